@@ -0,0 +1,916 @@
+/*
+ * File      : gui_bench.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+
+#if defined(PKG_USING_GUIENGINE) && defined(GUIENGINE_USING_BENCHMARK)
+
+#include <rtgui/rtgui.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/rtgui_app.h>
+#include <rtgui/rtgui_server.h>
+#include <rtgui/image.h>
+#include <rtgui/blit.h>
+#include <rtgui/region.h>
+#include <rtgui/widgets/window.h>
+#include <rtgui/dc.h>
+
+#if defined(GUIENGINE_IMAGE_PNG) || defined(GUIENGINE_IMAGE_LODEPNG)
+#include <resources.c>
+#endif
+
+#if defined(GUIENGINE_USING_HEADLESS_FB) && defined(GUIENGINE_HEADLESS_PERF) && defined(__linux__)
+#include "headless_fb.h"
+#define BENCH_USING_PERF
+#endif
+
+/*
+ * The micro benchmark of the primitives of dc on the hardware, client and
+ * buffer dc, the blits of each format pair, the region operations, the text of
+ * each font, the image decoders and the IPC of server and apps. Each case is
+ * run for GUIENGINE_BENCH_MS, and the result is a line of CSV:
+ *
+ *   bench,<group>,<target>,<case>,<ops>,<us>,<ops/s>,<Mpixel/s>
+ *
+ * The time is from GUIENGINE_PROFILE_CLOCK, map it to a cycle counter for the
+ * short cases. On the headless framebuffer of simulator with perf events, the
+ * cycles and instructions per op are appended. Run "gui_bench" in msh.
+ */
+#ifndef GUIENGINE_BENCH_MS
+#define GUIENGINE_BENCH_MS      200
+#endif
+/* the size of the area drawn, and of the buffer dc and blit */
+#ifndef GUIENGINE_BENCH_SIZE
+#define GUIENGINE_BENCH_SIZE    64
+#endif
+
+/* the input events posted to server for the latency from input to paint */
+#ifndef GUIENGINE_BENCH_INPUTS
+#define GUIENGINE_BENCH_INPUTS  64
+#endif
+
+#define BENCH_SIZE              GUIENGINE_BENCH_SIZE
+#define BENCH_CLOCK()           ((rt_uint32_t)GUIENGINE_PROFILE_CLOCK())
+
+typedef void (*bench_func_t)(void *parameter, int index);
+
+static void bench_report(const char *group, const char *target, const char *name,
+                         rt_uint32_t ops, rt_uint32_t pixels, rt_uint32_t us)
+{
+    rt_uint32_t ops_s, mpix;
+
+    if (us == 0) us = 1;
+    ops_s = (rt_uint32_t)((rt_uint64_t)ops * 1000000 / us);
+    /* the pixels in a microsecond is the Mpixel/s, in 1/1000 */
+    mpix = (rt_uint32_t)((rt_uint64_t)pixels * 1000 / us);
+
+    rt_kprintf("bench,%s,%s,%s,%d,%d,%d,%d.%03d", group, target, name,
+               ops, us, ops_s, mpix / 1000, mpix % 1000);
+}
+
+/* run the case in batches until the time is up */
+static void bench_run(const char *group, const char *target, const char *name,
+                      bench_func_t func, void *parameter, int batch, rt_uint32_t pixels_per_op)
+{
+    int index;
+    rt_uint32_t ops = 0, start, us;
+#ifdef BENCH_USING_PERF
+    rt_uint64_t cycles, instructions;
+
+    headless_perf_start();
+#endif
+
+    start = BENCH_CLOCK();
+    do
+    {
+        for (index = 0; index < batch; index ++)
+            func(parameter, ops + index);
+        ops += batch;
+
+        us = BENCH_CLOCK() - start;
+    }
+    while (us < GUIENGINE_BENCH_MS * 1000);
+
+#ifdef BENCH_USING_PERF
+    headless_perf_stop(&cycles, &instructions);
+    bench_report(group, target, name, ops, ops * pixels_per_op, us);
+    rt_kprintf(",%d,%d\n", (rt_uint32_t)(cycles / ops), (rt_uint32_t)(instructions / ops));
+#else
+    bench_report(group, target, name, ops, ops * pixels_per_op, us);
+    rt_kprintf("\n");
+#endif
+}
+
+/* the primitives of dc */
+static void bench_point(void *dc, int i)
+{
+    rtgui_dc_draw_point(dc, i % BENCH_SIZE, (i / BENCH_SIZE) % BENCH_SIZE);
+}
+
+static void bench_color_point(void *dc, int i)
+{
+    rtgui_dc_draw_color_point(dc, i % BENCH_SIZE, (i / BENCH_SIZE) % BENCH_SIZE, RTGUI_RGB(i, 0, 0));
+}
+
+static void bench_hline(void *dc, int i)
+{
+    rtgui_dc_draw_hline(dc, 0, BENCH_SIZE, i % BENCH_SIZE);
+}
+
+static void bench_vline(void *dc, int i)
+{
+    rtgui_dc_draw_vline(dc, i % BENCH_SIZE, 0, BENCH_SIZE);
+}
+
+static void bench_line(void *dc, int i)
+{
+    rtgui_dc_draw_line(dc, 0, i % BENCH_SIZE, BENCH_SIZE - 1, BENCH_SIZE - 1 - i % BENCH_SIZE);
+}
+
+static void bench_aa_line(void *dc, int i)
+{
+    rtgui_dc_draw_aa_line(dc, 0, i % BENCH_SIZE, BENCH_SIZE - 1, BENCH_SIZE - 1 - i % BENCH_SIZE);
+}
+
+static void bench_spans(void *dc, int i)
+{
+    int y;
+    struct rtgui_span spans[BENCH_SIZE];
+
+    for (y = 0; y < BENCH_SIZE; y ++)
+    {
+        spans[y].x1 = (y + i) % (BENCH_SIZE / 2);
+        spans[y].x2 = spans[y].x1 + BENCH_SIZE / 2;
+        spans[y].y = y;
+    }
+    rtgui_dc_fill_spans(dc, spans, BENCH_SIZE);
+}
+
+static void bench_fill_rect(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE, BENCH_SIZE};
+
+    rtgui_dc_fill_rect(dc, &rect);
+}
+
+static void bench_draw_rect(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE, BENCH_SIZE};
+
+    rtgui_dc_draw_rect(dc, &rect);
+}
+
+static void bench_round_rect(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE, BENCH_SIZE};
+
+    rtgui_dc_fill_round_rect(dc, &rect, BENCH_SIZE / 8);
+}
+
+static void bench_gradient(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE, BENCH_SIZE};
+
+    rtgui_dc_fill_gradient_rectv(dc, &rect, RED, BLUE);
+}
+
+static void bench_blend_rect(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE, BENCH_SIZE};
+
+    rtgui_dc_blend_fill_rect(dc, &rect, RTGUI_BLENDMODE_BLEND, RTGUI_ARGB(0x80, 0xff, 0, 0));
+}
+
+static void bench_circle(void *dc, int i)
+{
+    rtgui_dc_draw_circle(dc, BENCH_SIZE / 2, BENCH_SIZE / 2, BENCH_SIZE / 2 - 1);
+}
+
+static void bench_fill_circle(void *dc, int i)
+{
+    rtgui_dc_fill_circle(dc, BENCH_SIZE / 2, BENCH_SIZE / 2, BENCH_SIZE / 2 - 1);
+}
+
+static void bench_aa_circle(void *dc, int i)
+{
+    rtgui_dc_fill_aa_circle(dc, BENCH_SIZE / 2, BENCH_SIZE / 2, BENCH_SIZE / 2 - 1);
+}
+
+static void bench_ellipse(void *dc, int i)
+{
+    rtgui_dc_fill_ellipse(dc, BENCH_SIZE / 2, BENCH_SIZE / 2, BENCH_SIZE / 2 - 1, BENCH_SIZE / 4);
+}
+
+static void bench_polygon(void *dc, int i)
+{
+    const int vx[] = {0, BENCH_SIZE - 1, BENCH_SIZE / 2};
+    const int vy[] = {0, BENCH_SIZE / 2, BENCH_SIZE - 1};
+
+    rtgui_dc_fill_polygon(dc, vx, vy, 3);
+}
+
+static void bench_pie(void *dc, int i)
+{
+    rtgui_dc_fill_pie(dc, BENCH_SIZE / 2, BENCH_SIZE / 2, BENCH_SIZE / 2 - 1, 0, 270);
+}
+
+static struct rtgui_dc *_bench_src;
+static void bench_dc_blit(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE, BENCH_SIZE};
+
+    rtgui_dc_blit(_bench_src, RT_NULL, dc, &rect);
+}
+
+struct bench_case
+{
+    const char *name;
+    bench_func_t func;
+    rt_uint32_t pixels;
+};
+
+static const struct bench_case _bench_dc_cases[] =
+{
+    {"draw_point",       bench_point,        1},
+    {"draw_color_point", bench_color_point,  1},
+    {"draw_hline",       bench_hline,        BENCH_SIZE},
+    {"draw_vline",       bench_vline,        BENCH_SIZE},
+    {"draw_line",        bench_line,         BENCH_SIZE},
+    {"draw_aa_line",     bench_aa_line,      BENCH_SIZE},
+    {"fill_spans",       bench_spans,        BENCH_SIZE * BENCH_SIZE / 2},
+    {"fill_rect",        bench_fill_rect,    BENCH_SIZE * BENCH_SIZE},
+    {"draw_rect",        bench_draw_rect,    BENCH_SIZE * 4},
+    {"fill_round_rect",  bench_round_rect,   BENCH_SIZE * BENCH_SIZE},
+    {"fill_gradient",    bench_gradient,     BENCH_SIZE * BENCH_SIZE},
+    {"blend_fill_rect",  bench_blend_rect,   BENCH_SIZE * BENCH_SIZE},
+    {"draw_circle",      bench_circle,       0},
+    {"fill_circle",      bench_fill_circle,  0},
+    {"fill_aa_circle",   bench_aa_circle,    0},
+    {"fill_ellipse",     bench_ellipse,      0},
+    {"fill_polygon",     bench_polygon,      BENCH_SIZE * BENCH_SIZE / 2},
+    {"fill_pie",         bench_pie,          0},
+    {"blit_buffer",      bench_dc_blit,      BENCH_SIZE * BENCH_SIZE},
+};
+
+/* the text of each font */
+struct bench_font
+{
+    const char *family;
+    rt_uint16_t height;
+};
+
+static const struct bench_font _bench_fonts[] =
+{
+    {"asc", 12}, {"asc", 16}, {"hz", 12}, {"hz", 16},
+};
+
+static void bench_text(void *dc, int i)
+{
+    rtgui_rect_t rect = {0, 0, BENCH_SIZE * 4, BENCH_SIZE};
+
+    rtgui_dc_draw_text(dc, "The quick brown fox", &rect);
+}
+
+static void bench_dc(const char *target, struct rtgui_dc *dc)
+{
+    int index;
+    char name[16];
+    struct rtgui_font *font, *saved;
+
+    for (index = 0; index < sizeof(_bench_dc_cases) / sizeof(_bench_dc_cases[0]); index ++)
+    {
+        bench_run("dc", target, _bench_dc_cases[index].name, _bench_dc_cases[index].func,
+                  dc, 16, _bench_dc_cases[index].pixels);
+    }
+
+    saved = RTGUI_DC_FONT(dc);
+    for (index = 0; index < sizeof(_bench_fonts) / sizeof(_bench_fonts[0]); index ++)
+    {
+        font = rtgui_font_refer(_bench_fonts[index].family, _bench_fonts[index].height);
+        if (font == RT_NULL) continue;
+
+        RTGUI_DC_FONT(dc) = font;
+        rt_snprintf(name, sizeof(name), "text_%s%d", _bench_fonts[index].family,
+                    _bench_fonts[index].height);
+        /* the pixels are the glyphs */
+        bench_run("text", target, name, bench_text, dc, 4, 19);
+        rtgui_font_derefer(font);
+    }
+    RTGUI_DC_FONT(dc) = saved;
+}
+
+/* the blits of each format pair, in the buffers out of dc */
+static const rt_uint8_t _bench_src_formats[] =
+{
+    RTGRAPHIC_PIXEL_FORMAT_RGB565, RTGRAPHIC_PIXEL_FORMAT_RGB888, RTGRAPHIC_PIXEL_FORMAT_ARGB888,
+    RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE, RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE, RTGRAPHIC_PIXEL_FORMAT_ALPHA,
+};
+static const rt_uint8_t _bench_dst_formats[] =
+{
+    RTGRAPHIC_PIXEL_FORMAT_RGB565, RTGRAPHIC_PIXEL_FORMAT_RGB888, RTGRAPHIC_PIXEL_FORMAT_ARGB888,
+    RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE,
+};
+
+struct bench_blit
+{
+    struct rtgui_blit_info info;
+    rt_uint8_t *src, *dst;
+};
+
+static void bench_blit_func(void *parameter, int i)
+{
+    struct bench_blit *blit = (struct bench_blit *)parameter;
+    struct rtgui_blit_info info = blit->info;
+
+    rtgui_blit(&info);
+}
+
+static void bench_blits(void)
+{
+    int s, d, alpha;
+    char name[24];
+    struct bench_blit blit;
+    static const rt_uint8_t alphas[] = {255, 128};
+
+    /* the largest pixel is 4 bytes */
+    blit.src = (rt_uint8_t *)rtgui_malloc(BENCH_SIZE * BENCH_SIZE * 4);
+    blit.dst = (rt_uint8_t *)rtgui_malloc(BENCH_SIZE * BENCH_SIZE * 4);
+    if (blit.src == RT_NULL || blit.dst == RT_NULL)
+        goto __exit;
+    rt_memset(blit.src, 0x5a, BENCH_SIZE * BENCH_SIZE * 4);
+
+    for (s = 0; s < sizeof(_bench_src_formats); s ++)
+    {
+        for (d = 0; d < sizeof(_bench_dst_formats); d ++)
+        {
+            for (alpha = 0; alpha < sizeof(alphas); alpha ++)
+            {
+                rt_memset(&blit.info, 0, sizeof(blit.info));
+                blit.info.src = blit.src;
+                blit.info.src_w = blit.info.src_h = BENCH_SIZE;
+                blit.info.src_fmt = _bench_src_formats[s];
+                blit.info.src_pitch = BENCH_SIZE * rtgui_color_get_bpp(blit.info.src_fmt);
+                blit.info.dst = blit.dst;
+                blit.info.dst_w = blit.info.dst_h = BENCH_SIZE;
+                blit.info.dst_fmt = _bench_dst_formats[d];
+                blit.info.dst_pitch = BENCH_SIZE * rtgui_color_get_bpp(blit.info.dst_fmt);
+                blit.info.a = alphas[alpha];
+                blit.info.r = blit.info.g = blit.info.b = 0xff;
+
+                rt_snprintf(name, sizeof(name), "0x%02x_0x%02x_a%d", blit.info.src_fmt,
+                            blit.info.dst_fmt, blit.info.a);
+                bench_run("blit", "-", name, bench_blit_func, &blit, 4, BENCH_SIZE * BENCH_SIZE);
+            }
+        }
+    }
+
+__exit:
+    if (blit.src) rtgui_free(blit.src);
+    if (blit.dst) rtgui_free(blit.dst);
+}
+
+/* the region operations, on the grids of rects */
+struct bench_region
+{
+    rtgui_region_t r1, r2, result;
+};
+
+static void bench_region_union(void *parameter, int i)
+{
+    struct bench_region *region = (struct bench_region *)parameter;
+
+    rtgui_region_union(&region->result, &region->r1, &region->r2);
+}
+
+static void bench_region_intersect(void *parameter, int i)
+{
+    struct bench_region *region = (struct bench_region *)parameter;
+
+    rtgui_region_intersect(&region->result, &region->r1, &region->r2);
+}
+
+static void bench_region_subtract(void *parameter, int i)
+{
+    struct bench_region *region = (struct bench_region *)parameter;
+
+    rtgui_region_subtract(&region->result, &region->r1, &region->r2);
+}
+
+static void bench_regions(void)
+{
+    int x, y;
+    rtgui_rect_t rect;
+    struct bench_region region;
+
+    rtgui_region_init(&region.r1);
+    rtgui_region_init(&region.r2);
+    rtgui_region_init(&region.result);
+    for (y = 0; y < 8; y ++)
+    {
+        for (x = 0; x < 8; x ++)
+        {
+            rect.x1 = x * 16; rect.y1 = y * 16;
+            rect.x2 = rect.x1 + 12; rect.y2 = rect.y1 + 12;
+            rtgui_region_union_rect(&region.r1, &region.r1, &rect);
+
+            rtgui_rect_move(&rect, 6, 6);
+            rtgui_region_union_rect(&region.r2, &region.r2, &rect);
+        }
+    }
+
+    bench_run("region", "-", "union", bench_region_union, &region, 4, 0);
+    bench_run("region", "-", "intersect", bench_region_intersect, &region, 4, 0);
+    bench_run("region", "-", "subtract", bench_region_subtract, &region, 4, 0);
+
+    rtgui_region_fini(&region.r1);
+    rtgui_region_fini(&region.r2);
+    rtgui_region_fini(&region.result);
+}
+
+/* the image decoders, the images are generated except the PNG of demo */
+struct bench_image
+{
+    const char *type;
+    const rt_uint8_t *data;
+    rt_size_t length;
+};
+
+static void bench_image_decode(void *parameter, int i)
+{
+    struct rtgui_image *image;
+    struct bench_image *bimg = (struct bench_image *)parameter;
+
+    image = rtgui_image_create_from_mem(bimg->type, bimg->data, bimg->length, RT_TRUE);
+    if (image != RT_NULL)
+        rtgui_image_destroy(image);
+}
+
+rt_inline void bench_put32(rt_uint8_t *p, rt_uint32_t value)
+{
+    p[0] = value; p[1] = value >> 8; p[2] = value >> 16; p[3] = value >> 24;
+}
+
+static void bench_images(void)
+{
+    rt_uint8_t *data;
+    rt_size_t size;
+    struct bench_image bimg;
+
+    /* the HDC of RGB565 */
+    size = 20 + BENCH_SIZE * BENCH_SIZE * 2;
+    data = (rt_uint8_t *)rtgui_malloc(size);
+    if (data != RT_NULL)
+    {
+        rt_memset(data, 0x5a, size);
+        rt_memcpy(data, "HDC\0", 4);
+        bench_put32(data + 4, BENCH_SIZE);
+        bench_put32(data + 8, BENCH_SIZE);
+        bench_put32(data + 12, 1);
+        bench_put32(data + 16, RTGRAPHIC_PIXEL_FORMAT_RGB565);
+
+        bimg.type = "hdc"; bimg.data = data; bimg.length = size;
+        bench_run("image", "-", "hdc", bench_image_decode, &bimg, 1, BENCH_SIZE * BENCH_SIZE);
+        rtgui_free(data);
+    }
+
+#ifdef GUIENGINE_IMAGE_BMP
+    /* the BMP of 24 bits */
+    size = 54 + BENCH_SIZE * BENCH_SIZE * 3;
+    data = (rt_uint8_t *)rtgui_malloc(size);
+    if (data != RT_NULL)
+    {
+        rt_memset(data, 0, 54);
+        rt_memset(data + 54, 0x5a, size - 54);
+        data[0] = 'B'; data[1] = 'M';
+        bench_put32(data + 2, size);
+        bench_put32(data + 10, 54);
+        bench_put32(data + 14, 40);
+        bench_put32(data + 18, BENCH_SIZE);
+        bench_put32(data + 22, BENCH_SIZE);
+        data[26] = 1;
+        data[28] = 24;
+        bench_put32(data + 34, size - 54);
+
+        bimg.type = "bmp"; bimg.data = data; bimg.length = size;
+        bench_run("image", "-", "bmp", bench_image_decode, &bimg, 1, BENCH_SIZE * BENCH_SIZE);
+        rtgui_free(data);
+    }
+#endif
+
+#if defined(GUIENGINE_IMAGE_PNG) || defined(GUIENGINE_IMAGE_LODEPNG)
+    {
+        struct rtgui_image *image;
+
+        image = rtgui_image_create_from_mem("png", _picture_png, sizeof(_picture_png), RT_FALSE);
+        if (image != RT_NULL)
+        {
+            bimg.type = "png"; bimg.data = _picture_png; bimg.length = sizeof(_picture_png);
+            bench_run("image", "-", "png", bench_image_decode, &bimg, 1, image->w * image->h);
+            rtgui_image_destroy(image);
+        }
+    }
+#endif
+}
+
+/*
+ * The IPC: the events of each size sent to an echo app of higher priority, so
+ * each rtgui_send is received before it returns, the events posted to self and
+ * received, the windows in the cycles of create and show, and the clip of N
+ * windows under the one moved.
+ */
+#define BENCH_ECHO_QUIT         1
+
+static struct rtgui_app *_bench_echo;
+static struct rt_semaphore _bench_echo_sem;
+
+static void bench_echo_entry(void *parameter)
+{
+    union rtgui_event_generic buffer;
+    struct rtgui_event *event = (struct rtgui_event *)&buffer;
+
+    _bench_echo = rtgui_app_create("gbecho");
+    rt_sem_release(&_bench_echo_sem);
+    if (_bench_echo == RT_NULL)
+        return;
+
+    while (rtgui_recv(event, sizeof(buffer), RT_WAITING_FOREVER) == RT_EOK)
+    {
+        if (event->ack != RT_NULL)
+            rtgui_ack(event, RTGUI_STATUS_OK);
+        if (event->type == RTGUI_EVENT_COMMAND && event->user == BENCH_ECHO_QUIT)
+            break;
+    }
+
+    rtgui_app_destroy(_bench_echo);
+    _bench_echo = RT_NULL;
+    rt_sem_release(&_bench_echo_sem);
+}
+
+struct bench_ipc
+{
+    union rtgui_event_generic buffer;
+    rt_size_t size;
+};
+
+static void bench_send(void *parameter, int i)
+{
+    struct bench_ipc *ipc = (struct bench_ipc *)parameter;
+
+    rtgui_send(_bench_echo, (struct rtgui_event *)&ipc->buffer, ipc->size);
+}
+
+static void bench_send_sync(void *parameter, int i)
+{
+    struct bench_ipc *ipc = (struct bench_ipc *)parameter;
+
+    rtgui_send_sync(_bench_echo, (struct rtgui_event *)&ipc->buffer, ipc->size);
+}
+
+static void bench_post_recv(void *parameter, int i)
+{
+    struct bench_ipc *ipc = (struct bench_ipc *)parameter;
+    union rtgui_event_generic buffer;
+
+    if (rtgui_send(rtgui_app_self(), (struct rtgui_event *)&ipc->buffer, ipc->size) == RT_EOK)
+        rtgui_recv((struct rtgui_event *)&buffer, sizeof(buffer), 0);
+}
+
+static void bench_win_create(void *parameter, int i)
+{
+    struct rtgui_win *win;
+
+    win = rtgui_win_create(RT_NULL, "bench", (rtgui_rect_t *)parameter, RTGUI_WIN_STYLE_NO_TITLE);
+    if (win != RT_NULL)
+        rtgui_win_destroy(win);
+}
+
+static void bench_win_show(void *parameter, int i)
+{
+    rtgui_win_show((struct rtgui_win *)parameter, RT_FALSE);
+    rtgui_win_hide((struct rtgui_win *)parameter);
+}
+
+static void bench_win_move(void *parameter, int i)
+{
+    struct rtgui_win *win = (struct rtgui_win *)parameter;
+
+    rtgui_win_move(win, RTGUI_WIDGET(win)->extent.x1 + ((i & 0x01) ? -1 : 1),
+                   RTGUI_WIDGET(win)->extent.y1);
+}
+
+static void bench_ipc(void)
+{
+    int index, count, num;
+    char name[16];
+    rt_thread_t tid;
+    rtgui_rect_t rect;
+    struct rtgui_win *win, *wins[16];
+    struct bench_ipc ipc;
+    static const rt_size_t sizes[] = {sizeof(struct rtgui_event), 32, 64, sizeof(union rtgui_event_generic)};
+    static const int fanouts[] = {1, 4, 16};
+
+    rt_sem_init(&_bench_echo_sem, "gbecho", 0, RT_IPC_FLAG_FIFO);
+    tid = rt_thread_create("gbecho", bench_echo_entry, RT_NULL, 2048,
+                           GUIENGIN_APP_THREAD_PRIORITY - 1, GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid != RT_NULL)
+    {
+        rt_thread_startup(tid);
+        rt_sem_take(&_bench_echo_sem, RT_WAITING_FOREVER);
+    }
+
+    rt_memset(&ipc.buffer, 0, sizeof(ipc.buffer));
+    RTGUI_EVENT_INIT((struct rtgui_event *)&ipc.buffer, RTGUI_EVENT_COMMAND);
+    for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); index ++)
+    {
+        ipc.size = _UI_MIN(sizes[index], sizeof(ipc.buffer));
+        rt_snprintf(name, sizeof(name), "%d", (int)ipc.size);
+
+        if (_bench_echo != RT_NULL)
+        {
+            bench_run("ipc", name, "send", bench_send, &ipc, 8, 0);
+            bench_run("ipc", name, "send_sync", bench_send_sync, &ipc, 1, 0);
+        }
+        bench_run("ipc", name, "post_recv", bench_post_recv, &ipc, 8, 0);
+    }
+
+    if (_bench_echo != RT_NULL)
+    {
+        ((struct rtgui_event *)&ipc.buffer)->user = BENCH_ECHO_QUIT;
+        rtgui_send(_bench_echo, (struct rtgui_event *)&ipc.buffer, sizeof(struct rtgui_event));
+        rt_sem_take(&_bench_echo_sem, RT_WAITING_FOREVER);
+    }
+    rt_sem_detach(&_bench_echo_sem);
+
+    /* the windows */
+    rtgui_rect_init(&rect, 0, 0, BENCH_SIZE, BENCH_SIZE);
+    bench_run("ipc", "win", "create_destroy", bench_win_create, &rect, 1, 0);
+    win = rtgui_win_create(RT_NULL, "bench", &rect, RTGUI_WIN_STYLE_NO_TITLE);
+    if (win != RT_NULL)
+    {
+        bench_run("ipc", "win", "show_hide", bench_win_show, win, 1, 0);
+        rtgui_win_destroy(win);
+    }
+
+    /* the clip info to the windows under the top one moved */
+    for (index = 0; index < sizeof(fanouts) / sizeof(fanouts[0]); index ++)
+    {
+        num = fanouts[index];
+        for (count = 0; count < num; count ++)
+        {
+            rtgui_rect_init(&rect, count * 4, count * 4, BENCH_SIZE * 2, BENCH_SIZE * 2);
+            wins[count] = rtgui_win_create(RT_NULL, "bench", &rect, RTGUI_WIN_STYLE_NO_TITLE);
+            if (wins[count] == RT_NULL)
+                break;
+            rtgui_win_show(wins[count], RT_FALSE);
+        }
+
+        if (count == num)
+        {
+            rt_snprintf(name, sizeof(name), "%d", num);
+            bench_run("ipc", name, "clip_fanout", bench_win_move, wins[num - 1], 1, 0);
+        }
+        while (count > 0)
+            rtgui_win_destroy(wins[-- count]);
+    }
+
+    /* the paints of the windows destroyed are dropped */
+    while (rtgui_recv((struct rtgui_event *)&ipc.buffer, sizeof(ipc.buffer), 0) == RT_EOK) ;
+}
+
+/*
+ * The latency from the key posted to server to the paint of it on screen,
+ * while a thread of lower priority floods the server with mouse motion. The
+ * keys are posted one by one from the event loop of the window.
+ */
+static int _bench_inputs;
+static rt_uint32_t _bench_input_start, _bench_input_total, _bench_input_max;
+static volatile rt_bool_t _bench_load_stop;
+
+static void bench_load_entry(void *parameter)
+{
+    int i = 0;
+    struct rtgui_event_mouse emouse;
+
+    while (_bench_load_stop == RT_FALSE)
+    {
+        RTGUI_EVENT_MOUSE_MOTION_INIT(&emouse);
+        emouse.x = i % BENCH_SIZE;
+        emouse.y = (i / BENCH_SIZE) % BENCH_SIZE;
+        emouse.button = 0;
+        emouse.ts = rt_tick_get();
+        emouse.id = 0;
+        rtgui_server_post_event(&emouse.parent, sizeof(emouse));
+
+        i ++;
+        rt_thread_delay(1);
+    }
+    _bench_load_stop = RT_FALSE;
+}
+
+static void bench_input_post(void)
+{
+    struct rtgui_event_kbd ekbd;
+
+    RTGUI_EVENT_KBD_INIT(&ekbd);
+    ekbd.wid = RT_NULL;
+    ekbd.type = RTGUI_KEYDOWN;
+    ekbd.key = RTGUIK_SPACE;
+    ekbd.mod = 0;
+    ekbd.unicode = ' ';
+
+    _bench_input_start = BENCH_CLOCK();
+    rtgui_server_post_event(&ekbd.parent, sizeof(ekbd));
+}
+
+static void bench_input_start(struct rtgui_win *win)
+{
+    rt_thread_t tid;
+
+    _bench_inputs = 0;
+    _bench_input_total = _bench_input_max = 0;
+    _bench_load_stop = RT_FALSE;
+    tid = rt_thread_create("gbload", bench_load_entry, RT_NULL, 1024,
+                           GUIENGIN_APP_THREAD_PRIORITY + 1, GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid != RT_NULL)
+        rt_thread_startup(tid);
+
+    rtgui_win_activate(win);
+    bench_input_post();
+}
+
+/* return RT_TRUE when all the inputs are painted */
+static rt_bool_t bench_input_paint(struct rtgui_win *win)
+{
+    rt_uint32_t us;
+    rtgui_rect_t rect;
+    struct rtgui_dc *dc;
+
+    dc = rtgui_dc_begin_drawing(RTGUI_WIDGET(win));
+    if (dc != RT_NULL)
+    {
+        rtgui_rect_init(&rect, 0, 0, BENCH_SIZE, BENCH_SIZE);
+        RTGUI_DC_BC(dc) = (_bench_inputs & 0x01) ? white : black;
+        rtgui_dc_fill_rect(dc, &rect);
+        rtgui_dc_end_drawing(dc, RT_TRUE);
+    }
+
+    us = BENCH_CLOCK() - _bench_input_start;
+    _bench_input_total += us;
+    if (us > _bench_input_max)
+        _bench_input_max = us;
+
+    if (++ _bench_inputs < GUIENGINE_BENCH_INPUTS)
+    {
+        bench_input_post();
+        return RT_FALSE;
+    }
+
+    _bench_load_stop = RT_TRUE;
+    while (_bench_load_stop == RT_TRUE)
+        rt_thread_delay(1);
+
+    /* the mean of latency is the us of op, the max is in one op */
+    bench_report("ipc", "input", "input_paint", _bench_inputs, 0, _bench_input_total);
+    rt_kprintf("\n");
+    bench_report("ipc", "input", "input_paint_max", 1, 0, _bench_input_max);
+    rt_kprintf("\n");
+    return RT_TRUE;
+}
+
+static void bench_all(struct rtgui_win *win)
+{
+    struct rtgui_dc *dc, *target;
+
+    _bench_src = rtgui_dc_buffer_create(BENCH_SIZE, BENCH_SIZE);
+
+    /* the drawing of window holds the screen lock for the dc */
+    dc = rtgui_dc_begin_drawing(RTGUI_WIDGET(win));
+    if (dc != RT_NULL && _bench_src != RT_NULL)
+    {
+        target = rtgui_dc_hw_create(RTGUI_WIDGET(win));
+        if (target != RT_NULL)
+        {
+            bench_dc("hw", target);
+            target->engine->fini(target);
+        }
+
+        target = rtgui_dc_client_create(RTGUI_WIDGET(win));
+        if (target != RT_NULL)
+            bench_dc("client", target);
+
+        rtgui_dc_end_drawing(dc, RT_TRUE);
+    }
+
+    target = rtgui_dc_buffer_create(BENCH_SIZE * 4, BENCH_SIZE);
+    if (target != RT_NULL)
+    {
+        bench_dc("buffer", target);
+        rtgui_dc_destory(target);
+    }
+
+    if (_bench_src != RT_NULL)
+    {
+        rtgui_dc_destory(_bench_src);
+        _bench_src = RT_NULL;
+    }
+
+    bench_blits();
+    bench_regions();
+    bench_images();
+    bench_ipc();
+}
+
+static rt_bool_t bench_event_handler(struct rtgui_object *object, rtgui_event_t *event)
+{
+    rt_bool_t result;
+    struct rtgui_win *win = RTGUI_WIN(object);
+
+    if (event->type == RTGUI_EVENT_KBD && win->user_data == win)
+    {
+        if (bench_input_paint(win) == RT_TRUE)
+            rtgui_app_exit(win->app, 0);
+        return RT_TRUE;
+    }
+
+    result = rtgui_win_event_handler(object, event);
+    /* run once the window is shown on screen */
+    if (event->type == RTGUI_EVENT_PAINT && win->user_data == RT_NULL)
+    {
+        win->user_data = win;
+
+#ifdef BENCH_USING_PERF
+        rt_kprintf("bench,group,target,case,ops,us,ops_s,mpixel_s,cycles_op,instructions_op\n");
+#else
+        rt_kprintf("bench,group,target,case,ops,us,ops_s,mpixel_s\n");
+#endif
+        bench_all(win);
+        /* the latency of input runs in the event loop */
+        bench_input_start(win);
+    }
+
+    return result;
+}
+
+static void gui_bench_entry(void *parameter)
+{
+    struct rtgui_win *win;
+    struct rtgui_app *app;
+
+    app = rtgui_app_create("gui_bench");
+    if (app == RT_NULL)
+        return;
+
+    win = rtgui_mainwin_create(RT_NULL, "bench", RTGUI_WIN_STYLE_NO_TITLE);
+    if (win == RT_NULL)
+    {
+        rtgui_app_destroy(app);
+        return;
+    }
+    rtgui_object_set_event_handler(RTGUI_OBJECT(win), bench_event_handler);
+    rtgui_win_show(win, RT_FALSE);
+
+    rtgui_app_run(app);
+    rtgui_win_destroy(win);
+    rtgui_app_destroy(app);
+}
+
+int gui_bench(void)
+{
+    rt_thread_t tid;
+
+    tid = rt_thread_create("gui_bench", gui_bench_entry, RT_NULL,
+                           4096, GUIENGIN_APP_THREAD_PRIORITY, GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid != RT_NULL)
+        rt_thread_startup(tid);
+
+    return 0;
+}
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+FINSH_FUNCTION_EXPORT(gui_bench, run the benchmark of GUI engine);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(gui_bench, run the benchmark of GUI engine);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,505 @@
+/*
+ * File      : gui_soak.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+
+#if defined(PKG_USING_GUIENGINE) && defined(GUIENGINE_USING_SOAK)
+
+#include <rtgui/rtgui.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/rtgui_app.h>
+#include <rtgui/image.h>
+#include <rtgui/font.h>
+#include <rtgui/dc.h>
+#include <rtgui/widgets/window.h>
+#include <rtgui/widgets/listview.h>
+
+/*
+ * The soak test of long uptime. One action is run in each
+ * GUIENGINE_SOAK_STEP_MS at random: a window is opened, closed, moved or
+ * raised, the list is scrolled, an image or buffer dc of random size is
+ * replaced, or the font of list is changed. A line of CSV is printed in each
+ * GUIENGINE_SOAK_REPORT_MS:
+ *
+ *   soak,<s>,<steps>,<step_us>,<step_max_us>,<paint_us>,<paint_max_us>,
+ *        <heap_free>,<largest_free>,<frag_percent>,<gui_live>,<gui_blocks>,<gui_blocks_delta>
+ *
+ * The step and paint are the mean and max in the report period, the paint is
+ * of the main window. The largest free block of heap is probed by rt_malloc.
+ * The memory of GUI is from RTGUI_MEM_TRACE (-1 without it), the delta of
+ * blocks is from the first report: it keeps growing if there is a leak, since
+ * the windows, images and dc are replaced in a fixed number of slots. Run
+ * "gui_soak" in msh to start it, and again to stop it.
+ */
+#ifndef GUIENGINE_SOAK_STEP_MS
+#define GUIENGINE_SOAK_STEP_MS      20
+#endif
+#ifndef GUIENGINE_SOAK_REPORT_MS
+#define GUIENGINE_SOAK_REPORT_MS    60000
+#endif
+#ifndef GUIENGINE_SOAK_WINDOWS
+#define GUIENGINE_SOAK_WINDOWS      8
+#endif
+#ifndef GUIENGINE_SOAK_IMAGES
+#define GUIENGINE_SOAK_IMAGES       8
+#endif
+/* the largest image and buffer dc */
+#define SOAK_IMAGE_SIZE             128
+#define SOAK_ITEMS                  200
+#define SOAK_ITEM_HEIGHT            20
+
+#define SOAK_CLOCK()                ((rt_uint32_t)GUIENGINE_PROFILE_CLOCK())
+
+struct soak_time
+{
+    rt_uint32_t count;
+    rt_uint32_t total;
+    rt_uint32_t max;
+};
+
+struct soak
+{
+    struct rtgui_app *app;
+    struct rtgui_win *main;
+    rtgui_listview_t *list;
+    rtgui_timer_t *timer;
+
+    struct rtgui_win *wins[GUIENGINE_SOAK_WINDOWS];
+    struct rtgui_image *images[GUIENGINE_SOAK_IMAGES];
+    struct rtgui_dc *dcs[GUIENGINE_SOAK_IMAGES];
+    /* the HDC of the images, the size in header is changed for each */
+    rt_uint8_t *hdc;
+    struct rtgui_font *font;
+
+    rt_uint32_t seed;
+    rt_uint32_t steps;
+    rt_tick_t start;
+    rt_tick_t report;
+    struct soak_time step;
+    struct soak_time paint;
+    rt_int32_t first_blocks;
+
+    volatile rt_bool_t stop;
+};
+static struct soak *_soak;
+
+static const struct
+{
+    const char *family;
+    rt_uint16_t height;
+} _soak_fonts[] =
+{
+    {"asc", 12}, {"asc", 16}, {"hz", 12}, {"hz", 16},
+};
+
+static rt_uint32_t soak_rand(struct soak *soak)
+{
+    soak->seed = soak->seed * 1103515245 + 12345;
+    return soak->seed >> 16;
+}
+
+static void soak_time_add(struct soak_time *time, rt_uint32_t us)
+{
+    time->count ++;
+    time->total += us;
+    if (us > time->max)
+        time->max = us;
+}
+
+/* the largest block rt_malloc gets, in the steps of 64 bytes */
+static rt_uint32_t soak_largest_free(rt_uint32_t free)
+{
+    rt_uint32_t low = 0, high = free, mid;
+    void *ptr;
+
+    while (high - low > 64)
+    {
+        mid = low + (high - low) / 2;
+        ptr = rt_malloc(mid);
+        if (ptr != RT_NULL)
+        {
+            rt_free(ptr);
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static void soak_report(struct soak *soak)
+{
+    rt_uint32_t free = 0, largest = 0, frag = 0;
+    rt_int32_t live = -1, blocks = -1;
+#ifdef RT_USING_HEAP
+    rt_uint32_t total, used, max_used;
+
+    rt_memory_info(&total, &used, &max_used);
+    free = total - used;
+    largest = soak_largest_free(free);
+    if (free != 0)
+        frag = 100 - (rt_uint32_t)((rt_uint64_t)largest * 100 / free);
+#endif
+#ifdef RTGUI_MEM_TRACE
+    rtgui_mem_get_stat(RTGUI_MEM_TAG_MAX, (rt_uint32_t *)&live, (rt_uint32_t *)&blocks);
+    if (soak->first_blocks < 0)
+        soak->first_blocks = blocks;
+#endif
+
+    rt_kprintf("soak,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
+               (rt_tick_get() - soak->start) / RT_TICK_PER_SECOND, soak->steps,
+               soak->step.count ? soak->step.total / soak->step.count : 0, soak->step.max,
+               soak->paint.count ? soak->paint.total / soak->paint.count : 0, soak->paint.max,
+               free, largest, frag, live, blocks,
+               soak->first_blocks < 0 ? 0 : blocks - soak->first_blocks);
+
+    rt_memset(&soak->step, 0, sizeof(soak->step));
+    rt_memset(&soak->paint, 0, sizeof(soak->paint));
+}
+
+/* the rows of list */
+static rt_bool_t soak_row_event_handler(struct rtgui_object *object, struct rtgui_event *event)
+{
+    char text[16];
+    rtgui_rect_t rect;
+    struct rtgui_dc *dc;
+    struct rtgui_widget *row = RTGUI_WIDGET(object);
+
+    if (event->type != RTGUI_EVENT_PAINT)
+        return rtgui_widget_event_handler(object, event);
+
+    dc = rtgui_dc_begin_drawing(row);
+    if (dc == RT_NULL)
+        return RT_FALSE;
+
+    rtgui_widget_get_rect(row, &rect);
+    RTGUI_DC_BC(dc) = (row->user_data & 0x01) ? white : RTGUI_RGB(0xe0, 0xe0, 0xe0);
+    rtgui_dc_fill_rect(dc, &rect);
+    if (_soak->font != RT_NULL)
+        RTGUI_DC_FONT(dc) = _soak->font;
+    rt_snprintf(text, sizeof(text), "item %d", row->user_data);
+    rtgui_dc_draw_text(dc, text, &rect);
+    rtgui_dc_end_drawing(dc, RT_TRUE);
+
+    return RT_TRUE;
+}
+
+static rtgui_widget_t *soak_create_row(struct rtgui_listview *view)
+{
+    rtgui_widget_t *row;
+
+    row = rtgui_widget_create(RTGUI_WIDGET_TYPE);
+    if (row != RT_NULL)
+        rtgui_object_set_event_handler(RTGUI_OBJECT(row), soak_row_event_handler);
+
+    return row;
+}
+
+static void soak_bind_row(struct rtgui_listview *view, rtgui_widget_t *row, int index)
+{
+    row->user_data = index;
+}
+
+static const struct rtgui_listview_source _soak_list_source =
+{
+    soak_create_row,
+    soak_bind_row,
+};
+
+/* the actions */
+static void soak_random_rect(struct soak *soak, rtgui_rect_t *rect, int max)
+{
+    rtgui_rect_t screen;
+
+    rtgui_get_screen_rect(&screen);
+    rect->x1 = soak_rand(soak) % (rtgui_rect_width(screen) / 2 + 1);
+    rect->y1 = soak_rand(soak) % (rtgui_rect_height(screen) / 2 + 1);
+    rect->x2 = rect->x1 + 32 + soak_rand(soak) % max;
+    rect->y2 = rect->y1 + 32 + soak_rand(soak) % max;
+}
+
+static void soak_window(struct soak *soak, int action)
+{
+    int slot;
+    rtgui_rect_t rect;
+    struct rtgui_win *win;
+
+    slot = soak_rand(soak) % GUIENGINE_SOAK_WINDOWS;
+    win = soak->wins[slot];
+    if (win == RT_NULL)
+    {
+        soak_random_rect(soak, &rect, 160);
+        win = rtgui_win_create(RT_NULL, "soak", &rect,
+                               (soak_rand(soak) & 0x01) ? RTGUI_WIN_STYLE_DEFAULT : RTGUI_WIN_STYLE_NO_TITLE);
+        if (win == RT_NULL)
+            return;
+        RTGUI_WIDGET_BACKGROUND(win) = RTGUI_RGB(soak_rand(soak), soak_rand(soak), soak_rand(soak));
+        rtgui_win_show(win, RT_FALSE);
+        soak->wins[slot] = win;
+        return;
+    }
+
+    switch (action)
+    {
+    case 0:
+        rtgui_win_destroy(win);
+        soak->wins[slot] = RT_NULL;
+        break;
+    case 1:
+        soak_random_rect(soak, &rect, 1);
+        rtgui_win_move(win, rect.x1, rect.y1);
+        break;
+    default:
+        /* raise it over the others */
+        rtgui_win_show(win, RT_FALSE);
+        break;
+    }
+}
+
+static void soak_image(struct soak *soak)
+{
+    int slot, w, h;
+    rt_uint8_t *hdc = soak->hdc;
+
+    slot = soak_rand(soak) % GUIENGINE_SOAK_IMAGES;
+    if (soak->images[slot] != RT_NULL)
+    {
+        rtgui_image_destroy(soak->images[slot]);
+        soak->images[slot] = RT_NULL;
+    }
+    if (soak->dcs[slot] != RT_NULL)
+    {
+        rtgui_dc_destory(soak->dcs[slot]);
+        soak->dcs[slot] = RT_NULL;
+    }
+
+    w = 1 + soak_rand(soak) % SOAK_IMAGE_SIZE;
+    h = 1 + soak_rand(soak) % SOAK_IMAGE_SIZE;
+    if (soak_rand(soak) & 0x01)
+    {
+        soak->dcs[slot] = rtgui_dc_buffer_create(w, h);
+    }
+    else if (hdc != RT_NULL)
+    {
+        /* the HDC of RGB565 in the size */
+        hdc[4] = w; hdc[5] = w >> 8; hdc[6] = 0; hdc[7] = 0;
+        hdc[8] = h; hdc[9] = h >> 8; hdc[10] = 0; hdc[11] = 0;
+        soak->images[slot] = rtgui_image_create_from_mem("hdc", hdc, 20 + w * h * 2, RT_TRUE);
+    }
+}
+
+static void soak_font(struct soak *soak)
+{
+    int index;
+    struct rtgui_font *font;
+
+    index = soak_rand(soak) % (sizeof(_soak_fonts) / sizeof(_soak_fonts[0]));
+    font = rtgui_font_refer(_soak_fonts[index].family, _soak_fonts[index].height);
+    if (font == RT_NULL)
+        return;
+
+    if (soak->font != RT_NULL)
+        rtgui_font_derefer(soak->font);
+    soak->font = font;
+    rtgui_widget_update(RTGUI_WIDGET(soak->main));
+}
+
+static void soak_step(struct rtgui_timer *timer, void *parameter)
+{
+    rt_uint32_t start;
+    struct soak *soak = (struct soak *)parameter;
+
+    if (soak->stop == RT_TRUE)
+    {
+        rtgui_app_exit(soak->app, 0);
+        return;
+    }
+
+    start = SOAK_CLOCK();
+    switch (soak_rand(soak) % 8)
+    {
+    case 0:
+    case 1:
+    case 2:
+        soak_window(soak, soak_rand(soak) % 3);
+        break;
+    case 3:
+    case 4:
+        rtgui_listview_scroll_to(soak->list, soak_rand(soak) % (SOAK_ITEMS * SOAK_ITEM_HEIGHT));
+        break;
+    case 5:
+    case 6:
+        soak_image(soak);
+        break;
+    default:
+        soak_font(soak);
+        break;
+    }
+    soak_time_add(&soak->step, SOAK_CLOCK() - start);
+    soak->steps ++;
+
+    if (rt_tick_get() - soak->report >= rt_tick_from_millisecond(GUIENGINE_SOAK_REPORT_MS))
+    {
+        soak->report = rt_tick_get();
+        soak_report(soak);
+    }
+}
+
+static rt_bool_t soak_event_handler(struct rtgui_object *object, struct rtgui_event *event)
+{
+    rt_bool_t result;
+    rt_uint32_t start;
+
+    if (event->type != RTGUI_EVENT_PAINT)
+        return rtgui_win_event_handler(object, event);
+
+    start = SOAK_CLOCK();
+    result = rtgui_win_event_handler(object, event);
+    soak_time_add(&_soak->paint, SOAK_CLOCK() - start);
+
+    return result;
+}
+
+static void soak_cleanup(struct soak *soak)
+{
+    int index;
+
+    for (index = 0; index < GUIENGINE_SOAK_WINDOWS; index ++)
+    {
+        if (soak->wins[index] != RT_NULL)
+            rtgui_win_destroy(soak->wins[index]);
+    }
+    for (index = 0; index < GUIENGINE_SOAK_IMAGES; index ++)
+    {
+        if (soak->images[index] != RT_NULL)
+            rtgui_image_destroy(soak->images[index]);
+        if (soak->dcs[index] != RT_NULL)
+            rtgui_dc_destory(soak->dcs[index]);
+    }
+    if (soak->font != RT_NULL)
+        rtgui_font_derefer(soak->font);
+    if (soak->timer != RT_NULL)
+        rtgui_timer_destory(soak->timer);
+    if (soak->main != RT_NULL)
+        rtgui_win_destroy(soak->main);
+    rtgui_free(soak->hdc);
+}
+
+static void gui_soak_entry(void *parameter)
+{
+    rtgui_rect_t rect;
+    struct soak *soak = (struct soak *)parameter;
+
+    soak->app = rtgui_app_create("gui_soak");
+    if (soak->app == RT_NULL)
+        goto __exit;
+
+    soak->main = rtgui_mainwin_create(RT_NULL, "soak", RTGUI_WIN_STYLE_NO_TITLE);
+    soak->list = rtgui_listview_create(&_soak_list_source, SOAK_ITEM_HEIGHT);
+    soak->timer = rtgui_timer_create(rt_tick_from_millisecond(GUIENGINE_SOAK_STEP_MS),
+                                     RT_TIMER_FLAG_PERIODIC, soak_step, soak);
+    /* the pixels of HDC are not changed, it's only a source of the sizes */
+    soak->hdc = (rt_uint8_t *)rtgui_malloc(20 + SOAK_IMAGE_SIZE * SOAK_IMAGE_SIZE * 2);
+    if (soak->hdc != RT_NULL)
+    {
+        rt_memset(soak->hdc, 0x5a, 20 + SOAK_IMAGE_SIZE * SOAK_IMAGE_SIZE * 2);
+        rt_memcpy(soak->hdc, "HDC\0", 4);
+        soak->hdc[12] = 1; soak->hdc[13] = soak->hdc[14] = soak->hdc[15] = 0;
+        soak->hdc[16] = RTGRAPHIC_PIXEL_FORMAT_RGB565;
+        soak->hdc[17] = soak->hdc[18] = soak->hdc[19] = 0;
+    }
+
+    if (soak->main != RT_NULL && soak->list != RT_NULL && soak->timer != RT_NULL)
+    {
+        rtgui_object_set_event_handler(RTGUI_OBJECT(soak->main), soak_event_handler);
+        rect = RTGUI_WIDGET(soak->main)->extent;
+        rtgui_widget_set_rect(RTGUI_WIDGET(soak->list), &rect);
+        rtgui_container_add_child(RTGUI_CONTAINER(soak->main), RTGUI_WIDGET(soak->list));
+        rtgui_listview_set_count(soak->list, SOAK_ITEMS);
+        rtgui_win_show(soak->main, RT_FALSE);
+
+        soak->start = soak->report = rt_tick_get();
+        rt_kprintf("soak,s,steps,step_us,step_max_us,paint_us,paint_max_us,"
+                   "heap_free,largest_free,frag_percent,gui_live,gui_blocks,gui_blocks_delta\n");
+        soak_report(soak);
+        rtgui_timer_start(soak->timer);
+        rtgui_app_run(soak->app);
+        rtgui_timer_stop(soak->timer);
+        soak_report(soak);
+    }
+    else if (soak->list != RT_NULL)
+    {
+        rtgui_listview_destroy(soak->list);
+    }
+
+    soak_cleanup(soak);
+    rtgui_app_destroy(soak->app);
+
+__exit:
+    rtgui_free(soak);
+    _soak = RT_NULL;
+}
+
+int gui_soak(void)
+{
+    rt_thread_t tid;
+    struct soak *soak;
+
+    if (_soak != RT_NULL)
+    {
+        /* the soak test is running, stop it */
+        _soak->stop = RT_TRUE;
+        return 0;
+    }
+
+    soak = (struct soak *)rtgui_malloc(sizeof(struct soak));
+    if (soak == RT_NULL)
+        return -RT_ENOMEM;
+    rt_memset(soak, 0, sizeof(struct soak));
+    soak->seed = rt_tick_get();
+    soak->first_blocks = -1;
+
+    tid = rt_thread_create("gui_soak", gui_soak_entry, soak,
+                           4096, GUIENGIN_APP_THREAD_PRIORITY, GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid == RT_NULL)
+    {
+        rtgui_free(soak);
+        return -RT_ENOMEM;
+    }
+
+    _soak = soak;
+    rt_thread_startup(tid);
+    return 0;
+}
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+FINSH_FUNCTION_EXPORT(gui_soak, start or stop the soak test of GUI engine);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(gui_soak, start or stop the soak test of GUI engine);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * File      : headless_fb.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(PKG_USING_GUIENGINE) && defined(GUIENGINE_USING_HEADLESS_FB)
+
+#include <rtgui/rtgui.h>
+#include <rtgui/driver.h>
+#include "headless_fb.h"
+
+/*
+ * A graphic device of the framebuffer in memory, for the simulator of
+ * RT-Thread on host (or a board without panel). The output is compared with
+ * the golden images by the CRC or the dump in HDC, and the benchmark counts
+ * the cycles and instructions by the perf events of Linux.
+ */
+#ifndef GUIENGINE_HEADLESS_WIDTH
+#define GUIENGINE_HEADLESS_WIDTH        480
+#endif
+#ifndef GUIENGINE_HEADLESS_HEIGHT
+#define GUIENGINE_HEADLESS_HEIGHT       272
+#endif
+#ifndef GUIENGINE_HEADLESS_FORMAT
+#define GUIENGINE_HEADLESS_FORMAT       RTGRAPHIC_PIXEL_FORMAT_RGB565
+#define GUIENGINE_HEADLESS_BPP          16
+#endif
+
+#define HFB_PITCH   (GUIENGINE_HEADLESS_WIDTH * GUIENGINE_HEADLESS_BPP / 8)
+
+static struct rt_device _hfb_device;
+static rt_uint32_t _hfb_updates;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t _hfb_framebuffer[HFB_PITCH * GUIENGINE_HEADLESS_HEIGHT];
+
+static rt_err_t _hfb_control(rt_device_t dev, int cmd, void *args)
+{
+    switch (cmd)
+    {
+    case RTGRAPHIC_CTRL_GET_INFO:
+    {
+        struct rt_device_graphic_info *info = (struct rt_device_graphic_info *)args;
+
+        rt_memset(info, 0, sizeof(*info));
+        info->pixel_format = GUIENGINE_HEADLESS_FORMAT;
+        info->bits_per_pixel = GUIENGINE_HEADLESS_BPP;
+        info->width = GUIENGINE_HEADLESS_WIDTH;
+        info->height = GUIENGINE_HEADLESS_HEIGHT;
+        info->framebuffer = _hfb_framebuffer;
+        break;
+    }
+
+    case RTGRAPHIC_CTRL_RECT_UPDATE:
+        /* the framebuffer is the output */
+        _hfb_updates ++;
+        break;
+
+    default:
+        break;
+    }
+
+    return RT_EOK;
+}
+
+rt_uint32_t headless_fb_crc32(void)
+{
+    rt_size_t index;
+    int bit;
+    rt_uint32_t crc = 0xffffffff;
+
+    rtgui_graphic_driver_accel_sync();
+    for (index = 0; index < sizeof(_hfb_framebuffer); index ++)
+    {
+        crc ^= _hfb_framebuffer[index];
+        for (bit = 0; bit < 8; bit ++)
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 0x01));
+    }
+
+    return ~crc;
+}
+
+rt_uint32_t headless_fb_updates(void)
+{
+    return _hfb_updates;
+}
+
+void headless_fb_clear(void)
+{
+    rtgui_graphic_driver_accel_sync();
+    rt_memset(_hfb_framebuffer, 0, sizeof(_hfb_framebuffer));
+    _hfb_updates = 0;
+}
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+
+/* dump the framebuffer in HDC, which is loaded by the image engine and
+ * compared as the golden image */
+int headless_fb_dump(const char *filename)
+{
+    int fd;
+    rt_uint32_t header[4];
+
+    fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd < 0)
+        return -RT_ERROR;
+
+    rt_memcpy(&header[0], "HDC\0", 4);
+    header[1] = GUIENGINE_HEADLESS_WIDTH;
+    header[2] = GUIENGINE_HEADLESS_HEIGHT;
+    header[3] = 1;
+    write(fd, header, sizeof(header));
+    header[0] = GUIENGINE_HEADLESS_FORMAT;
+    write(fd, header, sizeof(header[0]));
+
+    rtgui_graphic_driver_accel_sync();
+    write(fd, _hfb_framebuffer, sizeof(_hfb_framebuffer));
+    close(fd);
+
+    return RT_EOK;
+}
+#endif
+
+#if defined(GUIENGINE_HEADLESS_PERF) && defined(__linux__)
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static int _hfb_perf_fd[2] = {-1, -1};
+
+static int _hfb_perf_open(rt_uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = (group == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    /* the thread calling it, which is the benchmark on simulator */
+    return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+int headless_perf_start(void)
+{
+    if (_hfb_perf_fd[0] < 0)
+    {
+        _hfb_perf_fd[0] = _hfb_perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (_hfb_perf_fd[0] < 0)
+            return -RT_ENOSYS;
+        _hfb_perf_fd[1] = _hfb_perf_open(PERF_COUNT_HW_INSTRUCTIONS, _hfb_perf_fd[0]);
+    }
+
+    ioctl(_hfb_perf_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(_hfb_perf_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    return RT_EOK;
+}
+
+void headless_perf_stop(rt_uint64_t *cycles, rt_uint64_t *instructions)
+{
+    rt_uint64_t value;
+
+    *cycles = *instructions = 0;
+    if (_hfb_perf_fd[0] < 0)
+        return;
+
+    ioctl(_hfb_perf_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if (read(_hfb_perf_fd[0], &value, sizeof(value)) == sizeof(value))
+        *cycles = value;
+    if (_hfb_perf_fd[1] >= 0 && read(_hfb_perf_fd[1], &value, sizeof(value)) == sizeof(value))
+        *instructions = value;
+}
+#endif
+
+int headless_fb_init(void)
+{
+    rt_device_t device = &_hfb_device;
+
+    rt_memset(device, 0, sizeof(*device));
+    device->type = RT_Device_Class_Graphic;
+    device->control = _hfb_control;
+
+    if (rt_device_register(device, "hfb", RT_DEVICE_FLAG_RDWR) != RT_EOK)
+        return -RT_ERROR;
+
+    return rtgui_graphic_set_device(device);
+}
+INIT_DEVICE_EXPORT(headless_fb_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+static void hfb_crc(void)
+{
+    rt_kprintf("hfb,%dx%d,0x%02x,updates %d,crc32 0x%08x\n", GUIENGINE_HEADLESS_WIDTH,
+               GUIENGINE_HEADLESS_HEIGHT, GUIENGINE_HEADLESS_FORMAT, _hfb_updates, headless_fb_crc32());
+}
+FINSH_FUNCTION_EXPORT(hfb_crc, display the CRC of headless framebuffer);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(hfb_crc, display the CRC of headless framebuffer);
+#ifdef RT_USING_DFS
+static int hfb_dump(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        rt_kprintf("usage: hfb_dump <file>\n");
+        return -1;
+    }
+
+    return headless_fb_dump(argv[1]);
+}
+MSH_CMD_EXPORT(hfb_dump, dump the headless framebuffer in HDC);
+#endif
+#endif
+#endif
+
+#endif
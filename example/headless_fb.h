@@ -0,0 +1,45 @@
+/*
+ * File      : headless_fb.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#ifndef __HEADLESS_FB_H__
+#define __HEADLESS_FB_H__
+
+#include <rtthread.h>
+
+int headless_fb_init(void);
+
+/* the CRC32 of framebuffer and the count of screen updates */
+rt_uint32_t headless_fb_crc32(void);
+rt_uint32_t headless_fb_updates(void);
+void headless_fb_clear(void);
+#ifdef RT_USING_DFS
+int headless_fb_dump(const char *filename);
+#endif
+
+#if defined(GUIENGINE_HEADLESS_PERF) && defined(__linux__)
+/* count the cycles and instructions of the calling thread */
+int headless_perf_start(void);
+void headless_perf_stop(rt_uint64_t *cycles, rt_uint64_t *instructions);
+#endif
+
+#endif
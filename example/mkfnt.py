@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+#
+# File      : mkfnt.py
+# This file is part of RT-Thread GUI Engine
+# COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+#
+# Compile a rockbox fnt font (RB11/RB12) to the binary fnt font, which is used
+# in place by rtgui_fnt_map_font_create() or loaded in one read by
+# rtgui_fnt_bin_font_create(). See include/rtgui/font_fnt.h for the layout.
+#
+#   python mkfnt.py -o font12.bin font12.fnt
+#   python mkfnt.py -s font12_map -o font12.c font12.fnt
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-14     Bernard      first version
+
+import argparse
+import struct
+import sys
+
+FNT_MAP_MAGIC = b'RTFN'
+FNT_MAP_VERSION = 1
+# struct fnt_map_header
+HEADER_FORMAT = '<4sHHHHHHIIIIIII'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+def align4(data):
+    return data + b'\0' * (-len(data) & 0x03)
+
+def parse(data):
+    """parse the rockbox fnt font, return the header and the tables"""
+    if data[:4] not in (b'RB11', b'RB12'):
+        sys.exit('not a rockbox fnt font')
+
+    (max_width, height, ascent, depth, first_char, default_char, size,
+     nbits, noffset, nwidth) = struct.unpack_from('<HHHHIIIIII', data, 4)
+    offset = 36
+    bits = data[offset:offset + nbits]
+    offset += nbits
+
+    # the offsets are 16 bits in the small fonts, aligned to their size
+    long_offset = nbits >= 0xFFDB
+    if long_offset:
+        offset += -offset & 0x03
+        offsets = list(struct.unpack_from('<%dI' % noffset, data, offset))
+        offset += noffset * 4
+    else:
+        offset += offset & 0x01
+        offsets = list(struct.unpack_from('<%dH' % noffset, data, offset))
+        offset += noffset * 2
+    widths = bytearray(data[offset:offset + nwidth])
+
+    if len(bits) != nbits or len(widths) != nwidth:
+        sys.exit('the fnt font is truncated')
+    if noffset not in (0, size) or nwidth not in (0, size):
+        sys.exit('the tables of fnt font are not in the size of chars')
+
+    header = dict(max_width=max_width, height=height, ascent=ascent, depth=depth,
+                  first_char=first_char, default_char=default_char, size=size)
+    return header, offsets, widths, bits
+
+def compile_font(data):
+    header, offsets, widths, bits = parse(data)
+    size = header['size']
+
+    # the fixed width font has no table
+    body = b''
+    offset_table = width_table = 0
+    position = HEADER_SIZE
+    if offsets:
+        if not widths:
+            widths = bytearray([header['max_width']]) * size
+        offset_table = position
+        body += struct.pack('<%dI' % size, *offsets)
+        width_table = offset_table + len(body)
+        body = align4(body + bytes(widths))
+        position += len(body)
+
+    header_data = struct.pack(HEADER_FORMAT, FNT_MAP_MAGIC, FNT_MAP_VERSION, HEADER_SIZE,
+                              header['max_width'], header['height'], header['ascent'],
+                              header['depth'], header['first_char'], header['default_char'],
+                              size, offset_table, width_table, position, len(bits))
+    return align4(header_data + body + bits)
+
+def write_c_array(output, symbol, data):
+    with open(output, 'w') as f:
+        f.write('/* generated by mkfnt.py, do not edit */\n')
+        f.write('#include <rtthread.h>\n\n')
+        f.write('ALIGN(4)\nconst rt_uint8_t %s[] =\n{\n' % symbol)
+        for index in range(0, len(data), 16):
+            f.write('    ' + ','.join('0x%02x' % c for c in bytearray(data[index:index + 16])) + ',\n')
+        f.write('};\n')
+        f.write('const rt_uint32_t %s_size = %d;\n' % (symbol, len(data)))
+
+def main():
+    parser = argparse.ArgumentParser(description='compile a rockbox fnt font to the binary fnt font of GUI engine')
+    parser.add_argument('-s', '--symbol', default='fnt_font_map', help='the name of C array')
+    parser.add_argument('-o', '--output', required=True, help='the binary font, or the C file if it ends with .c')
+    parser.add_argument('font')
+    args = parser.parse_args()
+
+    with open(args.font, 'rb') as f:
+        data = compile_font(f.read())
+
+    if args.output.endswith('.c'):
+        write_c_array(args.output, args.symbol, data)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+
+if __name__ == '__main__':
+    main()
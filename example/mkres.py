@@ -0,0 +1,186 @@
+#!/usr/bin/env python
+#
+# File      : mkres.py
+# This file is part of RT-Thread GUI Engine
+# COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+#
+# Convert the images (PNG, JPEG, BMP and the others read by Pillow) to HDC in
+# the pixel format of device, and pack them into a resource archive which is
+# mounted by rtgui_image_res_mount(). See include/rtgui/image_res.h for the
+# layout of archive.
+#
+#   python mkres.py -f rgb565 -o resources_pack.c icons/*.png
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-14     Bernard      first version
+
+import argparse
+import os
+import struct
+import sys
+
+from PIL import Image
+
+# the values of RTGRAPHIC_PIXEL_FORMAT_* in rtdef.h and rtgui/color.h
+PIXEL_FORMAT = {
+    'rgb565':       5,
+    'bgr565':       6,
+    'rgb888':       8,
+    'argb888':      9,
+    'argb888_pre':  0x40,
+    'argb4444_pre': 0x41,
+}
+
+HDC_COMPRESS_RLE = 2
+RLE_BAND_HEIGHT = 16
+
+def pack_pixel(fmt, r, g, b, a):
+    if fmt == 'rgb565':
+        return struct.pack('<H', ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    if fmt == 'bgr565':
+        return struct.pack('<H', ((b >> 3) << 11) | ((g >> 2) << 5) | (r >> 3))
+    if fmt == 'rgb888':
+        return struct.pack('<BBB', b, g, r)
+    if fmt == 'argb888':
+        return struct.pack('<BBBB', b, g, r, a)
+
+    # premultiplied by alpha
+    r, g, b = (r * a + 127) // 255, (g * a + 127) // 255, (b * a + 127) // 255
+    if fmt == 'argb888_pre':
+        return struct.pack('<BBBB', b, g, r, a)
+    return struct.pack('<H', ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4))
+
+def rle_row(pixels, bpp):
+    """encode a row into the runs of HDC_COMPRESS_RLE"""
+    out = bytearray()
+    count = len(pixels) // bpp
+    x = 0
+    while x < count:
+        pixel = pixels[x * bpp:(x + 1) * bpp]
+        run = 1
+        while x + run < count and run < 128 and pixels[(x + run) * bpp:(x + run + 1) * bpp] == pixel:
+            run += 1
+        if run > 1:
+            out.append(0x80 | (run - 1))
+            out += pixel
+            x += run
+            continue
+
+        # the literal pixels until a repeated one
+        run = 1
+        while x + run < count and run < 128:
+            if x + run + 1 < count and \
+               pixels[(x + run) * bpp:(x + run + 1) * bpp] == pixels[(x + run + 1) * bpp:(x + run + 2) * bpp]:
+                break
+            run += 1
+        out.append(run - 1)
+        out += pixels[x * bpp:(x + run) * bpp]
+        x += run
+    return bytes(out)
+
+def convert(filename, fmt, alpha_fmt, rle):
+    """convert an image to HDC, the opaque image keeps the format of device"""
+    image = Image.open(filename).convert('RGBA')
+    width, height = image.size
+    data = list(image.getdata())
+
+    if all(p[3] == 255 for p in data):
+        pixel_format = fmt
+    else:
+        pixel_format = alpha_fmt
+
+    rows = []
+    for y in range(height):
+        row = bytearray()
+        for r, g, b, a in data[y * width:(y + 1) * width]:
+            row += pack_pixel(pixel_format, r, g, b, a)
+        rows.append(bytes(row))
+
+    bpp = len(rows[0]) // width if width else 0
+    if not rle:
+        header = struct.pack('<4sIIII', b'HDC\0', width, height, 1, PIXEL_FORMAT[pixel_format])
+        return header + b''.join(rows)
+
+    # version 3, the rows in bands of RLE with the index of bands
+    bands = []
+    for y in range(0, height, RLE_BAND_HEIGHT):
+        bands.append(b''.join(rle_row(row, bpp) for row in rows[y:y + RLE_BAND_HEIGHT]))
+
+    header = struct.pack('<4sIIII', b'HDC\0', width, height, 3, PIXEL_FORMAT[pixel_format])
+    header += struct.pack('<HBB', RLE_BAND_HEIGHT, HDC_COMPRESS_RLE, 0)
+
+    # the offsets of bands are from the beginning of HDC
+    offset = len(header) + (len(bands) + 1) * 4
+    index = []
+    for band in bands:
+        index.append(offset)
+        offset += len(band)
+    index.append(offset)
+
+    return header + struct.pack('<%dI' % len(index), *index) + b''.join(bands)
+
+def align4(data):
+    return data + b'\0' * (-len(data) & 0x03)
+
+def pack(images):
+    """pack the (name, HDC) into an archive, the entries are sorted by name"""
+    images = sorted(images, key=lambda item: item[0].encode('utf-8'))
+
+    names = b''
+    offset = 8 + len(images) * 12
+    name_offsets = []
+    for name, hdc in images:
+        name_offsets.append(offset + len(names))
+        names += name.encode('utf-8') + b'\0'
+    names = align4(names)
+    offset += len(names)
+
+    entries = b''
+    blobs = b''
+    for (name, hdc), name_offset in zip(images, name_offsets):
+        entries += struct.pack('<III', name_offset, offset + len(blobs), len(hdc))
+        blobs += align4(hdc)
+
+    return struct.pack('<4sI', b'GRES', len(images)) + entries + names + blobs
+
+def write_c_array(output, symbol, data):
+    with open(output, 'w') as f:
+        f.write('/* generated by mkres.py, do not edit */\n')
+        f.write('#include <rtthread.h>\n\n')
+        f.write('ALIGN(4)\nconst rt_uint8_t %s[] =\n{\n' % symbol)
+        for index in range(0, len(data), 16):
+            f.write('    ' + ','.join('0x%02x' % c for c in bytearray(data[index:index + 16])) + ',\n')
+        f.write('};\n')
+
+def main():
+    parser = argparse.ArgumentParser(description='convert the images to a resource archive of GUI engine')
+    parser.add_argument('-f', '--format', default='rgb565', choices=['rgb565', 'bgr565', 'rgb888', 'argb888'],
+                        help='the pixel format of device for the opaque images')
+    parser.add_argument('-a', '--alpha', default='argb888_pre',
+                        choices=['argb888', 'argb888_pre', 'argb4444_pre'],
+                        help='the pixel format for the images with alpha channel')
+    parser.add_argument('-z', '--rle', action='store_true', help='compress the images in bands of RLE')
+    parser.add_argument('-s', '--symbol', default='resources_pack', help='the name of C array')
+    parser.add_argument('-o', '--output', required=True, help='the archive, or the C file if it ends with .c')
+    parser.add_argument('images', nargs='+')
+    args = parser.parse_args()
+
+    images = []
+    for filename in args.images:
+        name = os.path.splitext(os.path.basename(filename))[0]
+        images.append((name, convert(filename, args.format, args.alpha, args.rle)))
+
+    names = [name for name, hdc in images]
+    if len(set(names)) != len(names):
+        sys.exit('the names of images are duplicated')
+
+    data = pack(images)
+    if args.output.endswith('.c'):
+        write_c_array(args.output, args.symbol, data)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+
+if __name__ == '__main__':
+    main()
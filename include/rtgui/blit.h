@@ -70,6 +70,14 @@
 {                                                                       \
     Pixel = (a<<24)|(r<<16)|(g<<8)|b;                                   \
 }
+#define ARGB4444_FROM_RGBA(Pixel, r, g, b, a)                           \
+{                                                                       \
+    Pixel = ((a>>4)<<12)|((r>>4)<<8)|((g>>4)<<4)|(b>>4);                \
+}
+#define RGB332_FROM_RGB(Pixel, r, g, b)                                 \
+{                                                                       \
+    Pixel = (r&0xE0)|((g>>3)&0x1C)|(b>>6);                              \
+}
 #define RGBA8888_FROM_RGBA(Pixel, r, g, b, a)                           \
 {                                                                       \
     Pixel = (r<<24)|(g<<16)|(b<<8)|a;                                   \
@@ -91,13 +99,32 @@
     Pixel = (a<<30)|(r<<20)|(g<<10)|b;                                  \
 }
 
+/* the RGB565 pixel expanded to ARGB8888 by the table of GUIENGINE_BLIT_565_LUT */
+#if GUIENGINE_BLIT_565_LUT == 2
+#define RTGUI_BLIT_FROM_565(Pixel)                                      \
+    rtgui_blit_565_full[(rt_uint16_t)(Pixel)]
+#elif GUIENGINE_BLIT_565_LUT == 1
+#define RTGUI_BLIT_FROM_565(Pixel)                                      \
+    (rtgui_blit_565_split[((Pixel)&0xFF)*2] + rtgui_blit_565_split[(((Pixel)>>8)&0xFF)*2+1])
+#endif
+
 /* Load pixel of the specified format from a buffer and get its R-G-B values */
+#ifdef RTGUI_BLIT_FROM_565
+#define RGB_FROM_RGB565(Pixel, r, g, b)                                 \
+{                                                                       \
+    rt_uint32_t _c = RTGUI_BLIT_FROM_565(Pixel);                        \
+    r = ((_c>>16)&0xFF);                                                \
+    g = ((_c>>8)&0xFF);                                                 \
+    b = (_c&0xFF);                                                      \
+}
+#else
 #define RGB_FROM_RGB565(Pixel, r, g, b)                                 \
     {                                                                   \
     r = rtgui_blit_expand_byte[3][((Pixel&0xF800)>>11)];                \
     g = rtgui_blit_expand_byte[2][((Pixel&0x07E0)>>5)];                 \
     b = rtgui_blit_expand_byte[3][(Pixel&0x001F)];                      \
 }
+#endif
 #define RGB_FROM_BGR565(Pixel, r, g, b)                                 \
     {                                                                   \
     b = rtgui_blit_expand_byte[3][((Pixel&0xF800)>>11)];                \
@@ -117,6 +144,20 @@
     b = (Pixel&0xFF);                                                   \
 }
 
+#define RGB_FROM_RGB332(Pixel, r, g, b)                                 \
+{                                                                       \
+    r = rtgui_blit_expand_byte[5][((Pixel&0xE0)>>5)];                   \
+    g = rtgui_blit_expand_byte[5][((Pixel&0x1C)>>2)];                   \
+    b = rtgui_blit_expand_byte[6][(Pixel&0x03)];                        \
+}
+#define RGBA_FROM_ARGB4444(Pixel, r, g, b, a)                           \
+{                                                                       \
+    r = ((Pixel>>8)&0x0F)*0x11;                                         \
+    g = ((Pixel>>4)&0x0F)*0x11;                                         \
+    b = (Pixel&0x0F)*0x11;                                              \
+    a = (Pixel>>12)*0x11;                                               \
+}
+
 #define RGBA_FROM_RGBA8888(Pixel, r, g, b, a)                           \
 {                                                                       \
     r = (Pixel>>24);                                                    \
@@ -200,6 +241,11 @@ struct rtgui_blit_info
     rt_uint8_t src_fmt;
     rt_uint8_t dst_fmt;
     rt_uint8_t r, g, b, a;
+    /* the source colors are modulated by r, g, b, the color of ALPHA source is them anyway */
+    rt_uint8_t tint;
+
+    /* the colors of P8 source, indexed by the pixels */
+    const rtgui_color_t *palette;
 };
 
 struct rtgui_image_info
@@ -209,16 +255,46 @@ struct rtgui_image_info
 
     rt_uint8_t src_fmt;
     rt_uint8_t a;
+    /* the colors of source are multiplied by it, RTGUI_BLIT_NO_TINT for none */
+    rtgui_color_t tint;
+};
+#define RTGUI_BLIT_NO_TINT      RTGUI_RGB(255, 255, 255)
+
+/*
+ * The YUV frame of camera or video in the formats RTGUI_OVERLAY_FMT_*. The
+ * chroma planes follow the Y plane in the pitch of Y, of half pitch in I420.
+ */
+struct rtgui_yuv_info
+{
+    const rt_uint8_t *pixels;
+    int pitch;
+    int w, h;
+
+    rt_uint8_t format;
+    /* bilinear in the scale, otherwise the nearest */
+    rt_uint8_t smooth;
 };
 
 extern const rt_uint8_t* rtgui_blit_expand_byte[9];
+/* the ARGB8888 of the low byte at [i * 2] and the high byte at [i * 2 + 1] */
+extern const rt_uint32_t rtgui_blit_565_split[512];
+#if GUIENGINE_BLIT_565_LUT == 2
+extern const rt_uint32_t rtgui_blit_565_full[65536];
+#endif
 
 typedef void (*rtgui_blit_line_func)(rt_uint8_t *dst, rt_uint8_t *src, int line);
 rtgui_blit_line_func rtgui_blit_line_get(int dst_bpp, int src_bpp);
 rtgui_blit_line_func rtgui_blit_line_get_inv(int dst_bpp, int src_bpp);
 
 void rtgui_blit(struct rtgui_blit_info * info);
+/* copy the region of pixels from the place (-dx, -dy) away */
+void rtgui_blit_copy_region(rt_uint8_t *pixels, int pitch, rt_uint8_t format,
+                            rtgui_region_t *region, int dx, int dy);
 void rtgui_image_info_blit(struct rtgui_image_info* image, struct rtgui_dc* dc, struct rtgui_rect *dc_rect);
+/* convert the YUV frame in the scale to the destination of blit info */
+void rtgui_blit_yuv(const struct rtgui_yuv_info *yuv, struct rtgui_blit_info *info);
+/* draw the YUV frame scaled to the rect of dc, such as the preview without overlay plane */
+void rtgui_yuv_info_blit(const struct rtgui_yuv_info *yuv, struct rtgui_dc *dc, struct rtgui_rect *dc_rect);
 
 #endif
 
@@ -57,6 +57,45 @@ extern "C" {
 #define RTGUI_RGB_R(c)  (((c) >> 16) & 0xff)
 #define RTGUI_RGB_A(c)  (((c) >> 24) & 0xff)
 
+/*
+ * The pixel formats with the color premultiplied by alpha, which are only
+ * used in GUI engine:
+ *
+ *               bit          bit
+ * ARGB888_PRE   31 A,R,G,B   0
+ * ARGB4444_PRE  15 A,R,G,B   0
+ *
+ * ARGB4444 is the straight one of them, 4 bits each channel in half the size
+ * of ARGB888. RGB332 of the driver is a buffer dc format as well.
+ *
+ * and the 8bit formats of one byte each pixel:
+ *
+ * L8            the luminance, drawn in grey
+ * P8            the index to the palette of buffer dc
+ *
+ * The ALPHA (A8) buffer dc is a coverage mask, which is drawn in the alpha
+ * of color and filled through with a color. A4 packs two coverages in a byte,
+ * the high nibble first, it's only a source of rtgui_blit.
+ */
+#ifndef RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE
+#define RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE  0x40
+#endif
+#ifndef RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE
+#define RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE 0x41
+#endif
+#ifndef RTGRAPHIC_PIXEL_FORMAT_L8
+#define RTGRAPHIC_PIXEL_FORMAT_L8           0x42
+#endif
+#ifndef RTGRAPHIC_PIXEL_FORMAT_P8
+#define RTGRAPHIC_PIXEL_FORMAT_P8           0x43
+#endif
+#ifndef RTGRAPHIC_PIXEL_FORMAT_A4
+#define RTGRAPHIC_PIXEL_FORMAT_A4           0x44
+#endif
+#ifndef RTGRAPHIC_PIXEL_FORMAT_ARGB4444
+#define RTGRAPHIC_PIXEL_FORMAT_ARGB4444     0x45
+#endif
+
 extern const rtgui_color_t default_foreground;
 extern const rtgui_color_t default_background;
 
@@ -138,6 +177,42 @@ rt_inline rtgui_color_t rtgui_color_from_565(rt_uint16_t pixel)
     return color;
 }
 
+#ifdef GUIENGINE_USING_DITHER
+/* the offsets of 4x4 Bayer matrix in 0x00RRGGBB, below a step of 565 */
+extern const rt_uint32_t rtgui_dither_565[4][4];
+
+/* add the dither offset at (x, y) to the color, which is truncated to 565 then */
+rt_inline rtgui_color_t rtgui_color_dither_565(rtgui_color_t c, int x, int y)
+{
+    rt_uint32_t d, rb, g, carry;
+
+    /* R and B in parallel, saturated by the carries */
+    d = rtgui_dither_565[y & 3][x & 3];
+    rb = (c & 0xff00ff) + (d & 0xff00ff);
+    carry = rb & 0x1000100;
+    rb = (rb | (carry - (carry >> 8))) & 0xff00ff;
+    g = (c & 0xff00) + (d & 0xff00);
+    if (g & 0x10000) g = 0xff00;
+
+    return (c & 0xff000000) | rb | g;
+}
+
+rt_inline rt_uint16_t rtgui_color_to_565_dither(rtgui_color_t c, int x, int y)
+{
+    return rtgui_color_to_565(rtgui_color_dither_565(c, x, y));
+}
+#endif
+
+#ifdef GUIENGINE_USING_COVERAGE_GAMMA
+extern rt_uint8_t rtgui_coverage_gamma[256];
+
+/* build the coverage table of gamma in 1/10, 10 is the linear coverage */
+void rtgui_color_set_coverage_gamma(int gamma);
+#define RTGUI_COVERAGE(a)   (rtgui_coverage_gamma[(rt_uint8_t)(a)])
+#else
+#define RTGUI_COVERAGE(a)   (a)
+#endif
+
 /* convert rtgui color to BBBBBGGGGGGRRRRR */
 rt_inline rt_uint16_t rtgui_color_to_565p(rtgui_color_t c)
 {
@@ -161,6 +236,44 @@ rt_inline rtgui_color_t rtgui_color_from_565p(rt_uint16_t pixel)
     return color;
 }
 
+/* convert rtgui color to RRRGGGBB */
+rt_inline rt_uint8_t rtgui_color_to_332(rtgui_color_t c)
+{
+    return (rt_uint8_t)((RTGUI_RGB_R(c) & 0xe0) | ((RTGUI_RGB_G(c) >> 3) & 0x1c) | (RTGUI_RGB_B(c) >> 6));
+}
+
+rt_inline rtgui_color_t rtgui_color_from_332(rt_uint8_t pixel)
+{
+    rt_uint32_t r, g, b;
+
+    /* replicate the bits, 0xe0 is 0xff */
+    r = pixel & 0xe0;
+    r |= (r >> 3) | (r >> 6);
+    g = (pixel << 3) & 0xe0;
+    g |= (g >> 3) | (g >> 6);
+    b = pixel & 0x03;
+    b |= (b << 2) | (b << 4) | (b << 6);
+
+    return RTGUI_RGB(r, g, b);
+}
+
+/* convert rtgui color to AAAARRRRGGGGBBBB */
+rt_inline rt_uint16_t rtgui_color_to_4444(rtgui_color_t c)
+{
+    return (rt_uint16_t)(((c >> 16) & 0xf000) | ((c >> 12) & 0x0f00) |
+                         ((c >> 8) & 0x00f0) | ((c >> 4) & 0x000f));
+}
+
+rt_inline rtgui_color_t rtgui_color_from_4444(rt_uint16_t pixel)
+{
+    rt_uint32_t c;
+
+    c = ((pixel & 0xf000) << 16) | ((pixel & 0x0f00) << 12) |
+        ((pixel & 0x00f0) << 8) | ((pixel & 0x000f) << 4);
+
+    return c | (c >> 4);
+}
+
 /* convert rtgui color to RGB */
 rt_inline rt_uint32_t rtgui_color_to_888(rtgui_color_t c)
 {
@@ -179,6 +292,52 @@ rt_inline rtgui_color_t rtgui_color_from_888(rt_uint32_t pixel)
     return color;
 }
 
+/* convert rtgui color to the color premultiplied by alpha */
+rt_inline rtgui_color_t rtgui_color_premultiply(rtgui_color_t c)
+{
+    rt_uint32_t a, rb, g;
+
+    a = RTGUI_RGB_A(c);
+    if (a == 255) return c;
+
+    /* x * a / 255 with rounding, R and B in parallel */
+    rb = (c & 0xff00ff) * a + 0x800080;
+    rb = ((rb + ((rb >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+    g = RTGUI_RGB_G(c) * a + 0x80;
+    g = ((g + (g >> 8)) >> 8) & 0xff;
+
+    return (a << 24) | rb | (g << 8);
+}
+
+rt_inline rtgui_color_t rtgui_color_unpremultiply(rtgui_color_t c)
+{
+    rt_uint32_t a;
+
+    a = RTGUI_RGB_A(c);
+    if (a == 255 || a == 0) return c;
+
+    return RTGUI_ARGB(a, RTGUI_RGB_R(c) * 255 / a, RTGUI_RGB_G(c) * 255 / a,
+                      RTGUI_RGB_B(c) * 255 / a);
+}
+
+/*
+ * The pixel formats drawn to with GUIENGINE_FIXED_PIXEL_FORMAT, the one of
+ * screen, ARGB888 of the alpha and ALPHA of the masks. The format of kernel
+ * is a constant, so the kernels of the other formats are folded to RT_NULL and
+ * dropped by the compiler.
+ */
+#ifdef GUIENGINE_FIXED_PIXEL_FORMAT
+#define RTGUI_PIXEL_FORMAT_DRAWN(fmt)       ((fmt) == GUIENGINE_FIXED_PIXEL_FORMAT || \
+                                             (fmt) == RTGRAPHIC_PIXEL_FORMAT_ARGB888 || \
+                                             (fmt) == RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+#else
+#define RTGUI_PIXEL_FORMAT_DRAWN(fmt)       1
+#endif
+#define RTGUI_PIXEL_FORMAT_FUNC(fmt, func)  (RTGUI_PIXEL_FORMAT_DRAWN(fmt) ? (func) : RT_NULL)
+
+/* get the native pixel of color, RT_FALSE if the format is not supported */
+rt_bool_t rtgui_color_to_pixel(rt_uint8_t pixel_format, rtgui_color_t c, rt_uint32_t *pixel);
+
 /* get the bits of specified pixle format */
 rt_uint8_t rtgui_color_get_bits(rt_uint8_t pixel_format) RTGUI_PURE;
 /* get the bytes of specified pixle format */
@@ -31,6 +31,7 @@ extern "C" {
 #include <rtgui/rtgui.h>
 #include <rtgui/font.h>
 #include <rtgui/driver.h>
+#include <rtgui/profile.h>
 #include <rtgui/widgets/widget.h>
 
 #define RTGUI_DC(dc)        ((struct rtgui_dc*)(dc))
@@ -46,6 +47,45 @@ enum rtgui_dc_type
     RTGUI_DC_BUFFER,
 };
 
+/*
+ * The horizontal span of filling, the x1, x2 and y are the same as the
+ * parameters of draw_hline.
+ */
+struct rtgui_span
+{
+    rt_int16_t x1, x2;
+    rt_int16_t y;
+};
+
+enum rtgui_gradient_type
+{
+    RTGUI_GRADIENT_HORIZONTAL,
+    RTGUI_GRADIENT_VERTICAL,
+    /* from the center of rect to the ellipse in it */
+    RTGUI_GRADIENT_RADIAL,
+};
+
+/* a color of gradient at offset, 0 is the start and 255 is the end */
+struct rtgui_gradient_stop
+{
+    rt_uint8_t offset;
+    rtgui_color_t color;
+};
+
+/* the ramp of gradient is built once, and looked up in the fills */
+struct rtgui_gradient
+{
+    rt_uint8_t type;
+    rt_uint8_t opaque;
+    rtgui_color_t ramp[256];
+    /* the index of ramp for the squared distance of radial gradient */
+    rt_uint8_t radial[1024];
+};
+
+struct rtgui_gradient *rtgui_gradient_create(enum rtgui_gradient_type type,
+                                             const struct rtgui_gradient_stop *stops, int count);
+void rtgui_gradient_destroy(struct rtgui_gradient *gradient);
+
 struct rtgui_dc_engine
 {
     /* interface */
@@ -56,6 +96,8 @@ struct rtgui_dc_engine
     void (*fill_rect)(struct rtgui_dc *dc, rtgui_rect_t *rect);
     void (*blit_line)(struct rtgui_dc *dc, int x1, int x2, int y, rt_uint8_t *line_data);
     void (*blit)(struct rtgui_dc *dc, struct rtgui_point *dc_point, struct rtgui_dc *dest, rtgui_rect_t *rect);
+    /* fill the spans with foreground, the spans are sorted by y */
+    void (*fill_spans)(struct rtgui_dc *dc, const struct rtgui_span *spans, int count);
 
     rt_bool_t (*fini)(struct rtgui_dc *dc);
 };
@@ -100,6 +142,12 @@ struct rtgui_dc_hw
  *
  * All the operations on this device context is reflected to the memory buffer.
  */
+/* the pixels shared by the copy-on-write buffer dcs */
+struct rtgui_dc_buffer_share
+{
+    rt_uint32_t ref;
+};
+
 struct rtgui_dc_buffer
 {
     struct rtgui_dc parent;
@@ -110,6 +158,8 @@ struct rtgui_dc_buffer
     /* pixel format */
     rt_uint8_t pixel_format;
     rt_uint8_t blend_mode;		/* RTGUI_BLENDMODE: None/Blend/Add/Mod */
+    /* the memory tag of pixels */
+    rt_uint8_t pixel_tag;
 
     /* width and height */
     rt_uint16_t width, height;
@@ -123,8 +173,12 @@ struct rtgui_dc_buffer
 
 	/* pixel alpha */
     rt_uint8_t pixel_alpha;
-    /* pixel data */
+    /* pixel data, RT_NULL before the first draw of lazy buffer */
     rt_uint8_t *pixel;
+    /* the pixels are shared with the other buffer dcs until written */
+    struct rtgui_dc_buffer_share *share;
+    /* the palette of P8 pixels */
+    struct rtgui_image_palette *palette;
 };
 
 #define RTGUI_DC_FC(dc)         (rtgui_dc_get_gc(RTGUI_DC(dc))->foreground)
@@ -135,12 +189,85 @@ struct rtgui_dc_buffer
 /* create a buffer dc */
 struct rtgui_dc *rtgui_dc_buffer_create(int width, int height);
 struct rtgui_dc *rtgui_dc_buffer_create_pixformat(rt_uint8_t pixel_format, int w, int h);
+/* the pixels are allocated in the memory of tag, see rtgui_mem_set_region */
+struct rtgui_dc *rtgui_dc_buffer_create_tag(rt_uint8_t pixel_format, int w, int h, int tag);
 #ifdef GUIENGINE_IMAGE_CONTAINER
 struct rtgui_dc *rtgui_img_dc_create_pixformat(rt_uint8_t pixel_format, rt_uint8_t *pixel, 
     struct rtgui_image_item *image_item);
 #endif
+/* the pixel_tag of the pixels owned by the caller, they are not freed with dc */
+#define RTGUI_DC_PIXEL_EXTERN   0xFF
+/* the buffer dc on the pixels of caller, such as a slab in SDRAM, in the pitch
+ * of bytes (0 for the width of pixels) */
+struct rtgui_dc *rtgui_dc_buffer_create_from_pixel(rt_uint8_t pixel_format, int w, int h,
+                                                   int pitch, rt_uint8_t *pixel);
+/* the pixels are allocated on the first draw */
+struct rtgui_dc *rtgui_dc_buffer_create_lazy(rt_uint8_t pixel_format, int w, int h);
+/* the copy shares the pixels of dc, they are copied when either side is written */
 struct rtgui_dc *rtgui_dc_buffer_create_from_dc(struct rtgui_dc* dc);
 void rtgui_dc_buffer_set_alpha(struct rtgui_dc* dc, rt_uint8_t pixel_alpha);
+/* set the colors of P8 buffer dc, the pixels should be less than ncolors */
+rt_err_t rtgui_dc_buffer_set_palette(struct rtgui_dc *dc, const rtgui_color_t *colors, int ncolors);
+
+/* the A8 mask of coverage, filled through with a color or gradient */
+struct rtgui_dc *rtgui_dc_mask_create(int w, int h);
+void rtgui_dc_mask_fill(struct rtgui_dc *mask, struct rtgui_point *point,
+                        struct rtgui_dc *dest, rtgui_rect_t *rect, rtgui_color_t color);
+void rtgui_dc_mask_fill_gradientv(struct rtgui_dc *mask, struct rtgui_point *point,
+                                  struct rtgui_dc *dest, rtgui_rect_t *rect,
+                                  rtgui_color_t c1, rtgui_color_t c2);
+void rtgui_dc_mask_pack_a4(struct rtgui_dc *mask, rt_uint8_t *pixels, int pitch);
+/* blur the mask by the box of radius, 3 passes are about a gaussian */
+rt_err_t rtgui_dc_mask_blur(struct rtgui_dc *mask, int radius, int passes);
+
+/* the AA shapes of themed widgets, their masks are cached with GUIENGINE_USING_SHAPE_CACHE */
+enum rtgui_shape_type
+{
+    RTGUI_SHAPE_ROUND_RECT,
+    RTGUI_SHAPE_ROUND_FRAME,
+    RTGUI_SHAPE_CIRCLE,
+    RTGUI_SHAPE_RING,
+    /* the round rect blurred in the stroke, inside of the rect */
+    RTGUI_SHAPE_SHADOW,
+};
+void rtgui_dc_fill_shape(struct rtgui_dc *dc, enum rtgui_shape_type type, rtgui_rect_t *rect,
+                         int radius, int stroke);
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+int rtgui_dc_shape_init(void);
+void rtgui_dc_shape_cache_flush(void);
+#endif
+/*
+ * Draw a text which is not changed, such as a caption. With
+ * GUIENGINE_USING_TEXT_CACHE its A8 mask of the font and text style is kept
+ * in the shape cache and the draw is one blit of it in foreground.
+ */
+void rtgui_dc_draw_text_cached(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect);
+#ifdef GUIENGINE_USING_TEXT_CACHE
+/* drop the masks of the texts in font, such as the font is removed */
+void rtgui_dc_text_cache_remove(struct rtgui_font *font);
+#endif
+
+/* the scale of the edges and center in the nine-patch blit */
+enum rtgui_patch_mode
+{
+    RTGUI_PATCH_STRETCH,
+    RTGUI_PATCH_TILE,
+};
+/* blit the buffer dc to the rect, the center rect of source is scaled and the corners are not */
+void rtgui_dc_blit_nine_patch(struct rtgui_dc *src, const rtgui_rect_t *center,
+                              struct rtgui_dc *dest, const rtgui_rect_t *rect,
+                              enum rtgui_patch_mode mode);
+
+#ifdef GUIENGINE_USING_DC_POOL
+/* the pool of the pixels of buffer dc */
+void *rtgui_dc_pool_alloc(rt_size_t size);
+void rtgui_dc_pool_free(void *ptr);
+void rtgui_dc_pool_shrink(void);
+void rtgui_dc_pool_set_budget(rt_size_t budget);
+#ifdef RT_USING_MEMHEAP
+void rtgui_dc_pool_set_heap(struct rt_memheap *heap);
+#endif
+#endif
 
 /* create a widget dc */
 struct rtgui_dc *rtgui_dc_widget_create(struct rtgui_widget * owner);
@@ -159,7 +286,10 @@ struct rtgui_dc *rtgui_dc_hw_create(rtgui_widget_t *owner);
 struct rtgui_dc *rtgui_dc_client_create(rtgui_widget_t *owner);
 void rtgui_dc_client_init(rtgui_widget_t *owner);
 
+/* the pixels to be written, the shared or lazy pixels are owned first */
 rt_uint8_t *rtgui_dc_buffer_get_pixel(struct rtgui_dc *dc);
+/* the pixels only to be read, they may be shared with the other buffer dcs */
+rt_uint8_t *rtgui_dc_buffer_read_pixel(struct rtgui_dc *dc);
 
 void rtgui_dc_draw_line(struct rtgui_dc *dc, int x1, int y1, int x2, int y2);
 void rtgui_dc_draw_rect(struct rtgui_dc *dc, struct rtgui_rect *rect);
@@ -169,11 +299,25 @@ void rtgui_dc_fill_round_rect(struct rtgui_dc *dc, struct rtgui_rect *rect, int
 /** Fill a vertical gradient rect from @c1 to @c2 */
 void rtgui_dc_fill_gradient_rectv(struct rtgui_dc *dc, rtgui_rect_t *rect,
                                   rtgui_color_t c1, rtgui_color_t c2);
+/** Fill the rect with a gradient created by rtgui_gradient_create */
+void rtgui_dc_fill_gradient(struct rtgui_dc *dc, rtgui_rect_t *rect, const struct rtgui_gradient *gradient);
 void rtgui_dc_draw_annulus(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r1, rt_int16_t r2, rt_int16_t start, rt_int16_t end);
 void rtgui_dc_draw_pie(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r, rt_int16_t start, rt_int16_t end);
 void rtgui_dc_fill_pie(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r, rt_int16_t start, rt_int16_t end);
+/* fill the sector of annulus between r1 and r2 in spans, the pie is the annulus of r1 = 0 */
+void rtgui_dc_fill_annulus(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r1, rt_int16_t r2,
+                           rt_int16_t start, rt_int16_t end);
 
 void rtgui_dc_draw_text(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect);
+void rtgui_dc_draw_text_run(struct rtgui_dc *dc, struct rtgui_text_run *run, struct rtgui_rect *rect);
+/*
+ * Draw the text rotated counterclockwise in degrees, such as 90 for the
+ * label of y axis. The multiples of 90 are drawn by the glyph run rotating
+ * the glyphs, and the text align of dc is in the direction of text. The
+ * other angles are rendered in a buffer rotated onto dc once.
+ */
+void rtgui_dc_draw_text_rotated(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect, int angle);
+void rtgui_dc_draw_text_layout(struct rtgui_dc *dc, struct rtgui_text_layout *layout, struct rtgui_rect *rect);
 void rtgui_dc_draw_text_stroke(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect,
                                rtgui_color_t color_stroke, rtgui_color_t color_core);
 
@@ -196,9 +340,19 @@ void rtgui_dc_draw_arc(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16
 void rtgui_dc_draw_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry);
 void rtgui_dc_fill_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry);
 
+/*
+ * fill the rounded rows of the shape, in which the corners are centered at
+ * (x1, y1) - (x2, y2). It fills the rows [y1 - ry, y1] and [y2, y2 + ry],
+ * and the ellipse or circle is the shape with x1 == x2 and y1 == y2.
+ */
+void rtgui_dc_fill_round_spans(struct rtgui_dc *dc, int x1, int y1, int x2, int y2, int rx, int ry);
+
 /* alpha blending functions */
 void rtgui_dc_draw_aa_line(struct rtgui_dc * dst,int x1,int y1,int x2,int y2);
 void rtgui_dc_draw_aa_lines(struct rtgui_dc * dst,const struct rtgui_point * points,int count);
+/* draw the segments of polyline from points[start], the appended points of chart are drawn only */
+void rtgui_dc_draw_aa_polyline(struct rtgui_dc *dst, const struct rtgui_point *points, int count, int start);
+void rtgui_dc_fill_aa_polygon(struct rtgui_dc *dc, const int *vx, const int *vy, int count);
 
 void rtgui_dc_blend_point(struct rtgui_dc * dst,int x,int y,enum RTGUI_BLENDMODE blendMode,rt_uint8_t r,rt_uint8_t g,rt_uint8_t b,rt_uint8_t a);
 void rtgui_dc_blend_points(struct rtgui_dc * dst,const rtgui_point_t * points,int count,enum RTGUI_BLENDMODE blendMode,rt_uint8_t r,rt_uint8_t g,rt_uint8_t b,rt_uint8_t a);
@@ -211,9 +365,14 @@ void rtgui_dc_blend_fill_rects(struct rtgui_dc * dst,const rtgui_rect_t * rects,
 
 void rtgui_dc_draw_aa_circle(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r);
 void rtgui_dc_draw_aa_ellipse(struct rtgui_dc *dc, rt_int16_t  x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry);
+void rtgui_dc_fill_aa_circle(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r);
+void rtgui_dc_fill_aa_ellipse(struct rtgui_dc *dc, rt_int16_t  x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry);
 
 int rtgui_dc_draw_thick_line(struct rtgui_dc * dst, rt_int16_t x1, rt_int16_t y1, rt_int16_t x2, rt_int16_t y2, rt_uint8_t width);
 
+/* get pixel format */
+rt_uint8_t rtgui_dc_get_pixel_format(struct rtgui_dc *dc);
+
 /*
  * dc inline function
  *
@@ -226,7 +385,11 @@ int rtgui_dc_draw_thick_line(struct rtgui_dc * dst, rt_int16_t x1, rt_int16_t y1
  */
 rt_inline void rtgui_dc_draw_point(struct rtgui_dc *dc, int x, int y)
 {
+    RTGUI_PROFILE_DECLARE;
+
+    RTGUI_PROFILE_BEGIN();
     dc->engine->draw_point(dc, x, y);
+    RTGUI_PROFILE_END(RTGUI_PROFILE_POINT, 1);
 }
 
 /*
@@ -234,7 +397,11 @@ rt_inline void rtgui_dc_draw_point(struct rtgui_dc *dc, int x, int y)
  */
 rt_inline void rtgui_dc_draw_color_point(struct rtgui_dc *dc, int x, int y, rtgui_color_t color)
 {
+    RTGUI_PROFILE_DECLARE;
+
+    RTGUI_PROFILE_BEGIN();
     dc->engine->draw_color_point(dc, x, y, color);
+    RTGUI_PROFILE_END(RTGUI_PROFILE_POINT, 1);
 }
 
 /*
@@ -242,7 +409,11 @@ rt_inline void rtgui_dc_draw_color_point(struct rtgui_dc *dc, int x, int y, rtgu
  */
 rt_inline void rtgui_dc_draw_vline(struct rtgui_dc *dc, int x, int y1, int y2)
 {
+    RTGUI_PROFILE_DECLARE;
+
+    RTGUI_PROFILE_BEGIN();
     dc->engine->draw_vline(dc, x, y1, y2);
+    RTGUI_PROFILE_END(RTGUI_PROFILE_LINE, y2 > y1 ? y2 - y1 : y1 - y2);
 }
 
 /*
@@ -250,7 +421,38 @@ rt_inline void rtgui_dc_draw_vline(struct rtgui_dc *dc, int x, int y1, int y2)
  */
 rt_inline void rtgui_dc_draw_hline(struct rtgui_dc *dc, int x1, int x2, int y)
 {
+    RTGUI_PROFILE_DECLARE;
+
+    RTGUI_PROFILE_BEGIN();
     dc->engine->draw_hline(dc, x1, x2, y);
+    RTGUI_PROFILE_END(RTGUI_PROFILE_LINE, x2 > x1 ? x2 - x1 : x1 - x2);
+}
+
+#ifdef GUIENGINE_USING_PROFILE
+rt_inline rt_uint32_t rtgui_dc_spans_pixels(const struct rtgui_span *spans, int count)
+{
+    rt_uint32_t pixels = 0;
+
+    while (count --)
+    {
+        pixels += spans->x2 - spans->x1;
+        spans ++;
+    }
+
+    return pixels;
+}
+#endif
+
+/*
+ * fill the horizontal spans with foreground color
+ */
+rt_inline void rtgui_dc_fill_spans(struct rtgui_dc *dc, const struct rtgui_span *spans, int count)
+{
+    RTGUI_PROFILE_DECLARE;
+
+    RTGUI_PROFILE_BEGIN();
+    dc->engine->fill_spans(dc, spans, count);
+    RTGUI_PROFILE_END(RTGUI_PROFILE_SPAN, rtgui_dc_spans_pixels(spans, count));
 }
 
 /*
@@ -258,7 +460,11 @@ rt_inline void rtgui_dc_draw_hline(struct rtgui_dc *dc, int x1, int x2, int y)
  */
 rt_inline void rtgui_dc_fill_rect(struct rtgui_dc *dc, struct rtgui_rect *rect)
 {
+    RTGUI_PROFILE_DECLARE;
+
+    RTGUI_PROFILE_BEGIN();
     dc->engine->fill_rect(dc, rect);
+    RTGUI_PROFILE_END(RTGUI_PROFILE_FILL, rtgui_rect_width(*rect) * rtgui_rect_height(*rect));
 }
 
 /*
@@ -266,28 +472,86 @@ rt_inline void rtgui_dc_fill_rect(struct rtgui_dc *dc, struct rtgui_rect *rect)
  */
 rt_inline void rtgui_dc_blit(struct rtgui_dc *dc, struct rtgui_point *dc_point, struct rtgui_dc *dest, rtgui_rect_t *rect)
 {
+#ifdef GUIENGINE_USING_PROFILE
+    rt_uint32_t start = rtgui_profile_clock();
+
     dc->engine->blit(dc, dc_point, dest, rect);
+    rtgui_profile_blit(rtgui_dc_get_pixel_format(dc), rtgui_dc_get_pixel_format(dest),
+                       rtgui_rect_width(*rect) * rtgui_rect_height(*rect), start);
+#else
+    dc->engine->blit(dc, dc_point, dest, rect);
+#endif
 }
 
 /* set gc of dc */
 void rtgui_dc_set_gc(struct rtgui_dc *dc, rtgui_gc_t *gc);
 /* get gc of dc */
 rtgui_gc_t *rtgui_dc_get_gc(struct rtgui_dc *dc);
+
+void rtgui_gc_update_pixel(rtgui_gc_t *gc, rt_uint8_t pixel_format);
+
+/*
+ * Get the native pixel of foreground (background) in pixel_format, which is
+ * converted once until the color or the format is changed. RT_FALSE is
+ * returned if the format is not supported, such as P8.
+ */
+rt_inline rt_bool_t rtgui_gc_fore_pixel(rtgui_gc_t *gc, rt_uint8_t pixel_format, rt_uint32_t *pixel)
+{
+    if (gc->pixel_foreground != gc->foreground || gc->pixel_format != pixel_format)
+        rtgui_gc_update_pixel(gc, pixel_format);
+    *pixel = gc->fore_pixel;
+    return (gc->pixel_valid & 0x01) ? RT_TRUE : RT_FALSE;
+}
+
+rt_inline rt_bool_t rtgui_gc_back_pixel(rtgui_gc_t *gc, rt_uint8_t pixel_format, rt_uint32_t *pixel)
+{
+    if (gc->pixel_background != gc->background || gc->pixel_format != pixel_format)
+        rtgui_gc_update_pixel(gc, pixel_format);
+    *pixel = gc->back_pixel;
+    return (gc->pixel_valid & 0x02) ? RT_TRUE : RT_FALSE;
+}
 /* get visible status of dc */
 rt_bool_t rtgui_dc_get_visible(struct rtgui_dc *dc);
 /* get rect of dc */
 void rtgui_dc_get_rect(struct rtgui_dc *dc, rtgui_rect_t *rect);
-/* get pixel format */
-rt_uint8_t rtgui_dc_get_pixel_format(struct rtgui_dc *dc);
 /* coordinate conversion */
 void rtgui_dc_logic_to_device(struct rtgui_dc* dc, struct rtgui_point *point);
 void rtgui_dc_rect_to_device(struct rtgui_dc* dc, struct rtgui_rect* rect);
+/* scroll the pixels in rect by (dx, dy), the area to be painted is exposed */
+rt_err_t rtgui_dc_scroll(struct rtgui_dc *dc, rtgui_rect_t *rect, int dx, int dy,
+                         rtgui_region_t *exposed);
+/* show the overlay planes below the GUI layer in the visible part of rect */
+void rtgui_dc_punch_hole(struct rtgui_dc *dc, rtgui_rect_t *rect);
 
 /* dc rotation and zoom operations */
 struct rtgui_dc *rtgui_dc_shrink(struct rtgui_dc *dc, int factorx, int factory);
 struct rtgui_dc *rtgui_dc_zoom(struct rtgui_dc *dc, double zoomx, double zoomy, int smooth);
 struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoomx, double zoomy, int smooth);
 
+/* fixed point rotation and zoom, the angle (in degrees) and zoom factors are in 16.16 */
+#define RTGUI_FIXED(value)  ((rt_int32_t)((value) * 65536))
+void rtgui_dc_rotozoom_size_fixed(int width, int height, rt_int32_t angle,
+                                  rt_int32_t zoomx, rt_int32_t zoomy,
+                                  int *dstwidth, int *dstheight);
+int rtgui_dc_rotozoom_blit(struct rtgui_dc *dc, struct rtgui_dc *dest, struct rtgui_point *center,
+                           rt_int32_t angle, rt_int32_t zoomx, rt_int32_t zoomy, int smooth);
+
+#ifdef GUIENGINE_USING_PARALLEL_RENDER
+/** Render a rect of dc in parallel
+ *
+ * The rect (in the logical coordinate of dc) is split into horizontal bands,
+ * and each band is rendered by render() into a buffer dc of band in the
+ * workers, then the bands are blitted to the dc. The rect passed to render()
+ * is the band in the coordinate of dc, which is at (0, 0) of the band dc.
+ * The render() runs in several threads at the same time, so it should only
+ * draw on the band dc with the data not changed during the rendering.
+ */
+typedef void (*rtgui_band_render_t)(struct rtgui_dc *band, const rtgui_rect_t *rect, void *parameter);
+int rtgui_dc_render_init(void);
+rt_err_t rtgui_dc_render_parallel(struct rtgui_dc *dc, rtgui_rect_t *rect,
+                                  rtgui_band_render_t render, void *parameter);
+#endif
+
 /* dc buffer dump to file */
 void rtgui_dc_buffer_dump(struct rtgui_dc *self, char *fn);
 
@@ -110,6 +110,38 @@ do { \
     op; \
 } while (0)
 
+/*
+ * Define draw operators for the coverage of A8 mask, the shapes blended are
+ * in the union of their coverages
+ */
+
+#define DRAW_SETPIXEL_A8 \
+    *pixel = (rt_uint8_t)a
+
+#define DRAW_SETPIXEL_BLEND_A8 \
+    *pixel = (rt_uint8_t)(a + DRAW_MUL(inva, *pixel))
+
+#define DRAW_SETPIXEL_ADD_A8 \
+do { \
+    unsigned sa = *pixel + a; \
+    *pixel = (rt_uint8_t)(sa > 0xff ? 0xff : sa); \
+} while (0)
+
+#define DRAW_SETPIXEL_MOD_A8 \
+    *pixel = (rt_uint8_t)DRAW_MUL(*pixel, a)
+
+#define DRAW_SETPIXELXY_A8(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_A8)
+
+#define DRAW_SETPIXELXY_BLEND_A8(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_BLEND_A8)
+
+#define DRAW_SETPIXELXY_ADD_A8(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_ADD_A8)
+
+#define DRAW_SETPIXELXY_MOD_A8(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_MOD_A8)
+
 /*
  * Define draw operators for RGB555
  */
@@ -265,6 +297,68 @@ do { \
 #define DRAW_SETPIXELXY_MOD_ARGB8888(x, y) \
     DRAW_SETPIXELXY(x, y, rt_uint32_t, 4, DRAW_SETPIXEL_MOD_ARGB8888)
 
+/*
+ * Define draw operators for ARGB4444
+ */
+
+#define DRAW_SETPIXEL_ARGB4444 \
+    DRAW_SETPIXEL(ARGB4444_FROM_RGBA(*pixel, sr, sg, sb, sa))
+
+#define DRAW_SETPIXEL_BLEND_ARGB4444 \
+    DRAW_SETPIXEL_BLEND(RGBA_FROM_ARGB4444(*pixel, sr, sg, sb, sa), \
+                        ARGB4444_FROM_RGBA(*pixel, sr, sg, sb, sa))
+
+#define DRAW_SETPIXEL_ADD_ARGB4444 \
+    DRAW_SETPIXEL_ADD(RGBA_FROM_ARGB4444(*pixel, sr, sg, sb, sa), \
+                      ARGB4444_FROM_RGBA(*pixel, sr, sg, sb, sa))
+
+#define DRAW_SETPIXEL_MOD_ARGB4444 \
+    DRAW_SETPIXEL_MOD(RGBA_FROM_ARGB4444(*pixel, sr, sg, sb, sa), \
+                      ARGB4444_FROM_RGBA(*pixel, sr, sg, sb, sa))
+
+#define DRAW_SETPIXELXY_ARGB4444(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint16_t, 2, DRAW_SETPIXEL_ARGB4444)
+
+#define DRAW_SETPIXELXY_BLEND_ARGB4444(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint16_t, 2, DRAW_SETPIXEL_BLEND_ARGB4444)
+
+#define DRAW_SETPIXELXY_ADD_ARGB4444(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint16_t, 2, DRAW_SETPIXEL_ADD_ARGB4444)
+
+#define DRAW_SETPIXELXY_MOD_ARGB4444(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint16_t, 2, DRAW_SETPIXEL_MOD_ARGB4444)
+
+/*
+ * Define draw operators for RGB332
+ */
+
+#define DRAW_SETPIXEL_RGB332 \
+    DRAW_SETPIXEL(RGB332_FROM_RGB(*pixel, sr, sg, sb))
+
+#define DRAW_SETPIXEL_BLEND_RGB332 \
+    DRAW_SETPIXEL_BLEND(RGB_FROM_RGB332(*pixel, sr, sg, sb), \
+                        RGB332_FROM_RGB(*pixel, sr, sg, sb))
+
+#define DRAW_SETPIXEL_ADD_RGB332 \
+    DRAW_SETPIXEL_ADD(RGB_FROM_RGB332(*pixel, sr, sg, sb), \
+                      RGB332_FROM_RGB(*pixel, sr, sg, sb))
+
+#define DRAW_SETPIXEL_MOD_RGB332 \
+    DRAW_SETPIXEL_MOD(RGB_FROM_RGB332(*pixel, sr, sg, sb), \
+                      RGB332_FROM_RGB(*pixel, sr, sg, sb))
+
+#define DRAW_SETPIXELXY_RGB332(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_RGB332)
+
+#define DRAW_SETPIXELXY_BLEND_RGB332(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_BLEND_RGB332)
+
+#define DRAW_SETPIXELXY_ADD_RGB332(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_ADD_RGB332)
+
+#define DRAW_SETPIXELXY_MOD_RGB332(x, y) \
+    DRAW_SETPIXELXY(x, y, rt_uint8_t, 1, DRAW_SETPIXEL_MOD_RGB332)
+
 /*
  * Define line drawing macro
  */
@@ -467,7 +561,7 @@ do { \
              weighting for the paired pixel */ \
             Weighting = ErrorAcc >> 8; \
             { \
-                a = DRAW_MUL(_a, (Weighting ^ 255)); \
+                a = DRAW_MUL(_a, RTGUI_COVERAGE(Weighting ^ 255)); \
                 r = DRAW_MUL(_r, a); \
                 g = DRAW_MUL(_g, a); \
                 b = DRAW_MUL(_b, a); \
@@ -475,7 +569,7 @@ do { \
                 blend_op(x1, y1); \
             } \
             { \
-                a = DRAW_MUL(_a, Weighting); \
+                a = DRAW_MUL(_a, RTGUI_COVERAGE(Weighting)); \
                 r = DRAW_MUL(_r, a); \
                 g = DRAW_MUL(_g, a); \
                 b = DRAW_MUL(_b, a); \
@@ -502,7 +596,7 @@ do { \
               weighting for the paired pixel */ \
             Weighting = ErrorAcc >> 8; \
             { \
-                a = DRAW_MUL(_a, (Weighting ^ 255)); \
+                a = DRAW_MUL(_a, RTGUI_COVERAGE(Weighting ^ 255)); \
                 r = DRAW_MUL(_r, a); \
                 g = DRAW_MUL(_g, a); \
                 b = DRAW_MUL(_b, a); \
@@ -510,7 +604,7 @@ do { \
                 blend_op(x1, y1); \
             } \
             { \
-                a = DRAW_MUL(_a, Weighting); \
+                a = DRAW_MUL(_a, RTGUI_COVERAGE(Weighting)); \
                 r = DRAW_MUL(_r, a); \
                 g = DRAW_MUL(_g, a); \
                 b = DRAW_MUL(_b, a); \
@@ -0,0 +1,84 @@
+/*
+ * File      : dc_list.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_DC_LIST_H__
+#define __RTGUI_DC_LIST_H__
+
+#include <rtgui/dc.h>
+#include <rtgui/font.h>
+#include <rtgui/image.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The draw list records the drawing commands in a compact buffer, and
+ * executes them on a dc at once. On the client dc, the commands are
+ * executed in one pass for each clip rect, so the drawing operations only
+ * clip against one rect and the commands out of the rect are skipped.
+ *
+ * The coordinates are the logic coordinates of the dc which executes the
+ * list. The fonts, images and source dcs are referenced, not copied, and
+ * should be valid until the list is executed.
+ */
+struct rtgui_dc_list;
+
+/** Create a draw list
+ *
+ * @param size the initial size of command buffer in bytes, the buffer is
+ * grown when it's full.
+ *
+ * @return RT_NULL is there is no memory.
+ */
+struct rtgui_dc_list *rtgui_dc_list_create(rt_uint32_t size);
+void rtgui_dc_list_destroy(struct rtgui_dc_list *list);
+
+/* remove all the commands, the buffer is kept for the next recording */
+void rtgui_dc_list_reset(struct rtgui_dc_list *list);
+int rtgui_dc_list_count(struct rtgui_dc_list *list);
+
+/* the functions of recording, return -RT_ENOMEM if the buffer can not grow */
+rt_err_t rtgui_dc_list_fill_rect(struct rtgui_dc_list *list, const rtgui_rect_t *rect,
+                                 rtgui_color_t color);
+rt_err_t rtgui_dc_list_fill_spans(struct rtgui_dc_list *list, const struct rtgui_span *spans,
+                                  int count, rtgui_color_t color);
+rt_err_t rtgui_dc_list_draw_text(struct rtgui_dc_list *list, struct rtgui_font *font,
+                                 const char *text, const rtgui_rect_t *rect, rtgui_color_t color);
+rt_err_t rtgui_dc_list_blit(struct rtgui_dc_list *list, struct rtgui_dc *src,
+                            const struct rtgui_point *src_point, const rtgui_rect_t *rect);
+rt_err_t rtgui_dc_list_draw_image(struct rtgui_dc_list *list, struct rtgui_image *image,
+                                  const rtgui_rect_t *rect);
+
+/** Execute all the commands on the dc
+ *
+ * The gc of dc is restored after the execution.
+ */
+void rtgui_dc_list_execute(struct rtgui_dc_list *list, struct rtgui_dc *dc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * File      : dc_path.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_DC_PATH_H__
+#define __RTGUI_DC_PATH_H__
+
+#include <rtgui/dc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The path of lines, arcs and bezier curves, filled or stroked with the
+ * foreground color in anti-aliasing. The coordinates are in fixed point of
+ * RTGUI_PATH_FRAC_BITS, the curves are flattened to lines when they are
+ * added, and the lines are rasterized by the accumulation of the coverage
+ * areas in each row.
+ */
+#define RTGUI_PATH_FRAC_BITS    8
+#define RTGUI_PATH_ONE          (1 << RTGUI_PATH_FRAC_BITS)
+/* the fixed point of an integer coordinate */
+#define RTGUI_PATH_FIXED(v)     ((v) * RTGUI_PATH_ONE)
+
+enum rtgui_path_fill_rule
+{
+    RTGUI_PATH_NONZERO,
+    RTGUI_PATH_EVENODD,
+};
+
+/* the end of the open contours in stroke */
+enum rtgui_path_cap
+{
+    RTGUI_PATH_CAP_BUTT,
+    RTGUI_PATH_CAP_ROUND,
+    /* extended by the half width */
+    RTGUI_PATH_CAP_SQUARE,
+};
+
+/* the corner between lines in stroke, the miter is beveled in the sharp angle */
+enum rtgui_path_join
+{
+    RTGUI_PATH_JOIN_ROUND,
+    RTGUI_PATH_JOIN_MITER,
+    RTGUI_PATH_JOIN_BEVEL,
+};
+
+struct rtgui_path;
+
+/** Create a path
+ *
+ * @param size the initial points of path, the points are grown when it's full.
+ *
+ * @return RT_NULL is there is no memory.
+ */
+struct rtgui_path *rtgui_path_create(int size);
+void rtgui_path_destroy(struct rtgui_path *path);
+
+/* remove all the points, the buffer is kept for the next path */
+void rtgui_path_reset(struct rtgui_path *path);
+
+/* the functions of building, return -RT_ENOMEM if the points can not grow */
+rt_err_t rtgui_path_move_to(struct rtgui_path *path, int x, int y);
+rt_err_t rtgui_path_line_to(struct rtgui_path *path, int x, int y);
+rt_err_t rtgui_path_quad_to(struct rtgui_path *path, int cx, int cy, int x, int y);
+rt_err_t rtgui_path_cubic_to(struct rtgui_path *path, int c1x, int c1y,
+                             int c2x, int c2y, int x, int y);
+/*
+ * The arc of circle from the angle start to end in degrees, the angle is
+ * clockwise on screen from the x axis. The arc is connected to the current
+ * point by a line.
+ */
+rt_err_t rtgui_path_arc(struct rtgui_path *path, int cx, int cy, int r, int start, int end);
+rt_err_t rtgui_path_close(struct rtgui_path *path);
+
+/* fill the path with foreground, the open contours are closed in the fill */
+void rtgui_dc_fill_path(struct rtgui_dc *dc, const struct rtgui_path *path,
+                        enum rtgui_path_fill_rule rule);
+/* stroke the path in the width of fixed point, the outline is filled in one raster */
+void rtgui_dc_stroke_path(struct rtgui_dc *dc, const struct rtgui_path *path, int width,
+                          enum rtgui_path_cap cap, enum rtgui_path_join join);
+
+/* the AA rtgui_dc_fill_annulus in the integer coordinates, the pie is the annulus of r1 = 0 */
+void rtgui_dc_fill_aa_annulus(struct rtgui_dc *dc, int x, int y, int r1, int r2, int start, int end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -52,6 +52,13 @@ void rtgui_dc_trans_scale(struct rtgui_dc_trans *dct, double sx, double sy);
  */
 void rtgui_dc_trans_move(struct rtgui_dc_trans *dct, int dx, int dy);
 
+/** Shrink the sampled area to the pixels which are not fully transparent
+ *
+ * Only the ARGB888 buffer dc is scanned. Call it again after the content of
+ * the owner is changed.
+ */
+void rtgui_dc_trans_update_bound(struct rtgui_dc_trans *dct);
+
 void rtgui_dc_trans_get_new_wh(struct rtgui_dc_trans *dct, int *new_w, int *new_h);
 
 void rtgui_dc_trans_blit(struct rtgui_dc_trans *dct,
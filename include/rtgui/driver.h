@@ -26,6 +26,83 @@
 
 #include <rtgui/list.h>
 #include <rtgui/color.h>
+#include <rtgui/region.h>
+
+/* get the vsync/TE semaphore of graphic device, which is released by the
+ * panel driver on each refresh */
+#ifndef RTGRAPHIC_CTRL_GET_VSYNC
+#define RTGRAPHIC_CTRL_GET_VSYNC    0x20
+#endif
+
+/* hand a framebuffer page to the display controller as the front buffer */
+#ifndef RTGRAPHIC_CTRL_PAN_DISPLAY
+#define RTGRAPHIC_CTRL_PAN_DISPLAY  10
+#endif
+
+/* get the operations of overlay planes, if the display controller has */
+#ifndef RTGRAPHIC_CTRL_GET_OVERLAY
+#define RTGRAPHIC_CTRL_GET_OVERLAY  0x21
+#endif
+
+/* the overlay plane of mouse cursor */
+#define RTGUI_OVERLAY_CURSOR        0
+/* the planes of video, the others are allocated from the ones after cursor */
+#define RTGUI_OVERLAY_MAX           8
+
+/* the formats of overlay plane beyond the pixel formats, the planes of YUV
+ * are one after the other in the buffer, in the pitch of Y */
+#define RTGUI_OVERLAY_FMT_YUYV      0x80
+#define RTGUI_OVERLAY_FMT_NV12      0x81
+#define RTGUI_OVERLAY_FMT_I420      0x82
+
+/* the pixel of GUI layer where the planes below are shown, the transparent one
+ * in the format with alpha, or the color key of display controller */
+#define RTGUI_OVERLAY_HOLE          RTGUI_ARGB(0x00, 0x00, 0x00, 0x00)
+
+/* get the block write operations of the device without framebuffer */
+#ifndef RTGRAPHIC_CTRL_GET_PIXEL_OPS
+#define RTGRAPHIC_CTRL_GET_PIXEL_OPS 0x22
+#endif
+
+/* get the capabilities of device, see struct rtgui_graphic_caps */
+#ifndef RTGRAPHIC_CTRL_GET_CAPS
+#define RTGRAPHIC_CTRL_GET_CAPS     0x23
+#endif
+
+/* the capabilities of driver */
+#define RTGUI_CAP_FRAMEBUFFER       0x0001
+#define RTGUI_CAP_ACCEL_FILL        0x0002
+#define RTGUI_CAP_ACCEL_BLIT        0x0004
+#define RTGUI_CAP_OVERLAY           0x0008
+/* the vsync/TE of panel, there is no tearing in the update after it */
+#define RTGUI_CAP_VSYNC             0x0010
+/* the block write of the device without framebuffer */
+#define RTGUI_CAP_BLIT_RECT         0x0020
+/* the block write is the DMA in background */
+#define RTGUI_CAP_DMA               0x0040
+
+/*
+ * The capabilities of device. The engine finds the flags in the operations of
+ * device, and the device may report the limits by RTGRAPHIC_CTRL_GET_CAPS, in
+ * which the flags not reported are off.
+ */
+struct rtgui_graphic_caps
+{
+    rt_uint32_t flags;
+    /* the (1 << pixel format) of the pixels read by DMA and accelerator,
+     * 0 is the format of device only */
+    rt_uint32_t formats;
+    /* the bytes of alignment of the pixels read by DMA, 0 is no alignment */
+    rt_uint16_t dma_align;
+    /* the pixels of alignment of x and width in the block write */
+    rt_uint16_t x_align;
+    /* the max bytes in one block write, 0 is no limit */
+    rt_uint32_t max_transfer;
+    /* the overlay planes with the cursor one */
+    rt_uint8_t planes;
+};
+
+struct rtgui_blit_info;
 
 /* graphic driver operations */
 struct rtgui_graphic_driver_ops
@@ -48,6 +125,7 @@ struct rtgui_graphic_ext_ops
     void (*draw_line)(rtgui_color_t *c, int x1, int y1, int x2, int y2);
 
     void (*draw_rect)(rtgui_color_t *c, int x1, int y1, int x2, int y2);
+    /* the x2 and y2 are not included, as draw_hline */
     void (*fill_rect)(rtgui_color_t *c, int x1, int y1, int x2, int y2);
 
     void (*draw_circle)(rtgui_color_t *c, int x, int y, int r);
@@ -55,6 +133,52 @@ struct rtgui_graphic_ext_ops
 
     void (*draw_ellipse)(rtgui_color_t *c, int x, int y, int rx, int ry);
     void (*fill_ellipse)(rtgui_color_t *c, int x, int y, int rx, int ry);
+
+    /*
+     * 2D accelerator (DMA2D/PXP/G2D). The operations may run asynchronously,
+     * return RT_EOK if the request is submitted or -RT_ENOSYS if it is not
+     * supported and the software path will be used.
+     */
+    rt_err_t (*accel_fill)(rtgui_color_t c, rt_uint8_t *dst, int dst_pitch,
+                           rt_uint8_t dst_fmt, int w, int h);
+    /* copy with format conversion and alpha blend, see rtgui_blit */
+    rt_err_t (*accel_blit)(struct rtgui_blit_info *info);
+    /* wait for the finish of all the submitted operations */
+    void (*accel_sync)(void);
+};
+
+/*
+ * Overlay planes, blended over the framebuffer by the display controller. The
+ * pixels of a plane are not in the framebuffer, so nothing is saved, restored
+ * or drawn again when the plane is moved.
+ */
+struct rtgui_graphic_overlay_ops
+{
+    /* the pixels (alpha 255 is opaque) are copied, RT_NULL pixels hide it */
+    rt_err_t (*set_image)(int plane, const rt_uint8_t *pixels, int pitch,
+                          rt_uint8_t format, int w, int h);
+    rt_err_t (*set_position)(int plane, int x, int y);
+
+    /* show the buffer of frame without copy, it's read by the display
+     * controller until the next one is shown. RT_NULL buffer hides the plane */
+    rt_err_t (*queue_buffer)(int plane, const void *buffer, int pitch,
+                             rt_uint8_t format, int w, int h);
+    /* the plane of larger z is over, the GUI layer is 0 */
+    rt_err_t (*set_zorder)(int plane, int z);
+};
+
+/*
+ * The block write of the device without framebuffer, a set window command and
+ * a burst of pixels on the bus of SPI/8080 panel. The pixels are in the format
+ * of device, line by line in the pitch.
+ */
+struct rtgui_graphic_pixel_ops
+{
+    void (*blit_rect)(const rt_uint8_t *pixels, int pitch, int x, int y, int w, int h);
+    /* start the DMA of blit_rect and return, the driver calls
+     * rtgui_graphic_driver_flush_done in the end of transfer. RT_NULL if the
+     * transfer is not asynchronous */
+    rt_err_t (*blit_rect_async)(const rt_uint8_t *pixels, int pitch, int x, int y, int w, int h);
 };
 
 struct rtgui_graphic_driver
@@ -74,16 +198,142 @@ struct rtgui_graphic_driver
 
     const struct rtgui_graphic_driver_ops *ops;
     const struct rtgui_graphic_ext_ops *ext_ops;
+    const struct rtgui_graphic_overlay_ops *overlay_ops;
+    /* the block write of the device without framebuffer, or RT_NULL */
+    const struct rtgui_graphic_pixel_ops *pixel_ops;
+    /* negotiated in rtgui_graphic_set_device */
+    struct rtgui_graphic_caps caps;
+
+    /* vsync/TE semaphore, RT_NULL if the panel does not report it */
+    rt_sem_t vsync;
+    /* the 2D accelerator has operations in flight */
+    volatile rt_uint8_t accel_busy;
+    /* an asynchronous flush is reading the pixels */
+    volatile rt_uint8_t flush_busy;
+    /* the bits of overlay planes allocated */
+    rt_uint8_t overlay_used;
+
+    /* page flipping, the framebuffer points to the back page in drawing */
+    rt_uint8_t page_num;
+    rt_uint8_t page_back;
+    rt_uint8_t *pages[GUIENGINE_FRAMEBUFFER_PAGE_MAX];
+    /* the area of each page which is older than the front page */
+    rtgui_region_t page_stale[GUIENGINE_FRAMEBUFFER_PAGE_MAX];
+
+#ifdef GUIENGINE_USING_ROTATION
+    /* the framebuffer of panel, the framebuffer above is the shadow in the
+     * orientation of GUI when it's rotated clockwise by rotation degrees */
+    rt_uint16_t rotation;
+    rt_uint16_t panel_pitch;
+    rt_uint16_t panel_width;
+    rt_uint16_t panel_height;
+    rt_uint8_t *panel_fb;
+#endif
 };
 
 struct rtgui_graphic_driver *rtgui_graphic_driver_get_default(void);
 
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+#define RTGUI_DISPLAY_NUM   GUIENGINE_DISPLAY_MAX
+#else
+#define RTGUI_DISPLAY_NUM   1
+#endif
+struct rtgui_graphic_driver *rtgui_graphic_driver_get_display(int display);
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+rt_err_t rtgui_graphic_set_display(int display, rt_device_t device);
+/* draw to the display, the screen lock should be held in it */
+void rtgui_graphic_driver_display_enter(int display);
+void rtgui_graphic_driver_display_exit(void);
+#endif
+
 void rtgui_graphic_driver_get_rect(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect);
 void rtgui_graphic_driver_screen_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect);
 rt_uint8_t *rtgui_graphic_driver_get_framebuffer(const struct rtgui_graphic_driver *driver);
 
 rt_err_t rtgui_graphic_set_device(rt_device_t device);
 void rtgui_graphic_driver_set_framebuffer(void *fb);
+void rtgui_graphic_driver_set_vsync(rt_sem_t vsync);
+
+void rtgui_graphic_driver_fill_rect(const struct rtgui_graphic_driver *driver,
+                                    rtgui_color_t c, rtgui_rect_t *rect);
+rt_bool_t rtgui_graphic_driver_draw_hline_pixel(const struct rtgui_graphic_driver *driver,
+                                                rt_uint32_t pixel, int x1, int x2, int y);
+rt_bool_t rtgui_graphic_driver_draw_vline_pixel(const struct rtgui_graphic_driver *driver,
+                                                rt_uint32_t pixel, int x, int y1, int y2);
+rt_err_t rtgui_graphic_driver_accel_fill(const struct rtgui_graphic_driver *driver,
+                                         rtgui_color_t c, rtgui_rect_t *rect);
+rt_err_t rtgui_graphic_driver_accel_blit(struct rtgui_blit_info *info);
+void rtgui_graphic_driver_accel_sync(void);
+rt_err_t rtgui_graphic_driver_overlay_set_image(const struct rtgui_graphic_driver *driver, int plane,
+                                                const rt_uint8_t *pixels, int pitch,
+                                                rt_uint8_t format, int w, int h);
+rt_err_t rtgui_graphic_driver_overlay_set_position(const struct rtgui_graphic_driver *driver,
+                                                   int plane, int x, int y);
+/* the planes of video or camera, the buffers of frames are shown without copy */
+int rtgui_graphic_driver_overlay_alloc(struct rtgui_graphic_driver *driver);
+void rtgui_graphic_driver_overlay_free(struct rtgui_graphic_driver *driver, int plane);
+rt_err_t rtgui_graphic_driver_overlay_queue(const struct rtgui_graphic_driver *driver, int plane,
+                                            const void *buffer, int pitch,
+                                            rt_uint8_t format, int w, int h);
+rt_err_t rtgui_graphic_driver_overlay_set_zorder(const struct rtgui_graphic_driver *driver,
+                                                 int plane, int z);
+/* the pixel of hole in the GUI layer, which shows the planes below */
+rtgui_color_t rtgui_graphic_driver_overlay_hole(const struct rtgui_graphic_driver *driver);
+
+/* write the pixels combined for the device without framebuffer */
+void rtgui_graphic_driver_flush(const struct rtgui_graphic_driver *driver);
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+/* clean the D-cache of the rect in framebuffer, the CPU writes are in memory then */
+void rtgui_graphic_driver_cache_clean(const struct rtgui_graphic_driver *driver, const rtgui_rect_t *rect);
+#endif
+#ifdef GUIENGINE_USING_ASYNC_FLUSH
+/* start the transfer of pixels to the rect of device, and wait for it only
+ * when the pixels are written again */
+rt_err_t rtgui_graphic_driver_flush_async(struct rtgui_graphic_driver *driver, const rt_uint8_t *pixels,
+                                          int pitch, const rtgui_rect_t *rect);
+void rtgui_graphic_driver_flush_wait(struct rtgui_graphic_driver *driver);
+/* called by the driver in the end of transfer, it's safe in ISR */
+void rtgui_graphic_driver_flush_done(void);
+#endif
+
+rt_err_t rtgui_graphic_driver_set_pages(void *pages[], int num);
+#ifdef GUIENGINE_USING_ROTATION
+rt_err_t rtgui_graphic_driver_set_rotation(int degree);
+#endif
+#ifdef GUIENGINE_USING_EPAPER
+rt_err_t rtgui_epaper_init(const struct rtgui_graphic_driver *driver);
+void rtgui_epaper_set_full_every(int every);
+rt_bool_t rtgui_epaper_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect);
+#endif
+void rtgui_graphic_driver_page_flip(struct rtgui_graphic_driver *driver, rtgui_region_t *damage);
+
+#ifdef GUIENGINE_USING_OVERDRAW
+enum rtgui_overdraw_mode
+{
+    RTGUI_OVERDRAW_OFF,
+    /* tint the pixels written more than once on the screen update */
+    RTGUI_OVERDRAW_COUNT,
+    /* flash the rects of screen update */
+    RTGUI_OVERDRAW_FLASH,
+};
+
+rt_err_t rtgui_graphic_driver_set_overdraw(enum rtgui_overdraw_mode mode);
+/* count the writes to a device rect, or the destination of blit */
+void rtgui_overdraw_rect(rtgui_rect_t *rect);
+void rtgui_overdraw_blit(struct rtgui_blit_info *info);
+void rtgui_overdraw_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect);
+
+#define RTGUI_OVERDRAW_RECT(rect)   rtgui_overdraw_rect(rect)
+#define RTGUI_OVERDRAW_BLIT(info)   rtgui_overdraw_blit(info)
+#else
+#define RTGUI_OVERDRAW_RECT(rect)
+#define RTGUI_OVERDRAW_BLIT(info)
+#endif
+
+rt_inline rt_bool_t rtgui_graphic_driver_has_cap(const struct rtgui_graphic_driver *driver, rt_uint32_t cap)
+{
+    return (driver->caps.flags & cap) == cap ? RT_TRUE : RT_FALSE;
+}
 
 rt_inline struct rtgui_graphic_driver *rtgui_graphic_get_device()
 {
@@ -106,12 +356,51 @@ void rtgui_cursor_set_image(enum rtgui_cursor_type type);
 #endif
 
 #ifdef GUIENGIN_USING_VFRAMEBUFFER
+#ifndef RTGUI_VFB_PIXEL_FMT
+#ifdef GUIENGINE_FIXED_PIXEL_FORMAT
+#define RTGUI_VFB_PIXEL_FMT     GUIENGINE_FIXED_PIXEL_FORMAT
+#else
+#define RTGUI_VFB_PIXEL_FMT     RTGRAPHIC_PIXEL_FORMAT_RGB565
+#endif
+#endif
+
 void rtgui_graphic_driver_vmode_enter(void);
 void rtgui_graphic_driver_vmode_exit(void);
+rt_err_t rtgui_graphic_driver_vmode_enter_buffer(struct rtgui_dc *dc, struct rtgui_rect *rect);
 struct rtgui_dc* rtgui_graphic_driver_get_rect_buffer(const struct rtgui_graphic_driver *driver, struct rtgui_rect *rect);
 #endif
 
 rt_bool_t rtgui_graphic_driver_is_vmode(void);
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+/*
+ * The layer of a window, in the extent of window and the format of driver.
+ * The driver of layer addresses the pixels in the coordinate of screen, so the
+ * window draws to it as to the screen when it's entered.
+ */
+struct rtgui_layer
+{
+    struct rtgui_graphic_driver driver;
+    rt_uint8_t *pixels;
+    rtgui_rect_t extent;
+    /* 255 is opaque, 0 is not shown */
+    rt_uint8_t opacity;
+
+    /* the driver before the layer is entered */
+    struct rtgui_graphic_driver *prev;
+};
+
+struct rtgui_layer *rtgui_layer_create(rtgui_rect_t *extent);
+void rtgui_layer_destroy(struct rtgui_layer *layer);
+void rtgui_layer_move(struct rtgui_layer *layer, int dx, int dy);
+/* blend the layer in the rect to the framebuffer of driver */
+void rtgui_layer_composite(struct rtgui_graphic_driver *driver,
+                           struct rtgui_layer *layer, rtgui_rect_t *rect);
+
+/* draw to the layer, the screen lock should be held in it */
+void rtgui_graphic_driver_layer_enter(struct rtgui_layer *layer);
+void rtgui_graphic_driver_layer_exit(struct rtgui_layer *layer);
+#endif
+
 #endif
 
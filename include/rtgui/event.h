@@ -64,6 +64,7 @@ enum _rtgui_event_type
     RTGUI_EVENT_UPDATE_END,            /* update a rect         */
     RTGUI_EVENT_MONITOR_ADD,           /* add a monitor rect    */
     RTGUI_EVENT_MONITOR_REMOVE,        /* remove a monitor rect */
+    RTGUI_EVENT_VSYNC,                 /* panel refresh to server */
     RTGUI_EVENT_SHOW,                  /* the widget is going to be shown */
     RTGUI_EVENT_HIDE,                  /* the widget is going to be hidden */
     RTGUI_EVENT_PAINT,                 /* paint on screen       */
@@ -91,6 +92,13 @@ enum _rtgui_event_type
     RTGUI_EVENT_UNSELECTED,            /* widget un-selected    */
     RTGUI_EVENT_MV_MODEL,              /* data of a model has been changed */
 
+    /* image event */
+    RTGUI_EVENT_IMAGE_LOADED,          /* image decoded by loader */
+
+    /* frame clock event */
+    RTGUI_EVENT_FRAME_REQUEST,         /* request a frame (client -> server) */
+    RTGUI_EVENT_FRAME,                 /* a frame is presented (server -> client) */
+
     WBUS_NOTIFY_EVENT,
 
     /* user command event. It should always be the last command type. */
@@ -117,6 +125,11 @@ struct rtgui_event
 
     /* mailbox to acknowledge request */
     rt_mailbox_t ack;
+
+#ifdef GUIENGINE_USING_LATENCY
+    /* the time that the input is acquired, or 0 */
+    rt_uint32_t stamp;
+#endif
 };
 typedef struct rtgui_event rtgui_event_t;
 #define RTGUI_EVENT(e)  ((struct rtgui_event*)(e))
@@ -129,8 +142,15 @@ extern struct rtgui_app* rtgui_app_self(void);
     (e)->user = 0;                      \
     (e)->sender = rtgui_app_self();     \
     (e)->ack = RT_NULL;                 \
+    RTGUI_EVENT_STAMP_INIT(e);          \
 } while (0)
 
+#ifdef GUIENGINE_USING_LATENCY
+#define RTGUI_EVENT_STAMP_INIT(e)   (e)->stamp = 0
+#else
+#define RTGUI_EVENT_STAMP_INIT(e)
+#endif
+
 /*
  * RTGUI Application Event
  */
@@ -233,8 +253,14 @@ struct rtgui_event_update_end
 {
     struct rtgui_event parent;
 
+    /* the window updated */
+    struct rtgui_win *wid;
     /* the update rect */
     rtgui_rect_t rect;
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    /* the display of rect */
+    rt_uint8_t display;
+#endif
 };
 
 struct rtgui_event_monitor
@@ -249,7 +275,8 @@ struct rtgui_event_paint
 {
     _RTGUI_EVENT_WIN_ELEMENTS
 
-    rtgui_rect_t rect;      /* rect to be updated */
+    /* the damage on screen to be updated, the empty rect is the whole window */
+    rtgui_rect_t rect;
 };
 
 struct rtgui_timer;
@@ -261,6 +288,25 @@ struct rtgui_event_timer
 };
 typedef struct rtgui_event_timer rtgui_event_timer_t;
 
+struct rtgui_image_request;
+struct rtgui_event_image_loaded
+{
+    struct rtgui_event parent;
+
+    struct rtgui_image_request *request;
+};
+#define RTGUI_EVENT_IMAGE_LOADED_INIT(e)    RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_IMAGE_LOADED)
+
+struct rtgui_event_frame
+{
+    struct rtgui_event parent;
+
+    /* the tick of frame */
+    rt_tick_t tick;
+};
+#define RTGUI_EVENT_FRAME_REQUEST_INIT(e)   RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_FRAME_REQUEST)
+#define RTGUI_EVENT_FRAME_INIT(e)           RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_FRAME)
+
 
 struct rtgui_event_clip_info
 {
@@ -278,12 +324,17 @@ struct rtgui_event_clip_info
 #define RTGUI_EVENT_MONITOR_ADD_INIT(e)     RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_MONITOR_ADD)
 #define RTGUI_EVENT_MONITOR_REMOVE_INIT(e)  RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_MONITOR_REMOVE)
 #define RTGUI_EVENT_CLIP_INFO_INIT(e)       RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_CLIP_INFO)
-#define RTGUI_EVENT_PAINT_INIT(e)           RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_PAINT)
+#define RTGUI_EVENT_PAINT_INIT(e)           do { RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_PAINT); \
+                                                 (e)->rect.x1 = (e)->rect.x2 = 0;                    \
+                                                 (e)->rect.y1 = (e)->rect.y2 = 0; } while (0)
 #define RTGUI_EVENT_TIMER_INIT(e)           RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_TIMER)
 
 #define rtgui_event_show rtgui_event
 #define rtgui_event_hide rtgui_event
 
+#define rtgui_event_vsync rtgui_event
+
+#define RTGUI_EVENT_VSYNC_INIT(e)           RTGUI_EVENT_INIT((e), RTGUI_EVENT_VSYNC)
 #define RTGUI_EVENT_SHOW_INIT(e)            RTGUI_EVENT_INIT((e), RTGUI_EVENT_SHOW)
 #define RTGUI_EVENT_HIDE_INIT(e)            RTGUI_EVENT_INIT((e), RTGUI_EVENT_HIDE)
 
@@ -330,6 +381,9 @@ enum rtgui_gesture_type
     RTGUI_GESTURE_DRAG_HORIZONTAL   = 0x0004,
     RTGUI_GESTURE_DRAG_VERTICAL     = 0x0008,
     RTGUI_GESTURE_DRAG              = (RTGUI_GESTURE_DRAG_HORIZONTAL | RTGUI_GESTURE_DRAG_VERTICAL),
+    /* the drag is released in the velocity */
+    RTGUI_GESTURE_FLING     = 0x0010,
+    RTGUI_GESTURE_PINCH     = 0x0020,
     /* PINCH, DRAG finished. */
     RTGUI_GESTURE_FINISH    = 0x8000,
     /* The corresponding gesture should be canceled. */
@@ -344,6 +398,15 @@ struct rtgui_event_gesture
     enum rtgui_gesture_type type;
 
     rt_uint32_t	win_acti_cnt;		/* window activate count */
+
+    /* the point of gesture on screen, the center of pinch */
+    rt_int16_t x, y;
+    /* the motion of drag since the last gesture event */
+    rt_int16_t dx, dy;
+    /* the velocity of drag and fling in pixels per second */
+    rt_int16_t vx, vy;
+    /* the scale of pinch to its start, in 1/256 */
+    rt_uint16_t scale;
 };
 
 /*
@@ -410,7 +473,8 @@ struct rtgui_event_touch
 
     rt_uint16_t x, y;
     rt_uint16_t up_down;
-    rt_uint16_t resv;
+    /* the contact of multi-touch, 0 for the first finger */
+    rt_uint16_t id;
 };
 #define RTGUI_TOUCH_UP                  0x01
 #define RTGUI_TOUCH_DOWN                0x02
@@ -427,10 +491,15 @@ struct rtgui_event_command
     /* command id */
     rt_int32_t command_id;
 
-    /* command string */
-    char command_string[GUIENGINE_NAME_MAX];
+    /* command string, a payload of event which is released after the event
+     * is handled, set by rtgui_event_command_set_string */
+    char *command_string;
 };
-#define RTGUI_EVENT_COMMAND_INIT(e) RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_COMMAND)
+#define RTGUI_EVENT_COMMAND_INIT(e) \
+    do { \
+        RTGUI_EVENT_INIT(&((e)->parent), RTGUI_EVENT_COMMAND); \
+        (e)->command_string = RT_NULL; \
+    } while (0)
 
 #define RTGUI_CMD_UNKNOWN       0x00
 #define RTGUI_CMD_WM_CLOSE      0x10
@@ -558,6 +627,8 @@ union rtgui_event_generic
     struct rtgui_event_monitor monitor;
     struct rtgui_event_paint paint;
     struct rtgui_event_timer timer;
+    struct rtgui_event_image_loaded image_loaded;
+    struct rtgui_event_frame frame;
     struct rtgui_event_update_toplvl update_toplvl;
     struct rtgui_event_vpaint_req vpaint_req;
     struct rtgui_event_clip_info clip_info;
@@ -572,6 +643,19 @@ union rtgui_event_generic
     struct rtgui_event_command command;
 };
 
+/*
+ * The payload of event is refcounted, the event holds one reference which is
+ * released by the app after the event is handled (or by rtgui_send if the
+ * event is not sent). Take a reference for each more app the event is sent to.
+ */
+void *rtgui_event_payload_alloc(rt_size_t size);
+void rtgui_event_payload_ref(void *payload);
+void rtgui_event_payload_unref(void *payload);
+
+/* the payload carried by event, RT_NULL if there is none */
+void *rtgui_event_get_payload(struct rtgui_event *event);
+rt_err_t rtgui_event_command_set_string(struct rtgui_event_command *event, const char *string);
+
 #ifdef __cplusplus
 }
 #endif
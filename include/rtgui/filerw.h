@@ -54,10 +54,18 @@ struct rtgui_filerw
     int (*tell)(struct rtgui_filerw *context);
     int (*eof)(struct rtgui_filerw *context);
     int (*close)(struct rtgui_filerw *context);
+    /* the bytes at offset in place, it's optional */
+    const void *(*map)(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length);
 };
 typedef struct rtgui_filerw rtgui_filerw_t;
 
 struct rtgui_filerw *rtgui_filerw_create_file(const char *filename, const char *mode);
+/*
+ * Open the file for read in the blocks of buffer, the small reads and the
+ * seeks in the block are not the syscalls of file system. The block size is
+ * GUIENGINE_FILERW_BLOCK_SIZE if it's 0. It's not writable.
+ */
+struct rtgui_filerw *rtgui_filerw_create_buffered(const char *filename, rt_size_t block_size);
 struct rtgui_filerw *rtgui_filerw_create_mem(const rt_uint8_t *mem, rt_size_t size);
 
 int rtgui_filerw_seek(struct rtgui_filerw *context, rt_off_t offset, int whence);
@@ -68,6 +76,30 @@ int rtgui_filerw_eof(struct rtgui_filerw *context);
 int rtgui_filerw_close(struct rtgui_filerw *context);
 int rtgui_filerw_unlink(const char *filename);
 
+/** Get the bytes of file in place without copying
+ *
+ * The read position is not changed. The pointer of memory filerw is valid as
+ * the memory, and the one in the buffer of buffered filerw is valid until the
+ * next operation on it.
+ *
+ * @return RT_NULL if the filerw can not map them, read them then.
+ */
+const void *rtgui_filerw_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length);
+
+/* the segment of scattered memory, such as the pbuf of network */
+struct rtgui_filerw_iovec
+{
+    const void *base;
+    rt_size_t length;
+};
+
+/*
+ * Read the segments as one file without copying them together. The array of
+ * segments is copied, the memory of segments should be valid until the filerw
+ * is closed.
+ */
+struct rtgui_filerw *rtgui_filerw_create_iovec(const struct rtgui_filerw_iovec *iov, int count);
+
 /* get memory data from filerw memory object */
 const rt_uint8_t *rtgui_filerw_mem_getdata(struct rtgui_filerw *context);
 
@@ -35,6 +35,7 @@ extern "C" {
 struct rtgui_font;
 struct rtgui_dc;
 struct rtgui_rect;
+struct rtgui_text_run;
 
 struct rtgui_font_engine
 {
@@ -45,6 +46,12 @@ struct rtgui_font_engine
     void (*font_draw_text)(struct rtgui_font *font, struct rtgui_dc *dc, const char *text,
                            rt_ubase_t len, struct rtgui_rect *rect);
     void (*font_get_metrics)(struct rtgui_font *font, const char *text, struct rtgui_rect *rect);
+
+    /* prepare a text run and draw it, they are optional. The prepared data
+     * is one block allocated by rtgui_malloc and set to run->data. */
+    rt_err_t (*font_prepare_text)(struct rtgui_font *font, struct rtgui_text_run *run);
+    void (*font_draw_text_run)(struct rtgui_font *font, struct rtgui_dc *dc,
+                               struct rtgui_text_run *run, struct rtgui_rect *rect);
 };
 
 /*
@@ -64,19 +71,13 @@ struct rtgui_font_bitmap
 };
 extern const struct rtgui_font_engine bmp_font_engine;
 
-#include <rtgui/tree.h>
-SPLAY_HEAD(cache_tree, hz_cache);
-struct hz_cache
-{
-    SPLAY_ENTRY(hz_cache) hz_node;
-
-    rt_uint16_t hz_id;
-};
-
+struct hz_cache;
 struct rtgui_hz_file_font
 {
-    struct cache_tree cache_root;
-    rt_uint16_t cache_size;
+    /* the bytes of font data cached, 0 to read file for each glyph */
+    rt_uint32_t cache_size;
+    /* the cache is created at the first reading */
+    struct hz_cache *cache;
 
     /* font size */
     rt_uint16_t font_size;
@@ -87,6 +88,10 @@ struct rtgui_hz_file_font
 
     /* font file name */
     const char *font_fn;
+
+    /* the font data mapped in memory (XIP flash), RT_NULL to read the file */
+    const rt_uint8_t *font_map;
+    rt_uint32_t font_map_size;
 };
 extern const struct rtgui_font_engine rtgui_hz_file_font_engine;
 
@@ -109,12 +114,17 @@ struct rtgui_font
 
     /* the font list */
     rtgui_list_t list;
+
+    /* the engine of font is loaded, at the first use with GUIENGINE_USING_LAZY_INIT */
+    rt_uint8_t loaded;
 };
 typedef struct rtgui_font rtgui_font_t;
 
 void rtgui_font_system_init(void);
 void rtgui_font_fd_uninstall(void);
 void rtgui_font_system_add_font(struct rtgui_font *font);
+/* load the fonts not used yet in background, it's called at the screen update */
+void rtgui_font_system_load_deferred(void);
 void rtgui_font_system_remove_font(struct rtgui_font *font);
 struct rtgui_font *rtgui_font_default(void);
 void rtgui_font_set_defaut(struct rtgui_font *font);
@@ -127,6 +137,123 @@ void rtgui_font_draw(struct rtgui_font *font, struct rtgui_dc *dc, const char *t
 int  rtgui_font_get_string_width(struct rtgui_font *font, const char *text);
 void rtgui_font_get_metrics(struct rtgui_font *font, const char *text, struct rtgui_rect *rect);
 
+/*
+ * The x of caret before each byte of text in positions[len + 1], and the
+ * offset of caret nearest to x found in them by the binary search. The text
+ * input measures the positions once for all the hit tests.
+ */
+int rtgui_font_get_text_positions(struct rtgui_font *font, const char *text, rt_ubase_t len,
+                                  rt_uint16_t *positions);
+rt_ubase_t rtgui_font_hit_test(const rt_uint16_t *positions, rt_ubase_t len, int x);
+/* the bytes of the character at text, in the encoding of fonts */
+rt_ubase_t rtgui_font_char_len(const char *text);
+
+/*
+ * The text run is a text prepared to draw repeatedly, such as the label,
+ * which skips the decoding and the lookup of glyphs in the drawing. The
+ * font is referred until the run is destroyed.
+ */
+struct rtgui_text_run
+{
+    struct rtgui_font *font;
+    /* the metrics of text, same as rtgui_font_get_metrics */
+    struct rtgui_rect metrics;
+
+    /* the data prepared by font engine */
+    void *data;
+
+    rt_ubase_t len;
+    /* char text[len + 1]; */
+};
+#define rtgui_text_run_text(run)    ((const char *)((run) + 1))
+
+struct rtgui_text_run *rtgui_text_run_create(struct rtgui_font *font, const char *text, rt_ubase_t len);
+void rtgui_text_run_destroy(struct rtgui_text_run *run);
+void rtgui_font_draw_text_run(struct rtgui_text_run *run, struct rtgui_dc *dc, struct rtgui_rect *rect);
+
+/** Load the glyphs of charset into the caches of font in background
+ *
+ * The charset is drawn in a low priority thread out of a tiny buffer dc, so
+ * the font engine loads the glyphs into the glyph atlas, the hz file cache
+ * or the FreeType cache, whichever it uses. The charset is copied.
+ *
+ * @return -RT_ENOMEM if the thread can not be created.
+ */
+rt_err_t rtgui_font_prewarm(struct rtgui_font *font, const char *charset);
+/* stop all the prewarms after the chunks being loaded */
+void rtgui_font_prewarm_cancel(void);
+
+/*
+ * The text layout breaks a text into lines in a width once, the lines are
+ * prepared as text runs and reused in each draw. The lines are broken again
+ * only when the text, font or width is changed.
+ */
+struct rtgui_text_line
+{
+    /* the offset of line in text */
+    rt_ubase_t offset;
+    struct rtgui_text_run *run;
+};
+
+struct rtgui_text_layout
+{
+    struct rtgui_font *font;
+    /* the width of line, 0 to break only at new line */
+    int width;
+    /* the height of all the lines */
+    int height;
+
+    char *text;
+
+    int count, capacity;
+    struct rtgui_text_line *lines;
+};
+
+struct rtgui_text_layout *rtgui_text_layout_create(struct rtgui_font *font, const char *text, int width);
+void rtgui_text_layout_destroy(struct rtgui_text_layout *layout);
+/* set the text, font and width of layout, return -RT_ENOMEM if the lines can not be created */
+rt_err_t rtgui_text_layout_set(struct rtgui_text_layout *layout, struct rtgui_font *font,
+                               const char *text, int width);
+
+/*
+ * The font family is a chain of fonts in the order of fallback, such as a
+ * Latin font and a CJK font. Each font has a coverage of the blocks of 64
+ * code points, the text of UTF-8 is segmented once into the sub-runs of the
+ * first font covering the characters, and each sub-run is drawn by its font.
+ * The character covered by none of them is drawn by the last font.
+ */
+#define RTGUI_FONT_FAMILY_MAX       4
+/* the blocks of 64 code points in the Basic Multilingual Plane */
+#define RTGUI_FONT_COVERAGE_SHIFT   6
+#define RTGUI_FONT_COVERAGE_WORDS   (0x10000 >> RTGUI_FONT_COVERAGE_SHIFT >> 5)
+
+/* the code points from first to last */
+struct rtgui_font_range
+{
+    rt_uint32_t first, last;
+};
+
+struct rtgui_font_family
+{
+    int count;
+    struct rtgui_font *fonts[RTGUI_FONT_FAMILY_MAX];
+    rt_uint32_t coverage[RTGUI_FONT_FAMILY_MAX][RTGUI_FONT_COVERAGE_WORDS];
+};
+extern const struct rtgui_font_engine rtgui_font_family_engine;
+
+/* create a family of the name and height, it's added to system */
+struct rtgui_font *rtgui_font_family_create(const char *family, rt_uint16_t height);
+void rtgui_font_family_destroy(struct rtgui_font *font);
+/** Append a font to the fallback chain of family
+ *
+ * @param ranges the coverage of member, RT_NULL to get it from the engine of
+ * member: the range of bitmap font, GB2312 of hz fonts, or all the others.
+ *
+ * @return -RT_EFULL if there are RTGUI_FONT_FAMILY_MAX fonts.
+ */
+rt_err_t rtgui_font_family_add(struct rtgui_font *font, struct rtgui_font *member,
+                               const struct rtgui_font_range *ranges, int count);
+
 /* used by stract font */
 #define FONT_BMP_DATA_BEGIN
 #define FONT_BMP_DATA_END
@@ -0,0 +1,85 @@
+/*
+ * File      : font_aa.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_FONT_AA_H__
+#define __RTGUI_FONT_AA_H__
+
+#include <rtgui/font.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The anti-aliased bitmap font holds the glyphs pre-rendered offline in 4bit
+ * (A4) or 8bit (A8) coverage. The font data is used in place, so it can be
+ * compiled in as a const array or mapped in XIP flash. The layout is (little
+ * endian, 4 bytes aligned):
+ *
+ *   struct rtgui_aa_font_header
+ *   struct rtgui_aa_glyph[last_char - first_char + 1]
+ *   the coverage bitmaps of glyphs, in rows from top to bottom
+ *
+ * The A8 row is one byte for each pixel, and the A4 row is one nibble for
+ * each pixel, high nibble first, with the row padded to bytes. The glyph of
+ * A8 is drawn from the font data directly, and the glyph of A4 is expanded
+ * into the glyph atlas once.
+ */
+#define RTGUI_AA_FONT_MAGIC     "AAFN"
+
+struct rtgui_aa_font_header
+{
+    rt_uint8_t  magic[4];
+    rt_uint8_t  bpp;            /* 4 or 8 */
+    rt_uint8_t  height;         /* the height of line */
+    rt_uint8_t  first_char;
+    rt_uint8_t  last_char;
+    rt_uint32_t size;           /* the size of whole font data */
+};
+
+struct rtgui_aa_glyph
+{
+    rt_uint32_t offset;         /* the offset of bitmap in font data */
+    rt_uint8_t  width, height;  /* 0 for the blank glyph, such as space */
+    rt_int8_t   left, top;      /* the offset of bitmap from the top-left of pen */
+    rt_uint8_t  advance;
+    rt_uint8_t  reserved[3];
+};
+
+extern const struct rtgui_font_engine aa_font_engine;
+
+/** Create an anti-aliased bitmap font and add it to the font system
+ *
+ * @param data the font data, which should be valid while the font is used.
+ * @param font_family the family of font.
+ *
+ * @return RT_NULL if the font data is invalid or there is no memory.
+ */
+struct rtgui_font *rtgui_aa_font_create(const void *data, const char *font_family);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
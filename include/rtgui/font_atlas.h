@@ -0,0 +1,116 @@
+/*
+ * File      : font_atlas.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_FONT_ATLAS_H__
+#define __RTGUI_FONT_ATLAS_H__
+
+#include <rtgui/rtgui.h>
+#include <rtgui/region.h>
+#include <rtgui/dc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The glyph atlas caches the coverage bitmaps (8bit alpha) of glyphs for all
+ * the font engines, which are keyed by the face (any pointer identifies the
+ * font data) and the character code. The glyphs are packed in the shelves of
+ * a fixed buffer, and the least recently used shelf is evicted when the
+ * atlas is full.
+ */
+struct rtgui_glyph
+{
+    /* the coverage bitmap, one byte for each pixel */
+    rt_uint8_t *bitmap;
+    rt_uint16_t pitch;
+    rt_uint16_t width, height;
+
+    /* the offset of bitmap from the pen position */
+    rt_int16_t left, top;
+    /* the advance of pen */
+    rt_int16_t advance;
+};
+
+/*
+ * The glyph run draws glyphs on a dc, and the destination is resolved once
+ * in rtgui_glyph_run_begin. The atlas is locked in the run, so the glyphs
+ * are found, added and drawn between rtgui_glyph_run_begin/end. A glyph is
+ * only valid until the next glyph is added.
+ */
+struct rtgui_glyph_run
+{
+    struct rtgui_dc *dc;
+    rt_bool_t visible;
+
+    /* the clip in logic coordinate, which is in the rotated coordinate of
+     * text for RTGUI_TEXTSTYLE_ROTATE_*, and the clip rotated back to dc */
+    rtgui_rect_t clip;
+    rtgui_rect_t clip_rotated;
+    rtgui_color_t color;
+    rt_uint16_t style;
+
+    /* the pixels of destination, RT_NULL to draw through dc */
+    rt_uint8_t *pixels;
+    int pitch;
+    rt_uint8_t format;
+
+    /* the offset of logic to device, and the drawable area in device */
+    int dx, dy;
+    rtgui_rect_t extent;
+    /* the clip region of client dc */
+    rtgui_region_t *region;
+};
+
+void rtgui_font_atlas_init(void);
+
+struct rtgui_glyph *rtgui_font_atlas_find(const void *face, rt_uint32_t code);
+/* add a glyph with empty bitmap, the font engine renders it then */
+struct rtgui_glyph *rtgui_font_atlas_add(const void *face, rt_uint32_t code, int width, int height);
+/* add a glyph from 1bpp bitmap in rows, MSB first */
+struct rtgui_glyph *rtgui_font_atlas_add_mono(const void *face, rt_uint32_t code,
+                                              const rt_uint8_t *bits, int width, int height,
+                                              int row_bytes);
+/* remove all the glyphs of face, it should be called before the face is released */
+void rtgui_font_atlas_remove(const void *face);
+
+/*
+ * The rotated text is laid out by the font engines in the coordinate of text,
+ * which is the dc rotated around its origin, and the glyph run rotates the
+ * glyphs back. The rotated glyphs of atlas are cached in the atlas as well,
+ * keyed by the orientation in the high bits of code.
+ */
+#define RTGUI_GLYPH_ORIENTATION_SHIFT   30
+/* rotate the rect of dc into the coordinate of text in the orientation (1 - 3 of 90 degrees) */
+void rtgui_glyph_rotate_rect(int orientation, const rtgui_rect_t *rect, rtgui_rect_t *text_rect);
+
+void rtgui_glyph_run_begin(struct rtgui_glyph_run *run, struct rtgui_dc *dc, const rtgui_rect_t *clip);
+void rtgui_glyph_run_draw(struct rtgui_glyph_run *run, const struct rtgui_glyph *glyph, int x, int y);
+void rtgui_glyph_run_end(struct rtgui_glyph_run *run);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -57,11 +57,52 @@ struct fnt_font
     const MWIMAGEBITS *bits;   /* nbits */
     const rt_uint16_t *offset; /* noffset */
     const rt_uint8_t  *width;  /* nwidth */
+    /* the 32-bit offsets of binary font, instead of offset */
+    const rt_uint32_t *long_offset;
 };
 extern const struct rtgui_font_engine fnt_font_engine;
 
 struct rtgui_font *fnt_font_create(const char* filename, const char* font_family);
 
+/*
+ * The binary fnt font compiled by example/mkfnt.py, which is used in place.
+ * The map is in little endian and aligned to 4 bytes, the header is followed
+ * by the tables of direct index by (char - first_char) and the glyph bits in
+ * the columns of fnt font. The offsets of tables are from the beginning of
+ * map, the offset and width tables are 0 in the fixed width font.
+ */
+#define FNT_MAP_MAGIC       "RTFN"
+#define FNT_MAP_VERSION     1
+
+struct fnt_map_header
+{
+    rt_uint8_t magic[4];
+    rt_uint16_t version;
+    rt_uint16_t header_size;
+
+    rt_uint16_t max_width;
+    rt_uint16_t height;
+    rt_uint16_t ascent;
+    rt_uint16_t depth;
+
+    rt_uint32_t first_char;
+    rt_uint32_t default_char;
+    /* the number of chars */
+    rt_uint32_t size;
+
+    /* rt_uint32_t offset[size] of glyph in bits */
+    rt_uint32_t offset_table;
+    /* rt_uint8_t width[size] */
+    rt_uint32_t width_table;
+    rt_uint32_t bits;
+    rt_uint32_t nbits;
+};
+
+/* create fnt font with the binary font mapped in memory, such as XIP flash */
+struct rtgui_font *rtgui_fnt_map_font_create(const void *map, rt_uint32_t size, const char* font_family);
+/* create fnt font with the binary font file loaded in one read */
+struct rtgui_font *rtgui_fnt_bin_font_create(const char* filename, const char* font_family);
+
 struct rtgui_fnt_header
 {
     rt_uint32_t p;
@@ -76,6 +117,8 @@ struct rtgui_fnt_header
 
 struct rtgui_font *rtgui_fnt_font_create(const char* filename, const char* font_family);
 struct rtgui_font *rtgui_hz_fnt_font_create(const char* filename, const char* font_family, rt_uint8_t font_size);
+/* create hz font with the font file mapped in memory, such as XIP flash */
+struct rtgui_font *rtgui_hz_map_font_create(const void *map, rt_uint32_t size, const char* font_family, rt_uint8_t font_size);
 struct rtgui_font *rtgui_asc_fnt_font_create(const char* filename, const char* font_family, rt_uint8_t font_size);
 
 #ifdef __cplusplus
@@ -33,7 +33,44 @@
 extern "C" {
 #endif
 
+/* the statistics of FreeType shared by all the ttf fonts */
+struct rtgui_ttf_stat
+{
+    /* the glyph lookups of sbit cache */
+    rt_uint32_t hits, misses;
+    /* the faces opened, a face is opened again after evicted */
+    rt_uint32_t faces;
+    /* the heap used by FreeType */
+    rt_uint32_t bytes, max_bytes;
+};
+
+/*
+ * The profile of loading glyphs for the sizes up to max_size. The hinting is
+ * the cost of each cache miss, none by default, and the small sizes may be in
+ * mono or the embedded bitmaps of font.
+ */
+#define RTGUI_TTF_HINT_NONE     0x00
+/* the hinting of font itself */
+#define RTGUI_TTF_HINT_NATIVE   0x01
+#define RTGUI_TTF_HINT_AUTO     0x02
+/* the light autohinter, vertical only */
+#define RTGUI_TTF_HINT_LIGHT    0x04
+/* render in 1bpp */
+#define RTGUI_TTF_MONO          0x08
+/* use the embedded bitmaps, the size snaps to a strike within 1 pixel */
+#define RTGUI_TTF_BITMAP        0x10
+
+struct rtgui_ttf_profile
+{
+    rt_uint16_t max_size;
+    rt_uint16_t flags;
+};
+
 void rtgui_ttf_system_init(void);
+/* the profiles in ascending max_size for the fonts created later, they are
+ * not copied. RT_NULL is the default of GUIENGINE_TTF_SMALL_SIZE. */
+void rtgui_ttf_set_profiles(const struct rtgui_ttf_profile *profiles, int count);
+void rtgui_ttf_get_stat(struct rtgui_ttf_stat *stat);
 rtgui_font_t *rtgui_freetype_font_create(const char *filename, rt_size_t size, const char* font_family);
 void rtgui_freetype_font_destroy(rtgui_font_t *font);
 
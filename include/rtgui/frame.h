@@ -0,0 +1,79 @@
+/*
+ * File      : frame.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_FRAME_H__
+#define __RTGUI_FRAME_H__
+
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/widgets/widget.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The frame clock of app ticks with the frames presented by server (the panel
+ * vsync, or GUIENGINE_FRAME_MS if the panel does not report it). On each frame
+ * all the running frame callbacks of app are invoked once, and the callbacks
+ * of the widgets in one window draw in one drawing of the window, so they are
+ * presented in one update.
+ */
+struct rtgui_frame;
+typedef void (*rtgui_frame_func_t)(struct rtgui_frame *frame, struct rtgui_dc *dc,
+                                   rt_uint32_t delta_ms);
+
+struct rtgui_frame
+{
+    rt_list_t list;
+
+    /* the widget animated, the drawing dc is created on it */
+    struct rtgui_widget *widget;
+    rtgui_frame_func_t func;
+    void *user_data;
+
+    rt_uint16_t serial;
+};
+
+void rtgui_frame_init(struct rtgui_frame *frame, struct rtgui_widget *widget,
+                      rtgui_frame_func_t func, void *user_data);
+
+/** Start the frame callback on the app of current thread
+ *
+ * The widget is marked in animation, and rtgui_widget_update of it is skipped
+ * until the frame is stopped. The dc passed to the callback is RT_NULL if the
+ * widget is not visible, the callback should update the animation state still.
+ */
+void rtgui_frame_start(struct rtgui_frame *frame);
+void rtgui_frame_stop(struct rtgui_frame *frame);
+rt_bool_t rtgui_frame_is_running(struct rtgui_frame *frame);
+
+/* invoke the frame callbacks of app on the RTGUI_EVENT_FRAME */
+void rtgui_frame_dispatch(struct rtgui_app *app, struct rtgui_event_frame *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
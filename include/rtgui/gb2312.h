@@ -1,6 +1,7 @@
 #ifndef __GB2312_H__
 #define __GB2312_H__
 
+#include <rtthread.h>
 
 void UTF_8ToUnicode(unsigned short* pOut, char *pText);
 void UnicodeToGB2312(char* pOut, unsigned short uData);
@@ -12,5 +13,13 @@ int UTF_8ToGB2312_LEN(char *pText, int pLen);
 void UTF_8ToGB2312(char *pOut, char *pText, int pLen);
 int Gb2312ToUtf8(char *pGb2312, int len, char **ppUtf8);
 
+/* the GB2312 of unicode in the bytes order, such as 0xB0A1, 0 if it doesn't exist */
+rt_uint16_t rtgui_unicode_to_gb2312(rt_uint32_t unicode);
+/* decode a character of UTF-8, return the bytes of it */
+int rtgui_utf8_decode(const char *text, int len, rt_uint32_t *unicode);
+/* the streaming converters into the buffer of caller, return the bytes written */
+int rtgui_utf8_to_gb2312(const char *text, int len, char *out, int size);
+int rtgui_gb2312_to_utf8(const char *text, int len, char *out, int size);
+
 #endif
 
@@ -33,6 +33,27 @@ extern "C" {
 #endif
 
 struct rtgui_image;
+struct rtgui_image_stream;
+
+/* the frame of animated image, decoded on the canvas kept by the image */
+struct rtgui_image_frame
+{
+    struct rtgui_dc *canvas;
+    /* the rect of canvas changed from the last frame, the whole for the current one */
+    struct rtgui_rect changed;
+    /* the time to show the frame in ms */
+    rt_uint32_t delay;
+};
+
+/* the metrics of image read from the header of it */
+struct rtgui_image_probe_info
+{
+    /* the name of image engine */
+    const char *format;
+    rt_uint16_t w, h;
+    rt_bool_t has_alpha;
+};
+
 struct rtgui_image_engine
 {
     const char *name;
@@ -45,6 +66,21 @@ struct rtgui_image_engine
     void (*image_unload)(struct rtgui_image *image);
 
     void (*image_blit)(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
+
+    /* read the info from header without the decoder, it's optional */
+    rt_bool_t (*image_probe)(struct rtgui_filerw *file, struct rtgui_image_probe_info *info);
+
+    /* decode the data pushed in chunks, it's optional */
+    rt_bool_t (*stream_begin)(struct rtgui_image_stream *stream);
+    rt_err_t (*stream_feed)(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length);
+    void (*stream_end)(struct rtgui_image_stream *stream);
+
+    /* the current frame of animated image, or step to the next one. It's optional */
+    rt_bool_t (*image_frame)(struct rtgui_image *image, rt_bool_t next, struct rtgui_image_frame *frame);
+
+    /* blit with the opacity and tint in the kernel, RT_FALSE if it can't. It's optional */
+    rt_bool_t (*image_blit_ex)(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect,
+                               rt_uint8_t opacity, rtgui_color_t tint);
 };
 
 struct rtgui_image_palette
@@ -77,11 +113,89 @@ void rtgui_system_image_init(void);
 struct rtgui_image_engine *rtgui_image_get_engine_by_filename(const char *fn);
 struct rtgui_image *rtgui_image_create_from_file(const char *type, const char *filename, rt_bool_t load);
 struct rtgui_image *rtgui_image_create(const char *filename, rt_bool_t load);
+/* the info of image file, the image is created without load if its engine can not probe */
+rt_err_t rtgui_image_probe(const char *filename, struct rtgui_image_probe_info *info);
+
+#ifdef GUIENGINE_USING_IMAGE_DISK_CACHE
+/* open the decoded PNG or JPEG file in disk cache, RT_NULL if it's not there */
+struct rtgui_image *rtgui_image_cache_open(const char *filename, rt_bool_t load);
+/* keep the image decoded from file in disk cache */
+void rtgui_image_cache_store(const char *filename, struct rtgui_image *image);
 #endif
+#endif
+/** Probe the info of image in the header
+ *
+ * The engine of type is tried first, then the other engines which can probe.
+ * No decoder is set up for it.
+ *
+ * @return -RT_ERROR if it's not an image could be probed.
+ */
+rt_err_t rtgui_image_probe_filerw(const char *type, struct rtgui_filerw *file,
+                                  struct rtgui_image_probe_info *info);
 
+/* the HDC image not compressed references the data in place, so the data
+ * should be valid until the image is destroyed */
 struct rtgui_image *rtgui_image_create_from_mem(const char *type, const rt_uint8_t *data, rt_size_t length, rt_bool_t load);
+/* the filerw is owned by the image created, it's closed on failure */
+struct rtgui_image *rtgui_image_create_from_filerw(const char *type, struct rtgui_filerw *filerw, rt_bool_t load);
 void rtgui_image_destroy(struct rtgui_image *image);
 
+/*
+ * The progressive decode of the data received in chunks, such as from the
+ * network. The rows decoded are in the ARGB888 buffer dc of stream, which is
+ * created when the header is parsed, and the func is invoked on the rows
+ * from y1 to y2 (not included) updated by each feed. An interlaced PNG
+ * updates all the rows in each pass.
+ */
+typedef void (*rtgui_image_stream_func_t)(struct rtgui_image_stream *stream, int y1, int y2,
+                                          void *user_data);
+
+struct rtgui_image_stream
+{
+    const struct rtgui_image_engine *engine;
+
+    /* RT_NULL before the header */
+    struct rtgui_dc *dc;
+    rt_uint16_t w, h;
+    /* all the rows are decoded */
+    rt_bool_t done;
+
+    rtgui_image_stream_func_t func;
+    void *user_data;
+
+    /* the private data of engine */
+    void *data;
+};
+
+/* RT_NULL if the engine of type has no stream decoder */
+struct rtgui_image_stream *rtgui_image_stream_create(const char *type, rtgui_image_stream_func_t func,
+                                                     void *user_data);
+/* -RT_ERROR on the corrupt data, the data is not referenced after it */
+rt_err_t rtgui_image_stream_feed(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length);
+void rtgui_image_stream_destroy(struct rtgui_image_stream *stream);
+/* used by the engines: create the dc on the header, and report the rows */
+rt_bool_t rtgui_image_stream_set_size(struct rtgui_image_stream *stream, int w, int h);
+void rtgui_image_stream_update(struct rtgui_image_stream *stream, int y1, int y2);
+
+/*
+ * Decode the image into the pixels of caller without the pixels of image,
+ * such as a slab in SDRAM or the backing store of window. The format and
+ * pitch are negotiated by rtgui_image_decode_format and
+ * rtgui_image_decode_size, then the buffer dc is created on the pixels by
+ * rtgui_dc_buffer_create_from_pixel. The image is decoded as not loaded and
+ * written to the dc row by row, any dc could be the target.
+ */
+/* ARGB888 for the image with alpha, otherwise the format of screen */
+rt_uint8_t rtgui_image_decode_format(const struct rtgui_image_probe_info *info);
+/* the bytes of w x h in format, the pitch is aligned to align bytes (a power of 2) */
+rt_size_t rtgui_image_decode_size(rt_uint8_t format, int w, int h, int align, int *pitch);
+/* decode at the left top of dc, the pixels under the image with alpha are replaced
+ * on a buffer dc. The filerw is closed */
+rt_err_t rtgui_image_decode_filerw(const char *type, struct rtgui_filerw *filerw, struct rtgui_dc *dc);
+#if defined(GUIENGINE_USING_DFS_FILERW)
+rt_err_t rtgui_image_decode_file(const char *filename, struct rtgui_dc *dc);
+#endif
+
 /* get image's rect */
 void rtgui_image_get_rect(struct rtgui_image *image, struct rtgui_rect *rect);
 
@@ -90,8 +204,109 @@ void rtgui_image_register_engine(struct rtgui_image_engine *engine);
 
 /* blit an image on DC */
 void rtgui_image_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
+
+/** Blit an image with the opacity and the colors multiplied by tint
+ *
+ * The monochrome icon is recolored by the tint, RTGUI_RGB(255, 255, 255) is
+ * no tint. The modulation is in the blit kernel if the engine supports,
+ * otherwise the image is blitted through a temporary buffer.
+ */
+void rtgui_image_blit_ex(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect,
+                         rt_uint8_t opacity, rtgui_color_t tint);
+
+/* get the current frame of animated image, RT_FALSE if the image is not animated */
+rt_bool_t rtgui_image_get_frame(struct rtgui_image *image, struct rtgui_image_frame *frame);
+/** Step the animated image to its next frame, which is shown by the next blit
+ *
+ * Only the changed rect of frame is to be blitted again.
+ *
+ * @return RT_FALSE if the image is not animated or the animation ends.
+ */
+rt_bool_t rtgui_image_next_frame(struct rtgui_image *image, struct rtgui_image_frame *frame);
 struct rtgui_image_palette *rtgui_image_palette_create(rt_uint32_t ncolors);
 
+#if (defined(GUIENGINE_IMAGE_TJPGD) || defined(GUIENGINE_IMAGE_JPEG)) && defined(GUIENGINE_USING_DFS_FILERW)
+/* decode a jpeg file in 1/2, 1/4 or 1/8 scale, which is the smallest one
+ * still covers width x height */
+struct rtgui_image *rtgui_image_jpeg_create_thumbnail(const char *filename, int width, int height);
+#endif
+
+#ifdef GUIENGINE_IMAGE_JPEG
+/* the decoding of libjpeg, in the speed or the quality */
+enum rtgui_jpeg_profile
+{
+    /* the fast integer IDCT, no fancy upsampling and dither */
+    RTGUI_JPEG_PROFILE_FAST,
+    /* the fast integer IDCT, the fancy upsampling and ordered dither */
+    RTGUI_JPEG_PROFILE_BALANCED,
+    /* the accurate integer IDCT and the block smoothing */
+    RTGUI_JPEG_PROFILE_QUALITY,
+};
+
+/* the profile of the jpeg images loaded by rtgui_image_create */
+void rtgui_image_jpeg_set_profile(enum rtgui_jpeg_profile profile);
+#if defined(GUIENGINE_USING_DFS_FILERW)
+/* decode a jpeg file in the profile, scaled down if width x height is not 0 */
+struct rtgui_image *rtgui_image_jpeg_create(const char *filename, enum rtgui_jpeg_profile profile,
+                                            int width, int height);
+#endif
+#endif
+
+#if defined(GUIENGINE_IMAGE_XPM) && defined(GUIENGINE_USING_XPM_CACHE)
+/* release the compiled XPMs which no image is loaded from */
+void rtgui_image_xpm_cache_flush(void);
+#endif
+
+#ifdef GUIENGINE_USING_IMAGE_MIPMAP
+/* the levels of mipmap at most, the full one is 4096 pixels in width or height */
+#define RTGUI_IMAGE_MIPMAP_LEVELS   13
+
+/*
+ * The image in its halves of ARGB888, the scaled blit is filtered from the
+ * nearest level, which is faster and not aliased in the large shrink. The
+ * chain takes 4/3 of the ARGB888 of full image.
+ */
+struct rtgui_image_mipmap;
+
+/* the levels including the full one, 0 is all the levels to 1 pixel */
+struct rtgui_image_mipmap *rtgui_image_mipmap_create(struct rtgui_image *image, int levels);
+void rtgui_image_mipmap_destroy(struct rtgui_image_mipmap *mipmap);
+/* a new ARGB888 buffer dc of the image in w x h */
+struct rtgui_dc *rtgui_image_mipmap_scale(struct rtgui_image_mipmap *mipmap, int w, int h);
+/* blit the image scaled to the rect */
+void rtgui_image_mipmap_blit(struct rtgui_image_mipmap *mipmap, struct rtgui_dc *dc, struct rtgui_rect *rect);
+#endif
+
+/*
+ * Decode the image in the loader thread. When the image is decoded, or it
+ * failed with image RT_NULL, the done callback is invoked in the thread of
+ * application which makes the request, and the image is owned by callback.
+ * The widget could paint a placeholder before that.
+ *
+ * The request handle is valid until the callback returns or the request is
+ * canceled. The data of image in memory should be valid until then.
+ */
+struct rtgui_image_request;
+typedef void (*rtgui_image_done_t)(struct rtgui_image_request *request, struct rtgui_image *image,
+                                   void *user_data);
+
+void rtgui_image_loader_init(void);
+#if defined(GUIENGINE_USING_DFS_FILERW)
+struct rtgui_image_request *rtgui_image_load_async(const char *filename, rtgui_image_done_t done,
+                                                   void *user_data);
+/* the request in background, which is decoded after the others and in
+ * GUIENGINE_IMAGE_PREFETCH_PRIORITY */
+struct rtgui_image_request *rtgui_image_load_background(const char *filename, rtgui_image_done_t done,
+                                                        void *user_data);
+#endif
+struct rtgui_image_request *rtgui_image_load_mem_async(const char *type, const rt_uint8_t *data,
+                                                       rt_size_t length, rtgui_image_done_t done,
+                                                       void *user_data);
+/* cancel the request, the callback is not invoked */
+void rtgui_image_request_cancel(struct rtgui_image_request *request);
+/* complete the request on RTGUI_EVENT_IMAGE_LOADED, called by application */
+void rtgui_image_request_complete(struct rtgui_image_request *request);
+
 #ifdef __cplusplus
 }
 #endif
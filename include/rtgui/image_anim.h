@@ -0,0 +1,63 @@
+/*
+ * File      : image_anim.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#ifndef __RTGUI_IMAGE_ANIM_H__
+#define __RTGUI_IMAGE_ANIM_H__
+
+#include <rtgui/image.h>
+#include <rtgui/frame.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The player of animated image in a widget. The frames are stepped on the
+ * frame clock of app by their delays, and only the rect changed by them is
+ * drawn on the widget. The widget should blit the image in its paint as the
+ * other images, which shows the current frame.
+ */
+struct rtgui_image_anim
+{
+    struct rtgui_frame frame;
+
+    struct rtgui_image *image;
+    /* the rect of image in the widget */
+    rtgui_rect_t rect;
+
+    /* the time of current frame shown */
+    rt_uint32_t elapsed;
+    rt_uint32_t delay;
+};
+
+void rtgui_image_anim_init(struct rtgui_image_anim *anim, struct rtgui_widget *widget,
+                           struct rtgui_image *image, rtgui_rect_t *rect);
+/* the animation stops itself at the end of image, the last frame is kept */
+void rtgui_image_anim_start(struct rtgui_image_anim *anim);
+void rtgui_image_anim_stop(struct rtgui_image_anim *anim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * File      : image_atlas.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#ifndef __RTGUI_IMAGE_ATLAS_H__
+#define __RTGUI_IMAGE_ATLAS_H__
+
+#include <rtgui/image.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The atlas is one sheet of icons decoded in a buffer, and the icons are the
+ * images of sub-rects in it. The icon images are blitted as the others, all
+ * of them are in the memory of one decode and no engine state for each.
+ */
+struct rtgui_atlas_entry
+{
+    const char *name;
+    rt_int16_t x, y;
+    rt_uint16_t w, h;
+};
+
+struct rtgui_image_atlas;
+
+/** Create the atlas from the sheet image
+ *
+ * @param pixel_format the pixels of sheet kept, ARGB888 for the icons with alpha.
+ * @param entries the table of icons, which should be valid until the atlas
+ *        is destroyed.
+ *
+ * The sheet image could be destroyed after it.
+ */
+struct rtgui_image_atlas *rtgui_image_atlas_create(struct rtgui_image *sheet, rt_uint8_t pixel_format,
+                                                   const struct rtgui_atlas_entry *entries, int count);
+#if defined(GUIENGINE_USING_DFS_FILERW)
+/* the sheet with alpha is kept in ARGB888, the others in the pixels of driver */
+struct rtgui_image_atlas *rtgui_image_atlas_create_from_file(const char *filename,
+                                                             const struct rtgui_atlas_entry *entries,
+                                                             int count);
+#endif
+void rtgui_image_atlas_destroy(struct rtgui_image_atlas *atlas);
+
+/* the image of icon owned by atlas, not to be destroyed. RT_NULL if no such name */
+struct rtgui_image *rtgui_image_atlas_get(struct rtgui_image_atlas *atlas, const char *name);
+
+/* blit the src rect of the atlas icon on the rect of dc */
+void rtgui_image_blit_subrect(struct rtgui_image *image, const rtgui_rect_t *src,
+                              struct rtgui_dc *dc, rtgui_rect_t *rect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -40,16 +40,52 @@ struct rtgui_image_item
     char *filename;
 
     rt_uint32_t refcount;
+
+    /* the bytes of image decoded */
+    rt_uint32_t size;
+    /* the pinned item is kept when it's not referenced */
+    rt_bool_t pinned;
+    /* the node of lru list when it's not referenced */
+    rt_list_t list;
 };
 typedef struct rtgui_image_item rtgui_image_item_t;
 
 void rtgui_system_image_container_init(void);
 
+/*
+ * The item is kept in container after the last put, and the least recently
+ * used one is destroyed when the images in container are more than
+ * GUIENGINE_IMAGE_CONTAINER_BUDGET bytes.
+ */
 struct rtgui_image_item *rtgui_image_container_get(const char *filename);
+/*
+ * Get the image scaled to w x h and rotated by angle (in degrees), which is
+ * cached in container like the other images. The rotated image is the
+ * bounding box of rotation.
+ */
+struct rtgui_image_item *rtgui_image_container_get_scaled(const char *filename, int w, int h,
+                                                          int angle, rt_bool_t smooth);
 struct rtgui_image_item *rtgui_image_container_find(const char *filename);
 struct rtgui_image_item *rtgui_image_container_create(const char *filename);
 void rtgui_image_container_put(struct rtgui_image_item *item);
 
+/* keep the item in container even if it's not referenced */
+void rtgui_image_container_pin(struct rtgui_image_item *item, rt_bool_t pinned);
+/* destroy all the items not referenced or pinned */
+void rtgui_image_container_flush(void);
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+/*
+ * Decode the images for the next screen in background, the filenames are
+ * ended by RT_NULL. The image decoded is cached as an unreferenced item in the
+ * application thread, and it's dropped if it does not fit in the free budget,
+ * the cached ones are not evicted for it.
+ */
+void rtgui_image_container_prefetch(const char * const *filenames);
+/* cancel the prefetches not cached yet */
+void rtgui_image_container_prefetch_cancel(void);
+#endif
+
 #endif
 
 #ifdef __cplusplus
@@ -37,6 +37,31 @@ struct rtgui_image_hdcmm
     rt_uint8_t *pixels;
 };
 
+/*
+ * The HDC of version 3 is compressed in the bands of rows, so a blit only
+ * decompresses the visible bands. The layout after the header is:
+ *
+ *   struct rtgui_image_hdc_band
+ *   rt_uint32_t index[band_count + 1], the offsets of bands in file, and the
+ *               last one is the end of data
+ *   the compressed bands
+ *
+ * The band of HDC_COMPRESS_FASTLZ is one fastlz block of the rows. The band
+ * of HDC_COMPRESS_RLE is the rows encoded one by one. Each row is a list of
+ * runs, and each run is a control byte followed by the pixels: bit7 set for
+ * (bit0-6 + 1) repeated pixels followed by one pixel, and bit7 clear for
+ * (bit0-6 + 1) literal pixels. The run doesn't cross the rows.
+ */
+#define HDC_COMPRESS_FASTLZ     1
+#define HDC_COMPRESS_RLE        2
+
+struct rtgui_image_hdc_band
+{
+    rt_uint16_t band_height;
+    rt_uint8_t  method;
+    rt_uint8_t  reserved;
+};
+
 struct rtgui_image_hdc
 {
     rt_bool_t is_loaded;
@@ -48,6 +73,13 @@ struct rtgui_image_hdc
 
     rt_size_t   pixel_offset;
     rt_uint8_t *pixels;
+    /* the pixels reference the image data in memory (XIP flash) in place */
+    rt_bool_t   is_mapped;
+
+    /* the bands of version 3, RT_NULL for the image not compressed */
+    rt_uint8_t  method;
+    rt_uint16_t band_height;
+    rt_uint32_t *band_index;
 
     struct rtgui_filerw *filerw;
 };
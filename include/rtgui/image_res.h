@@ -0,0 +1,87 @@
+/*
+ * File      : image_res.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_IMAGE_RES_H__
+#define __RTGUI_IMAGE_RES_H__
+
+#include <rtgui/image.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The resource archive packs the images converted to HDC in the pixel format
+ * of device at build time (example/mkres.py). The archive is used in place,
+ * so it can be linked as a const array or mapped in XIP flash. The layout is
+ * (little endian, 4 bytes aligned):
+ *
+ *   struct rtgui_image_res_header
+ *   struct rtgui_image_res_entry[count], sorted by name
+ *   the names, terminated by '\0'
+ *   the HDC images, each one 4 bytes aligned
+ *
+ * The offsets are from the beginning of archive.
+ */
+#define RTGUI_IMAGE_RES_MAGIC   "GRES"
+
+struct rtgui_image_res_header
+{
+    rt_uint8_t  magic[4];
+    rt_uint32_t count;
+};
+
+struct rtgui_image_res_entry
+{
+    rt_uint32_t name;
+    rt_uint32_t offset;
+    rt_uint32_t length;
+};
+
+/** Mount a resource archive, the images in it can be created by name
+ *
+ * @param archive the data of archive, which should be valid until unmounted.
+ *
+ * @return -RT_ERROR if the archive is invalid, -RT_ENOMEM if there is no memory.
+ */
+rt_err_t rtgui_image_res_mount(const void *archive);
+void rtgui_image_res_unmount(const void *archive);
+
+/** Create an image from the mounted archives
+ *
+ * The image not compressed references the pixels in the archive without
+ * copying.
+ *
+ * @param name the name of image in archive.
+ * @param load whether to decompress the compressed image at once.
+ *
+ * @return RT_NULL if the image is not found.
+ */
+struct rtgui_image *rtgui_image_res_create(const char *name, rt_bool_t load);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * File      : pack.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#ifndef __RTGUI_PACK_H__
+#define __RTGUI_PACK_H__
+
+#include <rtgui/rtgui.h>
+#include <rtgui/filerw.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(GUIENGINE_USING_PACK) && defined(GUIENGINE_USING_DFS_FILERW)
+
+/*
+ * The resource pack is one file of the assets, in little endian:
+ *
+ *   struct rtgui_pack_header;
+ *   rt_uint32_t bucket[buckets];        the first entry of bucket, or ~0
+ *   struct rtgui_pack_entry entry[count];
+ *   char names[names_size];             the names ended by '\0'
+ *   ...                                 the blobs, aligned by the packer
+ *
+ * The bucket of a name is its FNV-1a hash % buckets, and the entries of a
+ * bucket are chained by next. The directory is loaded at the open, so an
+ * entry is found in memory, and its blob is read with one seek.
+ */
+#define RTGUI_PACK_MAGIC        "RPAK"
+#define RTGUI_PACK_VERSION      1
+
+/* the blob is stored as it is, or compressed by FastLZ */
+#define RTGUI_PACK_STORE        0
+#define RTGUI_PACK_FASTLZ       1
+
+struct rtgui_pack_header
+{
+    char magic[4];
+    rt_uint16_t version;
+    rt_uint16_t buckets;
+    rt_uint32_t count;
+    rt_uint32_t names_size;
+};
+
+struct rtgui_pack_entry
+{
+    rt_uint32_t hash;
+    rt_uint32_t next;
+    /* the offset of name in names */
+    rt_uint32_t name;
+    /* the offset of blob in file, the bytes stored and the bytes of data */
+    rt_uint32_t offset;
+    rt_uint32_t size;
+    rt_uint32_t length;
+    rt_uint32_t method;
+};
+
+struct rtgui_pack;
+
+rt_uint32_t rtgui_pack_hash(const char *name);
+
+struct rtgui_pack *rtgui_pack_open(const char *path);
+/* the pack is released after the entries opened are closed */
+void rtgui_pack_close(struct rtgui_pack *pack);
+/* open the entry for read, the compressed one is decompressed in memory */
+struct rtgui_filerw *rtgui_pack_open_entry(struct rtgui_pack *pack, const char *name);
+
+/*
+ * The files under the prefix are the entries of the pack, such as the entry
+ * "icons/ok.png" of the pack mounted on "/res/" is "/res/icons/ok.png". The
+ * images created from a file are looked up in the mounted packs first.
+ */
+rt_err_t rtgui_pack_mount(struct rtgui_pack *pack, const char *prefix);
+void rtgui_pack_unmount(struct rtgui_pack *pack);
+/* open the file in the mounted packs, RT_NULL if it's not in them */
+struct rtgui_filerw *rtgui_pack_open_file(const char *filename);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
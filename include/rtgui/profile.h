@@ -0,0 +1,136 @@
+/*
+ * File      : profile.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_PROFILE_H__
+#define __RTGUI_PROFILE_H__
+
+#include <rtthread.h>
+#include <rtgui/rtgui_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The render profile of windows. The calls of engine, font and screen update
+ * are counted in the drawing of window by the thread (the outermost
+ * rtgui_dc_begin_drawing to rtgui_dc_end_drawing is a frame of window), the
+ * time of items are inclusive: the fill in a blit is in both of them. The
+ * calls out of any drawing are counted in the window "-". See list_guiprof.
+ */
+enum rtgui_profile_item
+{
+    RTGUI_PROFILE_DRAWING,
+    RTGUI_PROFILE_POINT,
+    RTGUI_PROFILE_LINE,
+    RTGUI_PROFILE_SPAN,
+    RTGUI_PROFILE_FILL,
+    RTGUI_PROFILE_BLIT,
+    /* the pixels are the glyphs */
+    RTGUI_PROFILE_FONT,
+    RTGUI_PROFILE_UPDATE,
+
+    RTGUI_PROFILE_ITEM_MAX,
+};
+
+#ifdef GUIENGINE_USING_PROFILE
+struct rtgui_win;
+
+rt_inline rt_uint32_t rtgui_profile_clock(void)
+{
+    return GUIENGINE_PROFILE_CLOCK();
+}
+
+void rtgui_profile_add(enum rtgui_profile_item item, rt_uint32_t pixels, rt_uint32_t start);
+void rtgui_profile_blit(rt_uint8_t src_format, rt_uint8_t dst_format,
+                        rt_uint32_t pixels, rt_uint32_t start);
+void rtgui_profile_drawing_begin(struct rtgui_win *win);
+void rtgui_profile_drawing_end(struct rtgui_win *win);
+void rtgui_profile_reset(void);
+
+#define RTGUI_PROFILE_DECLARE               rt_uint32_t _profile_start
+#define RTGUI_PROFILE_BEGIN()               _profile_start = rtgui_profile_clock()
+#define RTGUI_PROFILE_END(item, pixels)     rtgui_profile_add((item), (pixels), _profile_start)
+#else
+#define RTGUI_PROFILE_DECLARE
+#define RTGUI_PROFILE_BEGIN()
+#define RTGUI_PROFILE_END(item, pixels)
+#endif
+
+/*
+ * The latency from input to screen. The input is stamped when acquired (by
+ * driver, or when posted to server), the stamp is carried by the event to the
+ * app and to the first screen update of drawings in the handler of it. See
+ * list_guilat.
+ */
+#ifdef GUIENGINE_USING_LATENCY
+struct rtgui_event;
+
+void rtgui_latency_stamp(struct rtgui_event *event);
+/* the screen is updated for the input of stamp */
+void rtgui_latency_add(rt_uint32_t stamp);
+void rtgui_latency_reset(void);
+#endif
+
+/*
+ * The time of boot. The phases are timed by the begin and end (cumulative,
+ * the FreeType faces are loaded several times), the first window show and
+ * screen update are the time they happen. The time is in the clock of
+ * profile, which should be counted from the boot. See list_guiboot.
+ */
+enum rtgui_boot_phase
+{
+    RTGUI_BOOT_SERVER_INIT,
+    RTGUI_BOOT_IMAGE_INIT,
+    RTGUI_BOOT_IMAGE_CONTAINER,
+    RTGUI_BOOT_FONT_INIT,
+    RTGUI_BOOT_TTF_INIT,
+    RTGUI_BOOT_TTF_FACE,
+    RTGUI_BOOT_SERVER_START,
+    RTGUI_BOOT_FIRST_SHOW,
+    RTGUI_BOOT_FIRST_UPDATE,
+
+    RTGUI_BOOT_PHASE_MAX,
+};
+
+#ifdef GUIENGINE_USING_BOOT_PROFILE
+void rtgui_boot_begin(enum rtgui_boot_phase phase);
+void rtgui_boot_end(enum rtgui_boot_phase phase);
+/* the first time of phase, the boot is reported at the first screen update */
+void rtgui_boot_mark(enum rtgui_boot_phase phase);
+
+#define RTGUI_BOOT_BEGIN(phase)     rtgui_boot_begin(phase)
+#define RTGUI_BOOT_END(phase)       rtgui_boot_end(phase)
+#define RTGUI_BOOT_MARK(phase)      rtgui_boot_mark(phase)
+#else
+#define RTGUI_BOOT_BEGIN(phase)
+#define RTGUI_BOOT_END(phase)
+#define RTGUI_BOOT_MARK(phase)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
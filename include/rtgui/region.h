@@ -41,10 +41,25 @@ struct rtgui_region_data
     /* rtgui_rect_t rects[size]; in memory but not explicitly declared */
 };
 
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+/* the inline data of small region, which avoids the heap allocation */
+struct rtgui_region_inline
+{
+    rtgui_region_data_t head;
+    rtgui_rect_t rects[GUIENGINE_REGION_INLINE_RECTS];
+};
+#endif
+
 typedef struct rtgui_region
 {
     rtgui_rect_t          extents;
     rtgui_region_data_t  *data;
+    /* the rect of the last point found, it's checked before the use */
+    rt_uint32_t           hint;
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+    /* only used through data, never copy a region by value */
+    struct rtgui_region_inline inline_data;
+#endif
 } rtgui_region_t;
 
 typedef enum
@@ -70,6 +85,9 @@ rtgui_region_status_t rtgui_region_intersect_rect(rtgui_region_t *newReg, rtgui_
 rtgui_region_status_t rtgui_region_union(rtgui_region_t *newReg, rtgui_region_t *reg1, rtgui_region_t *reg2);
 rtgui_region_status_t rtgui_region_union_rect(rtgui_region_t *dest, rtgui_region_t *source, rtgui_rect_t *rect);
 rtgui_region_status_t rtgui_region_subtract(rtgui_region_t *regD, rtgui_region_t *regM, rtgui_region_t *regS);
+/* set the region to rect minus the rects in one pass, its data is reused */
+rtgui_region_status_t rtgui_region_clip_rect_minus_rects(rtgui_region_t *region, const rtgui_rect_t *rect,
+                                                         const rtgui_rect_t *rects, int count);
 rtgui_region_status_t rtgui_region_subtract_rect(rtgui_region_t *regD, rtgui_region_t *regM, rtgui_rect_t *rect);
 rtgui_region_status_t rtgui_region_inverse(rtgui_region_t *newReg, rtgui_region_t *reg1, rtgui_rect_t *invRect);
 
@@ -84,6 +102,21 @@ rtgui_rect_t *rtgui_region_rects(rtgui_region_t *region);
 int rtgui_region_contains_point(rtgui_region_t *region, int x, int y, rtgui_rect_t *box);
 int rtgui_region_contains_rectangle(rtgui_region_t *rtgui_region_t, rtgui_rect_t *prect);
 
+/* the spans of region in a row, for the drawing of scanlines */
+struct rtgui_region_span_iter
+{
+    const rtgui_rect_t *rect, *end;
+    int x1, x2;
+};
+
+void rtgui_region_span_begin(struct rtgui_region_span_iter *iter, rtgui_region_t *region,
+                             int y, int x1, int x2);
+rt_bool_t rtgui_region_span_next(struct rtgui_region_span_iter *iter, int *x1, int *x2);
+
+/* fill the gaps in the bands of region which are inside of fill and not more
+ * than waste pixels, return the rects merged */
+int rtgui_region_simplify(rtgui_region_t *region, rtgui_region_t *fill, int waste);
+
 int rtgui_region_not_empty(rtgui_region_t *region);
 rtgui_rect_t *rtgui_region_extents(rtgui_region_t *region);
 
@@ -95,6 +128,40 @@ void rtgui_region_empty(rtgui_region_t *region);
 void rtgui_region_dump(rtgui_region_t *region);
 void rtgui_region_draw_clip(rtgui_region_t *region, struct rtgui_dc *dc);
 int rtgui_region_is_flat(rtgui_region_t *region);
+int rtgui_region_is_equal(rtgui_region_t *reg1, rtgui_region_t *reg2);
+void rtgui_region_pool_dump(void);
+
+#ifdef GUIENGINE_USING_REGION_STAT
+enum rtgui_region_op
+{
+    RTGUI_REGION_OP_INTERSECT,
+    RTGUI_REGION_OP_UNION,
+    RTGUI_REGION_OP_SUBTRACT,
+    RTGUI_REGION_OP_INVERSE,
+    RTGUI_REGION_OP_NUM
+};
+
+/*
+ * The statistics of an operation. The calls include the trivial ones, and the
+ * merges are the ones through the bands of rects, which cost by the rects in.
+ */
+struct rtgui_region_stat
+{
+    rt_uint32_t calls;
+    rt_uint32_t merges;
+    rt_uint32_t rects_in;
+    rt_uint32_t rects_out;
+    rt_uint32_t reallocs;
+    rt_uint32_t max_rects;
+    rt_uint32_t warns;
+};
+
+typedef void (*rtgui_region_warn_hook_t)(rtgui_region_t *region, enum rtgui_region_op op);
+
+const struct rtgui_region_stat *rtgui_region_stat_get(enum rtgui_region_op op);
+void rtgui_region_stat_reset(void);
+void rtgui_region_stat_set_hook(int rects, rtgui_region_warn_hook_t hook);
+#endif
 
 /* rect functions */
 extern rtgui_rect_t rtgui_empty_rect;
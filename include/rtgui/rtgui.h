@@ -104,9 +104,19 @@ struct rtgui_gc
 
     /* font */
     struct rtgui_font *font;
+
+    /* the native pixels of the colors in pixel_format, converted again when
+     * the colors or the format are changed, see rtgui_gc_fore_pixel */
+    rtgui_color_t pixel_foreground, pixel_background;
+    rt_uint32_t fore_pixel, back_pixel;
+    rt_uint8_t pixel_format;
+    rt_uint8_t pixel_valid;
 };
 typedef struct rtgui_gc rtgui_gc_t;
 
+/* the pixel_format of gc without the pixels converted */
+#define RTGUI_GC_PIXEL_NONE     0xff
+
 enum RTGUI_MARGIN_STYLE
 {
     RTGUI_MARGIN_LEFT   = 0x01,
@@ -176,6 +186,12 @@ enum RTGUI_TEXTSTYLE
     RTGUI_TEXTSTYLE_DRAW_BACKGROUND = 0x01,
     RTGUI_TEXTSTYLE_SHADOW          = 0x02,
     RTGUI_TEXTSTYLE_OUTLINE         = 0x04,
+    /* the glyphs rotated counterclockwise, the text is laid out in the
+     * direction of rotation, see rtgui_dc_draw_text_rotated */
+    RTGUI_TEXTSTYLE_ROTATE_90       = 0x10,
+    RTGUI_TEXTSTYLE_ROTATE_180      = 0x20,
+    RTGUI_TEXTSTYLE_ROTATE_270      = 0x30,
+    RTGUI_TEXTSTYLE_ROTATE_MASK     = 0x30,
 };
 
 enum RTGUI_MODAL_CODE
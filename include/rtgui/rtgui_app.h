@@ -47,6 +47,8 @@ enum rtgui_app_flag
 {
     RTGUI_APP_FLAG_EXITED  = 0x04,
     RTGUI_APP_FLAG_SHOWN   = 0x08,
+    /* the idle handler has no more work until the next event */
+    RTGUI_APP_FLAG_IDLE_DONE = 0x10,
     RTGUI_APP_FLAG_KEEP    = 0x80,
 };
 
@@ -69,8 +71,54 @@ struct rtgui_app
     rt_thread_t tid;
     /* the message queue of thread */
     rt_mq_t mq;
-    /* event buffer */
-    rt_uint8_t event_buffer[sizeof(union rtgui_event_generic)];
+    /* the depth of mq, the most events once in it and the events dropped */
+    rt_uint16_t mq_depth;
+    rt_uint16_t mq_peak;
+    rt_uint32_t mq_drops;
+    /* event buffer of the largest event to the app */
+    rt_uint16_t event_size;
+    rt_uint8_t *event_buffer;
+    /* the lanes of events deferred by rtgui_recv, handled after the mq is
+     * empty: the paints first and then the timers */
+    struct rtgui_event_paint paint_lane[GUIENGINE_EVENT_PAINT_LANE];
+    rt_uint16_t paint_cnt;
+    rt_uint16_t timer_cnt;
+    rt_uint16_t timer_first;
+    struct rtgui_event_timer timer_lane[GUIENGINE_EVENT_TIMER_LANE];
+
+    /* the running rtgui timers of app share one rt-thread timer, which is
+     * set to the earliest deadline and stopped if there is no timer. While
+     * the timer event is pending, it's re-armed in the watchdog ticks */
+    rt_list_t timer_list;
+    struct rt_timer timer;
+    volatile rt_uint8_t timer_pending;
+    rt_tick_t timer_watchdog;
+
+    /* the running frame callbacks (struct rtgui_frame) and the tick of last
+     * frame */
+    rt_list_t frame_list;
+    rt_tick_t frame_tick;
+    rt_uint16_t frame_serial;
+    rt_uint8_t frame_requested;
+
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    /* the cached widgets of app, the least recently painted one is at tail */
+    rt_list_t cache_list;
+#endif
+
+    /* the mailbox waiting the ack of rtgui_send_sync from this app */
+    struct rt_mailbox ack_mb;
+    rt_uint32_t ack_buffer;
+
+#ifdef GUIENGINE_USING_EVENT_RING
+    /* the ring of events from server thread, the head is written by server
+     * only and the tail by app only. The semaphore is released once for each
+     * event in mq and when the ring turns to non-empty. */
+    rt_uint8_t *ring;
+    volatile rt_uint32_t ring_head;
+    volatile rt_uint32_t ring_tail;
+    struct rt_semaphore ring_sem;
+#endif
 
     /* if not RT_NULL, the main_object is the one will be activated when the
      * app recieves activate event. By default, it is the first window shown in
@@ -79,11 +127,34 @@ struct rtgui_app
 
     /* on idle event handler */
     rtgui_idle_func_t on_idle;
+    /* the idle handler is run once in each period (in ticks) while the mq is
+     * empty, and the app is blocked between them. 0 to run it whenever the
+     * mq is empty */
+    rt_tick_t idle_period;
+    rt_tick_t idle_tick;
+
+#ifdef GUIENGINE_USING_LATENCY
+    /* the stamp of input being handled, taken by the first screen update */
+    rt_uint32_t input_stamp;
+#endif
 
     unsigned int window_cnt;
     /* window activate count */
     unsigned int win_acti_cnt;
 
+    /* the latest mouse motion coalesced into the one at the tail of mq, which
+     * is stamped with motion_seq in parent.user. 0 if there is none. */
+    struct rtgui_event_mouse motion;
+    rt_uint16_t motion_seq;
+
+#ifdef GUIENGINE_USING_ID_HASH
+    /* the objects of app by the id set */
+    struct rtgui_object *id_hash[GUIENGINE_ID_HASH_SIZE];
+#endif
+
+    /* the node in the list of apps */
+    rt_list_t app_node;
+
     void *user_data;
 };
 
@@ -95,7 +166,28 @@ struct rtgui_app
  * @return a pointer to struct rtgui_app on success. RT_NULL on failure.
  */
 struct rtgui_app *rtgui_app_create(const char *name);
+/**
+ * create an application with @mq_depth events in the message queue, and the
+ * events to it are @event_size bytes at most (0 for the largest event of
+ * engine). The small app saves the memory of mq and event buffer.
+ */
+struct rtgui_app *rtgui_app_create_ex(const char *name, rt_uint16_t mq_depth, rt_uint16_t event_size);
 void rtgui_app_destroy(struct rtgui_app *app);
+
+/**
+ * run @entry of an app in a new thread, which creates, runs and destroys the
+ * app in it.
+ *
+ * With GUIENGINE_USING_APP_POOL, the entry runs in an idle thread of the pool
+ * and the thread is back to the pool when the entry returns, the app must be
+ * destroyed before it. A thread named @name is created if all of them are
+ * running.
+ */
+rt_err_t rtgui_app_launch(const char *name, void (*entry)(void *parameter), void *parameter);
+#ifdef GUIENGINE_USING_APP_POOL
+/* create the threads and app runtimes of the pool, in rtgui_system_server_init */
+void rtgui_app_pool_init(void);
+#endif
 rt_bool_t rtgui_app_event_handler(struct rtgui_object *obj, rtgui_event_t *event);
 
 rt_base_t rtgui_app_run(struct rtgui_app *app);
@@ -107,6 +199,20 @@ void rtgui_app_sleep(struct rtgui_app *app, int millisecond);
 void rtgui_app_set_onidle(struct rtgui_app *app, rtgui_idle_func_t onidle);
 rtgui_idle_func_t rtgui_app_get_onidle(struct rtgui_app *app);
 
+/**
+ * run the idle handler in slices of @millisecond
+ *
+ * The idle handler is invoked at most once in each period while there is no
+ * event, and the app thread is blocked until the next event or slice in
+ * between, so the idle thread of system (and the tickless idle of PM) gets the
+ * time. The idle handler calls rtgui_app_idle_done when it has no more work,
+ * then the app is blocked until the next event and the slices are resumed
+ * after it. 0 (the default) to run the idle handler whenever there is no
+ * event.
+ */
+void rtgui_app_set_idle_period(struct rtgui_app *app, int millisecond);
+void rtgui_app_idle_done(struct rtgui_app *app);
+
 /**
  * return the rtgui_app struct on current thread
  */
@@ -120,6 +226,26 @@ struct rtgui_win* rtgui_app_get_main_win(struct rtgui_app *app);
 /* get the topwin belong app window activate count */
 unsigned int rtgui_app_get_win_acti_cnt(void);
 
+/* the cap of frame rate of the governor, GUIENGINE_USING_FRAME_GOVERNOR */
+enum rtgui_frame_policy
+{
+    /* GUIENGINE_FRAME_MS */
+    RTGUI_FRAME_POLICY_NORMAL,
+    /* GUIENGINE_GOVERNOR_BATTERY_MS */
+    RTGUI_FRAME_POLICY_BATTERY,
+    /* GUIENGINE_GOVERNOR_IDLE_MS, as if there is no input */
+    RTGUI_FRAME_POLICY_IDLE,
+};
+
+/**
+ * set the policy of frames, it's called by the power manager in any thread
+ *
+ * The frames of server and the animations on them are capped to the interval
+ * of policy from the next frame.
+ */
+void rtgui_app_set_frame_policy(enum rtgui_frame_policy policy);
+enum rtgui_frame_policy rtgui_app_get_frame_policy(void);
+
 #ifdef __cplusplus
 }
 #endif
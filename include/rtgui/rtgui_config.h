@@ -40,6 +40,11 @@
 #endif
 #endif
 
+/* the block of buffered file read, in the sectors of the storage */
+#ifndef GUIENGINE_FILERW_BLOCK_SIZE
+#define GUIENGINE_FILERW_BLOCK_SIZE     512
+#endif
+
 #if GUIENGINE_DEFAULT_FONT_SIZE == 0
 #define GUIENGINE_DEFAULT_FONT_SIZE 12
 #endif
@@ -54,6 +59,187 @@
 #endif
 #endif
 
+/* the period (in ms) the server coalesces the update rects before flushing
+ * them to the panel, 0 to flush each update immediately */
+#ifndef GUIENGINE_DAMAGE_FLUSH_MS
+#define GUIENGINE_DAMAGE_FLUSH_MS          16
+#endif
+/* the max rects flushed in one frame, the bounding box is used if exceeded */
+#ifndef GUIENGINE_DAMAGE_RECT_MAX
+#define GUIENGINE_DAMAGE_RECT_MAX          8
+#endif
+
+/* the events in the message queue of an app created by rtgui_app_create, see
+ * rtgui_app_create_ex for the depth and event size of each app */
+#ifndef GUIENGINE_APP_MQ_DEPTH
+#define GUIENGINE_APP_MQ_DEPTH             256
+#endif
+
+/* the events sent by server to an app are passed in a single producer and
+ * single consumer ring instead of the message queue, the size is in bytes */
+// #define GUIENGINE_USING_EVENT_RING
+#ifndef GUIENGINE_EVENT_RING_SIZE
+#define GUIENGINE_EVENT_RING_SIZE          2048
+#endif
+
+/* the paint and timer events deferred by an app until the input and window
+ * events queued are handled, the paints of same window are merged */
+#ifndef GUIENGINE_EVENT_PAINT_LANE
+#define GUIENGINE_EVENT_PAINT_LANE         8
+#endif
+#ifndef GUIENGINE_EVENT_TIMER_LANE
+#define GUIENGINE_EVENT_TIMER_LANE         8
+#endif
+
+/* the period (in ms) of frame clock if the panel does not report vsync, and
+ * the max apps waiting a frame */
+#ifndef GUIENGINE_FRAME_MS
+#define GUIENGINE_FRAME_MS                 16
+#endif
+#ifndef GUIENGINE_FRAME_APP_MAX
+#define GUIENGINE_FRAME_APP_MAX            8
+#endif
+
+/* the frame governor of server: the frames are not presented faster than an
+ * interval, which is doubled (GUIENGINE_GOVERNOR_SHIFT_MAX times at most) if
+ * the flushes keep over the budget. The interval is capped by the policy of
+ * rtgui_app_set_frame_policy, and by the idle one if there is no input in
+ * GUIENGINE_GOVERNOR_IDLE_AFTER_MS (0 is never idle) */
+// #define GUIENGINE_USING_FRAME_GOVERNOR
+#ifndef GUIENGINE_GOVERNOR_BATTERY_MS
+#define GUIENGINE_GOVERNOR_BATTERY_MS      33
+#endif
+#ifndef GUIENGINE_GOVERNOR_IDLE_MS
+#define GUIENGINE_GOVERNOR_IDLE_MS         100
+#endif
+#ifndef GUIENGINE_GOVERNOR_IDLE_AFTER_MS
+#define GUIENGINE_GOVERNOR_IDLE_AFTER_MS   5000
+#endif
+#ifndef GUIENGINE_GOVERNOR_SHIFT_MAX
+#define GUIENGINE_GOVERNOR_SHIFT_MAX       2
+#endif
+
+/* the server recognizes the tap, long press, drag, fling and pinch in the
+ * touch events, and sends the gestures to the window under the touch. The
+ * drag and pinch are sent once a frame. The slop is the motion in pixels not
+ * taken as a drag, and the fling is faster than the speed in pixels/s */
+// #define GUIENGINE_USING_GESTURE
+#ifndef GUIENGINE_GESTURE_SLOP
+#define GUIENGINE_GESTURE_SLOP             8
+#endif
+#ifndef GUIENGINE_GESTURE_LONGPRESS_MS
+#define GUIENGINE_GESTURE_LONGPRESS_MS     500
+#endif
+#ifndef GUIENGINE_GESTURE_FLING_SPEED
+#define GUIENGINE_GESTURE_FLING_SPEED      300
+#endif
+
+/* the drawings lock the rect of window instead of the whole screen, so the
+ * windows not overlapped are drawn by the apps at the same time. It needs a
+ * framebuffer, and the max threads drawing at the same time */
+// #define GUIENGINE_USING_RECT_LOCK
+#ifndef GUIENGINE_SCREEN_LOCKERS
+#define GUIENGINE_SCREEN_LOCKERS           8
+#endif
+
+/* the large payloads of events (the string of command) are passed by handle,
+ * the payloads not larger than the block are allocated in a pool */
+#ifndef GUIENGINE_EVENT_PAYLOAD_BLOCK
+#define GUIENGINE_EVENT_PAYLOAD_BLOCK      64
+#endif
+#ifndef GUIENGINE_EVENT_PAYLOAD_NUM
+#define GUIENGINE_EVENT_PAYLOAD_NUM        8
+#endif
+
+/* the objects are found by the id set by rtgui_object_set_id in a hash of the
+ * app, instead of searching the windows. The buckets should be a power of 2 */
+// #define GUIENGINE_USING_ID_HASH
+#ifndef GUIENGINE_ID_HASH_SIZE
+#define GUIENGINE_ID_HASH_SIZE             32
+#endif
+
+/* the title bar of window is drawn in a buffer once, and copied to the window
+ * if the width, title and state of it are not changed */
+// #define GUIENGINE_USING_TITLE_CACHE
+
+/* count the calls and time of drawings for each window, see list_guiprof.
+ * The clock is in microsecond, a cycle counter of cpu is better than tick */
+// #define GUIENGINE_USING_PROFILE
+#ifndef GUIENGINE_PROFILE_WINS
+#define GUIENGINE_PROFILE_WINS             8
+#endif
+#ifndef GUIENGINE_PROFILE_BLITS
+#define GUIENGINE_PROFILE_BLITS            8
+#endif
+#ifndef GUIENGINE_PROFILE_CLOCK
+#define GUIENGINE_PROFILE_CLOCK()          ((rt_uint32_t)rt_tick_get() * (1000000 / RT_TICK_PER_SECOND))
+#endif
+
+/* the cumulative time, count and area of paint for each widget, printed by
+ * rtgui_widget_dump. The time of container includes the one of children */
+// #define GUIENGINE_USING_WIDGET_PROFILE
+
+/* the time of each phase from the init of engine to the first screen update,
+ * reported at the first screen update and by list_guiboot */
+// #define GUIENGINE_USING_BOOT_PROFILE
+
+/* the image system and the fonts are initialized at their first use instead
+ * of the init of engine, the fonts not used by the first screen update are
+ * loaded after it by the thread of prewarm */
+// #define GUIENGINE_USING_LAZY_INIT
+
+/* the histogram of latency from the input acquired to the screen updated for
+ * it, in the clock of profile, see list_guilat */
+// #define GUIENGINE_USING_LATENCY
+#ifndef GUIENGINE_LATENCY_BUCKET_US
+#define GUIENGINE_LATENCY_BUCKET_US        1000
+#endif
+#ifndef GUIENGINE_LATENCY_BUCKETS
+#define GUIENGINE_LATENCY_BUCKETS          100
+#endif
+
+/* trace the memory of rtgui_malloc by the caller, app and subsystem (see
+ * RTGUI_MEM_TAG), see list_guimem. It's always used on Win32 simulator */
+// #define RTGUI_MEM_TRACE
+#if defined(_WIN32_NATIVE) && !defined(RTGUI_MEM_TRACE)
+#define RTGUI_MEM_TRACE
+#endif
+#ifndef GUIENGINE_MEMTRACE_MAX
+#define GUIENGINE_MEMTRACE_MAX             4096
+#endif
+#ifndef GUIENGINE_MEMTRACE_HASH_BITS
+#define GUIENGINE_MEMTRACE_HASH_BITS       8
+#endif
+#ifndef GUIENGINE_MEMTRACE_SITES
+#define GUIENGINE_MEMTRACE_SITES           128
+#endif
+#ifndef GUIENGINE_MEMTRACE_APPS
+#define GUIENGINE_MEMTRACE_APPS            8
+#endif
+
+/* the debug of overdraw: tint the pixels by the writes since the last update
+ * of them, or flash the rects of update. It's set by gui_overdraw in runtime,
+ * and the counting takes a byte of memory for each pixel */
+// #define GUIENGINE_USING_OVERDRAW
+#ifndef GUIENGINE_OVERDRAW_FLASH_MS
+#define GUIENGINE_OVERDRAW_FLASH_MS        100
+#endif
+
+/* the tracepoints recorded in a ring of records (a power of 2), exported as
+ * the JSON of Chrome trace by gui_trace */
+// #define GUIENGINE_USING_TRACE
+#ifndef GUIENGINE_TRACE_SIZE
+#define GUIENGINE_TRACE_SIZE               1024
+#endif
+#ifndef GUIENGINE_TRACE_THREADS
+#define GUIENGINE_TRACE_THREADS            16
+#endif
+
+/* the thread waiting the panel vsync for server */
+#ifndef GUIENGINE_VSYNC_THREAD_STACK_SIZE
+#define GUIENGINE_VSYNC_THREAD_STACK_SIZE  512
+#endif
+
 #define GUIENGIN_APP_THREAD_PRIORITY       25
 #define GUIENGIN_APP_THREAD_TIMESLICE      5
 #ifdef GUIENGIN_USING_SMALL_SIZE
@@ -62,8 +248,26 @@
 #define GUIENGIN_APP_THREAD_STACK_SIZE     2048
 #endif
 
+/* GUIENGINE_APP_POOL_SIZE threads of GUIENGIN_APP_THREAD_STACK_SIZE are created
+ * at init for rtgui_app_launch, and the message queues and event buffers of
+ * the apps in default size are kept for the next app when they're destroyed */
+// #define GUIENGINE_USING_APP_POOL
+#ifndef GUIENGINE_APP_POOL_SIZE
+#define GUIENGINE_APP_POOL_SIZE            2
+#endif
+/* the window is created in server without waiting the ack, the show of it
+ * waits the server in order */
+// #define GUIENGINE_USING_ASYNC_WIN_CREATE
+
 // #define GUIENGIN_USING_CAST_CHECK
 
+/* the widgets, containers and boxes destroyed are kept in the pools of their
+ * types, GUIENGINE_OBJECT_POOL_SIZE each at most, to be created again */
+// #define GUIENGINE_USING_OBJECT_POOL
+#ifndef GUIENGINE_OBJECT_POOL_SIZE
+#define GUIENGINE_OBJECT_POOL_SIZE         16
+#endif
+
 // #define GUIENGIN_USING_DESKTOP_WINDOW
 // #undef GUIENGIN_USING_SMALL_SIZE
 
@@ -71,6 +275,382 @@
 
 #define GUIENGIN_USING_VFRAMEBUFFER
 
+/* the windows are painted in the bands of screen width, and the lines of band
+ * are written to the device without framebuffer. The band is in the size of
+ * GUIENGINE_BAND_SIZE bytes, it needs GUIENGIN_USING_VFRAMEBUFFER */
+// #define GUIENGINE_USING_BAND
+#ifndef GUIENGINE_BAND_SIZE
+#define GUIENGINE_BAND_SIZE                (16 * 1024)
+#endif
+
+/* the screen update of device without framebuffer is the DMA of blit_rect_async
+ * in pixel ops, and the band is split in two halves: one is painted while the
+ * other is transferred */
+// #define GUIENGINE_USING_ASYNC_FLUSH
+
+/* the spans drawn to the device without framebuffer are combined to rects in a
+ * buffer of GUIENGINE_PIXEL_WC_SIZE bytes, and written by the blit_rect of
+ * device (RTGRAPHIC_CTRL_GET_PIXEL_OPS). Only the 16bit pixel is combined */
+// #define GUIENGINE_USING_PIXEL_WC
+#ifndef GUIENGINE_PIXEL_WC_SIZE
+#define GUIENGINE_PIXEL_WC_SIZE            (4 * 1024)
+#endif
+
+/* the color key of display controller, the pixel of GUI layer in it shows the
+ * overlay planes below on the framebuffer without alpha */
+#ifndef GUIENGINE_OVERLAY_COLORKEY
+#define GUIENGINE_OVERLAY_COLORKEY         RTGUI_RGB(0xff, 0x00, 0xff)
+#endif
+
+/* the framebuffer is write-back cacheable, and the D-cache of the rects is
+ * cleaned before they are read by the panel, DMA or 2D accelerator. The cache
+ * line is GUIENGINE_CACHE_LINE bytes */
+// #define GUIENGINE_USING_CACHE_CLEAN
+#ifndef GUIENGINE_CACHE_LINE
+#define GUIENGINE_CACHE_LINE               32
+#endif
+
+/* the pixels of buffer dc are allocated in the buckets of power of 2 bytes,
+ * and kept idle for reuse in GUIENGINE_DC_POOL_BUDGET bytes. The pixels less
+ * than GUIENGINE_DC_POOL_MIN bytes are not pooled */
+// #define GUIENGINE_USING_DC_POOL
+#ifndef GUIENGINE_DC_POOL_MIN
+#define GUIENGINE_DC_POOL_MIN              (4 * 1024)
+#endif
+#ifndef GUIENGINE_DC_POOL_BUDGET
+#define GUIENGINE_DC_POOL_BUDGET           (512 * 1024)
+#endif
+
+/* the memory of each tag (region, font, image, dc, dma...) is allocated in the
+ * region set by rtgui_mem_set_region, such as the fast SRAM or SDRAM */
+// #define GUIENGINE_USING_MEM_REGION
+
+/* decode the PNG image (lodepng) to the ARGB888 premultiplied by alpha */
+// #define GUIENGINE_IMAGE_PNG_PREMULTIPLIED
+/* keep the PNG image with alpha in ARGB4444, half the memory of ARGB888 */
+// #define GUIENGINE_IMAGE_PNG_ARGB4444
+
+/* the default profile of libjpeg decoding, rtgui_jpeg_profile:
+ * 0 - fast, 1 - balanced, 2 - quality */
+#ifndef GUIENGINE_IMAGE_JPEG_PROFILE
+#define GUIENGINE_IMAGE_JPEG_PROFILE       0
+#endif
+/* the libjpeg-turbo (1.4 or later) decodes to RGB565 for the RGB565 panel */
+// #define GUIENGINE_IMAGE_JPEG_RGB565
+
+/* the GIF engine, the animated GIF is played by rtgui_image_anim */
+// #define GUIENGINE_IMAGE_GIF
+
+/* the XPM is compiled to the indexes of colors once and shared by the next
+ * loads of the same data, which should be constant such as in firmware */
+// #define GUIENGINE_USING_XPM_CACHE
+
+/* the table of RGB565 to ARGB8888 used by the blit and blend kernels:
+ * 0 - expanded by the shifts
+ * 1 - the table split by the bytes of pixel, 2KB for MCU
+ * 2 - the full table of all the pixels, 256KB for Cortex-A */
+#ifndef GUIENGINE_BLIT_565_LUT
+#define GUIENGINE_BLIT_565_LUT             0
+#endif
+
+/* the 4x4 ordered dither of the 24/32bit colors converted to RGB565, in the
+ * blit and the gradient fill, against the banding on the 565 panel */
+// #define GUIENGINE_USING_DITHER
+
+/* correct the A8 coverage of the AA text, masks and shapes by a gamma (in
+ * 1/10) before blending, the thin AA text is not too light in sRGB then */
+// #define GUIENGINE_USING_COVERAGE_GAMMA
+#ifndef GUIENGINE_COVERAGE_GAMMA
+#define GUIENGINE_COVERAGE_GAMMA    14
+#endif
+
+/* keep the A8 masks of the AA shapes (round rects, circles and rings) in
+ * GUIENGINE_SHAPE_CACHE_BUDGET bytes, the paint of a cached shape is one blit
+ * of its mask, see rtgui_dc_fill_shape */
+// #define GUIENGINE_USING_SHAPE_CACHE
+#ifndef GUIENGINE_SHAPE_CACHE_BUDGET
+#define GUIENGINE_SHAPE_CACHE_BUDGET       (64 * 1024)
+#endif
+/* keep the static texts drawn by rtgui_dc_draw_text_cached as A8 masks in the
+ * budget of shape cache, the texts longer than GUIENGINE_TEXT_CACHE_MAX bytes
+ * are drawn directly */
+// #define GUIENGINE_USING_TEXT_CACHE
+#ifndef GUIENGINE_TEXT_CACHE_MAX
+#define GUIENGINE_TEXT_CACHE_MAX           64
+#endif
+#if defined(GUIENGINE_USING_TEXT_CACHE) && !defined(GUIENGINE_USING_SHAPE_CACHE)
+#define GUIENGINE_USING_SHAPE_CACHE
+#endif
+
+/* the widgets of RTGUI_WIDGET_FLAG_CACHED are rendered with their children in
+ * a buffer once, and painted by the blit of it until they are updated. The
+ * buffers of all apps are in GUIENGINE_WIDGET_CACHE_BUDGET bytes, it needs
+ * GUIENGIN_USING_VFRAMEBUFFER */
+// #define GUIENGINE_USING_WIDGET_CACHE
+#ifndef GUIENGINE_WIDGET_CACHE_BUDGET
+#define GUIENGINE_WIDGET_CACHE_BUDGET      (128 * 1024)
+#endif
+
+/* the SIMD kernels of blit are selected by the target of compiler */
+// #define GUIENGINE_BLIT_NO_SIMD
+#ifndef GUIENGINE_BLIT_NO_SIMD
+#if defined(__ARM_NEON)
+#define GUIENGINE_USING_BLIT_NEON
+#elif defined(__ARM_FEATURE_MVE)
+#define GUIENGINE_USING_BLIT_MVE
+#endif
+#endif
+
+/* render the bands of a rect in the worker threads, see
+ * rtgui_dc_render_parallel. The workers are bound to the other cores on SMP */
+// #define GUIENGINE_USING_PARALLEL_RENDER
+#ifndef GUIENGINE_RENDER_WORKERS
+#if defined(RT_USING_SMP) && defined(RT_CPUS_NR) && RT_CPUS_NR > 1
+#define GUIENGINE_RENDER_WORKERS           (RT_CPUS_NR - 1)
+#else
+#define GUIENGINE_RENDER_WORKERS           1
+#endif
+#endif
+#ifndef GUIENGINE_RENDER_WORKER_STACK_SIZE
+#define GUIENGINE_RENDER_WORKER_STACK_SIZE 2048
+#endif
+/* the min lines of a band */
+#ifndef GUIENGINE_RENDER_BAND_MIN
+#define GUIENGINE_RENDER_BAND_MIN          16
+#endif
+
+/* the thread decoding the images of rtgui_image_load_async */
+#ifndef GUIENGINE_IMAGE_LOADER_PRIORITY
+#define GUIENGINE_IMAGE_LOADER_PRIORITY    (GUIENGIN_APP_THREAD_PRIORITY + 1)
+#endif
+#ifndef GUIENGINE_IMAGE_LOADER_STACK_SIZE
+#define GUIENGINE_IMAGE_LOADER_STACK_SIZE  4096
+#endif
+/* the loader runs the background requests, such as the prefetch, in it */
+#ifndef GUIENGINE_IMAGE_PREFETCH_PRIORITY
+#define GUIENGINE_IMAGE_PREFETCH_PRIORITY  (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+/* the bytes of rows read at once by the BMP decoder */
+#ifndef GUIENGINE_BMP_BAND_SIZE
+#define GUIENGINE_BMP_BAND_SIZE            4096
+#endif
+
+/* the PNG and JPEG decoded are kept in the HDC files of native pixels */
+// #define GUIENGINE_USING_IMAGE_DISK_CACHE
+#ifndef GUIENGINE_IMAGE_DISK_CACHE_DIR
+#define GUIENGINE_IMAGE_DISK_CACHE_DIR     "/cache"
+#endif
+
+/* the images created from file are looked up in the mounted resource packs */
+// #define GUIENGINE_USING_PACK
+
+/* the mipmap chain of images for the scaled blits, see rtgui_image_mipmap_create.
+ * The smooth scaled variants of image container are filtered from the mipmap */
+// #define GUIENGINE_USING_IMAGE_MIPMAP
+
+/* the tiles kept decoded by a tileview at least, it keeps the tiles to cover
+ * its view if they are more */
+#ifndef GUIENGINE_TILEVIEW_TILES
+#define GUIENGINE_TILEVIEW_TILES           16
+#endif
+
+/* the bytes of decoded images kept in image container */
+#ifndef GUIENGINE_IMAGE_CONTAINER_BUDGET
+#define GUIENGINE_IMAGE_CONTAINER_BUDGET   (256 * 1024)
+#endif
+
+/* the rects stored inside of region before using the heap */
+#ifndef GUIENGINE_REGION_INLINE_RECTS
+#define GUIENGINE_REGION_INLINE_RECTS      4
+#endif
+
+/* the freed region data blocks cached in each size class */
+#ifndef GUIENGINE_REGION_POOL_CACHE
+#define GUIENGINE_REGION_POOL_CACHE        8
+#endif
+
+/* count the operations of region, and the rects in and out of them. The hook
+ * of region statistics is invoked when a result has more rects than this */
+// #define GUIENGINE_USING_REGION_STAT
+#ifndef GUIENGINE_REGION_WARN_RECTS
+#define GUIENGINE_REGION_WARN_RECTS        64
+#endif
+
+/* the gaps between the clip rects of a container made by its children, which
+ * are not more than GUIENGINE_CLIP_SIMPLIFY_WASTE pixels, are filled in the
+ * clip of container. The children paint over them after the container, so
+ * the drawing of container out of paint may overwrite the children. The
+ * areas covered by the other windows are never filled. */
+// #define GUIENGINE_USING_CLIP_SIMPLIFY
+#ifndef GUIENGINE_CLIP_SIMPLIFY_WASTE
+#define GUIENGINE_CLIP_SIMPLIFY_WASTE      4096
+#endif
+
+/* the server saves the screen under the windows of RTGUI_WIN_STYLE_BACKING_STORE
+ * when they are shown, and restores it when they are hidden or moved */
+// #define GUIENGINE_USING_BACKING_STORE
+
+/* the backing stores of the inactive windows are compressed by fastlz once the
+ * uncompressed ones are over GUIENGINE_BACKING_ZIP_BUDGET bytes, and they are
+ * decompressed when the windows are hidden or moved (PKG_USING_FASTLZ) */
+// #define GUIENGINE_USING_BACKING_ZIP
+#ifndef GUIENGINE_BACKING_ZIP_BUDGET
+#define GUIENGINE_BACKING_ZIP_BUDGET       (128 * 1024)
+#endif
+
+/* the snapshot saved by rtgui_snapshot_save(GUIENGINE_BOOT_SNAPSHOT_FILE) is
+ * shown on the panel at the beginning of rtgui_system_server_init, until the
+ * first window is shown. It's compressed in the blocks of rows about
+ * GUIENGINE_BOOT_SNAPSHOT_BLOCK bytes (PKG_USING_FASTLZ) */
+// #define GUIENGINE_USING_BOOT_SNAPSHOT
+#ifndef GUIENGINE_BOOT_SNAPSHOT_FILE
+#define GUIENGINE_BOOT_SNAPSHOT_FILE       "/ui_snapshot.bin"
+#endif
+#ifndef GUIENGINE_BOOT_SNAPSHOT_BLOCK
+#define GUIENGINE_BOOT_SNAPSHOT_BLOCK      8192
+#endif
+
+/* each window is drawn to a layer of its own, and the server composites the
+ * layers on the damage with the opacity of window. The background is shown
+ * where no window is, and at most GUIENGINE_COMPOSITOR_LAYERS layers are
+ * composited on a damage rect. It takes the place of backing store */
+// #define GUIENGINE_USING_COMPOSITOR
+#ifndef GUIENGINE_COMPOSITOR_LAYERS
+#define GUIENGINE_COMPOSITOR_LAYERS        8
+#endif
+#ifndef GUIENGINE_COMPOSITOR_BACKGROUND
+#define GUIENGINE_COMPOSITOR_BACKGROUND    RTGUI_RGB(0x00, 0x00, 0x00)
+#endif
+
+/* the windows are bound to one of GUIENGINE_DISPLAY_MAX displays, and the ones
+ * on a display are clipped and updated on it only. The display 0 is the device
+ * of rtgui_graphic_set_device and it has the pointer. It's not with the
+ * compositor */
+// #define GUIENGINE_USING_MULTI_DISPLAY
+#ifndef GUIENGINE_DISPLAY_MAX
+#define GUIENGINE_DISPLAY_MAX              2
+#endif
+
+/* the server moves a window by copying its pixels in the framebuffer, and only
+ * the window with newly exposed area is painted again. It's not used in the
+ * compositor, the backing store or the page flipping */
+// #define GUIENGINE_USING_MOVE_COPY
+
+/* the panel in a rotation of 90/180/270 is drawn through a shadow framebuffer
+ * in the orientation of GUI, the damaged rects are rotated to the panel on the
+ * screen update in the tiles of GUIENGINE_ROTATION_TILE pixels */
+// #define GUIENGINE_USING_ROTATION
+#ifndef GUIENGINE_ROTATION_TILE
+#define GUIENGINE_ROTATION_TILE            16
+#endif
+
+/* the mono framebuffer is packed in lines, 8 pixels a byte and the MSB is the
+ * left, as the e-paper and memory LCD. It's in pages of 8 lines without it */
+// #define GUIENGINE_USING_MONO_PACKED
+
+/* the only pixel format of the screen in the product. The engine is built for
+ * it: the drivers in the other formats are not set, and the kernels of blit,
+ * blend and framebuffer are kept only for it and ARGB888 (and ALPHA for the
+ * masks), the others are dropped. The other formats are still the sources of blit */
+// #define GUIENGINE_FIXED_PIXEL_FORMAT       RTGRAPHIC_PIXEL_FORMAT_RGB565
+
+/* the screen updates of e-paper (rtgui_epaper_init) are merged in the partial
+ * windows aligned for the controller, and refreshed by a thread in the delay
+ * after the first update. A full refresh is done each GUIENGINE_EPAPER_FULL_EVERY
+ * refreshes against the ghosting, 0 is never */
+// #define GUIENGINE_USING_EPAPER
+#ifndef GUIENGINE_EPAPER_ALIGN_X
+#define GUIENGINE_EPAPER_ALIGN_X           8
+#endif
+#ifndef GUIENGINE_EPAPER_ALIGN_Y
+#define GUIENGINE_EPAPER_ALIGN_Y           1
+#endif
+#ifndef GUIENGINE_EPAPER_WINDOWS
+#define GUIENGINE_EPAPER_WINDOWS           4
+#endif
+#ifndef GUIENGINE_EPAPER_DELAY_MS
+#define GUIENGINE_EPAPER_DELAY_MS          50
+#endif
+#ifndef GUIENGINE_EPAPER_FULL_EVERY
+#define GUIENGINE_EPAPER_FULL_EVERY        20
+#endif
+#ifndef GUIENGINE_EPAPER_THREAD_PRIORITY
+#define GUIENGINE_EPAPER_THREAD_PRIORITY   (GUIENGIN_APP_THREAD_PRIORITY + 1)
+#endif
+#ifndef GUIENGINE_EPAPER_THREAD_STACK_SIZE
+#define GUIENGINE_EPAPER_THREAD_STACK_SIZE 1024
+#endif
+
+/* the max framebuffer pages for page flipping */
+#ifndef GUIENGINE_FRAMEBUFFER_PAGE_MAX
+#define GUIENGINE_FRAMEBUFFER_PAGE_MAX     3
+#endif
+
+/* the size of glyph atlas shared by the font engines, and the max glyphs
+ * cached in it */
+#ifndef GUIENGINE_GLYPH_ATLAS_WIDTH
+#define GUIENGINE_GLYPH_ATLAS_WIDTH        256
+#endif
+#ifndef GUIENGINE_GLYPH_ATLAS_HEIGHT
+#define GUIENGINE_GLYPH_ATLAS_HEIGHT       64
+#endif
+#ifndef GUIENGINE_GLYPH_ATLAS_GLYPHS
+#define GUIENGINE_GLYPH_ATLAS_GLYPHS       128
+#endif
+
+/* the bytes of font data cached for each hz font file */
+#ifndef GUIENGINE_HZ_FILE_CACHE_SIZE
+#define GUIENGINE_HZ_FILE_CACHE_SIZE       8192
+#endif
+
+/* the texts which metrics are cached, 0 to measure the text each time */
+#ifndef GUIENGINE_FONT_METRICS_CACHE
+#define GUIENGINE_FONT_METRICS_CACHE       16
+#endif
+/* the fonts which advances of ascii are cached for the text positions */
+#ifndef GUIENGINE_FONT_ADVANCE_CACHE
+#define GUIENGINE_FONT_ADVANCE_CACHE       2
+#endif
+
+/* the limits of FreeType cache manager shared by all the ttf fonts */
+#ifndef GUIENGINE_TTF_MAX_FACES
+#define GUIENGINE_TTF_MAX_FACES            2
+#endif
+#ifndef GUIENGINE_TTF_MAX_SIZES
+#define GUIENGINE_TTF_MAX_SIZES            4
+#endif
+#ifndef GUIENGINE_TTF_MAX_BYTES
+#define GUIENGINE_TTF_MAX_BYTES            (200 * 1024)
+#endif
+/* the ttf fonts up to the size are loaded in GUIENGINE_TTF_SMALL_FLAGS of
+ * RTGUI_TTF_*, such as the strikes of CJK font, 0 for no hinting at all sizes */
+#ifndef GUIENGINE_TTF_SMALL_SIZE
+#define GUIENGINE_TTF_SMALL_SIZE           16
+#endif
+#ifndef GUIENGINE_TTF_SMALL_FLAGS
+#define GUIENGINE_TTF_SMALL_FLAGS          RTGUI_TTF_BITMAP
+#endif
+/* build the autofit module of FreeType for RTGUI_TTF_HINT_AUTO, it's read by
+ * the FreeType profile and should be defined in rtconfig.h */
+// #define GUIENGINE_TTF_USING_AUTOFIT
+
+/* the thread loading the glyphs by rtgui_font_prewarm */
+#ifndef GUIENGINE_FONT_PREWARM_PRIORITY
+#define GUIENGINE_FONT_PREWARM_PRIORITY    (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+#ifndef GUIENGINE_FONT_PREWARM_STACK_SIZE
+#define GUIENGINE_FONT_PREWARM_STACK_SIZE  2048
+#endif
+
+/* the address of hzk12.fnt/hzk16.fnt mapped in memory (XIP flash), the
+ * glyphs are used in place instead of reading the file */
+// #define GUIENGINE_HZ12_FONT_MAP            0x90000000
+// #define GUIENGINE_HZ16_FONT_MAP            0x90040000
+
+/* the text of hz bitmap font is in UTF-8 as the hz file font, not GB2312 */
+// #define GUIENGINE_HZ_BMP_UTF8
+
 #ifdef DEBUG_MEMLEAK
 #define rtgui_malloc     rt_malloc
 #define rtgui_realloc    rt_realloc
@@ -49,6 +49,16 @@ typedef struct rtgui_object rtgui_object_t;
 typedef void (*rtgui_constructor_t)(rtgui_object_t *object);
 typedef void (*rtgui_destructor_t)(rtgui_object_t *object);
 
+/* the objects of a type destroyed and kept to be created again */
+struct rtgui_object_pool
+{
+    /* the objects kept at most */
+    rt_uint16_t max;
+    rt_uint16_t count;
+    /* the list of objects in their first word */
+    void *idle;
+};
+
 /* rtgui type structure */
 struct rtgui_type
 {
@@ -64,6 +74,9 @@ struct rtgui_type
 
     /* size of type */
     int size;
+
+    /* the pool of objects, RT_NULL if they are allocated from heap */
+    struct rtgui_object_pool *pool;
 };
 typedef struct rtgui_type rtgui_type_t;
 #define RTGUI_TYPE(type)            (_rtgui_##type##_get_type())
@@ -79,15 +92,37 @@ typedef struct rtgui_type rtgui_type_t;
 	parent, \
 	RTGUI_CONSTRUCTOR(constructor), \
 	RTGUI_DESTRUCTOR(destructor), \
-	size }; \
+	size, \
+	RT_NULL }; \
+	const rtgui_type_t *_rtgui_##type##_get_type(void) { return &_rtgui_##type; } \
+	RTM_EXPORT(_rtgui_##type##_get_type)
+
+/* the type keeps at most count objects destroyed for the objects created
+ * later, the objects of the derived types are not pooled */
+#ifdef GUIENGINE_USING_OBJECT_POOL
+#define DEFINE_CLASS_TYPE_POOL(type, name, parent, constructor, destructor, size, count) \
+	static struct rtgui_object_pool _rtgui_##type##_pool = { count, 0, RT_NULL }; \
+	const struct rtgui_type _rtgui_##type = { \
+	name, \
+	parent, \
+	RTGUI_CONSTRUCTOR(constructor), \
+	RTGUI_DESTRUCTOR(destructor), \
+	size, \
+	&_rtgui_##type##_pool }; \
 	const rtgui_type_t *_rtgui_##type##_get_type(void) { return &_rtgui_##type; } \
 	RTM_EXPORT(_rtgui_##type##_get_type)
+#else
+#define DEFINE_CLASS_TYPE_POOL(type, name, parent, constructor, destructor, size, count) \
+	DEFINE_CLASS_TYPE(type, name, parent, constructor, destructor, size)
+#endif
 
 void          rtgui_type_object_construct(const rtgui_type_t *type, rtgui_object_t *object);
 void          rtgui_type_destructors_call(const rtgui_type_t *type, rtgui_object_t *object);
 rt_bool_t     rtgui_type_inherits_from(const rtgui_type_t *type, const rtgui_type_t *parent);
 const rtgui_type_t  *rtgui_type_parent_type_get(const rtgui_type_t *type);
 const char    *rtgui_type_name_get(const rtgui_type_t *type);
+/* free the objects kept in the pool of type */
+void          rtgui_type_pool_shrink(const rtgui_type_t *type);
 const rtgui_type_t *rtgui_object_object_type_get(rtgui_object_t *object);
 
 #ifdef GUIENGIN_USING_CAST_CHECK
@@ -128,8 +163,14 @@ struct rtgui_object
     rtgui_event_handler_ptr event_handler;
 
     enum rtgui_object_flag flag;
+    /* the events dispatched and broadcasted to the object, RTGUI_EVENT_BIT */
+    rt_uint64_t event_mask;
 
     rt_uint32_t id;
+#ifdef GUIENGINE_USING_ID_HASH
+    /* the chain in the id hash of app, RT_NULL pprev if it's not in */
+    struct rtgui_object *id_next, **id_pprev;
+#endif
 };
 
 rtgui_object_t *rtgui_object_create(const rtgui_type_t *object_type);
@@ -137,6 +178,24 @@ void rtgui_object_destroy(rtgui_object_t *object);
 
 /* set the event handler of object */
 void rtgui_object_set_event_handler(struct rtgui_object *object, rtgui_event_handler_ptr handler);
+
+/* the bit of event type in the mask, the user commands and above share the last bit */
+#define RTGUI_EVENT_BIT(type)       ((rt_uint64_t)1 << ((type) < 63 ? (type) : 63))
+#define RTGUI_EVENT_MASK_ALL        (~(rt_uint64_t)0)
+/* the events of the widget tree, a widget should keep them in its mask */
+#define RTGUI_EVENT_MASK_WIDGET     (RTGUI_EVENT_BIT(RTGUI_EVENT_SHOW) | RTGUI_EVENT_BIT(RTGUI_EVENT_HIDE) | \
+                                     RTGUI_EVENT_BIT(RTGUI_EVENT_PAINT) | RTGUI_EVENT_BIT(RTGUI_EVENT_RESIZE) | \
+                                     RTGUI_EVENT_BIT(RTGUI_EVENT_UPDATE_TOPLVL))
+/* the object wants the event in the dispatch of container */
+#define RTGUI_OBJECT_WANTS(object, type) \
+    ((object)->event_handler != RT_NULL && ((object)->event_mask & RTGUI_EVENT_BIT(type)))
+
+/*
+ * Set the events the object is interested in, all the events in default. The
+ * dispatch and broadcast of container skip the children without the bit of
+ * event, so the mask of a container should cover the ones of its children.
+ */
+void rtgui_object_set_event_mask(struct rtgui_object *object, rt_uint64_t mask);
 /* object default event handler */
 rt_bool_t rtgui_object_event_handler(struct rtgui_object *object, struct rtgui_event *event);
 /* helper micro. widget event handlers could use this. */
@@ -168,6 +227,10 @@ void rtgui_object_set_id(struct rtgui_object *obj, rt_uint32_t id);
 rt_uint32_t rtgui_object_get_id(struct rtgui_object *obj);
 struct rtgui_object* rtgui_get_object(struct rtgui_app *app, rt_uint32_t id);
 struct rtgui_object* rtgui_get_self_object(rt_uint32_t id);
+#ifdef GUIENGINE_USING_ID_HASH
+struct rtgui_object *rtgui_object_id_lookup(struct rtgui_app *app, rt_uint32_t id);
+void rtgui_object_id_hash_fini(struct rtgui_app *app);
+#endif
 
 #ifdef __cplusplus
 }
@@ -47,6 +47,8 @@ enum rtgui_topwin_flag
     WINTITLE_MODALING   = 0x100,
     WINTITLE_ONTOP      = 0x200,
     WINTITLE_ONBTM      = 0x400,
+    /* the screen under window is saved in the backing store */
+    WINTITLE_BACKING    = 0x800,
 };
 
 struct rtgui_topwin
@@ -76,6 +78,16 @@ struct rtgui_topwin
 
     /* the monitor rect list */
     rtgui_list_t monitor_list;
+
+#ifdef GUIENGINE_USING_BACKING_STORE
+    /* the screen under window, in the extent and the format of driver */
+    struct rtgui_dc *backing;
+    rt_bool_t backing_valid;
+#ifdef GUIENGINE_USING_BACKING_ZIP
+    /* the backing store compressed, the backing is RT_NULL then */
+    rt_uint8_t *backing_zip;
+#endif
+#endif
 };
 
 /* top win manager init */
@@ -49,10 +49,11 @@ struct rtgui_timer
 {
     /* the rtgui application it runs on */
     struct rtgui_app* app;
-    /* rt timer */
-    struct rt_timer timer;
-    /* How many events are pending on the queue. */
-    int pending_cnt;
+    /* the node in the timer list of app, sorted by the deadline */
+    rt_list_t list;
+    rt_tick_t deadline;
+    rt_int32_t period;
+    rt_uint8_t flag;
     enum rtgui_timer_state state;
 
     /* timeout function and user data */
@@ -67,6 +68,10 @@ void rtgui_timer_destory(rtgui_timer_t *timer);
 void rtgui_timer_set_timeout(rtgui_timer_t *timer, rt_int32_t time);
 void rtgui_timer_start(rtgui_timer_t *timer);
 void rtgui_timer_stop(rtgui_timer_t *timer);
+/* init the rt-thread timer of app, and run the expired timers of app on the
+ * RTGUI_EVENT_TIMER */
+void rtgui_timer_app_init(struct rtgui_app *app, const char *name);
+void rtgui_timer_expire(struct rtgui_app *app);
 
 /* rtgui system initialization function */
 int rtgui_system_server_init(void);
@@ -75,6 +80,66 @@ void *rtgui_malloc(rt_size_t size);
 void rtgui_free(void *ptr);
 void *rtgui_realloc(void *ptr, rt_size_t size);
 
+/* the subsystem of memory traced, a file defines RTGUI_MEM_TAG before the
+ * headers are included to tag the memory allocated in it */
+enum rtgui_mem_tag
+{
+    RTGUI_MEM_GENERIC,
+    RTGUI_MEM_REGION,
+    RTGUI_MEM_FONT,
+    RTGUI_MEM_IMAGE,
+    RTGUI_MEM_DC,
+    RTGUI_MEM_EVENT,
+    /* the buffers read by DMA, such as the band to panel */
+    RTGUI_MEM_DMA,
+
+    RTGUI_MEM_TAG_MAX,
+};
+
+void *rtgui_malloc_tag(rt_size_t size, int tag);
+void *rtgui_realloc_tag(void *ptr, rt_size_t size, int tag);
+#ifdef RTGUI_MEM_TRACE
+/* the bytes and blocks in use of the tag, RTGUI_MEM_TAG_MAX for all tags */
+void rtgui_mem_get_stat(int tag, rt_uint32_t *live, rt_uint32_t *blocks);
+#endif
+
+#ifdef GUIENGINE_USING_MEM_REGION
+/*
+ * A memory region, such as the fast SRAM, SDRAM or the memory of DMA. The
+ * memory of a tag is allocated in the region set to it, and in the system
+ * heap if the region is full. The block freed or reallocated is found in the
+ * region by its address, so it may be freed by the others.
+ */
+struct rtgui_mem_region
+{
+    const char *name;
+    void *start;
+    rt_size_t size;
+
+    void *(*malloc)(struct rtgui_mem_region *region, rt_size_t size);
+    void *(*realloc)(struct rtgui_mem_region *region, void *ptr, rt_size_t size);
+    void (*free)(struct rtgui_mem_region *region, void *ptr);
+    void *user_data;
+
+    struct rtgui_mem_region *next;
+};
+
+/* allocate the memory of tag in the region, RT_NULL for the system heap */
+void rtgui_mem_set_region(int tag, struct rtgui_mem_region *region);
+#ifdef RT_USING_MEMHEAP
+/* init the region as a memheap */
+void rtgui_mem_region_init_memheap(struct rtgui_mem_region *region, struct rt_memheap *heap);
+#endif
+#endif
+
+#if (defined(RTGUI_MEM_TRACE) || defined(GUIENGINE_USING_MEM_REGION)) && !defined(DEBUG_MEMLEAK)
+#ifndef RTGUI_MEM_TAG
+#define RTGUI_MEM_TAG               RTGUI_MEM_GENERIC
+#endif
+#define rtgui_malloc(size)          rtgui_malloc_tag((size), RTGUI_MEM_TAG)
+#define rtgui_realloc(ptr, size)    rtgui_realloc_tag((ptr), (size), RTGUI_MEM_TAG)
+#endif
+
 #ifdef _WIN32_NATIVE
 #define rtgui_enter_critical()
 #define rtgui_exit_critical()
@@ -90,6 +155,12 @@ void rtgui_get_screen_rect(struct rtgui_rect *rect);
 
 void rtgui_screen_lock(rt_int32_t timeout);
 void rtgui_screen_unlock(void);
+#ifdef GUIENGINE_USING_RECT_LOCK
+/* lock the rect on screen only, a thread holds one rect which is the union of
+ * the rects locked in nested */
+void rtgui_screen_lock_rect(const rtgui_rect_t *rect);
+void rtgui_screen_unlock_rect(void);
+#endif
 int rtgui_screen_lock_freeze(void);
 void rtgui_screen_lock_thaw(int value);
 
@@ -0,0 +1,62 @@
+/*
+ * File      : snapshot.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_SNAPSHOT_H__
+#define __RTGUI_SNAPSHOT_H__
+
+#include <rtgui/rtgui.h>
+#include <rtgui/region.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The snapshot of screen for the instant-on boot. The app saves the home
+ * screen once it's painted or changed, and the snapshot is shown on the panel
+ * at the beginning of rtgui_system_server_init. The updates of screen are held
+ * until the first window is shown, and the updates held are pushed with the
+ * first one after it, so the panel turns from the snapshot to the live UI in
+ * one update.
+ *
+ * The pixels are saved in the blocks of rows compressed by fastlz, the header
+ * is written in the end, so a snapshot torn by the power off is not shown.
+ */
+
+/* save the framebuffer to the file, -RT_ENOSYS if the driver has no framebuffer */
+rt_err_t rtgui_snapshot_save(const char *filename);
+/* show the snapshot on panel, -RT_ERROR if it's not of the current screen */
+rt_err_t rtgui_snapshot_show(const char *filename);
+
+/* in the screen update: RT_TRUE if the update of @rect is held, or the rect to
+ * be updated is returned in @update */
+rt_bool_t rtgui_snapshot_hold(const rtgui_rect_t *rect, rtgui_rect_t *update);
+/* the first window is shown, the next update pushes the updates held */
+void rtgui_snapshot_swap(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
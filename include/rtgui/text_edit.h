@@ -0,0 +1,88 @@
+/*
+ * File      : text_edit.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_TEXT_EDIT_H__
+#define __RTGUI_TEXT_EDIT_H__
+
+#include <rtgui/font.h>
+#include <rtgui/dc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The single line text of editing, which keeps the positions of caret for
+ * the text. An edit repaints only from the edit point to the end of visible
+ * line, and the caret blink repaints only the character under caret.
+ *
+ * The dc of functions is the dc in drawing of the field, or RT_NULL to edit
+ * without any drawing. The rect is the field, the text is drawn from its
+ * left in the font of edit and the colors of dc.
+ */
+struct rtgui_text_edit
+{
+    struct rtgui_font *font;
+
+    /* the bytes of text without '\0' */
+    rt_ubase_t len, capacity;
+    char *text;
+    /* the x of caret before each byte, positions[len] is the width */
+    rt_uint16_t *positions;
+
+    /* the offset of caret in text */
+    rt_ubase_t caret;
+    rt_bool_t caret_on;
+};
+
+struct rtgui_text_edit *rtgui_text_edit_create(struct rtgui_font *font, rt_ubase_t capacity);
+void rtgui_text_edit_destroy(struct rtgui_text_edit *edit);
+
+/* set the whole text, the caret is at the end. Return -RT_EFULL if the text
+ * is longer than capacity */
+rt_err_t rtgui_text_edit_set_text(struct rtgui_text_edit *edit, const char *text);
+/* draw the whole field */
+void rtgui_text_edit_draw(struct rtgui_text_edit *edit, struct rtgui_dc *dc, rtgui_rect_t *rect);
+
+/* insert the text at caret, the caret is after it. Return -RT_EFULL if
+ * there is no room */
+rt_err_t rtgui_text_edit_insert(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                                rtgui_rect_t *rect, const char *text);
+/* delete the character before caret, or after it in forward */
+rt_err_t rtgui_text_edit_delete(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                                rtgui_rect_t *rect, rt_bool_t forward);
+
+/* move the caret to the offset, or to the x in dc nearest to a caret */
+void rtgui_text_edit_set_caret(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                               rtgui_rect_t *rect, rt_ubase_t offset);
+void rtgui_text_edit_hit(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                         rtgui_rect_t *rect, int x);
+/* toggle the caret for the blink */
+void rtgui_text_edit_blink(struct rtgui_text_edit *edit, struct rtgui_dc *dc, rtgui_rect_t *rect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * File      : trace.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_TRACE_H__
+#define __RTGUI_TRACE_H__
+
+#include <rtthread.h>
+#include <rtgui/rtgui_config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The tracepoints of engine, recorded in a ring by the threads and exported as
+ * the JSON of Chrome trace (chrome://tracing or Perfetto) by gui_trace. The
+ * name should be a string constant. A tracepoint is a load of rtgui_trace_on
+ * when the trace is stopped, and nothing without GUIENGINE_USING_TRACE.
+ */
+#ifdef GUIENGINE_USING_TRACE
+extern volatile rt_uint8_t rtgui_trace_on;
+
+void rtgui_trace_record(const char *name, char phase, rt_int32_t value);
+void rtgui_trace_start(void);
+void rtgui_trace_stop(void);
+
+#define RTGUI_TRACE(name, phase, value)             \
+    do {                                            \
+        if (rtgui_trace_on)                         \
+            rtgui_trace_record((name), (phase), (value)); \
+    } while (0)
+#define RTGUI_TRACE_BEGIN(name, arg)        RTGUI_TRACE(name, 'B', arg)
+#define RTGUI_TRACE_END(name)               RTGUI_TRACE(name, 'E', 0)
+#define RTGUI_TRACE_COUNTER(name, value)    RTGUI_TRACE(name, 'C', value)
+#else
+#define RTGUI_TRACE_BEGIN(name, arg)
+#define RTGUI_TRACE_END(name)
+#define RTGUI_TRACE_COUNTER(name, value)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
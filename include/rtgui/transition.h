@@ -0,0 +1,74 @@
+/*
+ * File      : transition.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#ifndef __RTGUI_TRANSITION_H__
+#define __RTGUI_TRANSITION_H__
+
+#include <rtgui/rtgui.h>
+#include <rtgui/widgets/window.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef GUIENGIN_USING_VFRAMEBUFFER
+
+enum rtgui_transition_type
+{
+    /* the incoming window slides in over the outgoing one */
+    RTGUI_TRANSITION_SLIDE_LEFT,
+    RTGUI_TRANSITION_SLIDE_RIGHT,
+    RTGUI_TRANSITION_SLIDE_UP,
+    RTGUI_TRANSITION_SLIDE_DOWN,
+    /* the incoming window pushes the outgoing one out */
+    RTGUI_TRANSITION_PUSH_LEFT,
+    RTGUI_TRANSITION_PUSH_RIGHT,
+    RTGUI_TRANSITION_FADE,
+    /* the incoming window grows from the center */
+    RTGUI_TRANSITION_ZOOM,
+};
+
+/** Switch from a window to another in a transition
+ *
+ * Both windows are painted once into the snapshot buffers, and each frame of
+ * the transition is composed of the blits of the snapshots on the frame clock
+ * of app, no widget is painted in it. The to window is shown at the start and
+ * its paints are skipped until the end, then the from window is hidden and
+ * the to window is updated once.
+ *
+ * The windows should be of the app of current thread and in the same rect.
+ *
+ * @return -RT_ENOMEM if the snapshots can not be created, the to window is
+ * shown without transition then.
+ */
+rt_err_t rtgui_transition_start(struct rtgui_win *from, struct rtgui_win *to,
+                                enum rtgui_transition_type type, rt_uint32_t duration_ms);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
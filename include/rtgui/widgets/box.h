@@ -48,6 +48,10 @@ struct rtgui_box
     rt_uint16_t orient;
     rt_uint16_t border_size;
 
+    /* the size of children and borders in the last layout, the container of
+     * the same min size follows it in rtgui_container_relayout */
+    rt_int16_t hint_width, hint_height;
+
     struct rtgui_container *container;
 };
 typedef struct rtgui_box rtgui_box_t;
@@ -57,6 +61,7 @@ void rtgui_box_destroy(struct rtgui_box *box);
 
 void rtgui_box_layout(rtgui_box_t *box);
 void rtgui_box_layout_rect(rtgui_box_t *box, struct rtgui_rect *rect);
+void rtgui_box_get_hint(struct rtgui_box *box, int *width, int *height);
 
 #ifdef __cplusplus
 }
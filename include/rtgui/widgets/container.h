@@ -61,6 +61,8 @@ rt_bool_t rtgui_container_event_handler(struct rtgui_object *widget, struct rtgu
 /* set layout box */
 void rtgui_container_set_box(struct rtgui_container *container, struct rtgui_box *box);
 void rtgui_container_layout(struct rtgui_container *container);
+/* do the layout for the changed min size of child, return the container to be updated */
+rtgui_widget_t *rtgui_container_relayout(rtgui_widget_t *child);
 
 void rtgui_container_add_child(rtgui_container_t *container, rtgui_widget_t *child);
 void rtgui_container_remove_child(rtgui_container_t *container, rtgui_widget_t *child);
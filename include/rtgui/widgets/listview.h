@@ -0,0 +1,90 @@
+/*
+ * File      : listview.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#ifndef __RTGUI_LISTVIEW_H__
+#define __RTGUI_LISTVIEW_H__
+
+#include <rtgui/widgets/container.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+DECLARE_CLASS_TYPE(listview);
+/** Gets the type of a listview */
+#define RTGUI_LISTVIEW_TYPE       (RTGUI_TYPE(listview))
+/** Casts the object to an rtgui_listview */
+#define RTGUI_LISTVIEW(obj)       (RTGUI_OBJECT_CAST((obj), RTGUI_LISTVIEW_TYPE, rtgui_listview_t))
+/** Checks if the object is an rtgui_listview */
+#define RTGUI_IS_LISTVIEW(obj)    (RTGUI_OBJECT_CHECK_TYPE((obj), RTGUI_LISTVIEW_TYPE))
+
+struct rtgui_listview;
+
+/* the items of list view, they are bound to the rows in view only */
+struct rtgui_listview_source
+{
+    /* create a row widget of the pool */
+    rtgui_widget_t *(*create_row)(struct rtgui_listview *view);
+    /* show the item of index in the row, the row is updated by the view */
+    void (*bind_row)(struct rtgui_listview *view, rtgui_widget_t *row, int index);
+};
+
+/*
+ * The list of items in the same height. Only the rows in view are children,
+ * they are rebound to the items scrolled in, and the pixels of items still in
+ * view are scrolled by copy.
+ */
+struct rtgui_listview
+{
+    struct rtgui_container parent;
+
+    const struct rtgui_listview_source *source;
+    int count;
+    rt_int16_t item_height;
+    /* the pixels of items above the view */
+    int scroll;
+
+    /* the item of index is bound to rows[index % row_count], -1 for none */
+    rtgui_widget_t **rows;
+    int *row_items;
+    rt_uint16_t row_count;
+};
+typedef struct rtgui_listview rtgui_listview_t;
+
+rtgui_listview_t *rtgui_listview_create(const struct rtgui_listview_source *source, int item_height);
+void rtgui_listview_destroy(rtgui_listview_t *view);
+
+rt_bool_t rtgui_listview_event_handler(struct rtgui_object *object, struct rtgui_event *event);
+
+/* set the number of items, all the rows are bound again */
+void rtgui_listview_set_count(rtgui_listview_t *view, int count);
+/* scroll the top of view to the pixel y of items */
+void rtgui_listview_scroll_to(rtgui_listview_t *view, int y);
+/* the item of index is changed, it's bound again if it's in view */
+void rtgui_listview_item_changed(rtgui_listview_t *view, int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
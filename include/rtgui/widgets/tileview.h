@@ -0,0 +1,99 @@
+/*
+ * File      : tileview.h
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#ifndef __RTGUI_TILEVIEW_H__
+#define __RTGUI_TILEVIEW_H__
+
+#include <rtgui/image.h>
+#include <rtgui/widgets/widget.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+
+DECLARE_CLASS_TYPE(tileview);
+/** Gets the type of a tileview */
+#define RTGUI_TILEVIEW_TYPE       (RTGUI_TYPE(tileview))
+/** Casts the object to an rtgui_tileview */
+#define RTGUI_TILEVIEW(obj)       (RTGUI_OBJECT_CAST((obj), RTGUI_TILEVIEW_TYPE, rtgui_tileview_t))
+/** Checks if the object is an rtgui_tileview */
+#define RTGUI_IS_TILEVIEW(obj)    (RTGUI_OBJECT_CHECK_TYPE((obj), RTGUI_TILEVIEW_TYPE))
+
+struct rtgui_tileview;
+
+/* a tile decoded or in loading, the tiles are kept in the order of use */
+struct rtgui_tileview_tile
+{
+    rt_list_t list;
+    struct rtgui_tileview *view;
+
+    /* -1 for the tile not used */
+    rt_int16_t col, row;
+    /* RT_NULL in loading or the file failed */
+    struct rtgui_image *image;
+    struct rtgui_image_request *request;
+};
+
+/*
+ * The view of a large image in the tiles of the same size, such as a map. The
+ * tiles are the image files named by the pattern with the column and row, in
+ * the file system or a mounted resource pack. Only the tiles in view (and the
+ * ones around in background) are decoded by the image loader, at most as the
+ * tiles cached, and the pixels in view are scrolled by copy.
+ */
+struct rtgui_tileview
+{
+    struct rtgui_widget parent;
+
+    /* such as "/res/map/%d_%d.png", formatted with the column and row */
+    char *pattern;
+    rt_uint16_t tile_w, tile_h;
+    rt_uint16_t cols, rows;
+    /* the pixel of image at the left top of view */
+    int scroll_x, scroll_y;
+
+    /* the tiles in the order of use, the least recently used is at the tail */
+    rt_list_t tiles;
+    rt_uint16_t tile_count;
+};
+typedef struct rtgui_tileview rtgui_tileview_t;
+
+rtgui_tileview_t *rtgui_tileview_create(const char *pattern, int tile_w, int tile_h, int cols, int rows);
+void rtgui_tileview_destroy(rtgui_tileview_t *view);
+
+rt_bool_t rtgui_tileview_event_handler(struct rtgui_object *object, struct rtgui_event *event);
+
+/* scroll the left top of view to the pixel (x, y) of image */
+void rtgui_tileview_scroll_to(rtgui_tileview_t *view, int x, int y);
+/* drop the tiles decoded, such as the files are updated */
+void rtgui_tileview_flush(rtgui_tileview_t *view);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -37,6 +37,14 @@ DECLARE_CLASS_TYPE(wintitle);
 struct rtgui_wintitle
 {
     struct rtgui_widget parent;
+
+#ifdef GUIENGINE_USING_TITLE_CACHE
+    /* the title bar drawn last time, and the state it's drawn in */
+    struct rtgui_dc *cache;
+    rt_uint32_t cache_state;
+    rt_uint32_t cache_title;
+    struct rtgui_font *cache_font;
+#endif
 };
 typedef struct rtgui_wintitle rtgui_wintitle_t;
 
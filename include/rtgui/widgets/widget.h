@@ -41,8 +41,15 @@ extern "C" {
 #define RTGUI_WIDGET_FLAG_FOCUS         0x0004
 #define RTGUI_WIDGET_FLAG_TRANSPARENT   0x0008
 #define RTGUI_WIDGET_FLAG_FOCUSABLE     0x0010
+#define RTGUI_WIDGET_FLAG_CLIP_DIRTY    0x0020
+#define RTGUI_WIDGET_FLAG_CACHED        0x0040
+/* the cache of widget is being rendered */
+#define RTGUI_WIDGET_FLAG_CACHE_PAINT   0x0080
 #define RTGUI_WIDGET_FLAG_DC_VISIBLE    0x0100
 #define RTGUI_WIDGET_FLAG_IN_ANIM       0x0200
+#define RTGUI_WIDGET_FLAG_DC_SCISSOR    0x0400
+/* a min size of the children of container is changed since its layout */
+#define RTGUI_WIDGET_FLAG_LAYOUT_DIRTY  0x0800
 
 /* rtgui widget attribute */
 #define RTGUI_WIDGET_FOREGROUND(w)      (RTGUI_WIDGET(w)->gc.foreground)
@@ -72,6 +79,8 @@ extern "C" {
 #define RTGUI_WIDGET_IS_DC_VISIBLE(w)   (RTGUI_WIDGET_FLAG(w) & RTGUI_WIDGET_FLAG_DC_VISIBLE)
 #define RTGUI_WIDGET_DC_SET_VISIBLE(w)  RTGUI_WIDGET_FLAG(w) |= RTGUI_WIDGET_FLAG_DC_VISIBLE
 #define RTGUI_WIDGET_DC_SET_UNVISIBLE(w) RTGUI_WIDGET_FLAG(w) &= ~RTGUI_WIDGET_FLAG_DC_VISIBLE
+/* the clip of client DC is a single rect in this drawing */
+#define RTGUI_WIDGET_IS_DC_SCISSOR(w)   (RTGUI_WIDGET_FLAG(w) & RTGUI_WIDGET_FLAG_DC_SCISSOR)
 #define RTGUI_WIDGET_DC(w)              ((struct rtgui_dc*)&((w)->dc_type))
 
 DECLARE_CLASS_TYPE(widget);
@@ -114,6 +123,8 @@ struct rtgui_widget
     rtgui_rect_t extent_visiable;
     /* the rect clip information */
     rtgui_region_t clip;
+    /* the generation of visiable extent, and the one of parent used by clip */
+    rt_uint16_t clip_gen, clip_parent_gen;
 
     /* minimal width and height of widget */
     rt_int16_t min_width, min_height;
@@ -128,6 +139,21 @@ struct rtgui_widget
 
     /* user private data */
     rt_uint32_t user_data;
+
+#ifdef GUIENGINE_USING_WIDGET_PROFILE
+    /* the cumulative cost of paint, in the clock of profile and pixels */
+    rt_uint32_t paint_us;
+    rt_uint32_t paint_count;
+    rt_uint64_t paint_pixels;
+#endif
+
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    /* the rendering of widget and children, the node in the caches of app, and
+     * the generations of clip of widget and toplevel it's rendered in */
+    struct rtgui_dc *cache;
+    rt_list_t cache_list;
+    rt_uint16_t cache_gen, cache_top_gen;
+#endif
 };
 typedef struct rtgui_widget rtgui_widget_t;
 
@@ -175,6 +201,12 @@ void rtgui_widget_move_to_logic(rtgui_widget_t *widget, int dx, int dy);
 
 /* update the clip info of widget */
 void rtgui_widget_update_clip(rtgui_widget_t *widget);
+void rtgui_widget_clip_dirty(rtgui_widget_t *widget);
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+/* fill the small gaps of children in the clip of container, the base is the
+ * clip before the children are subtracted, it's changed */
+void rtgui_widget_clip_simplify(rtgui_widget_t *widget, rtgui_region_t *base);
+#endif
 
 /* get the toplevel widget of widget */
 struct rtgui_win *rtgui_widget_get_toplevel(rtgui_widget_t *widget);
@@ -185,6 +217,17 @@ rt_bool_t rtgui_widget_onshow(struct rtgui_object *object, struct rtgui_event *e
 void rtgui_widget_hide(rtgui_widget_t *widget);
 rt_bool_t rtgui_widget_onhide(struct rtgui_object *object, struct rtgui_event *event);
 void rtgui_widget_update(rtgui_widget_t *widget);
+/* repaint the rect of widget in the toplevel, the widgets out of it are not painted */
+void rtgui_widget_update_rect(rtgui_widget_t *widget, const rtgui_rect_t *rect);
+/* invalidate the rect of widget, the invalidations are painted once after the events queued */
+void rtgui_widget_invalidate(rtgui_widget_t *widget, const rtgui_rect_t *rect);
+rt_bool_t rtgui_widget_paint_event(rtgui_widget_t *widget, struct rtgui_event *event);
+/* paint the widget in the damage of the paint event, with the clip narrowed to it */
+rt_bool_t rtgui_widget_paint_damage(rtgui_widget_t *widget, struct rtgui_event *event);
+/* narrow the clip to the damage on screen in painting, the clip is restored from the saved */
+rt_bool_t rtgui_widget_clip_damage(rtgui_widget_t *widget, const rtgui_rect_t *damage,
+                                   rtgui_region_t *saved);
+void rtgui_widget_clip_restore(rtgui_widget_t *widget, rtgui_region_t *saved);
 rt_bool_t rtgui_widget_onpaint(struct rtgui_object *object, struct rtgui_event *event);
 
 /* get parent color */
@@ -200,6 +243,16 @@ rt_bool_t rtgui_widget_is_in_animation(rtgui_widget_t *widget);
 
 /* dump widget information */
 void rtgui_widget_dump(rtgui_widget_t *widget);
+#ifdef GUIENGINE_USING_WIDGET_PROFILE
+void rtgui_widget_paint_reset(rtgui_widget_t *widget);
+#endif
+
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+/* cache the rendering of the widget and its children, not for the transparent one */
+void rtgui_widget_set_cached(rtgui_widget_t *widget, rt_bool_t cached);
+/* drop the caches of widget and its parents, as it's changed */
+void rtgui_widget_cache_dirty(rtgui_widget_t *widget);
+#endif
 
 #ifdef __cplusplus
 }
@@ -53,6 +53,7 @@ DECLARE_CLASS_TYPE(win);
 #define RTGUI_WIN_STYLE_ONTOP               0x0040  /* window is in the top layer    */
 #define RTGUI_WIN_STYLE_ONBTM               0x0080  /* window is in the bottom layer */
 #define RTGUI_WIN_STYLE_MAINWIN             0x0106  /* window is a main window       */
+#define RTGUI_WIN_STYLE_BACKING_STORE       0x0200  /* the screen under window is saved */
 
 #define RTGUI_WIN_MAGIC						0xA5A55A5A		/* win magic flag */
 
@@ -83,6 +84,8 @@ enum rtgui_win_flag
     RTGUI_WIN_FLAG_HANDLE_KEY  = 0x20,
 
     RTGUI_WIN_FLAG_CB_PRESSED  = 0x40,
+    /* the damage is invalidated, and its paint event is sent */
+    RTGUI_WIN_FLAG_DAMAGED     = 0x80,
 };
 
 struct rtgui_win
@@ -97,6 +100,9 @@ struct rtgui_win
     rt_base_t drawing;
     struct rtgui_rect drawing_rect;
 
+    /* the rects invalidated on screen, painted once by the deferred paint */
+    struct rtgui_rect damage;
+
     /* parent window. RT_NULL if the window is a top level window */
     struct rtgui_win *parent_window;
 
@@ -146,6 +152,15 @@ struct rtgui_win
     /* app ref_count */
     rt_uint16_t app_ref_count;
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+    /* the layer drawn to, which is created by server */
+    struct rtgui_layer *layer;
+#endif
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    /* the display shown on, 0 is the main display */
+    rt_uint8_t display;
+#endif
+
     /* win magic flag, magic value is 0xA5A55A5A */
     rt_uint32_t	magic;
 };
@@ -200,8 +215,28 @@ void rtgui_win_event_loop(rtgui_win_t *wnd);
 void rtgui_win_set_title(rtgui_win_t *win, const char *title);
 char *rtgui_win_get_title(rtgui_win_t *win);
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+/* set the opacity of window in compositing, 255 is opaque */
+void rtgui_win_set_opacity(rtgui_win_t *win, rt_uint8_t opacity);
+#endif
+
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+/* bind the hidden window to the display, the extent is in the display */
+rt_err_t rtgui_win_set_display(rtgui_win_t *win, int display);
+#define RTGUI_WIN_DISPLAY(win)  ((win)->display)
+#else
+#define RTGUI_WIN_DISPLAY(win)  0
+#endif
+
 struct rtgui_dc *rtgui_win_get_drawing(rtgui_win_t * win);
 
+#ifdef GUIENGINE_USING_BAND
+/* the screen is a device without framebuffer, and not in the virtual mode */
+rt_bool_t rtgui_win_is_band_mode(void);
+/* paint the widget of window band by band, with the paint event */
+void rtgui_win_paint_bands(struct rtgui_win *win, rtgui_widget_t *widget, struct rtgui_event *event);
+#endif
+
 struct rtgui_win* rtgui_win_get_topmost_shown(void);
 struct rtgui_win* rtgui_win_get_next_shown(void);
 
@@ -24,6 +24,8 @@
   /*                                                                       */
   /*************************************************************************/
 
+  /* the memory of FreeType is traced as the fonts of GUI engine */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
 
 #include <ft2build.h>
 #include FT_CONFIG_CONFIG_H
@@ -36,6 +38,7 @@
 #include <rtthread.h>
 #include <dfs.h>
 #include <dfs_file.h>
+#include <rtgui/rtgui_system.h>
 
   /*************************************************************************/
   /*                                                                       */
@@ -74,7 +77,7 @@
   {
     FT_UNUSED( memory );
 
-    return rt_malloc( size );
+    return rtgui_malloc( size );
   }
 
 
@@ -107,7 +110,7 @@
     FT_UNUSED( memory );
     FT_UNUSED( cur_size );
 
-    return rt_realloc( block, new_size );
+    return rtgui_realloc( block, new_size );
   }
 
 
@@ -130,7 +133,7 @@
   {
     FT_UNUSED( memory );
 
-    rt_free( block );
+    rtgui_free( block );
   }
 
 
@@ -171,7 +174,7 @@
   ft_rtt_stream_close( FT_Stream  stream )
   {
     dfs_file_close( STREAM_FILE( stream ) );
-    rt_free( STREAM_FILE( stream ) );
+    rtgui_free( STREAM_FILE( stream ) );
 
     stream->descriptor.pointer = RT_NULL;
     stream->size               = 0;
@@ -253,7 +256,7 @@
     stream->read               = NULL;
     stream->close              = NULL;
 
-    dfd = rt_malloc(sizeof(*dfd));
+    dfd = rtgui_malloc(sizeof(*dfd));
     if ( !dfd )
       return FT_THROW( Out_Of_Memory );
 
@@ -263,6 +266,7 @@
       FT_ERROR(( "FT_Stream_Open:"
                  " could not open `%s'\n", filepathname ));
 
+      rtgui_free( dfd );
       return FT_THROW( Cannot_Open_Resource );
     }
 
@@ -272,7 +276,7 @@
       FT_ERROR(( "FT_Stream_Open:" ));
       FT_ERROR(( " opened `%s' but zero-sized\n", filepathname ));
       dfs_file_close( dfd );
-      rt_free(dfd);
+      rtgui_free(dfd);
       return FT_THROW( Cannot_Open_Stream );
     }
 
@@ -308,7 +312,7 @@
     FT_Memory  memory;
 
 
-    memory = (FT_Memory)rt_malloc( sizeof ( *memory ) );
+    memory = (FT_Memory)rtgui_malloc( sizeof ( *memory ) );
     if ( memory )
     {
       memory->user    = 0;
@@ -332,7 +336,7 @@
 #ifdef FT_DEBUG_MEMORY
     ft_mem_debug_done( memory );
 #endif
-    rt_free( memory );
+    rtgui_free( memory );
   }
 
 
@@ -10,7 +10,14 @@
  *
  */
 
+/*
+ *  The modules of RT-Thread GUI Engine, autofit is compiled with
+ *  GUIENGINE_TTF_USING_AUTOFIT (see the profile in ftoption.h).
+ */
+
+#ifdef GUIENGINE_TTF_USING_AUTOFIT
 FT_USE_MODULE( FT_Module_Class, autofit_module_class )
+#endif
 FT_USE_MODULE( FT_Driver_ClassRec, tt_driver_class )
 //FT_USE_MODULE( FT_Driver_ClassRec, t1_driver_class )
 //FT_USE_MODULE( FT_Driver_ClassRec, cff_driver_class )
@@ -20,13 +27,13 @@ FT_USE_MODULE( FT_Driver_ClassRec, tt_driver_class )
 //FT_USE_MODULE( FT_Driver_ClassRec, winfnt_driver_class )
 //FT_USE_MODULE( FT_Driver_ClassRec, pcf_driver_class )
 //FT_USE_MODULE( FT_Module_Class, psaux_module_class )
-FT_USE_MODULE( FT_Module_Class, psnames_module_class )
+//FT_USE_MODULE( FT_Module_Class, psnames_module_class )
 //FT_USE_MODULE( FT_Module_Class, pshinter_module_class )
 //FT_USE_MODULE( FT_Renderer_Class, ft_raster1_renderer_class )
 FT_USE_MODULE( FT_Module_Class, sfnt_module_class )
 FT_USE_MODULE( FT_Renderer_Class, ft_smooth_renderer_class )
-FT_USE_MODULE( FT_Renderer_Class, ft_smooth_lcd_renderer_class )
-FT_USE_MODULE( FT_Renderer_Class, ft_smooth_lcdv_renderer_class )
+//FT_USE_MODULE( FT_Renderer_Class, ft_smooth_lcd_renderer_class )
+//FT_USE_MODULE( FT_Renderer_Class, ft_smooth_lcdv_renderer_class )
 //FT_USE_MODULE( FT_Driver_ClassRec, bdf_driver_class )
 
 /* EOF */
@@ -21,10 +21,21 @@
 
 
 #include <ft2build.h>
+  /* the GUIENGINE_TTF_* options of the GUI engine profile */
+#include <rtconfig.h>
 
 
 FT_BEGIN_HEADER
 
+  /*************************************************************************/
+  /*                                                                       */
+  /* The profile of RT-Thread GUI Engine: only the sfnt, truetype, smooth  */
+  /* and cache modules are built, and autofit with                         */
+  /* GUIENGINE_TTF_USING_AUTOFIT.  The options below for the fonts of the  */
+  /* other formats, glyph names and the compressed streams are disabled to */
+  /* save the flash and the RAM of the library.                            */
+  /*                                                                       */
+
   /*************************************************************************/
   /*                                                                       */
   /*                 USER-SELECTABLE CONFIGURATION MACROS                  */
@@ -148,7 +159,7 @@ FT_BEGIN_HEADER
   /*                                                                       */
   /*   Define this macro if you want to enable this `feature'.             */
   /*                                                                       */
-#define FT_CONFIG_OPTION_USE_LZW
+/* #define FT_CONFIG_OPTION_USE_LZW */
 
 
   /*************************************************************************/
@@ -305,7 +316,7 @@ FT_BEGIN_HEADER
   /*   You would normally undefine this configuration macro when building  */
   /*   a version of FreeType that doesn't contain a Type 1 or CFF driver.  */
   /*                                                                       */
-#define FT_CONFIG_OPTION_POSTSCRIPT_NAMES
+/* #define FT_CONFIG_OPTION_POSTSCRIPT_NAMES */
 
 
   /*************************************************************************/
@@ -323,7 +334,7 @@ FT_BEGIN_HEADER
   /*   able to synthesize a Unicode charmap out of the glyphs found in the */
   /*   fonts.                                                              */
   /*                                                                       */
-#define FT_CONFIG_OPTION_ADOBE_GLYPH_LIST
+/* #define FT_CONFIG_OPTION_ADOBE_GLYPH_LIST */
 
 
   /*************************************************************************/
@@ -336,7 +347,7 @@ FT_BEGIN_HEADER
   /*                                                                       */
   /*   Note that the `FOND' resource isn't checked.                        */
   /*                                                                       */
-#define FT_CONFIG_OPTION_MAC_FONTS
+/* #define FT_CONFIG_OPTION_MAC_FONTS */
 
 
   /*************************************************************************/
@@ -370,7 +381,7 @@ FT_BEGIN_HEADER
   /* supply font data incrementally as the document is parsed, such        */
   /* as the Ghostscript interpreter for the PostScript language.           */
   /*                                                                       */
-#define FT_CONFIG_OPTION_INCREMENTAL
+/* #define FT_CONFIG_OPTION_INCREMENTAL */
 
 
   /*************************************************************************/
@@ -386,9 +397,10 @@ FT_BEGIN_HEADER
   /* FT_MAX_MODULES                                                        */
   /*                                                                       */
   /*   The maximum number of modules that can be registered in a single    */
-  /*   FreeType library object.  32 is the default.                        */
+  /*   FreeType library object.  32 is the default, the GUI engine profile */
+  /*   registers 4 at most.                                                */
   /*                                                                       */
-#define FT_MAX_MODULES  32
+#define FT_MAX_MODULES  8
 
 
   /*************************************************************************/
@@ -527,7 +539,7 @@ FT_BEGIN_HEADER
   /*                                                                       */
   /* (By default, the module uses `PSNames' to extract glyph names.)       */
   /*                                                                       */
-#define TT_CONFIG_OPTION_POSTSCRIPT_NAMES
+/* #define TT_CONFIG_OPTION_POSTSCRIPT_NAMES */
 
 
   /*************************************************************************/
@@ -554,8 +566,8 @@ FT_BEGIN_HEADER
 #define TT_CONFIG_CMAP_FORMAT_2
 #define TT_CONFIG_CMAP_FORMAT_4
 #define TT_CONFIG_CMAP_FORMAT_6
-#define TT_CONFIG_CMAP_FORMAT_8
-#define TT_CONFIG_CMAP_FORMAT_10
+/* #define TT_CONFIG_CMAP_FORMAT_8 */
+/* #define TT_CONFIG_CMAP_FORMAT_10 */
 #define TT_CONFIG_CMAP_FORMAT_12
 #define TT_CONFIG_CMAP_FORMAT_13
 #define TT_CONFIG_CMAP_FORMAT_14
@@ -681,7 +693,7 @@ FT_BEGIN_HEADER
   /* and avar tables).  This has many similarities to Type 1 Multiple      */
   /* Masters support.                                                      */
   /*                                                                       */
-#define TT_CONFIG_OPTION_GX_VAR_SUPPORT
+/* #define TT_CONFIG_OPTION_GX_VAR_SUPPORT */
 
 
   /*************************************************************************/
@@ -689,7 +701,7 @@ FT_BEGIN_HEADER
   /* Define TT_CONFIG_OPTION_BDF if you want to include support for        */
   /* an embedded `BDF ' table within SFNT-based bitmap formats.            */
   /*                                                                       */
-#define TT_CONFIG_OPTION_BDF
+/* #define TT_CONFIG_OPTION_BDF */
 
 
   /*************************************************************************/
@@ -828,7 +840,7 @@ FT_BEGIN_HEADER
   /*                                                                       */
   /* Compile autofit module with Indic script support.                     */
   /*                                                                       */
-#define AF_CONFIG_OPTION_INDIC
+/* #define AF_CONFIG_OPTION_INDIC */
 
   /*************************************************************************/
   /*                                                                       */
@@ -843,7 +855,7 @@ FT_BEGIN_HEADER
   /* `warping' property of the auto-hinter (see file `ftautoh.h' for more  */
   /* information; by default it is switched off).                          */
   /*                                                                       */
-#define AF_CONFIG_OPTION_USE_WARPER
+/* #define AF_CONFIG_OPTION_USE_WARPER */
 
   /* */
 
@@ -20,6 +20,18 @@
 
 #include "tjpgd.h"
 
+#if JD_USE_SIMD && defined(__ARM_NEON)
+#include <arm_neon.h>
+#include <stdint.h>
+#define	JD_USE_NEON		1
+#else
+#define	JD_USE_NEON		0
+#endif
+#if JD_USE_SIMD && !JD_USE_NEON && defined(__ARM_FEATURE_SAT)
+#include <arm_acle.h>
+#define	YCCCLIP(v)		((BYTE)__usat((v), 8))	/* Saturate in one instruction, no load of the table */
+#endif
+
 
 /*-----------------------------------------------*/
 /* Zigzag-order to raster-order conversion table */
@@ -346,6 +358,128 @@ INT huffext (			/* >=0: decoded data, <0: error code */
 /* Apply Inverse-DCT in Arai Algorithm (see also aa_idct.png)            */
 /*-----------------------------------------------------------------------*/
 
+#ifndef YCCCLIP
+#define	YCCCLIP(v)		BYTECLIP(v)
+#endif
+
+
+#if JD_USE_NEON
+/*-----------------------------------------------------------------------*/
+/* Apply Inverse-DCT in Arai Algorithm by NEON, in the same results      */
+/*-----------------------------------------------------------------------*/
+
+/* The 1-D transform of the elements v[0..7] in 4 lanes at once */
+static inline
+void idct_pass_neon (
+	int32x4_t* v
+)
+{
+	const int32_t M13 = (int32_t)(1.41421*4096), M2 = (int32_t)(1.08239*4096), M4 = (int32_t)(2.61313*4096), M5 = (int32_t)(1.84776*4096);
+	int32x4_t v0, v1, v2, v3, v4, v5, v6, v7;
+	int32x4_t t10, t11, t12, t13;
+
+	v0 = v[0]; v1 = v[2]; v2 = v[4]; v3 = v[6];	/* Process the even elements */
+	t10 = vaddq_s32(v0, v2);
+	t12 = vsubq_s32(v0, v2);
+	t11 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(v1, v3), M13), 12);
+	v3 = vaddq_s32(v3, v1);
+	t11 = vsubq_s32(t11, v3);
+	v0 = vaddq_s32(t10, v3);
+	v3 = vsubq_s32(t10, v3);
+	v1 = vaddq_s32(t11, t12);
+	v2 = vsubq_s32(t12, t11);
+
+	v4 = v[7]; v5 = v[1]; v6 = v[5]; v7 = v[3];	/* Process the odd elements */
+	t10 = vsubq_s32(v5, v4);
+	t11 = vaddq_s32(v5, v4);
+	t12 = vsubq_s32(v6, v7);
+	v7 = vaddq_s32(v7, v6);
+	v5 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(t11, v7), M13), 12);
+	v7 = vaddq_s32(v7, t11);
+	t13 = vshrq_n_s32(vmulq_n_s32(vaddq_s32(t10, t12), M5), 12);
+	v4 = vsubq_s32(t13, vshrq_n_s32(vmulq_n_s32(t10, M2), 12));
+	v6 = vsubq_s32(vsubq_s32(t13, vshrq_n_s32(vmulq_n_s32(t12, M4), 12)), v7);
+	v5 = vsubq_s32(v5, v6);
+	v4 = vsubq_s32(v4, v5);
+
+	v[0] = vaddq_s32(v0, v7);
+	v[7] = vsubq_s32(v0, v7);
+	v[1] = vaddq_s32(v1, v6);
+	v[6] = vsubq_s32(v1, v6);
+	v[2] = vaddq_s32(v2, v5);
+	v[5] = vsubq_s32(v2, v5);
+	v[3] = vaddq_s32(v3, v4);
+	v[4] = vsubq_s32(v3, v4);
+}
+
+/* Transpose the 4x4 block of s[0..3] to d[0..3] */
+static inline
+void transpose_neon (
+	const int32x4_t* s,
+	int32x4_t* d
+)
+{
+	int32x4x2_t t0 = vtrnq_s32(s[0], s[1]);
+	int32x4x2_t t1 = vtrnq_s32(s[2], s[3]);
+
+	d[0] = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+	d[1] = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+	d[2] = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+	d[3] = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+static
+void block_idct (
+	LONG* src,	/* Input block data (de-quantized and pre-scaled for Arai Algorithm) */
+	BYTE* dst	/* Pointer to the destination to store the block as byte array */
+)
+{
+	int32_t blk[64];
+	const int32_t *s;
+	int32x4_t lo[8], hi[8], a[8], b[8];
+	uint16x4_t l, h;
+	UINT i;
+
+	/* The LONG is 64-bit on the LP64 targets */
+	if (sizeof (LONG) == 4) {
+		s = (const int32_t*)src;
+	} else {
+		for (i = 0; i < 64; i++) blk[i] = (int32_t)src[i];
+		s = blk;
+	}
+
+	/* Process columns, 4 columns in the lanes */
+	for (i = 0; i < 8; i++) {
+		lo[i] = vld1q_s32(s + 8 * i);
+		hi[i] = vld1q_s32(s + 8 * i + 4);
+	}
+	idct_pass_neon(lo);
+	idct_pass_neon(hi);
+
+	/* Process rows, 4 rows in the lanes after the transpose */
+	transpose_neon(lo, a);
+	transpose_neon(hi, a + 4);
+	transpose_neon(lo + 4, b);
+	transpose_neon(hi + 4, b + 4);
+	a[0] = vaddq_s32(a[0], vdupq_n_s32(128L << 8));	/* Remove DC offset (-128) here */
+	b[0] = vaddq_s32(b[0], vdupq_n_s32(128L << 8));
+	idct_pass_neon(a);
+	idct_pass_neon(b);
+	transpose_neon(a, lo);
+	transpose_neon(a + 4, hi);
+	transpose_neon(b, lo + 4);
+	transpose_neon(b + 4, hi + 4);
+
+	/* Descale the transformed values 8 bits and output */
+	for (i = 0; i < 8; i++) {
+		l = vqmovun_s32(vshrq_n_s32(lo[i], 8));
+		h = vqmovun_s32(vshrq_n_s32(hi[i], 8));
+		vst1_u8(dst, vqmovn_u16(vcombine_u16(l, h)));
+		dst += 8;
+	}
+}
+
+#else
 static
 void block_idct (
 	LONG* src,	/* Input block data (de-quantized and pre-scaled for Arai Algorithm) */
@@ -451,6 +585,7 @@ void block_idct (
 		src += 8;	/* Next row */
 	}
 }
+#endif
 
 
 
@@ -461,7 +596,8 @@ void block_idct (
 
 static
 JRESULT mcu_load (
-	JDEC* jd		/* Pointer to the decompressor object */
+	JDEC* jd,		/* Pointer to the decompressor object */
+	BYTE skip		/* Only decode the huffman stream, the MCU is not output */
 )
 {
 	LONG *tmp = (LONG*)jd->workbuf;	/* Block working buffer for de-quantize and IDCT */
@@ -524,7 +660,9 @@ JRESULT mcu_load (
 			}
 		} while (++i < 64);		/* Next AC element */
 
-		if (JD_USE_SCALE && jd->scale == 3)
+		if (skip)
+			;							/* The DC values are kept for next MCU, IDCT is not needed */
+		else if (JD_USE_SCALE && jd->scale == 3)
 			*bp = (BYTE)((*tmp / 256) + 128);	/* If scale ratio is 1/8, IDCT can be ommited and only DC element is used */
 		else
 			block_idct(tmp, bp);		/* Apply IDCT and store the block to the MCU buffer */
@@ -538,6 +676,151 @@ JRESULT mcu_load (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Convert a line of YCbCr MCU to the output format directly            */
+/*-----------------------------------------------------------------------*/
+
+#if JD_USE_NEON
+/* (v * k) >> 10 of the 8 lanes */
+static inline
+int16x8_t ycc_mul_neon (
+	int16x8_t v,
+	int16_t k
+)
+{
+	return vcombine_s16(vshrn_n_s32(vmull_n_s16(vget_low_s16(v), k), 10),
+						vshrn_n_s32(vmull_n_s16(vget_high_s16(v), k), 10));
+}
+
+/* Convert 8 pixels, the chroma of 4 pixels are doubled if it's subsampled */
+static inline
+void ycc_pixels_neon (
+	const BYTE* py,
+	const BYTE* pc,
+	UINT half,
+	BYTE format,
+	BYTE* dst
+)
+{
+	uint8x8_t c8, r8, g8, b8;
+	int16x8_t yy, cb, cr;
+	uint8x8x3_t rgb;
+	uint16x8_t w;
+
+	yy = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(py)));
+	c8 = vld1_u8(pc);
+	if (half) c8 = vzip_u8(c8, c8).val[0];
+	cb = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c8)), vdupq_n_s16(128));
+	c8 = vld1_u8(pc + 64);
+	if (half) c8 = vzip_u8(c8, c8).val[0];
+	cr = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c8)), vdupq_n_s16(128));
+
+	r8 = vqmovun_s16(vaddq_s16(yy, ycc_mul_neon(cr, (int16_t)(1.402 * 1024))));
+	g8 = vqmovun_s16(vsubq_s16(vsubq_s16(yy, ycc_mul_neon(cb, (int16_t)(0.344 * 1024))),
+							   ycc_mul_neon(cr, (int16_t)(0.714 * 1024))));
+	b8 = vqmovun_s16(vaddq_s16(yy, ycc_mul_neon(cb, (int16_t)(1.772 * 1024))));
+
+	if (format == 1) {
+		w = vandq_u16(vshll_n_u8(r8, 8), vdupq_n_u16(0xF800));	/* RRRRR----------- */
+		w = vorrq_u16(w, vshlq_n_u16(vmovl_u8(vshr_n_u8(g8, 2)), 5));	/* -----GGGGGG----- */
+		w = vorrq_u16(w, vmovl_u8(vshr_n_u8(b8, 3)));			/* -----------BBBBB */
+		vst1q_u16((uint16_t*)dst, w);
+	} else {
+		rgb.val[0] = r8; rgb.val[1] = g8; rgb.val[2] = b8;
+		vst3_u8(dst, rgb);
+	}
+}
+#endif
+
+static
+void ycc_line (
+	JDEC* jd,		/* Pointer to the decompressor object */
+	const BYTE* py,	/* Y of the line, the right half is in the next block of double block width */
+	const BYTE* pc,	/* Cb of the line, Cr follows it by 64 */
+	UINT mx,		/* MCU width (pixel) */
+	UINT n,			/* Number of pixels to output */
+	BYTE* dst		/* Destination in the output format */
+)
+{
+	const INT CVACC = (sizeof (INT) > 2) ? 1024 : 128;
+	UINT ix, c;
+	INT yy, cb, cr, r, g, b;
+
+	ix = 0;
+#if JD_USE_NEON
+	for (; ix + 8 <= n; ix += 8) {
+		ycc_pixels_neon(ix < 8 ? py + ix : py + 64 + ix - 8, pc + (mx == 16 ? ix >> 1 : ix),
+						mx == 16, jd->format, dst + ix * (jd->format ? 2 : 3));
+	}
+#endif
+	dst += ix * (jd->format ? 2 : 3);
+	for (; ix < n; ix++) {
+		c = (mx == 16) ? ix >> 1 : ix;	/* Chroma is shared by two pixels in double block width */
+		cb = pc[c] - 128;
+		cr = pc[c + 64] - 128;
+		yy = (ix < 8) ? py[ix] : py[64 + ix - 8];
+
+		r = YCCCLIP(yy + ((INT)(1.402 * CVACC) * cr) / CVACC);
+		g = YCCCLIP(yy - ((INT)(0.344 * CVACC) * cb + (INT)(0.714 * CVACC) * cr) / CVACC);
+		b = YCCCLIP(yy + ((INT)(1.772 * CVACC) * cb) / CVACC);
+		if (jd->format == 1) {
+			*(WORD*)dst = (WORD)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+			dst += 2;
+		} else {
+			*dst++ = (BYTE)r;
+			*dst++ = (BYTE)g;
+			*dst++ = (BYTE)b;
+		}
+	}
+}
+
+/* Output an MCU not descaled, the visible pixels are converted to the format
+   once, in the frame if it's set */
+static
+JRESULT mcu_output_direct (
+	JDEC* jd,	/* Pointer to the decompressor object */
+	UINT (*outfunc)(JDEC*, void*, JRECT*),	/* RGB output function */
+	JRECT* rect,	/* Rectangular area in the frame buffer */
+	UINT rx,	/* Output rectangular size */
+	UINT ry
+)
+{
+	UINT iy, mx, my, bpp, pitch;
+	BYTE *py, *pc, *dst;
+
+
+	mx = jd->msx * 8; my = jd->msy * 8;			/* MCU size (pixel) */
+	bpp = jd->format ? 2 : 3;
+	if (jd->frame) {
+		pitch = jd->pitch;
+		dst = jd->frame + rect->top * pitch + rect->left * bpp;
+	} else {
+		pitch = rx * bpp;
+		dst = (BYTE*)jd->workbuf;
+	}
+
+	for (iy = 0; iy < ry; iy++) {
+		pc = jd->mcubuf;
+		py = pc + iy * 8;
+		if (my == 16) {		/* Double block height? */
+			pc += 64 * 4 + (iy >> 1) * 8;
+			if (iy >= 8) py += 64;
+		} else {			/* Single block height */
+			pc += mx * 8 + iy * 8;
+		}
+		ycc_line(jd, py, pc, mx, rx, dst);
+		dst += pitch;
+	}
+
+	if (jd->frame) return JDR_OK;
+
+	/* Output the rectangular */
+	return outfunc(jd, jd->workbuf, rect) ? JDR_OK : JDR_INTR;
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Output an MCU: Convert YCrCb to RGB and output it in RGB form         */
 /*-----------------------------------------------------------------------*/
@@ -568,6 +851,8 @@ JRESULT mcu_output (
 	rect.left = x; rect.right = x + rx - 1;				/* Rectangular area in the frame buffer */
 	rect.top = y; rect.bottom = y + ry - 1;
 
+	if (!JD_USE_SCALE || jd->scale == 0)	/* Not descaled, convert to the format in one pass */
+		return mcu_output_direct(jd, outfunc, &rect, rx, ry);
 
 	if (!JD_USE_SCALE || jd->scale != 3) {	/* Not for 1/8 scaling */
 
@@ -763,6 +1048,10 @@ JRESULT jd_prepare (
 	jd->device = dev;		/* I/O device identifier */
 	jd->nrst = 0;			/* No restart interval (default) */
 	jd->format = 0;			/* use RGB888 (3 BYTE/pix) default */
+	jd->roi.left = jd->roi.top = 0;	/* output whole picture default */
+	jd->roi.right = jd->roi.bottom = 0xFFFF;
+	jd->frame = 0;			/* output by outfunc default */
+	jd->pitch = 0;
 
 	for (i = 0; i < 2; i++) {	/* Nulls pointers */
 		for (j = 0; j < 2; j++) {
@@ -942,6 +1231,7 @@ JRESULT jd_decomp (
 {
 	UINT x, y, mx, my;
 	WORD rst, rsc;
+	BYTE skip;
 	JRESULT rc;
 
 
@@ -955,14 +1245,18 @@ JRESULT jd_decomp (
 
 	rc = JDR_OK;
 	for (y = 0; y < jd->height; y += my) {		/* Vertical loop of MCUs */
+		if ((y >> scale) > jd->roi.bottom) break;	/* The rest MCU rows are not needed */
 		for (x = 0; x < jd->width; x += mx) {	/* Horizontal loop of MCUs */
 			if (jd->nrst && rst++ == jd->nrst) {	/* Process restart interval if enabled */
 				rc = restart(jd, rsc++);
 				if (rc != JDR_OK) return rc;
 				rst = 1;
 			}
-			rc = mcu_load(jd);					/* Load an MCU (decompress huffman coded stream and IDCT) */
+			skip = ((y + my) >> scale) <= jd->roi.top ||	/* Is the MCU outside of the ROI? */
+				((x + mx) >> scale) <= jd->roi.left || (x >> scale) > jd->roi.right;
+			rc = mcu_load(jd, skip);			/* Load an MCU (decompress huffman coded stream and IDCT) */
 			if (rc != JDR_OK) return rc;
+			if (skip) continue;
 			rc = mcu_output(jd, outfunc, x, y);	/* Output the MCU (color space conversion, scaling and output) */
 			if (rc != JDR_OK) return rc;
 		}
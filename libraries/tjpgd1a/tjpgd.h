@@ -5,7 +5,16 @@
 /* System Configurations */
 
 #define	JD_SZBUF		(16 * 1024)	/* Size of stream input buffer (should be multiple of 512) */
-#define	JD_USE_SCALE	0	/* Use descaling feature for output */
+#ifndef JD_USE_SCALE
+#define	JD_USE_SCALE	1	/* Use descaling feature for output */
+#endif
+#ifndef JD_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_FEATURE_DSP)
+#define	JD_USE_SIMD		1	/* Use the NEON IDCT and color conversion, or the saturation of Cortex-M DSP */
+#else
+#define	JD_USE_SIMD		0
+#endif
+#endif
 
 /*---------------------------------------------------------------------------*/
 
@@ -57,6 +66,9 @@ struct JDEC {
 	void* device;			/* Pointer to I/O device identifiler for the session */
 
 	BYTE format;			/* the output format, 0:RGB888 (3 BYTE/pix), 1:RGB565 (1 WORD/pix) */
+	JRECT roi;				/* the output rectangular needed (descaled), the MCUs outside are not output */
+	BYTE* frame;			/* the output frame in format, the MCUs not descaled are converted into it without outfunc */
+	UINT pitch;				/* the bytes of a line in frame */
 };
 
 
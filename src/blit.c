@@ -44,15 +44,27 @@
      misrepresented as being the original software.
   3. This notice may not be removed or altered from any source distribution.
 */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
 
 #include <rtgui/rtgui.h>
 #include <rtgui/blit.h>
 #include <rtgui/color.h>
 #include <rtgui/region.h>
 #include <rtgui/dc.h>
+#include <rtgui/driver.h>
+#include <rtgui/trace.h>
+#include <rtgui/rtgui_system.h>
 
 #include <string.h>
 
+#if defined(GUIENGINE_USING_BLIT_NEON)
+#include <arm_neon.h>
+#define GUIENGINE_USING_BLIT_SIMD
+#elif defined(GUIENGINE_USING_BLIT_MVE)
+#include <arm_mve.h>
+#define GUIENGINE_USING_BLIT_SIMD
+#endif
+
 /* Lookup tables to expand partial bytes to the full 0..255 range */
 
 static const rt_uint8_t lookup_0[] =
@@ -129,6 +141,128 @@ const rt_uint8_t* rtgui_blit_expand_byte[9] =
     lookup_8
 };
 
+#ifdef GUIENGINE_USING_BLIT_SIMD
+/*
+ * The SIMD kernels work on 4 pixels in 32 bits lanes with the same integer
+ * operations of the scalar code, so the result is the same bit for bit. The
+ * kernels return the number of pixels handled, the rest is for scalar code.
+ */
+#define _simd_u32(n)                    vdupq_n_u32(n)
+#ifdef GUIENGINE_USING_BLIT_NEON
+#define _simd_load32(p)                 vld1q_u32(p)
+#define _simd_load16(p)                 vmovl_u16(vld1_u16(p))
+#define _simd_store32(p, v)             vst1q_u32(p, v)
+#define _simd_store16(p, v)             vst1_u16(p, vmovn_u32(v))
+/* select a if v == n, otherwise b */
+#define _simd_select_eq(v, n, a, b)     vbslq_u32(vceqq_u32(v, vdupq_n_u32(n)), a, b)
+#else
+#define _simd_load32(p)                 vld1q_u32(p)
+#define _simd_load16(p)                 vldrhq_u32(p)
+#define _simd_store32(p, v)             vst1q_u32(p, v)
+#define _simd_store16(p, v)             vstrhq_u32(p, v)
+#define _simd_select_eq(v, n, a, b)     vpselq_u32(a, b, vcmpeqq_n_u32(v, n))
+#endif
+
+/* x / 255 for x in [0, 255 * 255] */
+rt_inline uint32x4_t _simd_div255(uint32x4_t x)
+{
+    return vshrq_n_u32(vaddq_u32(vaddq_u32(x, _simd_u32(1)), vshrq_n_u32(x, 8)), 8);
+}
+
+/* parameter a is the alpha of blit info, 0 means not to use the pixel alpha */
+static int _simd_argb8888_to_565(rt_uint16_t *dst, const rt_uint32_t *src, int n, unsigned a)
+{
+    int index, count;
+    uint32x4_t s, d, s2, alpha, opaque;
+
+    count = n & ~3;
+    for (index = 0; index < count; index += 4)
+    {
+        s = _simd_load32(src);
+        d = _simd_load16(dst);
+
+        opaque = vaddq_u32(vaddq_u32(vandq_u32(vshrq_n_u32(s, 8), _simd_u32(0xf800)),
+                                     vandq_u32(vshrq_n_u32(s, 5), _simd_u32(0x7e0))),
+                           vandq_u32(vshrq_n_u32(s, 3), _simd_u32(0x1f)));
+
+        alpha = vshrq_n_u32(s, 24);
+        if (a > 0 && a != 255)
+            alpha = _simd_div255(vmulq_u32(alpha, _simd_u32(a)));
+        alpha = vshrq_n_u32(alpha, 3);
+
+        if (a == 0)
+        {
+            /* any visible pixel is opaque */
+            d = _simd_select_eq(alpha, 0, d, opaque);
+        }
+        else
+        {
+            /* convert source and destination to G0RAB65565 */
+            s2 = vaddq_u32(vaddq_u32(vshlq_n_u32(vandq_u32(s, _simd_u32(0xfc00)), 11),
+                                     vandq_u32(vshrq_n_u32(s, 8), _simd_u32(0xf800))),
+                           vandq_u32(vshrq_n_u32(s, 3), _simd_u32(0x1f)));
+            d = vandq_u32(vorrq_u32(d, vshlq_n_u32(d, 16)), _simd_u32(0x07e0f81f));
+            d = vaddq_u32(d, vshrq_n_u32(vmulq_u32(vsubq_u32(s2, d), alpha), 5));
+            d = vandq_u32(d, _simd_u32(0x07e0f81f));
+            d = vorrq_u32(d, vshrq_n_u32(d, 16));
+
+            d = _simd_select_eq(alpha, 255 >> 3, opaque, d);
+        }
+        _simd_store16(dst, d);
+
+        src += 4;
+        dst += 4;
+    }
+
+    return count;
+}
+
+static int _simd_argb8888_to_argb8888(rt_uint32_t *dst, const rt_uint32_t *src, int n, unsigned a)
+{
+    int index, count;
+    uint32x4_t s, d, sa, da, alpha, inv, rb, g, blend;
+
+    count = n & ~3;
+    for (index = 0; index < count; index += 4)
+    {
+        s = _simd_load32(src);
+        d = _simd_load32(dst);
+
+        sa = vshrq_n_u32(s, 24);
+        if (a > 0 && a != 255)
+            sa = _simd_div255(vmulq_u32(sa, _simd_u32(a)));
+        da = vshrq_n_u32(d, 24);
+
+        /* blend R and B in parallel, no field exceeds 16 bits */
+        alpha = vaddq_u32(sa, _simd_u32(1));
+        inv = vsubq_u32(_simd_u32(256), sa);
+        rb = vaddq_u32(vmulq_u32(vandq_u32(s, _simd_u32(0xff00ff)), alpha),
+                       vmulq_u32(vandq_u32(d, _simd_u32(0xff00ff)), inv));
+        rb = vandq_u32(vshrq_n_u32(rb, 8), _simd_u32(0xff00ff));
+        g = vaddq_u32(vmulq_u32(vandq_u32(vshrq_n_u32(s, 8), _simd_u32(0xff)), alpha),
+                      vmulq_u32(vandq_u32(vshrq_n_u32(d, 8), _simd_u32(0xff)), inv));
+        g = vandq_u32(g, _simd_u32(0xff00));
+        da = vaddq_u32(sa, _simd_div255(vmulq_u32(vsubq_u32(_simd_u32(255), sa), da)));
+        blend = vorrq_u32(vorrq_u32(rb, g), vshlq_n_u32(da, 24));
+
+        /* the destination is transparent, take the source */
+        blend = _simd_select_eq(vshrq_n_u32(d, 27), 0,
+                                vorrq_u32(vandq_u32(s, _simd_u32(0x00ffffff)), vshlq_n_u32(sa, 24)),
+                                blend);
+        blend = _simd_select_eq(sa, 0, d, blend);
+        blend = _simd_select_eq(sa, 255, s, blend);
+        if (a == 0)
+            blend = s;
+        _simd_store32(dst, blend);
+
+        src += 4;
+        dst += 4;
+    }
+
+    return count;
+}
+#endif
+
 /* 2 bpp to 1 bpp */
 static void rtgui_blit_line_2_1(rt_uint8_t *dst_ptr, rt_uint8_t *src_ptr, int line)
 {
@@ -204,6 +338,14 @@ static void rtgui_blit_line_4_2(rt_uint8_t *dst_ptr, rt_uint8_t *src_ptr, int li
     rt_uint32_t *srcp = (rt_uint32_t *) src_ptr;
     rt_uint16_t *dstp = (rt_uint16_t *) dst_ptr;
 
+#ifdef GUIENGINE_USING_BLIT_SIMD
+    line = _simd_argb8888_to_565(dstp, srcp, width, 255);
+    srcp += line;
+    dstp += line;
+    width -= line;
+    if (width == 0) return;
+#endif
+
     /* *INDENT-OFF* */
     DUFFS_LOOP4(
     {
@@ -380,8 +522,39 @@ static const rt_uint32_t RGB565_RGBA8888_LUT[512] =
     0x001cf6ff, 0xffc20000, 0x001cffff, 0xffe20000,
 };
 
+/* the bits of RGB565 replicated to ARGB8888 */
+#define _BLIT_565_EXPAND(c)                                                 \
+    (0xff000000 | ((c) & 0xf800) << 8 | ((c) & 0xe000) << 3 |               \
+     ((c) & 0x7e0) << 5 | ((c) & 0x600) >> 1 | ((c) & 0x1f) << 3 | ((c) & 0x1c) >> 2)
+
+#if GUIENGINE_BLIT_565_LUT == 2
+/*
+ * The full table is generated by the preprocessor, the hex digits of each
+ * pixel are pasted from the high one.
+ */
+#define _LUT_E(p)   _BLIT_565_EXPAND(p##u),
+#define _LUT_4(p)   _LUT_E(p##0) _LUT_E(p##1) _LUT_E(p##2) _LUT_E(p##3) _LUT_E(p##4) _LUT_E(p##5) \
+                    _LUT_E(p##6) _LUT_E(p##7) _LUT_E(p##8) _LUT_E(p##9) _LUT_E(p##A) _LUT_E(p##B) \
+                    _LUT_E(p##C) _LUT_E(p##D) _LUT_E(p##E) _LUT_E(p##F)
+#define _LUT_3(p)   _LUT_4(p##0) _LUT_4(p##1) _LUT_4(p##2) _LUT_4(p##3) _LUT_4(p##4) _LUT_4(p##5) \
+                    _LUT_4(p##6) _LUT_4(p##7) _LUT_4(p##8) _LUT_4(p##9) _LUT_4(p##A) _LUT_4(p##B) \
+                    _LUT_4(p##C) _LUT_4(p##D) _LUT_4(p##E) _LUT_4(p##F)
+#define _LUT_2(p)   _LUT_3(p##0) _LUT_3(p##1) _LUT_3(p##2) _LUT_3(p##3) _LUT_3(p##4) _LUT_3(p##5) \
+                    _LUT_3(p##6) _LUT_3(p##7) _LUT_3(p##8) _LUT_3(p##9) _LUT_3(p##A) _LUT_3(p##B) \
+                    _LUT_3(p##C) _LUT_3(p##D) _LUT_3(p##E) _LUT_3(p##F)
+#define _LUT_1(p)   _LUT_2(p##0) _LUT_2(p##1) _LUT_2(p##2) _LUT_2(p##3) _LUT_2(p##4) _LUT_2(p##5) \
+                    _LUT_2(p##6) _LUT_2(p##7) _LUT_2(p##8) _LUT_2(p##9) _LUT_2(p##A) _LUT_2(p##B) \
+                    _LUT_2(p##C) _LUT_2(p##D) _LUT_2(p##E) _LUT_2(p##F)
+
+const rt_uint32_t rtgui_blit_565_full[65536] =
+{
+    _LUT_1(0x)
+};
+RTM_EXPORT(rtgui_blit_565_full);
+#endif
+
 /* Special optimized blit for RGB 5-6-5 --> ARGB 8-8-8-8 */
-static const rt_uint32_t RGB565_ARGB8888_LUT[512] =
+const rt_uint32_t rtgui_blit_565_split[512] =
 {
     0x00000000, 0xff000000, 0x00000008, 0xff002000,
     0x00000010, 0xff004000, 0x00000018, 0xff006100,
@@ -927,6 +1100,7 @@ static void BlitRGBtoRGBSurfaceAlpha(struct rtgui_blit_info *info)
     }
 }
 
+#ifndef GUIENGINE_USING_DITHER
 /* fast alpha -> RGB565 blending with pixel alpha */
 static void BlitAlphato565PixelAlpha(struct rtgui_blit_info * info)
 {
@@ -945,7 +1119,7 @@ static void BlitAlphato565PixelAlpha(struct rtgui_blit_info * info)
         int n = info->dst_w;
         while (n--)
         {
-            srcA = (rt_uint8_t)(*src);
+            srcA = RTGUI_COVERAGE(*src);
             if (info->a > 0 && info->a != 255)
                 srcA = srcA * info->a / 255;
             ARGB8888_FROM_RGBA(srcpixel, srcR, srcG, srcB, srcA);
@@ -1014,6 +1188,16 @@ static void BlitARGBto565PixelAlpha(struct rtgui_blit_info * info)
 
     while (height--)
     {
+        int count = width;
+
+#ifdef GUIENGINE_USING_BLIT_SIMD
+        int done = _simd_argb8888_to_565(dstp, srcp, width, info->a);
+
+        srcp += done;
+        dstp += done;
+        count -= done;
+#endif
+        if (count > 0)
         /* *INDENT-OFF* */
         DUFFS_LOOP4(
         {
@@ -1049,12 +1233,13 @@ static void BlitARGBto565PixelAlpha(struct rtgui_blit_info * info)
             }
             srcp++;
             dstp++;
-        }, width);
+        }, count);
         /* *INDENT-ON* */
         srcp += srcskip;
         dstp += dstskip;
     }
 }
+#endif
 
 /* fast ARGB888->(A)RGB888 blending with pixel alpha */
 static void BlitARGBtoRGBPixelAlpha(struct rtgui_blit_info *info)
@@ -1129,7 +1314,7 @@ static void BlitAlphatoARGB8888PixelAlpha(struct rtgui_blit_info *info)
         int n = info->dst_w;
         while (n--)
         {
-            srcA = (rt_uint8_t)(*src);
+            srcA = RTGUI_COVERAGE(*src);
             if (info->a > 0 && info->a != 255)
                 srcA = srcA * info->a / 255;
             ARGB8888_FROM_RGBA(srcpixel, srcR, srcG, srcB, srcA);
@@ -1194,6 +1379,14 @@ static void BlitARGB8888toARGB8888PixelAlpha(struct rtgui_blit_info *info)
         rt_uint32_t *src = (rt_uint32_t *)info->src;
         rt_uint32_t *dst = (rt_uint32_t *)info->dst;
         int n = info->dst_w;
+
+#ifdef GUIENGINE_USING_BLIT_SIMD
+        int done = _simd_argb8888_to_argb8888(dst, src, n, info->a);
+
+        src += done;
+        dst += done;
+        n -= done;
+#endif
         while (n--)
         {
             srcpixel = *src;
@@ -1249,6 +1442,137 @@ static void BlitARGB8888toARGB8888PixelAlpha(struct rtgui_blit_info *info)
     }
 }
 
+/*
+ * The blits with premultiplied alpha source, the destination is
+ * d = s + d * (1 - a), so there is only one multiply for each channel.
+ */
+/* scale the premultiplied pixel by the alpha of blit info */
+rt_inline rt_uint32_t _premul_scale(rt_uint32_t s, unsigned a)
+{
+    a = a + 1;
+    return (((s & 0xff00ff) * a >> 8) & 0xff00ff) | ((((s >> 8) & 0xff00ff) * a) & 0xff00ff00);
+}
+
+rt_inline rt_uint32_t _premul_from_4444(rt_uint16_t p)
+{
+    rt_uint32_t s = p;
+
+    /* expand each 4 bits to 8 bits */
+    return ((s & 0xf000) << 12 | (s & 0x0f00) << 8 | (s & 0x00f0) << 4 | (s & 0x000f)) * 0x11;
+}
+
+rt_inline rt_uint32_t _premul_over(rt_uint32_t s, rt_uint32_t d)
+{
+    unsigned ia = 256 - (s >> 24);
+
+    return s + ((((d & 0xff00ff) * ia) >> 8) & 0xff00ff) + ((((d >> 8) & 0xff00ff) * ia) & 0xff00ff00);
+}
+
+rt_inline rt_uint16_t _premul_over_565(rt_uint32_t s, rt_uint32_t d)
+{
+    unsigned ia = 256 - (s >> 24);
+    rt_uint32_t rb, g;
+
+    /* expand the destination to 8 bits channels */
+    rb = (d & 0xf800) << 8 | (d & 0xe000) << 3 | (d & 0x1f) << 3 | (d & 0x1c) >> 2;
+    g = (d & 0x7e0) << 5 | (d & 0x600) >> 1;
+
+    rb = (s & 0xff00ff) + (((rb * ia) >> 8) & 0xff00ff);
+    g = (s & 0xff00) + (((g * ia) >> 8) & 0xff00);
+
+    return (rt_uint16_t)((rb >> 8 & 0xf800) | (g >> 5 & 0x7e0) | (rb >> 3 & 0x1f));
+}
+
+/* premultiplied ARGB888/ARGB4444 -> RGB565 */
+static void BlitPremulto565PixelAlpha(struct rtgui_blit_info *info)
+{
+    int n;
+    rt_uint32_t s;
+    rt_uint16_t *dst;
+    rt_uint8_t *src;
+    int sbpp = rtgui_color_get_bpp(info->src_fmt);
+
+    while (info->dst_h--)
+    {
+        src = info->src;
+        dst = (rt_uint16_t *)info->dst;
+        n = info->dst_w;
+        while (n--)
+        {
+            if (sbpp == 4)
+                s = *(rt_uint32_t *)src;
+            else
+                s = _premul_from_4444(*(rt_uint16_t *)src);
+            if (info->a > 0 && info->a != 255)
+                s = _premul_scale(s, info->a);
+
+            if (s >> 24 == 255)
+                *dst = (rt_uint16_t)((s >> 8 & 0xf800) + (s >> 5 & 0x7e0) + (s >> 3 & 0x1f));
+            else if (s >> 24)
+                *dst = _premul_over_565(s, *dst);
+
+            src += sbpp;
+            dst ++;
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+/* premultiplied ARGB888/ARGB4444 -> RGB888, ARGB888 or premultiplied ARGB888 */
+static void BlitPremultoARGB8888PixelAlpha(struct rtgui_blit_info *info)
+{
+    int n;
+    rt_uint32_t s, d;
+    rt_uint32_t *dst;
+    rt_uint8_t *src;
+    int sbpp = rtgui_color_get_bpp(info->src_fmt);
+
+    while (info->dst_h--)
+    {
+        src = info->src;
+        dst = (rt_uint32_t *)info->dst;
+        n = info->dst_w;
+        while (n--)
+        {
+            if (sbpp == 4)
+                s = *(rt_uint32_t *)src;
+            else
+                s = _premul_from_4444(*(rt_uint16_t *)src);
+            if (info->a > 0 && info->a != 255)
+                s = _premul_scale(s, info->a);
+
+            if (s >> 24 == 255)
+            {
+                *dst = s;
+            }
+            else if (s >> 24)
+            {
+                d = *dst;
+                if (info->dst_fmt == RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE || d >> 24 == 255)
+                {
+                    *dst = _premul_over(s, d);
+                }
+                else if (info->dst_fmt == RTGRAPHIC_PIXEL_FORMAT_RGB888)
+                {
+                    *dst = (_premul_over(s, d | 0xff000000) & 0x00ffffff) | (d & 0xff000000);
+                }
+                else
+                {
+                    /* the straight alpha destination is not opaque */
+                    d = rtgui_color_premultiply(d);
+                    *dst = rtgui_color_unpremultiply(_premul_over(s, d));
+                }
+            }
+
+            src += sbpp;
+            dst ++;
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
 /* Special optimized blit for RGB 5-6-5 --> 32-bit RGB surfaces */
 #define RGB565_32(dst, src, map) (map[src[LO]*2] + map[src[HI]*2+1])
 static void
@@ -1285,11 +1609,362 @@ BlitRGB565to32(struct rtgui_blit_info *info, const rt_uint32_t *map)
 static void
 BlitRGB565toARGB8888(struct rtgui_blit_info * info)
 {
-    BlitRGB565to32(info, RGB565_ARGB8888_LUT);
+    BlitRGB565to32(info, rtgui_blit_565_split);
+}
+
+/*
+ * The blit kernels are generated from the templates for each pair of pixel
+ * format and each blend mode, so the compiler sees the constant formats. A
+ * new format only needs its _BLIT_BPP/_BLIT_LOAD/_BLIT_STORE macros and an
+ * entry in the format lists below.
+ *
+ * The blend mode comes from the alpha of blit info:
+ *   COPY  - alpha is 0, copy the source without blending
+ *   BLEND - alpha is 255, blend with the pixel alpha
+ *   MOD   - otherwise, blend with the pixel alpha modulated by the alpha
+ */
+#define _BLIT_SRC_LIST(X, arg)  \
+    X(RGB565, arg) X(RGB888, arg) X(ARGB888, arg) X(ARGB888_PRE, arg) X(ARGB4444_PRE, arg) X(ALPHA, arg) \
+    X(L8, arg) X(P8, arg) X(ARGB4444, arg) X(RGB332, arg)
+#define _BLIT_DST_LIST(X, arg)  \
+    X(RGB565, arg) X(RGB888, arg) X(ARGB888, arg) X(ARGB888_PRE, arg) X(ARGB4444, arg) X(RGB332, arg)
+
+#define _BLIT_BPP_RGB565            2
+#define _BLIT_BPP_RGB888            3
+#define _BLIT_BPP_ARGB888           4
+#define _BLIT_BPP_ARGB888_PRE       4
+#define _BLIT_BPP_ARGB4444_PRE      2
+#define _BLIT_BPP_ALPHA             1
+#define _BLIT_BPP_L8                1
+#define _BLIT_BPP_P8                1
+#define _BLIT_BPP_ARGB4444          2
+#define _BLIT_BPP_RGB332            1
+
+/* load a pixel as straight ARGB8888 */
+#define _BLIT_LOAD_RGB565(p, info)          _blit_from_565(*(rt_uint16_t *)(p))
+#define _BLIT_LOAD_RGB888(p, info)          RTGUI_RGB((p)[2], (p)[1], (p)[0])
+#define _BLIT_LOAD_ARGB888(p, info)         (*(rt_uint32_t *)(p))
+#define _BLIT_LOAD_ARGB888_PRE(p, info)     rtgui_color_unpremultiply(*(rt_uint32_t *)(p))
+#define _BLIT_LOAD_ARGB4444_PRE(p, info)    rtgui_color_unpremultiply(_premul_from_4444(*(rt_uint16_t *)(p)))
+#define _BLIT_LOAD_ALPHA(p, info)           RTGUI_ARGB(RTGUI_COVERAGE(*(p)), (info)->r, (info)->g, (info)->b)
+#define _BLIT_LOAD_L8(p, info)              RTGUI_RGB(*(p), *(p), *(p))
+#define _BLIT_LOAD_P8(p, info)              ((info)->palette[*(p)])
+#define _BLIT_LOAD_ARGB4444(p, info)        rtgui_color_from_4444(*(rt_uint16_t *)(p))
+#define _BLIT_LOAD_RGB332(p, info)          rtgui_color_from_332(*(p))
+
+/* store a straight ARGB8888 pixel */
+#define _BLIT_STORE_RGB565(p, c)            (*(rt_uint16_t *)(p) = rtgui_color_to_565(c))
+#define _BLIT_STORE_RGB888(p, c)            ((p)[0] = RTGUI_RGB_B(c), (p)[1] = RTGUI_RGB_G(c), (p)[2] = RTGUI_RGB_R(c))
+#define _BLIT_STORE_ARGB888(p, c)           (*(rt_uint32_t *)(p) = (c))
+#define _BLIT_STORE_ARGB888_PRE(p, c)       (*(rt_uint32_t *)(p) = rtgui_color_premultiply(c))
+#define _BLIT_STORE_ARGB4444(p, c)          (*(rt_uint16_t *)(p) = rtgui_color_to_4444(c))
+#define _BLIT_STORE_RGB332(p, c)            (*(p) = rtgui_color_to_332(c))
+
+/* the sources deeper than RGB565, which are dithered on RGB565 */
+#define _BLIT_DEEP_RGB565                   0
+#define _BLIT_DEEP_RGB888                   1
+#define _BLIT_DEEP_ARGB888                  1
+#define _BLIT_DEEP_ARGB888_PRE              1
+#define _BLIT_DEEP_ARGB4444_PRE             0
+#define _BLIT_DEEP_ALPHA                    1
+#define _BLIT_DEEP_L8                       1
+#define _BLIT_DEEP_P8                       1
+#define _BLIT_DEEP_ARGB4444                 0
+#define _BLIT_DEEP_RGB332                   0
+
+/*
+ * The ordered dither of a pixel stored to RGB565. The pattern is anchored at
+ * the address of pixel (the row is the address over the pitch), so it's
+ * continuous across the blits of clip rects on the same framebuffer.
+ */
+#ifdef GUIENGINE_USING_DITHER
+#define _BLIT_DITHER_ROW_RGB565(p, info)    unsigned _row = (unsigned)((rt_ubase_t)(p) / (info)->dst_pitch);
+#define _BLIT_DITHER_RGB565(c, p)           rtgui_color_dither_565(c, (int)((rt_ubase_t)(p) >> 1), _row)
+#else
+#define _BLIT_DITHER_ROW_RGB565(p, info)
+#define _BLIT_DITHER_RGB565(c, p)           (c)
+#endif
+#define _BLIT_DITHER_ROW_RGB888(p, info)
+#define _BLIT_DITHER_ROW_ARGB888(p, info)
+#define _BLIT_DITHER_ROW_ARGB888_PRE(p, info)
+#define _BLIT_DITHER_ROW_ARGB4444(p, info)
+#define _BLIT_DITHER_ROW_RGB332(p, info)
+#define _BLIT_DITHER_RGB888(c, p)           (c)
+#define _BLIT_DITHER_ARGB888(c, p)          (c)
+#define _BLIT_DITHER_ARGB888_PRE(c, p)      (c)
+#define _BLIT_DITHER_ARGB4444(c, p)         (c)
+#define _BLIT_DITHER_RGB332(c, p)           (c)
+#define _BLIT_DITHER(SRC, DST, c, p)        (_BLIT_DEEP_##SRC ? _BLIT_DITHER_##DST(c, p) : (c))
+
+/* the alpha used to blend the pixel */
+#define _BLIT_ALPHA_COPY(s, info)           255
+#define _BLIT_ALPHA_BLEND(s, info)          RTGUI_RGB_A(s)
+#define _BLIT_ALPHA_MOD(s, info)            _blit_div255(RTGUI_RGB_A(s) * (info)->a)
+
+/* x / 255 for x in [0, 255 * 255] */
+rt_inline unsigned _blit_div255(unsigned x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+rt_inline rtgui_color_t _blit_from_565(rt_uint16_t p)
+{
+#ifdef RTGUI_BLIT_FROM_565
+    return RTGUI_BLIT_FROM_565(p);
+#else
+    rt_uint32_t c = p;
+
+    return _BLIT_565_EXPAND(c);
+#endif
+}
+
+/* blend the straight source on destination with alpha */
+rt_inline rtgui_color_t _blit_blend(rtgui_color_t s, rtgui_color_t d, unsigned a)
+{
+    rt_uint32_t rb, g, da;
+
+    rb = d & 0xff00ff;
+    rb = (rb + (((s & 0xff00ff) - rb) * a >> 8)) & 0xff00ff;
+    g = d & 0xff00;
+    g = (g + (((s & 0xff00) - g) * a >> 8)) & 0xff00;
+    da = a + _blit_div255((255 - a) * RTGUI_RGB_A(d));
+
+    return (da << 24) | rb | g;
+}
+
+#define _BLIT_KERNEL(SRC, DST, MODE)                                        \
+rt_inline void _blit_##SRC##_##DST##_##MODE(struct rtgui_blit_info *info)   \
+{                                                                           \
+    int n;                                                                  \
+    unsigned a;                                                             \
+    rtgui_color_t s;                                                        \
+    rt_uint8_t *src, *dst;                                                  \
+                                                                            \
+    while (info->dst_h--)                                                   \
+    {                                                                       \
+        _BLIT_DITHER_ROW_##DST(info->dst, info)                             \
+        src = info->src;                                                    \
+        dst = info->dst;                                                    \
+        for (n = info->dst_w; n > 0; n --)                                  \
+        {                                                                   \
+            s = _BLIT_LOAD_##SRC(src, info);                                \
+            a = _BLIT_ALPHA_##MODE(s, info);                                \
+            if (a == 255)                                                   \
+                _BLIT_STORE_##DST(dst, _BLIT_DITHER(SRC, DST, s, dst));     \
+            else if (a != 0)                                                \
+                _BLIT_STORE_##DST(dst, _BLIT_DITHER(SRC, DST,               \
+                                  _blit_blend(s, _BLIT_LOAD_##DST(dst, info), a), dst)); \
+                                                                            \
+            src += _BLIT_BPP_##SRC;                                         \
+            dst += _BLIT_BPP_##DST;                                         \
+        }                                                                   \
+        info->src += info->src_pitch;                                       \
+        info->dst += info->dst_pitch;                                       \
+    }                                                                       \
+}
+
+#define _BLIT_DEFINE_DST(DST, SRC)  \
+    _BLIT_KERNEL(SRC, DST, COPY) _BLIT_KERNEL(SRC, DST, BLEND) _BLIT_KERNEL(SRC, DST, MOD)
+#define _BLIT_DEFINE_SRC(SRC, arg)  _BLIT_DST_LIST(_BLIT_DEFINE_DST, SRC)
+_BLIT_SRC_LIST(_BLIT_DEFINE_SRC, _)
+
+/*
+ * The hand optimized blits take the place of the generated ones. They handle
+ * all the blend modes in themselves.
+ */
+#define _blit_RGB565_RGB565_COPY                 Blit565to565PixelAlpha
+#define _blit_RGB565_RGB565_BLEND                Blit565to565PixelAlpha
+#define _blit_RGB565_RGB565_MOD                  Blit565to565PixelAlpha
+#define _blit_RGB565_ARGB888_COPY                BlitRGB565toARGB8888
+#define _blit_RGB565_ARGB888_BLEND               BlitRGB565toARGB8888
+#define _blit_RGB565_ARGB888_MOD                 BlitRGB565toARGB8888
+#define _blit_RGB888_ARGB888_COPY                BlitRGBtoRGBSurfaceAlpha
+#define _blit_RGB888_ARGB888_BLEND               BlitRGBtoRGBSurfaceAlpha
+#define _blit_RGB888_ARGB888_MOD                 BlitRGBtoRGBSurfaceAlpha
+#ifndef GUIENGINE_USING_DITHER
+/* the sources deeper than RGB565 are dithered by the generated ones */
+#define _blit_ARGB888_RGB565_COPY                BlitARGBto565PixelAlpha
+#define _blit_ARGB888_RGB565_BLEND               BlitARGBto565PixelAlpha
+#define _blit_ARGB888_RGB565_MOD                 BlitARGBto565PixelAlpha
+#endif
+#define _blit_ARGB888_RGB888_COPY                BlitARGBtoRGBPixelAlpha
+#define _blit_ARGB888_RGB888_BLEND               BlitARGBtoRGBPixelAlpha
+#define _blit_ARGB888_RGB888_MOD                 BlitARGBtoRGBPixelAlpha
+#define _blit_ARGB888_ARGB888_COPY               BlitARGB8888toARGB8888PixelAlpha
+#define _blit_ARGB888_ARGB888_BLEND              BlitARGB8888toARGB8888PixelAlpha
+#define _blit_ARGB888_ARGB888_MOD                BlitARGB8888toARGB8888PixelAlpha
+#ifndef GUIENGINE_USING_DITHER
+#define _blit_ARGB888_PRE_RGB565_COPY            BlitPremulto565PixelAlpha
+#define _blit_ARGB888_PRE_RGB565_BLEND           BlitPremulto565PixelAlpha
+#define _blit_ARGB888_PRE_RGB565_MOD             BlitPremulto565PixelAlpha
+#endif
+#define _blit_ARGB888_PRE_RGB888_COPY            BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_RGB888_BLEND           BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_RGB888_MOD             BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_ARGB888_COPY           BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_ARGB888_BLEND          BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_ARGB888_MOD            BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_ARGB888_PRE_COPY       BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_ARGB888_PRE_BLEND      BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB888_PRE_ARGB888_PRE_MOD        BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_RGB565_COPY           BlitPremulto565PixelAlpha
+#define _blit_ARGB4444_PRE_RGB565_BLEND          BlitPremulto565PixelAlpha
+#define _blit_ARGB4444_PRE_RGB565_MOD            BlitPremulto565PixelAlpha
+#define _blit_ARGB4444_PRE_RGB888_COPY           BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_RGB888_BLEND          BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_RGB888_MOD            BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_ARGB888_COPY          BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_ARGB888_BLEND         BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_ARGB888_MOD           BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_ARGB888_PRE_COPY      BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_ARGB888_PRE_BLEND     BlitPremultoARGB8888PixelAlpha
+#define _blit_ARGB4444_PRE_ARGB888_PRE_MOD       BlitPremultoARGB8888PixelAlpha
+#ifndef GUIENGINE_USING_DITHER
+#define _blit_ALPHA_RGB565_COPY                  BlitAlphato565PixelAlpha
+#define _blit_ALPHA_RGB565_BLEND                 BlitAlphato565PixelAlpha
+#define _blit_ALPHA_RGB565_MOD                   BlitAlphato565PixelAlpha
+#endif
+#define _blit_ALPHA_ARGB888_COPY                 BlitAlphatoARGB8888PixelAlpha
+#define _blit_ALPHA_ARGB888_BLEND                BlitAlphatoARGB8888PixelAlpha
+#define _blit_ALPHA_ARGB888_MOD                  BlitAlphatoARGB8888PixelAlpha
+
+typedef void (*_blit_func)(struct rtgui_blit_info *info);
+
+#define _BLIT_SRC_INDEX(F, arg)     _BLIT_SRC_##F,
+#define _BLIT_DST_INDEX(F, arg)     _BLIT_DST_##F,
+enum { _BLIT_SRC_LIST(_BLIT_SRC_INDEX, _) _BLIT_SRC_NUM };
+enum { _BLIT_DST_LIST(_BLIT_DST_INDEX, _) _BLIT_DST_NUM };
+
+/* the kernels to the formats not drawn with GUIENGINE_FIXED_PIXEL_FORMAT are dropped */
+#define _BLIT_ENTRY_FUNC(DST, func) RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_##DST, func)
+#define _BLIT_ENTRY_DST(DST, SRC)   { _BLIT_ENTRY_FUNC(DST, _blit_##SRC##_##DST##_COPY),    \
+                                      _BLIT_ENTRY_FUNC(DST, _blit_##SRC##_##DST##_BLEND),   \
+                                      _BLIT_ENTRY_FUNC(DST, _blit_##SRC##_##DST##_MOD) },
+#define _BLIT_ENTRY_SRC(SRC, arg)   { _BLIT_DST_LIST(_BLIT_ENTRY_DST, SRC) },
+static const _blit_func _blit_table_fmt[_BLIT_SRC_NUM][_BLIT_DST_NUM][3] =
+{
+    _BLIT_SRC_LIST(_BLIT_ENTRY_SRC, _)
+};
+
+#define _BLIT_SRC_CASE(F, arg)      case RTGRAPHIC_PIXEL_FORMAT_##F: return _BLIT_SRC_##F;
+#define _BLIT_DST_CASE(F, arg)      case RTGRAPHIC_PIXEL_FORMAT_##F: \
+                                        return RTGUI_PIXEL_FORMAT_DRAWN(RTGRAPHIC_PIXEL_FORMAT_##F) ? _BLIT_DST_##F : -1;
+static int _blit_src_index(rt_uint8_t fmt)
+{
+    switch (fmt)
+    {
+    _BLIT_SRC_LIST(_BLIT_SRC_CASE, _)
+    }
+    return -1;
+}
+
+static int _blit_dst_index(rt_uint8_t fmt)
+{
+    switch (fmt)
+    {
+    _BLIT_DST_LIST(_BLIT_DST_CASE, _)
+    }
+    return -1;
+}
+
+/* the A4 pixels are expanded to A8 in pieces, which are blended by the A8 kernel */
+#define _BLIT_A4_PIECE      64
+static void _blit_a4(struct rtgui_blit_info *info, _blit_func func)
+{
+    int x, n, index, dst_bpp;
+    rt_uint8_t piece[_BLIT_A4_PIECE];
+    rt_uint8_t *src;
+    struct rtgui_blit_info part;
+
+    dst_bpp = rtgui_color_get_bpp(info->dst_fmt);
+    part = *info;
+    part.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ALPHA;
+    part.src = piece;
+
+    while (info->dst_h--)
+    {
+        for (x = 0; x < info->dst_w; x += n)
+        {
+            n = _UI_MIN(info->dst_w - x, _BLIT_A4_PIECE);
+
+            /* the piece starts at the high nibble */
+            src = info->src + (x >> 1);
+            for (index = 0; index < n; index ++)
+                piece[index] = ((src[index >> 1] >> ((index & 1) ? 0 : 4)) & 0x0f) * 0x11;
+
+            part.src = piece;
+            part.src_w = part.dst_w = n;
+            part.src_h = part.dst_h = 1;
+            part.src_pitch = n;
+            part.src_skip = 0;
+            part.dst = info->dst + x * dst_bpp;
+            part.dst_skip = part.dst_pitch - n * dst_bpp;
+            func(&part);
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+/*
+ * The tinted source is loaded to ARGB8888 in pieces, and the colors of them
+ * are modulated by r, g, b of info. Then the pieces are blended by the
+ * ARGB8888 kernel, the alpha of info is the opacity as the other blits.
+ */
+#define _BLIT_LOAD_CASE(SRC, arg)                                   \
+    case _BLIT_SRC_##SRC:                                           \
+        for (index = 0; index < n; index ++)                        \
+            piece[index] = _BLIT_LOAD_##SRC(src + index * _BLIT_BPP_##SRC, info); \
+        break;
+static void _blit_tint(struct rtgui_blit_info *info, int src_index, _blit_func func)
+{
+    int x, n, index, src_bpp, dst_bpp;
+    rt_uint32_t piece[_BLIT_A4_PIECE], c;
+    rt_uint8_t *src;
+    struct rtgui_blit_info part;
+
+    src_bpp = rtgui_color_get_bpp(info->src_fmt);
+    dst_bpp = rtgui_color_get_bpp(info->dst_fmt);
+    part = *info;
+    part.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ARGB888;
+
+    while (info->dst_h--)
+    {
+        for (x = 0; x < info->dst_w; x += n)
+        {
+            n = _UI_MIN(info->dst_w - x, _BLIT_A4_PIECE);
+
+            src = info->src + x * src_bpp;
+            switch (src_index)
+            {
+            _BLIT_SRC_LIST(_BLIT_LOAD_CASE, _)
+            }
+            for (index = 0; index < n; index ++)
+            {
+                c = piece[index];
+                piece[index] = RTGUI_ARGB(RTGUI_RGB_A(c), _blit_div255(RTGUI_RGB_R(c) * info->r),
+                                          _blit_div255(RTGUI_RGB_G(c) * info->g),
+                                          _blit_div255(RTGUI_RGB_B(c) * info->b));
+            }
+
+            part.src = (rt_uint8_t *)piece;
+            part.src_w = part.dst_w = n;
+            part.src_h = part.dst_h = 1;
+            part.src_pitch = n * 4;
+            part.src_skip = 0;
+            part.dst = info->dst + x * dst_bpp;
+            part.dst_skip = part.dst_pitch - n * dst_bpp;
+            func(&part);
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
 }
 
 void rtgui_blit(struct rtgui_blit_info * info)
 {
+    int src_index, dst_index, mode;
+
     if (info->src_h == 0 ||
             info->src_w == 0 ||
             info->dst_h == 0 ||
@@ -1313,49 +1988,155 @@ void rtgui_blit(struct rtgui_blit_info * info)
     if (info->src_h < info->dst_h)
         info->dst_h = info->src_h;
 
-    if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+    RTGUI_OVERDRAW_BLIT(info);
+    RTGUI_TRACE_BEGIN("blit", info->dst_w * info->dst_h);
+    /* let the 2D accelerator do it if the driver has, it does not tint */
+    if (!info->tint && rtgui_graphic_driver_accel_blit(info) == RT_EOK)
     {
-        if (info->dst_fmt == RTGRAPHIC_PIXEL_FORMAT_RGB565)
-            Blit565to565PixelAlpha(info);
-        else if (info->dst_fmt == RTGRAPHIC_PIXEL_FORMAT_ARGB888)
-            BlitRGB565toARGB8888(info);
+        RTGUI_TRACE_END("blit");
+        return;
     }
-    else if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_ARGB888)
+    rtgui_graphic_driver_accel_sync();
+
+    src_index = _blit_src_index(info->src_fmt);
+    dst_index = _blit_dst_index(info->dst_fmt);
+    /* the palette is expanded in the blit, P8 without palette is not drawn */
+    if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_P8 && info->palette == RT_NULL)
+        src_index = -1;
+    if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_A4)
+        src_index = _BLIT_SRC_ALPHA;
+    if (src_index >= 0 && dst_index >= 0)
     {
-        switch (info->dst_fmt)
-        {
-        case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-            BlitARGBto565PixelAlpha(info);
-            break;
-        case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-            BlitARGBtoRGBPixelAlpha(info);
-            break;
-        case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-            BlitARGB8888toARGB8888PixelAlpha(info);
-            break;
-        }
+        if (info->a == 0)
+            mode = 0;
+        else if (info->a == 255)
+            mode = 1;
+        else
+            mode = 2;
+
+        if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_A4)
+            _blit_a4(info, _blit_table_fmt[src_index][dst_index][mode]);
+        else if (info->tint && src_index != _BLIT_SRC_ALPHA)
+            _blit_tint(info, src_index, _blit_table_fmt[_BLIT_SRC_ARGB888][dst_index][mode]);
+        else
+            _blit_table_fmt[src_index][dst_index][mode](info);
     }
-    else if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_RGB888)
+    RTGUI_TRACE_END("blit");
+}
+RTM_EXPORT(rtgui_blit);
+
+/* copy the rect of pixels from the place (-dx, -dy) away */
+static void _blit_copy_rect(rt_uint8_t *pixels, int pitch, rt_uint8_t format,
+                            rtgui_rect_t *rect, int dx, int dy)
+{
+    int bpp, len, h;
+    rt_uint8_t *src, *dst;
+
+    bpp = rtgui_color_get_bpp(format);
+    len = rtgui_rect_width(*rect) * bpp;
+    h = rtgui_rect_height(*rect);
+    dst = pixels + rect->y1 * pitch + rect->x1 * bpp;
+    src = dst - dy * pitch - dx * bpp;
+
+    /* the accelerator copies the rect not overlapped with its source */
+    if (dx >= rtgui_rect_width(*rect) || -dx >= rtgui_rect_width(*rect) ||
+            dy >= h || -dy >= h)
+    {
+        struct rtgui_blit_info info;
+
+        info.src = src;
+        info.src_w = info.dst_w = rtgui_rect_width(*rect);
+        info.src_h = info.dst_h = h;
+        info.src_pitch = info.dst_pitch = pitch;
+        info.src_skip = info.dst_skip = pitch - len;
+        info.dst = dst;
+        info.src_fmt = info.dst_fmt = format;
+        info.r = info.g = info.b = 0;
+        info.a = 255;
+        if (rtgui_graphic_driver_accel_blit(&info) == RT_EOK)
+            return;
+    }
+    rtgui_graphic_driver_accel_sync();
+
+    /* the rows are copied from the bottom when moving down */
+    if (dy > 0)
+    {
+        src += (h - 1) * pitch;
+        dst += (h - 1) * pitch;
+        pitch = -pitch;
+    }
+    while (h--)
+    {
+        rt_memmove(dst, src, len);
+        src += pitch;
+        dst += pitch;
+    }
+}
+
+/* the rects in a band are copied from the right when moving right */
+static void _blit_copy_band(rt_uint8_t *pixels, int pitch, rt_uint8_t format,
+                            rtgui_rect_t *rects, int num, int dx, int dy)
+{
+    int index;
+
+    if (dx > 0)
+    {
+        for (index = num - 1; index >= 0; index --)
+            _blit_copy_rect(pixels, pitch, format, &rects[index], dx, dy);
+    }
+    else
+    {
+        for (index = 0; index < num; index ++)
+            _blit_copy_rect(pixels, pitch, format, &rects[index], dx, dy);
+    }
+}
+
+/*
+ * Copy the region of pixels from the place (-dx, -dy) away, the source and
+ * the destination may be overlapped. The rects of region are in the bands
+ * from top to bottom, and from left to right in a band. They are copied in
+ * the order that no source is overwritten before it's copied, so the bands
+ * are copied from the bottom when moving down. The 2D accelerator copies the
+ * rect in framebuffer not overlapped with its source.
+ */
+void rtgui_blit_copy_region(rt_uint8_t *pixels, int pitch, rt_uint8_t format,
+                            rtgui_region_t *region, int dx, int dy)
+{
+    int num, start, end;
+    rtgui_rect_t *rects;
+
+    num = rtgui_region_num_rects(region);
+    rects = rtgui_region_rects(region);
+
+    if (dy > 0)
     {
-        if (info->dst_fmt == RTGRAPHIC_PIXEL_FORMAT_ARGB888)
-            BlitRGBtoRGBSurfaceAlpha(info);
+        for (end = num; end > 0; end = start)
+        {
+            for (start = end - 1; start > 0 && rects[start - 1].y1 == rects[end - 1].y1; start --);
+            _blit_copy_band(pixels, pitch, format, &rects[start], end - start, dx, dy);
+        }
     }
-    else if (info->src_fmt == RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+    else
     {
-        switch (info->dst_fmt)
+        for (start = 0; start < num; start = end)
         {
-        case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-            BlitAlphato565PixelAlpha(info);
-            break;
-        case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-            break;
-        case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-            BlitAlphatoARGB8888PixelAlpha(info);
-            break;
+            for (end = start + 1; end < num && rects[end].y1 == rects[start].y1; end ++);
+            _blit_copy_band(pixels, pitch, format, &rects[start], end - start, dx, dy);
         }
     }
 }
-RTM_EXPORT(rtgui_blit);
+RTM_EXPORT(rtgui_blit_copy_region);
+
+rt_inline void _blit_info_tint(struct rtgui_blit_info *info, rtgui_color_t tint)
+{
+    if ((tint & 0xffffff) == (RTGUI_BLIT_NO_TINT & 0xffffff))
+        return;
+
+    info->tint = 1;
+    info->r = RTGUI_RGB_R(tint);
+    info->g = RTGUI_RGB_G(tint);
+    info->b = RTGUI_RGB_B(tint);
+}
 
 void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc, struct rtgui_rect *dc_rect)
 {
@@ -1389,6 +2170,7 @@ void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc,
 
         /* fill common info */
         info.a = image->a;
+        _blit_info_tint(&info, image->tint);
         info.src_fmt = image->src_fmt;
         info.src_pitch = image->src_pitch;
 
@@ -1431,6 +2213,7 @@ void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc,
 
         /* fill common info */
         info.a = image->a;
+        _blit_info_tint(&info, image->tint);
         info.src_fmt = image->src_fmt;
         info.src_pitch = image->src_pitch;
 
@@ -1455,6 +2238,12 @@ void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc,
     {
         struct rtgui_rect *r;
         struct rtgui_dc_buffer *dc_buffer = (struct rtgui_dc_buffer*)dc;
+        rt_uint8_t *pixel;
+
+        /* the pixels of buffer may be shared, own them to be written */
+        pixel = rtgui_dc_buffer_get_pixel(dc);
+        if (pixel == RT_NULL)
+            return;
 
         bpp = rtgui_color_get_bpp(image->src_fmt);
         hw_bpp = rtgui_color_get_bpp(dc_buffer->pixel_format);
@@ -1463,6 +2252,7 @@ void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc,
 
         /* fill common info */
         info.a = image->a;
+        _blit_info_tint(&info, image->tint);
         info.src_fmt = image->src_fmt;
         info.src_pitch = image->src_pitch;
 
@@ -1476,7 +2266,7 @@ void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc,
         info.src_skip = info.src_pitch - info.src_w * bpp;
 
         /* blit destination */
-        info.dst = (rt_uint8_t*)dc_buffer->pixel + r->y1 * dc_buffer->pitch + r->x1 * hw_bpp;
+        info.dst = pixel + r->y1 * dc_buffer->pitch + r->x1 * hw_bpp;
         info.dst_w = rtgui_rect_width(*r);
         info.dst_h = rtgui_rect_height(*r);
         info.dst_skip = info.dst_pitch - info.dst_w * hw_bpp;
@@ -1485,3 +2275,371 @@ void rtgui_image_info_blit(struct rtgui_image_info *image, struct rtgui_dc *dc,
     }
 }
 RTM_EXPORT(rtgui_image_info_blit);
+
+/*
+ * The YUV frames of camera or video in BT.601 video range, for the driver
+ * without an overlay plane. A row of source is converted to ARGB8888 once and
+ * kept for the next rows of destination, then scaled and stored in the pixel
+ * format of destination.
+ */
+#define _YUV_SHIFT      16
+#define _YUV_ONE        (1 << _YUV_SHIFT)
+
+struct _yuv_scaler
+{
+    const struct rtgui_yuv_info *yuv;
+    int dst_w, dst_h;
+    int step_x, step_y;
+
+    /* the source rows converted, row[i] is the line of source row index[i] */
+    rt_uint32_t *row[2];
+    int index[2];
+    rt_uint32_t *line;
+};
+
+rt_inline int _yuv_clamp(int v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+rt_inline rt_uint32_t _yuv_to_argb(int y, int u, int v)
+{
+    int r, g, b;
+
+    y = (y - 16) * 298 + 128;
+    u -= 128;
+    v -= 128;
+    r = _yuv_clamp((y + 409 * v) >> 8);
+    g = _yuv_clamp((y - 100 * u - 208 * v) >> 8);
+    b = _yuv_clamp((y + 516 * u) >> 8);
+
+    return 0xff000000 | (r << 16) | (g << 8) | b;
+}
+
+#ifdef GUIENGINE_USING_BLIT_SIMD
+#ifdef GUIENGINE_USING_BLIT_NEON
+/* 4 bytes to the lanes, 8 bytes are read */
+#define _simd_load8(p)                  vmovl_u16(vget_low_u16(vmovl_u8(vld1_u8(p))))
+#else
+#define _simd_load8(p)                  vldrbq_u32(p)
+#endif
+#define _simd_s32(n)                    vdupq_n_s32(n)
+#define _simd_clamp255(v)               vminq_s32(vmaxq_s32(v, _simd_s32(0)), _simd_s32(255))
+
+/* the planar Y of a row, the chroma of each 2 pixels is in the lanes twice */
+static int _simd_yuv_to_argb(rt_uint32_t *dst, const rt_uint8_t *y, const rt_uint8_t *u,
+                             const rt_uint8_t *v, int cstep, int n)
+{
+    int index, count;
+    rt_uint32_t uv[8];
+    int32x4_t sy, su, sv, r, g, b;
+
+    /* the Y of 8 bytes is read for 4 pixels */
+    count = n > 4 ? (n - 4) & ~3 : 0;
+    for (index = 0; index < count; index += 4)
+    {
+        uv[0] = uv[1] = u[0];
+        uv[2] = uv[3] = u[cstep];
+        uv[4] = uv[5] = v[0];
+        uv[6] = uv[7] = v[cstep];
+
+        sy = vreinterpretq_s32_u32(_simd_load8(y));
+        sy = vaddq_s32(vmulq_s32(vsubq_s32(sy, _simd_s32(16)), _simd_s32(298)), _simd_s32(128));
+        su = vsubq_s32(vreinterpretq_s32_u32(_simd_load32(&uv[0])), _simd_s32(128));
+        sv = vsubq_s32(vreinterpretq_s32_u32(_simd_load32(&uv[4])), _simd_s32(128));
+
+        r = vaddq_s32(sy, vmulq_s32(sv, _simd_s32(409)));
+        g = vsubq_s32(sy, vaddq_s32(vmulq_s32(su, _simd_s32(100)), vmulq_s32(sv, _simd_s32(208))));
+        b = vaddq_s32(sy, vmulq_s32(su, _simd_s32(516)));
+        r = _simd_clamp255(vshrq_n_s32(r, 8));
+        g = _simd_clamp255(vshrq_n_s32(g, 8));
+        b = _simd_clamp255(vshrq_n_s32(b, 8));
+
+        _simd_store32(dst, vorrq_u32(vorrq_u32(vshlq_n_u32(vreinterpretq_u32_s32(r), 16),
+                                               vshlq_n_u32(vreinterpretq_u32_s32(g), 8)),
+                                     vorrq_u32(vreinterpretq_u32_s32(b), _simd_u32(0xff000000))));
+
+        y += 4;
+        u += 2 * cstep;
+        v += 2 * cstep;
+        dst += 4;
+    }
+
+    return count;
+}
+#endif
+
+/* convert the source row to ARGB8888 */
+static void _yuv_row(const struct rtgui_yuv_info *yuv, int row, rt_uint32_t *dst)
+{
+    int x, ystep, cstep, cpitch;
+    const rt_uint8_t *y, *u, *v;
+
+    y = yuv->pixels + row * yuv->pitch;
+    switch (yuv->format)
+    {
+    case RTGUI_OVERLAY_FMT_YUYV:
+        ystep = 2;
+        cstep = 4;
+        u = y + 1;
+        v = y + 3;
+        break;
+    case RTGUI_OVERLAY_FMT_NV12:
+        ystep = 1;
+        cstep = 2;
+        u = yuv->pixels + yuv->h * yuv->pitch + (row >> 1) * yuv->pitch;
+        v = u + 1;
+        break;
+    default:
+        /* I420, the U and V planes of half pitch */
+        ystep = 1;
+        cstep = 1;
+        cpitch = yuv->pitch / 2;
+        u = yuv->pixels + yuv->h * yuv->pitch + (row >> 1) * cpitch;
+        v = u + ((yuv->h + 1) >> 1) * cpitch;
+        break;
+    }
+
+    x = 0;
+#ifdef GUIENGINE_USING_BLIT_SIMD
+    if (ystep == 1)
+    {
+        x = _simd_yuv_to_argb(dst, y, u, v, cstep, yuv->w);
+        y += x;
+        u += (x >> 1) * cstep;
+        v += (x >> 1) * cstep;
+    }
+#endif
+    for (; x < yuv->w; x ++)
+    {
+        *dst++ = _yuv_to_argb(*y, *u, *v);
+        y += ystep;
+        if (x & 1)
+        {
+            u += cstep;
+            v += cstep;
+        }
+    }
+}
+
+/* the interpolation of two ARGB8888 in the weight of c1 (0 - 256) */
+rt_inline rt_uint32_t _yuv_lerp(rt_uint32_t c0, rt_uint32_t c1, unsigned w)
+{
+    rt_uint32_t rb, g;
+
+    rb = (((c0 & 0xff00ff) * (256 - w) + (c1 & 0xff00ff) * w) >> 8) & 0xff00ff;
+    g = (((c0 & 0xff00) * (256 - w) + (c1 & 0xff00) * w) >> 8) & 0xff00;
+
+    return 0xff000000 | rb | g;
+}
+
+static rt_uint32_t *_yuv_scaler_row(struct _yuv_scaler *scaler, int row)
+{
+    int slot;
+
+    if (scaler->index[0] == row)
+        return scaler->row[0];
+    if (scaler->index[1] == row)
+        return scaler->row[1];
+
+    /* replace the row not the next of this one */
+    slot = scaler->index[0] == row - 1 ? 1 : 0;
+    scaler->index[slot] = row;
+    _yuv_row(scaler->yuv, row, scaler->row[slot]);
+
+    return scaler->row[slot];
+}
+
+static rt_err_t _yuv_scaler_init(struct _yuv_scaler *scaler, const struct rtgui_yuv_info *yuv,
+                                 int dst_w, int dst_h)
+{
+    scaler->row[0] = (rt_uint32_t *)rtgui_malloc((2 * yuv->w + dst_w) * sizeof(rt_uint32_t));
+    if (scaler->row[0] == RT_NULL)
+        return -RT_ENOMEM;
+    scaler->row[1] = scaler->row[0] + yuv->w;
+    scaler->line = scaler->row[1] + yuv->w;
+    scaler->index[0] = scaler->index[1] = -1;
+
+    scaler->yuv = yuv;
+    scaler->dst_w = dst_w;
+    scaler->dst_h = dst_h;
+    scaler->step_x = (int)(((rt_int64_t)yuv->w << _YUV_SHIFT) / dst_w);
+    scaler->step_y = (int)(((rt_int64_t)yuv->h << _YUV_SHIFT) / dst_h);
+
+    return RT_EOK;
+}
+
+/*
+ * Scale the row y of destination to the line of scaler, from the column x1 to
+ * x2. The pixels are sampled in their centers, the edges of bilinear repeat.
+ */
+static rt_uint32_t *_yuv_scaler_line(struct _yuv_scaler *scaler, int y, int x1, int x2)
+{
+    int x, sx, sy, last;
+    unsigned wx, wy;
+    rt_uint32_t *r0, *r1, *line;
+
+    line = scaler->line;
+    sy = y * scaler->step_y + scaler->step_y / 2;
+    sx = x1 * scaler->step_x + scaler->step_x / 2;
+    if (!scaler->yuv->smooth)
+    {
+        r0 = _yuv_scaler_row(scaler, sy >> _YUV_SHIFT);
+        for (x = x1; x < x2; x ++, sx += scaler->step_x)
+            *line++ = r0[sx >> _YUV_SHIFT];
+        return scaler->line;
+    }
+
+    sy -= _YUV_ONE / 2;
+    if (sy < 0) sy = 0;
+    last = scaler->yuv->h - 1;
+    r0 = _yuv_scaler_row(scaler, sy >> _YUV_SHIFT);
+    r1 = _yuv_scaler_row(scaler, (sy >> _YUV_SHIFT) < last ? (sy >> _YUV_SHIFT) + 1 : last);
+    wy = (sy >> (_YUV_SHIFT - 8)) & 0xff;
+
+    last = scaler->yuv->w - 1;
+    for (x = x1, sx -= _YUV_ONE / 2; x < x2; x ++, sx += scaler->step_x)
+    {
+        int c0, c1;
+
+        c0 = sx < 0 ? 0 : sx >> _YUV_SHIFT;
+        c1 = c0 < last ? c0 + 1 : last;
+        wx = sx < 0 ? 0 : (sx >> (_YUV_SHIFT - 8)) & 0xff;
+        *line++ = _yuv_lerp(_yuv_lerp(r0[c0], r0[c1], wx),
+                            _yuv_lerp(r1[c0], r1[c1], wx), wy);
+    }
+
+    return scaler->line;
+}
+
+/* store the ARGB8888 line in the pixel format, the x and y are for the dither */
+static void _yuv_store(rt_uint8_t *dst, rt_uint8_t format, const rt_uint32_t *line,
+                       int n, int x, int y)
+{
+    rt_uint32_t pixel;
+
+    switch (format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        rt_memcpy(dst, line, n * sizeof(rt_uint32_t));
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        for (; n > 0; n --, line ++, dst += 2)
+        {
+#ifdef GUIENGINE_USING_DITHER
+            *(rt_uint16_t *)dst = rtgui_color_to_565_dither(*line, x++, y);
+#else
+            *(rt_uint16_t *)dst = ((*line >> 8) & 0xf800) | ((*line >> 5) & 0x7e0) | ((*line >> 3) & 0x1f);
+#endif
+        }
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        for (; n > 0; n --, line ++, dst += 3)
+        {
+            dst[0] = (rt_uint8_t)*line;
+            dst[1] = (rt_uint8_t)(*line >> 8);
+            dst[2] = (rt_uint8_t)(*line >> 16);
+        }
+        break;
+    default:
+        for (; n > 0; n --, line ++)
+        {
+            rtgui_color_to_pixel(format, *line, &pixel);
+            rt_memcpy(dst, &pixel, rtgui_color_get_bpp(format));
+            dst += rtgui_color_get_bpp(format);
+        }
+        break;
+    }
+}
+
+/* scale the YUV frame to the dst_w x dst_h of info, the source of info is not used */
+void rtgui_blit_yuv(const struct rtgui_yuv_info *yuv, struct rtgui_blit_info *info)
+{
+    int y;
+    struct _yuv_scaler scaler;
+
+    RT_ASSERT(yuv != RT_NULL && info != RT_NULL);
+
+    if (yuv->w <= 0 || yuv->h <= 0 || info->dst_w <= 0 || info->dst_h <= 0)
+        return;
+    if (_yuv_scaler_init(&scaler, yuv, info->dst_w, info->dst_h) != RT_EOK)
+        return;
+
+    RTGUI_TRACE_BEGIN("blit_yuv", info->dst_w * info->dst_h);
+    for (y = 0; y < info->dst_h; y ++)
+    {
+        _yuv_store(info->dst + y * info->dst_pitch, info->dst_fmt,
+                   _yuv_scaler_line(&scaler, y, 0, info->dst_w), info->dst_w, 0, y);
+    }
+    RTGUI_TRACE_END("blit_yuv");
+
+    rtgui_free(scaler.row[0]);
+}
+RTM_EXPORT(rtgui_blit_yuv);
+
+/*
+ * Draw the YUV frame scaled to the rect of dc. The pixels out of the extents
+ * of window clip are not converted, and the lines are clipped by the
+ * blit_line of dc.
+ */
+void rtgui_yuv_info_blit(const struct rtgui_yuv_info *yuv, struct rtgui_dc *dc, rtgui_rect_t *dc_rect)
+{
+    int x1, x2, y, y1, y2, bpp;
+    rt_uint8_t format, *line;
+    rtgui_rect_t rect;
+    struct _yuv_scaler scaler;
+
+    RT_ASSERT(yuv != RT_NULL && dc != RT_NULL && dc_rect != RT_NULL);
+
+    rect = *dc_rect;
+    if (yuv->w <= 0 || yuv->h <= 0 || rect.x1 >= rect.x2 || rect.y1 >= rect.y2)
+        return;
+    if (!rtgui_dc_get_visible(dc))
+        return;
+
+    x1 = rect.x1;
+    x2 = rect.x2;
+    y1 = rect.y1;
+    y2 = rect.y2;
+    if (dc->type == RTGUI_DC_CLIENT || dc->type == RTGUI_DC_HW)
+    {
+        rtgui_widget_t *owner;
+        rtgui_rect_t *extents;
+
+        if (dc->type == RTGUI_DC_CLIENT)
+            owner = RTGUI_CONTAINER_OF(dc, struct rtgui_widget, dc_type);
+        else
+            owner = ((struct rtgui_dc_hw *)dc)->owner;
+        extents = rtgui_region_extents(&owner->clip);
+        if (x1 < extents->x1 - owner->extent.x1) x1 = extents->x1 - owner->extent.x1;
+        if (x2 > extents->x2 - owner->extent.x1) x2 = extents->x2 - owner->extent.x1;
+        if (y1 < extents->y1 - owner->extent.y1) y1 = extents->y1 - owner->extent.y1;
+        if (y2 > extents->y2 - owner->extent.y1) y2 = extents->y2 - owner->extent.y1;
+        if (x1 >= x2 || y1 >= y2)
+            return;
+    }
+
+    format = rtgui_dc_get_pixel_format(dc);
+    bpp = rtgui_color_get_bpp(format);
+    if (_yuv_scaler_init(&scaler, yuv, rtgui_rect_width(rect), rtgui_rect_height(rect)) != RT_EOK)
+        return;
+    line = (rt_uint8_t *)rtgui_malloc(scaler.dst_w * bpp);
+    if (line == RT_NULL)
+    {
+        rtgui_free(scaler.row[0]);
+        return;
+    }
+
+    RTGUI_TRACE_BEGIN("blit_yuv", (x2 - x1) * (y2 - y1));
+    for (y = y1; y < y2; y ++)
+    {
+        _yuv_store(line, format, _yuv_scaler_line(&scaler, y - rect.y1, x1 - rect.x1, x2 - rect.x1),
+                   x2 - x1, x1, y);
+        dc->engine->blit_line(dc, x1, x2, y, line);
+    }
+    RTGUI_TRACE_END("blit_yuv");
+
+    rtgui_free(line);
+    rtgui_free(scaler.row[0]);
+}
+RTM_EXPORT(rtgui_yuv_info_blit);
@@ -33,13 +33,15 @@ static void _rtgui_box_constructor(rtgui_box_t *box)
     box->orient = RTGUI_HORIZONTAL;
     box->border_size = RTGUI_BORDER_DEFAULT_WIDTH;
     box->container = RT_NULL;
+    box->hint_width = box->hint_height = 0;
 }
 
-DEFINE_CLASS_TYPE(box, "box",
-                  RTGUI_PARENT_TYPE(object),
-                  _rtgui_box_constructor,
-                  RT_NULL,
-                  sizeof(struct rtgui_box));
+DEFINE_CLASS_TYPE_POOL(box, "box",
+                       RTGUI_PARENT_TYPE(object),
+                       _rtgui_box_constructor,
+                       RT_NULL,
+                       sizeof(struct rtgui_box),
+                       GUIENGINE_OBJECT_POOL_SIZE);
 
 struct rtgui_box *rtgui_box_create(int orientation, int border_size)
 {
@@ -62,9 +64,71 @@ void rtgui_box_destroy(struct rtgui_box *box)
 }
 RTM_EXPORT(rtgui_box_destroy);
 
-static void rtgui_box_layout_vertical(struct rtgui_box *box, struct rtgui_rect *extent)
+/* the size of children in their min size with the borders */
+void rtgui_box_get_hint(struct rtgui_box *box, int *width, int *height)
 {
+    int major, minor, w, h;
     rtgui_list_t *node;
+    rtgui_widget_t *widget;
+
+    RT_ASSERT(box != RT_NULL && width != RT_NULL && height != RT_NULL);
+
+    major = box->border_size;
+    minor = 0;
+    if (box->container != RT_NULL)
+    {
+        rtgui_list_foreach(node, &(box->container->children))
+        {
+            widget = rtgui_list_entry(node, struct rtgui_widget, sibling);
+            w = box->orient & RTGUI_VERTICAL ? widget->min_width : widget->min_height;
+            h = box->orient & RTGUI_VERTICAL ? widget->min_height : widget->min_width;
+
+            major += h + box->border_size;
+            if (w > minor) minor = w;
+        }
+    }
+    minor += box->border_size * 2;
+
+    *width = box->orient & RTGUI_VERTICAL ? minor : major;
+    *height = box->orient & RTGUI_VERTICAL ? major : minor;
+}
+RTM_EXPORT(rtgui_box_get_hint);
+
+/*
+ * Apply the rect to the child in layout. The child of the same rect is not
+ * resized, and only the container of a changed child is laid out again.
+ * Return 1 if the clip of child should be updated.
+ */
+static int _box_layout_child(rtgui_widget_t *widget, rtgui_rect_t *old,
+                             struct rtgui_event_resize *size_event)
+{
+    struct rtgui_rect *rect;
+
+    rect = &(widget->extent);
+    if (rtgui_rect_is_equal(old, rect) == RT_EOK)
+    {
+        if (RTGUI_IS_CONTAINER(widget) && (widget->flag & RTGUI_WIDGET_FLAG_LAYOUT_DIRTY))
+            rtgui_container_layout(RTGUI_CONTAINER(widget));
+
+        return (widget->flag & RTGUI_WIDGET_FLAG_CLIP_DIRTY) ? 1 : 0;
+    }
+
+    widget->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+
+    /* process resize event */
+    size_event->x = rect->x1;
+    size_event->y = rect->y1;
+    size_event->w = rect->x2 - rect->x1;
+    size_event->h = rect->y2 - rect->y1;
+    RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget), &size_event->parent);
+
+    return 1;
+}
+
+static int rtgui_box_layout_vertical(struct rtgui_box *box, struct rtgui_rect *extent)
+{
+    rtgui_list_t *node;
+    int moved = 0;
     rt_int32_t box_width;
     rt_int32_t space_count;
     rt_int32_t next_x, next_y;
@@ -107,11 +171,12 @@ static void rtgui_box_layout_vertical(struct rtgui_box *box, struct rtgui_rect *
     /* layout each widget */
     rtgui_list_foreach(node, &(box->container->children))
     {
-        struct rtgui_rect *rect;
+        struct rtgui_rect *rect, old;
         rtgui_widget_t *widget = rtgui_list_entry(node, struct rtgui_widget, sibling);
 
         /* get extent of widget */
         rect = &(widget->extent);
+        old = *rect;
 
         /* reset rect */
         rtgui_rect_init(rect, 0, 0, widget->min_width, widget->min_height);
@@ -147,22 +212,19 @@ static void rtgui_box_layout_vertical(struct rtgui_box *box, struct rtgui_rect *
             rect->y2 = rect->y1 + space_height;
         }
 
-        /* process resize event */
-        size_event.x = rect->x1;
-        size_event.y = rect->y1;
-        size_event.w = rect->x2 - rect->x1;
-        size_event.h = rect->y2 - rect->y1;
-        RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget),
-                                            &size_event.parent);
+        moved += _box_layout_child(widget, &old, &size_event);
 
         /* point to next height */
         next_y = rect->y2 + box->border_size;
     }
+
+    return moved;
 }
 
-static void rtgui_box_layout_horizontal(struct rtgui_box *box, struct rtgui_rect *extent)
+static int rtgui_box_layout_horizontal(struct rtgui_box *box, struct rtgui_rect *extent)
 {
     rtgui_list_t *node;
+    int moved = 0;
     rt_int32_t box_height;
     rt_int32_t space_count;
     rt_int32_t next_x, next_y;
@@ -205,11 +267,12 @@ static void rtgui_box_layout_horizontal(struct rtgui_box *box, struct rtgui_rect
     /* layout each widget */
     rtgui_list_foreach(node, &(box->container->children))
     {
-        rtgui_rect_t *rect;
+        rtgui_rect_t *rect, old;
         rtgui_widget_t *widget = rtgui_list_entry(node, struct rtgui_widget, sibling);
 
         /* get extent of widget */
         rect = &(widget->extent);
+        old = *rect;
 
         /* reset rect */
         rtgui_rect_move(rect, -rect->x1, -rect->y1);
@@ -247,17 +310,13 @@ static void rtgui_box_layout_horizontal(struct rtgui_box *box, struct rtgui_rect
             rect->x2 = rect->x1 + space_width;
         }
 
-        /* process resize event */
-        size_event.x = rect->x1;
-        size_event.y = rect->y1;
-        size_event.w = rect->x2 - rect->x1;
-        size_event.h = rect->y2 - rect->y1;
-        RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget),
-                                            &size_event.parent);
+        moved += _box_layout_child(widget, &old, &size_event);
 
         /* point to next width */
         next_x = rect->x2 + box->border_size;
     }
+
+    return moved;
 }
 
 void rtgui_box_layout(rtgui_box_t *box)
@@ -268,40 +327,33 @@ void rtgui_box_layout(rtgui_box_t *box)
     if (box->container == RT_NULL) return;
 
     rtgui_widget_get_extent(RTGUI_WIDGET(box->container), &extent);
-    if (box->orient & RTGUI_VERTICAL)
-    {
-        rtgui_box_layout_vertical(box, &extent);
-    }
-    else
-    {
-        rtgui_box_layout_horizontal(box, &extent);
-    }
-
-    /* update box and its children clip */
-    if (!RTGUI_WIDGET_IS_HIDE(RTGUI_WIDGET(box->container)))
-    {
-        rtgui_widget_update_clip(RTGUI_WIDGET(box->container));
-    }
+    rtgui_box_layout_rect(box, &extent);
 }
 RTM_EXPORT(rtgui_box_layout);
 
 void rtgui_box_layout_rect(rtgui_box_t *box, struct rtgui_rect *rect)
 {
+    int moved, width, height;
+
     RT_ASSERT(box != RT_NULL);
 
     if (box->container == RT_NULL) return;
 
     if (box->orient & RTGUI_VERTICAL)
     {
-        rtgui_box_layout_vertical(box, rect);
+        moved = rtgui_box_layout_vertical(box, rect);
     }
     else
     {
-        rtgui_box_layout_horizontal(box, rect);
+        moved = rtgui_box_layout_horizontal(box, rect);
     }
+    RTGUI_WIDGET(box->container)->flag &= ~RTGUI_WIDGET_FLAG_LAYOUT_DIRTY;
+    rtgui_box_get_hint(box, &width, &height);
+    box->hint_width = width;
+    box->hint_height = height;
 
-    /* update box and its children clip */
-    if (!RTGUI_WIDGET_IS_HIDE(RTGUI_WIDGET(box->container)))
+    /* update the clip of the moved children, the others keep theirs */
+    if (moved && !RTGUI_WIDGET_IS_HIDE(RTGUI_WIDGET(box->container)))
     {
         rtgui_widget_update_clip(RTGUI_WIDGET(box->container));
     }
@@ -23,6 +23,10 @@
  */
 #include <rtgui/color.h>
 
+#ifdef GUIENGINE_USING_COVERAGE_GAMMA
+#include <math.h>
+#endif
+
 const rtgui_color_t red     = RTGUI_RGB(0xff, 0x00, 0x00);
 const rtgui_color_t green   = RTGUI_RGB(0x00, 0xff, 0x00);
 const rtgui_color_t blue    = RTGUI_RGB(0x00, 0x00, 0xff);
@@ -33,6 +37,42 @@ const rtgui_color_t high_light  = RTGUI_RGB(0xfc, 0xfc, 0xfc);
 const rtgui_color_t dark_grey   = RTGUI_RGB(0x7f, 0x7f, 0x7f);
 const rtgui_color_t light_grey  = RTGUI_RGB(0xc0, 0xc0, 0xc0);
 
+#ifdef GUIENGINE_USING_DITHER
+#define _DITHER(b)  (((b) >> 1) << 16 | ((b) >> 2) << 8 | ((b) >> 1))
+const rt_uint32_t rtgui_dither_565[4][4] =
+{
+    { _DITHER(0),  _DITHER(8),  _DITHER(2),  _DITHER(10) },
+    { _DITHER(12), _DITHER(4),  _DITHER(14), _DITHER(6)  },
+    { _DITHER(3),  _DITHER(11), _DITHER(1),  _DITHER(9)  },
+    { _DITHER(15), _DITHER(7),  _DITHER(13), _DITHER(5)  },
+};
+RTM_EXPORT(rtgui_dither_565);
+#endif
+
+#ifdef GUIENGINE_USING_COVERAGE_GAMMA
+rt_uint8_t rtgui_coverage_gamma[256];
+RTM_EXPORT(rtgui_coverage_gamma);
+
+/*
+ * The coverage is raised to 10 / gamma, which is near to the blending in
+ * linear light for the dark text on light background. It's looked up in the
+ * A8 kernels of blit and the AA shapes of dc_blend.
+ */
+void rtgui_color_set_coverage_gamma(int gamma)
+{
+    int index;
+    double exp;
+
+    if (gamma <= 0)
+        gamma = 10;
+    exp = 10.0 / gamma;
+
+    for (index = 0; index < 256; index ++)
+        rtgui_coverage_gamma[index] = (rt_uint8_t)(pow(index / 255.0, exp) * 255.0 + 0.5);
+}
+RTM_EXPORT(rtgui_color_set_coverage_gamma);
+#endif
+
 const static rt_uint8_t pixel_bits_table[] =
 {
     1, /* mono */
@@ -47,10 +87,58 @@ const static rt_uint8_t pixel_bits_table[] =
     32, /* ARGB888 */
 };
 
+rt_bool_t rtgui_color_to_pixel(rt_uint8_t pixel_format, rtgui_color_t c, rt_uint32_t *pixel)
+{
+    switch (pixel_format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        *pixel = rtgui_color_to_565(c);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
+        *pixel = rtgui_color_to_565p(c);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        *pixel = rtgui_color_to_888(c);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        *pixel = c;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_L8:
+        /* the luminance */
+        *pixel = (RTGUI_RGB_R(c) * 77 + RTGUI_RGB_G(c) * 150 + RTGUI_RGB_B(c) * 29) >> 8;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ALPHA:
+        /* the coverage of mask */
+        *pixel = RTGUI_RGB_A(c);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        *pixel = rtgui_color_to_4444(c);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        *pixel = rtgui_color_to_332(c);
+        break;
+    default:
+        /* the color is not mapped to the index of P8 */
+        return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+RTM_EXPORT(rtgui_color_to_pixel);
+
 rt_uint8_t rtgui_color_get_bits(rt_uint8_t pixel_format)
 {
     if (pixel_format <= RTGRAPHIC_PIXEL_FORMAT_ARGB888)
         return pixel_bits_table[pixel_format];
+    if (pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE ||
+            pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444)
+        return 16;
+    if (pixel_format == RTGRAPHIC_PIXEL_FORMAT_L8 ||
+            pixel_format == RTGRAPHIC_PIXEL_FORMAT_P8 ||
+            pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+        return 8;
+    if (pixel_format == RTGRAPHIC_PIXEL_FORMAT_A4)
+        return 4;
 
     /* use 32 as the default */
     return 32;
@@ -65,6 +153,17 @@ rt_uint8_t rtgui_color_get_bpp(rt_uint8_t pixel_format)
     {
         bpp = _UI_BITBYTES(pixel_bits_table[pixel_format]);
     }
+    else if (pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE ||
+             pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444)
+    {
+        bpp = 2;
+    }
+    else if (pixel_format == RTGRAPHIC_PIXEL_FORMAT_L8 ||
+             pixel_format == RTGRAPHIC_PIXEL_FORMAT_P8 ||
+             pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+    {
+        bpp = 1;
+    }
 
     return bpp;
 }
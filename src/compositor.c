@@ -0,0 +1,170 @@
+/*
+ * File      : compositor.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/driver.h>
+#include <rtgui/blit.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_COMPOSITOR
+
+#ifdef GUIENGINE_USING_BACKING_STORE
+#error "the layers of compositor take the place of backing store"
+#endif
+
+extern const struct rtgui_graphic_driver_ops *rtgui_framebuffer_get_ops(int pixel_format);
+
+/* the framebuffer of layer is the pixel (0, 0) of screen */
+static void _layer_set_origin(struct rtgui_layer *layer)
+{
+    layer->driver.framebuffer = layer->pixels
+                                - layer->extent.y1 * layer->driver.pitch
+                                - layer->extent.x1 * _UI_BITBYTES(layer->driver.bits_per_pixel);
+}
+
+/*
+ * Create the layer of a window. Only the driver with framebuffer could be
+ * composited, RT_NULL is returned on the others and the window is drawn to
+ * the screen directly.
+ */
+struct rtgui_layer *rtgui_layer_create(rtgui_rect_t *extent)
+{
+    int w, h, size;
+    struct rtgui_layer *layer;
+    struct rtgui_graphic_driver *driver;
+
+    w = rtgui_rect_width(*extent);
+    h = rtgui_rect_height(*extent);
+    if (w <= 0 || h <= 0)
+        return RT_NULL;
+
+    layer = (struct rtgui_layer *)rtgui_malloc(sizeof(struct rtgui_layer));
+    if (layer == RT_NULL)
+        return RT_NULL;
+    rt_memset(layer, 0, sizeof(struct rtgui_layer));
+
+    /* the default driver is not switched in it */
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    driver = rtgui_graphic_driver_get_default();
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL)
+    {
+        rtgui_screen_unlock();
+        rtgui_free(layer);
+        return RT_NULL;
+    }
+    layer->driver.pixel_format = driver->pixel_format;
+    layer->driver.bits_per_pixel = driver->bits_per_pixel;
+    layer->driver.width = driver->width;
+    layer->driver.height = driver->height;
+    rtgui_screen_unlock();
+
+    layer->driver.pitch = w * _UI_BITBYTES(layer->driver.bits_per_pixel);
+    layer->driver.ops = rtgui_framebuffer_get_ops(layer->driver.pixel_format);
+    if (layer->driver.ops == RT_NULL)
+    {
+        rtgui_free(layer);
+        return RT_NULL;
+    }
+
+    size = layer->driver.pitch * h;
+    layer->pixels = (rt_uint8_t *)rtgui_malloc(size);
+    if (layer->pixels == RT_NULL)
+    {
+        rtgui_free(layer);
+        return RT_NULL;
+    }
+    rt_memset(layer->pixels, 0, size);
+
+    layer->extent = *extent;
+    layer->opacity = 255;
+    _layer_set_origin(layer);
+
+    return layer;
+}
+RTM_EXPORT(rtgui_layer_create);
+
+void rtgui_layer_destroy(struct rtgui_layer *layer)
+{
+    if (layer == RT_NULL)
+        return;
+
+    rtgui_free(layer->pixels);
+    rtgui_free(layer);
+}
+RTM_EXPORT(rtgui_layer_destroy);
+
+/* the pixels are moved with the window, it's not drawn again */
+void rtgui_layer_move(struct rtgui_layer *layer, int dx, int dy)
+{
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    rtgui_rect_move(&layer->extent, dx, dy);
+    _layer_set_origin(layer);
+    rtgui_screen_unlock();
+}
+RTM_EXPORT(rtgui_layer_move);
+
+void rtgui_layer_composite(struct rtgui_graphic_driver *driver,
+                           struct rtgui_layer *layer, rtgui_rect_t *rect)
+{
+    int bpp;
+    rtgui_rect_t r, screen;
+    struct rtgui_blit_info info;
+
+    if (layer->opacity == 0)
+        return;
+
+    r = *rect;
+    rtgui_rect_intersect(&layer->extent, &r);
+    rtgui_graphic_driver_get_rect(driver, &screen);
+    rtgui_rect_intersect(&screen, &r);
+    if (r.x1 >= r.x2 || r.y1 >= r.y2)
+        return;
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+
+    /* the blend of surface alpha, or the copy of opaque layer */
+    info.src = layer->driver.framebuffer + r.y1 * layer->driver.pitch + r.x1 * bpp;
+    info.src_w = rtgui_rect_width(r);
+    info.src_h = rtgui_rect_height(r);
+    info.src_pitch = layer->driver.pitch;
+    info.src_skip = info.src_pitch - info.src_w * bpp;
+
+    info.dst = driver->framebuffer + r.y1 * driver->pitch + r.x1 * bpp;
+    info.dst_w = info.src_w;
+    info.dst_h = info.src_h;
+    info.dst_pitch = driver->pitch;
+    info.dst_skip = info.dst_pitch - info.dst_w * bpp;
+
+    info.src_fmt = layer->driver.pixel_format;
+    info.dst_fmt = driver->pixel_format;
+    info.r = info.g = info.b = 0;
+    info.a = layer->opacity;
+
+    rtgui_blit(&info);
+}
+RTM_EXPORT(rtgui_layer_composite);
+
+#endif
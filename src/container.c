@@ -40,19 +40,25 @@ static void _rtgui_container_constructor(rtgui_container_t *container)
     RTGUI_WIDGET(container)->flag |= RTGUI_WIDGET_FLAG_FOCUSABLE;
 }
 
+static void _rtgui_container_release_children(rtgui_container_t *container);
+
 static void _rtgui_container_destructor(rtgui_container_t *container)
 {
-    rtgui_container_destroy_children(container);
+    _rtgui_container_release_children(container);
+    /* the clip is updated once by the container the subtree is released from */
+    if (RTGUI_WIDGET(container)->parent != RT_NULL)
+        rtgui_win_update_clip(RTGUI_WIN(RTGUI_WIDGET(container)->toplevel));
 
     if (container->layout_box != RT_NULL)
         rtgui_object_destroy(RTGUI_OBJECT(container->layout_box));
 }
 
-DEFINE_CLASS_TYPE(container, "container",
-                  RTGUI_PARENT_TYPE(widget),
-                  _rtgui_container_constructor,
-                  _rtgui_container_destructor,
-                  sizeof(struct rtgui_container));
+DEFINE_CLASS_TYPE_POOL(container, "container",
+                       RTGUI_PARENT_TYPE(widget),
+                       _rtgui_container_constructor,
+                       _rtgui_container_destructor,
+                       sizeof(struct rtgui_container),
+                       GUIENGINE_OBJECT_POOL_SIZE);
 RTM_EXPORT(_rtgui_container);
 
 rt_bool_t rtgui_container_dispatch_event(rtgui_container_t *container, rtgui_event_t *event)
@@ -72,28 +78,22 @@ rt_bool_t rtgui_container_dispatch_event(rtgui_container_t *container, rtgui_eve
 
         event->type = save_event.type;
 
-        if (RTGUI_EVENT_PAINT & event->type)
+        if (event->type == RTGUI_EVENT_PAINT)
         {
-            if (widget->extent.x1 > w->extent.x2)
-            {
-                event->type &= !RTGUI_EVENT_PAINT;
-            }
-            else if (widget->extent.x2 < w->extent.x1)
-            {
-                event->type &= !RTGUI_EVENT_PAINT;
-            }
-            else if (widget->extent.y1 > w->extent.y2)
-            {
-                event->type &= !RTGUI_EVENT_PAINT;
-            }
-            else if (widget->extent.y2 < w->extent.y1)
-            {
-                event->type &= !RTGUI_EVENT_PAINT;
-            }
+            /* the child out of the container is not painted */
+            if (widget->extent.x1 >= w->extent.x2 || widget->extent.x2 <= w->extent.x1 ||
+                    widget->extent.y1 >= w->extent.y2 || widget->extent.y2 <= w->extent.y1)
+                continue;
+
+            /* the child out of the damage is skipped, or painted in the damage */
+            if (RTGUI_OBJECT_WANTS(RTGUI_OBJECT(w), RTGUI_EVENT_PAINT) &&
+                    rtgui_widget_paint_damage(w, event) == RT_TRUE)
+                return RT_TRUE;
+            continue;
         }
 
-        if (RTGUI_OBJECT(w)->event_handler &&
-                RTGUI_OBJECT(w)->event_handler(RTGUI_OBJECT(w), event) == RT_TRUE)
+        if (RTGUI_OBJECT_WANTS(RTGUI_OBJECT(w), event->type) &&
+                rtgui_widget_paint_event(w, event) == RT_TRUE)
         {
             return RT_TRUE;
         }
@@ -114,7 +114,7 @@ rt_bool_t rtgui_container_broadcast_event(struct rtgui_container *container, str
         struct rtgui_widget *w;
         w = rtgui_list_entry(node, struct rtgui_widget, sibling);
 
-        if (RTGUI_OBJECT(w)->event_handler)
+        if (RTGUI_OBJECT_WANTS(RTGUI_OBJECT(w), event->type))
             RTGUI_OBJECT(w)->event_handler(RTGUI_OBJECT(w), event);
     }
 
@@ -139,7 +139,7 @@ rt_bool_t rtgui_container_dispatch_mouse_event(rtgui_container_t *container, str
         {
             if ((old_focus != w) && RTGUI_WIDGET_IS_FOCUSABLE(w))
                 rtgui_widget_focus(w);
-            if (RTGUI_OBJECT(w)->event_handler &&
+            if (RTGUI_OBJECT_WANTS(RTGUI_OBJECT(w), event->parent.type) &&
                     RTGUI_OBJECT(w)->event_handler(RTGUI_OBJECT(w),
                                                    (rtgui_event_t *)event) == RT_TRUE)
                 return RT_TRUE;
@@ -256,6 +256,7 @@ void rtgui_container_add_child(rtgui_container_t *container, rtgui_widget_t *chi
 
     /* set parent and toplevel widget */
     child->parent = RTGUI_WIDGET(container);
+    rtgui_widget_clip_dirty(child);
     /* put widget to parent's children list */
     rtgui_list_append(&(container->children), &(child->sibling));
 
@@ -294,6 +295,8 @@ void rtgui_container_remove_child(rtgui_container_t *container, rtgui_widget_t *
     /* set parent and toplevel widget */
     child->parent = RT_NULL;
     child->toplevel = RT_NULL;
+    /* the container should get the clip of child back */
+    rtgui_widget_clip_dirty(RTGUI_WIDGET(container));
 
     /* update window clip */
     if (RTGUI_WIDGET(container)->toplevel)
@@ -303,14 +306,14 @@ void rtgui_container_remove_child(rtgui_container_t *container, rtgui_widget_t *
 }
 RTM_EXPORT(rtgui_container_remove_child);
 
-/* destroy all children of container */
-void rtgui_container_destroy_children(rtgui_container_t *container)
+/*
+ * Release the subtree of container. The children are destroyed without the
+ * update of clip, and the objects go back to the pools of their types.
+ */
+static void _rtgui_container_release_children(rtgui_container_t *container)
 {
     struct rtgui_list_node *node;
 
-    if (container == RT_NULL)
-        return;
-
     node = container->children.next;
     while (node != RT_NULL)
     {
@@ -322,7 +325,7 @@ void rtgui_container_destroy_children(rtgui_container_t *container)
             child->parent = RT_NULL;
 
             /* destroy children of child */
-            rtgui_container_destroy_children(RTGUI_CONTAINER(child));
+            _rtgui_container_release_children(RTGUI_CONTAINER(child));
         }
 
         /* remove widget from parent's children list */
@@ -338,6 +341,15 @@ void rtgui_container_destroy_children(rtgui_container_t *container)
     }
 
     container->children.next = RT_NULL;
+}
+
+/* destroy all children of container */
+void rtgui_container_destroy_children(rtgui_container_t *container)
+{
+    if (container == RT_NULL)
+        return;
+
+    _rtgui_container_release_children(container);
 
     /* update widget clip */
     rtgui_win_update_clip(RTGUI_WIN(RTGUI_WIDGET(container)->toplevel));
@@ -378,6 +390,48 @@ void rtgui_container_layout(struct rtgui_container *container)
 }
 RTM_EXPORT(rtgui_container_layout);
 
+/*
+ * The min size of child is changed, do the layout of the container of it. A
+ * container in a box, which min size is the hint of its last layout, takes
+ * the new hint as its min size and the layout goes up to its parent. So only
+ * the first container of the same size and the changed children inside are
+ * laid out.
+ */
+rtgui_widget_t *rtgui_container_relayout(rtgui_widget_t *child)
+{
+    int width, height;
+    rtgui_box_t *box;
+    rtgui_widget_t *widget;
+
+    RT_ASSERT(child != RT_NULL);
+
+    widget = child->parent;
+    if (widget == RT_NULL || RTGUI_CONTAINER(widget)->layout_box == RT_NULL)
+        return RT_NULL;
+
+    while (1)
+    {
+        widget->flag |= RTGUI_WIDGET_FLAG_LAYOUT_DIRTY;
+        box = RTGUI_CONTAINER(widget)->layout_box;
+        if (widget->parent == RT_NULL || RTGUI_CONTAINER(widget->parent)->layout_box == RT_NULL ||
+                widget->min_width != box->hint_width || widget->min_height != box->hint_height)
+            break;
+
+        rtgui_box_get_hint(box, &width, &height);
+        if (width == box->hint_width && height == box->hint_height)
+            break;
+
+        /* the container follows its children */
+        widget->min_width = box->hint_width = width;
+        widget->min_height = box->hint_height = height;
+        widget = widget->parent;
+    }
+
+    rtgui_container_layout(RTGUI_CONTAINER(widget));
+    return widget;
+}
+RTM_EXPORT(rtgui_container_relayout);
+
 struct rtgui_object* rtgui_container_get_object(struct rtgui_container *container,
                                                 rt_uint32_t id)
 {
@@ -25,23 +25,26 @@
  * 2011-04-25     Bernard      fix fill polygon issue, which found by loveic
  */
 
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
 /* for sin/cos etc */
 #include <math.h>
 
 #include <rtgui/dc.h>
+#include <rtgui/blit.h>
+#include <rtgui/font_atlas.h>
 
 #include <rtgui/rtgui_system.h>
 #include <rtgui/rtgui_server.h>
+#include <rtgui/rtgui_app.h>
 #include <rtgui/widgets/window.h>
 #include <rtgui/widgets/title.h>
+#include <rtgui/trace.h>
 
 #include <string.h> /* for strlen */
-#include <stdlib.h> /* fir qsort  */
 
-static int _int_compare(const void *a, const void *b)
-{
-    return (*(const int *) a) - (*(const int *) b);
-}
+static void _dc_fill_round_spans(struct rtgui_dc *dc, int x1, int y1, int x2, int y2,
+                                 int rx, int ry, rt_bool_t circle);
 
 void rtgui_dc_destory(struct rtgui_dc *dc)
 {
@@ -225,28 +228,21 @@ void rtgui_dc_fill_round_rect(struct rtgui_dc *dc, struct rtgui_rect *rect, int
 
     if (((rect->x2 - rect->x1) / 2 >= r) && ((rect->y2 - rect->y1) / 2 >= r))
     {
-        rect_temp.x1 = rect->x1 + r;
-        rect_temp.y1 = rect->y1;
-        rect_temp.x2 = rect->x2 - r;
-        rect_temp.y2 = rect->y2;
-        rtgui_dc_fill_rect_forecolor(dc, &rect_temp);//fill rect with foreground
+        if (r <= 0)
+        {
+            rtgui_dc_fill_rect_forecolor(dc, rect);
+            return;
+        }
 
+        /* the rows between the corners */
         rect_temp.x1 = rect->x1;
         rect_temp.y1 = rect->y1 + r;
-        rect_temp.x2 = rect->x1 + r;
-        rect_temp.y2 = rect->y2 - r;
-        rtgui_dc_fill_rect_forecolor(dc, &rect_temp);//fill rect with foreground
-
-        rect_temp.x1 = rect->x2 - r;
-        rect_temp.y1 = rect->y1 + r;
         rect_temp.x2 = rect->x2;
         rect_temp.y2 = rect->y2 - r;
         rtgui_dc_fill_rect_forecolor(dc, &rect_temp);//fill rect with foreground
 
-        rtgui_dc_fill_circle(dc, rect->x1 + r, rect->y1 + r, r);
-        rtgui_dc_fill_circle(dc, rect->x2 - r, rect->y2 - r, r);
-        rtgui_dc_fill_circle(dc, rect->x2 - r, rect->y1 + r, r);
-        rtgui_dc_fill_circle(dc, rect->x1 + r, rect->y2 - r, r);
+        /* the top and bottom rows with the corners */
+        _dc_fill_round_spans(dc, rect->x1 + r, rect->y1 + r, rect->x2 - r, rect->y2 - r, r, r, RT_TRUE);
     }
 }
 RTM_EXPORT(rtgui_dc_fill_round_rect);
@@ -271,6 +267,10 @@ void rtgui_dc_fill_gradient_rectv(struct rtgui_dc *dc, rtgui_rect_t *rect,
 {
     int y, step;
     rtgui_color_t fc;
+#ifdef GUIENGINE_USING_DITHER
+    int x, width;
+    rt_uint16_t *line = RT_NULL, pattern[4];
+#endif
 
     RT_ASSERT(dc != RT_NULL);
     RT_ASSERT(rect != RT_NULL);
@@ -278,16 +278,44 @@ void rtgui_dc_fill_gradient_rectv(struct rtgui_dc *dc, rtgui_rect_t *rect,
     step = rtgui_rect_height(*rect);
     fc = RTGUI_DC_FC(dc);
 
+#ifdef GUIENGINE_USING_DITHER
+    /* the opaque gradient on RGB565 is drawn in the dithered lines */
+    width = rtgui_rect_width(*rect);
+    if (width > 0 && RTGUI_RGB_A(c1) == 255 && RTGUI_RGB_A(c2) == 255 &&
+            rtgui_dc_get_pixel_format(dc) == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+        line = (rt_uint16_t *)rtgui_malloc(width * sizeof(rt_uint16_t));
+#endif
+
     for (y = rect->y1; y < rect->y2; y++)
     {
         RTGUI_DC_FC(dc) = RTGUI_ARGB(((int)RTGUI_RGB_A(c2) - RTGUI_RGB_A(c1)) * (y - rect->y1) / step + RTGUI_RGB_A(c1),
                                      ((int)RTGUI_RGB_R(c2) - RTGUI_RGB_R(c1)) * (y - rect->y1) / step + RTGUI_RGB_R(c1),
                                      ((int)RTGUI_RGB_G(c2) - RTGUI_RGB_G(c1)) * (y - rect->y1) / step + RTGUI_RGB_G(c1),
                                      ((int)RTGUI_RGB_B(c2) - RTGUI_RGB_B(c1)) * (y - rect->y1) / step + RTGUI_RGB_B(c1));
+#ifdef GUIENGINE_USING_DITHER
+        if (line != RT_NULL)
+        {
+            for (x = 0; x < 4; x ++)
+                pattern[x] = rtgui_color_to_565_dither(RTGUI_DC_FC(dc), x, y);
+
+            /* the row in one 565 color is a line as well */
+            if (pattern[0] != pattern[1] || pattern[0] != pattern[2] || pattern[0] != pattern[3])
+            {
+                for (x = 0; x < width; x ++)
+                    line[x] = pattern[(rect->x1 + x) & 3];
+                dc->engine->blit_line(dc, rect->x1, rect->x2, y, (rt_uint8_t *)line);
+                continue;
+            }
+        }
+#endif
         rtgui_dc_draw_hline(dc, rect->x1, rect->x2, y);
     }
 
     RTGUI_DC_FC(dc) = fc;
+#ifdef GUIENGINE_USING_DITHER
+    if (line != RT_NULL)
+        rtgui_free(line);
+#endif
 }
 RTM_EXPORT(rtgui_dc_fill_gradient_rectv);
 
@@ -331,6 +359,196 @@ void rtgui_dc_draw_text(struct rtgui_dc *dc, const char *text, struct rtgui_rect
 }
 RTM_EXPORT(rtgui_dc_draw_text);
 
+/* draw the text run prepared, the font of run is used instead of dc */
+void rtgui_dc_draw_text_run(struct rtgui_dc *dc, struct rtgui_text_run *run, struct rtgui_rect *rect)
+{
+    RT_ASSERT(dc != RT_NULL);
+    RT_ASSERT(run != RT_NULL);
+
+    if (run->len == 0)
+        return;
+
+    rtgui_font_draw_text_run(run, dc, rect);
+}
+RTM_EXPORT(rtgui_dc_draw_text_run);
+
+void rtgui_dc_draw_text_rotated(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect, int angle)
+{
+    int orientation;
+    rt_uint16_t style;
+    rtgui_rect_t text_rect;
+    rtgui_point_t center;
+    struct rtgui_font *font;
+    struct rtgui_dc *buffer;
+
+    RT_ASSERT(dc != RT_NULL);
+
+    angle %= 360;
+    if (angle < 0) angle += 360;
+    if (angle == 0)
+    {
+        rtgui_dc_draw_text(dc, text, rect);
+        return;
+    }
+
+    style = rtgui_dc_get_gc(dc)->textstyle;
+    if (angle % 90 == 0)
+    {
+        /* lay out in the coordinate of text, the glyphs are rotated back */
+        orientation = angle / 90;
+        rtgui_glyph_rotate_rect(orientation, rect, &text_rect);
+        rtgui_dc_get_gc(dc)->textstyle = (style & ~RTGUI_TEXTSTYLE_ROTATE_MASK) | (orientation << 4);
+        rtgui_dc_draw_text(dc, text, &text_rect);
+        rtgui_dc_get_gc(dc)->textstyle = style;
+        return;
+    }
+
+    font = RTGUI_DC_FONT(dc);
+    if (font == RT_NULL)
+        font = rtgui_font_default();
+    if (font == RT_NULL || !rtgui_dc_get_visible(dc))
+        return;
+
+    /* the text in a transparent buffer, rotated around the center of rect */
+    rtgui_font_get_metrics(font, text, &text_rect);
+    buffer = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888,
+                                              rtgui_rect_width(text_rect), rtgui_rect_height(text_rect));
+    if (buffer == RT_NULL)
+        return;
+    rt_memset(rtgui_dc_buffer_get_pixel(buffer), 0x00,
+              ((struct rtgui_dc_buffer *)buffer)->pitch * rtgui_rect_height(text_rect));
+    RTGUI_DC_FONT(buffer) = font;
+    RTGUI_DC_FC(buffer) = RTGUI_DC_FC(dc);
+    rtgui_dc_get_gc(buffer)->textstyle = style & ~(RTGUI_TEXTSTYLE_ROTATE_MASK | RTGUI_TEXTSTYLE_DRAW_BACKGROUND);
+    rtgui_dc_draw_text(buffer, text, &text_rect);
+
+    center.x = (rect->x1 + rect->x2) / 2;
+    center.y = (rect->y1 + rect->y2) / 2;
+    rtgui_dc_rotozoom_blit(buffer, dc, &center, RTGUI_FIXED(angle), RTGUI_FIXED(1), RTGUI_FIXED(1), 1);
+    rtgui_dc_destory(buffer);
+}
+RTM_EXPORT(rtgui_dc_draw_text_rotated);
+
+/* draw the lines of layout from the top of rect, the lines out of dc are skipped */
+void rtgui_dc_draw_text_layout(struct rtgui_dc *dc, struct rtgui_text_layout *layout, struct rtgui_rect *rect)
+{
+    int index, height;
+    rtgui_rect_t dc_rect, line_rect;
+
+    RT_ASSERT(dc != RT_NULL);
+    RT_ASSERT(layout != RT_NULL);
+
+    if (layout->count == 0)
+        return;
+
+    rtgui_dc_get_rect(dc, &dc_rect);
+    height = layout->font->height;
+
+    /* the first line visible in dc */
+    index = 0;
+    if (dc_rect.y1 > rect->y1)
+        index = (dc_rect.y1 - rect->y1) / height;
+
+    line_rect.x1 = rect->x1;
+    line_rect.x2 = rect->x2;
+    for (; index < layout->count; index ++)
+    {
+        line_rect.y1 = rect->y1 + index * height;
+        line_rect.y2 = line_rect.y1 + height;
+        if (line_rect.y1 >= rect->y2 || line_rect.y1 >= dc_rect.y2)
+            break;
+
+        rtgui_dc_draw_text_run(dc, layout->lines[index].run, &line_rect);
+    }
+}
+RTM_EXPORT(rtgui_dc_draw_text_layout);
+
+/*
+ * The outline of text in one raster: the glyphs are drawn once in an A8
+ * mask, the outline is the mask dilated by 1 pixel, and both colors are
+ * composed in an ARGB888 buffer blitted once. RT_FALSE if there is no memory.
+ */
+static rt_bool_t _dc_draw_text_outline(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect,
+                                       rtgui_color_t color_stroke, rtgui_color_t color_core)
+{
+    int x, y, w, h, pitch;
+    rt_uint8_t m, o, *mask, *dilated, *row;
+    rtgui_color_t *pixel;
+    rtgui_rect_t r;
+    rtgui_point_t point;
+    struct rtgui_dc *mask_dc, *buffer;
+
+    w = rtgui_rect_width(*rect) + 2;
+    h = rtgui_rect_height(*rect) + 2;
+    if (w <= 2 || h <= 2)
+        return RT_TRUE;
+
+    mask_dc = rtgui_dc_mask_create(w, h);
+    if (mask_dc == RT_NULL)
+        return RT_FALSE;
+    buffer = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, w, h);
+    dilated = (rt_uint8_t *)rtgui_malloc(w * h);
+    if (buffer == RT_NULL || dilated == RT_NULL)
+    {
+        if (buffer != RT_NULL) rtgui_dc_destory(buffer);
+        rtgui_free(dilated);
+        rtgui_dc_destory(mask_dc);
+        return RT_FALSE;
+    }
+
+    /* the text in the same font and alignment, 1 pixel inside of the mask */
+    RTGUI_DC_FONT(mask_dc) = RTGUI_DC_FONT(dc);
+    RTGUI_DC_TEXTALIGN(mask_dc) = RTGUI_DC_TEXTALIGN(dc);
+    rtgui_rect_init(&r, 1, 1, w - 2, h - 2);
+    rtgui_dc_draw_text(mask_dc, text, &r);
+    mask = rtgui_dc_buffer_get_pixel(mask_dc);
+    pitch = ((struct rtgui_dc_buffer *)mask_dc)->pitch;
+
+    /* the 3x3 max in two passes, the rows then the columns */
+    for (y = 0; y < h; y ++)
+    {
+        row = mask + y * pitch;
+        for (x = 0; x < w; x ++)
+        {
+            m = row[x];
+            if (x > 0 && row[x - 1] > m) m = row[x - 1];
+            if (x < w - 1 && row[x + 1] > m) m = row[x + 1];
+            dilated[y * w + x] = m;
+        }
+    }
+    for (y = 0; y < h; y ++)
+    {
+        pixel = (rtgui_color_t *)(rtgui_dc_buffer_get_pixel(buffer) + y * ((struct rtgui_dc_buffer *)buffer)->pitch);
+        row = mask + y * pitch;
+        for (x = 0; x < w; x ++)
+        {
+            o = dilated[y * w + x];
+            if (y > 0 && dilated[(y - 1) * w + x] > o) o = dilated[(y - 1) * w + x];
+            if (y < h - 1 && dilated[(y + 1) * w + x] > o) o = dilated[(y + 1) * w + x];
+
+            /* the core over the stroke, the outline covers the core */
+            m = row[x];
+            pixel[x] = RTGUI_ARGB(o,
+                                  (RTGUI_RGB_R(color_stroke) * (255 - m) + RTGUI_RGB_R(color_core) * m) / 255,
+                                  (RTGUI_RGB_G(color_stroke) * (255 - m) + RTGUI_RGB_G(color_core) * m) / 255,
+                                  (RTGUI_RGB_B(color_stroke) * (255 - m) + RTGUI_RGB_B(color_core) * m) / 255);
+        }
+    }
+    rtgui_free(dilated);
+    rtgui_dc_destory(mask_dc);
+
+    /* the negative origin clips the buffer */
+    rtgui_rect_init(&r, rect->x1 - 1, rect->y1 - 1, w, h);
+    point.x = r.x1 < 0 ? -r.x1 : 0;
+    point.y = r.y1 < 0 ? -r.y1 : 0;
+    if (r.x1 < 0) r.x1 = 0;
+    if (r.y1 < 0) r.y1 = 0;
+    rtgui_dc_blit(buffer, &point, dc, &r);
+    rtgui_dc_destory(buffer);
+
+    return RT_TRUE;
+}
+
 void rtgui_dc_draw_text_stroke(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect,
                                rtgui_color_t color_stroke, rtgui_color_t color_core)
 {
@@ -340,6 +558,12 @@ void rtgui_dc_draw_text_stroke(struct rtgui_dc *dc, const char *text, struct rtg
 
     RT_ASSERT(dc != RT_NULL);
 
+    if (text == RT_NULL || *text == '\0' || !rtgui_dc_get_visible(dc))
+        return;
+    if (_dc_draw_text_outline(dc, text, rect, color_stroke, color_core))
+        return;
+
+    /* no memory for the mask, draw the text at the 8 offsets and the core */
     fc = RTGUI_DC_FC(dc);
     RTGUI_DC_FC(dc) = color_stroke;
     for (x = -1; x < 2; x++)
@@ -362,17 +586,32 @@ RTM_EXPORT(rtgui_dc_draw_text_stroke);
  */
 void rtgui_dc_draw_mono_bmp(struct rtgui_dc *dc, int x, int y, int w, int h, const rt_uint8_t *data)
 {
-    int i, j, k;
+    int i, k, start, word_bytes;
 
     /* get word bytes */
-    w = (w + 7) / 8;
+    word_bytes = (w + 7) / 8;
 
-    /* draw mono bitmap data */
+    /* draw the runs of set bits in each row as hline */
     for (i = 0; i < h; i ++)
-        for (j = 0; j < w; j++)
-            for (k = 0; k < 8; k++)
-                if (((data[i * w + j] >> (7 - k)) & 0x01) != 0)
-                    rtgui_dc_draw_point(dc, x + 8 * j + k, y + i);
+    {
+        start = -1;
+        for (k = 0; k < w; k ++)
+        {
+            if ((data[k / 8] >> (7 - (k & 0x07))) & 0x01)
+            {
+                if (start < 0) start = k;
+            }
+            else if (start >= 0)
+            {
+                rtgui_dc_draw_hline(dc, x + start, x + k, y + i);
+                start = -1;
+            }
+        }
+        if (start >= 0)
+            rtgui_dc_draw_hline(dc, x + start, x + w, y + i);
+
+        data += word_bytes;
+    }
 }
 RTM_EXPORT(rtgui_dc_draw_mono_bmp);
 
@@ -475,16 +714,134 @@ void rtgui_dc_draw_polygon(struct rtgui_dc *dc, const int *vx, const int *vy, in
 }
 RTM_EXPORT(rtgui_dc_draw_polygon);
 
+/*
+ * The polygon edge for the active edge table. The parameter of the edge on
+ * each scanline is stepped exactly as floor(num / den), without division.
+ */
+struct _poly_edge
+{
+    /* the scanlines of edge: [y1, y2) */
+    int y1, y2;
+    int x1, dx;
+
+    /* the parameter and the remainder */
+    int value, rem;
+    /* the step of parameter and remainder */
+    int q, r;
+    int den;
+};
+
+rt_inline int _poly_floor_div(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static void _poly_edge_step_init(struct _poly_edge *edge, int num, int step, int den)
+{
+    edge->den   = den;
+    edge->value = _poly_floor_div(num, den);
+    edge->rem   = num - edge->value * den;
+    edge->q     = _poly_floor_div(step, den);
+    edge->r     = step - edge->q * den;
+}
+
+rt_inline void _poly_edge_step(struct _poly_edge *edge)
+{
+    edge->value += edge->q;
+    edge->rem   += edge->r;
+    if (edge->rem >= edge->den)
+    {
+        edge->value ++;
+        edge->rem -= edge->den;
+    }
+}
+
+/*
+ * Build the edge table of the polygon, sorted by y1. The scanlines are
+ * scaled by (1 << sub_shift), and the horizontal edges are dropped.
+ */
+static int _poly_build_edges(struct _poly_edge *edges, const int *vx, const int *vy,
+                             int count, int sub_shift)
+{
+    int i, j, num = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        struct _poly_edge edge;
+        int ind1 = i ? i - 1 : count - 1;
+        int ind2 = i;
+
+        if (vy[ind1] == vy[ind2])
+            continue;
+
+        if (vy[ind1] < vy[ind2])
+        {
+            edge.x1 = vx[ind1];
+            edge.dx = vx[ind2] - vx[ind1];
+            edge.y1 = vy[ind1];
+            edge.y2 = vy[ind2];
+        }
+        else
+        {
+            edge.x1 = vx[ind2];
+            edge.dx = vx[ind1] - vx[ind2];
+            edge.y1 = vy[ind2];
+            edge.y2 = vy[ind1];
+        }
+
+        if (sub_shift == 0)
+        {
+            /* t = 65536 * (y - y1) / (y2 - y1) */
+            _poly_edge_step_init(&edge, 0, 65536, edge.y2 - edge.y1);
+        }
+        else
+        {
+            /* the x offset at the center of each sub scanline, in 16.16 */
+            int den = (edge.y2 - edge.y1) << (sub_shift + 1);
+
+            _poly_edge_step_init(&edge, edge.dx * 65536, edge.dx * 65536 * 2, den);
+            edge.y1 <<= sub_shift;
+            edge.y2 <<= sub_shift;
+        }
+
+        /* insertion sort by y1 */
+        for (j = num; j > 0 && edges[j - 1].y1 > edge.y1; j--)
+            edges[j] = edges[j - 1];
+        edges[j] = edge;
+        num ++;
+    }
+
+    return num;
+}
+
+/* sort the active edges by x, which are almost in order */
+static void _poly_sort_active(struct _poly_edge **active, int *xs, int num)
+{
+    int i, j;
+
+    for (i = 1; i < num; i++)
+    {
+        struct _poly_edge *edge = active[i];
+        int x = xs[i];
+
+        for (j = i; j > 0 && xs[j - 1] > x; j--)
+        {
+            active[j] = active[j - 1];
+            xs[j] = xs[j - 1];
+        }
+        active[j] = edge;
+        xs[j] = x;
+    }
+}
+
 void rtgui_dc_fill_polygon(struct rtgui_dc *dc, const int *vx, const int *vy, int count)
 {
-    int i;
-    int y, xa, xb;
+    int i, y;
+    int xa, xb;
     int miny, maxy;
-    int x1, y1;
-    int x2, y2;
-    int ind1, ind2;
-    int ints;
-    int *poly_ints = RT_NULL;
+    int num_edges, num_active, next;
+    struct _poly_edge *edges, **active;
+    int *xs;
 
     /*
      * Sanity check number of edges
@@ -492,10 +849,13 @@ void rtgui_dc_fill_polygon(struct rtgui_dc *dc, const int *vx, const int *vy, in
     if (count < 3) return;
 
     /*
-     * Allocate temp array, only grow array
+     * Allocate the edge table and the active edge table
      */
-    poly_ints = (int *) rtgui_malloc(sizeof(int) * count);
-    if (poly_ints == RT_NULL) return ; /* no memory, failed */
+    edges = (struct _poly_edge *) rtgui_malloc((sizeof(struct _poly_edge) +
+             sizeof(struct _poly_edge *) + sizeof(int)) * count);
+    if (edges == RT_NULL) return ; /* no memory, failed */
+    active = (struct _poly_edge **)(edges + count);
+    xs = (int *)(active + count);
 
     /*
      * Determine Y maximal
@@ -508,65 +868,181 @@ void rtgui_dc_fill_polygon(struct rtgui_dc *dc, const int *vx, const int *vy, in
         else if (vy[i] > maxy) maxy = vy[i];
     }
 
+    num_edges = _poly_build_edges(edges, vx, vy, count, 0);
+    num_active = 0;
+    next = 0;
+
     /*
      * Draw, scanning y
      */
     for (y = miny; (y <= maxy); y++)
     {
-        ints = 0;
-        for (i = 0; (i < count); i++)
+        /* the new edges from this scanline */
+        while (next < num_edges && edges[next].y1 == y)
+            active[num_active++] = &edges[next++];
+
+        /* remove the finished edges, the last scanline includes the end of edges */
+        for (i = 0; i < num_active;)
         {
-            if (!i)
-            {
-                ind1 = count - 1;
-                ind2 = 0;
-            }
+            if (y >= active[i]->y2 && !(y == maxy && y == active[i]->y2))
+                active[i] = active[--num_active];
             else
+                i++;
+        }
+
+        for (i = 0; i < num_active; i++)
+        {
+            xs[i] = active[i]->value * active[i]->dx + 65536 * active[i]->x1;
+            _poly_edge_step(active[i]);
+        }
+        _poly_sort_active(active, xs, num_active);
+
+        for (i = 0; (i + 1 < num_active); i += 2)
+        {
+            xa = xs[i] + 1;
+            xa = (xa >> 16) + ((xa & 32768) >> 15);
+            xb = xs[i + 1] - 1;
+            xb = (xb >> 16) + ((xb & 32768) >> 15);
+            rtgui_dc_draw_hline(dc, xa, xb, y);
+        }
+    }
+
+    /* release memory */
+    rtgui_free(edges);
+}
+RTM_EXPORT(rtgui_dc_fill_polygon);
+
+/* the sub scanlines of each pixel in anti-aliased polygon */
+#define POLY_AA_SUB_SHIFT   2
+
+void rtgui_dc_fill_aa_polygon(struct rtgui_dc *dc, const int *vx, const int *vy, int count)
+{
+    int i, x, y, sub;
+    int minx, maxx, miny, maxy, width;
+    int num_edges, num_active, next, num_rects;
+    struct _poly_edge *edges, **active;
+    int *xs, *cover;
+    rtgui_rect_t *rects;
+    rtgui_color_t color;
+    rt_uint8_t r, g, b, a;
+
+    if (count < 3) return;
+    if (!rtgui_dc_get_visible(dc)) return;
+
+    minx = maxx = vx[0];
+    miny = maxy = vy[0];
+    for (i = 1; i < count; i++)
+    {
+        if (vx[i] < minx) minx = vx[i];
+        else if (vx[i] > maxx) maxx = vx[i];
+        if (vy[i] < miny) miny = vy[i];
+        else if (vy[i] > maxy) maxy = vy[i];
+    }
+    width = maxx - minx + 2;
+
+    /*
+     * The edge tables, the coverage of one pixel row (in difference form)
+     * and the full covered spans of the row.
+     */
+    edges = (struct _poly_edge *) rtgui_malloc((sizeof(struct _poly_edge) +
+             sizeof(struct _poly_edge *) + sizeof(int)) * count +
+             sizeof(int) * (width + 1) + sizeof(rtgui_rect_t) * (width / 2 + 1));
+    if (edges == RT_NULL) return ;
+    active = (struct _poly_edge **)(edges + count);
+    xs = (int *)(active + count);
+    cover = xs + count;
+    rects = (rtgui_rect_t *)(cover + width + 1);
+
+    color = rtgui_dc_get_gc(dc)->foreground;
+    r = RTGUI_RGB_R(color);
+    g = RTGUI_RGB_G(color);
+    b = RTGUI_RGB_B(color);
+    a = RTGUI_RGB_A(color);
+
+    num_edges = _poly_build_edges(edges, vx, vy, count, POLY_AA_SUB_SHIFT);
+    num_active = 0;
+    next = 0;
+
+    for (y = miny; y < maxy; y++)
+    {
+        int sum;
+
+        rt_memset(cover, 0, sizeof(int) * (width + 1));
+
+        for (sub = y << POLY_AA_SUB_SHIFT; sub < (y + 1) << POLY_AA_SUB_SHIFT; sub++)
+        {
+            while (next < num_edges && edges[next].y1 == sub)
+                active[num_active++] = &edges[next++];
+
+            for (i = 0; i < num_active;)
             {
-                ind1 = i - 1;
-                ind2 = i;
-            }
-            y1 = vy[ind1];
-            y2 = vy[ind2];
-            if (y1 < y2)
-            {
-                x1 = vx[ind1];
-                x2 = vx[ind2];
-            }
-            else if (y1 > y2)
-            {
-                y2 = vy[ind1];
-                y1 = vy[ind2];
-                x2 = vx[ind1];
-                x1 = vx[ind2];
+                if (sub >= active[i]->y2)
+                    active[i] = active[--num_active];
+                else
+                    i++;
             }
-            else
+
+            for (i = 0; i < num_active; i++)
             {
-                continue;
+                xs[i] = ((active[i]->x1 - minx) << 16) + active[i]->value;
+                _poly_edge_step(active[i]);
             }
+            _poly_sort_active(active, xs, num_active);
 
-            if (((y >= y1) && (y < y2)) || ((y == maxy) && (y > y1) && (y <= y2)))
+            /* accumulate the coverage, one full pixel of a sub scanline is 64 */
+            for (i = 0; (i + 1 < num_active); i += 2)
             {
-                poly_ints[ints++] = ((65536 * (y - y1)) / (y2 - y1)) * (x2 - x1) + (65536 * x1);
+                int xa = xs[i], xb = xs[i + 1];
+                int ia = xa >> 16, ib = xb >> 16;
+
+                if (ia == ib)
+                {
+                    cover[ia] += (xb - xa) >> 10;
+                    cover[ia + 1] -= (xb - xa) >> 10;
+                    continue;
+                }
+
+                cover[ia] += (65536 - (xa & 0xffff)) >> 10;
+                cover[ia + 1] += 64 - ((65536 - (xa & 0xffff)) >> 10);
+                cover[ib] += ((xb & 0xffff) >> 10) - 64;
+                cover[ib + 1] -= (xb & 0xffff) >> 10;
             }
         }
 
-        qsort(poly_ints, ints, sizeof(int), _int_compare);
-
-        for (i = 0; (i < ints); i += 2)
+        /* emit the full spans as rects, and blend the edge pixels */
+        num_rects = 0;
+        sum = 0;
+        for (x = 0; x < width; x++)
         {
-            xa = poly_ints[i] + 1;
-            xa = (xa >> 16) + ((xa & 32768) >> 15);
-            xb = poly_ints[i + 1] - 1;
-            xb = (xb >> 16) + ((xb & 32768) >> 15);
-            rtgui_dc_draw_hline(dc, xa, xb, y);
+            sum += cover[x];
+            if (sum >= (64 << POLY_AA_SUB_SHIFT))
+            {
+                if (num_rects && rects[num_rects - 1].x2 == minx + x)
+                {
+                    rects[num_rects - 1].x2 ++;
+                }
+                else
+                {
+                    rects[num_rects].x1 = minx + x;
+                    rects[num_rects].x2 = minx + x + 1;
+                    rects[num_rects].y1 = y;
+                    rects[num_rects].y2 = y + 1;
+                    num_rects ++;
+                }
+            }
+            else if (sum > 0)
+            {
+                rtgui_dc_blend_point(dc, minx + x, y, RTGUI_BLENDMODE_BLEND, r, g, b,
+                                     (a * sum) >> (6 + POLY_AA_SUB_SHIFT));
+            }
         }
+        if (num_rects)
+            rtgui_dc_blend_fill_rects(dc, rects, num_rects, RTGUI_BLENDMODE_BLEND, color);
     }
 
-    /* release memory */
-    rtgui_free(poly_ints);
+    rtgui_free(edges);
 }
-RTM_EXPORT(rtgui_dc_fill_polygon);
+RTM_EXPORT(rtgui_dc_fill_aa_polygon);
 
 void rtgui_dc_draw_circle(struct rtgui_dc *dc, int x, int y, int r)
 {
@@ -574,22 +1050,12 @@ void rtgui_dc_draw_circle(struct rtgui_dc *dc, int x, int y, int r)
 }
 RTM_EXPORT(rtgui_dc_draw_circle);
 
-enum
-{
-    QUARTER_BTM,
-    QUARTER_BTM_LEFT,
-    QUARTER_BTM_RIGHT,
-    QUARTER_TOP,
-    QUARTER_TOP_LEFT,
-    QUARTER_TOP_RIGHT,
-    QUARTER_FULL,
-};
+/* the spans are generated in the stack and filled in batch */
+#define RTGUI_SPAN_BATCH    32
 
-static void _fill_quarter_circle(struct rtgui_dc *dc,
-                                 rt_int16_t ox, rt_int16_t oy,
-                                 rt_int16_t rad, int quadrant)
+/* the half width of each row of the filled circle, in midpoint circle algorithm */
+static void _circle_half_widths(int rad, rt_int16_t *half)
 {
-    /* Midpoint circle algorithm. */
     int dk, x, y;
 
     dk = 1 - rad;
@@ -598,41 +1064,8 @@ static void _fill_quarter_circle(struct rtgui_dc *dc,
 
     while (x <= y)
     {
-        switch (quadrant)
-        {
-        case QUARTER_BTM:
-            rtgui_dc_draw_hline(dc, ox - x, ox + x, oy + y);
-            rtgui_dc_draw_hline(dc, ox - y, ox + y, oy + x);
-            break;
-        case QUARTER_BTM_LEFT:
-            rtgui_dc_draw_hline(dc, ox, ox + x, oy + y);
-            rtgui_dc_draw_hline(dc, ox, ox + y, oy + x);
-            break;
-        case QUARTER_BTM_RIGHT:
-            rtgui_dc_draw_hline(dc, ox, ox - x, oy + y);
-            rtgui_dc_draw_hline(dc, ox, ox - y, oy + x);
-            break;
-        case QUARTER_TOP_RIGHT:
-            rtgui_dc_draw_hline(dc, ox, ox - x, oy - y);
-            rtgui_dc_draw_hline(dc, ox, ox - y, oy - x);
-            break;
-        case QUARTER_TOP_LEFT:
-            rtgui_dc_draw_hline(dc, ox, ox + x, oy - y);
-            rtgui_dc_draw_hline(dc, ox, ox + y, oy - x);
-            break;
-        case QUARTER_TOP:
-            rtgui_dc_draw_hline(dc, ox - x, ox + x, oy - y);
-            rtgui_dc_draw_hline(dc, ox - y, ox + y, oy - x);
-            break;
-        case QUARTER_FULL:
-            rtgui_dc_draw_hline(dc, ox - x, ox + x, oy + y);
-            rtgui_dc_draw_hline(dc, ox - y, ox + y, oy + x);
-            rtgui_dc_draw_hline(dc, ox - x, ox + x, oy - y);
-            rtgui_dc_draw_hline(dc, ox - y, ox + y, oy - x);
-            break;
-        default:
-            RT_ASSERT(0);
-        };
+        if (half[y] < x) half[y] = x;
+        if (half[x] < y) half[x] = y;
 
         if (dk > 0)
         {
@@ -647,6 +1080,150 @@ static void _fill_quarter_circle(struct rtgui_dc *dc,
     }
 }
 
+#define _HALF_WIDTH(row, width) \
+    do { if (half[row] < (width)) half[row] = (width); } while (0)
+
+/* the half width of each row of the filled ellipse */
+static void _ellipse_half_widths(int rx, int ry, rt_int16_t *half)
+{
+    int ix, iy;
+    int h, i, j, k;
+    int oh, oi, oj, ok;
+
+    if (rx == 0 || ry == 0)
+    {
+        for (i = 0; i <= ry; i++)
+            half[i] = rx;
+        return;
+    }
+
+    oh = oi = oj = ok = 0xFFFF;
+
+    if (rx > ry)
+    {
+        ix = 0;
+        iy = rx * 64;
+
+        do
+        {
+            h = (ix + 32) >> 6;
+            i = (iy + 32) >> 6;
+            j = (h * ry) / rx;
+            k = (i * ry) / rx;
+
+            if ((ok != k) && (oj != k))
+            {
+                _HALF_WIDTH(k, h);
+                ok = k;
+            }
+            if ((oj != j) && (ok != j) && (k != j))
+            {
+                _HALF_WIDTH(j, i);
+                oj = j;
+            }
+
+            ix = ix + iy / rx;
+            iy = iy - ix / rx;
+        }
+        while (i > h);
+    }
+    else
+    {
+        ix = 0;
+        iy = ry * 64;
+
+        do
+        {
+            h = (ix + 32) >> 6;
+            i = (iy + 32) >> 6;
+            j = (h * rx) / ry;
+            k = (i * rx) / ry;
+
+            if ((oi != i) && (oh != i))
+            {
+                _HALF_WIDTH(i, j);
+                oi = i;
+            }
+            if ((oh != h) && (oi != h) && (i != h))
+            {
+                _HALF_WIDTH(h, k);
+                oh = h;
+            }
+            ix = ix + iy / ry;
+            iy = iy - ix / ry;
+        }
+        while (i > h);
+    }
+}
+#undef _HALF_WIDTH
+
+rt_inline int _span_push(struct rtgui_dc *dc, struct rtgui_span *spans, int num,
+                         int x1, int x2, int y)
+{
+    if (num == RTGUI_SPAN_BATCH)
+    {
+        rtgui_dc_fill_spans(dc, spans, num);
+        num = 0;
+    }
+
+    spans[num].x1 = x1;
+    spans[num].x2 = x2;
+    spans[num].y  = y;
+
+    return num + 1;
+}
+
+static void _dc_fill_round_spans(struct rtgui_dc *dc, int x1, int y1, int x2, int y2,
+                                 int rx, int ry, rt_bool_t circle)
+{
+    rt_int16_t buffer[RTGUI_SPAN_BATCH], *half;
+    struct rtgui_span spans[RTGUI_SPAN_BATCH];
+    int row, num;
+
+    if (rx < 0 || ry < 0) return;
+
+    if (ry < RTGUI_SPAN_BATCH)
+    {
+        half = buffer;
+    }
+    else
+    {
+        half = (rt_int16_t *) rtgui_malloc(sizeof(rt_int16_t) * (ry + 1));
+        if (half == RT_NULL) return; /* no memory, failed */
+    }
+
+    for (row = 0; row <= ry; row++)
+        half[row] = -1;
+    if (circle == RT_TRUE)
+        _circle_half_widths(ry, half);
+    else
+        _ellipse_half_widths(rx, ry, half);
+
+    /* the rows from top to bottom */
+    num = 0;
+    for (row = ry; row >= 0; row--)
+    {
+        if (half[row] >= 0)
+            num = _span_push(dc, spans, num, x1 - half[row], x2 + half[row], y1 - row);
+    }
+    for (row = (y1 == y2) ? 1 : 0; row <= ry; row++)
+    {
+        if (half[row] >= 0)
+            num = _span_push(dc, spans, num, x1 - half[row], x2 + half[row], y2 + row);
+    }
+    if (num)
+        rtgui_dc_fill_spans(dc, spans, num);
+
+    if (half != buffer)
+        rtgui_free(half);
+}
+
+void rtgui_dc_fill_round_spans(struct rtgui_dc *dc, int x1, int y1, int x2, int y2, int rx, int ry)
+{
+    _dc_fill_round_spans(dc, x1, y1, x2, y2, rx, ry, rx == ry);
+}
+RTM_EXPORT(rtgui_dc_fill_round_spans);
+
 void rtgui_dc_fill_circle(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r)
 {
     /*
@@ -664,7 +1241,7 @@ void rtgui_dc_fill_circle(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_in
         return;
     }
 
-    _fill_quarter_circle(dc, x, y, r, QUARTER_FULL);
+    _dc_fill_round_spans(dc, x, y, x, y, r, r, RT_TRUE);
 }
 RTM_EXPORT(rtgui_dc_fill_circle);
 
@@ -1018,163 +1595,22 @@ void rtgui_dc_draw_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_i
                 if (j > 0)
                 {
                     ypj = y + j;
-                    ymj = y - j;
-                    rtgui_dc_draw_point(dc, xmi, ypj);
-                    rtgui_dc_draw_point(dc, xpi, ypj);
-                    rtgui_dc_draw_point(dc, xmi, ymj);
-                    rtgui_dc_draw_point(dc, xpi, ymj);
-                }
-                else
-                {
-                    rtgui_dc_draw_point(dc, xmi, y);
-                    rtgui_dc_draw_point(dc, xpi, y);
-                }
-                oj = j;
-            }
-
-            ix = ix + iy / rx;
-            iy = iy - ix / rx;
-        }
-        while (i > h);
-    }
-    else
-    {
-        ix = 0;
-        iy = ry * 64;
-
-        do
-        {
-            h = (ix + 32) >> 6;
-            i = (iy + 32) >> 6;
-            j = (h * rx) / ry;
-            k = (i * rx) / ry;
-
-            if (((oi != i) && (oh != i)) || ((oh != h) && (oi != h) && (i != h)))
-            {
-                xmj = x - j;
-                xpj = x + j;
-                if (i > 0)
-                {
-                    ypi = y + i;
-                    ymi = y - i;
-                    rtgui_dc_draw_point(dc, xmj, ypi);
-                    rtgui_dc_draw_point(dc, xpj, ypi);
-                    rtgui_dc_draw_point(dc, xmj, ymi);
-                    rtgui_dc_draw_point(dc, xpj, ymi);
-                }
-                else
-                {
-                    rtgui_dc_draw_point(dc, xmj, y);
-                    rtgui_dc_draw_point(dc, xpj, y);
-                }
-                oi = i;
-                xmk = x - k;
-                xpk = x + k;
-                if (h > 0)
-                {
-                    yph = y + h;
-                    ymh = y - h;
-                    rtgui_dc_draw_point(dc, xmk, yph);
-                    rtgui_dc_draw_point(dc, xpk, yph);
-                    rtgui_dc_draw_point(dc, xmk, ymh);
-                    rtgui_dc_draw_point(dc, xpk, ymh);
-                }
-                else
-                {
-                    rtgui_dc_draw_point(dc, xmk, y);
-                    rtgui_dc_draw_point(dc, xpk, y);
-                }
-                oh = h;
-            }
-
-            ix = ix + iy / ry;
-            iy = iy - ix / ry;
-        }
-        while (i > h);
-    }
-}
-RTM_EXPORT(rtgui_dc_draw_ellipse);
-
-void rtgui_dc_fill_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry)
-{
-    int ix, iy;
-    int h, i, j, k;
-    int oh, oi, oj, ok;
-    int xmh, xph;
-    int xmi, xpi;
-    int xmj, xpj;
-    int xmk, xpk;
-
-    /*
-     * Special case for rx=0 - draw a vline
-     */
-    if (rx == 0)
-    {
-        rtgui_dc_draw_vline(dc, x, y - ry, y + ry);
-        return;
-    }
-
-    /* special case for ry=0 - draw a hline  */
-    if (ry == 0)
-    {
-        rtgui_dc_draw_hline(dc, x - rx, x + rx, y);
-        return;
-    }
-
-    /*
-     * Init vars
-     */
-    oh = oi = oj = ok = 0xFFFF;
-
-    /*
-     * Draw
-     */
-    if (rx > ry)
-    {
-        ix = 0;
-        iy = rx * 64;
-
-        do
-        {
-            h = (ix + 32) >> 6;
-            i = (iy + 32) >> 6;
-            j = (h * ry) / rx;
-            k = (i * ry) / rx;
-
-            if ((ok != k) && (oj != k))
-            {
-                xph = x + h;
-                xmh = x - h;
-                if (k > 0)
-                {
-                    rtgui_dc_draw_hline(dc, xmh, xph, y + k);
-                    rtgui_dc_draw_hline(dc, xmh, xph, y - k);
-                }
-                else
-                {
-                    rtgui_dc_draw_hline(dc, xmh, xph, y);
-                }
-                ok = k;
-            }
-            if ((oj != j) && (ok != j) && (k != j))
-            {
-                xmi = x - i;
-                xpi = x + i;
-                if (j > 0)
-                {
-                    rtgui_dc_draw_hline(dc, xmi, xpi, y + j);
-                    rtgui_dc_draw_hline(dc, xmi, xpi, y - j);
+                    ymj = y - j;
+                    rtgui_dc_draw_point(dc, xmi, ypj);
+                    rtgui_dc_draw_point(dc, xpi, ypj);
+                    rtgui_dc_draw_point(dc, xmi, ymj);
+                    rtgui_dc_draw_point(dc, xpi, ymj);
                 }
                 else
                 {
-                    rtgui_dc_draw_hline(dc, xmi, xpi, y);
+                    rtgui_dc_draw_point(dc, xmi, y);
+                    rtgui_dc_draw_point(dc, xpi, y);
                 }
                 oj = j;
             }
 
             ix = ix + iy / rx;
             iy = iy - ix / rx;
-
         }
         while (i > h);
     }
@@ -1190,42 +1626,72 @@ void rtgui_dc_fill_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_i
             j = (h * rx) / ry;
             k = (i * rx) / ry;
 
-            if ((oi != i) && (oh != i))
+            if (((oi != i) && (oh != i)) || ((oh != h) && (oi != h) && (i != h)))
             {
                 xmj = x - j;
                 xpj = x + j;
                 if (i > 0)
                 {
-                    rtgui_dc_draw_hline(dc, xmj, xpj, y + i);
-                    rtgui_dc_draw_hline(dc, xmj, xpj, y - i);
+                    ypi = y + i;
+                    ymi = y - i;
+                    rtgui_dc_draw_point(dc, xmj, ypi);
+                    rtgui_dc_draw_point(dc, xpj, ypi);
+                    rtgui_dc_draw_point(dc, xmj, ymi);
+                    rtgui_dc_draw_point(dc, xpj, ymi);
                 }
                 else
                 {
-                    rtgui_dc_draw_hline(dc, xmj, xpj, y);
+                    rtgui_dc_draw_point(dc, xmj, y);
+                    rtgui_dc_draw_point(dc, xpj, y);
                 }
                 oi = i;
-            }
-            if ((oh != h) && (oi != h) && (i != h))
-            {
                 xmk = x - k;
                 xpk = x + k;
                 if (h > 0)
                 {
-                    rtgui_dc_draw_hline(dc, xmk, xpk, y + h);
-                    rtgui_dc_draw_hline(dc, xmk, xpk, y - h);
+                    yph = y + h;
+                    ymh = y - h;
+                    rtgui_dc_draw_point(dc, xmk, yph);
+                    rtgui_dc_draw_point(dc, xpk, yph);
+                    rtgui_dc_draw_point(dc, xmk, ymh);
+                    rtgui_dc_draw_point(dc, xpk, ymh);
                 }
                 else
                 {
-                    rtgui_dc_draw_hline(dc, xmk, xpk, y);
+                    rtgui_dc_draw_point(dc, xmk, y);
+                    rtgui_dc_draw_point(dc, xpk, y);
                 }
                 oh = h;
             }
+
             ix = ix + iy / ry;
             iy = iy - ix / ry;
         }
         while (i > h);
     }
 }
+RTM_EXPORT(rtgui_dc_draw_ellipse);
+
+void rtgui_dc_fill_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry)
+{
+    /*
+     * Special case for rx=0 - draw a vline
+     */
+    if (rx == 0)
+    {
+        rtgui_dc_draw_vline(dc, x, y - ry, y + ry);
+        return;
+    }
+
+    /* special case for ry=0 - draw a hline  */
+    if (ry == 0)
+    {
+        rtgui_dc_draw_hline(dc, x - rx, x + rx, y);
+        return;
+    }
+
+    _dc_fill_round_spans(dc, x, y, x, y, rx, ry, RT_FALSE);
+}
 RTM_EXPORT(rtgui_dc_fill_ellipse);
 
 void rtgui_dc_draw_pie(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t rad, rt_int16_t start, rt_int16_t end)
@@ -1324,151 +1790,211 @@ void rtgui_dc_draw_pie(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16
 }
 RTM_EXPORT(rtgui_dc_draw_pie);
 
+/* the rays of sector in 1/16384 */
+#define SECTOR_SHIFT    14
+#define SECTOR_INF      0x7fff
+
+struct _sector_range
+{
+    int lo, hi;
+};
+
+rt_inline int _div_floor(int a, int b)
+{
+    int q = a / b;
+
+    if ((a % b) != 0 && ((a < 0) != (b < 0)))
+        q --;
+    return q;
+}
+
 /*
- * Octant labelling
- *
- *  \ 5 | 6 /
- *   \  |  /
- *  4 \ | / 7
- *     \|/
- *------+------ +x
- *     /|\
- *  3 / | \ 0
- *   /  |  \
- *  / 2 | 1 \
- *      +y
+ * The x of row dy in sign * cross(V, P) >= 0, the point P = (x, dy) is on
+ * the clockwise side of ray V for sign 1.
  */
-static void _draw_octant(struct rtgui_dc *dc,
-                         rt_int16_t ox, rt_int16_t oy,
-                         rt_int16_t y1, rt_int16_t y2, rt_int16_t x, int oct)
+static void _sector_half(int vx, int vy, int dy, int sign, struct _sector_range *range)
 {
-    switch (oct % 8)
+    int c = sign * vx * dy, k = sign * vy;
+
+    if (k > 0)
     {
-    case 0:
-        rtgui_dc_draw_line(dc, ox +  x, oy + y1, ox +  x, oy + y2);
-        break;
-    case 1:
-        /* Ugly hack to get the edge right. */
-        y2 += 1;
-        y1 += 1;
-        x -= 1;
-        rtgui_dc_draw_line(dc, ox + y1, oy +  x, ox + y2, oy +  x);
-        break;
-    case 2:
-        y2 -= 1;
-        y1 -= 1;
-        x -= 1;
-        rtgui_dc_draw_line(dc, ox - y2, oy +  x, ox - y1, oy +  x);
-        break;
-    case 3:
-        x -= 1;
-        rtgui_dc_draw_line(dc, ox -  x, oy + y1, ox -  x, oy + y2);
-        break;
-    case 4:
-        x -= 1;
-        rtgui_dc_draw_line(dc, ox -  x, oy - y2, ox -  x, oy - y1);
-        break;
-    case 5:
-        y2 -= 1;
-        y1 -= 1;
-        rtgui_dc_draw_line(dc, ox - y2, oy -  x, ox - y1, oy -  x);
-        break;
-    case 6:
-        y2 += 1;
-        y1 += 1;
-        rtgui_dc_draw_line(dc, ox + y1, oy -  x, ox + y2, oy -  x);
-        break;
-    case 7:
-        rtgui_dc_draw_line(dc, ox +  x, oy - y2, ox +  x, oy - y1);
-        break;
-    };
+        range->lo = -SECTOR_INF;
+        range->hi = _div_floor(c, k);
+    }
+    else if (k < 0)
+    {
+        /* the ceil of c / k */
+        range->lo = -_div_floor(-c, k);
+        range->hi = SECTOR_INF;
+    }
+    else if (c >= 0)
+    {
+        range->lo = -SECTOR_INF;
+        range->hi = SECTOR_INF;
+    }
+    else
+    {
+        range->lo = SECTOR_INF;
+        range->hi = -SECTOR_INF;
+    }
 }
 
-static void _fill_small_pie(struct rtgui_dc *dc,
-                            rt_int16_t ox, rt_int16_t oy,
-                            rt_int16_t rad, rt_int16_t start, rt_int16_t end,
-                            int oct)
+/* the ranges of sector in row dy, 2 ranges at most */
+static int _sector_ranges(int sx, int sy, int ex, int ey, int dy, rt_bool_t wide,
+                          struct _sector_range *ranges)
 {
-    /* Midpoint circle algorithm. */
-    int dk, x, y;
-    /* Start X, end X, */
-    rt_int16_t sx, ex, ty, my;
-    enum {ST_NONE, ST_ARC, ST_TRI} st;
+    struct _sector_range c1, c2, t;
 
-    RT_ASSERT(0 <= start && start <= 45);
-    RT_ASSERT(0 <= end && end <= 45);
-    if (start == end)
-        return;
-    RT_ASSERT(start < end);
-    RT_ASSERT(rad > 0);
+    _sector_half(sx, sy, dy, 1, &c1);
+    _sector_half(ex, ey, dy, -1, &c2);
 
-    /* cos(90 - start) == sin(start) */
-    sx = rad * sin(start * M_PI / 180);
-    ex = rad * sin(end * M_PI / 180);
+    if (wide == RT_FALSE)
+    {
+        /* in the sector of 180 degrees at most, the both sides */
+        ranges[0].lo = c1.lo > c2.lo ? c1.lo : c2.lo;
+        ranges[0].hi = c1.hi < c2.hi ? c1.hi : c2.hi;
+        return ranges[0].lo <= ranges[0].hi ? 1 : 0;
+    }
 
-    dk = 1 - rad;
-    x = 0;
-    y = rad;
+    /* out of the sector between end and start, either side */
+    if (c1.lo > c1.hi)
+    {
+        ranges[0] = c2;
+        return c2.lo <= c2.hi ? 1 : 0;
+    }
+    if (c2.lo > c2.hi)
+    {
+        ranges[0] = c1;
+        return 1;
+    }
+    if (c2.lo < c1.lo)
+    {
+        t = c1;
+        c1 = c2;
+        c2 = t;
+    }
+    if (c2.lo <= c1.hi + 1)
+    {
+        ranges[0].lo = c1.lo;
+        ranges[0].hi = c1.hi > c2.hi ? c1.hi : c2.hi;
+        return 1;
+    }
+    ranges[0] = c1;
+    ranges[1] = c2;
+    return 2;
+}
 
-    st = ST_NONE;
-    my = ex;
-    while (x <= y)
+/*
+ * Fill the sector of annulus between the radius r1 and r2, from the angle
+ * start to end in degrees clockwise on screen. Each row is the spans of the
+ * ring clipped by the two rays of sector in the integer cross products, the
+ * sin and cos are calculated only for the rays.
+ */
+void rtgui_dc_fill_annulus(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r1, rt_int16_t r2,
+                           rt_int16_t start, rt_int16_t end)
+{
+    int row, dy, i, j, num, count;
+    int sx, sy, ex, ey, lo, hi;
+    rt_bool_t full, wide;
+    rt_int16_t buffer[RTGUI_SPAN_BATCH], *outer, *inner;
+    struct rtgui_span spans[RTGUI_SPAN_BATCH];
+    struct _sector_range ring[2], sector[2];
+
+    if (r1 > r2)
     {
-        rt_int16_t lx;
+        row = r1;
+        r1 = r2;
+        r2 = row;
+    }
+    if (r1 < 0) return;
+    if (start == end) return;
 
-        if (x < sx)
-        {
-        }
-        else if (x == sx)
-        {
-            /* Start point. */
-            st = ST_ARC;
-            ty = y;
-        }
-        else if (x <= ex)
+    full = (end - start >= 360 || start - end >= 360) ? RT_TRUE : RT_FALSE;
+    while (start < 0)
+    {
+        start += 360;
+        end   += 360;
+    }
+    while (start >= 360)
+    {
+        start -= 360;
+        end   -= 360;
+    }
+    while (end < start)
+        end += 360;
+    while (end - start > 360)
+        end -= 360;
+    wide = (end - start > 180) ? RT_TRUE : RT_FALSE;
+
+    sx = (int)(cos(start * M_PI / 180) * (1 << SECTOR_SHIFT));
+    sy = (int)(sin(start * M_PI / 180) * (1 << SECTOR_SHIFT));
+    ex = (int)(cos(end * M_PI / 180) * (1 << SECTOR_SHIFT));
+    ey = (int)(sin(end * M_PI / 180) * (1 << SECTOR_SHIFT));
+
+    if (r2 + r1 + 1 <= RTGUI_SPAN_BATCH)
+    {
+        outer = buffer;
+    }
+    else
+    {
+        outer = (rt_int16_t *) rtgui_malloc(sizeof(rt_int16_t) * (r2 + r1 + 1));
+        if (outer == RT_NULL) return; /* no memory, failed */
+    }
+    /* the hole is the inside of inner circle, which is in the annulus */
+    inner = outer + r2 + 1;
+    for (row = 0; row < r2 + r1 + 1; row++)
+        outer[row] = -1;
+    _circle_half_widths(r2, outer);
+    if (r1 > 0)
+        _circle_half_widths(r1 - 1, inner);
+
+    num = 0;
+    for (dy = -r2; dy <= r2; dy++)
+    {
+        row = dy < 0 ? -dy : dy;
+        if (outer[row] < 0)
+            continue;
+
+        if (r1 > 0 && row < r1 && inner[row] >= 0)
         {
-            /* Between the pie. */
-            RT_ASSERT(st == ST_ARC);
+            ring[0].lo = -outer[row];
+            ring[0].hi = -inner[row] - 1;
+            ring[1].lo = inner[row] + 1;
+            ring[1].hi = outer[row];
+            count = 2;
         }
-        else /* x > ex */
+        else
         {
-            /* End. */
-            st = ST_TRI;
-            my = y;
-            break;
+            ring[0].lo = -outer[row];
+            ring[0].hi = outer[row];
+            count = 1;
         }
 
-        /* Drawing. */
-        if (st == ST_ARC)
+        if (full == RT_TRUE)
         {
-            lx = y * sx / ty;
-            /* Change from math coordinate to plot coordinate. */
-            _draw_octant(dc, ox, oy, lx, x, y, oct);
+            for (i = 0; i < count; i++)
+                num = _span_push(dc, spans, num, x + ring[i].lo, x + ring[i].hi + 1, y + dy);
+            continue;
         }
 
-        /* Midpoint increment. */
-        if (dk > 0)
-        {
-            y--;
-            dk += 2 * (x - y) + 5;
-        }
-        else
+        for (j = _sector_ranges(sx, sy, ex, ey, dy, wide, sector) - 1; j >= 0; j--)
         {
-            dk += 2 * x + 3;
+            for (i = 0; i < count; i++)
+            {
+                lo = ring[i].lo > sector[j].lo ? ring[i].lo : sector[j].lo;
+                hi = ring[i].hi < sector[j].hi ? ring[i].hi : sector[j].hi;
+                if (lo <= hi)
+                    num = _span_push(dc, spans, num, x + lo, x + hi + 1, y + dy);
+            }
         }
-        x++;
     }
-    /* Draw bottom part. */
-    for (; y >= 0; y--)
-    {
-        rt_int16_t lx, rx;
-
-        lx = y * sx / ty;
-        rx = y * ex / my;
+    if (num)
+        rtgui_dc_fill_spans(dc, spans, num);
 
-        _draw_octant(dc, ox, oy, lx, rx, y, oct);
-    }
+    if (outer != buffer)
+        rtgui_free(outer);
 }
+RTM_EXPORT(rtgui_dc_fill_annulus);
 
 void rtgui_dc_fill_pie(struct rtgui_dc *dc,
                        rt_int16_t x, rt_int16_t y, rt_int16_t rad,
@@ -1488,54 +2014,8 @@ void rtgui_dc_fill_pie(struct rtgui_dc *dc,
         rtgui_dc_fill_circle(dc, x, y, rad);
         return;
     }
-    if (start == end)
-        return;
-
-    /*
-     * Fixup angles
-     */
-    while (start < 0)
-    {
-        start += 360;
-        end   += 360;
-    }
-    while (start >= 360)
-    {
-        start -= 360;
-        end   -= 360;
-    }
-
-    if (end < start)
-        end += 360;
-
-    while (start / 45 != end / 45)
-    {
-        /* The start and end are not in the same piece. */
-        if ((start / 45) % 2)
-        {
-            _fill_small_pie(dc, x, y, rad,
-                            0, 45 - start % 45, start / 45);
-            start += 45 - start % 45;
-        }
-        else
-        {
-            _fill_small_pie(dc, x, y, rad,
-                            start % 45, 45, start / 45);
-            start += 45 - start % 45;
-        }
-    }
-    if ((start / 45) % 2)
-    {
-        _fill_small_pie(dc, x, y, rad,
-                        90 - end % 90, 90 - start % 90, start / 45);
-    }
-    else
-    {
-        _fill_small_pie(dc, x, y, rad,
-                        start % 45, end % 45, start / 45);
-    }
 
-    return;
+    rtgui_dc_fill_annulus(dc, x, y, 0, rad, start, end);
 }
 RTM_EXPORT(rtgui_dc_fill_pie);
 
@@ -1619,6 +2099,22 @@ rtgui_gc_t *rtgui_dc_get_gc(struct rtgui_dc *dc)
 }
 RTM_EXPORT(rtgui_dc_get_gc);
 
+/* convert the colors of gc to the native pixels of pixel_format */
+void rtgui_gc_update_pixel(rtgui_gc_t *gc, rt_uint8_t pixel_format)
+{
+    RT_ASSERT(gc != RT_NULL);
+
+    gc->pixel_valid = 0;
+    if (rtgui_color_to_pixel(pixel_format, gc->foreground, &gc->fore_pixel) == RT_TRUE)
+        gc->pixel_valid |= 0x01;
+    if (rtgui_color_to_pixel(pixel_format, gc->background, &gc->back_pixel) == RT_TRUE)
+        gc->pixel_valid |= 0x02;
+    gc->pixel_foreground = gc->foreground;
+    gc->pixel_background = gc->background;
+    gc->pixel_format = pixel_format;
+}
+RTM_EXPORT(rtgui_gc_update_pixel);
+
 /*
  * get visible status of dc
  */
@@ -1806,9 +2302,148 @@ void rtgui_dc_rect_to_device(struct rtgui_dc *dc, struct rtgui_rect *rect)
 }
 RTM_EXPORT(rtgui_dc_rect_to_device);
 
-extern struct rt_mutex cursor_mutex;
+/*
+ * Punch a hole of the rect in the window, the pixels of hole on screen let the
+ * video or camera plane below be shown by the display controller. The hole is
+ * clipped as the drawing, and it's painted again in the paint of window.
+ */
+void rtgui_dc_punch_hole(struct rtgui_dc *dc, rtgui_rect_t *rect)
+{
+    rtgui_color_t bc;
+
+    RT_ASSERT(dc != RT_NULL && rect != RT_NULL);
+
+    /* the hole is in the GUI layer on screen */
+    if (dc->type != RTGUI_DC_CLIENT && dc->type != RTGUI_DC_HW)
+        return;
+
+    bc = RTGUI_DC_BC(dc);
+    RTGUI_DC_BC(dc) = rtgui_graphic_driver_overlay_hole(rtgui_graphic_driver_get_default());
+    rtgui_dc_fill_rect(dc, rect);
+    RTGUI_DC_BC(dc) = bc;
+}
+RTM_EXPORT(rtgui_dc_punch_hole);
+
+/*
+ * Scroll the pixels in the rect (in the logical coordinate of dc) by (dx, dy).
+ * Only the visible pixels are moved, and the area of rect which they do not
+ * cover is returned in @exposed (in the logical coordinate, RT_NULL if it's not
+ * needed) to be painted. The pixels are not moved on the driver without
+ * framebuffer, the whole visible rect is exposed then. The dc should be
+ * taken by rtgui_dc_begin_drawing, which locks the screen and hides cursor.
+ */
+rt_err_t rtgui_dc_scroll(struct rtgui_dc *dc, rtgui_rect_t *rect, int dx, int dy,
+                         rtgui_region_t *exposed)
+{
+    rt_err_t result = RT_EOK;
+    int x = 0, y = 0, pitch = 0;
+    rt_uint8_t format = 0, *pixels = RT_NULL;
+    rtgui_rect_t r, bound;
+    struct rtgui_region visible, moved;
+
+    RT_ASSERT(dc != RT_NULL);
+    RT_ASSERT(rect != RT_NULL);
+
+    r = *rect;
+    rtgui_dc_rect_to_device(dc, &r);
+    rtgui_region_init(&visible);
+
+    switch (dc->type)
+    {
+    case RTGUI_DC_CLIENT:
+    case RTGUI_DC_HW:
+    {
+        rtgui_widget_t *owner;
+        struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+        if (dc->type == RTGUI_DC_CLIENT)
+            owner = RTGUI_CONTAINER_OF(dc, struct rtgui_widget, dc_type);
+        else
+            owner = ((struct rtgui_dc_hw *)dc)->owner;
+        x = owner->extent.x1;
+        y = owner->extent.y1;
+
+        /* the hardware dc is used only when the whole widget is visible */
+        if (dc->type == RTGUI_DC_CLIENT)
+            rtgui_region_intersect_rect(&visible, &owner->clip, &r);
+        else
+            rtgui_region_reset(&visible, &r);
+        rtgui_graphic_driver_get_rect(driver, &bound);
+        rtgui_region_intersect_rect(&visible, &visible, &bound);
+
+        if (rtgui_dc_get_visible(dc) == RT_TRUE)
+        {
+            pixels = driver->framebuffer;
+            pitch = driver->pitch;
+            format = driver->pixel_format;
+        }
+        break;
+    }
+
+    case RTGUI_DC_BUFFER:
+    {
+        struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)dc;
+
+        rtgui_region_reset(&visible, &r);
+        bound.x1 = bound.y1 = 0;
+        bound.x2 = buffer->width;
+        bound.y2 = buffer->height;
+        rtgui_region_intersect_rect(&visible, &visible, &bound);
+
+        pixels = rtgui_dc_buffer_get_pixel(dc);
+        pitch = buffer->pitch;
+        format = buffer->pixel_format;
+        break;
+    }
+
+    default:
+        rtgui_region_reset(&visible, &r);
+        break;
+    }
+
+    if (pixels == RT_NULL)
+    {
+        result = -RT_ENOSYS;
+        if (exposed != RT_NULL)
+            rtgui_region_copy(exposed, &visible);
+    }
+    else
+    {
+        /* the visible pixels which are still visible after moved */
+        rtgui_region_init(&moved);
+        rtgui_region_copy(&moved, &visible);
+        rtgui_region_translate(&moved, dx, dy);
+        rtgui_region_intersect(&moved, &moved, &visible);
+
+        RTGUI_TRACE_BEGIN("dc scroll", rtgui_region_num_rects(&moved));
+        rtgui_blit_copy_region(pixels, pitch, format, &moved, dx, dy);
+        RTGUI_TRACE_END("dc scroll");
+
+        if (exposed != RT_NULL)
+            rtgui_region_subtract(exposed, &visible, &moved);
+        rtgui_region_fini(&moved);
+    }
+
+    if (exposed != RT_NULL)
+        rtgui_region_translate(exposed, -x, -y);
+    rtgui_region_fini(&visible);
+
+    return result;
+}
+RTM_EXPORT(rtgui_dc_scroll);
+
 extern void rtgui_mouse_show_cursor(void);
 extern void rtgui_mouse_hide_cursor(void);
+extern rt_bool_t rtgui_mouse_cursor_intersect(rtgui_rect_t *rect);
+extern void rtgui_mouse_drawing_begin(rtgui_rect_t *rect);
+extern void rtgui_mouse_drawing_end(void);
+
+/* the layer is switched in the whole screen lock */
+#if defined(GUIENGINE_USING_RECT_LOCK) && !defined(GUIENGINE_USING_COMPOSITOR)
+#define _rtgui_dc_screen_unlock()   rtgui_screen_unlock_rect()
+#else
+#define _rtgui_dc_screen_unlock()   rtgui_screen_unlock()
+#endif
 
 struct rtgui_dc *rtgui_dc_begin_drawing(rtgui_widget_t *owner)
 {
@@ -1861,7 +2496,21 @@ struct rtgui_dc *rtgui_dc_begin_drawing(rtgui_widget_t *owner)
         }
     }
 
+#if defined(GUIENGINE_USING_RECT_LOCK) && !defined(GUIENGINE_USING_COMPOSITOR)
+    rtgui_screen_lock_rect(&(RTGUI_WIDGET(win)->extent));
+#else
     rtgui_screen_lock(RT_WAITING_FOREVER);
+#endif
+#ifdef GUIENGINE_USING_COMPOSITOR
+    /* draw to the layer of window until the drawing ends */
+    if (win->drawing == 1 && win->layer != RT_NULL && rtgui_graphic_driver_is_vmode() == RT_FALSE)
+        rtgui_graphic_driver_layer_enter(win->layer);
+#endif
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    /* draw to the display of window until the drawing ends */
+    if (win->drawing == 1 && win->display != 0 && rtgui_graphic_driver_is_vmode() == RT_FALSE)
+        rtgui_graphic_driver_display_enter(win->display);
+#endif
 
     /* create client or hardware DC */
     if ((rtgui_region_is_flat(&owner->clip) == RT_EOK) &&
@@ -1874,13 +2523,34 @@ struct rtgui_dc *rtgui_dc_begin_drawing(rtgui_widget_t *owner)
     {
         /* restore drawing counter */
         win->drawing--;
-        rtgui_screen_unlock();
+#ifdef GUIENGINE_USING_COMPOSITOR
+        if (win->drawing == 0 && win->layer != RT_NULL)
+            rtgui_graphic_driver_layer_exit(win->layer);
+#endif
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+        if (win->drawing == 0 && win->display != 0)
+            rtgui_graphic_driver_display_exit();
+#endif
+        _rtgui_dc_screen_unlock();
     }
     else if (win->drawing == 1 && rtgui_graphic_driver_is_vmode() == RT_FALSE)
     {
-#ifdef RTGUI_USING_MOUSE_CURSOR
-        rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
-        rtgui_mouse_hide_cursor();
+        /* the cursor is over the composited screen, not the layer */
+#if defined(RTGUI_USING_MOUSE_CURSOR) && !defined(GUIENGINE_USING_COMPOSITOR)
+        /* the cursor is on the main display */
+        if (RTGUI_WIN_DISPLAY(win) == 0)
+        {
+#ifdef GUIENGINE_USING_RECT_LOCK
+            /* the cursor can not be moved across the window locked, so only the
+             * cursor over the window is hidden until the drawing ends */
+            if (rtgui_mouse_cursor_intersect(&(RTGUI_WIDGET(win)->extent)))
+                rtgui_mouse_hide_cursor();
+#else
+            /* only the cursor over the window is hidden, and it's not moved
+             * into the window until the drawing ends */
+            rtgui_mouse_drawing_begin(&(RTGUI_WIDGET(win)->extent));
+#endif
+        }
 #endif
 
         if (! RTGUI_IS_WINTITLE(win))
@@ -1894,6 +2564,11 @@ struct rtgui_dc *rtgui_dc_begin_drawing(rtgui_widget_t *owner)
         }
     }
 
+#ifdef GUIENGINE_USING_PROFILE
+    if (dc != RT_NULL && win->drawing == 1)
+        rtgui_profile_drawing_begin(win);
+#endif
+
     return dc;
 }
 RTM_EXPORT(rtgui_dc_begin_drawing);
@@ -1921,6 +2596,20 @@ void rtgui_dc_end_drawing(struct rtgui_dc *dc, rt_bool_t update)
 
     if (win->drawing == 0)
     {
+        /* the spans combined are written before the cursor is shown */
+        rtgui_graphic_driver_flush(rtgui_graphic_driver_get_default());
+#if defined(RTGUI_USING_MOUSE_CURSOR) && !defined(GUIENGINE_USING_COMPOSITOR)
+        if (rtgui_graphic_driver_is_vmode() == RT_FALSE && RTGUI_WIN_DISPLAY(win) == 0)
+        {
+#ifdef GUIENGINE_USING_RECT_LOCK
+            if (rtgui_mouse_cursor_intersect(&(RTGUI_WIDGET(win)->extent)))
+                rtgui_mouse_show_cursor();
+#else
+            rtgui_mouse_drawing_end();
+#endif
+        }
+#endif
+
         /* notify window to handle window update done */
         if (RTGUI_OBJECT(win)->event_handler)
         {
@@ -1934,10 +2623,17 @@ void rtgui_dc_end_drawing(struct rtgui_dc *dc, rt_bool_t update)
 
         if (rtgui_graphic_driver_is_vmode() == RT_FALSE && win->update == 0 && update)
         {
-#ifdef RTGUI_USING_MOUSE_CURSOR
-            rt_mutex_release(&cursor_mutex);
-            /* show cursor */
-            rtgui_mouse_show_cursor();
+#ifdef GUIENGINE_USING_LATENCY
+            struct rtgui_app *app = rtgui_app_self();
+            rt_uint32_t stamp = 0;
+#endif
+#ifdef GUIENGINE_USING_LATENCY
+            /* the first update after an input is for it */
+            if (app != RT_NULL)
+            {
+                stamp = app->input_stamp;
+                app->input_stamp = 0;
+            }
 #endif
 
             if (RTGUI_IS_WINTITLE(win))
@@ -1945,20 +2641,43 @@ void rtgui_dc_end_drawing(struct rtgui_dc *dc, rt_bool_t update)
                 /* update screen */
                 rtgui_graphic_driver_screen_update(rtgui_graphic_driver_get_default(),
                                                    &(owner->extent));
+#ifdef GUIENGINE_USING_LATENCY
+                if (stamp != 0)
+                    rtgui_latency_add(stamp);
+#endif
             }
             else
             {
                 /* send to server for window update */
                 struct rtgui_event_update_end eupdate;
                 RTGUI_EVENT_UPDATE_END_INIT(&(eupdate));
+                eupdate.wid = win;
                 eupdate.rect = owner->extent;
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+                eupdate.display = win->display;
+#endif
+#ifdef GUIENGINE_USING_LATENCY
+                eupdate.parent.stamp = stamp;
+#endif
 
                 rtgui_server_post_event((struct rtgui_event *)&eupdate, sizeof(eupdate));
             }
         }
+
+#ifdef GUIENGINE_USING_PROFILE
+        rtgui_profile_drawing_end(win);
+#endif
     }
 
     dc->engine->fini(dc);
-    rtgui_screen_unlock();
+#ifdef GUIENGINE_USING_COMPOSITOR
+    if (win->drawing == 0 && win->layer != RT_NULL)
+        rtgui_graphic_driver_layer_exit(win->layer);
+#endif
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    if (win->drawing == 0 && win->display != 0)
+        rtgui_graphic_driver_display_exit();
+#endif
+    _rtgui_dc_screen_unlock();
 }
 RTM_EXPORT(rtgui_dc_end_drawing);
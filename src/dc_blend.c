@@ -70,9 +70,12 @@
 
   Andreas Schiffler -- aschiffler at ferzkopp dot net
 */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
 
 #include <rtgui/dc.h>
 #include <rtgui/dc_draw.h>
+#include <rtgui/dc_path.h>
+#include <rtgui/rtgui_system.h>
 #include <rtgui/color.h>
 #include <string.h>
 
@@ -124,6 +127,8 @@ rt_inline rt_uint8_t* _dc_get_pixel(struct rtgui_dc* dc, int x, int y)
         pixel = (rt_uint8_t*)(hw_driver->framebuffer);
         if (pixel == RT_NULL) return RT_NULL;
 
+        rtgui_graphic_driver_accel_sync();
+
         pixel = pixel + y * hw_driver->pitch + x * (_UI_BITBYTES(hw_driver->bits_per_pixel));
     }
     else if (dc->type == RTGUI_DC_BUFFER)
@@ -132,7 +137,10 @@ rt_inline rt_uint8_t* _dc_get_pixel(struct rtgui_dc* dc, int x, int y)
 
         dc_buffer = (struct rtgui_dc_buffer*)dc;
 
-        pixel = dc_buffer->pixel + y * dc_buffer->pitch +
+        pixel = rtgui_dc_buffer_get_pixel(dc);
+        if (pixel == RT_NULL) return RT_NULL;
+
+        pixel = pixel + y * dc_buffer->pitch +
                 x * rtgui_color_get_bpp(dc_buffer->pixel_format);
     }
 
@@ -591,43 +599,160 @@ void rtgui_dc_draw_aa_line(struct rtgui_dc * dst, int x1, int y1, int x2, int y2
 }
 RTM_EXPORT(rtgui_dc_draw_aa_line);
 
-void rtgui_dc_draw_aa_lines(struct rtgui_dc * dst, const struct rtgui_point * points, int count)
+rt_inline void _polyline_segment(struct rtgui_dc *dst, DrawLineFunc func, rtgui_color_t color,
+                                 const rtgui_rect_t *rect, rt_bool_t inside,
+                                 int x1, int y1, int x2, int y2)
 {
-    int i;
-    int x1, y1;
-    int x2, y2;
+    if (inside == RT_FALSE && _intersect_rect_line(rect, &x1, &y1, &x2, &y2) == RT_FALSE)
+        return;
+
+    func(dst, x1, y1, x2, y2, color, RT_FALSE);
+}
+
+/* the segments in one clip rect, the points in the same column are drawn in a vertical line */
+static void _do_draw_polyline(struct rtgui_dc *dst, DrawLineFunc func, rtgui_color_t color,
+                              const struct rtgui_point *points, int count, int dx, int dy,
+                              const rtgui_rect_t *rect, rt_bool_t inside)
+{
+    int i, x1, y1, x2, y2, miny, maxy;
+
+    x1 = points[0].x + dx;
+    y1 = points[0].y + dy;
+    for (i = 1; i < count; i ++)
+    {
+        x2 = points[i].x + dx;
+        y2 = points[i].y + dy;
+        if (x2 == x1)
+        {
+            miny = maxy = y1;
+            for (; i < count && points[i].x + dx == x1; i ++)
+            {
+                y2 = points[i].y + dy;
+                if (y2 < miny) miny = y2;
+                if (y2 > maxy) maxy = y2;
+            }
+            i --;
+
+            if (miny != maxy)
+                _polyline_segment(dst, func, color, rect, inside, x1, miny, x1, maxy);
+            y1 = y2;
+            continue;
+        }
+
+        _polyline_segment(dst, func, color, rect, inside, x1, y1, x2, y2);
+        x1 = x2;
+        y1 = y2;
+    }
+}
+
+/*
+ * Draw the AA polyline from points[start], the chart appending points draws
+ * only the new segments from the last point drawn. The drawing function and
+ * the clip are resolved once: the clip rects out of the bound of polyline
+ * are skipped, and the segments in a rect containing the bound are not
+ * clipped. The points in one pixel column, of a chart zoomed out, are merged
+ * to one vertical line.
+ */
+void rtgui_dc_draw_aa_polyline(struct rtgui_dc *dst, const struct rtgui_point *points,
+                               int count, int start)
+{
+    int i, dx, dy, num;
+    rtgui_rect_t bound, buffer_rect, *rects;
     rtgui_color_t color;
+    DrawLineFunc func;
+    rt_bool_t inside;
 
-    RT_ASSERT(dst);
+    RT_ASSERT(dst != RT_NULL);
+    if (start < 0 || count - start < 2)
+        return;
     if (!rtgui_dc_get_visible(dst))
         return;
     /* we do not support pixel DC */
-    if (_dc_get_pixel(dst, 0, 0) == RT_NULL)
+    if (_dc_get_pixel(dst, 0, 0) == RT_NULL || _dc_get_bits_per_pixel(dst) < 8)
+        return;
+
+    func = _dc_calc_draw_line_func(_dc_get_bits_per_pixel(dst) / 8);
+    if (!func)
+    {
+        rt_kprintf("dc_draw_polyline(): Unsupported pixel format\n");
         return;
+    }
 
     color = rtgui_dc_get_gc(dst)->foreground;
+    points += start;
+    count -= start;
 
-    for (i = 1; i < count; ++i)
+    dx = dy = 0;
+    if (dst->type == RTGUI_DC_CLIENT || dst->type == RTGUI_DC_HW)
     {
-        rt_bool_t draw_end;
+        rtgui_widget_t *owner;
 
-        x1 = points[i-1].x;
-        y1 = points[i-1].y;
-        x2 = points[i].x;
-        y2 = points[i].y;
+        if (dst->type == RTGUI_DC_CLIENT)
+            owner = RTGUI_CONTAINER_OF(dst, struct rtgui_widget, dc_type);
+        else
+            owner = ((struct rtgui_dc_hw *)dst)->owner;
 
-        /* Draw the end if it was clipped */
-        draw_end = (x2 != points[i].x || y2 != points[i].y);
-        _do_draw_line(dst, color, x1, y1, x2, y2, draw_end);
+        dx = owner->extent.x1;
+        dy = owner->extent.y1;
+        if (dst->type == RTGUI_DC_CLIENT)
+        {
+            rects = rtgui_region_rects(&(owner->clip));
+            num = rtgui_region_num_rects(&(owner->clip));
+        }
+        else
+        {
+            /* no clip */
+            rects = &(owner->clip.extents);
+            num = 1;
+        }
+    }
+    else
+    {
+        struct rtgui_dc_buffer *pbf = (struct rtgui_dc_buffer *)dst;
+
+        rtgui_rect_init(&buffer_rect, 0, 0, pbf->width, pbf->height);
+        rects = &buffer_rect;
+        num = 1;
+    }
+
+    /* the bound of polyline, x2 and y2 are included */
+    bound.x1 = bound.x2 = points[0].x + dx;
+    bound.y1 = bound.y2 = points[0].y + dy;
+    for (i = 1; i < count; i ++)
+    {
+        if (points[i].x + dx < bound.x1) bound.x1 = points[i].x + dx;
+        else if (points[i].x + dx > bound.x2) bound.x2 = points[i].x + dx;
+        if (points[i].y + dy < bound.y1) bound.y1 = points[i].y + dy;
+        else if (points[i].y + dy > bound.y2) bound.y2 = points[i].y + dy;
+    }
+
+    for (i = 0; i < num; i ++)
+    {
+        if (bound.x2 < rects[i].x1 || bound.x1 >= rects[i].x2 ||
+                bound.y2 < rects[i].y1 || bound.y1 >= rects[i].y2)
+            continue;
+
+        inside = (bound.x1 >= rects[i].x1 && bound.x2 < rects[i].x2 &&
+                  bound.y1 >= rects[i].y1 && bound.y2 < rects[i].y2);
+        _do_draw_polyline(dst, func, color, points, count, dx, dy, &rects[i], inside);
     }
+}
+RTM_EXPORT(rtgui_dc_draw_aa_polyline);
+
+void rtgui_dc_draw_aa_lines(struct rtgui_dc * dst, const struct rtgui_point * points, int count)
+{
+    RT_ASSERT(dst);
+    if (count < 2)
+        return;
+
+    rtgui_dc_draw_aa_polyline(dst, points, count, 0);
 
     if (points[0].x != points[count-1].x || points[0].y != points[count-1].y)
     {
         rtgui_dc_draw_point(dst, points[count-1].x, points[count-1].y);
     }
-
-    return ;
 }
+RTM_EXPORT(rtgui_dc_draw_aa_lines);
 
 static int
 _dc_blend_point_rgb565(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode, rt_uint8_t r,
@@ -701,6 +826,30 @@ _dc_blend_point_rgb888(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE
     return 0;
 }
 
+static int
+_dc_blend_point_a8(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode,
+                   rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
+{
+    unsigned inva = 0xff - a;
+
+    switch (blendMode)
+    {
+    case RTGUI_BLENDMODE_BLEND:
+        DRAW_SETPIXELXY_BLEND_A8(x, y);
+        break;
+    case RTGUI_BLENDMODE_ADD:
+        DRAW_SETPIXELXY_ADD_A8(x, y);
+        break;
+    case RTGUI_BLENDMODE_MOD:
+        DRAW_SETPIXELXY_MOD_A8(x, y);
+        break;
+    default:
+        DRAW_SETPIXELXY_A8(x, y);
+        break;
+    }
+    return 0;
+}
+
 static int
 _dc_blend_point_argb8888(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode,
                          rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
@@ -725,10 +874,87 @@ _dc_blend_point_argb8888(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMO
     return 0;
 }
 
+static int
+_dc_blend_point_argb4444(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode,
+                         rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
+{
+    unsigned inva = 0xff - a;
+
+    switch (blendMode)
+    {
+    case RTGUI_BLENDMODE_BLEND:
+        DRAW_SETPIXELXY_BLEND_ARGB4444(x, y);
+        break;
+    case RTGUI_BLENDMODE_ADD:
+        DRAW_SETPIXELXY_ADD_ARGB4444(x, y);
+        break;
+    case RTGUI_BLENDMODE_MOD:
+        DRAW_SETPIXELXY_MOD_ARGB4444(x, y);
+        break;
+    default:
+        DRAW_SETPIXELXY_ARGB4444(x, y);
+        break;
+    }
+    return 0;
+}
+
+static int
+_dc_blend_point_rgb332(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode, rt_uint8_t r,
+                       rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
+{
+    unsigned inva = 0xff - a;
+
+    switch (blendMode)
+    {
+    case RTGUI_BLENDMODE_BLEND:
+        DRAW_SETPIXELXY_BLEND_RGB332(x, y);
+        break;
+    case RTGUI_BLENDMODE_ADD:
+        DRAW_SETPIXELXY_ADD_RGB332(x, y);
+        break;
+    case RTGUI_BLENDMODE_MOD:
+        DRAW_SETPIXELXY_MOD_RGB332(x, y);
+        break;
+    default:
+        DRAW_SETPIXELXY_RGB332(x, y);
+        break;
+    }
+    return 0;
+}
+
+typedef int (*BlendPointFunc) (struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode,
+                               rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a);
+
+static BlendPointFunc
+_dc_blend_point_func(rt_uint8_t pixel_format)
+{
+    switch (pixel_format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565, _dc_blend_point_rgb565);
+    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_BGR565, _dc_blend_point_bgr565);
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB888, _dc_blend_point_rgb888);
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        return _dc_blend_point_argb8888;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_ARGB4444, _dc_blend_point_argb4444);
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB332, _dc_blend_point_rgb332);
+    case RTGRAPHIC_PIXEL_FORMAT_ALPHA:
+        return _dc_blend_point_a8;
+    }
+
+    return RT_NULL;
+}
+
 void
 rtgui_dc_blend_point(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE blendMode, rt_uint8_t r,
                      rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
 {
+    BlendPointFunc func;
+
     RT_ASSERT(dst != RT_NULL);
 
     /* Negative coordinates are always invisible. */
@@ -780,23 +1006,9 @@ rtgui_dc_blend_point(struct rtgui_dc * dst, int x, int y, enum RTGUI_BLENDMODE b
         b = DRAW_MUL(b, a);
     }
 
-    switch (rtgui_dc_get_pixel_format(dst))
-    {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        _dc_blend_point_rgb565(dst, x, y, blendMode, r, g, b, a);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
-        _dc_blend_point_bgr565(dst, x, y, blendMode, r, g, b, a);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        _dc_blend_point_rgb888(dst, x, y, blendMode, r, g, b, a);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        _dc_blend_point_argb8888(dst, x, y, blendMode, r, g, b, a);
-        break;
-    default:
-        break;
-    }
+    func = _dc_blend_point_func(rtgui_dc_get_pixel_format(dst));
+    if (func != RT_NULL)
+        func(dst, x, y, blendMode, r, g, b, a);
 }
 RTM_EXPORT(rtgui_dc_blend_point);
 
@@ -806,8 +1018,7 @@ rtgui_dc_blend_points(struct rtgui_dc *dst, const rtgui_point_t *points, int cou
 {
     int i;
     int x, y;
-    int (*func)(struct rtgui_dc * dst, int x, int y,
-                enum RTGUI_BLENDMODE blendMode, rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a) = NULL;
+    BlendPointFunc func;
 
     RT_ASSERT(dst != RT_NULL);
     if (!rtgui_dc_get_visible(dst)) return;
@@ -822,19 +1033,9 @@ rtgui_dc_blend_points(struct rtgui_dc *dst, const rtgui_point_t *points, int cou
     }
 
     /* FIXME: Does this function pointer slow things down significantly? */
-    switch (rtgui_dc_get_pixel_format(dst))
-    {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        func = _dc_blend_point_rgb565;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        func = _dc_blend_point_rgb888;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        func = _dc_blend_point_argb8888;
-    default:
+    func = _dc_blend_point_func(rtgui_dc_get_pixel_format(dst));
+    if (func == RT_NULL)
         return;
-    }
 
     /* get owner */
     if (dst->type == RTGUI_DC_CLIENT)
@@ -1309,81 +1510,295 @@ _dc_blend_line_argb8888(struct rtgui_dc * dst, int x1, int y1, int x2, int y2,
     }
 }
 
-typedef void (*BlendLineFunc) (struct rtgui_dc * dst,
-                               int x1, int y1, int x2, int y2,
-                               enum RTGUI_BLENDMODE blendMode,
-                               rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a,
-                               rt_bool_t draw_end);
-
-static BlendLineFunc
-_dc_calc_blend_line_func(rt_uint8_t pixel_format)
+static void
+_dc_blend_line_argb4444(struct rtgui_dc * dst, int x1, int y1, int x2, int y2,
+                        enum RTGUI_BLENDMODE blendMode, rt_uint8_t _r, rt_uint8_t _g, rt_uint8_t _b, rt_uint8_t _a,
+                        rt_bool_t draw_end)
 {
-    switch (pixel_format)
+    unsigned r, g, b, a, inva;
+
+    if (blendMode == RTGUI_BLENDMODE_BLEND || blendMode == RTGUI_BLENDMODE_ADD)
     {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        return _dc_blend_line_rgb565;
-    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
-        return _dc_blend_line_bgr565;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        return _dc_blend_line_rgb888;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        return _dc_blend_line_argb8888;
+        r = DRAW_MUL(_r, _a);
+        g = DRAW_MUL(_g, _a);
+        b = DRAW_MUL(_b, _a);
+        a = _a;
     }
-
-    return NULL;
-}
-
-static void _do_blend_line(struct rtgui_dc * dst,
-                           rtgui_color_t color,
-                           int x1, int y1,
-                           int x2, int y2,
-                           enum RTGUI_BLENDMODE blendMode,
-                           rt_bool_t draw_end)
-{
-    BlendLineFunc func;
-    rt_uint8_t pixel_format;
-    rt_uint8_t r, g, b, a;
-    rtgui_widget_t *owner;
-
-    pixel_format = rtgui_dc_get_pixel_format(dst);
-    func = _dc_calc_blend_line_func(pixel_format);
-    if (!func)
+    else
     {
-        rt_kprintf("dc_blend_line(): Unsupported pixel format\n");
-        return;
+        r = _r;
+        g = _g;
+        b = _b;
+        a = _a;
     }
+    inva = (a ^ 0xff);
 
-    r = RTGUI_RGB_R(color);
-    g = RTGUI_RGB_G(color);
-    b = RTGUI_RGB_B(color);
-    a = RTGUI_RGB_A(color);
-
-    /* perform clip */
-    if (dst->type == RTGUI_DC_CLIENT)
+    if (y1 == y2)
     {
-        /* get owner */
-        owner = RTGUI_CONTAINER_OF(dst, struct rtgui_widget, dc_type);
-
-        x1 = x1 + owner->extent.x1;
-        x2 = x2 + owner->extent.x1;
-        y1 = y1 + owner->extent.y1;
-        y2 = y2 + owner->extent.y1;
-
-        if (owner->clip.data == RT_NULL)
+        switch (blendMode)
         {
-            rtgui_rect_t *prect;
-
-            /* no clip */
-            prect = &(owner->clip.extents);
-
-            /* calculate line intersect */
-            if (_intersect_rect_line(prect, &x1, &y1, &x2, &y2) == RT_FALSE)
-                return;
-
-            /* draw line */
-            func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, RT_TRUE);
+        case RTGUI_BLENDMODE_BLEND:
+            HLINE(rt_uint16_t, DRAW_SETPIXEL_BLEND_ARGB4444, draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            HLINE(rt_uint16_t, DRAW_SETPIXEL_ADD_ARGB4444, draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            HLINE(rt_uint16_t, DRAW_SETPIXEL_MOD_ARGB4444, draw_end);
+            break;
+        default:
+            HLINE(rt_uint16_t, DRAW_SETPIXEL_ARGB4444, draw_end);
+            break;
         }
-        else
+    }
+    else if (x1 == x2)
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            VLINE(rt_uint16_t, DRAW_SETPIXEL_BLEND_ARGB4444, draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            VLINE(rt_uint16_t, DRAW_SETPIXEL_ADD_ARGB4444, draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            VLINE(rt_uint16_t, DRAW_SETPIXEL_MOD_ARGB4444, draw_end);
+            break;
+        default:
+            VLINE(rt_uint16_t, DRAW_SETPIXEL_ARGB4444, draw_end);
+            break;
+        }
+    }
+    else if (ABS(x1 - x2) == ABS(y1 - y2))
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            DLINE(rt_uint16_t, DRAW_SETPIXEL_BLEND_ARGB4444, draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            DLINE(rt_uint16_t, DRAW_SETPIXEL_ADD_ARGB4444, draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            DLINE(rt_uint16_t, DRAW_SETPIXEL_MOD_ARGB4444, draw_end);
+            break;
+        default:
+            DLINE(rt_uint16_t, DRAW_SETPIXEL_ARGB4444, draw_end);
+            break;
+        }
+    }
+    else
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_BLEND_ARGB4444, DRAW_SETPIXELXY_BLEND_ARGB4444,
+                   draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_ADD_ARGB4444, DRAW_SETPIXELXY_ADD_ARGB4444,
+                   draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_MOD_ARGB4444, DRAW_SETPIXELXY_MOD_ARGB4444,
+                   draw_end);
+            break;
+        default:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_ARGB4444, DRAW_SETPIXELXY_BLEND_ARGB4444,
+                   draw_end);
+            break;
+        }
+    }
+}
+
+static void
+_dc_blend_line_rgb332(struct rtgui_dc * dst, int x1, int y1, int x2, int y2,
+                      enum RTGUI_BLENDMODE blendMode, rt_uint8_t _r, rt_uint8_t _g, rt_uint8_t _b, rt_uint8_t _a,
+                      rt_bool_t draw_end)
+{
+    unsigned r, g, b, a, inva;
+
+    if (blendMode == RTGUI_BLENDMODE_BLEND || blendMode == RTGUI_BLENDMODE_ADD)
+    {
+        r = DRAW_MUL(_r, _a);
+        g = DRAW_MUL(_g, _a);
+        b = DRAW_MUL(_b, _a);
+        a = _a;
+    }
+    else
+    {
+        r = _r;
+        g = _g;
+        b = _b;
+        a = _a;
+    }
+    inva = (a ^ 0xff);
+
+    if (y1 == y2)
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            HLINE(rt_uint8_t, DRAW_SETPIXEL_BLEND_RGB332, draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            HLINE(rt_uint8_t, DRAW_SETPIXEL_ADD_RGB332, draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            HLINE(rt_uint8_t, DRAW_SETPIXEL_MOD_RGB332, draw_end);
+            break;
+        default:
+            HLINE(rt_uint8_t, DRAW_SETPIXEL_RGB332, draw_end);
+            break;
+        }
+    }
+    else if (x1 == x2)
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            VLINE(rt_uint8_t, DRAW_SETPIXEL_BLEND_RGB332, draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            VLINE(rt_uint8_t, DRAW_SETPIXEL_ADD_RGB332, draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            VLINE(rt_uint8_t, DRAW_SETPIXEL_MOD_RGB332, draw_end);
+            break;
+        default:
+            VLINE(rt_uint8_t, DRAW_SETPIXEL_RGB332, draw_end);
+            break;
+        }
+    }
+    else if (ABS(x1 - x2) == ABS(y1 - y2))
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            DLINE(rt_uint8_t, DRAW_SETPIXEL_BLEND_RGB332, draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            DLINE(rt_uint8_t, DRAW_SETPIXEL_ADD_RGB332, draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            DLINE(rt_uint8_t, DRAW_SETPIXEL_MOD_RGB332, draw_end);
+            break;
+        default:
+            DLINE(rt_uint8_t, DRAW_SETPIXEL_RGB332, draw_end);
+            break;
+        }
+    }
+    else
+    {
+        switch (blendMode)
+        {
+        case RTGUI_BLENDMODE_BLEND:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_BLEND_RGB332, DRAW_SETPIXELXY_BLEND_RGB332,
+                   draw_end);
+            break;
+        case RTGUI_BLENDMODE_ADD:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_ADD_RGB332, DRAW_SETPIXELXY_ADD_RGB332,
+                   draw_end);
+            break;
+        case RTGUI_BLENDMODE_MOD:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_MOD_RGB332, DRAW_SETPIXELXY_MOD_RGB332,
+                   draw_end);
+            break;
+        default:
+            AALINE(x1, y1, x2, y2,
+                   DRAW_SETPIXELXY_RGB332, DRAW_SETPIXELXY_BLEND_RGB332,
+                   draw_end);
+            break;
+        }
+    }
+}
+
+typedef void (*BlendLineFunc) (struct rtgui_dc * dst,
+                               int x1, int y1, int x2, int y2,
+                               enum RTGUI_BLENDMODE blendMode,
+                               rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a,
+                               rt_bool_t draw_end);
+
+static BlendLineFunc
+_dc_calc_blend_line_func(rt_uint8_t pixel_format)
+{
+    switch (pixel_format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565, _dc_blend_line_rgb565);
+    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_BGR565, _dc_blend_line_bgr565);
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB888, _dc_blend_line_rgb888);
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        return _dc_blend_line_argb8888;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_ARGB4444, _dc_blend_line_argb4444);
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB332, _dc_blend_line_rgb332);
+    }
+
+    return NULL;
+}
+
+static void _do_blend_line(struct rtgui_dc * dst,
+                           rtgui_color_t color,
+                           int x1, int y1,
+                           int x2, int y2,
+                           enum RTGUI_BLENDMODE blendMode,
+                           rt_bool_t draw_end)
+{
+    BlendLineFunc func;
+    rt_uint8_t pixel_format;
+    rt_uint8_t r, g, b, a;
+    rtgui_widget_t *owner;
+
+    pixel_format = rtgui_dc_get_pixel_format(dst);
+    func = _dc_calc_blend_line_func(pixel_format);
+    if (!func)
+    {
+        rt_kprintf("dc_blend_line(): Unsupported pixel format\n");
+        return;
+    }
+
+    r = RTGUI_RGB_R(color);
+    g = RTGUI_RGB_G(color);
+    b = RTGUI_RGB_B(color);
+    a = RTGUI_RGB_A(color);
+
+    /* perform clip */
+    if (dst->type == RTGUI_DC_CLIENT)
+    {
+        /* get owner */
+        owner = RTGUI_CONTAINER_OF(dst, struct rtgui_widget, dc_type);
+
+        x1 = x1 + owner->extent.x1;
+        x2 = x2 + owner->extent.x1;
+        y1 = y1 + owner->extent.y1;
+        y2 = y2 + owner->extent.y1;
+
+        if (owner->clip.data == RT_NULL)
+        {
+            rtgui_rect_t *prect;
+
+            /* no clip */
+            prect = &(owner->clip.extents);
+
+            /* calculate line intersect */
+            if (_intersect_rect_line(prect, &x1, &y1, &x2, &y2) == RT_FALSE)
+                return;
+
+            /* draw line */
+            func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, RT_TRUE);
+        }
+        else
         {
             register rt_base_t index;
 
@@ -1580,9 +1995,113 @@ _dc_blend_fill_rect_argb8888(struct rtgui_dc * dst, const rtgui_rect_t * rect,
     }
 }
 
+static void
+_dc_blend_fill_rect_argb4444(struct rtgui_dc * dst, const rtgui_rect_t * rect,
+                             enum RTGUI_BLENDMODE blendMode, rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
+{
+    unsigned inva = 0xff - a;
+
+    switch (blendMode)
+    {
+    case RTGUI_BLENDMODE_BLEND:
+        FILLRECT(rt_uint16_t, DRAW_SETPIXEL_BLEND_ARGB4444);
+        break;
+    case RTGUI_BLENDMODE_ADD:
+        FILLRECT(rt_uint16_t, DRAW_SETPIXEL_ADD_ARGB4444);
+        break;
+    case RTGUI_BLENDMODE_MOD:
+        FILLRECT(rt_uint16_t, DRAW_SETPIXEL_MOD_ARGB4444);
+        break;
+    default:
+        FILLRECT(rt_uint16_t, DRAW_SETPIXEL_ARGB4444);
+        break;
+    }
+}
+
+static void
+_dc_blend_fill_rect_rgb332(struct rtgui_dc * dst, const rtgui_rect_t * rect,
+                           enum RTGUI_BLENDMODE blendMode, rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
+{
+    unsigned inva = 0xff - a;
+
+    switch (blendMode)
+    {
+    case RTGUI_BLENDMODE_BLEND:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_BLEND_RGB332);
+        break;
+    case RTGUI_BLENDMODE_ADD:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_ADD_RGB332);
+        break;
+    case RTGUI_BLENDMODE_MOD:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_MOD_RGB332);
+        break;
+    default:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_RGB332);
+        break;
+    }
+}
+
+static void
+_dc_blend_fill_rect_a8(struct rtgui_dc * dst, const rtgui_rect_t * rect,
+                       enum RTGUI_BLENDMODE blendMode, rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a)
+{
+    unsigned inva = 0xff - a;
+
+    switch (blendMode)
+    {
+    case RTGUI_BLENDMODE_BLEND:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_BLEND_A8);
+        break;
+    case RTGUI_BLENDMODE_ADD:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_ADD_A8);
+        break;
+    case RTGUI_BLENDMODE_MOD:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_MOD_A8);
+        break;
+    default:
+        FILLRECT(rt_uint8_t, DRAW_SETPIXEL_A8);
+        break;
+    }
+}
+
 typedef void (*BlendFillFunc)(struct rtgui_dc * dst, const rtgui_rect_t * rect,
                               enum RTGUI_BLENDMODE blendMode, rt_uint8_t r, rt_uint8_t g, rt_uint8_t b, rt_uint8_t a);
 
+/* the fill kernel of the pixel format of dc */
+static BlendFillFunc _dc_blend_fill_func(struct rtgui_dc *dst)
+{
+    BlendFillFunc func = RT_NULL;
+
+    switch (rtgui_dc_get_pixel_format(dst))
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        func = RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565, _dc_blend_fill_rect_rgb565);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
+        func = RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_BGR565, _dc_blend_fill_rect_bgr565);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        func = RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB888, _dc_blend_fill_rect_rgb888);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        func = _dc_blend_fill_rect_argb8888;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        func = RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_ARGB4444, _dc_blend_fill_rect_argb4444);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        func = RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB332, _dc_blend_fill_rect_rgb332);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ALPHA:
+        func = _dc_blend_fill_rect_a8;
+        break;
+    default:
+        break;
+    }
+
+    return func;
+}
+
 void
 rtgui_dc_blend_fill_rect(struct rtgui_dc* dst, const rtgui_rect_t *rect,
                          enum RTGUI_BLENDMODE blendMode, rtgui_color_t color)
@@ -1612,23 +2131,7 @@ rtgui_dc_blend_fill_rect(struct rtgui_dc* dst, const rtgui_rect_t *rect,
         b = DRAW_MUL(b, a);
     }
 
-    switch (rtgui_dc_get_pixel_format(dst))
-    {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        func = _dc_blend_fill_rect_rgb565;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
-        func = _dc_blend_fill_rect_bgr565;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        func = _dc_blend_fill_rect_rgb888;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        func = _dc_blend_fill_rect_argb8888;
-        break;
-    default:
-        break;
-    }
+    func = _dc_blend_fill_func(dst);
     if (func == RT_NULL)
     {
         rt_kprintf("dc_blend_fill_rect(): Unsupported pixel format\n");
@@ -1702,19 +2205,43 @@ rtgui_dc_blend_fill_rect(struct rtgui_dc* dst, const rtgui_rect_t *rect,
 }
 RTM_EXPORT(rtgui_dc_blend_fill_rect);
 
+/* the order of rects by the top, in shell sort */
+static void _dc_blend_rects_sort(const rtgui_rect_t *rects, int *order, int count)
+{
+    int i, j, gap, index;
+
+    for (gap = count / 2; gap > 0; gap /= 2)
+    {
+        for (i = gap; i < count; i ++)
+        {
+            index = order[i];
+            for (j = i; j >= gap && rects[order[j - gap]].y1 > rects[index].y1; j -= gap)
+                order[j] = order[j - gap];
+            order[j] = index;
+        }
+    }
+}
+
+/*
+ * Fill the rects in one kernel of the format. On the client dc, the rects are
+ * sorted by the top and swept through the y-x banded clip, the bands above
+ * a rect are skipped for all the rects after it. The opaque fill is a store
+ * without the blending, in the fill_rect of buffer dc.
+ */
 void
 rtgui_dc_blend_fill_rects(struct rtgui_dc * dst, const rtgui_rect_t *rects, int count,
                           enum RTGUI_BLENDMODE blendMode, rtgui_color_t color)
 {
-    int i;
-    rtgui_rect_t rect;
-    BlendFillFunc func = RT_NULL;
+    int i, index, first, num, *order;
+    rtgui_rect_t rect, draw_rect, *clips;
+    BlendFillFunc func;
     rt_uint8_t r, g, b, a;
-    rtgui_widget_t *owner = RT_NULL;
+    rtgui_color_t fc;
+    rtgui_widget_t *owner;
 
     RT_ASSERT(dst != RT_NULL);
 
-    if (!rtgui_dc_get_visible(dst)) return;
+    if (count <= 0 || !rtgui_dc_get_visible(dst)) return;
     /* This function doesn't work on surfaces < 8 bpp */
     if (_dc_get_bits_per_pixel(dst)< 8)
     {
@@ -1722,97 +2249,97 @@ rtgui_dc_blend_fill_rects(struct rtgui_dc * dst, const rtgui_rect_t *rects, int
         return;
     }
 
+    func = _dc_blend_fill_func(dst);
+    if (func == RT_NULL)
+    {
+        rt_kprintf("dc_blend_fill_rects(): Unsupported pixel format\n");
+        return;
+    }
+
     r = RTGUI_RGB_R(color);
     g = RTGUI_RGB_G(color);
     b = RTGUI_RGB_B(color);
     a = RTGUI_RGB_A(color);
 
-    if (blendMode == RTGUI_BLENDMODE_BLEND || blendMode == RTGUI_BLENDMODE_ADD)
+    if (blendMode == RTGUI_BLENDMODE_BLEND && a == 255)
+        blendMode = RTGUI_BLENDMODE_NONE;
+    if (blendMode == RTGUI_BLENDMODE_NONE && dst->type == RTGUI_DC_BUFFER)
     {
-        r = DRAW_MUL(r, a);
-        g = DRAW_MUL(g, a);
-        b = DRAW_MUL(b, a);
-    }
-
-    switch (rtgui_dc_get_pixel_format(dst))
-    {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        func = _dc_blend_fill_rect_rgb565;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
-        func = _dc_blend_fill_rect_bgr565;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        func = _dc_blend_fill_rect_rgb888;
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        func = _dc_blend_fill_rect_argb8888;
-        break;
-    default:
-        break;
-    }
-    if (func == RT_NULL)
-    {
-        rt_kprintf("dc_blend_fill_rects(): Unsupported pixel format\n");
+        fc = RTGUI_DC_FC(dst);
+        RTGUI_DC_FC(dst) = color;
+        for (i = 0; i < count; i ++)
+        {
+            rect = rects[i];
+            rtgui_dc_fill_rect(dst, &rect);
+        }
+        RTGUI_DC_FC(dst) = fc;
         return;
     }
 
-    if (dst->type == RTGUI_DC_CLIENT)
+    if (blendMode == RTGUI_BLENDMODE_BLEND || blendMode == RTGUI_BLENDMODE_ADD)
     {
-        /* get owner */
-        owner = RTGUI_CONTAINER_OF(dst, struct rtgui_widget, dc_type);
+        r = DRAW_MUL(r, a);
+        g = DRAW_MUL(g, a);
+        b = DRAW_MUL(b, a);
     }
 
-    for (i = 0; i < count; ++i)
+    if (dst->type != RTGUI_DC_CLIENT)
     {
-        rect = rects[i];
+        /* the buffer is clipped by its rect, the rects on hw dc are on the screen */
+        if (dst->type == RTGUI_DC_BUFFER)
+            rtgui_dc_get_rect(dst, &draw_rect);
+        else
+            rtgui_graphic_driver_get_rect(hw_driver, &draw_rect);
 
-        if (dst->type == RTGUI_DC_CLIENT)
+        for (i = 0; i < count; i ++)
         {
-            register rt_base_t index;
-            rtgui_rect_t draw_rect;
-
-            if (owner->clip.data == RT_NULL)
-            {
-                rtgui_rect_t *prect;
-                prect = &(owner->clip.extents);
-
-                /* convert logic to device */
-                draw_rect = rect;
-                rtgui_rect_move(&draw_rect,owner->extent.x1, owner->extent.y1);
-
-                /* calculate rect intersect */
-                if (prect->y1 > draw_rect.y2  || prect->y2 <= draw_rect.y1) return ;
-                if (prect->x2 <= draw_rect.x1 || prect->x1 > draw_rect.x2 ) return ;
-                rtgui_rect_intersect(prect, &draw_rect);
+            rect = rects[i];
+            rtgui_rect_intersect(&draw_rect, &rect);
+            if (rect.x1 < rect.x2 && rect.y1 < rect.y2)
+                func(dst, &rect, blendMode, r, g, b, a);
+        }
+        return;
+    }
 
-                func(dst, &draw_rect, blendMode, r, g, b, a);
-            }
-            else
-            {
-                for (index = 0; index < rtgui_region_num_rects(&(owner->clip)); index ++)
-                {
-                    rtgui_rect_t *prect;
+    owner = RTGUI_CONTAINER_OF(dst, struct rtgui_widget, dc_type);
+    num = rtgui_region_num_rects(&(owner->clip));
+    clips = rtgui_region_rects(&(owner->clip));
 
-                    prect = ((rtgui_rect_t *)(owner->clip.data + index + 1));
+    order = RT_NULL;
+    if (num > 1 && count > 1)
+    {
+        /* without the order, each rect is swept from the first band */
+        order = (int *)rtgui_malloc(count * sizeof(int));
+        if (order != RT_NULL)
+        {
+            for (i = 0; i < count; i ++)
+                order[i] = i;
+            _dc_blend_rects_sort(rects, order, count);
+        }
+    }
 
-                    draw_rect = rect;
-                    rtgui_rect_move(&draw_rect,owner->extent.x1, owner->extent.y1);
+    for (i = 0, first = 0; i < count; i ++)
+    {
+        /* convert logic to device */
+        rect = rects[order != RT_NULL ? order[i] : i];
+        rtgui_rect_move(&rect, owner->extent.x1, owner->extent.y1);
 
-                    /* calculate rect intersect */
-                    if (prect->y1 > draw_rect.y2  || prect->y2 <= draw_rect.y1) continue;
-                    if (prect->x2 <= draw_rect.x1 || prect->x1 > draw_rect.x2 ) continue;
-                    rtgui_rect_intersect(prect, &draw_rect);
+        if (order == RT_NULL)
+            first = 0;
+        while (first < num && clips[first].y2 <= rect.y1)
+            first ++;
 
-                    func(dst, &draw_rect, blendMode, r, g, b, a);
-                }
-            }
-        }
-        else
+        for (index = first; index < num && clips[index].y1 < rect.y2; index ++)
         {
-            func(dst, &rect, blendMode, r, g, b, a);
+            draw_rect = rect;
+            rtgui_rect_intersect(&clips[index], &draw_rect);
+            if (draw_rect.x1 < draw_rect.x2 && draw_rect.y1 < draw_rect.y2)
+                func(dst, &draw_rect, blendMode, r, g, b, a);
         }
     }
+
+    if (order != RT_NULL)
+        rtgui_free(order);
 }
 RTM_EXPORT(rtgui_dc_blend_fill_rects);
 
@@ -1863,6 +2390,12 @@ rt_inline void _draw_pixel_weight(struct rtgui_dc * dc, rt_int16_t x, rt_int16_t
     * Modify Alpha by weight
     */
     rt_uint32_t ax = a;
+
+#ifdef GUIENGINE_USING_COVERAGE_GAMMA
+    /* the coverage in a mask is corrected when it's blitted */
+    if (rtgui_dc_get_pixel_format(dc) != RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+        weight = RTGUI_COVERAGE(weight);
+#endif
     ax = ((ax * weight) >> 8);
     if (ax > 255)
     {
@@ -2076,605 +2609,51 @@ RTM_EXPORT(rtgui_dc_draw_aa_ellipse);
 
 void rtgui_dc_draw_aa_circle(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r)
 {
-    rtgui_dc_draw_aa_ellipse(dc, x, y, r, r);
-}
-RTM_EXPORT(rtgui_dc_draw_aa_circle);
-
-/*!
-\brief The structure passed to the internal Bresenham iterator.
-*/
-typedef struct
-{
-    rt_int16_t x, y;
-    int dx, dy, s1, s2, swapdir, error;
-    rt_uint32_t count;
-} _BresenhamIterator;
-
-/*!
-\brief The structure passed to the internal Murphy iterator.
-*/
-typedef struct
-{
-    rt_uint32_t color;
-    struct rtgui_dc *dst;
-    int u, v;       /* delta x , delta y */
-    int ku, kt, kv, kd; /* loop constants */
-    int oct2;
-    int quad4;
-    rt_int16_t last1x, last1y, last2x, last2y, first1x, first1y, first2x, first2y, tempx, tempy;
-} _MurphyIterator;
-
-/*!
-\brief Internal function to initialize the Bresenham line iterator.
-
-Example of use:
-_BresenhamIterator b;
-_bresenhamInitialize (&b, x1, y1, x2, y2);
-do {
-plot(b.x, b.y);
-} while (_bresenhamIterate(&b)==0);
-
-\param b Pointer to struct for bresenham line drawing state.
-\param x1 X coordinate of the first point of the line.
-\param y1 Y coordinate of the first point of the line.
-\param x2 X coordinate of the second point of the line.
-\param y2 Y coordinate of the second point of the line.
-
-\returns Returns 0 on success, -1 on failure.
-*/
-int _bresenhamInitialize(_BresenhamIterator *b, rt_int16_t x1, rt_int16_t y1, rt_int16_t x2, rt_int16_t y2)
-{
-    int temp;
-
-    if (b==NULL)
-    {
-        return(-1);
-    }
-
-    b->x = x1;
-    b->y = y1;
-
-    /* dx = abs(x2-x1), s1 = sign(x2-x1) */
-    if ((b->dx = x2 - x1) != 0)
-    {
-        if (b->dx < 0)
-        {
-            b->dx = -b->dx;
-            b->s1 = -1;
-        }
-        else
-        {
-            b->s1 = 1;
-        }
-    }
-    else
-    {
-        b->s1 = 0;
-    }
-
-    /* dy = abs(y2-y1), s2 = sign(y2-y1)    */
-    if ((b->dy = y2 - y1) != 0)
-    {
-        if (b->dy < 0)
-        {
-            b->dy = -b->dy;
-            b->s2 = -1;
-        }
-        else
-        {
-            b->s2 = 1;
-        }
-    }
-    else
-    {
-        b->s2 = 0;
-    }
-
-    if (b->dy > b->dx)
-    {
-        temp = b->dx;
-        b->dx = b->dy;
-        b->dy = temp;
-        b->swapdir = 1;
-    }
-    else
-    {
-        b->swapdir = 0;
-    }
-
-    b->count = (b->dx<0) ? 0 : (unsigned int)b->dx;
-    b->dy <<= 1;
-    b->error = b->dy - b->dx;
-    b->dx <<= 1;
-
-    return(0);
-}
-
-
-/*!
-\brief Internal function to move Bresenham line iterator to the next position.
-
-Maybe updates the x and y coordinates of the iterator struct.
-
-\param b Pointer to struct for bresenham line drawing state.
-
-\returns Returns 0 on success, 1 if last point was reached, 2 if moving past end-of-line, -1 on failure.
-*/
-int _bresenhamIterate(_BresenhamIterator *b)
-{
-    if (b==NULL)
-    {
-        return (-1);
-    }
-
-    /* last point check */
-    if (b->count==0)
-    {
-        return (2);
-    }
-
-    while (b->error >= 0)
-    {
-        if (b->swapdir)
-        {
-            b->x += b->s1;
-        }
-        else
-        {
-            b->y += b->s2;
-        }
-
-        b->error -= b->dx;
-    }
-
-    if (b->swapdir)
-    {
-        b->y += b->s2;
-    }
-    else
-    {
-        b->x += b->s1;
-    }
-
-    b->error += b->dy;
-    b->count--;
-
-    /* count==0 indicates "end-of-line" */
-    return ((b->count) ? 0 : 1);
-}
-
-
-/*!
-\brief Internal function to to draw parallel lines with Murphy algorithm.
-
-\param m Pointer to struct for murphy iterator.
-\param x X coordinate of point.
-\param y Y coordinate of point.
-\param d1 Direction square/diagonal.
-*/
-void _murphyParaline(_MurphyIterator *m, rt_int16_t x, rt_int16_t y, int d1)
-{
-    int p;
-    d1 = -d1;
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+    rtgui_rect_t rect;
 
-    for (p = 0; p <= m->u; p++)
+    /* the ring of 1 pixel through the cached mask */
+    if (r > 0 && rtgui_dc_get_pixel_format(dc) != RTGRAPHIC_PIXEL_FORMAT_ALPHA)
     {
-        rtgui_dc_draw_point(m->dst, x, y);
-
-        if (d1 <= m->kt)
-        {
-            if (m->oct2 == 0)
-            {
-                x++;
-            }
-            else
-            {
-                if (m->quad4 == 0)
-                {
-                    y++;
-                }
-                else
-                {
-                    y--;
-                }
-            }
-            d1 += m->kv;
-        }
-        else
-        {
-            x++;
-            if (m->quad4 == 0)
-            {
-                y++;
-            }
-            else
-            {
-                y--;
-            }
-            d1 += m->kd;
-        }
+        rtgui_rect_init(&rect, x - r, y - r, 2 * r + 1, 2 * r + 1);
+        rtgui_dc_fill_shape(dc, RTGUI_SHAPE_RING, &rect, 0, 1);
+        return;
     }
-
-    m->tempx = x;
-    m->tempy = y;
+#endif
+    rtgui_dc_draw_aa_ellipse(dc, x, y, r, r);
 }
+RTM_EXPORT(rtgui_dc_draw_aa_circle);
 
-/*!
-\brief Internal function to to draw one iteration of the Murphy algorithm.
-
-\param m Pointer to struct for murphy iterator.
-\param miter Iteration count.
-\param ml1bx X coordinate of a point.
-\param ml1by Y coordinate of a point.
-\param ml2bx X coordinate of a point.
-\param ml2by Y coordinate of a point.
-\param ml1x X coordinate of a point.
-\param ml1y Y coordinate of a point.
-\param ml2x X coordinate of a point.
-\param ml2y Y coordinate of a point.
-
-*/
-void _murphyIteration(_MurphyIterator *m, rt_uint8_t miter,
-                      rt_uint16_t ml1bx, rt_uint16_t ml1by, rt_uint16_t ml2bx, rt_uint16_t ml2by,
-                      rt_uint16_t ml1x, rt_uint16_t ml1y, rt_uint16_t ml2x, rt_uint16_t ml2y)
+void rtgui_dc_fill_aa_ellipse(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t rx, rt_int16_t ry)
 {
-    int atemp1, atemp2;
-    int ftmp1, ftmp2;
-    rt_uint16_t m1x, m1y, m2x, m2y;
-    rt_uint16_t fix, fiy, lax, lay, curx, cury;
-    int px[4], py[4];
-    _BresenhamIterator b;
-
-    if (miter > 1)
-    {
-        if (m->first1x != -32768)
-        {
-            fix = (m->first1x + m->first2x) / 2;
-            fiy = (m->first1y + m->first2y) / 2;
-            lax = (m->last1x + m->last2x) / 2;
-            lay = (m->last1y + m->last2y) / 2;
-            curx = (ml1x + ml2x) / 2;
-            cury = (ml1y + ml2y) / 2;
-
-            atemp1 = (fix - curx);
-            atemp2 = (fiy - cury);
-            ftmp1 = atemp1 * atemp1 + atemp2 * atemp2;
-            atemp1 = (lax - curx);
-            atemp2 = (lay - cury);
-            ftmp2 = atemp1 * atemp1 + atemp2 * atemp2;
-
-            if (ftmp1 <= ftmp2)
-            {
-                m1x = m->first1x;
-                m1y = m->first1y;
-                m2x = m->first2x;
-                m2y = m->first2y;
-            }
-            else
-            {
-                m1x = m->last1x;
-                m1y = m->last1y;
-                m2x = m->last2x;
-                m2y = m->last2y;
-            }
-
-            atemp1 = (m2x - ml2x);
-            atemp2 = (m2y - ml2y);
-            ftmp1 = atemp1 * atemp1 + atemp2 * atemp2;
-            atemp1 = (m2x - ml2bx);
-            atemp2 = (m2y - ml2by);
-            ftmp2 = atemp1 * atemp1 + atemp2 * atemp2;
-
-            if (ftmp2 >= ftmp1)
-            {
-                ftmp1 = ml2bx;
-                ftmp2 = ml2by;
-                ml2bx = ml2x;
-                ml2by = ml2y;
-                ml2x = ftmp1;
-                ml2y = ftmp2;
-                ftmp1 = ml1bx;
-                ftmp2 = ml1by;
-                ml1bx = ml1x;
-                ml1by = ml1y;
-                ml1x = ftmp1;
-                ml1y = ftmp2;
-            }
-
-            _bresenhamInitialize(&b, m2x, m2y, m1x, m1y);
-            do
-            {
-                rtgui_dc_draw_color_point(m->dst, b.x, b.y, m->color);
-            }
-            while (_bresenhamIterate(&b)==0);
-
-            _bresenhamInitialize(&b, m1x, m1y, ml1bx, ml1by);
-            do
-            {
-                rtgui_dc_draw_color_point(m->dst, b.x, b.y, m->color);
-            }
-            while (_bresenhamIterate(&b)==0);
-
-            _bresenhamInitialize(&b, ml1bx, ml1by, ml2bx, ml2by);
-            do
-            {
-                rtgui_dc_draw_color_point(m->dst, b.x, b.y, m->color);
-            }
-            while (_bresenhamIterate(&b)==0);
+    /* Sanity check radii */
+    if ((rx < 0) || (ry < 0)) return ;
 
-            _bresenhamInitialize(&b, ml2bx, ml2by, m2x, m2y);
-            do
-            {
-                rtgui_dc_draw_color_point(m->dst, b.x, b.y, m->color);
-            }
-            while (_bresenhamIterate(&b)==0);
-
-            px[0] = m1x;
-            px[1] = m2x;
-            px[2] = ml1bx;
-            px[3] = ml2bx;
-            py[0] = m1y;
-            py[1] = m2y;
-            py[2] = ml1by;
-            py[3] = ml2by;
-            rtgui_dc_draw_polygon(m->dst, px, py, 4);
-        }
-    }
-
-    m->last1x = ml1x;
-    m->last1y = ml1y;
-    m->last2x = ml2x;
-    m->last2y = ml2y;
-    m->first1x = ml1bx;
-    m->first1y = ml1by;
-    m->first2x = ml2bx;
-    m->first2y = ml2by;
+    /* fill the inside with spans, and blend the edge with the anti-aliased outline */
+    if ((rx > 1) && (ry > 1))
+        rtgui_dc_fill_round_spans(dc, x, y, x, y, rx - 1, ry - 1);
+    rtgui_dc_draw_aa_ellipse(dc, x, y, rx, ry);
 }
+RTM_EXPORT(rtgui_dc_fill_aa_ellipse);
 
-#define HYPOT(x,y) sqrt((double)(x)*(double)(x)+(double)(y)*(double)(y))
-
-/*!
-\brief Internal function to to draw wide lines with Murphy algorithm.
-
-Draws lines parallel to ideal line.
-
-\param m Pointer to struct for murphy iterator.
-\param x1 X coordinate of first point.
-\param y1 Y coordinate of first point.
-\param x2 X coordinate of second point.
-\param y2 Y coordinate of second point.
-\param width Width of line.
-\param miter Iteration count.
-
-*/
-void _murphyWideline(_MurphyIterator *m, rt_int16_t x1, rt_int16_t y1, rt_int16_t x2, rt_int16_t y2, rt_uint8_t width, rt_uint8_t miter)
+void rtgui_dc_fill_aa_circle(struct rtgui_dc *dc, rt_int16_t x, rt_int16_t y, rt_int16_t r)
 {
-    float offset = (float)width / 2.f;
-
-    rt_int16_t temp;
-    rt_int16_t ptx, pty, ml1x, ml1y, ml2x, ml2y, ml1bx, ml1by, ml2bx, ml2by;
-
-    int d0, d1;     /* difference terms d0=perpendicular to line, d1=along line */
-
-    int q;          /* pel counter,q=perpendicular to line */
-    int tmp;
-
-    int dd;         /* distance along line */
-    int tk;         /* thickness threshold */
-    double ang;     /* angle for initial point calculation */
-    double sang, cang;
-
-    /* Initialisation */
-    m->u = x2 - x1; /* delta x */
-    m->v = y2 - y1; /* delta y */
-
-    if (m->u < 0)   /* swap to make sure we are in quadrants 1 or 4 */
-    {
-        temp = x1;
-        x1 = x2;
-        x2 = temp;
-        temp = y1;
-        y1 = y2;
-        y2 = temp;
-        m->u *= -1;
-        m->v *= -1;
-    }
-
-    if (m->v < 0)   /* swap to 1st quadrant and flag */
-    {
-        m->v *= -1;
-        m->quad4 = 1;
-    }
-    else
-    {
-        m->quad4 = 0;
-    }
-
-    if (m->v > m->u)    /* swap things if in 2 octant */
-    {
-        tmp = m->u;
-        m->u = m->v;
-        m->v = tmp;
-        m->oct2 = 1;
-    }
-    else
-    {
-        m->oct2 = 0;
-    }
-
-    m->ku = m->u + m->u;    /* change in l for square shift */
-    m->kv = m->v + m->v;    /* change in d for square shift */
-    m->kd = m->kv - m->ku;  /* change in d for diagonal shift */
-    m->kt = m->u - m->kv;   /* diag/square decision threshold */
-
-    d0 = 0;
-    d1 = 0;
-    dd = 0;
-
-    ang = atan((double) m->v / (double) m->u);  /* calc new initial point - offset both sides of ideal */
-    sang = sin(ang);
-    cang = cos(ang);
-
-    if (m->oct2 == 0)
-    {
-        ptx = x1 + (rt_int16_t)lrint(offset * sang);
-        if (m->quad4 == 0)
-        {
-            pty = y1 - (rt_int16_t)lrint(offset * cang);
-        }
-        else
-        {
-            pty = y1 + (rt_int16_t)lrint(offset * cang);
-        }
-    }
-    else
-    {
-        ptx = x1 - (rt_int16_t)lrint(offset * cang);
-        if (m->quad4 == 0)
-        {
-            pty = y1 + (rt_int16_t)lrint(offset * sang);
-        }
-        else
-        {
-            pty = y1 - (rt_int16_t)lrint(offset * sang);
-        }
-    }
-
-    /* used here for constant thickness line */
-    tk = (int) (4. * HYPOT(ptx - x1, pty - y1) * HYPOT(m->u, m->v));
-
-    if (miter == 0)
-    {
-        m->first1x = -32768;
-        m->first1y = -32768;
-        m->first2x = -32768;
-        m->first2y = -32768;
-        m->last1x = -32768;
-        m->last1y = -32768;
-        m->last2x = -32768;
-        m->last2y = -32768;
-    }
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+    rtgui_rect_t rect;
 
-    for (q = 0; dd <= tk; q++)      /* outer loop, stepping perpendicular to line */
+    if (r > 0 && rtgui_dc_get_pixel_format(dc) != RTGRAPHIC_PIXEL_FORMAT_ALPHA)
     {
-
-        _murphyParaline(m, ptx, pty, d1);   /* call to inner loop - right edge */
-        if (q == 0)
-        {
-            ml1x = ptx;
-            ml1y = pty;
-            ml1bx = m->tempx;
-            ml1by = m->tempy;
-        }
-        else
-        {
-            ml2x = ptx;
-            ml2y = pty;
-            ml2bx = m->tempx;
-            ml2by = m->tempy;
-        }
-        if (d0 < m->kt)     /* square move */
-        {
-            if (m->oct2 == 0)
-            {
-                if (m->quad4 == 0)
-                {
-                    pty++;
-                }
-                else
-                {
-                    pty--;
-                }
-            }
-            else
-            {
-                ptx++;
-            }
-        }
-        else    /* diagonal move */
-        {
-            dd += m->kv;
-            d0 -= m->ku;
-            if (d1 < m->kt)     /* normal diagonal */
-            {
-                if (m->oct2 == 0)
-                {
-                    ptx--;
-                    if (m->quad4 == 0)
-                    {
-                        pty++;
-                    }
-                    else
-                    {
-                        pty--;
-                    }
-                }
-                else
-                {
-                    ptx++;
-                    if (m->quad4 == 0)
-                    {
-                        pty--;
-                    }
-                    else
-                    {
-                        pty++;
-                    }
-                }
-                d1 += m->kv;
-            }
-            else    /* double square move, extra parallel line */
-            {
-                if (m->oct2 == 0)
-                {
-                    ptx--;
-                }
-                else
-                {
-                    if (m->quad4 == 0)
-                    {
-                        pty--;
-                    }
-                    else
-                    {
-                        pty++;
-                    }
-                }
-                d1 += m->kd;
-                if (dd > tk)
-                {
-                    _murphyIteration(m, miter, ml1bx, ml1by, ml2bx, ml2by, ml1x, ml1y, ml2x, ml2y);
-                    return; /* breakout on the extra line */
-                }
-                _murphyParaline(m, ptx, pty, d1);
-                if (m->oct2 == 0)
-                {
-                    if (m->quad4 == 0)
-                    {
-                        pty++;
-                    }
-                    else
-                    {
-
-                        pty--;
-                    }
-                }
-                else
-                {
-                    ptx++;
-                }
-            }
-        }
-        dd += m->ku;
-        d0 += m->kv;
+        rtgui_rect_init(&rect, x - r, y - r, 2 * r + 1, 2 * r + 1);
+        rtgui_dc_fill_shape(dc, RTGUI_SHAPE_CIRCLE, &rect, 0, 0);
+        return;
     }
-
-    _murphyIteration(m, miter, ml1bx, ml1by, ml2bx, ml2by, ml1x, ml1y, ml2x, ml2y);
+#endif
+    rtgui_dc_fill_aa_ellipse(dc, x, y, r, r);
 }
-
+RTM_EXPORT(rtgui_dc_fill_aa_circle);
 
 /*!
-\brief Draw a thick line with alpha blending.
+\brief Draw a thick line in anti-aliasing.
 
 \param dst The surface to draw on.
 \param x1 X coordinate of the first point of the line.
@@ -2682,14 +2661,17 @@ void _murphyWideline(_MurphyIterator *m, rt_int16_t x1, rt_int16_t y1, rt_int16_
 \param x2 X coordinate of the second point of the line.
 \param y2 Y coordinate of the second point of the line.
 \param width Width of the line in pixels. Must be >0.
-\param color The color value of the line to draw (0xRRGGBBAA).
+
+The line is stroked from the center of the first pixel to the center of the
+last one, and the end pixels are covered by the square caps of half pixel.
 
 \returns Returns 0 on success, -1 on failure.
 */
 int rtgui_dc_draw_thick_line(struct rtgui_dc * dst, rt_int16_t x1, rt_int16_t y1, rt_int16_t x2, rt_int16_t y2, rt_uint8_t width)
 {
-    int wh;
-    _MurphyIterator m;
+    int wh, dx, dy, ex, ey;
+    double len;
+    struct rtgui_path *path;
 
     if (dst == NULL) return -1;
     if (width < 1) return -1;
@@ -2700,15 +2682,27 @@ int rtgui_dc_draw_thick_line(struct rtgui_dc * dst, rt_int16_t x1, rt_int16_t y1
         struct rtgui_rect rect;
         wh = width / 2;
 
-        rtgui_rect_init(&rect, x1 - wh, y1 - wh, x2 + width, y2 + width);
+        rtgui_rect_init(&rect, x1 - wh, y1 - wh, width, width);
         rtgui_dc_fill_rect(dst, &rect);
+        return 0;
     }
 
-    m.dst = dst;
-    m.color = RTGUI_DC_FC(dst);
+    path = rtgui_path_create(2);
+    if (path == RT_NULL) return -1;
+
+    /* the half pixel out of each end along the line */
+    dx = x2 - x1;
+    dy = y2 - y1;
+    len = sqrt((double)dx * dx + (double)dy * dy);
+    ex = (int)(dx * RTGUI_PATH_ONE / 2 / len);
+    ey = (int)(dy * RTGUI_PATH_ONE / 2 / len);
 
-    _murphyWideline(&m, x1, y1, x2, y2, width, 0);
-    _murphyWideline(&m, x1, y1, x2, y2, width, 1);
+    rtgui_path_move_to(path, RTGUI_PATH_FIXED(x1) + RTGUI_PATH_ONE / 2 - ex,
+                       RTGUI_PATH_FIXED(y1) + RTGUI_PATH_ONE / 2 - ey);
+    rtgui_path_line_to(path, RTGUI_PATH_FIXED(x2) + RTGUI_PATH_ONE / 2 + ex,
+                       RTGUI_PATH_FIXED(y2) + RTGUI_PATH_ONE / 2 + ey);
+    rtgui_dc_stroke_path(dst, path, RTGUI_PATH_FIXED(width), RTGUI_PATH_CAP_BUTT, RTGUI_PATH_JOIN_ROUND);
+    rtgui_path_destroy(path);
 
     return(0);
 }
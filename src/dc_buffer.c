@@ -21,11 +21,14 @@
  * Date           Author       Notes
  * 2009-10-16     Bernard      first version
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
 #include <rtgui/rtgui.h>
 #include <rtgui/dc.h>
 #include <rtgui/blit.h>
 #include <rtgui/color.h>
 #include <rtgui/rtgui_system.h>
+#include <rtgui/driver.h>
 #include <rtgui/dc_draw.h>
 #include <rtgui/image_container.h>
 #include <string.h>
@@ -39,6 +42,7 @@ static void rtgui_dc_buffer_fill_rect(struct rtgui_dc *dc, struct rtgui_rect *re
 static void rtgui_dc_buffer_blit_line(struct rtgui_dc *self, int x1, int x2, int y, rt_uint8_t *line_data);
 static void rtgui_dc_buffer_blit(struct rtgui_dc *self, struct rtgui_point *dc_point,
                                  struct rtgui_dc *dest, rtgui_rect_t *rect);
+static void rtgui_dc_buffer_fill_spans(struct rtgui_dc *dc, const struct rtgui_span *spans, int count);
 
 const struct rtgui_dc_engine dc_buffer_engine =
 {
@@ -49,6 +53,7 @@ const struct rtgui_dc_engine dc_buffer_engine =
     rtgui_dc_buffer_fill_rect,
     rtgui_dc_buffer_blit_line,
     rtgui_dc_buffer_blit,
+    rtgui_dc_buffer_fill_spans,
 
     rtgui_dc_buffer_fini,
 };
@@ -59,10 +64,165 @@ const struct rtgui_dc_engine dc_buffer_engine =
     ((dc)->pixel + (y) * (dc)->pitch + (x) * rtgui_color_get_bpp((dc)->pixel_format))
 #define _dc_get_bits_per_pixel(dc)  \
     rtgui_color_get_bits(dc->pixel_format)
+#define _dc_get_palette(dc)         \
+    ((dc)->palette != RT_NULL ? (const rtgui_color_t *)(dc)->palette->colors : RT_NULL)
 
 #define _hw_get_pixel(dst, x, y, type)  \
         (type *)((rt_uint8_t*)((dst)->framebuffer) + (y) * (dst)->pitch + (x) * _UI_BITBYTES((dst)->bits_per_pixel))
 
+/* the luminance of L8 pixel */
+#define _dc_luma(r, g, b)           (((r) * 77 + (g) * 150 + (b) * 29) >> 8)
+
+/* the machine word used by solid fill, 32bit or 64bit */
+typedef unsigned long _fill_word_t;
+
+static void _dc_buffer_fill_span16(rt_uint16_t *pixel, rt_uint16_t value, int count)
+{
+    _fill_word_t *word, pattern;
+    int n;
+
+    /* the same high and low byte, such as black and white */
+    if ((value >> 8) == (value & 0xff))
+    {
+        memset(pixel, value & 0xff, count * sizeof(rt_uint16_t));
+        return;
+    }
+
+    /* align to the machine word */
+    while (count > 0 && ((rt_ubase_t)pixel & (sizeof(_fill_word_t) - 1)))
+    {
+        *pixel++ = value;
+        count --;
+    }
+
+    /* two (or four) pixels in one word */
+    pattern = ((_fill_word_t)-1 / 0xffff) * value;
+    word = (_fill_word_t *)pixel;
+    n = count / (sizeof(_fill_word_t) / sizeof(rt_uint16_t));
+    count -= n * (sizeof(_fill_word_t) / sizeof(rt_uint16_t));
+    while (n >= 4)
+    {
+        word[0] = pattern;
+        word[1] = pattern;
+        word[2] = pattern;
+        word[3] = pattern;
+        word += 4;
+        n -= 4;
+    }
+    while (n--) *word++ = pattern;
+
+    pixel = (rt_uint16_t *)word;
+    while (count--) *pixel++ = value;
+}
+
+static void _dc_buffer_fill_span24(rt_uint8_t *pixel, rt_uint32_t value, int count)
+{
+    rt_uint8_t r, g, b;
+
+    r = (value >> 16) & 0xff;
+    g = (value >> 8) & 0xff;
+    b = value & 0xff;
+    if (r == g && g == b)
+    {
+        memset(pixel, r, count * 3);
+        return;
+    }
+
+    while (count--)
+    {
+        pixel[0] = b;
+        pixel[1] = g;
+        pixel[2] = r;
+        pixel += 3;
+    }
+}
+
+static void _dc_buffer_fill_span32(rt_uint32_t *pixel, rt_uint32_t value, int count)
+{
+    /* all of bytes are the same, such as transparent black */
+    if ((value & 0xff) * 0x01010101 == value)
+    {
+        memset(pixel, value & 0xff, count * sizeof(rt_uint32_t));
+        return;
+    }
+
+    while (count >= 4)
+    {
+        pixel[0] = value;
+        pixel[1] = value;
+        pixel[2] = value;
+        pixel[3] = value;
+        pixel += 4;
+        count -= 4;
+    }
+    while (count--) *pixel++ = value;
+}
+
+/* fill count pixels with the pixel value */
+static void _dc_buffer_fill_span(rt_uint8_t *pixel, int bpp, rt_uint32_t value, int count)
+{
+    switch (bpp)
+    {
+    case 1:
+        memset(pixel, value, count);
+        break;
+    case 2:
+        _dc_buffer_fill_span16((rt_uint16_t *)pixel, (rt_uint16_t)value, count);
+        break;
+    case 3:
+        _dc_buffer_fill_span24(pixel, value, count);
+        break;
+    case 4:
+        _dc_buffer_fill_span32((rt_uint32_t *)pixel, value, count);
+        break;
+    }
+}
+
+/* copy the pixels directly if there is no conversion and blending, return RT_FALSE if not */
+static rt_bool_t _dc_buffer_blit_direct(struct rtgui_blit_info *info)
+{
+    int line, height;
+    rt_uint8_t *src, *dst;
+
+    if (info->src_fmt != info->dst_fmt) return RT_FALSE;
+    if (info->a != 0)
+    {
+        /* only the opaque format can be copied with the pixel alpha */
+        if (info->a != 255) return RT_FALSE;
+        if (info->src_fmt != RTGRAPHIC_PIXEL_FORMAT_RGB565 &&
+                info->src_fmt != RTGRAPHIC_PIXEL_FORMAT_BGR565 &&
+                info->src_fmt != RTGRAPHIC_PIXEL_FORMAT_RGB888)
+            return RT_FALSE;
+    }
+    if (info->dst_w == 0 || info->dst_h == 0) return RT_TRUE;
+
+    RTGUI_OVERDRAW_BLIT(info);
+    /* a DMA descriptor chain of the accelerator is better than CPU copy */
+    if (rtgui_graphic_driver_accel_blit(info) == RT_EOK)
+        return RT_TRUE;
+    rtgui_graphic_driver_accel_sync();
+
+    src = info->src;
+    dst = info->dst;
+    line = info->dst_w * rtgui_color_get_bpp(info->dst_fmt);
+    height = info->dst_h;
+    if (info->src_pitch == line && info->dst_pitch == line)
+    {
+        /* both of them are continuous */
+        memcpy(dst, src, line * height);
+        return RT_TRUE;
+    }
+
+    while (height--)
+    {
+        memcpy(dst, src, line);
+        src += info->src_pitch;
+        dst += info->dst_pitch;
+    }
+
+    return RT_TRUE;
+}
+
 struct rtgui_dc *rtgui_dc_buffer_create(int w, int h)
 {
     rt_uint8_t pixel_format;
@@ -75,6 +235,94 @@ struct rtgui_dc *rtgui_dc_buffer_create(int w, int h)
 RTM_EXPORT(rtgui_dc_buffer_create);
 
 struct rtgui_dc *rtgui_dc_buffer_create_pixformat(rt_uint8_t pixel_format, int w, int h)
+{
+    return rtgui_dc_buffer_create_tag(pixel_format, w, h, RTGUI_MEM_DC);
+}
+RTM_EXPORT(rtgui_dc_buffer_create_pixformat);
+
+static rt_uint8_t *_dc_buffer_alloc_pixel(struct rtgui_dc_buffer *dc)
+{
+#ifdef GUIENGINE_USING_DC_POOL
+    /* the pool is in the memory of dc */
+    if (dc->pixel_tag == RTGUI_MEM_DC)
+        return rtgui_dc_pool_alloc(dc->height * dc->pitch);
+#endif
+
+    return rtgui_malloc_tag(dc->height * dc->pitch, dc->pixel_tag);
+}
+
+static void _dc_buffer_free_pixel(struct rtgui_dc_buffer *dc)
+{
+    if (dc->pixel_tag == RTGUI_DC_PIXEL_EXTERN)
+        return;
+#ifdef GUIENGINE_USING_DC_POOL
+    if (dc->pixel_tag == RTGUI_MEM_DC)
+    {
+        rtgui_dc_pool_free(dc->pixel);
+        return;
+    }
+#endif
+
+    rtgui_free(dc->pixel);
+}
+
+/* allocate the pixels of lazy buffer, which are cleared as the new buffer */
+static rt_bool_t _dc_buffer_materialize(struct rtgui_dc_buffer *dc)
+{
+    if (dc->pixel != RT_NULL)
+        return RT_TRUE;
+
+    dc->pixel = _dc_buffer_alloc_pixel(dc);
+    if (dc->pixel == RT_NULL)
+        return RT_FALSE;
+    rt_memset(dc->pixel, 0, dc->height * dc->pitch);
+
+    return RT_TRUE;
+}
+
+/*
+ * Own the pixels before writing. The lazy buffer is allocated and the shared
+ * pixels are copied, the last one of the shared buffers keeps them.
+ */
+static rt_bool_t _dc_buffer_own(struct rtgui_dc_buffer *dc)
+{
+    rt_uint8_t *pixel;
+    rt_uint32_t ref;
+
+    if (dc->share == RT_NULL)
+        return _dc_buffer_materialize(dc);
+
+    rt_enter_critical();
+    ref = dc->share->ref;
+    rt_exit_critical();
+
+    if (ref > 1)
+    {
+        pixel = _dc_buffer_alloc_pixel(dc);
+        if (pixel == RT_NULL)
+            return RT_FALSE;
+        memcpy(pixel, dc->pixel, dc->height * dc->pitch);
+
+        rt_enter_critical();
+        ref = -- dc->share->ref;
+        rt_exit_critical();
+
+        /* the others are released in copying */
+        if (ref == 0)
+            _dc_buffer_free_pixel(dc);
+        dc->pixel = pixel;
+    }
+    else
+        ref = 0;
+
+    if (ref == 0)
+        rtgui_free(dc->share);
+    dc->share = RT_NULL;
+
+    return RT_TRUE;
+}
+
+static struct rtgui_dc_buffer *_dc_buffer_create(rt_uint8_t pixel_format, int w, int h, int tag)
 {
     struct rtgui_dc_buffer *dc;
 
@@ -85,7 +333,9 @@ struct rtgui_dc *rtgui_dc_buffer_create_pixformat(rt_uint8_t pixel_format, int w
         dc->parent.engine = &dc_buffer_engine;
         dc->gc.foreground = default_foreground;
         dc->gc.background = default_background;
+        dc->gc.pixel_format = RTGUI_GC_PIXEL_NONE;
         dc->gc.font = rtgui_font_default();
+        dc->gc.textstyle = RTGUI_TEXTSTYLE_NORMAL;
         dc->gc.textalign = RTGUI_ALIGN_LEFT | RTGUI_ALIGN_TOP;
         dc->pixel_format = pixel_format;
         dc->pixel_alpha = 255;
@@ -97,20 +347,67 @@ struct rtgui_dc *rtgui_dc_buffer_create_pixformat(rt_uint8_t pixel_format, int w
 #ifdef GUIENGINE_IMAGE_CONTAINER
         dc->image_item = RT_NULL;
 #endif
-        dc->pixel = rtgui_malloc(h * dc->pitch);
-        if (!dc->pixel)
-        {
-            rtgui_free(dc);
-            return RT_NULL;
-        }
-        rt_memset(dc->pixel, 0, h * dc->pitch);
+        dc->pixel_tag = tag;
+        dc->palette = RT_NULL;
+        dc->pixel = RT_NULL;
+        dc->share = RT_NULL;
+    }
 
-        return &(dc->parent);
+    return dc;
+}
+
+struct rtgui_dc *rtgui_dc_buffer_create_tag(rt_uint8_t pixel_format, int w, int h, int tag)
+{
+    struct rtgui_dc_buffer *dc;
+
+    dc = _dc_buffer_create(pixel_format, w, h, tag);
+    if (dc == RT_NULL)
+        return RT_NULL;
+
+    if (_dc_buffer_materialize(dc) == RT_FALSE)
+    {
+        rtgui_free(dc);
+        return RT_NULL;
     }
 
-    return RT_NULL;
+    return &(dc->parent);
 }
-RTM_EXPORT(rtgui_dc_buffer_create_pixformat);
+RTM_EXPORT(rtgui_dc_buffer_create_tag);
+
+/*
+ * The pixels of lazy buffer are allocated on the first draw, the buffer which
+ * is never drawn (a transition not played to the end) costs no pixels.
+ */
+struct rtgui_dc *rtgui_dc_buffer_create_lazy(rt_uint8_t pixel_format, int w, int h)
+{
+    struct rtgui_dc_buffer *dc;
+
+    dc = _dc_buffer_create(pixel_format, w, h, RTGUI_MEM_DC);
+    if (dc == RT_NULL)
+        return RT_NULL;
+
+    return &(dc->parent);
+}
+RTM_EXPORT(rtgui_dc_buffer_create_lazy);
+
+struct rtgui_dc *rtgui_dc_buffer_create_from_pixel(rt_uint8_t pixel_format, int w, int h,
+                                                   int pitch, rt_uint8_t *pixel)
+{
+    struct rtgui_dc_buffer *dc;
+
+    RT_ASSERT(pixel != RT_NULL);
+
+    dc = _dc_buffer_create(pixel_format, w, h, RTGUI_DC_PIXEL_EXTERN);
+    if (dc == RT_NULL)
+        return RT_NULL;
+
+    if (pitch > dc->pitch)
+        dc->pitch = pitch;
+    dc->pixel = pixel;
+
+    return &(dc->parent);
+}
+RTM_EXPORT(rtgui_dc_buffer_create_from_pixel);
 
 #ifdef GUIENGINE_IMAGE_CONTAINER
 struct rtgui_dc *rtgui_img_dc_create_pixformat(rt_uint8_t pixel_format,
@@ -125,10 +422,13 @@ struct rtgui_dc *rtgui_img_dc_create_pixformat(rt_uint8_t pixel_format,
         dc->parent.engine = &dc_buffer_engine;
         dc->gc.foreground = default_foreground;
         dc->gc.background = default_background;
+        dc->gc.pixel_format = RTGUI_GC_PIXEL_NONE;
         dc->gc.font = rtgui_font_default();
+        dc->gc.textstyle = RTGUI_TEXTSTYLE_NORMAL;
         dc->gc.textalign = RTGUI_ALIGN_LEFT | RTGUI_ALIGN_TOP;
         dc->pixel_format = pixel_format;
         dc->pixel_alpha = 255;
+        dc->pixel_tag = RTGUI_MEM_IMAGE;
 
         dc->width = image_item->image->w;
         dc->height = image_item->image->h;
@@ -136,6 +436,8 @@ struct rtgui_dc *rtgui_img_dc_create_pixformat(rt_uint8_t pixel_format,
 
         dc->image_item = image_item;
         dc->pixel = pixel;
+        dc->share = RT_NULL;
+        dc->palette = RT_NULL;
 
         return &(dc->parent);
     }
@@ -156,14 +458,58 @@ struct rtgui_dc *rtgui_dc_buffer_create_from_dc(struct rtgui_dc* dc)
     {
         struct rtgui_dc_buffer *d = (struct rtgui_dc_buffer*) dc;
 
-        /* buffer clone */
-        buffer = (struct rtgui_dc_buffer*)rtgui_dc_buffer_create_pixformat(d->pixel_format,
-                 d->width,
-                 d->height);
+#ifdef GUIENGINE_IMAGE_CONTAINER
+        /* the pixels of image are released with the image item */
+        if (d->image_item != RT_NULL)
+        {
+            buffer = (struct rtgui_dc_buffer*)rtgui_dc_buffer_create_pixformat(d->pixel_format,
+                     d->width,
+                     d->height);
+            if (buffer != RT_NULL)
+                memcpy(buffer->pixel, d->pixel, d->pitch * d->height);
+        }
+        else
+#endif
+        if (d->pixel_tag == RTGUI_DC_PIXEL_EXTERN)
+        {
+            int y;
+
+            /* the pixels of caller may be released before the clone */
+            buffer = (struct rtgui_dc_buffer*)rtgui_dc_buffer_create_pixformat(d->pixel_format,
+                     d->width,
+                     d->height);
+            for (y = 0; buffer != RT_NULL && y < d->height; y ++)
+                memcpy(buffer->pixel + y * buffer->pitch, d->pixel + y * d->pitch, buffer->pitch);
+        }
+        else
+        {
+            /* buffer clone, the pixels are shared until either side is written */
+            buffer = _dc_buffer_create(d->pixel_format, d->width, d->height, d->pixel_tag);
+            if (buffer != RT_NULL && d->pixel != RT_NULL)
+            {
+                if (d->share == RT_NULL)
+                {
+                    d->share = (struct rtgui_dc_buffer_share *)rtgui_malloc(sizeof(struct rtgui_dc_buffer_share));
+                    if (d->share == RT_NULL)
+                    {
+                        rtgui_free(buffer);
+                        return RT_NULL;
+                    }
+                    d->share->ref = 1;
+                }
+
+                rt_enter_critical();
+                d->share->ref ++;
+                rt_exit_critical();
+                buffer->share = d->share;
+                buffer->pixel = d->pixel;
+            }
+        }
         if (buffer != RT_NULL)
         {
-            memcpy(buffer->pixel, d->pixel, d->pitch * d->height);
             d->pixel_alpha = 255;
+            if (d->palette != RT_NULL)
+                rtgui_dc_buffer_set_palette(RTGUI_DC(buffer), d->palette->colors, d->palette->ncolors);
 
             return RTGUI_DC(buffer);
         }
@@ -182,22 +528,62 @@ void rtgui_dc_buffer_set_alpha(struct rtgui_dc* dc, rt_uint8_t pixel_alpha)
     }
 }
 
+rt_err_t rtgui_dc_buffer_set_palette(struct rtgui_dc *dc, const rtgui_color_t *colors, int ncolors)
+{
+    struct rtgui_image_palette *palette;
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)dc;
+
+    RT_ASSERT(dc != RT_NULL && dc->type == RTGUI_DC_BUFFER);
+
+    if (buffer->pixel_format != RTGRAPHIC_PIXEL_FORMAT_P8 || ncolors <= 0 || ncolors > 256)
+        return -RT_EINVAL;
+
+    palette = rtgui_image_palette_create(ncolors);
+    if (palette == RT_NULL)
+        return -RT_ENOMEM;
+    palette->ncolors = ncolors;
+    memcpy(palette->colors, colors, ncolors * sizeof(rtgui_color_t));
+
+    rtgui_free(buffer->palette);
+    buffer->palette = palette;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_buffer_set_palette);
+
 rt_uint8_t *rtgui_dc_buffer_get_pixel(struct rtgui_dc *dc)
 {
     struct rtgui_dc_buffer *dc_buffer;
 
     dc_buffer = (struct rtgui_dc_buffer *)dc;
+    if (_dc_buffer_own(dc_buffer) == RT_FALSE)
+        return RT_NULL;
 
     return dc_buffer->pixel;
 }
 RTM_EXPORT(rtgui_dc_buffer_get_pixel);
 
+rt_uint8_t *rtgui_dc_buffer_read_pixel(struct rtgui_dc *dc)
+{
+    struct rtgui_dc_buffer *dc_buffer;
+
+    dc_buffer = (struct rtgui_dc_buffer *)dc;
+    if (_dc_buffer_materialize(dc_buffer) == RT_FALSE)
+        return RT_NULL;
+
+    return dc_buffer->pixel;
+}
+RTM_EXPORT(rtgui_dc_buffer_read_pixel);
+
 static rt_bool_t rtgui_dc_buffer_fini(struct rtgui_dc *dc)
 {
     struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)dc;
 
     if (dc->type != RTGUI_DC_BUFFER) return RT_FALSE;
 
+    /* the pixels may be in use by the 2D accelerator */
+    rtgui_graphic_driver_accel_sync();
+
 #ifdef GUIENGINE_IMAGE_CONTAINER
     if (buffer->image_item)
     {
@@ -206,8 +592,23 @@ static rt_bool_t rtgui_dc_buffer_fini(struct rtgui_dc *dc)
     }
 #endif
 
+    if (buffer->share)
+    {
+        rt_uint32_t ref;
+
+        /* the pixels are freed by the last one sharing them */
+        rt_enter_critical();
+        ref = -- buffer->share->ref;
+        rt_exit_critical();
+        if (ref > 0)
+            buffer->pixel = RT_NULL;
+        else
+            rtgui_free(buffer->share);
+    }
+
     if (buffer->pixel)
-        rtgui_free(buffer->pixel);
+        _dc_buffer_free_pixel(buffer);
+    rtgui_free(buffer->palette);
 
     return RT_TRUE;
 }
@@ -222,6 +623,7 @@ static void rtgui_dc_buffer_draw_point(struct rtgui_dc *self, int x, int y)
     /* does not draw point out of dc */
     if ((x >= dst->width) || (y >= dst->height)) return;
     if (x < 0 || y < 0) return;
+    if (_dc_buffer_own(dst) == RT_FALSE) return;
 
     r = RTGUI_RGB_R(dst->gc.foreground);
     g = RTGUI_RGB_G(dst->gc.foreground);
@@ -242,6 +644,18 @@ static void rtgui_dc_buffer_draw_point(struct rtgui_dc *self, int x, int y)
     case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
         DRAW_SETPIXELXY_ARGB8888(x, y);
         break;
+    case RTGRAPHIC_PIXEL_FORMAT_L8:
+        *_dc_get_pixel(dst, x, y) = _dc_luma(r, g, b);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ALPHA:
+        *_dc_get_pixel(dst, x, y) = a;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        *(rt_uint16_t *)_dc_get_pixel(dst, x, y) = rtgui_color_to_4444(dst->gc.foreground);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        *_dc_get_pixel(dst, x, y) = rtgui_color_to_332(dst->gc.foreground);
+        break;
     }
 }
 
@@ -255,6 +669,7 @@ static void rtgui_dc_buffer_draw_color_point(struct rtgui_dc *self, int x, int y
     /* does not draw point out of dc */
     if ((x >= dst->width) || (y >= dst->height)) return;
     if (x < 0 || y < 0) return;
+    if (_dc_buffer_own(dst) == RT_FALSE) return;
 
     r = RTGUI_RGB_R(color);
     g = RTGUI_RGB_G(color);
@@ -275,6 +690,18 @@ static void rtgui_dc_buffer_draw_color_point(struct rtgui_dc *self, int x, int y
     case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
         DRAW_SETPIXELXY_ARGB8888(x, y);
         break;
+    case RTGRAPHIC_PIXEL_FORMAT_L8:
+        *_dc_get_pixel(dst, x, y) = _dc_luma(r, g, b);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ALPHA:
+        *_dc_get_pixel(dst, x, y) = a;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        *(rt_uint16_t *)_dc_get_pixel(dst, x, y) = rtgui_color_to_4444(color);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        *_dc_get_pixel(dst, x, y) = rtgui_color_to_332(color);
+        break;
     }
 }
 
@@ -290,6 +717,7 @@ static void rtgui_dc_buffer_draw_vline(struct rtgui_dc *self, int x1, int y1, in
 
     if (y1 < 0) y1 = 0;
     if (y2 > dst->height) y2 = dst->height;
+    if (_dc_buffer_own(dst) == RT_FALSE) return;
 
     r = RTGUI_RGB_R(dst->gc.foreground);
     g = RTGUI_RGB_G(dst->gc.foreground);
@@ -310,50 +738,101 @@ static void rtgui_dc_buffer_draw_vline(struct rtgui_dc *self, int x1, int y1, in
     case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
         VLINE(rt_uint32_t, DRAW_SETPIXEL_ARGB8888, 0);
         break;
+    case RTGRAPHIC_PIXEL_FORMAT_L8:
+        for (; y1 < y2; y1 ++)
+            *_dc_get_pixel(dst, x1, y1) = _dc_luma(r, g, b);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ALPHA:
+        for (; y1 < y2; y1 ++)
+            *_dc_get_pixel(dst, x1, y1) = a;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB4444:
+        for (; y1 < y2; y1 ++)
+            *(rt_uint16_t *)_dc_get_pixel(dst, x1, y1) = rtgui_color_to_4444(dst->gc.foreground);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB332:
+        for (; y1 < y2; y1 ++)
+            *_dc_get_pixel(dst, x1, y1) = rtgui_color_to_332(dst->gc.foreground);
+        break;
     }
 }
 
 static void rtgui_dc_buffer_draw_hline(struct rtgui_dc *self, int x1, int x2, int y1)
 {
     struct rtgui_dc_buffer *dst;
-    unsigned r, g, b, a;
+    rt_uint32_t value;
 
     dst = (struct rtgui_dc_buffer *)self;
 
+    /* the line does not include the end point */
+    if (x1 > x2)
+    {
+        int x = x1;
+
+        x1 = x2 + 1;
+        x2 = x + 1;
+    }
+
     /* parameter checking */
     if (y1 < 0 || y1 >= dst->height) return;
     if (x1 >= dst->width) return;
 
     if (x1 < 0) x1 = 0;
     if (x2 > dst->width) x2 = dst->width;
+    if (x2 <= x1) return;
 
-    r = RTGUI_RGB_R(dst->gc.foreground);
-    g = RTGUI_RGB_G(dst->gc.foreground);
-    b = RTGUI_RGB_B(dst->gc.foreground);
-    a = RTGUI_RGB_A(dst->gc.foreground);
+    if (rtgui_gc_fore_pixel(&dst->gc, dst->pixel_format, &value) == RT_FALSE)
+        return;
+    if (_dc_buffer_own(dst) == RT_FALSE)
+        return;
 
-    switch (dst->pixel_format)
+    _dc_buffer_fill_span(_dc_get_pixel(dst, x1, y1), rtgui_color_get_bpp(dst->pixel_format),
+                         value, x2 - x1);
+}
+
+static void rtgui_dc_buffer_fill_spans(struct rtgui_dc *self, const struct rtgui_span *spans, int count)
+{
+    struct rtgui_dc_buffer *dst;
+    rt_uint32_t value;
+    int bpp;
+
+    dst = (struct rtgui_dc_buffer *)self;
+    if (rtgui_gc_fore_pixel(&dst->gc, dst->pixel_format, &value) == RT_FALSE)
+        return;
+    if (count <= 0 || _dc_buffer_own(dst) == RT_FALSE)
+        return;
+    bpp = rtgui_color_get_bpp(dst->pixel_format);
+
+    for (; count > 0; spans ++, count --)
     {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        HLINE(rt_uint16_t, DRAW_SETPIXEL_RGB565, 0);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
-        HLINE(rt_uint16_t, DRAW_SETPIXEL_BGR565, 0);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        HLINE(rt_uint16_t, DRAW_SETPIXEL_RGB888, 0);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        HLINE(rt_uint32_t, DRAW_SETPIXEL_ARGB8888, 0);
-        break;
+        int x1 = spans->x1, x2 = spans->x2;
+
+        /* the line does not include the end point */
+        if (x1 > x2)
+        {
+            x1 = spans->x2 + 1;
+            x2 = spans->x1 + 1;
+        }
+
+        if (spans->y < 0) continue;
+        if (spans->y >= dst->height) break;
+        if (x1 >= dst->width) continue;
+
+        if (x1 < 0) x1 = 0;
+        if (x2 > dst->width) x2 = dst->width;
+        if (x2 <= x1) continue;
+
+        _dc_buffer_fill_span(_dc_get_pixel(dst, x1, spans->y), bpp, value, x2 - x1);
     }
 }
 
 static void rtgui_dc_buffer_fill_rect(struct rtgui_dc *self, struct rtgui_rect *dst_rect)
 {
     struct rtgui_dc_buffer *dst;
-    unsigned r, g, b, a;
-    rtgui_rect_t _r, *rect;
+    rt_uint32_t value;
+    rt_uint8_t *line, *pixel;
+    int bpp, width, height;
+    rtgui_rect_t _r;
 
     RT_ASSERT(self);
     if (dst_rect == RT_NULL) rtgui_dc_get_rect(self, &_r);
@@ -377,31 +856,83 @@ static void rtgui_dc_buffer_fill_rect(struct rtgui_dc *self, struct rtgui_rect *
         _r.y1 = 0;
     if (_r.y2 > dst->height)
         _r.y2 = dst->height;
-    rect = &_r;
 
-    r = RTGUI_RGB_R(dst->gc.background);
-    g = RTGUI_RGB_G(dst->gc.background);
-    b = RTGUI_RGB_B(dst->gc.background);
-    a = RTGUI_RGB_A(dst->gc.background);
+    width = _r.x2 - _r.x1;
+    height = _r.y2 - _r.y1;
+    if (width <= 0 || height <= 0) return;
 
-    switch (dst->pixel_format)
+    if (rtgui_gc_back_pixel(&dst->gc, dst->pixel_format, &value) == RT_FALSE)
+        return;
+    if (_dc_buffer_own(dst) == RT_FALSE)
+        return;
+
+    bpp = rtgui_color_get_bpp(dst->pixel_format);
+    pixel = _dc_get_pixel(dst, _r.x1, _r.y1);
+    if (width * bpp == _dc_get_pitch(dst))
     {
-    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        FILLRECT(rt_uint16_t, DRAW_SETPIXEL_RGB565);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
-        FILLRECT(rt_uint16_t, DRAW_SETPIXEL_BGR565);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        FILLRECT(rt_uint32_t, DRAW_SETPIXEL_RGB888);
-        break;
-    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
-        FILLRECT(rt_uint32_t, DRAW_SETPIXEL_ARGB8888);
-        break;
+        /* full rows are continuous in the buffer */
+        _dc_buffer_fill_span(pixel, bpp, value, width * height);
+        return;
+    }
+
+    /* fill the first row and replicate it to the others */
+    _dc_buffer_fill_span(pixel, bpp, value, width);
+    for (line = pixel + _dc_get_pitch(dst); --height > 0; line += _dc_get_pitch(dst))
+    {
+        memcpy(line, pixel, width * bpp);
     }
 }
 
 /* blit a dc to another dc */
+/* the palette of P8, or the color which the A8 mask is filled with */
+rt_inline void _dc_buffer_blit_source(struct rtgui_dc_buffer *dc, struct rtgui_blit_info *info)
+{
+    info->palette = _dc_get_palette(dc);
+    info->r = RTGUI_RGB_R(dc->gc.foreground);
+    info->g = RTGUI_RGB_G(dc->gc.foreground);
+    info->b = RTGUI_RGB_B(dc->gc.foreground);
+}
+
+/* draw the pixels of A8 mask covered by half, there is no pixel to blend with */
+static void _dc_buffer_blit_mask_points(struct rtgui_dc_buffer *dc, struct rtgui_dc *dest,
+                                        rtgui_rect_t *rect, rt_uint8_t *pixels, int width, int height)
+{
+    int x, y;
+
+    for (y = 0; y < height; y ++, pixels += dc->pitch)
+    {
+        for (x = 0; x < width; x ++)
+        {
+            if (pixels[x] >= 128)
+                rtgui_dc_draw_color_point(dest, rect->x1 + x, rect->y1 + y, dc->gc.foreground);
+        }
+    }
+}
+
+/* expand a line of L8, P8 or A8 pixels into the line of dst_fmt */
+static void _dc_buffer_expand_line(struct rtgui_dc_buffer *dc, rt_uint8_t *dst, rt_uint8_t dst_fmt,
+                                   rt_uint8_t *src, int width)
+{
+    struct rtgui_blit_info info = { 0 };
+
+    info.src = src;
+    info.src_fmt = dc->pixel_format;
+    _dc_buffer_blit_source(dc, &info);
+    info.src_w = width;
+    info.src_h = 1;
+    info.src_pitch = width;
+
+    info.dst = dst;
+    info.dst_fmt = dst_fmt;
+    info.dst_w = width;
+    info.dst_h = 1;
+    info.dst_pitch = width * rtgui_color_get_bpp(dst_fmt);
+
+    /* the mask is blended on the line, the others are copied */
+    info.a = dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA ? dc->pixel_alpha : 0;
+    rtgui_blit(&info);
+}
+
 static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
                                  struct rtgui_point *dc_pt,
                                  struct rtgui_dc *dest,
@@ -462,6 +993,10 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
     rect_width  = _UI_MIN(rtgui_rect_width(*dest_rect), dc->width - dc_point.x);
     rect_height = _UI_MIN(rtgui_rect_height(*dest_rect), dc->height - dc_point.y);
 
+    /* the lazy buffer is blitted as cleared */
+    if (_dc_buffer_materialize(dc) == RT_FALSE)
+        return;
+
     if ((dest->type == RTGUI_DC_HW) || (dest->type == RTGUI_DC_CLIENT))
     {
         int index;
@@ -488,6 +1023,7 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
             /* blit source */
             info.src = _dc_get_pixel(dc, dc_point.x, dc_point.y);
             info.src_fmt = dc->pixel_format;
+            _dc_buffer_blit_source(dc, &info);
             info.src_h = rect_height;
             info.src_w = rect_width;
             info.src_pitch = dc->pitch;
@@ -505,7 +1041,8 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
             info.dst_pitch = hw_driver->pitch;
             info.dst_skip = info.dst_pitch - info.dst_w * rtgui_color_get_bpp(hw_driver->pixel_format);
 
-            rtgui_blit(&info);
+            if (_dc_buffer_blit_direct(&info) == RT_FALSE)
+                rtgui_blit(&info);
         }
         else if (dest->type == RTGUI_DC_CLIENT && hw_driver->framebuffer != RT_NULL)
         {
@@ -538,6 +1075,7 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
             else
                 info.a = 255;
             info.src_fmt = dc->pixel_format;
+            _dc_buffer_blit_source(dc, &info);
             info.src_pitch = dc->pitch;
 
             info.dst_fmt = hw_driver->pixel_format;
@@ -565,7 +1103,8 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
                 info.dst_w = blit_width;
                 info.dst_skip = info.dst_pitch - info.dst_w * hw_bpp;
 
-                rtgui_blit(&info);
+                if (_dc_buffer_blit_direct(&info) == RT_FALSE)
+                    rtgui_blit(&info);
             }
 
             rtgui_region_fini(&dest_region);
@@ -578,6 +1117,13 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
             /* get blit line function */
             blit_line = rtgui_blit_line_get(_UI_BITBYTES(hw_driver->bits_per_pixel),
                                             rtgui_color_get_bpp(dc->pixel_format));
+            /* the 8bit pixels are not RGB332 and the 4444 ones are not RGB565, expand them in rtgui_blit */
+            if (dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_L8 ||
+                    dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_P8 ||
+                    dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA ||
+                    dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444 ||
+                    dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE)
+                blit_line = RT_NULL;
             if (hw_driver->framebuffer != RT_NULL)
             {
                 struct rtgui_widget* owner = RT_NULL;
@@ -591,14 +1137,29 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
 
                 /* change the logic coordinate to the device coordinate */
                 rtgui_rect_move(dest_rect, owner->extent.x1, owner->extent.y1);
+#ifdef GUIENGINE_USING_OVERDRAW
+                {
+                    rtgui_rect_t r;
+
+                    rtgui_rect_init(&r, dest_rect->x1, dest_rect->y1, rect_width, rect_height);
+                    rtgui_overdraw_rect(&r);
+                }
+#endif
 
                 for (index = dest_rect->y1; index < dest_rect->y1 + rect_height; index ++)
                 {
                     line_ptr = _hw_get_pixel(hw_driver, dest_rect->x1, index, rt_uint8_t);
-                    blit_line(line_ptr, (rt_uint8_t*)pixels, pitch);
+                    if (blit_line != RT_NULL)
+                        blit_line(line_ptr, (rt_uint8_t*)pixels, pitch);
+                    else
+                        _dc_buffer_expand_line(dc, line_ptr, hw_driver->pixel_format, pixels, rect_width);
                     pixels += dc->pitch;
                 }
             }
+            else if (dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+            {
+                _dc_buffer_blit_mask_points(dc, dest, dest_rect, pixels, rect_width, rect_height);
+            }
             else
             {
                 /* calculate pitch */
@@ -610,7 +1171,10 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
                 for (index = dest_rect->y1; index < dest_rect->y1 + rect_height; index ++)
                 {
                     /* blit on line buffer */
-                    blit_line(line_ptr, (rt_uint8_t *)pixels, pitch);
+                    if (blit_line != RT_NULL)
+                        blit_line(line_ptr, (rt_uint8_t *)pixels, pitch);
+                    else
+                        _dc_buffer_expand_line(dc, line_ptr, hw_driver->pixel_format, pixels, rect_width);
                     pixels += dc->pitch;
 
                     /* draw on hardware dc */
@@ -630,6 +1194,9 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
         /* use rtgui_blit to handle buffer blit */
         struct rtgui_blit_info info = { 0 };
 
+        if (_dc_buffer_own(dest_dc) == RT_FALSE)
+            return;
+
         if (self->type == RTGUI_DC_BUFFER)
             info.a = dc->pixel_alpha;
         else
@@ -638,6 +1205,7 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
         /* blit source */
         info.src = _dc_get_pixel(dc, dc_point.x, dc_point.y);
         info.src_fmt = dc->pixel_format;
+        _dc_buffer_blit_source(dc, &info);
         info.src_h = rect_height;
         info.src_w = rect_width;
         info.src_pitch = dc->pitch;
@@ -651,7 +1219,8 @@ static void rtgui_dc_buffer_blit(struct rtgui_dc *self,
         info.dst_pitch = dest_dc->pitch;
         info.dst_skip = info.dst_pitch - info.dst_w * rtgui_color_get_bpp(dest_dc->pixel_format);
 
-        rtgui_blit(&info);
+        if (_dc_buffer_blit_direct(&info) == RT_FALSE)
+            rtgui_blit(&info);
     }
 }
 
@@ -667,11 +1236,19 @@ static void rtgui_dc_buffer_blit_line(struct rtgui_dc *self, int x1, int x2, int
     if ((x1 >= dc->width) || (y >= dc->height) || y < 0 || x1 == x2)
         return;
 
-    /* check range */
+    /* check range, the line data is from x1 */
     if (x1 < 0)
+    {
+        line_data -= x1 * rtgui_color_get_bpp(dc->pixel_format);
         x1 = 0;
-    if (x2 >= dc->width)
-        x2 = dc->width-1;
+    }
+    if (x2 > dc->width)
+        x2 = dc->width;
+    if (x2 <= x1)
+        return;
+
+    if (_dc_buffer_own(dc) == RT_FALSE)
+        return;
 
     pixel = _dc_get_pixel(dc,x1,y);
     memcpy(pixel, line_data, (x2 - x1) * rtgui_color_get_bpp(dc->pixel_format));
@@ -691,6 +1268,7 @@ void rtgui_dc_buffer_dump(struct rtgui_dc *self, char *fn)
 
     if (self->type != RTGUI_DC_BUFFER) return; /* only support DC buffer */
     buffer = (struct rtgui_dc_buffer*)self;
+    if (_dc_buffer_materialize(buffer) == RT_FALSE) return;
 
     header.w = buffer->width;
     header.h = buffer->height;
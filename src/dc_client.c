@@ -41,6 +41,7 @@ static void rtgui_dc_client_draw_vline(struct rtgui_dc *dc, int x, int y1, int y
 static void rtgui_dc_client_fill_rect(struct rtgui_dc *dc, rtgui_rect_t *rect);
 static void rtgui_dc_client_blit_line(struct rtgui_dc *self, int x1, int x2, int y, rt_uint8_t *line_data);
 static void rtgui_dc_client_blit(struct rtgui_dc *dc, struct rtgui_point *dc_point, struct rtgui_dc *dest, rtgui_rect_t *rect);
+static void rtgui_dc_client_fill_spans(struct rtgui_dc *dc, const struct rtgui_span *spans, int count);
 static rt_bool_t rtgui_dc_client_fini(struct rtgui_dc *dc);
 
 #define hw_driver               (rtgui_graphic_driver_get_default())
@@ -57,6 +58,7 @@ const struct rtgui_dc_engine dc_client_engine =
     rtgui_dc_client_fill_rect,
     rtgui_dc_client_blit_line,
     rtgui_dc_client_blit,
+    rtgui_dc_client_fill_spans,
 
     rtgui_dc_client_fini,
 };
@@ -77,6 +79,12 @@ struct rtgui_dc *rtgui_dc_client_create(rtgui_widget_t *owner)
     /* adjudge owner */
     if (owner == RT_NULL || owner->toplevel == RT_NULL) return RT_NULL;
 
+    /* the clip is fixed in one drawing, check the single rect clip once */
+    if (rtgui_region_is_flat(&(owner->clip)) == RT_EOK)
+        owner->flag |= RTGUI_WIDGET_FLAG_DC_SCISSOR;
+    else
+        owner->flag &= ~RTGUI_WIDGET_FLAG_DC_SCISSOR;
+
     return RTGUI_WIDGET_DC(owner);
 }
 
@@ -100,11 +108,20 @@ static void rtgui_dc_client_draw_point(struct rtgui_dc *self, int x, int y)
 
     /* get owner */
     owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
+    rtgui_graphic_driver_accel_sync();
 
     x = x + owner->extent.x1;
     y = y + owner->extent.y1;
 
-    if (rtgui_region_contains_point(&(owner->clip), x, y, &rect) == RT_EOK)
+    if (RTGUI_WIDGET_IS_DC_SCISSOR(owner))
+    {
+        if (x < owner->clip.extents.x1 || x >= owner->clip.extents.x2 ||
+                y < owner->clip.extents.y1 || y >= owner->clip.extents.y2)
+            return;
+
+        hw_driver->ops->set_pixel(&(owner->gc.foreground), x, y);
+    }
+    else if (rtgui_region_contains_point(&(owner->clip), x, y, &rect) == RT_EOK)
     {
         /* draw this point */
         hw_driver->ops->set_pixel(&(owner->gc.foreground), x, y);
@@ -121,11 +138,20 @@ static void rtgui_dc_client_draw_color_point(struct rtgui_dc *self, int x, int y
 
     /* get owner */
     owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
+    rtgui_graphic_driver_accel_sync();
 
     x = x + owner->extent.x1;
     y = y + owner->extent.y1;
 
-    if (rtgui_region_contains_point(&(owner->clip), x, y, &rect) == RT_EOK)
+    if (RTGUI_WIDGET_IS_DC_SCISSOR(owner))
+    {
+        if (x < owner->clip.extents.x1 || x >= owner->clip.extents.x2 ||
+                y < owner->clip.extents.y1 || y >= owner->clip.extents.y2)
+            return;
+
+        hw_driver->ops->set_pixel(&color, x, y);
+    }
+    else if (rtgui_region_contains_point(&(owner->clip), x, y, &rect) == RT_EOK)
     {
         /* draw this point */
         hw_driver->ops->set_pixel(&color, x, y);
@@ -137,7 +163,10 @@ static void rtgui_dc_client_draw_color_point(struct rtgui_dc *self, int x, int y
  */
 static void rtgui_dc_client_draw_vline(struct rtgui_dc *self, int x, int y1, int y2)
 {
-    register rt_base_t index;
+    register rt_base_t index, num;
+    rtgui_rect_t *rects;
+    rt_bool_t native;
+    rt_uint32_t pixel;
     rtgui_widget_t *owner;
 
     if (self == RT_NULL) return;
@@ -145,13 +174,16 @@ static void rtgui_dc_client_draw_vline(struct rtgui_dc *self, int x, int y1, int
 
     /* get owner */
     owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
+    rtgui_graphic_driver_accel_sync();
+    /* the pixel cached in gc is drawn on framebuffer */
+    native = rtgui_gc_fore_pixel(&(owner->gc), hw_driver->pixel_format, &pixel);
 
     x  = x + owner->extent.x1;
     y1 = y1 + owner->extent.y1;
     y2 = y2 + owner->extent.y1;
     if (y1 > y2) _int_swap(y1, y2);
 
-    if (owner->clip.data == RT_NULL)
+    if (RTGUI_WIDGET_IS_DC_SCISSOR(owner))
     {
         rtgui_rect_t *prect;
 
@@ -165,16 +197,19 @@ static void rtgui_dc_client_draw_vline(struct rtgui_dc *self, int x, int y1, int
         if (prect->y2 < y2) y2 = prect->y2;
 
         /* draw vline */
-        hw_driver->ops->draw_vline(&(owner->gc.foreground), x, y1, y2);
+        if (!native || !rtgui_graphic_driver_draw_vline_pixel(hw_driver, pixel, x, y1, y2))
+            hw_driver->ops->draw_vline(&(owner->gc.foreground), x, y1, y2);
     }
     else
     {
-        for (index = 0; index < rtgui_region_num_rects(&(owner->clip)); index ++)
+        num = rtgui_region_num_rects(&(owner->clip));
+        rects = rtgui_region_rects(&(owner->clip));
+        for (index = 0; index < num; index ++)
         {
             rtgui_rect_t *prect;
             register rt_base_t draw_y1, draw_y2;
 
-            prect = ((rtgui_rect_t *)(owner->clip.data + index + 1));
+            prect = &rects[index];
             draw_y1 = y1;
             draw_y2 = y2;
 
@@ -186,7 +221,8 @@ static void rtgui_dc_client_draw_vline(struct rtgui_dc *self, int x, int y1, int
             if (prect->y2 < y2) draw_y2 = prect->y2;
 
             /* draw vline */
-            hw_driver->ops->draw_vline(&(owner->gc.foreground), x, draw_y1, draw_y2);
+            if (!native || !rtgui_graphic_driver_draw_vline_pixel(hw_driver, pixel, x, draw_y1, draw_y2))
+                hw_driver->ops->draw_vline(&(owner->gc.foreground), x, draw_y1, draw_y2);
         }
     }
 }
@@ -196,7 +232,10 @@ static void rtgui_dc_client_draw_vline(struct rtgui_dc *self, int x, int y1, int
  */
 static void rtgui_dc_client_draw_hline(struct rtgui_dc *self, int x1, int x2, int y)
 {
-    register rt_base_t index;
+    int draw_x1, draw_x2;
+    struct rtgui_region_span_iter iter;
+    rt_bool_t native;
+    rt_uint32_t pixel;
     rtgui_widget_t *owner;
 
     if (self == RT_NULL) return;
@@ -204,6 +243,9 @@ static void rtgui_dc_client_draw_hline(struct rtgui_dc *self, int x1, int x2, in
 
     /* get owner */
     owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
+    rtgui_graphic_driver_accel_sync();
+    /* the pixel cached in gc is drawn on framebuffer */
+    native = rtgui_gc_fore_pixel(&(owner->gc), hw_driver->pixel_format, &pixel);
 
     /* convert logic to device */
     x1 = x1 + owner->extent.x1;
@@ -211,7 +253,7 @@ static void rtgui_dc_client_draw_hline(struct rtgui_dc *self, int x1, int x2, in
     if (x1 > x2) _int_swap(x1, x2);
     y  = y + owner->extent.y1;
 
-    if (owner->clip.data == RT_NULL)
+    if (RTGUI_WIDGET_IS_DC_SCISSOR(owner))
     {
         rtgui_rect_t *prect;
 
@@ -225,36 +267,78 @@ static void rtgui_dc_client_draw_hline(struct rtgui_dc *self, int x1, int x2, in
         if (prect->x2 < x2) x2 = prect->x2;
 
         /* draw hline */
-        hw_driver->ops->draw_hline(&(owner->gc.foreground), x1, x2, y);
+        if (!native || !rtgui_graphic_driver_draw_hline_pixel(hw_driver, pixel, x1, x2, y))
+            hw_driver->ops->draw_hline(&(owner->gc.foreground), x1, x2, y);
     }
     else
     {
-        for (index = 0; index < rtgui_region_num_rects(&(owner->clip)); index ++)
+        rtgui_region_span_begin(&iter, &(owner->clip), y, x1, x2);
+        while (rtgui_region_span_next(&iter, &draw_x1, &draw_x2))
         {
-            rtgui_rect_t *prect;
-            register rt_base_t draw_x1, draw_x2;
+            /* draw hline */
+            if (!native || !rtgui_graphic_driver_draw_hline_pixel(hw_driver, pixel, draw_x1, draw_x2, y))
+                hw_driver->ops->draw_hline(&(owner->gc.foreground), draw_x1, draw_x2, y);
+        }
+    }
+}
+
+/*
+ * fill the logic spans on device, each span is clipped by the spans of clip
+ * in its row.
+ */
+static void rtgui_dc_client_fill_spans(struct rtgui_dc *self, const struct rtgui_span *spans, int count)
+{
+    int x1, x2, y, draw_x1, draw_x2;
+    struct rtgui_region_span_iter iter;
+    rt_bool_t native;
+    rt_uint32_t pixel;
+    rtgui_widget_t *owner;
 
-            prect = ((rtgui_rect_t *)(owner->clip.data + index + 1));
-            draw_x1 = x1;
-            draw_x2 = x2;
+    if (self == RT_NULL) return;
+    if (!rtgui_dc_get_visible(self)) return;
 
-            /* calculate hline clip */
-            if (prect->y1 > y  || prect->y2 <= y) continue;
-            if (prect->x2 <= x1 || prect->x1 > x2) continue;
+    /* get owner */
+    owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
+    rtgui_graphic_driver_accel_sync();
+    native = rtgui_gc_fore_pixel(&(owner->gc), hw_driver->pixel_format, &pixel);
 
-            if (prect->x1 > x1) draw_x1 = prect->x1;
-            if (prect->x2 < x2) draw_x2 = prect->x2;
+    for (; count > 0; spans ++, count --)
+    {
+        /* convert logic to device */
+        x1 = spans->x1 + owner->extent.x1;
+        x2 = spans->x2 + owner->extent.x1;
+        if (x1 > x2) _int_swap(x1, x2);
+        y  = spans->y + owner->extent.y1;
 
+        if (RTGUI_WIDGET_IS_DC_SCISSOR(owner))
+        {
+            /* the spans are sorted by y, the rest are below the scissor */
+            if (y >= owner->clip.extents.y2) break;
+            if (y < owner->clip.extents.y1) continue;
+
+            draw_x1 = x1 > owner->clip.extents.x1 ? x1 : owner->clip.extents.x1;
+            draw_x2 = x2 < owner->clip.extents.x2 ? x2 : owner->clip.extents.x2;
+            if (draw_x1 >= draw_x2) continue;
+
+            if (!native || !rtgui_graphic_driver_draw_hline_pixel(hw_driver, pixel, draw_x1, draw_x2, y))
+                hw_driver->ops->draw_hline(&(owner->gc.foreground), draw_x1, draw_x2, y);
+            continue;
+        }
+
+        rtgui_region_span_begin(&iter, &(owner->clip), y, x1, x2);
+        while (rtgui_region_span_next(&iter, &draw_x1, &draw_x2))
+        {
             /* draw hline */
-            hw_driver->ops->draw_hline(&(owner->gc.foreground), draw_x1, draw_x2, y);
+            if (!native || !rtgui_graphic_driver_draw_hline_pixel(hw_driver, pixel, draw_x1, draw_x2, y))
+                hw_driver->ops->draw_hline(&(owner->gc.foreground), draw_x1, draw_x2, y);
         }
     }
 }
 
 static void rtgui_dc_client_fill_rect(struct rtgui_dc *self, struct rtgui_rect *rect)
 {
-    rtgui_color_t foreground;
-    register rt_base_t index;
+    register rt_base_t index, num;
+    rtgui_rect_t *prect, r;
     rtgui_widget_t *owner;
 
     RT_ASSERT(self);
@@ -265,25 +349,29 @@ static void rtgui_dc_client_fill_rect(struct rtgui_dc *self, struct rtgui_rect *
     /* get owner */
     owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
 
-    /* save foreground color */
-    foreground = owner->gc.foreground;
+    /* fill the rect intersected with each clip rect at once */
+    num = rtgui_region_num_rects(&(owner->clip));
+    prect = rtgui_region_rects(&(owner->clip));
+    for (index = 0; index < num; index ++)
+    {
+        /* convert logic to device */
+        r = *rect;
+        rtgui_rect_move(&r, owner->extent.x1, owner->extent.y1);
 
-    /* set background color as foreground color */
-    owner->gc.foreground = owner->gc.background;
+        /* the clip rects are sorted by y */
+        if (prect[index].y1 >= r.y2) break;
 
-    /* fill rect */
-    for (index = rect->y1; index < rect->y2; index ++)
-    {
-        rtgui_dc_client_draw_hline(self, rect->x1, rect->x2, index);
-    }
+        rtgui_rect_intersect(&prect[index], &r);
+        if (r.x1 >= r.x2 || r.y1 >= r.y2) continue;
 
-    /* restore foreground color */
-    owner->gc.foreground = foreground;
+        rtgui_graphic_driver_fill_rect(hw_driver, owner->gc.background, &r);
+    }
 }
 
 static void rtgui_dc_client_blit_line(struct rtgui_dc *self, int x1, int x2, int y, rt_uint8_t *line_data)
 {
-    register rt_base_t index;
+    int draw_x1, draw_x2;
+    struct rtgui_region_span_iter iter;
     rtgui_widget_t *owner;
 
     if (self == RT_NULL) return;
@@ -291,6 +379,7 @@ static void rtgui_dc_client_blit_line(struct rtgui_dc *self, int x1, int x2, int
 
     /* get owner */
     owner = RTGUI_CONTAINER_OF(self, struct rtgui_widget, dc_type);
+    rtgui_graphic_driver_accel_sync();
 
     /* convert logic to device */
     x1 = x1 + owner->extent.x1;
@@ -298,7 +387,7 @@ static void rtgui_dc_client_blit_line(struct rtgui_dc *self, int x1, int x2, int
     if (x1 > x2) _int_swap(x1, x2);
     y  = y + owner->extent.y1;
 
-    if (rtgui_region_is_flat(&(owner->clip)) == RT_EOK)
+    if (RTGUI_WIDGET_IS_DC_SCISSOR(owner))
     {
         rtgui_rect_t *prect;
         int offset = 0;
@@ -321,22 +410,9 @@ static void rtgui_dc_client_blit_line(struct rtgui_dc *self, int x1, int x2, int
     }
     else
     {
-        for (index = 0; index < rtgui_region_num_rects(&(owner->clip)); index ++)
+        rtgui_region_span_begin(&iter, &(owner->clip), y, x1, x2);
+        while (rtgui_region_span_next(&iter, &draw_x1, &draw_x2))
         {
-            rtgui_rect_t *prect;
-            register rt_base_t draw_x1, draw_x2;
-
-            prect = ((rtgui_rect_t *)(owner->clip.data + index + 1));
-            draw_x1 = x1;
-            draw_x2 = x2;
-
-            /* calculate hline clip */
-            if (prect->y1 > y  || prect->y2 <= y) continue;
-            if (prect->x2 <= x1 || prect->x1 > x2) continue;
-
-            if (prect->x1 > x1) draw_x1 = prect->x1;
-            if (prect->x2 < x2) draw_x2 = prect->x2;
-
             /* draw hline */
             hw_driver->ops->draw_raw_hline(line_data + (draw_x1 - x1) * _UI_BITBYTES(hw_driver->bits_per_pixel), draw_x1, draw_x2, y);
         }
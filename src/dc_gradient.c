@@ -0,0 +1,314 @@
+/*
+ * File      : dc_gradient.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
+
+/* the squared distance of radial gradient in 1/1024 of the radius */
+#define RADIAL_SHIFT        10
+#define RADIAL_ONE          (1 << RADIAL_SHIFT)
+
+static rt_uint32_t _gradient_isqrt(rt_uint32_t value)
+{
+    rt_uint32_t root = 0, bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+static rtgui_color_t _gradient_lerp(rtgui_color_t c1, rtgui_color_t c2, int t, int n)
+{
+    return RTGUI_ARGB(((int)RTGUI_RGB_A(c2) - RTGUI_RGB_A(c1)) * t / n + RTGUI_RGB_A(c1),
+                      ((int)RTGUI_RGB_R(c2) - RTGUI_RGB_R(c1)) * t / n + RTGUI_RGB_R(c1),
+                      ((int)RTGUI_RGB_G(c2) - RTGUI_RGB_G(c1)) * t / n + RTGUI_RGB_G(c1),
+                      ((int)RTGUI_RGB_B(c2) - RTGUI_RGB_B(c1)) * t / n + RTGUI_RGB_B(c1));
+}
+
+/*
+ * Create a gradient of the stops, which offsets (0 - 255) are ascending. The
+ * ramp of 256 colors is built once here, and the fills only look it up.
+ */
+struct rtgui_gradient *rtgui_gradient_create(enum rtgui_gradient_type type,
+                                             const struct rtgui_gradient_stop *stops, int count)
+{
+    int index, stop;
+    struct rtgui_gradient *gradient;
+
+    RT_ASSERT(stops != RT_NULL && count > 0);
+
+    gradient = (struct rtgui_gradient *)rtgui_malloc(sizeof(struct rtgui_gradient));
+    if (gradient == RT_NULL)
+        return RT_NULL;
+
+    gradient->type = type;
+    gradient->opaque = RT_TRUE;
+    for (index = 0, stop = 0; index < 256; index ++)
+    {
+        while (stop < count && stops[stop].offset < index)
+            stop ++;
+
+        if (stop == 0)
+            gradient->ramp[index] = stops[0].color;
+        else if (stop == count)
+            gradient->ramp[index] = stops[count - 1].color;
+        else
+            gradient->ramp[index] = _gradient_lerp(stops[stop - 1].color, stops[stop].color,
+                                                   index - stops[stop - 1].offset,
+                                                   stops[stop].offset - stops[stop - 1].offset);
+
+        if (RTGUI_RGB_A(gradient->ramp[index]) != 255)
+            gradient->opaque = RT_FALSE;
+    }
+
+    /* the index of ramp for the squared distance, no sqrt in the fill */
+    if (type == RTGUI_GRADIENT_RADIAL)
+    {
+        for (index = 0; index < RADIAL_ONE; index ++)
+            gradient->radial[index] = (rt_uint8_t)_gradient_isqrt(index * 255 * 255 / RADIAL_ONE);
+    }
+
+    return gradient;
+}
+RTM_EXPORT(rtgui_gradient_create);
+
+void rtgui_gradient_destroy(struct rtgui_gradient *gradient)
+{
+    rtgui_free(gradient);
+}
+RTM_EXPORT(rtgui_gradient_destroy);
+
+/* the ramp index of each column, or the squared distance to center for radial */
+static void _gradient_columns(const struct rtgui_gradient *gradient, const rtgui_rect_t *rect, int *columns)
+{
+    int x, w, fx;
+
+    w = rtgui_rect_width(*rect);
+    for (x = 0; x < w; x ++)
+    {
+        if (gradient->type == RTGUI_GRADIENT_RADIAL)
+        {
+            /* in the center of pixel, the radius is the half of width */
+            fx = (2 * x + 1 - w) * RADIAL_ONE / w;
+            columns[x] = fx * fx;
+        }
+        else
+        {
+            columns[x] = w > 1 ? x * 255 / (w - 1) : 0;
+        }
+    }
+}
+
+static int _gradient_row(const struct rtgui_gradient *gradient, const rtgui_rect_t *rect, int y)
+{
+    int h, fy;
+
+    h = rtgui_rect_height(*rect);
+    y -= rect->y1;
+    if (gradient->type == RTGUI_GRADIENT_RADIAL)
+    {
+        fy = (2 * y + 1 - h) * RADIAL_ONE / h;
+        return fy * fy;
+    }
+
+    return h > 1 ? y * 255 / (h - 1) : 0;
+}
+
+/* the index of ramp at the column and row */
+static int _gradient_index(const struct rtgui_gradient *gradient, int column, int row)
+{
+    rt_uint32_t d;
+
+    switch (gradient->type)
+    {
+    case RTGUI_GRADIENT_HORIZONTAL:
+        return column;
+    case RTGUI_GRADIENT_VERTICAL:
+        return row;
+    default:
+        d = ((rt_uint32_t)column + row) >> RADIAL_SHIFT;
+        return d < RADIAL_ONE ? gradient->radial[d] : 255;
+    }
+}
+
+static void _gradient_store(rt_uint8_t *ptr, int bpp, rt_uint32_t pixel)
+{
+    switch (bpp)
+    {
+    case 1:
+        *ptr = (rt_uint8_t)pixel;
+        break;
+    case 2:
+        *(rt_uint16_t *)ptr = (rt_uint16_t)pixel;
+        break;
+    case 3:
+        ptr[0] = (rt_uint8_t)pixel;
+        ptr[1] = (rt_uint8_t)(pixel >> 8);
+        ptr[2] = (rt_uint8_t)(pixel >> 16);
+        break;
+    default:
+        *(rt_uint32_t *)ptr = pixel;
+        break;
+    }
+}
+
+/* the gradient with alpha or in the formats without pixel, drawn in points */
+static void _gradient_fill_points(struct rtgui_dc *dc, rtgui_rect_t *rect,
+                                  const struct rtgui_gradient *gradient, int *columns)
+{
+    int x, y, row;
+
+    for (y = rect->y1; y < rect->y2; y ++)
+    {
+        row = _gradient_row(gradient, rect, y);
+        for (x = rect->x1; x < rect->x2; x ++)
+            rtgui_dc_draw_color_point(dc, x, y,
+                                      gradient->ramp[_gradient_index(gradient, columns[x - rect->x1], row)]);
+    }
+}
+
+/*
+ * Fill the rect with gradient. An opaque gradient is written in the lines of
+ * native pixels by blit_line: the line of horizontal gradient is built once
+ * for all rows, a row of vertical gradient is a hline. The gradient on RGB565
+ * is dithered with GUIENGINE_USING_DITHER.
+ */
+void rtgui_dc_fill_gradient(struct rtgui_dc *dc, rtgui_rect_t *rect, const struct rtgui_gradient *gradient)
+{
+    int x, y, w, bpp, row, lines, dither, index;
+    int *columns;
+    rt_uint8_t fmt, *line, *ptr;
+    rt_uint32_t pixel, *pixels;
+    rtgui_color_t fc;
+
+    RT_ASSERT(dc != RT_NULL && rect != RT_NULL && gradient != RT_NULL);
+
+    w = rtgui_rect_width(*rect);
+    if (w <= 0 || rect->y1 >= rect->y2)
+        return;
+    if (!rtgui_dc_get_visible(dc))
+        return;
+
+    fmt = rtgui_dc_get_pixel_format(dc);
+    bpp = rtgui_color_get_bpp(fmt);
+    dither = 0;
+#ifdef GUIENGINE_USING_DITHER
+    if (fmt == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+        dither = 1;
+#endif
+
+    /* the columns, the 256 native pixels of ramp and 4 lines for the dither */
+    columns = (int *)rtgui_malloc(w * sizeof(int) + 256 * sizeof(rt_uint32_t) + 4 * w * bpp);
+    if (columns == RT_NULL)
+        return;
+    pixels = (rt_uint32_t *)(columns + w);
+    line = (rt_uint8_t *)(pixels + 256);
+    _gradient_columns(gradient, rect, columns);
+
+    if (gradient->opaque == RT_FALSE || bpp > 4 ||
+            rtgui_color_to_pixel(fmt, gradient->ramp[0], &pixel) == RT_FALSE)
+    {
+        _gradient_fill_points(dc, rect, gradient, columns);
+        rtgui_free(columns);
+        return;
+    }
+    for (x = 0; x < 256; x ++)
+        rtgui_color_to_pixel(fmt, gradient->ramp[x], &pixels[x]);
+
+    fc = RTGUI_DC_FC(dc);
+    if (gradient->type == RTGUI_GRADIENT_HORIZONTAL)
+    {
+        /* the same line for each row, or 4 lines of the dither */
+        lines = dither ? 4 : 1;
+        for (y = 0; y < lines; y ++)
+        {
+            ptr = line + y * w * bpp;
+            for (x = 0; x < w; x ++, ptr += bpp)
+            {
+#ifdef GUIENGINE_USING_DITHER
+                if (dither)
+                {
+                    _gradient_store(ptr, bpp, rtgui_color_to_565_dither(gradient->ramp[columns[x]],
+                                    rect->x1 + x, rect->y1 + y));
+                    continue;
+                }
+#endif
+                _gradient_store(ptr, bpp, pixels[columns[x]]);
+            }
+        }
+
+        for (y = rect->y1; y < rect->y2; y ++)
+            dc->engine->blit_line(dc, rect->x1, rect->x2, y,
+                                  line + ((y - rect->y1) % lines) * w * bpp);
+    }
+    else
+    {
+        for (y = rect->y1; y < rect->y2; y ++)
+        {
+            row = _gradient_row(gradient, rect, y);
+            if (gradient->type == RTGUI_GRADIENT_VERTICAL && !dither)
+            {
+                /* a row is in one color */
+                RTGUI_DC_FC(dc) = gradient->ramp[row];
+                rtgui_dc_draw_hline(dc, rect->x1, rect->x2, y);
+                continue;
+            }
+
+            for (x = 0, ptr = line; x < w; x ++, ptr += bpp)
+            {
+                index = _gradient_index(gradient, columns[x], row);
+#ifdef GUIENGINE_USING_DITHER
+                if (dither)
+                {
+                    _gradient_store(ptr, bpp, rtgui_color_to_565_dither(gradient->ramp[index], rect->x1 + x, y));
+                    continue;
+                }
+#endif
+                _gradient_store(ptr, bpp, pixels[index]);
+            }
+            dc->engine->blit_line(dc, rect->x1, rect->x2, y, line);
+        }
+    }
+    RTGUI_DC_FC(dc) = fc;
+
+    rtgui_free(columns);
+}
+RTM_EXPORT(rtgui_dc_fill_gradient);
@@ -21,6 +21,8 @@
  * Date           Author       Notes
  * 2009-10-16     Bernard      first version
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
 #include <rtgui/dc.h>
 #include <rtgui/driver.h>
 #include <rtgui/rtgui_system.h>
@@ -39,7 +41,9 @@ static void rtgui_dc_hw_draw_vline(struct rtgui_dc *dc, int x, int y1, int y2);
 static void rtgui_dc_hw_fill_rect(struct rtgui_dc *dc, rtgui_rect_t *rect);
 static void rtgui_dc_hw_blit_line(struct rtgui_dc *self, int x1, int x2, int y, rt_uint8_t *line_data);
 static void rtgui_dc_hw_blit(struct rtgui_dc *dc, struct rtgui_point *dc_point, struct rtgui_dc *dest, rtgui_rect_t *rect);
+static void rtgui_dc_hw_fill_spans(struct rtgui_dc *dc, const struct rtgui_span *spans, int count);
 static rt_bool_t rtgui_dc_hw_fini(struct rtgui_dc *dc);
+static const struct rtgui_dc_engine *_dc_hw_get_engine(const struct rtgui_graphic_driver *driver);
 
 const struct rtgui_dc_engine dc_hw_engine =
 {
@@ -50,6 +54,7 @@ const struct rtgui_dc_engine dc_hw_engine =
     rtgui_dc_hw_fill_rect,
     rtgui_dc_hw_blit_line,
     rtgui_dc_hw_blit,
+    rtgui_dc_hw_fill_spans,
 
     rtgui_dc_hw_fini,
 };
@@ -66,9 +71,9 @@ struct rtgui_dc *rtgui_dc_hw_create(rtgui_widget_t *owner)
     if (dc)
     {
         dc->parent.type = RTGUI_DC_HW;
-        dc->parent.engine = &dc_hw_engine;
         dc->owner = owner;
         dc->hw_driver = rtgui_graphic_driver_get_default();
+        dc->parent.engine = _dc_hw_get_engine(dc->hw_driver);
 
         return &(dc->parent);
     }
@@ -95,6 +100,7 @@ static void rtgui_dc_hw_draw_point(struct rtgui_dc *self, int x, int y)
 
     RT_ASSERT(self != RT_NULL);
     dc = (struct rtgui_dc_hw *) self;
+    rtgui_graphic_driver_accel_sync();
 
     if (x < 0 || y < 0)
         return;
@@ -116,6 +122,7 @@ static void rtgui_dc_hw_draw_color_point(struct rtgui_dc *self, int x, int y, rt
 
     RT_ASSERT(self != RT_NULL);
     dc = (struct rtgui_dc_hw *) self;
+    rtgui_graphic_driver_accel_sync();
 
     if (x < 0 || y < 0)
         return;
@@ -136,10 +143,12 @@ static void rtgui_dc_hw_draw_color_point(struct rtgui_dc *self, int x, int y, rt
  */
 static void rtgui_dc_hw_draw_vline(struct rtgui_dc *self, int x, int y1, int y2)
 {
+    rt_uint32_t pixel;
     struct rtgui_dc_hw *dc;
 
     RT_ASSERT(self != RT_NULL);
     dc = (struct rtgui_dc_hw *) self;
+    rtgui_graphic_driver_accel_sync();
 
     if (x < 0)
         return;
@@ -160,7 +169,10 @@ static void rtgui_dc_hw_draw_vline(struct rtgui_dc *self, int x, int y1, int y2)
         y2 = dc->owner->extent.y2;
 
 
-    /* draw vline */
+    /* draw vline, in the pixel cached in gc on framebuffer */
+    if (rtgui_gc_fore_pixel(&(dc->owner->gc), dc->hw_driver->pixel_format, &pixel) &&
+            rtgui_graphic_driver_draw_vline_pixel(dc->hw_driver, pixel, x, y1, y2))
+        return;
     dc->hw_driver->ops->draw_vline(&(dc->owner->gc.foreground), x, y1, y2);
 }
 
@@ -169,10 +181,12 @@ static void rtgui_dc_hw_draw_vline(struct rtgui_dc *self, int x, int y1, int y2)
  */
 static void rtgui_dc_hw_draw_hline(struct rtgui_dc *self, int x1, int x2, int y)
 {
+    rt_uint32_t pixel;
     struct rtgui_dc_hw *dc;
 
     RT_ASSERT(self != RT_NULL);
     dc = (struct rtgui_dc_hw *) self;
+    rtgui_graphic_driver_accel_sync();
 
     if (y < 0)
         return;
@@ -193,13 +207,60 @@ static void rtgui_dc_hw_draw_hline(struct rtgui_dc *self, int x1, int x2, int y)
     if (x2 > dc->owner->extent.x2)
         x2 = dc->owner->extent.x2;
 
-    /* draw hline */
+    /* draw hline, in the pixel cached in gc on framebuffer */
+    if (rtgui_gc_fore_pixel(&(dc->owner->gc), dc->hw_driver->pixel_format, &pixel) &&
+            rtgui_graphic_driver_draw_hline_pixel(dc->hw_driver, pixel, x1, x2, y))
+        return;
     dc->hw_driver->ops->draw_hline(&(dc->owner->gc.foreground), x1, x2, y);
 }
 
+static void rtgui_dc_hw_fill_spans(struct rtgui_dc *self, const struct rtgui_span *spans, int count)
+{
+    int index;
+    rt_bool_t native;
+    rt_uint32_t pixel;
+    struct rtgui_dc_hw *dc;
+    rtgui_rect_t *extent;
+
+    RT_ASSERT(self != RT_NULL);
+    dc = (struct rtgui_dc_hw *) self;
+    extent = &(dc->owner->extent);
+    rtgui_graphic_driver_accel_sync();
+    native = rtgui_gc_fore_pixel(&(dc->owner->gc), dc->hw_driver->pixel_format, &pixel);
+
+    for (index = 0; index < count; index ++)
+    {
+        int x1, x2, y;
+
+        if (spans[index].y < 0)
+            continue;
+        y = spans[index].y + extent->y1;
+        if (y >= extent->y2)
+            break;
+
+        /* convert logic to device */
+        x1 = spans[index].x1 + extent->x1;
+        x2 = spans[index].x2 + extent->x1;
+        if (x1 > x2)
+            _int_swap(x1, x2);
+        if (x1 > extent->x2 || x2 < extent->x1)
+            continue;
+
+        if (x1 < extent->x1)
+            x1 = extent->x1;
+        if (x2 > extent->x2)
+            x2 = extent->x2;
+
+        if (native && rtgui_graphic_driver_draw_hline_pixel(dc->hw_driver, pixel, x1, x2, y))
+            continue;
+        dc->hw_driver->ops->draw_hline(&(dc->owner->gc.foreground), x1, x2, y);
+    }
+}
+
 static void rtgui_dc_hw_fill_rect(struct rtgui_dc *self, struct rtgui_rect *rect)
 {
     rtgui_color_t color;
+    rtgui_rect_t r;
     register rt_base_t y1, y2, x1, x2;
     struct rtgui_dc_hw *dc;
 
@@ -234,10 +295,9 @@ static void rtgui_dc_hw_fill_rect(struct rtgui_dc *self, struct rtgui_rect *rect
         y2 = dc->owner->extent.y2;
 
     /* fill rect */
-    for (; y1 < y2; y1++)
-    {
-        dc->hw_driver->ops->draw_hline(&color, x1, x2, y1);
-    }
+    r.x1 = x1; r.y1 = y1;
+    r.x2 = x2; r.y2 = y2;
+    rtgui_graphic_driver_fill_rect(dc->hw_driver, color, &r);
 }
 
 static void rtgui_dc_hw_blit_line(struct rtgui_dc *self, int x1, int x2, int y, rt_uint8_t *line_data)
@@ -246,6 +306,7 @@ static void rtgui_dc_hw_blit_line(struct rtgui_dc *self, int x1, int x2, int y,
 
     RT_ASSERT(self != RT_NULL);
     dc = (struct rtgui_dc_hw *) self;
+    rtgui_graphic_driver_accel_sync();
 
     /* convert logic to device */
     if (y < 0)
@@ -278,3 +339,338 @@ static void rtgui_dc_hw_blit(struct rtgui_dc *dc,
     return ;
 }
 
+
+/*
+ * The engines of framebuffer in the formats of driver, which write the native
+ * pixel cached in gc to the framebuffer directly instead of the operations of
+ * driver for each primitive. The fill and blit are the same as dc_hw_engine.
+ */
+#define _DC_HW_PIXEL(dc, x, y, type) \
+    ((type *)((dc)->hw_driver->framebuffer + (y) * (dc)->hw_driver->pitch) + (x))
+
+#ifdef GUIENGINE_USING_OVERDRAW
+#define _DC_HW_OVERDRAW(left, top, right, bottom)       \
+    do {                                                \
+        rtgui_rect_t _r;                                \
+        _r.x1 = (left);  _r.y1 = (top);                 \
+        _r.x2 = (right); _r.y2 = (bottom);              \
+        RTGUI_OVERDRAW_RECT(&_r);                       \
+    } while (0)
+#else
+#define _DC_HW_OVERDRAW(left, top, right, bottom)
+#endif
+
+static rt_bool_t _dc_hw_clip_point(struct rtgui_dc_hw *dc, int *x, int *y)
+{
+    if (*x < 0 || *y < 0)
+        return RT_FALSE;
+
+    *x += dc->owner->extent.x1;
+    *y += dc->owner->extent.y1;
+
+    return (*x < dc->owner->extent.x2 && *y < dc->owner->extent.y2) ? RT_TRUE : RT_FALSE;
+}
+
+static rt_bool_t _dc_hw_clip_hline(struct rtgui_dc_hw *dc, int *x1, int *x2, int *y)
+{
+    if (*y < 0)
+        return RT_FALSE;
+    *y += dc->owner->extent.y1;
+    if (*y >= dc->owner->extent.y2)
+        return RT_FALSE;
+
+    *x1 += dc->owner->extent.x1;
+    *x2 += dc->owner->extent.x1;
+    if (*x1 > *x2)
+        _int_swap(*x1, *x2);
+    if (*x1 < dc->owner->extent.x1)
+        *x1 = dc->owner->extent.x1;
+    if (*x2 > dc->owner->extent.x2)
+        *x2 = dc->owner->extent.x2;
+
+    return (*x1 < *x2) ? RT_TRUE : RT_FALSE;
+}
+
+static rt_bool_t _dc_hw_clip_vline(struct rtgui_dc_hw *dc, int *x, int *y1, int *y2)
+{
+    if (*x < 0)
+        return RT_FALSE;
+    *x += dc->owner->extent.x1;
+    if (*x >= dc->owner->extent.x2)
+        return RT_FALSE;
+
+    *y1 += dc->owner->extent.y1;
+    *y2 += dc->owner->extent.y1;
+    if (*y1 > *y2)
+        _int_swap(*y1, *y2);
+    if (*y1 < dc->owner->extent.y1)
+        *y1 = dc->owner->extent.y1;
+    if (*y2 > dc->owner->extent.y2)
+        *y2 = dc->owner->extent.y2;
+
+    return (*y1 < *y2) ? RT_TRUE : RT_FALSE;
+}
+
+#define _DC_HW_ENGINE(FMT, type, to_pixel)                                      \
+static void _dc_hw_draw_point_##FMT(struct rtgui_dc *self, int x, int y)        \
+{                                                                               \
+    rt_uint32_t pixel;                                                          \
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;                        \
+                                                                                \
+    rtgui_graphic_driver_accel_sync();                                          \
+    if (!_dc_hw_clip_point(dc, &x, &y)) return;                                 \
+                                                                                \
+    rtgui_gc_fore_pixel(&(dc->owner->gc), RTGRAPHIC_PIXEL_FORMAT_##FMT, &pixel); \
+    _DC_HW_OVERDRAW(x, y, x + 1, y + 1);                                        \
+    *_DC_HW_PIXEL(dc, x, y, type) = (type)pixel;                                \
+}                                                                               \
+                                                                                \
+static void _dc_hw_draw_color_point_##FMT(struct rtgui_dc *self, int x, int y,  \
+                                          rtgui_color_t color)                  \
+{                                                                               \
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;                        \
+                                                                                \
+    rtgui_graphic_driver_accel_sync();                                          \
+    if (!_dc_hw_clip_point(dc, &x, &y)) return;                                 \
+                                                                                \
+    _DC_HW_OVERDRAW(x, y, x + 1, y + 1);                                        \
+    *_DC_HW_PIXEL(dc, x, y, type) = (type)to_pixel(color);                      \
+}                                                                               \
+                                                                                \
+static void _dc_hw_draw_hline_##FMT(struct rtgui_dc *self, int x1, int x2, int y) \
+{                                                                               \
+    type *ptr, value;                                                           \
+    rt_uint32_t pixel;                                                          \
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;                        \
+                                                                                \
+    rtgui_graphic_driver_accel_sync();                                          \
+    if (!_dc_hw_clip_hline(dc, &x1, &x2, &y)) return;                           \
+                                                                                \
+    rtgui_gc_fore_pixel(&(dc->owner->gc), RTGRAPHIC_PIXEL_FORMAT_##FMT, &pixel); \
+    _DC_HW_OVERDRAW(x1, y, x2, y + 1);                                          \
+    value = (type)pixel;                                                        \
+    for (ptr = _DC_HW_PIXEL(dc, x1, y, type); x1 < x2; x1 ++)                   \
+        *ptr++ = value;                                                         \
+}                                                                               \
+                                                                                \
+static void _dc_hw_draw_vline_##FMT(struct rtgui_dc *self, int x, int y1, int y2) \
+{                                                                               \
+    rt_uint8_t *ptr;                                                            \
+    rt_uint32_t pixel;                                                          \
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;                        \
+                                                                                \
+    rtgui_graphic_driver_accel_sync();                                          \
+    if (!_dc_hw_clip_vline(dc, &x, &y1, &y2)) return;                           \
+                                                                                \
+    rtgui_gc_fore_pixel(&(dc->owner->gc), RTGRAPHIC_PIXEL_FORMAT_##FMT, &pixel); \
+    _DC_HW_OVERDRAW(x, y1, x + 1, y2);                                          \
+    ptr = (rt_uint8_t *)_DC_HW_PIXEL(dc, x, y1, type);                          \
+    for (; y1 < y2; y1 ++, ptr += dc->hw_driver->pitch)                         \
+        *(type *)ptr = (type)pixel;                                             \
+}                                                                               \
+                                                                                \
+static void _dc_hw_fill_spans_##FMT(struct rtgui_dc *self,                      \
+                                    const struct rtgui_span *spans, int count)  \
+{                                                                               \
+    int index, x1, x2, y;                                                       \
+    type *ptr, value;                                                           \
+    rt_uint32_t pixel;                                                          \
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;                        \
+                                                                                \
+    rtgui_graphic_driver_accel_sync();                                          \
+    rtgui_gc_fore_pixel(&(dc->owner->gc), RTGRAPHIC_PIXEL_FORMAT_##FMT, &pixel); \
+    value = (type)pixel;                                                        \
+                                                                                \
+    for (index = 0; index < count; index ++)                                    \
+    {                                                                           \
+        x1 = spans[index].x1;                                                   \
+        x2 = spans[index].x2;                                                   \
+        y = spans[index].y;                                                     \
+        /* the spans are sorted by y */                                         \
+        if (y + dc->owner->extent.y1 >= dc->owner->extent.y2) break;            \
+        if (!_dc_hw_clip_hline(dc, &x1, &x2, &y)) continue;                     \
+                                                                                \
+        _DC_HW_OVERDRAW(x1, y, x2, y + 1);                                      \
+        for (ptr = _DC_HW_PIXEL(dc, x1, y, type); x1 < x2; x1 ++)               \
+            *ptr++ = value;                                                     \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static const struct rtgui_dc_engine dc_hw_engine_##FMT =                        \
+{                                                                               \
+    _dc_hw_draw_point_##FMT,                                                    \
+    _dc_hw_draw_color_point_##FMT,                                              \
+    _dc_hw_draw_vline_##FMT,                                                    \
+    _dc_hw_draw_hline_##FMT,                                                    \
+    rtgui_dc_hw_fill_rect,                                                      \
+    rtgui_dc_hw_blit_line,                                                      \
+    rtgui_dc_hw_blit,                                                           \
+    _dc_hw_fill_spans_##FMT,                                                    \
+                                                                                \
+    rtgui_dc_hw_fini,                                                           \
+};
+
+#define _DC_HW_COLOR_TO_ARGB888(c)      (c)
+
+_DC_HW_ENGINE(RGB565, rt_uint16_t, rtgui_color_to_565)
+_DC_HW_ENGINE(ARGB888, rt_uint32_t, _DC_HW_COLOR_TO_ARGB888)
+
+#ifdef GUIENGINE_USING_MONO_PACKED
+/* the packed mono framebuffer, the MSB is the left pixel and the bit set is black */
+#define _DC_HW_MONO_BYTE(dc, x, y) \
+    ((dc)->hw_driver->framebuffer + (y) * (dc)->hw_driver->pitch + ((x) >> 3))
+#define _DC_HW_MONO_MASK(x)     (0x80 >> ((x) & 0x07))
+
+static void _dc_hw_mono_set(struct rtgui_dc_hw *dc, int x, int y, rtgui_color_t c)
+{
+    if (c == white)
+        *_DC_HW_MONO_BYTE(dc, x, y) &= ~_DC_HW_MONO_MASK(x);
+    else
+        *_DC_HW_MONO_BYTE(dc, x, y) |= _DC_HW_MONO_MASK(x);
+}
+
+static void _dc_hw_mono_hline(struct rtgui_dc_hw *dc, int x1, int x2, int y, rtgui_color_t c)
+{
+    int bytes;
+    rt_uint8_t *ptr, head, tail, fill;
+
+    fill = (c == white) ? 0x00 : 0xff;
+    ptr = _DC_HW_MONO_BYTE(dc, x1, y);
+    head = 0xff >> (x1 & 0x07);
+    tail = 0xff << (7 - ((x2 - 1) & 0x07));
+    bytes = ((x2 - 1) >> 3) - (x1 >> 3);
+
+    if (bytes == 0)
+    {
+        head &= tail;
+        *ptr = (*ptr & ~head) | (fill & head);
+        return;
+    }
+
+    *ptr = (*ptr & ~head) | (fill & head);
+    ptr ++;
+    if (bytes > 1)
+    {
+        rt_memset(ptr, fill, bytes - 1);
+        ptr += bytes - 1;
+    }
+    *ptr = (*ptr & ~tail) | (fill & tail);
+}
+
+static void _dc_hw_draw_point_MONO(struct rtgui_dc *self, int x, int y)
+{
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;
+
+    rtgui_graphic_driver_accel_sync();
+    if (!_dc_hw_clip_point(dc, &x, &y)) return;
+
+    _DC_HW_OVERDRAW(x, y, x + 1, y + 1);
+    _dc_hw_mono_set(dc, x, y, dc->owner->gc.foreground);
+}
+
+static void _dc_hw_draw_color_point_MONO(struct rtgui_dc *self, int x, int y, rtgui_color_t color)
+{
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;
+
+    rtgui_graphic_driver_accel_sync();
+    if (!_dc_hw_clip_point(dc, &x, &y)) return;
+
+    _DC_HW_OVERDRAW(x, y, x + 1, y + 1);
+    _dc_hw_mono_set(dc, x, y, color);
+}
+
+static void _dc_hw_draw_hline_MONO(struct rtgui_dc *self, int x1, int x2, int y)
+{
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;
+
+    rtgui_graphic_driver_accel_sync();
+    if (!_dc_hw_clip_hline(dc, &x1, &x2, &y)) return;
+
+    _DC_HW_OVERDRAW(x1, y, x2, y + 1);
+    _dc_hw_mono_hline(dc, x1, x2, y, dc->owner->gc.foreground);
+}
+
+static void _dc_hw_draw_vline_MONO(struct rtgui_dc *self, int x, int y1, int y2)
+{
+    rt_uint8_t *ptr, mask;
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;
+
+    rtgui_graphic_driver_accel_sync();
+    if (!_dc_hw_clip_vline(dc, &x, &y1, &y2)) return;
+
+    _DC_HW_OVERDRAW(x, y1, x + 1, y2);
+    ptr = _DC_HW_MONO_BYTE(dc, x, y1);
+    mask = _DC_HW_MONO_MASK(x);
+    if (dc->owner->gc.foreground == white)
+    {
+        for (; y1 < y2; y1 ++, ptr += dc->hw_driver->pitch)
+            *ptr &= ~mask;
+    }
+    else
+    {
+        for (; y1 < y2; y1 ++, ptr += dc->hw_driver->pitch)
+            *ptr |= mask;
+    }
+}
+
+static void _dc_hw_fill_spans_MONO(struct rtgui_dc *self, const struct rtgui_span *spans, int count)
+{
+    int index, x1, x2, y;
+    struct rtgui_dc_hw *dc = (struct rtgui_dc_hw *)self;
+
+    rtgui_graphic_driver_accel_sync();
+    for (index = 0; index < count; index ++)
+    {
+        x1 = spans[index].x1;
+        x2 = spans[index].x2;
+        y = spans[index].y;
+        /* the spans are sorted by y */
+        if (y + dc->owner->extent.y1 >= dc->owner->extent.y2) break;
+        if (!_dc_hw_clip_hline(dc, &x1, &x2, &y)) continue;
+
+        _DC_HW_OVERDRAW(x1, y, x2, y + 1);
+        _dc_hw_mono_hline(dc, x1, x2, y, dc->owner->gc.foreground);
+    }
+}
+
+static const struct rtgui_dc_engine dc_hw_engine_MONO =
+{
+    _dc_hw_draw_point_MONO,
+    _dc_hw_draw_color_point_MONO,
+    _dc_hw_draw_vline_MONO,
+    _dc_hw_draw_hline_MONO,
+    rtgui_dc_hw_fill_rect,
+    rtgui_dc_hw_blit_line,
+    rtgui_dc_hw_blit,
+    _dc_hw_fill_spans_MONO,
+
+    rtgui_dc_hw_fini,
+};
+#endif
+
+/* the engine in the format of framebuffer, or the one through driver operations */
+static const struct rtgui_dc_engine *_dc_hw_get_engine(const struct rtgui_graphic_driver *driver)
+{
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL)
+        return &dc_hw_engine;
+
+    switch (driver->pixel_format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        if (driver->bits_per_pixel == 16 && RTGUI_PIXEL_FORMAT_DRAWN(RTGRAPHIC_PIXEL_FORMAT_RGB565))
+            return &dc_hw_engine_RGB565;
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        if (driver->bits_per_pixel == 32)
+            return &dc_hw_engine_ARGB888;
+        break;
+#ifdef GUIENGINE_USING_MONO_PACKED
+    case RTGRAPHIC_PIXEL_FORMAT_MONO:
+        if (RTGUI_PIXEL_FORMAT_DRAWN(RTGRAPHIC_PIXEL_FORMAT_MONO))
+            return &dc_hw_engine_MONO;
+        break;
+#endif
+    }
+
+    return &dc_hw_engine;
+}
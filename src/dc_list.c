@@ -0,0 +1,435 @@
+/*
+ * File      : dc_list.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtgui/rtgui.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/dc.h>
+#include <rtgui/dc_list.h>
+#include <rtgui/widgets/widget.h>
+
+#include <string.h>
+
+enum
+{
+    DC_LIST_RECT,
+    DC_LIST_SPANS,
+    DC_LIST_TEXT,
+    DC_LIST_BLIT,
+    DC_LIST_IMAGE,
+};
+
+/* the header of each command, the parameters follow it */
+struct _dc_list_cmd
+{
+    rt_uint16_t type;
+    /* the size of command, including the header */
+    rt_uint16_t size;
+    /* the box of the drawing, used to skip the clip rects */
+    rtgui_rect_t bound;
+    rtgui_color_t color;
+};
+
+struct _dc_list_spans
+{
+    struct _dc_list_cmd cmd;
+    int count;
+    /* struct rtgui_span spans[count]; */
+};
+
+struct _dc_list_text
+{
+    struct _dc_list_cmd cmd;
+    struct rtgui_font *font;
+    rt_uint32_t len;
+    /* char text[len]; */
+};
+
+struct _dc_list_blit
+{
+    struct _dc_list_cmd cmd;
+    struct rtgui_dc *src;
+    struct rtgui_point point;
+};
+
+struct _dc_list_image
+{
+    struct _dc_list_cmd cmd;
+    struct rtgui_image *image;
+};
+
+struct rtgui_dc_list
+{
+    rt_uint8_t *buffer;
+    rt_uint32_t size;
+    rt_uint32_t used;
+    int count;
+};
+
+#define _DC_LIST_ALIGN(size)    (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+/* the size of one command is saved in 16bit */
+#define _DC_LIST_CMD_MAX        0xFFF0
+
+struct rtgui_dc_list *rtgui_dc_list_create(rt_uint32_t size)
+{
+    struct rtgui_dc_list *list;
+
+    list = (struct rtgui_dc_list *)rtgui_malloc(sizeof(struct rtgui_dc_list));
+    if (list == RT_NULL)
+        return RT_NULL;
+
+    size = _DC_LIST_ALIGN(size);
+    if (size < sizeof(struct _dc_list_image))
+        size = _DC_LIST_ALIGN(sizeof(struct _dc_list_image));
+
+    list->buffer = (rt_uint8_t *)rtgui_malloc(size);
+    if (list->buffer == RT_NULL)
+    {
+        rtgui_free(list);
+        return RT_NULL;
+    }
+    list->size  = size;
+    list->used  = 0;
+    list->count = 0;
+
+    return list;
+}
+RTM_EXPORT(rtgui_dc_list_create);
+
+void rtgui_dc_list_destroy(struct rtgui_dc_list *list)
+{
+    if (list == RT_NULL)
+        return;
+
+    rtgui_free(list->buffer);
+    rtgui_free(list);
+}
+RTM_EXPORT(rtgui_dc_list_destroy);
+
+void rtgui_dc_list_reset(struct rtgui_dc_list *list)
+{
+    RT_ASSERT(list != RT_NULL);
+
+    list->used  = 0;
+    list->count = 0;
+}
+RTM_EXPORT(rtgui_dc_list_reset);
+
+int rtgui_dc_list_count(struct rtgui_dc_list *list)
+{
+    RT_ASSERT(list != RT_NULL);
+
+    return list->count;
+}
+RTM_EXPORT(rtgui_dc_list_count);
+
+/* allocate a command in the buffer, the buffer is doubled when it's full */
+static struct _dc_list_cmd *_dc_list_alloc(struct rtgui_dc_list *list, int type,
+                                           rt_uint32_t size, const rtgui_rect_t *bound)
+{
+    struct _dc_list_cmd *cmd;
+
+    size = _DC_LIST_ALIGN(size);
+    if (size > _DC_LIST_CMD_MAX)
+        return RT_NULL;
+
+    if (list->used + size > list->size)
+    {
+        rt_uint8_t *buffer;
+        rt_uint32_t new_size = list->size * 2;
+
+        while (new_size < list->used + size)
+            new_size *= 2;
+
+        buffer = (rt_uint8_t *)rtgui_realloc(list->buffer, new_size);
+        if (buffer == RT_NULL)
+            return RT_NULL;
+        list->buffer = buffer;
+        list->size = new_size;
+    }
+
+    cmd = (struct _dc_list_cmd *)(list->buffer + list->used);
+    cmd->type  = type;
+    cmd->size  = size;
+    cmd->bound = *bound;
+    list->used += size;
+    list->count ++;
+
+    return cmd;
+}
+
+rt_err_t rtgui_dc_list_fill_rect(struct rtgui_dc_list *list, const rtgui_rect_t *rect,
+                                 rtgui_color_t color)
+{
+    struct _dc_list_cmd *cmd;
+
+    RT_ASSERT(list != RT_NULL);
+    RT_ASSERT(rect != RT_NULL);
+
+    if (rtgui_rect_is_empty(rect))
+        return RT_EOK;
+
+    cmd = _dc_list_alloc(list, DC_LIST_RECT, sizeof(struct _dc_list_cmd), rect);
+    if (cmd == RT_NULL)
+        return -RT_ENOMEM;
+    cmd->color = color;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_list_fill_rect);
+
+rt_err_t rtgui_dc_list_fill_spans(struct rtgui_dc_list *list, const struct rtgui_span *spans,
+                                  int count, rtgui_color_t color)
+{
+    int index;
+    rtgui_rect_t bound;
+    struct _dc_list_spans *cmd;
+
+    RT_ASSERT(list != RT_NULL);
+
+    if (spans == RT_NULL || count <= 0)
+        return RT_EOK;
+
+    /* the box, including the end point of spans */
+    bound.x1 = bound.x2 = spans[0].x1;
+    bound.y1 = spans[0].y;
+    bound.y2 = spans[count - 1].y + 1;
+    for (index = 0; index < count; index ++)
+    {
+        if (spans[index].x1 < bound.x1) bound.x1 = spans[index].x1;
+        if (spans[index].x2 < bound.x1) bound.x1 = spans[index].x2;
+        if (spans[index].x1 + 1 > bound.x2) bound.x2 = spans[index].x1 + 1;
+        if (spans[index].x2 + 1 > bound.x2) bound.x2 = spans[index].x2 + 1;
+    }
+
+    cmd = (struct _dc_list_spans *)_dc_list_alloc(list, DC_LIST_SPANS,
+            sizeof(struct _dc_list_spans) + sizeof(struct rtgui_span) * count, &bound);
+    if (cmd == RT_NULL)
+        return -RT_ENOMEM;
+    cmd->cmd.color = color;
+    cmd->count = count;
+    memcpy(cmd + 1, spans, sizeof(struct rtgui_span) * count);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_list_fill_spans);
+
+rt_err_t rtgui_dc_list_draw_text(struct rtgui_dc_list *list, struct rtgui_font *font,
+                                 const char *text, const rtgui_rect_t *rect, rtgui_color_t color)
+{
+    rt_uint32_t len;
+    struct _dc_list_text *cmd;
+
+    RT_ASSERT(list != RT_NULL);
+    RT_ASSERT(rect != RT_NULL);
+
+    if (text == RT_NULL || rtgui_rect_is_empty(rect))
+        return RT_EOK;
+
+    len = strlen(text);
+    if (len == 0)
+        return RT_EOK;
+
+    cmd = (struct _dc_list_text *)_dc_list_alloc(list, DC_LIST_TEXT,
+            sizeof(struct _dc_list_text) + len, rect);
+    if (cmd == RT_NULL)
+        return -RT_ENOMEM;
+    cmd->cmd.color = color;
+    cmd->font = font ? font : rtgui_font_default();
+    cmd->len  = len;
+    memcpy(cmd + 1, text, len);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_list_draw_text);
+
+rt_err_t rtgui_dc_list_blit(struct rtgui_dc_list *list, struct rtgui_dc *src,
+                            const struct rtgui_point *src_point, const rtgui_rect_t *rect)
+{
+    struct _dc_list_blit *cmd;
+
+    RT_ASSERT(list != RT_NULL);
+    RT_ASSERT(src != RT_NULL);
+    RT_ASSERT(rect != RT_NULL);
+
+    if (rtgui_rect_is_empty(rect))
+        return RT_EOK;
+
+    cmd = (struct _dc_list_blit *)_dc_list_alloc(list, DC_LIST_BLIT,
+            sizeof(struct _dc_list_blit), rect);
+    if (cmd == RT_NULL)
+        return -RT_ENOMEM;
+    cmd->src = src;
+    if (src_point)
+    {
+        cmd->point = *src_point;
+    }
+    else
+    {
+        cmd->point.x = 0;
+        cmd->point.y = 0;
+    }
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_list_blit);
+
+rt_err_t rtgui_dc_list_draw_image(struct rtgui_dc_list *list, struct rtgui_image *image,
+                                  const rtgui_rect_t *rect)
+{
+    struct _dc_list_image *cmd;
+
+    RT_ASSERT(list != RT_NULL);
+    RT_ASSERT(rect != RT_NULL);
+
+    if (image == RT_NULL || rtgui_rect_is_empty(rect))
+        return RT_EOK;
+
+    cmd = (struct _dc_list_image *)_dc_list_alloc(list, DC_LIST_IMAGE,
+            sizeof(struct _dc_list_image), rect);
+    if (cmd == RT_NULL)
+        return -RT_ENOMEM;
+    cmd->image = image;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_list_draw_image);
+
+/* execute the commands which intersect with the clip (in logic), or all if clip is RT_NULL */
+static void _dc_list_execute(struct rtgui_dc_list *list, struct rtgui_dc *dc,
+                             const rtgui_rect_t *clip)
+{
+    rt_uint8_t *ptr, *end;
+    rtgui_gc_t *gc;
+
+    gc = rtgui_dc_get_gc(dc);
+    end = list->buffer + list->used;
+    for (ptr = list->buffer; ptr < end; ptr += ((struct _dc_list_cmd *)ptr)->size)
+    {
+        struct _dc_list_cmd *cmd = (struct _dc_list_cmd *)ptr;
+        rtgui_rect_t rect = cmd->bound;
+
+        if (clip && (rect.x1 >= clip->x2 || rect.x2 <= clip->x1 ||
+                     rect.y1 >= clip->y2 || rect.y2 <= clip->y1))
+            continue;
+
+        switch (cmd->type)
+        {
+        case DC_LIST_RECT:
+            gc->background = cmd->color;
+            rtgui_dc_fill_rect(dc, &rect);
+            break;
+
+        case DC_LIST_SPANS:
+        {
+            struct _dc_list_spans *spans = (struct _dc_list_spans *)cmd;
+
+            gc->foreground = cmd->color;
+            rtgui_dc_fill_spans(dc, (struct rtgui_span *)(spans + 1), spans->count);
+            break;
+        }
+
+        case DC_LIST_TEXT:
+        {
+            struct _dc_list_text *text = (struct _dc_list_text *)cmd;
+
+            gc->foreground = cmd->color;
+            rtgui_font_draw(text->font, dc, (const char *)(text + 1), text->len, &rect);
+            break;
+        }
+
+        case DC_LIST_BLIT:
+        {
+            struct _dc_list_blit *blit = (struct _dc_list_blit *)cmd;
+            struct rtgui_point point = blit->point;
+
+            rtgui_dc_blit(blit->src, &point, dc, &rect);
+            break;
+        }
+
+        case DC_LIST_IMAGE:
+            rtgui_image_blit(((struct _dc_list_image *)cmd)->image, dc, &rect);
+            break;
+
+        default:
+            RT_ASSERT(0);
+        }
+    }
+}
+
+void rtgui_dc_list_execute(struct rtgui_dc_list *list, struct rtgui_dc *dc)
+{
+    rtgui_gc_t gc;
+
+    RT_ASSERT(list != RT_NULL);
+    RT_ASSERT(dc != RT_NULL);
+
+    if (list->count == 0) return;
+    if (!rtgui_dc_get_visible(dc)) return;
+
+    gc = *rtgui_dc_get_gc(dc);
+
+    if (dc->type == RTGUI_DC_CLIENT)
+    {
+        int index, num;
+        rtgui_rect_t *rects, extents;
+        rtgui_region_data_t *data;
+        rt_int32_t flag;
+        rtgui_widget_t *owner;
+
+        owner = RTGUI_CONTAINER_OF(dc, struct rtgui_widget, dc_type);
+
+        /*
+         * Replace the clip of owner with each clip rect in turn, and it's a
+         * single rect clip (scissor) for the drawing operations.
+         */
+        num = rtgui_region_num_rects(&(owner->clip));
+        rects = rtgui_region_rects(&(owner->clip));
+        extents = owner->clip.extents;
+        data = owner->clip.data;
+        flag = owner->flag;
+
+        owner->clip.data = RT_NULL;
+        owner->flag |= RTGUI_WIDGET_FLAG_DC_SCISSOR;
+        for (index = 0; index < num; index ++)
+        {
+            rtgui_rect_t clip = rects[index];
+
+            owner->clip.extents = clip;
+            rtgui_rect_move(&clip, -owner->extent.x1, -owner->extent.y1);
+            _dc_list_execute(list, dc, &clip);
+        }
+        owner->clip.extents = extents;
+        owner->clip.data = data;
+        owner->flag = flag;
+    }
+    else
+    {
+        _dc_list_execute(list, dc, RT_NULL);
+    }
+
+    rtgui_dc_set_gc(dc, &gc);
+}
+RTM_EXPORT(rtgui_dc_list_execute);
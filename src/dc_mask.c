@@ -0,0 +1,239 @@
+/*
+ * File      : dc_mask.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
+
+/*
+ * The mask is an A8 buffer dc of coverage. The shapes, glyphs and shadows are
+ * drawn in it once (the AA ones of dc_blend accumulate the coverage), and the
+ * mask is filled through with a color by the A8 kernel of rtgui_blit.
+ */
+struct rtgui_dc *rtgui_dc_mask_create(int w, int h)
+{
+    struct rtgui_dc *dc;
+
+    dc = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ALPHA, w, h);
+    if (dc != RT_NULL)
+    {
+        /* draw the full coverage, and clear it by fill */
+        RTGUI_DC_FC(dc) = WHITE;
+        RTGUI_DC_BC(dc) = TRANSPARENT;
+    }
+
+    return dc;
+}
+RTM_EXPORT(rtgui_dc_mask_create);
+
+/* fill the mask from point on the rect of dest with color, the alpha of color is the opacity */
+void rtgui_dc_mask_fill(struct rtgui_dc *mask, struct rtgui_point *point,
+                        struct rtgui_dc *dest, rtgui_rect_t *rect, rtgui_color_t color)
+{
+    rtgui_color_t fc;
+    rt_uint8_t alpha;
+    rtgui_rect_t r;
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)mask;
+
+    RT_ASSERT(mask != RT_NULL && dest != RT_NULL && rect != RT_NULL);
+    RT_ASSERT(buffer->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA);
+
+    if (RTGUI_RGB_A(color) == 0)
+        return;
+
+    fc = RTGUI_DC_FC(mask);
+    alpha = buffer->pixel_alpha;
+
+    /* the blit fills the mask with the foreground in the pixel alpha */
+    RTGUI_DC_FC(mask) = color;
+    buffer->pixel_alpha = RTGUI_RGB_A(color);
+    r = *rect;
+    rtgui_dc_blit(mask, point, dest, &r);
+
+    RTGUI_DC_FC(mask) = fc;
+    buffer->pixel_alpha = alpha;
+}
+RTM_EXPORT(rtgui_dc_mask_fill);
+
+/* fill the mask with a vertical gradient from c1 to c2 */
+void rtgui_dc_mask_fill_gradientv(struct rtgui_dc *mask, struct rtgui_point *point,
+                                  struct rtgui_dc *dest, rtgui_rect_t *rect,
+                                  rtgui_color_t c1, rtgui_color_t c2)
+{
+    int y, step;
+    rtgui_rect_t r;
+    rtgui_point_t pt;
+    rtgui_color_t color;
+
+    RT_ASSERT(mask != RT_NULL && dest != RT_NULL && rect != RT_NULL);
+
+    step = rtgui_rect_height(*rect);
+    if (point == RT_NULL)
+        pt = rtgui_empty_point;
+    else
+        pt = *point;
+
+    /* a row of the mask each color */
+    for (y = 0; y < step; y ++)
+    {
+        color = RTGUI_ARGB(((int)RTGUI_RGB_A(c2) - RTGUI_RGB_A(c1)) * y / step + RTGUI_RGB_A(c1),
+                           ((int)RTGUI_RGB_R(c2) - RTGUI_RGB_R(c1)) * y / step + RTGUI_RGB_R(c1),
+                           ((int)RTGUI_RGB_G(c2) - RTGUI_RGB_G(c1)) * y / step + RTGUI_RGB_G(c1),
+                           ((int)RTGUI_RGB_B(c2) - RTGUI_RGB_B(c1)) * y / step + RTGUI_RGB_B(c1));
+
+        r = *rect;
+        r.y1 = rect->y1 + y;
+        r.y2 = r.y1 + 1;
+        rtgui_dc_mask_fill(mask, &pt, dest, &r, color);
+        pt.y ++;
+    }
+}
+RTM_EXPORT(rtgui_dc_mask_fill_gradientv);
+
+/*
+ * Pack the coverage of mask into A4, (width + 1) / 2 bytes each row at least.
+ * The A4 pixels are half the size of mask to be cached, and they are blitted
+ * by rtgui_blit in RTGRAPHIC_PIXEL_FORMAT_A4.
+ */
+void rtgui_dc_mask_pack_a4(struct rtgui_dc *mask, rt_uint8_t *pixels, int pitch)
+{
+    int x, y;
+    rt_uint8_t *src, *dst;
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)mask;
+
+    RT_ASSERT(mask != RT_NULL && pixels != RT_NULL);
+    RT_ASSERT(buffer->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA);
+    if (rtgui_dc_buffer_read_pixel(mask) == RT_NULL)
+        return;
+
+    for (y = 0; y < buffer->height; y ++)
+    {
+        src = buffer->pixel + y * buffer->pitch;
+        dst = pixels + y * pitch;
+        for (x = 0; x + 1 < buffer->width; x += 2)
+            *dst++ = (src[x] & 0xf0) | (src[x + 1] >> 4);
+        if (x < buffer->width)
+            *dst = src[x] & 0xf0;
+    }
+}
+RTM_EXPORT(rtgui_dc_mask_pack_a4);
+
+/* the box of a row, src and dst are different lines */
+static void _mask_box_row(const rt_uint8_t *src, rt_uint8_t *dst, int w, int radius, rt_uint32_t mul)
+{
+    int x;
+    rt_uint32_t sum = 0;
+
+    /* the pixels out of mask are transparent */
+    for (x = 0; x < radius && x < w; x ++)
+        sum += src[x];
+    for (x = 0; x < w; x ++)
+    {
+        if (x + radius < w)
+            sum += src[x + radius];
+        if (x - radius - 1 >= 0)
+            sum -= src[x - radius - 1];
+        dst[x] = (rt_uint8_t)((sum * mul + 0x8000) >> 16);
+    }
+}
+
+/*
+ * Blur the coverage of mask by the box of radius in passes, 3 passes are
+ * about a gaussian of the radius 3 * radius. The box is separable: each row
+ * is a running sum, and the columns are the running sums of a whole row at
+ * once, which are vectorized by the compiler. The rows above in a column
+ * are kept in the ring of radius + 1 rows. The sum of box is in 16.16.
+ */
+rt_err_t rtgui_dc_mask_blur(struct rtgui_dc *mask, int radius, int passes)
+{
+    int x, y, w, h, pass, slot;
+    rt_uint32_t mul, *sums;
+    rt_uint8_t *pixel, *line, *ring, *row;
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)mask;
+
+    RT_ASSERT(mask != RT_NULL);
+    RT_ASSERT(buffer->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ALPHA);
+
+    if (radius <= 0 || passes <= 0)
+        return RT_EOK;
+    pixel = rtgui_dc_buffer_get_pixel(mask);
+    if (pixel == RT_NULL)
+        return -RT_ENOMEM;
+
+    w = buffer->width;
+    h = buffer->height;
+    sums = (rt_uint32_t *)rtgui_malloc(w * sizeof(rt_uint32_t) + (radius + 2) * w);
+    if (sums == RT_NULL)
+        return -RT_ENOMEM;
+    line = (rt_uint8_t *)(sums + w);
+    ring = line + w;
+    mul = 65536 / (2 * radius + 1);
+
+    for (pass = 0; pass < passes; pass ++)
+    {
+        for (y = 0; y < h; y ++)
+        {
+            row = pixel + y * buffer->pitch;
+            rt_memcpy(line, row, w);
+            _mask_box_row(line, row, w, radius, mul);
+        }
+
+        rt_memset(sums, 0, w * sizeof(rt_uint32_t));
+        for (y = 0; y < radius && y < h; y ++)
+        {
+            row = pixel + y * buffer->pitch;
+            for (x = 0; x < w; x ++)
+                sums[x] += row[x];
+        }
+        for (y = 0; y < h; y ++)
+        {
+            slot = y % (radius + 1);
+            if (y + radius < h)
+            {
+                row = pixel + (y + radius) * buffer->pitch;
+                for (x = 0; x < w; x ++)
+                    sums[x] += row[x];
+            }
+            if (y - radius - 1 >= 0)
+            {
+                /* the row y - radius - 1 is in the same slot */
+                row = ring + slot * w;
+                for (x = 0; x < w; x ++)
+                    sums[x] -= row[x];
+            }
+
+            row = pixel + y * buffer->pitch;
+            rt_memcpy(ring + slot * w, row, w);
+            for (x = 0; x < w; x ++)
+                row[x] = (rt_uint8_t)((sums[x] * mul + 0x8000) >> 16);
+        }
+    }
+
+    rtgui_free(sums);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_dc_mask_blur);
@@ -0,0 +1,188 @@
+/*
+ * File      : dc_parallel.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_PARALLEL_RENDER
+
+/*
+ * The rect is split into horizontal bands, each band is rendered into a band
+ * buffer dc by a worker (and the caller renders the first band). The workers
+ * do not touch the framebuffer: the bands are blitted to the dc by the caller
+ * one by one after they are rendered, so the screen lock held by the drawing
+ * is only used for the copy of each band.
+ */
+struct rtgui_band_job
+{
+    struct rtgui_dc *band;
+    rtgui_rect_t rect;
+    rtgui_band_render_t render;
+    void *parameter;
+
+    struct rt_semaphore done;
+};
+
+static struct rt_mailbox _render_mb;
+static rt_ubase_t _render_mb_pool[GUIENGINE_RENDER_WORKERS];
+static rt_bool_t _render_inited = RT_FALSE;
+/* one parallel rendering at a time, the workers are shared by all apps */
+static struct rt_mutex _render_lock;
+
+static void _rtgui_band_render(struct rtgui_band_job *job)
+{
+    if (job->band != RT_NULL)
+        job->render(job->band, &job->rect, job->parameter);
+}
+
+static void _rtgui_render_worker(void *parameter)
+{
+    struct rtgui_band_job *job;
+
+    while (1)
+    {
+        if (rt_mb_recv(&_render_mb, (rt_ubase_t *)&job, RT_WAITING_FOREVER) != RT_EOK)
+            continue;
+
+        _rtgui_band_render(job);
+        rt_sem_release(&job->done);
+    }
+}
+
+int rtgui_dc_render_init(void)
+{
+    int index;
+    rt_thread_t tid;
+    char name[RT_NAME_MAX];
+
+    rt_mutex_init(&_render_lock, "rtgui_pr", RT_IPC_FLAG_FIFO);
+    rt_mb_init(&_render_mb, "rtgui_pr", _render_mb_pool,
+               GUIENGINE_RENDER_WORKERS, RT_IPC_FLAG_FIFO);
+
+    for (index = 0; index < GUIENGINE_RENDER_WORKERS; index ++)
+    {
+        rt_snprintf(name, sizeof(name), "rtgui_r%d", index);
+        tid = rt_thread_create(name, _rtgui_render_worker, RT_NULL,
+                               GUIENGINE_RENDER_WORKER_STACK_SIZE,
+                               GUIENGIN_APP_THREAD_PRIORITY,
+                               GUIENGIN_APP_THREAD_TIMESLICE);
+        if (tid == RT_NULL)
+            return -RT_ENOMEM;
+
+#if defined(RT_USING_SMP) && RT_CPUS_NR > 1
+        /* spread the workers on the other cores */
+        rt_thread_control(tid, RT_THREAD_CTRL_BIND_CPU,
+                          (void *)(rt_ubase_t)((index + 1) % RT_CPUS_NR));
+#endif
+        rt_thread_startup(tid);
+    }
+
+    _render_inited = RT_TRUE;
+    return RT_EOK;
+}
+
+rt_err_t rtgui_dc_render_parallel(struct rtgui_dc *dc, rtgui_rect_t *rect,
+                                  rtgui_band_render_t render, void *parameter)
+{
+    int index, count, height, band_height;
+    rt_uint8_t pixel_format;
+    struct rtgui_band_job jobs[GUIENGINE_RENDER_WORKERS + 1];
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(dc != RT_NULL);
+    RT_ASSERT(rect != RT_NULL);
+    RT_ASSERT(render != RT_NULL);
+
+    height = rtgui_rect_height(*rect);
+    if (height <= 0 || rtgui_rect_width(*rect) <= 0)
+        return RT_EOK;
+
+    /* too small to be split, render it at once */
+    count = GUIENGINE_RENDER_WORKERS + 1;
+    if (height < count * GUIENGINE_RENDER_BAND_MIN || _render_inited == RT_FALSE)
+        count = 1;
+
+    band_height = (height + count - 1) / count;
+    pixel_format = rtgui_dc_get_pixel_format(dc);
+
+    if (count > 1)
+        rt_mutex_take(&_render_lock, RT_WAITING_FOREVER);
+
+    for (index = 0; index < count; index ++)
+    {
+        struct rtgui_band_job *job = &jobs[index];
+
+        job->rect.x1 = rect->x1;
+        job->rect.x2 = rect->x2;
+        job->rect.y1 = rect->y1 + index * band_height;
+        job->rect.y2 = job->rect.y1 + band_height;
+        if (job->rect.y2 > rect->y2) job->rect.y2 = rect->y2;
+
+        job->render = render;
+        job->parameter = parameter;
+        job->band = RT_NULL;
+        if (job->rect.y1 < job->rect.y2)
+        {
+            job->band = rtgui_dc_buffer_create_pixformat(pixel_format,
+                        rtgui_rect_width(job->rect), rtgui_rect_height(job->rect));
+        }
+        if (job->band == RT_NULL && job->rect.y1 < job->rect.y2)
+            result = -RT_ENOMEM;
+
+        /* the first band is rendered by the caller */
+        if (index > 0)
+        {
+            rt_sem_init(&job->done, "rtgui_pr", 0, RT_IPC_FLAG_FIFO);
+            /* the mailbox holds a job for each worker */
+            rt_mb_send(&_render_mb, (rt_ubase_t)job);
+        }
+    }
+
+    _rtgui_band_render(&jobs[0]);
+
+    for (index = 0; index < count; index ++)
+    {
+        struct rtgui_band_job *job = &jobs[index];
+
+        if (index > 0)
+        {
+            rt_sem_take(&job->done, RT_WAITING_FOREVER);
+            rt_sem_detach(&job->done);
+        }
+
+        if (job->band != RT_NULL)
+        {
+            rtgui_dc_blit(job->band, RT_NULL, dc, &job->rect);
+            rtgui_dc_destory(job->band);
+        }
+    }
+
+    if (count > 1)
+        rt_mutex_release(&_render_lock);
+
+    return result;
+}
+RTM_EXPORT(rtgui_dc_render_parallel);
+
+#endif
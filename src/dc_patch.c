@@ -0,0 +1,270 @@
+/*
+ * File      : dc_patch.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/image.h>
+#include <rtgui/rtgui_system.h>
+
+#include <string.h>
+
+struct _patch_blit
+{
+    struct rtgui_dc_buffer *src;
+    struct rtgui_dc *dest;
+    enum rtgui_patch_mode mode;
+
+    /* the line of a stretched row, in the format of source */
+    struct rtgui_dc *line;
+    int line_width;
+};
+
+/*
+ * The 3 ranges of each axis in source and destination, the corners are
+ * shrunk in proportion when the destination is smaller than them.
+ */
+static void _patch_axis(int *src, int *dst, int lo, int hi, int size, int d1, int d2)
+{
+    int a, b, len;
+
+    if (lo < 0) lo = 0;
+    if (hi > size) hi = size;
+    if (hi < lo) hi = lo;
+
+    a = lo;
+    b = size - hi;
+    len = d2 - d1;
+    if (a + b > len)
+    {
+        a = a * len / (a + b);
+        b = len - a;
+    }
+
+    src[0] = 0;
+    src[1] = lo;
+    src[2] = hi;
+    src[3] = size;
+    dst[0] = d1;
+    dst[1] = d1 + a;
+    dst[2] = d2 - b;
+    dst[3] = d2;
+}
+
+static void _patch_blit_once(struct _patch_blit *blit, struct rtgui_dc *src, int sx, int sy,
+                             int x1, int y1, int x2, int y2)
+{
+    struct rtgui_point point;
+    rtgui_rect_t rect;
+
+    point.x = sx;
+    point.y = sy;
+    rtgui_rect_init(&rect, x1, y1, x2 - x1, y2 - y1);
+    rtgui_dc_blit(src, &point, blit->dest, &rect);
+}
+
+/* the color of the cell if all its pixels are the same opaque color */
+static rt_bool_t _patch_uniform(struct rtgui_dc_buffer *src, const rtgui_rect_t *cell, rtgui_color_t *color)
+{
+    int x, y, bpp;
+    rt_uint8_t *first, *ptr;
+    rt_uint32_t pixel;
+
+    if (src->pixel_alpha != 255)
+        return RT_FALSE;
+
+    bpp = rtgui_color_get_bpp(src->pixel_format);
+    first = src->pixel + cell->y1 * src->pitch + cell->x1 * bpp;
+    for (y = cell->y1; y < cell->y2; y ++)
+    {
+        ptr = src->pixel + y * src->pitch + cell->x1 * bpp;
+        for (x = cell->x1; x < cell->x2; x ++, ptr += bpp)
+        {
+            if (memcmp(ptr, first, bpp) != 0)
+                return RT_FALSE;
+        }
+    }
+
+    switch (src->pixel_format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        *color = rtgui_color_from_565(*(rt_uint16_t *)first);
+        return RT_TRUE;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        pixel = first[0] | (first[1] << 8) | (first[2] << 16);
+        *color = rtgui_color_from_888(pixel);
+        return RT_TRUE;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        *color = *(rt_uint32_t *)first;
+        return RTGUI_RGB_A(*color) == 255;
+    default:
+        return RT_FALSE;
+    }
+}
+
+/* the line of source row stretched to the width, the pixels are replicated */
+static struct rtgui_dc *_patch_line(struct _patch_blit *blit, int sx, int sw, int sy, int width)
+{
+    int x, bpp;
+    rt_uint8_t *line, *row;
+    struct rtgui_dc_buffer *src = blit->src;
+
+    if (blit->line == RT_NULL)
+    {
+        blit->line = rtgui_dc_buffer_create_pixformat(src->pixel_format, blit->line_width, 1);
+        if (blit->line == RT_NULL)
+            return RT_NULL;
+        rtgui_dc_buffer_set_alpha(blit->line, src->pixel_alpha);
+        if (src->palette != RT_NULL)
+            rtgui_dc_buffer_set_palette(blit->line, src->palette->colors, src->palette->ncolors);
+    }
+
+    line = rtgui_dc_buffer_get_pixel(blit->line);
+    if (line == RT_NULL)
+        return RT_NULL;
+
+    bpp = rtgui_color_get_bpp(src->pixel_format);
+    row = src->pixel + sy * src->pitch + sx * bpp;
+    for (x = 0; x < width; x ++, line += bpp)
+        memcpy(line, row + (x * sw / width) * bpp, bpp);
+
+    return blit->line;
+}
+
+/* blit the source cell to the destination cell, scaled in the mode */
+static void _patch_cell(struct _patch_blit *blit, const rtgui_rect_t *cell,
+                        int x1, int y1, int x2, int y2, rt_bool_t center)
+{
+    int x, y, sw, sh, dw, dh, sy, last;
+    rtgui_color_t color, fc;
+    rtgui_rect_t rect;
+    struct rtgui_dc *line;
+
+    sw = rtgui_rect_width(*cell);
+    sh = rtgui_rect_height(*cell);
+    dw = x2 - x1;
+    dh = y2 - y1;
+    if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0)
+        return;
+
+    /* the corner of the same size, or shrunk by the clip */
+    if (sw >= dw && sh >= dh)
+    {
+        _patch_blit_once(blit, RTGUI_DC(blit->src), cell->x1, cell->y1, x1, y1, x2, y2);
+        return;
+    }
+
+    if (center && _patch_uniform(blit->src, cell, &color))
+    {
+        fc = RTGUI_DC_FC(blit->dest);
+        RTGUI_DC_FC(blit->dest) = color;
+        rtgui_rect_init(&rect, x1, y1, dw, dh);
+        rtgui_dc_fill_rect(blit->dest, &rect);
+        RTGUI_DC_FC(blit->dest) = fc;
+        return;
+    }
+
+    if (blit->mode == RTGUI_PATCH_TILE)
+    {
+        for (y = y1; y < y2; y += sh)
+        {
+            for (x = x1; x < x2; x += sw)
+            {
+                _patch_blit_once(blit, RTGUI_DC(blit->src), cell->x1, cell->y1, x, y,
+                                 _UI_MIN(x + sw, x2), _UI_MIN(y + sh, y2));
+            }
+        }
+        return;
+    }
+
+    /* stretch in rows, the stretched line is built once for the same source row */
+    for (y = y1, last = -1; y < y2; y ++)
+    {
+        sy = cell->y1 + (y - y1) * sh / dh;
+        if (sw == dw)
+        {
+            _patch_blit_once(blit, RTGUI_DC(blit->src), cell->x1, sy, x1, y, x2, y + 1);
+            continue;
+        }
+
+        if (sy != last)
+        {
+            line = _patch_line(blit, cell->x1, sw, sy, dw);
+            if (line == RT_NULL)
+                return;
+            last = sy;
+        }
+        _patch_blit_once(blit, blit->line, 0, 0, x1, y, x2, y + 1);
+    }
+}
+
+/*
+ * Blit the buffer dc to the rect in nine patches. The center is the part of
+ * source to be scaled, the corners out of it are blitted once, the edges are
+ * scaled in one axis, and the center in both. A uniform center is a solid
+ * fill, so the themed panels of any size are drawn from one small bitmap.
+ */
+void rtgui_dc_blit_nine_patch(struct rtgui_dc *src, const rtgui_rect_t *center,
+                              struct rtgui_dc *dest, const rtgui_rect_t *rect,
+                              enum rtgui_patch_mode mode)
+{
+    int i, j, sx[4], sy[4], dx[4], dy[4];
+    rtgui_rect_t cell;
+    struct _patch_blit blit;
+
+    RT_ASSERT(src != RT_NULL && center != RT_NULL);
+    RT_ASSERT(dest != RT_NULL && rect != RT_NULL);
+    RT_ASSERT(src->type == RTGUI_DC_BUFFER);
+
+    if (rect->x1 >= rect->x2 || rect->y1 >= rect->y2)
+        return;
+    if (!rtgui_dc_get_visible(dest))
+        return;
+
+    blit.src = (struct rtgui_dc_buffer *)src;
+    blit.dest = dest;
+    blit.mode = mode;
+    blit.line = RT_NULL;
+    blit.line_width = rtgui_rect_width(*rect);
+    /* the lazy buffer is read as cleared */
+    if (blit.src->pixel == RT_NULL && rtgui_dc_buffer_get_pixel(src) == RT_NULL)
+        return;
+
+    _patch_axis(sx, dx, center->x1, center->x2, blit.src->width, rect->x1, rect->x2);
+    _patch_axis(sy, dy, center->y1, center->y2, blit.src->height, rect->y1, rect->y2);
+
+    for (j = 0; j < 3; j ++)
+    {
+        for (i = 0; i < 3; i ++)
+        {
+            rtgui_rect_init(&cell, sx[i], sy[j], sx[i + 1] - sx[i], sy[j + 1] - sy[j]);
+            _patch_cell(&blit, &cell, dx[i], dy[j], dx[i + 1], dy[j + 1], i == 1 && j == 1);
+        }
+    }
+
+    if (blit.line != RT_NULL)
+        rtgui_dc_destory(blit.line);
+}
+RTM_EXPORT(rtgui_dc_blit_nine_patch);
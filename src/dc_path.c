@@ -0,0 +1,948 @@
+/*
+ * File      : dc_path.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/dc_path.h>
+#include <rtgui/rtgui_system.h>
+
+/* for sin/cos etc */
+#include <math.h>
+
+#define PATH_MOVE           0x01
+#define PATH_CLOSE          0x02
+
+/* the curves are flattened in the error of 1/8 pixel, at most 64 lines */
+#define PATH_TOLERANCE      (RTGUI_PATH_ONE / 8)
+#define PATH_MAX_LINES      64
+/* the miter longer than the limit of width is beveled */
+#define PATH_MITER_LIMIT    4
+
+/* the coverage of a full pixel is RTGUI_PATH_ONE * RTGUI_PATH_ONE */
+#define PATH_COVER_SHIFT    (RTGUI_PATH_FRAC_BITS * 2)
+#define PATH_COVER_FULL     (1 << PATH_COVER_SHIFT)
+
+#define PATH_SPAN_BATCH     32
+
+struct rtgui_path_point
+{
+    rt_int32_t x, y;
+    rt_uint32_t flag;
+};
+
+struct rtgui_path
+{
+    struct rtgui_path_point *points;
+    int count, size;
+    /* the first point of the last contour */
+    int start;
+};
+
+/* the edge from top to bottom, dir is -1 for the edge up in path */
+struct _path_edge
+{
+    rt_int32_t x0, y0, x1, y1;
+    /* dx / dy in 16.16 */
+    rt_int64_t slope;
+    int dir;
+};
+
+struct _path_edges
+{
+    struct _path_edge *edges;
+    int num;
+    rt_int32_t minx, miny, maxx, maxy;
+};
+
+/* the unit circle in 1/256 of the round joins */
+static const rt_int16_t _path_circle[16][2] =
+{
+    { 256,    0}, { 237,   98}, { 181,  181}, {  98,  237},
+    {   0,  256}, { -98,  237}, {-181,  181}, {-237,   98},
+    {-256,    0}, {-237,  -98}, {-181, -181}, { -98, -237},
+    {   0, -256}, {  98, -237}, { 181, -181}, { 237,  -98},
+};
+
+struct rtgui_path *rtgui_path_create(int size)
+{
+    struct rtgui_path *path;
+
+    if (size < 4)
+        size = 4;
+
+    path = (struct rtgui_path *)rtgui_malloc(sizeof(struct rtgui_path));
+    if (path == RT_NULL)
+        return RT_NULL;
+
+    path->points = (struct rtgui_path_point *)rtgui_malloc(size * sizeof(struct rtgui_path_point));
+    if (path->points == RT_NULL)
+    {
+        rtgui_free(path);
+        return RT_NULL;
+    }
+    path->size = size;
+    rtgui_path_reset(path);
+
+    return path;
+}
+RTM_EXPORT(rtgui_path_create);
+
+void rtgui_path_destroy(struct rtgui_path *path)
+{
+    if (path == RT_NULL)
+        return;
+
+    rtgui_free(path->points);
+    rtgui_free(path);
+}
+RTM_EXPORT(rtgui_path_destroy);
+
+void rtgui_path_reset(struct rtgui_path *path)
+{
+    RT_ASSERT(path != RT_NULL);
+
+    path->count = 0;
+    path->start = 0;
+}
+RTM_EXPORT(rtgui_path_reset);
+
+static rt_err_t _path_add(struct rtgui_path *path, rt_int32_t x, rt_int32_t y, rt_uint32_t flag)
+{
+    struct rtgui_path_point *points;
+
+    if (path->count == path->size)
+    {
+        points = (struct rtgui_path_point *)rtgui_realloc(path->points,
+                 path->size * 2 * sizeof(struct rtgui_path_point));
+        if (points == RT_NULL)
+            return -RT_ENOMEM;
+        path->points = points;
+        path->size *= 2;
+    }
+
+    if (flag & PATH_MOVE)
+        path->start = path->count;
+    points = &path->points[path->count ++];
+    points->x = x;
+    points->y = y;
+    points->flag = flag;
+
+    return RT_EOK;
+}
+
+/* a line after the close starts a new contour from the closed one */
+static rt_err_t _path_current(struct rtgui_path *path, int x, int y)
+{
+    struct rtgui_path_point *last;
+
+    if (path->count == 0)
+        return _path_add(path, x, y, PATH_MOVE);
+
+    last = &path->points[path->count - 1];
+    if (last->flag & PATH_CLOSE)
+        return _path_add(path, path->points[path->start].x, path->points[path->start].y, PATH_MOVE);
+
+    return RT_EOK;
+}
+
+rt_err_t rtgui_path_move_to(struct rtgui_path *path, int x, int y)
+{
+    RT_ASSERT(path != RT_NULL);
+
+    /* the contour of a single point is replaced */
+    if (path->count > 0 && path->start == path->count - 1)
+    {
+        path->points[path->start].x = x;
+        path->points[path->start].y = y;
+        path->points[path->start].flag = PATH_MOVE;
+        return RT_EOK;
+    }
+
+    return _path_add(path, x, y, PATH_MOVE);
+}
+RTM_EXPORT(rtgui_path_move_to);
+
+rt_err_t rtgui_path_line_to(struct rtgui_path *path, int x, int y)
+{
+    RT_ASSERT(path != RT_NULL);
+
+    if (_path_current(path, x, y) != RT_EOK)
+        return -RT_ENOMEM;
+
+    return _path_add(path, x, y, 0);
+}
+RTM_EXPORT(rtgui_path_line_to);
+
+static int _path_abs(int value)
+{
+    return value < 0 ? -value : value;
+}
+
+/* the lines of a curve, which deviation is at most dd / (n * n) */
+static int _path_lines(int dd)
+{
+    int n = 1;
+
+    while (n < PATH_MAX_LINES && n * n * PATH_TOLERANCE < dd)
+        n ++;
+
+    return n;
+}
+
+rt_err_t rtgui_path_quad_to(struct rtgui_path *path, int cx, int cy, int x, int y)
+{
+    int i, n, dd;
+    rt_int64_t t, u, den;
+    struct rtgui_path_point p0;
+
+    RT_ASSERT(path != RT_NULL);
+
+    if (_path_current(path, cx, cy) != RT_EOK)
+        return -RT_ENOMEM;
+    p0 = path->points[path->count - 1];
+
+    /* the deviation of one line is |p0 - 2c + p1| / 4 */
+    dd = _path_abs(p0.x - 2 * cx + x);
+    if (_path_abs(p0.y - 2 * cy + y) > dd)
+        dd = _path_abs(p0.y - 2 * cy + y);
+    n = _path_lines(dd / 4);
+
+    den = (rt_int64_t)n * n;
+    for (i = 1; i < n; i ++)
+    {
+        t = i;
+        u = n - i;
+        if (_path_add(path, (rt_int32_t)((u * u * p0.x + 2 * t * u * cx + t * t * x) / den),
+                      (rt_int32_t)((u * u * p0.y + 2 * t * u * cy + t * t * y) / den), 0) != RT_EOK)
+            return -RT_ENOMEM;
+    }
+
+    return _path_add(path, x, y, 0);
+}
+RTM_EXPORT(rtgui_path_quad_to);
+
+rt_err_t rtgui_path_cubic_to(struct rtgui_path *path, int c1x, int c1y,
+                             int c2x, int c2y, int x, int y)
+{
+    int i, n, dd, d;
+    rt_int64_t t, u, den;
+    struct rtgui_path_point p0;
+
+    RT_ASSERT(path != RT_NULL);
+
+    if (_path_current(path, c1x, c1y) != RT_EOK)
+        return -RT_ENOMEM;
+    p0 = path->points[path->count - 1];
+
+    /* the deviation of one line is 3/4 of the larger second difference */
+    dd = _path_abs(p0.x - 2 * c1x + c2x);
+    d = _path_abs(p0.y - 2 * c1y + c2y);
+    if (d > dd) dd = d;
+    d = _path_abs(c1x - 2 * c2x + x);
+    if (d > dd) dd = d;
+    d = _path_abs(c1y - 2 * c2y + y);
+    if (d > dd) dd = d;
+    n = _path_lines(dd / 4 * 3);
+
+    den = (rt_int64_t)n * n * n;
+    for (i = 1; i < n; i ++)
+    {
+        t = i;
+        u = n - i;
+        if (_path_add(path,
+                      (rt_int32_t)((u * u * u * p0.x + 3 * u * u * t * c1x + 3 * u * t * t * c2x + t * t * t * x) / den),
+                      (rt_int32_t)((u * u * u * p0.y + 3 * u * u * t * c1y + 3 * u * t * t * c2y + t * t * t * y) / den),
+                      0) != RT_EOK)
+            return -RT_ENOMEM;
+    }
+
+    return _path_add(path, x, y, 0);
+}
+RTM_EXPORT(rtgui_path_cubic_to);
+
+static int _path_round(double value)
+{
+    return (int)floor(value + 0.5);
+}
+
+/* the arc in the cubic curves of at most 90 degrees */
+rt_err_t rtgui_path_arc(struct rtgui_path *path, int cx, int cy, int r, int start, int end)
+{
+    int i, n;
+    double a0, a1, step, k;
+    rt_err_t result;
+
+    RT_ASSERT(path != RT_NULL);
+
+    a0 = start * M_PI / 180;
+    n = (_path_abs(end - start) + 89) / 90;
+    if (n == 0)
+        n = 1;
+    step = (end - start) * M_PI / 180 / n;
+    k = 4.0 / 3.0 * tan(step / 4) * r;
+
+    if (path->count == 0 || (path->points[path->count - 1].flag & PATH_CLOSE))
+        result = rtgui_path_move_to(path, cx + _path_round(r * cos(a0)), cy + _path_round(r * sin(a0)));
+    else
+        result = rtgui_path_line_to(path, cx + _path_round(r * cos(a0)), cy + _path_round(r * sin(a0)));
+
+    for (i = 0; i < n && result == RT_EOK; i ++)
+    {
+        a1 = a0 + step;
+        result = rtgui_path_cubic_to(path,
+                                     cx + _path_round(r * cos(a0) - k * sin(a0)),
+                                     cy + _path_round(r * sin(a0) + k * cos(a0)),
+                                     cx + _path_round(r * cos(a1) + k * sin(a1)),
+                                     cy + _path_round(r * sin(a1) - k * cos(a1)),
+                                     cx + _path_round(r * cos(a1)), cy + _path_round(r * sin(a1)));
+        a0 = a1;
+    }
+
+    return result;
+}
+RTM_EXPORT(rtgui_path_arc);
+
+rt_err_t rtgui_path_close(struct rtgui_path *path)
+{
+    RT_ASSERT(path != RT_NULL);
+
+    if (path->count > 0)
+        path->points[path->count - 1].flag |= PATH_CLOSE;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_path_close);
+
+/* the horizontal edges are dropped, they cover no area */
+static void _path_edge_add(struct _path_edges *edges, rt_int32_t x0, rt_int32_t y0,
+                           rt_int32_t x1, rt_int32_t y1)
+{
+    struct _path_edge *edge;
+
+    if (y0 == y1)
+        return;
+
+    edge = &edges->edges[edges->num ++];
+    if (y0 < y1)
+    {
+        edge->x0 = x0; edge->y0 = y0;
+        edge->x1 = x1; edge->y1 = y1;
+        edge->dir = 1;
+    }
+    else
+    {
+        edge->x0 = x1; edge->y0 = y1;
+        edge->x1 = x0; edge->y1 = y0;
+        edge->dir = -1;
+    }
+    edge->slope = ((rt_int64_t)(edge->x1 - edge->x0) << 16) / (edge->y1 - edge->y0);
+
+    if (edge->x0 < edges->minx) edges->minx = edge->x0;
+    if (edge->x0 > edges->maxx) edges->maxx = edge->x0;
+    if (edge->x1 < edges->minx) edges->minx = edge->x1;
+    if (edge->x1 > edges->maxx) edges->maxx = edge->x1;
+    if (edge->y0 < edges->miny) edges->miny = edge->y0;
+    if (edge->y1 > edges->maxy) edges->maxy = edge->y1;
+}
+
+/* sort the edges by y0 in shell sort, the strokes have thousands of edges */
+static void _path_edge_sort(struct _path_edges *edges)
+{
+    int i, j, gap;
+    struct _path_edge edge;
+
+    for (gap = edges->num / 2; gap > 0; gap /= 2)
+    {
+        for (i = gap; i < edges->num; i ++)
+        {
+            edge = edges->edges[i];
+            for (j = i; j >= gap && edges->edges[j - gap].y0 > edge.y0; j -= gap)
+                edges->edges[j] = edges->edges[j - gap];
+            edges->edges[j] = edge;
+        }
+    }
+}
+
+static rt_int32_t _path_edge_x(const struct _path_edge *edge, rt_int32_t y)
+{
+    if (y == edge->y1)
+        return edge->x1;
+
+    return edge->x0 + (rt_int32_t)(((y - edge->y0) * edge->slope) >> 16);
+}
+
+/*
+ * Accumulate the area of the edge from (x, top) to (xnext, bottom) in a row,
+ * the height d is signed by the direction. The area right of the edge is
+ * added in the difference form, the coverage of the pixel is the sum of all
+ * the cells left to it.
+ */
+static void _path_accumulate(int *acc, rt_int32_t x, rt_int32_t xnext, int d)
+{
+    int x0i, x1i, xi, x0f, x1f;
+    rt_int32_t x0, x1, w;
+    int a0, a1, a2, am, step, full;
+
+    if (x < xnext)
+    {
+        x0 = x;
+        x1 = xnext;
+    }
+    else
+    {
+        x0 = xnext;
+        x1 = x;
+    }
+    x0i = x0 >> RTGUI_PATH_FRAC_BITS;
+    x1i = (x1 + RTGUI_PATH_ONE - 1) >> RTGUI_PATH_FRAC_BITS;
+
+    if (x1i <= x0i + 1)
+    {
+        /* in one pixel, split by the middle of edge */
+        x0f = ((x + xnext) >> 1) - (x0i << RTGUI_PATH_FRAC_BITS);
+        acc[x0i] += d * (RTGUI_PATH_ONE - x0f);
+        acc[x0i + 1] += d * x0f;
+        return;
+    }
+
+    /* the triangles at both ends, and the same step in the pixels between */
+    w = x1 - x0;
+    x0f = x0 - (x0i << RTGUI_PATH_FRAC_BITS);
+    x1f = x1 - (x1i << RTGUI_PATH_FRAC_BITS) + RTGUI_PATH_ONE;
+    full = d * RTGUI_PATH_ONE;
+    a0 = d * (RTGUI_PATH_ONE - x0f) * (RTGUI_PATH_ONE - x0f) / (2 * w);
+    am = d * x1f * x1f / (2 * w);
+
+    acc[x0i] += a0;
+    if (x1i == x0i + 2)
+    {
+        acc[x0i + 1] += full - a0 - am;
+    }
+    else
+    {
+        step = d * PATH_COVER_FULL / w;
+        a1 = d * RTGUI_PATH_ONE * (RTGUI_PATH_ONE * 3 / 2 - x0f) / w;
+        acc[x0i + 1] += a1 - a0;
+        for (xi = x0i + 2; xi < x1i - 1; xi ++)
+            acc[xi] += step;
+        a2 = a1 + (x1i - x0i - 3) * step;
+        acc[x1i - 1] += full - a2 - am;
+    }
+    acc[x1i] += am;
+}
+
+struct _path_spans
+{
+    struct rtgui_dc *dc;
+    rtgui_color_t color;
+    struct rtgui_span spans[PATH_SPAN_BATCH];
+    int num;
+};
+
+static void _path_spans_flush(struct _path_spans *spans)
+{
+    if (spans->num)
+        rtgui_dc_fill_spans(spans->dc, spans->spans, spans->num);
+    spans->num = 0;
+}
+
+/* the run of full coverage, in spans of foreground or the blend of a translucent color */
+static void _path_spans_push(struct _path_spans *spans, int x1, int x2, int y)
+{
+    rtgui_rect_t rect;
+
+    if (RTGUI_RGB_A(spans->color) != 255)
+    {
+        rtgui_rect_init(&rect, x1, y, x2 - x1, 1);
+        rtgui_dc_blend_fill_rect(spans->dc, &rect, RTGUI_BLENDMODE_BLEND, spans->color);
+        return;
+    }
+
+    if (spans->num == PATH_SPAN_BATCH)
+        _path_spans_flush(spans);
+    spans->spans[spans->num].x1 = x1;
+    spans->spans[spans->num].x2 = x2;
+    spans->spans[spans->num].y = y;
+    spans->num ++;
+}
+
+/*
+ * Rasterize the edges row by row. The areas of the active edges are
+ * accumulated in a row of cells and summed to the coverage, the runs of full
+ * coverage are filled in spans and the pixels of edges are blended.
+ */
+static void _path_raster(struct rtgui_dc *dc, struct _path_edges *edges,
+                         enum rtgui_path_fill_rule rule)
+{
+    int i, x, y, y1, y2, ox, px, width, run;
+    int num_active, next, sum, cover, alpha;
+    int *acc;
+    rt_int32_t top, bottom, ya, yb;
+    struct _path_edge *edge, **active;
+    struct _path_spans spans;
+    rtgui_rect_t rect;
+    rt_uint8_t r, g, b, a;
+
+    if (edges->num == 0)
+        return;
+
+    rtgui_dc_get_rect(dc, &rect);
+    y1 = edges->miny >> RTGUI_PATH_FRAC_BITS;
+    y2 = (edges->maxy + RTGUI_PATH_ONE - 1) >> RTGUI_PATH_FRAC_BITS;
+    if (y1 < rect.y1) y1 = rect.y1;
+    if (y2 > rect.y2) y2 = rect.y2;
+    if (y1 >= y2)
+        return;
+
+    ox = edges->minx >> RTGUI_PATH_FRAC_BITS;
+    width = ((edges->maxx + RTGUI_PATH_ONE - 1) >> RTGUI_PATH_FRAC_BITS) - ox + 2;
+    if (ox >= rect.x2 || ox + width <= rect.x1)
+        return;
+
+    acc = (int *)rtgui_malloc(width * sizeof(int) + edges->num * sizeof(struct _path_edge *));
+    if (acc == RT_NULL)
+        return;
+    active = (struct _path_edge **)(acc + width);
+    rt_memset(acc, 0, width * sizeof(int));
+
+    _path_edge_sort(edges);
+
+    spans.dc = dc;
+    spans.color = RTGUI_DC_FC(dc);
+    spans.num = 0;
+    r = RTGUI_RGB_R(spans.color);
+    g = RTGUI_RGB_G(spans.color);
+    b = RTGUI_RGB_B(spans.color);
+    a = RTGUI_RGB_A(spans.color);
+
+    num_active = 0;
+    next = 0;
+    for (y = y1; y < y2; y ++)
+    {
+        top = y << RTGUI_PATH_FRAC_BITS;
+        bottom = top + RTGUI_PATH_ONE;
+
+        while (next < edges->num && edges->edges[next].y0 < bottom)
+            active[num_active ++] = &edges->edges[next ++];
+
+        for (i = 0; i < num_active;)
+        {
+            edge = active[i];
+            if (edge->y1 <= top)
+            {
+                active[i] = active[-- num_active];
+                continue;
+            }
+            i ++;
+
+            ya = edge->y0 > top ? edge->y0 : top;
+            yb = edge->y1 < bottom ? edge->y1 : bottom;
+            _path_accumulate(acc, _path_edge_x(edge, ya) - (ox << RTGUI_PATH_FRAC_BITS),
+                             _path_edge_x(edge, yb) - (ox << RTGUI_PATH_FRAC_BITS),
+                             (yb - ya) * edge->dir);
+        }
+
+        /* sum the cells to the coverage, and clear them for the next row */
+        sum = 0;
+        run = -1;
+        for (x = 0; x < width; x ++)
+        {
+            sum += acc[x];
+            acc[x] = 0;
+
+            cover = sum < 0 ? -sum : sum;
+            if (rule == RTGUI_PATH_EVENODD)
+            {
+                cover &= 2 * PATH_COVER_FULL - 1;
+                if (cover > PATH_COVER_FULL)
+                    cover = 2 * PATH_COVER_FULL - cover;
+            }
+            else if (cover > PATH_COVER_FULL)
+            {
+                cover = PATH_COVER_FULL;
+            }
+            alpha = (cover * 255 + PATH_COVER_FULL / 2) >> PATH_COVER_SHIFT;
+
+            px = ox + x;
+            if (alpha == 255 && px >= rect.x1 && px < rect.x2)
+            {
+                if (run < 0)
+                    run = px;
+                continue;
+            }
+
+            if (run >= 0)
+            {
+                _path_spans_push(&spans, run, px, y);
+                run = -1;
+            }
+            if (alpha > 0 && px >= rect.x1 && px < rect.x2)
+                rtgui_dc_blend_point(dc, px, y, RTGUI_BLENDMODE_BLEND, r, g, b,
+                                     a * RTGUI_COVERAGE(alpha) / 255);
+        }
+        if (run >= 0)
+            _path_spans_push(&spans, run, ox + width, y);
+    }
+    _path_spans_flush(&spans);
+
+    rtgui_free(acc);
+}
+
+static rt_bool_t _path_edges_init(struct _path_edges *edges, int size)
+{
+    edges->edges = (struct _path_edge *)rtgui_malloc(size * sizeof(struct _path_edge));
+    if (edges->edges == RT_NULL)
+        return RT_FALSE;
+
+    edges->num = 0;
+    edges->minx = edges->miny = 0x7fffffff;
+    edges->maxx = edges->maxy = -0x7fffffff;
+
+    return RT_TRUE;
+}
+
+/* the contour from the point index, return the count of its points */
+static int _path_contour(const struct rtgui_path *path, int index, rt_bool_t *closed)
+{
+    int count;
+
+    for (count = 1; index + count < path->count; count ++)
+    {
+        if (path->points[index + count].flag & PATH_MOVE)
+            break;
+    }
+    *closed = (path->points[index + count - 1].flag & PATH_CLOSE) ? RT_TRUE : RT_FALSE;
+
+    return count;
+}
+
+void rtgui_dc_fill_path(struct rtgui_dc *dc, const struct rtgui_path *path,
+                        enum rtgui_path_fill_rule rule)
+{
+    int index, i, count;
+    rt_bool_t closed;
+    const struct rtgui_path_point *points;
+    struct _path_edges edges;
+
+    RT_ASSERT(dc != RT_NULL && path != RT_NULL);
+
+    if (path->count < 3 || !rtgui_dc_get_visible(dc))
+        return;
+    if (_path_edges_init(&edges, path->count) == RT_FALSE)
+        return;
+
+    for (index = 0; index < path->count; index += count)
+    {
+        count = _path_contour(path, index, &closed);
+        points = &path->points[index];
+        for (i = 0; i < count; i ++)
+        {
+            _path_edge_add(&edges, points[i].x, points[i].y,
+                           points[(i + 1) % count].x, points[(i + 1) % count].y);
+        }
+    }
+
+    _path_raster(dc, &edges, rule);
+    rtgui_free(edges.edges);
+}
+RTM_EXPORT(rtgui_dc_fill_path);
+
+/* the polygon in the orientation of the rects and circles of stroke, negative in the y down area */
+static void _path_stroke_poly(struct _path_edges *edges, const double *xy, int count)
+{
+    int i, j;
+    double area;
+    rt_int32_t x[4], y[4];
+
+    area = 0;
+    for (i = 0; i < count; i ++)
+    {
+        j = (i + 1) % count;
+        x[i] = _path_round(xy[2 * i]);
+        y[i] = _path_round(xy[2 * i + 1]);
+        area += xy[2 * i] * xy[2 * j + 1] - xy[2 * j] * xy[2 * i + 1];
+    }
+
+    for (i = 0; i < count; i ++)
+    {
+        j = (i + 1) % count;
+        if (area > 0)
+            _path_edge_add(edges, x[j], y[j], x[i], y[i]);
+        else
+            _path_edge_add(edges, x[i], y[i], x[j], y[j]);
+    }
+}
+
+/* the direction of line in the half width, RT_FALSE for a point */
+static rt_bool_t _path_stroke_dir(const struct rtgui_path_point *p, const struct rtgui_path_point *q,
+                                  int half, double *dir)
+{
+    double dx, dy, len;
+
+    dx = q->x - p->x;
+    dy = q->y - p->y;
+    if (dx == 0 && dy == 0)
+        return RT_FALSE;
+
+    len = sqrt(dx * dx + dy * dy);
+    dir[0] = dx * half / len;
+    dir[1] = dy * half / len;
+
+    return RT_TRUE;
+}
+
+/* the rect of a line, the normal is (-dir[1], dir[0]) */
+static void _path_stroke_line(struct _path_edges *edges, const struct rtgui_path_point *p,
+                              const struct rtgui_path_point *q, const double *dir)
+{
+    double xy[8];
+
+    xy[0] = p->x - dir[1];
+    xy[1] = p->y + dir[0];
+    xy[2] = q->x - dir[1];
+    xy[3] = q->y + dir[0];
+    xy[4] = q->x + dir[1];
+    xy[5] = q->y - dir[0];
+    xy[6] = p->x + dir[1];
+    xy[7] = p->y - dir[0];
+    _path_stroke_poly(edges, xy, 4);
+}
+
+static void _path_stroke_circle(struct _path_edges *edges, const struct rtgui_path_point *p, int half)
+{
+    int k, next;
+
+    for (k = 15; k >= 0; k --)
+    {
+        next = (k + 15) & 15;
+        _path_edge_add(edges, p->x + _path_circle[k][0] * half / 256,
+                       p->y + _path_circle[k][1] * half / 256,
+                       p->x + _path_circle[next][0] * half / 256,
+                       p->y + _path_circle[next][1] * half / 256);
+    }
+}
+
+/*
+ * The join of the lines in and out of the point. The bevel is the triangle on
+ * the outer side, the miter is the quad to the tip of outer edges, which
+ * falls back to the bevel in the sharp angle over the miter limit.
+ */
+static void _path_stroke_join(struct _path_edges *edges, const struct rtgui_path_point *p,
+                              const double *d1, const double *d2, int half,
+                              enum rtgui_path_join join)
+{
+    int n;
+    double s, ux, uy, u2, t, xy[8];
+
+    if (join == RTGUI_PATH_JOIN_ROUND)
+    {
+        _path_stroke_circle(edges, p, half);
+        return;
+    }
+
+    /* the outer side of the turn */
+    s = d1[0] * d2[1] - d1[1] * d2[0];
+    if (s == 0 && d1[0] * d2[0] + d1[1] * d2[1] > 0)
+        return;
+    s = s > 0 ? -1 : 1;
+
+    n = 0;
+    xy[n ++] = p->x;
+    xy[n ++] = p->y;
+    xy[n ++] = p->x - s * d1[1];
+    xy[n ++] = p->y + s * d1[0];
+    if (join == RTGUI_PATH_JOIN_MITER)
+    {
+        /* the tip is on the bisector, at half / cos(angle / 2) */
+        ux = -d1[1] - d2[1];
+        uy = d1[0] + d2[0];
+        u2 = ux * ux + uy * uy;
+        if (u2 * PATH_MITER_LIMIT * PATH_MITER_LIMIT > 4.0 * half * half)
+        {
+            t = 2.0 * half * half / u2;
+            xy[n ++] = p->x + s * ux * t;
+            xy[n ++] = p->y + s * uy * t;
+        }
+    }
+    xy[n ++] = p->x - s * d2[1];
+    xy[n ++] = p->y + s * d2[0];
+    _path_stroke_poly(edges, xy, n / 2);
+}
+
+/* the cap at the end point, dir is out of the line */
+static void _path_stroke_cap(struct _path_edges *edges, const struct rtgui_path_point *p,
+                             const double *dir, int half, enum rtgui_path_cap cap)
+{
+    double xy[8];
+
+    switch (cap)
+    {
+    case RTGUI_PATH_CAP_ROUND:
+        _path_stroke_circle(edges, p, half);
+        break;
+    case RTGUI_PATH_CAP_SQUARE:
+        xy[0] = p->x - dir[1];
+        xy[1] = p->y + dir[0];
+        xy[2] = xy[0] + dir[0];
+        xy[3] = xy[1] + dir[1];
+        xy[4] = p->x + dir[1] + dir[0];
+        xy[5] = p->y - dir[0] + dir[1];
+        xy[6] = p->x + dir[1];
+        xy[7] = p->y - dir[0];
+        _path_stroke_poly(edges, xy, 4);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * Stroke the path as the union of the rects of lines, the joins and the caps
+ * of the open contours. They are in the same orientation, and filled in the
+ * non-zero rule. The points of zero length lines are skipped.
+ */
+void rtgui_dc_stroke_path(struct rtgui_dc *dc, const struct rtgui_path *path, int width,
+                          enum rtgui_path_cap cap, enum rtgui_path_join join)
+{
+    int index, i, last, count, half;
+    rt_bool_t closed, lined;
+    double first[2], prev[2], dir[2], back[2];
+    const struct rtgui_path_point *points;
+    struct _path_edges edges;
+
+    RT_ASSERT(dc != RT_NULL && path != RT_NULL);
+
+    half = width / 2;
+    if (path->count < 2 || half <= 0 || !rtgui_dc_get_visible(dc))
+        return;
+    /* 4 edges of each line and 16 of each join, the closing line and 2 caps */
+    if (_path_edges_init(&edges, (path->count + 1) * 20 + 32) == RT_FALSE)
+        return;
+
+    for (index = 0; index < path->count; index += count)
+    {
+        count = _path_contour(path, index, &closed);
+        points = &path->points[index];
+        lined = RT_FALSE;
+        for (last = 0, i = 1; i <= count; i ++)
+        {
+            if (i == count && (!closed || count < 3))
+                break;
+            if (_path_stroke_dir(&points[last], &points[i % count], half, dir) == RT_FALSE)
+                continue;
+
+            if (lined)
+            {
+                _path_stroke_join(&edges, &points[last], prev, dir, half, join);
+            }
+            else
+            {
+                first[0] = dir[0];
+                first[1] = dir[1];
+                lined = RT_TRUE;
+            }
+            _path_stroke_line(&edges, &points[last], &points[i % count], dir);
+            prev[0] = dir[0];
+            prev[1] = dir[1];
+            last = i;
+        }
+        if (!lined)
+            continue;
+
+        if (closed && count > 2)
+        {
+            _path_stroke_join(&edges, &points[0], prev, first, half, join);
+        }
+        else
+        {
+            back[0] = -first[0];
+            back[1] = -first[1];
+            _path_stroke_cap(&edges, &points[0], back, half, cap);
+            _path_stroke_cap(&edges, &points[last], prev, half, cap);
+        }
+    }
+
+    _path_raster(dc, &edges, RTGUI_PATH_NONZERO);
+    rtgui_free(edges.edges);
+}
+RTM_EXPORT(rtgui_dc_stroke_path);
+
+/*
+ * Fill the sector of annulus in anti-aliasing, the pixels are the same as
+ * rtgui_dc_fill_annulus. It's the path of the outer arc and the inner arc
+ * back, the pie is the path from the center for r1 = 0.
+ */
+void rtgui_dc_fill_aa_annulus(struct rtgui_dc *dc, int x, int y, int r1, int r2, int start, int end)
+{
+    int cx, cy, t;
+    struct rtgui_path *path;
+
+    RT_ASSERT(dc != RT_NULL);
+
+    if (r1 > r2)
+    {
+        t = r1;
+        r1 = r2;
+        r2 = t;
+    }
+    if (r1 < 0 || start == end)
+        return;
+    if (end - start > 360)
+        end = start + 360;
+    else if (start - end > 360)
+        end = start - 360;
+
+    path = rtgui_path_create(64);
+    if (path == RT_NULL)
+        return;
+
+    /* in the center of pixel, the outer edge of ring includes the pixels on r2 */
+    cx = RTGUI_PATH_FIXED(x) + RTGUI_PATH_ONE / 2;
+    cy = RTGUI_PATH_FIXED(y) + RTGUI_PATH_ONE / 2;
+    rtgui_path_arc(path, cx, cy, RTGUI_PATH_FIXED(r2) + RTGUI_PATH_ONE / 2, start, end);
+    if (end - start == 360 || start - end == 360)
+    {
+        /* the hole of ring is another contour, in the even-odd rule */
+        rtgui_path_close(path);
+        if (r1 > 0)
+        {
+            rtgui_path_arc(path, cx, cy, RTGUI_PATH_FIXED(r1) - RTGUI_PATH_ONE / 2, start, end);
+            rtgui_path_close(path);
+        }
+    }
+    else
+    {
+        if (r1 > 0)
+            rtgui_path_arc(path, cx, cy, RTGUI_PATH_FIXED(r1) - RTGUI_PATH_ONE / 2, end, start);
+        else
+            rtgui_path_line_to(path, cx, cy);
+        rtgui_path_close(path);
+    }
+    rtgui_dc_fill_path(dc, path, RTGUI_PATH_EVENODD);
+
+    rtgui_path_destroy(path);
+}
+RTM_EXPORT(rtgui_dc_fill_aa_annulus);
@@ -0,0 +1,269 @@
+/*
+ * File      : dc_pool.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_DC_POOL
+
+#if (GUIENGINE_DC_POOL_MIN & (GUIENGINE_DC_POOL_MIN - 1)) != 0
+#error "GUIENGINE_DC_POOL_MIN should be a power of 2"
+#endif
+
+/* the buckets from GUIENGINE_DC_POOL_MIN bytes */
+#define DC_POOL_BUCKETS     24
+/* the block smaller than GUIENGINE_DC_POOL_MIN is not kept in the pool */
+#define DC_POOL_DIRECT      0xff
+
+/*
+ * The header before the pixels of a block. The block is in the size of its
+ * bucket, so it's reused by any buffer in the same bucket.
+ */
+struct rtgui_dc_pool_block
+{
+    struct rtgui_dc_pool_block *next;
+    rt_uint32_t bucket;
+};
+
+/* the blocks idle in each bucket */
+static struct rtgui_dc_pool_block *_pool_idle[DC_POOL_BUCKETS];
+/* the bytes of the blocks idle, at most _pool_budget */
+static rt_size_t _pool_idle_size = 0;
+static rt_size_t _pool_budget = GUIENGINE_DC_POOL_BUDGET;
+#ifdef RT_USING_MEMHEAP
+static struct rt_memheap *_pool_heap = RT_NULL;
+#endif
+
+static void *_pool_heap_alloc(rt_size_t size)
+{
+#ifdef RT_USING_MEMHEAP
+    void *ptr;
+
+    /* the external memory first, the system heap if it's full */
+    if (_pool_heap != RT_NULL)
+    {
+        ptr = rt_memheap_alloc(_pool_heap, size);
+        if (ptr != RT_NULL)
+            return ptr;
+    }
+#endif
+
+    return rtgui_malloc(size);
+}
+
+static void _pool_heap_free(void *ptr)
+{
+#ifdef RT_USING_MEMHEAP
+    /* the memheap finds the heap of ptr itself */
+    if (_pool_heap != RT_NULL &&
+            (rt_uint8_t *)ptr >= (rt_uint8_t *)_pool_heap->start_addr &&
+            (rt_uint8_t *)ptr < (rt_uint8_t *)_pool_heap->start_addr + _pool_heap->pool_size)
+    {
+        rt_memheap_free(ptr);
+        return;
+    }
+#endif
+
+    rtgui_free(ptr);
+}
+
+static int _pool_bucket(rt_size_t size)
+{
+    int bucket = 0;
+    rt_size_t bucket_size = GUIENGINE_DC_POOL_MIN;
+
+    while (bucket_size < size)
+    {
+        bucket_size <<= 1;
+        bucket ++;
+        if (bucket == DC_POOL_BUCKETS)
+            return -1;
+    }
+
+    return bucket;
+}
+
+#define _pool_bucket_size(bucket)   ((rt_size_t)GUIENGINE_DC_POOL_MIN << (bucket))
+
+/*
+ * Allocate the pixels of a buffer DC. The idle block in the bucket of size is
+ * reused, the small pixels are allocated from the heap directly.
+ */
+void *rtgui_dc_pool_alloc(rt_size_t size)
+{
+    int bucket;
+    struct rtgui_dc_pool_block *block;
+
+    size += sizeof(struct rtgui_dc_pool_block);
+    if (size < GUIENGINE_DC_POOL_MIN)
+    {
+        block = (struct rtgui_dc_pool_block *)_pool_heap_alloc(size);
+        if (block == RT_NULL)
+            return RT_NULL;
+        block->bucket = DC_POOL_DIRECT;
+        return (void *)(block + 1);
+    }
+
+    bucket = _pool_bucket(size);
+    if (bucket < 0)
+        return RT_NULL;
+
+    rt_enter_critical();
+    block = _pool_idle[bucket];
+    if (block != RT_NULL)
+    {
+        _pool_idle[bucket] = block->next;
+        _pool_idle_size -= _pool_bucket_size(bucket);
+    }
+    rt_exit_critical();
+
+    if (block == RT_NULL)
+    {
+        block = (struct rtgui_dc_pool_block *)_pool_heap_alloc(_pool_bucket_size(bucket));
+        if (block == RT_NULL)
+        {
+            /* give the idle blocks back and try again */
+            rtgui_dc_pool_shrink();
+            block = (struct rtgui_dc_pool_block *)_pool_heap_alloc(_pool_bucket_size(bucket));
+            if (block == RT_NULL)
+                return RT_NULL;
+        }
+        block->bucket = bucket;
+    }
+    block->next = RT_NULL;
+
+    return (void *)(block + 1);
+}
+RTM_EXPORT(rtgui_dc_pool_alloc);
+
+/* keep the block idle in the budget, or free it to the heap */
+void rtgui_dc_pool_free(void *ptr)
+{
+    rt_size_t size;
+    struct rtgui_dc_pool_block *block;
+
+    if (ptr == RT_NULL)
+        return;
+
+    block = (struct rtgui_dc_pool_block *)ptr - 1;
+    if (block->bucket == DC_POOL_DIRECT)
+    {
+        _pool_heap_free(block);
+        return;
+    }
+    size = _pool_bucket_size(block->bucket);
+
+    rt_enter_critical();
+    if (_pool_idle_size + size <= _pool_budget)
+    {
+        block->next = _pool_idle[block->bucket];
+        _pool_idle[block->bucket] = block;
+        _pool_idle_size += size;
+        block = RT_NULL;
+    }
+    rt_exit_critical();
+
+    if (block != RT_NULL)
+        _pool_heap_free(block);
+}
+RTM_EXPORT(rtgui_dc_pool_free);
+
+/* free all of the idle blocks to the heap */
+void rtgui_dc_pool_shrink(void)
+{
+    int bucket;
+    struct rtgui_dc_pool_block *block, *next;
+
+    for (bucket = 0; bucket < DC_POOL_BUCKETS; bucket ++)
+    {
+        rt_enter_critical();
+        block = _pool_idle[bucket];
+        _pool_idle[bucket] = RT_NULL;
+        if (block != RT_NULL)
+        {
+            for (next = block; next != RT_NULL; next = next->next)
+                _pool_idle_size -= _pool_bucket_size(bucket);
+        }
+        rt_exit_critical();
+
+        while (block != RT_NULL)
+        {
+            next = block->next;
+            _pool_heap_free(block);
+            block = next;
+        }
+    }
+}
+RTM_EXPORT(rtgui_dc_pool_shrink);
+
+/* set the bytes kept idle in the pool, the blocks over it are freed */
+void rtgui_dc_pool_set_budget(rt_size_t budget)
+{
+    _pool_budget = budget;
+    if (_pool_idle_size > budget)
+        rtgui_dc_pool_shrink();
+}
+RTM_EXPORT(rtgui_dc_pool_set_budget);
+
+#ifdef RT_USING_MEMHEAP
+/*
+ * Allocate the pixels from the memheap of an external memory (SDRAM or CCM)
+ * first. The blocks allocated before are freed to their heap as well.
+ */
+void rtgui_dc_pool_set_heap(struct rt_memheap *heap)
+{
+    rtgui_dc_pool_shrink();
+    _pool_heap = heap;
+}
+RTM_EXPORT(rtgui_dc_pool_set_heap);
+#endif
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+static int list_dc_pool(void)
+{
+    int bucket, count;
+    struct rtgui_dc_pool_block *block;
+
+    rt_kprintf("idle %d bytes, budget %d bytes\n", _pool_idle_size, _pool_budget);
+    for (bucket = 0; bucket < DC_POOL_BUCKETS; bucket ++)
+    {
+        rt_enter_critical();
+        for (count = 0, block = _pool_idle[bucket]; block != RT_NULL; block = block->next)
+            count ++;
+        rt_exit_critical();
+
+        if (count)
+            rt_kprintf("%8d bytes: %d\n", _pool_bucket_size(bucket), count);
+    }
+
+    return 0;
+}
+MSH_CMD_EXPORT(list_dc_pool, list the idle pixels of buffer dc pool);
+#endif
+
+#endif
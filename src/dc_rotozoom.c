@@ -50,6 +50,8 @@ distribution.
 Andreas Schiffler -- aschiffler at ferzkopp dot net
 */
 
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
 #include <stdlib.h>
 #include <string.h>
 #include <rtgui/rtgui.h>
@@ -59,6 +61,7 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 #include <rtgui/rtgui_system.h>
 
 #include <math.h>
+#include <stdint.h>
 
 /* ---- Internally used structures */
 
@@ -461,142 +464,316 @@ int _rtgui_dc_zoom_RGBA(struct rtgui_dc_buffer * src, struct rtgui_dc_buffer * d
 }
 
 /*!
-\brief Internal 32 bit rotozoomer with optional anti-aliasing.
+\brief Lower limit of absolute zoom factor in 16.16 fixed point.
+*/
+#define FIXED_VALUE_LIMIT 66
 
-Rotates and zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control
-parameters by scanning the destination surface and applying optionally anti-aliasing
-by bilinear interpolation.
-Assumes src and dst surfaces are of 32 bit depth.
-Assumes dst surface was allocated with the correct dimensions.
+/*!
+\brief Quarter wave sine table in 16.16 fixed point, one entry per degree.
+*/
+static const rt_int32_t _rotozoom_sin_table[91] =
+{
+    0, 1144, 2287, 3430, 4572, 5712, 6850, 7987, 9121, 10252,
+    11380, 12505, 13626, 14742, 15855, 16962, 18064, 19161, 20252, 21336,
+    22415, 23486, 24550, 25607, 26656, 27697, 28729, 29753, 30767, 31772,
+    32768, 33754, 34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+    42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930, 48703, 49461,
+    50203, 50931, 51643, 52339, 53020, 53684, 54332, 54963, 55578, 56175,
+    56756, 57319, 57865, 58393, 58903, 59396, 59870, 60326, 60764, 61183,
+    61584, 61966, 62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+    64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446, 65496, 65526,
+    65536,
+};
 
-\param src Source surface.
-\param dst Destination surface.
-\param cx Horizontal center coordinate.
-\param cy Vertical center coordinate.
-\param isin Integer version of sine of angle.
-\param icos Integer version of cosine of angle.
-\param flipx Flag indicating horizontal mirroring should be applied.
-\param flipy Flag indicating vertical mirroring should be applied.
-\param smooth Flag indicating anti-aliasing should be used.
+/*!
+\brief Fixed point sine, interpolates linearly between the table entries.
+
+\param angle The angle in degrees, 16.16 fixed point.
+
+\return The sine of the angle in 16.16 fixed point.
 */
-int _rtgui_dc_transform_RGBA(struct rtgui_dc_buffer * src, struct rtgui_dc_buffer * dst,
-                             int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+static rt_int32_t _rtgui_fixed_sin(rt_int32_t angle)
 {
-    int x, y, t1, t2, dx, dy, xd, yd, sdx, sdy, ax, ay, ex, ey, sw, sh;
-    tColorRGBA c00, c01, c10, c11, cswap;
-    tColorRGBA *pc, *sp;
-    int gap;
+    rt_int32_t index, frac, value;
+    int negative = 0;
 
-    /*
-    * Variable setup
-    */
-    xd = ((src->width - dst->width) << 15);
-    yd = ((src->height - dst->height) << 15);
-    ax = (cx << 16) - (icos * cx);
-    ay = (cy << 16) - (isin * cx);
-    sw = src->width - 1;
-    sh = src->height - 1;
-    pc = (tColorRGBA*) dst->pixel;
-    gap = dst->pitch - dst->width * 4;
+    /* normalize the angle to [0, 90] */
+    angle %= (360 << 16);
+    if (angle < 0) angle += (360 << 16);
+    if (angle >= (180 << 16))
+    {
+        angle -= (180 << 16);
+        negative = 1;
+    }
+    if (angle > (90 << 16)) angle = (180 << 16) - angle;
+
+    index = angle >> 16;
+    frac = angle & 0xffff;
+    value = _rotozoom_sin_table[index];
+    if (frac)
+        value += ((_rotozoom_sin_table[index + 1] - value) * frac) >> 16;
+
+    return negative ? -value : value;
+}
+
+#define _rtgui_fixed_cos(angle) _rtgui_fixed_sin(((angle) % (360 << 16)) + (90 << 16))
+
+/*!
+\brief Calculates the half size of the rotozoomed box in fixed point.
+
+\param width The source width.
+\param height The source height.
+\param s The sine of the angle in 16.16 fixed point.
+\param c The cosine of the angle in 16.16 fixed point.
+\param zoomx The horizontal zoom factor in 16.16 fixed point.
+\param zoomy The vertical zoom factor in 16.16 fixed point.
+\param halfw The calculated half width of the box.
+\param halfh The calculated half height of the box.
+*/
+static void _rtgui_dc_rotozoom_half_size(int width, int height, rt_int32_t s, rt_int32_t c,
+        rt_int32_t zoomx, rt_int32_t zoomy, int *halfw, int *halfh)
+{
+    int64_t czx, czy, szx, szy, w, h;
+
+    if (s < 0) s = -s;
+    if (c < 0) c = -c;
+    if (zoomx < 0) zoomx = -zoomx;
+    if (zoomy < 0) zoomy = -zoomy;
+
+    czx = ((int64_t)c * zoomx) >> 16;
+    czy = ((int64_t)c * zoomy) >> 16;
+    szx = ((int64_t)s * zoomx) >> 16;
+    szy = ((int64_t)s * zoomy) >> 16;
+
+    w = czx * (width / 2) + szy * (height / 2);
+    h = szx * (width / 2) + czy * (height / 2);
+
+    *halfw = MAX((int)((w + 0xffff) >> 16), 1);
+    *halfh = MAX((int)((h + 0xffff) >> 16), 1);
+}
+
+/*!
+\brief Bilinear interpolation of two ARGB8888 pixels, the weight range is 0~255.
+*/
+rt_inline rt_uint32_t _rotozoom_lerp_ARGB(rt_uint32_t a, rt_uint32_t b, unsigned w)
+{
+    rt_uint32_t rb, ag;
+
+    rb = (((a & 0x00ff00ff) * (256 - w) + (b & 0x00ff00ff) * w) >> 8) & 0x00ff00ff;
+    ag = (((a >> 8) & 0x00ff00ff) * (256 - w) + ((b >> 8) & 0x00ff00ff) * w) & 0xff00ff00;
+
+    return rb | ag;
+}
+
+/*!
+\brief Bilinear interpolation of two spread RGB565 pixels, the weight range is 0~31.
+*/
+rt_inline rt_uint32_t _rotozoom_lerp_565(rt_uint32_t a, rt_uint32_t b, unsigned w)
+{
+    return ((a * (32 - w) + b * w) >> 5) & 0x07e0f81f;
+}
+
+#define _ROTOZOOM_SPREAD_565(p)   ((((rt_uint32_t)(p)) | ((rt_uint32_t)(p) << 16)) & 0x07e0f81f)
+
+/*
+ * Sample one span of the source until it goes out of the source. The u and v
+ * are the source coordinates in 16.16 fixed point, the du and dv are the steps
+ * of them on each destination pixel.
+ */
+#define _ROTOZOOM_SPAN(type, sample)                                            \
+do {                                                                            \
+    rt_uint32_t su = (rt_uint32_t)src->width << 16;                             \
+    rt_uint32_t sv = (rt_uint32_t)src->height << 16;                            \
+    type *sp, *dp = (type *)pixel;                                              \
+    int sx, sy;                                                                 \
+    for (n = 0; n < max; n ++, u += du, v += dv)                                \
+    {                                                                           \
+        if ((rt_uint32_t)u >= su || (rt_uint32_t)v >= sv) break;                \
+        sx = u >> 16;                                                           \
+        sy = v >> 16;                                                           \
+        sp = (type *)(src->pixel + sy * src->pitch) + sx;                       \
+        sample;                                                                 \
+    }                                                                           \
+} while (0)
+
+/*!
+\brief Bilinear sample of an ARGB8888 source pixel and its right and bottom neighbors.
+*/
+rt_inline rt_uint32_t _rotozoom_sample_ARGB(struct rtgui_dc_buffer *src, rt_uint32_t *sp,
+        int sx, int sy, int u, int v)
+{
+    unsigned ex = (u >> 8) & 0xff, ey = (v >> 8) & 0xff;
+    int ox = (sx < src->width - 1) ? 1 : 0;
+    rt_uint32_t *sp1 = (sy < src->height - 1) ? (rt_uint32_t *)((rt_uint8_t *)sp + src->pitch) : sp;
+
+    return _rotozoom_lerp_ARGB(_rotozoom_lerp_ARGB(sp[0], sp[ox], ex),
+                               _rotozoom_lerp_ARGB(sp1[0], sp1[ox], ex), ey);
+}
+
+/*!
+\brief Bilinear sample of a RGB565 source pixel and its right and bottom neighbors.
+*/
+rt_inline rt_uint16_t _rotozoom_sample_565(struct rtgui_dc_buffer *src, rt_uint16_t *sp,
+        int sx, int sy, int u, int v)
+{
+    unsigned ex = (u >> 11) & 0x1f, ey = (v >> 11) & 0x1f;
+    int ox = (sx < src->width - 1) ? 1 : 0;
+    rt_uint16_t *sp1 = (sy < src->height - 1) ? (rt_uint16_t *)((rt_uint8_t *)sp + src->pitch) : sp;
+    rt_uint32_t c;
+
+    c = _rotozoom_lerp_565(_rotozoom_lerp_565(_ROTOZOOM_SPREAD_565(sp[0]), _ROTOZOOM_SPREAD_565(sp[ox]), ex),
+                           _rotozoom_lerp_565(_ROTOZOOM_SPREAD_565(sp1[0]), _ROTOZOOM_SPREAD_565(sp1[ox]), ex), ey);
+
+    return (rt_uint16_t)(c | (c >> 16));
+}
+
+static int _rotozoom_span_ARGB(struct rtgui_dc_buffer *src, rt_uint8_t *pixel, int max,
+                               int u, int v, int du, int dv, int smooth)
+{
+    int n;
 
-    /*
-    * Switch between interpolating and non-interpolating code
-    */
     if (smooth)
+        _ROTOZOOM_SPAN(rt_uint32_t, dp[n] = _rotozoom_sample_ARGB(src, sp, sx, sy, u, v));
+    else
+        _ROTOZOOM_SPAN(rt_uint32_t, dp[n] = *sp);
+
+    return n;
+}
+
+static int _rotozoom_span_565(struct rtgui_dc_buffer *src, rt_uint8_t *pixel, int max,
+                              int u, int v, int du, int dv, int smooth)
+{
+    int n;
+
+    if (smooth)
+        _ROTOZOOM_SPAN(rt_uint16_t, dp[n] = _rotozoom_sample_565(src, sp, sx, sy, u, v));
+    else
+        _ROTOZOOM_SPAN(rt_uint16_t, dp[n] = *sp);
+
+    return n;
+}
+
+/*!
+\brief Internal fixed point rotozoomer which renders into a destination dc.
+
+Scans the destination rows covered by the rotated source, steps the source
+coordinates incrementally in 16.16 fixed point, and only touches the pixels
+which are inside the source. Supports RGB565 and ARGB8888 sources.
+The span is sampled straight into a buffer dc of the same format if it can
+be copied, otherwise into a line buffer which is blit onto the destination.
+
+\param src Source surface.
+\param dest Destination dc.
+\param cx Horizontal center coordinate on the destination.
+\param cy Vertical center coordinate on the destination.
+\param angle The angle to rotate in degrees, 16.16 fixed point.
+\param zoomx The horizontal zoom factor in 16.16 fixed point, negative to flip.
+\param zoomy The vertical zoom factor in 16.16 fixed point, negative to flip.
+\param smooth Flag indicating anti-aliasing should be used.
+\param copy Flag indicating the source pixels are copied without blending.
+
+\return 0 for success or -1 for error.
+*/
+static int _rtgui_dc_rotozoom_fixed(struct rtgui_dc_buffer *src, struct rtgui_dc *dest,
+                                    int cx, int cy, rt_int32_t angle,
+                                    rt_int32_t zoomx, rt_int32_t zoomy, int smooth, int copy)
+{
+    int x, y, n, halfw, halfh, bpp;
+    int u0, v0, du, dv, eu, ev;
+    rt_int32_t s, c;
+    rt_uint8_t *pixel;
+    rtgui_rect_t bound, rect;
+    struct rtgui_point line_point;
+    struct rtgui_dc_buffer *line = RT_NULL, *direct = RT_NULL;
+    int (*span)(struct rtgui_dc_buffer *src, rt_uint8_t *pixel, int max,
+                int u, int v, int du, int dv, int smooth);
+
+    if (src->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB888)
+        span = _rotozoom_span_ARGB;
+    else if (src->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+        span = _rotozoom_span_565;
+    else
+        return -1;
+    bpp = rtgui_color_get_bpp(src->pixel_format);
+
+    /* sanity check zoom factor */
+    if (zoomx > -FIXED_VALUE_LIMIT && zoomx < FIXED_VALUE_LIMIT)
+        zoomx = zoomx < 0 ? -FIXED_VALUE_LIMIT : FIXED_VALUE_LIMIT;
+    if (zoomy > -FIXED_VALUE_LIMIT && zoomy < FIXED_VALUE_LIMIT)
+        zoomy = zoomy < 0 ? -FIXED_VALUE_LIMIT : FIXED_VALUE_LIMIT;
+
+    s = _rtgui_fixed_sin(angle);
+    c = _rtgui_fixed_cos(angle);
+
+    /* the covered box on the destination */
+    _rtgui_dc_rotozoom_half_size(src->width, src->height, s, c, zoomx, zoomy, &halfw, &halfh);
+    bound.x1 = cx - halfw;
+    bound.y1 = cy - halfh;
+    bound.x2 = cx + halfw;
+    bound.y2 = cy + halfh;
+    rtgui_dc_get_rect(dest, &rect);
+    rtgui_rect_intersect(&rect, &bound);
+    if (rtgui_rect_is_empty(&bound)) return 0;
+    if (rtgui_dc_buffer_read_pixel(RTGUI_DC(src)) == RT_NULL) return -1;
+
+    /* the source steps on each destination column and row */
+    du = (int)(((int64_t)c << 16) / zoomx);
+    dv = (int)(((int64_t)s << 16) / zoomy);
+    eu = (int)(((int64_t)-s << 16) / zoomx);
+    ev = (int)(((int64_t)c << 16) / zoomy);
+
+    /* the source coordinate of the top left pixel */
+    u0 = (src->width << 15) + du * (bound.x1 - cx) + eu * (bound.y1 - cy);
+    v0 = (src->height << 15) + dv * (bound.x1 - cx) + ev * (bound.y1 - cy);
+
+    if (dest->type == RTGUI_DC_BUFFER &&
+        ((struct rtgui_dc_buffer *)dest)->pixel_format == src->pixel_format &&
+        (copy || src->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565))
     {
-        for (y = 0; y < dst->height; y++)
-        {
-            dy = cy - y;
-            sdx = (ax + (isin * dy)) + xd;
-            sdy = (ay - (icos * dy)) + yd;
-            for (x = 0; x < dst->width; x++)
-            {
-                dx = (sdx >> 16);
-                dy = (sdy >> 16);
-                if (flipx) dx = sw - dx;
-                if (flipy) dy = sh - dy;
-                if ((dx > -1) && (dy > -1) && (dx < (src->width-1)) && (dy < (src->height-1)))
-                {
-                    sp = (tColorRGBA *)src->pixel;;
-                    sp += ((src->pitch/4) * dy);
-                    sp += dx;
-                    c00 = *sp;
-                    sp += 1;
-                    c01 = *sp;
-                    sp += (src->pitch/4);
-                    c11 = *sp;
-                    sp -= 1;
-                    c10 = *sp;
-                    if (flipx)
-                    {
-                        cswap = c00;
-                        c00=c01;
-                        c01=cswap;
-                        cswap = c10;
-                        c10=c11;
-                        c11=cswap;
-                    }
-                    if (flipy)
-                    {
-                        cswap = c00;
-                        c00=c10;
-                        c10=cswap;
-                        cswap = c01;
-                        c01=c11;
-                        c11=cswap;
-                    }
-                    /*
-                    * Interpolate colors
-                    */
-                    ex = (sdx & 0xffff);
-                    ey = (sdy & 0xffff);
-                    t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-                    t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-                    pc->r = (((t2 - t1) * ey) >> 16) + t1;
-                    t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-                    t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-                    pc->g = (((t2 - t1) * ey) >> 16) + t1;
-                    t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-                    t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-                    pc->b = (((t2 - t1) * ey) >> 16) + t1;
-                    t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-                    t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-                    pc->a = (((t2 - t1) * ey) >> 16) + t1;
-                }
-                sdx += icos;
-                sdy += isin;
-                pc++;
-            }
-            pc = (tColorRGBA *) ((rt_uint8_t *) pc + gap);
-        }
+        direct = (struct rtgui_dc_buffer *)dest;
+        if (rtgui_dc_buffer_get_pixel(dest) == RT_NULL) return -1;
     }
     else
     {
-        for (y = 0; y < dst->height; y++)
+        line = (struct rtgui_dc_buffer *)rtgui_dc_buffer_create_pixformat(src->pixel_format,
+                rtgui_rect_width(bound), 1);
+        if (line == RT_NULL) return -1;
+    }
+    line_point.x = line_point.y = 0;
+
+    for (y = bound.y1; y < bound.y2; y ++, u0 += eu, v0 += ev)
+    {
+        int u = u0, v = v0;
+
+        /* skip the pixels outside of source, the rotated box is convex */
+        for (x = bound.x1; x < bound.x2; x ++, u += du, v += dv)
         {
-            dy = cy - y;
-            sdx = (ax + (isin * dy)) + xd;
-            sdy = (ay - (icos * dy)) + yd;
-            for (x = 0; x < dst->width; x++)
-            {
-                dx = (short) (sdx >> 16);
-                dy = (short) (sdy >> 16);
-                if (flipx) dx = (src->width-1)-dx;
-                if (flipy) dy = (src->height-1)-dy;
-                if ((dx >= 0) && (dy >= 0) && (dx < src->width) && (dy < src->height))
-                {
-                    sp = (tColorRGBA *) ((rt_uint8_t *) src->pixel + src->pitch * dy);
-                    sp += dx;
-                    *pc = *sp;
-                }
-                sdx += icos;
-                sdy += isin;
-                pc++;
-            }
-            pc = (tColorRGBA *) ((rt_uint8_t *) pc + gap);
+            if ((rt_uint32_t)u < ((rt_uint32_t)src->width << 16) &&
+                (rt_uint32_t)v < ((rt_uint32_t)src->height << 16))
+                break;
+        }
+        if (x == bound.x2) continue;
+
+        if (direct)
+            pixel = direct->pixel + y * direct->pitch + x * bpp;
+        else
+            pixel = line->pixel;
+
+        n = span(src, pixel, bound.x2 - x, u, v, du, dv, smooth);
+        if (line && n > 0)
+        {
+            rtgui_rect_t line_rect;
+
+            line_rect.x1 = x;
+            line_rect.y1 = y;
+            line_rect.x2 = x + n;
+            line_rect.y2 = y + 1;
+            rtgui_dc_blit(RTGUI_DC(line), &line_point, dest, &line_rect);
         }
     }
 
+    if (line) rtgui_dc_destory(RTGUI_DC(line));
+
     return 0;
 }
 
@@ -625,6 +802,7 @@ struct rtgui_dc* rtgui_dc_rotate_90degrees(struct rtgui_dc_buffer* src, int numC
     if (src == RT_NULL) return RT_NULL;
     /* we only support 32bit */
     if (rtgui_color_get_bits(src->pixel_format) != 32) return RT_NULL;
+    if (rtgui_dc_buffer_read_pixel(RTGUI_DC(src)) == RT_NULL) return RT_NULL;
 
     /* normalize numClockwiseTurns */
     while(numClockwiseTurns < 0)
@@ -809,9 +987,8 @@ struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoo
 {
     struct rtgui_dc_buffer *rz_src;
     struct rtgui_dc_buffer *rz_dst;
-    double zoominv;
-    double sanglezoom, canglezoom, sanglezoominv, canglezoominv;
-    int dstwidthhalf, dstwidth, dstheighthalf, dstheight;
+    rt_int32_t fangle, fzoomx, fzoomy;
+    int dstwidth, dstheight;
     int flipx,flipy;
     int result;
 
@@ -820,8 +997,7 @@ struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoo
     */
     rz_src = (struct rtgui_dc_buffer*)(dc);
     if (rz_src == RT_NULL) return (RT_NULL);
-    /* we only support 32bit */
-    if (rtgui_color_get_bits(rz_src->pixel_format) != 32) return RT_NULL;
+    if (rtgui_dc_buffer_read_pixel(dc) == RT_NULL) return (RT_NULL);
 
     /*
     * Sanity check zoom factor
@@ -832,7 +1008,6 @@ struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoo
     if (flipy) zoomy=-zoomy;
     if (zoomx < VALUE_LIMIT) zoomx = VALUE_LIMIT;
     if (zoomy < VALUE_LIMIT) zoomy = VALUE_LIMIT;
-    zoominv = 65536.0 / (zoomx * zoomx);
 
     /*
     * Check if we have a rotozoom or just a zoom
@@ -840,42 +1015,31 @@ struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoo
     if (fabs(angle) > VALUE_LIMIT)
     {
         /*
-        * Angle!=0: full rotozoom
-        */
-        /*
-        * -----------------------
+        * Angle!=0: full rotozoom with the fixed point engine
         */
+        fangle = (rt_int32_t)(fmod(angle, 360.0) * 65536.0);
+        fzoomx = (rt_int32_t)(zoomx * 65536.0);
+        fzoomy = (rt_int32_t)(zoomy * 65536.0);
+        if (flipx) fzoomx = -fzoomx;
+        if (flipy) fzoomy = -fzoomy;
 
         /* Determine target size */
-        _rtgui_dc_rotozoom_size(rz_src->width, rz_src->height, angle, zoomx, zoomy, &dstwidth, &dstheight, &canglezoom, &sanglezoom);
-
-        /*
-        * Calculate target factors from sin/cos and zoom
-        */
-        sanglezoominv = sanglezoom;
-        canglezoominv = canglezoom;
-        sanglezoominv *= zoominv;
-        canglezoominv *= zoominv;
-
-        /* Calculate half size */
-        dstwidthhalf = dstwidth / 2;
-        dstheighthalf = dstheight / 2;
+        rtgui_dc_rotozoom_size_fixed(rz_src->width, rz_src->height, fangle, fzoomx, fzoomy,
+                                     &dstwidth, &dstheight);
 
         /*
         * Alloc space to completely contain the rotated surface
         */
-        rz_dst = (struct rtgui_dc_buffer*)rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888,
+        rz_dst = (struct rtgui_dc_buffer*)rtgui_dc_buffer_create_pixformat(rz_src->pixel_format,
                  dstwidth, dstheight + GUARD_ROWS);
         /* Check target */
         if (rz_dst == RT_NULL)return RT_NULL;
 
         /*
-        * Call the 32bit transformation routine to do the rotation (using alpha)
+        * Copy the rotated pixels into the new surface
         */
-        result = _rtgui_dc_transform_RGBA(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
-                                          (int) (sanglezoominv), (int) (canglezoominv),
-                                          flipx, flipy,
-                                          smooth);
+        result = _rtgui_dc_rotozoom_fixed(rz_src, RTGUI_DC(rz_dst), dstwidth / 2, dstheight / 2,
+                                          fangle, fzoomx, fzoomy, smooth, 1);
         if (result != 0)
         {
             rtgui_dc_destory(RTGUI_DC(rz_dst));
@@ -887,6 +1051,8 @@ struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoo
         /*
         * Angle=0: Just a zoom
         */
+        /* we only support 32bit */
+        if (rtgui_color_get_bits(rz_src->pixel_format) != 32) return RT_NULL;
 
         /*
         * Calculate target size
@@ -918,6 +1084,76 @@ struct rtgui_dc *rtgui_dc_rotozoom(struct rtgui_dc *dc, double angle, double zoo
     return RTGUI_DC(rz_dst);
 }
 RTM_EXPORT(rtgui_dc_rotozoom);
+
+/*!
+\brief Returns the size of the target surface for a fixed point rotozoom.
+
+\param width The source surface width.
+\param height The source surface height.
+\param angle The angle to rotate in degrees, 16.16 fixed point.
+\param zoomx The horizontal zoom factor in 16.16 fixed point.
+\param zoomy The vertical zoom factor in 16.16 fixed point.
+\param dstwidth The calculated width of the rotozoomed destination surface.
+\param dstheight The calculated height of the rotozoomed destination surface.
+*/
+void rtgui_dc_rotozoom_size_fixed(int width, int height, rt_int32_t angle,
+                                  rt_int32_t zoomx, rt_int32_t zoomy,
+                                  int *dstwidth, int *dstheight)
+{
+    int halfw, halfh;
+
+    _rtgui_dc_rotozoom_half_size(width, height, _rtgui_fixed_sin(angle), _rtgui_fixed_cos(angle),
+                                 zoomx, zoomy, &halfw, &halfh);
+    *dstwidth = 2 * halfw;
+    *dstheight = 2 * halfh;
+}
+RTM_EXPORT(rtgui_dc_rotozoom_size_fixed);
+
+/*!
+\brief Rotates and zooms a buffer dc directly onto a destination dc in fixed point.
+
+Renders the RGB565 or ARGB8888 'dc' rotated around its center onto 'dest',
+with the center placed at 'center' of the destination. No intermediate
+surface is allocated and only the destination pixels covered by the
+rotated source are touched. The pixel alpha of ARGB8888 source is blended
+onto the destination.
+
+\param dc The buffer dc to rotozoom.
+\param dest The destination dc.
+\param center The center point on the destination, RT_NULL for the center of it.
+\param angle The angle to rotate in degrees, 16.16 fixed point.
+\param zoomx The horizontal zoom factor in 16.16 fixed point, negative to flip.
+\param zoomy The vertical zoom factor in 16.16 fixed point, negative to flip.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+
+\return 0 for success or -1 for error.
+*/
+int rtgui_dc_rotozoom_blit(struct rtgui_dc *dc, struct rtgui_dc *dest, struct rtgui_point *center,
+                           rt_int32_t angle, rt_int32_t zoomx, rt_int32_t zoomy, int smooth)
+{
+    int cx, cy;
+
+    if (dc == RT_NULL || dest == RT_NULL || dc->type != RTGUI_DC_BUFFER) return -1;
+    if (rtgui_dc_get_visible(dest) == RT_FALSE) return 0;
+
+    if (center == RT_NULL)
+    {
+        rtgui_rect_t rect;
+
+        rtgui_dc_get_rect(dest, &rect);
+        cx = (rect.x1 + rect.x2) / 2;
+        cy = (rect.y1 + rect.y2) / 2;
+    }
+    else
+    {
+        cx = center->x;
+        cy = center->y;
+    }
+
+    return _rtgui_dc_rotozoom_fixed((struct rtgui_dc_buffer *)dc, dest, cx, cy,
+                                    angle, zoomx, zoomy, smooth, 0);
+}
+RTM_EXPORT(rtgui_dc_rotozoom_blit);
 /*!
 \brief Calculates the size of the target surface for a rtgui_dc_zoom() call.
 
@@ -996,6 +1232,7 @@ struct rtgui_dc *rtgui_dc_zoom(struct rtgui_dc *dc, double zoomx, double zoomy,
     rz_src = (struct rtgui_dc_buffer*)(dc);
     /* we only support 32bit */
     if (rtgui_color_get_bits(rz_src->pixel_format) != 32) return RT_NULL;
+    if (rtgui_dc_buffer_read_pixel(dc) == RT_NULL) return RT_NULL;
 
     flipx = (zoomx<0.0);
     if (flipx) zoomx = -zoomx;
@@ -1058,6 +1295,7 @@ struct rtgui_dc *rtgui_dc_shrink(struct rtgui_dc *dc, int factorx, int factory)
     rz_src = (struct rtgui_dc_buffer*)(dc);
     /* we only support 32bit */
     if (rtgui_color_get_bits(rz_src->pixel_format) != 32) return RT_NULL;
+    if (rtgui_dc_buffer_read_pixel(dc) == RT_NULL) return RT_NULL;
 
     /* Get size for target */
     dstwidth=rz_src->width/factorx;
@@ -0,0 +1,435 @@
+/*
+ * File      : dc_shape.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/dc_path.h>
+#include <rtgui/rtgui_system.h>
+
+/* the contour of round rect in fixed point, clockwise */
+static void _shape_round_rect(struct rtgui_path *path, int x1, int y1, int x2, int y2, int r)
+{
+    rtgui_path_arc(path, x1 + r, y1 + r, r, 180, 270);
+    rtgui_path_arc(path, x2 - r, y1 + r, r, 270, 360);
+    rtgui_path_arc(path, x2 - r, y2 - r, r, 0, 90);
+    rtgui_path_arc(path, x1 + r, y2 - r, r, 90, 180);
+    rtgui_path_close(path);
+}
+
+/* rasterize the shape in the rect of dc with foreground */
+static void _shape_draw(struct rtgui_dc *dc, enum rtgui_shape_type type, int x, int y,
+                        int w, int h, int radius, int stroke)
+{
+    int x1, y1, x2, y2, r, inset;
+    struct rtgui_path *path;
+
+    if (w <= 0 || h <= 0)
+        return;
+    if (radius > w / 2) radius = w / 2;
+    if (radius > h / 2) radius = h / 2;
+
+    path = rtgui_path_create(64);
+    if (path == RT_NULL)
+        return;
+
+    x1 = RTGUI_PATH_FIXED(x);
+    y1 = RTGUI_PATH_FIXED(y);
+    x2 = RTGUI_PATH_FIXED(x + w);
+    y2 = RTGUI_PATH_FIXED(y + h);
+    r = RTGUI_PATH_FIXED(radius);
+    inset = RTGUI_PATH_FIXED(stroke);
+
+    switch (type)
+    {
+    case RTGUI_SHAPE_ROUND_RECT:
+    case RTGUI_SHAPE_SHADOW:
+        _shape_round_rect(path, x1, y1, x2, y2, r);
+        break;
+    case RTGUI_SHAPE_ROUND_FRAME:
+        _shape_round_rect(path, x1, y1, x2, y2, r);
+        if (2 * stroke < w && 2 * stroke < h)
+            _shape_round_rect(path, x1 + inset, y1 + inset, x2 - inset, y2 - inset,
+                              r > inset ? r - inset : 0);
+        break;
+    case RTGUI_SHAPE_CIRCLE:
+    case RTGUI_SHAPE_RING:
+        /* the circle in the rect, the pixels of diameter are included */
+        r = (w < h ? w : h) * RTGUI_PATH_ONE / 2;
+        rtgui_path_arc(path, (x1 + x2) / 2, (y1 + y2) / 2, r, 0, 360);
+        rtgui_path_close(path);
+        if (type == RTGUI_SHAPE_RING && inset < r)
+        {
+            rtgui_path_arc(path, (x1 + x2) / 2, (y1 + y2) / 2, r - inset, 0, 360);
+            rtgui_path_close(path);
+        }
+        break;
+    }
+    rtgui_dc_fill_path(dc, path, RTGUI_PATH_EVENODD);
+
+    rtgui_path_destroy(path);
+}
+
+/*
+ * The mask of shape. The shadow is the round rect inside of the rect by the
+ * stroke, blurred in 3 boxes of stroke / 3 to the edge of rect.
+ */
+static struct rtgui_dc *_shape_mask_create(enum rtgui_shape_type type, int w, int h,
+                                           int radius, int stroke)
+{
+    struct rtgui_dc *mask;
+
+    mask = rtgui_dc_mask_create(w, h);
+    if (mask == RT_NULL)
+        return RT_NULL;
+
+    if (type == RTGUI_SHAPE_SHADOW)
+    {
+        _shape_draw(mask, type, stroke, stroke, w - 2 * stroke, h - 2 * stroke, radius, 0);
+        rtgui_dc_mask_blur(mask, (stroke + 2) / 3, 3);
+    }
+    else
+    {
+        _shape_draw(mask, type, 0, 0, w, h, radius, stroke);
+    }
+
+    return mask;
+}
+
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+/*
+ * The masks of shapes in the order of use, the least recently used is at the
+ * tail. A shape is rasterized to its A8 mask once, and then each paint of it
+ * is a blit of the mask.
+ */
+struct rtgui_shape_item
+{
+    rt_list_t list;
+
+    rt_uint8_t type;
+    rt_int16_t w, h;
+    rt_int16_t radius, stroke;
+
+    struct rtgui_dc *mask;
+#ifdef GUIENGINE_USING_TEXT_CACHE
+    /* the key of text, which is after the item */
+    struct rtgui_font *font;
+    rt_uint32_t hash;
+    const char *text;
+#endif
+};
+
+static rt_list_t _shape_list = RT_LIST_OBJECT_INIT(_shape_list);
+static struct rt_mutex _shape_lock;
+/* the bytes of all the masks */
+static rt_uint32_t _shape_size = 0;
+
+#define _shape_item_size(item)  ((rt_uint32_t)(item)->w * (item)->h)
+
+int rtgui_dc_shape_init(void)
+{
+    return rt_mutex_init(&_shape_lock, "shape", RT_IPC_FLAG_FIFO);
+}
+
+static void _shape_item_destroy(struct rtgui_shape_item *item)
+{
+    rt_list_remove(&item->list);
+    _shape_size -= _shape_item_size(item);
+    rtgui_dc_destory(item->mask);
+    rtgui_free(item);
+}
+
+/* make room for the new mask from the least recently used ones */
+static void _shape_item_insert(struct rtgui_shape_item *item)
+{
+    while (_shape_size + _shape_item_size(item) > GUIENGINE_SHAPE_CACHE_BUDGET &&
+            !rt_list_isempty(&_shape_list))
+    {
+        _shape_item_destroy(rt_list_entry(_shape_list.prev, struct rtgui_shape_item, list));
+    }
+    rt_list_insert_after(&_shape_list, &item->list);
+    _shape_size += _shape_item_size(item);
+}
+
+static struct rtgui_shape_item *_shape_item_get(enum rtgui_shape_type type, int w, int h,
+                                                int radius, int stroke)
+{
+    struct rtgui_shape_item *item;
+    rt_list_t *node;
+
+    rt_list_for_each(node, &_shape_list)
+    {
+        item = rt_list_entry(node, struct rtgui_shape_item, list);
+        if (item->type == type && item->w == w && item->h == h &&
+                item->radius == radius && item->stroke == stroke)
+        {
+            /* move to the head, as the most recently used */
+            rt_list_remove(&item->list);
+            rt_list_insert_after(&_shape_list, &item->list);
+            return item;
+        }
+    }
+
+    /* the mask larger than the budget is not cached */
+    if ((rt_uint32_t)w * h > GUIENGINE_SHAPE_CACHE_BUDGET)
+        return RT_NULL;
+
+    item = (struct rtgui_shape_item *)rtgui_malloc(sizeof(struct rtgui_shape_item));
+    if (item == RT_NULL)
+        return RT_NULL;
+    item->mask = _shape_mask_create(type, w, h, radius, stroke);
+    if (item->mask == RT_NULL)
+    {
+        rtgui_free(item);
+        return RT_NULL;
+    }
+    item->type = type;
+    item->w = w;
+    item->h = h;
+    item->radius = radius;
+    item->stroke = stroke;
+#ifdef GUIENGINE_USING_TEXT_CACHE
+    item->font = RT_NULL;
+#endif
+    _shape_item_insert(item);
+
+    return item;
+}
+
+/* destroy all the masks, such as the theme is changed */
+void rtgui_dc_shape_cache_flush(void)
+{
+    rt_mutex_take(&_shape_lock, RT_WAITING_FOREVER);
+    while (!rt_list_isempty(&_shape_list))
+        _shape_item_destroy(rt_list_entry(_shape_list.next, struct rtgui_shape_item, list));
+    rt_mutex_release(&_shape_lock);
+}
+RTM_EXPORT(rtgui_dc_shape_cache_flush);
+#endif
+
+/*
+ * Fill the AA shape in the rect with foreground. The radius is the corners
+ * of round rect, and the stroke is the width of frame or ring, or the blur of
+ * shadow. The circle and ring are in the rect. With GUIENGINE_USING_SHAPE_CACHE,
+ * the mask of the same shape is kept and the fill is one blit of it.
+ */
+void rtgui_dc_fill_shape(struct rtgui_dc *dc, enum rtgui_shape_type type, rtgui_rect_t *rect,
+                         int radius, int stroke)
+{
+    int w, h;
+    struct rtgui_dc *mask;
+    rtgui_point_t point;
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+    struct rtgui_shape_item *item;
+#endif
+
+    RT_ASSERT(dc != RT_NULL && rect != RT_NULL);
+
+    w = rtgui_rect_width(*rect);
+    h = rtgui_rect_height(*rect);
+    if (w <= 0 || h <= 0)
+        return;
+    if (radius > w / 2) radius = w / 2;
+    if (radius > h / 2) radius = h / 2;
+    if (radius < 0) radius = 0;
+    if (!rtgui_dc_get_visible(dc))
+        return;
+
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+    /* the mask itself is rasterized directly */
+    if (rtgui_dc_get_pixel_format(dc) != RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+    {
+        rt_mutex_take(&_shape_lock, RT_WAITING_FOREVER);
+        item = _shape_item_get(type, w, h, radius, stroke);
+        if (item != RT_NULL)
+        {
+            point = rtgui_empty_point;
+            rtgui_dc_mask_fill(item->mask, &point, dc, rect, RTGUI_DC_FC(dc));
+        }
+        rt_mutex_release(&_shape_lock);
+
+        if (item != RT_NULL)
+            return;
+    }
+#endif
+
+    if (type == RTGUI_SHAPE_SHADOW)
+    {
+        /* the blur is only on a mask */
+        mask = _shape_mask_create(type, w, h, radius, stroke);
+        if (mask != RT_NULL)
+        {
+            point = rtgui_empty_point;
+            rtgui_dc_mask_fill(mask, &point, dc, rect, RTGUI_DC_FC(dc));
+            rtgui_dc_destory(mask);
+        }
+        return;
+    }
+
+    _shape_draw(dc, type, rect->x1, rect->y1, w, h, radius, stroke);
+}
+RTM_EXPORT(rtgui_dc_fill_shape);
+
+#ifdef GUIENGINE_USING_TEXT_CACHE
+/* the type of the text items, not a shape */
+#define _SHAPE_TEXT     0xFF
+
+static rt_uint32_t _text_hash(const char *text)
+{
+    rt_uint32_t hash = 5381;
+
+    while (*text)
+        hash = hash * 33 + (rt_uint8_t)*text ++;
+
+    return hash;
+}
+
+static struct rtgui_shape_item *_text_item_get(struct rtgui_font *font, rt_uint16_t style,
+                                               const char *text, int len, int w, int h)
+{
+    rt_uint32_t hash;
+    rt_list_t *node;
+    rtgui_rect_t rect;
+    struct rtgui_shape_item *item;
+
+    hash = _text_hash(text);
+    rt_list_for_each(node, &_shape_list)
+    {
+        item = rt_list_entry(node, struct rtgui_shape_item, list);
+        if (item->type == _SHAPE_TEXT && item->font == font && item->hash == hash &&
+                item->stroke == style && rt_strcmp(item->text, text) == 0)
+        {
+            rt_list_remove(&item->list);
+            rt_list_insert_after(&_shape_list, &item->list);
+            return item;
+        }
+    }
+
+    if ((rt_uint32_t)w * h > GUIENGINE_SHAPE_CACHE_BUDGET)
+        return RT_NULL;
+
+    item = (struct rtgui_shape_item *)rtgui_malloc(sizeof(struct rtgui_shape_item) + len + 1);
+    if (item == RT_NULL)
+        return RT_NULL;
+    item->mask = rtgui_dc_mask_create(w, h);
+    if (item->mask == RT_NULL)
+    {
+        rtgui_free(item);
+        return RT_NULL;
+    }
+
+    /* the glyphs are rendered once in the coverage of mask */
+    RTGUI_DC_FONT(item->mask) = font;
+    rtgui_dc_get_gc(item->mask)->textstyle = style;
+    RTGUI_DC_TEXTALIGN(item->mask) = RTGUI_ALIGN_LEFT | RTGUI_ALIGN_TOP;
+    rtgui_rect_init(&rect, 0, 0, w, h);
+    rtgui_font_draw(font, item->mask, text, len, &rect);
+
+    item->type = _SHAPE_TEXT;
+    item->w = w;
+    item->h = h;
+    item->radius = 0;
+    item->stroke = style;
+    item->font = font;
+    item->hash = hash;
+    item->text = (const char *)(item + 1);
+    rt_memcpy(item + 1, text, len + 1);
+    _shape_item_insert(item);
+
+    return item;
+}
+
+void rtgui_dc_text_cache_remove(struct rtgui_font *font)
+{
+    rt_list_t *node, *next;
+    struct rtgui_shape_item *item;
+
+    rt_mutex_take(&_shape_lock, RT_WAITING_FOREVER);
+    for (node = _shape_list.next; node != &_shape_list; node = next)
+    {
+        next = node->next;
+        item = rt_list_entry(node, struct rtgui_shape_item, list);
+        if (item->type == _SHAPE_TEXT && item->font == font)
+            _shape_item_destroy(item);
+    }
+    rt_mutex_release(&_shape_lock);
+}
+RTM_EXPORT(rtgui_dc_text_cache_remove);
+#endif
+
+void rtgui_dc_draw_text_cached(struct rtgui_dc *dc, const char *text, struct rtgui_rect *rect)
+{
+#ifdef GUIENGINE_USING_TEXT_CACHE
+    int len;
+    rtgui_rect_t text_rect;
+    rtgui_point_t point;
+    struct rtgui_font *font;
+    struct rtgui_shape_item *item;
+
+    RT_ASSERT(dc != RT_NULL);
+
+    len = rt_strlen(text);
+    if (len == 0)
+        return;
+    font = RTGUI_DC_FONT(dc);
+    if (font == RT_NULL)
+        font = rtgui_font_default();
+
+    /* the mask itself, a long text which is likely to change, or the styles
+     * in the background or shadow color, which are not in the coverage */
+    if (len > GUIENGINE_TEXT_CACHE_MAX || font == RT_NULL ||
+            (rtgui_dc_get_gc(dc)->textstyle & (RTGUI_TEXTSTYLE_DRAW_BACKGROUND | RTGUI_TEXTSTYLE_SHADOW |
+                                               RTGUI_TEXTSTYLE_ROTATE_MASK)) ||
+            rtgui_dc_get_pixel_format(dc) == RTGRAPHIC_PIXEL_FORMAT_ALPHA)
+    {
+        rtgui_dc_draw_text(dc, text, rect);
+        return;
+    }
+    if (!rtgui_dc_get_visible(dc))
+        return;
+
+    rtgui_font_get_metrics(font, text, &text_rect);
+    if (text_rect.x2 <= text_rect.x1 || text_rect.y2 <= text_rect.y1)
+        return;
+
+    rt_mutex_take(&_shape_lock, RT_WAITING_FOREVER);
+    item = _text_item_get(font, rtgui_dc_get_gc(dc)->textstyle, text, len,
+                          rtgui_rect_width(text_rect), rtgui_rect_height(text_rect));
+    if (item != RT_NULL)
+    {
+        /* the mask in the alignment of the text drawn directly */
+        rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
+        point = rtgui_empty_point;
+        rtgui_dc_mask_fill(item->mask, &point, dc, &text_rect, RTGUI_DC_FC(dc));
+    }
+    rt_mutex_release(&_shape_lock);
+
+    if (item == RT_NULL)
+        rtgui_dc_draw_text(dc, text, rect);
+#else
+    rtgui_dc_draw_text(dc, text, rect);
+#endif
+}
+RTM_EXPORT(rtgui_dc_draw_text_cached);
@@ -22,6 +22,8 @@
  * 2014-03-15     Grissom      The first version
  */
 
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
 #include <rtgui/rtgui.h>
 #include <rtgui/rtgui_system.h>
 #include <rtgui/dc.h>
@@ -32,8 +34,19 @@ struct rtgui_dc_trans
     struct rtgui_matrix m;
     struct rtgui_dc *owner;
     int use_aa;
+
+    /* the inverse matrix and the new size are cached until the matrix changes */
+    struct rtgui_matrix invm;
+    int neww, newh;
+    rt_bool_t invertible;
+    rt_bool_t dirty;
+
+    /* the box of the visible pixels in owner, only sampled inside it */
+    struct rtgui_rect bound;
 };
 
+static void _rtgui_dc_trans_update(struct rtgui_dc_trans *dct);
+
 struct rtgui_dc_trans* rtgui_dc_trans_create(struct rtgui_dc *owner)
 {
     struct rtgui_dc_trans *dct;
@@ -45,6 +58,8 @@ struct rtgui_dc_trans* rtgui_dc_trans_create(struct rtgui_dc *owner)
     rtgu_matrix_identity(&dct->m);
     dct->owner  = owner;
     dct->use_aa = 0;
+    dct->dirty  = RT_TRUE;
+    rtgui_dc_get_rect(owner, &dct->bound);
 
     return dct;
 }
@@ -69,6 +84,7 @@ void rtgui_dc_trans_rotate(struct rtgui_dc_trans *dct, double degree)
     RT_ASSERT(dct);
 
     rtgui_matrix_rotate(&dct->m, degree * RTGUI_MATRIX_FRAC / 360.0);
+    dct->dirty = RT_TRUE;
 }
 RTM_EXPORT(rtgui_dc_trans_rotate);
 
@@ -79,6 +95,7 @@ void rtgui_dc_trans_scale(struct rtgui_dc_trans *dct,
     RT_ASSERT(dct);
 
     rtgui_matrix_scale(&dct->m, sx * RTGUI_MATRIX_FRAC, sy * RTGUI_MATRIX_FRAC);
+    dct->dirty = RT_TRUE;
 }
 RTM_EXPORT(rtgui_dc_trans_scale);
 
@@ -89,20 +106,53 @@ void rtgui_dc_trans_move(struct rtgui_dc_trans *dct,
     RT_ASSERT(dct);
 
     rtgui_matrix_move(&dct->m, dx, dy);
+    dct->dirty = RT_TRUE;
 }
 RTM_EXPORT(rtgui_dc_trans_move);
 
-void rtgui_dc_trans_get_new_wh(struct rtgui_dc_trans *dct,
-                               int *new_wp,
-                               int *new_hp)
+void rtgui_dc_trans_update_bound(struct rtgui_dc_trans *dct)
 {
-    struct rtgui_rect rect;
-    struct rtgui_point topleft, topright, bottomright;
+    struct rtgui_dc_buffer *buffer;
+    rt_uint32_t *pixel;
+    int x, y;
 
     RT_ASSERT(dct);
 
-    if (!new_wp && !new_hp)
+    rtgui_dc_get_rect(dct->owner, &dct->bound);
+    if (dct->owner->type != RTGUI_DC_BUFFER)
         return;
+    buffer = (struct rtgui_dc_buffer*)dct->owner;
+    if (buffer->pixel_format != RTGRAPHIC_PIXEL_FORMAT_ARGB888 ||
+            rtgui_dc_buffer_read_pixel(dct->owner) == RT_NULL)
+        return;
+
+    /* shrink the bound to the pixels which are not fully transparent */
+    dct->bound.x1 = buffer->width;
+    dct->bound.y1 = buffer->height;
+    dct->bound.x2 = dct->bound.y2 = 0;
+    for (y = 0; y < buffer->height; y++)
+    {
+        pixel = (rt_uint32_t*)(buffer->pixel + y * buffer->pitch);
+        for (x = 0; x < buffer->width; x++)
+        {
+            if ((pixel[x] >> 24) == 0)
+                continue;
+
+            if (x < dct->bound.x1) dct->bound.x1 = x;
+            if (x >= dct->bound.x2) dct->bound.x2 = x + 1;
+            if (y < dct->bound.y1) dct->bound.y1 = y;
+            dct->bound.y2 = y + 1;
+        }
+    }
+}
+RTM_EXPORT(rtgui_dc_trans_update_bound);
+
+static void _rtgui_dc_trans_new_wh(struct rtgui_dc_trans *dct,
+                                   int *new_wp,
+                                   int *new_hp)
+{
+    struct rtgui_rect rect;
+    struct rtgui_point topleft, topright, bottomright;
 
     rtgui_dc_get_rect(dct->owner, &rect);
 
@@ -119,7 +169,6 @@ void rtgui_dc_trans_get_new_wh(struct rtgui_dc_trans *dct,
     /* Transform result of (0, 0) is always (0, 0). */
 
 #define NORMALIZE(x) do { if (x < 0) x = 0; } while (0)
-    if (new_wp)
     {
         int neww;
 
@@ -134,7 +183,6 @@ void rtgui_dc_trans_get_new_wh(struct rtgui_dc_trans *dct,
 
         *new_wp = neww;
     }
-    if (new_hp)
     {
         int newh;
 
@@ -150,6 +198,33 @@ void rtgui_dc_trans_get_new_wh(struct rtgui_dc_trans *dct,
     }
 #undef NORMALIZE
 }
+
+/* update the cached inverse matrix and new size if the matrix changed */
+static void _rtgui_dc_trans_update(struct rtgui_dc_trans *dct)
+{
+    if (!dct->dirty)
+        return;
+
+    _rtgui_dc_trans_new_wh(dct, &dct->neww, &dct->newh);
+    dct->invertible = rtgui_matrix_inverse(&dct->m, &dct->invm) == 0;
+    dct->dirty = RT_FALSE;
+}
+
+void rtgui_dc_trans_get_new_wh(struct rtgui_dc_trans *dct,
+                               int *new_wp,
+                               int *new_hp)
+{
+    RT_ASSERT(dct);
+
+    if (!new_wp && !new_hp)
+        return;
+
+    _rtgui_dc_trans_update(dct);
+    if (new_wp)
+        *new_wp = dct->neww;
+    if (new_hp)
+        *new_hp = dct->newh;
+}
 RTM_EXPORT(rtgui_dc_trans_get_new_wh);
 
 struct _fb_rect
@@ -159,8 +234,110 @@ struct _fb_rect
     rt_uint16_t width, height;
     /* unit: pixel */
     rt_uint16_t skip;
+    /* the box of visible pixels, only used in source */
+    const struct rtgui_rect *bound;
+};
+
+/* The scanline walker. The source coordinate of each pixel is stepped from
+ * the start point of the scanline, and the scanline is clipped to the source
+ * box before sampling, so the loops have no bound checking. */
+struct _trans_scanline
+{
+    /* The source coordinate of the first pixel. */
+    int bx, by;
+    /* Delta of bx/by when nx++ and ny++. */
+    int dx, dy, rdx, rdy;
+    /* The pixels on the scanline. */
+    int width;
 };
 
+rt_inline int _trans_floor_div(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/* Narrow [*lo, *hi) to the k which makes min <= b + k * d < max. */
+static void _trans_range(int b, int d, int min, int max, int *lo, int *hi)
+{
+    int k0, k1;
+
+    if (d == 0)
+    {
+        if (b < min || b >= max)
+            *hi = *lo;
+        return;
+    }
+
+    if (d > 0)
+    {
+        k0 = -_trans_floor_div(b - min, d);
+        k1 = _trans_floor_div(max - 1 - b, d);
+    }
+    else
+    {
+        k0 = -_trans_floor_div(max - 1 - b, -d);
+        k1 = _trans_floor_div(b - min, -d);
+    }
+
+    if (*lo < k0)
+        *lo = k0;
+    if (*hi > k1 + 1)
+        *hi = k1 + 1;
+    if (*hi < *lo)
+        *hi = *lo;
+}
+
+static void _trans_scanline_init(struct _trans_scanline *line,
+                                 const struct rtgui_point *dc_point,
+                                 const struct _fb_rect *dst,
+                                 const struct rtgui_matrix *invm)
+{
+    line->dx  = invm->m[0];
+    line->dy  = invm->m[1];
+    line->rdx = invm->m[2];
+    line->rdy = invm->m[3];
+
+    /* The first pixel is stepped once from the base point. */
+    line->bx = (dc_point->x + 1) * line->dx + dc_point->y * line->rdx + RTGUI_MATRIX_FRAC * invm->m[4];
+    line->by = (dc_point->x + 1) * line->dy + dc_point->y * line->rdy + RTGUI_MATRIX_FRAC * invm->m[5];
+    line->width = dst->width - dc_point->x;
+}
+
+/* Clip the scanline to the source bound. With @aa, the neighbors of the
+ * bound are sampled too, and the last column and row of the source are left
+ * out for the interpolation. Return the pixels inside and the offset of the
+ * first one in @start. */
+static int _trans_scanline_clip(const struct _trans_scanline *line,
+                                const struct _fb_rect *src, int aa,
+                                int *bx, int *by, int *start)
+{
+    int lo = 0, hi = line->width;
+    struct rtgui_rect b = *src->bound;
+
+    if (aa)
+    {
+        if (b.x1 > 0) b.x1 --;
+        if (b.y1 > 0) b.y1 --;
+        if (b.x2 > src->width - 1) b.x2 = src->width - 1;
+        if (b.y2 > src->height - 1) b.y2 = src->height - 1;
+    }
+
+    _trans_range(line->bx, line->dx, b.x1 * RTGUI_MATRIX_FRAC, b.x2 * RTGUI_MATRIX_FRAC, &lo, &hi);
+    _trans_range(line->by, line->dy, b.y1 * RTGUI_MATRIX_FRAC, b.y2 * RTGUI_MATRIX_FRAC, &lo, &hi);
+
+    *start = lo;
+    *bx = line->bx + lo * line->dx;
+    *by = line->by + lo * line->dy;
+
+    return hi - lo;
+}
+
+rt_inline void _trans_scanline_next(struct _trans_scanline *line)
+{
+    line->bx += line->rdx;
+    line->by += line->rdy;
+}
+
 /* FrameRect to FrameRect, same format, 2 Bytes/pixel. */
 static void _blit_rotate_FR2FR_SF2B(struct _fb_rect* RTGUI_RESTRICT src,
                                     const struct rtgui_point *dc_point,
@@ -169,46 +346,31 @@ static void _blit_rotate_FR2FR_SF2B(struct _fb_rect* RTGUI_RESTRICT src,
 {
     rt_uint16_t* RTGUI_RESTRICT srcp = (rt_uint16_t*)src->fb;
     rt_uint16_t* RTGUI_RESTRICT dstp = (rt_uint16_t*)dst->fb;
-    int neww = dst->width;
-    int newh = dst->height;
     int oriw = src->width;
-    int orih = src->height;
-    int nx, ny;
-    int dx, dy;
+    int ny, count, start;
+    int bx, by;
+    struct _trans_scanline line;
 
-    /* Delta of bx/by when nx++. */
-    dx = invm->m[0];
-    dy = invm->m[1];
+    _trans_scanline_init(&line, dc_point, dst, invm);
 
-    for (ny = dc_point->y; ny < newh; ny++)
+    for (ny = dc_point->y; ny < dst->height; ny++, dstp += dst->skip)
     {
-        /* Base x, y. */
-        int bx, by;
+        rt_uint16_t* RTGUI_RESTRICT dp;
 
-        bx = dc_point->x * dx + ny * invm->m[2] + RTGUI_MATRIX_FRAC * invm->m[4];
-        by = dc_point->x * dy + ny * invm->m[3] + RTGUI_MATRIX_FRAC * invm->m[5];
+        count = _trans_scanline_clip(&line, src, 0, &bx, &by, &start);
+        _trans_scanline_next(&line);
 
-        for (nx = dc_point->x; nx < neww; nx++, dstp++)
+        for (dp = dstp + start; count > 0; count--, dp++, bx += line.dx, by += line.dy)
         {
             /* The coordinate in the source frame. */
             int rx, ry;
 
-            bx += dx;
-            by += dy;
-
-            if (bx < 0 || by < 0)
-                continue;
-
-            rx = bx / RTGUI_MATRIX_FRAC;
-            ry = by / RTGUI_MATRIX_FRAC;
-
-            if (oriw <= rx || orih <= ry)
-                continue;
+            rx = bx >> RTGUI_MATRIX_FRAC_BITS;
+            ry = by >> RTGUI_MATRIX_FRAC_BITS;
 
             /* We take the source as a whole and ignore the src->skip. */
-            *dstp = srcp[ry * oriw + rx];
+            *dp = srcp[ry * oriw + rx];
         }
-        dstp += dst->skip - neww;
     }
 }
 
@@ -220,25 +382,21 @@ static void _blit_rotate_FR2FR_SF2B_AA(struct _fb_rect* RTGUI_RESTRICT src,
 {
     rt_uint16_t* RTGUI_RESTRICT srcp = (rt_uint16_t*)src->fb;
     rt_uint16_t* RTGUI_RESTRICT dstp = (rt_uint16_t*)dst->fb;
-    int neww = dst->width;
-    int newh = dst->height;
     int oriw = src->width;
-    int orih = src->height;
-    int nx, ny;
-    int dx, dy;
+    int ny, count, start;
+    int bx, by;
+    struct _trans_scanline line;
 
-    dx = invm->m[0];
-    dy = invm->m[1];
+    _trans_scanline_init(&line, dc_point, dst, invm);
 
-    for (ny = dc_point->y; ny < newh; ny++)
+    for (ny = dc_point->y; ny < dst->height; ny++, dstp += dst->skip)
     {
-        /* Base x, y. */
-        int bx, by;
+        rt_uint16_t* RTGUI_RESTRICT dp;
 
-        bx = dc_point->x * dx + ny * invm->m[2] + RTGUI_MATRIX_FRAC * invm->m[4];
-        by = dc_point->x * dy + ny * invm->m[3] + RTGUI_MATRIX_FRAC * invm->m[5];
+        count = _trans_scanline_clip(&line, src, 1, &bx, &by, &start);
+        _trans_scanline_next(&line);
 
-        for (nx = dc_point->x; nx < neww; nx++, dstp++)
+        for (dp = dstp + start; count > 0; count--, dp++, bx += line.dx, by += line.dy)
         {
             /* Color of pixels:
              *     c00 c01
@@ -246,17 +404,8 @@ static void _blit_rotate_FR2FR_SF2B_AA(struct _fb_rect* RTGUI_RESTRICT src,
             rt_uint32_t c00, c01, c10, c11;
             int rx, ry, sx, sy;
 
-            bx += dx;
-            by += dy;
-
-            if (bx < 0 || by < 0)
-                continue;
-
-            rx = bx / RTGUI_MATRIX_FRAC;
-            ry = by / RTGUI_MATRIX_FRAC;
-
-            if (oriw - 1 <= rx || orih - 1 <= ry)
-                continue;
+            rx = bx >> RTGUI_MATRIX_FRAC_BITS;
+            ry = by >> RTGUI_MATRIX_FRAC_BITS;
 
             c00 = srcp[ry * oriw + rx];
             c01 = srcp[ry * oriw + rx + 1];
@@ -281,9 +430,8 @@ static void _blit_rotate_FR2FR_SF2B_AA(struct _fb_rect* RTGUI_RESTRICT src,
                 c00 = ((c10 - c00) * sy / 32 + c00) & 0x07e0f81f;
 
             /* We take the source as a whole and ignore the src->skip. */
-            *dstp = c00 | (c00 >> 16);
+            *dp = c00 | (c00 >> 16);
         }
-        dstp += dst->skip - neww;
     }
 }
 
@@ -304,40 +452,27 @@ static void _blit_rotate_FR2FR_SF4B(struct _fb_rect* RTGUI_RESTRICT src,
 {
     rt_uint32_t* RTGUI_RESTRICT srcp = (rt_uint32_t*)src->fb;
     rt_uint32_t* RTGUI_RESTRICT dstp = (rt_uint32_t*)dst->fb;
-    int neww = dst->width;
-    int newh = dst->height;
     int oriw = src->width;
-    int orih = src->height;
-    int nx, ny;
-    int dx, dy;
+    int ny, count, start;
+    int bx, by;
+    struct _trans_scanline line;
 
-    dx = invm->m[0];
-    dy = invm->m[1];
+    _trans_scanline_init(&line, dc_point, dst, invm);
 
-    for (ny = dc_point->y; ny < newh; ny++)
+    for (ny = dc_point->y; ny < dst->height; ny++, dstp += dst->skip)
     {
-        /* Base x, y. */
-        int bx, by;
+        rt_uint32_t* RTGUI_RESTRICT dp;
 
-        bx = dc_point->x * dx + ny * invm->m[2] + RTGUI_MATRIX_FRAC * invm->m[4];
-        by = dc_point->x * dy + ny * invm->m[3] + RTGUI_MATRIX_FRAC * invm->m[5];
+        count = _trans_scanline_clip(&line, src, 0, &bx, &by, &start);
+        _trans_scanline_next(&line);
 
-        for (nx = dc_point->x; nx < neww; nx++, dstp++)
+        for (dp = dstp + start; count > 0; count--, dp++, bx += line.dx, by += line.dy)
         {
             union _rgba spix, dpix;
             int rx, ry, a;
 
-            bx += dx;
-            by += dy;
-
-            if (bx < 0 || by < 0)
-                continue;
-
-            rx = bx / RTGUI_MATRIX_FRAC;
-            ry = by / RTGUI_MATRIX_FRAC;
-
-            if (oriw <= rx || orih <= ry)
-                continue;
+            rx = bx >> RTGUI_MATRIX_FRAC_BITS;
+            ry = by >> RTGUI_MATRIX_FRAC_BITS;
 
             spix.blk = srcp[ry * oriw + rx];
             /* Down scale the alpha to 5 bits. */
@@ -348,17 +483,16 @@ static void _blit_rotate_FR2FR_SF4B(struct _fb_rect* RTGUI_RESTRICT src,
 
             if (a == 31)
             {
-                *dstp = spix.blk;
+                *dp = spix.blk;
                 continue;
             }
 
-            dpix.blk = *dstp;
+            dpix.blk = *dp;
             dpix.d.r = (spix.d.r - dpix.d.r) * a / 32 + dpix.d.r;
             dpix.d.g = (spix.d.g - dpix.d.g) * a / 32 + dpix.d.g;
             dpix.d.b = (spix.d.b - dpix.d.b) * a / 32 + dpix.d.b;
-            *dstp = dpix.blk;
+            *dp = dpix.blk;
         }
-        dstp += dst->skip - neww;
     }
 }
 
@@ -370,40 +504,27 @@ static void _blit_rotate_FR2FR_SF4B_AA(struct _fb_rect* RTGUI_RESTRICT src,
 {
     rt_uint32_t* RTGUI_RESTRICT srcp = (rt_uint32_t*)src->fb;
     rt_uint32_t* RTGUI_RESTRICT dstp = (rt_uint32_t*)dst->fb;
-    int neww = dst->width;
-    int newh = dst->height;
     int oriw = src->width;
-    int orih = src->height;
-    int nx, ny;
-    int dx, dy;
+    int ny, count, start;
+    int bx, by;
+    struct _trans_scanline line;
 
-    dx = invm->m[0];
-    dy = invm->m[1];
+    _trans_scanline_init(&line, dc_point, dst, invm);
 
-    for (ny = dc_point->y; ny < newh; ny++)
+    for (ny = dc_point->y; ny < dst->height; ny++, dstp += dst->skip)
     {
-        /* Base x, y. */
-        int bx, by;
+        rt_uint32_t* RTGUI_RESTRICT dp;
 
-        bx = dc_point->x * dx + ny * invm->m[2] + RTGUI_MATRIX_FRAC * invm->m[4];
-        by = dc_point->x * dy + ny * invm->m[3] + RTGUI_MATRIX_FRAC * invm->m[5];
+        count = _trans_scanline_clip(&line, src, 1, &bx, &by, &start);
+        _trans_scanline_next(&line);
 
-        for (nx = dc_point->x; nx < neww; nx++, dstp++)
+        for (dp = dstp + start; count > 0; count--, dp++, bx += line.dx, by += line.dy)
         {
             union _rgba spix00, spix01, spix10, spix11, dpix;
             int rx, ry, a, sx, sy;
 
-            bx += dx;
-            by += dy;
-
-            if (bx < 0 || by < 0)
-                continue;
-
-            rx = bx / RTGUI_MATRIX_FRAC;
-            ry = by / RTGUI_MATRIX_FRAC;
-
-            if (oriw - 1 <= rx || orih - 1 <= ry)
-                continue;
+            rx = bx >> RTGUI_MATRIX_FRAC_BITS;
+            ry = by >> RTGUI_MATRIX_FRAC_BITS;
 
             spix00.blk = srcp[ry * oriw + rx];
 
@@ -452,17 +573,16 @@ static void _blit_rotate_FR2FR_SF4B_AA(struct _fb_rect* RTGUI_RESTRICT src,
 
             if (a == (255 >> 3))
             {
-                *dstp = spix00.blk;
+                *dp = spix00.blk;
                 continue;
             }
 
-            dpix.blk = *dstp;
+            dpix.blk = *dp;
             dpix.d.r = (spix00.d.r - dpix.d.r) * a / 32 + dpix.d.r;
             dpix.d.g = (spix00.d.g - dpix.d.g) * a / 32 + dpix.d.g;
             dpix.d.b = (spix00.d.b - dpix.d.b) * a / 32 + dpix.d.b;
-            *dstp = dpix.blk;
+            *dp = dpix.blk;
         }
-        dstp += dst->skip - neww;
     }
 }
 
@@ -474,41 +594,28 @@ static void _blit_rotate_FR2FR_ARGB2RGB565(struct _fb_rect* RTGUI_RESTRICT src,
 {
     rt_uint32_t* RTGUI_RESTRICT srcp = (rt_uint32_t*)src->fb;
     rt_uint16_t* RTGUI_RESTRICT dstp = (rt_uint16_t*)dst->fb;
-    int neww = dst->width;
-    int newh = dst->height;
     int oriw = src->width;
-    int orih = src->height;
-    int nx, ny;
-    int dx, dy;
+    int ny, count, start;
+    int bx, by;
+    struct _trans_scanline line;
 
-    dx = invm->m[0];
-    dy = invm->m[1];
+    _trans_scanline_init(&line, dc_point, dst, invm);
 
-    for (ny = dc_point->y; ny < newh; ny++)
+    for (ny = dc_point->y; ny < dst->height; ny++, dstp += dst->skip)
     {
-        /* Base x, y. */
-        int bx, by;
+        rt_uint16_t* RTGUI_RESTRICT dp;
 
-        bx = dc_point->x * dx + ny * invm->m[2] + RTGUI_MATRIX_FRAC * invm->m[4];
-        by = dc_point->x * dy + ny * invm->m[3] + RTGUI_MATRIX_FRAC * invm->m[5];
+        count = _trans_scanline_clip(&line, src, 0, &bx, &by, &start);
+        _trans_scanline_next(&line);
 
-        for (nx = dc_point->x; nx < neww; nx++, dstp++)
+        for (dp = dstp + start; count > 0; count--, dp++, bx += line.dx, by += line.dy)
         {
             int rx, ry;
             int alpha;
             rt_uint32_t op;
 
-            bx += dx;
-            by += dy;
-
-            if (bx < 0 || by < 0)
-                continue;
-
-            rx = bx / RTGUI_MATRIX_FRAC;
-            ry = by / RTGUI_MATRIX_FRAC;
-
-            if (oriw <= rx || orih <= ry)
-                continue;
+            rx = bx >> RTGUI_MATRIX_FRAC_BITS;
+            ry = by >> RTGUI_MATRIX_FRAC_BITS;
 
             /* We take the source as a whole and ignore the src->skip. */
             op = srcp[ry * oriw + rx];
@@ -516,14 +623,14 @@ static void _blit_rotate_FR2FR_ARGB2RGB565(struct _fb_rect* RTGUI_RESTRICT src,
             alpha = op >> 27;
             if (alpha == (255 >> 3))
             {
-                *dstp = (rt_uint16_t)((op >> 8 & 0xf800) +
+                *dp = (rt_uint16_t)((op >> 8 & 0xf800) +
                                       (op >> 5 & 0x7e0) +
                                       (op >> 3 & 0x1f));
             }
             else if (alpha != 0)
             {
                 /* We take the source as a whole and ignore the src->skip. */
-                rt_uint32_t d = *dstp;
+                rt_uint32_t d = *dp;
                 /*
                  * convert source and destination to G0RAB65565
                  * and blend all components at the same time
@@ -533,10 +640,9 @@ static void _blit_rotate_FR2FR_ARGB2RGB565(struct _fb_rect* RTGUI_RESTRICT src,
                 d = (d | d << 16) & 0x07e0f81f;
                 d += (op - d) * alpha >> 5;
                 d &= 0x07e0f81f;
-                *dstp = (rt_uint16_t)(d | d >> 16);
+                *dp = (rt_uint16_t)(d | d >> 16);
             }
         }
-        dstp += dst->skip - neww;
     }
 }
 
@@ -548,41 +654,28 @@ static void _blit_rotate_FR2FR_ARGB2RGB565_AA(struct _fb_rect* RTGUI_RESTRICT sr
 {
     rt_uint32_t* RTGUI_RESTRICT srcp = (rt_uint32_t*)src->fb;
     rt_uint16_t* RTGUI_RESTRICT dstp = (rt_uint16_t*)dst->fb;
-    int neww = dst->width;
-    int newh = dst->height;
     int oriw = src->width;
-    int orih = src->height;
-    int nx, ny;
-    int dx, dy;
+    int ny, count, start;
+    int bx, by;
+    struct _trans_scanline line;
 
-    dx = invm->m[0];
-    dy = invm->m[1];
+    _trans_scanline_init(&line, dc_point, dst, invm);
 
-    for (ny = dc_point->y; ny < newh; ny++)
+    for (ny = dc_point->y; ny < dst->height; ny++, dstp += dst->skip)
     {
-        /* Base x, y. */
-        int bx, by;
+        rt_uint16_t* RTGUI_RESTRICT dp;
 
-        bx = dc_point->x * dx + ny * invm->m[2] + RTGUI_MATRIX_FRAC * invm->m[4];
-        by = dc_point->x * dy + ny * invm->m[3] + RTGUI_MATRIX_FRAC * invm->m[5];
+        count = _trans_scanline_clip(&line, src, 1, &bx, &by, &start);
+        _trans_scanline_next(&line);
 
-        for (nx = dc_point->x; nx < neww; nx++, dstp++)
+        for (dp = dstp + start; count > 0; count--, dp++, bx += line.dx, by += line.dy)
         {
             rt_uint32_t op00, op01, op10, op11;
             rt_uint8_t a00, a01, a10, a11;
             int rx, ry, sx, sy;
 
-            bx += dx;
-            by += dy;
-
-            if (bx < 0 || by < 0)
-                continue;
-
-            rx = bx / RTGUI_MATRIX_FRAC;
-            ry = by / RTGUI_MATRIX_FRAC;
-
-            if (oriw - 1 <= rx || orih - 1 <= ry)
-                continue;
+            rx = bx >> RTGUI_MATRIX_FRAC_BITS;
+            ry = by >> RTGUI_MATRIX_FRAC_BITS;
 
             op00 = srcp[ry * oriw + rx];
             op01 = srcp[ry * oriw + rx + 1];
@@ -629,80 +722,75 @@ static void _blit_rotate_FR2FR_ARGB2RGB565_AA(struct _fb_rect* RTGUI_RESTRICT sr
 
             if (a00 == (255 >> 3))
             {
-                *dstp = op00 | (op00 >> 16);
+                *dp = op00 | (op00 >> 16);
             }
             else if (a00 != 0)
             {
-                rt_uint32_t d = *dstp;
+                rt_uint32_t d = *dp;
 
                 d = (d | d << 16) & 0x07e0f81f;
                 d += (op00 - d) * a00 >> 5;
                 d &= 0x07e0f81f;
-                *dstp = (rt_uint16_t)(d | d >> 16);
+                *dp = (rt_uint16_t)(d | d >> 16);
             }
         }
-        dstp += dst->skip - neww;
     }
 }
 
-static void _blit_rotate_B2B(struct rtgui_dc_trans *dct,
-                             const struct rtgui_point *dc_point,
-                             struct rtgui_dc_buffer* RTGUI_RESTRICT dest,
-                             struct rtgui_rect *rect,
-                             const struct rtgui_matrix *invm,
-                             int neww, int newh)
+/* Route the framebuffer rect to the optimized routine of the formats. */
+static void _blit_rotate_fb(struct rtgui_dc_trans *dct,
+                            const struct rtgui_point *dc_point,
+                            struct _fb_rect* RTGUI_RESTRICT dstfb,
+                            rt_uint8_t dst_format)
 {
     struct rtgui_rect srcrect;
+    struct _fb_rect srcfb;
     struct rtgui_dc_buffer *dc = (struct rtgui_dc_buffer*)dct->owner;
-    struct _fb_rect srcfb, dstfb;
+    const struct rtgui_matrix *invm = &dct->invm;
 
     rtgui_dc_get_rect(dct->owner, &srcrect);
 
-    srcfb.fb     = ((struct rtgui_dc_buffer*)dct->owner)->pixel;
+    srcfb.fb     = dc->pixel;
     srcfb.width  = srcrect.x2;
     srcfb.height = srcrect.y2;
     srcfb.skip   = 0;
+    srcfb.bound  = &dct->bound;
 
-    dstfb.fb     = dest->pixel + rtgui_color_get_bpp(dest->pixel_format) * (rect->x1 + rect->y1 * dest->width);
-    dstfb.width  = neww;
-    dstfb.height = newh;
-    dstfb.skip   = dest->width;
-
-    if (dc->pixel_format == dest->pixel_format)
+    if (dc->pixel_format == dst_format)
     {
-        switch (rtgui_color_get_bpp(dest->pixel_format))
+        switch (rtgui_color_get_bpp(dst_format))
         {
         case 2:
             if (dct->use_aa)
                 _blit_rotate_FR2FR_SF2B_AA(&srcfb, dc_point,
-                                           &dstfb, invm);
+                                           dstfb, invm);
             else
                 _blit_rotate_FR2FR_SF2B(&srcfb, dc_point,
-                                        &dstfb, invm);
+                                        dstfb, invm);
             break;
         case 4:
             if (dct->use_aa)
                 _blit_rotate_FR2FR_SF4B_AA(&srcfb, dc_point,
-                                           &dstfb, invm);
+                                           dstfb, invm);
             else
                 _blit_rotate_FR2FR_SF4B(&srcfb, dc_point,
-                                        &dstfb, invm);
+                                        dstfb, invm);
             break;
         default:
             rt_kprintf("could not handle bpp: %d\n",
-                       rtgui_color_get_bpp(dest->pixel_format));
+                       rtgui_color_get_bpp(dst_format));
             return;
         }
     }
     else if (dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB888 &&
-             dest->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+             dst_format == RTGRAPHIC_PIXEL_FORMAT_RGB565)
     {
         if (dct->use_aa)
             _blit_rotate_FR2FR_ARGB2RGB565_AA(&srcfb, dc_point,
-                                              &dstfb, invm);
+                                              dstfb, invm);
         else
             _blit_rotate_FR2FR_ARGB2RGB565(&srcfb, dc_point,
-                                           &dstfb, invm);
+                                           dstfb, invm);
     }
     else
     {
@@ -711,30 +799,40 @@ static void _blit_rotate_B2B(struct rtgui_dc_trans *dct,
     }
 }
 
+static void _blit_rotate_B2B(struct rtgui_dc_trans *dct,
+                             const struct rtgui_point *dc_point,
+                             struct rtgui_dc_buffer* RTGUI_RESTRICT dest,
+                             struct rtgui_rect *rect,
+                             int neww, int newh)
+{
+    struct _fb_rect dstfb;
+
+    if (rtgui_dc_buffer_get_pixel(RTGUI_DC(dest)) == RT_NULL)
+        return;
+
+    dstfb.fb     = dest->pixel + rtgui_color_get_bpp(dest->pixel_format) * (rect->x1 + rect->y1 * dest->width);
+    dstfb.width  = neww;
+    dstfb.height = newh;
+    dstfb.skip   = dest->width;
+
+    _blit_rotate_fb(dct, dc_point, &dstfb, dest->pixel_format);
+}
+
 static void _blit_rotate_B2H(struct rtgui_dc_trans *dct,
                              const struct rtgui_point *dc_point,
                              struct rtgui_dc_hw* dest,
                              struct rtgui_rect *rect,
-                             const struct rtgui_matrix *invm,
                              int neww, int newh)
 {
-    struct rtgui_rect srcrect;
     int start_pix;
-    struct _fb_rect srcfb, dstfb;
-    struct rtgui_dc_buffer *dc = (struct rtgui_dc_buffer*)dct->owner;
+    struct _fb_rect dstfb;
 
     if (dest->hw_driver->framebuffer == RT_NULL)
     {
         rt_kprintf("Only support framebuffer hw dc\n");
         return;
     }
-
-    rtgui_dc_get_rect(dct->owner, &srcrect);
-
-    srcfb.fb     = ((struct rtgui_dc_buffer*)dct->owner)->pixel;
-    srcfb.width  = srcrect.x2;
-    srcfb.height = srcrect.y2;
-    srcfb.skip   = 0;
+    rtgui_graphic_driver_accel_sync();
 
     /* Start point of the widget. */
     start_pix = dest->owner->extent.x1 + dest->owner->extent.y1 * dest->hw_driver->width;
@@ -747,47 +845,66 @@ static void _blit_rotate_B2H(struct rtgui_dc_trans *dct,
     dstfb.height = newh;
     dstfb.skip   = dest->hw_driver->width;
 
-    if (dc->pixel_format == dest->hw_driver->pixel_format)
-    {
-        switch (rtgui_color_get_bpp(dest->hw_driver->pixel_format))
-        {
-        case 2:
-            if (dct->use_aa)
-                _blit_rotate_FR2FR_SF2B_AA(&srcfb, dc_point,
-                                           &dstfb, invm);
-            else
-                _blit_rotate_FR2FR_SF2B(&srcfb, dc_point,
-                                        &dstfb, invm);
-            break;
-        case 4:
-            if (dct->use_aa)
-                _blit_rotate_FR2FR_SF4B_AA(&srcfb, dc_point,
-                                           &dstfb, invm);
-            else
-                _blit_rotate_FR2FR_SF4B(&srcfb, dc_point,
-                                        &dstfb, invm);
-            break;
-        default:
-            rt_kprintf("could not handle bpp: %d\n",
-                       rtgui_color_get_bpp(dest->hw_driver->pixel_format));
-            return;
-        }
-    }
-    else if (dc->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB888 &&
-             dest->hw_driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+    _blit_rotate_fb(dct, dc_point, &dstfb, dest->hw_driver->pixel_format);
+}
+
+static void _blit_rotate_B2C(struct rtgui_dc_trans *dct,
+                             const struct rtgui_point *dc_point,
+                             struct rtgui_dc *dest,
+                             struct rtgui_rect *rect,
+                             int neww, int newh)
+{
+    int index, num_rects;
+    struct rtgui_rect area, *rects;
+    struct rtgui_region region;
+    struct rtgui_widget *owner;
+    struct rtgui_graphic_driver *hw_driver;
+
+    hw_driver = rtgui_graphic_driver_get_default();
+    if (hw_driver->framebuffer == RT_NULL)
     {
-        if (dct->use_aa)
-            _blit_rotate_FR2FR_ARGB2RGB565_AA(&srcfb, dc_point,
-                                              &dstfb, invm);
-        else
-            _blit_rotate_FR2FR_ARGB2RGB565(&srcfb, dc_point,
-                                           &dstfb, invm);
+        rt_kprintf("Only support framebuffer client dc\n");
+        return;
     }
-    else
+    rtgui_graphic_driver_accel_sync();
+
+    owner = RTGUI_CONTAINER_OF(dest, struct rtgui_widget, dc_type);
+
+    /* The drawing area on the device. */
+    area.x1 = rect->x1;
+    area.y1 = rect->y1;
+    area.x2 = rect->x1 + neww - dc_point->x;
+    area.y2 = rect->y1 + newh - dc_point->y;
+    rtgui_widget_rect_to_device(owner, &area);
+
+    rtgui_region_init_with_extents(&region, &area);
+    rtgui_region_intersect_rect(&region, &(owner->clip), &area);
+
+    num_rects = rtgui_region_num_rects(&region);
+    rects = rtgui_region_rects(&region);
+    for (index = 0; index < num_rects; index++)
     {
-        rt_kprintf("not implemented yet\n");
-        return;
+        struct rtgui_rect *r = &rects[index];
+        struct rtgui_point pt;
+        struct _fb_rect dstfb;
+
+        if (rtgui_rect_is_empty(r))
+            continue;
+
+        /* The transformed point at the top left of the clip rect. */
+        pt.x = dc_point->x + r->x1 - area.x1;
+        pt.y = dc_point->y + r->y1 - area.y1;
+
+        dstfb.fb     = (void*)(hw_driver->framebuffer
+                               + rtgui_color_get_bpp(hw_driver->pixel_format) * (r->x1 + r->y1 * hw_driver->width));
+        dstfb.width  = pt.x + rtgui_rect_width(*r);
+        dstfb.height = pt.y + rtgui_rect_height(*r);
+        dstfb.skip   = hw_driver->width;
+
+        _blit_rotate_fb(dct, &pt, &dstfb, hw_driver->pixel_format);
     }
+
+    rtgui_region_fini(&region);
 }
 
 void rtgui_dc_trans_blit(struct rtgui_dc_trans *dct,
@@ -796,7 +913,6 @@ void rtgui_dc_trans_blit(struct rtgui_dc_trans *dct,
                          struct rtgui_rect *rect)
 {
     struct rtgui_rect bkrect;
-    struct rtgui_matrix invm;
     struct rtgui_point dp;
     int neww, newh;
 
@@ -834,7 +950,7 @@ void rtgui_dc_trans_blit(struct rtgui_dc_trans *dct,
     else if (dc_point->y > newh)
         return;
 
-    if (rtgui_matrix_inverse(&dct->m, &invm))
+    if (!dct->invertible)
         return;
 
     if (rtgui_rect_width(*rect) < neww - dc_point->x)
@@ -845,17 +961,21 @@ void rtgui_dc_trans_blit(struct rtgui_dc_trans *dct,
     /* Route to different optimized routines. */
     if (dct->owner->type == RTGUI_DC_BUFFER)
     {
+        /* the lazy pixels of owner are allocated, the shared ones are only read */
+        if (rtgui_dc_buffer_read_pixel(dct->owner) == RT_NULL)
+            return;
+
         if (dest->type == RTGUI_DC_BUFFER)
             _blit_rotate_B2B(dct, dc_point,
                              (struct rtgui_dc_buffer*)dest,
-                             rect, &invm, neww, newh);
+                             rect, neww, newh);
         else if (dest->type == RTGUI_DC_HW)
             _blit_rotate_B2H(dct, dc_point,
                              (struct rtgui_dc_hw*)dest,
-                             rect, &invm, neww, newh);
+                             rect, neww, newh);
         else if (dest->type == RTGUI_DC_CLIENT)
-            // TODO:
-            ;
+            _blit_rotate_B2C(dct, dc_point, dest,
+                             rect, neww, newh);
         else
             rt_kprintf("unknown dc for dc_trans\n");
     }
@@ -863,4 +983,3 @@ void rtgui_dc_trans_blit(struct rtgui_dc_trans *dct,
         rt_kprintf("not implemented yet\n");
 }
 RTM_EXPORT(rtgui_dc_trans_blit);
-
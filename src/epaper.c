@@ -0,0 +1,211 @@
+/*
+ * File      : epaper.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/driver.h>
+#include <rtgui/region.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_EPAPER
+
+#if (GUIENGINE_EPAPER_ALIGN_X & (GUIENGINE_EPAPER_ALIGN_X - 1)) != 0 || \
+    (GUIENGINE_EPAPER_ALIGN_Y & (GUIENGINE_EPAPER_ALIGN_Y - 1)) != 0
+#error "the alignment of e-paper window should be a power of 2"
+#endif
+
+/*
+ * The screen updates of e-paper are collected in the damage, and refreshed by
+ * a thread in the partial windows of controller. A refresh takes hundreds of
+ * ms, the updates in it are merged to the next refresh and the GUI does not
+ * wait for the waveform.
+ */
+static const struct rtgui_graphic_driver *_epaper_driver = RT_NULL;
+static struct rt_mutex _epaper_lock;
+static struct rt_semaphore _epaper_sem;
+static rtgui_region_t _epaper_damage;
+/* the partial refreshes since the last full refresh */
+static int _epaper_partial = 0;
+static int _epaper_full_every = GUIENGINE_EPAPER_FULL_EVERY;
+
+/* the rect of panel, which is not the GUI in rotation */
+static void _epaper_get_rect(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+#ifdef GUIENGINE_USING_ROTATION
+    if (driver->rotation != 0)
+    {
+        rtgui_rect_init(rect, 0, 0, driver->panel_width, driver->panel_height);
+        return;
+    }
+#endif
+    rtgui_graphic_driver_get_rect(driver, rect);
+}
+
+static void _epaper_align(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+    rtgui_rect_t screen;
+
+    _epaper_get_rect(driver, &screen);
+    rect->x1 &= ~(GUIENGINE_EPAPER_ALIGN_X - 1);
+    rect->y1 &= ~(GUIENGINE_EPAPER_ALIGN_Y - 1);
+    rect->x2 = (rect->x2 + GUIENGINE_EPAPER_ALIGN_X - 1) & ~(GUIENGINE_EPAPER_ALIGN_X - 1);
+    rect->y2 = (rect->y2 + GUIENGINE_EPAPER_ALIGN_Y - 1) & ~(GUIENGINE_EPAPER_ALIGN_Y - 1);
+
+    if (rect->x1 < 0) rect->x1 = 0;
+    if (rect->y1 < 0) rect->y1 = 0;
+    if (rect->x2 > screen.x2) rect->x2 = screen.x2;
+    if (rect->y2 > screen.y2) rect->y2 = screen.y2;
+}
+
+static void _epaper_refresh(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+    struct rt_device_rect_info rect_info;
+
+    rect_info.x = rect->x1;
+    rect_info.y = rect->y1;
+    rect_info.width = rect->x2 - rect->x1;
+    rect_info.height = rect->y2 - rect->y1;
+    rt_device_control(driver->device, RTGRAPHIC_CTRL_RECT_UPDATE, &rect_info);
+}
+
+static void _epaper_entry(void *parameter)
+{
+    int index, num;
+    rtgui_region_t damage;
+    rtgui_rect_t screen, *rects;
+    const struct rtgui_graphic_driver *driver;
+
+    rtgui_region_init(&damage);
+    while (1)
+    {
+        rt_sem_take(&_epaper_sem, RT_WAITING_FOREVER);
+        /* the updates of a redraw come in a burst, merge them */
+        rt_thread_delay(rt_tick_from_millisecond(GUIENGINE_EPAPER_DELAY_MS));
+        while (rt_sem_trytake(&_epaper_sem) == RT_EOK);
+
+        rt_mutex_take(&_epaper_lock, RT_WAITING_FOREVER);
+        driver = _epaper_driver;
+        rtgui_region_copy(&damage, &_epaper_damage);
+        rtgui_region_fini(&_epaper_damage);
+        rtgui_region_init(&_epaper_damage);
+        rt_mutex_release(&_epaper_lock);
+
+        if (driver == RT_NULL || !rtgui_region_not_empty(&damage))
+            continue;
+
+        num = rtgui_region_num_rects(&damage);
+        _epaper_get_rect(driver, &screen);
+        _epaper_partial ++;
+        if (_epaper_full_every > 0 && _epaper_partial >= _epaper_full_every)
+        {
+            /* clear the ghosting of partial waveform by a full refresh */
+            _epaper_partial = 0;
+            _epaper_refresh(driver, &screen);
+        }
+        else if (num > GUIENGINE_EPAPER_WINDOWS)
+        {
+            /* the controller has a few windows, refresh the extents once */
+            _epaper_refresh(driver, rtgui_region_extents(&damage));
+        }
+        else
+        {
+            rects = rtgui_region_rects(&damage);
+            for (index = 0; index < num; index ++)
+                _epaper_refresh(driver, &rects[index]);
+        }
+    }
+}
+
+/*
+ * Refresh the driver as an e-paper, the screen updates of it are aligned to
+ * the windows of controller and refreshed by a thread. The driver should copy
+ * the window to the controller before its waveform.
+ */
+rt_err_t rtgui_epaper_init(const struct rtgui_graphic_driver *driver)
+{
+    rt_thread_t tid;
+
+    RT_ASSERT(driver != RT_NULL);
+
+    if (_epaper_driver != RT_NULL)
+    {
+        rt_mutex_take(&_epaper_lock, RT_WAITING_FOREVER);
+        _epaper_driver = driver;
+        rt_mutex_release(&_epaper_lock);
+        return RT_EOK;
+    }
+
+    rt_mutex_init(&_epaper_lock, "epaper", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&_epaper_sem, "epaper", 0, RT_IPC_FLAG_FIFO);
+    rtgui_region_init(&_epaper_damage);
+
+    tid = rt_thread_create("epaper", _epaper_entry, RT_NULL,
+                           GUIENGINE_EPAPER_THREAD_STACK_SIZE,
+                           GUIENGINE_EPAPER_THREAD_PRIORITY,
+                           GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid == RT_NULL)
+    {
+        rt_mutex_detach(&_epaper_lock);
+        rt_sem_detach(&_epaper_sem);
+        return -RT_ENOMEM;
+    }
+
+    _epaper_driver = driver;
+    rt_thread_startup(tid);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_epaper_init);
+
+/* a full refresh each every partial refreshes, 0 is never */
+void rtgui_epaper_set_full_every(int every)
+{
+    _epaper_full_every = every;
+}
+RTM_EXPORT(rtgui_epaper_set_full_every);
+
+/* collect the update on panel of the e-paper driver, RT_FALSE on the other drivers */
+rt_bool_t rtgui_epaper_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+    rtgui_rect_t r;
+
+    if (driver != _epaper_driver || driver == RT_NULL)
+        return RT_FALSE;
+
+    r = *rect;
+    _epaper_align(driver, &r);
+    if (r.x1 >= r.x2 || r.y1 >= r.y2)
+        return RT_TRUE;
+
+    rt_mutex_take(&_epaper_lock, RT_WAITING_FOREVER);
+    rtgui_region_union_rect(&_epaper_damage, &_epaper_damage, &r);
+    rt_mutex_release(&_epaper_lock);
+    rt_sem_release(&_epaper_sem);
+
+    return RT_TRUE;
+}
+RTM_EXPORT(rtgui_epaper_update);
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * File      : event_payload.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_EVENT
+
+#include <rtthread.h>
+#include <rtgui/event.h>
+#include <rtgui/rtgui_system.h>
+
+/*
+ * The events are copied into the queue of app by value, so the large data is
+ * passed by a payload instead of embedded in the event. The payload has a
+ * reference count in the header, and it's freed when the last reference of
+ * the events carrying it is released.
+ */
+struct rtgui_event_payload
+{
+    rt_uint16_t ref;
+    rt_uint16_t pooled;
+};
+#define _PAYLOAD_HEADER_SIZE    RT_ALIGN(sizeof(struct rtgui_event_payload), RT_ALIGN_SIZE)
+#define _PAYLOAD_HEADER(p)      ((struct rtgui_event_payload *)((rt_uint8_t *)(p) - _PAYLOAD_HEADER_SIZE))
+
+static struct rt_mempool _payload_mp;
+static rt_uint8_t _payload_pool[GUIENGINE_EVENT_PAYLOAD_NUM *
+                                (RT_ALIGN(GUIENGINE_EVENT_PAYLOAD_BLOCK + _PAYLOAD_HEADER_SIZE, RT_ALIGN_SIZE) + sizeof(rt_uint8_t *))];
+static rt_bool_t _payload_inited = RT_FALSE;
+
+void *rtgui_event_payload_alloc(rt_size_t size)
+{
+    rt_base_t level;
+    struct rtgui_event_payload *payload = RT_NULL;
+
+    if (size <= GUIENGINE_EVENT_PAYLOAD_BLOCK)
+    {
+        level = rt_hw_interrupt_disable();
+        if (_payload_inited == RT_FALSE)
+        {
+            rt_mp_init(&_payload_mp, "payload", _payload_pool, sizeof(_payload_pool),
+                       RT_ALIGN(GUIENGINE_EVENT_PAYLOAD_BLOCK + _PAYLOAD_HEADER_SIZE, RT_ALIGN_SIZE));
+            _payload_inited = RT_TRUE;
+        }
+        rt_hw_interrupt_enable(level);
+
+        payload = (struct rtgui_event_payload *)rt_mp_alloc(&_payload_mp, 0);
+        if (payload != RT_NULL)
+            payload->pooled = 1;
+    }
+
+    /* the large one, or the pool is used up */
+    if (payload == RT_NULL)
+    {
+        payload = (struct rtgui_event_payload *)rtgui_malloc(_PAYLOAD_HEADER_SIZE + size);
+        if (payload == RT_NULL)
+            return RT_NULL;
+        payload->pooled = 0;
+    }
+    payload->ref = 1;
+
+    return (rt_uint8_t *)payload + _PAYLOAD_HEADER_SIZE;
+}
+RTM_EXPORT(rtgui_event_payload_alloc);
+
+void rtgui_event_payload_ref(void *payload)
+{
+    rt_base_t level;
+
+    if (payload == RT_NULL) return;
+
+    level = rt_hw_interrupt_disable();
+    _PAYLOAD_HEADER(payload)->ref ++;
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rtgui_event_payload_ref);
+
+void rtgui_event_payload_unref(void *payload)
+{
+    rt_base_t level;
+    rt_uint16_t ref;
+    struct rtgui_event_payload *header;
+
+    if (payload == RT_NULL) return;
+
+    header = _PAYLOAD_HEADER(payload);
+    level = rt_hw_interrupt_disable();
+    RT_ASSERT(header->ref > 0);
+    ref = -- header->ref;
+    rt_hw_interrupt_enable(level);
+
+    if (ref == 0)
+    {
+        if (header->pooled)
+            rt_mp_free(header);
+        else
+            rtgui_free(header);
+    }
+}
+RTM_EXPORT(rtgui_event_payload_unref);
+
+void *rtgui_event_get_payload(struct rtgui_event *event)
+{
+    RT_ASSERT(event != RT_NULL);
+
+    switch (event->type)
+    {
+    case RTGUI_EVENT_COMMAND:
+        return ((struct rtgui_event_command *)event)->command_string;
+
+    default:
+        break;
+    }
+
+    return RT_NULL;
+}
+RTM_EXPORT(rtgui_event_get_payload);
+
+rt_err_t rtgui_event_command_set_string(struct rtgui_event_command *event, const char *string)
+{
+    rt_size_t length;
+
+    RT_ASSERT(event != RT_NULL);
+
+    rtgui_event_payload_unref(event->command_string);
+    event->command_string = RT_NULL;
+    if (string == RT_NULL)
+        return RT_EOK;
+
+    length = rt_strlen(string) + 1;
+    event->command_string = (char *)rtgui_event_payload_alloc(length);
+    if (event->command_string == RT_NULL)
+        return -RT_ENOMEM;
+    rt_memcpy(event->command_string, string, length);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_event_command_set_string);
@@ -104,6 +104,196 @@ static int stdio_close(struct rtgui_filerw *context)
     return -1;
 }
 
+/*
+ * The read-only file in the blocks of buffer. The file position of fd is
+ * always at the end of the buffer, so a sequential fill needs no lseek.
+ */
+struct rtgui_filerw_block
+{
+    /* inherit from rtgui_filerw */
+    struct rtgui_filerw parent;
+
+    int fd;
+    rt_bool_t eof;
+
+    /* the read position in file */
+    rt_off_t offset;
+    /* the file offset of buffer and the bytes in it */
+    rt_off_t base;
+    rt_size_t length;
+
+    rt_size_t size;
+    rt_uint8_t *buffer;
+};
+
+static int block_seek(struct rtgui_filerw *context, rt_off_t offset, int whence)
+{
+    int end;
+    struct rtgui_filerw_block *rw = (struct rtgui_filerw_block *)context;
+
+    switch (whence)
+    {
+    case RTGUI_FILE_SEEK_SET:
+        break;
+
+    case RTGUI_FILE_SEEK_CUR:
+        offset += rw->offset;
+        break;
+
+    case RTGUI_FILE_SEEK_END:
+        end = lseek(rw->fd, 0, SEEK_END);
+        if (end < 0)
+            return -1;
+        /* the buffer is dropped with the file position moved */
+        rw->base = end;
+        rw->length = 0;
+        offset += end;
+        break;
+
+    default:
+        return -1;
+    }
+
+    if (offset < 0)
+        return -1;
+
+    rw->offset = offset;
+    rw->eof = RT_FALSE;
+    return offset;
+}
+
+/* read the block from the file offset into buffer */
+static void block_fill(struct rtgui_filerw_block *rw, rt_off_t start)
+{
+    int result;
+
+    if (start != rw->base + (rt_off_t)rw->length &&
+            lseek(rw->fd, start, SEEK_SET) != start)
+    {
+        /* the file position is unknown, seek it in the next fill */
+        rw->base = -1;
+        rw->length = 0;
+        return;
+    }
+
+    result = read(rw->fd, rw->buffer, rw->size);
+    rw->base = start;
+    rw->length = result > 0 ? result : 0;
+}
+
+static int block_read(struct rtgui_filerw *context, void *ptr, rt_size_t size, rt_size_t maxnum)
+{
+    int result;
+    rt_size_t total, count;
+    rt_uint8_t *dst = (rt_uint8_t *)ptr;
+    struct rtgui_filerw_block *rw = (struct rtgui_filerw_block *)context;
+
+    /* end of file */
+    if (rw->eof == RT_TRUE) return -1;
+
+    total = size * maxnum;
+    while (total > 0)
+    {
+        if (rw->offset >= rw->base && rw->offset < rw->base + (rt_off_t)rw->length)
+        {
+            count = rw->base + rw->length - rw->offset;
+            if (count > total) count = total;
+
+            memcpy(dst, rw->buffer + (rw->offset - rw->base), count);
+        }
+        else if (total >= rw->size)
+        {
+            /* the large read is not copied through the buffer */
+            if (rw->offset != rw->base + (rt_off_t)rw->length &&
+                    lseek(rw->fd, rw->offset, SEEK_SET) != rw->offset)
+                break;
+
+            result = read(rw->fd, dst, total);
+            rw->base = rw->offset + (result > 0 ? result : 0);
+            rw->length = 0;
+            if (result <= 0)
+            {
+                rw->eof = RT_TRUE;
+                break;
+            }
+            count = result;
+        }
+        else
+        {
+            block_fill(rw, rw->offset - rw->offset % rw->size);
+            if (rw->offset < rw->base || rw->offset >= rw->base + (rt_off_t)rw->length)
+            {
+                rw->eof = RT_TRUE;
+                break;
+            }
+            continue;
+        }
+
+        dst += count;
+        total -= count;
+        rw->offset += count;
+    }
+
+    return dst - (rt_uint8_t *)ptr;
+}
+
+static int block_write(struct rtgui_filerw *context, const void *ptr, rt_size_t size, rt_size_t num)
+{
+    return 0; /* not support buffered write */
+}
+
+static int block_tell(struct rtgui_filerw *context)
+{
+    struct rtgui_filerw_block *rw = (struct rtgui_filerw_block *)context;
+
+    return rw->offset;
+}
+
+static int block_eof(struct rtgui_filerw *context)
+{
+    struct rtgui_filerw_block *rw = (struct rtgui_filerw_block *)context;
+
+    return rw->eof == RT_TRUE ? 1 : -1;
+}
+
+static const void *block_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length)
+{
+    rt_off_t start;
+    struct rtgui_filerw_block *rw = (struct rtgui_filerw_block *)context;
+
+    if (offset < 0 || length > rw->size)
+        return RT_NULL;
+
+    if (offset < rw->base || offset + (rt_off_t)length > rw->base + (rt_off_t)rw->length)
+    {
+        /* the aligned block, or the block from offset if it's crossed */
+        start = offset - offset % rw->size;
+        if (offset + (rt_off_t)length > start + (rt_off_t)rw->size)
+            start = offset;
+        block_fill(rw, start);
+
+        if (offset < rw->base || offset + (rt_off_t)length > rw->base + (rt_off_t)rw->length)
+            return RT_NULL;
+    }
+
+    return rw->buffer + (offset - rw->base);
+}
+
+static int block_close(struct rtgui_filerw *context)
+{
+    struct rtgui_filerw_block *rw = (struct rtgui_filerw_block *)context;
+
+    if (rw)
+    {
+        close(rw->fd);
+        rtgui_free(rw);
+
+        return 0;
+    }
+
+    return -1;
+}
+
 #endif
 
 /* memory file read/write */
@@ -191,6 +381,16 @@ static int mem_eof(struct rtgui_filerw *context)
     return mem->mem_position >= mem->mem_end;
 }
 
+static const void *mem_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length)
+{
+    struct rtgui_filerw_mem *mem = (struct rtgui_filerw_mem *)context;
+
+    if (offset < 0 || offset + length > (rt_size_t)(mem->mem_end - mem->mem_base))
+        return RT_NULL;
+
+    return mem->mem_base + offset;
+}
+
 static int mem_close(struct rtgui_filerw *context)
 {
     struct rtgui_filerw_mem *mem = (struct rtgui_filerw_mem *)context;
@@ -204,6 +404,151 @@ static int mem_close(struct rtgui_filerw *context)
     return -1;
 }
 
+/* scattered memory read, the position is the segment and the offset in it */
+struct rtgui_filerw_iov
+{
+    /* inherit from rtgui_filerw */
+    struct rtgui_filerw parent;
+
+    int count;
+    rt_size_t size;
+    /* the position, and the file offset of current segment */
+    rt_size_t position;
+    int segment;
+    rt_size_t segment_base;
+
+    /* struct rtgui_filerw_iovec iov[count]; */
+};
+#define _filerw_iov(rw)     ((struct rtgui_filerw_iovec *)((rw) + 1))
+
+/* move the current segment to the one of position */
+static void iov_locate(struct rtgui_filerw_iov *rw)
+{
+    struct rtgui_filerw_iovec *iov = _filerw_iov(rw);
+
+    if (rw->position < rw->segment_base)
+    {
+        rw->segment = 0;
+        rw->segment_base = 0;
+    }
+    while (rw->segment < rw->count &&
+            rw->position >= rw->segment_base + iov[rw->segment].length)
+    {
+        rw->segment_base += iov[rw->segment].length;
+        rw->segment ++;
+    }
+}
+
+static int iov_seek(struct rtgui_filerw *context, rt_off_t offset, int whence)
+{
+    struct rtgui_filerw_iov *rw = (struct rtgui_filerw_iov *)context;
+
+    switch (whence)
+    {
+    case RTGUI_FILE_SEEK_SET:
+        break;
+    case RTGUI_FILE_SEEK_CUR:
+        offset += rw->position;
+        break;
+    case RTGUI_FILE_SEEK_END:
+        offset += rw->size;
+        break;
+    default:
+        return -1;
+    }
+
+    if (offset < 0)
+        offset = 0;
+    if (offset > (rt_off_t)rw->size)
+        offset = rw->size;
+
+    rw->position = offset;
+    iov_locate(rw);
+    return offset;
+}
+
+static int iov_read(struct rtgui_filerw *context, void *ptr, rt_size_t size, rt_size_t maxnum)
+{
+    rt_size_t total, count, offset, remain;
+    rt_uint8_t *dst = (rt_uint8_t *)ptr;
+    struct rtgui_filerw_iov *rw = (struct rtgui_filerw_iov *)context;
+    struct rtgui_filerw_iovec *iov = _filerw_iov(rw);
+
+    total = maxnum * size;
+    if ((maxnum <= 0) || (size <= 0) || ((total / maxnum) != size))
+        return -1;
+
+    if (total > rw->size - rw->position)
+        total = rw->size - rw->position;
+    /* the whole items */
+    total -= total % size;
+
+    remain = total;
+    while (remain > 0 && rw->segment < rw->count)
+    {
+        offset = rw->position - rw->segment_base;
+        count = iov[rw->segment].length - offset;
+        if (count > remain) count = remain;
+
+        memcpy(dst, (const rt_uint8_t *)iov[rw->segment].base + offset, count);
+        dst += count;
+        remain -= count;
+        rw->position += count;
+        iov_locate(rw);
+    }
+
+    return (total / size);
+}
+
+static int iov_tell(struct rtgui_filerw *context)
+{
+    return ((struct rtgui_filerw_iov *)context)->position;
+}
+
+static int iov_eof(struct rtgui_filerw *context)
+{
+    struct rtgui_filerw_iov *rw = (struct rtgui_filerw_iov *)context;
+
+    return rw->position >= rw->size;
+}
+
+/* the bytes in one segment are mapped */
+static const void *iov_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length)
+{
+    int segment;
+    rt_size_t base;
+    struct rtgui_filerw_iov *rw = (struct rtgui_filerw_iov *)context;
+    struct rtgui_filerw_iovec *iov = _filerw_iov(rw);
+
+    if (offset < 0 || offset + length > rw->size)
+        return RT_NULL;
+
+    for (segment = 0, base = 0; segment < rw->count; segment ++)
+    {
+        if ((rt_size_t)offset < base + iov[segment].length)
+        {
+            if (offset + length > base + iov[segment].length)
+                return RT_NULL;
+
+            return (const rt_uint8_t *)iov[segment].base + (offset - base);
+        }
+        base += iov[segment].length;
+    }
+
+    return RT_NULL;
+}
+
+static int iov_close(struct rtgui_filerw *context)
+{
+    if (context != RT_NULL)
+    {
+        rtgui_free(context);
+        return 0;
+    }
+
+    return -1;
+}
+
 const rt_uint8_t *rtgui_filerw_mem_getdata(struct rtgui_filerw *context)
 {
     struct rtgui_filerw_mem *mem = (struct rtgui_filerw_mem *)context;
@@ -272,6 +617,7 @@ struct rtgui_filerw *rtgui_filerw_create_file(const char *filename, const char *
             rw->parent.tell  = stdio_tell;
             rw->parent.close = stdio_close;
             rw->parent.eof   = stdio_eof;
+            rw->parent.map   = RT_NULL;
 
             rw->fd  = fd;
             rw->eof = RT_FALSE;
@@ -288,6 +634,50 @@ struct rtgui_filerw *rtgui_filerw_create_file(const char *filename, const char *
     return RT_NULL;
 }
 
+struct rtgui_filerw *rtgui_filerw_create_buffered(const char *filename, rt_size_t block_size)
+{
+    int fd;
+    struct rtgui_filerw_block *rw;
+
+    RT_ASSERT(filename != RT_NULL);
+
+    if (block_size == 0)
+        block_size = GUIENGINE_FILERW_BLOCK_SIZE;
+
+#ifdef _WIN32_NATIVE
+    fd = _open(filename, O_RDONLY | O_BINARY, 0);
+#else
+    fd = open(filename, O_RDONLY | O_BINARY, 0);
+#endif
+    if (fd < 0)
+        return RT_NULL;
+
+    rw = (struct rtgui_filerw_block *) rtgui_malloc(sizeof(struct rtgui_filerw_block) + block_size);
+    if (rw == RT_NULL)
+    {
+        close(fd);
+        return RT_NULL;
+    }
+
+    rw->parent.seek  = block_seek;
+    rw->parent.read  = block_read;
+    rw->parent.write = block_write;
+    rw->parent.tell  = block_tell;
+    rw->parent.close = block_close;
+    rw->parent.eof   = block_eof;
+    rw->parent.map   = block_map;
+
+    rw->fd = fd;
+    rw->eof = RT_FALSE;
+    rw->offset = 0;
+    rw->base = 0;
+    rw->length = 0;
+    rw->size = block_size;
+    rw->buffer = (rt_uint8_t *)(rw + 1);
+
+    return &(rw->parent);
+}
+
 int rtgui_filerw_unlink(const char *filename)
 {
 #ifdef _WIN32_NATIVE
@@ -318,6 +708,7 @@ struct rtgui_filerw *rtgui_filerw_create_mem(const rt_uint8_t *mem, rt_size_t si
         rw->parent.tell  = mem_tell;
         rw->parent.eof   = mem_eof;
         rw->parent.close = mem_close;
+        rw->parent.map   = mem_map;
 
         rw->mem_base = mem;
         rw->mem_position = mem;
@@ -327,6 +718,40 @@ struct rtgui_filerw *rtgui_filerw_create_mem(const rt_uint8_t *mem, rt_size_t si
     return &(rw->parent);
 }
 
+struct rtgui_filerw *rtgui_filerw_create_iovec(const struct rtgui_filerw_iovec *iov, int count)
+{
+    int index;
+    struct rtgui_filerw_iov *rw;
+
+    RT_ASSERT(iov != RT_NULL && count > 0);
+
+    rw = (struct rtgui_filerw_iov *) rtgui_malloc(sizeof(struct rtgui_filerw_iov) +
+                                                 count * sizeof(struct rtgui_filerw_iovec));
+    if (rw == RT_NULL)
+        return RT_NULL;
+
+    rw->parent.seek  = iov_seek;
+    rw->parent.read  = iov_read;
+    rw->parent.write = mem_write;
+    rw->parent.tell  = iov_tell;
+    rw->parent.eof   = iov_eof;
+    rw->parent.close = iov_close;
+    rw->parent.map   = iov_map;
+
+    rt_memcpy(_filerw_iov(rw), iov, count * sizeof(struct rtgui_filerw_iovec));
+    rw->count = count;
+    rw->size = 0;
+    for (index = 0; index < count; index ++)
+        rw->size += iov[index].length;
+    rw->position = 0;
+    rw->segment = 0;
+    rw->segment_base = 0;
+    /* skip the empty segments at the head */
+    iov_locate(rw);
+
+    return &(rw->parent);
+}
+
 int rtgui_filerw_seek(struct rtgui_filerw *context, rt_off_t offset, int whence)
 {
     RT_ASSERT(context != RT_NULL);
@@ -362,6 +787,16 @@ int rtgui_filerw_tell(struct rtgui_filerw *context)
     return context->tell(context);
 }
 
+const void *rtgui_filerw_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length)
+{
+    RT_ASSERT(context != RT_NULL);
+
+    if (context->map == RT_NULL)
+        return RT_NULL;
+
+    return context->map(context, offset, length);
+}
+
 int rtgui_filerw_close(struct rtgui_filerw *context)
 {
     int result;
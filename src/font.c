@@ -23,12 +23,47 @@
  * 2013-08-31     Bernard      remove the default font setting.
  *                             (which set by theme)
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
 #include <rtgui/font.h>
+#include <rtgui/font_atlas.h>
 #include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
 
 static rtgui_list_t _rtgui_font_list;
 static struct rtgui_font *rtgui_default_font;
 
+#if GUIENGINE_FONT_METRICS_CACHE > 0
+/* the longest text which metrics is cached */
+#define FONT_METRICS_TEXT_MAX   32
+
+/* the metrics of the text measured recently, layout measures the same
+ * label again and again */
+struct font_metrics
+{
+    struct rtgui_font *font;
+    rt_uint32_t hash;
+    rt_uint32_t stamp;
+    rtgui_rect_t rect;
+    char text[FONT_METRICS_TEXT_MAX + 1];
+};
+static struct font_metrics _font_metrics[GUIENGINE_FONT_METRICS_CACHE];
+static rt_uint32_t _font_metrics_stamp;
+#endif
+
+#if GUIENGINE_FONT_ADVANCE_CACHE > 0
+/* the advances of ascii in the bitmap fonts measured recently, the positions
+ * of text are summed in the table instead of the engine callbacks */
+struct font_advance
+{
+    struct rtgui_font *font;
+    rt_uint32_t stamp;
+    rt_uint16_t advance[128];
+};
+static struct font_advance _font_advances[GUIENGINE_FONT_ADVANCE_CACHE];
+static rt_uint32_t _font_advance_stamp;
+#endif
+
 extern struct rtgui_font rtgui_font_asc16;
 extern struct rtgui_font rtgui_font_arial16;
 extern struct rtgui_font rtgui_font_asc12;
@@ -38,9 +73,83 @@ extern struct rtgui_font rtgui_font_hz16;
 extern struct rtgui_font rtgui_font_hz12;
 #endif
 
+#ifdef GUIENGINE_USING_LAZY_INIT
+/* the fonts are loaded one by one at the first use */
+static struct rt_mutex _font_load_lock;
+static rt_uint8_t _font_deferred = 0;
+#endif
+
+#ifdef GUIENGINE_USING_HZ_FILE
+/* the hz font without the file and the map is removed */
+static rt_bool_t _font_hz_file_check(struct rtgui_font *font)
+{
+    struct rtgui_hz_file_font *hz_file_font;
+
+    if (font->engine != &rtgui_hz_file_font_engine)
+        return RT_TRUE;
+
+    hz_file_font = (struct rtgui_hz_file_font *)font->data;
+    if (hz_file_font->fd < 0 && hz_file_font->font_map == RT_NULL)
+    {
+        rtgui_font_system_remove_font(font);
+        return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+#else
+rt_inline rt_bool_t _font_hz_file_check(struct rtgui_font *font)
+{
+    return RT_TRUE;
+}
+#endif
+
+static void _font_engine_load(struct rtgui_font *font)
+{
+    /* init font */
+    if (font->engine->font_init != RT_NULL)
+        font->engine->font_init(font);
+
+    /* first refer, load it */
+    if (font->engine->font_load != RT_NULL)
+        font->engine->font_load(font);
+
+    font->loaded = 1;
+}
+
+#ifdef GUIENGINE_USING_LAZY_INIT
+/* load the font at the first use, return RT_FALSE if it's removed for the failure */
+static rt_bool_t _font_load(struct rtgui_font *font)
+{
+    rt_bool_t result = RT_TRUE;
+
+    if (font->loaded)
+        return RT_TRUE;
+
+    rt_mutex_take(&_font_load_lock, RT_WAITING_FOREVER);
+    if (!font->loaded)
+    {
+        _font_engine_load(font);
+        result = _font_hz_file_check(font);
+    }
+    rt_mutex_release(&_font_load_lock);
+
+    return result;
+}
+#else
+rt_inline rt_bool_t _font_load(struct rtgui_font *font)
+{
+    return RT_TRUE;
+}
+#endif
+
 void rtgui_font_system_init(void)
 {
     rtgui_list_init(&(_rtgui_font_list));
+#ifdef GUIENGINE_USING_LAZY_INIT
+    rt_mutex_init(&_font_load_lock, "font", RT_IPC_FLAG_FIFO);
+#endif
+    rtgui_font_atlas_init();
 
     /* set default font to NULL */
     rtgui_default_font = RT_NULL;
@@ -49,13 +158,9 @@ void rtgui_font_system_init(void)
     rtgui_font_system_add_font(&rtgui_font_asc16);
 #ifdef GUIENGINE_USING_FONTHZ
     rtgui_font_system_add_font(&rtgui_font_hz16);
-    {
-        struct rtgui_hz_file_font *hz16 = (struct rtgui_hz_file_font *)rtgui_font_hz16.data;
-        if (hz16->fd < 0)
-        {
-            rtgui_font_system_remove_font(&rtgui_font_hz16);
-        }
-    }
+#ifndef GUIENGINE_USING_LAZY_INIT
+    _font_hz_file_check(&rtgui_font_hz16);
+#endif
 #endif
 #endif
 
@@ -63,13 +168,9 @@ void rtgui_font_system_init(void)
     rtgui_font_system_add_font(&rtgui_font_asc12);
 #ifdef GUIENGINE_USING_FONTHZ
     rtgui_font_system_add_font(&rtgui_font_hz12);
-    {
-        struct rtgui_hz_file_font *hz12 = (struct rtgui_hz_file_font *)rtgui_font_hz12.data;
-        if (hz12->fd < 0)
-        {
-            rtgui_font_system_remove_font(&rtgui_font_hz12);
-        }
-    }
+#ifndef GUIENGINE_USING_LAZY_INIT
+    _font_hz_file_check(&rtgui_font_hz12);
+#endif
 #endif
 #endif
 }
@@ -101,19 +202,51 @@ void rtgui_font_system_add_font(struct rtgui_font *font)
     rtgui_list_init(&(font->list));
     rtgui_list_append(&_rtgui_font_list, &(font->list));
 
-    /* init font */
-    if (font->engine->font_init != RT_NULL)
-        font->engine->font_init(font);
-
-    /* first refer, load it */
-    if (font->engine->font_load != RT_NULL)
-        font->engine->font_load(font);
+#ifdef GUIENGINE_USING_LAZY_INIT
+    /* only registered, it's loaded at the first use */
+    font->loaded = 0;
+#else
+    _font_engine_load(font);
+#endif
 }
 RTM_EXPORT(rtgui_font_system_add_font);
 
 void rtgui_font_system_remove_font(struct rtgui_font *font)
 {
     rtgui_list_remove(&_rtgui_font_list, &(font->list));
+
+    /* the glyphs are keyed by the font data */
+    rtgui_font_atlas_remove(font->data);
+#ifdef GUIENGINE_USING_TEXT_CACHE
+    rtgui_dc_text_cache_remove(font);
+#endif
+
+#if GUIENGINE_FONT_METRICS_CACHE > 0
+    {
+        int index;
+
+        rtgui_enter_critical();
+        for (index = 0; index < GUIENGINE_FONT_METRICS_CACHE; index ++)
+        {
+            if (_font_metrics[index].font == font)
+                _font_metrics[index].font = RT_NULL;
+        }
+        rtgui_exit_critical();
+    }
+#endif
+#if GUIENGINE_FONT_ADVANCE_CACHE > 0
+    {
+        int index;
+
+        rtgui_enter_critical();
+        for (index = 0; index < GUIENGINE_FONT_ADVANCE_CACHE; index ++)
+        {
+            if (_font_advances[index].font == font)
+                _font_advances[index].font = RT_NULL;
+        }
+        rtgui_exit_critical();
+    }
+#endif
 }
 RTM_EXPORT(rtgui_font_system_remove_font);
 
@@ -140,6 +273,9 @@ struct rtgui_font *rtgui_font_refer(const char *family, rt_uint16_t height)
         if ((rt_strncmp(font->family, family, GUIENGINE_NAME_MAX) == 0) &&
                 font->height == height)
         {
+            if (_font_load(font) == RT_FALSE)
+                return RT_NULL;
+
             font->refer_count ++;
             return font;
         }
@@ -164,14 +300,35 @@ void rtgui_font_derefer(struct rtgui_font *font)
 RTM_EXPORT(rtgui_font_derefer);
 
 /* draw a text */
+#ifdef GUIENGINE_USING_PROFILE
+/* the glyphs are the characters of UTF-8 */
+static rt_uint32_t _font_glyphs(const char *text, rt_ubase_t len)
+{
+    rt_uint32_t glyphs = 0;
+
+    while (len --)
+    {
+        if (((rt_uint8_t)*text & 0xC0) != 0x80) glyphs ++;
+        text ++;
+    }
+
+    return glyphs;
+}
+#endif
+
 void rtgui_font_draw(struct rtgui_font *font, struct rtgui_dc *dc, const char *text, rt_ubase_t len, struct rtgui_rect *rect)
 {
     RT_ASSERT(font != RT_NULL);
+    _font_load(font);
 
     if (font->engine != RT_NULL &&
             font->engine->font_draw_text != RT_NULL)
     {
+        RTGUI_PROFILE_DECLARE;
+
+        RTGUI_PROFILE_BEGIN();
         font->engine->font_draw_text(font, dc, text, len, rect);
+        RTGUI_PROFILE_END(RTGUI_PROFILE_FONT, _font_glyphs(text, len));
     }
 }
 
@@ -186,13 +343,96 @@ int rtgui_font_get_string_width(struct rtgui_font *font, const char *text)
 }
 RTM_EXPORT(rtgui_font_get_string_width);
 
+#if GUIENGINE_FONT_METRICS_CACHE > 0
+/* get the hash of text, return RT_FALSE if the text is too long to cache */
+static rt_bool_t _font_metrics_hash(const char *text, rt_uint32_t *hash)
+{
+    int len;
+    rt_uint32_t value = 2166136261u;
+
+    for (len = 0; text[len] != '\0'; len ++)
+    {
+        if (len == FONT_METRICS_TEXT_MAX) return RT_FALSE;
+        value = (value ^ (rt_uint8_t)text[len]) * 16777619u;
+    }
+    *hash = value;
+
+    return RT_TRUE;
+}
+
+static rt_bool_t _font_metrics_find(struct rtgui_font *font, const char *text, rt_uint32_t hash,
+                                    rtgui_rect_t *rect)
+{
+    int index;
+    rt_bool_t found = RT_FALSE;
+
+    rtgui_enter_critical();
+    for (index = 0; index < GUIENGINE_FONT_METRICS_CACHE; index ++)
+    {
+        struct font_metrics *metrics = &_font_metrics[index];
+
+        if (metrics->font == font && metrics->hash == hash &&
+                rt_strncmp(metrics->text, text, FONT_METRICS_TEXT_MAX) == 0)
+        {
+            metrics->stamp = ++ _font_metrics_stamp;
+            *rect = metrics->rect;
+            found = RT_TRUE;
+            break;
+        }
+    }
+    rtgui_exit_critical();
+
+    return found;
+}
+
+static void _font_metrics_add(struct rtgui_font *font, const char *text, rt_uint32_t hash,
+                              const rtgui_rect_t *rect)
+{
+    int index;
+    struct font_metrics *metrics;
+
+    rtgui_enter_critical();
+    /* replace the least recently used one */
+    metrics = &_font_metrics[0];
+    for (index = 1; index < GUIENGINE_FONT_METRICS_CACHE; index ++)
+    {
+        if (metrics->font == RT_NULL) break;
+        if (_font_metrics[index].font == RT_NULL ||
+                _font_metrics[index].stamp < metrics->stamp)
+            metrics = &_font_metrics[index];
+    }
+
+    metrics->font = font;
+    metrics->hash = hash;
+    metrics->stamp = ++ _font_metrics_stamp;
+    metrics->rect = *rect;
+    rt_strncpy(metrics->text, text, FONT_METRICS_TEXT_MAX);
+    metrics->text[FONT_METRICS_TEXT_MAX] = '\0';
+    rtgui_exit_critical();
+}
+#endif
+
 void rtgui_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
 {
     RT_ASSERT(font != RT_NULL);
+    _font_load(font);
 
     if (font->engine != RT_NULL &&
             font->engine->font_get_metrics != RT_NULL)
     {
+#if GUIENGINE_FONT_METRICS_CACHE > 0
+        rt_uint32_t hash;
+
+        if (_font_metrics_hash(text, &hash) == RT_TRUE)
+        {
+            if (_font_metrics_find(font, text, hash, rect) == RT_TRUE)
+                return;
+
+            font->engine->font_get_metrics(font, text, rect);
+            _font_metrics_add(font, text, hash, rect);
+            return;
+        }
+#endif
         font->engine->font_get_metrics(font, text, rect);
     }
     else
@@ -203,6 +443,460 @@ void rtgui_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rec
 }
 RTM_EXPORT(rtgui_font_get_metrics);
 
+struct rtgui_text_run *rtgui_text_run_create(struct rtgui_font *font, const char *text, rt_ubase_t len)
+{
+    struct rtgui_text_run *run;
+
+    RT_ASSERT(font != RT_NULL);
+    RT_ASSERT(text != RT_NULL);
+    _font_load(font);
+
+    run = (struct rtgui_text_run *)rtgui_malloc(sizeof(struct rtgui_text_run) + len + 1);
+    if (run == RT_NULL)
+        return RT_NULL;
+
+    run->font = font;
+    run->data = RT_NULL;
+    run->len = len;
+    rt_memcpy(run + 1, text, len);
+    ((char *)(run + 1))[len] = '\0';
+
+    /* keep the font until the run is destroyed */
+    font->refer_count ++;
+
+    if (font->engine != RT_NULL &&
+            font->engine->font_prepare_text != RT_NULL &&
+            font->engine->font_prepare_text(font, run) == RT_EOK)
+        return run;
+
+    /* the text is drawn by the font engine each time */
+    run->data = RT_NULL;
+    rtgui_font_get_metrics(font, rtgui_text_run_text(run), &run->metrics);
+
+    return run;
+}
+RTM_EXPORT(rtgui_text_run_create);
+
+void rtgui_text_run_destroy(struct rtgui_text_run *run)
+{
+    RT_ASSERT(run != RT_NULL);
+
+    rtgui_free(run->data);
+    rtgui_font_derefer(run->font);
+    rtgui_free(run);
+}
+RTM_EXPORT(rtgui_text_run_destroy);
+
+void rtgui_font_draw_text_run(struct rtgui_text_run *run, struct rtgui_dc *dc, struct rtgui_rect *rect)
+{
+    struct rtgui_font *font;
+
+    RT_ASSERT(run != RT_NULL);
+
+    font = run->font;
+    if (run->data != RT_NULL)
+    {
+        RTGUI_PROFILE_DECLARE;
+
+        RTGUI_PROFILE_BEGIN();
+        font->engine->font_draw_text_run(font, dc, run, rect);
+        RTGUI_PROFILE_END(RTGUI_PROFILE_FONT, _font_glyphs(rtgui_text_run_text(run), run->len));
+    }
+    else
+        rtgui_font_draw(font, dc, rtgui_text_run_text(run), run->len, rect);
+}
+RTM_EXPORT(rtgui_font_draw_text_run);
+
+/* the characters are drawn in chunks, so the atlas is not locked for long */
+#define FONT_PREWARM_CHUNK      32
+
+struct font_prewarm
+{
+    struct rtgui_font *font;
+    rt_ubase_t len;
+    /* the prewarm is canceled when the serial is changed */
+    rt_uint32_t serial;
+
+    /* char charset[len + 1]; */
+};
+
+/* get the bytes of the character at text */
+rt_inline rt_ubase_t _font_char_len(const char *text)
+{
+    rt_uint8_t ch = (rt_uint8_t)*text;
+
+#ifdef GUIENGINE_TTF_UTF8
+    if (ch < 0x80) return 1;
+    else if ((ch & 0xe0) == 0xc0) return 2;
+    else if ((ch & 0xf0) == 0xe0) return 3;
+    return 4;
+#else
+    return ch < 0x80 ? 1 : 2;
+#endif
+}
+
+rt_ubase_t rtgui_font_char_len(const char *text)
+{
+    return _font_char_len(text);
+}
+RTM_EXPORT(rtgui_font_char_len);
+
+/* get the length of the whole characters in a chunk */
+static rt_ubase_t _font_prewarm_chunk(const char *text, rt_ubase_t len)
+{
+    rt_ubase_t pos = 0;
+
+    while (pos < len && pos < FONT_PREWARM_CHUNK)
+        pos += _font_char_len(text + pos);
+
+    return pos > len ? len : pos;
+}
+
+static volatile rt_uint32_t _font_prewarm_serial = 0;
+
+static void _font_prewarm_entry(void *parameter)
+{
+    char *text, saved;
+    rt_ubase_t len, length;
+    struct rtgui_dc *dc;
+    struct rtgui_rect rect;
+    struct font_prewarm *prewarm = (struct font_prewarm *)parameter;
+
+    /* the glyphs are drawn out of a tiny buffer, which only loads them */
+    dc = rtgui_dc_buffer_create(1, 1);
+    if (dc != RT_NULL)
+    {
+        text = (char *)(prewarm + 1);
+        len = prewarm->len;
+        while (len && prewarm->serial == _font_prewarm_serial)
+        {
+            length = _font_prewarm_chunk(text, len);
+
+            /* the metrics of font engine is measured until '\0' */
+            saved = text[length];
+            text[length] = '\0';
+            rect.x1 = rect.y1 = 0;
+            rect.x2 = 0x7fff;
+            rect.y2 = prewarm->font->height;
+            rtgui_font_draw(prewarm->font, dc, text, length, &rect);
+            text[length] = saved;
+
+            text += length;
+            len -= length;
+        }
+        rtgui_dc_destory(dc);
+    }
+
+    rtgui_font_derefer(prewarm->font);
+    rtgui_free(prewarm);
+}
+
+rt_err_t rtgui_font_prewarm(struct rtgui_font *font, const char *charset)
+{
+    rt_ubase_t len;
+    rt_thread_t tid;
+    struct font_prewarm *prewarm;
+
+    RT_ASSERT(font != RT_NULL);
+    RT_ASSERT(charset != RT_NULL);
+
+    len = rt_strlen(charset);
+    prewarm = (struct font_prewarm *)rtgui_malloc(sizeof(struct font_prewarm) + len + 1);
+    if (prewarm == RT_NULL)
+        return -RT_ENOMEM;
+
+    prewarm->font = font;
+    prewarm->len = len;
+    prewarm->serial = _font_prewarm_serial;
+    rt_memcpy(prewarm + 1, charset, len + 1);
+
+    /* keep the font until the charset is loaded */
+    font->refer_count ++;
+
+    tid = rt_thread_create("fprewarm", _font_prewarm_entry, prewarm,
+                           GUIENGINE_FONT_PREWARM_STACK_SIZE,
+                           GUIENGINE_FONT_PREWARM_PRIORITY,
+                           GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid == RT_NULL)
+    {
+        rtgui_font_derefer(font);
+        rtgui_free(prewarm);
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(tid);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_font_prewarm);
+
+#ifdef GUIENGINE_USING_LAZY_INIT
+/* the font not loaded yet is referred in the lock, the list is changed by the apps */
+static struct rtgui_font *_font_deferred_next(void)
+{
+    struct rtgui_list_node *node;
+    struct rtgui_font *font;
+
+    rtgui_enter_critical();
+    rtgui_list_foreach(node, &_rtgui_font_list)
+    {
+        font = rtgui_list_entry(node, struct rtgui_font, list);
+        if (!font->loaded)
+        {
+            font->refer_count ++;
+            rtgui_exit_critical();
+            return font;
+        }
+    }
+    rtgui_exit_critical();
+
+    return RT_NULL;
+}
+
+static void _font_deferred_entry(void *parameter)
+{
+    struct rtgui_rect rect;
+    struct rtgui_font *font;
+
+    while ((font = _font_deferred_next()) != RT_NULL)
+    {
+        /* the face of TTF is opened by the first measure */
+        rtgui_font_get_metrics(font, " ", &rect);
+        rtgui_font_derefer(font);
+    }
+}
+
+void rtgui_font_system_load_deferred(void)
+{
+    rt_thread_t tid;
+
+    if (_font_deferred)
+        return;
+
+    rtgui_enter_critical();
+    if (_font_deferred)
+    {
+        rtgui_exit_critical();
+        return;
+    }
+    _font_deferred = 1;
+    rtgui_exit_critical();
+
+    tid = rt_thread_create("fdefer", _font_deferred_entry, RT_NULL,
+                           GUIENGINE_FONT_PREWARM_STACK_SIZE,
+                           GUIENGINE_FONT_PREWARM_PRIORITY,
+                           GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid != RT_NULL)
+        rt_thread_startup(tid);
+}
+RTM_EXPORT(rtgui_font_system_load_deferred);
+#endif
+
+void rtgui_font_prewarm_cancel(void)
+{
+    _font_prewarm_serial ++;
+}
+RTM_EXPORT(rtgui_font_prewarm_cancel);
+
+/* get the width of text in [text, text + len) */
+static int _text_layout_width(struct rtgui_font *font, char *text, rt_ubase_t len)
+{
+    char saved;
+    struct rtgui_rect rect;
+
+    /* the metrics of font engine is measured until '\0' */
+    saved = text[len];
+    text[len] = '\0';
+    rtgui_font_get_metrics(font, text, &rect);
+    text[len] = saved;
+
+    return rtgui_rect_width(rect);
+}
+
+static void _text_layout_clear(struct rtgui_text_layout *layout)
+{
+    int index;
+
+    for (index = 0; index < layout->count; index ++)
+        rtgui_text_run_destroy(layout->lines[index].run);
+    layout->count = 0;
+    layout->height = 0;
+}
+
+static rt_err_t _text_layout_add_line(struct rtgui_text_layout *layout, rt_ubase_t offset, rt_ubase_t len)
+{
+    struct rtgui_text_line *line;
+
+    /* the spaces at the end of line are not drawn */
+    while (len > 0 && layout->text[offset + len - 1] == ' ') len --;
+
+    if (layout->count == layout->capacity)
+    {
+        int capacity = layout->capacity ? layout->capacity * 2 : 8;
+
+        line = (struct rtgui_text_line *)rtgui_realloc(layout->lines, capacity * sizeof(struct rtgui_text_line));
+        if (line == RT_NULL) return -RT_ENOMEM;
+
+        layout->lines = line;
+        layout->capacity = capacity;
+    }
+
+    line = &layout->lines[layout->count];
+    line->offset = offset;
+    line->run = rtgui_text_run_create(layout->font, layout->text + offset, len);
+    if (line->run == RT_NULL) return -RT_ENOMEM;
+
+    layout->count ++;
+    layout->height += layout->font->height;
+
+    return RT_EOK;
+}
+
+/* break the text into lines in the width, the lines are broken after the
+ * spaces and around the non-ascii characters, or in a word which is wider
+ * than the line */
+static rt_err_t _text_layout_break(struct rtgui_text_layout *layout)
+{
+    char *text = layout->text;
+    rt_bool_t wrapped;
+    rt_ubase_t start, pos, next, fit, total;
+
+    _text_layout_clear(layout);
+
+    total = rt_strlen(text);
+    start = 0;
+    while (start < total)
+    {
+        /* the end of longest text fit in the line */
+        fit = start;
+        wrapped = RT_FALSE;
+        for (pos = start; pos < total && text[pos] != '\n'; pos = next)
+        {
+            rt_uint8_t ch = (rt_uint8_t)text[pos];
+            rt_uint8_t nch;
+            rt_ubase_t len;
+
+            next = pos + _font_char_len(text + pos);
+            if (next > total) next = total;
+            nch = (rt_uint8_t)text[next];
+
+            if (ch != ' ' && ch < 0x80 && nch != ' ' && nch != '\n' && nch != '\0' && nch < 0x80)
+                continue;
+
+            if (layout->width <= 0) continue;
+
+            /* the spaces at the end are not counted */
+            len = next - start;
+            while (len > 0 && text[start + len - 1] == ' ') len --;
+            if (_text_layout_width(layout->font, text + start, len) > layout->width)
+            {
+                wrapped = RT_TRUE;
+                if (fit > start) break;
+
+                /* the first word is too wide, break it in characters */
+                for (fit = start + _font_char_len(text + start); fit < pos; fit += len)
+                {
+                    len = _font_char_len(text + fit);
+                    if (_text_layout_width(layout->font, text + start, fit + len - start) > layout->width)
+                        break;
+                }
+                break;
+            }
+            fit = next;
+        }
+
+        if (wrapped == RT_FALSE)
+        {
+            /* the line is ended by new line or the end of text */
+            if (_text_layout_add_line(layout, start, pos - start) != RT_EOK)
+                return -RT_ENOMEM;
+            start = pos + 1;
+        }
+        else
+        {
+            if (_text_layout_add_line(layout, start, fit - start) != RT_EOK)
+                return -RT_ENOMEM;
+
+            /* skip the spaces at the begin of next line */
+            for (start = fit; text[start] == ' '; start ++);
+        }
+    }
+
+    return RT_EOK;
+}
+
+struct rtgui_text_layout *rtgui_text_layout_create(struct rtgui_font *font, const char *text, int width)
+{
+    struct rtgui_text_layout *layout;
+
+    layout = (struct rtgui_text_layout *)rtgui_malloc(sizeof(struct rtgui_text_layout));
+    if (layout == RT_NULL)
+        return RT_NULL;
+
+    rt_memset(layout, 0, sizeof(struct rtgui_text_layout));
+    if (rtgui_text_layout_set(layout, font, text, width) != RT_EOK)
+    {
+        rtgui_text_layout_destroy(layout);
+        return RT_NULL;
+    }
+
+    return layout;
+}
+RTM_EXPORT(rtgui_text_layout_create);
+
+void rtgui_text_layout_destroy(struct rtgui_text_layout *layout)
+{
+    RT_ASSERT(layout != RT_NULL);
+
+    _text_layout_clear(layout);
+    rtgui_free(layout->lines);
+    rtgui_free(layout->text);
+    rtgui_free(layout);
+}
+RTM_EXPORT(rtgui_text_layout_destroy);
+
+rt_err_t rtgui_text_layout_set(struct rtgui_text_layout *layout, struct rtgui_font *font,
+                               const char *text, int width)
+{
+    rt_ubase_t len;
+
+    RT_ASSERT(layout != RT_NULL);
+    RT_ASSERT(font != RT_NULL);
+    RT_ASSERT(text != RT_NULL);
+
+    /* the lines are kept if nothing is changed */
+    if (layout->font == font && layout->width == width &&
+            layout->text != RT_NULL && rt_strcmp(layout->text, text) == 0)
+        return RT_EOK;
+
+    if (layout->text == RT_NULL || rt_strcmp(layout->text, text) != 0)
+    {
+        char *copy;
+
+        len = rt_strlen(text);
+        copy = (char *)rtgui_malloc(len + 1);
+        if (copy == RT_NULL)
+        {
+            _text_layout_clear(layout);
+            return -RT_ENOMEM;
+        }
+        rt_memcpy(copy, text, len + 1);
+
+        rtgui_free(layout->text);
+        layout->text = copy;
+    }
+    layout->font = font;
+    layout->width = width;
+
+    if (_text_layout_break(layout) != RT_EOK)
+    {
+        _text_layout_clear(layout);
+        return -RT_ENOMEM;
+    }
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_text_layout_set);
+
 
 /* GB18030 encoding:
  *          1st byte    2nd byte    3rd byte    4th byte
@@ -255,3 +949,204 @@ struct rtgui_char_position _string_char_width(char *str, rt_size_t len, rt_size_
     pos.remain = pc - (unsigned char*)&str[offset];
     return pos;
 }
+
+/* the width of a character measured by the engine */
+static int _font_char_width(struct rtgui_font *font, const char *text, rt_ubase_t len)
+{
+    char buf[8];
+    struct rtgui_rect rect;
+
+    if (len > sizeof(buf) - 1) len = sizeof(buf) - 1;
+    rt_memcpy(buf, text, len);
+    buf[len] = '\0';
+    font->engine->font_get_metrics(font, buf, &rect);
+
+    return rtgui_rect_width(rect);
+}
+
+#if GUIENGINE_FONT_ADVANCE_CACHE > 0
+/* get the ascii advances of font, which are measured in the first use */
+static void _font_advance_get(struct rtgui_font *font, rt_uint16_t *advance)
+{
+    int index;
+    char ch;
+    struct font_advance *item;
+
+    rtgui_enter_critical();
+    for (index = 0; index < GUIENGINE_FONT_ADVANCE_CACHE; index ++)
+    {
+        item = &_font_advances[index];
+        if (item->font == font)
+        {
+            item->stamp = ++ _font_advance_stamp;
+            rt_memcpy(advance, item->advance, sizeof(item->advance));
+            rtgui_exit_critical();
+            return;
+        }
+    }
+    rtgui_exit_critical();
+
+    /* the engine is not called in the critical section */
+    advance[0] = 0;
+    for (index = 1; index < 128; index ++)
+    {
+        ch = (char)index;
+        advance[index] = (rt_uint16_t)_font_char_width(font, &ch, 1);
+    }
+
+    rtgui_enter_critical();
+    /* replace the least recently used one */
+    item = &_font_advances[0];
+    for (index = 1; index < GUIENGINE_FONT_ADVANCE_CACHE; index ++)
+    {
+        if (item->font == RT_NULL) break;
+        if (_font_advances[index].font == RT_NULL ||
+                _font_advances[index].stamp < item->stamp)
+            item = &_font_advances[index];
+    }
+    item->font = font;
+    item->stamp = ++ _font_advance_stamp;
+    rt_memcpy(item->advance, advance, sizeof(item->advance));
+    rtgui_exit_critical();
+}
+#endif
+
+/* the positions of prefixes measured by the engine, for the engines which
+ * width of text is not the sum of characters, such as the kerning */
+static int _font_text_positions_measure(struct rtgui_font *font, const char *text, rt_ubase_t len,
+                                        rt_uint16_t *positions)
+{
+    char *copy;
+    rt_ubase_t pos, next, index;
+
+    copy = (char *)rtgui_malloc(len + 1);
+    if (copy == RT_NULL) return -RT_ENOMEM;
+    rt_memcpy(copy, text, len);
+    copy[len] = '\0';
+
+    positions[0] = 0;
+    for (pos = 0; pos < len; pos = next)
+    {
+        next = pos + _font_char_len(copy + pos);
+        if (next > len) next = len;
+
+        positions[next] = (rt_uint16_t)_text_layout_width(font, copy, next);
+        for (index = pos + 1; index < next; index ++)
+            positions[index] = positions[pos];
+    }
+    rtgui_free(copy);
+
+    return positions[len];
+}
+
+/*
+ * Get the x of caret before each byte of text, positions[len] is the width.
+ * The positions of the bytes in a character are the same as its first byte,
+ * so the positions are ascending for the binary search of hit test. The
+ * ascii of bitmap fonts are summed in the table of advances.
+ *
+ * @param positions the array of len + 1
+ *
+ * @return the width of text, -RT_ENOMEM if there is no memory.
+ */
+int rtgui_font_get_text_positions(struct rtgui_font *font, const char *text, rt_ubase_t len,
+                                  rt_uint16_t *positions)
+{
+    int x;
+    rt_ubase_t pos, next, index;
+#if GUIENGINE_FONT_ADVANCE_CACHE > 0
+    rt_uint16_t advance[128];
+#endif
+
+    RT_ASSERT(font != RT_NULL);
+    RT_ASSERT(text != RT_NULL && positions != RT_NULL);
+    _font_load(font);
+
+    positions[0] = 0;
+    if (len == 0 || font->engine == RT_NULL || font->engine->font_get_metrics == RT_NULL)
+    {
+        for (index = 1; index <= len; index ++) positions[index] = 0;
+        return 0;
+    }
+
+    /* the engines of prepared text measure the whole text */
+    if (font->engine->font_prepare_text != RT_NULL)
+        return _font_text_positions_measure(font, text, len, positions);
+
+#if GUIENGINE_FONT_ADVANCE_CACHE > 0
+    _font_advance_get(font, advance);
+#endif
+
+    x = 0;
+    for (pos = 0; pos < len; pos = next)
+    {
+#if GUIENGINE_FONT_ADVANCE_CACHE > 0
+        /* the ascii in 4 characters a loop */
+        while (pos + 4 <= len && (((rt_uint8_t)text[pos] | (rt_uint8_t)text[pos + 1] |
+                                   (rt_uint8_t)text[pos + 2] | (rt_uint8_t)text[pos + 3]) & 0x80) == 0)
+        {
+            positions[pos + 1] = x += advance[(int)text[pos]];
+            positions[pos + 2] = x += advance[(int)text[pos + 1]];
+            positions[pos + 3] = x += advance[(int)text[pos + 2]];
+            positions[pos + 4] = x += advance[(int)text[pos + 3]];
+            pos += 4;
+        }
+        if (pos == len) break;
+
+        if ((rt_uint8_t)text[pos] < 0x80)
+        {
+            next = pos + 1;
+            positions[next] = x += advance[(int)text[pos]];
+            continue;
+        }
+#endif
+        next = pos + _font_char_len(text + pos);
+        if (next > len) next = len;
+
+        for (index = pos + 1; index < next; index ++)
+            positions[index] = x;
+        positions[next] = x += _font_char_width(font, text + pos, next - pos);
+    }
+
+    return x;
+}
+RTM_EXPORT(rtgui_font_get_text_positions);
+
+/* the first position not less than x */
+static rt_ubase_t _font_positions_lower(const rt_uint16_t *positions, rt_ubase_t len, int x)
+{
+    rt_ubase_t low = 0, high = len + 1, mid;
+
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (positions[mid] < x)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+/*
+ * Get the offset of the caret nearest to x in the positions of
+ * rtgui_font_get_text_positions, which is at the boundary of characters.
+ */
+rt_ubase_t rtgui_font_hit_test(const rt_uint16_t *positions, rt_ubase_t len, int x)
+{
+    rt_ubase_t after, before;
+
+    RT_ASSERT(positions != RT_NULL);
+
+    if (x <= 0) return 0;
+    if (x >= positions[len]) return len;
+
+    /* the first byte of a position is the boundary of character */
+    after = _font_positions_lower(positions, len, x);
+    if (positions[after] == x) return after;
+    before = _font_positions_lower(positions, len, positions[after - 1]);
+
+    return (x - positions[before] <= positions[after] - x) ? before : after;
+}
+RTM_EXPORT(rtgui_font_hit_test);
@@ -0,0 +1,252 @@
+/*
+ * File      : font_aa.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+/*
+ * anti-aliased bitmap font engine
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
+#include <rtgui/font_aa.h>
+#include <rtgui/font_atlas.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/dc.h>
+
+static void rtgui_aa_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text, rt_ubase_t len, struct rtgui_rect *rect);
+static void rtgui_aa_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect);
+const struct rtgui_font_engine aa_font_engine =
+{
+    RT_NULL,
+    RT_NULL,
+    rtgui_aa_font_draw_text,
+    rtgui_aa_font_get_metrics,
+    RT_NULL,
+    RT_NULL
+};
+RTM_EXPORT(aa_font_engine);
+
+rt_inline const struct rtgui_aa_glyph *_aa_font_glyph(const struct rtgui_aa_font_header *header, rt_uint8_t ch)
+{
+    if (ch < header->first_char || ch > header->last_char) return RT_NULL;
+
+    return (const struct rtgui_aa_glyph *)(header + 1) + (ch - header->first_char);
+}
+
+static void _aa_font_draw_char(const struct rtgui_aa_font_header *header, struct rtgui_glyph_run *run,
+                               rt_uint8_t ch, int x, int y)
+{
+    const struct rtgui_aa_glyph *aa;
+    const rt_uint8_t *bits;
+    struct rtgui_glyph *glyph;
+    struct rtgui_glyph local;
+
+    aa = _aa_font_glyph(header, ch);
+    if (aa == RT_NULL || aa->width == 0 || aa->height == 0) return;
+
+    bits = (const rt_uint8_t *)header + aa->offset;
+    if (header->bpp == 8)
+    {
+        /* the coverage is drawn from the font data without copying */
+        local.bitmap = (rt_uint8_t *)bits;
+        local.pitch = aa->width;
+        local.width = aa->width;
+        local.height = aa->height;
+        local.left = aa->left;
+        local.top = aa->top;
+        local.advance = aa->advance;
+        glyph = &local;
+    }
+    else
+    {
+        glyph = rtgui_font_atlas_find(header, ch);
+        if (glyph == RT_NULL)
+        {
+            int row, col, row_bytes;
+
+            glyph = rtgui_font_atlas_add(header, ch, aa->width, aa->height);
+            if (glyph == RT_NULL) return;
+
+            /* expand the nibbles to bytes, 0xf maps to 0xff */
+            row_bytes = (aa->width + 1) / 2;
+            for (row = 0; row < aa->height; row ++)
+            {
+                rt_uint8_t *ptr = glyph->bitmap + row * glyph->pitch;
+
+                for (col = 0; col < aa->width; col ++)
+                {
+                    rt_uint8_t value = bits[col / 2];
+
+                    value = (col & 0x01) ? (value & 0x0f) : (value >> 4);
+                    ptr[col] = value * 0x11;
+                }
+                bits += row_bytes;
+            }
+
+            glyph->left = aa->left;
+            glyph->top = aa->top;
+            glyph->advance = aa->advance;
+        }
+    }
+
+    rtgui_glyph_run_draw(run, glyph, x, y);
+}
+
+static void rtgui_aa_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc,
+                                    const char *text, rt_ubase_t len, struct rtgui_rect *rect)
+{
+    rt_uint32_t length;
+    struct rtgui_rect text_rect;
+    struct rtgui_glyph_run run;
+    const struct rtgui_aa_glyph *aa;
+    const struct rtgui_aa_font_header *header = (const struct rtgui_aa_font_header *)(font->data);
+#ifdef GUIENGINE_USING_FONTHZ
+    struct rtgui_font *hz_font;
+#endif
+
+    RT_ASSERT(header != RT_NULL);
+
+    rtgui_font_get_metrics(font, text, &text_rect);
+    rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
+
+    /* parameter check */
+    if (text_rect.y1 > text_rect.y2) return;
+
+    rtgui_glyph_run_begin(&run, dc, &text_rect);
+    /* the glyph boxes are tight, fill the background of line once */
+    if (run.style & RTGUI_TEXTSTYLE_DRAW_BACKGROUND)
+    {
+        rtgui_dc_fill_rect(dc, &text_rect);
+        run.style &= ~RTGUI_TEXTSTYLE_DRAW_BACKGROUND;
+    }
+
+#ifdef GUIENGINE_USING_FONTHZ
+    hz_font = rtgui_font_refer("hz", font->height);
+#endif
+    while ((text_rect.x1 < text_rect.x2) && len)
+    {
+        length = 0;
+        while ((rt_uint8_t) * (text + length) >= 0x80) length ++; /* it's not a ascii character */
+        if (length > 0)
+        {
+#ifdef GUIENGINE_USING_FONTHZ
+            if (hz_font != RT_NULL) rtgui_font_draw(hz_font, dc, text, length, &text_rect);
+#endif
+            text_rect.x1 += (font->height / 2) * length;
+            text += length;
+            len -= length;
+        }
+
+        length = 0;
+        while (((rt_uint8_t) * (text + length) < 0x80) && *(text + length)) length ++;
+        if (length > 0)
+        {
+            len -= length;
+            while (length-- && text_rect.x1 < text_rect.x2)
+            {
+                _aa_font_draw_char(header, &run, *text, text_rect.x1, text_rect.y1);
+
+                /* move x to next character */
+                aa = _aa_font_glyph(header, *text);
+                if (aa != RT_NULL) text_rect.x1 += aa->advance;
+                text ++;
+            }
+        }
+    }
+#ifdef GUIENGINE_USING_FONTHZ
+    if (hz_font != RT_NULL) rtgui_font_derefer(hz_font);
+#endif
+
+    rtgui_glyph_run_end(&run);
+}
+
+static void rtgui_aa_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
+{
+    const struct rtgui_aa_glyph *aa;
+    const struct rtgui_aa_font_header *header = (const struct rtgui_aa_font_header *)(font->data);
+
+    RT_ASSERT(header != RT_NULL);
+
+    /* set init metrics rect */
+    rect->x1 = rect->y1 = 0;
+    rect->x2 = 0;
+    rect->y2 = header->height;
+
+    while (*text)
+    {
+        if ((rt_uint8_t)*text >= 0x80)
+        {
+            /* it's not a ascii character, same as the bitmap font */
+            rect->x2 += font->height / 2;
+        }
+        else
+        {
+            aa = _aa_font_glyph(header, *text);
+            if (aa != RT_NULL) rect->x2 += aa->advance;
+        }
+        text ++;
+    }
+}
+
+struct rtgui_font *rtgui_aa_font_create(const void *data, const char *font_family)
+{
+    int index, count;
+    struct rtgui_font *font;
+    const struct rtgui_aa_glyph *aa;
+    const struct rtgui_aa_font_header *header = (const struct rtgui_aa_font_header *)data;
+
+    if (header == RT_NULL || ((rt_ubase_t)header & 0x03)) return RT_NULL;
+
+    /* check the font data once, the glyphs are trusted when drawing */
+    if (rt_memcmp(header->magic, RTGUI_AA_FONT_MAGIC, sizeof(header->magic)) != 0 ||
+        (header->bpp != 4 && header->bpp != 8) ||
+        header->first_char > header->last_char)
+        return RT_NULL;
+
+    count = header->last_char - header->first_char + 1;
+    if (header->size < sizeof(struct rtgui_aa_font_header) + count * sizeof(struct rtgui_aa_glyph))
+        return RT_NULL;
+
+    aa = (const struct rtgui_aa_glyph *)(header + 1);
+    for (index = 0; index < count; index ++)
+    {
+        rt_uint32_t pitch = header->bpp == 8 ? aa[index].width : (aa[index].width + 1) / 2;
+
+        if (aa[index].offset > header->size ||
+            pitch * aa[index].height > header->size - aa[index].offset)
+            return RT_NULL;
+    }
+
+    font = (struct rtgui_font *)rtgui_malloc(sizeof(struct rtgui_font));
+    if (font == RT_NULL) return RT_NULL;
+
+    font->family = rt_strdup(font_family);
+    font->height = header->height;
+    font->refer_count = 1;
+    font->engine = &aa_font_engine;
+    font->data = (void *)header;
+
+    rtgui_font_system_add_font(font);
+
+    return font;
+}
+RTM_EXPORT(rtgui_aa_font_create);
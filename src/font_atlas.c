@@ -0,0 +1,709 @@
+/*
+ * File      : font_atlas.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
+#include <rtgui/rtgui.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/dc.h>
+#include <rtgui/blit.h>
+#include <rtgui/driver.h>
+#include <rtgui/font_atlas.h>
+#include <rtgui/widgets/widget.h>
+
+#include <string.h>
+
+#define _ATLAS_SHELF_MAX    16
+#define _ATLAS_HASH_SIZE    64
+
+#define _atlas_hash(face, code)   \
+    ((((rt_ubase_t)(face) >> 2) ^ ((code) * 31)) & (_ATLAS_HASH_SIZE - 1))
+
+struct _atlas_glyph
+{
+    struct rtgui_glyph glyph;
+
+    const void *face;
+    rt_uint32_t code;
+    rt_uint8_t shelf;
+
+    struct _atlas_glyph *hash_next;
+    struct _atlas_glyph *shelf_next;
+};
+
+/* a row of glyphs, which are placed from left to right */
+struct _atlas_shelf
+{
+    rt_uint16_t y, height;
+    rt_uint16_t used;
+    /* the last time one of the glyphs was used */
+    rt_uint32_t stamp;
+
+    struct _atlas_glyph *glyphs;
+};
+
+static struct
+{
+    rt_uint8_t *pixels;
+    struct _atlas_glyph *pool;
+    struct _atlas_glyph *free;
+
+    struct _atlas_glyph *hash[_ATLAS_HASH_SIZE];
+    struct _atlas_shelf shelf[_ATLAS_SHELF_MAX];
+    int shelf_num;
+    /* the bottom of the last shelf */
+    rt_uint16_t bottom;
+    rt_uint32_t stamp;
+
+    /* the glyph larger than the atlas, which is not cached */
+    struct rtgui_glyph huge;
+    rt_uint32_t huge_size;
+    /* the glyph rotated out of the atlas */
+    struct rtgui_glyph rotated;
+    rt_uint32_t rotated_size;
+
+    struct rt_mutex lock;
+} _atlas;
+
+void rtgui_font_atlas_init(void)
+{
+    rt_memset(&_atlas, 0x00, sizeof(_atlas));
+    rt_mutex_init(&_atlas.lock, "atlas", RT_IPC_FLAG_FIFO);
+}
+
+static rt_bool_t _atlas_alloc(void)
+{
+    int index;
+    rt_uint32_t size;
+
+    if (_atlas.pixels != RT_NULL) return RT_TRUE;
+
+    /* the pixels and the glyphs are in one block */
+    size = GUIENGINE_GLYPH_ATLAS_WIDTH * GUIENGINE_GLYPH_ATLAS_HEIGHT;
+    size = RT_ALIGN(size, RT_ALIGN_SIZE);
+    _atlas.pixels = (rt_uint8_t *)rtgui_malloc(size + GUIENGINE_GLYPH_ATLAS_GLYPHS * sizeof(struct _atlas_glyph));
+    if (_atlas.pixels == RT_NULL) return RT_FALSE;
+
+    _atlas.pool = (struct _atlas_glyph *)(_atlas.pixels + size);
+    _atlas.free = RT_NULL;
+    for (index = GUIENGINE_GLYPH_ATLAS_GLYPHS - 1; index >= 0; index --)
+    {
+        _atlas.pool[index].shelf_next = _atlas.free;
+        _atlas.free = &_atlas.pool[index];
+    }
+
+    return RT_TRUE;
+}
+
+static void _atlas_unhash(struct _atlas_glyph *glyph)
+{
+    struct _atlas_glyph **link;
+
+    link = &_atlas.hash[_atlas_hash(glyph->face, glyph->code)];
+    while (*link != RT_NULL)
+    {
+        if (*link == glyph)
+        {
+            *link = glyph->hash_next;
+            break;
+        }
+        link = &((*link)->hash_next);
+    }
+}
+
+/* remove all the glyphs of shelf, the space of shelf is kept */
+static void _atlas_shelf_evict(struct _atlas_shelf *shelf)
+{
+    struct _atlas_glyph *glyph, *next;
+
+    /* the accelerator may still read the pixels of glyphs */
+    rtgui_graphic_driver_accel_sync();
+
+    for (glyph = shelf->glyphs; glyph != RT_NULL; glyph = next)
+    {
+        next = glyph->shelf_next;
+
+        _atlas_unhash(glyph);
+        glyph->shelf_next = _atlas.free;
+        _atlas.free = glyph;
+    }
+    shelf->glyphs = RT_NULL;
+    shelf->used = 0;
+}
+
+static void _atlas_reset(void)
+{
+    int index;
+
+    for (index = 0; index < _atlas.shelf_num; index ++)
+        _atlas_shelf_evict(&_atlas.shelf[index]);
+    _atlas.shelf_num = 0;
+    _atlas.bottom = 0;
+}
+
+/* get the least recently used shelf which is higher than height */
+static struct _atlas_shelf *_atlas_shelf_lru(int height)
+{
+    int index;
+    struct _atlas_shelf *lru = RT_NULL;
+
+    for (index = 0; index < _atlas.shelf_num; index ++)
+    {
+        struct _atlas_shelf *shelf = &_atlas.shelf[index];
+
+        if (shelf->height < height) continue;
+        if (height == 0 && shelf->glyphs == RT_NULL) continue;
+        if (lru == RT_NULL || shelf->stamp < lru->stamp) lru = shelf;
+    }
+
+    return lru;
+}
+
+static struct _atlas_shelf *_atlas_shelf_get(int width, int height)
+{
+    int index;
+    struct _atlas_shelf *shelf, *fit = RT_NULL;
+
+    /* the shelf has room, and not too higher than the glyph */
+    for (index = 0; index < _atlas.shelf_num; index ++)
+    {
+        shelf = &_atlas.shelf[index];
+        if (shelf->height < height || shelf->height > height * 2) continue;
+        if (shelf->used + width > GUIENGINE_GLYPH_ATLAS_WIDTH) continue;
+
+        if (fit == RT_NULL || shelf->height < fit->height) fit = shelf;
+    }
+    if (fit != RT_NULL) return fit;
+
+    /* open a new shelf */
+    if (_atlas.shelf_num < _ATLAS_SHELF_MAX &&
+            _atlas.bottom + height <= GUIENGINE_GLYPH_ATLAS_HEIGHT)
+    {
+        shelf = &_atlas.shelf[_atlas.shelf_num ++];
+        shelf->y = _atlas.bottom;
+        shelf->height = height;
+        shelf->used = 0;
+        shelf->glyphs = RT_NULL;
+        _atlas.bottom += height;
+
+        return shelf;
+    }
+
+    /* reuse the least recently used shelf */
+    shelf = _atlas_shelf_lru(height);
+    if (shelf != RT_NULL)
+    {
+        _atlas_shelf_evict(shelf);
+        return shelf;
+    }
+
+    /* no shelf is high enough, start over */
+    _atlas_reset();
+    return _atlas_shelf_get(width, height);
+}
+
+static struct rtgui_glyph *_atlas_huge_glyph(int width, int height)
+{
+    rt_uint32_t size = width * height;
+
+    if (size > _atlas.huge_size)
+    {
+        rt_uint8_t *bitmap;
+
+        rtgui_graphic_driver_accel_sync();
+        bitmap = (rt_uint8_t *)rtgui_realloc(_atlas.huge.bitmap, size);
+        if (bitmap == RT_NULL) return RT_NULL;
+
+        _atlas.huge.bitmap = bitmap;
+        _atlas.huge_size = size;
+    }
+
+    _atlas.huge.pitch = width;
+    _atlas.huge.width = width;
+    _atlas.huge.height = height;
+    _atlas.huge.left = _atlas.huge.top = 0;
+    _atlas.huge.advance = width;
+    rt_memset(_atlas.huge.bitmap, 0x00, size);
+
+    return &_atlas.huge;
+}
+
+struct rtgui_glyph *rtgui_font_atlas_find(const void *face, rt_uint32_t code)
+{
+    struct _atlas_glyph *glyph;
+
+    for (glyph = _atlas.hash[_atlas_hash(face, code)]; glyph != RT_NULL; glyph = glyph->hash_next)
+    {
+        if (glyph->face == face && glyph->code == code)
+        {
+            _atlas.shelf[glyph->shelf].stamp = ++ _atlas.stamp;
+            return &glyph->glyph;
+        }
+    }
+
+    return RT_NULL;
+}
+RTM_EXPORT(rtgui_font_atlas_find);
+
+struct rtgui_glyph *rtgui_font_atlas_add(const void *face, rt_uint32_t code, int width, int height)
+{
+    int index;
+    rt_uint8_t *ptr;
+    struct _atlas_glyph *glyph;
+    struct _atlas_shelf *shelf;
+
+    if (width < 0 || height < 0) return RT_NULL;
+
+    if (width > GUIENGINE_GLYPH_ATLAS_WIDTH || height > GUIENGINE_GLYPH_ATLAS_HEIGHT ||
+            _atlas_alloc() == RT_FALSE)
+        return _atlas_huge_glyph(width, height);
+
+    /* get a free glyph */
+    while (_atlas.free == RT_NULL)
+    {
+        shelf = _atlas_shelf_lru(0);
+        RT_ASSERT(shelf != RT_NULL);
+        _atlas_shelf_evict(shelf);
+    }
+
+    shelf = _atlas_shelf_get(width, height);
+    glyph = _atlas.free;
+    _atlas.free = glyph->shelf_next;
+
+    glyph->face = face;
+    glyph->code = code;
+    glyph->shelf = shelf - &_atlas.shelf[0];
+    glyph->glyph.bitmap = _atlas.pixels + shelf->y * GUIENGINE_GLYPH_ATLAS_WIDTH + shelf->used;
+    glyph->glyph.pitch = GUIENGINE_GLYPH_ATLAS_WIDTH;
+    glyph->glyph.width = width;
+    glyph->glyph.height = height;
+    glyph->glyph.left = glyph->glyph.top = 0;
+    glyph->glyph.advance = width;
+
+    glyph->shelf_next = shelf->glyphs;
+    shelf->glyphs = glyph;
+    shelf->used += width;
+    shelf->stamp = ++ _atlas.stamp;
+
+    index = _atlas_hash(face, code);
+    glyph->hash_next = _atlas.hash[index];
+    _atlas.hash[index] = glyph;
+
+    ptr = glyph->glyph.bitmap;
+    for (index = 0; index < height; index ++)
+    {
+        rt_memset(ptr, 0x00, width);
+        ptr += GUIENGINE_GLYPH_ATLAS_WIDTH;
+    }
+
+    return &glyph->glyph;
+}
+RTM_EXPORT(rtgui_font_atlas_add);
+
+struct rtgui_glyph *rtgui_font_atlas_add_mono(const void *face, rt_uint32_t code,
+                                              const rt_uint8_t *bits, int width, int height,
+                                              int row_bytes)
+{
+    int x, y;
+    rt_uint8_t *ptr;
+    struct rtgui_glyph *glyph;
+
+    glyph = rtgui_font_atlas_add(face, code, width, height);
+    if (glyph == RT_NULL) return RT_NULL;
+
+    ptr = glyph->bitmap;
+    for (y = 0; y < height; y ++)
+    {
+        for (x = 0; x < width; x ++)
+        {
+            if (bits[x >> 3] & (0x80 >> (x & 0x07)))
+                ptr[x] = 0xff;
+        }
+
+        bits += row_bytes;
+        ptr += glyph->pitch;
+    }
+
+    return glyph;
+}
+RTM_EXPORT(rtgui_font_atlas_add_mono);
+
+void rtgui_font_atlas_remove(const void *face)
+{
+    int index;
+    struct _atlas_glyph **link, *glyph;
+
+    rt_mutex_take(&_atlas.lock, RT_WAITING_FOREVER);
+
+    for (index = 0; index < _atlas.shelf_num; index ++)
+    {
+        link = &_atlas.shelf[index].glyphs;
+        while (*link != RT_NULL)
+        {
+            glyph = *link;
+            if (glyph->face != face)
+            {
+                link = &glyph->shelf_next;
+                continue;
+            }
+
+            /* the space is reclaimed when the shelf is evicted */
+            *link = glyph->shelf_next;
+            _atlas_unhash(glyph);
+            glyph->shelf_next = _atlas.free;
+            _atlas.free = glyph;
+        }
+    }
+
+    rt_mutex_release(&_atlas.lock);
+}
+RTM_EXPORT(rtgui_font_atlas_remove);
+
+/* rotate the rect in the coordinate of text to dc, the dc is the text rotated counterclockwise */
+static void _glyph_rotate_box(int orientation, const rtgui_rect_t *rect, rtgui_rect_t *box)
+{
+    rtgui_rect_t r = *rect;
+
+    switch (orientation)
+    {
+    case 1:
+        box->x1 = r.y1;
+        box->y1 = -r.x2;
+        box->x2 = r.y2;
+        box->y2 = -r.x1;
+        break;
+    case 2:
+        box->x1 = -r.x2;
+        box->y1 = -r.y2;
+        box->x2 = -r.x1;
+        box->y2 = -r.y1;
+        break;
+    case 3:
+        box->x1 = -r.y2;
+        box->y1 = r.x1;
+        box->x2 = -r.y1;
+        box->y2 = r.x2;
+        break;
+    default:
+        *box = r;
+        break;
+    }
+}
+
+void rtgui_glyph_rotate_rect(int orientation, const rtgui_rect_t *rect, rtgui_rect_t *text_rect)
+{
+    /* the reverse rotation */
+    _glyph_rotate_box((4 - orientation) & 0x03, rect, text_rect);
+}
+RTM_EXPORT(rtgui_glyph_rotate_rect);
+
+void rtgui_glyph_run_begin(struct rtgui_glyph_run *run, struct rtgui_dc *dc, const rtgui_rect_t *clip)
+{
+    rtgui_gc_t *gc;
+    struct rtgui_widget *owner = RT_NULL;
+    struct rtgui_graphic_driver *hw_driver = rtgui_graphic_driver_get_default();
+
+    RT_ASSERT(run != RT_NULL);
+    RT_ASSERT(dc != RT_NULL);
+
+    gc = rtgui_dc_get_gc(dc);
+    run->dc = dc;
+    run->clip = *clip;
+    run->color = gc->foreground;
+    run->style = gc->textstyle;
+    run->visible = rtgui_dc_get_visible(dc);
+    run->clip_rotated = *clip;
+    if (run->style & RTGUI_TEXTSTYLE_ROTATE_MASK)
+        _glyph_rotate_box((run->style & RTGUI_TEXTSTYLE_ROTATE_MASK) >> 4, clip, &run->clip_rotated);
+
+    run->pixels = RT_NULL;
+    run->dx = run->dy = 0;
+    run->region = RT_NULL;
+
+    /* the atlas is locked until the end of run */
+    rt_mutex_take(&_atlas.lock, RT_WAITING_FOREVER);
+
+    if (dc->type == RTGUI_DC_BUFFER)
+    {
+        struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)dc;
+
+        run->pixels = rtgui_dc_buffer_get_pixel(dc);
+        run->pitch = buffer->pitch;
+        run->format = buffer->pixel_format;
+        run->extent.x1 = run->extent.y1 = 0;
+        run->extent.x2 = buffer->width;
+        run->extent.y2 = buffer->height;
+    }
+    else if (dc->type == RTGUI_DC_HW && hw_driver->framebuffer != RT_NULL)
+    {
+        owner = ((struct rtgui_dc_hw *)dc)->owner;
+    }
+    else if (dc->type == RTGUI_DC_CLIENT && hw_driver->framebuffer != RT_NULL)
+    {
+        owner = RTGUI_CONTAINER_OF(dc, struct rtgui_widget, dc_type);
+        run->region = &(owner->clip);
+    }
+
+    if (owner != RT_NULL)
+    {
+        run->pixels = hw_driver->framebuffer;
+        run->pitch = hw_driver->pitch;
+        run->format = hw_driver->pixel_format;
+        run->dx = owner->extent.x1;
+        run->dy = owner->extent.y1;
+        run->extent = owner->extent;
+    }
+
+    /* the formats which rtgui_blit can draw alpha on */
+    switch (run->format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE:
+        break;
+    default:
+        run->pixels = RT_NULL;
+        run->region = RT_NULL;
+        break;
+    }
+}
+RTM_EXPORT(rtgui_glyph_run_begin);
+
+/* blit the coverage in box to the pixels, both rects are in device coordinate */
+static void _glyph_run_blit(struct rtgui_glyph_run *run, const rt_uint8_t *bitmap, int pitch,
+                            const rtgui_rect_t *box, const rtgui_rect_t *clip)
+{
+    int bpp;
+    rtgui_rect_t r;
+    struct rtgui_blit_info info;
+
+    r = *box;
+    rtgui_rect_intersect((rtgui_rect_t *)clip, &r);
+    if (r.x1 >= r.x2 || r.y1 >= r.y2) return;
+
+    bpp = rtgui_color_get_bpp(run->format);
+
+    info.src = (rt_uint8_t *)bitmap + (r.y1 - box->y1) * pitch + (r.x1 - box->x1);
+    info.src_w = rtgui_rect_width(r);
+    info.src_h = rtgui_rect_height(r);
+    info.src_pitch = pitch;
+    info.src_skip = pitch - info.src_w;
+    info.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ALPHA;
+
+    info.dst = run->pixels + r.y1 * run->pitch + r.x1 * bpp;
+    info.dst_w = info.src_w;
+    info.dst_h = info.src_h;
+    info.dst_pitch = run->pitch;
+    info.dst_skip = run->pitch - info.dst_w * bpp;
+    info.dst_fmt = run->format;
+
+    info.r = RTGUI_RGB_R(run->color);
+    info.g = RTGUI_RGB_G(run->color);
+    info.b = RTGUI_RGB_B(run->color);
+    /* the coverage is the alpha, and the color without alpha is opaque */
+    info.a = RTGUI_RGB_A(run->color);
+    if (info.a == 0) info.a = 255;
+
+    rtgui_blit(&info);
+}
+
+/* draw the coverage through dc, the pixels covered by half are drawn */
+static void _glyph_run_draw_dc(struct rtgui_glyph_run *run, const rt_uint8_t *bitmap, int pitch,
+                               const rtgui_rect_t *box)
+{
+    int x, y, start;
+
+    for (y = box->y1; y < box->y2; y ++)
+    {
+        const rt_uint8_t *ptr = bitmap;
+
+        start = -1;
+        for (x = box->x1; x < box->x2; x ++, ptr ++)
+        {
+            if (*ptr >= 0x80)
+            {
+                if (start < 0) start = x;
+            }
+            else if (start >= 0)
+            {
+                rtgui_dc_draw_hline(run->dc, start, x, y);
+                start = -1;
+            }
+        }
+        if (start >= 0)
+            rtgui_dc_draw_hline(run->dc, start, box->x2, y);
+
+        bitmap += pitch;
+    }
+}
+
+/* draw the bitmap at the box, which is clipped here */
+static void _glyph_run_box(struct rtgui_glyph_run *run, const rt_uint8_t *bitmap, int pitch,
+                           rtgui_rect_t *box, rtgui_rect_t *clip)
+{
+    int x, y;
+
+    x = box->x1;
+    y = box->y1;
+    rtgui_rect_intersect(clip, box);
+    if (box->x1 >= box->x2 || box->y1 >= box->y2) return;
+
+    if (run->style & RTGUI_TEXTSTYLE_DRAW_BACKGROUND)
+        rtgui_dc_fill_rect(run->dc, box);
+
+    bitmap += (box->y1 - y) * pitch + (box->x1 - x);
+    if (run->pixels == RT_NULL)
+    {
+        _glyph_run_draw_dc(run, bitmap, pitch, box);
+        return;
+    }
+
+    rtgui_rect_move(box, run->dx, run->dy);
+    if (run->region == RT_NULL)
+    {
+        _glyph_run_blit(run, bitmap, pitch, box, &run->extent);
+    }
+    else
+    {
+        int index, num;
+        rtgui_rect_t *rects;
+
+        num = rtgui_region_num_rects(run->region);
+        rects = rtgui_region_rects(run->region);
+        for (index = 0; index < num; index ++)
+        {
+            /* the clip rects are sorted by y */
+            if (rects[index].y1 >= box->y2) break;
+
+            _glyph_run_blit(run, bitmap, pitch, box, &rects[index]);
+        }
+    }
+}
+
+/* the glyph rotated in the orientation, the glyph of atlas is cached rotated */
+static const struct rtgui_glyph *_glyph_rotated(int orientation, const struct rtgui_glyph *glyph)
+{
+    int x, y, w, h;
+    rt_uint8_t *ptr;
+    const void *face = RT_NULL;
+    rt_uint32_t code = 0;
+    struct rtgui_glyph *rotated;
+
+    w = orientation == 2 ? glyph->width : glyph->height;
+    h = orientation == 2 ? glyph->height : glyph->width;
+
+    if (_atlas.pool != RT_NULL &&
+            (const rt_uint8_t *)glyph >= (const rt_uint8_t *)_atlas.pool &&
+            (const rt_uint8_t *)glyph < (const rt_uint8_t *)(_atlas.pool + GUIENGINE_GLYPH_ATLAS_GLYPHS))
+    {
+        face = ((const struct _atlas_glyph *)glyph)->face;
+        code = ((const struct _atlas_glyph *)glyph)->code | ((rt_uint32_t)orientation << RTGUI_GLYPH_ORIENTATION_SHIFT);
+        rotated = rtgui_font_atlas_find(face, code);
+        if (rotated != RT_NULL) return rotated;
+    }
+
+    /* transpose the glyph out of atlas first, it may be evicted by the add */
+    if ((rt_uint32_t)(w * h) > _atlas.rotated_size)
+    {
+        ptr = (rt_uint8_t *)rtgui_realloc(_atlas.rotated.bitmap, w * h);
+        if (ptr == RT_NULL) return RT_NULL;
+        _atlas.rotated.bitmap = ptr;
+        _atlas.rotated_size = w * h;
+    }
+    for (y = 0; y < h; y ++)
+    {
+        ptr = _atlas.rotated.bitmap + y * w;
+        for (x = 0; x < w; x ++)
+        {
+            switch (orientation)
+            {
+            case 1:
+                ptr[x] = glyph->bitmap[x * glyph->pitch + (glyph->width - 1 - y)];
+                break;
+            case 2:
+                ptr[x] = glyph->bitmap[(glyph->height - 1 - y) * glyph->pitch + (glyph->width - 1 - x)];
+                break;
+            default:
+                ptr[x] = glyph->bitmap[(glyph->height - 1 - x) * glyph->pitch + y];
+                break;
+            }
+        }
+    }
+    _atlas.rotated.pitch = w;
+    _atlas.rotated.width = w;
+    _atlas.rotated.height = h;
+
+    if (face == RT_NULL)
+        return &_atlas.rotated;
+
+    rotated = rtgui_font_atlas_add(face, code, w, h);
+    if (rotated == RT_NULL)
+        return &_atlas.rotated;
+    for (y = 0; y < h; y ++)
+        rt_memcpy(rotated->bitmap + y * rotated->pitch, _atlas.rotated.bitmap + y * w, w);
+
+    return rotated;
+}
+
+void rtgui_glyph_run_draw(struct rtgui_glyph_run *run, const struct rtgui_glyph *glyph, int x, int y)
+{
+    int orientation;
+    rtgui_rect_t box, rotated_box;
+
+    RT_ASSERT(run != RT_NULL);
+
+    if (run->visible == RT_FALSE || glyph == RT_NULL) return;
+
+    box.x1 = x + glyph->left;
+    box.y1 = y + glyph->top;
+    box.x2 = box.x1 + glyph->width;
+    box.y2 = box.y1 + glyph->height;
+
+    orientation = (run->style & RTGUI_TEXTSTYLE_ROTATE_MASK) >> 4;
+    if (orientation == 0)
+    {
+        _glyph_run_box(run, glyph->bitmap, glyph->pitch, &box, &run->clip);
+        return;
+    }
+
+    /* the glyph out of clip is not rotated */
+    rotated_box = box;
+    rtgui_rect_intersect(&run->clip, &rotated_box);
+    if (rotated_box.x1 >= rotated_box.x2 || rotated_box.y1 >= rotated_box.y2) return;
+
+    _glyph_rotate_box(orientation, &box, &rotated_box);
+    glyph = _glyph_rotated(orientation, glyph);
+    if (glyph != RT_NULL)
+        _glyph_run_box(run, glyph->bitmap, glyph->pitch, &rotated_box, &run->clip_rotated);
+}
+RTM_EXPORT(rtgui_glyph_run_draw);
+
+void rtgui_glyph_run_end(struct rtgui_glyph_run *run)
+{
+    RT_ASSERT(run != RT_NULL);
+
+    rt_mutex_release(&_atlas.lock);
+}
+RTM_EXPORT(rtgui_glyph_run_end);
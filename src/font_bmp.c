@@ -22,6 +22,7 @@
  * 2010-09-15     Bernard      first version
  */
 #include <rtgui/font.h>
+#include <rtgui/font_atlas.h>
 #include <rtgui/dc.h>
 
 /* bitmap font private data */
@@ -33,62 +34,81 @@ const struct rtgui_font_engine bmp_font_engine =
     RT_NULL,
     RT_NULL,
     rtgui_bitmap_font_draw_text,
-    rtgui_bitmap_font_get_metrics
+    rtgui_bitmap_font_get_metrics,
+    RT_NULL,
+    RT_NULL
 };
 RTM_EXPORT(bmp_font_engine);
 
-void rtgui_bitmap_font_draw_char(struct rtgui_font_bitmap *font, struct rtgui_dc *dc, const char ch,
-                                 rtgui_rect_t *rect)
+/* the advance of character, the characters out of font are skipped in the proportional font */
+rt_inline int _bitmap_font_advance(struct rtgui_font_bitmap *font, rt_uint8_t ch)
 {
-    rtgui_color_t bc;
-    const rt_uint8_t *font_ptr;
-    int x, y, w, h, style;
-    register rt_base_t i, j, /*k,*/ word_bytes;
-    struct rtgui_rect dc_rect;
+    if (font->char_width == RT_NULL) return font->width;
+    if (ch < font->first_char || ch > font->last_char) return 0;
 
-    /* check first and last char */
-    if (ch < font->first_char || ch > font->last_char) return;
+    return font->char_width[ch - font->first_char];
+}
 
-    /* get text style */
-    style = rtgui_dc_get_gc(dc)->textstyle;
-    bc = rtgui_dc_get_gc(dc)->background;
-    rtgui_dc_get_rect(dc, &dc_rect);
+/* the width of ascii characters, in 4 characters a loop */
+static int _bitmap_font_width(struct rtgui_font_bitmap *font, const char *text, rt_uint32_t length)
+{
+    int width = 0;
 
-    x = rect->x1;
-    y = rect->y1;
-    /* get width */
-    if (font->char_width == RT_NULL)
-    {
-        word_bytes = (((font->width - 1) / 8) + 1);
-        font_ptr = font->bmp + (ch - font->first_char) * word_bytes * font->height;
-    }
-    else
+    if (font->char_width == RT_NULL) return font->width * length;
+
+    for (; length >= 4; length -= 4, text += 4)
     {
-        word_bytes = ((font->char_width[ch - font->first_char] - 1) / 8) + 1;
-        font_ptr = font->bmp + font->offset[ch - font->first_char];
+        width += _bitmap_font_advance(font, text[0]) + _bitmap_font_advance(font, text[1]) +
+                 _bitmap_font_advance(font, text[2]) + _bitmap_font_advance(font, text[3]);
     }
-    w = (font->width  + x > rect->x2) ? rect->x2 - rect->x1 : font->width;
-    h = (font->height + y > rect->y2) ? rect->y2 - rect->y1 : font->height;
+    while (length --)
+        width += _bitmap_font_advance(font, *text ++);
 
-    for (i = 0; i < h; i++)
-    {
-        rt_uint8_t chr = 0;
-        const rt_uint8_t *ptr = font_ptr + i * word_bytes;
+    return width;
+}
+
+static void _bitmap_font_draw_char(struct rtgui_font_bitmap *font, struct rtgui_glyph_run *run,
+                                   const char ch, int x, int y)
+{
+    struct rtgui_glyph *glyph;
+
+    /* check first and last char */
+    if (ch < font->first_char || ch > font->last_char) return;
 
-        if ((i + y) >= dc_rect.y2) continue;
-        if ((i + y) < 0) continue;
+    glyph = rtgui_font_atlas_find(font, (rt_uint8_t)ch);
+    if (glyph == RT_NULL)
+    {
+        int width, word_bytes;
+        const rt_uint8_t *font_ptr;
 
-        for (j = 0; j < w; j++)
+        /* get width */
+        if (font->char_width == RT_NULL)
+        {
+            width = font->width;
+            word_bytes = (((font->width - 1) / 8) + 1);
+            font_ptr = font->bmp + (ch - font->first_char) * word_bytes * font->height;
+        }
+        else
         {
-            if (j % 8 == 0)
-                chr = *ptr++;
-            if (chr & 0x80)
-                rtgui_dc_draw_point(dc, j + x, i + y);
-            else if (style & RTGUI_TEXTSTYLE_DRAW_BACKGROUND)
-                rtgui_dc_draw_color_point(dc, j + x, i + y, bc);
-            chr <<= 1;
+            width = font->char_width[ch - font->first_char];
+            word_bytes = ((width - 1) / 8) + 1;
+            font_ptr = font->bmp + font->offset[ch - font->first_char];
         }
+
+        glyph = rtgui_font_atlas_add_mono(font, (rt_uint8_t)ch, font_ptr, width, font->height, word_bytes);
     }
+
+    rtgui_glyph_run_draw(run, glyph, x, y);
+}
+
+void rtgui_bitmap_font_draw_char(struct rtgui_font_bitmap *font, struct rtgui_dc *dc, const char ch,
+                                 rtgui_rect_t *rect)
+{
+    struct rtgui_glyph_run run;
+
+    rtgui_glyph_run_begin(&run, dc, rect);
+    _bitmap_font_draw_char(font, &run, ch, rect->x1, rect->y1);
+    rtgui_glyph_run_end(&run);
 }
 
 static void rtgui_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc,
@@ -96,6 +116,7 @@ static void rtgui_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui_dc
 {
     rt_uint32_t length;
     struct rtgui_rect text_rect;
+    struct rtgui_glyph_run run;
     struct rtgui_font_bitmap *bmp_font = (struct rtgui_font_bitmap *)(font->data);
 #ifdef GUIENGINE_USING_FONTHZ
     struct rtgui_font *hz_font;
@@ -109,6 +130,9 @@ static void rtgui_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui_dc
     /* parameter check */
     if (text_rect.y1 > text_rect.y2) return;
 
+    /* all the characters are drawn in one run */
+    rtgui_glyph_run_begin(&run, dc, &text_rect);
+
 #ifdef GUIENGINE_USING_FONTHZ
     hz_font = rtgui_font_refer("hz", font->height);
     while ((text_rect.x1 < text_rect.x2) && len)
@@ -129,13 +153,10 @@ static void rtgui_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui_dc
             len -= length;
             while (length-- && text_rect.x1 < text_rect.x2)
             {
-                rtgui_bitmap_font_draw_char(bmp_font, dc, *text, &text_rect);
+                _bitmap_font_draw_char(bmp_font, &run, *text, text_rect.x1, text_rect.y1);
 
                 /* move x to next character */
-                if (bmp_font->char_width == RT_NULL)
-                    text_rect.x1 += bmp_font->width;
-                else
-                    text_rect.x1 += bmp_font->char_width[*text - bmp_font->first_char];
+                text_rect.x1 += _bitmap_font_advance(bmp_font, *text);
                 text ++;
             }
         }
@@ -153,18 +174,17 @@ static void rtgui_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui_dc
             len -= length;
             while (length-- && text_rect.x1 < text_rect.x2)
             {
-                rtgui_bitmap_font_draw_char(bmp_font, dc, *text, &text_rect);
+                _bitmap_font_draw_char(bmp_font, &run, *text, text_rect.x1, text_rect.y1);
 
                 /* move x to next character */
-                if (bmp_font->char_width == RT_NULL)
-                    text_rect.x1 += bmp_font->width;
-                else
-                    text_rect.x1 += bmp_font->char_width[*text - bmp_font->first_char];
+                text_rect.x1 += _bitmap_font_advance(bmp_font, *text);
                 text ++;
             }
         }
     }
 #endif
+
+    rtgui_glyph_run_end(&run);
 }
 
 static void rtgui_bitmap_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
@@ -188,20 +208,7 @@ static void rtgui_bitmap_font_get_metrics(struct rtgui_font *font, const char *t
 
         length = 0;
         while (((rt_uint8_t) * (text + length) < 0x80) && *(text + length)) length ++;
-        if (bmp_font->char_width != NULL)
-        {
-            /* get width for each character */
-            while (*text && ((rt_uint8_t)*text < 0x80))
-            {
-                rect->x2 += bmp_font->char_width[*text - bmp_font->first_char];
-                text ++;
-            }
-        }
-        else
-        {
-            /* set metrics rect */
-            rect->x2 += bmp_font->width * length;
-            text += length;
-        }
+        rect->x2 += _bitmap_font_width(bmp_font, text, length);
+        text += length;
     }
 }
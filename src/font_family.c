@@ -0,0 +1,412 @@
+/*
+ * File      : font_family.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
+#include <rtgui/font.h>
+#include <rtgui/dc.h>
+#include <rtgui/gb2312.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef RTGUI_USING_HZ_BMP
+extern const struct rtgui_font_engine hz_bmp_font_engine;
+#endif
+
+/* the bytes of a sub-run measured at once */
+#define FAMILY_TEXT_MAX     64
+
+/* a sub-run of the text drawn by one font */
+struct family_segment
+{
+    rt_uint16_t offset, len;
+    rt_int16_t width;
+    rt_uint8_t member;
+};
+
+struct family_run
+{
+    int count;
+    /* struct family_segment segments[count]; */
+};
+
+static void _family_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text,
+                              rt_ubase_t len, struct rtgui_rect *rect);
+static void _family_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect);
+static rt_err_t _family_prepare_text(struct rtgui_font *font, struct rtgui_text_run *run);
+static void _family_draw_text_run(struct rtgui_font *font, struct rtgui_dc *dc,
+                                  struct rtgui_text_run *run, struct rtgui_rect *rect);
+
+const struct rtgui_font_engine rtgui_font_family_engine =
+{
+    RT_NULL,
+    RT_NULL,
+    _family_draw_text,
+    _family_get_metrics,
+    _family_prepare_text,
+    _family_draw_text_run
+};
+
+rt_inline void _family_cover(rt_uint32_t *coverage, rt_uint32_t first, rt_uint32_t last)
+{
+    rt_uint32_t block;
+
+    if (last > 0xFFFF) last = 0xFFFF;
+    for (block = first >> RTGUI_FONT_COVERAGE_SHIFT;
+            block <= (last >> RTGUI_FONT_COVERAGE_SHIFT) && first <= last; block ++)
+        coverage[block >> 5] |= 1UL << (block & 0x1F);
+}
+
+/* the coverage of member from its engine */
+static void _family_engine_cover(struct rtgui_font *member, rt_uint32_t *coverage)
+{
+    rt_uint32_t unicode;
+    struct rtgui_font_bitmap *bmp_font;
+
+    if (member->engine == &bmp_font_engine)
+    {
+        bmp_font = (struct rtgui_font_bitmap *)member->data;
+        _family_cover(coverage, bmp_font->first_char, bmp_font->last_char);
+        return;
+    }
+
+#if defined(GUIENGINE_USING_HZ_FILE) || defined(RTGUI_USING_HZ_BMP)
+    if (0
+#ifdef GUIENGINE_USING_HZ_FILE
+            || member->engine == &rtgui_hz_file_font_engine
+#endif
+#ifdef RTGUI_USING_HZ_BMP
+            || member->engine == &hz_bmp_font_engine
+#endif
+       )
+    {
+        /* the blocks of GB2312, the ASCII is drawn by the asc font of hz engine */
+        _family_cover(coverage, 0x20, 0x7F);
+        for (unicode = 0x80; unicode <= 0xFFFF; unicode ++)
+        {
+            if (rtgui_unicode_to_gb2312(unicode) != 0)
+                _family_cover(coverage, unicode, unicode);
+        }
+        return;
+    }
+#endif
+
+    /* the glyphs of the others can not be enumerated, cover all */
+    (void)unicode;
+    _family_cover(coverage, 0, 0xFFFF);
+}
+
+struct rtgui_font *rtgui_font_family_create(const char *family, rt_uint16_t height)
+{
+    struct rtgui_font *font;
+    struct rtgui_font_family *font_family;
+
+    RT_ASSERT(family != RT_NULL);
+
+    font = (struct rtgui_font *)rtgui_malloc(sizeof(struct rtgui_font) + sizeof(struct rtgui_font_family));
+    if (font == RT_NULL)
+        return RT_NULL;
+
+    font_family = (struct rtgui_font_family *)(font + 1);
+    rt_memset(font_family, 0, sizeof(struct rtgui_font_family));
+
+    font->family = rt_strdup(family);
+    if (font->family == RT_NULL)
+    {
+        rtgui_free(font);
+        return RT_NULL;
+    }
+    font->height = height;
+    font->refer_count = 1;
+    font->engine = &rtgui_font_family_engine;
+    font->data = font_family;
+
+    rtgui_font_system_add_font(font);
+
+    return font;
+}
+RTM_EXPORT(rtgui_font_family_create);
+
+void rtgui_font_family_destroy(struct rtgui_font *font)
+{
+    int index;
+    struct rtgui_font_family *family;
+
+    RT_ASSERT(font != RT_NULL && font->engine == &rtgui_font_family_engine);
+
+    rtgui_font_system_remove_font(font);
+
+    family = (struct rtgui_font_family *)font->data;
+    for (index = 0; index < family->count; index ++)
+        rtgui_font_derefer(family->fonts[index]);
+
+    rt_free(font->family);
+    rtgui_free(font);
+}
+RTM_EXPORT(rtgui_font_family_destroy);
+
+rt_err_t rtgui_font_family_add(struct rtgui_font *font, struct rtgui_font *member,
+                               const struct rtgui_font_range *ranges, int count)
+{
+    int index;
+    rt_uint32_t *coverage;
+    struct rtgui_font_family *family;
+
+    RT_ASSERT(font != RT_NULL && font->engine == &rtgui_font_family_engine);
+    RT_ASSERT(member != RT_NULL && member != font);
+
+    family = (struct rtgui_font_family *)font->data;
+    if (family->count >= RTGUI_FONT_FAMILY_MAX)
+        return -RT_EFULL;
+
+    coverage = family->coverage[family->count];
+    if (ranges != RT_NULL)
+    {
+        for (index = 0; index < count; index ++)
+            _family_cover(coverage, ranges[index].first, ranges[index].last);
+    }
+    else
+    {
+        _family_engine_cover(member, coverage);
+    }
+
+    /* keep the member until the family is destroyed */
+    member->refer_count ++;
+    family->fonts[family->count ++] = member;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_font_family_add);
+
+/* the first member covering the character, the last one is the fallback */
+rt_inline int _family_member(const struct rtgui_font_family *family, rt_uint32_t unicode)
+{
+    int index;
+    rt_uint32_t block;
+
+    if (unicode <= 0xFFFF)
+    {
+        block = unicode >> RTGUI_FONT_COVERAGE_SHIFT;
+        for (index = 0; index < family->count - 1; index ++)
+        {
+            if (family->coverage[index][block >> 5] & (1UL << (block & 0x1F)))
+                return index;
+        }
+    }
+
+    return family->count - 1;
+}
+
+/* the bytes of the sub-run at text in one member */
+static rt_ubase_t _family_segment(const struct rtgui_font_family *family, const char *text,
+                                  rt_ubase_t len, int *member)
+{
+    int bytes;
+    rt_ubase_t offset;
+    rt_uint32_t unicode;
+
+    bytes = rtgui_utf8_decode(text, len, &unicode);
+    *member = _family_member(family, unicode);
+    for (offset = bytes; offset < len && text[offset] != '\0'; offset += bytes)
+    {
+        bytes = rtgui_utf8_decode(text + offset, len - offset, &unicode);
+        if (_family_member(family, unicode) != *member)
+            break;
+    }
+
+    return offset;
+}
+
+/* the width of sub-run, measured in the chunks of whole characters */
+static int _family_width(struct rtgui_font *member, const char *text, rt_ubase_t len)
+{
+    int width;
+    rt_ubase_t chunk;
+    rtgui_rect_t rect;
+    char buffer[FAMILY_TEXT_MAX + 1];
+
+    width = 0;
+    while (len > 0)
+    {
+        chunk = len;
+        if (chunk > FAMILY_TEXT_MAX)
+        {
+            chunk = FAMILY_TEXT_MAX;
+            while (chunk > 1 && ((rt_uint8_t)text[chunk] & 0xC0) == 0x80)
+                chunk --;
+        }
+
+        rt_memcpy(buffer, text, chunk);
+        buffer[chunk] = '\0';
+        rtgui_font_get_metrics(member, buffer, &rect);
+        width += rtgui_rect_width(rect);
+
+        text += chunk;
+        len -= chunk;
+    }
+
+    return width;
+}
+
+/* draw a sub-run at the left of line, in the vertical alignment of dc */
+static void _family_draw_segment(struct rtgui_font *member, struct rtgui_dc *dc, const char *text,
+                                 rt_ubase_t len, int width, const rtgui_rect_t *line)
+{
+    int dh;
+    rtgui_rect_t rect;
+
+    rect.x1 = line->x1;
+    rect.x2 = line->x1 + width;
+    if (rect.x2 > line->x2) rect.x2 = line->x2;
+    rect.y1 = line->y1;
+    dh = rtgui_rect_height(*line) - member->height;
+    if (dh > 0)
+    {
+        if (RTGUI_DC_TEXTALIGN(dc) & RTGUI_ALIGN_BOTTOM)
+            rect.y1 += dh;
+        else if (RTGUI_DC_TEXTALIGN(dc) & RTGUI_ALIGN_CENTER_VERTICAL)
+            rect.y1 += dh >> 1;
+    }
+    rect.y2 = rect.y1 + member->height;
+    if (rect.y2 > line->y2) rect.y2 = line->y2;
+
+    if (rect.x1 < rect.x2)
+        rtgui_font_draw(member, dc, text, len, &rect);
+}
+
+static void _family_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text,
+                              rt_ubase_t len, struct rtgui_rect *rect)
+{
+    int member, width;
+    rt_ubase_t length;
+    rtgui_rect_t text_rect;
+    struct rtgui_font_family *family = (struct rtgui_font_family *)font->data;
+
+    if (family->count == 0)
+        return;
+
+    _family_get_metrics(font, text, &text_rect);
+    rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
+
+    while (len > 0 && *text != '\0' && text_rect.x1 < text_rect.x2)
+    {
+        length = _family_segment(family, text, len, &member);
+        width = _family_width(family->fonts[member], text, length);
+        _family_draw_segment(family->fonts[member], dc, text, length, width, &text_rect);
+
+        text_rect.x1 += width;
+        text += length;
+        len -= length;
+    }
+}
+
+static void _family_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
+{
+    int member, width;
+    rt_ubase_t len, length;
+    struct rtgui_font_family *family = (struct rtgui_font_family *)font->data;
+
+    width = 0;
+    len = family->count > 0 ? rt_strlen(text) : 0;
+    while (len > 0)
+    {
+        length = _family_segment(family, text, len, &member);
+        width += _family_width(family->fonts[member], text, length);
+        text += length;
+        len -= length;
+    }
+
+    rect->x1 = rect->y1 = 0;
+    rect->x2 = (rt_int16_t)(width >= 0x7FFF ? 0x7FFF : width);
+    rect->y2 = font->height;
+}
+
+/* the segments and widths are resolved once, the draw only walks them */
+static rt_err_t _family_prepare_text(struct rtgui_font *font, struct rtgui_text_run *run)
+{
+    int count, member, width;
+    const char *text;
+    rt_ubase_t offset, length;
+    struct family_run *family_run;
+    struct family_segment *segment;
+    struct rtgui_font_family *family = (struct rtgui_font_family *)font->data;
+
+    text = rtgui_text_run_text(run);
+    if (family->count == 0 || run->len > 0xFFFF)
+        return -RT_ERROR;
+
+    count = 0;
+    for (offset = 0; offset < run->len && text[offset] != '\0'; offset += length)
+    {
+        length = _family_segment(family, text + offset, run->len - offset, &member);
+        count ++;
+    }
+
+    family_run = (struct family_run *)rtgui_malloc(sizeof(struct family_run) +
+                                                   count * sizeof(struct family_segment));
+    if (family_run == RT_NULL)
+        return -RT_ENOMEM;
+    family_run->count = count;
+
+    width = 0;
+    segment = (struct family_segment *)(family_run + 1);
+    for (offset = 0; offset < run->len && text[offset] != '\0'; offset += length, segment ++)
+    {
+        length = _family_segment(family, text + offset, run->len - offset, &member);
+        segment->offset = (rt_uint16_t)offset;
+        segment->len = (rt_uint16_t)length;
+        segment->member = (rt_uint8_t)member;
+        segment->width = (rt_int16_t)_family_width(family->fonts[member], text + offset, length);
+        width += segment->width;
+    }
+
+    run->metrics.x1 = run->metrics.y1 = 0;
+    run->metrics.x2 = (rt_int16_t)(width >= 0x7FFF ? 0x7FFF : width);
+    run->metrics.y2 = font->height;
+    run->data = family_run;
+
+    return RT_EOK;
+}
+
+static void _family_draw_text_run(struct rtgui_font *font, struct rtgui_dc *dc,
+                                  struct rtgui_text_run *run, struct rtgui_rect *rect)
+{
+    int index;
+    const char *text;
+    rtgui_rect_t text_rect;
+    struct family_run *family_run;
+    struct family_segment *segment;
+    struct rtgui_font_family *family = (struct rtgui_font_family *)font->data;
+
+    text = rtgui_text_run_text(run);
+    family_run = (struct family_run *)run->data;
+    segment = (struct family_segment *)(family_run + 1);
+
+    text_rect = run->metrics;
+    rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
+    for (index = 0; index < family_run->count && text_rect.x1 < text_rect.x2; index ++, segment ++)
+    {
+        _family_draw_segment(family->fonts[segment->member], dc, text + segment->offset,
+                             segment->len, segment->width, &text_rect);
+        text_rect.x1 += segment->width;
+    }
+}
@@ -25,7 +25,10 @@
 /*
 * rockbox fnt font engine
 */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
 #include <rtgui/font_fnt.h>
+#include <rtgui/font_atlas.h>
 #include <rtgui/rtgui_system.h>
 
 #ifdef _WIN32_NATIVE
@@ -49,15 +52,85 @@ const struct rtgui_font_engine fnt_font_engine =
     RT_NULL,
     RT_NULL,
     rtgui_fnt_font_draw_text,
-    rtgui_fnt_font_get_metrics
+    rtgui_fnt_font_get_metrics,
+    RT_NULL,
+    RT_NULL
 };
 
+/* the index of char in the tables, the chars out of font are default_char */
+static rt_uint32_t _fnt_font_index(struct fnt_font *fnt, int ch)
+{
+    rt_uint32_t index;
+
+    index = (rt_uint32_t)ch - fnt->header.first_char;
+    if (index >= fnt->header.size)
+        index = fnt->header.default_char - fnt->header.first_char;
+
+    return index;
+}
+
+static int _fnt_font_width(struct fnt_font *fnt, int ch)
+{
+    rt_uint32_t index;
+
+    if (fnt->width == RT_NULL)
+        return fnt->header.max_width;
+
+    index = _fnt_font_index(fnt, ch);
+    return index < fnt->header.size ? fnt->width[index] : 0;
+}
+
+/* the bits are in columns, each byte holds 8 rows of column */
+static struct rtgui_glyph *_fnt_font_get_glyph(struct fnt_font *fnt, int ch)
+{
+    int i, j, c, width;
+    rt_uint32_t position, index;
+    rt_uint8_t *data_ptr;
+    struct rtgui_glyph *glyph;
+
+    glyph = rtgui_font_atlas_find(fnt, ch);
+    if (glyph != RT_NULL) return glyph;
+
+    index = _fnt_font_index(fnt, ch);
+    if (index >= fnt->header.size) return RT_NULL;
+
+    /* get position and width */
+    width = _fnt_font_width(fnt, ch);
+    if (fnt->long_offset != RT_NULL)
+        position = fnt->long_offset[index];
+    else if (fnt->offset != RT_NULL)
+        position = fnt->offset[index];
+    else
+        position = index * width * ((fnt->header.height + 7)/8);
+    /* the glyph out of bits in a broken font */
+    if (position + width * ((fnt->header.height + 7)/8) > fnt->header.nbits)
+        return RT_NULL;
+
+    glyph = rtgui_font_atlas_add(fnt, ch, width, fnt->header.height);
+    if (glyph == RT_NULL) return RT_NULL;
+
+    data_ptr = (rt_uint8_t*)&fnt->bits[position];
+    for (i = 0; i < width; i ++) /* x */
+    {
+        for (c = 0; c < (fnt->header.height + 7)/8; c ++)
+        {
+            for (j = 0; j < 8 && c * 8 + j < fnt->header.height; j ++) /* y */
+            {
+                if (data_ptr[i + c * width] & (1 << j))
+                    glyph->bitmap[(c * 8 + j) * glyph->pitch + i] = 0xff;
+            }
+        }
+    }
+
+    return glyph;
+}
+
 void rtgui_fnt_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text, rt_ubase_t len, struct rtgui_rect *rect)
 {
-    int ch, i, j, c, width;
-    rt_uint32_t position;
+    int ch;
     struct fnt_font *fnt;
-    rt_uint8_t *data_ptr;
+    struct rtgui_glyph *glyph;
+    struct rtgui_glyph_run run;
     struct rtgui_rect text_rect;
 
     fnt = (struct fnt_font*)font->data;
@@ -66,6 +139,7 @@ void rtgui_fnt_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, cons
     rtgui_font_get_metrics(font, text, &text_rect);
     rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
 
+    rtgui_glyph_run_begin(&run, dc, &text_rect);
     while (len)
     {
         /* get character */
@@ -78,40 +152,18 @@ void rtgui_fnt_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, cons
             continue;
         }
 
-        /* get position and width */
-        if (fnt->offset == RT_NULL)
-        {
-            width = fnt->header.max_width;
-            position = (ch - fnt->header.first_char) * width * ((fnt->header.height + 7)/8);
-        }
-        else
-        {
-            width = fnt->width[ch - fnt->header.first_char];
-            position = fnt->offset[ch - fnt->header.first_char];
-        }
-
         /* draw a character */
-        data_ptr = (rt_uint8_t*)&fnt->bits[position];
-        for (i = 0; i < width; i ++) /* x */
+        glyph = _fnt_font_get_glyph(fnt, ch);
+        if (glyph != RT_NULL)
         {
-            for (j = 0; j < 8; j ++) /* y */
-            {
-                for (c = 0; c < (fnt->header.height + 7)/8; c ++)
-                {
-                    /* check drawable region */
-                    if ((text_rect.x1 + i > text_rect.x2) || (text_rect.y1 + c * 8 + j > text_rect.y2))
-                        continue;
-
-                    if (data_ptr[i + c * width] & (1 << j))
-                        rtgui_dc_draw_point(dc, text_rect.x1 + i, text_rect.y1 + c * 8 + j);
-                }
-            }
+            rtgui_glyph_run_draw(&run, glyph, text_rect.x1, text_rect.y1);
+            text_rect.x1 += glyph->advance;
         }
 
-        text_rect.x1 += width;
         text += 1;
         len -= 1;
     }
+    rtgui_glyph_run_end(&run);
 }
 
 void rtgui_fnt_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
@@ -142,7 +194,7 @@ void rtgui_fnt_font_get_metrics(struct rtgui_font *font, const char *text, rtgui
                 continue;
             }
 
-            rect->x2 += fnt->width[ch - fnt->header.first_char];
+            rect->x2 += _fnt_font_width(fnt, ch);
         }
 
         text += 1;
@@ -242,14 +294,14 @@ struct rtgui_font *rtgui_fnt_font_create(const char* filename, const char* font_
         /* load hz */
         if (hz && hz_font && fnt_header->asc_offset != 0)
         {
-            struct cache_tree _cache_root = { NULL };
-
-            hz->cache_root = _cache_root;
-            hz->cache_size = 0;
+            hz->cache_size = GUIENGINE_HZ_FILE_CACHE_SIZE;
+            hz->cache = RT_NULL;
             hz->font_size = fnt_header->h;
             hz->font_data_size = (fnt_header->h + 7) / 8 * fnt_header->h;
             hz->fd = -1;
             hz->font_fn = rt_strdup(filename);
+            hz->font_map = RT_NULL;
+            hz->font_map_size = 0;
 
             hz_font->family = rt_strdup(font_family);
             hz_font->height = fnt_header->h;
@@ -302,14 +354,14 @@ struct rtgui_font *rtgui_hz_fnt_font_create(const char* filename, const char* fo
         /* load hz */
         if (hz && hz_font)
         {
-            struct cache_tree _cache_root = { NULL };
-
-            hz->cache_root = _cache_root;
-            hz->cache_size = 0;
+            hz->cache_size = GUIENGINE_HZ_FILE_CACHE_SIZE;
+            hz->cache = RT_NULL;
             hz->font_size = font_size;
             hz->font_data_size = (font_size + 7) / 8 * font_size;
             hz->fd = -1;
             hz->font_fn = rt_strdup(filename);
+            hz->font_map = RT_NULL;
+            hz->font_map_size = 0;
 
             hz_font->family = rt_strdup(font_family);
             hz_font->height = font_size;
@@ -333,6 +385,49 @@ struct rtgui_font *rtgui_hz_fnt_font_create(const char* filename, const char* fo
     return RT_NULL;
 }
 
+struct rtgui_font *rtgui_hz_map_font_create(const void *map, rt_uint32_t size, const char* font_family, rt_uint8_t font_size)
+{
+#ifdef GUIENGINE_USING_HZ_FILE
+    struct rtgui_font *font = RT_NULL;
+    struct rtgui_hz_file_font *hz;
+    struct rtgui_font *hz_font;
+
+    if (map == RT_NULL) return RT_NULL;
+
+    hz = (struct rtgui_hz_file_font*)rtgui_malloc(sizeof(struct rtgui_hz_file_font));
+    hz_font = (struct rtgui_font*)rtgui_malloc(sizeof(struct rtgui_font));
+    if (hz && hz_font)
+    {
+        /* the glyphs are used in place, no file and cache */
+        hz->cache_size = 0;
+        hz->cache = RT_NULL;
+        hz->font_size = font_size;
+        hz->font_data_size = (font_size + 7) / 8 * font_size;
+        hz->fd = -1;
+        hz->font_fn = RT_NULL;
+        hz->font_map = (const rt_uint8_t *)map;
+        hz->font_map_size = size;
+
+        hz_font->family = rt_strdup(font_family);
+        hz_font->height = font_size;
+        hz_font->refer_count = 1;
+        hz_font->engine = &rtgui_hz_file_font_engine;
+        hz_font->data = (void *)hz;
+
+        rtgui_font_system_add_font(hz_font);
+        font = hz_font;
+    }
+    else
+    {
+        rtgui_free(hz);
+        rtgui_free(hz_font);
+    }
+
+    return font;
+#endif
+    return RT_NULL;
+}
+
 struct rtgui_font *rtgui_asc_fnt_font_create(const char* filename, const char* font_family, rt_uint8_t font_size)
 {
     int fd = -1, file_len = 0;
@@ -391,6 +486,135 @@ struct rtgui_font *rtgui_asc_fnt_font_create(const char* filename, const char* f
     return font;
 }
 
+/* point the fnt font to the tables in map, no table is copied */
+static rt_err_t _fnt_map_init(struct fnt_font *fnt, const void *map, rt_uint32_t size)
+{
+    const struct fnt_map_header *header;
+
+    header = (const struct fnt_map_header *)map;
+    if (((rt_ubase_t)map & 0x03) || size < sizeof(struct fnt_map_header))
+        return -RT_ERROR;
+    if (rt_memcmp(header->magic, FNT_MAP_MAGIC, 4) != 0 ||
+            header->version != FNT_MAP_VERSION ||
+            header->header_size < sizeof(struct fnt_map_header) ||
+            header->height == 0 || header->size == 0)
+        return -RT_ERROR;
+
+    /* the tables in the map, in the sizes not overflowed */
+    if (header->bits > size || header->nbits > size - header->bits)
+        return -RT_ERROR;
+    if ((header->offset_table == 0) != (header->width_table == 0))
+        return -RT_ERROR;
+    if (header->offset_table != 0 &&
+            (header->size > size / 4 ||
+             header->offset_table > size - header->size * 4 ||
+             header->width_table > size - header->size ||
+             (header->offset_table & 0x03)))
+        return -RT_ERROR;
+
+    rt_memset(fnt, 0x00, sizeof(struct fnt_font));
+    rt_memcpy(fnt->header.version, header->magic, 4);
+    fnt->header.max_width = header->max_width;
+    fnt->header.height = header->height;
+    fnt->header.ascent = header->ascent;
+    fnt->header.depth = header->depth;
+    fnt->header.first_char = header->first_char;
+    fnt->header.default_char = header->default_char;
+    fnt->header.size = header->size;
+    fnt->header.nbits = header->nbits;
+
+    fnt->bits = (const MWIMAGEBITS *)map + header->bits;
+    if (header->offset_table != 0)
+    {
+        fnt->header.noffset = header->size;
+        fnt->header.nwidth = header->size;
+        fnt->long_offset = (const rt_uint32_t *)((const rt_uint8_t *)map + header->offset_table);
+        fnt->width = (const rt_uint8_t *)map + header->width_table;
+    }
+
+    return RT_EOK;
+}
+
+static struct rtgui_font *_fnt_map_font_add(struct fnt_font *fnt, const char* font_family)
+{
+    struct rtgui_font *font;
+
+    font = (struct rtgui_font*)rtgui_malloc(sizeof(struct rtgui_font));
+    if (font == RT_NULL) return RT_NULL;
+
+    font->family = rt_strdup(font_family);
+    font->height = fnt->header.height;
+    font->refer_count = 1;
+    font->engine = &fnt_font_engine;
+    font->data = (void *)fnt;
+
+    rtgui_font_system_add_font(font);
+    return font;
+}
+
+struct rtgui_font *rtgui_fnt_map_font_create(const void *map, rt_uint32_t size, const char* font_family)
+{
+    struct fnt_font *fnt;
+    struct rtgui_font *font;
+
+    if (map == RT_NULL) return RT_NULL;
+
+    fnt = (struct fnt_font*)rtgui_malloc(sizeof(struct fnt_font));
+    if (fnt == RT_NULL) return RT_NULL;
+
+    if (_fnt_map_init(fnt, map, size) != RT_EOK)
+    {
+        rtgui_free(fnt);
+        return RT_NULL;
+    }
+
+    font = _fnt_map_font_add(fnt, font_family);
+    if (font == RT_NULL)
+        rtgui_free(fnt);
+
+    return font;
+}
+RTM_EXPORT(rtgui_fnt_map_font_create);
+
+struct rtgui_font *rtgui_fnt_bin_font_create(const char* filename, const char* font_family)
+{
+    int fd, file_len;
+    struct fnt_font *fnt;
+    struct rtgui_font *font = RT_NULL;
+
+    fd = open(filename, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return RT_NULL;
+    }
+
+    file_len = lseek(fd, 0, SEEK_END);
+    lseek(fd, 0, SEEK_SET);
+    if (file_len <= 0)
+    {
+        close(fd);
+        return RT_NULL;
+    }
+
+    /* the font and the map in one block, the map is aligned after font */
+    fnt = (struct fnt_font*)rtgui_malloc(RT_ALIGN(sizeof(struct fnt_font), 4) + file_len);
+    if (fnt != RT_NULL)
+    {
+        rt_uint8_t *map = (rt_uint8_t *)fnt + RT_ALIGN(sizeof(struct fnt_font), 4);
+
+        if (read(fd, map, file_len) == file_len &&
+                _fnt_map_init(fnt, map, file_len) == RT_EOK)
+            font = _fnt_map_font_add(fnt, font_family);
+
+        if (font == RT_NULL)
+            rtgui_free(fnt);
+    }
+    close(fd);
+
+    return font;
+}
+RTM_EXPORT(rtgui_fnt_bin_font_create);
+
 #ifdef GUIENG_USING_FNT_FILE
 #include <dfs_posix.h>
 
@@ -22,19 +22,23 @@
  * 2010-09-15     Grissom      first version
  */
 
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
 #include <rtthread.h>
 
 #ifdef GUIENGINE_USING_TTF
 #include <rtgui/rtgui.h>
 #include <rtgui/rtgui_system.h>
 #include <rtgui/dc.h>
-#include <rtgui/blit.h>
 #include <rtgui/font.h>
+#include <rtgui/font_atlas.h>
 #include <rtgui/font_freetype.h>
+#include <rtgui/profile.h>
 
 #include <ftcache.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_MODULE_H
 
 #define LOG_ERROR
 
@@ -52,9 +56,6 @@
 #define PINFO(...)
 #endif
 
-#define _dc_get_pixel(dc, x, y)	\
-    ((dc)->pixel + (y) * (dc)->pitch + (x) * rtgui_color_get_bpp((dc)->pixel_format))
-
 #if !defined(RT_USING_DFS) || !defined(RT_USING_DFS_ELMFAT) || (RT_DFS_ELM_CODE_PAGE != 936)
 extern rt_uint32_t gb2312tounicode(const rt_uint16_t key);
 #else
@@ -309,13 +310,18 @@ static void ftc_draw_text(struct rtgui_font *font,
                           rt_ubase_t len,
                           struct rtgui_rect *rect);
 static void ftc_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect);
+static rt_err_t ftc_prepare_text(struct rtgui_font *font, struct rtgui_text_run *run);
+static void ftc_draw_text_run(struct rtgui_font *font, struct rtgui_dc *dc,
+                              struct rtgui_text_run *run, struct rtgui_rect *rect);
 
 static const struct rtgui_font_engine ftc_engine =
 {
     RT_NULL,
     RT_NULL,
     ftc_draw_text,
-    ftc_get_metrics
+    ftc_get_metrics,
+    ftc_prepare_text,
+    ftc_draw_text_run
 };
 
 struct ttf_face_id
@@ -331,10 +337,21 @@ struct rtgui_ttf
     rt_uint32_t		refer_count;
 
     struct ttf_face_id  face_id;
-    FT_Library  		library;
-    FTC_Manager 		manager;
-    FTC_SBitCache 		sbit_cache;
-    FTC_CMapCache 		cmap_cache;
+};
+
+/* the library and cache manager shared by all the ttf files, so the limits
+ * of cache manager are the budget of FreeType */
+struct ftc_shared
+{
+    struct FT_MemoryRec_ memory;
+    FT_Library          library;
+    FTC_Manager         manager;
+    FTC_SBitCache       sbit_cache;
+    FTC_CMapCache       cmap_cache;
+
+    /* the allocations, a lookup of cache without allocation is a hit */
+    rt_uint32_t         allocs;
+    struct rtgui_ttf_stat stat;
 };
 
 struct rtgui_ttf_font
@@ -344,6 +361,7 @@ struct rtgui_ttf_font
 };
 
 static rtgui_list_t _rtgui_ttf_list;
+static struct ftc_shared _ftc;
 
 void rtgui_ttf_system_init(void)
 {
@@ -393,244 +411,293 @@ static void rtgui_ttf_derefer(struct rtgui_ttf *ttf)
 }
 
 
-static void _get_metrics(struct rtgui_ttf_font *ttf_font, const rt_uint16_t *text_short, struct rtgui_rect *rect);
+/* the heap of FreeType, the size is saved before each block */
+static void *_ftc_alloc(FT_Memory memory, long size)
+{
+    rt_uint32_t *block;
+
+    block = (rt_uint32_t *)rtgui_malloc(size + 2 * sizeof(rt_uint32_t));
+    if (block == RT_NULL) return RT_NULL;
 
-static void _draw_bitmap(struct rtgui_dc *dc,
-                         FTC_SBit bitmap,
-                         rt_int16_t ox, rt_int16_t btm_y,
-                         rtgui_color_t fgc, rt_uint16_t right, rt_uint16_t bottom)
+    block[0] = size;
+    _ftc.allocs ++;
+    _ftc.stat.bytes += size;
+    if (_ftc.stat.bytes > _ftc.stat.max_bytes)
+        _ftc.stat.max_bytes = _ftc.stat.bytes;
+
+    return block + 2;
+}
+
+static void _ftc_free(FT_Memory memory, void *ptr)
 {
-    rt_int16_t x_start, y_start;
-    struct rtgui_blit_info info = { 0 };
-    struct rtgui_dc_buffer *dest_buf;
+    rt_uint32_t *block;
+
+    if (ptr == RT_NULL) return;
 
+    block = (rt_uint32_t *)ptr - 2;
+    _ftc.stat.bytes -= block[0];
+    rtgui_free(block);
+}
+
+static void *_ftc_realloc(FT_Memory memory, long cur_size, long new_size, void *ptr)
+{
+    rt_uint32_t *block;
 
-    x_start = ox + bitmap->left;
-    y_start = btm_y - bitmap->top;
+    if (ptr == RT_NULL) return _ftc_alloc(memory, new_size);
 
-    PINFO(" draw bitmap (x, y) -> (%d, %d)\n", x_start, y_start);
+    block = (rt_uint32_t *)rtgui_realloc((rt_uint32_t *)ptr - 2, new_size + 2 * sizeof(rt_uint32_t));
+    if (block == RT_NULL) return RT_NULL;
 
-    info.a = RTGUI_RGB_A(fgc);
-    info.r = RTGUI_RGB_R(fgc);
-    info.g = RTGUI_RGB_G(fgc);
-    info.b = RTGUI_RGB_B(fgc);
+    _ftc.allocs ++;
+    _ftc.stat.bytes += new_size - block[0];
+    if (_ftc.stat.bytes > _ftc.stat.max_bytes)
+        _ftc.stat.max_bytes = _ftc.stat.bytes;
+    block[0] = new_size;
 
-    if (dc->type == RTGUI_DC_HW)
+    return block + 2;
+}
+
+static FT_Error ftc_face_requester(FTC_FaceID faceID, FT_Library lib, FT_Pointer reqData, FT_Face *face);
+
+static FT_Error _ftc_init(void)
+{
+    FT_Error err;
+
+    _ftc.memory.user = RT_NULL;
+    _ftc.memory.alloc = _ftc_alloc;
+    _ftc.memory.free = _ftc_free;
+    _ftc.memory.realloc = _ftc_realloc;
+
+    err = FT_New_Library(&_ftc.memory, &_ftc.library);
+    if (err)
     {
-        struct rtgui_graphic_driver *hw_driver = rtgui_graphic_driver_get_default();
-        dest_buf = (struct rtgui_dc_buffer*)dc;
+        PERROR("FT_New_Library failed err: %d\n", err);
+        return err;
+    }
+    FT_Add_Default_Modules(_ftc.library);
 
-        if (hw_driver->framebuffer != RT_NULL)
-        {
-            struct rtgui_widget *owner = ((struct rtgui_dc_hw*)dest_buf)->owner;
-
-            if (x_start + bitmap->width < 0 || y_start + bitmap->height < 0
-                    || x_start > owner->extent.x2 - owner->extent.x1 || y_start > owner->extent.y2 - owner->extent.y1)
-                return;
-
-            /* blit source */
-            info.src = (rt_uint8_t *)bitmap->buffer;
-            info.src = info.src + (y_start > 0 ? 0 : bitmap->top - btm_y) * bitmap->width + (x_start > 0 ? 0 : -x_start);
-            info.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ALPHA;
-            info.src_w = bitmap->width - (x_start > 0 ? 0 : -x_start) - (x_start + bitmap->width < owner->extent.x2 - owner->extent.x1 ? 0 : x_start + bitmap->width - owner->extent.x2 + owner->extent.x1);
-            info.src_h = bitmap->height - (y_start > 0 ? 0 : bitmap->top - btm_y) - (y_start + bitmap->height < owner->extent.y2 - owner->extent.y1 ? 0 : y_start + bitmap->height - owner->extent.y2 + owner->extent.y1);
-            info.src_pitch = bitmap->width;
-            info.src_skip = info.src_pitch - info.src_w;
-
-            /* blit destination */
-            info.dst = (rt_uint8_t*)hw_driver->framebuffer;
-            info.dst = info.dst + (owner->extent.y1 + (y_start < 0 ? 0 : y_start)) * hw_driver->pitch + (owner->extent.x1 + (x_start < 0 ? 0 : x_start)) * rtgui_color_get_bpp(hw_driver->pixel_format);
-            info.dst_fmt = hw_driver->pixel_format;
-            info.dst_w = info.src_w;
-            info.dst_h = info.src_h;
-            info.dst_pitch = hw_driver->pitch;
-            info.dst_skip = info.dst_pitch - info.dst_w * rtgui_color_get_bpp(hw_driver->pixel_format);
-
-            rtgui_blit(&info);
-        }
+    err = FTC_Manager_New(_ftc.library, GUIENGINE_TTF_MAX_FACES, GUIENGINE_TTF_MAX_SIZES,
+                          GUIENGINE_TTF_MAX_BYTES, ftc_face_requester, 0, &_ftc.manager);
+    if (err != 0)
+    {
+        PERROR("FTC_Manager_New failed!\n");
+        goto _err_done_library;
     }
-    else if (dc->type == RTGUI_DC_BUFFER)
+
+    err = FTC_CMapCache_New(_ftc.manager, &_ftc.cmap_cache);
+    if (err != 0)
     {
-        int max_right, max_bottom;
+        PERROR("FTC_CMapCache_New failed!\n");
+        goto _err_done_manager;
+    }
 
-        dest_buf = (struct rtgui_dc_buffer*)dc;
-        max_right = right > dest_buf->width ? dest_buf->width : right;
-        max_bottom = bottom > dest_buf->height ? dest_buf->height : bottom;
+    err = FTC_SBitCache_New(_ftc.manager, &_ftc.sbit_cache);
+    if (err != 0)
+    {
+        PERROR("FTC_SBitCache_New failed!\n");
+        goto _err_done_manager;
+    }
 
-        if (x_start + bitmap->width < 0 || y_start + bitmap->height < 0
-                || x_start > max_right || y_start > max_bottom)
-            return;
+    return 0;
 
-        /* blit source */
-        info.src = (rt_uint8_t *)bitmap->buffer;
-        info.src = info.src + (y_start > 0 ? 0 : -y_start) * bitmap->width + (x_start > 0 ? 0 : -x_start);
-        info.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ALPHA;
-        info.src_w = bitmap->width - (x_start > 0 ? 0 : -x_start) - (x_start + bitmap->width < max_right ? 0 : x_start + bitmap->width - max_right);
-        info.src_h = bitmap->height - (y_start > 0 ? 0 : -y_start) - (y_start + bitmap->height < max_bottom ? 0 : y_start + bitmap->height - max_bottom);
-        info.src_pitch = bitmap->width;
-        info.src_skip = info.src_pitch - info.src_w;
-
-        /* blit destination */
-        info.dst = _dc_get_pixel(dest_buf, (x_start < 0 ? 0 : x_start), (y_start < 0 ? 0 : y_start));
-        info.dst_fmt = dest_buf->pixel_format;
-        info.dst_w = info.src_w;
-        info.dst_h = info.src_h;
-        info.dst_pitch = dest_buf->pitch;
-        info.dst_skip = info.dst_pitch - info.dst_w * rtgui_color_get_bpp(dest_buf->pixel_format);
-
-        rtgui_blit(&info);
-    }
+_err_done_manager:
+    FTC_Manager_Done(_ftc.manager);
+_err_done_library:
+    FT_Done_Library(_ftc.library);
+    _ftc.library = RT_NULL;
+
+    return err;
+}
+
+static void _ftc_done(void)
+{
+    FTC_Manager_Done(_ftc.manager);
+    FT_Done_Library(_ftc.library);
+    _ftc.library = RT_NULL;
+}
+
+static FT_Error _ftc_sbit_lookup(struct rtgui_ttf_font *ttf_font, FT_UInt gindex, FTC_SBit *sbit)
+{
+    FT_Error err;
+    rt_uint32_t allocs = _ftc.allocs;
+
+    err = FTC_SBitCache_Lookup(_ftc.sbit_cache, &ttf_font->image_type_rec, gindex, sbit, 0);
+    if (_ftc.allocs == allocs)
+        _ftc.stat.hits ++;
     else
-    {
-        struct rtgui_rect text_rect;
-        struct rtgui_point dc_point = { 0, 0 };
-        struct rtgui_dc *text_dc;
+        _ftc.stat.misses ++;
 
-        if (x_start + bitmap->width < 0 || y_start + bitmap->height < 0
-                || x_start > right || y_start > bottom)
-            return;
+    return err;
+}
 
-        text_dc = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, bitmap->width, bitmap->height);
-        if (text_dc)
-        {
-            dest_buf = (struct rtgui_dc_buffer*)text_dc;
+void rtgui_ttf_get_stat(struct rtgui_ttf_stat *stat)
+{
+    RT_ASSERT(stat != RT_NULL);
 
-            /* blit source */
-            info.a = 0;
-            info.src = (rt_uint8_t *)bitmap->buffer;
-            info.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ALPHA;
-            info.src_w = bitmap->width;
-            info.src_h = bitmap->height;
-            info.src_pitch = bitmap->width;
-            info.src_skip = 0;
+    *stat = _ftc.stat;
+}
+RTM_EXPORT(rtgui_ttf_get_stat);
 
-            /* blit destination */
-            info.dst = _dc_get_pixel(dest_buf, 0, 0);
-            info.dst_fmt = dest_buf->pixel_format;
-            info.dst_w = info.src_w;
-            info.dst_h = info.src_h;
-            info.dst_pitch = dest_buf->pitch;
-            info.dst_skip = info.dst_pitch - info.dst_w * rtgui_color_get_bpp(dest_buf->pixel_format);
+struct ftc_text_run;
+static void _get_metrics(struct rtgui_ttf_font *ttf_font, const struct ftc_text_run *prep, struct rtgui_rect *rect);
 
-            rtgui_blit(&info);
+static void _draw_bitmap(struct rtgui_glyph_run *run,
+                         struct rtgui_ttf_font *ttf_font, FT_UInt gindex,
+                         FTC_SBit bitmap,
+                         rt_int16_t ox, rt_int16_t btm_y)
+{
+    struct rtgui_glyph glyph, *mono;
 
-            text_rect.x1 = x_start;
-            text_rect.x2 = text_rect.x1 + bitmap->width;
+    PINFO(" draw bitmap (x, y) -> (%d, %d)\n", ox + bitmap->left, btm_y - bitmap->top);
 
-            text_rect.y1 = y_start;
-            text_rect.y2 = text_rect.y1 + bitmap->height;
+    /* the sbit cache already holds the coverage, draw it without copying */
+    glyph.bitmap = bitmap->buffer;
+    glyph.pitch = bitmap->pitch;
+    if (bitmap->format == FT_PIXEL_MODE_MONO)
+    {
+        /* the 1bpp of mono profile or strike is expanded once in the atlas */
+        mono = rtgui_font_atlas_find(ttf_font, gindex);
+        if (mono == RT_NULL)
+            mono = rtgui_font_atlas_add_mono(ttf_font, gindex, bitmap->buffer,
+                                             bitmap->width, bitmap->height, bitmap->pitch);
+        if (mono == RT_NULL)
+            return;
+        glyph.bitmap = mono->bitmap;
+        glyph.pitch = mono->pitch;
+    }
+    glyph.width = bitmap->width;
+    glyph.height = bitmap->height;
+    glyph.left = bitmap->left;
+    glyph.top = -bitmap->top;
+    glyph.advance = bitmap->xadvance;
 
-            rtgui_dc_buffer_set_alpha(text_dc, RTGUI_RGB_A(fgc));
-            rtgui_dc_blit(text_dc, &dc_point, dc, &text_rect);
+    rtgui_glyph_run_draw(run, &glyph, ox, btm_y);
+}
 
-            rtgui_dc_destory(text_dc);
-        }
+/* the text decoded and mapped to glyphs */
+struct ftc_text_run
+{
+    /* the metrics before align */
+    struct rtgui_rect metrics;
+    /* the glyph of '-', which width is used for space */
+    FT_UInt dash;
+
+    int count;
+    FT_UInt *glyphs;
+    rt_uint16_t *codes;
+};
+
+static struct ftc_text_run *_prepare_text(struct rtgui_ttf_font *ttf_font, const char *text, int len)
+{
+    int count, index;
+    struct ftc_text_run *prep;
+
+    /* allocate unicode buffer */
+#ifndef GUIENGINE_TTF_UTF8
+    count = len;
+#else
+    count = utf8_to_unicode_len(text, len);
+#endif
+    prep = (struct ftc_text_run *)rtgui_malloc(sizeof(struct ftc_text_run) +
+            count * sizeof(FT_UInt) + (count + 1) * sizeof(rt_uint16_t));
+    if (prep == RT_NULL)
+        return RT_NULL; /* out of memory */
+
+    prep->glyphs = (FT_UInt *)(prep + 1);
+    prep->codes = (rt_uint16_t *)(prep->glyphs + count);
+    rt_memset(prep->codes, 0x00, (count + 1) * sizeof(rt_uint16_t));
+
+    /* convert gbk to unicode */
+#ifndef GUIENGINE_TTF_UTF8
+    gbk_to_unicode(prep->codes, text, len);
+#else
+    utf8_to_unicode(prep->codes, text, len);
+#endif
+
+    for (index = 0; index < count && prep->codes[index]; index ++)
+    {
+        prep->glyphs[index] = FTC_CMapCache_Lookup(_ftc.cmap_cache,
+                              &ttf_font->ttf->face_id, 0, prep->codes[index]);
     }
+    prep->count = index;
+    prep->dash = FTC_CMapCache_Lookup(_ftc.cmap_cache, &ttf_font->ttf->face_id, 0, '-');
+
+    _get_metrics(ttf_font, prep, &prep->metrics);
+
+    return prep;
 }
 
-static void _draw_text(struct rtgui_dc *dc,
+static void _draw_text(struct rtgui_glyph_run *run,
                        struct rtgui_ttf_font *ttf_font,
-                       rt_uint16_t *text_short,
-                       rt_int16_t begin_x, rt_int16_t btm_y,
-                       rtgui_color_t fgc, rt_uint16_t right, rt_uint16_t bottom)
+                       const struct ftc_text_run *prep,
+                       rt_int16_t begin_x, rt_int16_t btm_y)
 {
-    int glyphIndex;
+    int index;
     FTC_SBit ftcSBit = RT_NULL;
     FT_Error err = 0;
 
-    while (*text_short)
+    for (index = 0; index < prep->count; index ++)
     {
-        glyphIndex = FTC_CMapCache_Lookup(ttf_font->ttf->cmap_cache, &ttf_font->ttf->face_id, 0, *text_short);
-
-        err = FTC_SBitCache_Lookup(ttf_font->ttf->sbit_cache, &ttf_font->image_type_rec, glyphIndex, &ftcSBit, 0);
+        err = _ftc_sbit_lookup(ttf_font, prep->glyphs[index], &ftcSBit);
         if (err == 0 && ftcSBit->width != 0)
         {
             /* render font */
             begin_x -= (ftcSBit->left - (abs(ftcSBit->left) + 2) / 2);
 
-            _draw_bitmap(dc, ftcSBit, begin_x, btm_y, fgc, right, bottom);
+            _draw_bitmap(run, ttf_font, prep->glyphs[index], ftcSBit, begin_x, btm_y);
 
             begin_x += ftcSBit->width + ftcSBit->left;
-
-            text_short++;
         }
-        else if (*text_short == ' ')
+        else if (prep->codes[index] == ' ')
         {
-            glyphIndex = FTC_CMapCache_Lookup(ttf_font->ttf->cmap_cache, &ttf_font->ttf->face_id, 0, '-');
-
-            err = FTC_SBitCache_Lookup(ttf_font->ttf->sbit_cache, &ttf_font->image_type_rec, glyphIndex, &ftcSBit, 0);
+            err = _ftc_sbit_lookup(ttf_font, prep->dash, &ftcSBit);
             if (err == 0)
             {
                 begin_x += ftcSBit->width;
-
-                text_short++;
             }
         }
     }
 }
 
-static void ftc_draw_text(struct rtgui_font *font,
-                          struct rtgui_dc *dc,
-                          const char *text,
-                          rt_ubase_t len,
-                          struct rtgui_rect *rect)
+static void _draw_prepared(struct rtgui_font *font,
+                           struct rtgui_dc *dc,
+                           const struct ftc_text_run *prep,
+                           struct rtgui_rect *rect)
 {
-    rt_uint16_t *text_short;
     struct rtgui_ttf_font *ttf_font;
     rt_int16_t begin_x, btm_y;
     rt_int16_t topy;
-    rtgui_color_t fgc;
-    struct rtgui_rect text_rect;
-
-    RT_ASSERT(font != RT_NULL);
-    ttf_font = (struct rtgui_ttf_font *) font->data;
-    RT_ASSERT(ttf_font != RT_NULL);
-
-    /* allocate unicode buffer */
-#ifndef GUIENGINE_TTF_UTF8
-    text_short = (rt_uint16_t *)rtgui_malloc((len + 1) * 2);
-#else
-    text_short = (rt_uint16_t *)rtgui_malloc((utf8_to_unicode_len(text, len) + 1) * 2);
-#endif
-    if (text_short == RT_NULL)
-        return; /* out of memory */
-#ifndef GUIENGINE_TTF_UTF8
-    rt_memset(text_short, 0x00, (len + 1) * 2);
-#else
-    rt_memset(text_short, 0x00, (utf8_to_unicode_len(text, len) + 1) * 2);
-#endif
+    struct rtgui_rect text_rect, clip_rect;
+    struct rtgui_glyph_run run;
 
     RT_ASSERT(rect);
-
-    /* convert gbk to unicode */
-#ifndef GUIENGINE_TTF_UTF8
-    gbk_to_unicode(text_short, text, len);
-#else
-    utf8_to_unicode(text_short, text, len);
-#endif
-
-    fgc = RTGUI_DC_FC(dc);
+    ttf_font = (struct rtgui_ttf_font *) font->data;
 
     /* text align */
-    _get_metrics(ttf_font, text_short, &text_rect);
+    text_rect = prep->metrics;
 
     topy = text_rect.y1;
 
     _rtgui_rect_move_to_align(rect, &text_rect, font->height, RTGUI_DC_TEXTALIGN(dc));
 
     btm_y = topy + text_rect.y2;
-    if (btm_y <= 0)
-        return;
     begin_x = text_rect.x1;
 
-    if (dc->type == RTGUI_DC_BUFFER)
+    /* the rotated text is in the coordinate of text, clipped by the run */
+    if (rtgui_dc_get_gc(dc)->textstyle & RTGUI_TEXTSTYLE_ROTATE_MASK)
+    {
+        clip_rect = *rect;
+    }
+    else if (btm_y <= 0)
+    {
+        return;
+    }
+    else if (dc->type == RTGUI_DC_BUFFER)
     {
         struct rtgui_dc_buffer *bdc = (struct rtgui_dc_buffer *) dc;
 
         if (begin_x >= bdc->width || topy >= bdc->height)
-        {
-            goto _out;
-        }
+            return;
     }
     else if (dc->type == RTGUI_DC_HW)
     {
@@ -640,55 +707,80 @@ static void ftc_draw_text(struct rtgui_font *font,
         x = begin_x + hdc->owner->extent.x1;
         y = topy + hdc->owner->extent.y1;
         if (x >= hdc->owner->extent.x2)
-            goto _out;
+            return;
         if (y >= hdc->owner->extent.y2)
-            goto _out;
+            return;
     }
 
-    _draw_text(dc, ttf_font, text_short, begin_x, btm_y, fgc, rect->x2, rect->y2);
+    if (!(rtgui_dc_get_gc(dc)->textstyle & RTGUI_TEXTSTYLE_ROTATE_MASK))
+    {
+        /* the glyphs may be above or left of rect after align */
+        clip_rect.x1 = clip_rect.y1 = 0;
+        clip_rect.x2 = rect->x2;
+        clip_rect.y2 = rect->y2;
+    }
 
-_out:
-    /* release unicode buffer */
-    rtgui_free(text_short);
+    rtgui_glyph_run_begin(&run, dc, &clip_rect);
+    /* the glyph boxes are not in one line, don't fill the background */
+    run.style &= ~RTGUI_TEXTSTYLE_DRAW_BACKGROUND;
+    _draw_text(&run, ttf_font, prep, begin_x, btm_y);
+    rtgui_glyph_run_end(&run);
 }
 
-static void _get_metrics(struct rtgui_ttf_font *ttf_font, const rt_uint16_t *text_short, struct rtgui_rect *rect)
+static void ftc_draw_text(struct rtgui_font *font,
+                          struct rtgui_dc *dc,
+                          const char *text,
+                          rt_ubase_t len,
+                          struct rtgui_rect *rect)
 {
+    struct ftc_text_run *prep;
+    struct rtgui_ttf_font *ttf_font;
+
+    RT_ASSERT(font != RT_NULL);
+    ttf_font = (struct rtgui_ttf_font *) font->data;
+    RT_ASSERT(ttf_font != RT_NULL);
+
+    prep = _prepare_text(ttf_font, text, len);
+    if (prep == RT_NULL)
+        return; /* out of memory */
+
+    _draw_prepared(font, dc, prep, rect);
+
+    rtgui_free(prep);
+}
+
+static void _get_metrics(struct rtgui_ttf_font *ttf_font, const struct ftc_text_run *prep, struct rtgui_rect *rect)
+{
+    int index;
     FTC_SBit ftcSBit = RT_NULL;
     rt_int16_t w = 0, top = 0, btm = 0;
 
-    while (*text_short)
+    for (index = 0; index < prep->count; index ++)
     {
         FT_Error err = 0;
-        int glyphIndex;
-
-        glyphIndex = FTC_CMapCache_Lookup(ttf_font->ttf->cmap_cache, &ttf_font->ttf->face_id, 0, *text_short);
 
-        err = FTC_SBitCache_Lookup(ttf_font->ttf->sbit_cache, &ttf_font->image_type_rec, glyphIndex, &ftcSBit, 0);
+        err = _ftc_sbit_lookup(ttf_font, prep->glyphs[index], &ftcSBit);
         if (err == 0 && ftcSBit->width != 0)
         {
+            w -= (ftcSBit->left - (abs(ftcSBit->left) + 2) / 2);
             w -= (ftcSBit->left - (abs(ftcSBit->left) + 2) / 2);
             w += ftcSBit->width + ftcSBit->left;
 
             top = top > ftcSBit->top ? top : ftcSBit->top;
             btm = (ftcSBit->top - ftcSBit->height) > btm ? btm : (ftcSBit->top - ftcSBit->height);
         }
-        else if (*text_short == ' ')
+        else if (prep->codes[index] == ' ')
         {
-            glyphIndex = FTC_CMapCache_Lookup(ttf_font->ttf->cmap_cache, &ttf_font->ttf->face_id, 0, '-');
-
-            err = FTC_SBitCache_Lookup(ttf_font->ttf->sbit_cache, &ttf_font->image_type_rec, glyphIndex, &ftcSBit, 0);
+            err = _ftc_sbit_lookup(ttf_font, prep->dash, &ftcSBit);
             if (err == 0)
             {
                 w += ftcSBit->width;
             }
         }
-        PINFO(" bitmap:(%d, %d, %d, %d)\n", ftcSBit->left, ftcSBit->top - ftcSBit->height, ftcSBit->width, ftcSBit->height);
-
-        text_short ++;
     }
 
-    w += ftcSBit->left - (ftcSBit->left - (abs(ftcSBit->left) + 2) / 2);
+    if (ftcSBit != RT_NULL)
+        w += ftcSBit->left - (ftcSBit->left - (abs(ftcSBit->left) + 2) / 2);
 
     rect->x1 = 0;
     rect->y1 = btm;
@@ -701,7 +793,7 @@ static void _get_metrics(struct rtgui_ttf_font *ttf_font, const rt_uint16_t *tex
 static void ftc_get_metrics(struct rtgui_font *font, const char *text, struct rtgui_rect *rect)
 {
     int len;
-    rt_uint16_t *text_short;
+    struct ftc_text_run *prep;
     struct rtgui_ttf_font *ttf_font;
 
     RT_ASSERT(font != RT_NULL);
@@ -715,34 +807,36 @@ static void ftc_get_metrics(struct rtgui_font *font, const char *text, struct rt
 
     memset(rect, 0, sizeof(struct rtgui_rect));
 
-    /* allocate unicode buffer */
-#ifndef GUIENGINE_TTF_UTF8
-    text_short = (rt_uint16_t *)rtgui_malloc((len + 1) * 2);
-#else
-    text_short = (rt_uint16_t *)rtgui_malloc((utf8_to_unicode_len(text, len) + 1) * 2);
-#endif
-    if (text_short == RT_NULL)
+    prep = _prepare_text(ttf_font, text, len);
+    if (prep == RT_NULL)
         return; /* out of memory */
 
-#ifndef GUIENGINE_TTF_UTF8
-    rt_memset(text_short, 0x00, (len + 1) * 2);
-#else
-    rt_memset(text_short, 0x00, (utf8_to_unicode_len(text, len) + 1) * 2);
-#endif
-
-    /* convert gbk to unicode */
-#ifndef GUIENGINE_TTF_UTF8
-    gbk_to_unicode(text_short, text, len);
-#else
-    utf8_to_unicode(text_short, text, len);
-#endif
-
-    _get_metrics(ttf_font, text_short, rect);
+    *rect = prep->metrics;
     rtgui_rect_move_to_point(rect, 0, 0);
 
     PINFO(" ftc_get_metrics_kern: %d %d %d %d\n", rect->x1, rect->y1, rect->x2, rect->y2);
-    /* release unicode buffer */
-    rtgui_free(text_short);
+    rtgui_free(prep);
+}
+
+static rt_err_t ftc_prepare_text(struct rtgui_font *font, struct rtgui_text_run *run)
+{
+    struct ftc_text_run *prep;
+
+    prep = _prepare_text((struct rtgui_ttf_font *) font->data, rtgui_text_run_text(run), run->len);
+    if (prep == RT_NULL)
+        return -RT_ENOMEM;
+
+    run->data = prep;
+    run->metrics = prep->metrics;
+    rtgui_rect_move_to_point(&run->metrics, 0, 0);
+
+    return RT_EOK;
+}
+
+static void ftc_draw_text_run(struct rtgui_font *font, struct rtgui_dc *dc,
+                              struct rtgui_text_run *run, struct rtgui_rect *rect)
+{
+    _draw_prepared(font, dc, (const struct ftc_text_run *)run->data, rect);
 }
 
 static FT_Error ftc_face_requester(FTC_FaceID faceID, FT_Library lib, FT_Pointer reqData, FT_Face *face)
@@ -752,7 +846,10 @@ static FT_Error ftc_face_requester(FTC_FaceID faceID, FT_Library lib, FT_Pointer
     struct ttf_face_id *face_id = (struct ttf_face_id *)faceID;
 
     PINFO("ftc_face_requester  %s  %d\n", face_id->pathname, face_id->face_index);
+    _ftc.stat.faces ++;
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_TTF_FACE);
     ret = FT_New_Face(lib, (char *)face_id->pathname, face_id->face_index, face);
+    RTGUI_BOOT_END(RTGUI_BOOT_TTF_FACE);
     if (ret != 0)
     {
         PERROR("FT_New_Face failed!\n");
@@ -784,6 +881,18 @@ static struct rtgui_ttf *rtgui_ttf_load(const char *filename)
         else
         {
             PERROR("open %s failed!\n", filename);
+            rtgui_free(ttf);
+            return RT_NULL;
+        }
+    }
+
+    /* the library and cache manager are created for the first ttf */
+    if (_ftc.library == RT_NULL)
+    {
+        err = _ftc_init();
+        if (err != 0)
+        {
+            rtgui_free(ttf);
             return RT_NULL;
         }
     }
@@ -791,52 +900,101 @@ static struct rtgui_ttf *rtgui_ttf_load(const char *filename)
     /* face_id init */
     ttf->face_id.pathname = rt_strdup(filename);
     ttf->face_id.face_index = 0;
+    ttf->refer_count = 1;
 
-    err = FT_Init_FreeType(&ttf->library);
-    if (err)
-    {
-        PERROR("FT_Init_FreeType failed err: %d\n", err);
-        goto _err_done_malloc;
-    }
+    rtgui_ttf_system_add_ttf(ttf);
 
-    err = FTC_Manager_New(ttf->library, 0, 0, 0, ftc_face_requester, 0, &ttf->manager);
-    if (err != 0)
-    {
-        PERROR("FTC_Manager_New failed!\n");
-        goto _err_done_init;
-    }
+    return ttf;
+}
+RTM_EXPORT(rtgui_ttf_load);
 
-    err = FTC_CMapCache_New(ttf->manager, &ttf->cmap_cache);
-    if (err != 0)
+/* no hinting at all sizes, the speed of the cache misses first */
+static const struct rtgui_ttf_profile _ttf_default_profiles[] =
+{
+#if GUIENGINE_TTF_SMALL_SIZE > 0
+    {GUIENGINE_TTF_SMALL_SIZE, GUIENGINE_TTF_SMALL_FLAGS},
+#endif
+    {0xFFFF, RTGUI_TTF_HINT_NONE},
+};
+static const struct rtgui_ttf_profile *_ttf_profiles = _ttf_default_profiles;
+static int _ttf_profile_count = sizeof(_ttf_default_profiles) / sizeof(_ttf_default_profiles[0]);
+
+void rtgui_ttf_set_profiles(const struct rtgui_ttf_profile *profiles, int count)
+{
+    if (profiles == RT_NULL || count <= 0)
     {
-        PERROR("FTC_CMapCache_New failed!\n");
-        goto _err_done_manager;
+        _ttf_profiles = _ttf_default_profiles;
+        _ttf_profile_count = sizeof(_ttf_default_profiles) / sizeof(_ttf_default_profiles[0]);
+        return;
     }
 
-    err = FTC_SBitCache_New(ttf->manager, &ttf->sbit_cache);
-    if (err != 0)
+    _ttf_profiles = profiles;
+    _ttf_profile_count = count;
+}
+RTM_EXPORT(rtgui_ttf_set_profiles);
+
+static FT_Int32 _ttf_load_flags(rt_uint16_t flags)
+{
+    FT_Int32 load = FT_LOAD_RENDER;
+
+    if (flags & RTGUI_TTF_MONO)
     {
-        PERROR("FTC_SBitCache_New failed!\n");
-        goto _err_done_manager;
+        /* the one target of mono, the hinting is still chosen below */
+        load |= FT_LOAD_MONOCHROME | FT_LOAD_TARGET_MONO;
+        flags &= ~RTGUI_TTF_HINT_LIGHT;
     }
 
-    ttf->refer_count = 1;
+    /* FreeType hints natively without the autofit module */
+    if (flags & RTGUI_TTF_HINT_AUTO)
+        load |= FT_LOAD_FORCE_AUTOHINT;
+    else if (flags & RTGUI_TTF_HINT_LIGHT)
+        load |= FT_LOAD_TARGET_LIGHT;
+    else if (!(flags & RTGUI_TTF_HINT_NATIVE))
+        load |= FT_LOAD_NO_HINTING;
 
-    rtgui_ttf_system_add_ttf(ttf);
+    if (!(flags & RTGUI_TTF_BITMAP))
+        load |= FT_LOAD_NO_BITMAP;
 
-    return ttf;
+    return load;
+}
 
-_err_done_manager:
-    FTC_Manager_Done(ttf->manager);
-_err_done_init:
-    FT_Done_FreeType(ttf->library);
-_err_done_malloc:
-    rt_free((void *)ttf->face_id.pathname);
-    rtgui_free(ttf);
+/* the load flags of the profile for size, and the strike of the embedded bitmaps near it */
+static void _ttf_apply_profile(struct rtgui_ttf_font *ttf_font, int size)
+{
+    int index, ppem, best;
+    FT_Face face;
+    rt_uint16_t flags;
 
-    return RT_NULL;
+    flags = RTGUI_TTF_HINT_NONE;
+    for (index = 0; index < _ttf_profile_count; index ++)
+    {
+        if (size <= _ttf_profiles[index].max_size)
+        {
+            flags = _ttf_profiles[index].flags;
+            break;
+        }
+    }
+    ttf_font->image_type_rec.flags = _ttf_load_flags(flags);
+
+    if (!(flags & RTGUI_TTF_BITMAP) ||
+            FTC_Manager_LookupFace(_ftc.manager, &ttf_font->ttf->face_id, &face) != 0 ||
+            !FT_HAS_FIXED_SIZES(face))
+        return;
+
+    /* snap to the strike within 1 pixel, the glyphs are not scaled or hinted then */
+    best = 0;
+    for (index = 0; index < face->num_fixed_sizes; index ++)
+    {
+        ppem = (face->available_sizes[index].y_ppem + 32) >> 6;
+        if (abs(ppem - size) <= 1 && (best == 0 || abs(ppem - size) < abs(best - size)))
+            best = ppem;
+    }
+    if (best != 0)
+    {
+        ttf_font->image_type_rec.width = best;
+        ttf_font->image_type_rec.height = best;
+    }
 }
-RTM_EXPORT(rtgui_ttf_load);
 
 rtgui_font_t *rtgui_freetype_font_create(const char *filename, rt_size_t size, const char* font_family)
 {
@@ -882,11 +1040,11 @@ rtgui_font_t *rtgui_freetype_font_create(const char *filename, rt_size_t size, c
     ttf_font->image_type_rec.face_id = &ttf_font->ttf->face_id;
     ttf_font->image_type_rec.width 	 = size;
     ttf_font->image_type_rec.height  = size;
-    ttf_font->image_type_rec.flags 	 = FT_LOAD_RENDER | FT_LOAD_NO_HINTING;
+    _ttf_apply_profile(ttf_font, size);
 
     /* set user data */
     font->family = rt_strdup(font_family);
-    font->height = (rt_uint16_t)ttf_font->image_type_rec.height;
+    font->height = (rt_uint16_t)size;
     font->refer_count = 1;
     font->engine = &ftc_engine;
 
@@ -911,9 +1069,13 @@ void rtgui_freetype_font_destroy(rtgui_font_t *font)
 
     if (ttf_font->ttf->refer_count == 0)
     {
-        FTC_Manager_Done(ttf_font->ttf->manager);
-        FT_Done_FreeType(ttf_font->ttf->library);
+        /* drop the face and sizes of ttf from the shared manager */
+        FTC_Manager_RemoveFaceID(_ftc.manager, &ttf_font->ttf->face_id);
+        rt_free((void *)ttf_font->ttf->face_id.pathname);
+        rtgui_free(ttf_font->ttf);
         rt_free(font->family);
+
+        if (_rtgui_ttf_list.next == RT_NULL) _ftc_done();
     }
 
     rtgui_free(font);
@@ -923,5 +1085,13 @@ RTM_EXPORT(rtgui_freetype_font_destroy);
 #ifdef RT_USING_FINSH
 #include <finsh.h>
 FINSH_FUNCTION_EXPORT_ALIAS(rtgui_freetype_font_create, ffc, "create freetype font: name, size, family")
+
+void list_ttf(void)
+{
+    rt_kprintf("glyph hits: %d, misses: %d, faces opened: %d\n",
+               _ftc.stat.hits, _ftc.stat.misses, _ftc.stat.faces);
+    rt_kprintf("FreeType used: %d, maximal used: %d\n", _ftc.stat.bytes, _ftc.stat.max_bytes);
+}
+FINSH_FUNCTION_EXPORT(list_ttf, display freetype cache information);
 #endif
 #endif
@@ -23,6 +23,8 @@
  */
 #include <rtgui/dc.h>
 #include <rtgui/font.h>
+#include <rtgui/font_atlas.h>
+#include <rtgui/gb2312.h>
 
 #ifdef RTGUI_USING_HZ_BMP
 
@@ -33,7 +35,9 @@ const struct rtgui_font_engine hz_bmp_font_engine =
     RT_NULL,
     RT_NULL,
     rtgui_hz_bitmap_font_draw_text,
-    rtgui_hz_bitmap_font_get_metrics
+    rtgui_hz_bitmap_font_get_metrics,
+    RT_NULL,
+    RT_NULL
 };
 
 #ifdef RTGUI_USING_FONT_COMPACT
@@ -76,54 +80,73 @@ rt_inline const rt_uint8_t *_rtgui_hz_bitmap_get_font_ptr(struct rtgui_font_bitm
 
 static void _rtgui_hz_bitmap_font_draw_text(struct rtgui_font_bitmap *bmp_font, struct rtgui_dc *dc, const char *text, rt_ubase_t len, struct rtgui_rect *rect)
 {
-    rtgui_color_t bc;
-    rt_uint16_t style;
     rt_uint8_t *str;
-    register rt_base_t h, word_bytes, font_bytes;
+    struct rtgui_glyph_run run;
+    register rt_base_t word_bytes, font_bytes;
+#ifdef GUIENGINE_HZ_BMP_UTF8
+    int bytes;
+    rt_uint8_t gb[2];
+    rt_uint16_t gb_code;
+    rt_uint32_t unicode;
+#endif
 
     RT_ASSERT(bmp_font != RT_NULL);
 
-    /* get text style */
-    style = rtgui_dc_get_gc(dc)->textstyle;
-    bc = rtgui_dc_get_gc(dc)->background;
-
-    /* drawing height */
-    h = (bmp_font->height + rect->y1 > rect->y2) ? rect->y2 - rect->y1 : bmp_font->height;
     word_bytes = (bmp_font->width + 7) / 8;
     font_bytes = word_bytes * bmp_font->height;
 
     str = (rt_uint8_t *)text;
 
+    rtgui_glyph_run_begin(&run, dc, rect);
     while (len > 0 && rect->x1 < rect->x2)
     {
-        const rt_uint8_t *font_ptr;
-        register rt_base_t i, j, k;
-
-        /* get font pixel data */
-        font_ptr = _rtgui_hz_bitmap_get_font_ptr(bmp_font, str, font_bytes);
-        /* draw word */
-        for (i = 0; i < h; i ++)
+        struct rtgui_glyph *glyph;
+        rt_uint16_t code;
+
+#ifdef GUIENGINE_HZ_BMP_UTF8
+        /* the character of UTF-8 is looked up in GB2312 directly */
+        bytes = rtgui_utf8_decode((const char *)str, len, &unicode);
+        str += bytes;
+        len -= bytes;
+        gb_code = rtgui_unicode_to_gb2312(unicode);
+        if (gb_code == 0)
+        {
+            /* the character not in GB2312 is a blank of half width */
+            rect->x1 += bmp_font->width / 2;
+            continue;
+        }
+        gb[0] = (rt_uint8_t)(gb_code >> 8);
+        gb[1] = (rt_uint8_t)gb_code;
+        code = gb[0] | (gb[1] << 8);
+        glyph = rtgui_font_atlas_find(bmp_font, code);
+        if (glyph == RT_NULL)
+        {
+            glyph = rtgui_font_atlas_add_mono(bmp_font, code,
+                                              _rtgui_hz_bitmap_get_font_ptr(bmp_font, gb, font_bytes),
+                                              bmp_font->width, bmp_font->height, word_bytes);
+        }
+        rtgui_glyph_run_draw(&run, glyph, rect->x1, rect->y1);
+        rect->x1 += bmp_font->width;
+        continue;
+#endif
+        code = *str | (*(str + 1) << 8);
+        glyph = rtgui_font_atlas_find(bmp_font, code);
+        if (glyph == RT_NULL)
         {
-            for (j = 0; j < word_bytes; j++)
-                for (k = 0; k < 8; k++)
-                {
-                    if (((font_ptr[i * word_bytes + j] >> (7 - k)) & 0x01) != 0 &&
-                            (rect->x1 + 8 * j + k < rect->x2))
-                    {
-                        rtgui_dc_draw_point(dc, rect->x1 + 8 * j + k, rect->y1 + i);
-                    }
-                    else if (style & RTGUI_TEXTSTYLE_DRAW_BACKGROUND)
-                    {
-                        rtgui_dc_draw_color_point(dc, rect->x1 + 8 * j + k, rect->y1 + i, bc);
-                    }
-                }
+            /* get font pixel data */
+            glyph = rtgui_font_atlas_add_mono(bmp_font, code,
+                                              _rtgui_hz_bitmap_get_font_ptr(bmp_font, str, font_bytes),
+                                              bmp_font->width, bmp_font->height, word_bytes);
         }
+        /* draw word */
+        rtgui_glyph_run_draw(&run, glyph, rect->x1, rect->y1);
 
         /* move x to next character */
         rect->x1 += bmp_font->width;
         str += 2;
         len -= 2;
     }
+    rtgui_glyph_run_end(&run);
 }
 
 static void rtgui_hz_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text, rt_ubase_t length, struct rtgui_rect *rect)
@@ -135,7 +158,7 @@ static void rtgui_hz_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui
 
     RT_ASSERT(dc != RT_NULL);
 
-    rtgui_font_get_metrics(rtgui_dc_get_gc(dc)->font, text, &text_rect);
+    rtgui_font_get_metrics(font, text, &text_rect);
     rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
 
     /* get English font */
@@ -171,14 +194,34 @@ static void rtgui_hz_bitmap_font_draw_text(struct rtgui_font *font, struct rtgui
 
 static void rtgui_hz_bitmap_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
 {
+    rt_uint32_t count;
     struct rtgui_font_bitmap *bmp_font = (struct rtgui_font_bitmap *)(font->data);
+#ifdef GUIENGINE_HZ_BMP_UTF8
+    int len, bytes;
+    rt_uint32_t unicode;
+#endif
 
     RT_ASSERT(bmp_font != RT_NULL);
 
+#ifdef GUIENGINE_HZ_BMP_UTF8
+    /* the bytes of text in GB2312, counted in one pass of the UTF-8 */
+    count = 0;
+    len = rt_strlen(text);
+    while (len > 0)
+    {
+        bytes = rtgui_utf8_decode(text, len, &unicode);
+        text += bytes;
+        len -= bytes;
+        count += (unicode >= 0x80 && rtgui_unicode_to_gb2312(unicode) != 0) ? 2 : 1;
+    }
+#else
+    count = rt_strlen((const char *)text);
+#endif
+
     /* set metrics rect */
     rect->x1 = rect->y1 = 0;
     /* Chinese font is always fixed font */
-    rect->x2 = (rt_int16_t)(bmp_font->width * rt_strlen((const char *)text));
+    rect->x2 = (rt_int16_t)(bmp_font->width * count);
     rect->y2 = bmp_font->height;
 }
 
@@ -24,9 +24,11 @@
 /*
  * Cached HZ font engine
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
 #include <rtgui/dc.h>
 #include <rtgui/font.h>
-#include <rtgui/tree.h>
+#include <rtgui/font_atlas.h>
 #include <rtgui/rtgui_system.h>
 #include "rtgui/gb2312.h"
 
@@ -45,10 +47,6 @@
 #include <dfs_posix.h>
 #endif
 
-#define HZ_CACHE_MAX    64
-
-static int _font_cache_compare(struct hz_cache *node1, struct hz_cache *node2);
-
 static void rtgui_hz_file_font_load(struct rtgui_font *font);
 static void rtgui_hz_file_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text, rt_ubase_t len, struct rtgui_rect *rect);
 static void rtgui_hz_file_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect);
@@ -57,95 +55,278 @@ const struct rtgui_font_engine rtgui_hz_file_font_engine =
     RT_NULL,
     rtgui_hz_file_font_load,
     rtgui_hz_file_font_draw_text,
-    rtgui_hz_file_font_get_metrics
+    rtgui_hz_file_font_get_metrics,
+    RT_NULL,
+    RT_NULL
 };
 
-SPLAY_PROTOTYPE(cache_tree, hz_cache, hz_node, _font_cache_compare);
-SPLAY_GENERATE(cache_tree, hz_cache, hz_node, _font_cache_compare);
+/*
+ * The font data read from file is cached in fixed size slots. The slots are
+ * indexed by an open addressing hash (linear probing), and linked in the
+ * order of using, so the least recently used slot is reused when the cache
+ * is full. The cache is only accessed in the glyph run, which holds the lock
+ * of glyph atlas.
+ */
+#define HZ_CACHE_NIL    0xffff
+
+struct hz_cache_slot
+{
+    rt_uint16_t hz_id;
+    /* the position in hash */
+    rt_uint16_t pos;
+    /* the list of using, the head is the most recently used */
+    rt_uint16_t prev, next;
+};
 
-static int _font_cache_compare(struct hz_cache *cache_1, struct hz_cache *cache_2)
+struct hz_cache
 {
-    if (cache_1->hz_id > cache_2->hz_id) return 1;
-    if (cache_1->hz_id < cache_2->hz_id) return -1;
+    rt_uint16_t capacity;
+    rt_uint16_t data_size;
+    rt_uint16_t mask;
+    rt_uint16_t head, tail;
+
+    /* the index of slot, HZ_CACHE_NIL for empty */
+    rt_uint16_t *hash;
+    struct hz_cache_slot *slots;
+    rt_uint8_t *data;
+};
+
+#define _hz_cache_hash(cache, hz_id)    (((rt_uint32_t)(hz_id) * 40503u >> 4) & (cache)->mask)
 
-    return 0;
+static struct hz_cache *_hz_cache_create(rt_uint32_t size, rt_uint16_t data_size)
+{
+    rt_uint32_t capacity, hash_size, index;
+    struct hz_cache *cache;
+
+    capacity = size / data_size;
+    if (capacity == 0) return RT_NULL;
+    if (capacity > HZ_CACHE_NIL / 4) capacity = HZ_CACHE_NIL / 4;
+
+    /* keep the hash less than half full */
+    for (hash_size = 1; hash_size < capacity * 2; hash_size <<= 1);
+
+    cache = (struct hz_cache *) rtgui_malloc(sizeof(struct hz_cache) +
+            hash_size * sizeof(rt_uint16_t) +
+            capacity * sizeof(struct hz_cache_slot) +
+            capacity * data_size);
+    if (cache == RT_NULL) return RT_NULL;
+
+    cache->capacity = capacity;
+    cache->data_size = data_size;
+    cache->mask = hash_size - 1;
+    cache->hash = (rt_uint16_t *)(cache + 1);
+    cache->slots = (struct hz_cache_slot *)(cache->hash + hash_size);
+    cache->data = (rt_uint8_t *)(cache->slots + capacity);
+    rt_memset(cache->hash, 0xff, hash_size * sizeof(rt_uint16_t));
+
+    /* all the slots are empty and in the list */
+    for (index = 0; index < capacity; index ++)
+    {
+        cache->slots[index].pos = HZ_CACHE_NIL;
+        cache->slots[index].prev = index - 1;
+        cache->slots[index].next = index + 1;
+    }
+    cache->slots[0].prev = HZ_CACHE_NIL;
+    cache->slots[capacity - 1].next = HZ_CACHE_NIL;
+    cache->head = 0;
+    cache->tail = capacity - 1;
+
+    return cache;
 }
 
-static rt_uint8_t *_font_cache_get(struct rtgui_hz_file_font *font, rt_uint16_t hz_id)
+static void _hz_cache_unlink(struct hz_cache *cache, rt_uint16_t index)
 {
-    rt_uint32_t seek;
-    struct hz_cache *cache, search;
+    struct hz_cache_slot *slot = &cache->slots[index];
 
-    search.hz_id = hz_id;
+    if (slot->prev != HZ_CACHE_NIL) cache->slots[slot->prev].next = slot->next;
+    else cache->head = slot->next;
+    if (slot->next != HZ_CACHE_NIL) cache->slots[slot->next].prev = slot->prev;
+    else cache->tail = slot->prev;
+}
 
-    /* enter critical */
-    rtgui_enter_critical();
+static void _hz_cache_link_head(struct hz_cache *cache, rt_uint16_t index)
+{
+    struct hz_cache_slot *slot = &cache->slots[index];
 
-    cache = SPLAY_FIND(cache_tree, &(font->cache_root), &search);
-    if (cache != RT_NULL)
+    slot->prev = HZ_CACHE_NIL;
+    slot->next = cache->head;
+    if (cache->head != HZ_CACHE_NIL) cache->slots[cache->head].prev = index;
+    else cache->tail = index;
+    cache->head = index;
+}
+
+/* remove the slot from hash, and shift the following entries back */
+static void _hz_cache_unhash(struct hz_cache *cache, rt_uint16_t index)
+{
+    rt_uint16_t hole, pos, home;
+
+    hole = cache->slots[index].pos;
+    if (hole == HZ_CACHE_NIL) return;
+    cache->slots[index].pos = HZ_CACHE_NIL;
+    cache->hash[hole] = HZ_CACHE_NIL;
+
+    for (pos = (hole + 1) & cache->mask; cache->hash[pos] != HZ_CACHE_NIL; pos = (pos + 1) & cache->mask)
     {
-        /* exit critical */
-        rtgui_exit_critical();
+        rt_uint16_t moved = cache->hash[pos];
 
-        /* found it */
-        return (rt_uint8_t *)(cache + 1);
+        /* the entry can fill the hole if its home is not in (hole, pos] */
+        home = _hz_cache_hash(cache, cache->slots[moved].hz_id);
+        if (((pos - home) & cache->mask) >= ((pos - hole) & cache->mask))
+        {
+            cache->hash[hole] = moved;
+            cache->slots[moved].pos = hole;
+            cache->hash[pos] = HZ_CACHE_NIL;
+            hole = pos;
+        }
     }
+}
 
-    /* exit critical */
-    rtgui_exit_critical();
+static rt_uint8_t *_hz_cache_find(struct hz_cache *cache, rt_uint16_t hz_id)
+{
+    rt_uint16_t pos, index;
 
-    /* can not find it, load to cache */
-    cache = (struct hz_cache *) rtgui_malloc(sizeof(struct hz_cache) + font->font_data_size);
-    if (cache == RT_NULL)
-        return RT_NULL; /* no memory yet */
+    for (pos = _hz_cache_hash(cache, hz_id); cache->hash[pos] != HZ_CACHE_NIL; pos = (pos + 1) & cache->mask)
+    {
+        index = cache->hash[pos];
+        if (cache->slots[index].hz_id == hz_id)
+        {
+            if (cache->head != index)
+            {
+                _hz_cache_unlink(cache, index);
+                _hz_cache_link_head(cache, index);
+            }
+
+            return cache->data + index * cache->data_size;
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* take the least recently used slot to read data in */
+static rt_uint16_t _hz_cache_take(struct hz_cache *cache)
+{
+    rt_uint16_t index = cache->tail;
+
+    _hz_cache_unlink(cache, index);
+    _hz_cache_unhash(cache, index);
+
+    return index;
+}
+
+/* put back the slot taken, which is cached if the data is read */
+static void _hz_cache_put(struct hz_cache *cache, rt_uint16_t index, rt_uint16_t hz_id, rt_bool_t valid)
+{
+    rt_uint16_t pos;
+    struct hz_cache_slot *slot = &cache->slots[index];
+
+    if (valid == RT_FALSE)
+    {
+        /* link to the tail to be reused first */
+        slot->next = HZ_CACHE_NIL;
+        slot->prev = cache->tail;
+        if (cache->tail != HZ_CACHE_NIL) cache->slots[cache->tail].next = index;
+        else cache->head = index;
+        cache->tail = index;
+        return;
+    }
+
+    for (pos = _hz_cache_hash(cache, hz_id); cache->hash[pos] != HZ_CACHE_NIL; pos = (pos + 1) & cache->mask);
+    cache->hash[pos] = index;
+    slot->hz_id = hz_id;
+    slot->pos = pos;
+    _hz_cache_link_head(cache, index);
+}
+
+rt_inline rt_uint32_t _font_data_offset(struct rtgui_hz_file_font *font, rt_uint16_t hz_id)
+{
+    rt_uint32_t seek;
 
-    cache->hz_id = hz_id;
     seek = 94 * (((hz_id & 0xff) - 0xA0) - 1) + ((hz_id >> 8) - 0xA0) - 1;
-    seek *= font->font_data_size;
+    return seek * font->font_data_size;
+}
+
+static rt_bool_t _font_data_read(struct rtgui_hz_file_font *font, rt_uint16_t hz_id, rt_uint8_t *data)
+{
+    rt_uint32_t seek;
 
     if (font->fd < 0)
     {
         font->fd = open(font->font_fn, O_RDONLY, 0);
         if (font->fd < 0)
-        {
-            rtgui_free(cache);
-            return RT_NULL;
-        }
+            return RT_FALSE;
     }
 
+    seek = _font_data_offset(font, hz_id);
+
     /* read hz font data */
     if ((lseek(font->fd, seek, SEEK_SET) < 0) ||
-            read(font->fd, (char *)(cache + 1), font->font_data_size) !=
-            font->font_data_size)
+            read(font->fd, (char *)data, font->font_data_size) != font->font_data_size)
+        return RT_FALSE;
+
+    return RT_TRUE;
+}
+
+/* the glyphs are cached in the glyph atlas, and the font data in the cache */
+static struct rtgui_glyph *_font_glyph_get(struct rtgui_hz_file_font *font, rt_uint16_t hz_id)
+{
+    rt_uint8_t *data = RT_NULL;
+    struct rtgui_glyph *glyph;
+
+    glyph = rtgui_font_atlas_find(font, hz_id);
+    if (glyph != RT_NULL)
+        return glyph;
+
+    if (font->font_map != RT_NULL)
     {
-        rtgui_free(cache);
-        return RT_NULL;
+        rt_uint32_t offset = _font_data_offset(font, hz_id);
+
+        /* use the mapped data in place */
+        if (offset >= font->font_map_size || font->font_map_size - offset < font->font_data_size)
+            return RT_NULL;
+
+        return rtgui_font_atlas_add_mono(font, hz_id, font->font_map + offset, font->font_size,
+                                         font->font_size, (font->font_size + 7) / 8);
     }
 
-    /* enter critical */
-    rtgui_enter_critical();
+    if (font->cache == RT_NULL && font->cache_size != 0)
+        font->cache = _hz_cache_create(font->cache_size, font->font_data_size);
 
-    if (font->cache_size >= HZ_CACHE_MAX)
+    if (font->cache != RT_NULL)
     {
-        /* remove a cache */
-        struct hz_cache *left;
-        left = font->cache_root.sph_root;
-        while (SPLAY_LEFT(left, hz_node) != RT_NULL) left = SPLAY_LEFT(left, hz_node);
-
-        /* remove the left node */
-        SPLAY_REMOVE(cache_tree, &(font->cache_root), left);
-        rtgui_free(left);
-        font->cache_size --;
+        data = _hz_cache_find(font->cache, hz_id);
+        if (data == RT_NULL)
+        {
+            rt_uint16_t index = _hz_cache_take(font->cache);
+            rt_bool_t valid;
+
+            data = font->cache->data + index * font->cache->data_size;
+            valid = _font_data_read(font, hz_id, data);
+            _hz_cache_put(font->cache, index, hz_id, valid);
+            if (valid == RT_FALSE)
+                return RT_NULL;
+        }
     }
+    else
+    {
+        data = (rt_uint8_t *) rtgui_malloc(font->font_data_size);
+        if (data == RT_NULL)
+            return RT_NULL; /* no memory yet */
 
-    /* insert to cache */
-    SPLAY_INSERT(cache_tree, &(font->cache_root), cache);
-    font->cache_size ++;
+        if (_font_data_read(font, hz_id, data) == RT_FALSE)
+        {
+            rtgui_free(data);
+            return RT_NULL;
+        }
+    }
 
-    /* exit critical */
-    rtgui_exit_critical();
+    glyph = rtgui_font_atlas_add_mono(font, hz_id, data, font->font_size, font->font_size,
+                                      (font->font_size + 7) / 8);
 
-    return (rt_uint8_t *)(cache + 1);
+    if (font->cache == RT_NULL)
+        rtgui_free(data);
+
+    return glyph;
 }
 
 static void rtgui_hz_file_font_load(struct rtgui_font *font)
@@ -153,6 +334,9 @@ static void rtgui_hz_file_font_load(struct rtgui_font *font)
     struct rtgui_hz_file_font *hz_file_font = (struct rtgui_hz_file_font *)font->data;
     RT_ASSERT(hz_file_font != RT_NULL);
 
+    /* the font data is in memory */
+    if (hz_file_font->font_map != RT_NULL) return;
+
     hz_file_font->fd = open(hz_file_font->font_fn, O_RDONLY, 0);
     if (hz_file_font->fd < 0)
     {
@@ -161,62 +345,42 @@ static void rtgui_hz_file_font_load(struct rtgui_font *font)
     }
 }
 
+/* draw the UTF-8 of non-ASCII, each character is looked up in GB2312 directly */
 static void _rtgui_hz_file_font_draw_text(struct rtgui_hz_file_font *hz_file_font, struct rtgui_dc *dc, const char *text, rt_ubase_t len, struct rtgui_rect *rect)
 {
-    rt_uint8_t *str;
-    rtgui_color_t bc;
-    rt_uint16_t style;
-    register rt_base_t h, word_bytes;
-
-    /* get text style */
-    style = rtgui_dc_get_gc(dc)->textstyle;
-    bc = rtgui_dc_get_gc(dc)->background;
-
-    /* drawing height */
-    h = (hz_file_font->font_size + rect->y1 > rect->y2) ?
-        rect->y2 - rect->y1 : hz_file_font->font_size;
-    word_bytes = (hz_file_font->font_size + 7) / 8;
-
-    str = (rt_uint8_t *)text;
+    int bytes;
+    rt_uint16_t code;
+    rt_uint32_t unicode;
+    struct rtgui_glyph_run run;
 
+    rtgui_glyph_run_begin(&run, dc, rect);
     while (len > 0 && rect->x1 < rect->x2)
     {
-        const rt_uint8_t *font_ptr;
-        register rt_base_t i, j, k;
+        bytes = rtgui_utf8_decode(text, len, &unicode);
+        text += bytes;
+        len -= bytes;
 
-        /* get font pixel data */
-        font_ptr = _font_cache_get(hz_file_font, *str | (*(str + 1) << 8));
-        if (font_ptr)
+        code = rtgui_unicode_to_gb2312(unicode);
+        if (code == 0)
         {
-            /* draw word */
-            for (i = 0; i < h; i++)
-            {
-                for (j = 0; j < word_bytes; j++)
-                    for (k = 0; k < 8; k++)
-                    {
-                        if (((font_ptr[i * word_bytes + j] >> (7 - k)) & 0x01) != 0 &&
-                                (rect->x1 + 8 * j + k < rect->x2))
-                        {
-                            rtgui_dc_draw_point(dc, rect->x1 + 8 * j + k, rect->y1 + i);
-                        }
-                        else if (style & RTGUI_TEXTSTYLE_DRAW_BACKGROUND)
-                        {
-                            rtgui_dc_draw_color_point(dc, rect->x1 + 8 * j + k, rect->y1 + i, bc);
-                        }
-                    }
-            }
+            /* the character not in GB2312 is a blank of half width */
+            rect->x1 += hz_file_font->font_size / 2;
+            continue;
         }
 
+        /* get font pixel data and draw word, the id is in the bytes order */
+        rtgui_glyph_run_draw(&run, _font_glyph_get(hz_file_font, (code >> 8) | ((code & 0xFF) << 8)),
+                             rect->x1, rect->y1);
+
         /* move x to next character */
         rect->x1 += hz_file_font->font_size;
-        str += 2;
-        len -= 2;
     }
+    rtgui_glyph_run_end(&run);
 }
 
 static void rtgui_hz_file_font_draw_text(struct rtgui_font *font, struct rtgui_dc *dc, const char *text, rt_ubase_t length, struct rtgui_rect *rect)
 {
-    rt_uint8_t *str, *str_p;
+    rt_uint8_t *str;
     rt_uint32_t len, str_len;
     struct rtgui_font *efont;
     struct rtgui_hz_file_font *hz_file_font = (struct rtgui_hz_file_font *)font->data;
@@ -225,25 +389,16 @@ static void rtgui_hz_file_font_draw_text(struct rtgui_font *font, struct rtgui_d
     RT_ASSERT(dc != RT_NULL);
     RT_ASSERT(hz_file_font != RT_NULL);
 
-    rtgui_font_get_metrics(rtgui_dc_get_gc(dc)->font, text, &text_rect);
+    rtgui_font_get_metrics(font, text, &text_rect);
     rtgui_rect_move_to_align(rect, &text_rect, RTGUI_DC_TEXTALIGN(dc));
 
     /* get English font */
     efont = rtgui_font_refer("asc", hz_file_font->font_size);
     if (efont == RT_NULL) efont = rtgui_font_default(); /* use system default font */
 
-    str = rt_malloc(UTF_8ToGB2312_LEN((char *)text, length));
-    if (str)
-    {
-        str_p = str;
-        UTF_8ToGB2312((char *)str, (char *)text, length);
-        str_len = strlen((const char *)str);
-    }
-    else
-    {
-        return;
-    }
-
+    /* the UTF-8 is drawn in the runs of ASCII and non-ASCII, no transcoding */
+    str = (rt_uint8_t *)text;
+    for (str_len = 0; str_len < length && str[str_len] != '\0'; str_len ++);
     while (str_len > 0)
     {
         len = 0;
@@ -270,33 +425,39 @@ static void rtgui_hz_file_font_draw_text(struct rtgui_font *font, struct rtgui_d
     }
 
     rtgui_font_derefer(efont);
-
-    rt_free(str_p);
 }
 
 static void rtgui_hz_file_font_get_metrics(struct rtgui_font *font, const char *text, rtgui_rect_t *rect)
 {
-    rt_uint8_t *str;
-    rt_uint32_t x2;
+    int len, bytes;
+    rt_uint32_t x2, unicode;
     struct rtgui_hz_file_font *hz_file_font = (struct rtgui_hz_file_font *)font->data;
     RT_ASSERT(hz_file_font != RT_NULL);
 
-    str = rt_malloc(UTF_8ToGB2312_LEN((char *)text, strlen(text)));
-    if (str)
+    /* the half width of ASCII and the character not in GB2312, the full width of GB2312 */
+    x2 = 0;
+    len = rt_strlen(text);
+    while (len > 0)
     {
-        UTF_8ToGB2312((char *)str, (char *)text, strlen(text));
-    }
-    else
-    {
-        return;
+        if ((rt_uint8_t)*text < 0x80)
+        {
+            x2 += hz_file_font->font_size / 2;
+            text ++;
+            len --;
+            continue;
+        }
+
+        bytes = rtgui_utf8_decode(text, len, &unicode);
+        text += bytes;
+        len -= bytes;
+        x2 += hz_file_font->font_size / 2;
+        if (rtgui_unicode_to_gb2312(unicode) != 0)
+            x2 += hz_file_font->font_size / 2;
     }
 
     /* set metrics rect */
     rect->x1 = rect->y1 = 0;
-    x2 = hz_file_font->font_size / 2 * rt_strlen((const char *)str);
     rect->x2 = (rt_int16_t)(x2 >= 0x7FFF ? 0x7FFF : x2);
     rect->y2 = hz_file_font->font_size;
-
-    rt_free(str);
 }
 #endif
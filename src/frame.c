@@ -0,0 +1,178 @@
+/*
+ * File      : frame.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtgui/frame.h>
+#include <rtgui/rtgui_app.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/rtgui_server.h>
+#include <rtgui/widgets/window.h>
+
+/* request the next frame from server, one request is pending at most */
+static void _rtgui_frame_request(struct rtgui_app *app)
+{
+    struct rtgui_event_frame event;
+
+    if (app->frame_requested)
+        return;
+
+    RTGUI_EVENT_FRAME_REQUEST_INIT(&event);
+    event.tick = rt_tick_get();
+    if (rtgui_server_post_event(&event.parent, sizeof(event)) == RT_EOK)
+        app->frame_requested = 1;
+}
+
+void rtgui_frame_init(struct rtgui_frame *frame, struct rtgui_widget *widget,
+                      rtgui_frame_func_t func, void *user_data)
+{
+    RT_ASSERT(frame != RT_NULL);
+
+    rt_list_init(&frame->list);
+    frame->widget = widget;
+    frame->func = func;
+    frame->user_data = user_data;
+    frame->serial = 0;
+}
+RTM_EXPORT(rtgui_frame_init);
+
+void rtgui_frame_start(struct rtgui_frame *frame)
+{
+    struct rtgui_app *app;
+
+    RT_ASSERT(frame != RT_NULL);
+
+    app = rtgui_app_self();
+    RT_ASSERT(app != RT_NULL);
+
+    if (!rt_list_isempty(&frame->list))
+        return;
+
+    /* the first delta is from the start of the clock */
+    if (rt_list_isempty(&app->frame_list))
+        app->frame_tick = rt_tick_get();
+
+    /* not invoked in the frame being dispatched */
+    frame->serial = app->frame_serial;
+    rt_list_insert_before(&app->frame_list, &frame->list);
+    if (frame->widget != RT_NULL)
+        RTGUI_WIDGET_FLAG(frame->widget) |= RTGUI_WIDGET_FLAG_IN_ANIM;
+
+    _rtgui_frame_request(app);
+}
+RTM_EXPORT(rtgui_frame_start);
+
+void rtgui_frame_stop(struct rtgui_frame *frame)
+{
+    RT_ASSERT(frame != RT_NULL);
+
+    if (rt_list_isempty(&frame->list))
+        return;
+
+    rt_list_remove(&frame->list);
+    rt_list_init(&frame->list);
+    if (frame->widget != RT_NULL)
+        RTGUI_WIDGET_FLAG(frame->widget) &= ~RTGUI_WIDGET_FLAG_IN_ANIM;
+}
+RTM_EXPORT(rtgui_frame_stop);
+
+rt_bool_t rtgui_frame_is_running(struct rtgui_frame *frame)
+{
+    RT_ASSERT(frame != RT_NULL);
+
+    return !rt_list_isempty(&frame->list);
+}
+RTM_EXPORT(rtgui_frame_is_running);
+
+/* find the next frame not invoked in this dispatch, in the window if it's not
+ * RT_NULL. The list is scanned again each time, for the callback may stop any
+ * frame. */
+static struct rtgui_frame *_rtgui_frame_next(struct rtgui_app *app, struct rtgui_win *win)
+{
+    rt_list_t *node;
+    struct rtgui_frame *frame;
+
+    rt_list_for_each(node, &app->frame_list)
+    {
+        frame = rt_list_entry(node, struct rtgui_frame, list);
+        if (frame->serial == app->frame_serial)
+            continue;
+
+        if (win == RT_NULL || (frame->widget != RT_NULL && frame->widget->toplevel == win))
+            return frame;
+    }
+
+    return RT_NULL;
+}
+
+static void _rtgui_frame_invoke(struct rtgui_frame *frame, rt_uint32_t delta)
+{
+    struct rtgui_dc *dc = RT_NULL;
+
+    if (frame->widget != RT_NULL)
+        dc = rtgui_dc_begin_drawing(frame->widget);
+
+    frame->func(frame, dc, delta);
+
+    if (dc != RT_NULL)
+        rtgui_dc_end_drawing(dc, RT_TRUE);
+}
+
+void rtgui_frame_dispatch(struct rtgui_app *app, struct rtgui_event_frame *event)
+{
+    rt_uint32_t delta;
+    struct rtgui_frame *frame;
+    struct rtgui_win *win;
+    struct rtgui_dc *dc;
+
+    app->frame_requested = 0;
+    if (rt_list_isempty(&app->frame_list))
+        return;
+
+    delta = (event->tick - app->frame_tick) * 1000 / RT_TICK_PER_SECOND;
+    app->frame_tick = event->tick;
+
+    if (++app->frame_serial == 0) app->frame_serial = 1;
+    while ((frame = _rtgui_frame_next(app, RT_NULL)) != RT_NULL)
+    {
+        win = frame->widget != RT_NULL ? frame->widget->toplevel : RT_NULL;
+
+        /* the drawings of widgets are nested in the drawing of window, which
+         * sends one update to server at the end */
+        dc = RT_NULL;
+        if (win != RT_NULL)
+            dc = rtgui_dc_begin_drawing(RTGUI_WIDGET(win));
+
+        do
+        {
+            frame->serial = app->frame_serial;
+            _rtgui_frame_invoke(frame, delta);
+        }
+        while (win != RT_NULL && (frame = _rtgui_frame_next(app, win)) != RT_NULL);
+
+        if (dc != RT_NULL)
+            rtgui_dc_end_drawing(dc, RT_TRUE);
+    }
+
+    if (!rt_list_isempty(&app->frame_list))
+        _rtgui_frame_request(app);
+}
+RTM_EXPORT(rtgui_frame_dispatch);
@@ -2182,6 +2182,251 @@ static const struct
     {0,73}, {2,93}, {2,3}
 };
 
+/*
+ * The direct lookup of gb2312_backward by Unicode: the page of 256 code
+ * points indexes its 4 blocks of 64 (0xFFFF if there is no GB2312 in
+ * it), and a block has the bits of code points in GB2312 and the index of
+ * its first one in gb2312_backward. The index of a code point is the base of
+ * its block and the bits below it. Generated from the tables above.
+ */
+static const rt_uint16_t gb2312_page[256] =
+{
+    0x0000, 0x0004, 0x0008, 0x000C, 0x0010, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0x0014, 0x0018, 0x001C, 0x0020, 0x0024, 0x0028, 0x002C, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0x0030, 0x0034, 0x0038, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x003C, 0x0040,
+    0x0044, 0x0048, 0x004C, 0x0050, 0x0054, 0x0058, 0x005C, 0x0060,
+    0x0064, 0x0068, 0x006C, 0x0070, 0x0074, 0x0078, 0x007C, 0x0080,
+    0x0084, 0x0088, 0x008C, 0x0090, 0x0094, 0x0098, 0x009C, 0x00A0,
+    0x00A4, 0x00A8, 0x00AC, 0x00B0, 0x00B4, 0x00B8, 0x00BC, 0x00C0,
+    0x00C4, 0x00C8, 0x00CC, 0x00D0, 0x00D4, 0x00D8, 0x00DC, 0x00E0,
+    0x00E4, 0x00E8, 0x00EC, 0x00F0, 0x00F4, 0x00F8, 0x00FC, 0x0100,
+    0x0104, 0x0108, 0x010C, 0x0110, 0x0114, 0x0118, 0x011C, 0x0120,
+    0x0124, 0x0128, 0x012C, 0x0130, 0x0134, 0x0138, 0x013C, 0x0140,
+    0x0144, 0x0148, 0x014C, 0x0150, 0x0154, 0x0158, 0x015C, 0x0160,
+    0x0164, 0x0168, 0x016C, 0x0170, 0x0174, 0xFFFF, 0x0178, 0x017C,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0180
+};
+
+static const struct
+{
+    rt_uint32_t bits[2];
+    rt_uint16_t base;
+} gb2312_block[] =
+{
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00030190}, 0}, {{0x00800000, 0x168C3703}, 5},
+    {{0x08080002, 0x00000800}, 19}, {{0x00002000, 0x00000800}, 23},
+    {{0x00000000, 0x00000000}, 0}, {{0x15554000, 0x00000000}, 25},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000280, 0x00000000}, 33},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0xFFFE0000, 0xFFFE03FB}, 35}, {{0x000003FB, 0x00000000}, 74},
+    {{0xFFFF0002, 0xFFFFFFFF}, 83}, {{0x0002FFFF, 0x00000000}, 132},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x33600000, 0x080D0040}, 149}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00400008, 0x00000000}, 160}, {{0x00000000, 0x00000FFF}, 162},
+    {{0x000F0000, 0x00000000}, 174}, {{0x00000000, 0x00000000}, 0},
+    {{0x64028100, 0x20F04FA1}, 178}, {{0x00001100, 0x0000C033}, 197},
+    {{0x02000000, 0x00000020}, 205}, {{0x00000000, 0x00000000}, 0},
+    {{0x00040000, 0x00000000}, 207}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0xFFF003FF}, 208},
+    {{0x0FFFFFFF, 0x00000000}, 230}, {{0x00000000, 0x00000000}, 0},
+    {{0xFFFFFFFF, 0xFFFFFFFF}, 258}, {{0x00000FFF, 0x00000000}, 322},
+    {{0x00000000, 0x000C0003}, 334}, {{0x0000C8C0, 0x00000000}, 338},
+    {{0x00000060, 0x00000000}, 343}, {{0x00000005, 0x00000000}, 345},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00FBFF2F, 0x00000000}, 347}, {{0xFFFFFFFE, 0xFFFFFFFF}, 367},
+    {{0x000FFFFF, 0xFFFFFFFE}, 430}, {{0xFFFFFFFF, 0x087FFFFF}, 481},
+    {{0xFFFFFFE0, 0x000003FF}, 537}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x000003FF}, 574}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x7F7B7F8B, 0xEF553DB4}, 584}, {{0xF35DFBA8, 0x400B0243}, 628},
+    {{0x8D3EFB40, 0x8C2C7BF7}, 657}, {{0xE3FA6EFF, 0xA8ED1D3A}, 693},
+    {{0xCF83E602, 0x35558CF5}, 734}, {{0xFFABE048, 0xD85992B9}, 766},
+    {{0x2892AB18, 0x8020D7E9}, 800}, {{0xF583C438, 0x450AE74A}, 825},
+    {{0x9714B000, 0x54007762}, 854}, {{0x1420D188, 0xC8C01020}, 876},
+    {{0x00002121, 0x0C0413A8}, 892}, {{0x04408000, 0x082870C0}, 905},
+    {{0x000408C0, 0x80000002}, 916}, {{0x14722B7B, 0x3BFB7924}, 922},
+    {{0x1AE43327, 0x38EF9835}, 957}, {{0x28029AD1, 0xBF69A813}, 989},
+    {{0x2FC665CF, 0xAFC96B11}, 1017}, {{0x5053340F, 0xA00486A2}, 1053},
+    {{0xE8090106, 0xC00E3F0F}, 1075}, {{0x81450A88, 0xC6010010}, 1099},
+    {{0x26E1A161, 0xCE00444B}, 1114}, {{0xD4EEC7AA, 0x85BBCADF}, 1138},
+    {{0xA5203A74, 0x8840436C}, 1177}, {{0x8BD23F06, 0x3BEFFF79}, 1200},
+    {{0xE8EFF75A, 0x5B36FBCB}, 1241}, {{0x1BFD0D49, 0x39EE0154}, 1284},
+    {{0x2E75D855, 0xA91ABFD8}, 1315}, {{0xF6BFF3D7, 0xB40C67E0}, 1350},
+    {{0x081382C2, 0xD08BD49D}, 1389}, {{0x1061065A, 0x59E074F2}, 1414},
+    {{0xB3128F9F, 0x6AAA0080}, 1440}, {{0xB05E3230, 0x60AC9D7A}, 1467},
+    {{0xC900D303, 0x8A563098}, 1496}, {{0x13907000, 0x18421F14}, 1519},
+    {{0x0008C060, 0x10808008}, 1538}, {{0xEC900400, 0xE6332817}, 1547},
+    {{0x90000758, 0x4E09F708}, 1570}, {{0xFC83F485, 0x18C8AF53}, 1592},
+    {{0x080C187C, 0x01146ADF}, 1624}, {{0xA734C80C, 0x2710A011}, 1648},
+    {{0x422228C5, 0x00210413}, 1670}, {{0x41123010, 0x40001820}, 1686},
+    {{0xC60C022B, 0x10000300}, 1697}, {{0x00220022, 0x02495810}, 1711},
+    {{0x9670A094, 0x1792EEB0}, 1723}, {{0x05F2CB96, 0x23580025}, 1751},
+    {{0x42CC25DE, 0x4A04CF38}, 1776}, {{0x359F0C40, 0x8A001128}, 1804},
+    {{0x910A13FA, 0x10560229}, 1824}, {{0x04200641, 0x84F00484}, 1847},
+    {{0x0C040000, 0x412C0400}, 1862}, {{0x11541206, 0x00020A4B}, 1871},
+    {{0x00C00200, 0x00940000}, 1887}, {{0xBFBB0001, 0x242B167C}, 1893},
+    {{0x7FA89BBB, 0xE3790C7F}, 1921}, {{0xE00D10F4, 0x9F014132}, 1961},
+    {{0x35728652, 0xFF1210B4}, 1985}, {{0x4223CF27, 0x8602C06B}, 2014},
+    {{0x1FD33106, 0xA1AA3A0C}, 2040}, {{0x02040812, 0x08012572}, 2068},
+    {{0x485040CC, 0x601062D0}, 2082}, {{0x29001C80, 0x00109A00}, 2100},
+    {{0x22000004, 0x00800000}, 2112}, {{0x68002020, 0x609ECBE6}, 2116},
+    {{0x3F73916E, 0x398260C0}, 2138}, {{0x48301034, 0xBD5C0006}, 2167},
+    {{0xD6FB8CD1, 0x43E820E1}, 2187}, {{0x084E0600, 0xC4D00500}, 2218},
+    {{0x89AA8D1F, 0x1602A6E1}, 2233}, {{0x21ED0001, 0x1A8B3656}, 2261},
+    {{0x13A51FB7, 0x30A06502}, 2285}, {{0x23C7B278, 0xE9226C93}, 2312},
+    {{0x3A74E47F, 0x98208FE3}, 2343}, {{0x2625280E, 0xBF49BF9C}, 2376},
+    {{0xAC543218, 0x1916B949}, 2408}, {{0xB5220C60, 0x0659FBC1}, 2434},
+    {{0x8420E343, 0x800008D9}, 2461}, {{0x20225500, 0x00A10184}, 2479},
+    {{0x20104800, 0x40801380}, 2492}, {{0x00160D04, 0x80200040}, 2502},
+    {{0x8DE7FD40, 0xE0985436}, 2512}, {{0x091E7B8B, 0xD249FEC8}, 2543},
+    {{0x8DEE0611, 0xBA221937}, 2576}, {{0x9FDD77F4, 0xF0DAF3EC}, 2605},
+    {{0xEC424386, 0x26048D3F}, 2648}, {{0xC021FA6C, 0x0CC2628E}, 2675},
+    {{0x0145D785, 0x559977AD}, 2701}, {{0x4045E250, 0xA154260B}, 2733},
+    {{0x58199827, 0xA4103443}, 2755}, {{0x411405F2, 0x07002280}, 2778},
+    {{0x426600B4, 0x15A17210}, 2795}, {{0x41856025, 0x00000054}, 2816},
+    {{0x01040201, 0xCB70C820}, 2829}, {{0x6A629320, 0x0095184C}, 2845},
+    {{0x9A8B1880, 0x3201AAB2}, 2866}, {{0x00C4D87A, 0x04C3F3E5}, 2889},
+    {{0xA238D44D, 0x5072A1A1}, 2917}, {{0x84FC980A, 0x44D1C152}, 2943},
+    {{0x20C21094, 0x42104180}, 2968}, {{0x3A000000, 0xD29D0240}, 2982},
+    {{0xA8B12F01, 0x2432BD40}, 2997}, {{0xD04BD34D, 0xD0ADA723}, 3022},
+    {{0x75A10A92, 0x01E9ADAC}, 3054}, {{0x771F801A, 0xA01B9225}, 3082},
+    {{0x20CADFA1, 0x738C0602}, 3109}, {{0x003B577F, 0x00D00BFF}, 3135},
+    {{0x0088806A, 0x0029A1C4}, 3166}, {{0x05242A05, 0x16234009}, 3182},
+    {{0x80056822, 0xA2112011}, 3200}, {{0x64900004, 0x13824849}, 3216},
+    {{0x193023D5, 0x08922980}, 3232}, {{0x88115402, 0xA0042001}, 3253},
+    {{0x81800400, 0x60228502}, 3266}, {{0x0B010090, 0x12020022}, 3278},
+    {{0x00834011, 0x00001A01}, 3289}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x4684009F}, 3299}, {{0x020012C8, 0x1A0004FC}, 3310},
+    {{0x0C4C2EDE, 0x80B80402}, 3326}, {{0x0AFCA826, 0x22288C02}, 3348},
+    {{0x8F7BA0E0, 0x2135C7D6}, 3370}, {{0xF8B106C7, 0x62550713}, 3402},
+    {{0x8A19936E, 0xFB0E6EFA}, 3431}, {{0x48F91630, 0x7DEBCD2F}, 3467},
+    {{0x4E845892, 0x7A2E4CA0}, 3502}, {{0x561EEDEA, 0x1190C649}, 3528},
+    {{0xE83A5324, 0x8124CFDB}, 3558}, {{0x634218F1, 0x1A8A5853}, 3588},
+    {{0x24D37420, 0x0514AA3B}, 3614}, {{0x89586018, 0xC0004800}, 3639},
+    {{0x91018268, 0x2CD684A4}, 3653}, {{0xC4BA8886, 0x02100377}, 3675},
+    {{0x00388244, 0x404AAE11}, 3698}, {{0x510028C0, 0x15146044}, 3716},
+    {{0x10007310, 0x02480082}, 3732}, {{0x40060205, 0x0000C003}, 3744},
+    {{0x0C020000, 0x02200008}, 3754}, {{0x40009000, 0xD161B800}, 3760},
+    {{0x32744621, 0x3B8AF800}, 3774}, {{0x8B00050F, 0x2280BBD0}, 3799},
+    {{0x07690600, 0x00438040}, 3821}, {{0x50005420, 0x250C41D0}, 3835},
+    {{0x83108410, 0x02281101}, 3851}, {{0x00304008, 0x020040A1}, 3864},
+    {{0x20000040, 0xABE31500}, 3873}, {{0xAA443180, 0xC624C2C6}, 3888},
+    {{0x8004AC13, 0x03D1B000}, 3911}, {{0x4285611E, 0x1D9FF303}, 3929},
+    {{0x78E8440A, 0xC3925E26}, 3959}, {{0x00852000, 0x4000B001}, 3986},
+    {{0x88424A90, 0x0C8DCA04}, 3995}, {{0x4203A705, 0x000422A1}, 4015},
+    {{0x0C018668, 0x10795564}, 4032}, {{0xDEA00002, 0x40C12000}, 4054},
+    {{0x5001488B, 0x04000380}, 4068}, {{0x50040000, 0x80D0C05D}, 4081},
+    {{0x970AA010, 0x4DAFBB20}, 4095}, {{0x1E10D921, 0x83140460}, 4122},
+    {{0xA6D68848, 0x733FD83B}, 4142}, {{0x497427BC, 0x92130DDC}, 4175},
+    {{0x8BA1142B, 0xD1392E75}, 4205}, {{0x50503009, 0x69008808}, 4235},
+    {{0x024A49D4, 0x80164010}, 4250}, {{0x89D7E564, 0x5316C020}, 4267},
+    {{0x86002B92, 0x15E0A345}, 4294}, {{0x0C03008B, 0xE200196E}, 4317},
+    {{0x80067031, 0xA82916A5}, 4337}, {{0x18802000, 0xE1487AAC}, 4359},
+    {{0xB5D63207, 0x5F9132E8}, 4378}, {{0x20E550A1, 0x10807C00}, 4410},
+    {{0x9D8A7280, 0x421F00AA}, 4428}, {{0x02310E22, 0x04941100}, 4452},
+    {{0x40080022, 0x5C100010}, 4467}, {{0xFCC80343, 0x0580A1A5}, 4477},
+    {{0x04008433, 0x6E080080}, 4501}, {{0x81262A4B, 0x2901AAD8}, 4515},
+    {{0x4490684D, 0xBA880009}, 4539}, {{0x00820040, 0x87D10000}, 4559},
+    {{0xB1E6215B, 0x80083161}, 4570}, {{0xC2400800, 0xA600A069}, 4594},
+    {{0x4A328D58, 0x550A5D71}, 4609}, {{0x2D579AA0, 0x4AA64005}, 4637},
+    {{0x30B12021, 0x01123FC6}, 4662}, {{0x260A10C2, 0x50824462}, 4684},
+    {{0x80409880, 0x810004C0}, 4702}, {{0x00002003, 0x38180000}, 4713},
+    {{0xF1A60200, 0x720E4434}, 4721}, {{0x92E035A2, 0x09008101}, 4743},
+    {{0x00000400, 0x00008885}, 4761}, {{0x00000000, 0x00804000}, 4767},
+    {{0x00000000, 0x00004040}, 4769}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x08000000}, 4771}, {{0x00000082, 0x00000000}, 4772},
+    {{0x88000004, 0xE7EFBFFF}, 4774}, {{0xFFBFFFFF, 0xFDFFEFEF}, 4805},
+    {{0xBFFEFBFF, 0x057FFFFF}, 4865}, {{0x85B30034, 0x42164706}, 4919},
+    {{0xE4105402, 0xB3058092}, 4941}, {{0x81305422, 0x180B4263}, 4961},
+    {{0x13F5387B, 0xA9EA07E5}, 4981}, {{0x05143C4C, 0x80020600}, 5016},
+    {{0xBD481AD9, 0xF496EE37}, 5031}, {{0x7EC0705F, 0x355FBFB2}, 5067},
+    {{0x455FE644, 0x41469000}, 5105}, {{0x063B1D40, 0xFE1362A1}, 5128},
+    {{0x39028505, 0x0C080548}, 5156}, {{0x0000144F, 0x58183488}, 5173},
+    {{0xD8153077, 0x4BFBBD0E}, 5190}, {{0x85008A90, 0xE61DC100}, 5225},
+    {{0xB386ED14, 0x639BFF72}, 5245}, {{0xD9BEFD92, 0x0A92887B}, 5282},
+    {{0x1CB2D3FE, 0x177AB980}, 5316}, {{0xDC1782C9, 0x3980FFFB}, 5350},
+    {{0x590C4260, 0x37DF0F01}, 5385}, {{0xB15094A3, 0x23070623}, 5412},
+    {{0x3102F85A, 0x310201F0}, 5436}, {{0x1E820040, 0x056A3A0A}, 5458},
+    {{0x12805B84, 0xA7148002}, 5477}, {{0xA04B2612, 0x90011069}, 5496},
+    {{0x848A1000, 0x3F801802}, 5515}, {{0x42400708, 0x4E140110}, 5531},
+    {{0x180080B0, 0x0281C510}, 5546}, {{0x10298202, 0x88000210}, 5560},
+    {{0x00420020, 0x11000280}, 5571}, {{0x4413E000, 0xFE025804}, 5578},
+    {{0x30283C07, 0x04739798}, 5598}, {{0xCB13CED1, 0x431F6210}, 5623},
+    {{0x55AC278D, 0xC892422E}, 5652}, {{0x02885380, 0x78514039}, 5680},
+    {{0x8088292C, 0x2428B900}, 5700}, {{0x080E0C41, 0x42004421}, 5718},
+    {{0x08680408, 0x12040006}, 5732}, {{0x02903031, 0xE0855B3E}, 5743},
+    {{0x10442936, 0x10822814}, 5767}, {{0x83344266, 0x531B013C}, 5784},
+    {{0x0E0D0404, 0x00510C22}, 5809}, {{0xC0000012, 0x88000040}, 5824},
+    {{0x0000004A, 0x00000000}, 5831}, {{0x5447DFF6, 0x00088868}, 5834},
+    {{0x00000081, 0x40000000}, 5860}, {{0x00000100, 0x02000000}, 5863},
+    {{0x00080600, 0x00000000}, 5865}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000080, 0x00000040}, 5868}, {{0x00000000, 0x00001040}, 5870},
+    {{0x00000000, 0xF7FDEFFF}, 5872}, {{0xFFFEFF7F, 0xFFFFFBFF}, 5901},
+    {{0xBFFFFDFF, 0x00FFFFFF}, 5962}, {{0x042012C2, 0x07080C06}, 6016},
+    {{0x01101624, 0x00000000}, 6031}, {{0x00000000, 0x00000000}, 0},
+    {{0xE0000000, 0xFFFFFFFE}, 6038}, {{0x7F79FFFF, 0x00F928DF}, 6072},
+    {{0x80120C32, 0xD53A0008}, 6115}, {{0xECC2D858, 0x2FA89D18}, 6133},
+    {{0xE0109620, 0x2622D60C}, 6163}, {{0x02060F97, 0x9055B240}, 6184},
+    {{0x501180A2, 0x04049800}, 6207}, {{0x00004000, 0x00000000}, 6220},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0xFFFFFBC0}, 6221},
+    {{0xDFFBEFFE, 0x62430B08}, 6246}, {{0xFB3B41B6, 0x23896F74}, 6284},
+    {{0xECD7AE7F, 0x5960E047}, 6319}, {{0x098FA096, 0xA030612C}, 6355},
+    {{0x2AAA090D, 0x4F7BD44E}, 6378}, {{0x388BC4B2, 0x6110A9C6}, 6409},
+    {{0x42000014, 0x0202800C}, 6435}, {{0x6485FE48, 0xE3F7D63E}, 6444},
+    {{0x0C073AA0, 0x0430E40C}, 6481}, {{0x1002F680, 0x00000000}, 6501},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00100000}, 6510},
+    {{0x00004000, 0x00004000}, 6511}, {{0x00000100, 0x00000000}, 6513},
+    {{0x00000000, 0x40000000}, 6514}, {{0x00000000, 0x00000400}, 6515},
+    {{0x00008000, 0x00000000}, 6516}, {{0x00400400, 0x00000000}, 6517},
+    {{0x00000000, 0x40000000}, 6519}, {{0x00000000, 0x00000800}, 6520},
+    {{0xFEBDFFE0, 0xFFFFFFFF}, 6521}, {{0xFBE77F7F, 0xF7FFFFBF}, 6577},
+    {{0xEFFFFFFF, 0xDFF7FF7E}, 6634}, {{0xFBDFF6F7, 0x804FBFFE}, 6693},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x7FFFEF00}, 6740},
+    {{0xB6F7FF7F, 0xB87E4406}, 6762}, {{0x88313BF5, 0x00F41796}, 6803},
+    {{0x1391A960, 0x72490080}, 6832}, {{0x0024F2F3, 0x42C88701}, 6852},
+    {{0x5048E3D3, 0x43052400}, 6875}, {{0x4A4C0000, 0x10580227}, 6896},
+    {{0x01162820, 0x0014A809}, 6911}, {{0x00000000, 0x00683EC0}, 6925},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0xFFE00000}, 6935},
+    {{0xFDDBB7FF, 0x000000F7}, 6946}, {{0xC72E4000, 0x00000180}, 6980},
+    {{0x00012000, 0x00004000}, 6992}, {{0x00300000, 0xB4F7FFA8}, 6995},
+    {{0x03FFADF3, 0x00000120}, 7019}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0xFFFBF000}, 7042},
+    {{0xFDCF9DF7, 0x15C301BF}, 7061}, {{0x810A1827, 0x0A00A842}, 7101},
+    {{0x80088108, 0x18048008}, 7118}, {{0x0012A3BE, 0x00000000}, 7128},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x00000000}, 0},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x90000000}, 7140},
+    {{0xDC3769E6, 0x3DFF6BFF}, 7142}, {{0xF3F9FCF8, 0x00000004}, 7187},
+    {{0x80000000, 0xE7EEBF6F}, 7211}, {{0x5DA2DFFE, 0xC00B3FD8}, 7237},
+    {{0xA00C0984, 0x69100040}, 7274}, {{0xB912E210, 0x5A0086A5}, 7288},
+    {{0x02896800, 0x6A809005}, 7311}, {{0x00030010, 0x80000000}, 7327},
+    {{0x8E001FF9, 0x00000001}, 7331}, {{0x00000000, 0x00000000}, 0},
+    {{0xFFFFFFFE, 0xFFFFFFFF}, 7347}, {{0x7FFFFFFF, 0x00000000}, 7410},
+    {{0x00000000, 0x00000000}, 0}, {{0x00000000, 0x0000002B}, 7441}
+};
+
 /* This returns ERROR if the code point doesn't exist. */
 unsigned short gb2312_to_unicode( char r, char c )
 {
@@ -2196,33 +2441,52 @@ unsigned short gb2312_to_unicode( char r, char c )
     return gb2312_forward[rr][cc];
 }
 
+static int _gb2312_bits(rt_uint32_t value)
+{
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    value = (value + (value >> 4)) & 0x0F0F0F0F;
+
+    return (int)((value * 0x01010101) >> 24);
+}
+
+/* the index of unicode in gb2312_backward, -1 if the code point doesn't exist */
+static int _gb2312_index(rt_uint32_t unicode)
+{
+    int index, bit;
+    rt_uint32_t word;
+    rt_uint16_t page;
+
+    if (unicode > 0xFFFF)
+        return -1;
+    page = gb2312_page[unicode >> 8];
+    if (page == 0xFFFF)
+        return -1;
+
+    index = page + ((unicode >> 6) & 0x03);
+    bit = unicode & 0x3F;
+    word = gb2312_block[index].bits[bit >> 5];
+    if ((word & (1UL << (bit & 0x1F))) == 0)
+        return -1;
+
+    return gb2312_block[index].base + (bit >= 32 ? _gb2312_bits(gb2312_block[index].bits[0]) : 0) +
+           _gb2312_bits(word & ((1UL << (bit & 0x1F)) - 1));
+}
+
 /* This one returns 1 on success, 0 if the code point doesn't exist. */
 int unicode_to_gb2312(long int unicode, unsigned char *r, unsigned char *c)
 {
-    int rr, cc;
-    long int uu;
-    int i, j, k;
-
-    i = -1;
-    j = lenof(gb2312_backward);
-    while (j - i > 1)
-    {
-        k = (i + j) / 2;
-        rr = gb2312_backward[k].r;
-        cc = gb2312_backward[k].c;
-        uu = gb2312_forward[rr][cc];
-        if (unicode > uu)
-            i = k;
-        else if (unicode < uu)
-            j = k;
-        else
-        {
-            *r = rr;
-            *c = cc;
-            return 1;
-        }
-    }
-    return 0;
+    int index;
+
+    if (unicode < 0)
+        return 0;
+    index = _gb2312_index((rt_uint32_t)unicode);
+    if (index < 0)
+        return 0;
+
+    *r = gb2312_backward[index].r;
+    *c = gb2312_backward[index].c;
+    return 1;
 }
 
 void UTF_8ToUnicode(unsigned short* pOut, char *pText)
@@ -2410,3 +2674,170 @@ int Gb2312ToUtf8(char *pGb2312, int len, char **ppUtf8)
 
     return ret;
 }
+
+/* the GB2312 of unicode in the bytes order, such as 0xB0A1, 0 if it doesn't exist */
+rt_uint16_t rtgui_unicode_to_gb2312(rt_uint32_t unicode)
+{
+    int index;
+
+    index = _gb2312_index(unicode);
+    if (index < 0)
+        return 0;
+
+    return ((gb2312_backward[index].r + 0xA1) << 8) | (gb2312_backward[index].c + 0xA1);
+}
+RTM_EXPORT(rtgui_unicode_to_gb2312);
+
+/*
+ * Decode a character of UTF-8 in the len bytes of text. It returns the bytes
+ * of the character, an invalid or a truncated sequence is one byte of 0xFFFD.
+ */
+int rtgui_utf8_decode(const char *text, int len, rt_uint32_t *unicode)
+{
+    int index, count;
+    rt_uint8_t ch;
+    rt_uint32_t value;
+
+    ch = (rt_uint8_t)text[0];
+    if (ch < 0x80)
+    {
+        *unicode = ch;
+        return 1;
+    }
+
+    if ((ch & 0xE0) == 0xC0)
+    {
+        count = 2;
+        value = ch & 0x1F;
+    }
+    else if ((ch & 0xF0) == 0xE0)
+    {
+        count = 3;
+        value = ch & 0x0F;
+    }
+    else if ((ch & 0xF8) == 0xF0)
+    {
+        count = 4;
+        value = ch & 0x07;
+    }
+    else
+    {
+        *unicode = 0xFFFD;
+        return 1;
+    }
+
+    if (count > len)
+    {
+        *unicode = 0xFFFD;
+        return 1;
+    }
+    for (index = 1; index < count; index ++)
+    {
+        ch = (rt_uint8_t)text[index];
+        if ((ch & 0xC0) != 0x80)
+        {
+            *unicode = 0xFFFD;
+            return 1;
+        }
+        value = (value << 6) | (ch & 0x3F);
+    }
+
+    *unicode = value;
+    return count;
+}
+RTM_EXPORT(rtgui_utf8_decode);
+
+/*
+ * Convert the len bytes of UTF-8 to GB2312 in the size bytes of out in one
+ * pass, the character not in GB2312 is '?'. The out is terminated by NUL,
+ * and the bytes in out are returned without the NUL.
+ */
+int rtgui_utf8_to_gb2312(const char *text, int len, char *out, int size)
+{
+    int i, j;
+    rt_uint16_t code;
+    rt_uint32_t unicode;
+
+    RT_ASSERT(text != RT_NULL && out != RT_NULL && size > 0);
+
+    for (i = 0, j = 0; i < len && j < size - 1; )
+    {
+        if (!(text[i] & 0x80))
+        {
+            out[j++] = text[i++];
+            continue;
+        }
+
+        i += rtgui_utf8_decode(text + i, len - i, &unicode);
+        code = rtgui_unicode_to_gb2312(unicode);
+        if (code == 0)
+        {
+            out[j++] = '?';
+            continue;
+        }
+        if (j + 2 > size - 1)
+            break;
+        out[j++] = (char)(code >> 8);
+        out[j++] = (char)code;
+    }
+    out[j] = '\0';
+
+    return j;
+}
+RTM_EXPORT(rtgui_utf8_to_gb2312);
+
+/*
+ * Convert the len bytes of GB2312 to UTF-8 in the size bytes of out in one
+ * pass, the invalid code is '?'. The out is terminated by NUL, and the bytes
+ * in out are returned without the NUL.
+ */
+int rtgui_gb2312_to_utf8(const char *text, int len, char *out, int size)
+{
+    int i, j, r, c;
+    rt_uint16_t unicode;
+
+    RT_ASSERT(text != RT_NULL && out != RT_NULL && size > 0);
+
+    for (i = 0, j = 0; i < len && j < size - 1; )
+    {
+        if (!(text[i] & 0x80))
+        {
+            out[j++] = text[i++];
+            continue;
+        }
+
+        unicode = ERROR;
+        if (i + 1 < len)
+        {
+            r = (rt_uint8_t)text[i] - 0xA1;
+            c = (rt_uint8_t)text[i + 1] - 0xA1;
+            if (r >= 0 && r < 94 && c >= 0 && c < 94)
+                unicode = gb2312_forward[r][c];
+        }
+        i += 2;
+
+        if (unicode == ERROR || unicode == 0)
+        {
+            out[j++] = '?';
+        }
+        else if (unicode < 0x800)
+        {
+            if (j + 2 > size - 1)
+                break;
+            out[j++] = (char)(0xC0 | (unicode >> 6));
+            out[j++] = (char)(0x80 | (unicode & 0x3F));
+        }
+        else
+        {
+            if (j + 3 > size - 1)
+                break;
+            out[j++] = (char)(0xE0 | (unicode >> 12));
+            out[j++] = (char)(0x80 | ((unicode >> 6) & 0x3F));
+            out[j++] = (char)(0x80 | (unicode & 0x3F));
+        }
+    }
+    out[j] = '\0';
+
+    return j;
+}
+RTM_EXPORT(rtgui_gb2312_to_utf8);
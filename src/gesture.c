@@ -0,0 +1,388 @@
+/*
+ * File      : gesture.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/event.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/rtgui_app.h>
+
+#include "topwin.h"
+
+#ifdef GUIENGINE_USING_GESTURE
+
+enum rtgui_gesture_state
+{
+    GESTURE_IDLE,
+    GESTURE_PRESSED,
+    GESTURE_LONGPRESSED,
+    GESTURE_DRAG,
+    GESTURE_PINCH,
+    /* the gesture is finished or canceled, wait all the contacts up */
+    GESTURE_DONE,
+};
+
+/* the finger stopped longer than it before up is not a fling */
+#define GESTURE_FLING_IDLE_MS   100
+
+struct rtgui_gesture
+{
+    enum rtgui_gesture_state state;
+    /* the drag in the axis locked in its start */
+    enum rtgui_gesture_type drag;
+
+    /* the contacts of two fingers */
+    rt_bool_t down[2];
+    int x[2], y[2];
+
+    int start_x, start_y;
+    /* the drag not sent yet, and the sample of velocity */
+    int dx, dy;
+    int vx, vy;
+    int last_x, last_y;
+    rt_tick_t last_tick;
+    /* the distance of fingers in the start of pinch */
+    int distance;
+    rt_bool_t pending;
+
+    struct rtgui_win *wid;
+    struct rtgui_app *app;
+    rtgui_timer_t *long_timer;
+    rtgui_timer_t *frame_timer;
+};
+static struct rtgui_gesture _gesture;
+
+static int _gesture_isqrt(rt_uint32_t value)
+{
+    rt_uint32_t root = 0, bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (int)root;
+}
+
+static int _gesture_distance(void)
+{
+    int dx, dy;
+
+    dx = _gesture.x[1] - _gesture.x[0];
+    dy = _gesture.y[1] - _gesture.y[0];
+    return _gesture_isqrt((rt_uint32_t)(dx * dx + dy * dy));
+}
+
+static rt_int16_t _gesture_clamp(int value)
+{
+    if (value > 32767) return 32767;
+    if (value < -32768) return -32768;
+    return (rt_int16_t)value;
+}
+
+static void _gesture_send(int type)
+{
+    struct rtgui_event_gesture event;
+
+    if (_gesture.app == RT_NULL)
+        return;
+
+    RTGUI_EVENT_GESTURE_INIT(&event, (enum rtgui_gesture_type)type);
+    event.wid = _gesture.wid;
+    event.win_acti_cnt = rtgui_app_get_win_acti_cnt();
+    event.x = _gesture.x[0];
+    event.y = _gesture.y[0];
+    event.dx = _gesture_clamp(_gesture.dx);
+    event.dy = _gesture_clamp(_gesture.dy);
+    event.vx = _gesture_clamp(_gesture.vx);
+    event.vy = _gesture_clamp(_gesture.vy);
+    event.scale = 256;
+    if ((type & RTGUI_GESTURE_TYPE_MASK) == RTGUI_GESTURE_PINCH)
+    {
+        event.x = (_gesture.x[0] + _gesture.x[1]) / 2;
+        event.y = (_gesture.y[0] + _gesture.y[1]) / 2;
+        if (_gesture.distance > 0)
+            event.scale = (rt_uint16_t)(_gesture_distance() * 256 / _gesture.distance);
+    }
+
+    /* the motion is sent, the next drag event has the motion after it */
+    _gesture.dx = _gesture.dy = 0;
+    _gesture.pending = RT_FALSE;
+    rtgui_send(_gesture.app, &(event.parent), sizeof(event));
+}
+
+/* the drag and pinch are sent once a frame with the motion merged */
+static void _gesture_frame_timeout(struct rtgui_timer *timer, void *parameter)
+{
+    rtgui_timer_stop(timer);
+
+    if (_gesture.pending == RT_FALSE)
+        return;
+    if (_gesture.state == GESTURE_DRAG)
+        _gesture_send(_gesture.drag);
+    else if (_gesture.state == GESTURE_PINCH)
+        _gesture_send(RTGUI_GESTURE_PINCH);
+}
+
+static void _gesture_long_timeout(struct rtgui_timer *timer, void *parameter)
+{
+    rtgui_timer_stop(timer);
+
+    if (_gesture.state == GESTURE_PRESSED)
+    {
+        _gesture.state = GESTURE_LONGPRESSED;
+        _gesture_send(RTGUI_GESTURE_LONGPRESS);
+    }
+}
+
+static void _gesture_update(void)
+{
+    _gesture.pending = RT_TRUE;
+    if (_gesture.frame_timer == RT_NULL)
+    {
+        _gesture.frame_timer = rtgui_timer_create(rt_tick_from_millisecond(GUIENGINE_FRAME_MS),
+                               RT_TIMER_FLAG_ONE_SHOT,
+                               _gesture_frame_timeout, RT_NULL);
+        if (_gesture.frame_timer == RT_NULL)
+        {
+            _gesture_frame_timeout(RT_NULL, RT_NULL);
+            return;
+        }
+    }
+    if (_gesture.frame_timer->state != RTGUI_TIMER_ST_RUNNING)
+        rtgui_timer_start(_gesture.frame_timer);
+}
+
+static void _gesture_stop(enum rtgui_gesture_state state)
+{
+    _gesture.state = state;
+    _gesture.pending = RT_FALSE;
+    if (_gesture.long_timer != RT_NULL)
+        rtgui_timer_stop(_gesture.long_timer);
+    if (_gesture.frame_timer != RT_NULL)
+        rtgui_timer_stop(_gesture.frame_timer);
+}
+
+/* the velocity of drag in the samples of different ticks */
+static void _gesture_velocity(void)
+{
+    int dt;
+    rt_tick_t tick;
+
+    tick = rt_tick_get();
+    dt = (int)(tick - _gesture.last_tick);
+    if (dt <= 0)
+        return;
+
+    _gesture.vx = (_gesture.vx + (_gesture.x[0] - _gesture.last_x) * RT_TICK_PER_SECOND / dt) / 2;
+    _gesture.vy = (_gesture.vy + (_gesture.y[0] - _gesture.last_y) * RT_TICK_PER_SECOND / dt) / 2;
+    _gesture.last_x = _gesture.x[0];
+    _gesture.last_y = _gesture.y[0];
+    _gesture.last_tick = tick;
+}
+
+static void _gesture_down(int id, int x, int y)
+{
+    struct rtgui_topwin *topwin;
+
+    if (id == 1)
+    {
+        /* the second finger turns the press or drag to pinch */
+        if (_gesture.state == GESTURE_PRESSED || _gesture.state == GESTURE_DRAG)
+        {
+            if (_gesture.state == GESTURE_DRAG)
+                _gesture_send(_gesture.drag | RTGUI_GESTURE_FINISH);
+            _gesture_stop(GESTURE_PINCH);
+            _gesture.distance = _gesture_distance();
+        }
+        return;
+    }
+
+    if (_gesture.state != GESTURE_IDLE)
+        return;
+
+    topwin = rtgui_topwin_get_wnd_no_modaled(x, y);
+    if (topwin == RT_NULL)
+    {
+        _gesture.state = GESTURE_DONE;
+        return;
+    }
+    _gesture.wid = topwin->wid;
+    _gesture.app = topwin->app;
+    _gesture.start_x = _gesture.last_x = x;
+    _gesture.start_y = _gesture.last_y = y;
+    _gesture.last_tick = rt_tick_get();
+    _gesture.dx = _gesture.dy = 0;
+    _gesture.vx = _gesture.vy = 0;
+    _gesture.state = GESTURE_PRESSED;
+
+    if (_gesture.long_timer == RT_NULL)
+        _gesture.long_timer = rtgui_timer_create(rt_tick_from_millisecond(GUIENGINE_GESTURE_LONGPRESS_MS),
+                              RT_TIMER_FLAG_ONE_SHOT,
+                              _gesture_long_timeout, RT_NULL);
+    if (_gesture.long_timer != RT_NULL)
+        rtgui_timer_start(_gesture.long_timer);
+}
+
+static void _gesture_motion(int id, int dx, int dy)
+{
+    int mx, my;
+
+    switch (_gesture.state)
+    {
+    case GESTURE_PRESSED:
+    case GESTURE_LONGPRESSED:
+        if (id != 0)
+            break;
+        mx = _gesture.x[0] - _gesture.start_x;
+        my = _gesture.y[0] - _gesture.start_y;
+        if (mx < 0) mx = -mx;
+        if (my < 0) my = -my;
+        if (mx <= GUIENGINE_GESTURE_SLOP && my <= GUIENGINE_GESTURE_SLOP)
+            break;
+
+        /* the drag starts from the press, in the axis of the most motion */
+        _gesture_stop(GESTURE_DRAG);
+        _gesture.drag = mx >= my ? RTGUI_GESTURE_DRAG_HORIZONTAL : RTGUI_GESTURE_DRAG_VERTICAL;
+        _gesture.dx = _gesture.x[0] - _gesture.start_x;
+        _gesture.dy = _gesture.y[0] - _gesture.start_y;
+        _gesture_velocity();
+        _gesture_update();
+        break;
+
+    case GESTURE_DRAG:
+        if (id != 0)
+            break;
+        _gesture.dx += dx;
+        _gesture.dy += dy;
+        _gesture_velocity();
+        _gesture_update();
+        break;
+
+    case GESTURE_PINCH:
+        _gesture_update();
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void _gesture_up(void)
+{
+    int speed;
+
+    switch (_gesture.state)
+    {
+    case GESTURE_PRESSED:
+        _gesture_send(RTGUI_GESTURE_TAP);
+        break;
+
+    case GESTURE_LONGPRESSED:
+        _gesture_send(RTGUI_GESTURE_LONGPRESS | RTGUI_GESTURE_FINISH);
+        break;
+
+    case GESTURE_DRAG:
+        if ((int)(rt_tick_get() - _gesture.last_tick) > rt_tick_from_millisecond(GESTURE_FLING_IDLE_MS))
+            _gesture.vx = _gesture.vy = 0;
+        _gesture_send(_gesture.drag | RTGUI_GESTURE_FINISH);
+
+        speed = _gesture_isqrt((rt_uint32_t)(_gesture.vx * _gesture.vx + _gesture.vy * _gesture.vy));
+        if (speed > GUIENGINE_GESTURE_FLING_SPEED)
+            _gesture_send(RTGUI_GESTURE_FLING);
+        break;
+
+    case GESTURE_PINCH:
+        _gesture_send(RTGUI_GESTURE_PINCH | RTGUI_GESTURE_FINISH);
+        break;
+
+    default:
+        break;
+    }
+    _gesture_stop(GESTURE_DONE);
+}
+
+/*
+ * The touch samples are not sent to the apps, the gestures in them are sent
+ * to the window under the first finger. A gesture is one tap, or the events
+ * of long press, drag or pinch which end in RTGUI_GESTURE_FINISH. The fling
+ * is sent after the drag released fast, for the kinetic scroll on the frame
+ * clock of app.
+ */
+void rtgui_gesture_handle_touch(struct rtgui_event_touch *event)
+{
+    int id, dx, dy;
+
+    id = event->id;
+    if (id > 1)
+        return;
+
+    dx = (int)event->x - _gesture.x[id];
+    dy = (int)event->y - _gesture.y[id];
+    _gesture.x[id] = event->x;
+    _gesture.y[id] = event->y;
+
+    switch (event->up_down)
+    {
+    case RTGUI_TOUCH_DOWN:
+        _gesture.down[id] = RT_TRUE;
+        _gesture_down(id, event->x, event->y);
+        break;
+
+    case RTGUI_TOUCH_MOTION:
+        if (_gesture.down[id])
+            _gesture_motion(id, dx, dy);
+        break;
+
+    case RTGUI_TOUCH_UP:
+        _gesture.down[id] = RT_FALSE;
+        _gesture_up();
+        if (!_gesture.down[0] && !_gesture.down[1])
+            _gesture.state = GESTURE_IDLE;
+        break;
+    }
+}
+
+void rtgui_gesture_cancel(struct rtgui_win *wid)
+{
+    if (_gesture.wid != wid)
+        return;
+
+    _gesture.wid = RT_NULL;
+    _gesture.app = RT_NULL;
+    if (_gesture.state != GESTURE_IDLE)
+        _gesture_stop(GESTURE_DONE);
+}
+
+#endif
@@ -12326,12 +12326,19 @@ struct rtgui_font rtgui_font_hz12 =
 #else
 struct rtgui_hz_file_font hz12 =
 {
-    {RT_NULL},              /* cache root       */
-    0,                      /* cache size       */
+    GUIENGINE_HZ_FILE_CACHE_SIZE, /* cache size       */
+    RT_NULL,                /* cache            */
     12,                     /* font size        */
     24,                     /* font data size   */
     -1,                     /* fd               */
-    "/resource/hzk12.fnt"   /* font_fn          */
+    "/resource/hzk12.fnt",  /* font_fn          */
+#ifdef GUIENGINE_HZ12_FONT_MAP
+    (const rt_uint8_t *)GUIENGINE_HZ12_FONT_MAP, /* font map */
+    94 * 94 * 24,           /* font map size    */
+#else
+    RT_NULL,                /* font map         */
+    0,                      /* font map size    */
+#endif
 };
 
 struct rtgui_font rtgui_font_hz12 =
@@ -16785,12 +16785,19 @@ struct rtgui_font rtgui_font_hz16 =
 #else
 struct rtgui_hz_file_font hz16 =
 {
-    {RT_NULL},              /* cache root       */
-    0,                      /* cache size       */
+    GUIENGINE_HZ_FILE_CACHE_SIZE, /* cache size       */
+    RT_NULL,                /* cache            */
     16,                     /* font size        */
     32,                     /* font data size   */
     -1,                     /* fd               */
-    "/resource/hzk16.fnt"   /* font_fn          */
+    "/resource/hzk16.fnt",  /* font_fn          */
+#ifdef GUIENGINE_HZ16_FONT_MAP
+    (const rt_uint8_t *)GUIENGINE_HZ16_FONT_MAP, /* font map */
+    94 * 94 * 32,           /* font map size    */
+#else
+    RT_NULL,                /* font map         */
+    0,                      /* font map size    */
+#endif
 };
 
 struct rtgui_font rtgui_font_hz16 =
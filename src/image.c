@@ -23,12 +23,18 @@
  * 2012-01-24     onelife      add TJpgDec (Tiny JPEG Decompressor) support
  * 2012-08-29     amsl         add Image zoom interface.
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <rtthread.h>
 #include <rtgui/image.h>
+#include <rtgui/blit.h>
 
 #include <rtgui/image_hdc.h>
 #include <rtgui/rtgui_system.h>
 #include <rtgui/image_container.h>
+#include <rtgui/pack.h>
+#include <rtgui/trace.h>
+#include <rtgui/profile.h>
 
 #include <string.h>
 #ifdef _WIN32
@@ -49,12 +55,32 @@ extern void rtgui_image_jpeg_init(void);
 #if defined(GUIENGINE_IMAGE_PNG) || defined(GUIENGINE_IMAGE_LODEPNG)
 extern void rtgui_image_png_init(void);
 #endif
+#ifdef GUIENGINE_IMAGE_GIF
+extern void rtgui_image_gif_init(void);
+#endif
 
 static rtgui_list_t _rtgui_system_image_list = {RT_NULL};
+/* 1 in the init, 2 after it */
+static volatile rt_uint8_t _rtgui_system_image_state = 0;
 
-/* initialize rtgui image system */
+/* initialize rtgui image system, it runs once at the first call */
 void rtgui_system_image_init(void)
 {
+    if (_rtgui_system_image_state == 2)
+        return;
+
+    rtgui_enter_critical();
+    if (_rtgui_system_image_state != 0)
+    {
+        rtgui_exit_critical();
+        /* in the init of another thread */
+        while (_rtgui_system_image_state != 2)
+            rt_thread_delay(1);
+        return;
+    }
+    _rtgui_system_image_state = 1;
+    rtgui_exit_critical();
+
     /* always support HDC image */
     rtgui_image_hdc_init();
 
@@ -74,10 +100,20 @@ void rtgui_system_image_init(void)
     rtgui_image_png_init();
 #endif
 
+#ifdef GUIENGINE_IMAGE_GIF
+    rtgui_image_gif_init();
+#endif
+
+    rtgui_image_loader_init();
+
 #ifdef GUIENGINE_IMAGE_CONTAINER
     /* initialize image container */
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_IMAGE_CONTAINER);
     rtgui_system_image_container_init();
+    RTGUI_BOOT_END(RTGUI_BOOT_IMAGE_CONTAINER);
 #endif
+
+    _rtgui_system_image_state = 2;
 }
 
 static struct rtgui_image_engine *rtgui_image_get_engine(const char *type)
@@ -85,6 +121,7 @@ static struct rtgui_image_engine *rtgui_image_get_engine(const char *type)
     struct rtgui_list_node *node;
     struct rtgui_image_engine *engine;
 
+    rtgui_system_image_init();
     rtgui_list_foreach(node, &_rtgui_system_image_list)
     {
         engine = rtgui_list_entry(node, struct rtgui_image_engine, list);
@@ -96,6 +133,47 @@ static struct rtgui_image_engine *rtgui_image_get_engine(const char *type)
     return RT_NULL;
 }
 
+/* probe the header by the engine of hint first, then the others */
+static rt_err_t _rtgui_image_probe(struct rtgui_image_engine *hint, struct rtgui_filerw *file,
+                                   struct rtgui_image_probe_info *info)
+{
+    struct rtgui_list_node *node;
+    struct rtgui_image_engine *engine;
+
+    rtgui_system_image_init();
+    info->has_alpha = RT_FALSE;
+    if (hint != RT_NULL && hint->image_probe != RT_NULL && hint->image_probe(file, info) == RT_TRUE)
+    {
+        info->format = hint->name;
+        return RT_EOK;
+    }
+
+    rtgui_list_foreach(node, &_rtgui_system_image_list)
+    {
+        engine = rtgui_list_entry(node, struct rtgui_image_engine, list);
+        if (engine == hint || engine->image_probe == RT_NULL)
+            continue;
+
+        info->has_alpha = RT_FALSE;
+        if (engine->image_probe(file, info) == RT_TRUE)
+        {
+            info->format = engine->name;
+            return RT_EOK;
+        }
+    }
+
+    return -RT_ERROR;
+}
+
+rt_err_t rtgui_image_probe_filerw(const char *type, struct rtgui_filerw *file,
+                                  struct rtgui_image_probe_info *info)
+{
+    RT_ASSERT(file != RT_NULL && info != RT_NULL);
+
+    return _rtgui_image_probe(type != RT_NULL ? rtgui_image_get_engine(type) : RT_NULL, file, info);
+}
+RTM_EXPORT(rtgui_image_probe_filerw);
+
 #if defined(GUIENGINE_USING_DFS_FILERW)
 struct rtgui_image_engine *rtgui_image_get_engine_by_filename(const char *fn)
 {
@@ -115,6 +193,7 @@ struct rtgui_image_engine *rtgui_image_get_engine_by_filename(const char *fn)
     }
     if (ext == fn) return RT_NULL; /* no ext */
 
+    rtgui_system_image_init();
     rtgui_list_foreach(node, &_rtgui_system_image_list)
     {
         engine = rtgui_list_entry(node, struct rtgui_image_engine, list);
@@ -126,6 +205,33 @@ struct rtgui_image_engine *rtgui_image_get_engine_by_filename(const char *fn)
 }
 RTM_EXPORT(rtgui_image_get_engine_by_filename);
 
+/* load the image, which is decoded here if load is RT_TRUE */
+rt_inline rt_bool_t _rtgui_image_load(struct rtgui_image_engine *engine, struct rtgui_image *image,
+                                      struct rtgui_filerw *filerw, rt_bool_t load)
+{
+    rt_bool_t result;
+
+    RTGUI_TRACE_BEGIN("image load", load);
+    result = engine->image_load(image, filerw, load);
+    RTGUI_TRACE_END("image load");
+
+    return result;
+}
+
+/* the file in the mounted packs, or in file system */
+static struct rtgui_filerw *_image_open_file(const char *filename)
+{
+#ifdef GUIENGINE_USING_PACK
+    struct rtgui_filerw *filerw;
+
+    filerw = rtgui_pack_open_file(filename);
+    if (filerw != RT_NULL)
+        return filerw;
+#endif
+
+    return rtgui_filerw_create_buffered(filename, 0);
+}
+
 struct rtgui_image *rtgui_image_create_from_file(const char *type, const char *filename, rt_bool_t load)
 {
     struct rtgui_filerw *filerw;
@@ -133,7 +239,7 @@ struct rtgui_image *rtgui_image_create_from_file(const char *type, const char *f
     struct rtgui_image *image = RT_NULL;
 
     /* create filerw context */
-    filerw = rtgui_filerw_create_file(filename, "rb");
+    filerw = _image_open_file(filename);
     if (filerw == RT_NULL) return RT_NULL;
 
     /* get image engine */
@@ -156,7 +262,7 @@ struct rtgui_image *rtgui_image_create_from_file(const char *type, const char *f
         }
 
         image->palette = RT_NULL;
-        if (engine->image_load(image, filerw, load) != RT_TRUE)
+        if (_rtgui_image_load(engine, image, filerw, load) != RT_TRUE)
         {
             /* close filerw context */
             rtgui_filerw_close(filerw);
@@ -181,8 +287,15 @@ struct rtgui_image *rtgui_image_create(const char *filename, rt_bool_t load)
     struct rtgui_image_engine *engine;
     struct rtgui_image *image = RT_NULL;
 
+#ifdef GUIENGINE_USING_IMAGE_DISK_CACHE
+    /* the decoded one is in native pixels */
+    image = rtgui_image_cache_open(filename, load);
+    if (image != RT_NULL)
+        return image;
+#endif
+
     /* create filerw context */
-    filerw = rtgui_filerw_create_file(filename, "rb");
+    filerw = _image_open_file(filename);
     if (filerw == RT_NULL)
     {
         //rt_kprintf("create filerw failed!\n");
@@ -211,7 +324,7 @@ struct rtgui_image *rtgui_image_create(const char *filename, rt_bool_t load)
         }
 
         image->palette = RT_NULL;
-        if (engine->image_load(image, filerw, load) != RT_TRUE)
+        if (_rtgui_image_load(engine, image, filerw, load) != RT_TRUE)
         {
             rt_kprintf("load image:%s failed!\n", filename);
             /* close filerw context */
@@ -221,6 +334,9 @@ struct rtgui_image *rtgui_image_create(const char *filename, rt_bool_t load)
 
         /* set image engine */
         image->engine = engine;
+#ifdef GUIENGINE_USING_IMAGE_DISK_CACHE
+        rtgui_image_cache_store(filename, image);
+#endif
     }
     else
     {
@@ -231,17 +347,52 @@ struct rtgui_image *rtgui_image_create(const char *filename, rt_bool_t load)
     return image;
 }
 RTM_EXPORT(rtgui_image_create);
-#endif
 
-struct rtgui_image *rtgui_image_create_from_mem(const char *type, const rt_uint8_t *data, rt_size_t length, rt_bool_t load)
+rt_err_t rtgui_image_probe(const char *filename, struct rtgui_image_probe_info *info)
 {
+    rt_err_t result;
+    struct rtgui_image *image;
     struct rtgui_filerw *filerw;
     struct rtgui_image_engine *engine;
+
+    RT_ASSERT(filename != RT_NULL && info != RT_NULL);
+
+    /* the extension is the hint of format */
+    engine = rtgui_image_get_engine_by_filename(filename);
+    if (engine == RT_NULL || engine->image_probe != RT_NULL)
+    {
+        filerw = _image_open_file(filename);
+        if (filerw == RT_NULL)
+            return -RT_EIO;
+
+        result = _rtgui_image_probe(engine, filerw, info);
+        rtgui_filerw_close(filerw);
+
+        return result;
+    }
+
+    /* the engine can not probe, create the image without load */
+    image = rtgui_image_create(filename, RT_FALSE);
+    if (image == RT_NULL)
+        return -RT_ERROR;
+
+    info->format = engine->name;
+    info->w = image->w;
+    info->h = image->h;
+    info->has_alpha = RT_FALSE;
+    rtgui_image_destroy(image);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_image_probe);
+#endif
+
+struct rtgui_image *rtgui_image_create_from_filerw(const char *type, struct rtgui_filerw *filerw, rt_bool_t load)
+{
+    struct rtgui_image_engine *engine;
     struct rtgui_image *image = RT_NULL;
 
-    /* create filerw context */
-    filerw = rtgui_filerw_create_mem(data, length);
-    if (filerw == RT_NULL) return RT_NULL;
+    RT_ASSERT(filerw != RT_NULL);
 
     /* get image engine */
     engine = rtgui_image_get_engine(type);
@@ -263,7 +414,7 @@ struct rtgui_image *rtgui_image_create_from_mem(const char *type, const rt_uint8
         }
 
         image->palette = RT_NULL;
-        if (engine->image_load(image, filerw, load) != RT_TRUE)
+        if (_rtgui_image_load(engine, image, filerw, load) != RT_TRUE)
         {
             /* close filerw context */
             rtgui_filerw_close(filerw);
@@ -280,6 +431,18 @@ struct rtgui_image *rtgui_image_create_from_mem(const char *type, const rt_uint8
 
     return image;
 }
+RTM_EXPORT(rtgui_image_create_from_filerw);
+
+struct rtgui_image *rtgui_image_create_from_mem(const char *type, const rt_uint8_t *data, rt_size_t length, rt_bool_t load)
+{
+    struct rtgui_filerw *filerw;
+
+    /* create filerw context */
+    filerw = rtgui_filerw_create_mem(data, length);
+    if (filerw == RT_NULL) return RT_NULL;
+
+    return rtgui_image_create_from_filerw(type, filerw, load);
+}
 RTM_EXPORT(rtgui_image_create_from_mem);
 
 void rtgui_image_destroy(struct rtgui_image *image)
@@ -293,6 +456,82 @@ void rtgui_image_destroy(struct rtgui_image *image)
 }
 RTM_EXPORT(rtgui_image_destroy);
 
+struct rtgui_image_stream *rtgui_image_stream_create(const char *type, rtgui_image_stream_func_t func,
+                                                     void *user_data)
+{
+    struct rtgui_image_engine *engine;
+    struct rtgui_image_stream *stream;
+
+    engine = rtgui_image_get_engine(type);
+    if (engine == RT_NULL || engine->stream_begin == RT_NULL)
+        return RT_NULL;
+
+    stream = (struct rtgui_image_stream *)rtgui_malloc(sizeof(struct rtgui_image_stream));
+    if (stream == RT_NULL)
+        return RT_NULL;
+
+    stream->engine = engine;
+    stream->dc = RT_NULL;
+    stream->w = stream->h = 0;
+    stream->done = RT_FALSE;
+    stream->func = func;
+    stream->user_data = user_data;
+    stream->data = RT_NULL;
+    if (engine->stream_begin(stream) != RT_TRUE)
+    {
+        rtgui_free(stream);
+        return RT_NULL;
+    }
+
+    return stream;
+}
+RTM_EXPORT(rtgui_image_stream_create);
+
+rt_err_t rtgui_image_stream_feed(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length)
+{
+    RT_ASSERT(stream != RT_NULL);
+
+    if (stream->done == RT_TRUE || length == 0)
+        return RT_EOK;
+
+    return stream->engine->stream_feed(stream, data, length);
+}
+RTM_EXPORT(rtgui_image_stream_feed);
+
+void rtgui_image_stream_destroy(struct rtgui_image_stream *stream)
+{
+    RT_ASSERT(stream != RT_NULL);
+
+    stream->engine->stream_end(stream);
+    if (stream->dc != RT_NULL)
+        rtgui_dc_destory(stream->dc);
+    rtgui_free(stream);
+}
+RTM_EXPORT(rtgui_image_stream_destroy);
+
+rt_bool_t rtgui_image_stream_set_size(struct rtgui_image_stream *stream, int w, int h)
+{
+    if (stream->dc != RT_NULL || w <= 0 || h <= 0)
+        return RT_FALSE;
+
+    /* the pixels are transparent before they are decoded */
+    stream->dc = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, w, h);
+    if (stream->dc == RT_NULL)
+        return RT_FALSE;
+    stream->w = w;
+    stream->h = h;
+
+    return RT_TRUE;
+}
+RTM_EXPORT(rtgui_image_stream_set_size);
+
+void rtgui_image_stream_update(struct rtgui_image_stream *stream, int y1, int y2)
+{
+    if (y1 < y2 && stream->func != RT_NULL)
+        stream->func(stream, y1, y2, stream->user_data);
+}
+RTM_EXPORT(rtgui_image_stream_update);
+
 /* register an image engine */
 void rtgui_image_register_engine(struct rtgui_image_engine *engine)
 {
@@ -302,6 +541,30 @@ void rtgui_image_register_engine(struct rtgui_image_engine *engine)
 }
 RTM_EXPORT(rtgui_image_register_engine);
 
+/* the rect of blit in dc, RT_NULL if it's out of dc */
+static struct rtgui_rect *_rtgui_image_blit_rect(struct rtgui_dc *dc, struct rtgui_rect *rect,
+                                                 struct rtgui_rect *r)
+{
+    rtgui_dc_get_rect(dc, r);
+
+    /* use rect of DC */
+    if (rect == RT_NULL)
+        return r;
+
+    /* Don't modify x1, y1, they are handled in engine->image_blit. */
+    if (rect->x1 > r->x2)
+        return RT_NULL;
+    if (rect->y1 > r->y2)
+        return RT_NULL;
+
+    if (rect->x2 > r->x2)
+        rect->x2 = r->x2;
+    if (rect->y2 > r->y2)
+        rect->y2 = r->y2;
+
+    return rect;
+}
+
 void rtgui_image_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
 {
     struct rtgui_rect r;
@@ -309,34 +572,192 @@ void rtgui_image_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtg
 
     if (rtgui_dc_get_visible(dc) != RT_TRUE) return;
 
-    rtgui_dc_get_rect(dc, &r);
+    rect = _rtgui_image_blit_rect(dc, rect, &r);
+    if (rect == RT_NULL)
+        return;
 
-    /* use rect of DC */
+    if (image != RT_NULL && image->engine != RT_NULL)
+    {
+        /* use image engine to blit, the image not loaded is decoded here */
+        RTGUI_TRACE_BEGIN("image blit", rtgui_rect_width(*rect) * rtgui_rect_height(*rect));
+        image->engine->image_blit(image, dc, rect);
+        RTGUI_TRACE_END("image blit");
+    }
+}
+RTM_EXPORT(rtgui_image_blit);
+
+void rtgui_image_blit_ex(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect,
+                         rt_uint8_t opacity, rtgui_color_t tint)
+{
+    int x, y;
+    rt_uint8_t *line;
+    rtgui_color_t *pixel;
+    struct rtgui_rect r;
+    struct rtgui_point point;
+    struct rtgui_dc *buffer;
+    rt_bool_t tinted;
+
+    RT_ASSERT(dc != RT_NULL);
+
+    tinted = (tint & 0xffffff) != (RTGUI_BLIT_NO_TINT & 0xffffff);
+    if (opacity == 255 && !tinted)
+    {
+        rtgui_image_blit(image, dc, rect);
+        return;
+    }
+    if (image == RT_NULL || image->engine == RT_NULL || opacity == 0)
+        return;
+    if (rtgui_dc_get_visible(dc) != RT_TRUE)
+        return;
+    rect = _rtgui_image_blit_rect(dc, rect, &r);
     if (rect == RT_NULL)
+        return;
+
+    RTGUI_TRACE_BEGIN("image blit", rtgui_rect_width(*rect) * rtgui_rect_height(*rect));
+    if (image->engine->image_blit_ex != RT_NULL &&
+            image->engine->image_blit_ex(image, dc, rect, opacity, tint))
     {
-        rect = &r;
+        RTGUI_TRACE_END("image blit");
+        return;
     }
-    else
+
+    /* render the image to a transparent dc, then tint it and blit it in the opacity */
+    buffer = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, image->w, image->h);
+    if (buffer != RT_NULL)
     {
-        /* Don't modify x1, y1, they are handled in engine->image_blit. */
-        if (rect->x1 > r.x2)
-            return;
-        if (rect->y1 > r.y2)
-            return;
-
-        if (rect->x2 > r.x2)
-            rect->x2 = r.x2;
-        if (rect->y2 > r.y2)
-            rect->y2 = r.y2;
+        rtgui_rect_init(&r, 0, 0, image->w, image->h);
+        rtgui_image_blit(image, buffer, &r);
+
+        line = rtgui_dc_buffer_get_pixel(buffer);
+        for (y = 0; tinted && line != RT_NULL && y < image->h; y ++)
+        {
+            pixel = (rtgui_color_t *)line;
+            for (x = 0; x < image->w; x ++, pixel ++)
+                *pixel = RTGUI_ARGB(RTGUI_RGB_A(*pixel), RTGUI_RGB_R(*pixel) * RTGUI_RGB_R(tint) / 255,
+                                    RTGUI_RGB_G(*pixel) * RTGUI_RGB_G(tint) / 255,
+                                    RTGUI_RGB_B(*pixel) * RTGUI_RGB_B(tint) / 255);
+            line += ((struct rtgui_dc_buffer *)buffer)->pitch;
+        }
+        rtgui_dc_buffer_set_alpha(buffer, opacity);
+
+        /* the negative origin of rect clips the image as the engines */
+        point.x = rect->x1 < 0 ? -rect->x1 : 0;
+        point.y = rect->y1 < 0 ? -rect->y1 : 0;
+        r = *rect;
+        if (r.x1 < 0) r.x1 = 0;
+        if (r.y1 < 0) r.y1 = 0;
+        rtgui_dc_blit(buffer, &point, dc, &r);
+        rtgui_dc_destory(buffer);
     }
+    RTGUI_TRACE_END("image blit");
+}
+RTM_EXPORT(rtgui_image_blit_ex);
 
-    if (image != RT_NULL && image->engine != RT_NULL)
+rt_bool_t rtgui_image_get_frame(struct rtgui_image *image, struct rtgui_image_frame *frame)
+{
+    RT_ASSERT(image != RT_NULL && frame != RT_NULL);
+
+    if (image->engine == RT_NULL || image->engine->image_frame == RT_NULL)
+        return RT_FALSE;
+
+    return image->engine->image_frame(image, RT_FALSE, frame);
+}
+RTM_EXPORT(rtgui_image_get_frame);
+
+rt_bool_t rtgui_image_next_frame(struct rtgui_image *image, struct rtgui_image_frame *frame)
+{
+    RT_ASSERT(image != RT_NULL && frame != RT_NULL);
+
+    if (image->engine == RT_NULL || image->engine->image_frame == RT_NULL)
+        return RT_FALSE;
+
+    return image->engine->image_frame(image, RT_TRUE, frame);
+}
+RTM_EXPORT(rtgui_image_next_frame);
+
+rt_uint8_t rtgui_image_decode_format(const struct rtgui_image_probe_info *info)
+{
+    struct rtgui_graphic_driver *driver;
+
+    RT_ASSERT(info != RT_NULL);
+
+    driver = rtgui_graphic_driver_get_default();
+    if (info->has_alpha || driver == RT_NULL)
+        return RTGRAPHIC_PIXEL_FORMAT_ARGB888;
+
+#ifdef GUIENGINE_FIXED_PIXEL_FORMAT
+    /* the only format of screen */
+    return GUIENGINE_FIXED_PIXEL_FORMAT;
+#else
+    return driver->pixel_format;
+#endif
+}
+RTM_EXPORT(rtgui_image_decode_format);
+
+rt_size_t rtgui_image_decode_size(rt_uint8_t format, int w, int h, int align, int *pitch)
+{
+    int bytes;
+
+    RT_ASSERT(align > 0 && (align & (align - 1)) == 0);
+
+    bytes = (w * rtgui_color_get_bits(format) + 7) / 8;
+    bytes = (bytes + align - 1) & ~(align - 1);
+    if (pitch != RT_NULL)
+        *pitch = bytes;
+
+    return (rt_size_t)bytes * h;
+}
+RTM_EXPORT(rtgui_image_decode_size);
+
+static rt_err_t _image_decode(struct rtgui_image *image, struct rtgui_dc *dc)
+{
+    int y, w, h;
+    rt_uint8_t fmt, *pixel;
+    struct rtgui_rect rect;
+    struct rtgui_dc_buffer *buffer;
+
+    if (image == RT_NULL)
+        return -RT_ERROR;
+
+    w = image->w;
+    h = image->h;
+    /* the image with alpha is blended on the transparent pixels */
+    fmt = rtgui_dc_get_pixel_format(dc);
+    if (dc->type == RTGUI_DC_BUFFER &&
+            (fmt == RTGRAPHIC_PIXEL_FORMAT_ARGB888 || fmt == RTGRAPHIC_PIXEL_FORMAT_ARGB4444))
     {
-        /* use image engine to blit */
-        image->engine->image_blit(image, dc, rect);
+        buffer = (struct rtgui_dc_buffer *)dc;
+        pixel = rtgui_dc_buffer_read_pixel(dc);
+        w = _UI_MIN(w, buffer->width);
+        h = _UI_MIN(h, buffer->height);
+        for (y = 0; pixel != RT_NULL && y < h; y ++)
+            rt_memset(pixel + y * buffer->pitch, 0, (w * rtgui_color_get_bits(buffer->pixel_format) + 7) / 8);
     }
+
+    rtgui_rect_init(&rect, 0, 0, image->w, image->h);
+    rtgui_image_blit(image, dc, &rect);
+    rtgui_image_destroy(image);
+
+    return RT_EOK;
 }
-RTM_EXPORT(rtgui_image_blit);
+
+rt_err_t rtgui_image_decode_filerw(const char *type, struct rtgui_filerw *filerw, struct rtgui_dc *dc)
+{
+    RT_ASSERT(filerw != RT_NULL && dc != RT_NULL);
+
+    return _image_decode(rtgui_image_create_from_filerw(type, filerw, RT_FALSE), dc);
+}
+RTM_EXPORT(rtgui_image_decode_filerw);
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+rt_err_t rtgui_image_decode_file(const char *filename, struct rtgui_dc *dc)
+{
+    RT_ASSERT(filename != RT_NULL && dc != RT_NULL);
+
+    return _image_decode(rtgui_image_create(filename, RT_FALSE), dc);
+}
+RTM_EXPORT(rtgui_image_decode_file);
+#endif
 
 struct rtgui_image_palette *rtgui_image_palette_create(rt_uint32_t ncolors)
 {
@@ -0,0 +1,112 @@
+/*
+ * File      : image_anim.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/image_anim.h>
+#include <rtgui/widgets/widget.h>
+
+static void _image_anim_frame(struct rtgui_frame *frame, struct rtgui_dc *dc, rt_uint32_t delta_ms)
+{
+    rtgui_rect_t dirty, rect;
+    rtgui_point_t point;
+    struct rtgui_image_frame image_frame;
+    struct rtgui_image_anim *anim;
+
+    anim = (struct rtgui_image_anim *)frame->user_data;
+    rtgui_rect_init(&dirty, 0, 0, 0, 0);
+    image_frame.canvas = RT_NULL;
+
+    /* the frames passed in a long frame of app are merged */
+    anim->elapsed += delta_ms;
+    while (anim->elapsed >= anim->delay)
+    {
+        anim->elapsed -= anim->delay;
+        if (rtgui_image_next_frame(anim->image, &image_frame) == RT_FALSE)
+        {
+            rtgui_frame_stop(frame);
+            break;
+        }
+        if (!rtgui_rect_is_empty(&image_frame.changed))
+            rtgui_rect_union(&image_frame.changed, &dirty);
+        anim->delay = image_frame.delay;
+        if (anim->delay == 0)
+            break;
+    }
+
+    if (dc == RT_NULL || image_frame.canvas == RT_NULL || rtgui_rect_is_empty(&dirty))
+        return;
+
+    /* the changed rect of canvas on the rect of image */
+    point.x = dirty.x1;
+    point.y = dirty.y1;
+    rect = dirty;
+    rtgui_rect_move(&rect, anim->rect.x1, anim->rect.y1);
+    rtgui_rect_intersect(&anim->rect, &rect);
+    if (rtgui_rect_is_empty(&rect))
+        return;
+
+    /* the transparent pixels of frame are on the background of widget */
+    rtgui_dc_fill_rect(dc, &rect);
+    rtgui_dc_blit(image_frame.canvas, &point, dc, &rect);
+}
+
+void rtgui_image_anim_init(struct rtgui_image_anim *anim, struct rtgui_widget *widget,
+                           struct rtgui_image *image, rtgui_rect_t *rect)
+{
+    struct rtgui_image_frame frame;
+
+    RT_ASSERT(anim != RT_NULL && image != RT_NULL && rect != RT_NULL);
+
+    rtgui_frame_init(&anim->frame, widget, _image_anim_frame, anim);
+    anim->image = image;
+    anim->rect = *rect;
+    anim->elapsed = 0;
+    anim->delay = 0;
+    if (rtgui_image_get_frame(image, &frame))
+        anim->delay = frame.delay;
+}
+RTM_EXPORT(rtgui_image_anim_init);
+
+void rtgui_image_anim_start(struct rtgui_image_anim *anim)
+{
+    struct rtgui_image_frame frame;
+
+    RT_ASSERT(anim != RT_NULL);
+
+    /* the image not animated is only blitted once */
+    if (rtgui_image_get_frame(anim->image, &frame) == RT_FALSE)
+        return;
+
+    anim->elapsed = 0;
+    rtgui_frame_start(&anim->frame);
+}
+RTM_EXPORT(rtgui_image_anim_start);
+
+void rtgui_image_anim_stop(struct rtgui_image_anim *anim)
+{
+    RT_ASSERT(anim != RT_NULL);
+
+    rtgui_frame_stop(&anim->frame);
+}
+RTM_EXPORT(rtgui_image_anim_stop);
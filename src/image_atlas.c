@@ -0,0 +1,290 @@
+/*
+ * File      : image_atlas.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/blit.h>
+#include <rtgui/driver.h>
+#include <rtgui/image_atlas.h>
+#include <rtgui/rtgui_system.h>
+
+struct rtgui_image_atlas
+{
+    /* the decoded sheet */
+    struct rtgui_dc *sheet;
+
+    const struct rtgui_atlas_entry *entries;
+    int count;
+    /* the images of entries */
+    struct rtgui_image *images;
+
+    /* the index of entries by name, -1 is the empty slot */
+    rt_int16_t *hash;
+    int hash_mask;
+};
+
+static rt_bool_t _atlas_blit_part(struct rtgui_image *image, const rtgui_rect_t *src,
+                                  struct rtgui_dc *dc, rtgui_rect_t *rect,
+                                  rt_uint8_t opacity, rtgui_color_t tint);
+
+static void _atlas_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
+{
+    rtgui_rect_t src;
+
+    rtgui_rect_init(&src, 0, 0, image->w, image->h);
+    rtgui_image_blit_subrect(image, &src, dc, rect);
+}
+
+static rt_bool_t _atlas_blit_ex(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect,
+                                rt_uint8_t opacity, rtgui_color_t tint)
+{
+    rtgui_rect_t src;
+
+    rtgui_rect_init(&src, 0, 0, image->w, image->h);
+    return _atlas_blit_part(image, &src, dc, rect, opacity, tint);
+}
+
+/* the icons are owned by atlas, they are not unloaded */
+static void _atlas_unload(struct rtgui_image *image)
+{
+}
+
+static struct rtgui_image_engine _atlas_engine =
+{
+    "atlas",
+    { RT_NULL },
+    RT_NULL,
+    RT_NULL,
+    _atlas_unload,
+    _atlas_blit,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    _atlas_blit_ex,
+};
+
+static rt_uint32_t _atlas_hash(const char *name)
+{
+    rt_uint32_t hash = 2166136261UL;
+
+    while (*name)
+        hash = (hash ^ (rt_uint8_t)*name++) * 16777619UL;
+
+    return hash;
+}
+
+struct rtgui_image_atlas *rtgui_image_atlas_create(struct rtgui_image *sheet, rt_uint8_t pixel_format,
+                                                   const struct rtgui_atlas_entry *entries, int count)
+{
+    int index, size;
+    rt_uint32_t slot;
+    rtgui_rect_t rect;
+    struct rtgui_image_atlas *atlas;
+
+    RT_ASSERT(sheet != RT_NULL && entries != RT_NULL);
+    RT_ASSERT(count > 0 && count < 0x8000);
+
+    for (size = 2; size < 2 * count; size <<= 1);
+    atlas = (struct rtgui_image_atlas *)rtgui_malloc(sizeof(struct rtgui_image_atlas) +
+            count * sizeof(struct rtgui_image) + size * sizeof(rt_int16_t));
+    if (atlas == RT_NULL)
+        return RT_NULL;
+    atlas->images = (struct rtgui_image *)(atlas + 1);
+    atlas->hash = (rt_int16_t *)(atlas->images + count);
+    atlas->hash_mask = size - 1;
+    atlas->entries = entries;
+    atlas->count = count;
+
+    /* render the sheet to a transparent dc once */
+    atlas->sheet = rtgui_dc_buffer_create_tag(pixel_format, sheet->w, sheet->h, RTGUI_MEM_IMAGE);
+    if (atlas->sheet == RT_NULL)
+    {
+        rtgui_free(atlas);
+        return RT_NULL;
+    }
+    rtgui_rect_init(&rect, 0, 0, sheet->w, sheet->h);
+    rtgui_image_blit(sheet, atlas->sheet, &rect);
+
+    rt_memset(atlas->hash, 0xff, size * sizeof(rt_int16_t));
+    for (index = 0; index < count; index ++)
+    {
+        atlas->images[index].w = entries[index].w;
+        atlas->images[index].h = entries[index].h;
+        atlas->images[index].engine = &_atlas_engine;
+        atlas->images[index].palette = RT_NULL;
+        atlas->images[index].data = atlas;
+
+        slot = _atlas_hash(entries[index].name) & atlas->hash_mask;
+        while (atlas->hash[slot] >= 0)
+            slot = (slot + 1) & atlas->hash_mask;
+        atlas->hash[slot] = index;
+    }
+
+    return atlas;
+}
+RTM_EXPORT(rtgui_image_atlas_create);
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+struct rtgui_image_atlas *rtgui_image_atlas_create_from_file(const char *filename,
+                                                             const struct rtgui_atlas_entry *entries,
+                                                             int count)
+{
+    rt_uint8_t format;
+    struct rtgui_image *sheet;
+    struct rtgui_image_atlas *atlas;
+    struct rtgui_image_probe_info info;
+
+    format = rtgui_graphic_driver_get_default()->pixel_format;
+    if (rtgui_image_probe(filename, &info) == RT_EOK && info.has_alpha)
+        format = RTGRAPHIC_PIXEL_FORMAT_ARGB888;
+
+    sheet = rtgui_image_create(filename, RT_TRUE);
+    if (sheet == RT_NULL)
+        return RT_NULL;
+    atlas = rtgui_image_atlas_create(sheet, format, entries, count);
+    rtgui_image_destroy(sheet);
+
+    return atlas;
+}
+RTM_EXPORT(rtgui_image_atlas_create_from_file);
+#endif
+
+void rtgui_image_atlas_destroy(struct rtgui_image_atlas *atlas)
+{
+    if (atlas == RT_NULL)
+        return;
+
+    rtgui_dc_destory(atlas->sheet);
+    rtgui_free(atlas);
+}
+RTM_EXPORT(rtgui_image_atlas_destroy);
+
+struct rtgui_image *rtgui_image_atlas_get(struct rtgui_image_atlas *atlas, const char *name)
+{
+    rt_uint32_t slot;
+
+    RT_ASSERT(atlas != RT_NULL && name != RT_NULL);
+
+    slot = _atlas_hash(name) & atlas->hash_mask;
+    while (atlas->hash[slot] >= 0)
+    {
+        if (rt_strcmp(atlas->entries[atlas->hash[slot]].name, name) == 0)
+            return &atlas->images[atlas->hash[slot]];
+        slot = (slot + 1) & atlas->hash_mask;
+    }
+
+    return RT_NULL;
+}
+RTM_EXPORT(rtgui_image_atlas_get);
+
+/*
+ * The pixels of sheet are blitted in place by rtgui_image_info_blit at the
+ * offset of sub-rect, the dcs without the framebuffer are blitted by dc,
+ * which could not modulate the pixels and RT_FALSE is returned then.
+ */
+static rt_bool_t _atlas_blit_part(struct rtgui_image *image, const rtgui_rect_t *src,
+                                  struct rtgui_dc *dc, rtgui_rect_t *rect,
+                                  rt_uint8_t opacity, rtgui_color_t tint)
+{
+    int w, h, xoff, yoff;
+    rtgui_rect_t dest;
+    const struct rtgui_atlas_entry *entry;
+    struct rtgui_image_atlas *atlas;
+    struct rtgui_dc_buffer *sheet;
+    struct rtgui_graphic_driver *driver;
+
+    RT_ASSERT(image != RT_NULL && src != RT_NULL && dc != RT_NULL && rect != RT_NULL);
+    RT_ASSERT(image->engine == &_atlas_engine);
+
+    if (rtgui_dc_get_visible(dc) != RT_TRUE)
+        return RT_TRUE;
+
+    atlas = (struct rtgui_image_atlas *)image->data;
+    entry = &atlas->entries[image - atlas->images];
+    sheet = (struct rtgui_dc_buffer *)atlas->sheet;
+
+    /* the part of src in the icon, and the negative origin of rect as the hdc image */
+    xoff = src->x1 > 0 ? src->x1 : 0;
+    yoff = src->y1 > 0 ? src->y1 : 0;
+    dest = *rect;
+    if (dest.x1 < 0)
+    {
+        xoff -= dest.x1;
+        dest.x1 = 0;
+    }
+    if (dest.y1 < 0)
+    {
+        yoff -= dest.y1;
+        dest.y1 = 0;
+    }
+    w = _UI_MIN(_UI_MIN(src->x2, image->w) - xoff, rtgui_rect_width(dest));
+    h = _UI_MIN(_UI_MIN(src->y2, image->h) - yoff, rtgui_rect_height(dest));
+    if (w <= 0 || h <= 0)
+        return RT_TRUE;
+    dest.x2 = dest.x1 + w;
+    dest.y2 = dest.y1 + h;
+
+    xoff += entry->x;
+    yoff += entry->y;
+    driver = rtgui_graphic_driver_get_default();
+    if (dc->type == RTGUI_DC_BUFFER ||
+            ((dc->type == RTGUI_DC_CLIENT || dc->type == RTGUI_DC_HW) && driver->framebuffer != RT_NULL))
+    {
+        struct rtgui_image_info info;
+
+        info.a = opacity;
+        info.tint = tint;
+        info.pixels = rtgui_dc_buffer_read_pixel(atlas->sheet);
+        if (info.pixels == RT_NULL)
+            return RT_TRUE;
+        info.pixels += sheet->pitch * yoff + rtgui_color_get_bpp(sheet->pixel_format) * xoff;
+        info.src_fmt = sheet->pixel_format;
+        info.src_pitch = sheet->pitch;
+
+        rtgui_image_info_blit(&info, dc, &dest);
+    }
+    else
+    {
+        struct rtgui_point point;
+
+        if (opacity != 255 || (tint & 0xffffff) != (RTGUI_BLIT_NO_TINT & 0xffffff))
+            return RT_FALSE;
+
+        point.x = xoff;
+        point.y = yoff;
+        rtgui_dc_blit(atlas->sheet, &point, dc, &dest);
+    }
+
+    return RT_TRUE;
+}
+
+void rtgui_image_blit_subrect(struct rtgui_image *image, const rtgui_rect_t *src,
+                              struct rtgui_dc *dc, rtgui_rect_t *rect)
+{
+    _atlas_blit_part(image, src, dc, rect, 255, RTGUI_BLIT_NO_TINT);
+}
+RTM_EXPORT(rtgui_image_blit_subrect);
@@ -23,6 +23,8 @@
  *  features. The new decoder uses configurable fixed size working buffer and
  *  provides scaledown function.
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <rtthread.h>
 #include <rtgui/dc.h>
 #include <rtgui/image.h>
@@ -53,6 +55,8 @@ struct rtgui_image_bmp
 {
     rt_bool_t is_loaded;
     rt_uint8_t *pixels;
+    /* the P8 buffer dc of the palettized pixels loaded */
+    struct rtgui_dc *dc;
     struct rtgui_filerw *filerw;
     rt_uint32_t w, h;
     rt_uint32_t pixel_offset;
@@ -66,6 +70,7 @@ static rt_bool_t rtgui_image_bmp_check(struct rtgui_filerw *file);
 static rt_bool_t rtgui_image_bmp_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load);
 static void rtgui_image_bmp_unload(struct rtgui_image *image);
 static void rtgui_image_bmp_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
+static rt_bool_t rtgui_image_bmp_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info);
 
 struct rtgui_image_engine rtgui_image_bmp_engine =
 {
@@ -75,8 +80,37 @@ struct rtgui_image_engine rtgui_image_bmp_engine =
     rtgui_image_bmp_load,
     rtgui_image_bmp_unload,
     rtgui_image_bmp_blit,
+    rtgui_image_bmp_probe,
 };
 
+static rt_bool_t rtgui_image_bmp_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info)
+{
+    int h;
+    rt_uint8_t buffer[30];
+
+    if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(file, (void *)buffer, 1, sizeof(buffer)) != sizeof(buffer) ||
+            buffer[0] != 'B' || buffer[1] != 'M')
+        return RT_FALSE;
+
+    if (*(rt_uint32_t *)&buffer[14] == 12)
+    {
+        /* Bitmap Header Version 2.x */
+        info->w = *(rt_uint16_t *)&buffer[18];
+        info->h = *(rt_uint16_t *)&buffer[20];
+    }
+    else
+    {
+        /* the bottom-up rows are in the negative height */
+        h = *(rt_int32_t *)&buffer[22];
+        info->w = (rt_uint16_t)*(rt_int32_t *)&buffer[18];
+        info->h = (rt_uint16_t)(h < 0 ? -h : h);
+        info->has_alpha = *(rt_uint16_t *)&buffer[28] == 32;
+    }
+
+    return RT_TRUE;
+}
+
 static rt_bool_t rtgui_image_bmp_check(struct rtgui_filerw *file)
 {
     rt_uint8_t buffer[18];
@@ -136,7 +170,8 @@ static struct rtgui_image_palette *rtgui_image_bmp_load_palette(
     rt_bool_t alpha)
 {
     /* Load the palette, if any */
-    rt_uint32_t i;
+    rt_uint32_t i, size;
+    rt_uint8_t *temp, *ptr;
     struct rtgui_image_palette *palette;
 
     palette = rtgui_image_palette_create(colorsUsed);
@@ -146,34 +181,167 @@ static struct rtgui_image_palette *rtgui_image_bmp_load_palette(
     }
 
     palette->ncolors = colorsUsed;
-    if (alpha)
+
+    /* the entries are read in one call */
+    size = alpha ? 4 : 3;
+    temp = (rt_uint8_t *)rtgui_malloc(colorsUsed * size);
+    if (temp == RT_NULL ||
+            rtgui_filerw_read(file, (void *)temp, 1, colorsUsed * size) != (int)(colorsUsed * size))
+    {
+        rtgui_free(temp);
+        rtgui_free(palette);
+        return RT_NULL;
+    }
+
+    for (i = 0, ptr = temp; i < colorsUsed; i++, ptr += size)
+    {
+        if (alpha)
+            palette->colors[i] = RTGUI_ARGB(ptr[3], ptr[2], ptr[1], ptr[0]);
+        else
+            palette->colors[i] = RTGUI_RGB(ptr[2], ptr[1], ptr[0]);
+    }
+    rtgui_free(temp);
+
+    return palette;
+}
+
+/* the rows of pixels in a band, the padding is included */
+static int _bmp_band_rows(struct rtgui_image_bmp *bmp)
+{
+    int rows;
+
+    rows = GUIENGINE_BMP_BAND_SIZE / (bmp->pitch + bmp->pad);
+    return rows > 0 ? rows : 1;
+}
+
+/* the band of file in place if the filerw maps it, otherwise read in one call */
+static const rt_uint8_t *_bmp_band(struct rtgui_filerw *file, rt_off_t offset,
+                                   rt_uint32_t size, rt_uint8_t *buffer)
+{
+    const rt_uint8_t *band;
+
+    band = (const rt_uint8_t *)rtgui_filerw_map(file, offset, size);
+    if (band != RT_NULL)
+        return band;
+
+    if (rtgui_filerw_seek(file, offset, RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(file, (void *)buffer, 1, size) != (int)size)
+        return RT_NULL;
+
+    return buffer;
+}
+
+/*
+ * Load the pixels of 16, 24 and 32 bits not scaled, in the bands of rows. The
+ * rows are upside down in the file, each one is a memcpy.
+ */
+static rt_bool_t _bmp_load_rows(struct rtgui_image *image, struct rtgui_image_bmp *bmp)
+{
+    int y, rows, band_rows, index;
+    rt_uint32_t stride;
+    const rt_uint8_t *band;
+    rt_uint8_t *buffer;
+
+    stride = bmp->pitch + bmp->pad;
+    band_rows = _bmp_band_rows(bmp);
+    buffer = (rt_uint8_t *)rtgui_malloc(band_rows * stride);
+    if (buffer == RT_NULL)
+        return RT_FALSE;
+
+    for (y = 0; y < image->h; y += rows)
     {
-        rt_uint8_t temp[4];
-        for (i = 0; i < colorsUsed; i++)
+        rows = _UI_MIN(band_rows, image->h - y);
+        band = _bmp_band(bmp->filerw, bmp->pixel_offset + y * stride, rows * stride, buffer);
+        if (band == RT_NULL)
         {
-            if (rtgui_filerw_read(file, (void *)&temp, 1, 4) != 4)
-            {
-                rtgui_free(palette);
-                return RT_NULL;
-            }
-            palette->colors[i] = RTGUI_ARGB(temp[3], temp[2], temp[1], temp[0]);
+            rt_kprintf("BMP err: read failed\n");
+            break;
         }
+
+        for (index = 0; index < rows; index ++)
+            memcpy(bmp->pixels + (image->h - y - index - 1) * bmp->pitch,
+                   band + index * stride, bmp->pitch);
     }
-    else
+    rtgui_free(buffer);
+
+    return y >= image->h ? RT_TRUE : RT_FALSE;
+}
+
+/* the bytes per pixel of dc in the blit_line */
+static int _bmp_dc_bpp(struct rtgui_dc *dc)
+{
+    int bpp;
+
+    bpp = rtgui_color_get_bpp(rtgui_dc_get_pixel_format(dc));
+    return bpp > 0 ? bpp : 1;
+}
+
+/* the line converter from the pixels of BMP to the dc, RT_NULL if they are the same */
+static rtgui_blit_line_func _bmp_line_func(struct rtgui_image_bmp *bmp, struct rtgui_dc *dc)
+{
+    int bpp, src_bpp;
+
+    bpp = _bmp_dc_bpp(dc);
+    src_bpp = _UI_BITBYTES(bmp->bit_per_pixel);
+    if (rtgui_dc_get_pixel_format(dc) == RTGRAPHIC_PIXEL_FORMAT_BGR565)
+        return rtgui_blit_line_get_inv(bpp, src_bpp);
+    if (bpp == src_bpp)
+        return RT_NULL;
+
+    return rtgui_blit_line_get(bpp, src_bpp);
+}
+
+/*
+ * Blit the pixels of 16, 24 and 32 bits not loaded and not scaled. The rows
+ * are read in bands and converted in lines, or blitted in place if the BMP is
+ * in the format of dc.
+ */
+static void _bmp_blit_rows(struct rtgui_image *image, struct rtgui_image_bmp *bmp,
+                           struct rtgui_dc *dc, struct rtgui_rect *dst_rect, int w, int h)
+{
+    int y, rows, band_rows, index;
+    rt_uint32_t stride;
+    const rt_uint8_t *band;
+    rt_uint8_t *buffer, *line, *line_data;
+    rtgui_blit_line_func blit_line;
+
+    stride = bmp->pitch + bmp->pad;
+    band_rows = _bmp_band_rows(bmp);
+    blit_line = _bmp_line_func(bmp, dc);
+    buffer = (rt_uint8_t *)rtgui_malloc(band_rows * stride +
+                                        (blit_line != RT_NULL ? w * _bmp_dc_bpp(dc) : 0));
+    if (buffer == RT_NULL)
+    {
+        rt_kprintf("BMP err: no mem (%d)\n", band_rows * stride);
+        return;
+    }
+    line_data = buffer + band_rows * stride;
+
+    /* the top h rows of image are the last h rows of file */
+    for (y = 0; y < h; y += rows)
     {
-        rt_uint8_t temp[3];
-        for (i = 0; i < colorsUsed; i++)
+        rows = _UI_MIN(band_rows, h - y);
+        band = _bmp_band(bmp->filerw, bmp->pixel_offset + (image->h - h + y) * stride,
+                         rows * stride, buffer);
+        if (band == RT_NULL)
         {
-            if (rtgui_filerw_read(file, (void *)&temp, 1, 3) != 3)
+            rt_kprintf("BMP err: read failed\n");
+            break;
+        }
+
+        for (index = 0; index < rows; index ++)
+        {
+            line = (rt_uint8_t *)band + index * stride;
+            if (blit_line != RT_NULL)
             {
-                rtgui_free(palette);
-                return RT_NULL;
+                blit_line(line_data, line, w * _UI_BITBYTES(bmp->bit_per_pixel));
+                line = line_data;
             }
-            palette->colors[i] = RTGUI_RGB(temp[2], temp[1], temp[0]);
+            dc->engine->blit_line(dc, dst_rect->x1, dst_rect->x1 + w,
+                                  dst_rect->y1 + h - 1 - y - index, line);
         }
     }
-
-    return palette;
+    rtgui_free(buffer);
 }
 
 static rt_bool_t rtgui_image_bmp_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
@@ -204,6 +372,7 @@ static rt_bool_t rtgui_image_bmp_load(struct rtgui_image *image, struct rtgui_fi
             break;
         }
         bmp->pixels = RT_NULL;
+        bmp->dc = RT_NULL;
 
         /* Prepare to decode */
         if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) < 0)
@@ -324,7 +493,20 @@ static rt_bool_t rtgui_image_bmp_load(struct rtgui_image *image, struct rtgui_fi
 
             bytePerPixel = _UI_BITBYTES(bmp->bit_per_pixel);
             imageWidth = image->w * bytePerPixel;       /* Scaled width in byte */
-            bmp->pixels = rtgui_malloc(image->h * imageWidth);
+            if (bmp->bit_per_pixel <= 8)
+            {
+                /* the indexes are kept in a P8 dc, expanded by the palette in blit */
+                bmp->dc = rtgui_dc_buffer_create_tag(RTGRAPHIC_PIXEL_FORMAT_P8, image->w, image->h,
+                                                     RTGUI_MEM_IMAGE);
+                if (bmp->dc != RT_NULL &&
+                        rtgui_dc_buffer_set_palette(bmp->dc, image->palette->colors,
+                                                    image->palette->ncolors) == RT_EOK)
+                    bmp->pixels = rtgui_dc_buffer_get_pixel(bmp->dc);
+            }
+            else
+            {
+                bmp->pixels = rtgui_malloc(image->h * imageWidth);
+            }
             if (bmp->pixels == RT_NULL)
             {
                 rt_kprintf("BMP err: no mem to load (%d)\n", image->h * imageWidth);
@@ -366,6 +548,13 @@ static rt_bool_t rtgui_image_bmp_load(struct rtgui_image *image, struct rtgui_fi
 
             /* Process whole image */
             y = 0;
+            if (bmp->bit_per_pixel > 8 && bmp->scale == 0)
+            {
+                /* the rows are loaded in bands */
+                if (_bmp_load_rows(image, bmp) == RT_FALSE)
+                    break;
+                y = image->h;
+            }
             while (y < image->h)
             {
                 dst = bmp->pixels + (image->h - y - 1) * imageWidth;
@@ -486,7 +675,12 @@ static rt_bool_t rtgui_image_bmp_load(struct rtgui_image *image, struct rtgui_fi
     rtgui_free(wrkBuffer);
     rtgui_free(image->palette);
     if (bmp)
-        rtgui_free(bmp->pixels);
+    {
+        if (bmp->dc != RT_NULL)
+            rtgui_dc_destory(bmp->dc);
+        else
+            rtgui_free(bmp->pixels);
+    }
     rtgui_free(bmp);
     return RT_FALSE;
 }
@@ -500,7 +694,10 @@ static void rtgui_image_bmp_unload(struct rtgui_image *image)
         bmp = (struct rtgui_image_bmp *)image->data;
 
         /* Release memory */
-        rtgui_free(bmp->pixels);
+        if (bmp->dc != RT_NULL)
+            rtgui_dc_destory(bmp->dc);
+        else
+            rtgui_free(bmp->pixels);
         if (bmp->filerw != RT_NULL)
         {
             /* Close file */
@@ -536,7 +733,11 @@ static void rtgui_image_bmp_blit(struct rtgui_image *image, struct rtgui_dc *dc,
         w = _UI_MIN(image->w, rtgui_rect_width(*dst_rect));
         h = _UI_MIN(image->h, rtgui_rect_height(*dst_rect));
 
-        if (!bmp->is_loaded)
+        if (!bmp->is_loaded && bmp->bit_per_pixel > 8 && bmp->scale == 0)
+        {
+            _bmp_blit_rows(image, bmp, dc, dst_rect, w, h);
+        }
+        else if (!bmp->is_loaded)
         {
             rt_uint8_t *wrkBuffer;
             rt_uint16_t readLength, readIndex, loadIndex;
@@ -759,55 +960,49 @@ static void rtgui_image_bmp_blit(struct rtgui_image *image, struct rtgui_dc *dc,
         }
         else
         {
-            rt_uint16_t x, y;
+            rt_uint16_t y;
             rt_uint8_t *ptr;
 
             if (bmp->bit_per_pixel <= 8)
             {
-                rtgui_color_t color;
+                rtgui_rect_t rect;
 
-                /* 1bpp, and using palette */
-                for (y = 0; y < h; y ++)
-                {
-                    ptr = bmp->pixels + (y * imageWidth);
-                    for (x = 0; x < w; x ++)
-                    {
-                        color = image->palette->colors[*(ptr++)];
-                        rtgui_dc_draw_color_point(dc,
-                                                  dst_rect->x1 + x, dst_rect->y1 + y,
-                                                  color);
-                    }
-                }
+                /* the palette is expanded in the blit of P8 dc */
+                rtgui_rect_init(&rect, dst_rect->x1, dst_rect->y1, w, h);
+                rtgui_dc_blit(bmp->dc, RT_NULL, dc, &rect);
             }
             else
             {
                 rtgui_blit_line_func blit_line;
-                rt_uint8_t hw_bytePerPixel = _UI_BITBYTES(hw_driver->bits_per_pixel);
-                rt_uint8_t *line_data;
+                rt_uint8_t *line_data = RT_NULL;
 
-                if (hw_driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_BGR565)
+                /* the rows in the format of dc are blitted in place */
+                blit_line = _bmp_line_func(bmp, dc);
+                if (blit_line != RT_NULL)
                 {
-                    blit_line = rtgui_blit_line_get_inv(hw_bytePerPixel, bytePerPixel);
+                    line_data = (rt_uint8_t *)rtgui_malloc(w * _bmp_dc_bpp(dc));
+                    if (line_data == RT_NULL) break; /* out of memory */
                 }
-                else
-                {
-                    blit_line = rtgui_blit_line_get(hw_bytePerPixel, bytePerPixel);
-                }
-
-                line_data = (rt_uint8_t *)rtgui_malloc(w * rtgui_color_get_bpp(hw_driver->pixel_format));
-                if (line_data == RT_NULL) break; /* out of memory */
 
                 ptr = bmp->pixels;
                 for (y = 0; y < h; y ++)
                 {
-                    blit_line(line_data, ptr, bytePerPixel * w);
+                    if (blit_line != RT_NULL)
+                    {
+                        blit_line(line_data, ptr, bytePerPixel * w);
+                        dc->engine->blit_line(dc, dst_rect->x1, dst_rect->x1 + w,
+                                              dst_rect->y1 + y, line_data);
+                    }
+                    else
+                    {
+                        dc->engine->blit_line(dc, dst_rect->x1, dst_rect->x1 + w,
+                                              dst_rect->y1 + y, ptr);
+                    }
                     ptr += imageWidth;
-
-                    dc->engine->blit_line(dc, dst_rect->x1, dst_rect->x1 + w,
-                                          dst_rect->y1 + y, line_data);
                 }
 
-                rtgui_free(line_data);
+                if (line_data != RT_NULL)
+                    rtgui_free(line_data);
             }
         }
     } while (0);
@@ -928,6 +1123,7 @@ void screenshot(const char *filename)
         bmp_align_write(file, pixel_buf, (char *)&mask, 4, &write_count);
     }
     rtgui_screen_lock(RT_WAITING_FOREVER);
+    rtgui_graphic_driver_accel_sync();
     if (grp->framebuffer != RT_NULL)
     {
         src = (rt_uint16_t *)grp->framebuffer;
@@ -0,0 +1,169 @@
+/*
+ * File      : image_cache.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/image.h>
+#include <rtgui/driver.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#if defined(GUIENGINE_USING_IMAGE_DISK_CACHE) && defined(GUIENGINE_USING_DFS_FILERW)
+
+/*
+ * The images of the formats expensive to decode are kept in the HDC files of
+ * native pixels in GUIENGINE_IMAGE_DISK_CACHE_DIR. The cache file is named by
+ * the hash of path, the size and mtime of source, so the changed source is
+ * decoded again.
+ */
+#define IMAGE_CACHE_NAME_SIZE   (sizeof(GUIENGINE_IMAGE_DISK_CACHE_DIR) + 32)
+
+static rt_bool_t _image_cache_name(const char *filename, char *name)
+{
+    struct stat st;
+    struct rtgui_image_engine *engine;
+    rt_uint32_t hash = 2166136261UL;
+    const char *ptr;
+
+    engine = rtgui_image_get_engine_by_filename(filename);
+    if (engine == RT_NULL ||
+            (rt_strcmp(engine->name, "png") != 0 && rt_strcmp(engine->name, "jpeg") != 0 &&
+             rt_strcmp(engine->name, "jpg") != 0))
+        return RT_FALSE;
+
+    if (stat(filename, &st) != 0)
+        return RT_FALSE;
+
+    for (ptr = filename; *ptr; ptr ++)
+    {
+        hash ^= (rt_uint8_t)*ptr;
+        hash *= 16777619UL;
+    }
+    rt_snprintf(name, IMAGE_CACHE_NAME_SIZE, "%s/%08x%08x%08x.hdc", GUIENGINE_IMAGE_DISK_CACHE_DIR,
+                hash, (rt_uint32_t)st.st_size, (rt_uint32_t)st.st_mtime);
+
+    return RT_TRUE;
+}
+
+struct rtgui_image *rtgui_image_cache_open(const char *filename, rt_bool_t load)
+{
+    int fd;
+    char name[IMAGE_CACHE_NAME_SIZE];
+
+    if (_image_cache_name(filename, name) == RT_FALSE)
+        return RT_NULL;
+
+    /* no engine is checked for the file not cached */
+    fd = open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return RT_NULL;
+    close(fd);
+
+    return rtgui_image_create_from_file("hdc", name, load);
+}
+
+void rtgui_image_cache_store(const char *filename, struct rtgui_image *image)
+{
+    int y, bpp;
+    rt_uint8_t format, *pixels;
+    rt_uint32_t header[5];
+    char name[IMAGE_CACHE_NAME_SIZE + 4];
+    struct rtgui_rect rect;
+    struct rtgui_dc *dc;
+    struct rtgui_filerw *file;
+    struct rtgui_image_probe_info info;
+
+    if (_image_cache_name(filename, name) == RT_FALSE)
+        return;
+
+    /* the image with alpha is kept in ARGB888, the others in the pixels of driver */
+    format = rtgui_graphic_driver_get_default()->pixel_format;
+    if (rtgui_image_probe(filename, &info) == RT_EOK && info.has_alpha)
+        format = RTGRAPHIC_PIXEL_FORMAT_ARGB888;
+
+    dc = rtgui_dc_buffer_create_pixformat(format, image->w, image->h);
+    if (dc == RT_NULL)
+        return;
+    rtgui_rect_init(&rect, 0, 0, image->w, image->h);
+    rtgui_image_blit(image, dc, &rect);
+
+    pixels = rtgui_dc_buffer_read_pixel(dc);
+    if (pixels == RT_NULL)
+    {
+        rtgui_dc_destory(dc);
+        return;
+    }
+
+    /* written in a temporary file, which is renamed when it's complete */
+    rt_strncpy(name + rt_strlen(name), ".tmp", 5);
+    file = rtgui_filerw_create_file(name, "wb");
+    if (file == RT_NULL)
+    {
+        mkdir(GUIENGINE_IMAGE_DISK_CACHE_DIR, 0);
+        file = rtgui_filerw_create_file(name, "wb");
+    }
+    if (file == RT_NULL)
+    {
+        rtgui_dc_destory(dc);
+        return;
+    }
+
+    /* the 1.x HDC, the pixels after the header */
+    rt_memcpy(&header[0], "HDC", 4);
+    header[1] = image->w;
+    header[2] = image->h;
+    header[3] = 1;
+    header[4] = format;
+    bpp = rtgui_color_get_bpp(format);
+
+    y = -1;
+    if (rtgui_filerw_write(file, header, 1, sizeof(header)) == sizeof(header))
+    {
+        for (y = 0; y < image->h; y ++)
+        {
+            if (rtgui_filerw_write(file, pixels + y * ((struct rtgui_dc_buffer *)dc)->pitch,
+                                   1, image->w * bpp) != image->w * bpp)
+                break;
+        }
+    }
+    rtgui_filerw_close(file);
+    rtgui_dc_destory(dc);
+
+    if (y == image->h)
+    {
+        char target[IMAGE_CACHE_NAME_SIZE];
+
+        rt_strncpy(target, name, rt_strlen(name) - 4);
+        target[rt_strlen(name) - 4] = '\0';
+        if (rename(name, target) == 0)
+            return;
+    }
+    rtgui_filerw_unlink(name);
+}
+
+#endif
@@ -21,8 +21,11 @@
  * Date           Author       Notes
  * 2010-09-15     Bernard      first version
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <rtgui/rtgui_system.h>
 #include <rtgui/image_container.h>
+#include <rtgui/dc.h>
 
 /*
  * ImageContainer is a Image pool to manage image resource in the system.
@@ -374,6 +377,12 @@ rt_bool_t string_equal_func(const void *a, const void *b)
 static rtgui_hash_table_t *image_hash_table;
 static struct rt_mutex _image_hash_lock;
 
+/* the unreferenced items in the order of put, the least recently used is
+ * at the tail */
+static rt_list_t _image_lru_list = RT_LIST_OBJECT_INIT(_image_lru_list);
+/* the bytes of all the items in container */
+static rt_uint32_t _image_total_size;
+
 void rtgui_system_image_container_init(void)
 {
     rt_mutex_init(&_image_hash_lock, "image", RT_IPC_FLAG_FIFO);
@@ -383,57 +392,254 @@ void rtgui_system_image_container_init(void)
     RT_ASSERT(image_hash_table != RT_NULL);
 }
 
+/* the image system is initialized at the first use with GUIENGINE_USING_LAZY_INIT */
+rt_inline rt_err_t _image_hash_take(void)
+{
+    rtgui_system_image_init();
+
+    return rt_mutex_take(&_image_hash_lock, RT_WAITING_FOREVER);
+}
+
+/* the bytes of image decoded, which is ARGB888 at most */
+rt_inline rt_uint32_t _image_item_size(struct rtgui_image *image)
+{
+    return (rt_uint32_t)image->w * image->h * 4;
+}
+
+static void _image_item_destroy(struct rtgui_image_item *item)
+{
+    /* remove item from container */
+    hash_table_remove(image_hash_table, item->filename);
+    _image_total_size -= item->size;
+
+    /* destroy image and image item */
+    rt_free(item->filename);
+    rtgui_image_destroy(item->image);
+    rtgui_free(item);
+}
+
+/* destroy the least recently used items until the container is in budget */
+static void _image_container_evict(void)
+{
+    struct rtgui_image_item *item;
+
+    while (_image_total_size > GUIENGINE_IMAGE_CONTAINER_BUDGET &&
+            !rt_list_isempty(&_image_lru_list))
+    {
+        item = rt_list_entry(_image_lru_list.prev, struct rtgui_image_item, list);
+        rt_list_remove(&item->list);
+        _image_item_destroy(item);
+    }
+}
+
+/* add an image to container with the key, the image is destroyed on failure */
+static struct rtgui_image_item *_image_item_insert(const char *key, struct rtgui_image *image)
+{
+    struct rtgui_image_item *item;
+
+    item = (struct rtgui_image_item *) rtgui_malloc(sizeof(struct rtgui_image_item));
+    if (item == RT_NULL)
+    {
+        rtgui_image_destroy(image);
+        return RT_NULL;
+    }
+
+    item->image = image;
+    item->refcount = 1;
+    item->pinned = RT_FALSE;
+    item->size = _image_item_size(item->image);
+    rt_list_init(&item->list);
+    item->filename = rt_strdup(key);
+    hash_table_insert(image_hash_table, item->filename, item);
+    _image_total_size += item->size;
+
+    /* make room for the new image from the cached ones */
+    _image_container_evict();
+
+    return item;
+}
+
+static struct rtgui_image_item *_image_item_create(const char *filename)
+{
+    struct rtgui_image *image;
+
+    /* create a image object */
+    image = rtgui_image_create(filename, RT_TRUE);
+    if (image == RT_NULL)
+        return RT_NULL; /* create image failed */
+
+    return _image_item_insert(filename, image);
+}
+
+/* refer an item in container, it's removed from lru list if unreferenced */
+rt_inline void _image_item_refer(struct rtgui_image_item *item)
+{
+    if (item->refcount == 0)
+        rt_list_remove(&item->list);
+    item->refcount ++;
+}
+
 rtgui_image_item_t *rtgui_image_container_get(const char *filename)
 {
     struct rtgui_image_item *item = RT_NULL;
 
-    if (rt_mutex_take(&_image_hash_lock, RT_WAITING_FOREVER) == RT_EOK)
+    if (_image_hash_take() == RT_EOK)
     {
         item = hash_table_find(image_hash_table, filename);
         if (item == RT_NULL)
-        {
-            item = (struct rtgui_image_item *) rtgui_malloc(sizeof(struct rtgui_image_item));
-            if (item == RT_NULL)
-            {
-                rt_mutex_release(&_image_hash_lock);
-                return RT_NULL;
-            }
+            item = _image_item_create(filename);
+        else
+            _image_item_refer(item);
 
-            /* create a image object */
-            item->image = rtgui_image_create(filename, RT_TRUE);
-            if (item->image == RT_NULL)
-            {
-                rtgui_free(item);
-                rt_mutex_release(&_image_hash_lock);
-                return RT_NULL; /* create image failed */
-            }
-            item->refcount = 1;
-            item->filename = rt_strdup(filename);
-            hash_table_insert(image_hash_table, item->filename, item);
+        rt_mutex_release(&_image_hash_lock);
+    }
+
+    return item;
+}
+RTM_EXPORT(rtgui_image_container_get);
+
+/* the scaled image is a buffer dc wrapped in an image */
+static void _image_dc_unload(struct rtgui_image *image)
+{
+    rtgui_dc_destory((struct rtgui_dc *)image->data);
+}
+
+static void _image_dc_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
+{
+    struct rtgui_rect dst = *rect;
+
+    dst.x2 = _UI_MIN(dst.x2, dst.x1 + image->w);
+    dst.y2 = _UI_MIN(dst.y2, dst.y1 + image->h);
+    rtgui_dc_blit((struct rtgui_dc *)image->data, RT_NULL, dc, &dst);
+}
+
+static struct rtgui_image_engine _image_dc_engine =
+{
+    "dc",
+    { RT_NULL },
+    RT_NULL,
+    RT_NULL,
+    _image_dc_unload,
+    _image_dc_blit,
+};
+
+static struct rtgui_image *_image_scale(struct rtgui_image *image, int w, int h, int angle, rt_bool_t smooth)
+{
+    struct rtgui_dc *dc, *scaled;
+    struct rtgui_rect rect;
+    struct rtgui_image *result;
+#ifdef GUIENGINE_USING_IMAGE_MIPMAP
+    struct rtgui_image_mipmap *mipmap;
+
+    /* the smooth shrink in the half levels, only the nearest one is zoomed */
+    if (smooth && angle == 0 && (w * 2 <= image->w || h * 2 <= image->h))
+    {
+        mipmap = rtgui_image_mipmap_create(image, 0);
+        if (mipmap == RT_NULL) return RT_NULL;
+        scaled = rtgui_image_mipmap_scale(mipmap, w, h);
+        rtgui_image_mipmap_destroy(mipmap);
+        goto _wrap;
+    }
+#endif
+
+    /* render the image to a transparent dc, then scale and rotate it */
+    dc = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, image->w, image->h);
+    if (dc == RT_NULL) return RT_NULL;
+
+    rect.x1 = rect.y1 = 0;
+    rect.x2 = image->w;
+    rect.y2 = image->h;
+    rtgui_image_blit(image, dc, &rect);
+
+    scaled = rtgui_dc_rotozoom(dc, angle, (double)w / image->w, (double)h / image->h, smooth);
+    rtgui_dc_destory(dc);
+#ifdef GUIENGINE_USING_IMAGE_MIPMAP
+_wrap:
+#endif
+    if (scaled == RT_NULL) return RT_NULL;
+
+    result = (struct rtgui_image *) rtgui_malloc(sizeof(struct rtgui_image));
+    if (result == RT_NULL)
+    {
+        rtgui_dc_destory(scaled);
+        return RT_NULL;
+    }
+
+    /* the rotated image is larger than the rect of scale */
+    result->w = angle ? ((struct rtgui_dc_buffer *)scaled)->width : w;
+    result->h = angle ? ((struct rtgui_dc_buffer *)scaled)->height : h;
+    result->engine = &_image_dc_engine;
+    result->palette = RT_NULL;
+    result->data = scaled;
+
+    return result;
+}
+
+rtgui_image_item_t *rtgui_image_container_get_scaled(const char *filename, int w, int h,
+                                                     int angle, rt_bool_t smooth)
+{
+    char *key;
+    struct rtgui_image *image;
+    struct rtgui_image_item *item = RT_NULL, *base;
+
+    RT_ASSERT(filename != RT_NULL);
+    if (w <= 0 || h <= 0) return RT_NULL;
+
+    /* the variant is cached by the name of image with the parameters */
+    key = (char *) rtgui_malloc(rt_strlen(filename) + 32);
+    if (key == RT_NULL) return RT_NULL;
+    rt_snprintf(key, rt_strlen(filename) + 32, "%s#%dx%d@%d%s", filename, w, h, angle,
+                smooth ? "s" : "");
+
+    if (_image_hash_take() == RT_EOK)
+    {
+        item = hash_table_find(image_hash_table, key);
+        if (item != RT_NULL)
+        {
+            _image_item_refer(item);
         }
         else
         {
-            item->refcount ++; /* increase refcount */
+            base = hash_table_find(image_hash_table, filename);
+            if (base == RT_NULL)
+                base = _image_item_create(filename);
+            else
+                _image_item_refer(base);
+
+            if (base != RT_NULL)
+            {
+                image = _image_scale(base->image, w, h, angle, smooth);
+                if (image != RT_NULL)
+                    item = _image_item_insert(key, image);
+
+                /* the base image is cached as an unreferenced one */
+                base->refcount --;
+                if (base->refcount == 0 && base->pinned == RT_FALSE)
+                {
+                    rt_list_insert_after(&_image_lru_list, &base->list);
+                    _image_container_evict();
+                }
+            }
         }
 
         rt_mutex_release(&_image_hash_lock);
     }
 
+    rtgui_free(key);
+
     return item;
 }
-RTM_EXPORT(rtgui_image_container_get);
+RTM_EXPORT(rtgui_image_container_get_scaled);
 
 rtgui_image_item_t *rtgui_image_container_find(const char *filename)
 {
     struct rtgui_image_item *item = RT_NULL;
 
-    if (rt_mutex_take(&_image_hash_lock, RT_WAITING_FOREVER) == RT_EOK)
+    if (_image_hash_take() == RT_EOK)
     {
         item = hash_table_find(image_hash_table, filename);
         if (item != RT_NULL)
-        {
-            item->refcount++; /* increase refcount */
-        }
+            _image_item_refer(item);
 
         rt_mutex_release(&_image_hash_lock);
     }
@@ -446,27 +652,17 @@ rtgui_image_item_t *rtgui_image_container_create(const char *filename)
 {
     struct rtgui_image_item *item = RT_NULL;
 
-    if (rt_mutex_take(&_image_hash_lock, RT_WAITING_FOREVER) == RT_EOK)
+    if (_image_hash_take() == RT_EOK)
     {
-        item = (struct rtgui_image_item *) rtgui_malloc(sizeof(struct rtgui_image_item));
-        if (item == RT_NULL)
-        {
-            rt_mutex_release(&_image_hash_lock);
-            return RT_NULL;
-        }
-
-        /* create a image object */
-        item->image = rtgui_image_create(filename, RT_TRUE);
-        if (item->image == RT_NULL)
+        /* the cached item is replaced by the new one */
+        item = hash_table_find(image_hash_table, filename);
+        if (item != RT_NULL && item->refcount == 0 && item->pinned == RT_FALSE)
         {
-            rtgui_free(item);
-            rt_mutex_release(&_image_hash_lock);
-            return RT_NULL; /* create image failed */
+            rt_list_remove(&item->list);
+            _image_item_destroy(item);
         }
-        item->refcount = 1;
-        item->filename = rt_strdup(filename);
-        hash_table_insert(image_hash_table, item->filename, item);
 
+        item = _image_item_create(filename);
         rt_mutex_release(&_image_hash_lock);
     }
 
@@ -476,21 +672,169 @@ RTM_EXPORT(rtgui_image_container_create);
 
 void rtgui_image_container_put(rtgui_image_item_t *item)
 {
-    rt_mutex_take(&_image_hash_lock, RT_WAITING_FOREVER);
+    _image_hash_take();
     item->refcount --;
-    if (item->refcount == 0)
+    if (item->refcount == 0 && item->pinned == RT_FALSE)
     {
-        /* remove item from container */
-        hash_table_remove(image_hash_table, item->filename);
-
-        /* destroy image and image item */
-        rt_free(item->filename);
-        rtgui_image_destroy(item->image);
-        rtgui_free(item);
+        /* keep the image in cache until it's out of budget */
+        rt_list_insert_after(&_image_lru_list, &item->list);
+        _image_container_evict();
     }
     rt_mutex_release(&_image_hash_lock);
 }
 RTM_EXPORT(rtgui_image_container_put);
 
+void rtgui_image_container_pin(rtgui_image_item_t *item, rt_bool_t pinned)
+{
+    _image_hash_take();
+    if (item->pinned != pinned)
+    {
+        item->pinned = pinned;
+
+        /* the unreferenced item is moved in or out of lru list */
+        if (item->refcount == 0)
+        {
+            if (pinned == RT_TRUE)
+            {
+                rt_list_remove(&item->list);
+            }
+            else
+            {
+                rt_list_insert_after(&_image_lru_list, &item->list);
+                _image_container_evict();
+            }
+        }
+    }
+    rt_mutex_release(&_image_hash_lock);
+}
+RTM_EXPORT(rtgui_image_container_pin);
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+/* the prefetch requests not done */
+struct rtgui_image_prefetch
+{
+    rt_list_t list;
+    struct rtgui_image_request *request;
+
+    /* char filename[]; */
+};
+
+static rt_list_t _image_prefetch_list = RT_LIST_OBJECT_INIT(_image_prefetch_list);
+
+static void _image_prefetch_done(struct rtgui_image_request *request, struct rtgui_image *image,
+                                 void *user_data)
+{
+    struct rtgui_image_item *item;
+    struct rtgui_image_prefetch *prefetch = (struct rtgui_image_prefetch *)user_data;
+
+    _image_hash_take();
+    rt_list_remove(&prefetch->list);
+    if (image != RT_NULL)
+    {
+        if (hash_table_find(image_hash_table, (const char *)(prefetch + 1)) == RT_NULL &&
+                _image_total_size + _image_item_size(image) <= GUIENGINE_IMAGE_CONTAINER_BUDGET)
+        {
+            item = _image_item_insert((const char *)(prefetch + 1), image);
+            if (item != RT_NULL)
+            {
+                item->refcount = 0;
+                rt_list_insert_after(&_image_lru_list, &item->list);
+            }
+        }
+        else
+        {
+            rtgui_image_destroy(image);
+        }
+    }
+    rt_mutex_release(&_image_hash_lock);
+
+    rtgui_free(prefetch);
+}
+
+void rtgui_image_container_prefetch(const char * const *filenames)
+{
+    rt_size_t len;
+    rt_list_t *node;
+    struct rtgui_image_prefetch *prefetch;
+
+    RT_ASSERT(filenames != RT_NULL);
+
+    for (; *filenames != RT_NULL; filenames ++)
+    {
+        _image_hash_take();
+        /* the image cached or being prefetched */
+        prefetch = RT_NULL;
+        if (hash_table_find(image_hash_table, *filenames) == RT_NULL)
+        {
+            rt_list_for_each(node, &_image_prefetch_list)
+            {
+                if (rt_strcmp((const char *)(rt_list_entry(node, struct rtgui_image_prefetch, list) + 1),
+                              *filenames) == 0)
+                    break;
+            }
+
+            if (node == &_image_prefetch_list)
+            {
+                len = rt_strlen(*filenames) + 1;
+                prefetch = (struct rtgui_image_prefetch *)rtgui_malloc(sizeof(struct rtgui_image_prefetch) + len);
+                if (prefetch != RT_NULL)
+                {
+                    rt_memcpy(prefetch + 1, *filenames, len);
+                    rt_list_insert_before(&_image_prefetch_list, &prefetch->list);
+                }
+            }
+        }
+        rt_mutex_release(&_image_hash_lock);
+
+        if (prefetch == RT_NULL)
+            continue;
+
+        /* the done callback is in this thread, after the request is set */
+        prefetch->request = rtgui_image_load_background(*filenames, _image_prefetch_done, prefetch);
+        if (prefetch->request == RT_NULL)
+        {
+            _image_hash_take();
+            rt_list_remove(&prefetch->list);
+            rt_mutex_release(&_image_hash_lock);
+            rtgui_free(prefetch);
+        }
+    }
+}
+RTM_EXPORT(rtgui_image_container_prefetch);
+
+void rtgui_image_container_prefetch_cancel(void)
+{
+    struct rtgui_image_prefetch *prefetch;
+
+    _image_hash_take();
+    while (!rt_list_isempty(&_image_prefetch_list))
+    {
+        prefetch = rt_list_entry(_image_prefetch_list.next, struct rtgui_image_prefetch, list);
+        rt_list_remove(&prefetch->list);
+
+        /* the callback is not invoked after cancel */
+        rtgui_image_request_cancel(prefetch->request);
+        rtgui_free(prefetch);
+    }
+    rt_mutex_release(&_image_hash_lock);
+}
+RTM_EXPORT(rtgui_image_container_prefetch_cancel);
+#endif
+
+void rtgui_image_container_flush(void)
+{
+    struct rtgui_image_item *item;
+
+    _image_hash_take();
+    while (!rt_list_isempty(&_image_lru_list))
+    {
+        item = rt_list_entry(_image_lru_list.prev, struct rtgui_image_item, list);
+        rt_list_remove(&item->list);
+        _image_item_destroy(item);
+    }
+    rt_mutex_release(&_image_hash_lock);
+}
+RTM_EXPORT(rtgui_image_container_flush);
+
 #endif
 
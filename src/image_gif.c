@@ -0,0 +1,668 @@
+/*
+ * File      : image_gif.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/image.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_IMAGE_GIF
+
+/*
+ * The GIF image keeps the file data, the mapped memory or a copy of it, and
+ * decodes one frame at a time on the persistent ARGB888 canvas. A frame is
+ * the sub-rect of image in LZW, so only it is decoded and blitted.
+ */
+#define GIF_MAX_CODES       4096
+/* the delay of frame too short is slowed as the browsers do */
+#define GIF_MIN_DELAY       2
+#define GIF_DEFAULT_DELAY   10
+
+/* the disposal of frame before the next one */
+#define GIF_DISPOSE_NONE        0
+#define GIF_DISPOSE_KEEP        1
+#define GIF_DISPOSE_BACKGROUND  2
+#define GIF_DISPOSE_PREVIOUS    3
+
+struct rtgui_image_gif
+{
+    /* the filerw of mapped data, RT_NULL if the data is copied */
+    struct rtgui_filerw *filerw;
+    const rt_uint8_t *data;
+    rt_uint32_t size;
+
+    /* the global color table, RT_NULL if there is not */
+    const rt_uint8_t *palette;
+    int ncolors;
+
+    /* the block after the header, and the next block to decode */
+    rt_uint32_t first, pos;
+
+    struct rtgui_dc *canvas;
+
+    /* the delay of the last frame in ms, and its disposal */
+    rt_uint32_t delay;
+    rtgui_rect_t last;
+    rt_uint8_t dispose;
+    /* the pixels under the last frame of GIF_DISPOSE_PREVIOUS */
+    rt_uint32_t *backup;
+
+    /* the loops of NETSCAPE extension, 0 is forever and -1 is played once */
+    rt_int32_t loops;
+    rt_int32_t played;
+};
+
+/* the state of a frame from the graphic control extension */
+struct _gif_frame
+{
+    rtgui_rect_t rect;
+    const rt_uint8_t *palette;
+    int ncolors;
+    int transparent;
+    rt_uint8_t dispose;
+    rt_uint8_t interlace;
+    rt_uint32_t delay;
+};
+
+/* the reader of LZW codes in the data sub-blocks */
+struct _gif_bits
+{
+    const rt_uint8_t *data;
+    rt_uint32_t size, pos;
+    int block;
+    rt_uint32_t bits;
+    int count;
+};
+
+static rt_bool_t rtgui_image_gif_check(struct rtgui_filerw *file);
+static rt_bool_t rtgui_image_gif_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load);
+static void rtgui_image_gif_unload(struct rtgui_image *image);
+static void rtgui_image_gif_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
+static rt_bool_t rtgui_image_gif_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info);
+static rt_bool_t rtgui_image_gif_frame(struct rtgui_image *image, rt_bool_t next, struct rtgui_image_frame *frame);
+
+struct rtgui_image_engine rtgui_image_gif_engine =
+{
+    "gif",
+    { RT_NULL },
+    rtgui_image_gif_check,
+    rtgui_image_gif_load,
+    rtgui_image_gif_unload,
+    rtgui_image_gif_blit,
+    rtgui_image_gif_probe,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    rtgui_image_gif_frame,
+};
+
+rt_inline int _gif_u16(const rt_uint8_t *ptr)
+{
+    return ptr[0] | (ptr[1] << 8);
+}
+
+static rt_bool_t _gif_is_header(const rt_uint8_t *buffer)
+{
+    return rt_memcmp(buffer, "GIF87a", 6) == 0 || rt_memcmp(buffer, "GIF89a", 6) == 0;
+}
+
+static rt_bool_t rtgui_image_gif_check(struct rtgui_filerw *file)
+{
+    int start;
+    rt_uint8_t buffer[6];
+    rt_bool_t is_gif = RT_FALSE;
+
+    start = rtgui_filerw_tell(file);
+    if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) == 0 &&
+            rtgui_filerw_read(file, buffer, 1, sizeof(buffer)) == sizeof(buffer))
+        is_gif = _gif_is_header(buffer);
+    rtgui_filerw_seek(file, start, RTGUI_FILE_SEEK_SET);
+
+    return is_gif;
+}
+
+static rt_bool_t rtgui_image_gif_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info)
+{
+    rt_uint8_t buffer[13];
+
+    if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(file, buffer, 1, sizeof(buffer)) != sizeof(buffer) ||
+            !_gif_is_header(buffer))
+        return RT_FALSE;
+
+    info->w = _gif_u16(&buffer[6]);
+    info->h = _gif_u16(&buffer[8]);
+    /* the transparency is in the frames, which are not parsed here */
+    info->has_alpha = RT_TRUE;
+
+    return RT_TRUE;
+}
+
+/* skip the data sub-blocks, return the position after the terminator or 0 */
+static rt_uint32_t _gif_skip_blocks(const struct rtgui_image_gif *gif, rt_uint32_t pos)
+{
+    while (pos < gif->size)
+    {
+        if (gif->data[pos] == 0)
+            return pos + 1;
+        pos += gif->data[pos] + 1;
+    }
+
+    return 0;
+}
+
+/* the next code of size bits, -1 at the end of data */
+static int _gif_read_code(struct _gif_bits *reader, int size)
+{
+    int code;
+
+    while (reader->count < size)
+    {
+        if (reader->block == 0)
+        {
+            if (reader->pos >= reader->size || reader->data[reader->pos] == 0)
+                return -1;
+            reader->block = reader->data[reader->pos ++];
+        }
+        if (reader->pos >= reader->size)
+            return -1;
+        reader->bits |= (rt_uint32_t)reader->data[reader->pos ++] << reader->count;
+        reader->count += 8;
+        reader->block --;
+    }
+
+    code = reader->bits & ((1 << size) - 1);
+    reader->bits >>= size;
+    reader->count -= size;
+
+    return code;
+}
+
+/* the row of canvas for the index of row in frame */
+static int _gif_frame_row(const struct _gif_frame *frame, int index)
+{
+    int h, pass;
+    static const rt_uint8_t start[] = {0, 4, 2, 1}, step[] = {8, 8, 4, 2};
+
+    if (!frame->interlace)
+        return frame->rect.y1 + index;
+
+    h = rtgui_rect_height(frame->rect);
+    for (pass = 0; pass < 4; pass ++)
+    {
+        int rows = (h - start[pass] + step[pass] - 1) / step[pass];
+
+        if (h <= start[pass])
+            continue;
+        if (index < rows)
+            return frame->rect.y1 + start[pass] + index * step[pass];
+        index -= rows;
+    }
+
+    return -1;
+}
+
+/* decode the LZW pixels of frame on the canvas, the transparent index is skipped */
+static rt_bool_t _gif_decode_frame(struct rtgui_image_gif *gif, const struct _gif_frame *frame,
+                                   int min_size, struct _gif_bits *reader)
+{
+    int code, in, clear, next, size, old, first, x, y, row, w, h, pitch;
+    rt_uint16_t *prefix;
+    rt_uint8_t *suffix, *stack, *sp, *pixels;
+    rt_uint32_t *line;
+    struct rtgui_dc_buffer *canvas;
+
+    if (min_size < 2 || min_size > 11)
+        return RT_FALSE;
+
+    prefix = (rt_uint16_t *)rtgui_malloc(GIF_MAX_CODES * (sizeof(rt_uint16_t) + 2));
+    if (prefix == RT_NULL)
+        return RT_FALSE;
+    suffix = (rt_uint8_t *)(prefix + GIF_MAX_CODES);
+    stack = suffix + GIF_MAX_CODES;
+
+    canvas = (struct rtgui_dc_buffer *)gif->canvas;
+    pixels = rtgui_dc_buffer_get_pixel(gif->canvas);
+    pitch = canvas->pitch;
+    w = rtgui_rect_width(frame->rect);
+    h = rtgui_rect_height(frame->rect);
+
+    clear = 1 << min_size;
+    for (code = 0; code < clear; code ++)
+    {
+        prefix[code] = 0;
+        suffix[code] = code;
+    }
+    next = clear + 2;
+    size = min_size + 1;
+    old = -1;
+    first = 0;
+    x = 0;
+    y = 0;
+    line = RT_NULL;
+    row = _gif_frame_row(frame, 0);
+    if (row >= 0 && row < canvas->height)
+        line = (rt_uint32_t *)(pixels + row * pitch);
+
+    while (y < h)
+    {
+        code = _gif_read_code(reader, size);
+        if (code < 0 || code == clear + 1)
+            break;
+        if (code == clear)
+        {
+            next = clear + 2;
+            size = min_size + 1;
+            old = -1;
+            continue;
+        }
+
+        in = code;
+        sp = stack;
+        if (old == -1)
+        {
+            if (code >= clear)
+                break;
+            *sp++ = first = code;
+        }
+        else
+        {
+            if (code >= next)
+            {
+                /* the code of the string being defined */
+                if (code > next)
+                    break;
+                *sp++ = first;
+                code = old;
+            }
+            while (code >= clear)
+            {
+                *sp++ = suffix[code];
+                code = prefix[code];
+            }
+            *sp++ = first = code;
+
+            if (next < GIF_MAX_CODES)
+            {
+                prefix[next] = old;
+                suffix[next] = first;
+                next ++;
+                if (next == (1 << size) && size < 12)
+                    size ++;
+            }
+        }
+        old = in;
+
+        /* the string is in the reverse order on stack */
+        while (sp > stack && y < h)
+        {
+            code = *--sp;
+            if (line != RT_NULL && code != frame->transparent && code < frame->ncolors &&
+                    frame->rect.x1 + x < canvas->width)
+            {
+                const rt_uint8_t *c = frame->palette + code * 3;
+
+                line[frame->rect.x1 + x] = RTGUI_ARGB(255, c[0], c[1], c[2]);
+            }
+
+            if (++x == w)
+            {
+                x = 0;
+                y ++;
+                line = RT_NULL;
+                row = _gif_frame_row(frame, y);
+                if (y < h && row >= 0 && row < canvas->height)
+                    line = (rt_uint32_t *)(pixels + row * pitch);
+            }
+        }
+    }
+
+    rtgui_free(prefix);
+
+    return RT_TRUE;
+}
+
+/* the rect of canvas in pixels the frame covers */
+static void _gif_clip_rect(const struct rtgui_image_gif *gif, rtgui_rect_t *rect)
+{
+    struct rtgui_dc_buffer *canvas = (struct rtgui_dc_buffer *)gif->canvas;
+
+    if (rect->x2 > canvas->width) rect->x2 = canvas->width;
+    if (rect->y2 > canvas->height) rect->y2 = canvas->height;
+    if (rect->x1 > rect->x2) rect->x1 = rect->x2;
+    if (rect->y1 > rect->y2) rect->y1 = rect->y2;
+}
+
+/* copy the pixels of rect between canvas and the backup */
+static void _gif_backup(struct rtgui_image_gif *gif, const rtgui_rect_t *rect, rt_bool_t restore)
+{
+    int y, len;
+    rt_uint8_t *ptr;
+    rt_uint32_t *backup;
+    struct rtgui_dc_buffer *canvas = (struct rtgui_dc_buffer *)gif->canvas;
+
+    len = rtgui_rect_width(*rect) * sizeof(rt_uint32_t);
+    ptr = rtgui_dc_buffer_get_pixel(gif->canvas) + rect->y1 * canvas->pitch + rect->x1 * 4;
+    backup = gif->backup;
+    for (y = rect->y1; y < rect->y2; y ++, ptr += canvas->pitch, backup += rtgui_rect_width(*rect))
+    {
+        if (restore)
+            rt_memcpy(ptr, backup, len);
+        else
+            rt_memcpy(backup, ptr, len);
+    }
+}
+
+/* dispose the last frame, the rect disposed is in changed */
+static void _gif_dispose(struct rtgui_image_gif *gif, rtgui_rect_t *changed)
+{
+    rtgui_rect_t *r = &gif->last;
+
+    if (gif->dispose == GIF_DISPOSE_BACKGROUND)
+    {
+        /* the background is transparent, as the browsers do */
+        int y;
+        rt_uint8_t *ptr;
+        struct rtgui_dc_buffer *canvas = (struct rtgui_dc_buffer *)gif->canvas;
+
+        ptr = rtgui_dc_buffer_get_pixel(gif->canvas) + r->y1 * canvas->pitch + r->x1 * 4;
+        for (y = r->y1; y < r->y2; y ++, ptr += canvas->pitch)
+            rt_memset(ptr, 0, rtgui_rect_width(*r) * 4);
+        *changed = *r;
+    }
+    else if (gif->dispose == GIF_DISPOSE_PREVIOUS && gif->backup != RT_NULL)
+    {
+        _gif_backup(gif, r, RT_TRUE);
+        rtgui_free(gif->backup);
+        gif->backup = RT_NULL;
+        *changed = *r;
+    }
+    gif->dispose = GIF_DISPOSE_NONE;
+}
+
+/* restart from the first frame on the clear canvas */
+static void _gif_rewind(struct rtgui_image_gif *gif)
+{
+    struct rtgui_dc_buffer *canvas = (struct rtgui_dc_buffer *)gif->canvas;
+
+    rt_memset(rtgui_dc_buffer_get_pixel(gif->canvas), 0, canvas->pitch * canvas->height);
+    if (gif->backup != RT_NULL)
+    {
+        rtgui_free(gif->backup);
+        gif->backup = RT_NULL;
+    }
+    gif->dispose = GIF_DISPOSE_NONE;
+    gif->pos = gif->first;
+}
+
+/*
+ * Decode the next frame on canvas, the rect changed from the last frame is
+ * returned. At the end the GIF is rewound by the loops of it.
+ *
+ * @return the delay of frame in ms, -1 if there is no frame more.
+ */
+static rt_int32_t _gif_next(struct rtgui_image_gif *gif, rtgui_rect_t *changed)
+{
+    int length, rewound = 0;
+    rt_uint32_t pos;
+    const rt_uint8_t *ptr;
+    struct _gif_frame frame;
+    struct _gif_bits reader;
+    rtgui_rect_t rect;
+
+    rtgui_rect_init(changed, 0, 0, 0, 0);
+    frame.transparent = -1;
+    frame.dispose = GIF_DISPOSE_NONE;
+    frame.delay = 0;
+
+    pos = gif->pos;
+    while (pos < gif->size)
+    {
+        ptr = gif->data + pos;
+        if (ptr[0] == 0x21 && pos + 2 < gif->size)
+        {
+            /* the graphic control and NETSCAPE extensions, the others are skipped */
+            length = ptr[2];
+            if (ptr[1] == 0xf9 && length >= 4 && pos + 3 + length <= gif->size)
+            {
+                frame.dispose = (ptr[3] >> 2) & 0x07;
+                frame.delay = _gif_u16(&ptr[4]);
+                frame.transparent = (ptr[3] & 0x01) ? ptr[6] : -1;
+            }
+            else if (ptr[1] == 0xff && length == 11 && pos + 17 <= gif->size &&
+                     rt_memcmp(&ptr[3], "NETSCAPE2.0", 11) == 0 && ptr[14] >= 3 && ptr[15] == 1)
+            {
+                if (gif->loops < 0)
+                    gif->loops = _gif_u16(&ptr[16]);
+            }
+            pos = _gif_skip_blocks(gif, pos + 2);
+            if (pos == 0)
+                break;
+        }
+        else if (ptr[0] == 0x2c && pos + 10 < gif->size)
+        {
+            int left, top;
+
+            left = _gif_u16(&ptr[1]);
+            top = _gif_u16(&ptr[3]);
+            rtgui_rect_init(&frame.rect, left, top, _gif_u16(&ptr[5]), _gif_u16(&ptr[7]));
+            frame.interlace = (ptr[9] & 0x40) != 0;
+            frame.palette = gif->palette;
+            frame.ncolors = gif->ncolors;
+            pos += 10;
+            if (ptr[9] & 0x80)
+            {
+                frame.palette = gif->data + pos;
+                frame.ncolors = 2 << (ptr[9] & 0x07);
+                pos += frame.ncolors * 3;
+            }
+            if (pos >= gif->size || frame.palette == RT_NULL)
+                break;
+
+            _gif_dispose(gif, changed);
+            rect = frame.rect;
+            _gif_clip_rect(gif, &rect);
+            if (frame.dispose == GIF_DISPOSE_PREVIOUS && rect.x1 < rect.x2 && rect.y1 < rect.y2)
+            {
+                gif->backup = (rt_uint32_t *)rtgui_malloc(rtgui_rect_width(rect) *
+                              rtgui_rect_height(rect) * sizeof(rt_uint32_t));
+                if (gif->backup != RT_NULL)
+                    _gif_backup(gif, &rect, RT_FALSE);
+            }
+
+            reader.data = gif->data;
+            reader.size = gif->size;
+            reader.pos = pos + 1;
+            reader.block = 0;
+            reader.bits = 0;
+            reader.count = 0;
+            _gif_decode_frame(gif, &frame, gif->data[pos], &reader);
+
+            pos = _gif_skip_blocks(gif, pos + 1);
+            gif->pos = pos ? pos : gif->size;
+            gif->last = rect;
+            gif->dispose = frame.dispose;
+            if (!rtgui_rect_is_empty(&rect))
+                rtgui_rect_union(&rect, changed);
+
+            if (frame.delay < GIF_MIN_DELAY)
+                frame.delay = GIF_DEFAULT_DELAY;
+            return frame.delay * 10;
+        }
+        else
+        {
+            /* the trailer or corrupt data: loop by the NETSCAPE extension */
+            if (rewound || gif->pos == gif->first)
+                break;
+            if (gif->loops < 0 || (gif->loops > 0 && ++ gif->played > gif->loops))
+                break;
+
+            _gif_rewind(gif);
+            rtgui_rect_init(changed, 0, 0, ((struct rtgui_dc_buffer *)gif->canvas)->width,
+                            ((struct rtgui_dc_buffer *)gif->canvas)->height);
+            pos = gif->first;
+            rewound = 1;
+        }
+    }
+
+    gif->pos = gif->size;
+    return -1;
+}
+
+static rt_bool_t rtgui_image_gif_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+{
+    int size;
+    rt_uint8_t *copy = RT_NULL;
+    rtgui_rect_t changed;
+    struct rtgui_image_gif *gif;
+
+    gif = (struct rtgui_image_gif *)rtgui_malloc(sizeof(struct rtgui_image_gif));
+    if (gif == RT_NULL)
+        return RT_FALSE;
+    rt_memset(gif, 0, sizeof(struct rtgui_image_gif));
+    gif->loops = -1;
+
+    rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_END);
+    size = rtgui_filerw_tell(file);
+    if (size < 13)
+        goto __error;
+
+    /* the data in memory or flash is referenced in place */
+    gif->data = (const rt_uint8_t *)rtgui_filerw_map(file, 0, size);
+    if (gif->data != RT_NULL)
+    {
+        gif->filerw = file;
+    }
+    else
+    {
+        copy = (rt_uint8_t *)rtgui_malloc(size);
+        if (copy == RT_NULL)
+            goto __error;
+        rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET);
+        if (rtgui_filerw_read(file, copy, 1, size) != size)
+            goto __error;
+        gif->data = copy;
+    }
+    gif->size = size;
+    if (!_gif_is_header(gif->data))
+        goto __error;
+
+    image->w = _gif_u16(&gif->data[6]);
+    image->h = _gif_u16(&gif->data[8]);
+    gif->first = 13;
+    if (gif->data[10] & 0x80)
+    {
+        gif->palette = gif->data + 13;
+        gif->ncolors = 2 << (gif->data[10] & 0x07);
+        gif->first += gif->ncolors * 3;
+    }
+    gif->pos = gif->first;
+
+    gif->canvas = rtgui_dc_buffer_create_tag(RTGRAPHIC_PIXEL_FORMAT_ARGB888, image->w, image->h,
+                                             RTGUI_MEM_IMAGE);
+    if (gif->canvas == RT_NULL)
+        goto __error;
+    rt_memset(rtgui_dc_buffer_get_pixel(gif->canvas), 0,
+              ((struct rtgui_dc_buffer *)gif->canvas)->pitch * image->h);
+
+    image->engine = &rtgui_image_gif_engine;
+    image->data = gif;
+    /* the first frame is on the canvas for the blit */
+    gif->delay = _gif_next(gif, &changed);
+    if ((rt_int32_t)gif->delay < 0)
+        gif->delay = 0;
+
+    if (gif->filerw == RT_NULL)
+        rtgui_filerw_close(file);
+
+    return RT_TRUE;
+
+__error:
+    if (gif->canvas != RT_NULL)
+        rtgui_dc_destory(gif->canvas);
+    if (copy != RT_NULL)
+        rtgui_free(copy);
+    rtgui_free(gif);
+    return RT_FALSE;
+}
+
+static void rtgui_image_gif_unload(struct rtgui_image *image)
+{
+    struct rtgui_image_gif *gif;
+
+    if (image == RT_NULL || image->data == RT_NULL)
+        return;
+
+    gif = (struct rtgui_image_gif *)image->data;
+    rtgui_dc_destory(gif->canvas);
+    if (gif->backup != RT_NULL)
+        rtgui_free(gif->backup);
+    if (gif->filerw != RT_NULL)
+        rtgui_filerw_close(gif->filerw);
+    else
+        rtgui_free((void *)gif->data);
+    rtgui_free(gif);
+    image->data = RT_NULL;
+}
+
+static void rtgui_image_gif_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
+{
+    struct rtgui_image_gif *gif;
+    struct rtgui_point point = {0, 0};
+
+    RT_ASSERT(image != RT_NULL && dc != RT_NULL && rect != RT_NULL);
+
+    gif = (struct rtgui_image_gif *)image->data;
+    rtgui_dc_blit(gif->canvas, &point, dc, rect);
+}
+
+static rt_bool_t rtgui_image_gif_frame(struct rtgui_image *image, rt_bool_t next, struct rtgui_image_frame *frame)
+{
+    rt_int32_t delay;
+    struct rtgui_image_gif *gif = (struct rtgui_image_gif *)image->data;
+
+    frame->canvas = gif->canvas;
+    if (!next)
+    {
+        rtgui_rect_init(&frame->changed, 0, 0, image->w, image->h);
+        frame->delay = gif->delay;
+        return RT_TRUE;
+    }
+
+    delay = _gif_next(gif, &frame->changed);
+    if (delay < 0)
+        return RT_FALSE;
+    gif->delay = frame->delay = delay;
+
+    return RT_TRUE;
+}
+
+void rtgui_image_gif_init(void)
+{
+    /* register gif on image system */
+    rtgui_image_register_engine(&rtgui_image_gif_engine);
+}
+
+#endif
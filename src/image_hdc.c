@@ -21,6 +21,8 @@
  * Date           Author       Notes
  * 2010-09-15     Bernard      first version
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <rtthread.h>
 #include <rtgui/dc.h>
 #include <rtgui/image.h>
@@ -39,6 +41,9 @@ static rt_bool_t rtgui_image_hdc_load(struct rtgui_image *image, struct rtgui_fi
 static void rtgui_image_hdc_unload(struct rtgui_image *image);
 static void rtgui_image_hdc_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
 static void rtgui_image_hdcmm_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *dst_rect);
+static rt_bool_t rtgui_image_hdc_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info);
+static rt_bool_t rtgui_image_hdc_blit_ex(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect,
+                                         rt_uint8_t opacity, rtgui_color_t tint);
 
 struct rtgui_image_engine rtgui_image_hdc_engine =
 {
@@ -48,6 +53,12 @@ struct rtgui_image_engine rtgui_image_hdc_engine =
     rtgui_image_hdc_load,
     rtgui_image_hdc_unload,
     rtgui_image_hdc_blit,
+    rtgui_image_hdc_probe,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    rtgui_image_hdc_blit_ex,
 };
 
 const struct rtgui_image_engine rtgui_image_hdcmm_engine =
@@ -60,6 +71,26 @@ const struct rtgui_image_engine rtgui_image_hdcmm_engine =
     rtgui_image_hdcmm_blit,
 };
 
+static rt_bool_t rtgui_image_hdc_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info)
+{
+    rt_uint32_t header[5];
+
+    if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(file, (char *)&header, 1, sizeof(header)) != sizeof(header) ||
+            rt_memcmp(header, "HDC", HDC_MAGIC_LEN) != 0)
+        return RT_FALSE;
+
+    info->w = (rt_uint16_t)header[1];
+    info->h = (rt_uint16_t)header[2];
+    /* the pixel format is in the header since 1.x */
+    if (header[3] != 0)
+        info->has_alpha = header[4] == RTGRAPHIC_PIXEL_FORMAT_ARGB888 ||
+                          header[4] == RTGRAPHIC_PIXEL_FORMAT_ABGR888 ||
+                          header[4] == RTGRAPHIC_PIXEL_FORMAT_ARGB565;
+
+    return RT_TRUE;
+}
+
 static rt_bool_t rtgui_image_hdc_check(struct rtgui_filerw *file)
 {
     int start;
@@ -89,6 +120,141 @@ static rt_bool_t rtgui_image_hdc_check(struct rtgui_filerw *file)
     return (is_HDC);
 }
 
+/* read the band header and index of version 3 */
+static rt_bool_t _hdc_load_band_index(struct rtgui_image *image, struct rtgui_image_hdc *hdc)
+{
+    rt_size_t size;
+    struct rtgui_image_hdc_band band;
+
+    if (rtgui_filerw_read(hdc->filerw, &band, 1, sizeof(band)) != sizeof(band))
+        return RT_FALSE;
+    if (band.band_height == 0)
+        return RT_FALSE;
+#ifdef PKG_USING_FASTLZ
+    if (band.method != HDC_COMPRESS_FASTLZ && band.method != HDC_COMPRESS_RLE)
+#else
+    if (band.method != HDC_COMPRESS_RLE)
+#endif
+        return RT_FALSE;
+
+    size = ((image->h + band.band_height - 1) / band.band_height + 1) * sizeof(rt_uint32_t);
+    hdc->band_index = (rt_uint32_t *)rtgui_malloc(size);
+    if (hdc->band_index == RT_NULL)
+        return RT_FALSE;
+    if (rtgui_filerw_read(hdc->filerw, hdc->band_index, 1, size) != size)
+    {
+        rtgui_free(hdc->band_index);
+        hdc->band_index = RT_NULL;
+        return RT_FALSE;
+    }
+
+    hdc->method = band.method;
+    hdc->band_height = band.band_height;
+
+    return RT_TRUE;
+}
+
+/* decode a row of RLE into line, return the data of next row */
+static const rt_uint8_t *_hdc_rle_decode_row(const rt_uint8_t *src, const rt_uint8_t *end,
+                                             rt_uint8_t *line, int width, int bpp)
+{
+    int x, count;
+    rt_uint8_t ctrl;
+
+    for (x = 0; x < width; x += count)
+    {
+        if (src >= end) return RT_NULL;
+
+        ctrl = *src++;
+        count = (ctrl & 0x7f) + 1;
+        if (count > width - x) return RT_NULL;
+
+        if (ctrl & 0x80)
+        {
+            if (end - src < bpp) return RT_NULL;
+
+            /* the flat area of UI graphics */
+            if (bpp == 2)
+            {
+                rt_uint16_t pixel = src[0] | (src[1] << 8);
+                rt_uint16_t *ptr = (rt_uint16_t *)line;
+                int index;
+
+                for (index = 0; index < count; index ++) ptr[index] = pixel;
+            }
+            else
+            {
+                int index;
+
+                for (index = 0; index < count; index ++)
+                    rt_memcpy(line + index * bpp, src, bpp);
+            }
+            src += bpp;
+        }
+        else
+        {
+            if (end - src < count * bpp) return RT_NULL;
+
+            rt_memcpy(line, src, count * bpp);
+            src += count * bpp;
+        }
+        line += count * bpp;
+    }
+
+    return src;
+}
+
+/* read and decompress a band into the buffer, the data is the scratch of
+ * compressed band. Return the rows of band, or 0 on error */
+static int _hdc_load_band(struct rtgui_image *image, struct rtgui_image_hdc *hdc, int band,
+                          rt_uint8_t **data, rt_uint32_t *data_size, rt_uint8_t *buffer)
+{
+    int rows;
+    rt_uint32_t length;
+
+    rows = _UI_MIN(hdc->band_height, image->h - band * hdc->band_height);
+    length = hdc->band_index[band + 1] - hdc->band_index[band];
+    if (hdc->band_index[band + 1] < hdc->band_index[band])
+        return 0;
+
+    if (length > *data_size)
+    {
+        rt_uint8_t *ptr = (rt_uint8_t *)rtgui_realloc(*data, length);
+
+        if (ptr == RT_NULL) return 0;
+        *data = ptr;
+        *data_size = length;
+    }
+
+    if (rtgui_filerw_seek(hdc->filerw, hdc->band_index[band], RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(hdc->filerw, *data, 1, length) != length)
+        return 0;
+
+#ifdef PKG_USING_FASTLZ
+    if (hdc->method == HDC_COMPRESS_FASTLZ)
+    {
+        if (fastlz_decompress(*data, length, buffer, rows * hdc->pitch) != rows * hdc->pitch)
+            return 0;
+
+        return rows;
+    }
+#endif
+
+    {
+        int row;
+        const rt_uint8_t *src = *data;
+
+        for (row = 0; row < rows; row ++)
+        {
+            src = _hdc_rle_decode_row(src, *data + length, buffer + row * hdc->pitch,
+                                      image->w, hdc->byte_per_pixel);
+            if (src == RT_NULL) return 0;
+        }
+    }
+
+    return rows;
+}
+
 static rt_bool_t rtgui_image_hdc_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
 {
     rt_uint32_t header[5];
@@ -96,6 +262,8 @@ static rt_bool_t rtgui_image_hdc_load(struct rtgui_image *image, struct rtgui_fi
 
     hdc = (struct rtgui_image_hdc *) rtgui_malloc(sizeof(struct rtgui_image_hdc));
     if (hdc == RT_NULL) return RT_FALSE;
+    hdc->band_index = RT_NULL;
+    hdc->is_mapped = RT_FALSE;
 
     rtgui_filerw_read(file, (char *)&header, 1, sizeof(header));
 
@@ -116,19 +284,70 @@ static rt_bool_t rtgui_image_hdc_load(struct rtgui_image *image, struct rtgui_fi
         /* 1.x version */
         hdc->pixel_format = header[4];
     }
-    else if (header[3] == 2)
+    else if (header[3] == 2 || header[3] == 3)
     {
-        /* 2.x version */
+        /* 2.x version, and 3.x version compressed in bands */
         hdc->pixel_format = header[4];
     }
 
     hdc->byte_per_pixel = rtgui_color_get_bpp(hdc->pixel_format);
     hdc->pitch = image->w * hdc->byte_per_pixel;
+    if (header[3] == 3 && _hdc_load_band_index(image, hdc) != RT_TRUE)
+    {
+        rtgui_free(hdc);
+        return RT_FALSE;
+    }
     hdc->pixel_offset = rtgui_filerw_tell(file);
 
-    if (load == RT_TRUE)
+    /* the image not compressed in memory is used in place, without copying */
+    if (header[3] < 2 && rtgui_filerw_mem_getdata(file) != RT_NULL &&
+            rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_END) >= hdc->pixel_offset + image->h * hdc->pitch)
+    {
+        hdc->pixels = (rt_uint8_t *)rtgui_filerw_mem_getdata(file) + hdc->pixel_offset;
+        hdc->is_mapped = RT_TRUE;
+        rtgui_filerw_close(hdc->filerw);
+        hdc->filerw = RT_NULL;
+        hdc->pixel_offset = 0;
+    }
+    else if (load == RT_TRUE)
     {
-        if (header[3] == 2)
+        if (header[3] == 3)
+        {
+            int band;
+            rt_uint8_t *data = RT_NULL;
+            rt_uint32_t data_size = 0;
+
+            hdc->pixels = (rt_uint8_t *)rtgui_malloc(image->h * hdc->pitch);
+            if (hdc->pixels == RT_NULL)
+            {
+                rtgui_free(hdc->band_index);
+                rtgui_free(hdc);
+                return RT_FALSE;
+            }
+
+            for (band = 0; band * hdc->band_height < image->h; band ++)
+            {
+                if (_hdc_load_band(image, hdc, band, &data, &data_size,
+                                   hdc->pixels + band * hdc->band_height * hdc->pitch) == 0)
+                    break;
+            }
+            if (data != RT_NULL) rtgui_free(data);
+            rtgui_free(hdc->band_index);
+            hdc->band_index = RT_NULL;
+
+            if (band * hdc->band_height < image->h)
+            {
+                /* release data */
+                rtgui_free(hdc->pixels);
+                rtgui_free(hdc);
+                return RT_FALSE;
+            }
+
+            rtgui_filerw_close(hdc->filerw);
+            hdc->filerw = RT_NULL;
+            hdc->pixel_offset = 0;
+        }
+        else if (header[3] == 2)
         {
 #ifdef PKG_USING_FASTLZ
             /* TODO: add HDC with fastlz compressed */
@@ -214,8 +433,10 @@ static void rtgui_image_hdc_unload(struct rtgui_image *image)
     {
         hdc = (struct rtgui_image_hdc *) image->data;
 
-        if (hdc->pixels != RT_NULL)
+        if (hdc->pixels != RT_NULL && hdc->is_mapped == RT_FALSE)
             rtgui_free(hdc->pixels);
+        if (hdc->band_index != RT_NULL)
+            rtgui_free(hdc->band_index);
         if (hdc->filerw != RT_NULL)
             rtgui_filerw_close(hdc->filerw);
 
@@ -224,9 +445,54 @@ static void rtgui_image_hdc_unload(struct rtgui_image *image)
     }
 }
 
-static void rtgui_image_hdc_blit(struct rtgui_image *image,
-                                 struct rtgui_dc *dc,
-                                 struct rtgui_rect *dst_rect)
+/* blit the image compressed in bands, only the visible bands are decoded */
+static void _hdc_blit_bands(struct rtgui_image *image, struct rtgui_image_hdc *hdc,
+                            struct rtgui_dc *dc, struct rtgui_rect *dst_rect,
+                            int xoff, int yoff, int w, int h)
+{
+    int y, y1, y2, band, rows;
+    rt_uint8_t *data, *buffer;
+    rt_uint32_t data_size;
+    struct rtgui_rect rect;
+
+    /* the rows of image in the visible part of dc */
+    rtgui_dc_get_rect(dc, &rect);
+    y1 = _UI_MAX(rect.y1, dst_rect->y1) - dst_rect->y1 + yoff;
+    y2 = _UI_MIN(rect.y2, dst_rect->y1 + h) - dst_rect->y1 + yoff;
+    if (y1 >= y2) return;
+
+    buffer = (rt_uint8_t *)rtgui_malloc(hdc->band_height * hdc->pitch);
+    if (buffer == RT_NULL)
+        return; /* no memory */
+
+    data = RT_NULL;
+    data_size = 0;
+    for (band = y1 / hdc->band_height; band * hdc->band_height < y2; band ++)
+    {
+        rows = _hdc_load_band(image, hdc, band, &data, &data_size, buffer);
+        if (rows == 0)
+            break; /* read data failed */
+
+        y = _UI_MAX(y1, band * hdc->band_height);
+        rows = _UI_MIN(y2, band * hdc->band_height + rows);
+        for (; y < rows; y ++)
+        {
+            dc->engine->blit_line(dc,
+                                  dst_rect->x1,
+                                  dst_rect->x1 + w,
+                                  dst_rect->y1 + y - yoff,
+                                  buffer + (y - band * hdc->band_height) * hdc->pitch +
+                                  xoff * hdc->byte_per_pixel);
+        }
+    }
+
+    if (data != RT_NULL) rtgui_free(data);
+    rtgui_free(buffer);
+}
+
+/* the opacity and tint are only in the blit of the pixels in memory */
+static void _hdc_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *dst_rect,
+                      rt_uint8_t opacity, rtgui_color_t tint)
 {
     rt_int16_t y, w, h, xoff, yoff;
     struct rtgui_image_hdc *hdc;
@@ -273,7 +539,8 @@ static void rtgui_image_hdc_blit(struct rtgui_image *image,
     {
         struct rtgui_image_info info;
         struct rtgui_rect dest = *dst_rect;
-        info.a = 255;
+        info.a = opacity;
+        info.tint = tint;
         info.pixels = hdc->pixels + hdc->pitch * yoff + hdc->byte_per_pixel * xoff;
         info.src_fmt = hdc->pixel_format;
         info.src_pitch = hdc->pitch;
@@ -283,37 +550,69 @@ static void rtgui_image_hdc_blit(struct rtgui_image *image,
 
         rtgui_image_info_blit(&info, dc, &dest);
     }
+    else if (hdc->band_index != RT_NULL)
+    {
+        _hdc_blit_bands(image, hdc, dc, dst_rect, xoff, yoff, w, h);
+    }
     else
     {
-        rt_uint8_t *ptr;
-        ptr = rtgui_malloc(hdc->byte_per_pixel * w);
-        if (ptr == RT_NULL)
-            return; /* no memory */
-
-        /* seek to the begin of pixel data */
-        rtgui_filerw_seek(hdc->filerw,
-                          hdc->pixel_offset + hdc->pitch * yoff + hdc->byte_per_pixel * xoff,
-                          RTGUI_FILE_SEEK_SET);
+        rt_off_t offset;
+        rt_uint8_t *ptr = RT_NULL;
+        const rt_uint8_t *line;
 
         for (y = 0; y < h; y ++)
         {
-            /* read pixel data */
-            if (rtgui_filerw_read(hdc->filerw, ptr, 1,
-                                  hdc->byte_per_pixel * w) != hdc->byte_per_pixel * w)
-                break; /* read data failed */
+            offset = hdc->pixel_offset + hdc->pitch * (yoff + y) + hdc->byte_per_pixel * xoff;
+
+            /* the line in place, or read in the pixel buffer */
+            line = (const rt_uint8_t *)rtgui_filerw_map(hdc->filerw, offset, hdc->byte_per_pixel * w);
+            if (line == RT_NULL)
+            {
+                if (ptr == RT_NULL)
+                {
+                    ptr = rtgui_malloc(hdc->byte_per_pixel * w);
+                    if (ptr == RT_NULL)
+                        return; /* no memory */
+                }
+
+                if (rtgui_filerw_seek(hdc->filerw, offset, RTGUI_FILE_SEEK_SET) < 0 ||
+                        rtgui_filerw_read(hdc->filerw, ptr, 1,
+                                          hdc->byte_per_pixel * w) != hdc->byte_per_pixel * w)
+                    break; /* read data failed */
+                line = ptr;
+            }
 
             dc->engine->blit_line(dc,
                                   dst_rect->x1,
                                   dst_rect->x1 + w,
                                   dst_rect->y1 + y,
-                                  ptr);
-            rtgui_filerw_seek(hdc->filerw, hdc->byte_per_pixel * xoff, RTGUI_FILE_SEEK_CUR);
+                                  (rt_uint8_t *)line);
         }
 
-        rtgui_free(ptr);
+        if (ptr != RT_NULL)
+            rtgui_free(ptr);
     }
 }
 
+static void rtgui_image_hdc_blit(struct rtgui_image *image,
+                                 struct rtgui_dc *dc,
+                                 struct rtgui_rect *dst_rect)
+{
+    _hdc_blit(image, dc, dst_rect, 255, RTGUI_BLIT_NO_TINT);
+}
+
+static rt_bool_t rtgui_image_hdc_blit_ex(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect,
+                                         rt_uint8_t opacity, rtgui_color_t tint)
+{
+    struct rtgui_image_hdc *hdc = (struct rtgui_image_hdc *)image->data;
+
+    if (hdc == RT_NULL || hdc->pixels == RT_NULL)
+        return RT_FALSE;
+
+    _hdc_blit(image, dc, rect, opacity, tint);
+    return RT_TRUE;
+}
+
 static void rtgui_image_hdcmm_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *dst_rect)
 {
     rt_uint8_t *ptr;
@@ -22,10 +22,65 @@
  * 2010-09-15     Bernard      first version
  * 2012-01-24     onelife      add TJpgDec (Tiny JPEG Decompressor) support
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <rtthread.h>
 #include <rtgui/rtgui.h>
 #include <rtgui/image.h>
 
+#if defined(GUIENGINE_IMAGE_JPEG) || defined(GUIENGINE_IMAGE_TJPGD)
+/* the size in the frame header (SOFn), the markers before it are skipped */
+static rt_bool_t rtgui_image_jpeg_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info)
+{
+    int index;
+    rt_uint8_t marker, buffer[5];
+
+    if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(file, buffer, 1, 2) != 2 ||
+            buffer[0] != 0xff || buffer[1] != 0xd8)
+        return RT_FALSE;
+
+    for (index = 0; index < 64; index ++)
+    {
+        if (rtgui_filerw_read(file, buffer, 1, 2) != 2 || buffer[0] != 0xff)
+            return RT_FALSE;
+
+        marker = buffer[1];
+        if (marker == 0xff)
+        {
+            /* the fill byte */
+            rtgui_filerw_seek(file, -1, RTGUI_FILE_SEEK_CUR);
+            continue;
+        }
+        /* the markers without length */
+        if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7))
+            continue;
+        /* the end of image or the scan before frame */
+        if (marker == 0xd9 || marker == 0xda)
+            return RT_FALSE;
+
+        if (rtgui_filerw_read(file, buffer, 1, 2) != 2)
+            return RT_FALSE;
+
+        if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc)
+        {
+            /* the precision, height and width */
+            if (rtgui_filerw_read(file, buffer, 1, 5) != 5)
+                return RT_FALSE;
+
+            info->h = (buffer[1] << 8) | buffer[2];
+            info->w = (buffer[3] << 8) | buffer[4];
+            return RT_TRUE;
+        }
+
+        if (rtgui_filerw_seek(file, ((buffer[0] << 8) | buffer[1]) - 2, RTGUI_FILE_SEEK_CUR) < 0)
+            return RT_FALSE;
+    }
+
+    return RT_FALSE;
+}
+#endif
+
 #ifdef GUIENGINE_IMAGE_JPEG
 #include <stdio.h>
 #include <stdlib.h>
@@ -43,6 +98,9 @@ static rt_bool_t rtgui_image_jpeg_check(struct rtgui_filerw *file);
 static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load);
 static void rtgui_image_jpeg_unload(struct rtgui_image *image);
 static void rtgui_image_jpeg_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
+static rt_bool_t rtgui_image_jpeg_stream_begin(struct rtgui_image_stream *stream);
+static rt_err_t rtgui_image_jpeg_stream_feed(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length);
+static void rtgui_image_jpeg_stream_end(struct rtgui_image_stream *stream);
 
 struct rtgui_jpeg_error_mgr
 {
@@ -59,10 +117,18 @@ struct rtgui_image_jpeg
     struct jpeg_decompress_struct cinfo;
     struct rtgui_jpeg_error_mgr errmgr;
 
+    /* the pixels in ARGB888, or RGB565 decoded by libjpeg-turbo */
+    rt_uint8_t format;
+    int pitch;
+    JSAMPARRAY row;
+
     rt_uint8_t *pixels;
     rt_uint8_t *line_pixels;
 };
 
+/* the profile of the images loaded, except the ones of rtgui_image_jpeg_create */
+static int _jpeg_profile = GUIENGINE_IMAGE_JPEG_PROFILE;
+
 struct rtgui_image_engine rtgui_image_jpeg_engine =
 {
     "jpeg",
@@ -70,7 +136,11 @@ struct rtgui_image_engine rtgui_image_jpeg_engine =
     rtgui_image_jpeg_check,
     rtgui_image_jpeg_load,
     rtgui_image_jpeg_unload,
-    rtgui_image_jpeg_blit
+    rtgui_image_jpeg_blit,
+    rtgui_image_jpeg_probe,
+    rtgui_image_jpeg_stream_begin,
+    rtgui_image_jpeg_stream_feed,
+    rtgui_image_jpeg_stream_end,
 };
 
 struct rtgui_image_engine rtgui_image_jpg_engine =
@@ -80,7 +150,11 @@ struct rtgui_image_engine rtgui_image_jpg_engine =
     rtgui_image_jpeg_check,
     rtgui_image_jpeg_load,
     rtgui_image_jpeg_unload,
-    rtgui_image_jpeg_blit
+    rtgui_image_jpeg_blit,
+    rtgui_image_jpeg_probe,
+    rtgui_image_jpeg_stream_begin,
+    rtgui_image_jpeg_stream_feed,
+    rtgui_image_jpeg_stream_end,
 };
 
 #define INPUT_BUFFER_SIZE   4096
@@ -205,14 +279,81 @@ static void rtgui_jpeg_filerw_src_init(j_decompress_ptr cinfo, struct rtgui_file
     src->pub.next_input_byte = NULL; /* until buffer loaded */
 }
 
+/*
+ * Set the decompression of the profile, after the header is read. The DCT
+ * scaling is the smallest one still covers width x height, if they are not 0.
+ * The dither is only in the RGB565 output of libjpeg-turbo.
+ */
+static void _jpeg_setup(j_decompress_ptr cinfo, int profile, int width, int height, rt_bool_t rgb565)
+{
+    unsigned int denom;
+
+    cinfo->out_color_space = JCS_RGB;
+#ifdef GUIENGINE_IMAGE_JPEG_RGB565
+    if (rgb565 == RT_TRUE)
+        cinfo->out_color_space = JCS_RGB565;
+#endif
+    cinfo->quantize_colors = FALSE;
+
+    denom = 1;
+    if (width > 0 && height > 0)
+    {
+        while (denom < 8 &&
+                cinfo->image_width / (denom * 2) >= (unsigned int)width &&
+                cinfo->image_height / (denom * 2) >= (unsigned int)height)
+            denom <<= 1;
+    }
+    cinfo->scale_num   = 1;
+    cinfo->scale_denom = denom;
+
+    switch (profile)
+    {
+    case RTGUI_JPEG_PROFILE_QUALITY:
+        cinfo->dct_method = JDCT_ISLOW;
+        cinfo->do_fancy_upsampling = TRUE;
+        cinfo->do_block_smoothing = TRUE;
+        cinfo->dither_mode = JDITHER_ORDERED;
+        break;
+    case RTGUI_JPEG_PROFILE_BALANCED:
+        cinfo->dct_method = JDCT_IFAST;
+        cinfo->do_fancy_upsampling = TRUE;
+        cinfo->do_block_smoothing = FALSE;
+        cinfo->dither_mode = JDITHER_ORDERED;
+        break;
+    default:
+        cinfo->dct_method = JDCT_FASTEST;
+        cinfo->do_fancy_upsampling = FALSE;
+        cinfo->do_block_smoothing = FALSE;
+        cinfo->dither_mode = JDITHER_NONE;
+        break;
+    }
+}
+
+/* decode a line into the pixels of format */
+static void _jpeg_read_row(struct rtgui_image_jpeg *jpeg, rt_uint8_t *dst)
+{
+    JDIMENSION index;
+    JSAMPROW row;
+    rtgui_color_t *ptr;
+
+    if (jpeg->format != RTGRAPHIC_PIXEL_FORMAT_ARGB888)
+    {
+        /* the RGB565 is decoded in place */
+        row = (JSAMPROW)dst;
+        jpeg_read_scanlines(&jpeg->cinfo, &row, 1);
+        return;
+    }
+
+    jpeg_read_scanlines(&jpeg->cinfo, jpeg->row, 1);
+    ptr = (rtgui_color_t *)dst;
+    for (index = 0; index < jpeg->cinfo.output_width; index ++)
+        ptr[index] = RTGUI_RGB(jpeg->row[0][index * 3], jpeg->row[0][index * 3 + 1], jpeg->row[0][index * 3 + 2]);
+}
+
 /* get line data of a jpeg image */
 static rt_uint8_t *rtgui_image_get_line(struct rtgui_image *image, int h)
 {
     struct rtgui_image_jpeg *jpeg;
-    rt_uint8_t *result_ptr;
-
-    JSAMPARRAY buffer;      /* Output row buffer */
-    int row_stride;
 
     RT_ASSERT(image != RT_NULL);
     jpeg = (struct rtgui_image_jpeg *) image->data;
@@ -222,32 +363,16 @@ static rt_uint8_t *rtgui_image_get_line(struct rtgui_image *image, int h)
 
     /* if the image is loaded, */
     if (jpeg->is_loaded == RT_TRUE)
-    {
-        result_ptr = jpeg->pixels + (image->w * sizeof(rtgui_color_t)) * h;
-
-        return result_ptr;
-    }
+        return jpeg->pixels + jpeg->pitch * h;
 
     if (jpeg->line_pixels == RT_NULL)
-        jpeg->line_pixels = rtgui_malloc(image->w * sizeof(rtgui_color_t));
-
-    row_stride = jpeg->cinfo.output_width * jpeg->cinfo.output_components;
-    buffer = (*jpeg->cinfo.mem->alloc_sarray)
-             ((j_common_ptr) &jpeg->cinfo, JPOOL_IMAGE, row_stride, 1);
+        jpeg->line_pixels = rtgui_malloc(jpeg->pitch);
+    if (jpeg->line_pixels == RT_NULL)
+        return RT_NULL;
 
     /* decompress line data */
     jpeg->cinfo.output_scanline = h;
-    jpeg_read_scanlines(&jpeg->cinfo, buffer, (JDIMENSION) 1);
-
-    /* copy pixels memory */
-    {
-        int index;
-        rtgui_color_t *ptr;
-
-        ptr = (rtgui_color_t *)jpeg->line_pixels;
-        for (index = 0; index < image->w; index ++)
-            ptr[index] = RTGUI_ARGB(0, buffer[0][index * 3], buffer[0][index * 3 + 1], buffer[0][index * 3 + 2]);
-    }
+    _jpeg_read_row(jpeg, jpeg->line_pixels);
 
     return jpeg->line_pixels;
 }
@@ -256,8 +381,6 @@ static rt_bool_t rtgui_image_jpeg_loadall(struct rtgui_image *image)
 {
     struct rtgui_image_jpeg *jpeg;
     rt_uint8_t *line_ptr;
-    JSAMPARRAY buffer;      /* Output row buffer */
-    int row_stride;
 
     jpeg = (struct rtgui_image_jpeg *) image->data;
     RT_ASSERT(jpeg != RT_NULL);
@@ -266,38 +389,20 @@ static rt_bool_t rtgui_image_jpeg_loadall(struct rtgui_image *image)
     if (jpeg->pixels != RT_NULL) return RT_TRUE;
 
     /* allocate all pixels */
-    jpeg->pixels = rtgui_malloc(image->h * image->w * sizeof(rtgui_color_t));
+    jpeg->pixels = rtgui_malloc(image->h * jpeg->pitch);
     if (jpeg->pixels == RT_NULL) return RT_FALSE;
 
     /* reset scan line to zero */
     jpeg->cinfo.output_scanline = 0;
     line_ptr = jpeg->pixels;
 
-    row_stride = jpeg->cinfo.output_width * jpeg->cinfo.output_components;
-    buffer = (*jpeg->cinfo.mem->alloc_sarray)
-             ((j_common_ptr) &jpeg->cinfo, JPOOL_IMAGE, row_stride, 1);
-
     /* decompress all pixels */
     while (jpeg->cinfo.output_scanline < jpeg->cinfo.output_height)
     {
-        /* jpeg_read_scanlines expects an array of pointers to scanlines.
-        * Here the array is only one element long, but you could ask for
-        * more than one scanline at a time if that's more convenient.
-        */
-        (void) jpeg_read_scanlines(&jpeg->cinfo, buffer, 1);
-
-        /* copy pixels memory */
-        {
-            int index;
-            rtgui_color_t *ptr;
-
-            ptr = (rtgui_color_t *)line_ptr;
-            for (index = 0; index < image->w; index ++)
-                ptr[index] = RTGUI_ARGB(0, buffer[0][index * 3], buffer[0][index * 3 + 1], buffer[0][index * 3 + 2]);
-        }
+        _jpeg_read_row(jpeg, line_ptr);
 
         /* move to next line */
-        line_ptr += image->w * sizeof(rtgui_color_t);
+        line_ptr += jpeg->pitch;
     }
 
     /* decompress done */
@@ -308,6 +413,13 @@ static rt_bool_t rtgui_image_jpeg_loadall(struct rtgui_image *image)
     return RT_TRUE;
 }
 
+/* set the profile of the images loaded after it */
+void rtgui_image_jpeg_set_profile(enum rtgui_jpeg_profile profile)
+{
+    _jpeg_profile = profile;
+}
+RTM_EXPORT(rtgui_image_jpeg_set_profile);
+
 void rtgui_image_jpeg_init()
 {
     /* register jpeg on image system */
@@ -325,9 +437,229 @@ static void output_no_message(j_common_ptr cinfo)
     /* do nothing */
 }
 
-static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+/*
+ * The stream decoder with a suspending source: fill_input_buffer returns
+ * FALSE when the data fed is consumed, then jpeg_read_header, start or
+ * read_scanlines returns and resumes in the next feed. The bytes not consumed
+ * are kept for it.
+ */
+enum
+{
+    JPEG_STREAM_HEADER,
+    JPEG_STREAM_START,
+    JPEG_STREAM_SCAN,
+    JPEG_STREAM_FINISH,
+};
+
+struct rtgui_jpeg_stream_error_mgr
+{
+    struct jpeg_error_mgr pub;
+    rt_bool_t failed;
+};
+
+struct rtgui_image_jpeg_stream
+{
+    struct jpeg_decompress_struct cinfo;
+    struct rtgui_jpeg_stream_error_mgr errmgr;
+    struct jpeg_source_mgr src;
+
+    int state;
+    JSAMPARRAY row;
+
+    /* the data not consumed */
+    rt_uint8_t *buffer;
+    rt_size_t size;
+    /* the bytes skipped beyond the data fed */
+    long skip;
+};
+
+static boolean _jpeg_stream_fill(j_decompress_ptr cinfo)
+{
+    /* suspend the decoder until the next feed */
+    return FALSE;
+}
+
+static void _jpeg_stream_skip(j_decompress_ptr cinfo, long num_bytes)
+{
+    struct rtgui_image_jpeg_stream *jpeg;
+
+    jpeg = (struct rtgui_image_jpeg_stream *)cinfo->client_data;
+    if (num_bytes <= 0)
+        return;
+
+    if (num_bytes > (long)jpeg->src.bytes_in_buffer)
+    {
+        jpeg->skip = num_bytes - (long)jpeg->src.bytes_in_buffer;
+        jpeg->src.next_input_byte += jpeg->src.bytes_in_buffer;
+        jpeg->src.bytes_in_buffer = 0;
+    }
+    else
+    {
+        jpeg->src.next_input_byte += (size_t)num_bytes;
+        jpeg->src.bytes_in_buffer -= (size_t)num_bytes;
+    }
+}
+
+static void _jpeg_stream_error_exit(j_common_ptr cinfo)
+{
+    ((struct rtgui_jpeg_stream_error_mgr *)cinfo->err)->failed = RT_TRUE;
+}
+
+static rt_bool_t rtgui_image_jpeg_stream_begin(struct rtgui_image_stream *stream)
 {
+    struct rtgui_image_jpeg_stream *jpeg;
+
+    jpeg = (struct rtgui_image_jpeg_stream *)rtgui_malloc(sizeof(struct rtgui_image_jpeg_stream));
+    if (jpeg == RT_NULL) return RT_FALSE;
+
+    jpeg->cinfo.err = jpeg_std_error(&jpeg->errmgr.pub);
+    jpeg->errmgr.pub.error_exit = _jpeg_stream_error_exit;
+    jpeg->errmgr.pub.output_message = output_no_message;
+    jpeg->errmgr.failed = RT_FALSE;
+    jpeg_create_decompress(&jpeg->cinfo);
+    jpeg->cinfo.client_data = jpeg;
+
+    jpeg->src.init_source = init_source;
+    jpeg->src.fill_input_buffer = _jpeg_stream_fill;
+    jpeg->src.skip_input_data = _jpeg_stream_skip;
+    jpeg->src.resync_to_restart = jpeg_resync_to_restart;
+    jpeg->src.term_source = term_source;
+    jpeg->src.next_input_byte = RT_NULL;
+    jpeg->src.bytes_in_buffer = 0;
+    jpeg->cinfo.src = &jpeg->src;
+
+    jpeg->state = JPEG_STREAM_HEADER;
+    jpeg->row = RT_NULL;
+    jpeg->buffer = RT_NULL;
+    jpeg->size = 0;
+    jpeg->skip = 0;
+    stream->data = jpeg;
+
+    return RT_TRUE;
+}
+
+/* append the data to the bytes not consumed */
+static rt_bool_t _jpeg_stream_append(struct rtgui_image_jpeg_stream *jpeg, const rt_uint8_t *data, rt_size_t length)
+{
+    rt_size_t remain;
+    rt_uint8_t *buffer;
+
+    if (jpeg->skip > 0)
+    {
+        remain = (rt_size_t)jpeg->skip < length ? (rt_size_t)jpeg->skip : length;
+        jpeg->skip -= remain;
+        data += remain;
+        length -= remain;
+    }
+
+    remain = jpeg->src.bytes_in_buffer;
+    if (remain > 0 && jpeg->src.next_input_byte != jpeg->buffer)
+        rt_memmove(jpeg->buffer, jpeg->src.next_input_byte, remain);
+    if (remain + length > jpeg->size)
+    {
+        buffer = (rt_uint8_t *)rtgui_realloc(jpeg->buffer, remain + length);
+        if (buffer == RT_NULL)
+            return RT_FALSE;
+        jpeg->buffer = buffer;
+        jpeg->size = remain + length;
+    }
+    rt_memcpy(jpeg->buffer + remain, data, length);
+
+    jpeg->src.next_input_byte = jpeg->buffer;
+    jpeg->src.bytes_in_buffer = remain + length;
+
+    return RT_TRUE;
+}
+
+static rt_err_t rtgui_image_jpeg_stream_feed(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length)
+{
+    int x, y;
+    rtgui_color_t *ptr;
+    struct rtgui_dc_buffer *buffer;
+    struct rtgui_image_jpeg_stream *jpeg;
+
+    jpeg = (struct rtgui_image_jpeg_stream *)stream->data;
+    if (jpeg->errmgr.failed == RT_TRUE)
+        return -RT_ERROR;
+    if (_jpeg_stream_append(jpeg, data, length) != RT_TRUE)
+        return -RT_ENOMEM;
+
+    switch (jpeg->state)
+    {
+    case JPEG_STREAM_HEADER:
+        if (jpeg_read_header(&jpeg->cinfo, TRUE) == JPEG_SUSPENDED)
+            break;
+        if (jpeg->errmgr.failed == RT_TRUE)
+            return -RT_ERROR;
+
+        /* the stream is decoded in the ARGB888 dc in full size */
+        _jpeg_setup(&jpeg->cinfo, _jpeg_profile, 0, 0, RT_FALSE);
+        if (rtgui_image_stream_set_size(stream, jpeg->cinfo.image_width,
+                                        jpeg->cinfo.image_height) != RT_TRUE)
+            return -RT_ENOMEM;
+        jpeg->state = JPEG_STREAM_START;
+        /* fall through */
+
+    case JPEG_STREAM_START:
+        /* a progressive jpeg is buffered in it until all the scans come */
+        if (jpeg_start_decompress(&jpeg->cinfo) == FALSE)
+            break;
+        if (jpeg->errmgr.failed == RT_TRUE)
+            return -RT_ERROR;
+
+        jpeg->row = (*jpeg->cinfo.mem->alloc_sarray)((j_common_ptr) &jpeg->cinfo, JPOOL_IMAGE,
+                    jpeg->cinfo.output_width * jpeg->cinfo.output_components, 1);
+        jpeg->state = JPEG_STREAM_SCAN;
+        /* fall through */
+
+    case JPEG_STREAM_SCAN:
+        buffer = (struct rtgui_dc_buffer *)stream->dc;
+        y = jpeg->cinfo.output_scanline;
+        while (jpeg->cinfo.output_scanline < jpeg->cinfo.output_height &&
+                jpeg->cinfo.output_scanline < stream->h)
+        {
+            ptr = (rtgui_color_t *)(buffer->pixel + jpeg->cinfo.output_scanline * buffer->pitch);
+            if (jpeg_read_scanlines(&jpeg->cinfo, jpeg->row, 1) != 1)
+                break;
+
+            for (x = 0; x < stream->w; x ++)
+                ptr[x] = RTGUI_RGB(jpeg->row[0][x * 3], jpeg->row[0][x * 3 + 1], jpeg->row[0][x * 3 + 2]);
+        }
+        if (jpeg->errmgr.failed == RT_TRUE)
+            return -RT_ERROR;
+        rtgui_image_stream_update(stream, y, jpeg->cinfo.output_scanline);
+
+        if (jpeg->cinfo.output_scanline < jpeg->cinfo.output_height)
+            break;
+        jpeg->state = JPEG_STREAM_FINISH;
+        /* fall through */
+
+    case JPEG_STREAM_FINISH:
+        if (jpeg_finish_decompress(&jpeg->cinfo) == TRUE)
+            stream->done = RT_TRUE;
+        break;
+    }
+
+    return jpeg->errmgr.failed == RT_TRUE ? -RT_ERROR : RT_EOK;
+}
+
+static void rtgui_image_jpeg_stream_end(struct rtgui_image_stream *stream)
+{
+    struct rtgui_image_jpeg_stream *jpeg;
+
+    jpeg = (struct rtgui_image_jpeg_stream *)stream->data;
+    jpeg_destroy_decompress(&jpeg->cinfo);
+    if (jpeg->buffer != RT_NULL)
+        rtgui_free(jpeg->buffer);
+    rtgui_free(jpeg);
+}
+
+static rt_bool_t _jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load,
+                            int profile, int width, int height)
+{
+    rt_bool_t rgb565;
     struct rtgui_image_jpeg *jpeg;
+    struct rtgui_graphic_driver *driver;
 
     jpeg = (struct rtgui_image_jpeg *) rtgui_malloc(sizeof(struct rtgui_image_jpeg));
     if (jpeg == RT_NULL) return RT_FALSE;
@@ -344,29 +676,37 @@ static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_f
     rtgui_jpeg_filerw_src_init(&jpeg->cinfo, jpeg->filerw);
     (void)jpeg_read_header(&jpeg->cinfo, TRUE);
 
-    image->w = jpeg->cinfo.image_width;
-    image->h = jpeg->cinfo.image_height;
+    /* decode to RGB565 for the panel of RGB565 */
+    driver = rtgui_graphic_driver_get_default();
+    rgb565 = (driver != RT_NULL && driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565) ?
+             RT_TRUE : RT_FALSE;
+    _jpeg_setup(&jpeg->cinfo, profile, width, height, rgb565);
+    jpeg->format = RTGRAPHIC_PIXEL_FORMAT_ARGB888;
+#ifdef GUIENGINE_IMAGE_JPEG_RGB565
+    if (jpeg->cinfo.out_color_space == JCS_RGB565)
+        jpeg->format = RTGRAPHIC_PIXEL_FORMAT_RGB565;
+#endif
+
+    /* start decompression, the output size is in the scale */
+    (void) jpeg_start_decompress(&jpeg->cinfo);
+
+    image->w = jpeg->cinfo.output_width;
+    image->h = jpeg->cinfo.output_height;
+    jpeg->pitch = image->w * rtgui_color_get_bpp(jpeg->format);
+    jpeg->row = RT_NULL;
+    if (jpeg->format == RTGRAPHIC_PIXEL_FORMAT_ARGB888)
+        jpeg->row = (*jpeg->cinfo.mem->alloc_sarray)((j_common_ptr) &jpeg->cinfo, JPOOL_IMAGE,
+                    jpeg->cinfo.output_width * jpeg->cinfo.output_components, 1);
 
     /* set image private data and engine */
     image->data = jpeg;
     image->engine = &rtgui_image_jpeg_engine;
 
-    /* start decompression */
-    (void) jpeg_start_decompress(&jpeg->cinfo);
-
-    jpeg->cinfo.out_color_space = JCS_RGB;
-    jpeg->cinfo.quantize_colors = FALSE;
-    /* use fast jpeg */
-    jpeg->cinfo.scale_num   = 1;
-    jpeg->cinfo.scale_denom = 1;
-    jpeg->cinfo.dct_method = JDCT_FASTEST;
-    jpeg->cinfo.do_fancy_upsampling = FALSE;
-
     jpeg->pixels = RT_NULL;
     jpeg->is_loaded = RT_FALSE;
 
     /* allocate line pixels */
-    jpeg->line_pixels = rtgui_malloc(image->w * sizeof(rtgui_color_t));
+    jpeg->line_pixels = rtgui_malloc(jpeg->pitch);
     if (jpeg->line_pixels == RT_NULL)
     {
         /* no memory */
@@ -383,6 +723,55 @@ static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_f
     return RT_TRUE;
 }
 
+static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+{
+    return _jpeg_load(image, file, load, _jpeg_profile, 0, 0);
+}
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+struct rtgui_image *rtgui_image_jpeg_create(const char *filename, enum rtgui_jpeg_profile profile,
+                                            int width, int height)
+{
+    struct rtgui_filerw *filerw;
+    struct rtgui_image *image;
+
+    filerw = rtgui_filerw_create_buffered(filename, 0);
+    if (filerw == RT_NULL)
+        return RT_NULL;
+
+    if (rtgui_image_jpeg_check(filerw) != RT_TRUE)
+    {
+        rtgui_filerw_close(filerw);
+        return RT_NULL;
+    }
+
+    image = (struct rtgui_image *)rtgui_malloc(sizeof(struct rtgui_image));
+    if (image == RT_NULL)
+    {
+        rtgui_filerw_close(filerw);
+        return RT_NULL;
+    }
+    image->palette = RT_NULL;
+
+    /* the file is closed by loader once the image is decoded */
+    if (_jpeg_load(image, filerw, RT_TRUE, profile, width, height) != RT_TRUE)
+    {
+        rtgui_free(image);
+        rtgui_filerw_close(filerw);
+        return RT_NULL;
+    }
+
+    return image;
+}
+RTM_EXPORT(rtgui_image_jpeg_create);
+
+struct rtgui_image *rtgui_image_jpeg_create_thumbnail(const char *filename, int width, int height)
+{
+    return rtgui_image_jpeg_create(filename, RTGUI_JPEG_PROFILE_FAST, width, height);
+}
+RTM_EXPORT(rtgui_image_jpeg_create_thumbnail);
+#endif
+
 
 static void rtgui_image_jpeg_unload(struct rtgui_image *image)
 {
@@ -407,10 +796,15 @@ static void rtgui_image_jpeg_unload(struct rtgui_image *image)
     }
 }
 
+/*
+ * The lines in the format of dc are blitted directly, the others are
+ * converted by the line converters of blit.
+ */
 static void rtgui_image_jpeg_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
 {
-    rt_uint16_t x, y;
-    rtgui_color_t *ptr;
+    int x, y, w, h, bpp, src_bpp;
+    rt_uint8_t fmt, *row, *line_data;
+    rtgui_blit_line_func blit_line;
     struct rtgui_image_jpeg *jpeg;
 
     RT_ASSERT(image != RT_NULL && dc != RT_NULL && rect != RT_NULL);
@@ -418,88 +812,65 @@ static void rtgui_image_jpeg_blit(struct rtgui_image *image, struct rtgui_dc *dc
     jpeg = (struct rtgui_image_jpeg *) image->data;
     RT_ASSERT(jpeg != RT_NULL);
 
-    if (jpeg->pixels != RT_NULL)
-    {
-        ptr = (rtgui_color_t *) jpeg->pixels;
-
-        if (dc->type == RTGUI_DC_BUFFER)
-        {
-            /* blit ARGB888 to this buffered DC */
-            int dst_x, dst_y;
-            int w, h;
-            struct rtgui_blit_info info = { 0 };
-            struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer*)dc;
-
-            w = _UI_MIN(image->w, rtgui_rect_width(*rect));
-            h = _UI_MIN(image->h, rtgui_rect_height(*rect));
-
-            info.a = 0;
-
-            /* initialize source blit information */
-            info.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ARGB888;;
-            info.src_h = h;
-            info.src_w = w;
-            info.src_pitch = image->w * rtgui_color_get_bpp(RTGRAPHIC_PIXEL_FORMAT_ARGB888);
-            info.src_skip = info.src_pitch - w * rtgui_color_get_bpp(RTGRAPHIC_PIXEL_FORMAT_ARGB888);
-            info.src = (rt_uint8_t *)image->data + y * info.src_pitch + x * rtgui_color_get_bpp(RTGRAPHIC_PIXEL_FORMAT_ARGB888);
-
-            if (rect->x1 < 0) dst_x = 0;
-            else dst_x = rect->x1;
-            if (rect->y1 < 0) dst_y = 0;
-            else dst_y = rect->y1;
-
-            /* initialize destination blit information */
-            info.dst = rtgui_dc_buffer_get_pixel(RTGUI_DC(buffer)) + dst_y * buffer->pitch +
-                       dst_x * rtgui_color_get_bpp(buffer->pixel_format);
-            info.dst_h = h;
-            info.dst_w = w;
-            info.dst_fmt = buffer->pixel_format;
-            info.dst_pitch = buffer->pitch;
-            info.dst_skip = info.dst_pitch - info.dst_w * rtgui_color_get_bpp(buffer->pixel_format);
+    w = _UI_MIN(image->w, rtgui_rect_width(*rect));
+    h = _UI_MIN(image->h, rtgui_rect_height(*rect));
+    if (w <= 0 || h <= 0 || rtgui_dc_get_visible(dc) != RT_TRUE)
+        return;
 
-            rtgui_blit(&info);
-        }
+    fmt = rtgui_dc_get_pixel_format(dc);
+    bpp = rtgui_color_get_bpp(fmt);
+    src_bpp = rtgui_color_get_bpp(jpeg->format);
+    blit_line = RT_NULL;
+    line_data = RT_NULL;
+    if (fmt != jpeg->format && bpp > 0 && bpp <= 4)
+    {
+        if (fmt == RTGRAPHIC_PIXEL_FORMAT_BGR565)
+            blit_line = rtgui_blit_line_get_inv(bpp, src_bpp);
         else
-        {
-            /* draw each point within dc */
-            for (y = 0; y < image->h; y ++)
-            {
-                for (x = 0; x < image->w; x++)
-                {
-                    /* not alpha */
-                    if ((*ptr >> 24) != 255)
-                    {
-                        rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1, *ptr);
-                    }
+            blit_line = rtgui_blit_line_get(bpp, src_bpp);
 
-                    /* move to next color buffer */
-                    ptr ++;
-                }
-            }
-        }
+        line_data = (rt_uint8_t *)rtgui_malloc(w * bpp);
+        if (line_data == RT_NULL)
+            return; /* no memory */
     }
-    else
+
+    if (jpeg->pixels == RT_NULL)
     {
         /* seek to the begin of file */
         rtgui_filerw_seek(jpeg->filerw, 0, RTGUI_FILE_SEEK_SET);
+    }
+
+    /* decompress line and line, if it's not loaded */
+    for (y = 0; y < h; y ++)
+    {
+        row = rtgui_image_get_line(image, y);
+        if (row == RT_NULL)
+            break;
 
-        /* decompress line and line */
-        for (y = 0; y < image->h; y ++)
+        if (fmt == jpeg->format)
+        {
+            dc->engine->blit_line(dc, rect->x1, rect->x1 + w, rect->y1 + y, row);
+        }
+        else if (line_data != RT_NULL)
+        {
+            blit_line(line_data, row, w * src_bpp);
+            dc->engine->blit_line(dc, rect->x1, rect->x1 + w, rect->y1 + y, line_data);
+        }
+        else
         {
-            ptr = (rtgui_color_t *)rtgui_image_get_line(image, y);
-            for (x = 0; x < image->w; x++)
+            /* the formats without native pixel */
+            for (x = 0; x < w; x ++)
             {
-                /* not alpha */
-                if ((*ptr >> 24) != 255)
-                {
-                    rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1, *ptr);
-                }
-
-                /* move to next color buffer */
-                ptr ++;
+                rtgui_dc_draw_color_point(dc, rect->x1 + x, rect->y1 + y,
+                                          jpeg->format == RTGRAPHIC_PIXEL_FORMAT_RGB565 ?
+                                          rtgui_color_from_565(((rt_uint16_t *)row)[x]) :
+                                          ((rtgui_color_t *)row)[x]);
             }
         }
     }
+
+    if (line_data != RT_NULL)
+        rtgui_free(line_data);
 }
 
 static rt_bool_t rtgui_image_jpeg_check(struct rtgui_filerw *file)
@@ -633,6 +1004,7 @@ struct rtgui_image_jpeg
 
 /* Private define ------------------------------------------------------------*/
 #define TJPGD_WORKING_BUFFER_SIZE   (32 * 1024)
+#define TJPGD_SCALE_MAX             3
 
 /* Private macro -------------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
@@ -650,7 +1022,8 @@ struct rtgui_image_engine rtgui_image_jpeg_engine =
     rtgui_image_jpeg_check,
     rtgui_image_jpeg_load,
     rtgui_image_jpeg_unload,
-    rtgui_image_jpeg_blit
+    rtgui_image_jpeg_blit,
+    rtgui_image_jpeg_probe,
 };
 
 struct rtgui_image_engine rtgui_image_jpg_engine =
@@ -660,7 +1033,8 @@ struct rtgui_image_engine rtgui_image_jpg_engine =
     rtgui_image_jpeg_check,
     rtgui_image_jpeg_load,
     rtgui_image_jpeg_unload,
-    rtgui_image_jpeg_blit
+    rtgui_image_jpeg_blit,
+    rtgui_image_jpeg_probe,
 };
 
 /* Private functions ---------------------------------------------------------*/
@@ -734,6 +1108,22 @@ static UINT tjpgd_out_func(JDEC *jdec, void *bitmap, JRECT *rect)
     return 1;                           /* Continue to decompress */
 }
 
+/* get the largest de-scaling (1/2, 1/4, 1/8) in which the image still
+ * covers the width and height */
+static BYTE tjpgd_get_scale(JDEC *jdec, int width, int height)
+{
+    BYTE scale = 0;
+
+#if JD_USE_SCALE
+    while (scale < TJPGD_SCALE_MAX &&
+            (int)(jdec->width >> (scale + 1)) >= width &&
+            (int)(jdec->height >> (scale + 1)) >= height)
+        scale ++;
+#endif
+
+    return scale;
+}
+
 static rt_bool_t rtgui_image_jpeg_check(struct rtgui_filerw *file)
 {
     rt_uint8_t soi[2];
@@ -747,11 +1137,15 @@ static rt_bool_t rtgui_image_jpeg_check(struct rtgui_filerw *file)
     return RT_FALSE;
 }
 
-static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+/* load the image, which is decoded in the scale fit in width x height if
+ * they are not 0 */
+static rt_bool_t _jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load,
+                            int width, int height)
 {
     rt_bool_t res = RT_FALSE;
     struct rtgui_image_jpeg *jpeg;
     JRESULT ret;
+    BYTE scale = 0;
     struct rtgui_graphic_driver *hw_driver;
 
     do
@@ -797,8 +1191,12 @@ static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_f
         /* else use RGB888 format */
         else jpeg->byte_per_pixel = 3;
 
-        image->w = (rt_uint16_t)jpeg->tjpgd.width;
-        image->h = (rt_uint16_t)jpeg->tjpgd.height;
+        /* the pixels of a loaded image are in the scale */
+        if (jpeg->is_loaded == RT_TRUE && width > 0 && height > 0)
+            scale = tjpgd_get_scale(&jpeg->tjpgd, width, height);
+
+        image->w = (rt_uint16_t)(jpeg->tjpgd.width >> scale);
+        image->h = (rt_uint16_t)(jpeg->tjpgd.height >> scale);
         /* set image private data and engine */
         image->data = jpeg;
         image->engine = &rtgui_image_jpeg_engine;
@@ -814,7 +1212,11 @@ static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_f
                 break;
             }
 
-            ret = jd_decomp(&jpeg->tjpgd, tjpgd_out_func, 0);
+            /* the MCUs not descaled are converted into the pixels directly */
+            jpeg->tjpgd.frame = jpeg->pixels;
+            jpeg->tjpgd.pitch = jpeg->byte_per_pixel * image->w;
+
+            ret = jd_decomp(&jpeg->tjpgd, tjpgd_out_func, scale);
             if (ret != JDR_OK) break;
 
             rtgui_filerw_close(jpeg->filerw);
@@ -843,6 +1245,48 @@ static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_f
     return res;
 }
 
+static rt_bool_t rtgui_image_jpeg_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+{
+    return _jpeg_load(image, file, load, 0, 0);
+}
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+struct rtgui_image *rtgui_image_jpeg_create_thumbnail(const char *filename, int width, int height)
+{
+    struct rtgui_filerw *filerw;
+    struct rtgui_image *image;
+
+    filerw = rtgui_filerw_create_buffered(filename, 0);
+    if (filerw == RT_NULL)
+        return RT_NULL;
+
+    if (rtgui_image_jpeg_check(filerw) != RT_TRUE)
+    {
+        rtgui_filerw_close(filerw);
+        return RT_NULL;
+    }
+
+    image = (struct rtgui_image *)rtgui_malloc(sizeof(struct rtgui_image));
+    if (image == RT_NULL)
+    {
+        rtgui_filerw_close(filerw);
+        return RT_NULL;
+    }
+    image->palette = RT_NULL;
+
+    /* the file is closed by loader once the image is decoded */
+    if (_jpeg_load(image, filerw, RT_TRUE, width, height) != RT_TRUE)
+    {
+        rtgui_free(image);
+        rtgui_filerw_close(filerw);
+        return RT_NULL;
+    }
+
+    return image;
+}
+RTM_EXPORT(rtgui_image_jpeg_create_thumbnail);
+#endif
+
 static void rtgui_image_jpeg_unload(struct rtgui_image *image)
 {
     if (image != RT_NULL)
@@ -915,13 +1359,54 @@ static void rtgui_image_jpeg_blit(struct rtgui_image *image,
     if (!jpeg->is_loaded)
     {
         JRESULT ret;
+        BYTE scale, format;
+
+        /* the stream is prepared again, it's consumed by the last decoding */
+        format = jpeg->tjpgd.format;
+        if (rtgui_filerw_seek(jpeg->filerw, 0, RTGUI_FILE_SEEK_SET) == -1)
+            return;
+        ret = jd_prepare(&jpeg->tjpgd, tjpgd_in_func, jpeg->pool,
+                         TJPGD_WORKING_BUFFER_SIZE, (void *)jpeg);
+        if (ret != JDR_OK)
+            return;
+        jpeg->tjpgd.format = format;
+
+        /* decode in the scale of rect, if the rect is smaller than image */
+        scale = tjpgd_get_scale(&jpeg->tjpgd, rtgui_rect_width(*dst_rect), rtgui_rect_height(*dst_rect));
+        if (scale)
+        {
+            if (xoff >= (image->w >> scale) || yoff >= (image->h >> scale))
+                return;
+
+            w = _UI_MIN((image->w >> scale) - xoff, rtgui_rect_width (*dst_rect));
+            h = _UI_MIN((image->h >> scale) - yoff, rtgui_rect_height(*dst_rect));
+        }
 
         /* TODO support xoff/yoff. */
         jpeg->dst_x = dst_rect->x1;
         jpeg->dst_y = dst_rect->y1;
         jpeg->dst_w = w;
         jpeg->dst_h = h;
-        ret = jd_decomp(&jpeg->tjpgd, tjpgd_out_func, 0);
+
+        /* only the MCUs in the visible part of dc are decoded */
+        {
+            struct rtgui_rect roi;
+
+            rtgui_dc_get_rect(dc, &roi);
+            roi.x1 = _UI_MAX(roi.x1, dst_rect->x1);
+            roi.y1 = _UI_MAX(roi.y1, dst_rect->y1);
+            roi.x2 = _UI_MIN(roi.x2, dst_rect->x1 + w);
+            roi.y2 = _UI_MIN(roi.y2, dst_rect->y1 + h);
+            if (roi.x1 >= roi.x2 || roi.y1 >= roi.y2)
+                return;
+
+            jpeg->tjpgd.roi.left   = roi.x1 - dst_rect->x1;
+            jpeg->tjpgd.roi.right  = roi.x2 - dst_rect->x1 - 1;
+            jpeg->tjpgd.roi.top    = roi.y1 - dst_rect->y1;
+            jpeg->tjpgd.roi.bottom = roi.y2 - dst_rect->y1 - 1;
+        }
+
+        ret = jd_decomp(&jpeg->tjpgd, tjpgd_out_func, scale);
         if (ret != JDR_OK)
             return;
     }
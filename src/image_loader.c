@@ -0,0 +1,300 @@
+/*
+ * File      : image_loader.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/image.h>
+#include <rtgui/event.h>
+#include <rtgui/rtgui_app.h>
+#include <rtgui/rtgui_system.h>
+
+/*
+ * The image loader decodes the images in a worker thread. The request is
+ * queued by the application, and the image is delivered to the application
+ * by RTGUI_EVENT_IMAGE_LOADED, then the done callback is invoked in the
+ * application thread.
+ */
+enum
+{
+    IMAGE_REQUEST_PENDING,      /* in the queue of worker */
+    IMAGE_REQUEST_LOADING,      /* decoding by worker */
+    IMAGE_REQUEST_DONE,         /* the event is sent to application */
+};
+
+struct rtgui_image_request
+{
+    rt_list_t list;
+    rt_uint8_t state;
+    rt_bool_t canceled;
+    /* decoded after the foreground requests, in a low priority */
+    rt_bool_t background;
+
+    struct rtgui_app *app;
+    rtgui_image_done_t done;
+    void *user_data;
+
+    /* the image in memory, or the filename if data is RT_NULL */
+    const char *type;
+    const rt_uint8_t *data;
+    rt_size_t length;
+
+    struct rtgui_image *image;
+
+    /* char filename[]; */
+};
+
+static rt_list_t _image_request_list = RT_LIST_OBJECT_INIT(_image_request_list);
+static struct rt_mutex _image_request_lock;
+static struct rt_semaphore _image_request_sem;
+static rt_thread_t _image_loader_tid;
+
+static void _image_loader_entry(void *parameter)
+{
+    rt_uint8_t priority;
+    struct rtgui_image_request *request;
+    struct rtgui_event_image_loaded event;
+
+    while (1)
+    {
+        rt_sem_take(&_image_request_sem, RT_WAITING_FOREVER);
+
+        rt_mutex_take(&_image_request_lock, RT_WAITING_FOREVER);
+        if (rt_list_isempty(&_image_request_list))
+        {
+            /* the request is canceled */
+            rt_mutex_release(&_image_request_lock);
+            continue;
+        }
+        request = rt_list_entry(_image_request_list.next, struct rtgui_image_request, list);
+        rt_list_remove(&request->list);
+        request->state = IMAGE_REQUEST_LOADING;
+        rt_mutex_release(&_image_request_lock);
+
+        if (request->background)
+        {
+            priority = GUIENGINE_IMAGE_PREFETCH_PRIORITY;
+            rt_thread_control(rt_thread_self(), RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+        }
+
+        if (request->data != RT_NULL)
+            request->image = rtgui_image_create_from_mem(request->type, request->data, request->length, RT_TRUE);
+#if defined(GUIENGINE_USING_DFS_FILERW)
+        else
+            request->image = rtgui_image_create((const char *)(request + 1), RT_TRUE);
+#endif
+
+        if (request->background)
+        {
+            priority = GUIENGINE_IMAGE_LOADER_PRIORITY;
+            rt_thread_control(rt_thread_self(), RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+        }
+
+        rt_mutex_take(&_image_request_lock, RT_WAITING_FOREVER);
+        if (request->canceled)
+        {
+            rt_mutex_release(&_image_request_lock);
+
+            if (request->image != RT_NULL) rtgui_image_destroy(request->image);
+            rtgui_free(request);
+            continue;
+        }
+        request->state = IMAGE_REQUEST_DONE;
+        rt_mutex_release(&_image_request_lock);
+
+        RTGUI_EVENT_IMAGE_LOADED_INIT(&event);
+        event.request = request;
+        /* the request is owned by application from now, wait if its queue is full */
+        while (rtgui_send(request->app, &event.parent, sizeof(event)) != RT_EOK)
+            rt_thread_delay(RT_TICK_PER_SECOND / 50);
+    }
+}
+
+void rtgui_image_loader_init(void)
+{
+    rt_mutex_init(&_image_request_lock, "imgreq", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&_image_request_sem, "imgreq", 0, RT_IPC_FLAG_FIFO);
+}
+
+static struct rtgui_image_request *_image_request_create(const char *filename, rtgui_image_done_t done,
+                                                         void *user_data)
+{
+    rt_size_t len;
+    struct rtgui_image_request *request;
+
+    RT_ASSERT(done != RT_NULL);
+
+    len = filename != RT_NULL ? rt_strlen(filename) + 1 : 0;
+    request = (struct rtgui_image_request *)rtgui_malloc(sizeof(struct rtgui_image_request) + len);
+    if (request == RT_NULL)
+        return RT_NULL;
+
+    rt_list_init(&request->list);
+    request->state = IMAGE_REQUEST_PENDING;
+    request->canceled = RT_FALSE;
+    request->background = RT_FALSE;
+    request->app = rtgui_app_self();
+    request->done = done;
+    request->user_data = user_data;
+    request->type = RT_NULL;
+    request->data = RT_NULL;
+    request->length = 0;
+    request->image = RT_NULL;
+    if (len) rt_memcpy(request + 1, filename, len);
+
+    RT_ASSERT(request->app != RT_NULL);
+
+    return request;
+}
+
+static struct rtgui_image_request *_image_request_queue(struct rtgui_image_request *request)
+{
+    rt_list_t *node;
+
+    /* the lock is initialized with the image system */
+    rtgui_system_image_init();
+    rt_mutex_take(&_image_request_lock, RT_WAITING_FOREVER);
+    /* the worker is created for the first request */
+    if (_image_loader_tid == RT_NULL)
+    {
+        _image_loader_tid = rt_thread_create("imgload", _image_loader_entry, RT_NULL,
+                                             GUIENGINE_IMAGE_LOADER_STACK_SIZE,
+                                             GUIENGINE_IMAGE_LOADER_PRIORITY,
+                                             GUIENGIN_APP_THREAD_TIMESLICE);
+        if (_image_loader_tid == RT_NULL)
+        {
+            rt_mutex_release(&_image_request_lock);
+            rtgui_free(request);
+            return RT_NULL;
+        }
+        rt_thread_startup(_image_loader_tid);
+    }
+
+    /* the foreground request is queued before the background ones */
+    node = &_image_request_list;
+    if (request->background == RT_FALSE)
+    {
+        for (node = _image_request_list.next; node != &_image_request_list; node = node->next)
+        {
+            if (rt_list_entry(node, struct rtgui_image_request, list)->background)
+                break;
+        }
+    }
+    rt_list_insert_before(node, &request->list);
+    rt_mutex_release(&_image_request_lock);
+
+    rt_sem_release(&_image_request_sem);
+
+    return request;
+}
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+struct rtgui_image_request *rtgui_image_load_async(const char *filename, rtgui_image_done_t done,
+                                                   void *user_data)
+{
+    struct rtgui_image_request *request;
+
+    RT_ASSERT(filename != RT_NULL);
+
+    request = _image_request_create(filename, done, user_data);
+    if (request == RT_NULL)
+        return RT_NULL;
+
+    return _image_request_queue(request);
+}
+RTM_EXPORT(rtgui_image_load_async);
+
+struct rtgui_image_request *rtgui_image_load_background(const char *filename, rtgui_image_done_t done,
+                                                        void *user_data)
+{
+    struct rtgui_image_request *request;
+
+    RT_ASSERT(filename != RT_NULL);
+
+    request = _image_request_create(filename, done, user_data);
+    if (request == RT_NULL)
+        return RT_NULL;
+    request->background = RT_TRUE;
+
+    return _image_request_queue(request);
+}
+RTM_EXPORT(rtgui_image_load_background);
+#endif
+
+struct rtgui_image_request *rtgui_image_load_mem_async(const char *type, const rt_uint8_t *data,
+                                                       rt_size_t length, rtgui_image_done_t done,
+                                                       void *user_data)
+{
+    struct rtgui_image_request *request;
+
+    RT_ASSERT(data != RT_NULL);
+
+    request = _image_request_create(RT_NULL, done, user_data);
+    if (request == RT_NULL)
+        return RT_NULL;
+
+    request->type = type;
+    request->data = data;
+    request->length = length;
+
+    return _image_request_queue(request);
+}
+RTM_EXPORT(rtgui_image_load_mem_async);
+
+void rtgui_image_request_cancel(struct rtgui_image_request *request)
+{
+    RT_ASSERT(request != RT_NULL);
+
+    rt_mutex_take(&_image_request_lock, RT_WAITING_FOREVER);
+    if (request->state == IMAGE_REQUEST_PENDING)
+    {
+        rt_list_remove(&request->list);
+        rt_mutex_release(&_image_request_lock);
+
+        rtgui_free(request);
+        return;
+    }
+
+    /* the worker or the event handler releases it */
+    request->canceled = RT_TRUE;
+    rt_mutex_release(&_image_request_lock);
+}
+RTM_EXPORT(rtgui_image_request_cancel);
+
+void rtgui_image_request_complete(struct rtgui_image_request *request)
+{
+    RT_ASSERT(request != RT_NULL);
+
+    if (request->canceled)
+    {
+        if (request->image != RT_NULL) rtgui_image_destroy(request->image);
+    }
+    else
+    {
+        /* the image is owned by the callback */
+        request->done(request, request->image, request->user_data);
+    }
+
+    rtgui_free(request);
+}
+RTM_EXPORT(rtgui_image_request_complete);
@@ -0,0 +1,236 @@
+/*
+ * File      : image_mipmap.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/image.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_IMAGE_MIPMAP
+
+/*
+ * The chain of an image in ARGB888, each level is the half of the previous
+ * one in the 2x2 box average. A scaled blit filters from the smallest level
+ * still covers the target, so the bilinear zoom never steps over more than
+ * two source pixels.
+ */
+struct rtgui_image_mipmap
+{
+    int count;
+    struct rtgui_dc *levels[RTGUI_IMAGE_MIPMAP_LEVELS];
+
+    /* the last scaled blit, the same size is blitted again without zoom */
+    struct rtgui_dc *scaled;
+    rt_uint16_t scaled_w, scaled_h;
+};
+
+/* the next level in the average of 2x2 pixels, the odd edge is repeated */
+static struct rtgui_dc *_mipmap_half(struct rtgui_dc *dc)
+{
+    int x, y, w, h, x1, y1;
+    rt_uint32_t p0, p1, p2, p3, lo, hi;
+    rt_uint32_t *row0, *row1, *dst;
+    struct rtgui_dc_buffer *src, *half;
+
+    src = (struct rtgui_dc_buffer *)dc;
+    w = src->width > 1 ? src->width / 2 : 1;
+    h = src->height > 1 ? src->height / 2 : 1;
+    half = (struct rtgui_dc_buffer *)rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, w, h);
+    if (half == RT_NULL)
+        return RT_NULL;
+    if (rtgui_dc_buffer_read_pixel(RTGUI_DC(half)) == RT_NULL)
+    {
+        rtgui_dc_destory(RTGUI_DC(half));
+        return RT_NULL;
+    }
+
+    for (y = 0; y < h; y ++)
+    {
+        y1 = _UI_MIN(2 * y + 1, src->height - 1);
+        row0 = (rt_uint32_t *)(src->pixel + 2 * y * src->pitch);
+        row1 = (rt_uint32_t *)(src->pixel + y1 * src->pitch);
+        dst = (rt_uint32_t *)(half->pixel + y * half->pitch);
+        for (x = 0; x < w; x ++)
+        {
+            x1 = _UI_MIN(2 * x + 1, src->width - 1);
+            p0 = row0[2 * x];
+            p1 = row0[x1];
+            p2 = row1[2 * x];
+            p3 = row1[x1];
+
+            /* two channels in each 16 bits lane, the sum of 4 does not carry */
+            lo = (p0 & 0x00FF00FF) + (p1 & 0x00FF00FF) + (p2 & 0x00FF00FF) + (p3 & 0x00FF00FF) + 0x00020002;
+            hi = ((p0 >> 8) & 0x00FF00FF) + ((p1 >> 8) & 0x00FF00FF) +
+                 ((p2 >> 8) & 0x00FF00FF) + ((p3 >> 8) & 0x00FF00FF) + 0x00020002;
+            dst[x] = ((lo >> 2) & 0x00FF00FF) | (((hi >> 2) & 0x00FF00FF) << 8);
+        }
+    }
+
+    return RTGUI_DC(half);
+}
+
+/** Create the mipmap of an image
+ *
+ * @param levels the levels including the full one, 0 is halved until 1 pixel.
+ *
+ * @return RT_NULL if there is no memory for the full level.
+ */
+struct rtgui_image_mipmap *rtgui_image_mipmap_create(struct rtgui_image *image, int levels)
+{
+    struct rtgui_rect rect;
+    struct rtgui_dc *dc;
+    struct rtgui_image_mipmap *mipmap;
+
+    RT_ASSERT(image != RT_NULL);
+
+    if (levels <= 0 || levels > RTGUI_IMAGE_MIPMAP_LEVELS)
+        levels = RTGUI_IMAGE_MIPMAP_LEVELS;
+
+    mipmap = (struct rtgui_image_mipmap *)rtgui_malloc(sizeof(struct rtgui_image_mipmap));
+    if (mipmap == RT_NULL)
+        return RT_NULL;
+    rt_memset(mipmap, 0, sizeof(struct rtgui_image_mipmap));
+
+    /* the full level is the image rendered on transparent */
+    dc = rtgui_dc_buffer_create_pixformat(RTGRAPHIC_PIXEL_FORMAT_ARGB888, image->w, image->h);
+    if (dc == RT_NULL || rtgui_dc_buffer_read_pixel(dc) == RT_NULL)
+    {
+        if (dc != RT_NULL) rtgui_dc_destory(dc);
+        rtgui_free(mipmap);
+        return RT_NULL;
+    }
+    rtgui_rect_init(&rect, 0, 0, image->w, image->h);
+    rtgui_image_blit(image, dc, &rect);
+    mipmap->levels[0] = dc;
+    mipmap->count = 1;
+
+    /* the smaller levels are optional, the chain stops on no memory */
+    while (mipmap->count < levels)
+    {
+        struct rtgui_dc_buffer *last = (struct rtgui_dc_buffer *)dc;
+
+        if (last->width == 1 && last->height == 1)
+            break;
+        dc = _mipmap_half(dc);
+        if (dc == RT_NULL)
+            break;
+        mipmap->levels[mipmap->count ++] = dc;
+    }
+
+    return mipmap;
+}
+RTM_EXPORT(rtgui_image_mipmap_create);
+
+void rtgui_image_mipmap_destroy(struct rtgui_image_mipmap *mipmap)
+{
+    int index;
+
+    RT_ASSERT(mipmap != RT_NULL);
+
+    for (index = 0; index < mipmap->count; index ++)
+        rtgui_dc_destory(mipmap->levels[index]);
+    if (mipmap->scaled != RT_NULL)
+        rtgui_dc_destory(mipmap->scaled);
+    rtgui_free(mipmap);
+}
+RTM_EXPORT(rtgui_image_mipmap_destroy);
+
+/* the smallest level covers w x h, the full one for the zoom in */
+static struct rtgui_dc *_mipmap_level(struct rtgui_image_mipmap *mipmap, int w, int h)
+{
+    int index;
+    struct rtgui_dc_buffer *level;
+
+    for (index = mipmap->count - 1; index > 0; index --)
+    {
+        level = (struct rtgui_dc_buffer *)mipmap->levels[index];
+        if (level->width >= w && level->height >= h)
+            break;
+    }
+
+    return mipmap->levels[index];
+}
+
+/* a new ARGB888 dc of the image in w x h, filtered from the nearest level */
+struct rtgui_dc *rtgui_image_mipmap_scale(struct rtgui_image_mipmap *mipmap, int w, int h)
+{
+    struct rtgui_dc_buffer *level;
+
+    RT_ASSERT(mipmap != RT_NULL);
+    if (w <= 0 || h <= 0)
+        return RT_NULL;
+
+    level = (struct rtgui_dc_buffer *)_mipmap_level(mipmap, w, h);
+    return rtgui_dc_zoom(RTGUI_DC(level), (double)w / level->width, (double)h / level->height, 1);
+}
+RTM_EXPORT(rtgui_image_mipmap_scale);
+
+/*
+ * Blit the image scaled to the rect. The level of the same size is blitted
+ * directly, and the scaled one is kept for the next blits in the same size,
+ * such as the tiles of map in a zoom.
+ */
+void rtgui_image_mipmap_blit(struct rtgui_image_mipmap *mipmap, struct rtgui_dc *dc, struct rtgui_rect *rect)
+{
+    int w, h;
+    struct rtgui_rect dst;
+    struct rtgui_dc *src;
+    struct rtgui_dc_buffer *level;
+
+    RT_ASSERT(mipmap != RT_NULL && dc != RT_NULL && rect != RT_NULL);
+
+    w = rtgui_rect_width(*rect);
+    h = rtgui_rect_height(*rect);
+    if (w <= 0 || h <= 0 || !rtgui_dc_get_visible(dc))
+        return;
+
+    level = (struct rtgui_dc_buffer *)_mipmap_level(mipmap, w, h);
+    if (level->width == w && level->height == h)
+    {
+        src = RTGUI_DC(level);
+    }
+    else
+    {
+        if (mipmap->scaled == RT_NULL || mipmap->scaled_w != w || mipmap->scaled_h != h)
+        {
+            if (mipmap->scaled != RT_NULL)
+                rtgui_dc_destory(mipmap->scaled);
+            mipmap->scaled = rtgui_image_mipmap_scale(mipmap, w, h);
+            if (mipmap->scaled == RT_NULL)
+                return;
+            mipmap->scaled_w = w;
+            mipmap->scaled_h = h;
+        }
+        src = mipmap->scaled;
+    }
+
+    /* only the rect, the zoomed dc has the guard rows under the image */
+    dst = *rect;
+    rtgui_dc_blit(src, RT_NULL, dc, &dst);
+}
+RTM_EXPORT(rtgui_image_mipmap_blit);
+
+#endif
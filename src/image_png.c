@@ -22,12 +22,62 @@
  * 2010-09-15     Bernard      first version
  */
 
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <rtthread.h>
 #include <rtgui/rtgui_system.h>
 #include <rtgui/blit.h>
 #include <rtgui/driver.h>
 #include <rtgui/image.h>
 
+#if defined(GUIENGINE_IMAGE_PNG) || defined(GUIENGINE_IMAGE_LODEPNG)
+rt_inline rt_uint32_t _png_get_u32(const rt_uint8_t *ptr)
+{
+    return ((rt_uint32_t)ptr[0] << 24) | ((rt_uint32_t)ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
+}
+
+/* the size in IHDR, and the alpha of color type or tRNS before IDAT */
+static rt_bool_t rtgui_image_png_probe(struct rtgui_filerw *file, struct rtgui_image_probe_info *info)
+{
+    int index;
+    /* the signature, IHDR chunk and its CRC */
+    rt_uint8_t buffer[8 + 8 + 13 + 4];
+    static const rt_uint8_t signature[8] = {0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a};
+
+    if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) < 0 ||
+            rtgui_filerw_read(file, buffer, 1, sizeof(buffer)) != sizeof(buffer) ||
+            rt_memcmp(buffer, signature, sizeof(signature)) != 0 ||
+            rt_memcmp(buffer + 12, "IHDR", 4) != 0)
+        return RT_FALSE;
+
+    info->w = (rt_uint16_t)_png_get_u32(buffer + 16);
+    info->h = (rt_uint16_t)_png_get_u32(buffer + 20);
+    /* the gray or truecolor with alpha */
+    if (buffer[25] & 0x04)
+    {
+        info->has_alpha = RT_TRUE;
+        return RT_TRUE;
+    }
+
+    /* only a few chunks such as PLTE are before IDAT */
+    for (index = 0; index < 8; index ++)
+    {
+        if (rtgui_filerw_read(file, buffer, 1, 8) != 8 || rt_memcmp(buffer + 4, "IDAT", 4) == 0)
+            break;
+        if (rt_memcmp(buffer + 4, "tRNS", 4) == 0)
+        {
+            info->has_alpha = RT_TRUE;
+            break;
+        }
+        /* skip the data and CRC */
+        if (rtgui_filerw_seek(file, _png_get_u32(buffer) + 4, RTGUI_FILE_SEEK_CUR) < 0)
+            break;
+    }
+
+    return RT_TRUE;
+}
+#endif
+
 #ifdef GUIENGINE_IMAGE_PNG
 #include "png.h"
 
@@ -36,6 +86,9 @@
 struct rtgui_image_png
 {
     rt_bool_t is_loaded;
+    /* the rows are read by the streaming blit, the stream should be read
+     * from the beginning again */
+    rt_bool_t is_consumed;
 
     struct rtgui_filerw *filerw;
 
@@ -50,6 +103,9 @@ static rt_bool_t rtgui_image_png_check(struct rtgui_filerw *file);
 static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load);
 static void rtgui_image_png_unload(struct rtgui_image *image);
 static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect);
+static rt_bool_t rtgui_image_png_stream_begin(struct rtgui_image_stream *stream);
+static rt_err_t rtgui_image_png_stream_feed(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length);
+static void rtgui_image_png_stream_end(struct rtgui_image_stream *stream);
 
 struct rtgui_image_engine rtgui_image_png_engine =
 {
@@ -59,6 +115,10 @@ struct rtgui_image_engine rtgui_image_png_engine =
     rtgui_image_png_load,
     rtgui_image_png_unload,
     rtgui_image_png_blit,
+    rtgui_image_png_probe,
+    rtgui_image_png_stream_begin,
+    rtgui_image_png_stream_feed,
+    rtgui_image_png_stream_end,
 };
 
 static void rtgui_image_png_read_data(png_structp png_ptr, png_bytep data, png_size_t length)
@@ -166,46 +226,34 @@ static void _image_png_error_fn(png_structp png_ptr, png_const_charp error_messa
     rt_kprintf(error_message);
 }
 
-static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+/* create the png struct and read the information of image from beginning */
+static rt_bool_t _image_png_prepare(struct rtgui_image_png *png)
 {
     png_uint_32 width;
     png_uint_32 height;
     int bit_depth;
     int color_type;
     double gamma;
-    struct rtgui_image_png *png;
 
-    png = (struct rtgui_image_png *) rtgui_malloc(sizeof(struct rtgui_image_png));
     png->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (png->png_ptr == RT_NULL)
-    {
-        rtgui_free(png);
         return RT_FALSE;
-    }
     png_set_error_fn(png->png_ptr, RT_NULL, _image_png_error_fn, _image_png_error_fn);
 
     png->info_ptr = png_create_info_struct(png->png_ptr);
     if (png->info_ptr == RT_NULL)
     {
         png_destroy_read_struct(&png->png_ptr, NULL, NULL);
-        rtgui_free(png);
         return RT_FALSE;
     }
 
-    png->filerw = file;
-    png->is_loaded = RT_FALSE;
+    png->is_consumed = RT_FALSE;
     png_set_read_fn(png->png_ptr, png->filerw, rtgui_image_png_read_data);
 
     png_read_info(png->png_ptr, png->info_ptr);
     png_get_IHDR(png->png_ptr, png->info_ptr, &width, &height, &bit_depth,
                  &color_type, NULL, NULL, NULL);
 
-    /* set image information */
-    image->w = width;
-    image->h = height;
-    image->engine = &rtgui_image_png_engine;
-    image->data = png;
-
     if (bit_depth == 16)
         png_set_strip_16(png->png_ptr);
     if (color_type == PNG_COLOR_TYPE_PALETTE)
@@ -226,6 +274,30 @@ static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_fi
 
     png_read_update_info(png->png_ptr, png->info_ptr);
 
+    return RT_TRUE;
+}
+
+static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+{
+    struct rtgui_image_png *png;
+
+    png = (struct rtgui_image_png *) rtgui_malloc(sizeof(struct rtgui_image_png));
+    if (png == RT_NULL) return RT_FALSE;
+
+    png->filerw = file;
+    png->is_loaded = RT_FALSE;
+    if (_image_png_prepare(png) != RT_TRUE)
+    {
+        rtgui_free(png);
+        return RT_FALSE;
+    }
+
+    /* set image information */
+    image->w = png_get_image_width(png->png_ptr, png->info_ptr);
+    image->h = png_get_image_height(png->png_ptr, png->info_ptr);
+    image->engine = &rtgui_image_png_engine;
+    image->data = png;
+
     if (load == RT_TRUE)
     {
         /* load all pixels */
@@ -277,6 +349,73 @@ static void rtgui_image_png_unload(struct rtgui_image *image)
     }
 }
 
+/* pack the pixel into the line of dc, RT_FALSE if the format is not supported */
+rt_inline rt_bool_t _image_png_pack_pixel(rt_uint8_t format, rt_uint8_t *ptr, png_bytep data)
+{
+    switch (format)
+    {
+    case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+        *(rt_uint16_t *)ptr = ((data[0] >> 3) << 11) | ((data[1] >> 2) << 5) | (data[2] >> 3);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_BGR565:
+        *(rt_uint16_t *)ptr = ((data[2] >> 3) << 11) | ((data[1] >> 2) << 5) | (data[0] >> 3);
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_RGB888:
+        ptr[0] = data[2];
+        ptr[1] = data[1];
+        ptr[2] = data[0];
+        break;
+    case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+        *(rtgui_color_t *)ptr = RTGUI_RGB(data[0], data[1], data[2]);
+        break;
+    default:
+        return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+/* draw a row of image, the runs of opaque pixels are blitted as lines of dc
+ * and the translucent pixels are blended */
+static void _image_png_blit_row(struct rtgui_dc *dc, rt_uint8_t format, rt_uint8_t *line,
+                                png_bytep row, int channels, int x, int y, int w)
+{
+    int index, start, bpp;
+    rt_uint8_t alpha;
+    png_bytep data;
+
+    bpp = rtgui_color_get_bpp(format);
+    start = -1;
+    for (index = 0; index <= w; index ++)
+    {
+        data = &(row[index * channels]);
+        alpha = (index == w) ? 0 : (channels == 4 ? data[3] : 255);
+
+        if (alpha == 255)
+        {
+            if (_image_png_pack_pixel(format, line + index * bpp, data) != RT_TRUE)
+            {
+                rtgui_dc_draw_color_point(dc, x + index, y, RTGUI_RGB(data[0], data[1], data[2]));
+                continue;
+            }
+            if (start < 0) start = index;
+            continue;
+        }
+
+        if (start >= 0)
+        {
+            dc->engine->blit_line(dc, x + start, x + index, y, line + start * bpp);
+            start = -1;
+        }
+
+        if (alpha != 0)
+        {
+            rtgui_dc_blend_point(dc, x + index, y, RTGUI_BLENDMODE_BLEND,
+                                 data[0], data[1], data[2], alpha);
+        }
+    }
+}
+
 static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
 {
     rt_uint16_t x, y, w, h;
@@ -357,64 +496,187 @@ static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc,
     else
     {
         png_bytep row;
-        png_bytep data;
+        rt_uint8_t *line;
+        int channels;
+        rt_uint8_t format = rtgui_dc_get_pixel_format(dc);
 
-        row = (png_bytep) rtgui_malloc(png_get_rowbytes(png->png_ptr, png->info_ptr));
-        if (row == RT_NULL) return ;
+        /* this dc is not visible */
+        if (rtgui_dc_get_visible(dc) != RT_TRUE) return;
 
-        switch (png->info_ptr->color_type)
+        /* the stream can't be rewound in libpng, create the png struct again */
+        if (png->is_consumed == RT_TRUE)
         {
-        case PNG_COLOR_TYPE_RGB:
-            for (y = 0; y < h; y++)
-            {
-                png_read_row(png->png_ptr, row, png_bytep_NULL);
-                for (x = 0; x < w; x++)
-                {
-                    data = &(row[x * 3]);
-                    rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1,
-                                              RTGUI_RGB(data[0], data[1], data[2]));
-                }
-            }
-            break;
+            png_destroy_info_struct(png->png_ptr, &png->info_ptr);
+            png_destroy_read_struct(&png->png_ptr, RT_NULL, RT_NULL);
 
-        case PNG_COLOR_TYPE_RGBA:
-            for (y = 0; y < h; y++)
+            rtgui_filerw_seek(png->filerw, 0, RTGUI_FILE_SEEK_SET);
+            if (_image_png_prepare(png) != RT_TRUE)
             {
-                png_read_row(png->png_ptr, row, png_bytep_NULL);
-                for (x = 0; x < w; x++)
-                {
-                    data = &(row[x * 4]);
-                    if (data[3] != 0)
-                    {
-                        rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1,
-                                                  RTGUI_ARGB(data[3], data[0], data[1], data[2]));
-                    }
-                }
+                png->png_ptr = RT_NULL;
+                png->info_ptr = RT_NULL;
+                return;
             }
+        }
 
-            break;
+        /* only one row of image and one line of dc are buffered */
+        row = (png_bytep) rtgui_malloc(png_get_rowbytes(png->png_ptr, png->info_ptr));
+        if (row == RT_NULL) return ;
+        line = (rt_uint8_t *) rtgui_malloc(w * rtgui_color_get_bpp(format));
+        if (line == RT_NULL)
+        {
+            rtgui_free(row);
+            return ;
+        }
 
-        case PNG_COLOR_TYPE_PALETTE:
-            for (y = 0; y < h; y++)
-            {
-                png_read_row(png->png_ptr, row, png_bytep_NULL);
-                for (x = 0; x < w; x++)
-                {
-                    data = &(row[x]);
+        png->is_consumed = RT_TRUE;
+        channels = png_get_channels(png->png_ptr, png->info_ptr);
+        for (y = 0; y < h; y++)
+        {
+            png_read_row(png->png_ptr, row, png_bytep_NULL);
+            _image_png_blit_row(dc, format, line, row, channels, rect->x1, rect->y1 + y, w);
+        }
 
-                    rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1,
-                                              RTGUI_ARGB(0, png->info_ptr->palette[data[0]].red,
-                                                         png->info_ptr->palette[data[0]].green,
-                                                         png->info_ptr->palette[data[0]].blue));
-                }
-            }
+        rtgui_free(line);
+        rtgui_free(row);
+    }
+}
 
-        default:
-            break;
-        };
+/* the progressive reader of libpng, the rows are decoded when the data comes */
+struct rtgui_image_png_stream
+{
+    png_structp png_ptr;
+    png_infop info_ptr;
 
-        rtgui_free(row);
+    /* the rows updated in a feed */
+    int y1, y2;
+    rt_bool_t failed;
+};
+
+static void _image_png_stream_info(png_structp png_ptr, png_infop info_ptr)
+{
+    png_uint_32 width;
+    png_uint_32 height;
+    int bit_depth;
+    int color_type;
+    double gamma;
+    struct rtgui_image_stream *stream;
+    struct rtgui_image_png_stream *png;
+
+    stream = (struct rtgui_image_stream *)png_get_progressive_ptr(png_ptr);
+    png = (struct rtgui_image_png_stream *)stream->data;
+
+    png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth,
+                 &color_type, NULL, NULL, NULL);
+
+    /* the same transforms as _image_png_prepare */
+    if (bit_depth == 16)
+        png_set_strip_16(png_ptr);
+    if (color_type == PNG_COLOR_TYPE_PALETTE)
+        png_set_expand(png_ptr);
+    if (bit_depth < 8)
+        png_set_expand(png_ptr);
+    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+        png_set_expand(png_ptr);
+    if (color_type == PNG_COLOR_TYPE_GRAY ||
+            color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png_ptr);
+    if (png_get_gAMA(png_ptr, info_ptr, &gamma))
+        png_set_gamma(png_ptr, (double)2.2, gamma);
+
+    /* the rows in B, G, R, A bytes, which are the ARGB888 pixels of dc, so
+     * the passes of an interlaced image are combined in the dc directly */
+    png_set_bgr(png_ptr);
+    png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+    png_set_interlace_handling(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+
+    if (rtgui_image_stream_set_size(stream, width, height) != RT_TRUE)
+        png->failed = RT_TRUE;
+}
+
+static void _image_png_stream_row(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int pass)
+{
+    struct rtgui_image_stream *stream;
+    struct rtgui_image_png_stream *png;
+    struct rtgui_dc_buffer *buffer;
+
+    stream = (struct rtgui_image_stream *)png_get_progressive_ptr(png_ptr);
+    png = (struct rtgui_image_png_stream *)stream->data;
+    if (new_row == RT_NULL || png->failed == RT_TRUE || row_num >= stream->h)
+        return;
+
+    buffer = (struct rtgui_dc_buffer *)stream->dc;
+    png_progressive_combine_row(png_ptr, buffer->pixel + row_num * buffer->pitch, new_row);
+
+    if ((int)row_num < png->y1) png->y1 = row_num;
+    if ((int)row_num >= png->y2) png->y2 = row_num + 1;
+}
+
+static void _image_png_stream_done(png_structp png_ptr, png_infop info_ptr)
+{
+    struct rtgui_image_stream *stream;
+
+    stream = (struct rtgui_image_stream *)png_get_progressive_ptr(png_ptr);
+    stream->done = RT_TRUE;
+}
+
+static rt_bool_t rtgui_image_png_stream_begin(struct rtgui_image_stream *stream)
+{
+    struct rtgui_image_png_stream *png;
+
+    png = (struct rtgui_image_png_stream *)rtgui_malloc(sizeof(struct rtgui_image_png_stream));
+    if (png == RT_NULL) return RT_FALSE;
+
+    png->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (png->png_ptr == RT_NULL)
+    {
+        rtgui_free(png);
+        return RT_FALSE;
     }
+    png_set_error_fn(png->png_ptr, RT_NULL, _image_png_error_fn, _image_png_error_fn);
+
+    png->info_ptr = png_create_info_struct(png->png_ptr);
+    if (png->info_ptr == RT_NULL)
+    {
+        png_destroy_read_struct(&png->png_ptr, NULL, NULL);
+        rtgui_free(png);
+        return RT_FALSE;
+    }
+
+    png->failed = RT_FALSE;
+    stream->data = png;
+    png_set_progressive_read_fn(png->png_ptr, stream, _image_png_stream_info,
+                                _image_png_stream_row, _image_png_stream_done);
+
+    return RT_TRUE;
+}
+
+static rt_err_t rtgui_image_png_stream_feed(struct rtgui_image_stream *stream, const rt_uint8_t *data, rt_size_t length)
+{
+    struct rtgui_image_png_stream *png;
+
+    png = (struct rtgui_image_png_stream *)stream->data;
+    if (png->failed == RT_TRUE)
+        return -RT_ERROR;
+
+    png->y1 = stream->h;
+    png->y2 = 0;
+    png_process_data(png->png_ptr, png->info_ptr, (png_bytep)data, length);
+    if (png->failed == RT_TRUE)
+        return -RT_ERROR;
+
+    rtgui_image_stream_update(stream, png->y1, png->y2);
+
+    return RT_EOK;
+}
+
+static void rtgui_image_png_stream_end(struct rtgui_image_stream *stream)
+{
+    struct rtgui_image_png_stream *png;
+
+    png = (struct rtgui_image_png_stream *)stream->data;
+    png_destroy_read_struct(&png->png_ptr, &png->info_ptr, NULL);
+    rtgui_free(png);
 }
 
 void rtgui_image_png_init()
@@ -424,8 +686,27 @@ void rtgui_image_png_init()
 }
 
 #elif defined(GUIENGINE_IMAGE_LODEPNG)
+#include <stdlib.h>
 #include "lodepng.h"
 
+#if defined(GUIENGINE_IMAGE_PNG_ARGB4444) && defined(GUIENGINE_IMAGE_PNG_PREMULTIPLIED)
+#define PNG_PIXEL_FORMAT    RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE
+#elif defined(GUIENGINE_IMAGE_PNG_ARGB4444)
+#define PNG_PIXEL_FORMAT    RTGRAPHIC_PIXEL_FORMAT_ARGB4444
+#elif defined(GUIENGINE_IMAGE_PNG_PREMULTIPLIED)
+#define PNG_PIXEL_FORMAT    RTGRAPHIC_PIXEL_FORMAT_ARGB888_PRE
+#else
+#define PNG_PIXEL_FORMAT    RTGRAPHIC_PIXEL_FORMAT_ARGB888
+#endif
+
+struct rtgui_image_png
+{
+    /* PNG_PIXEL_FORMAT, the format of panel for the opaque image, or P8 for
+     * the palettized image with the palette of image */
+    rt_uint8_t pixel_format;
+    rt_uint8_t *pixels;
+};
+
 static rt_bool_t rtgui_image_png_check(struct rtgui_filerw *file);
 static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load);
 static void rtgui_image_png_unload(struct rtgui_image *image);
@@ -439,6 +720,7 @@ struct rtgui_image_engine rtgui_image_png_engine =
     rtgui_image_png_load,
     rtgui_image_png_unload,
     rtgui_image_png_blit,
+    rtgui_image_png_probe,
 };
 
 static rt_bool_t rtgui_image_png_check(struct rtgui_filerw *file)
@@ -470,6 +752,146 @@ static rt_bool_t rtgui_image_png_check(struct rtgui_filerw *file)
     return(is_PNG);
 }
 
+/* decode the opaque image to RGB888 and pack it into the format of panel */
+static rt_uint8_t *_image_png_decode_native(rt_uint8_t format, const rt_uint8_t *in, rt_uint32_t in_size,
+                                            unsigned int *width, unsigned int *height)
+{
+    unsigned int error;
+    rt_uint8_t *pixel = RT_NULL;
+    LodePNGState state;
+
+    lodepng_state_init(&state);
+    if (lodepng_inspect(width, height, &state, in, in_size) != 0 ||
+            lodepng_is_alpha_type(&state.info_png.color))
+        goto __exit;
+
+    state.info_raw.colortype = LCT_RGB;
+    state.info_raw.bitdepth = 8;
+    error = lodepng_decode(&pixel, width, height, &state, in, in_size);
+    if (error) goto __exit;
+
+    /* the transparent color key is known after decoding, keep the alpha */
+    if (lodepng_can_have_alpha(&state.info_png.color))
+    {
+        free(pixel);
+        pixel = RT_NULL;
+        goto __exit;
+    }
+
+    if (format == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+    {
+        rt_uint8_t *src = pixel, *end = pixel + *width * *height * 3;
+        rt_uint16_t *dst = (rt_uint16_t *)pixel;
+        rt_uint8_t *ptr;
+
+        /* the packed pixel is not larger than the source, convert in place */
+        while (src < end)
+        {
+            *dst++ = ((src[0] >> 3) << 11) | ((src[1] >> 2) << 5) | (src[2] >> 3);
+            src += 3;
+        }
+
+        ptr = realloc(pixel, *width * *height * 2);
+        if (ptr != RT_NULL) pixel = ptr;
+    }
+    else if (format == RTGRAPHIC_PIXEL_FORMAT_RGB332)
+    {
+        rt_uint8_t *src = pixel, *end = pixel + *width * *height * 3;
+        rt_uint8_t *dst = pixel;
+        rt_uint8_t *ptr;
+
+        while (src < end)
+        {
+            *dst++ = (src[0] & 0xe0) | ((src[1] >> 3) & 0x1c) | (src[2] >> 6);
+            src += 3;
+        }
+
+        ptr = realloc(pixel, *width * *height);
+        if (ptr != RT_NULL) pixel = ptr;
+    }
+    else
+    {
+        rt_uint8_t *ptr = pixel, *end = pixel + *width * *height * 3;
+
+        /* RGB888 is B,G,R in memory */
+        while (ptr < end)
+        {
+            rt_uint8_t r = ptr[0];
+
+            ptr[0] = ptr[2];
+            ptr[2] = r;
+            ptr += 3;
+        }
+    }
+
+__exit:
+    lodepng_state_cleanup(&state);
+    return pixel;
+}
+
+/* decode the palettized image to the indexes of P8 and the palette of them */
+static rt_uint8_t *_image_png_decode_palette(const rt_uint8_t *in, rt_uint32_t in_size,
+                                             unsigned int *width, unsigned int *height,
+                                             struct rtgui_image_palette **palette)
+{
+    unsigned int index, count, bits, bit;
+    rt_uint8_t *raw = RT_NULL, *pixel = RT_NULL;
+    LodePNGColorMode *color;
+    LodePNGState state;
+
+    lodepng_state_init(&state);
+    if (lodepng_inspect(width, height, &state, in, in_size) != 0 ||
+            state.info_png.color.colortype != LCT_PALETTE)
+        goto __exit;
+
+    /* keep the indexes in the bit depth of file */
+    state.decoder.color_convert = 0;
+    if (lodepng_decode(&raw, width, height, &state, in, in_size) != 0)
+        goto __exit;
+
+    color = &state.info_png.color;
+    bits = color->bitdepth;
+    *palette = rtgui_image_palette_create(1 << bits);
+    if (*palette == RT_NULL)
+        goto __exit;
+
+    /* the colors not in PLTE are transparent, the alpha of tRNS is in PLTE */
+    (*palette)->ncolors = 1 << bits;
+    for (index = 0; index < (*palette)->ncolors; index ++)
+    {
+        if (index < color->palettesize)
+            (*palette)->colors[index] = RTGUI_ARGB(color->palette[index * 4 + 3], color->palette[index * 4],
+                                                   color->palette[index * 4 + 1], color->palette[index * 4 + 2]);
+        else
+            (*palette)->colors[index] = TRANSPARENT;
+    }
+
+    if (bits == 8)
+    {
+        pixel = raw;
+        raw = RT_NULL;
+        goto __exit;
+    }
+
+    count = *width * *height;
+    pixel = malloc(count);
+    if (pixel == RT_NULL)
+    {
+        rtgui_free(*palette);
+        *palette = RT_NULL;
+        goto __exit;
+    }
+
+    /* the indexes are packed from the high bits, the rows are not padded */
+    for (index = 0, bit = 0; index < count; index ++, bit += bits)
+        pixel[index] = (raw[bit >> 3] >> (8 - bits - (bit & 7))) & ((1 << bits) - 1);
+
+__exit:
+    free(raw);
+    lodepng_state_cleanup(&state);
+    return pixel;
+}
+
 static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
 {
     unsigned int width;
@@ -479,6 +901,9 @@ static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_fi
     rt_uint8_t* pixel;
     rt_uint8_t* in;
     rt_uint32_t in_size;
+    rt_uint8_t format;
+    struct rtgui_image_png *png;
+    struct rtgui_graphic_driver *hw_driver = rtgui_graphic_driver_get_default();
 
     RT_ASSERT(image != RT_NULL);
     RT_ASSERT(file != RT_NULL);
@@ -491,24 +916,53 @@ static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_fi
     rtgui_filerw_seek(file, 0, SEEK_SET);
     rtgui_filerw_read(file, in, in_size, 1);
 
-    error = lodepng_decode32(&pixel, &width, &height, in, in_size);
-    if(error)
+    png = (struct rtgui_image_png *) rtgui_malloc(sizeof(struct rtgui_image_png));
+    if (png == RT_NULL)
     {
-        rt_kprintf("error %u: %s\n", error, lodepng_error_text(error));
         rtgui_free(in);
         return RT_FALSE;
     }
 
+    /* the opaque image is decoded in the format of panel, which costs less
+     * memory and is copied to the panel without conversion */
+    format = PNG_PIXEL_FORMAT;
+    /* the palettized image keeps one byte each pixel */
+    pixel = _image_png_decode_palette(in, in_size, &width, &height, &image->palette);
+    if (pixel != RT_NULL)
+        format = RTGRAPHIC_PIXEL_FORMAT_P8;
+    else if (hw_driver != RT_NULL && (hw_driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565 ||
+                                      hw_driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB888 ||
+                                      hw_driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB332))
+    {
+        pixel = _image_png_decode_native(hw_driver->pixel_format, in, in_size, &width, &height);
+        if (pixel != RT_NULL) format = hw_driver->pixel_format;
+    }
+
+    if (pixel == RT_NULL)
+    {
+        error = lodepng_decode32(&pixel, &width, &height, in, in_size);
+        if(error)
+        {
+            rt_kprintf("error %u: %s\n", error, lodepng_error_text(error));
+            rtgui_free(png);
+            rtgui_free(in);
+            return RT_FALSE;
+        }
+    }
+
     rtgui_free(in);
 
     /* set image information */
+    png->pixel_format = format;
+    png->pixels = pixel;
     image->w = width;
     image->h = height;
     image->engine = &rtgui_image_png_engine;
-    image->data = pixel;
+    image->data = png;
 
     /* NOTE: the pixel format of PNG is ABGR888, bit0 R,G,B,A bit31 */
     /* convert pixel to ARGB888, swap B/G */
+    if (format == PNG_PIXEL_FORMAT)
     {
         rt_uint8_t* pixel_ptr;
         rt_uint8_t* pixel_end;
@@ -521,9 +975,25 @@ static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_fi
             pixel_ptr[0] = pixel_ptr[0] ^ pixel_ptr[2];
             pixel_ptr[2] = pixel_ptr[0] ^ pixel_ptr[2];
             pixel_ptr[0] = pixel_ptr[0] ^ pixel_ptr[2];
+#ifdef GUIENGINE_IMAGE_PNG_PREMULTIPLIED
+            *(rtgui_color_t *)pixel_ptr = rtgui_color_premultiply(*(rtgui_color_t *)pixel_ptr);
+#endif
 
             pixel_ptr += 4;
         }
+
+#ifdef GUIENGINE_IMAGE_PNG_ARGB4444
+        {
+            rt_uint16_t *dst = (rt_uint16_t *)pixel;
+
+            /* the 4444 pixel is half of the source, pack it in place */
+            for (pixel_ptr = pixel; pixel_ptr < pixel_end; pixel_ptr += 4)
+                *dst++ = rtgui_color_to_4444(*(rtgui_color_t *)pixel_ptr);
+
+            pixel_ptr = realloc(pixel, width * height * 2);
+            if (pixel_ptr != RT_NULL) png->pixels = pixel_ptr;
+        }
+#endif
     }
 
     /* close file handler */
@@ -534,29 +1004,59 @@ static rt_bool_t rtgui_image_png_load(struct rtgui_image *image, struct rtgui_fi
 
 static void rtgui_image_png_unload(struct rtgui_image *image)
 {
-    rt_uint8_t *pixels;
+    struct rtgui_image_png *png;
 
     if (image != RT_NULL)
     {
-        pixels = (rt_uint8_t*) image->data;
+        png = (struct rtgui_image_png *) image->data;
 
         /* release data */
         //rtgui_free(pixels);
-        free(pixels);
+        free(png->pixels);
+        rtgui_free(png);
     }
 }
 
+rt_inline rtgui_color_t _image_png_get_pixel(struct rtgui_image *image, int x, int y)
+{
+    struct rtgui_image_png *png = (struct rtgui_image_png *) image->data;
+    rt_uint8_t *ptr;
+
+    ptr = png->pixels + (y * image->w + x) * rtgui_color_get_bpp(png->pixel_format);
+    if (png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565)
+        return rtgui_color_from_565(*(rt_uint16_t *)ptr) | 0xff000000;
+    if (png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB888)
+        return RTGUI_RGB(ptr[2], ptr[1], ptr[0]);
+    if (png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB332)
+        return rtgui_color_from_332(*ptr);
+    if (png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444 ||
+            png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB4444_PRE)
+        return rtgui_color_from_4444(*(rt_uint16_t *)ptr);
+#ifdef GUIENGINE_IMAGE_PNG_PREMULTIPLIED
+    if (png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_P8)
+        return rtgui_color_premultiply(image->palette->colors[*ptr]);
+#else
+    if (png->pixel_format == RTGRAPHIC_PIXEL_FORMAT_P8)
+        return image->palette->colors[*ptr];
+#endif
+
+    return *(rtgui_color_t *)ptr;
+}
+
 static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
 {
     int x, y;
     int w, h;
+    struct rtgui_image_png *png;
     struct rtgui_blit_info info = {0};
     struct rtgui_graphic_driver *hw_driver = rtgui_graphic_driver_get_default();
 
     RT_ASSERT(image != RT_NULL && dc != RT_NULL && rect != RT_NULL);
     RT_ASSERT(image->data != RT_NULL);
+    png = (struct rtgui_image_png *) image->data;
 
 #define blending(s, d, a) (((unsigned)(((s) - (d)) * (a)) >> 8) + (d))
+#define blending_premul(d, s, a) ((s) + (((unsigned)(d) * (256 - (a))) >> 8))
 
     /* this dc is not visible */
     if (rtgui_dc_get_visible(dc) != RT_TRUE) return;
@@ -585,7 +1085,7 @@ static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc,
     {
         int dx, dy, start_x;
         rtgui_rect_t r;
-        rtgui_color_t *pixel;
+        rtgui_color_t pixel;
         rt_uint8_t alpha;
         rtgui_widget_t *owner = RT_NULL;
 
@@ -612,14 +1112,13 @@ static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc,
                 if (y - rect->y1 < 0 || x - rect->x1 < 0)
                     continue;
 
-                pixel = (rtgui_color_t*)((rt_uint8_t*)image->data + (y - rect->y1) * image->w * 4 +
-                                         (x - rect->x1) * 4);
+                pixel = _image_png_get_pixel(image, x - rect->x1, y - rect->y1);
 
-                alpha = RTGUI_RGB_A(*pixel);
+                alpha = RTGUI_RGB_A(pixel);
                 if (alpha == 0) continue;
                 if (alpha == 0xff)
                 {
-                    rtgui_dc_draw_color_point(dc, x, y, *pixel);
+                    rtgui_dc_draw_color_point(dc, x, y, pixel);
                 }
                 else
                 {
@@ -627,8 +1126,15 @@ static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc,
 
                     /* draw an alpha blending point */
                     if (hw_driver->framebuffer != RT_NULL)
+                    {
+#ifdef GUIENGINE_IMAGE_PNG_PREMULTIPLIED
+                        fc = rtgui_color_unpremultiply(pixel);
+#else
+                        fc = pixel;
+#endif
                         rtgui_dc_blend_point(dc, x, y, RTGUI_BLENDMODE_BLEND,
-                                             RTGUI_RGB_R(*pixel), RTGUI_RGB_G(*pixel), RTGUI_RGB_B(*pixel), RTGUI_RGB_A(*pixel));
+                                             RTGUI_RGB_R(fc), RTGUI_RGB_G(fc), RTGUI_RGB_B(fc), RTGUI_RGB_A(fc));
+                    }
                     else
                     {
                         x = x + dx;
@@ -643,9 +1149,15 @@ static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc,
                         /* get background pixel */
                         hw_driver->ops->get_pixel(&bc, x, y);
                         /* alpha blending */
-                        fc = RTGUI_RGB(blending(RTGUI_RGB_R(bc), RTGUI_RGB_R(*pixel),  alpha),
-                                       blending(RTGUI_RGB_G(bc), RTGUI_RGB_G(*pixel),  alpha),
-                                       blending(RTGUI_RGB_B(bc), RTGUI_RGB_B(*pixel),  alpha));
+#ifdef GUIENGINE_IMAGE_PNG_PREMULTIPLIED
+                        fc = RTGUI_RGB(blending_premul(RTGUI_RGB_R(bc), RTGUI_RGB_R(pixel),  alpha),
+                                       blending_premul(RTGUI_RGB_G(bc), RTGUI_RGB_G(pixel),  alpha),
+                                       blending_premul(RTGUI_RGB_B(bc), RTGUI_RGB_B(pixel),  alpha));
+#else
+                        fc = RTGUI_RGB(blending(RTGUI_RGB_R(bc), RTGUI_RGB_R(pixel),  alpha),
+                                       blending(RTGUI_RGB_G(bc), RTGUI_RGB_G(pixel),  alpha),
+                                       blending(RTGUI_RGB_B(bc), RTGUI_RGB_B(pixel),  alpha));
+#endif
                         hw_driver->ops->set_pixel(&fc, x, y);
                     }
                 }
@@ -659,12 +1171,14 @@ static void rtgui_image_png_blit(struct rtgui_image *image, struct rtgui_dc *dc,
         info.a = 255;
 
         /* initialize source blit information */
-        info.src_fmt = RTGRAPHIC_PIXEL_FORMAT_ARGB888;
+        info.src_fmt = png->pixel_format;
+        if (image->palette != RT_NULL)
+            info.palette = image->palette->colors;
         info.src_h = h;
         info.src_w = w;
-        info.src_pitch = image->w * rtgui_color_get_bpp(RTGRAPHIC_PIXEL_FORMAT_ARGB888);
-        info.src_skip = info.src_pitch - w * rtgui_color_get_bpp(RTGRAPHIC_PIXEL_FORMAT_ARGB888);
-        info.src = (rt_uint8_t *)image->data + y * info.src_pitch + x * rtgui_color_get_bpp(RTGRAPHIC_PIXEL_FORMAT_ARGB888);
+        info.src_pitch = image->w * rtgui_color_get_bpp(png->pixel_format);
+        info.src_skip = info.src_pitch - w * rtgui_color_get_bpp(png->pixel_format);
+        info.src = png->pixels + y * info.src_pitch + x * rtgui_color_get_bpp(png->pixel_format);
 
         if (rect->x1 < 0) dst_x = 0;
         else dst_x = rect->x1;
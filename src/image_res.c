@@ -0,0 +1,130 @@
+/*
+ * File      : image_res.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/image_res.h>
+#include <rtgui/rtgui_system.h>
+
+struct rtgui_image_res
+{
+    rt_list_t list;
+    const struct rtgui_image_res_header *header;
+};
+
+static rt_list_t _image_res_list = RT_LIST_OBJECT_INIT(_image_res_list);
+
+rt_err_t rtgui_image_res_mount(const void *archive)
+{
+    rt_uint32_t index;
+    struct rtgui_image_res *res;
+    const struct rtgui_image_res_entry *entry;
+    const struct rtgui_image_res_header *header = (const struct rtgui_image_res_header *)archive;
+
+    if (header == RT_NULL || ((rt_ubase_t)header & 0x03)) return -RT_ERROR;
+    if (rt_memcmp(header->magic, RTGUI_IMAGE_RES_MAGIC, sizeof(header->magic)) != 0)
+        return -RT_ERROR;
+
+    /* the images are checked by the image engine when created */
+    entry = (const struct rtgui_image_res_entry *)(header + 1);
+    for (index = 0; index < header->count; index ++)
+    {
+        if (entry[index].offset & 0x03) return -RT_ERROR;
+    }
+
+    res = (struct rtgui_image_res *)rtgui_malloc(sizeof(struct rtgui_image_res));
+    if (res == RT_NULL) return -RT_ENOMEM;
+
+    res->header = header;
+    rt_list_insert_before(&_image_res_list, &res->list);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_image_res_mount);
+
+void rtgui_image_res_unmount(const void *archive)
+{
+    struct rtgui_image_res *res;
+    rt_list_t *node;
+
+    rt_list_for_each(node, &_image_res_list)
+    {
+        res = rt_list_entry(node, struct rtgui_image_res, list);
+        if (res->header == archive)
+        {
+            rt_list_remove(&res->list);
+            rtgui_free(res);
+            return;
+        }
+    }
+}
+RTM_EXPORT(rtgui_image_res_unmount);
+
+/* the entries are sorted by name, find the name in binary search */
+static const struct rtgui_image_res_entry *_image_res_find(const struct rtgui_image_res_header *header,
+                                                           const char *name)
+{
+    int low, high, mid, result;
+    const struct rtgui_image_res_entry *entry;
+
+    entry = (const struct rtgui_image_res_entry *)(header + 1);
+    low = 0;
+    high = (int)header->count - 1;
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        result = rt_strcmp(name, (const char *)header + entry[mid].name);
+        if (result == 0)
+            return &entry[mid];
+
+        if (result < 0) high = mid - 1;
+        else low = mid + 1;
+    }
+
+    return RT_NULL;
+}
+
+struct rtgui_image *rtgui_image_res_create(const char *name, rt_bool_t load)
+{
+    rt_list_t *node;
+    struct rtgui_image_res *res;
+    const struct rtgui_image_res_entry *entry;
+
+    RT_ASSERT(name != RT_NULL);
+
+    rt_list_for_each(node, &_image_res_list)
+    {
+        res = rt_list_entry(node, struct rtgui_image_res, list);
+
+        entry = _image_res_find(res->header, name);
+        if (entry != RT_NULL)
+        {
+            return rtgui_image_create_from_mem("hdc", (const rt_uint8_t *)res->header + entry->offset,
+                                               entry->length, load);
+        }
+    }
+
+    return RT_NULL;
+}
+RTM_EXPORT(rtgui_image_res_create);
@@ -21,16 +21,42 @@
  * Date           Author       Notes
  * 2009-10-16     Bernard      first version
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
 #include <stdio.h>
 #include <string.h>
 
 #include <rtgui/filerw.h>
 #include <rtgui/rtgui_system.h>
 #include <rtgui/image.h>
+#include <rtgui/dc.h>
 
 #ifdef GUIENGINE_IMAGE_XPM
 #define XPM_MAGIC_LEN       9
 
+/*
+ * The XPM compiled to the indexes of its colors, 1 byte for the XPM of
+ * 256 colors, otherwise 2 bytes. With GUIENGINE_USING_XPM_CACHE, the XPM is
+ * compiled once and shared by the images loaded from the same data.
+ */
+struct rtgui_image_xpm
+{
+    rt_list_t list;
+    /* the data compiled */
+    const char **xpm;
+    int ref_count;
+
+    rt_uint16_t w, h;
+    int ncolors;
+    rt_uint8_t index_size;
+    /* the colors of transparent None are in alpha 0 */
+    rtgui_color_t *colors;
+    rt_uint8_t *indexes;
+};
+
+#define _xpm_index(xpm, i)  ((xpm)->index_size == 1 ? (xpm)->indexes[i] : \
+                             ((rt_uint16_t *)(xpm)->indexes)[i])
+
 static rt_bool_t rtgui_image_xpm_check(struct rtgui_filerw *file);
 static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load);
 static void rtgui_image_xpm_unload(struct rtgui_image *image);
@@ -297,7 +323,7 @@ const struct rgb_item rgbRecord[234] =
 struct hash_entry
 {
     char key[10];
-    rtgui_color_t color;
+    int index;
     struct hash_entry *next;
 };
 
@@ -351,12 +377,12 @@ static struct color_hash *create_colorhash(int maxnum)
 }
 
 static int add_colorhash(struct color_hash *hash,
-                         char *key, int cpp, rtgui_color_t *color)
+                         char *key, int cpp, int color)
 {
     int index = hash_key(key, cpp, hash->size);
     struct hash_entry *e = hash->next_free++;
 
-    e->color = *color;
+    e->index = color;
     rt_memset(e->key, 0, sizeof(e->key));
     rt_strncpy(e->key, key, cpp);
     e->next = hash->table[index];
@@ -365,22 +391,20 @@ static int add_colorhash(struct color_hash *hash,
     return 1;
 }
 
-static void get_colorhash(struct color_hash *hash, const char *key, int cpp, rtgui_color_t *c)
+static int get_colorhash(struct color_hash *hash, const char *key, int cpp)
 {
     struct hash_entry *entry = hash->table[hash_key(key, cpp, hash->size)];
     while (entry)
     {
         if (rt_memcmp(key, entry->key, cpp) == 0)
         {
-            *c = entry->color;
-
-            return;
+            return entry->index;
         }
 
         entry = entry->next;
     }
 
-    return ;        /* garbage in - garbage out */
+    return 0;       /* garbage in - garbage out */
 }
 
 static void free_colorhash(struct color_hash *hash)
@@ -434,8 +458,17 @@ static int hex2int(const char *str)
     return r;
 }
 
+#ifdef GUIENGINE_USING_XPM_CACHE
+/* the XPMs compiled, they are kept for the next loads */
+static rt_list_t _xpm_list = RT_LIST_OBJECT_INIT(_xpm_list);
+static struct rt_mutex _xpm_lock;
+#endif
+
 void rtgui_image_xpm_init()
 {
+#ifdef GUIENGINE_USING_XPM_CACHE
+    rt_mutex_init(&_xpm_lock, "xpm", RT_IPC_FLAG_FIFO);
+#endif
     /* register xpm engine */
     rtgui_image_register_engine(&rtgui_image_xpm_engine);
 }
@@ -488,9 +521,9 @@ static int _str2int(const char *str, int strlen, int *p)
     return i;
 }
 
-static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+/* parse the colors and pixels of XPM to the indexes of colors */
+static struct rtgui_image_xpm *_xpm_compile(const char **xpm)
 {
-    const char **xpm;
     const char *buf;
     const char *buf_tmp;
 
@@ -499,18 +532,12 @@ static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_fi
     int colors_pp = 0;
 
     int i, j;
+    rt_uint8_t index_size;
+    struct rtgui_image_xpm *compiled;
 
     /* color hash table */
     struct color_hash *colors_table = RT_NULL;
 
-    if (image == RT_NULL) return RT_FALSE;
-
-    xpm = (const char **)rtgui_filerw_mem_getdata(file);
-    if (xpm == RT_NULL) return RT_FALSE;
-
-    /* set image engine */
-    image->engine = &rtgui_image_xpm_engine;
-
     /* parse xpm image */
     i = rt_strlen(xpm[0]);
     /* Add one for the space. */
@@ -518,14 +545,30 @@ static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_fi
     j += _str2int(xpm[0] + j, i - j, &h) + 1;
     j += _str2int(xpm[0] + j, i - j, &colors) + 1;
     j += _str2int(xpm[0] + j, i - j, &colors_pp) + 1;
-    image->w = w;
-    image->h = h;
+    if (w <= 0 || h <= 0 || colors <= 0 || colors_pp <= 0 || colors_pp >= 10)
+        return RT_NULL;
+
+    /* the colors and indexes follow the struct */
+    index_size = colors > 256 ? 2 : 1;
+    compiled = (struct rtgui_image_xpm *)rtgui_malloc(sizeof(struct rtgui_image_xpm) +
+               colors * sizeof(rtgui_color_t) + w * h * index_size);
+    if (compiled == RT_NULL)
+        return RT_NULL;
+    compiled->xpm = xpm;
+    compiled->ref_count = 1;
+    compiled->w = w;
+    compiled->h = h;
+    compiled->ncolors = colors;
+    compiled->index_size = index_size;
+    compiled->colors = (rtgui_color_t *)(compiled + 1);
+    compiled->indexes = (rt_uint8_t *)(compiled->colors + colors);
 
     /* build color table */
     colors_table = create_colorhash(colors);
     if (!colors_table)
     {
-        return RT_FALSE;
+        rtgui_free(compiled);
+        return RT_NULL;
     }
 
     for (i = 0; i < colors; i++)
@@ -544,9 +587,9 @@ static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_fi
         /* build rtgui_color */
         if ((buf_tmp = strstr(buf, "c #")) != RT_NULL)
         {
-            c = RTGUI_ARGB(0, hex2int(buf_tmp + 3),
-                           hex2int(buf_tmp + 5),
-                           hex2int(buf_tmp + 7));
+            c = RTGUI_RGB(hex2int(buf_tmp + 3),
+                          hex2int(buf_tmp + 5),
+                          hex2int(buf_tmp + 7));
         }
         else if ((buf_tmp = strstr(buf, "c ")) != RT_NULL)
         {
@@ -561,9 +604,9 @@ static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_fi
             {
                 if (strcasecmp(buf_tmp + 2, rgbRecord[k].name) == 0)
                 {
-                    c = RTGUI_ARGB(0, rgbRecord[k].r,
-                                   rgbRecord[k].g,
-                                   rgbRecord[k].b);
+                    c = RTGUI_RGB(rgbRecord[k].r,
+                                  rgbRecord[k].g,
+                                  rgbRecord[k].b);
                     break;
                 }
             }
@@ -571,33 +614,78 @@ static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_fi
         else
         {
 color_none:
-            c = RTGUI_RGB(0, 0, 0);
+            c = RTGUI_ARGB(0, 0, 0, 0);
         }
 
         /* add to color hash table */
-        add_colorhash(colors_table, color_name, colors_pp, &c);
+        compiled->colors[i] = c;
+        add_colorhash(colors_table, color_name, colors_pp, i);
+    }
+
+    /* build the indexes of pixels */
+    for (h = 0, i = 0; h < compiled->h; h++)
+    {
+        buf = xpm[colors + 1 + h];
+        for (w = 0; w < compiled->w; w++, i++, buf += colors_pp)
+        {
+            if (index_size == 1)
+                compiled->indexes[i] = (rt_uint8_t)get_colorhash(colors_table, buf, colors_pp);
+            else
+                ((rt_uint16_t *)compiled->indexes)[i] = (rt_uint16_t)get_colorhash(colors_table, buf, colors_pp);
+        }
     }
 
-    /* build rgb pixel data */
-    image->data = (rt_uint8_t *) rtgui_malloc(image->w * image->h * sizeof(rtgui_color_t));
-    memset(image->data, 0, image->w * image->h * sizeof(rtgui_color_t));
+    free_colorhash(colors_table);
+
+    return compiled;
+}
+
+static rt_bool_t rtgui_image_xpm_load(struct rtgui_image *image, struct rtgui_filerw *file, rt_bool_t load)
+{
+    const char **xpm;
+    struct rtgui_image_xpm *compiled = RT_NULL;
+
+    if (image == RT_NULL) return RT_FALSE;
+
+    xpm = (const char **)rtgui_filerw_mem_getdata(file);
+    if (xpm == RT_NULL) return RT_FALSE;
 
+#ifdef GUIENGINE_USING_XPM_CACHE
+    rt_mutex_take(&_xpm_lock, RT_WAITING_FOREVER);
     {
-        rtgui_color_t *ptr = (rtgui_color_t *) image->data;
+        rt_list_t *node;
 
-        for (h = 0; h < image->h; h++)
+        /* the XPM compiled is shared, no parsing of strings */
+        rt_list_for_each(node, &_xpm_list)
         {
-            buf = xpm[colors + 1 + h];
-            for (w = 0; w < image->w; w++, buf += colors_pp)
+            compiled = rt_list_entry(node, struct rtgui_image_xpm, list);
+            if (compiled->xpm == xpm)
             {
-                get_colorhash(colors_table, buf, colors_pp, ptr);
-
-                ptr ++;
+                compiled->ref_count ++;
+                break;
             }
+            compiled = RT_NULL;
         }
     }
+    if (compiled == RT_NULL)
+    {
+        compiled = _xpm_compile(xpm);
+        if (compiled != RT_NULL)
+            rt_list_insert_after(&_xpm_list, &compiled->list);
+    }
+    rt_mutex_release(&_xpm_lock);
+#else
+    compiled = _xpm_compile(xpm);
+#endif
+    if (compiled == RT_NULL)
+        return RT_FALSE;
+
+    /* set image engine */
+    image->engine = &rtgui_image_xpm_engine;
+    image->w = compiled->w;
+    image->h = compiled->h;
+    image->data = compiled;
 
-    free_colorhash(colors_table);
     rtgui_filerw_close(file);
 
     return RT_TRUE;
@@ -605,38 +693,132 @@ color_none:
 
 static void rtgui_image_xpm_unload(struct rtgui_image *image)
 {
-    if (image != RT_NULL)
+    if (image != RT_NULL && image->data != RT_NULL)
     {
+#ifdef GUIENGINE_USING_XPM_CACHE
+        struct rtgui_image_xpm *compiled = (struct rtgui_image_xpm *)image->data;
+
+        /* the XPM compiled is kept in the cache for the next load */
+        rt_mutex_take(&_xpm_lock, RT_WAITING_FOREVER);
+        compiled->ref_count --;
+        rt_mutex_release(&_xpm_lock);
+#else
         /* release data */
         rtgui_free(image->data);
+#endif
         image->data = RT_NULL;
     }
 }
 
+#ifdef GUIENGINE_USING_XPM_CACHE
+/* release the XPMs compiled not in use */
+void rtgui_image_xpm_cache_flush(void)
+{
+    struct rtgui_image_xpm *compiled;
+    rt_list_t *node, *next;
+
+    rt_mutex_take(&_xpm_lock, RT_WAITING_FOREVER);
+    for (node = _xpm_list.next; node != &_xpm_list; node = next)
+    {
+        next = node->next;
+        compiled = rt_list_entry(node, struct rtgui_image_xpm, list);
+        if (compiled->ref_count == 0)
+        {
+            rt_list_remove(&compiled->list);
+            rtgui_free(compiled);
+        }
+    }
+    rt_mutex_release(&_xpm_lock);
+}
+RTM_EXPORT(rtgui_image_xpm_cache_flush);
+#endif
+
+static void _xpm_store(rt_uint8_t *ptr, int bpp, rt_uint32_t pixel)
+{
+    switch (bpp)
+    {
+    case 1:
+        *ptr = (rt_uint8_t)pixel;
+        break;
+    case 2:
+        *(rt_uint16_t *)ptr = (rt_uint16_t)pixel;
+        break;
+    case 3:
+        ptr[0] = (rt_uint8_t)pixel;
+        ptr[1] = (rt_uint8_t)(pixel >> 8);
+        ptr[2] = (rt_uint8_t)(pixel >> 16);
+        break;
+    default:
+        *(rt_uint32_t *)ptr = pixel;
+        break;
+    }
+}
+
+/*
+ * The colors are converted to the native pixels of dc once in the blit, and
+ * the runs of opaque pixels in a row are drawn by blit_line. The transparent
+ * None is skipped.
+ */
 static void rtgui_image_xpm_blit(struct rtgui_image *image, struct rtgui_dc *dc, struct rtgui_rect *rect)
 {
-    rt_uint16_t x, y;
-    rtgui_color_t *ptr;
+    int x, y, w, h, bpp, start, index;
+    rt_uint8_t fmt, *line;
+    rt_uint32_t pixel, *pixels;
+    struct rtgui_image_xpm *xpm;
 
     RT_ASSERT(image != RT_NULL && dc != RT_NULL && rect != RT_NULL);
     RT_ASSERT(image->data != RT_NULL);
 
-    ptr = (rtgui_color_t *) image->data;
+    xpm = (struct rtgui_image_xpm *)image->data;
+    w = _UI_MIN(image->w, rtgui_rect_width(*rect));
+    h = _UI_MIN(image->h, rtgui_rect_height(*rect));
+    if (w <= 0 || h <= 0 || !rtgui_dc_get_visible(dc))
+        return;
+
+    fmt = rtgui_dc_get_pixel_format(dc);
+    bpp = rtgui_color_get_bpp(fmt);
+    pixels = RT_NULL;
+    if (bpp > 0 && bpp <= 4 && rtgui_color_to_pixel(fmt, xpm->colors[0], &pixel))
+        pixels = (rt_uint32_t *)rtgui_malloc(xpm->ncolors * sizeof(rt_uint32_t) + w * bpp);
 
-    /* draw each point within dc */
-    for (y = 0; y < image->h; y ++)
+    if (pixels == RT_NULL)
     {
-        for (x = 0; x < image->w; x++)
+        /* the formats without native pixel, draw each point */
+        for (y = 0; y < h; y ++)
         {
-            /* not alpha */
-            if ((*ptr >> 24) != 255)
+            for (x = 0; x < w; x ++)
             {
-                rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1, *ptr);
+                index = _xpm_index(xpm, y * xpm->w + x);
+                if (RTGUI_RGB_A(xpm->colors[index]) != 0)
+                    rtgui_dc_draw_color_point(dc, x + rect->x1, y + rect->y1, xpm->colors[index]);
             }
+        }
+        return;
+    }
+
+    for (index = 0; index < xpm->ncolors; index ++)
+        rtgui_color_to_pixel(fmt, xpm->colors[index], &pixels[index]);
+    line = (rt_uint8_t *)(pixels + xpm->ncolors);
 
-            /* move to next color buffer */
-            ptr ++;
+    for (y = 0; y < h; y ++)
+    {
+        for (x = 0, start = -1; x <= w; x ++)
+        {
+            index = x < w ? _xpm_index(xpm, y * xpm->w + x) : 0;
+            if (x < w && RTGUI_RGB_A(xpm->colors[index]) != 0)
+            {
+                if (start < 0) start = x;
+                _xpm_store(line + x * bpp, bpp, pixels[index]);
+            }
+            else if (start >= 0)
+            {
+                dc->engine->blit_line(dc, rect->x1 + start, rect->x1 + x, rect->y1 + y,
+                                      line + start * bpp);
+                start = -1;
+            }
         }
     }
+
+    rtgui_free(pixels);
 }
 #endif
@@ -0,0 +1,330 @@
+/*
+ * File      : listview.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/widgets/window.h>
+#include <rtgui/widgets/listview.h>
+
+static void _rtgui_listview_constructor(rtgui_listview_t *view)
+{
+    rtgui_object_set_event_handler(RTGUI_OBJECT(view), rtgui_listview_event_handler);
+
+    view->source = RT_NULL;
+    view->count = 0;
+    view->item_height = 1;
+    view->scroll = 0;
+    view->rows = RT_NULL;
+    view->row_items = RT_NULL;
+    view->row_count = 0;
+}
+
+static void _rtgui_listview_destructor(rtgui_listview_t *view)
+{
+    /* the rows are destroyed as the children */
+    if (view->rows != RT_NULL)
+        rtgui_free(view->rows);
+    if (view->row_items != RT_NULL)
+        rtgui_free(view->row_items);
+}
+
+DEFINE_CLASS_TYPE(listview, "listview",
+                  RTGUI_PARENT_TYPE(container),
+                  _rtgui_listview_constructor,
+                  _rtgui_listview_destructor,
+                  sizeof(struct rtgui_listview));
+RTM_EXPORT(_rtgui_listview);
+
+rtgui_listview_t *rtgui_listview_create(const struct rtgui_listview_source *source, int item_height)
+{
+    rtgui_listview_t *view;
+
+    RT_ASSERT(source != RT_NULL && item_height > 0);
+
+    view = (rtgui_listview_t *)rtgui_widget_create(RTGUI_LISTVIEW_TYPE);
+    if (view != RT_NULL)
+    {
+        view->source = source;
+        view->item_height = item_height;
+    }
+
+    return view;
+}
+RTM_EXPORT(rtgui_listview_create);
+
+void rtgui_listview_destroy(rtgui_listview_t *view)
+{
+    rtgui_widget_destroy(RTGUI_WIDGET(view));
+}
+RTM_EXPORT(rtgui_listview_destroy);
+
+/* the rows to cover the view in any scroll, not more than the items */
+static int _listview_rows_needed(rtgui_listview_t *view)
+{
+    int need;
+
+    need = rtgui_rect_height(RTGUI_WIDGET(view)->extent) / view->item_height + 2;
+    return need < view->count ? need : view->count;
+}
+
+static int _listview_max_scroll(rtgui_listview_t *view)
+{
+    int max;
+
+    max = view->count * view->item_height - rtgui_rect_height(RTGUI_WIDGET(view)->extent);
+    return max > 0 ? max : 0;
+}
+
+static void _listview_pool(rtgui_listview_t *view)
+{
+    int need, slot;
+    int *items;
+    rtgui_rect_t rect;
+    rtgui_widget_t *row, **rows;
+    rtgui_widget_t *widget = RTGUI_WIDGET(view);
+
+    need = _listview_rows_needed(view);
+    if (need <= view->row_count)
+        return;
+
+    rows = (rtgui_widget_t **)rtgui_realloc(view->rows, need * sizeof(rtgui_widget_t *));
+    if (rows == RT_NULL)
+        return;
+    view->rows = rows;
+    items = (int *)rtgui_realloc(view->row_items, need * sizeof(int));
+    if (items == RT_NULL)
+        return;
+    view->row_items = items;
+
+    rect = widget->extent;
+    rect.y2 = rect.y1 + view->item_height;
+    for (slot = view->row_count; slot < need; slot ++)
+    {
+        row = view->source->create_row(view);
+        if (row == RT_NULL)
+            break;
+
+        rtgui_container_add_child(RTGUI_CONTAINER(view), row);
+        rtgui_widget_set_rect(row, &rect);
+        RTGUI_WIDGET_HIDE(row);
+        view->rows[slot] = row;
+        view->row_items[slot] = -1;
+        view->row_count ++;
+    }
+}
+
+/*
+ * Bind the items in view to the rows and move the rows to them. The row of a
+ * slot keeps its item in scroll until the item is out of view, so only the
+ * rows scrolled in are bound again.
+ */
+static void _listview_place(rtgui_listview_t *view)
+{
+    int slot, index, first, y;
+    rtgui_widget_t *row;
+    rtgui_widget_t *widget = RTGUI_WIDGET(view);
+
+    if (view->row_count == 0)
+        return;
+
+    first = view->scroll / view->item_height;
+    for (slot = 0; slot < view->row_count; slot ++)
+    {
+        row = view->rows[slot];
+        index = first + (slot - first % view->row_count + view->row_count) % view->row_count;
+        if (index >= view->count)
+        {
+            RTGUI_WIDGET_HIDE(row);
+            view->row_items[slot] = -1;
+            continue;
+        }
+
+        if (view->row_items[slot] != index)
+        {
+            view->row_items[slot] = index;
+            view->source->bind_row(view, row, index);
+        }
+        if (RTGUI_WIDGET_IS_HIDE(row))
+        {
+            RTGUI_WIDGET_UNHIDE(row);
+            rtgui_widget_clip_dirty(row);
+        }
+
+        y = widget->extent.y1 + index * view->item_height - view->scroll;
+        if (y != row->extent.y1)
+            rtgui_widget_move_to_logic(row, 0, y - row->extent.y1);
+    }
+
+    rtgui_widget_update_clip(widget);
+}
+
+/* fit the rows to the extent of view */
+static void _listview_layout(rtgui_listview_t *view)
+{
+    int slot;
+    rtgui_rect_t rect;
+    rtgui_widget_t *row;
+    rtgui_widget_t *widget = RTGUI_WIDGET(view);
+
+    for (slot = 0; slot < view->row_count; slot ++)
+    {
+        row = view->rows[slot];
+        if (row->extent.x1 != widget->extent.x1 || row->extent.x2 != widget->extent.x2)
+        {
+            rect = row->extent;
+            rect.x1 = widget->extent.x1;
+            rect.x2 = widget->extent.x2;
+            rtgui_widget_set_rect(row, &rect);
+        }
+    }
+
+    _listview_pool(view);
+    if (view->scroll > _listview_max_scroll(view))
+        view->scroll = _listview_max_scroll(view);
+    _listview_place(view);
+}
+
+rt_bool_t rtgui_listview_event_handler(struct rtgui_object *object, struct rtgui_event *event)
+{
+    rtgui_listview_t *view;
+
+    RT_ASSERT(object != RT_NULL);
+    RT_ASSERT(event != RT_NULL);
+
+    view = RTGUI_LISTVIEW(object);
+    switch (event->type)
+    {
+    case RTGUI_EVENT_RESIZE:
+        _listview_layout(view);
+        return RT_FALSE;
+
+    case RTGUI_EVENT_PAINT:
+        /* the extent set by rtgui_widget_set_rect comes without resize */
+        if (_listview_rows_needed(view) > view->row_count ||
+                (view->row_count > 0 &&
+                 rtgui_rect_width(view->rows[0]->extent) != rtgui_rect_width(RTGUI_WIDGET(view)->extent)))
+            _listview_layout(view);
+        break;
+
+    default:
+        break;
+    }
+
+    return rtgui_container_event_handler(object, event);
+}
+RTM_EXPORT(rtgui_listview_event_handler);
+
+void rtgui_listview_set_count(rtgui_listview_t *view, int count)
+{
+    int slot;
+    rtgui_widget_t *widget;
+
+    RT_ASSERT(view != RT_NULL && count >= 0);
+
+    widget = RTGUI_WIDGET(view);
+    view->count = count;
+    for (slot = 0; slot < view->row_count; slot ++)
+        view->row_items[slot] = -1;
+    _listview_layout(view);
+
+    if (widget->toplevel != RT_NULL && !RTGUI_WIDGET_IS_HIDE(widget))
+        rtgui_widget_update_rect(widget, RT_NULL);
+}
+RTM_EXPORT(rtgui_listview_set_count);
+
+/*
+ * Scroll the items in view by copying their pixels, the rows scrolled in are
+ * bound and painted in the exposed area only. The cost is the same for any
+ * number of items.
+ */
+void rtgui_listview_scroll_to(rtgui_listview_t *view, int y)
+{
+    int dy;
+    struct rtgui_dc *dc;
+    rtgui_rect_t rect;
+    rtgui_region_t saved, exposed;
+    rtgui_widget_t *widget;
+
+    RT_ASSERT(view != RT_NULL);
+
+    widget = RTGUI_WIDGET(view);
+    if (y > _listview_max_scroll(view))
+        y = _listview_max_scroll(view);
+    if (y < 0)
+        y = 0;
+    dy = view->scroll - y;
+    if (dy == 0)
+        return;
+    view->scroll = y;
+
+    if (widget->toplevel == RT_NULL || RTGUI_WIDGET_IS_HIDE(widget))
+    {
+        _listview_place(view);
+        return;
+    }
+    if (dy >= rtgui_rect_height(widget->extent) || -dy >= rtgui_rect_height(widget->extent))
+    {
+        _listview_place(view);
+        rtgui_widget_update_rect(widget, RT_NULL);
+        return;
+    }
+
+    /* the clip of view excludes the rows, scroll in the visible view */
+    saved = widget->clip;
+    rtgui_region_init(&(widget->clip));
+    rect = widget->extent_visiable;
+    rtgui_region_intersect_rect(&(widget->clip), &(widget->toplevel->outer_clip), &rect);
+    rtgui_region_init(&exposed);
+    dc = rtgui_dc_begin_drawing(widget);
+    if (dc != RT_NULL)
+    {
+        rtgui_widget_get_rect(widget, &rect);
+        rtgui_dc_scroll(dc, &rect, 0, dy, &exposed);
+        rtgui_dc_end_drawing(dc, 1);
+    }
+    rtgui_widget_clip_restore(widget, &saved);
+
+    _listview_place(view);
+    if (rtgui_region_not_empty(&exposed))
+        rtgui_widget_update_rect(widget, rtgui_region_extents(&exposed));
+    rtgui_region_fini(&exposed);
+}
+RTM_EXPORT(rtgui_listview_scroll_to);
+
+void rtgui_listview_item_changed(rtgui_listview_t *view, int index)
+{
+    int slot;
+
+    RT_ASSERT(view != RT_NULL);
+
+    if (view->row_count == 0 || index < 0 || index >= view->count)
+        return;
+
+    slot = index % view->row_count;
+    if (view->row_items[slot] == index)
+    {
+        view->source->bind_row(view, view->rows[slot], index);
+        rtgui_widget_invalidate(view->rows[slot], RT_NULL);
+    }
+}
+RTM_EXPORT(rtgui_listview_item_changed);
@@ -52,15 +52,30 @@ struct rtgui_cursor
     /* cursor image and saved cursor */
     rtgui_image_t   *cursor_image;
     rt_uint8_t      *cursor_saved;
+
+    /* the cursor is an overlay plane, not drawn in framebuffer */
+    rt_bool_t overlay;
+
+#ifndef GUIENGINE_USING_RECT_LOCK
+    /* the area drawn by the apps, the cursor over it is hidden */
+    rt_uint16_t drawing;
+    rtgui_rect_t drawing_rect;
+    rt_bool_t drawing_hidden;
+
+    /* the move into the area drawn is deferred until the drawing ends */
+    rt_bool_t moving;
+    int mx, my;
+#endif
 #endif
 
 #ifdef RTGUI_USING_WINMOVE
     /* move window rect and border */
     struct rtgui_win *win;
     rtgui_rect_t    win_rect;
-    rt_uint8_t      *win_left, *win_right;
-    rt_uint8_t      *win_top, *win_bottom;
-    rt_bool_t       win_rect_show, win_rect_has_saved;
+    rt_bool_t       win_rect_show, win_rect_drawn;
+    /* the cursor position when the outline is drawn, the outline follows
+     * the cursor once a frame */
+    rt_uint16_t     win_cx, win_cy;
 #endif
 };
 
@@ -130,9 +145,36 @@ static void rtgui_cursor_show(void);
 #endif
 
 #ifdef RTGUI_USING_WINMOVE
-static void rtgui_winrect_restore(void);
-static void rtgui_winrect_save(void);
-static void rtgui_winrect_show(void);
+static void rtgui_winrect_xor(void);
+#endif
+
+#ifdef RTGUI_USING_MOUSE_CURSOR
+/* upload the cursor image to the overlay plane */
+static void _rtgui_cursor_set_overlay(const struct rtgui_graphic_driver *gd)
+{
+    int index, size;
+    rtgui_color_t *src, *pixels;
+
+    size = _rtgui_cursor->cursor_image->w * _rtgui_cursor->cursor_image->h;
+    pixels = (rtgui_color_t *)rtgui_malloc(size * sizeof(rtgui_color_t));
+    if (pixels == RT_NULL)
+        return;
+
+    /* the pixels of alpha 255 are not drawn in the cursor image */
+    src = (rtgui_color_t *)_rtgui_cursor->cursor_image->data;
+    for (index = 0; index < size; index ++)
+        pixels[index] = (src[index] & 0x00ffffff) | ((0xff - (src[index] >> 24)) << 24);
+
+    if (rtgui_graphic_driver_overlay_set_image(gd, RTGUI_OVERLAY_CURSOR, (rt_uint8_t *)pixels,
+            _rtgui_cursor->cursor_image->w * sizeof(rtgui_color_t), RTGRAPHIC_PIXEL_FORMAT_ARGB888,
+            _rtgui_cursor->cursor_image->w, _rtgui_cursor->cursor_image->h) == RT_EOK)
+    {
+        _rtgui_cursor->overlay = RT_TRUE;
+        rtgui_graphic_driver_overlay_set_position(gd, RTGUI_OVERLAY_CURSOR,
+                _rtgui_cursor->cx, _rtgui_cursor->cy);
+    }
+    rtgui_free(pixels);
+}
 #endif
 
 #define WIN_MOVE_BORDER 4
@@ -178,17 +220,16 @@ void rtgui_mouse_init(void)
     _rtgui_cursor->show_cursor_count = 0;
     _rtgui_cursor->cursor_saved = rtgui_malloc(_rtgui_cursor->cursor_image->w *
                                   _rtgui_cursor->cursor_image->h * _rtgui_cursor->bpp);
+
+    /* use the cursor plane of display controller if it has */
+    if (gd->overlay_ops != RT_NULL)
+        _rtgui_cursor_set_overlay(gd);
 #endif
 
 #ifdef RTGUI_USING_WINMOVE
-    /* init window move save image */
-    _rtgui_cursor->win_rect_has_saved   = RT_FALSE;
+    /* init window move outline */
+    _rtgui_cursor->win_rect_drawn       = RT_FALSE;
     _rtgui_cursor->win_rect_show        = RT_FALSE;
-
-    _rtgui_cursor->win_left     = rtgui_malloc(_rtgui_cursor->bpp * gd->height * WIN_MOVE_BORDER);
-    _rtgui_cursor->win_right    = rtgui_malloc(_rtgui_cursor->bpp * gd->height * WIN_MOVE_BORDER);
-    _rtgui_cursor->win_top      = rtgui_malloc(_rtgui_cursor->bpp * gd->width  * WIN_MOVE_BORDER);
-    _rtgui_cursor->win_bottom   = rtgui_malloc(_rtgui_cursor->bpp * gd->width  * WIN_MOVE_BORDER);
 #endif
 }
 
@@ -196,12 +237,6 @@ void rtgui_mouse_fini(void)
 {
     if (_rtgui_cursor != RT_NULL)
     {
-#ifdef RTGUI_USING_WINMOVE
-        rtgui_free(_rtgui_cursor->win_left);
-        rtgui_free(_rtgui_cursor->win_right);
-        rtgui_free(_rtgui_cursor->win_top);
-        rtgui_free(_rtgui_cursor->win_bottom);
-#endif
 #ifdef RTGUI_USING_MOUSE_CURSOR
         rt_mutex_detach(&cursor_mutex);
         rtgui_image_destroy(_rtgui_cursor->cursor_image);
@@ -213,32 +248,56 @@ void rtgui_mouse_fini(void)
     }
 }
 
-void rtgui_mouse_moveto(int x, int y)
+#if defined(RTGUI_USING_MOUSE_CURSOR) && defined(GUIENGINE_USING_RECT_LOCK)
+/* the area of cursor on screen */
+static void _rtgui_cursor_get_rect(rtgui_rect_t *rect)
 {
-#ifdef RTGUI_USING_MOUSE_CURSOR
-    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+    *rect = _rtgui_cursor->rect;
+    rtgui_rect_move(rect, _rtgui_cursor->cx, _rtgui_cursor->cy);
+}
+
+/* lock the area of cursor on screen, the cursor may be moved before it's
+ * locked, so check it again */
+static void _rtgui_cursor_lock(void)
+{
+    rtgui_rect_t rect, current;
+
+    while (1)
+    {
+        _rtgui_cursor_get_rect(&rect);
+        rtgui_screen_lock_rect(&rect);
+        rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+
+        _rtgui_cursor_get_rect(&current);
+        if (rtgui_rect_is_equal(&rect, &current) == RT_EOK)
+            return;
+
+        rt_mutex_release(&cursor_mutex);
+        rtgui_screen_unlock_rect();
+    }
+}
+
+static void _rtgui_cursor_unlock(void)
+{
+    rt_mutex_release(&cursor_mutex);
+    rtgui_screen_unlock_rect();
+}
+#endif
+
+#ifdef RTGUI_USING_WINMOVE
+extern void rtgui_server_request_winrect(void);
 #endif
 
+/* move the cursor, the cursor_mutex is taken */
+static void _rtgui_mouse_move(int x, int y)
+{
     if (x != _rtgui_cursor->cx ||
             y != _rtgui_cursor->cy)
     {
-#ifdef RTGUI_USING_WINMOVE
-        if (_rtgui_cursor->win_rect_show)
         {
-            if (_rtgui_cursor->win_rect_has_saved == RT_TRUE)
-            {
-                rtgui_winrect_restore();
-            }
-
 #ifdef RTGUI_USING_MOUSE_CURSOR
             rtgui_mouse_hide_cursor();
 #endif
-
-            /* move winrect */
-            rtgui_rect_move(&(_rtgui_cursor->win_rect), x - _rtgui_cursor->cx,
-                              y - _rtgui_cursor->cy);
-            rtgui_winrect_save();
-
             /* move current cursor */
             _rtgui_cursor->cx = x;
             _rtgui_cursor->cy = y;
@@ -247,32 +306,137 @@ void rtgui_mouse_moveto(int x, int y)
             /* show cursor */
             rtgui_mouse_show_cursor();
 #endif
-            /* show winrect */
-            rtgui_winrect_show();
         }
-        else
+
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        if (_rtgui_cursor->overlay)
+            rtgui_graphic_driver_overlay_set_position(rtgui_graphic_driver_get_default(),
+                    RTGUI_OVERLAY_CURSOR, x, y);
 #endif
+#ifdef RTGUI_USING_HW_CURSOR
+        rtgui_cursor_set_position(_rtgui_cursor->cx, _rtgui_cursor->cy);
+#endif
+
+#ifdef RTGUI_USING_WINMOVE
+        /* the outline follows the cursor in the next frame */
+        if (_rtgui_cursor->win_rect_show)
+            rtgui_server_request_winrect();
+#endif
+    }
+}
+
+#if defined(RTGUI_USING_MOUSE_CURSOR) && !defined(GUIENGINE_USING_RECT_LOCK)
+/* whether the cursor at (x, y) is over the rect */
+static rt_bool_t _rtgui_cursor_is_over(int x, int y, rtgui_rect_t *rect)
+{
+    return (x + _rtgui_cursor->rect.x2 > rect->x1 && x + _rtgui_cursor->rect.x1 < rect->x2 &&
+            y + _rtgui_cursor->rect.y2 > rect->y1 && y + _rtgui_cursor->rect.y1 < rect->y2) ?
+           RT_TRUE : RT_FALSE;
+}
+
+/*
+ * The app draws in the rect on screen. Only the cursor over it is hidden, and
+ * the cursor is not moved into it until the drawing ends, so the cursor out of
+ * the rect is moved without waiting for the drawing.
+ */
+void rtgui_mouse_drawing_begin(rtgui_rect_t *rect)
+{
+    if (_rtgui_cursor == RT_NULL || _rtgui_cursor->overlay)
+        return;
+
+    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+    if (_rtgui_cursor->drawing == 0)
+        _rtgui_cursor->drawing_rect = *rect;
+    else
+        rtgui_rect_union(rect, &(_rtgui_cursor->drawing_rect));
+    _rtgui_cursor->drawing ++;
+
+    if (_rtgui_cursor->drawing_hidden == RT_FALSE &&
+            _rtgui_cursor_is_over(_rtgui_cursor->cx, _rtgui_cursor->cy, rect))
+    {
+        rtgui_mouse_hide_cursor();
+        _rtgui_cursor->drawing_hidden = RT_TRUE;
+    }
+    rt_mutex_release(&cursor_mutex);
+}
+
+void rtgui_mouse_drawing_end(void)
+{
+    if (_rtgui_cursor == RT_NULL || _rtgui_cursor->overlay)
+        return;
+
+    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+    if (_rtgui_cursor->drawing > 0)
+        _rtgui_cursor->drawing --;
+
+    if (_rtgui_cursor->drawing == 0)
+    {
+        if (_rtgui_cursor->drawing_hidden == RT_TRUE)
         {
-#ifdef RTGUI_USING_MOUSE_CURSOR
-            rtgui_mouse_hide_cursor();
+            _rtgui_cursor->drawing_hidden = RT_FALSE;
+            rtgui_mouse_show_cursor();
+        }
+
+        /* the move deferred in the drawing */
+        if (_rtgui_cursor->moving == RT_TRUE)
+        {
+            _rtgui_cursor->moving = RT_FALSE;
+            _rtgui_mouse_move(_rtgui_cursor->mx, _rtgui_cursor->my);
+        }
+    }
+    rt_mutex_release(&cursor_mutex);
+}
 #endif
-            /* move current cursor */
-            _rtgui_cursor->cx = x;
-            _rtgui_cursor->cy = y;
 
+void rtgui_mouse_moveto(int x, int y)
+{
 #ifdef RTGUI_USING_MOUSE_CURSOR
-            /* show cursor */
-            rtgui_mouse_show_cursor();
+#ifdef GUIENGINE_USING_RECT_LOCK
+    rtgui_rect_t rect, dest;
 #endif
-        }
 
-#ifdef RTGUI_USING_HW_CURSOR
-        rtgui_cursor_set_position(_rtgui_cursor->cx, _rtgui_cursor->cy);
+    /* the cursor plane is moved by the display controller */
+    if (_rtgui_cursor->overlay)
+    {
+        _rtgui_mouse_move(x, y);
+        return;
+    }
+
+#ifdef GUIENGINE_USING_RECT_LOCK
+    /* lock the area from the current position to the new one, so only the
+     * drawings under them block the cursor */
+    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+    _rtgui_cursor_get_rect(&rect);
+    rt_mutex_release(&cursor_mutex);
+    dest = _rtgui_cursor->rect;
+    rtgui_rect_move(&dest, x, y);
+    rtgui_rect_union(&rect, &dest);
+
+    rtgui_screen_lock_rect(&dest);
 #endif
+    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+#ifndef GUIENGINE_USING_RECT_LOCK
+    /* the cursor shown is not moved into the area being drawn */
+    if (_rtgui_cursor->drawing != 0 && _rtgui_cursor->drawing_hidden == RT_FALSE &&
+            _rtgui_cursor_is_over(x, y, &(_rtgui_cursor->drawing_rect)))
+    {
+        _rtgui_cursor->moving = RT_TRUE;
+        _rtgui_cursor->mx = x;
+        _rtgui_cursor->my = y;
+        rt_mutex_release(&cursor_mutex);
+        return;
     }
+    _rtgui_cursor->moving = RT_FALSE;
+#endif
+#endif
+
+    _rtgui_mouse_move(x, y);
 
 #ifdef RTGUI_USING_MOUSE_CURSOR
     rt_mutex_release(&cursor_mutex);
+#ifdef GUIENGINE_USING_RECT_LOCK
+    rtgui_screen_unlock_rect();
+#endif
 #endif
 }
 
@@ -282,6 +446,11 @@ void rtgui_mouse_set_position(int x, int y)
     _rtgui_cursor->cx = x;
     _rtgui_cursor->cy = y;
 
+#ifdef RTGUI_USING_MOUSE_CURSOR
+    if (_rtgui_cursor->overlay)
+        rtgui_graphic_driver_overlay_set_position(rtgui_graphic_driver_get_default(),
+                RTGUI_OVERLAY_CURSOR, x, y);
+#endif
 #ifdef RTGUI_USING_HW_CURSOR
     rtgui_cursor_set_position(_rtgui_cursor->cx, _rtgui_cursor->cy);
 #endif
@@ -308,9 +477,14 @@ void rtgui_mouse_get_cursor_rect(rtgui_rect_t *rect)
 
 void rtgui_mouse_show_cursor()
 {
-    if (_rtgui_cursor->show_cursor == RT_FALSE)
+    if (_rtgui_cursor->show_cursor == RT_FALSE || _rtgui_cursor->overlay)
         return;
 
+#ifdef GUIENGINE_USING_RECT_LOCK
+    _rtgui_cursor_lock();
+#else
+    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+#endif
     _rtgui_cursor->show_cursor_count ++;
     if (_rtgui_cursor->show_cursor_count == 1)
     {
@@ -320,19 +494,34 @@ void rtgui_mouse_show_cursor()
         /* show mouse cursor */
         rtgui_cursor_show();
     }
+#ifdef GUIENGINE_USING_RECT_LOCK
+    _rtgui_cursor_unlock();
+#else
+    rt_mutex_release(&cursor_mutex);
+#endif
 }
 
 void rtgui_mouse_hide_cursor()
 {
-    if (_rtgui_cursor->show_cursor == RT_FALSE)
+    if (_rtgui_cursor->show_cursor == RT_FALSE || _rtgui_cursor->overlay)
         return;
 
+#ifdef GUIENGINE_USING_RECT_LOCK
+    _rtgui_cursor_lock();
+#else
+    rt_mutex_take(&cursor_mutex, RT_WAITING_FOREVER);
+#endif
     if (_rtgui_cursor->show_cursor_count == 1)
     {
         /* display the cursor coverage area */
         rtgui_cursor_restore();
     }
     _rtgui_cursor->show_cursor_count --;
+#ifdef GUIENGINE_USING_RECT_LOCK
+    _rtgui_cursor_unlock();
+#else
+    rt_mutex_release(&cursor_mutex);
+#endif
 }
 
 rt_bool_t rtgui_mouse_is_intersect(rtgui_rect_t *r)
@@ -340,12 +529,25 @@ rt_bool_t rtgui_mouse_is_intersect(rtgui_rect_t *r)
     return rtgui_rect_is_intersect(&(_rtgui_cursor->rect), r) == RT_EOK ? RT_TRUE : RT_FALSE;
 }
 
+/* whether the cursor at current position is over the rect */
+rt_bool_t rtgui_mouse_cursor_intersect(rtgui_rect_t *r)
+{
+    rtgui_rect_t rect;
+
+    rect = _rtgui_cursor->rect;
+    rtgui_rect_move(&rect, _rtgui_cursor->cx, _rtgui_cursor->cy);
+
+    return rtgui_rect_is_intersect(&rect, r) == RT_EOK ? RT_TRUE : RT_FALSE;
+}
+
 /* display the saved cursor area to screen */
 static void rtgui_cursor_restore()
 {
     rt_base_t idx, height, cursor_pitch;
     rt_uint8_t *cursor_ptr, *fb_ptr;
 
+    rtgui_graphic_driver_accel_sync();
+
     fb_ptr = rtgui_graphic_driver_get_framebuffer(RT_NULL) + _rtgui_cursor->cy * _rtgui_cursor->screen_pitch
              + _rtgui_cursor->cx * _rtgui_cursor->bpp;
     cursor_ptr = _rtgui_cursor->cursor_saved;
@@ -373,6 +575,8 @@ static void rtgui_cursor_save()
     rt_base_t idx, height, cursor_pitch;
     rt_uint8_t *cursor_ptr, *fb_ptr;
 
+    rtgui_graphic_driver_accel_sync();
+
     fb_ptr = rtgui_graphic_driver_get_framebuffer(RT_NULL) + _rtgui_cursor->cy * _rtgui_cursor->screen_pitch +
              _rtgui_cursor->cx * _rtgui_cursor->bpp;
     cursor_ptr = _rtgui_cursor->cursor_saved;
@@ -433,33 +637,91 @@ static void rtgui_cursor_show()
 #ifdef RTGUI_USING_WINMOVE
 void rtgui_winrect_set(struct rtgui_win *win)
 {
+    rtgui_screen_lock(RT_WAITING_FOREVER);
     /* set win rect show */
     _rtgui_cursor->win_rect_show = RT_TRUE;
+    _rtgui_cursor->win_rect_drawn = RT_FALSE;
 
     /* set win rect */
     _rtgui_cursor->win_rect =
         win->_title_wgt == RT_NULL ?
         RTGUI_WIDGET(win)->extent :
         RTGUI_WIDGET(win->_title_wgt)->extent;
+    _rtgui_cursor->win_cx = _rtgui_cursor->cx;
+    _rtgui_cursor->win_cy = _rtgui_cursor->cy;
 
     _rtgui_cursor->win = win;
+    rtgui_screen_unlock();
+}
+
+/*
+ * Move the outline to the cursor, invoked by the server once a frame in
+ * dragging. The outline is drawn over the whole screen, so the screen is locked.
+ */
+void rtgui_winrect_update(void)
+{
+    int dx, dy;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+
+    dx = _rtgui_cursor->cx - _rtgui_cursor->win_cx;
+    dy = _rtgui_cursor->cy - _rtgui_cursor->win_cy;
+    if (_rtgui_cursor->win_rect_show && (dx != 0 || dy != 0))
+    {
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        /* the saved area of cursor has the outline */
+        rtgui_mouse_hide_cursor();
+#endif
+        if (_rtgui_cursor->win_rect_drawn == RT_TRUE)
+            rtgui_winrect_xor();
+
+        rtgui_rect_move(&(_rtgui_cursor->win_rect), dx, dy);
+        _rtgui_cursor->win_cx += dx;
+        _rtgui_cursor->win_cy += dy;
+
+        rtgui_winrect_xor();
+        _rtgui_cursor->win_rect_drawn = RT_TRUE;
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        rtgui_mouse_show_cursor();
+#endif
+    }
+
+    rtgui_screen_unlock();
 }
 
 rt_bool_t rtgui_winrect_moved_done(rtgui_rect_t *winrect, struct rtgui_win **win)
 {
     rt_bool_t moved = RT_FALSE;
 
-    /* restore winrect */
-    if (_rtgui_cursor->win_rect_has_saved)
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+
+    /* erase winrect */
+    if (_rtgui_cursor->win_rect_drawn)
     {
-        rtgui_winrect_restore();
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        rtgui_mouse_hide_cursor();
+#endif
+        rtgui_winrect_xor();
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        rtgui_mouse_show_cursor();
+#endif
 
         moved = RT_TRUE;
     }
 
+    /* the motion not drawn yet */
+    if (_rtgui_cursor->win_rect_show)
+    {
+        rtgui_rect_move(&(_rtgui_cursor->win_rect),
+                        _rtgui_cursor->cx - _rtgui_cursor->win_cx,
+                        _rtgui_cursor->cy - _rtgui_cursor->win_cy);
+        _rtgui_cursor->win_cx = _rtgui_cursor->cx;
+        _rtgui_cursor->win_cy = _rtgui_cursor->cy;
+    }
+
     /* clear win rect show */
     _rtgui_cursor->win_rect_show = RT_FALSE;
-    _rtgui_cursor->win_rect_has_saved = RT_FALSE;
+    _rtgui_cursor->win_rect_drawn = RT_FALSE;
 
     /* return win rect */
     if (winrect)
@@ -467,6 +729,8 @@ rt_bool_t rtgui_winrect_moved_done(rtgui_rect_t *winrect, struct rtgui_win **win
     if (win)
         *win = _rtgui_cursor->win;
 
+    rtgui_screen_unlock();
+
     return moved;
 }
 
@@ -475,157 +739,65 @@ rt_bool_t rtgui_winrect_is_moved()
     return _rtgui_cursor->win_rect_show;
 }
 
-/* show winrect */
-static void rtgui_winrect_show()
+/* invert the dotted pixels of a strip on screen */
+static void _rtgui_winrect_xor_strip(rt_uint8_t *fb, rtgui_rect_t *screen,
+                                     int x1, int y1, int x2, int y2)
 {
-    rt_uint16_t x, y;
-    rtgui_color_t c;
-    rtgui_rect_t screen_rect, win_rect, win_rect_inner;
-    void (*set_pixel)(rtgui_color_t * c, int x, int y);
-
-    c = black;
-    set_pixel = rtgui_graphic_driver_get_default()->ops->set_pixel;
-
-    win_rect = _rtgui_cursor->win_rect;
-    win_rect_inner = win_rect;
-    rtgui_rect_inflate(&win_rect_inner, -WIN_MOVE_BORDER);
+    int x, y, index;
+    rt_uint8_t *ptr;
 
-    rtgui_graphic_driver_get_rect(rtgui_graphic_driver_get_default(),
-                                  &screen_rect);
-    rtgui_rect_intersect(&screen_rect, &win_rect);
-    rtgui_rect_intersect(&screen_rect, &win_rect_inner);
-
-    /* draw left */
-    for (y = win_rect.y1; y < win_rect.y2; y ++)
-    {
-        for (x = win_rect.x1; x < win_rect_inner.x1; x++)
-            if ((x + y) & 0x01) set_pixel(&c, x, y);
-    }
-
-    /* draw right */
-    for (y = win_rect.y1; y < win_rect.y2; y ++)
-    {
-        for (x = win_rect_inner.x2; x < win_rect.x2; x++)
-            if ((x + y) & 0x01) set_pixel(&c, x, y);
-    }
-
-    /* draw top border */
-    for (y = win_rect.y1; y < win_rect_inner.y1; y ++)
-    {
-        for (x = win_rect_inner.x1; x < win_rect_inner.x2; x++)
-            if ((x + y) & 0x01) set_pixel(&c, x, y);
-    }
+    if (x1 < screen->x1) x1 = screen->x1;
+    if (y1 < screen->y1) y1 = screen->y1;
+    if (x2 > screen->x2) x2 = screen->x2;
+    if (y2 > screen->y2) y2 = screen->y2;
 
-    /* draw bottom border */
-    for (y = win_rect_inner.y2; y < win_rect.y2; y ++)
+    for (y = y1; y < y2; y ++)
     {
-        for (x = win_rect_inner.x1; x < win_rect_inner.x2; x++)
-            if ((x + y) & 0x01) set_pixel(&c, x, y);
+        ptr = fb + y * _rtgui_cursor->screen_pitch + x1 * _rtgui_cursor->bpp;
+        for (x = x1; x < x2; x ++)
+        {
+            if ((x + y) & 0x01)
+            {
+                for (index = 0; index < _rtgui_cursor->bpp; index ++)
+                    ptr[index] ^= 0xff;
+            }
+            ptr += _rtgui_cursor->bpp;
+        }
     }
-
-    /* update rect */
-    rtgui_graphic_driver_screen_update(rtgui_graphic_driver_get_default(), &win_rect);
 }
 
-#define display_direct_memcpy(src, dest, src_pitch, dest_pitch, height, len)    \
-    for (idx = 0; idx < height; idx ++)     \
-    {                                       \
-        memcpy(dest, src, len);             \
-        src  += src_pitch;                  \
-        dest += dest_pitch;                 \
-    }
-
-static void rtgui_winrect_restore()
+/*
+ * Draw the dotted outline by inverting the pixels in framebuffer, and erase it
+ * by inverting them again. Nothing under the outline is saved.
+ */
+static void rtgui_winrect_xor()
 {
-    rt_uint8_t *winrect_ptr, *fb_ptr, *driver_fb;
-    int winrect_pitch, idx;
+    rt_uint8_t *fb;
     rtgui_rect_t screen_rect, win_rect;
 
-    driver_fb = rtgui_graphic_driver_get_framebuffer(RT_NULL);
-    win_rect = _rtgui_cursor->win_rect;
+    fb = rtgui_graphic_driver_get_framebuffer(RT_NULL);
+    if (fb == RT_NULL)
+        return;
+    rtgui_graphic_driver_accel_sync();
 
+    win_rect = _rtgui_cursor->win_rect;
     rtgui_graphic_driver_get_rect(rtgui_graphic_driver_get_default(),
                                   &screen_rect);
-    rtgui_rect_intersect(&screen_rect, &win_rect);
-
-    /* restore winrect left */
-    fb_ptr = driver_fb + win_rect.y1 * _rtgui_cursor->screen_pitch +
-             win_rect.x1 * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_left;
-    winrect_pitch = WIN_MOVE_BORDER * _rtgui_cursor->bpp;
-    display_direct_memcpy(winrect_ptr, fb_ptr, winrect_pitch, _rtgui_cursor->screen_pitch,
-                          (win_rect.y2 - win_rect.y1), winrect_pitch);
-
-    /* restore winrect right */
-    fb_ptr = driver_fb + win_rect.y1 * _rtgui_cursor->screen_pitch +
-             (win_rect.x2 - WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_right;
-    winrect_pitch = WIN_MOVE_BORDER * _rtgui_cursor->bpp;
-    display_direct_memcpy(winrect_ptr, fb_ptr, winrect_pitch, _rtgui_cursor->screen_pitch,
-                          (win_rect.y2 - win_rect.y1), winrect_pitch);
-
-    /* restore winrect top */
-    fb_ptr = driver_fb + win_rect.y1 * _rtgui_cursor->screen_pitch +
-             (win_rect.x1 + WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_top;
-    winrect_pitch = (win_rect.x2 - win_rect.x1 - 2 * WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    display_direct_memcpy(winrect_ptr, fb_ptr, winrect_pitch, _rtgui_cursor->screen_pitch,
-                          WIN_MOVE_BORDER, winrect_pitch);
-
-    /* restore winrect bottom */
-    fb_ptr = driver_fb + (win_rect.y2 - WIN_MOVE_BORDER) * _rtgui_cursor->screen_pitch +
-             (win_rect.x1 + WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_bottom;
-    display_direct_memcpy(winrect_ptr, fb_ptr, winrect_pitch, _rtgui_cursor->screen_pitch,
-                          WIN_MOVE_BORDER, winrect_pitch);
-}
-
-static void rtgui_winrect_save()
-{
-    rt_uint8_t *winrect_ptr, *fb_ptr, *driver_fb;
-    int winrect_pitch, idx;
-    rtgui_rect_t screen_rect, win_rect;
 
-    driver_fb = rtgui_graphic_driver_get_framebuffer(RT_NULL);
-    win_rect = _rtgui_cursor->win_rect;
+    /* the left and right borders, the top and bottom ones between them */
+    _rtgui_winrect_xor_strip(fb, &screen_rect, win_rect.x1, win_rect.y1,
+                             win_rect.x1 + WIN_MOVE_BORDER, win_rect.y2);
+    _rtgui_winrect_xor_strip(fb, &screen_rect, win_rect.x2 - WIN_MOVE_BORDER, win_rect.y1,
+                             win_rect.x2, win_rect.y2);
+    _rtgui_winrect_xor_strip(fb, &screen_rect, win_rect.x1 + WIN_MOVE_BORDER, win_rect.y1,
+                             win_rect.x2 - WIN_MOVE_BORDER, win_rect.y1 + WIN_MOVE_BORDER);
+    _rtgui_winrect_xor_strip(fb, &screen_rect, win_rect.x1 + WIN_MOVE_BORDER, win_rect.y2 - WIN_MOVE_BORDER,
+                             win_rect.x2 - WIN_MOVE_BORDER, win_rect.y2);
 
-    rtgui_graphic_driver_get_rect(rtgui_graphic_driver_get_default(),
-                                  &screen_rect);
+    /* update rect */
     rtgui_rect_intersect(&screen_rect, &win_rect);
-
-    /* set winrect has saved */
-    _rtgui_cursor->win_rect_has_saved = RT_TRUE;
-
-    /* save winrect left */
-    fb_ptr = driver_fb + win_rect.y1 * _rtgui_cursor->screen_pitch +
-             win_rect.x1 * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_left;
-    winrect_pitch = WIN_MOVE_BORDER * _rtgui_cursor->bpp;
-    display_direct_memcpy(fb_ptr, winrect_ptr, _rtgui_cursor->screen_pitch, winrect_pitch,
-                          (win_rect.y2 - win_rect.y1), winrect_pitch);
-
-    /* save winrect right */
-    fb_ptr = driver_fb + win_rect.y1 * _rtgui_cursor->screen_pitch +
-             (win_rect.x2 - WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_right;
-    winrect_pitch = WIN_MOVE_BORDER * _rtgui_cursor->bpp;
-    display_direct_memcpy(fb_ptr, winrect_ptr, _rtgui_cursor->screen_pitch, winrect_pitch,
-                          (win_rect.y2 - win_rect.y1), winrect_pitch);
-
-    /* save winrect top */
-    fb_ptr = driver_fb + win_rect.y1 * _rtgui_cursor->screen_pitch +
-             (win_rect.x1 + WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_top;
-    winrect_pitch = (win_rect.x2 - win_rect.x1 - 2 * WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    display_direct_memcpy(fb_ptr, winrect_ptr, _rtgui_cursor->screen_pitch, winrect_pitch,
-                          WIN_MOVE_BORDER, winrect_pitch);
-
-    /* save winrect bottom */
-    fb_ptr = driver_fb + (win_rect.y2 - WIN_MOVE_BORDER) * _rtgui_cursor->screen_pitch +
-             (win_rect.x1 + WIN_MOVE_BORDER) * _rtgui_cursor->bpp;
-    winrect_ptr = _rtgui_cursor->win_bottom;
-    display_direct_memcpy(fb_ptr, winrect_ptr, _rtgui_cursor->screen_pitch, winrect_pitch,
-                          WIN_MOVE_BORDER, winrect_pitch);
+    if (win_rect.x1 < win_rect.x2 && win_rect.y1 < win_rect.y2)
+        rtgui_graphic_driver_screen_update(rtgui_graphic_driver_get_default(), &win_rect);
 }
 #endif
 
@@ -52,11 +52,17 @@ void rtgui_mouse_show_cursor(void);
 void rtgui_mouse_hide_cursor(void);
 
 rt_bool_t rtgui_mouse_is_intersect(rtgui_rect_t *r);
+rt_bool_t rtgui_mouse_cursor_intersect(rtgui_rect_t *r);
+#ifndef GUIENGINE_USING_RECT_LOCK
+void rtgui_mouse_drawing_begin(rtgui_rect_t *rect);
+void rtgui_mouse_drawing_end(void);
+#endif
 
 #ifdef RTGUI_USING_WINMOVE
 rt_bool_t rtgui_winrect_is_moved(void);
 void rtgui_winrect_set(struct rtgui_win *win);
 rt_bool_t rtgui_winrect_moved_done(rtgui_rect_t *winrect, struct rtgui_win **win);
+void rtgui_winrect_update(void);
 #endif
 
 void rtgui_mouse_monitor_append(rtgui_list_t *head, rtgui_rect_t *rect);
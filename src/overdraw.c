@@ -0,0 +1,302 @@
+/*
+ * File      : overdraw.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_DC
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/driver.h>
+#include <rtgui/blit.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_OVERDRAW
+
+/*
+ * The writes to framebuffer are counted by the operations of driver (wrapped
+ * in the counting mode), the fill of driver and rtgui_blit. The others which
+ * write to framebuffer directly (dc_trans and dc_blend) are not counted.
+ */
+static volatile rt_uint8_t _overdraw_mode = RTGUI_OVERDRAW_OFF;
+static struct rtgui_graphic_driver *_overdraw_driver = RT_NULL;
+/* the writes of each pixel since it's updated last time, saturated */
+static rt_uint8_t *_overdraw_count = RT_NULL;
+/* the operations of driver and the counting ones wrapped them */
+static const struct rtgui_graphic_driver_ops *_overdraw_ops = RT_NULL;
+static struct rtgui_graphic_driver_ops _overdraw_wrap_ops;
+
+/* the tint of pixels written 2, 3, 4 and more than 4 times */
+static const rtgui_color_t _overdraw_tint[] =
+{
+    RTGUI_RGB(0x00, 0x00, 0xff),
+    RTGUI_RGB(0x00, 0xff, 0x00),
+    RTGUI_RGB(0xff, 0x80, 0xff),
+    RTGUI_RGB(0xff, 0x00, 0x00),
+};
+
+static void _overdraw_add(int x1, int x2, int y1, int y2)
+{
+    int x, y;
+    rt_uint8_t *count;
+    struct rtgui_graphic_driver *driver = _overdraw_driver;
+
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > driver->width) x2 = driver->width;
+    if (y2 > driver->height) y2 = driver->height;
+
+    for (y = y1; y < y2; y ++)
+    {
+        count = _overdraw_count + y * driver->width + x1;
+        for (x = x1; x < x2; x ++, count ++)
+        {
+            if (*count != 0xff) *count += 1;
+        }
+    }
+}
+
+static void _overdraw_set_pixel(rtgui_color_t *c, int x, int y)
+{
+    _overdraw_add(x, x + 1, y, y + 1);
+    _overdraw_ops->set_pixel(c, x, y);
+}
+
+static void _overdraw_draw_hline(rtgui_color_t *c, int x1, int x2, int y)
+{
+    _overdraw_add(x1, x2, y, y + 1);
+    _overdraw_ops->draw_hline(c, x1, x2, y);
+}
+
+static void _overdraw_draw_vline(rtgui_color_t *c, int x, int y1, int y2)
+{
+    _overdraw_add(x, x + 1, y1, y2);
+    _overdraw_ops->draw_vline(c, x, y1, y2);
+}
+
+static void _overdraw_draw_raw_hline(rt_uint8_t *pixels, int x1, int x2, int y)
+{
+    _overdraw_add(x1, x2, y, y + 1);
+    _overdraw_ops->draw_raw_hline(pixels, x1, x2, y);
+}
+
+void rtgui_overdraw_rect(rtgui_rect_t *rect)
+{
+    if (_overdraw_mode != RTGUI_OVERDRAW_COUNT)
+        return;
+
+    _overdraw_add(rect->x1, rect->x2, rect->y1, rect->y2);
+}
+RTM_EXPORT(rtgui_overdraw_rect);
+
+void rtgui_overdraw_blit(struct rtgui_blit_info *info)
+{
+    rt_ubase_t offset;
+    int x, y, bpp;
+    struct rtgui_graphic_driver *driver = _overdraw_driver;
+
+    if (_overdraw_mode != RTGUI_OVERDRAW_COUNT || driver->framebuffer == RT_NULL)
+        return;
+
+    /* only the blit to framebuffer */
+    if (info->dst < driver->framebuffer ||
+            info->dst >= driver->framebuffer + driver->pitch * driver->height)
+        return;
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+    offset = info->dst - driver->framebuffer;
+    y = offset / driver->pitch;
+    x = (offset % driver->pitch) / bpp;
+    _overdraw_add(x, x + info->dst_w, y, y + info->dst_h);
+}
+RTM_EXPORT(rtgui_overdraw_blit);
+
+/* tint the pixels written more than once, and restart the count of them */
+static void _overdraw_tint_rect(rtgui_rect_t *rect)
+{
+    int x, y;
+    rt_uint8_t *count;
+    rtgui_color_t color, tint;
+    struct rtgui_graphic_driver *driver = _overdraw_driver;
+
+    for (y = rect->y1; y < rect->y2; y ++)
+    {
+        count = _overdraw_count + y * driver->width + rect->x1;
+        for (x = rect->x1; x < rect->x2; x ++, count ++)
+        {
+            if (*count > 1)
+            {
+                tint = _overdraw_tint[*count > 4 ? 3 : *count - 2];
+
+                _overdraw_ops->get_pixel(&color, x, y);
+                color = RTGUI_RGB((RTGUI_RGB_R(color) + RTGUI_RGB_R(tint)) / 2,
+                                  (RTGUI_RGB_G(color) + RTGUI_RGB_G(tint)) / 2,
+                                  (RTGUI_RGB_B(color) + RTGUI_RGB_B(tint)) / 2);
+                _overdraw_ops->set_pixel(&color, x, y);
+            }
+            *count = 0;
+        }
+    }
+}
+
+/* invert the pixels of rect, it's restored by inverting again */
+static void _overdraw_invert_rect(rtgui_rect_t *rect)
+{
+    int x, y;
+    rtgui_color_t color;
+
+    for (y = rect->y1; y < rect->y2; y ++)
+    {
+        for (x = rect->x1; x < rect->x2; x ++)
+        {
+            _overdraw_ops->get_pixel(&color, x, y);
+            color = RTGUI_RGB(0xff - RTGUI_RGB_R(color), 0xff - RTGUI_RGB_G(color),
+                              0xff - RTGUI_RGB_B(color));
+            _overdraw_ops->set_pixel(&color, x, y);
+        }
+    }
+}
+
+/* invoked by rtgui_graphic_driver_screen_update before the rect is updated */
+void rtgui_overdraw_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+    rtgui_rect_t r;
+    struct rt_device_rect_info rect_info;
+
+    if (_overdraw_mode == RTGUI_OVERDRAW_OFF || driver != _overdraw_driver)
+        return;
+
+    r = *rect;
+    if (r.x1 < 0) r.x1 = 0;
+    if (r.y1 < 0) r.y1 = 0;
+    if (r.x2 > driver->width) r.x2 = driver->width;
+    if (r.y2 > driver->height) r.y2 = driver->height;
+    if (r.x1 >= r.x2 || r.y1 >= r.y2)
+        return;
+
+    if (_overdraw_mode == RTGUI_OVERDRAW_COUNT)
+    {
+        _overdraw_tint_rect(&r);
+        return;
+    }
+
+    /* flash the rect before it's updated */
+    rect_info.x = r.x1;
+    rect_info.y = r.y1;
+    rect_info.width = r.x2 - r.x1;
+    rect_info.height = r.y2 - r.y1;
+
+    _overdraw_invert_rect(&r);
+    rt_device_control(driver->device, RTGRAPHIC_CTRL_RECT_UPDATE, &rect_info);
+    rt_thread_delay(rt_tick_from_millisecond(GUIENGINE_OVERDRAW_FLASH_MS));
+    _overdraw_invert_rect(&r);
+}
+RTM_EXPORT(rtgui_overdraw_update);
+
+/*
+ * Set the debug mode of overdraw on the default driver. Set it after
+ * rtgui_graphic_set_device, which resets the operations of driver.
+ */
+rt_err_t rtgui_graphic_driver_set_overdraw(enum rtgui_overdraw_mode mode)
+{
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+    if (driver == RT_NULL || driver->ops == RT_NULL || driver->device == RT_NULL)
+        return -RT_ENOSYS;
+    if (mode == _overdraw_mode)
+        return RT_EOK;
+
+    /* no drawing is in progress when the operations are switched */
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+
+    /* stop counting first */
+    if (_overdraw_mode == RTGUI_OVERDRAW_COUNT)
+    {
+        _overdraw_mode = RTGUI_OVERDRAW_OFF;
+        _overdraw_driver->ops = _overdraw_ops;
+        rtgui_free(_overdraw_count);
+        _overdraw_count = RT_NULL;
+    }
+
+    _overdraw_driver = driver;
+    _overdraw_ops = driver->ops;
+
+    if (mode == RTGUI_OVERDRAW_COUNT)
+    {
+        _overdraw_count = (rt_uint8_t *)rtgui_malloc(driver->width * driver->height);
+        if (_overdraw_count == RT_NULL)
+        {
+            _overdraw_mode = RTGUI_OVERDRAW_OFF;
+            rtgui_screen_unlock();
+            return -RT_ENOMEM;
+        }
+        rt_memset(_overdraw_count, 0, driver->width * driver->height);
+
+        _overdraw_wrap_ops.set_pixel = _overdraw_set_pixel;
+        _overdraw_wrap_ops.get_pixel = _overdraw_ops->get_pixel;
+        _overdraw_wrap_ops.draw_hline = _overdraw_draw_hline;
+        _overdraw_wrap_ops.draw_vline = _overdraw_draw_vline;
+        _overdraw_wrap_ops.draw_raw_hline = _overdraw_draw_raw_hline;
+        driver->ops = &_overdraw_wrap_ops;
+    }
+    _overdraw_mode = mode;
+    rtgui_screen_unlock();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_graphic_driver_set_overdraw);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+static int gui_overdraw(int argc, char **argv)
+{
+    rt_err_t result;
+    enum rtgui_overdraw_mode mode;
+    static const char *mode_name[] = {"off", "count", "flash"};
+
+    if (argc != 2)
+    {
+        rt_kprintf("overdraw: %s\n", mode_name[_overdraw_mode]);
+        rt_kprintf("usage: gui_overdraw off|count|flash\n");
+        return 0;
+    }
+
+    for (mode = RTGUI_OVERDRAW_OFF; mode <= RTGUI_OVERDRAW_FLASH; mode ++)
+    {
+        if (rt_strcmp(argv[1], mode_name[mode]) == 0)
+            break;
+    }
+    if (mode > RTGUI_OVERDRAW_FLASH)
+    {
+        rt_kprintf("usage: gui_overdraw off|count|flash\n");
+        return -1;
+    }
+
+    result = rtgui_graphic_driver_set_overdraw(mode);
+    if (result != RT_EOK)
+        rt_kprintf("set overdraw failed: %d\n", result);
+
+    return result;
+}
+MSH_CMD_EXPORT(gui_overdraw, set the debug of overdraw: off count or flash);
+#endif
+
+#endif
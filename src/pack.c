@@ -0,0 +1,598 @@
+/*
+ * File      : pack.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/pack.h>
+#include <rtgui/rtgui_system.h>
+
+#if defined(GUIENGINE_USING_PACK) && defined(GUIENGINE_USING_DFS_FILERW)
+
+#ifdef PKG_USING_FASTLZ
+extern int fastlz_decompress(const void *input, int length, void *output, int maxout);
+#endif
+
+#define PACK_NONE       0xffffffff
+
+struct rtgui_pack
+{
+    /* the node of mounted packs */
+    rt_list_t list;
+    char *prefix;
+
+    int fd;
+    /* the reads of entries are in the lock, each is a seek and a read */
+    struct rt_mutex lock;
+    /* the pack and the entries opened */
+    int refcount;
+
+    struct rtgui_pack_header header;
+    rt_uint32_t *buckets;
+    struct rtgui_pack_entry *entries;
+    char *names;
+};
+
+/* the stored entry, read in the blocks of buffer */
+struct rtgui_pack_file
+{
+    /* inherit from rtgui_filerw */
+    struct rtgui_filerw parent;
+
+    struct rtgui_pack *pack;
+    rt_uint32_t start, size;
+    /* the read position, and the offset and bytes of buffer in entry */
+    rt_uint32_t offset;
+    rt_uint32_t base, length;
+
+    rt_uint8_t buffer[GUIENGINE_FILERW_BLOCK_SIZE];
+};
+
+/* the decompressed entry in memory */
+struct rtgui_pack_blob
+{
+    /* inherit from rtgui_filerw */
+    struct rtgui_filerw parent;
+
+    struct rtgui_pack *pack;
+    rt_uint32_t size, offset;
+
+    /* rt_uint8_t data[size]; */
+};
+#define _pack_blob_data(blob)   ((rt_uint8_t *)((blob) + 1))
+
+static rt_list_t _pack_mount_list = RT_LIST_OBJECT_INIT(_pack_mount_list);
+static struct rt_mutex *_pack_mount_lock = RT_NULL;
+
+rt_uint32_t rtgui_pack_hash(const char *name)
+{
+    rt_uint32_t hash = 2166136261UL;
+
+    while (*name)
+    {
+        hash ^= (rt_uint8_t)*name++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+RTM_EXPORT(rtgui_pack_hash);
+
+static int _pack_read(struct rtgui_pack *pack, rt_uint32_t offset, void *buffer, rt_size_t size)
+{
+    int result = -1;
+
+    rt_mutex_take(&pack->lock, RT_WAITING_FOREVER);
+    if (lseek(pack->fd, offset, SEEK_SET) == (off_t)offset)
+        result = read(pack->fd, buffer, size);
+    rt_mutex_release(&pack->lock);
+
+    return result;
+}
+
+static void _pack_refer(struct rtgui_pack *pack)
+{
+    rt_mutex_take(&pack->lock, RT_WAITING_FOREVER);
+    pack->refcount ++;
+    rt_mutex_release(&pack->lock);
+}
+
+static void _pack_release(struct rtgui_pack *pack)
+{
+    int refcount;
+
+    rt_mutex_take(&pack->lock, RT_WAITING_FOREVER);
+    refcount = -- pack->refcount;
+    rt_mutex_release(&pack->lock);
+    if (refcount > 0)
+        return;
+
+    close(pack->fd);
+    rt_mutex_detach(&pack->lock);
+    rtgui_free(pack->buckets);
+    rtgui_free(pack);
+}
+
+struct rtgui_pack *rtgui_pack_open(const char *path)
+{
+    int fd;
+    rt_uint32_t size;
+    struct rtgui_pack *pack;
+    struct rtgui_pack_header header;
+
+    RT_ASSERT(path != RT_NULL);
+
+    fd = open(path, O_RDONLY | O_BINARY, 0);
+    if (fd < 0)
+        return RT_NULL;
+
+    if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+            rt_memcmp(header.magic, RTGUI_PACK_MAGIC, 4) != 0 ||
+            header.version != RTGUI_PACK_VERSION || header.buckets == 0)
+        goto __fail;
+
+    pack = (struct rtgui_pack *)rtgui_malloc(sizeof(struct rtgui_pack));
+    if (pack == RT_NULL)
+        goto __fail;
+
+    /* the directory is loaded in one block */
+    size = header.buckets * sizeof(rt_uint32_t) + header.count * sizeof(struct rtgui_pack_entry) +
+           header.names_size;
+    pack->buckets = (rt_uint32_t *)rtgui_malloc(size + 1);
+    if (pack->buckets == RT_NULL || read(fd, pack->buckets, size) != (int)size)
+    {
+        if (pack->buckets != RT_NULL) rtgui_free(pack->buckets);
+        rtgui_free(pack);
+        goto __fail;
+    }
+    pack->entries = (struct rtgui_pack_entry *)(pack->buckets + header.buckets);
+    pack->names = (char *)(pack->entries + header.count);
+    pack->names[header.names_size] = '\0';
+
+    rt_list_init(&pack->list);
+    pack->prefix = RT_NULL;
+    pack->fd = fd;
+    rt_mutex_init(&pack->lock, "pack", RT_IPC_FLAG_FIFO);
+    pack->refcount = 1;
+    pack->header = header;
+
+    return pack;
+
+__fail:
+    close(fd);
+    return RT_NULL;
+}
+RTM_EXPORT(rtgui_pack_open);
+
+void rtgui_pack_close(struct rtgui_pack *pack)
+{
+    RT_ASSERT(pack != RT_NULL);
+
+    rtgui_pack_unmount(pack);
+    _pack_release(pack);
+}
+RTM_EXPORT(rtgui_pack_close);
+
+static struct rtgui_pack_entry *_pack_find(struct rtgui_pack *pack, const char *name)
+{
+    rt_uint32_t hash, index;
+    struct rtgui_pack_entry *entry;
+
+    hash = rtgui_pack_hash(name);
+    index = pack->buckets[hash % pack->header.buckets];
+    while (index < pack->header.count)
+    {
+        entry = &pack->entries[index];
+        if (entry->hash == hash && entry->name < pack->header.names_size &&
+                rt_strcmp(pack->names + entry->name, name) == 0)
+            return entry;
+
+        index = entry->next;
+    }
+
+    return RT_NULL;
+}
+
+static int pack_file_seek(struct rtgui_filerw *context, rt_off_t offset, int whence)
+{
+    struct rtgui_pack_file *file = (struct rtgui_pack_file *)context;
+
+    switch (whence)
+    {
+    case RTGUI_FILE_SEEK_SET:
+        break;
+    case RTGUI_FILE_SEEK_CUR:
+        offset += file->offset;
+        break;
+    case RTGUI_FILE_SEEK_END:
+        offset += file->size;
+        break;
+    default:
+        return -1;
+    }
+
+    if (offset < 0)
+        return -1;
+    if (offset > (rt_off_t)file->size)
+        offset = file->size;
+
+    file->offset = offset;
+    return offset;
+}
+
+/* read the block from the offset of entry into buffer */
+static void pack_file_fill(struct rtgui_pack_file *file, rt_uint32_t start)
+{
+    int result;
+    rt_uint32_t size;
+
+    size = file->size - start;
+    if (size > sizeof(file->buffer))
+        size = sizeof(file->buffer);
+
+    result = _pack_read(file->pack, file->start + start, file->buffer, size);
+    file->base = start;
+    file->length = result > 0 ? result : 0;
+}
+
+static int pack_file_read(struct rtgui_filerw *context, void *ptr, rt_size_t size, rt_size_t maxnum)
+{
+    int result;
+    rt_size_t total, count;
+    rt_uint8_t *dst = (rt_uint8_t *)ptr;
+    struct rtgui_pack_file *file = (struct rtgui_pack_file *)context;
+
+    total = size * maxnum;
+    if (total > file->size - file->offset)
+        total = file->size - file->offset;
+
+    while (total > 0)
+    {
+        if (file->offset >= file->base && file->offset < file->base + file->length)
+        {
+            count = file->base + file->length - file->offset;
+            if (count > total) count = total;
+
+            memcpy(dst, file->buffer + (file->offset - file->base), count);
+        }
+        else if (total >= sizeof(file->buffer))
+        {
+            /* the large read is not copied through the buffer */
+            result = _pack_read(file->pack, file->start + file->offset, dst, total);
+            if (result <= 0)
+                break;
+            count = result;
+        }
+        else
+        {
+            pack_file_fill(file, file->offset - file->offset % sizeof(file->buffer));
+            if (file->offset < file->base || file->offset >= file->base + file->length)
+                break;
+            continue;
+        }
+
+        dst += count;
+        total -= count;
+        file->offset += count;
+    }
+
+    return dst - (rt_uint8_t *)ptr;
+}
+
+static int pack_write(struct rtgui_filerw *context, const void *ptr, rt_size_t size, rt_size_t num)
+{
+    return 0; /* the pack is read only */
+}
+
+static int pack_file_tell(struct rtgui_filerw *context)
+{
+    return ((struct rtgui_pack_file *)context)->offset;
+}
+
+static int pack_file_eof(struct rtgui_filerw *context)
+{
+    struct rtgui_pack_file *file = (struct rtgui_pack_file *)context;
+
+    return file->offset >= file->size ? 1 : -1;
+}
+
+static const void *pack_file_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length)
+{
+    rt_uint32_t start;
+    struct rtgui_pack_file *file = (struct rtgui_pack_file *)context;
+
+    if (offset < 0 || length > sizeof(file->buffer) || offset + length > file->size)
+        return RT_NULL;
+
+    if (offset < (rt_off_t)file->base || offset + length > file->base + file->length)
+    {
+        start = offset - offset % sizeof(file->buffer);
+        if (offset + length > start + sizeof(file->buffer))
+            start = offset;
+        pack_file_fill(file, start);
+
+        if (offset < (rt_off_t)file->base || offset + length > file->base + file->length)
+            return RT_NULL;
+    }
+
+    return file->buffer + (offset - file->base);
+}
+
+static int pack_file_close(struct rtgui_filerw *context)
+{
+    struct rtgui_pack_file *file = (struct rtgui_pack_file *)context;
+
+    _pack_release(file->pack);
+    rtgui_free(file);
+
+    return 0;
+}
+
+static int pack_blob_seek(struct rtgui_filerw *context, rt_off_t offset, int whence)
+{
+    struct rtgui_pack_blob *blob = (struct rtgui_pack_blob *)context;
+
+    switch (whence)
+    {
+    case RTGUI_FILE_SEEK_SET:
+        break;
+    case RTGUI_FILE_SEEK_CUR:
+        offset += blob->offset;
+        break;
+    case RTGUI_FILE_SEEK_END:
+        offset += blob->size;
+        break;
+    default:
+        return -1;
+    }
+
+    if (offset < 0)
+        return -1;
+    if (offset > (rt_off_t)blob->size)
+        offset = blob->size;
+
+    blob->offset = offset;
+    return offset;
+}
+
+static int pack_blob_read(struct rtgui_filerw *context, void *ptr, rt_size_t size, rt_size_t maxnum)
+{
+    rt_size_t total;
+    struct rtgui_pack_blob *blob = (struct rtgui_pack_blob *)context;
+
+    total = size * maxnum;
+    if (total > blob->size - blob->offset)
+        total = blob->size - blob->offset;
+
+    memcpy(ptr, _pack_blob_data(blob) + blob->offset, total);
+    blob->offset += total;
+
+    return total;
+}
+
+static int pack_blob_tell(struct rtgui_filerw *context)
+{
+    return ((struct rtgui_pack_blob *)context)->offset;
+}
+
+static int pack_blob_eof(struct rtgui_filerw *context)
+{
+    struct rtgui_pack_blob *blob = (struct rtgui_pack_blob *)context;
+
+    return blob->offset >= blob->size ? 1 : -1;
+}
+
+static const void *pack_blob_map(struct rtgui_filerw *context, rt_off_t offset, rt_size_t length)
+{
+    struct rtgui_pack_blob *blob = (struct rtgui_pack_blob *)context;
+
+    if (offset < 0 || offset + length > blob->size)
+        return RT_NULL;
+
+    return _pack_blob_data(blob) + offset;
+}
+
+static int pack_blob_close(struct rtgui_filerw *context)
+{
+    struct rtgui_pack_blob *blob = (struct rtgui_pack_blob *)context;
+
+    _pack_release(blob->pack);
+    rtgui_free(blob);
+
+    return 0;
+}
+
+#ifdef PKG_USING_FASTLZ
+static struct rtgui_filerw *_pack_open_blob(struct rtgui_pack *pack, struct rtgui_pack_entry *entry)
+{
+    rt_uint8_t *data;
+    struct rtgui_pack_blob *blob;
+
+    blob = (struct rtgui_pack_blob *)rtgui_malloc(sizeof(struct rtgui_pack_blob) + entry->length);
+    if (blob == RT_NULL)
+        return RT_NULL;
+
+    data = (rt_uint8_t *)rtgui_malloc(entry->size);
+    if (data == RT_NULL ||
+            _pack_read(pack, entry->offset, data, entry->size) != (int)entry->size ||
+            fastlz_decompress(data, entry->size, _pack_blob_data(blob), entry->length) != (int)entry->length)
+    {
+        if (data != RT_NULL) rtgui_free(data);
+        rtgui_free(blob);
+        return RT_NULL;
+    }
+    rtgui_free(data);
+
+    blob->parent.seek  = pack_blob_seek;
+    blob->parent.read  = pack_blob_read;
+    blob->parent.write = pack_write;
+    blob->parent.tell  = pack_blob_tell;
+    blob->parent.eof   = pack_blob_eof;
+    blob->parent.close = pack_blob_close;
+    blob->parent.map   = pack_blob_map;
+
+    blob->pack = pack;
+    blob->size = entry->length;
+    blob->offset = 0;
+    _pack_refer(pack);
+
+    return &(blob->parent);
+}
+#endif
+
+struct rtgui_filerw *rtgui_pack_open_entry(struct rtgui_pack *pack, const char *name)
+{
+    struct rtgui_pack_entry *entry;
+    struct rtgui_pack_file *file;
+
+    RT_ASSERT(pack != RT_NULL && name != RT_NULL);
+
+    entry = _pack_find(pack, name);
+    if (entry == RT_NULL)
+        return RT_NULL;
+
+#ifdef PKG_USING_FASTLZ
+    if (entry->method == RTGUI_PACK_FASTLZ)
+        return _pack_open_blob(pack, entry);
+#endif
+    if (entry->method != RTGUI_PACK_STORE)
+        return RT_NULL;
+
+    file = (struct rtgui_pack_file *)rtgui_malloc(sizeof(struct rtgui_pack_file));
+    if (file == RT_NULL)
+        return RT_NULL;
+
+    file->parent.seek  = pack_file_seek;
+    file->parent.read  = pack_file_read;
+    file->parent.write = pack_write;
+    file->parent.tell  = pack_file_tell;
+    file->parent.eof   = pack_file_eof;
+    file->parent.close = pack_file_close;
+    file->parent.map   = pack_file_map;
+
+    file->pack = pack;
+    file->start = entry->offset;
+    file->size = entry->size;
+    file->offset = 0;
+    file->base = 0;
+    file->length = 0;
+    _pack_refer(pack);
+
+    return &(file->parent);
+}
+RTM_EXPORT(rtgui_pack_open_entry);
+
+static struct rt_mutex *_pack_get_mount_lock(void)
+{
+    static struct rt_mutex lock;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (_pack_mount_lock == RT_NULL)
+    {
+        rt_mutex_init(&lock, "pmount", RT_IPC_FLAG_FIFO);
+        _pack_mount_lock = &lock;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return _pack_mount_lock;
+}
+
+rt_err_t rtgui_pack_mount(struct rtgui_pack *pack, const char *prefix)
+{
+    struct rt_mutex *lock;
+
+    RT_ASSERT(pack != RT_NULL && prefix != RT_NULL);
+
+    lock = _pack_get_mount_lock();
+    rt_mutex_take(lock, RT_WAITING_FOREVER);
+    if (pack->prefix != RT_NULL)
+    {
+        rt_mutex_release(lock);
+        return -RT_EBUSY;
+    }
+
+    pack->prefix = rt_strdup(prefix);
+    if (pack->prefix == RT_NULL)
+    {
+        rt_mutex_release(lock);
+        return -RT_ENOMEM;
+    }
+    rt_list_insert_before(&_pack_mount_list, &pack->list);
+    rt_mutex_release(lock);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_pack_mount);
+
+void rtgui_pack_unmount(struct rtgui_pack *pack)
+{
+    struct rt_mutex *lock;
+
+    RT_ASSERT(pack != RT_NULL);
+
+    lock = _pack_get_mount_lock();
+    rt_mutex_take(lock, RT_WAITING_FOREVER);
+    if (pack->prefix != RT_NULL)
+    {
+        rt_list_remove(&pack->list);
+        rt_free(pack->prefix);
+        pack->prefix = RT_NULL;
+    }
+    rt_mutex_release(lock);
+}
+RTM_EXPORT(rtgui_pack_unmount);
+
+struct rtgui_filerw *rtgui_pack_open_file(const char *filename)
+{
+    rt_size_t len;
+    rt_list_t *node;
+    struct rtgui_pack *pack;
+    struct rtgui_filerw *filerw = RT_NULL;
+
+    RT_ASSERT(filename != RT_NULL);
+
+    /* no pack is mounted */
+    if (_pack_mount_lock == RT_NULL)
+        return RT_NULL;
+
+    rt_mutex_take(_pack_mount_lock, RT_WAITING_FOREVER);
+    rt_list_for_each(node, &_pack_mount_list)
+    {
+        pack = rt_list_entry(node, struct rtgui_pack, list);
+        len = rt_strlen(pack->prefix);
+        if (rt_strncmp(filename, pack->prefix, len) == 0)
+        {
+            filerw = rtgui_pack_open_entry(pack, filename + len);
+            if (filerw != RT_NULL)
+                break;
+        }
+    }
+    rt_mutex_release(_pack_mount_lock);
+
+    return filerw;
+}
+RTM_EXPORT(rtgui_pack_open_file);
+
+#endif
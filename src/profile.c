@@ -0,0 +1,479 @@
+/*
+ * File      : profile.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtthread.h>
+#include <rtgui/profile.h>
+#include <rtgui/widgets/window.h>
+
+#ifdef GUIENGINE_USING_PROFILE
+
+struct rtgui_profile_stat
+{
+    rt_uint32_t calls;
+    rt_uint32_t pixels;
+    rt_uint32_t us;
+};
+
+struct rtgui_profile_win
+{
+    struct rtgui_win *win;
+    char title[GUIENGINE_NAME_MAX];
+
+    /* the thread drawing the window and the start of drawing */
+    rt_thread_t owner;
+    rt_uint32_t start;
+
+    rt_uint32_t frames;
+    rt_uint32_t max_us;
+    /* the frame being drawn, the last frame and the sum of frames */
+    struct rtgui_profile_stat frame[RTGUI_PROFILE_ITEM_MAX];
+    struct rtgui_profile_stat last[RTGUI_PROFILE_ITEM_MAX];
+    struct rtgui_profile_stat total[RTGUI_PROFILE_ITEM_MAX];
+};
+
+struct rtgui_profile_blit
+{
+    rt_uint8_t src_format;
+    rt_uint8_t dst_format;
+    struct rtgui_profile_stat stat;
+};
+
+/* the first one is for the calls out of drawing */
+static struct rtgui_profile_win _profile_wins[GUIENGINE_PROFILE_WINS + 1];
+static struct rtgui_profile_blit _profile_blits[GUIENGINE_PROFILE_BLITS];
+
+static const char *_profile_item_name[RTGUI_PROFILE_ITEM_MAX] =
+{
+    "drawing", "point", "line", "span", "fill", "blit", "font", "update",
+};
+
+/* the window drawn by current thread, invoked in critical */
+static struct rtgui_profile_win *_profile_current(void)
+{
+    int index;
+    rt_thread_t self = rt_thread_self();
+
+    for (index = 1; index <= GUIENGINE_PROFILE_WINS; index ++)
+    {
+        if (_profile_wins[index].owner == self)
+            return &_profile_wins[index];
+    }
+
+    return &_profile_wins[0];
+}
+
+rt_inline void _profile_stat_add(struct rtgui_profile_stat *stat, rt_uint32_t pixels, rt_uint32_t us)
+{
+    stat->calls ++;
+    stat->pixels += pixels;
+    stat->us += us;
+}
+
+static void _profile_add(enum rtgui_profile_item item, rt_uint32_t pixels, rt_uint32_t us)
+{
+    struct rtgui_profile_win *pwin;
+
+    rt_enter_critical();
+    pwin = _profile_current();
+    _profile_stat_add(&pwin->frame[item], pixels, us);
+    /* there is no frame out of drawing */
+    if (pwin == &_profile_wins[0])
+        _profile_stat_add(&pwin->total[item], pixels, us);
+    rt_exit_critical();
+}
+
+void rtgui_profile_add(enum rtgui_profile_item item, rt_uint32_t pixels, rt_uint32_t start)
+{
+    _profile_add(item, pixels, rtgui_profile_clock() - start);
+}
+RTM_EXPORT(rtgui_profile_add);
+
+void rtgui_profile_blit(rt_uint8_t src_format, rt_uint8_t dst_format,
+                        rt_uint32_t pixels, rt_uint32_t start)
+{
+    int index;
+    rt_uint32_t us;
+    struct rtgui_profile_blit *blit = RT_NULL;
+
+    us = rtgui_profile_clock() - start;
+    _profile_add(RTGUI_PROFILE_BLIT, pixels, us);
+
+    rt_enter_critical();
+    for (index = 0; index < GUIENGINE_PROFILE_BLITS; index ++)
+    {
+        if (_profile_blits[index].stat.calls == 0 ||
+                (_profile_blits[index].src_format == src_format &&
+                 _profile_blits[index].dst_format == dst_format))
+        {
+            blit = &_profile_blits[index];
+            break;
+        }
+    }
+    if (blit != RT_NULL)
+    {
+        blit->src_format = src_format;
+        blit->dst_format = dst_format;
+        _profile_stat_add(&blit->stat, pixels, us);
+    }
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_profile_blit);
+
+void rtgui_profile_drawing_begin(struct rtgui_win *win)
+{
+    int index;
+    struct rtgui_profile_win *pwin = RT_NULL, *spare = RT_NULL;
+
+    rt_enter_critical();
+    for (index = 1; index <= GUIENGINE_PROFILE_WINS; index ++)
+    {
+        if (_profile_wins[index].win == win)
+        {
+            pwin = &_profile_wins[index];
+            break;
+        }
+
+        /* replace the window drawn in the fewest frames */
+        if (_profile_wins[index].owner == RT_NULL &&
+                (spare == RT_NULL || _profile_wins[index].frames < spare->frames))
+            spare = &_profile_wins[index];
+    }
+
+    if (pwin == RT_NULL && spare != RT_NULL)
+    {
+        pwin = spare;
+        rt_memset(pwin, 0, sizeof(*pwin));
+        pwin->win = win;
+        if (win->title != RT_NULL)
+            rt_strncpy(pwin->title, win->title, sizeof(pwin->title) - 1);
+    }
+
+    if (pwin != RT_NULL)
+    {
+        rt_memset(pwin->frame, 0, sizeof(pwin->frame));
+        pwin->owner = rt_thread_self();
+        pwin->start = rtgui_profile_clock();
+    }
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_profile_drawing_begin);
+
+void rtgui_profile_drawing_end(struct rtgui_win *win)
+{
+    int index, item;
+    rt_uint32_t us;
+    struct rtgui_profile_win *pwin;
+
+    rt_enter_critical();
+    for (index = 1; index <= GUIENGINE_PROFILE_WINS; index ++)
+    {
+        pwin = &_profile_wins[index];
+        if (pwin->win != win || pwin->owner != rt_thread_self())
+            continue;
+
+        us = rtgui_profile_clock() - pwin->start;
+        _profile_stat_add(&pwin->frame[RTGUI_PROFILE_DRAWING], 0, us);
+        if (us > pwin->max_us) pwin->max_us = us;
+
+        for (item = 0; item < RTGUI_PROFILE_ITEM_MAX; item ++)
+        {
+            pwin->last[item] = pwin->frame[item];
+            pwin->total[item].calls += pwin->frame[item].calls;
+            pwin->total[item].pixels += pwin->frame[item].pixels;
+            pwin->total[item].us += pwin->frame[item].us;
+        }
+        pwin->frames ++;
+        pwin->owner = RT_NULL;
+        break;
+    }
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_profile_drawing_end);
+
+void rtgui_profile_reset(void)
+{
+    int index;
+
+    rt_enter_critical();
+    for (index = 0; index <= GUIENGINE_PROFILE_WINS; index ++)
+    {
+        struct rtgui_profile_win *pwin = &_profile_wins[index];
+
+        pwin->frames = 0;
+        pwin->max_us = 0;
+        rt_memset(pwin->last, 0, sizeof(pwin->last));
+        rt_memset(pwin->total, 0, sizeof(pwin->total));
+        if (pwin->owner == RT_NULL)
+            rt_memset(pwin->frame, 0, sizeof(pwin->frame));
+    }
+    rt_memset(_profile_blits, 0, sizeof(_profile_blits));
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_profile_reset);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+static void _profile_dump_win(struct rtgui_profile_win *pwin)
+{
+    int item;
+    rt_uint32_t frames;
+
+    frames = pwin->frames ? pwin->frames : 1;
+    rt_kprintf("%-16s frames: %d, max: %dus\n", pwin == &_profile_wins[0] ? "-" : pwin->title,
+               pwin->frames, pwin->max_us);
+    for (item = 0; item < RTGUI_PROFILE_ITEM_MAX; item ++)
+    {
+        if (pwin->total[item].calls == 0) continue;
+
+        /* the last frame and the average of frames */
+        rt_kprintf("  %-8s last %5d calls %8d %s %8dus, avg %5d calls %8d %s %8dus\n",
+                   _profile_item_name[item],
+                   pwin->last[item].calls, pwin->last[item].pixels,
+                   item == RTGUI_PROFILE_FONT ? "glyphs" : "pixels", pwin->last[item].us,
+                   pwin->total[item].calls / frames, pwin->total[item].pixels / frames,
+                   item == RTGUI_PROFILE_FONT ? "glyphs" : "pixels", pwin->total[item].us / frames);
+    }
+}
+
+void list_guiprof(void)
+{
+    int index;
+
+    for (index = 0; index <= GUIENGINE_PROFILE_WINS; index ++)
+    {
+        if (index == 0 || _profile_wins[index].win != RT_NULL)
+            _profile_dump_win(&_profile_wins[index]);
+    }
+
+    rt_kprintf("blit (src -> dst format):\n");
+    for (index = 0; index < GUIENGINE_PROFILE_BLITS; index ++)
+    {
+        struct rtgui_profile_blit *blit = &_profile_blits[index];
+
+        if (blit->stat.calls == 0) break;
+        rt_kprintf("  0x%02x -> 0x%02x %8d calls %10d pixels %10dus\n", blit->src_format,
+                   blit->dst_format, blit->stat.calls, blit->stat.pixels, blit->stat.us);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_guiprof, display the render profile of windows);
+FINSH_FUNCTION_EXPORT_ALIAS(rtgui_profile_reset, guiprof_reset, reset the render profile);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(list_guiprof, display the render profile of windows);
+MSH_CMD_EXPORT_ALIAS(rtgui_profile_reset, guiprof_reset, reset the render profile);
+#endif
+#endif
+
+#endif
+
+#ifdef GUIENGINE_USING_LATENCY
+#include <rtgui/event.h>
+
+struct rtgui_latency
+{
+    rt_uint32_t count;
+    rt_uint32_t min_us;
+    rt_uint32_t max_us;
+    rt_uint64_t sum_us;
+    /* the last one is for the latency out of buckets */
+    rt_uint32_t buckets[GUIENGINE_LATENCY_BUCKETS + 1];
+};
+static struct rtgui_latency _latency;
+
+void rtgui_latency_stamp(struct rtgui_event *event)
+{
+    rt_uint32_t now = GUIENGINE_PROFILE_CLOCK();
+
+    /* 0 is for the event without stamp */
+    event->stamp = now ? now : 1;
+}
+RTM_EXPORT(rtgui_latency_stamp);
+
+void rtgui_latency_add(rt_uint32_t stamp)
+{
+    rt_uint32_t us, index;
+
+    us = GUIENGINE_PROFILE_CLOCK() - stamp;
+    index = us / GUIENGINE_LATENCY_BUCKET_US;
+    if (index > GUIENGINE_LATENCY_BUCKETS)
+        index = GUIENGINE_LATENCY_BUCKETS;
+
+    rt_enter_critical();
+    if (_latency.count == 0 || us < _latency.min_us) _latency.min_us = us;
+    if (us > _latency.max_us) _latency.max_us = us;
+    _latency.count ++;
+    _latency.sum_us += us;
+    _latency.buckets[index] ++;
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_latency_add);
+
+void rtgui_latency_reset(void)
+{
+    rt_enter_critical();
+    rt_memset(&_latency, 0, sizeof(_latency));
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_latency_reset);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+/* the upper bound of bucket that the percent of latency are in */
+static rt_uint32_t _latency_percentile(struct rtgui_latency *latency, int percent)
+{
+    int index;
+    rt_uint32_t target, count = 0;
+
+    target = (rt_uint32_t)(((rt_uint64_t)latency->count * percent + 99) / 100);
+    for (index = 0; index < GUIENGINE_LATENCY_BUCKETS; index ++)
+    {
+        count += latency->buckets[index];
+        if (count >= target)
+            return (index + 1) * GUIENGINE_LATENCY_BUCKET_US;
+    }
+
+    return latency->max_us;
+}
+
+void list_guilat(void)
+{
+    struct rtgui_latency latency;
+
+    rt_enter_critical();
+    latency = _latency;
+    rt_exit_critical();
+
+    rt_kprintf("input to screen: %d samples\n", latency.count);
+    if (latency.count == 0) return;
+
+    rt_kprintf("min %dus, avg %dus, max %dus\n", latency.min_us,
+               (rt_uint32_t)(latency.sum_us / latency.count), latency.max_us);
+    rt_kprintf("p50 <= %dus, p90 <= %dus, p99 <= %dus\n",
+               _latency_percentile(&latency, 50),
+               _latency_percentile(&latency, 90),
+               _latency_percentile(&latency, 99));
+}
+FINSH_FUNCTION_EXPORT(list_guilat, display the latency from input to screen);
+FINSH_FUNCTION_EXPORT_ALIAS(rtgui_latency_reset, guilat_reset, reset the latency from input to screen);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(list_guilat, display the latency from input to screen);
+MSH_CMD_EXPORT_ALIAS(rtgui_latency_reset, guilat_reset, reset the latency from input to screen);
+#endif
+#endif
+
+#endif
+
+#ifdef GUIENGINE_USING_BOOT_PROFILE
+struct rtgui_boot_stat
+{
+    /* the first begin or mark */
+    rt_uint32_t at;
+    rt_uint32_t us;
+    rt_uint32_t count;
+    rt_uint32_t start;
+};
+static struct rtgui_boot_stat _boot[RTGUI_BOOT_PHASE_MAX];
+static rt_bool_t _boot_reported = RT_FALSE;
+
+static const char *_boot_name[RTGUI_BOOT_PHASE_MAX] =
+{
+    "server init",
+    " image",
+    "  container",
+    " font",
+    " ttf",
+    "ttf face",
+    " server",
+    "first show",
+    "first update",
+};
+
+static void _boot_report(void)
+{
+    int index;
+    struct rtgui_boot_stat *stat;
+
+    rt_kprintf("%-14s %10s %10s %5s\n", "gui boot", "at(us)", "time(us)", "count");
+    for (index = 0; index < RTGUI_BOOT_PHASE_MAX; index ++)
+    {
+        stat = &_boot[index];
+        if (stat->count == 0)
+            continue;
+
+        if (index == RTGUI_BOOT_FIRST_SHOW || index == RTGUI_BOOT_FIRST_UPDATE)
+            rt_kprintf("%-14s %10d %10s %5s\n", _boot_name[index], stat->at, "-", "-");
+        else
+            rt_kprintf("%-14s %10d %10d %5d\n", _boot_name[index], stat->at, stat->us, stat->count);
+    }
+}
+
+void rtgui_boot_begin(enum rtgui_boot_phase phase)
+{
+    struct rtgui_boot_stat *stat = &_boot[phase];
+
+    stat->start = GUIENGINE_PROFILE_CLOCK();
+    if (stat->count == 0)
+        stat->at = stat->start;
+}
+RTM_EXPORT(rtgui_boot_begin);
+
+void rtgui_boot_end(enum rtgui_boot_phase phase)
+{
+    struct rtgui_boot_stat *stat = &_boot[phase];
+
+    stat->us += GUIENGINE_PROFILE_CLOCK() - stat->start;
+    stat->count ++;
+}
+RTM_EXPORT(rtgui_boot_end);
+
+void rtgui_boot_mark(enum rtgui_boot_phase phase)
+{
+    struct rtgui_boot_stat *stat = &_boot[phase];
+
+    if (stat->count != 0)
+        return;
+
+    stat->at = GUIENGINE_PROFILE_CLOCK();
+    stat->count = 1;
+
+    /* the UI is on the screen */
+    if (phase == RTGUI_BOOT_FIRST_UPDATE && !_boot_reported)
+    {
+        _boot_reported = RT_TRUE;
+        _boot_report();
+    }
+}
+RTM_EXPORT(rtgui_boot_mark);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+void list_guiboot(void)
+{
+    _boot_report();
+}
+FINSH_FUNCTION_EXPORT(list_guiboot, display the time of gui boot);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(list_guiboot, display the time of gui boot);
+#endif
+#endif
+
+#endif
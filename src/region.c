@@ -21,6 +21,8 @@
  * Date           Author       Notes
  * 2009-10-16     Bernard      first version
  */
+#define RTGUI_MEM_TAG   RTGUI_MEM_REGION
+
 #include <rtgui/region.h>
 #include <rtgui/rtgui_system.h>
 
@@ -130,8 +132,251 @@ static rtgui_region_status_t rtgui_break(rtgui_region_t *pReg);
         ((r1)->y1 >= (r2)->y1) && \
         ((r1)->y2 <= (r2)->y2) )
 
-#define allocData(n) rtgui_malloc(PIXREGION_SZOF(n))
-#define freeData(reg) if ((reg)->data && (reg)->data->size) rtgui_free((reg)->data)
+#ifdef GUIENGINE_USING_REGION_STAT
+/*
+ * The statistics of region operations. The operation in progress is recorded
+ * when it's called, the merge and realloc are counted for it. The regions are
+ * mostly operated in the thread of server and applications, a race only
+ * makes the statistics inaccurate.
+ */
+static struct rtgui_region_stat _region_stat[RTGUI_REGION_OP_NUM];
+static enum rtgui_region_op _region_stat_op = RTGUI_REGION_OP_INTERSECT;
+static rt_uint32_t _region_warn_rects = GUIENGINE_REGION_WARN_RECTS;
+static rtgui_region_warn_hook_t _region_warn_hook = RT_NULL;
+
+#define REGION_STAT_CALL(op, reg1, n2)                              \
+    do {                                                            \
+        _region_stat_op = (op);                                     \
+        _region_stat[op].calls ++;                                  \
+        _region_stat[op].rects_in += PIXREGION_NUM_RECTS(reg1) + (n2); \
+    } while (0)
+#define REGION_STAT_MERGE(reg)      _region_stat_merge(reg)
+#define REGION_STAT_REALLOC()       (_region_stat[_region_stat_op].reallocs ++)
+
+static void _region_stat_merge(rtgui_region_t *region)
+{
+    rt_uint32_t num = PIXREGION_NUM_RECTS(region);
+    struct rtgui_region_stat *stat = &_region_stat[_region_stat_op];
+
+    stat->merges ++;
+    stat->rects_out += num;
+    if (num > stat->max_rects)
+        stat->max_rects = num;
+
+    if (num > _region_warn_rects)
+    {
+        stat->warns ++;
+        if (_region_warn_hook != RT_NULL)
+            _region_warn_hook(region, _region_stat_op);
+    }
+}
+
+const struct rtgui_region_stat *rtgui_region_stat_get(enum rtgui_region_op op)
+{
+    if (op >= RTGUI_REGION_OP_NUM)
+        return RT_NULL;
+
+    return &_region_stat[op];
+}
+RTM_EXPORT(rtgui_region_stat_get);
+
+void rtgui_region_stat_reset(void)
+{
+    rt_memset(_region_stat, 0, sizeof(_region_stat));
+}
+RTM_EXPORT(rtgui_region_stat_reset);
+
+void rtgui_region_stat_set_hook(int rects, rtgui_region_warn_hook_t hook)
+{
+    _region_warn_rects = rects;
+    _region_warn_hook = hook;
+}
+RTM_EXPORT(rtgui_region_stat_set_hook);
+#else
+#define REGION_STAT_CALL(op, reg1, n2)
+#define REGION_STAT_MERGE(reg)
+#define REGION_STAT_REALLOC()
+#endif
+
+/*
+ * Region data pool. The region data is allocated and freed in each region
+ * operation, so the freed blocks are cached in free lists of some size class
+ * to avoid the malloc churn. The size of region data is the capacity of
+ * block, which decides the class it goes back to.
+ */
+#define REGION_POOL_CLASS_NUM   4
+static const rt_uint16_t _region_pool_size[REGION_POOL_CLASS_NUM] = {4, 8, 16, 32};
+
+struct rtgui_region_pool
+{
+    rtgui_region_data_t *free_list;
+    rt_uint16_t cached;
+
+    /* statistics */
+    rt_uint32_t hit, miss;
+};
+static struct rtgui_region_pool _region_pool[REGION_POOL_CLASS_NUM];
+
+static rtgui_region_data_t *_region_data_alloc(int n)
+{
+    int index;
+    rt_base_t level;
+    rtgui_region_data_t *data;
+
+    for (index = 0; index < REGION_POOL_CLASS_NUM; index ++)
+    {
+        if (n <= _region_pool_size[index]) break;
+    }
+
+    if (index == REGION_POOL_CLASS_NUM)
+    {
+        /* too large to be cached */
+        data = (rtgui_region_data_t *)rtgui_malloc(PIXREGION_SZOF(n));
+        if (data) data->size = n;
+        return data;
+    }
+
+    level = rt_hw_interrupt_disable();
+    data = _region_pool[index].free_list;
+    if (data != RT_NULL)
+    {
+        _region_pool[index].free_list = *(rtgui_region_data_t **)data;
+        _region_pool[index].cached --;
+        _region_pool[index].hit ++;
+    }
+    else
+    {
+        _region_pool[index].miss ++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (data == RT_NULL)
+        data = (rtgui_region_data_t *)rtgui_malloc(PIXREGION_SZOF(_region_pool_size[index]));
+    if (data) data->size = _region_pool_size[index];
+
+    return data;
+}
+
+static void _region_data_free(rtgui_region_data_t *data)
+{
+    int index;
+    rt_base_t level;
+
+    for (index = 0; index < REGION_POOL_CLASS_NUM; index ++)
+    {
+        if (data->size == _region_pool_size[index]) break;
+    }
+
+    if (index < REGION_POOL_CLASS_NUM)
+    {
+        level = rt_hw_interrupt_disable();
+        if (_region_pool[index].cached < GUIENGINE_REGION_POOL_CACHE)
+        {
+            *(rtgui_region_data_t **)data = _region_pool[index].free_list;
+            _region_pool[index].free_list = data;
+            _region_pool[index].cached ++;
+            data = RT_NULL;
+        }
+        rt_hw_interrupt_enable(level);
+    }
+
+    if (data != RT_NULL)
+        rtgui_free(data);
+}
+
+/*
+ * The small region stores the rects in itself. The data of region points to
+ * the inline data in this case, which is never freed.
+ */
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+#define REGION_INLINE_DATA(reg) (&(reg)->inline_data.head)
+#else
+#define REGION_INLINE_DATA(reg) ((rtgui_region_data_t *)RT_NULL)
+#endif
+
+static rtgui_region_data_t *_region_data_alloc_for(rtgui_region_t *region, int n)
+{
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+    if (n <= GUIENGINE_REGION_INLINE_RECTS)
+    {
+        region->inline_data.head.size = GUIENGINE_REGION_INLINE_RECTS;
+        return REGION_INLINE_DATA(region);
+    }
+#endif
+
+    return _region_data_alloc(n);
+}
+
+static void _region_data_free_for(rtgui_region_t *region, rtgui_region_data_t *data)
+{
+    if (data != REGION_INLINE_DATA(region))
+        _region_data_free(data);
+}
+
+static rtgui_region_data_t *_region_data_realloc(rtgui_region_t *region, int n)
+{
+    rtgui_region_data_t *data, *new_data;
+
+    data = region->data;
+    if (data == REGION_INLINE_DATA(region) && (rt_uint32_t)n <= data->size)
+        return data;
+
+    if (data == REGION_INLINE_DATA(region))
+        new_data = _region_data_alloc(n);
+    else
+        new_data = _region_data_alloc_for(region, n);
+    if (new_data == RT_NULL)
+        return RT_NULL;
+
+    new_data->numRects = RTGUI_MIN(data->numRects, (rt_uint32_t)n);
+    rt_memcpy(new_data + 1, data + 1, new_data->numRects * sizeof(rtgui_rect_t));
+    _region_data_free_for(region, data);
+    REGION_STAT_REALLOC();
+
+    return new_data;
+}
+
+/* fix the data of a region which is copied by value from the other */
+static void _region_data_moved(rtgui_region_t *dest, rtgui_region_data_t *inline_data)
+{
+    if (dest->data != RT_NULL && dest->data == inline_data)
+        dest->data = REGION_INLINE_DATA(dest);
+}
+
+void rtgui_region_pool_dump(void)
+{
+    int index;
+
+    for (index = 0; index < REGION_POOL_CLASS_NUM; index ++)
+    {
+        rt_kprintf("region pool %2d rects: cached %d, hit %d, miss %d\n",
+                   _region_pool_size[index], _region_pool[index].cached,
+                   _region_pool[index].hit, _region_pool[index].miss);
+    }
+
+#ifdef GUIENGINE_USING_REGION_STAT
+    {
+        static const char *op_name[RTGUI_REGION_OP_NUM] =
+        {
+            "intersect", "union", "subtract", "inverse"
+        };
+
+        rt_kprintf("%-10s %8s %8s %9s %9s %8s %5s %5s\n", "region op", "calls", "merges",
+                   "rects in", "rects out", "reallocs", "max", "warns");
+        for (index = 0; index < RTGUI_REGION_OP_NUM; index ++)
+        {
+            struct rtgui_region_stat *stat = &_region_stat[index];
+
+            rt_kprintf("%-10s %8d %8d %9d %9d %8d %5d %5d\n", op_name[index], stat->calls,
+                       stat->merges, stat->rects_in, stat->rects_out, stat->reallocs,
+                       stat->max_rects, stat->warns);
+        }
+    }
+#endif
+}
+
+#define allocData(reg, n) _region_data_alloc_for(reg, n)
+#define freeData(reg) if ((reg)->data && (reg)->data->size) _region_data_free_for(reg, (reg)->data)
 
 #define RECTALLOC_BAIL(pReg,n,bail) \
 if (!(pReg)->data || (((pReg)->data->numRects + (n)) > (pReg)->data->size)) \
@@ -167,10 +412,9 @@ if (!(pReg)->data || (((pReg)->data->numRects + (n)) > (pReg)->data->size)) \
 if (((numRects) < ((reg)->data->size >> 1)) && ((reg)->data->size > 50)) \
 {                                    \
     rtgui_region_data_t * NewData;                           \
-    NewData = (rtgui_region_data_t *)rt_realloc((reg)->data, PIXREGION_SZOF(numRects));  \
+    NewData = _region_data_realloc(reg, numRects);              \
     if (NewData)                             \
     {                                    \
-    NewData->size = (numRects);                  \
     (reg)->data = NewData;                       \
     }                                    \
 }
@@ -179,6 +423,7 @@ void rtgui_region_init(rtgui_region_t *region)
 {
     region->extents = rtgui_empty_rect;
     region->data = &rtgui_region_emptydata;
+    region->hint = 0;
 }
 RTM_EXPORT(rtgui_region_init);
 
@@ -190,12 +435,14 @@ void rtgui_region_init_rect(rtgui_region_t *region,
     region->extents.x2 = x + width;
     region->extents.y2 = y + height;
     region->data = RT_NULL;
+    region->hint = 0;
 }
 
 void rtgui_region_init_with_extents(rtgui_region_t *region, const rtgui_rect_t *extents)
 {
     region->extents = *extents;
     region->data = RT_NULL;
+    region->hint = 0;
 }
 
 void rtgui_region_fini(rtgui_region_t *region)
@@ -230,14 +477,14 @@ static rtgui_region_status_t rtgui_rect_alloc(rtgui_region_t *region, int n)
     if (!region->data)
     {
         n++;
-        region->data = allocData(n);
+        region->data = allocData(region, n);
         if (!region->data) return rtgui_break(region);
         region->data->numRects = 1;
         *PIXREGION_BOXPTR(region) = region->extents;
     }
     else if (!region->data->size)
     {
-        region->data = allocData(n);
+        region->data = allocData(region, n);
         if (!region->data) return rtgui_break(region);
         region->data->numRects = 0;
     }
@@ -250,11 +497,11 @@ static rtgui_region_status_t rtgui_rect_alloc(rtgui_region_t *region, int n)
                 n = 250;
         }
         n += region->data->numRects;
-        data = (rtgui_region_data_t *)rt_realloc(region->data, PIXREGION_SZOF(n));
+        data = _region_data_realloc(region, n);
         if (!data) return rtgui_break(region);
         region->data = data;
     }
-    region->data->size = n;
+    /* the size has been set to the capacity of data */
     return RTGUI_REGION_STATUS_SUCCESS;
 }
 
@@ -274,9 +521,8 @@ rtgui_region_status_t rtgui_region_copy(rtgui_region_t *dst, rtgui_region_t *src
     if (!dst->data || (dst->data->size < src->data->numRects))
     {
         freeData(dst);
-        dst->data = allocData(src->data->numRects);
+        dst->data = allocData(dst, src->data->numRects);
         if (!dst->data) return rtgui_break(dst);
-        dst->data->size = src->data->numRects;
     }
     dst->data->numRects = src->data->numRects;
     rt_memmove((char *)PIXREGION_BOXPTR(dst), (char *)PIXREGION_BOXPTR(src),
@@ -505,6 +751,9 @@ rtgui_op(
     short       ybot;           /* Bottom of intersection        */
     short       ytop;           /* Top of intersection       */
     rtgui_region_data_t        *oldData;            /* Old data for newReg       */
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+    struct rtgui_region_inline inline_saved;        /* Old inline data of newReg */
+#endif
     int         prevBand;           /* Index of start of
                              * previous band in newReg       */
     int         curBand;            /* Index of start of current
@@ -548,6 +797,24 @@ rtgui_op(
         oldData = newReg->data;
         newReg->data = &rtgui_region_emptydata;
     }
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+    if (oldData != RT_NULL && oldData == REGION_INLINE_DATA(newReg))
+    {
+        /* the inline data will be overwritten by the result, save the rects */
+        rt_memcpy(&inline_saved, &newReg->inline_data, sizeof(inline_saved));
+        if (newReg == reg1)
+        {
+            r1 = inline_saved.rects;
+            r1End = r1 + inline_saved.head.numRects;
+        }
+        if (newReg == reg2)
+        {
+            r2 = inline_saved.rects;
+            r2End = r2 + inline_saved.head.numRects;
+        }
+        oldData = RT_NULL;
+    }
+#endif
     /* guess at new size */
     if (numRects > newSize)
         newSize = numRects;
@@ -699,7 +966,7 @@ rtgui_op(
     }
 
     if (oldData)
-        rtgui_free(oldData);
+        _region_data_free(oldData);
 
     numRects = newReg->data->numRects;
     if (!numRects)
@@ -717,6 +984,7 @@ rtgui_op(
     {
         DOWNSIZE(newReg, numRects);
     }
+    REGION_STAT_MERGE(newReg);
 
     return RTGUI_REGION_STATUS_SUCCESS;
 }
@@ -854,6 +1122,7 @@ rtgui_region_intersect(rtgui_region_t *newReg,
     good(reg1);
     good(reg2);
     good(newReg);
+    REGION_STAT_CALL(RTGUI_REGION_OP_INTERSECT, reg1, PIXREGION_NUM_RECTS(reg2));
     /* check for trivial reject */
     if (PIXREGION_NIL(reg1)  || PIXREGION_NIL(reg2) ||
             !EXTENTCHECK(&reg1->extents, &reg2->extents))
@@ -908,6 +1177,71 @@ rtgui_region_intersect(rtgui_region_t *newReg,
 }
 RTM_EXPORT(rtgui_region_intersect);
 
+/*
+ * Intersect the region with rect in its own rects. Each rect is clipped to
+ * one rect at most, so the rects are written in place before they are read,
+ * and the bands become the same are coalesced.
+ */
+static rtgui_region_status_t _region_intersect_rect_inplace(rtgui_region_t *region, rtgui_rect_t *rect)
+{
+    rtgui_rect_t *pbox, *pNextRect;
+    int index, end, numRects, prevBand, curBand;
+    int x1, y1, x2, y2;
+
+    pbox = PIXREGION_BOXPTR(region);
+    numRects = region->data->numRects;
+    region->data->numRects = 0;
+    prevBand = 0;
+    for (index = 0; index < numRects; index = end)
+    {
+        for (end = index + 1; end < numRects && pbox[end].y1 == pbox[index].y1; end ++);
+
+        y1 = RTGUI_MAX(pbox[index].y1, rect->y1);
+        y2 = RTGUI_MIN(pbox[index].y2, rect->y2);
+        if (y1 >= y2)
+            continue;
+
+        curBand = region->data->numRects;
+        pNextRect = PIXREGION_TOP(region);
+        for (; index < end; index ++)
+        {
+            x1 = RTGUI_MAX(pbox[index].x1, rect->x1);
+            x2 = RTGUI_MIN(pbox[index].x2, rect->x2);
+            if (x1 >= x2)
+                continue;
+
+            ADDRECT(pNextRect, x1, y1, x2, y2);
+            region->data->numRects ++;
+        }
+        if (region->data->numRects > curBand)
+        {
+            Coalesce(region, prevBand, curBand);
+        }
+    }
+
+    numRects = region->data->numRects;
+    if (!numRects)
+    {
+        freeData(region);
+        region->data = &rtgui_region_emptydata;
+        region->extents.x2 = region->extents.x1;
+        region->extents.y2 = region->extents.y1;
+    }
+    else if (numRects == 1)
+    {
+        region->extents = *PIXREGION_BOXPTR(region);
+        freeData(region);
+        region->data = (rtgui_region_data_t *)RT_NULL;
+    }
+    else
+    {
+        rtgui_set_extents(region);
+    }
+    good(region);
+
+    return RTGUI_REGION_STATUS_SUCCESS;
+}
+
 rtgui_region_status_t
 rtgui_region_intersect_rect(rtgui_region_t *newReg,
                             rtgui_region_t *reg1,
@@ -915,6 +1249,14 @@ rtgui_region_intersect_rect(rtgui_region_t *newReg,
 {
     rtgui_region_t region;
 
+    /* no new data for the intersection of region itself */
+    if (newReg == reg1 && reg1->data != RT_NULL && reg1->data->numRects > 1 &&
+            !SUBSUMES(rect, &reg1->extents))
+    {
+        REGION_STAT_CALL(RTGUI_REGION_OP_INTERSECT, reg1, 1);
+        return _region_intersect_rect_inplace(reg1, rect);
+    }
+
     region.data = RT_NULL;
     region.extents.x1 = rect->x1;
     region.extents.y1 = rect->y1;
@@ -925,6 +1267,114 @@ rtgui_region_intersect_rect(rtgui_region_t *newReg,
 }
 RTM_EXPORT(rtgui_region_intersect_rect);
 
+/*
+ * Set the region to the rect minus the rects, in one pass of the bands
+ * between the edges of the rects. The rects may overlap. The data of region
+ * is reused for the result when it has the room.
+ */
+rtgui_region_status_t rtgui_region_clip_rect_minus_rects(rtgui_region_t *region, const rtgui_rect_t *rect,
+                                                         const rtgui_rect_t *rects, int count)
+{
+    const rtgui_rect_t *r;
+    rtgui_rect_t *pNextRect;
+    int index, moved, numRects, prevBand, curBand;
+    int x, y, next, y2;
+
+    good(region);
+    if (rect->x1 >= rect->x2 || rect->y1 >= rect->y2)
+    {
+        freeData(region);
+        region->extents = *rect;
+        region->extents.x2 = region->extents.x1;
+        region->extents.y2 = region->extents.y1;
+        region->data = &rtgui_region_emptydata;
+        return RTGUI_REGION_STATUS_SUCCESS;
+    }
+
+    if (region->data != RT_NULL && region->data->size)
+        region->data->numRects = 0;
+    else
+        region->data = &rtgui_region_emptydata;
+
+    prevBand = 0;
+    for (y = rect->y1; y < rect->y2; y = y2)
+    {
+        /* the band ends at the next edge of rects */
+        y2 = rect->y2;
+        for (index = 0; index < count; index ++)
+        {
+            r = &rects[index];
+            if (r->x1 >= r->x2 || r->x2 <= rect->x1 || r->x1 >= rect->x2)
+                continue;
+            if (r->y1 > y && r->y1 < y2) y2 = r->y1;
+            if (r->y2 > y && r->y2 < y2) y2 = r->y2;
+        }
+
+        curBand = region->data->numRects;
+        pNextRect = PIXREGION_TOP(region);
+        x = rect->x1;
+        while (x < rect->x2)
+        {
+            /* the rects in the band over x move it to their right */
+            do
+            {
+                moved = 0;
+                for (index = 0; index < count; index ++)
+                {
+                    r = &rects[index];
+                    if (r->y1 <= y && r->y2 > y && r->x1 <= x && r->x2 > x)
+                    {
+                        x = r->x2;
+                        moved = 1;
+                    }
+                }
+            }
+            while (moved && x < rect->x2);
+            if (x >= rect->x2)
+                break;
+
+            next = rect->x2;
+            for (index = 0; index < count; index ++)
+            {
+                r = &rects[index];
+                if (r->y1 <= y && r->y2 > y && r->x1 > x && r->x1 < next && r->x1 < r->x2)
+                    next = r->x1;
+            }
+
+            NEWRECT(region, pNextRect, x, y, next, y2);
+            x = next;
+        }
+        if (region->data->numRects > curBand)
+        {
+            Coalesce(region, prevBand, curBand);
+        }
+    }
+
+    numRects = region->data->numRects;
+    if (!numRects)
+    {
+        freeData(region);
+        region->extents = *rect;
+        region->extents.x2 = region->extents.x1;
+        region->extents.y2 = region->extents.y1;
+        region->data = &rtgui_region_emptydata;
+    }
+    else if (numRects == 1)
+    {
+        region->extents = *PIXREGION_BOXPTR(region);
+        freeData(region);
+        region->data = (rtgui_region_data_t *)RT_NULL;
+    }
+    else
+    {
+        rtgui_set_extents(region);
+    }
+    good(region);
+
+    return RTGUI_REGION_STATUS_SUCCESS;
+}
+RTM_EXPORT(rtgui_region_clip_rect_minus_rects);
+
 #define MERGERECT(r)            \
 {                               \
     if (r->x1 <= x2) {          \
@@ -1045,6 +1495,7 @@ rtgui_region_union(rtgui_region_t *newReg, rtgui_region_t *reg1, rtgui_region_t
     good(reg1);
     good(reg2);
     good(newReg);
+    REGION_STAT_CALL(RTGUI_REGION_OP_UNION, reg1, PIXREGION_NUM_RECTS(reg2));
     /*  checks all the simple cases */
 
     /*
@@ -1380,6 +1831,7 @@ rtgui_region_status_t rtgui_region_validate(rtgui_region_t *badreg,
     ri[0].prevBand = 0;
     ri[0].curBand = 0;
     ri[0].reg = *badreg;
+    _region_data_moved(&ri[0].reg, REGION_INLINE_DATA(badreg));
     box = PIXREGION_BOXPTR(&ri[0].reg);
     ri[0].reg.extents = *box;
     ri[0].reg.data->numRects = 1;
@@ -1436,9 +1888,17 @@ rtgui_region_status_t rtgui_region_validate(rtgui_region_t *badreg,
         {
             /* Oops, allocate space for new region information */
             sizeRI <<= 1;
-            rit = (RegionInfo *) rt_realloc(ri, sizeRI * sizeof(RegionInfo));
+            rit = (RegionInfo *) rtgui_realloc(ri, sizeRI * sizeof(RegionInfo));
             if (!rit)
                 goto bail;
+#if GUIENGINE_REGION_INLINE_RECTS > 0
+            /* the inline data moves with the region info */
+            for (j = 0; j < numRI; j++)
+            {
+                _region_data_moved(&rit[j].reg, (rtgui_region_data_t *)
+                                   ((rt_uint8_t *)ri + ((rt_uint8_t *)REGION_INLINE_DATA(&rit[j].reg) - (rt_uint8_t *)rit)));
+            }
+#endif
             ri = rit;
             rit = &ri[numRI];
         }
@@ -1493,6 +1953,7 @@ NextRect:
         numRI -= half;
     }
     *badreg = ri[0].reg;
+    _region_data_moved(badreg, REGION_INLINE_DATA(&ri[0].reg));
     rtgui_free(ri);
     good(badreg);
     return ret;
@@ -1659,6 +2120,7 @@ rtgui_region_subtract(rtgui_region_t *regD,
     good(regM);
     good(regS);
     good(regD);
+    REGION_STAT_CALL(RTGUI_REGION_OP_SUBTRACT, regM, PIXREGION_NUM_RECTS(regS));
     /* check for trivial rejects */
     if (PIXREGION_NIL(regM) || PIXREGION_NIL(regS) ||
             !EXTENTCHECK(&regM->extents, &regS->extents))
@@ -1737,6 +2199,7 @@ rtgui_region_inverse(rtgui_region_t *newReg,       /* Destination region */
 
     good(reg1);
     good(newReg);
+    REGION_STAT_CALL(RTGUI_REGION_OP_INVERSE, reg1, 1);
     /* check for trivial rejects */
     if (PIXREGION_NIL(reg1) || !EXTENTCHECK(invRect, &reg1->extents))
     {
@@ -1969,12 +2432,65 @@ void rtgui_region_reset(rtgui_region_t *region, rtgui_rect_t *rect)
 }
 RTM_EXPORT(rtgui_region_reset);
 
-/* box is "return" value */
+/*
+ * The rects are in the y-x bands: the band of y is bisected by the bottoms of
+ * rects, which are ascending, and then the first rect right of x in it. The
+ * end is the end of band, RT_NULL is returned if y is between the bands.
+ */
+static const rtgui_rect_t *_region_find_band(const rtgui_rect_t *pbox, int numRects, int x, int y,
+                                             const rtgui_rect_t **end)
+{
+    int low, high, mid, band;
+
+    low = 0;
+    high = numRects;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (pbox[mid].y2 <= y)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == numRects || y < pbox[low].y1)
+        return RT_NULL;
+
+    /* the end of band */
+    band = low;
+    high = numRects;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (pbox[mid].y1 == pbox[band].y1)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    *end = &pbox[low];
+
+    high = low;
+    low = band;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (pbox[mid].x2 <= x)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return &pbox[low];
+}
+
+/*
+ * Box is "return" value. The points drawn are coherent, so the rect of last
+ * point is tried before the band is searched.
+ */
 int rtgui_region_contains_point(rtgui_region_t *region,
                                 int x, int y,
                                 rtgui_rect_t *box)
 {
-    rtgui_rect_t *pbox, *pboxEnd;
+    const rtgui_rect_t *pbox, *prect, *end;
     int numRects;
 
     good(region);
@@ -1988,23 +2504,120 @@ int rtgui_region_contains_point(rtgui_region_t *region,
         return RT_EOK;
     }
 
-    for (pbox = PIXREGION_BOXPTR(region), pboxEnd = pbox + numRects;
-            pbox != pboxEnd;
-            pbox++)
+    pbox = PIXREGION_BOXPTR(region);
+    if (region->hint < (rt_uint32_t)numRects && INBOX(&pbox[region->hint], x, y))
     {
-        if (y >= pbox->y2)
-            continue;       /* not there yet */
-        if ((y < pbox->y1) || (x < pbox->x1))
-            break;      /* missed it */
-        if (x >= pbox->x2)
-            continue;       /* not there yet */
-        *box = *pbox;
+        *box = pbox[region->hint];
         return RT_EOK;
     }
 
-    return -RT_ERROR;
+    prect = _region_find_band(pbox, numRects, x, y, &end);
+    if (prect == RT_NULL || prect == end || x < prect->x1)
+        return -RT_ERROR;
+
+    region->hint = prect - pbox;
+    *box = *prect;
+    return RT_EOK;
 }
 
+/*
+ * Begin the spans of region in the row y, which are clipped to x1 - x2. The
+ * spans come from the band of y in the rects directly.
+ */
+void rtgui_region_span_begin(struct rtgui_region_span_iter *iter, rtgui_region_t *region,
+                             int y, int x1, int x2)
+{
+    int numRects;
+
+    good(region);
+    iter->x1 = x1;
+    iter->x2 = x2;
+    iter->rect = iter->end = RT_NULL;
+
+    numRects = PIXREGION_NUM_RECTS(region);
+    if (!numRects || x1 >= x2 ||
+            y < region->extents.y1 || y >= region->extents.y2)
+        return;
+
+    if (numRects == 1)
+    {
+        iter->rect = &region->extents;
+        iter->end = iter->rect + 1;
+        return;
+    }
+
+    iter->rect = _region_find_band(PIXREGION_BOXPTR(region), numRects, x1, y, &iter->end);
+    if (iter->rect == RT_NULL)
+        iter->end = RT_NULL;
+}
+RTM_EXPORT(rtgui_region_span_begin);
+
+/* the next span in x1 - x2 (not included), RT_FALSE if there is no more */
+rt_bool_t rtgui_region_span_next(struct rtgui_region_span_iter *iter, int *x1, int *x2)
+{
+    const rtgui_rect_t *prect;
+
+    prect = iter->rect;
+    if (prect == iter->end || prect->x1 >= iter->x2 || prect->x2 <= iter->x1)
+        return RT_FALSE;
+    iter->rect ++;
+
+    *x1 = prect->x1 > iter->x1 ? prect->x1 : iter->x1;
+    *x2 = prect->x2 < iter->x2 ? prect->x2 : iter->x2;
+
+    return RT_TRUE;
+}
+RTM_EXPORT(rtgui_region_span_next);
+
+/*
+ * The adjacent rects in a band are merged when the gap between them is in
+ * fill, then the bands of the same spans are coalesced by the union.
+ */
+int rtgui_region_simplify(rtgui_region_t *region, rtgui_region_t *fill, int waste)
+{
+    int index, numRects, merged;
+    rtgui_rect_t *pbox, rect, gap;
+    rtgui_region_t result;
+
+    good(region);
+    numRects = PIXREGION_NUM_RECTS(region);
+    if (numRects <= 1 || !rtgui_region_not_empty(fill))
+        return 0;
+
+    pbox = PIXREGION_BOXPTR(region);
+    merged = 0;
+    rtgui_region_init(&result);
+    rect = pbox[0];
+    for (index = 1; index <= numRects; index ++)
+    {
+        if (index < numRects && pbox[index].y1 == rect.y1)
+        {
+            gap.x1 = rect.x2;
+            gap.x2 = pbox[index].x1;
+            gap.y1 = rect.y1;
+            gap.y2 = rect.y2;
+            if ((gap.x2 - gap.x1) * (gap.y2 - gap.y1) <= waste &&
+                    rtgui_region_contains_rectangle(fill, &gap) == RTGUI_REGION_IN)
+            {
+                rect.x2 = pbox[index].x2;
+                merged ++;
+                continue;
+            }
+        }
+
+        rtgui_region_union_rect(&result, &result, &rect);
+        if (index < numRects)
+            rect = pbox[index];
+    }
+
+    if (merged > 0)
+        rtgui_region_copy(region, &result);
+    rtgui_region_fini(&result);
+
+    return merged;
+}
+RTM_EXPORT(rtgui_region_simplify);
+
 int rtgui_region_not_empty(rtgui_region_t *region)
 {
     good(region);
@@ -2019,6 +2632,7 @@ void rtgui_region_empty(rtgui_region_t *region)
 
     region->extents = rtgui_empty_rect;
     region->data = &rtgui_region_emptydata;
+    region->hint = 0;
 }
 
 rtgui_rect_t *rtgui_region_extents(rtgui_region_t *region)
@@ -2100,6 +2714,21 @@ int rtgui_region_is_flat(rtgui_region_t *region)
 }
 RTM_EXPORT(rtgui_region_is_flat);
 
+int rtgui_region_is_equal(rtgui_region_t *reg1, rtgui_region_t *reg2)
+{
+    int num;
+
+    num = PIXREGION_NUM_RECTS(reg1);
+    if (num != PIXREGION_NUM_RECTS(reg2)) return -RT_ERROR;
+    if (rtgui_rect_is_equal(&reg1->extents, &reg2->extents) != RT_EOK) return -RT_ERROR;
+    if (num > 1 &&
+            rt_memcmp(PIXREGION_RECTS(reg1), PIXREGION_RECTS(reg2), num * sizeof(rtgui_rect_t)) != 0)
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_region_is_equal);
+
 void rtgui_rect_move(rtgui_rect_t *rect, int x, int y)
 {
     rect->x1 += x;
@@ -28,6 +28,9 @@
 
 #include <rtgui/rtgui_system.h>
 #include <rtgui/rtgui_app.h>
+#include <rtgui/image.h>
+#include <rtgui/frame.h>
+#include <rtgui/trace.h>
 #include <rtgui/widgets/window.h>
 #include <topwin.h>
 
@@ -44,11 +47,44 @@ static void _rtgui_app_constructor(struct rtgui_app *app)
     app->ref_count      = 0;
     app->window_cnt     = 0;
     app->win_acti_cnt   = 0;
+    app->motion_seq     = 0;
+    app->paint_cnt      = 0;
+    app->timer_cnt      = 0;
+    app->timer_first    = 0;
+    app->timer_pending  = 0;
+    app->timer_watchdog = 1;
+    rt_list_init(&app->timer_list);
+    app->frame_tick     = 0;
+    app->frame_serial   = 0;
+    app->frame_requested = 0;
+    rt_list_init(&app->frame_list);
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    rt_list_init(&app->cache_list);
+#endif
     app->exit_code      = 0;
     app->tid            = RT_NULL;
     app->mq             = RT_NULL;
+    app->mq_depth       = 0;
+    app->mq_peak        = 0;
+    app->mq_drops       = 0;
+    app->event_size     = 0;
+    app->event_buffer   = RT_NULL;
+    rt_list_init(&app->app_node);
+#ifdef GUIENGINE_USING_EVENT_RING
+    app->ring           = RT_NULL;
+    app->ring_head      = 0;
+    app->ring_tail      = 0;
+#endif
     app->main_object    = RT_NULL;
     app->on_idle        = RT_NULL;
+    app->idle_period    = 0;
+    app->idle_tick      = 0;
+#ifdef GUIENGINE_USING_LATENCY
+    app->input_stamp    = 0;
+#endif
+#ifdef GUIENGINE_USING_ID_HASH
+    rt_memset(app->id_hash, 0, sizeof(app->id_hash));
+#endif
 }
 
 static void _rtgui_app_destructor(struct rtgui_app *app)
@@ -57,6 +93,9 @@ static void _rtgui_app_destructor(struct rtgui_app *app)
 
     rt_free(app->name);
     app->name = RT_NULL;
+#ifdef GUIENGINE_USING_ID_HASH
+    rtgui_object_id_hash_fini(app);
+#endif
 }
 
 DEFINE_CLASS_TYPE(application, "application",
@@ -65,7 +104,162 @@ DEFINE_CLASS_TYPE(application, "application",
                   _rtgui_app_destructor,
                   sizeof(struct rtgui_app));
 
+/* the apps created, listed by list_guiapp */
+static rt_list_t _rtgui_app_list = RT_LIST_OBJECT_INIT(_rtgui_app_list);
+
+static void _rtgui_app_list_insert(struct rtgui_app *app)
+{
+    rt_enter_critical();
+    rt_list_insert_before(&_rtgui_app_list, &app->app_node);
+    rt_exit_critical();
+}
+
+/*
+ * The runtime of app: the message queue, the event buffer and the ring. With
+ * GUIENGINE_USING_APP_POOL, the runtimes of the default size are kept in the
+ * pool when the apps are destroyed, and taken by the next app created.
+ */
+/* drop the events left in mq, with their payloads released */
+static void _rtgui_app_runtime_drain(struct rtgui_app *app)
+{
+    struct rtgui_event *event = (struct rtgui_event *)app->event_buffer;
+
+    if (app->mq == RT_NULL || event == RT_NULL)
+        return;
+
+    while (rt_mq_recv(app->mq, event, app->event_size, 0) == RT_EOK)
+        rtgui_event_payload_unref(rtgui_event_get_payload(event));
+}
+
+static void _rtgui_app_runtime_delete(struct rtgui_app *app)
+{
+    _rtgui_app_runtime_drain(app);
+    if (app->mq != RT_NULL)
+        rt_mq_delete(app->mq);
+    app->mq = RT_NULL;
+    rtgui_free(app->event_buffer);
+    app->event_buffer = RT_NULL;
+#ifdef GUIENGINE_USING_EVENT_RING
+    rtgui_free(app->ring);
+    app->ring = RT_NULL;
+#endif
+}
+
+#ifdef GUIENGINE_USING_APP_POOL
+struct _app_runtime
+{
+    rt_mq_t mq;
+    rt_uint8_t *event_buffer;
+#ifdef GUIENGINE_USING_EVENT_RING
+    rt_uint8_t *ring;
+#endif
+};
+static struct _app_runtime _app_runtime_pool[GUIENGINE_APP_POOL_SIZE];
+static int _app_runtime_cnt = 0;
+
+#define _APP_RUNTIME_POOLED(app) ((app)->mq_depth == GUIENGINE_APP_MQ_DEPTH && \
+        (app)->event_size == sizeof(union rtgui_event_generic))
+
+static rt_bool_t _rtgui_app_runtime_take(struct rtgui_app *app)
+{
+    struct _app_runtime *runtime = RT_NULL;
+
+    if (!_APP_RUNTIME_POOLED(app))
+        return RT_FALSE;
+
+    rt_enter_critical();
+    if (_app_runtime_cnt > 0)
+        runtime = &_app_runtime_pool[-- _app_runtime_cnt];
+    rt_exit_critical();
+    if (runtime == RT_NULL)
+        return RT_FALSE;
+
+    app->mq = runtime->mq;
+    app->event_buffer = runtime->event_buffer;
+#ifdef GUIENGINE_USING_EVENT_RING
+    app->ring = runtime->ring;
+#endif
+    return RT_TRUE;
+}
+
+static rt_bool_t _rtgui_app_runtime_put(struct rtgui_app *app)
+{
+    struct _app_runtime *runtime = RT_NULL;
+
+    if (!_APP_RUNTIME_POOLED(app) || app->mq == RT_NULL || app->event_buffer == RT_NULL)
+        return RT_FALSE;
+#ifdef GUIENGINE_USING_EVENT_RING
+    if (app->ring == RT_NULL)
+        return RT_FALSE;
+#endif
+
+    /* the events left are dropped, the next app starts from an empty mq */
+    _rtgui_app_runtime_drain(app);
+
+    rt_enter_critical();
+    if (_app_runtime_cnt < GUIENGINE_APP_POOL_SIZE)
+        runtime = &_app_runtime_pool[_app_runtime_cnt ++];
+    rt_exit_critical();
+    if (runtime == RT_NULL)
+        return RT_FALSE;
+
+    runtime->mq = app->mq;
+    runtime->event_buffer = app->event_buffer;
+#ifdef GUIENGINE_USING_EVENT_RING
+    runtime->ring = app->ring;
+    app->ring = RT_NULL;
+#endif
+    app->mq = RT_NULL;
+    app->event_buffer = RT_NULL;
+    return RT_TRUE;
+}
+#endif
+
+static rt_err_t _rtgui_app_runtime_create(struct rtgui_app *app, const char *name)
+{
+#ifdef GUIENGINE_USING_APP_POOL
+    if (_rtgui_app_runtime_take(app) == RT_TRUE)
+        return RT_EOK;
+#endif
+
+    app->event_buffer = (rt_uint8_t *)rtgui_malloc(app->event_size);
+    if (app->event_buffer == RT_NULL)
+        goto __err;
+#ifdef GUIENGINE_USING_EVENT_RING
+    app->ring = (rt_uint8_t *)rtgui_malloc(GUIENGINE_EVENT_RING_SIZE);
+    if (app->ring == RT_NULL)
+        goto __err;
+#endif
+    app->mq = rt_mq_create(name, app->event_size, app->mq_depth, RT_IPC_FLAG_FIFO);
+    if (app->mq == RT_NULL)
+    {
+        rt_kprintf("create msgq failed.\n");
+        goto __err;
+    }
+
+    return RT_EOK;
+
+__err:
+    _rtgui_app_runtime_delete(app);
+    return -RT_ENOMEM;
+}
+
+static void _rtgui_app_runtime_destroy(struct rtgui_app *app)
+{
+#ifdef GUIENGINE_USING_APP_POOL
+    if (_rtgui_app_runtime_put(app) == RT_TRUE)
+        return;
+#endif
+    _rtgui_app_runtime_delete(app);
+}
+
 struct rtgui_app *rtgui_app_create(const char *title)
+{
+    return rtgui_app_create_ex(title, GUIENGINE_APP_MQ_DEPTH, 0);
+}
+RTM_EXPORT(rtgui_app_create);
+
+struct rtgui_app *rtgui_app_create_ex(const char *title, rt_uint16_t mq_depth, rt_uint16_t event_size)
 {
     rt_thread_t tid = rt_thread_self();
     struct rtgui_app *app;
@@ -85,15 +279,25 @@ struct rtgui_app *rtgui_app_create(const char *title)
     RT_ASSERT(tid->user_data == 0);
     app->tid = tid;
 
+    /* the paints and timers are deferred in the lanes of event size */
+    if (event_size == 0 || event_size > sizeof(union rtgui_event_generic))
+        event_size = sizeof(union rtgui_event_generic);
+    if (event_size < sizeof(struct rtgui_event_paint))
+        event_size = sizeof(struct rtgui_event_paint);
+    if (event_size < sizeof(struct rtgui_event_timer))
+        event_size = sizeof(struct rtgui_event_timer);
+    app->event_size = event_size;
+    app->mq_depth = mq_depth;
+
     rt_snprintf(mq_name, RT_NAME_MAX, "g%s", title);
-    app->mq = rt_mq_create(mq_name,
-                           sizeof(union rtgui_event_generic), 256,
-                           RT_IPC_FLAG_FIFO);
-    if (app->mq == RT_NULL)
-    {
-        rt_kprintf("create msgq failed.\n");
+    if (_rtgui_app_runtime_create(app, mq_name) != RT_EOK)
         goto __mq_err;
-    }
+
+    rt_mb_init(&app->ack_mb, mq_name, &app->ack_buffer, 1, RT_IPC_FLAG_FIFO);
+    rtgui_timer_app_init(app, mq_name);
+#ifdef GUIENGINE_USING_EVENT_RING
+    rt_sem_init(&app->ring_sem, mq_name, 0, RT_IPC_FLAG_FIFO);
+#endif
 
     /* set application title */
     app->name = (unsigned char *)rt_strdup((char *)title);
@@ -106,6 +310,7 @@ struct rtgui_app *rtgui_app_create(const char *title)
     {
         /* set user thread */
         tid->user_data = (rt_uint32_t)app;
+        _rtgui_app_list_insert(app);
         return app;
     }
 
@@ -117,15 +322,22 @@ struct rtgui_app *rtgui_app_create(const char *title)
     {
         /* set user thread */
         tid->user_data = (rt_uint32_t)app;
+        _rtgui_app_list_insert(app);
         return app;
     }
 
 __err:
+    rt_mb_detach(&app->ack_mb);
+    rt_timer_detach(&app->timer);
+#ifdef GUIENGINE_USING_EVENT_RING
+    rt_sem_detach(&app->ring_sem);
+#endif
+    _rtgui_app_runtime_destroy(app);
 __mq_err:
     rtgui_object_destroy(RTGUI_OBJECT(app));
     return RT_NULL;
 }
-RTM_EXPORT(rtgui_app_create);
+RTM_EXPORT(rtgui_app_create_ex);
 
 #define _rtgui_application_check(app)           \
     do {                                        \
@@ -163,11 +375,130 @@ void rtgui_app_destroy(struct rtgui_app *app)
     }
 
     app->tid->user_data = 0;
-    rt_mq_delete(app->mq);
+    rt_enter_critical();
+    rt_list_remove(&app->app_node);
+    rt_exit_critical();
+    rt_mb_detach(&app->ack_mb);
+    rt_timer_detach(&app->timer);
+#ifdef GUIENGINE_USING_EVENT_RING
+    rt_sem_detach(&app->ring_sem);
+#endif
+    _rtgui_app_runtime_destroy(app);
     rtgui_object_destroy(RTGUI_OBJECT(app));
 }
 RTM_EXPORT(rtgui_app_destroy);
 
+#ifdef GUIENGINE_USING_APP_POOL
+/* the threads of pool, each waits its semaphore for the entry to run */
+struct _app_worker
+{
+    rt_thread_t tid;
+    struct rt_semaphore sem;
+    void (*entry)(void *parameter);
+    void *parameter;
+};
+static struct _app_worker _app_workers[GUIENGINE_APP_POOL_SIZE];
+
+static void _rtgui_app_worker_entry(void *parameter)
+{
+    struct _app_worker *worker = (struct _app_worker *)parameter;
+
+    while (1)
+    {
+        rt_sem_take(&worker->sem, RT_WAITING_FOREVER);
+        worker->entry(worker->parameter);
+        /* the app must be destroyed before the entry returns */
+        RT_ASSERT(worker->tid->user_data == 0);
+
+        rt_enter_critical();
+        worker->entry = RT_NULL;
+        rt_exit_critical();
+    }
+}
+
+void rtgui_app_pool_init(void)
+{
+    int index;
+    char name[RT_NAME_MAX];
+    struct _app_runtime *runtime;
+
+    for (index = 0; index < GUIENGINE_APP_POOL_SIZE; index ++)
+    {
+        struct _app_worker *worker = &_app_workers[index];
+
+        rt_snprintf(name, sizeof(name), "gapp%d", index);
+        rt_sem_init(&worker->sem, name, 0, RT_IPC_FLAG_FIFO);
+        worker->entry = RT_NULL;
+        worker->tid = rt_thread_create(name, _rtgui_app_worker_entry, worker,
+                                       GUIENGIN_APP_THREAD_STACK_SIZE,
+                                       GUIENGIN_APP_THREAD_PRIORITY,
+                                       GUIENGIN_APP_THREAD_TIMESLICE);
+        if (worker->tid != RT_NULL)
+            rt_thread_startup(worker->tid);
+
+        /* the runtimes of default size, ready for the first apps */
+        runtime = &_app_runtime_pool[_app_runtime_cnt];
+        runtime->event_buffer = (rt_uint8_t *)rtgui_malloc(sizeof(union rtgui_event_generic));
+        runtime->mq = rt_mq_create(name, sizeof(union rtgui_event_generic),
+                                   GUIENGINE_APP_MQ_DEPTH, RT_IPC_FLAG_FIFO);
+#ifdef GUIENGINE_USING_EVENT_RING
+        runtime->ring = (rt_uint8_t *)rtgui_malloc(GUIENGINE_EVENT_RING_SIZE);
+        if (runtime->ring != RT_NULL)
+#endif
+        if (runtime->mq != RT_NULL && runtime->event_buffer != RT_NULL)
+        {
+            _app_runtime_cnt ++;
+            continue;
+        }
+
+        if (runtime->mq != RT_NULL)
+            rt_mq_delete(runtime->mq);
+        rtgui_free(runtime->event_buffer);
+#ifdef GUIENGINE_USING_EVENT_RING
+        rtgui_free(runtime->ring);
+#endif
+    }
+}
+#endif
+
+rt_err_t rtgui_app_launch(const char *name, void (*entry)(void *parameter), void *parameter)
+{
+    rt_thread_t tid;
+#ifdef GUIENGINE_USING_APP_POOL
+    int index;
+    struct _app_worker *worker = RT_NULL;
+
+    rt_enter_critical();
+    for (index = 0; index < GUIENGINE_APP_POOL_SIZE; index ++)
+    {
+        if (_app_workers[index].tid != RT_NULL && _app_workers[index].entry == RT_NULL)
+        {
+            worker = &_app_workers[index];
+            worker->entry = entry;
+            worker->parameter = parameter;
+            break;
+        }
+    }
+    rt_exit_critical();
+
+    if (worker != RT_NULL)
+    {
+        rt_sem_release(&worker->sem);
+        return RT_EOK;
+    }
+#endif
+
+    tid = rt_thread_create(name, entry, parameter,
+                           GUIENGIN_APP_THREAD_STACK_SIZE,
+                           GUIENGIN_APP_THREAD_PRIORITY,
+                           GUIENGIN_APP_THREAD_TIMESLICE);
+    if (tid == RT_NULL)
+        return -RT_ENOMEM;
+
+    return rt_thread_startup(tid);
+}
+RTM_EXPORT(rtgui_app_launch);
+
 struct rtgui_app *rtgui_app_self(void)
 {
     struct rtgui_app *app;
@@ -195,6 +526,39 @@ rtgui_idle_func_t rtgui_app_get_onidle(struct rtgui_app *app)
 }
 RTM_EXPORT(rtgui_app_get_onidle);
 
+void rtgui_app_set_idle_period(struct rtgui_app *app, int millisecond)
+{
+    _rtgui_application_check(app);
+
+    app->idle_period = millisecond > 0 ? rt_tick_from_millisecond(millisecond) : 0;
+    app->idle_tick = rt_tick_get();
+    app->state_flag &= ~RTGUI_APP_FLAG_IDLE_DONE;
+}
+RTM_EXPORT(rtgui_app_set_idle_period);
+
+void rtgui_app_idle_done(struct rtgui_app *app)
+{
+    _rtgui_application_check(app);
+
+    app->state_flag |= RTGUI_APP_FLAG_IDLE_DONE;
+}
+RTM_EXPORT(rtgui_app_idle_done);
+
+/* the policy of frames, read by the frame governor of server */
+static volatile enum rtgui_frame_policy _app_frame_policy = RTGUI_FRAME_POLICY_NORMAL;
+
+void rtgui_app_set_frame_policy(enum rtgui_frame_policy policy)
+{
+    _app_frame_policy = policy;
+}
+RTM_EXPORT(rtgui_app_set_frame_policy);
+
+enum rtgui_frame_policy rtgui_app_get_frame_policy(void)
+{
+    return _app_frame_policy;
+}
+RTM_EXPORT(rtgui_app_get_frame_policy);
+
 rt_inline rt_bool_t _rtgui_application_dest_handle(
     struct rtgui_app *app,
     struct rtgui_event *event)
@@ -320,27 +684,19 @@ rt_bool_t rtgui_app_event_handler(struct rtgui_object *object, rtgui_event_t *ev
         break;
 
     case RTGUI_EVENT_TIMER:
+        rtgui_timer_expire(app);
+        break;
+
+    case RTGUI_EVENT_FRAME:
+        rtgui_frame_dispatch(app, (struct rtgui_event_frame *)event);
+        break;
+
+    case RTGUI_EVENT_IMAGE_LOADED:
     {
-        rt_base_t level;
-        struct rtgui_timer *timer;
-        struct rtgui_event_timer *etimer = (struct rtgui_event_timer *) event;
-
-        timer = etimer->timer;
-        level = rt_hw_interrupt_disable();
-        timer->pending_cnt--;
-        rt_hw_interrupt_enable(level);
-        RT_ASSERT(timer->pending_cnt >= 0);
-        if (timer->state == RTGUI_TIMER_ST_DESTROY_PENDING)
-        {
-            /* Truly destroy the timer when there is no pending event. */
-            if (timer->pending_cnt == 0)
-                rtgui_timer_destory(timer);
-        }
-        else if (timer->state == RTGUI_TIMER_ST_RUNNING && timer->timeout != RT_NULL)
-        {
-            /* call timeout function */
-            timer->timeout(timer, timer->user_data);
-        }
+        struct rtgui_event_image_loaded *eimage = (struct rtgui_event_image_loaded *)event;
+
+        /* invoke the done callback of request */
+        rtgui_image_request_complete(eimage->request);
     }
     break;
 
@@ -381,6 +737,81 @@ rt_bool_t rtgui_app_event_handler(struct rtgui_object *object, rtgui_event_t *ev
 }
 RTM_EXPORT(rtgui_app_event_handler);
 
+/* the payload is released after the event is handled, the event buffer may be
+ * overwritten by the nested event loop in handler */
+rt_inline void _rtgui_application_dispatch(struct rtgui_app *app, struct rtgui_event *event)
+{
+    void *payload;
+#ifdef GUIENGINE_USING_LATENCY
+    rt_uint32_t stamp = app->input_stamp;
+
+    /* the drawings in handler are for the input */
+    if (event->stamp != 0)
+        app->input_stamp = event->stamp;
+#endif
+
+    payload = rtgui_event_get_payload(event);
+    RTGUI_TRACE_BEGIN("dispatch", event->type);
+    RTGUI_OBJECT(app)->event_handler(RTGUI_OBJECT(app), event);
+    RTGUI_TRACE_END("dispatch");
+    rtgui_event_payload_unref(payload);
+
+#ifdef GUIENGINE_USING_LATENCY
+    app->input_stamp = stamp;
+#endif
+}
+
+/* receive an event, the idle handler is invoked if there is none. Returns
+ * -RT_ETIMEOUT if no event is received in the timeout. */
+static rt_err_t _rtgui_application_recv(struct rtgui_app *app, struct rtgui_event *event,
+                                        rt_int32_t timeout)
+{
+    rt_err_t result;
+    rt_tick_t tick;
+    rt_int32_t wait;
+
+    if (app->on_idle == RT_NULL)
+        return rtgui_recv(event, app->event_size, timeout);
+
+    result = rtgui_recv(event, app->event_size, 0);
+    if (result == RT_EOK)
+    {
+        /* the event may bring new work to the idle handler */
+        app->state_flag &= ~RTGUI_APP_FLAG_IDLE_DONE;
+        return result;
+    }
+    else if (result != -RT_ETIMEOUT)
+        return result;
+
+    if (app->idle_period == 0)
+    {
+        app->on_idle(RTGUI_OBJECT(app), RT_NULL);
+        return result;
+    }
+
+    /* run a slice of idle, or block until the next one */
+    wait = RT_WAITING_FOREVER;
+    if (!(app->state_flag & RTGUI_APP_FLAG_IDLE_DONE))
+    {
+        tick = rt_tick_get();
+        if ((rt_int32_t)(tick - app->idle_tick) >= 0)
+        {
+            app->idle_tick = tick + app->idle_period;
+            app->on_idle(RTGUI_OBJECT(app), RT_NULL);
+            return -RT_ETIMEOUT;
+        }
+        wait = app->idle_tick - tick;
+    }
+    if (timeout != RT_WAITING_FOREVER && (wait == RT_WAITING_FOREVER || timeout < wait))
+        wait = timeout;
+
+    result = rtgui_recv(event, app->event_size, wait);
+    if (result == RT_EOK)
+        app->state_flag &= ~RTGUI_APP_FLAG_IDLE_DONE;
+
+    return result;
+}
+
 rt_inline void _rtgui_application_event_loop(struct rtgui_app *app)
 {
     rt_err_t result;
@@ -397,20 +828,9 @@ rt_inline void _rtgui_application_event_loop(struct rtgui_app *app)
     {
         RT_ASSERT(current_ref == app->ref_count);
 
-        if (app->on_idle != RT_NULL)
-        {
-            result = rtgui_recv(event, sizeof(union rtgui_event_generic), 0);
-            if (result == RT_EOK)
-                RTGUI_OBJECT(app)->event_handler(RTGUI_OBJECT(app), event);
-            else if (result == -RT_ETIMEOUT)
-                app->on_idle(RTGUI_OBJECT(app), RT_NULL);
-        }
-        else
-        {
-            result = rtgui_recv(event, sizeof(union rtgui_event_generic), RT_WAITING_FOREVER);
-            if (result == RT_EOK)
-                RTGUI_OBJECT(app)->event_handler(RTGUI_OBJECT(app), event);
-        }
+        result = _rtgui_application_recv(app, event, RT_WAITING_FOREVER);
+        if (result == RT_EOK)
+            _rtgui_application_dispatch(app, event);
     }
 }
 
@@ -473,20 +893,9 @@ void rtgui_app_sleep(struct rtgui_app *app, int millisecond)
     {
         RT_ASSERT(current_ref == app->ref_count);
 
-        if (app->on_idle != RT_NULL)
-        {
-            result = rtgui_recv(event, sizeof(union rtgui_event_generic), 0);
-            if (result == RT_EOK)
-                RTGUI_OBJECT(app)->event_handler(RTGUI_OBJECT(app), event);
-            else if (result == -RT_ETIMEOUT)
-                app->on_idle(RTGUI_OBJECT(app), RT_NULL);
-        }
-        else
-        {
-            result = rtgui_recv(event, sizeof(union rtgui_event_generic), sleep_tick - rt_tick_get());
-            if (result == RT_EOK)
-                RTGUI_OBJECT(app)->event_handler(RTGUI_OBJECT(app), event);
-        }
+        result = _rtgui_application_recv(app, event, sleep_tick - rt_tick_get());
+        if (result == RT_EOK)
+            _rtgui_application_dispatch(app, event);
 
         delta_tick = sleep_tick - rt_tick_get();
     }
@@ -557,3 +966,26 @@ unsigned int rtgui_app_get_win_acti_cnt(void)
 }
 RTM_EXPORT(rtgui_app_get_win_acti_cnt);
 
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+static int list_guiapp(void)
+{
+    rt_list_t *node;
+    struct rtgui_app *app;
+
+    rt_kprintf("%-*.*s depth  peak   drops  event  mq bytes\n", RT_NAME_MAX, RT_NAME_MAX, "app");
+    rt_enter_critical();
+    rt_list_for_each(node, &_rtgui_app_list)
+    {
+        app = rt_list_entry(node, struct rtgui_app, app_node);
+        /* each message is in a header of pointer */
+        rt_kprintf("%-*.*s %5d %5d %7d %6d %9d\n", RT_NAME_MAX, RT_NAME_MAX, app->name,
+                   app->mq_depth, app->mq_peak, app->mq_drops, app->event_size,
+                   app->mq_depth * (RT_ALIGN(app->event_size, RT_ALIGN_SIZE) + sizeof(void *)));
+    }
+    rt_exit_critical();
+
+    return 0;
+}
+MSH_CMD_EXPORT(list_guiapp, list the message queue of apps);
+#endif
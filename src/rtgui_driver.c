@@ -22,24 +22,41 @@
  * 2009-10-04     Bernard      first version
  */
 #include <rtthread.h>
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+#include <rthw.h>
+#endif
 #include <rtgui/driver.h>
 #include <rtgui/region.h>
 #include <rtgui/rtgui_system.h>
+#include <rtgui/blit.h>
+#include <rtgui/trace.h>
+#include <rtgui/profile.h>
+#include <rtgui/snapshot.h>
 #include <string.h>
 
 extern const struct rtgui_graphic_driver_ops *rtgui_pixel_device_get_ops(int pixel_format);
 extern const struct rtgui_graphic_driver_ops *rtgui_framebuffer_get_ops(int pixel_format);
+#ifdef GUIENGINE_USING_PIXEL_WC
+static const struct rtgui_graphic_driver_ops *_pixel_wc_get_ops(const struct rtgui_graphic_pixel_ops *device_ops,
+                                                                int pixel_format);
+#endif
 
 static struct rtgui_graphic_driver _driver;
 static struct rtgui_graphic_driver *_current_driver = &_driver;
-
-#ifdef GUIENGIN_USING_VFRAMEBUFFER
-#ifndef RTGUI_VFB_PIXEL_FMT
-#define RTGUI_VFB_PIXEL_FMT     RTGRAPHIC_PIXEL_FORMAT_RGB565
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+#ifdef GUIENGINE_USING_COMPOSITOR
+#error "the layers are composited to the main display only"
+#endif
+/* the displays after the main one */
+static struct rtgui_graphic_driver _displays[RTGUI_DISPLAY_NUM - 1];
+static rt_err_t _graphic_driver_set_device(struct rtgui_graphic_driver *driver, rt_device_t device);
 #endif
 
+#ifdef GUIENGIN_USING_VFRAMEBUFFER
 #include <rtgui/dc.h>
 static struct rtgui_graphic_driver _vfb_driver = {0};
+/* the virtual mode drawing to a buffer DC */
+static struct rtgui_graphic_driver _vbuf_driver = {0};
 static void _graphic_driver_vmode_init(void)
 {
     if (_vfb_driver.width != _driver.width || _vfb_driver.height != _driver.height)
@@ -55,6 +72,7 @@ static void _graphic_driver_vmode_init(void)
         _vfb_driver.framebuffer = rtgui_malloc(_vfb_driver.height * _vfb_driver.pitch);
         rt_memset(_vfb_driver.framebuffer, 0, _vfb_driver.height * _vfb_driver.pitch);
         _vfb_driver.ext_ops = RT_NULL;
+        _vfb_driver.overlay_ops = RT_NULL;
         _vfb_driver.ops = rtgui_framebuffer_get_ops(_vfb_driver.pixel_format);
     }
 }
@@ -62,6 +80,8 @@ static void _graphic_driver_vmode_init(void)
 void rtgui_graphic_driver_vmode_enter(void)
 {
     rtgui_screen_lock(RT_WAITING_FOREVER);
+    /* the virtual framebuffer is allocated in the first use */
+    _graphic_driver_vmode_init();
     _current_driver = &_vfb_driver;
 }
 RTM_EXPORT(rtgui_graphic_driver_vmode_enter);
@@ -73,9 +93,51 @@ void rtgui_graphic_driver_vmode_exit(void)
 }
 RTM_EXPORT(rtgui_graphic_driver_vmode_exit);
 
+/*
+ * Enter the virtual mode drawing to the buffer DC, which is the pixels of rect
+ * on screen. The rect is not larger than the buffer. The buffer addresses the
+ * pixels in the coordinate of screen as the layer, so nothing out of rect
+ * should be drawn in it.
+ */
+rt_err_t rtgui_graphic_driver_vmode_enter_buffer(struct rtgui_dc *dc, struct rtgui_rect *rect)
+{
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)dc;
+
+    if (buffer == RT_NULL || buffer->parent.type != RTGUI_DC_BUFFER ||
+            buffer->width < rtgui_rect_width(*rect) || buffer->height < rtgui_rect_height(*rect))
+        return -RT_EINVAL;
+    /* the pixels are drawn as framebuffer, they should not be shared */
+    if (rtgui_dc_buffer_get_pixel(dc) == RT_NULL)
+        return -RT_ENOMEM;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    _vbuf_driver.ops = rtgui_framebuffer_get_ops(buffer->pixel_format);
+    if (_vbuf_driver.ops == RT_NULL)
+    {
+        rtgui_screen_unlock();
+        return -RT_ENOSYS;
+    }
+
+    _vbuf_driver.device = RT_NULL;
+    _vbuf_driver.pixel_format = buffer->pixel_format;
+    _vbuf_driver.bits_per_pixel = rtgui_color_get_bits(buffer->pixel_format);
+    _vbuf_driver.width  = _driver.width;
+    _vbuf_driver.height = _driver.height;
+    _vbuf_driver.pitch  = buffer->pitch;
+    _vbuf_driver.framebuffer = buffer->pixel
+                               - rect->y1 * buffer->pitch
+                               - rect->x1 * _UI_BITBYTES(_vbuf_driver.bits_per_pixel);
+    _vbuf_driver.ext_ops = RT_NULL;
+    _vbuf_driver.overlay_ops = RT_NULL;
+    _current_driver = &_vbuf_driver;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_graphic_driver_vmode_enter_buffer);
+
 rt_bool_t rtgui_graphic_driver_is_vmode(void)
 {
-    if (_current_driver == &_vfb_driver)
+    if (_current_driver == &_vfb_driver || _current_driver == &_vbuf_driver)
         return RT_TRUE;
 
     return RT_FALSE;
@@ -110,6 +172,8 @@ rtgui_graphic_driver_get_rect_buffer(const struct rtgui_graphic_driver *driver,
     if (!(w && h) || driver->framebuffer == RT_NULL)
         return RT_NULL;
 
+    rtgui_graphic_driver_accel_sync();
+
     /* create buffer DC */
     buffer = (struct rtgui_dc_buffer*)rtgui_dc_buffer_create_pixformat(driver->pixel_format, w, h);
     if (buffer == RT_NULL)
@@ -141,6 +205,22 @@ rt_bool_t rtgui_graphic_driver_is_vmode(void)
 RTM_EXPORT(rtgui_graphic_driver_is_vmode);
 #endif
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+void rtgui_graphic_driver_layer_enter(struct rtgui_layer *layer)
+{
+    layer->prev = _current_driver;
+    _current_driver = &layer->driver;
+}
+RTM_EXPORT(rtgui_graphic_driver_layer_enter);
+
+void rtgui_graphic_driver_layer_exit(struct rtgui_layer *layer)
+{
+    if (_current_driver == &layer->driver)
+        _current_driver = layer->prev;
+}
+RTM_EXPORT(rtgui_graphic_driver_layer_exit);
+#endif
+
 /* get default driver */
 struct rtgui_graphic_driver *rtgui_graphic_driver_get_default(void)
 {
@@ -148,6 +228,59 @@ struct rtgui_graphic_driver *rtgui_graphic_driver_get_default(void)
 }
 RTM_EXPORT(rtgui_graphic_driver_get_default);
 
+/* the driver of display, the display 0 is the default. RT_NULL if it's not set */
+struct rtgui_graphic_driver *rtgui_graphic_driver_get_display(int display)
+{
+    if (display == 0)
+        return _current_driver;
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    if (display > 0 && display < RTGUI_DISPLAY_NUM && _displays[display - 1].device != RT_NULL)
+        return &_displays[display - 1];
+#endif
+
+    return RT_NULL;
+}
+RTM_EXPORT(rtgui_graphic_driver_get_display);
+
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+/* set the device of display, the display 0 is rtgui_graphic_set_device */
+rt_err_t rtgui_graphic_set_display(int display, rt_device_t device)
+{
+    rt_err_t result;
+
+    if (display == 0)
+        return rtgui_graphic_set_device(device);
+    if (display < 0 || display >= RTGUI_DISPLAY_NUM)
+        return -RT_EINVAL;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    result = _graphic_driver_set_device(&_displays[display - 1], device);
+    rtgui_screen_unlock();
+
+    return result;
+}
+RTM_EXPORT(rtgui_graphic_set_display);
+
+/*
+ * Draw to the display, all the drawing is on its driver until the exit. The
+ * screen lock should be held in it, and it's not in the virtual mode.
+ */
+void rtgui_graphic_driver_display_enter(int display)
+{
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_display(display);
+
+    if (display != 0 && driver != RT_NULL)
+        _current_driver = driver;
+}
+RTM_EXPORT(rtgui_graphic_driver_display_enter);
+
+void rtgui_graphic_driver_display_exit(void)
+{
+    _current_driver = &_driver;
+}
+RTM_EXPORT(rtgui_graphic_driver_display_exit);
+#endif
+
 void rtgui_graphic_driver_get_rect(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
 {
     RT_ASSERT(rect != RT_NULL);
@@ -162,105 +295,973 @@ void rtgui_graphic_driver_get_rect(const struct rtgui_graphic_driver *driver, rt
 }
 RTM_EXPORT(rtgui_graphic_driver_get_rect);
 
-rt_err_t rtgui_graphic_set_device(rt_device_t device)
+/* the capabilities in the operations of device, limited by the ones it reports */
+static void _graphic_driver_negotiate(struct rtgui_graphic_driver *driver)
+{
+    rt_uint32_t flags = 0;
+    const struct rtgui_graphic_ext_ops *ext_ops = driver->ext_ops;
+
+    if (driver->framebuffer != RT_NULL)
+        flags |= RTGUI_CAP_FRAMEBUFFER;
+    /* the accelerator writes the framebuffer */
+    if (driver->framebuffer != RT_NULL && ext_ops != RT_NULL && ext_ops->accel_sync != RT_NULL)
+    {
+        if (ext_ops->accel_fill != RT_NULL)
+            flags |= RTGUI_CAP_ACCEL_FILL;
+        if (ext_ops->accel_blit != RT_NULL)
+            flags |= RTGUI_CAP_ACCEL_BLIT;
+    }
+    if (driver->overlay_ops != RT_NULL)
+        flags |= RTGUI_CAP_OVERLAY;
+    if (driver->vsync != RT_NULL)
+        flags |= RTGUI_CAP_VSYNC;
+    if (driver->pixel_ops != RT_NULL && driver->pixel_ops->blit_rect != RT_NULL)
+        flags |= RTGUI_CAP_BLIT_RECT;
+    if (driver->pixel_ops != RT_NULL && driver->pixel_ops->blit_rect_async != RT_NULL)
+        flags |= RTGUI_CAP_DMA;
+
+    rt_memset(&driver->caps, 0, sizeof(driver->caps));
+    if (rt_device_control(driver->device, RTGRAPHIC_CTRL_GET_CAPS, &driver->caps) == RT_EOK)
+        flags &= driver->caps.flags;
+    driver->caps.flags = flags;
+}
+
+static rt_err_t _graphic_driver_set_device(struct rtgui_graphic_driver *driver, rt_device_t device)
 {
     rt_err_t result;
     struct rt_device_graphic_info info;
     struct rtgui_graphic_ext_ops *ext_ops;
+    struct rtgui_graphic_overlay_ops *overlay_ops;
+    rt_sem_t vsync = RT_NULL;
+
+    RT_ASSERT(device);
+
+    result = rt_device_open(device, 0);
+    if (result != RT_EOK)
+    {
+        return result;
+    }
+
+    /* get framebuffer address */
+    result = rt_device_control(device, RTGRAPHIC_CTRL_GET_INFO, &info);
+    if (result != RT_EOK)
+    {
+        /* get device information failed */
+        return result;
+    }
+#ifdef GUIENGINE_FIXED_PIXEL_FORMAT
+    /* the engine is built for the format of screen */
+    if (info.pixel_format != GUIENGINE_FIXED_PIXEL_FORMAT)
+    {
+        rt_kprintf("RTGUI: the pixel format %d is not the fixed one\n", info.pixel_format);
+        return -RT_ENOSYS;
+    }
+#endif
+
+    /* if the first set graphic device */
+    if (driver == &_driver && (driver->width == 0 || driver->height == 0))
+    {
+        rtgui_rect_t rect;
+
+        rtgui_get_mainwin_rect(&rect);
+        if (rect.x2 == 0 || rect.y2 == 0)
+        {
+            rtgui_rect_init(&rect, 0, 0, info.width, info.height);
+            /* re-set main-window */
+            rtgui_set_mainwin_rect(&rect);
+        }
+    }
+
+    /* initialize framebuffer driver */
+    driver->device = device;
+    driver->pixel_format = info.pixel_format;
+    driver->bits_per_pixel = info.bits_per_pixel;
+    driver->width = info.width;
+    driver->height = info.height;
+    driver->pitch = driver->width * _UI_BITBYTES(driver->bits_per_pixel);
+#ifdef GUIENGINE_USING_MONO_PACKED
+    /* the lines of 8 pixels a byte */
+    if (driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_MONO)
+        driver->pitch = (driver->width + 7) / 8;
+#endif
+    driver->framebuffer = info.framebuffer;
+
+    /* get graphic extension operations */
+    result = rt_device_control(device, RTGRAPHIC_CTRL_GET_EXT, &ext_ops);
+    if (result == RT_EOK)
+    {
+        driver->ext_ops = ext_ops;
+    }
+
+    /* get overlay planes if the display controller has */
+    result = rt_device_control(device, RTGRAPHIC_CTRL_GET_OVERLAY, &overlay_ops);
+    if (result == RT_EOK)
+        driver->overlay_ops = overlay_ops;
+    else
+        driver->overlay_ops = RT_NULL;
+
+    /* get the block write of the device without framebuffer */
+    driver->pixel_ops = RT_NULL;
+    if (info.framebuffer == RT_NULL)
+    {
+        struct rtgui_graphic_pixel_ops *pixel_ops;
+
+        result = rt_device_control(device, RTGRAPHIC_CTRL_GET_PIXEL_OPS, &pixel_ops);
+        if (result == RT_EOK)
+            driver->pixel_ops = pixel_ops;
+    }
+
+    /* get vsync/TE semaphore if the panel has */
+    result = rt_device_control(device, RTGRAPHIC_CTRL_GET_VSYNC, &vsync);
+    if (result == RT_EOK)
+        driver->vsync = vsync;
+    else
+        driver->vsync = RT_NULL;
+
+    if (info.framebuffer != RT_NULL)
+    {
+        /* is a frame buffer device */
+        driver->ops = rtgui_framebuffer_get_ops(driver->pixel_format);
+    }
+    else
+    {
+        /* is a pixel device, the writes are combined on the main display */
+        driver->ops = rtgui_pixel_device_get_ops(driver->pixel_format);
+#ifdef GUIENGINE_USING_PIXEL_WC
+        if (driver == &_driver)
+            driver->ops = _pixel_wc_get_ops(driver->pixel_ops, driver->pixel_format);
+#endif
+    }
+
+    _graphic_driver_negotiate(driver);
+
+    return RT_EOK;
+}
+
+rt_err_t rtgui_graphic_set_device(rt_device_t device)
+{
+    rt_err_t result;
+
+    result = _graphic_driver_set_device(&_driver, device);
+    if (result != RT_EOK)
+        return result;
+
+#ifdef RTGUI_USING_HW_CURSOR
+    /* set default cursor image */
+    rtgui_cursor_set_image(RTGUI_CURSOR_ARROW);
+#endif
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_graphic_set_device);
+
+#ifdef GUIENGINE_USING_ROTATION
+/* the pixel on panel of the pixel (x, y) in GUI */
+static rt_uint8_t *_rotation_pixel(const struct rtgui_graphic_driver *driver, int x, int y, int bpp)
+{
+    int px, py;
+
+    switch (driver->rotation)
+    {
+    case 90:
+        px = driver->panel_width - 1 - y;
+        py = x;
+        break;
+    case 180:
+        px = driver->panel_width - 1 - x;
+        py = driver->panel_height - 1 - y;
+        break;
+    default:
+        px = y;
+        py = driver->panel_height - 1 - x;
+        break;
+    }
+
+    return driver->panel_fb + py * driver->panel_pitch + px * bpp;
+}
+
+/*
+ * Rotate the rect of shadow framebuffer to the panel. It's copied in tiles,
+ * the lines of panel written by a tile are still in cache for its next row.
+ */
+static void _rotation_copy(const struct rtgui_graphic_driver *driver, const rtgui_rect_t *rect)
+{
+    int bpp, step, x, y, tx, ty, x2, y2;
+    rt_uint8_t *src, *dst;
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+    /* the step on panel of the next pixel in a line of GUI */
+    if (driver->rotation == 90)
+        step = driver->panel_pitch;
+    else if (driver->rotation == 180)
+        step = -bpp;
+    else
+        step = -(int)driver->panel_pitch;
+
+    for (ty = rect->y1; ty < rect->y2; ty += GUIENGINE_ROTATION_TILE)
+    {
+        y2 = ty + GUIENGINE_ROTATION_TILE;
+        if (y2 > rect->y2) y2 = rect->y2;
+
+        for (tx = rect->x1; tx < rect->x2; tx += GUIENGINE_ROTATION_TILE)
+        {
+            x2 = tx + GUIENGINE_ROTATION_TILE;
+            if (x2 > rect->x2) x2 = rect->x2;
+
+            for (y = ty; y < y2; y ++)
+            {
+                src = driver->framebuffer + y * driver->pitch + tx * bpp;
+                dst = _rotation_pixel(driver, tx, y, bpp);
+
+                if (bpp == 2)
+                {
+                    for (x = tx; x < x2; x ++, src += 2, dst += step)
+                        *(rt_uint16_t *)dst = *(rt_uint16_t *)src;
+                }
+                else if (bpp == 4)
+                {
+                    for (x = tx; x < x2; x ++, src += 4, dst += step)
+                        *(rt_uint32_t *)dst = *(rt_uint32_t *)src;
+                }
+                else
+                {
+                    for (x = tx; x < x2; x ++, src += bpp, dst += step)
+                        rt_memcpy(dst, src, bpp);
+                }
+            }
+        }
+    }
+}
+
+/* rotate the damaged rect to panel, and get the rect on panel to be updated */
+static void _rotation_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect,
+                             struct rt_device_rect_info *info)
+{
+    rtgui_rect_t r, screen;
+
+    r = *rect;
+    rtgui_graphic_driver_get_rect(driver, &screen);
+    rtgui_rect_intersect(&screen, &r);
+    if (r.x1 >= r.x2 || r.y1 >= r.y2)
+    {
+        info->x = info->y = info->width = info->height = 0;
+        return;
+    }
+
+    _rotation_copy(driver, &r);
+
+    info->width = r.y2 - r.y1;
+    info->height = r.x2 - r.x1;
+    switch (driver->rotation)
+    {
+    case 90:
+        info->x = driver->panel_width - r.y2;
+        info->y = r.x1;
+        break;
+    case 180:
+        info->x = driver->panel_width - r.x2;
+        info->y = driver->panel_height - r.y2;
+        info->width = r.x2 - r.x1;
+        info->height = r.y2 - r.y1;
+        break;
+    default:
+        info->x = r.y1;
+        info->y = driver->panel_height - r.x2;
+        break;
+    }
+}
+
+/*
+ * Rotate the GUI on the panel of the default driver clockwise by degree (0,
+ * 90, 180 or 270). The GUI draws to a shadow framebuffer in its orientation,
+ * which is rotated to the panel on the rects of screen update only.
+ *
+ * Note: call it after rtgui_graphic_set_device and before the windows are
+ * created. The page flipping is not rotated.
+ */
+rt_err_t rtgui_graphic_driver_set_rotation(int degree)
+{
+    int bpp;
+    rt_uint8_t *shadow;
+    rtgui_rect_t rect;
+
+    if (degree != 0 && degree != 90 && degree != 180 && degree != 270)
+        return -RT_ERROR;
+    if (_driver.page_num > 1)
+        return -RT_EBUSY;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    rtgui_graphic_driver_accel_sync();
+
+    /* back to the panel */
+    if (_driver.rotation != 0)
+    {
+        rtgui_free(_driver.framebuffer);
+        _driver.framebuffer = _driver.panel_fb;
+        _driver.width = _driver.panel_width;
+        _driver.height = _driver.panel_height;
+        _driver.pitch = _driver.panel_pitch;
+        _driver.rotation = 0;
+    }
+
+    if (degree != 0)
+    {
+        if (_driver.framebuffer == RT_NULL)
+        {
+            /* only the framebuffer device is rotated */
+            rtgui_screen_unlock();
+            return -RT_ENOSYS;
+        }
+
+        bpp = _UI_BITBYTES(_driver.bits_per_pixel);
+        _driver.panel_fb = _driver.framebuffer;
+        _driver.panel_width = _driver.width;
+        _driver.panel_height = _driver.height;
+        _driver.panel_pitch = _driver.pitch;
+        if (degree != 180)
+        {
+            _driver.width = _driver.panel_height;
+            _driver.height = _driver.panel_width;
+        }
+
+        shadow = (rt_uint8_t *)rtgui_malloc(_driver.width * bpp * _driver.height);
+        if (shadow == RT_NULL)
+        {
+            _driver.width = _driver.panel_width;
+            _driver.height = _driver.panel_height;
+            rtgui_screen_unlock();
+            return -RT_ENOMEM;
+        }
+        rt_memset(shadow, 0, _driver.width * bpp * _driver.height);
+
+        _driver.framebuffer = shadow;
+        _driver.pitch = _driver.width * bpp;
+        _driver.rotation = degree;
+    }
+
+    /* the main window in the orientation of GUI */
+    rtgui_rect_init(&rect, 0, 0, _driver.width, _driver.height);
+    rtgui_set_mainwin_rect(&rect);
+    rtgui_screen_unlock();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_graphic_driver_set_rotation);
+#endif
+
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+/* the cache lines of range, the ones of clean and invalidate are cleaned first */
+static void _cache_range(int ops, const rt_uint8_t *addr, int size)
+{
+    rt_ubase_t start, end;
+
+    start = (rt_ubase_t)addr & ~(rt_ubase_t)(GUIENGINE_CACHE_LINE - 1);
+    end = ((rt_ubase_t)addr + size + GUIENGINE_CACHE_LINE - 1) & ~(rt_ubase_t)(GUIENGINE_CACHE_LINE - 1);
+    rt_hw_cpu_dcache_ops(RT_HW_CACHE_FLUSH, (void *)start, end - start);
+    if (ops == RT_HW_CACHE_INVALIDATE)
+        rt_hw_cpu_dcache_ops(RT_HW_CACHE_INVALIDATE, (void *)start, end - start);
+}
+
+/*
+ * The rows of size bytes in the pitch. The rows with the gaps not larger than
+ * them are one range, for the gaps are cleaned before the invalidation.
+ */
+static void _cache_rows(int ops, const rt_uint8_t *pixels, int pitch, int size, int rows)
+{
+    if (size <= 0 || rows <= 0)
+        return;
+
+    if (pitch - size <= size)
+    {
+        _cache_range(ops, pixels, (rows - 1) * pitch + size);
+        return;
+    }
+    for (; rows > 0; rows --, pixels += pitch)
+        _cache_range(ops, pixels, size);
+}
+
+static void _cache_rect(int ops, const rt_uint8_t *fb, int pitch, int bpp, const rtgui_rect_t *rect)
+{
+    if (fb == RT_NULL || rect->x1 >= rect->x2 || rect->y1 >= rect->y2)
+        return;
+
+    _cache_rows(ops, fb + rect->y1 * pitch + rect->x1 * bpp, pitch,
+                (rect->x2 - rect->x1) * bpp, rect->y2 - rect->y1);
+}
+
+void rtgui_graphic_driver_cache_clean(const struct rtgui_graphic_driver *driver, const rtgui_rect_t *rect)
+{
+    rtgui_rect_t r;
+
+    rtgui_graphic_driver_get_rect(driver, &r);
+    rtgui_rect_intersect((rtgui_rect_t *)rect, &r);
+    _cache_rect(RT_HW_CACHE_FLUSH, driver->framebuffer, driver->pitch,
+                _UI_BITBYTES(driver->bits_per_pixel), &r);
+}
+RTM_EXPORT(rtgui_graphic_driver_cache_clean);
+
+/* the rect of panel in update is read by the display controller */
+static void _cache_clean_update(const struct rtgui_graphic_driver *driver,
+                                const struct rt_device_rect_info *info)
+{
+    rtgui_rect_t rect;
+
+    rtgui_rect_init(&rect, info->x, info->y, info->width, info->height);
+#ifdef GUIENGINE_USING_ROTATION
+    if (driver->rotation != 0)
+    {
+        _cache_rect(RT_HW_CACHE_FLUSH, driver->panel_fb, driver->panel_pitch,
+                    _UI_BITBYTES(driver->bits_per_pixel), &rect);
+        return;
+    }
+#endif
+    rtgui_graphic_driver_cache_clean(driver, &rect);
+}
+#endif
+
+/* screen update */
+void rtgui_graphic_driver_screen_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+#ifdef GUIENGINE_USING_BOOT_SNAPSHOT
+    rtgui_rect_t update;
+
+    /* the snapshot of boot stays on panel until the first window is shown */
+    if (rtgui_snapshot_hold(rect, &update) == RT_TRUE)
+        return;
+    rect = &update;
+#endif
+    if (driver->device != RT_NULL)
+    {
+        struct rt_device_rect_info rect_info;
+
+        rtgui_graphic_driver_accel_sync();
+        rtgui_graphic_driver_flush(driver);
+
+#ifdef GUIENGINE_USING_OVERDRAW
+        rtgui_overdraw_update(driver, rect);
+#endif
+#ifdef GUIENGINE_USING_ROTATION
+        if (driver->rotation != 0)
+        {
+            _rotation_update(driver, rect, &rect_info);
+            if (rect_info.width == 0) return;
+        }
+        else
+#endif
+        {
+            rect_info.x = rect->x1;
+            rect_info.y = rect->y1;
+            rect_info.width = rect->x2 - rect->x1;
+            rect_info.height = rect->y2 - rect->y1;
+        }
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+        _cache_clean_update(driver, &rect_info);
+#endif
+#ifdef GUIENGINE_USING_EPAPER
+        {
+            rtgui_rect_t r;
+
+            /* the e-paper is refreshed by its thread */
+            rtgui_rect_init(&r, rect_info.x, rect_info.y, rect_info.width, rect_info.height);
+            if (rtgui_epaper_update(driver, &r))
+                return;
+        }
+#endif
+        RTGUI_TRACE_BEGIN("screen update", rect_info.width * rect_info.height);
+#ifdef GUIENGINE_USING_PROFILE
+        {
+            rt_uint32_t start = rtgui_profile_clock();
+
+            rt_device_control(driver->device, RTGRAPHIC_CTRL_RECT_UPDATE, &rect_info);
+            rtgui_profile_add(RTGUI_PROFILE_UPDATE, rect_info.width * rect_info.height, start);
+        }
+#else
+        rt_device_control(driver->device, RTGRAPHIC_CTRL_RECT_UPDATE, &rect_info);
+#endif
+        RTGUI_BOOT_MARK(RTGUI_BOOT_FIRST_UPDATE);
+#ifdef GUIENGINE_USING_LAZY_INIT
+        /* the fonts not used by the first frame are loaded in background */
+        rtgui_font_system_load_deferred();
+#endif
+        RTGUI_TRACE_END("screen update");
+    }
+}
+RTM_EXPORT(rtgui_graphic_driver_screen_update);
+
+void rtgui_graphic_driver_set_framebuffer(void *fb)
+{
+    rtgui_graphic_driver_accel_sync();
+    if (_current_driver)
+        _current_driver->framebuffer = fb;
+    else
+        _driver.framebuffer = fb;
+}
+
+void rtgui_graphic_driver_set_vsync(rt_sem_t vsync)
+{
+    _driver.vsync = vsync;
+}
+RTM_EXPORT(rtgui_graphic_driver_set_vsync);
+
+/*
+ * fill a device rect of framebuffer by the 2D accelerator. The CPU should not
+ * touch the framebuffer before rtgui_graphic_driver_accel_sync.
+ */
+rt_err_t rtgui_graphic_driver_accel_fill(const struct rtgui_graphic_driver *driver,
+                                         rtgui_color_t c, rtgui_rect_t *rect)
+{
+    rt_err_t result;
+    rt_uint8_t *dst;
+
+    if (!rtgui_graphic_driver_has_cap(driver, RTGUI_CAP_ACCEL_FILL) || driver->framebuffer == RT_NULL)
+        return -RT_ENOSYS;
+
+    if (rect->x1 >= rect->x2 || rect->y1 >= rect->y2)
+        return RT_EOK;
+
+    dst = driver->framebuffer + rect->y1 * driver->pitch +
+          rect->x1 * _UI_BITBYTES(driver->bits_per_pixel);
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+    /* no dirty line is written back over the fill */
+    _cache_rect(RT_HW_CACHE_INVALIDATE, driver->framebuffer, driver->pitch,
+                _UI_BITBYTES(driver->bits_per_pixel), rect);
+#endif
+    result = driver->ext_ops->accel_fill(c, dst, driver->pitch, driver->pixel_format,
+                                         rtgui_rect_width(*rect), rtgui_rect_height(*rect));
+    if (result == RT_EOK)
+        _driver.accel_busy = 1;
+
+    return result;
+}
+RTM_EXPORT(rtgui_graphic_driver_accel_fill);
+
+/*
+ * blit by the 2D accelerator. Only the blit to framebuffer is accelerated, for
+ * the other memory may be read by CPU without synchronization.
+ */
+rt_err_t rtgui_graphic_driver_accel_blit(struct rtgui_blit_info *info)
+{
+    rt_err_t result;
+    rt_uint8_t *fb_end;
+
+    if (!rtgui_graphic_driver_has_cap(&_driver, RTGUI_CAP_ACCEL_BLIT) || _driver.framebuffer == RT_NULL)
+        return -RT_ENOSYS;
+
+    /* the source is read by the accelerator */
+    if (_driver.caps.formats != 0 && (_driver.caps.formats & (1UL << info->src_fmt)) == 0)
+        return -RT_ENOSYS;
+
+    fb_end = _driver.framebuffer + _driver.pitch * _driver.height;
+    if (info->dst < _driver.framebuffer || info->dst >= fb_end)
+        return -RT_ENOSYS;
+
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+    /* the source is in memory, and no dirty line is written back over the blit */
+    _cache_rows(RT_HW_CACHE_FLUSH, info->src, info->src_pitch,
+                info->src_w * rtgui_color_get_bpp(info->src_fmt), info->src_h);
+    _cache_rows(RT_HW_CACHE_INVALIDATE, info->dst, info->dst_pitch,
+                info->dst_w * rtgui_color_get_bpp(info->dst_fmt), info->dst_h);
+#endif
+    result = _driver.ext_ops->accel_blit(info);
+    if (result == RT_EOK)
+        _driver.accel_busy = 1;
+
+    return result;
+}
+RTM_EXPORT(rtgui_graphic_driver_accel_blit);
+
+/* wait for the 2D accelerator before the CPU touches the framebuffer */
+void rtgui_graphic_driver_accel_sync(void)
+{
+    if (_driver.accel_busy)
+    {
+        _driver.accel_busy = 0;
+        _driver.ext_ops->accel_sync();
+    }
+}
+RTM_EXPORT(rtgui_graphic_driver_accel_sync);
+
+/*
+ * Set the pixels of an overlay plane, -RT_ENOSYS is returned if the display
+ * controller has no overlay planes and the one should be drawn in framebuffer.
+ */
+rt_err_t rtgui_graphic_driver_overlay_set_image(const struct rtgui_graphic_driver *driver, int plane,
+                                                const rt_uint8_t *pixels, int pitch,
+                                                rt_uint8_t format, int w, int h)
+{
+    if (driver == RT_NULL || driver->overlay_ops == RT_NULL ||
+            driver->overlay_ops->set_image == RT_NULL)
+        return -RT_ENOSYS;
+
+    return driver->overlay_ops->set_image(plane, pixels, pitch, format, w, h);
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_set_image);
+
+rt_err_t rtgui_graphic_driver_overlay_set_position(const struct rtgui_graphic_driver *driver,
+                                                   int plane, int x, int y)
+{
+    if (driver == RT_NULL || driver->overlay_ops == RT_NULL ||
+            driver->overlay_ops->set_position == RT_NULL)
+        return -RT_ENOSYS;
+
+    return driver->overlay_ops->set_position(plane, x, y);
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_set_position);
+
+/*
+ * Allocate a plane after the cursor one, in the planes reported by the caps of
+ * device. It's the plane number, or -RT_ENOSYS if the display controller can
+ * not queue the buffers and -RT_EFULL if all the planes are used.
+ */
+int rtgui_graphic_driver_overlay_alloc(struct rtgui_graphic_driver *driver)
+{
+    int plane, planes;
+
+    if (driver == RT_NULL || driver->overlay_ops == RT_NULL ||
+            driver->overlay_ops->queue_buffer == RT_NULL)
+        return -RT_ENOSYS;
+
+    planes = driver->caps.planes < RTGUI_OVERLAY_MAX ? driver->caps.planes : RTGUI_OVERLAY_MAX;
+    for (plane = RTGUI_OVERLAY_CURSOR + 1; plane < planes; plane ++)
+    {
+        if (!(driver->overlay_used & (1 << plane)))
+        {
+            driver->overlay_used |= 1 << plane;
+            return plane;
+        }
+    }
+
+    return -RT_EFULL;
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_alloc);
+
+/* hide the plane and free it */
+void rtgui_graphic_driver_overlay_free(struct rtgui_graphic_driver *driver, int plane)
+{
+    if (plane <= RTGUI_OVERLAY_CURSOR || plane >= RTGUI_OVERLAY_MAX ||
+            !(driver->overlay_used & (1 << plane)))
+        return;
+
+    driver->overlay_ops->queue_buffer(plane, RT_NULL, 0, 0, 0, 0);
+    driver->overlay_used &= ~(1 << plane);
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_free);
+
+/*
+ * Show the frame in the plane, the format may be YUV. The buffer should not
+ * be written until the next frame is queued, so a decoder or camera keeps two
+ * buffers at least.
+ */
+rt_err_t rtgui_graphic_driver_overlay_queue(const struct rtgui_graphic_driver *driver, int plane,
+                                            const void *buffer, int pitch,
+                                            rt_uint8_t format, int w, int h)
+{
+    if (driver == RT_NULL || driver->overlay_ops == RT_NULL ||
+            driver->overlay_ops->queue_buffer == RT_NULL)
+        return -RT_ENOSYS;
+
+    return driver->overlay_ops->queue_buffer(plane, buffer, pitch, format, w, h);
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_queue);
+
+rt_err_t rtgui_graphic_driver_overlay_set_zorder(const struct rtgui_graphic_driver *driver,
+                                                 int plane, int z)
+{
+    if (driver == RT_NULL || driver->overlay_ops == RT_NULL ||
+            driver->overlay_ops->set_zorder == RT_NULL)
+        return -RT_ENOSYS;
+
+    return driver->overlay_ops->set_zorder(plane, z);
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_set_zorder);
+
+rtgui_color_t rtgui_graphic_driver_overlay_hole(const struct rtgui_graphic_driver *driver)
+{
+    if (driver->pixel_format == RTGRAPHIC_PIXEL_FORMAT_ARGB888)
+        return RTGUI_OVERLAY_HOLE;
+
+    return GUIENGINE_OVERLAY_COLORKEY;
+}
+RTM_EXPORT(rtgui_graphic_driver_overlay_hole);
+
+static void _framebuffer_fill_rect(const struct rtgui_graphic_driver *driver,
+                                   rt_uint32_t pixel, rtgui_rect_t *rect)
+{
+    int index, w, h, bpp;
+    rt_uint8_t *line, *dst;
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+    w = rtgui_rect_width(*rect);
+    h = rtgui_rect_height(*rect);
+    line = driver->framebuffer + rect->y1 * driver->pitch + rect->x1 * bpp;
+
+    /* fill the first line in word */
+    if (bpp == 2)
+    {
+        rt_uint16_t *ptr = (rt_uint16_t *)line;
+
+        index = w;
+        if (((rt_ubase_t)ptr & 0x03) != 0)
+        {
+            *ptr++ = (rt_uint16_t)pixel;
+            index --;
+        }
+        pixel = (pixel & 0xFFFF) | (pixel << 16);
+        for (; index >= 2; index -= 2)
+        {
+            *(rt_uint32_t *)ptr = pixel;
+            ptr += 2;
+        }
+        if (index) *ptr = (rt_uint16_t)pixel;
+    }
+    else
+    {
+        rt_uint32_t *ptr = (rt_uint32_t *)line;
+
+        for (index = 0; index < w; index ++)
+            *ptr++ = pixel;
+    }
+
+    /* then copy it to the others */
+    dst = line + driver->pitch;
+    for (index = 1; index < h; index ++)
+    {
+        rt_memcpy(dst, line, w * bpp);
+        dst += driver->pitch;
+    }
+}
+
+/*
+ * fill a device rect, which should be inside of the screen. The 2D
+ * accelerator, the fill_rect of extension operations and the block fill of
+ * framebuffer are tried in turn.
+ */
+void rtgui_graphic_driver_fill_rect(const struct rtgui_graphic_driver *driver,
+                                    rtgui_color_t c, rtgui_rect_t *rect)
+{
+    int index;
+
+    if (rect->x1 >= rect->x2 || rect->y1 >= rect->y2)
+        return;
+
+    if (rtgui_graphic_driver_accel_fill(driver, c, rect) == RT_EOK)
+    {
+        RTGUI_OVERDRAW_RECT(rect);
+        return;
+    }
+    rtgui_graphic_driver_accel_sync();
+
+    if (driver->ext_ops != RT_NULL && driver->ext_ops->fill_rect != RT_NULL)
+    {
+        RTGUI_OVERDRAW_RECT(rect);
+        driver->ext_ops->fill_rect(&c, rect->x1, rect->y1, rect->x2, rect->y2);
+        return;
+    }
+
+    if (driver->framebuffer != RT_NULL)
+    {
+        switch (driver->pixel_format)
+        {
+        case RTGRAPHIC_PIXEL_FORMAT_RGB565:
+            RTGUI_OVERDRAW_RECT(rect);
+            _framebuffer_fill_rect(driver, rtgui_color_to_565(c), rect);
+            return;
+        case RTGRAPHIC_PIXEL_FORMAT_RGB565P:
+            RTGUI_OVERDRAW_RECT(rect);
+            _framebuffer_fill_rect(driver, rtgui_color_to_565p(c), rect);
+            return;
+        case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
+            RTGUI_OVERDRAW_RECT(rect);
+            _framebuffer_fill_rect(driver, c, rect);
+            return;
+        }
+    }
+
+    /* the draw_hline is counted by itself */
+    for (index = rect->y1; index < rect->y2; index ++)
+        driver->ops->draw_hline(&c, rect->x1, rect->x2, index);
+}
+RTM_EXPORT(rtgui_graphic_driver_fill_rect);
+
+/*
+ * draw a device hline in the native pixel of driver, which is cached in the
+ * gc. RT_FALSE is returned if it's not a framebuffer of 16 or 32 bits, and the
+ * line should be drawn by the draw_hline of operations.
+ */
+rt_bool_t rtgui_graphic_driver_draw_hline_pixel(const struct rtgui_graphic_driver *driver,
+                                                rt_uint32_t pixel, int x1, int x2, int y)
+{
+    rtgui_rect_t rect;
+
+    if (driver->framebuffer == RT_NULL || driver->ext_ops != RT_NULL ||
+            (driver->bits_per_pixel != 16 && driver->bits_per_pixel != 32))
+        return RT_FALSE;
+    if (x1 >= x2)
+        return RT_TRUE;
+
+    rect.x1 = x1; rect.x2 = x2;
+    rect.y1 = y;  rect.y2 = y + 1;
+    RTGUI_OVERDRAW_RECT(&rect);
+    _framebuffer_fill_rect(driver, pixel, &rect);
+
+    return RT_TRUE;
+}
+RTM_EXPORT(rtgui_graphic_driver_draw_hline_pixel);
 
-    RT_ASSERT(device);
+rt_bool_t rtgui_graphic_driver_draw_vline_pixel(const struct rtgui_graphic_driver *driver,
+                                                rt_uint32_t pixel, int x, int y1, int y2)
+{
+    int index;
+    rt_uint8_t *dst;
 
-    result = rt_device_open(device, 0);
-    if (result != RT_EOK)
+    if (driver->framebuffer == RT_NULL || driver->ext_ops != RT_NULL ||
+            (driver->bits_per_pixel != 16 && driver->bits_per_pixel != 32))
+        return RT_FALSE;
+    if (y1 >= y2)
+        return RT_TRUE;
+
+#ifdef GUIENGINE_USING_OVERDRAW
     {
-        return result;
+        rtgui_rect_t rect;
+
+        rect.x1 = x;  rect.x2 = x + 1;
+        rect.y1 = y1; rect.y2 = y2;
+        RTGUI_OVERDRAW_RECT(&rect);
     }
+#endif
 
-    /* get framebuffer address */
-    result = rt_device_control(device, RTGRAPHIC_CTRL_GET_INFO, &info);
-    if (result != RT_EOK)
+    dst = driver->framebuffer + y1 * driver->pitch + x * _UI_BITBYTES(driver->bits_per_pixel);
+    if (driver->bits_per_pixel == 16)
     {
-        /* get device information failed */
-        return result;
+        for (index = y1; index < y2; index ++)
+        {
+            *(rt_uint16_t *)dst = (rt_uint16_t)pixel;
+            dst += driver->pitch;
+        }
     }
-
-    /* if the first set graphic device */
-    if (_driver.width == 0 || _driver.height == 0)
+    else
     {
-        rtgui_rect_t rect;
-
-        rtgui_get_mainwin_rect(&rect);
-        if (rect.x2 == 0 || rect.y2 == 0)
+        for (index = y1; index < y2; index ++)
         {
-            rtgui_rect_init(&rect, 0, 0, info.width, info.height);
-            /* re-set main-window */
-            rtgui_set_mainwin_rect(&rect);
+            *(rt_uint32_t *)dst = pixel;
+            dst += driver->pitch;
         }
     }
 
-    /* initialize framebuffer driver */
-    _driver.device = device;
-    _driver.pixel_format = info.pixel_format;
-    _driver.bits_per_pixel = info.bits_per_pixel;
-    _driver.width = info.width;
-    _driver.height = info.height;
-    _driver.pitch = _driver.width * _UI_BITBYTES(_driver.bits_per_pixel);
-    _driver.framebuffer = info.framebuffer;
+    return RT_TRUE;
+}
+RTM_EXPORT(rtgui_graphic_driver_draw_vline_pixel);
 
-    /* get graphic extension operations */
-    result = rt_device_control(device, RTGRAPHIC_CTRL_GET_EXT, &ext_ops);
-    if (result == RT_EOK)
-    {
-        _driver.ext_ops = ext_ops;
-    }
+/*
+ * Set the framebuffer pages of the default driver for page flipping. The
+ * pages[0] should be the page being shown, the GUI draws to the others in
+ * turn. Set num to 1 to disable page flipping.
+ *
+ * Note: call it after rtgui_graphic_set_device.
+ */
+rt_err_t rtgui_graphic_driver_set_pages(void *pages[], int num)
+{
+    int index;
+    rtgui_rect_t rect;
 
-    if (info.framebuffer != RT_NULL)
-    {
-        /* is a frame buffer device */
-        _driver.ops = rtgui_framebuffer_get_ops(_driver.pixel_format);
-    }
-    else
+    if (num < 1 || num > GUIENGINE_FRAMEBUFFER_PAGE_MAX)
+        return -RT_ERROR;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+
+    for (index = 0; index < _driver.page_num; index++)
+        rtgui_region_fini(&_driver.page_stale[index]);
+
+    rtgui_graphic_driver_get_rect(&_driver, &rect);
+    for (index = 0; index < num; index++)
     {
-        /* is a pixel device */
-        _driver.ops = rtgui_pixel_device_get_ops(_driver.pixel_format);
+        _driver.pages[index] = (rt_uint8_t *)pages[index];
+        /* the content of the pages behind is unknown */
+        if (index < 2)
+            rtgui_region_init(&_driver.page_stale[index]);
+        else
+            rtgui_region_init_with_extents(&_driver.page_stale[index], &rect);
     }
 
-#ifdef RTGUI_USING_HW_CURSOR
-    /* set default cursor image */
-    rtgui_cursor_set_image(RTGUI_CURSOR_ARROW);
-#endif
+    _driver.page_num  = num > 1 ? num : 0;
+    _driver.page_back = num > 1 ? 1 : 0;
+    /* initialize the first back page from the front */
+    if (num > 1)
+        rt_memcpy(_driver.pages[1], _driver.pages[0], _driver.pitch * _driver.height);
+    _driver.framebuffer = _driver.pages[_driver.page_back];
 
-#ifdef GUIENGIN_USING_VFRAMEBUFFER
-    _graphic_driver_vmode_init();
-#endif
+    rtgui_screen_unlock();
 
     return RT_EOK;
 }
-RTM_EXPORT(rtgui_graphic_set_device);
+RTM_EXPORT(rtgui_graphic_driver_set_pages);
 
-/* screen update */
-void rtgui_graphic_driver_screen_update(const struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+/*
+ * Show the back page and switch drawing to the next page. Only the area
+ * stale in the next page is copied forward from the new front page.
+ *
+ * Note: with two pages, the flip should be done in vsync, or the display
+ * controller may still scan the page which will be drawn.
+ */
+void rtgui_graphic_driver_page_flip(struct rtgui_graphic_driver *driver, rtgui_region_t *damage)
 {
+    int index, num, y, bpp;
+    rt_uint8_t front, back;
+    rtgui_rect_t *rects, rect;
+    rt_uint8_t *src, *dst;
+
+    if (driver == RT_NULL) driver = &_driver;
+    if (driver->page_num < 2)
+        return;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    rtgui_graphic_driver_accel_sync();
+
+    front = driver->page_back;
+    back = (front + 1) % driver->page_num;
+
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+    num = rtgui_region_num_rects(damage);
+    rects = rtgui_region_rects(damage);
+    for (index = 0; index < num; index++)
+        rtgui_graphic_driver_cache_clean(driver, &rects[index]);
+#endif
     if (driver->device != RT_NULL)
+        rt_device_control(driver->device, RTGRAPHIC_CTRL_PAN_DISPLAY, driver->pages[front]);
+
+    /* the other pages miss the damage of this frame */
+    for (index = 0; index < driver->page_num; index++)
     {
-        struct rt_device_rect_info rect_info;
+        if (index != front)
+            rtgui_region_union(&driver->page_stale[index], &driver->page_stale[index], damage);
+    }
 
-        rect_info.x = rect->x1;
-        rect_info.y = rect->y1;
-        rect_info.width = rect->x2 - rect->x1;
-        rect_info.height = rect->y2 - rect->y1;
-        rt_device_control(driver->device, RTGRAPHIC_CTRL_RECT_UPDATE, &rect_info);
+    /* copy forward the stale area to the new back page */
+    rtgui_graphic_driver_get_rect(driver, &rect);
+    rtgui_region_intersect_rect(&driver->page_stale[back], &driver->page_stale[back], &rect);
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+    num = rtgui_region_num_rects(&driver->page_stale[back]);
+    rects = rtgui_region_rects(&driver->page_stale[back]);
+    for (index = 0; index < num; index++)
+    {
+        src = driver->pages[front] + rects[index].y1 * driver->pitch + rects[index].x1 * bpp;
+        dst = driver->pages[back]  + rects[index].y1 * driver->pitch + rects[index].x1 * bpp;
+        for (y = rects[index].y1; y < rects[index].y2; y++)
+        {
+            rt_memcpy(dst, src, rtgui_rect_width(rects[index]) * bpp);
+            src += driver->pitch;
+            dst += driver->pitch;
+        }
     }
-}
-RTM_EXPORT(rtgui_graphic_driver_screen_update);
+    rtgui_region_empty(&driver->page_stale[back]);
 
-void rtgui_graphic_driver_set_framebuffer(void *fb)
-{
-    if (_current_driver)
-        _current_driver->framebuffer = fb;
-    else
-        _driver.framebuffer = fb;
+    driver->page_back = back;
+    driver->framebuffer = driver->pages[back];
+
+    rtgui_screen_unlock();
 }
+RTM_EXPORT(rtgui_graphic_driver_page_flip);
 
 /* get video frame buffer */
 rt_uint8_t *rtgui_graphic_driver_get_framebuffer(const struct rtgui_graphic_driver *driver)
@@ -431,7 +1432,7 @@ static void framebuffer_draw_raw_hline(rt_uint8_t *pixels, int x1, int x2, int y
               (x2 - x1) * _UI_BITBYTES(drv->bits_per_pixel));
 }
 
-const struct rtgui_graphic_driver_ops _framebuffer_rgb565_ops =
+static const struct rtgui_graphic_driver_ops _framebuffer_rgb565_ops =
 {
     _rgb565_set_pixel,
     _rgb565_get_pixel,
@@ -440,7 +1441,7 @@ const struct rtgui_graphic_driver_ops _framebuffer_rgb565_ops =
     framebuffer_draw_raw_hline,
 };
 
-const struct rtgui_graphic_driver_ops _framebuffer_rgb565p_ops =
+static const struct rtgui_graphic_driver_ops _framebuffer_rgb565p_ops =
 {
     _rgb565p_set_pixel,
     _rgb565p_get_pixel,
@@ -449,7 +1450,7 @@ const struct rtgui_graphic_driver_ops _framebuffer_rgb565p_ops =
     framebuffer_draw_raw_hline,
 };
 
-const struct rtgui_graphic_driver_ops _framebuffer_argb888_ops =
+static const struct rtgui_graphic_driver_ops _framebuffer_argb888_ops =
 {
     _argb888_set_pixel,
     _argb888_get_pixel,
@@ -531,7 +1532,7 @@ static void _mono_draw_raw_hline(rt_uint8_t *pixels, int x1, int x2, int y)
     }
 }
 
-const struct rtgui_graphic_driver_ops _framebuffer_mono_ops =
+static const struct rtgui_graphic_driver_ops _framebuffer_mono_ops =
 {
     _mono_set_pixel,
     _mono_get_pixel,
@@ -540,20 +1541,134 @@ const struct rtgui_graphic_driver_ops _framebuffer_mono_ops =
     _mono_draw_raw_hline,
 };
 
+#ifdef GUIENGINE_USING_MONO_PACKED
+/*
+ * The packed mono framebuffer of e-paper and memory LCD, the lines are in
+ * the pitch and the MSB of a byte is the left pixel. The bit set is black.
+ */
+#define MONO_PACKED_BYTE(drv, x, y) \
+    ((drv)->framebuffer + (y) * (drv)->pitch + ((x) >> 3))
+#define MONO_PACKED_MASK(x)     (0x80 >> ((x) & 0x07))
+
+static void _mono_packed_set_pixel(rtgui_color_t *c, int x, int y)
+{
+    struct rtgui_graphic_driver *drv = rtgui_graphic_get_device();
+
+    if (*c == white)
+        *MONO_PACKED_BYTE(drv, x, y) &= ~MONO_PACKED_MASK(x);
+    else
+        *MONO_PACKED_BYTE(drv, x, y) |= MONO_PACKED_MASK(x);
+}
+
+static void _mono_packed_get_pixel(rtgui_color_t *c, int x, int y)
+{
+    struct rtgui_graphic_driver *drv = rtgui_graphic_get_device();
+
+    if (*MONO_PACKED_BYTE(drv, x, y) & MONO_PACKED_MASK(x))
+        *c = black;
+    else
+        *c = white;
+}
+
+static void _mono_packed_draw_hline(rtgui_color_t *c, int x1, int x2, int y)
+{
+    int bytes;
+    rt_uint8_t *ptr, head, tail, fill;
+    struct rtgui_graphic_driver *drv = rtgui_graphic_get_device();
+
+    if (x1 >= x2) return;
+
+    fill = (*c == white) ? 0x00 : 0xff;
+    ptr = MONO_PACKED_BYTE(drv, x1, y);
+    /* the bits from x1 in the first byte, and to x2 in the last byte */
+    head = 0xff >> (x1 & 0x07);
+    tail = 0xff << (7 - ((x2 - 1) & 0x07));
+    bytes = ((x2 - 1) >> 3) - (x1 >> 3);
+
+    if (bytes == 0)
+    {
+        head &= tail;
+        *ptr = (*ptr & ~head) | (fill & head);
+        return;
+    }
+
+    *ptr = (*ptr & ~head) | (fill & head);
+    ptr ++;
+    /* the bytes between are set in words by memset */
+    if (bytes > 1)
+    {
+        rt_memset(ptr, fill, bytes - 1);
+        ptr += bytes - 1;
+    }
+    *ptr = (*ptr & ~tail) | (fill & tail);
+}
+
+static void _mono_packed_draw_vline(rtgui_color_t *c, int x, int y1, int y2)
+{
+    int index;
+    rt_uint8_t *ptr, mask;
+    struct rtgui_graphic_driver *drv = rtgui_graphic_get_device();
+
+    ptr = MONO_PACKED_BYTE(drv, x, y1);
+    mask = MONO_PACKED_MASK(x);
+    if (*c == white)
+    {
+        for (index = y1; index < y2; index ++, ptr += drv->pitch)
+            *ptr &= ~mask;
+    }
+    else
+    {
+        for (index = y1; index < y2; index ++, ptr += drv->pitch)
+            *ptr |= mask;
+    }
+}
+
+/* the raw line is packed by 8 pixels a byte from x = 0, the LSB is the left */
+static void _mono_packed_draw_raw_hline(rt_uint8_t *pixels, int x1, int x2, int y)
+{
+    int index;
+    rt_uint8_t *ptr;
+    struct rtgui_graphic_driver *drv = rtgui_graphic_get_device();
+
+    ptr = MONO_PACKED_BYTE(drv, x1, y);
+    for (index = x1; index < x2; index ++)
+    {
+        if (pixels[index / 8] & (1 << (index % 8)))
+            *ptr |= MONO_PACKED_MASK(index);
+        else
+            *ptr &= ~MONO_PACKED_MASK(index);
+        if ((index & 0x07) == 0x07) ptr ++;
+    }
+}
+
+static const struct rtgui_graphic_driver_ops _framebuffer_mono_packed_ops =
+{
+    _mono_packed_set_pixel,
+    _mono_packed_get_pixel,
+    _mono_packed_draw_hline,
+    _mono_packed_draw_vline,
+    _mono_packed_draw_raw_hline,
+};
+#endif
+
 const struct rtgui_graphic_driver_ops *rtgui_framebuffer_get_ops(int pixel_format)
 {
     switch (pixel_format)
     {
     case RTGRAPHIC_PIXEL_FORMAT_MONO:
-        return &_framebuffer_mono_ops;
+#ifdef GUIENGINE_USING_MONO_PACKED
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_MONO, &_framebuffer_mono_packed_ops);
+#else
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_MONO, &_framebuffer_mono_ops);
+#endif
     case RTGRAPHIC_PIXEL_FORMAT_GRAY4:
         break;
     case RTGRAPHIC_PIXEL_FORMAT_GRAY16:
         break;
     case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        return &_framebuffer_rgb565_ops;
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565, &_framebuffer_rgb565_ops);
     case RTGRAPHIC_PIXEL_FORMAT_RGB565P:
-        return &_framebuffer_rgb565p_ops;
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565P, &_framebuffer_rgb565p_ops);
     case RTGRAPHIC_PIXEL_FORMAT_ARGB888:
         return &_framebuffer_argb888_ops;
     default:
@@ -706,7 +1821,7 @@ static void _pixel_draw_raw_hline(rt_uint8_t *pixels, int x1, int x2, int y)
         gfx_device_ops->blit_line((char *)pixels, x2, y, (x1 - x2));
 }
 
-const struct rtgui_graphic_driver_ops _pixel_mono_ops =
+static const struct rtgui_graphic_driver_ops _pixel_mono_ops =
 {
     _pixel_mono_set_pixel,
     _pixel_mono_get_pixel,
@@ -715,7 +1830,7 @@ const struct rtgui_graphic_driver_ops _pixel_mono_ops =
     _pixel_draw_raw_hline,
 };
 
-const struct rtgui_graphic_driver_ops _pixel_rgb565p_ops =
+static const struct rtgui_graphic_driver_ops _pixel_rgb565p_ops =
 {
     _pixel_rgb565p_set_pixel,
     _pixel_rgb565p_get_pixel,
@@ -724,7 +1839,7 @@ const struct rtgui_graphic_driver_ops _pixel_rgb565p_ops =
     _pixel_draw_raw_hline,
 };
 
-const struct rtgui_graphic_driver_ops _pixel_rgb565_ops =
+static const struct rtgui_graphic_driver_ops _pixel_rgb565_ops =
 {
     _pixel_rgb565_set_pixel,
     _pixel_rgb565_get_pixel,
@@ -733,7 +1848,7 @@ const struct rtgui_graphic_driver_ops _pixel_rgb565_ops =
     _pixel_draw_raw_hline,
 };
 
-const struct rtgui_graphic_driver_ops _pixel_rgb888_ops =
+static const struct rtgui_graphic_driver_ops _pixel_rgb888_ops =
 {
     _pixel_rgb888_set_pixel,
     _pixel_rgb888_get_pixel,
@@ -742,21 +1857,298 @@ const struct rtgui_graphic_driver_ops _pixel_rgb888_ops =
     _pixel_draw_raw_hline,
 };
 
+#ifdef GUIENGINE_USING_PIXEL_WC
+/*
+ * The write combining of pixel device. The spans of the same x range in the
+ * adjacent lines are kept in the buffer as a rect, which is written by one
+ * blit_rect. The others flush the rect first, so the order of writes is kept.
+ */
+static struct
+{
+    const struct rtgui_graphic_pixel_ops *device_ops;
+    /* the operations of pixel format without combining */
+    const struct rtgui_graphic_driver_ops *ops;
+    rt_uint8_t pixel_format;
+
+    rt_uint8_t pixels[GUIENGINE_PIXEL_WC_SIZE];
+    /* the rect combined, it's empty if y1 == y2 */
+    int x1, x2, y1, y2;
+} _pixel_wc;
+
+static void _pixel_wc_flush(void)
+{
+    int w = _pixel_wc.x2 - _pixel_wc.x1;
+
+    if (_pixel_wc.y2 > _pixel_wc.y1)
+    {
+        _pixel_wc.device_ops->blit_rect(_pixel_wc.pixels, w * 2, _pixel_wc.x1, _pixel_wc.y1,
+                                        w, _pixel_wc.y2 - _pixel_wc.y1);
+    }
+    _pixel_wc.y1 = _pixel_wc.y2 = 0;
+}
+
+/* get the line of span in the rect, RT_NULL if the span is out of buffer */
+static rt_uint16_t *_pixel_wc_line(int x1, int x2, int y)
+{
+    int size = (x2 - x1) * 2;
+    rt_uint8_t *line;
+
+    if (size <= 0 || size > GUIENGINE_PIXEL_WC_SIZE)
+    {
+        _pixel_wc_flush();
+        return RT_NULL;
+    }
+
+    /* not the next line of rect, or the buffer is full */
+    if (_pixel_wc.y2 > _pixel_wc.y1 &&
+            (x1 != _pixel_wc.x1 || x2 != _pixel_wc.x2 || y != _pixel_wc.y2 ||
+             (_pixel_wc.y2 - _pixel_wc.y1 + 1) * size > GUIENGINE_PIXEL_WC_SIZE))
+        _pixel_wc_flush();
+
+    if (_pixel_wc.y2 == _pixel_wc.y1)
+    {
+        _pixel_wc.x1 = x1;
+        _pixel_wc.x2 = x2;
+        _pixel_wc.y1 = _pixel_wc.y2 = y;
+    }
+
+    line = _pixel_wc.pixels + (_pixel_wc.y2 - _pixel_wc.y1) * size;
+    _pixel_wc.y2 ++;
+
+    return (rt_uint16_t *)line;
+}
+
+static rt_uint16_t _pixel_wc_value(rtgui_color_t *c)
+{
+    if (_pixel_wc.pixel_format == RTGRAPHIC_PIXEL_FORMAT_RGB565P)
+        return rtgui_color_to_565p(*c);
+
+    return rtgui_color_to_565(*c);
+}
+
+static void _pixel_wc_set_pixel(rtgui_color_t *c, int x, int y)
+{
+    rt_uint16_t *line = _pixel_wc_line(x, x + 1, y);
+
+    if (line != RT_NULL)
+        *line = _pixel_wc_value(c);
+    else
+        _pixel_wc.ops->set_pixel(c, x, y);
+}
+
+static void _pixel_wc_get_pixel(rtgui_color_t *c, int x, int y)
+{
+    _pixel_wc_flush();
+    _pixel_wc.ops->get_pixel(c, x, y);
+}
+
+static void _pixel_wc_draw_hline(rtgui_color_t *c, int x1, int x2, int y)
+{
+    int x;
+    rt_uint16_t *line, pixel;
+
+    if (x1 > x2)
+    {
+        x = x1;
+        x1 = x2;
+        x2 = x;
+    }
+
+    line = _pixel_wc_line(x1, x2, y);
+    if (line == RT_NULL)
+    {
+        _pixel_wc.ops->draw_hline(c, x1, x2, y);
+        return;
+    }
+
+    pixel = _pixel_wc_value(c);
+    for (x = x1; x < x2; x ++)
+        *line ++ = pixel;
+}
+
+/* a vline is the rect of width 1 */
+static void _pixel_wc_draw_vline(rtgui_color_t *c, int x, int y1, int y2)
+{
+    int y;
+    rt_uint16_t *line, pixel;
+
+    pixel = _pixel_wc_value(c);
+    for (y = y1; y < y2; y ++)
+    {
+        line = _pixel_wc_line(x, x + 1, y);
+        if (line == RT_NULL)
+        {
+            _pixel_wc.ops->draw_vline(c, x, y, y2);
+            return;
+        }
+        *line = pixel;
+    }
+}
+
+static void _pixel_wc_draw_raw_hline(rt_uint8_t *pixels, int x1, int x2, int y)
+{
+    rt_uint16_t *line;
+
+    if (x1 > x2)
+    {
+        _pixel_wc.ops->draw_raw_hline(pixels, x1, x2, y);
+        return;
+    }
+
+    line = _pixel_wc_line(x1, x2, y);
+    if (line == RT_NULL)
+        _pixel_wc.ops->draw_raw_hline(pixels, x1, x2, y);
+    else
+        rt_memcpy(line, pixels, (x2 - x1) * 2);
+}
+
+static const struct rtgui_graphic_driver_ops _pixel_wc_ops =
+{
+    _pixel_wc_set_pixel,
+    _pixel_wc_get_pixel,
+    _pixel_wc_draw_hline,
+    _pixel_wc_draw_vline,
+    _pixel_wc_draw_raw_hline,
+};
+
+/* the operations combining the writes if the device has blit_rect */
+static const struct rtgui_graphic_driver_ops *_pixel_wc_get_ops(const struct rtgui_graphic_pixel_ops *device_ops,
+                                                                int pixel_format)
+{
+    const struct rtgui_graphic_driver_ops *ops = rtgui_pixel_device_get_ops(pixel_format);
+
+    if (ops == RT_NULL || (pixel_format != RTGRAPHIC_PIXEL_FORMAT_RGB565 &&
+                           pixel_format != RTGRAPHIC_PIXEL_FORMAT_RGB565P))
+        return ops;
+    if (device_ops == RT_NULL || device_ops->blit_rect == RT_NULL)
+        return ops;
+
+    _pixel_wc_flush();
+    _pixel_wc.device_ops = device_ops;
+    _pixel_wc.ops = ops;
+    _pixel_wc.pixel_format = pixel_format;
+
+    return &_pixel_wc_ops;
+}
+#endif
+
+void rtgui_graphic_driver_flush(const struct rtgui_graphic_driver *driver)
+{
+#ifdef GUIENGINE_USING_PIXEL_WC
+    if (driver->ops == &_pixel_wc_ops)
+        _pixel_wc_flush();
+#endif
+}
+RTM_EXPORT(rtgui_graphic_driver_flush);
+
+#ifdef GUIENGINE_USING_ASYNC_FLUSH
+/* released by the driver in the end of transfer */
+static struct rt_semaphore _flush_sem;
+static rt_bool_t _flush_sem_inited = RT_FALSE;
+
+/*
+ * Start the DMA of pixels to the rect of device, the pixels in the format of
+ * device should not be written before rtgui_graphic_driver_flush_wait. The
+ * previous transfer is waited for, so there is one transfer in flight. The
+ * rect is split in the rows of max_transfer of device caps. It's -RT_ENOSYS
+ * if the device has no DMA, it's rotated or the pixels are not aligned as the
+ * caps, and the pixels should be written in the synchronous way.
+ */
+rt_err_t rtgui_graphic_driver_flush_async(struct rtgui_graphic_driver *driver, const rt_uint8_t *pixels,
+                                          int pitch, const rtgui_rect_t *rect)
+{
+    int w, h, y, rows;
+    rt_err_t result;
+    const struct rtgui_graphic_caps *caps = &driver->caps;
+
+    if (driver->device == RT_NULL || !rtgui_graphic_driver_has_cap(driver, RTGUI_CAP_DMA))
+        return -RT_ENOSYS;
+#ifdef GUIENGINE_USING_ROTATION
+    if (driver->rotation != 0)
+        return -RT_ENOSYS;
+#endif
+    w = rect->x2 - rect->x1;
+    h = rect->y2 - rect->y1;
+    if (w <= 0 || h <= 0)
+        return RT_EOK;
+
+    if (caps->dma_align > 1 && (((rt_ubase_t)pixels | pitch) & (caps->dma_align - 1)) != 0)
+        return -RT_ENOSYS;
+    if (caps->x_align > 1 && (rect->x1 % caps->x_align != 0 || w % caps->x_align != 0))
+        return -RT_ENOSYS;
+    rows = h;
+    if (caps->max_transfer != 0)
+    {
+        rows = caps->max_transfer / (w * _UI_BITBYTES(driver->bits_per_pixel));
+        if (rows < 1)
+            return -RT_ENOSYS;
+    }
+
+    if (_flush_sem_inited == RT_FALSE)
+    {
+        rt_sem_init(&_flush_sem, "flush", 0, RT_IPC_FLAG_FIFO);
+        _flush_sem_inited = RT_TRUE;
+    }
+
+    /* the spans combined are before the transfer */
+    rtgui_graphic_driver_flush(driver);
+
+    RTGUI_TRACE_BEGIN("flush async", w * h);
+    for (y = 0, result = RT_EOK; y < h && result == RT_EOK; y += rows)
+    {
+        if (rows > h - y)
+            rows = h - y;
+
+        rtgui_graphic_driver_flush_wait(driver);
+#ifdef GUIENGINE_USING_CACHE_CLEAN
+        _cache_rows(RT_HW_CACHE_FLUSH, pixels + y * pitch, pitch,
+                    w * _UI_BITBYTES(driver->bits_per_pixel), rows);
+#endif
+        driver->flush_busy = 1;
+        result = driver->pixel_ops->blit_rect_async(pixels + y * pitch, pitch, rect->x1,
+                                                    rect->y1 + y, w, rows);
+        if (result != RT_EOK)
+            driver->flush_busy = 0;
+    }
+    RTGUI_TRACE_END("flush async");
+
+    return result;
+}
+RTM_EXPORT(rtgui_graphic_driver_flush_async);
+
+/* wait for the transfer in flight, the pixels of it can be written then */
+void rtgui_graphic_driver_flush_wait(struct rtgui_graphic_driver *driver)
+{
+    if (driver->flush_busy)
+    {
+        rt_sem_take(&_flush_sem, RT_WAITING_FOREVER);
+        driver->flush_busy = 0;
+    }
+}
+RTM_EXPORT(rtgui_graphic_driver_flush_wait);
+
+void rtgui_graphic_driver_flush_done(void)
+{
+    rt_sem_release(&_flush_sem);
+}
+RTM_EXPORT(rtgui_graphic_driver_flush_done);
+#endif
+
 const struct rtgui_graphic_driver_ops *rtgui_pixel_device_get_ops(int pixel_format)
 {
     switch (pixel_format)
     {
     case RTGRAPHIC_PIXEL_FORMAT_MONO:
-        return &_pixel_mono_ops;
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_MONO, &_pixel_mono_ops);
 
     case RTGRAPHIC_PIXEL_FORMAT_RGB565:
-        return &_pixel_rgb565_ops;
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565, &_pixel_rgb565_ops);
 
     case RTGRAPHIC_PIXEL_FORMAT_RGB565P:
-        return &_pixel_rgb565p_ops;
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB565P, &_pixel_rgb565p_ops);
 
     case RTGRAPHIC_PIXEL_FORMAT_RGB888:
-        return &_pixel_rgb888_ops;
+        return RTGUI_PIXEL_FORMAT_FUNC(RTGRAPHIC_PIXEL_FORMAT_RGB888, &_pixel_rgb888_ops);
     }
 
     return RT_NULL;
@@ -771,6 +2163,10 @@ void rtgui_cursor_set_position(rt_uint16_t x, rt_uint16_t y)
 {
     rt_uint32_t value;
 
+    /* the cursor plane of display controller */
+    if (rtgui_graphic_driver_overlay_set_position(&_driver, RTGUI_OVERLAY_CURSOR, x, y) == RT_EOK)
+        return;
+
     if (_current_driver->device != RT_NULL)
     {
         value = (x << 16 | y);
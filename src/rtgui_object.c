@@ -24,6 +24,82 @@
 
 #include <rtgui/rtgui_object.h>
 #include <rtgui/rtgui_system.h>
+#include <rtgui/rtgui_app.h>
+
+#ifdef GUIENGINE_USING_ID_HASH
+#if (GUIENGINE_ID_HASH_SIZE & (GUIENGINE_ID_HASH_SIZE - 1)) != 0
+#error "GUIENGINE_ID_HASH_SIZE should be a power of 2"
+#endif
+
+#define _ID_HASH(id)    (((id) ^ ((id) >> 8) ^ ((id) >> 16)) & (GUIENGINE_ID_HASH_SIZE - 1))
+
+/*
+ * The hash is looked up by the other threads (updating the widgets from the
+ * data threads), so the chains are changed with the scheduler locked.
+ */
+static void _rtgui_object_id_unlink(struct rtgui_object *object)
+{
+    rt_enter_critical();
+    if (object->id_pprev != RT_NULL)
+    {
+        *object->id_pprev = object->id_next;
+        if (object->id_next != RT_NULL)
+            object->id_next->id_pprev = object->id_pprev;
+        object->id_next = RT_NULL;
+        object->id_pprev = RT_NULL;
+    }
+    rt_exit_critical();
+}
+
+static void _rtgui_object_id_link(struct rtgui_app *app, struct rtgui_object *object)
+{
+    struct rtgui_object **head = &app->id_hash[_ID_HASH(object->id)];
+
+    rt_enter_critical();
+    object->id_next = *head;
+    if (object->id_next != RT_NULL)
+        object->id_next->id_pprev = &object->id_next;
+    object->id_pprev = head;
+    *head = object;
+    rt_exit_critical();
+}
+
+struct rtgui_object *rtgui_object_id_lookup(struct rtgui_app *app, rt_uint32_t id)
+{
+    struct rtgui_object *object;
+
+    rt_enter_critical();
+    for (object = app->id_hash[_ID_HASH(id)]; object != RT_NULL; object = object->id_next)
+    {
+        if (object->id == id)
+            break;
+    }
+    rt_exit_critical();
+
+    return object;
+}
+RTM_EXPORT(rtgui_object_id_lookup);
+
+/* the objects still in the hash are not linked to the app destroyed */
+void rtgui_object_id_hash_fini(struct rtgui_app *app)
+{
+    int index;
+    struct rtgui_object *object;
+
+    rt_enter_critical();
+    for (index = 0; index < GUIENGINE_ID_HASH_SIZE; index ++)
+    {
+        while ((object = app->id_hash[index]) != RT_NULL)
+        {
+            app->id_hash[index] = object->id_next;
+            object->id_next = RT_NULL;
+            object->id_pprev = RT_NULL;
+        }
+    }
+    rt_exit_critical();
+}
+RTM_EXPORT(rtgui_object_id_hash_fini);
+#endif
 
 static void _rtgui_object_constructor(rtgui_object_t *object)
 {
@@ -31,7 +107,12 @@ static void _rtgui_object_constructor(rtgui_object_t *object)
         return;
 
     object->flag = RTGUI_OBJECT_FLAG_VALID;
+    object->event_mask = RTGUI_EVENT_MASK_ALL;
     object->id   = (rt_uint32_t)object;
+#ifdef GUIENGINE_USING_ID_HASH
+    object->id_next  = RT_NULL;
+    object->id_pprev = RT_NULL;
+#endif
 }
 
 /* Destroys the object */
@@ -42,6 +123,9 @@ static void _rtgui_object_destructor(rtgui_object_t *object)
      * object and thus the flag will become valid. */
     object->flag = RTGUI_OBJECT_FLAG_NONE;
     object->type = RT_NULL;
+#ifdef GUIENGINE_USING_ID_HASH
+    _rtgui_object_id_unlink(object);
+#endif
 }
 
 DEFINE_CLASS_TYPE(object, "object",
@@ -122,7 +206,22 @@ rtgui_object_t *rtgui_object_create(const rtgui_type_t *object_type)
     if (!object_type)
         return RT_NULL;
 
-    new_object = rtgui_malloc(object_type->size);
+    new_object = RT_NULL;
+    if (object_type->pool != RT_NULL)
+    {
+        struct rtgui_object_pool *pool = object_type->pool;
+
+        rt_enter_critical();
+        if (pool->idle != RT_NULL)
+        {
+            new_object = (rtgui_object_t *)pool->idle;
+            pool->idle = *(void **)new_object;
+            pool->count --;
+        }
+        rt_exit_critical();
+    }
+    if (new_object == RT_NULL)
+        new_object = rtgui_malloc(object_type->size);
     if (new_object == RT_NULL) return RT_NULL;
 
 #ifdef RTGUI_OBJECT_TRACE
@@ -161,11 +260,49 @@ void rtgui_object_destroy(rtgui_object_t *object)
     RT_ASSERT(object->type != RT_NULL);
     rtgui_type_destructors_call(object->type, object);
 
+    /* keep object in the pool of type */
+    if (object->type->pool != RT_NULL)
+    {
+        struct rtgui_object_pool *pool = object->type->pool;
+
+        rt_enter_critical();
+        if (pool->count < pool->max)
+        {
+            *(void **)object = pool->idle;
+            pool->idle = object;
+            pool->count ++;
+            object = RT_NULL;
+        }
+        rt_exit_critical();
+    }
+
     /* release object */
-    rtgui_free(object);
+    if (object != RT_NULL)
+        rtgui_free(object);
 }
 RTM_EXPORT(rtgui_object_destroy);
 
+void rtgui_type_pool_shrink(const rtgui_type_t *type)
+{
+    void *idle, *next;
+
+    if (type == RT_NULL || type->pool == RT_NULL)
+        return;
+
+    rt_enter_critical();
+    idle = type->pool->idle;
+    type->pool->idle = RT_NULL;
+    type->pool->count = 0;
+    rt_exit_critical();
+
+    for (; idle != RT_NULL; idle = next)
+    {
+        next = *(void **)idle;
+        rtgui_free(idle);
+    }
+}
+RTM_EXPORT(rtgui_type_pool_shrink);
+
 /**
  * @brief Checks if the object can be cast to the specified type.
  *
@@ -213,6 +350,14 @@ void rtgui_object_set_event_handler(struct rtgui_object *object, rtgui_event_han
 }
 RTM_EXPORT(rtgui_object_set_event_handler);
 
+void rtgui_object_set_event_mask(struct rtgui_object *object, rt_uint64_t mask)
+{
+    RT_ASSERT(object != RT_NULL);
+
+    object->event_mask = mask;
+}
+RTM_EXPORT(rtgui_object_set_event_mask);
+
 rt_bool_t rtgui_object_event_handler(struct rtgui_object *object, struct rtgui_event *event)
 {
     return RT_FALSE;
@@ -221,12 +366,24 @@ RTM_EXPORT(rtgui_object_event_handler);
 
 void rtgui_object_set_id(struct rtgui_object *object, rt_uint32_t id)
 {
+#ifdef GUIENGINE_USING_ID_HASH
+    struct rtgui_app *app;
+#endif
 #ifdef RTGUI_USING_ID_CHECK
     struct rtgui_object *obj = rtgui_get_self_object(id);
     RT_ASSERT(!obj);
 #endif
+#ifdef GUIENGINE_USING_ID_HASH
+    _rtgui_object_id_unlink(object);
+    object->id = id;
 
+    /* the object is of the app setting its id */
+    app = rtgui_app_self();
+    if (app != RT_NULL)
+        _rtgui_object_id_link(app, object);
+#else
     object->id = id;
+#endif
 }
 RTM_EXPORT(rtgui_object_set_id);
 
@@ -30,16 +30,14 @@
 #include <rtgui/rtgui_app.h>
 #include <rtgui/rtgui_server.h>
 #include <rtgui/rtgui_system.h>
+#include <rtgui/profile.h>
+#include <rtgui/snapshot.h>
 #include <rtgui/widgets/window.h>
 
 #ifdef GUIENGINE_USING_TTF
 #include <rtgui/font_freetype.h>
 #endif
 
-#ifdef _WIN32_NATIVE
-#define RTGUI_MEM_TRACE
-#endif
-
 const rtgui_color_t default_foreground = RTGUI_RGB(0x00, 0x00, 0x00);
 const rtgui_color_t default_background = RTGUI_RGB(212, 208, 200);
 
@@ -48,19 +46,54 @@ extern struct rtgui_font rtgui_font_asc12;
 
 static rtgui_rect_t _mainwin_rect;
 static struct rt_mutex _screen_lock;
+#ifdef GUIENGINE_USING_RECT_LOCK
+/* the threads waiting the locked rects */
+static struct rt_semaphore _screen_wait;
+#endif
 
 int rtgui_system_server_init(void)
 {
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_SERVER_INIT);
     rt_mutex_init(&_screen_lock, "screen", RT_IPC_FLAG_FIFO);
+#ifdef GUIENGINE_USING_RECT_LOCK
+    rt_sem_init(&_screen_wait, "screen", 0, RT_IPC_FLAG_FIFO);
+#endif
+#ifdef GUIENGINE_USING_BOOT_SNAPSHOT
+    /* the last home screen is on panel before the init */
+    rtgui_snapshot_show(GUIENGINE_BOOT_SNAPSHOT_FILE);
+#endif
+#ifdef GUIENGINE_USING_COVERAGE_GAMMA
+    rtgui_color_set_coverage_gamma(GUIENGINE_COVERAGE_GAMMA);
+#endif
 
-    /* init image */
+#ifndef GUIENGINE_USING_LAZY_INIT
+    /* init image, or at the first image created */
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_IMAGE_INIT);
     rtgui_system_image_init();
+    RTGUI_BOOT_END(RTGUI_BOOT_IMAGE_INIT);
+#endif
+#ifdef GUIENGINE_USING_SHAPE_CACHE
+    /* before the fonts, the texts of a font removed are dropped from the cache */
+    rtgui_dc_shape_init();
+#endif
     /* init font */
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_FONT_INIT);
     rtgui_font_system_init();
+    RTGUI_BOOT_END(RTGUI_BOOT_FONT_INIT);
+#ifdef GUIENGINE_USING_PARALLEL_RENDER
+    /* init the workers of parallel rendering */
+    rtgui_dc_render_init();
+#endif
+#ifdef GUIENGINE_USING_APP_POOL
+    /* the app threads and runtimes ready for rtgui_app_launch */
+    rtgui_app_pool_init();
+#endif
 
     /* init rtgui server */
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_SERVER_START);
     rtgui_topwin_init();
     rtgui_server_init();
+    RTGUI_BOOT_END(RTGUI_BOOT_SERVER_START);
 
     /* use driver rect for main window */
     rtgui_graphic_driver_get_rect(rtgui_graphic_driver_get_default(), &_mainwin_rect);
@@ -75,8 +108,11 @@ int rtgui_system_server_init(void)
 #endif
 
 #ifdef GUIENGINE_USING_TTF
+    RTGUI_BOOT_BEGIN(RTGUI_BOOT_TTF_INIT);
     rtgui_ttf_system_init();
+    RTGUI_BOOT_END(RTGUI_BOOT_TTF_INIT);
 #endif
+    RTGUI_BOOT_END(RTGUI_BOOT_SERVER_INIT);
 
     return 0;
 }
@@ -85,46 +121,170 @@ INIT_APP_EXPORT(rtgui_system_server_init);
 /************************************************************************/
 /* RTGUI Timer                                                          */
 /************************************************************************/
+/*
+ * The running timers of an app are kept in a list sorted by the deadline, and
+ * one rt-thread timer of app is set to the earliest deadline. It posts only
+ * one RTGUI_EVENT_TIMER until the app handles it, then the app runs all the
+ * expired timers. The rt-thread timer is stopped if there is no running
+ * timer, so an idle app does not wake up the system.
+ *
+ * The event may be lost, consumed by a custom loop of rtgui_recv. So while it
+ * is pending, the rt-thread timer is re-armed in the period of the earliest
+ * timer, and the event is posted again if it's not handled by then.
+ */
+#define _TIMER_BEFORE(a, b)     ((rt_int32_t)((a) - (b)) < 0)
+
 static void rtgui_time_out(void *parameter)
 {
     rt_err_t result;
-    rtgui_timer_t *timer;
+    struct rtgui_app *app;
     rtgui_event_timer_t event;
-    timer = (rtgui_timer_t *)parameter;
 
-    if (!(timer->state == RTGUI_TIMER_ST_RUNNING))
-        return;
+    app = (struct rtgui_app *)parameter;
     /*
     * Note: event_timer can not use RTGUI_EVENT_TIMER_INIT to init, for there is no
     * thread context
     */
     event.parent.type = RTGUI_EVENT_TIMER;
+    event.parent.user = 0;
     event.parent.sender = RT_NULL;
+    event.parent.ack = RT_NULL;
+    RTGUI_EVENT_STAMP_INIT(&(event.parent));
+    event.timer = RT_NULL;
 
-    event.timer = timer;
-    timer->pending_cnt++;
+    app->timer_pending = 1;
+    result = rtgui_send(app, &(event.parent), sizeof(rtgui_event_timer_t));
+    if (result != RT_EOK)
+    {
+        rt_tick_t tick = 1;
 
-    result = rtgui_send(timer->app, &(event.parent), sizeof(rtgui_event_timer_t));
-    if (result == RT_EOK)
+        /* the queue is full, try again in the next tick */
+        app->timer_pending = 0;
+        rt_timer_control(&app->timer, RT_TIMER_CTRL_SET_TIME, &tick);
+        rt_timer_start(&app->timer);
+    }
+    else
+    {
+        rt_tick_t tick = app->timer_watchdog;
+
+        /* the watchdog of the event, stopped by rtgui_timer_expire */
+        rt_timer_control(&app->timer, RT_TIMER_CTRL_SET_TIME, &tick);
+        rt_timer_start(&app->timer);
+    }
+}
+
+void rtgui_timer_app_init(struct rtgui_app *app, const char *name)
+{
+    rt_timer_init(&app->timer, name, rtgui_time_out, app, 1, RT_TIMER_FLAG_ONE_SHOT);
+}
+
+/* set the rt-thread timer of app to the earliest deadline */
+static void _rtgui_timer_schedule(struct rtgui_app *app)
+{
+    rt_tick_t tick;
+    rtgui_timer_t *first;
+
+    /* the timers will be scheduled after the pending event handled, the
+     * watchdog of the event keeps running */
+    if (app->timer_pending)
+        return;
+
+    rt_timer_stop(&app->timer);
+    if (rt_list_isempty(&app->timer_list))
+        return;
+
+    first = rt_list_entry(app->timer_list.next, rtgui_timer_t, list);
+    app->timer_watchdog = first->period;
+    tick = first->deadline - rt_tick_get();
+    if ((rt_int32_t)tick <= 0) tick = 1;
+
+    rt_timer_control(&app->timer, RT_TIMER_CTRL_SET_TIME, &tick);
+    rt_timer_start(&app->timer);
+}
+
+static void _rtgui_timer_insert(rtgui_timer_t *timer)
+{
+    rt_list_t *node;
+    rtgui_timer_t *item;
+
+    rt_list_for_each(node, &timer->app->timer_list)
+    {
+        item = rt_list_entry(node, rtgui_timer_t, list);
+        if (_TIMER_BEFORE(timer->deadline, item->deadline))
+            break;
+    }
+    rt_list_insert_before(node, &timer->list);
+}
+
+void rtgui_timer_expire(struct rtgui_app *app)
+{
+    rt_tick_t now;
+    rtgui_timer_t *timer;
+
+    app->timer_pending = 0;
+
+    now = rt_tick_get();
+    while (1)
     {
-        timer->pending_cnt++;
+        rt_enter_critical();
+        if (rt_list_isempty(&app->timer_list))
+        {
+            rt_exit_critical();
+            break;
+        }
+
+        timer = rt_list_entry(app->timer_list.next, rtgui_timer_t, list);
+        if (_TIMER_BEFORE(now, timer->deadline))
+        {
+            rt_exit_critical();
+            break;
+        }
+
+        /* re-insert the periodic timer before the timeout function, which may
+         * stop or destroy it. The expiries missed are coalesced. */
+        rt_list_remove(&timer->list);
+        if (timer->flag & RT_TIMER_FLAG_PERIODIC)
+        {
+            timer->deadline += timer->period;
+            if (!_TIMER_BEFORE(now, timer->deadline))
+                timer->deadline = now + timer->period;
+            _rtgui_timer_insert(timer);
+        }
+        else
+        {
+            rt_list_init(&timer->list);
+            timer->state = RTGUI_TIMER_ST_INIT;
+        }
+        rt_exit_critical();
+
+        if (timer->timeout != RT_NULL)
+            timer->timeout(timer, timer->user_data);
     }
+
+    rt_enter_critical();
+    _rtgui_timer_schedule(app);
+    rt_exit_critical();
 }
+RTM_EXPORT(rtgui_timer_expire);
 
 rtgui_timer_t *rtgui_timer_create(rt_int32_t time, rt_int32_t flag, rtgui_timeout_func timeout, void *parameter)
 {
     rtgui_timer_t *timer;
 
     timer = (rtgui_timer_t *) rtgui_malloc(sizeof(rtgui_timer_t));
+    if (timer == RT_NULL)
+        return RT_NULL;
+
     timer->app = rtgui_app_self();
+    RT_ASSERT(timer->app != RT_NULL);
+    rt_list_init(&timer->list);
+    timer->deadline = 0;
+    timer->period = time > 0 ? time : 1;
+    timer->flag = (rt_uint8_t)flag;
     timer->timeout = timeout;
-    timer->pending_cnt = 0;
     timer->state = RTGUI_TIMER_ST_INIT;
     timer->user_data = parameter;
 
-    /* init rt-thread timer */
-    rt_timer_init(&(timer->timer), "rtgui", rtgui_time_out, timer, time, (rt_uint8_t)flag);
-
     return timer;
 }
 RTM_EXPORT(rtgui_timer_create);
@@ -133,18 +293,9 @@ void rtgui_timer_destory(rtgui_timer_t *timer)
 {
     RT_ASSERT(timer != RT_NULL);
 
-    /* stop timer firstly */
+    /* no event references the timer, it is freed at once */
     rtgui_timer_stop(timer);
-    if (timer->pending_cnt != 0 && timer->app->ref_count != 0)
-    {
-        timer->state = RTGUI_TIMER_ST_DESTROY_PENDING;
-    }
-    else
-    {
-        /* detach rt-thread timer */
-        rt_timer_detach(&(timer->timer));
-        rtgui_free(timer);
-    }
+    rtgui_free(timer);
 }
 RTM_EXPORT(rtgui_timer_destory);
 
@@ -152,17 +303,12 @@ void rtgui_timer_set_timeout(rtgui_timer_t *timer, rt_int32_t time)
 {
     RT_ASSERT(timer != RT_NULL);
 
-    /* start rt-thread timer */
+    timer->period = time > 0 ? time : 1;
     if (timer->state == RTGUI_TIMER_ST_RUNNING)
     {
         rtgui_timer_stop(timer);
-        rt_timer_control(&timer->timer, RT_TIMER_CTRL_SET_TIME, &time);
         rtgui_timer_start(timer);
     }
-    else
-    {
-        rt_timer_control(&timer->timer, RT_TIMER_CTRL_SET_TIME, &time);
-    }
 }
 RTM_EXPORT(rtgui_timer_set_timeout);
 
@@ -170,9 +316,15 @@ void rtgui_timer_start(rtgui_timer_t *timer)
 {
     RT_ASSERT(timer != RT_NULL);
 
-    /* start rt-thread timer */
+    rt_enter_critical();
+    if (timer->state == RTGUI_TIMER_ST_RUNNING)
+        rt_list_remove(&timer->list);
+
     timer->state = RTGUI_TIMER_ST_RUNNING;
-    rt_timer_start(&(timer->timer));
+    timer->deadline = rt_tick_get() + timer->period;
+    _rtgui_timer_insert(timer);
+    _rtgui_timer_schedule(timer->app);
+    rt_exit_critical();
 }
 RTM_EXPORT(rtgui_timer_start);
 
@@ -180,15 +332,30 @@ void rtgui_timer_stop(rtgui_timer_t *timer)
 {
     RT_ASSERT(timer != RT_NULL);
 
-    /* stop rt-thread timer */
+    rt_enter_critical();
+    if (timer->state == RTGUI_TIMER_ST_RUNNING)
+    {
+        rt_list_remove(&timer->list);
+        _rtgui_timer_schedule(timer->app);
+    }
     timer->state = RTGUI_TIMER_ST_INIT;
-    rt_timer_stop(&(timer->timer));
+    rt_exit_critical();
 }
 RTM_EXPORT(rtgui_timer_stop);
 
 /************************************************************************/
 /* RTGUI Memory Management                                              */
 /************************************************************************/
+/* the caller of memory functions */
+#if defined(__GNUC__) || defined(__CC_ARM) || defined(__clang__)
+#define MEMTRACE_CALLER()   __builtin_return_address(0)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define MEMTRACE_CALLER()   _ReturnAddress()
+#else
+#define MEMTRACE_CALLER()   RT_NULL
+#endif
+
 #ifdef RTGUI_MEM_TRACE
 struct rtgui_mem_info
 {
@@ -197,19 +364,54 @@ struct rtgui_mem_info
 };
 struct rtgui_mem_info mem_info;
 
-#define MEMTRACE_MAX        4096
-#define MEMTRACE_HASH_SIZE  256
+#define MEMTRACE_HASH_SIZE  (1 << GUIENGINE_MEMTRACE_HASH_BITS)
 
 struct rti_memtrace_item
 {
     void       *mb_ptr;     /* memory block pointer */
     rt_uint32_t mb_len;     /* memory block length */
+    rt_uint16_t site;       /* the caller allocated it */
+    rt_uint8_t  app;        /* the app allocated it */
+    rt_uint8_t  tag;        /* the subsystem allocated it */
 
     struct rti_memtrace_item *next;
 };
-struct rti_memtrace_item trace_list[MEMTRACE_MAX];
-struct rti_memtrace_item *item_hash[MEMTRACE_HASH_SIZE];
-struct rti_memtrace_item *item_free;
+
+struct rti_memtrace_stat
+{
+    rt_uint32_t live;       /* the bytes in use */
+    rt_uint32_t max;        /* the high-water mark of live */
+    rt_uint32_t blocks;     /* the blocks in use */
+};
+
+/* the first site and app are for the ones out of table */
+struct rti_memtrace_site
+{
+    void *caller;
+    rt_uint8_t tag;
+    struct rti_memtrace_stat stat;
+};
+
+struct rti_memtrace_app
+{
+    struct rtgui_app *app;
+    char name[GUIENGINE_NAME_MAX];
+    struct rti_memtrace_stat stat;
+};
+
+static struct rti_memtrace_item trace_list[GUIENGINE_MEMTRACE_MAX];
+static struct rti_memtrace_item *item_hash[MEMTRACE_HASH_SIZE];
+static struct rti_memtrace_item *item_free;
+static struct rti_memtrace_site trace_sites[GUIENGINE_MEMTRACE_SITES];
+static struct rti_memtrace_app trace_apps[GUIENGINE_MEMTRACE_APPS];
+static struct rti_memtrace_stat trace_tags[RTGUI_MEM_TAG_MAX];
+/* the blocks not traced for the items are run out */
+static rt_uint32_t trace_lost;
+
+static const char *trace_tag_name[RTGUI_MEM_TAG_MAX] =
+{
+    "generic", "region", "font", "image", "dc", "event", "dma",
+};
 
 rt_bool_t rti_memtrace_inited = 0;
 void rti_memtrace_init()
@@ -223,7 +425,7 @@ void rti_memtrace_init()
     item_free = &trace_list[0];
     item = &trace_list[0];
 
-    for (index = 1; index < MEMTRACE_HASH_SIZE; index ++)
+    for (index = 1; index < GUIENGINE_MEMTRACE_MAX; index ++)
     {
         item->next = &trace_list[index];
         item = item->next;
@@ -232,100 +434,296 @@ void rti_memtrace_init()
     item->next = RT_NULL;
 }
 
-void rti_malloc_hook(void *ptr, rt_uint32_t len)
+rt_inline rt_uint32_t rti_memtrace_hash(void *ptr)
+{
+    /* the low bits of the aligned blocks are always 0 */
+    return ((rt_uint32_t)((rt_ubase_t)ptr >> 3) * 2654435761u) >> (32 - GUIENGINE_MEMTRACE_HASH_BITS);
+}
+
+rt_inline void rti_memtrace_stat_add(struct rti_memtrace_stat *stat, rt_uint32_t len)
+{
+    stat->live += len;
+    stat->blocks ++;
+    if (stat->max < stat->live)
+        stat->max = stat->live;
+}
+
+rt_inline void rti_memtrace_stat_sub(struct rti_memtrace_stat *stat, rt_uint32_t len)
+{
+    stat->live -= len;
+    stat->blocks --;
+}
+
+static rt_uint16_t rti_memtrace_site(void *caller, rt_uint8_t tag)
+{
+    rt_uint16_t index;
+
+    for (index = 1; index < GUIENGINE_MEMTRACE_SITES; index ++)
+    {
+        if (trace_sites[index].caller == RT_NULL)
+        {
+            trace_sites[index].caller = caller;
+            trace_sites[index].tag = tag;
+            return index;
+        }
+
+        if (trace_sites[index].caller == caller && trace_sites[index].tag == tag)
+            return index;
+    }
+
+    return 0;
+}
+
+static rt_uint8_t rti_memtrace_app(void)
+{
+    rt_uint8_t index, spare = 0;
+    struct rtgui_app *app = rtgui_app_self();
+
+    if (app == RT_NULL)
+        return 0;
+
+    for (index = 1; index < GUIENGINE_MEMTRACE_APPS; index ++)
+    {
+        if (trace_apps[index].app == app)
+            return index;
+
+        /* reuse the record of an app freed all the memory */
+        if (spare == 0 && (trace_apps[index].app == RT_NULL || trace_apps[index].stat.blocks == 0))
+            spare = index;
+    }
+
+    if (spare != 0)
+    {
+        rt_memset(&trace_apps[spare], 0, sizeof(trace_apps[spare]));
+        trace_apps[spare].app = app;
+        if (app->name != RT_NULL)
+            rt_strncpy(trace_apps[spare].name, (char *)app->name, sizeof(trace_apps[spare].name) - 1);
+    }
+
+    return spare;
+}
+
+void rti_malloc_hook(void *ptr, rt_uint32_t len, int tag, void *caller)
 {
     rt_uint32_t index;
     struct rti_memtrace_item *item;
 
-    if (item_free == RT_NULL) return;
+    rtgui_enter_critical();
+    if (item_free == RT_NULL)
+    {
+        trace_lost ++;
+        rtgui_exit_critical();
+        return;
+    }
 
     mem_info.allocated_size += len;
     if (mem_info.max_allocated < mem_info.allocated_size)
         mem_info.max_allocated = mem_info.allocated_size;
 
-    /* lock context */
     item = item_free;
     item_free = item->next;
 
     item->mb_ptr = ptr;
     item->mb_len = len;
-    item->next   = RT_NULL;
+    item->tag    = tag;
+    item->site   = rti_memtrace_site(caller, tag);
+    item->app    = rti_memtrace_app();
+
+    rti_memtrace_stat_add(&trace_sites[item->site].stat, len);
+    rti_memtrace_stat_add(&trace_apps[item->app].stat, len);
+    rti_memtrace_stat_add(&trace_tags[tag], len);
+
+    /* add to the list of hash */
+    index = rti_memtrace_hash(ptr);
+    item->next = item_hash[index];
+    item_hash[index] = item;
+    rtgui_exit_critical();
+}
 
-    /* get hash item index */
-    index = ((rt_uint32_t)ptr) % MEMTRACE_HASH_SIZE;
-    if (item_hash[index] != RT_NULL)
+/* returns the length of block, 0 if it's not traced */
+rt_uint32_t rti_free_hook(void *ptr)
+{
+    rt_uint32_t len;
+    struct rti_memtrace_item **link, *item;
+
+    rtgui_enter_critical();
+    /* find ptr in the list of hash */
+    link = &item_hash[rti_memtrace_hash(ptr)];
+    while (*link != RT_NULL && (*link)->mb_ptr != ptr)
+        link = &(*link)->next;
+
+    item = *link;
+    if (item == RT_NULL)
     {
-        /* add to list */
-        item->next = item_hash[index];
-        item_hash[index] = item;
+        /* not found */
+        rtgui_exit_critical();
+        return 0;
     }
-    else
+    *link = item->next;
+
+    /* reduce allocated size */
+    len = item->mb_len;
+    mem_info.allocated_size -= len;
+    rti_memtrace_stat_sub(&trace_sites[item->site].stat, len);
+    rti_memtrace_stat_sub(&trace_apps[item->app].stat, len);
+    rti_memtrace_stat_sub(&trace_tags[item->tag], len);
+
+    /* clear item */
+    rt_memset(item, 0, sizeof(struct rti_memtrace_item));
+
+    /* add item to the free list */
+    item->next = item_free;
+    item_free = item;
+    rtgui_exit_critical();
+
+    return len;
+}
+
+void rtgui_mem_get_stat(int tag, rt_uint32_t *live, rt_uint32_t *blocks)
+{
+    int index;
+
+    RT_ASSERT(tag >= 0 && tag <= RTGUI_MEM_TAG_MAX);
+
+    *live = *blocks = 0;
+    rtgui_enter_critical();
+    for (index = 0; index < RTGUI_MEM_TAG_MAX; index ++)
     {
-        /* set list header */
-        item_hash[index] = item;
+        if (tag == RTGUI_MEM_TAG_MAX || tag == index)
+        {
+            *live += trace_tags[index].live;
+            *blocks += trace_tags[index].blocks;
+        }
     }
-    /* unlock context */
+    rtgui_exit_critical();
 }
+RTM_EXPORT(rtgui_mem_get_stat);
+#endif
+
+//#define DEBUG_MEMLEAK
+
+#ifdef GUIENGINE_USING_MEM_REGION
+/* the region of each tag, and all of the regions set */
+static struct rtgui_mem_region *_mem_tag_region[RTGUI_MEM_TAG_MAX];
+static struct rtgui_mem_region *_mem_regions = RT_NULL;
 
-void rti_free_hook(void *ptr)
+void rtgui_mem_set_region(int tag, struct rtgui_mem_region *region)
 {
-    rt_uint32_t index;
-    struct rti_memtrace_item *item;
+    struct rtgui_mem_region *node;
 
-    /* get hash item index */
-    index = ((rt_uint32_t)ptr) % MEMTRACE_HASH_SIZE;
-    if (item_hash[index] != RT_NULL)
+    RT_ASSERT(tag >= 0 && tag < RTGUI_MEM_TAG_MAX);
+
+    rtgui_enter_critical();
+    if (region != RT_NULL)
     {
-        item = item_hash[index];
-        if (item->mb_ptr == ptr)
+        for (node = _mem_regions; node != RT_NULL && node != region; node = node->next);
+        if (node == RT_NULL)
         {
-            /* delete item from list */
-            item_hash[index] = item->next;
+            region->next = _mem_regions;
+            _mem_regions = region;
         }
-        else
-        {
-            /* find ptr in list */
-            while (item->next != RT_NULL && item->next->mb_ptr != ptr)
-                item = item->next;
+    }
+    _mem_tag_region[tag] = region;
+    rtgui_exit_critical();
+}
+RTM_EXPORT(rtgui_mem_set_region);
 
-            /* delete item from list */
-            if (item->next != RT_NULL)
-            {
-                struct rti_memtrace_item *i;
+/* the region of ptr, RT_NULL if it's in the system heap */
+static struct rtgui_mem_region *_rtgui_mem_region_of(void *ptr)
+{
+    struct rtgui_mem_region *region;
 
-                i = item->next;
-                item->next = item->next->next;
+    for (region = _mem_regions; region != RT_NULL; region = region->next)
+    {
+        if ((rt_uint8_t *)ptr >= (rt_uint8_t *)region->start &&
+                (rt_uint8_t *)ptr < (rt_uint8_t *)region->start + region->size)
+            return region;
+    }
 
-                item = i;
-            }
-            else
-            {
-                /* not found */
-                return;
-            }
-        }
+    return RT_NULL;
+}
 
-        /* reduce allocated size */
-        mem_info.allocated_size -= item->mb_len;
+static void *_rtgui_mem_malloc(rt_size_t size, int tag)
+{
+    void *ptr = RT_NULL;
+    struct rtgui_mem_region *region = _mem_tag_region[tag];
 
-        /* clear item */
-        rt_memset(item, 0, sizeof(struct rti_memtrace_item));
+    if (region != RT_NULL)
+        ptr = region->malloc(region, size);
+    if (ptr == RT_NULL)
+        ptr = rt_malloc(size);
 
-        /* add item to the free list */
-        item->next = item_free;
-        item_free = item;
-    }
+    return ptr;
 }
-#endif
 
-//#define DEBUG_MEMLEAK
+static void *_rtgui_mem_realloc(void *ptr, rt_size_t size, int tag)
+{
+    struct rtgui_mem_region *region;
 
-#undef rtgui_malloc
-void *rtgui_malloc(rt_size_t size)
+    if (ptr == RT_NULL)
+        return _rtgui_mem_malloc(size, tag);
+
+    region = _rtgui_mem_region_of(ptr);
+    if (region != RT_NULL)
+        return region->realloc(region, ptr, size);
+
+    return rt_realloc(ptr, size);
+}
+
+static void _rtgui_mem_free(void *ptr)
+{
+    struct rtgui_mem_region *region;
+
+    if (ptr == RT_NULL)
+        return;
+
+    region = _rtgui_mem_region_of(ptr);
+    if (region != RT_NULL)
+        region->free(region, ptr);
+    else
+        rt_free(ptr);
+}
+
+#ifdef RT_USING_MEMHEAP
+static void *_rtgui_memheap_malloc(struct rtgui_mem_region *region, rt_size_t size)
+{
+    return rt_memheap_alloc((struct rt_memheap *)region->user_data, size);
+}
+
+static void *_rtgui_memheap_realloc(struct rtgui_mem_region *region, void *ptr, rt_size_t size)
+{
+    return rt_memheap_realloc((struct rt_memheap *)region->user_data, ptr, size);
+}
+
+static void _rtgui_memheap_free(struct rtgui_mem_region *region, void *ptr)
+{
+    rt_memheap_free(ptr);
+}
+
+void rtgui_mem_region_init_memheap(struct rtgui_mem_region *region, struct rt_memheap *heap)
+{
+    region->name = heap->parent.name;
+    region->start = heap->start_addr;
+    region->size = heap->pool_size;
+    region->malloc = _rtgui_memheap_malloc;
+    region->realloc = _rtgui_memheap_realloc;
+    region->free = _rtgui_memheap_free;
+    region->user_data = heap;
+    region->next = RT_NULL;
+}
+RTM_EXPORT(rtgui_mem_region_init_memheap);
+#endif
+#else
+#define _rtgui_mem_malloc(size, tag)        rt_malloc(size)
+#define _rtgui_mem_realloc(ptr, size, tag)  rt_realloc((ptr), (size))
+#define _rtgui_mem_free(ptr)                rt_free(ptr)
+#endif
+
+rt_inline void *_rtgui_malloc(rt_size_t size, int tag, void *caller)
 {
     void *ptr;
 
-    ptr = rt_malloc(size);
+    ptr = _rtgui_mem_malloc(size, tag);
 #ifdef RTGUI_MEM_TRACE
     if (rti_memtrace_inited == 0)
     {
@@ -334,68 +732,148 @@ void *rtgui_malloc(rt_size_t size)
     }
 
     if (ptr != RT_NULL)
-        rti_malloc_hook(ptr, size);
+        rti_malloc_hook(ptr, size, tag, caller);
 #endif
 
 #ifdef DEBUG_MEMLEAK
     rt_kprintf("alloc %p (%d) on %p %.*s\n",
-               ptr, size, __builtin_return_address(0),
+               ptr, size, caller,
                RT_NAME_MAX, rt_thread_self()->name);
 #endif
 
     return ptr;
 }
-RTM_EXPORT(rtgui_malloc);
 
-#undef rtgui_realloc
-void *rtgui_realloc(void *ptr, rt_size_t size)
+rt_inline void *_rtgui_realloc(void *ptr, rt_size_t size, int tag, void *caller)
 {
     void *new_ptr;
-
 #ifdef RTGUI_MEM_TRACE
-    new_ptr = rtgui_malloc(size);
-    if ((new_ptr != RT_NULL) && (ptr != RT_NULL))
+    rt_uint32_t len = 0;
+
+    if (ptr != RT_NULL)
+        len = rti_free_hook(ptr);
+    new_ptr = _rtgui_mem_realloc(ptr, size, tag);
+    if (new_ptr != RT_NULL)
+        rti_malloc_hook(new_ptr, size, tag, caller);
+    else if (ptr != RT_NULL && size != 0 && len != 0)
     {
-        memcpy(new_ptr, ptr, size);
-        rtgui_free(ptr);
+        /* the block is kept on failure */
+        rti_malloc_hook(ptr, len, tag, caller);
     }
 #else
-    new_ptr = rt_realloc(ptr, size);
+    new_ptr = _rtgui_mem_realloc(ptr, size, tag);
 #endif
 
 #ifdef DEBUG_MEMLEAK
     rt_kprintf("realloc %p to %p (%d) on %p %*.s\n",
-               ptr, new_ptr, size, __builtin_return_address(0),
+               ptr, new_ptr, size, caller,
                RT_NAME_MAX, rt_thread_self()->name);
 #endif
 
     return new_ptr;
 }
+
+#undef rtgui_malloc
+void *rtgui_malloc(rt_size_t size)
+{
+    return _rtgui_malloc(size, RTGUI_MEM_GENERIC, MEMTRACE_CALLER());
+}
+RTM_EXPORT(rtgui_malloc);
+
+#undef rtgui_realloc
+void *rtgui_realloc(void *ptr, rt_size_t size)
+{
+    return _rtgui_realloc(ptr, size, RTGUI_MEM_GENERIC, MEMTRACE_CALLER());
+}
 RTM_EXPORT(rtgui_realloc);
 
+void *rtgui_malloc_tag(rt_size_t size, int tag)
+{
+    return _rtgui_malloc(size, tag, MEMTRACE_CALLER());
+}
+RTM_EXPORT(rtgui_malloc_tag);
+
+void *rtgui_realloc_tag(void *ptr, rt_size_t size, int tag)
+{
+    return _rtgui_realloc(ptr, size, tag, MEMTRACE_CALLER());
+}
+RTM_EXPORT(rtgui_realloc_tag);
+
 #undef rtgui_free
 void rtgui_free(void *ptr)
 {
 #ifdef DEBUG_MEMLEAK
     rt_kprintf("dealloc %p on %p\n",
-               ptr, __builtin_return_address(0));
+               ptr, MEMTRACE_CALLER());
 #endif
 #ifdef RTGUI_MEM_TRACE
     if (ptr != RT_NULL)
         rti_free_hook(ptr);
 #endif
 
-    rt_free(ptr);
+    _rtgui_mem_free(ptr);
 }
 RTM_EXPORT(rtgui_free);
 
 #if defined(RTGUI_MEM_TRACE) && defined(RT_USING_FINSH)
 #include <finsh.h>
+static void _memtrace_dump_stat(const char *name, struct rti_memtrace_stat *stat)
+{
+    rt_kprintf("  %-16s %8d %8d %6d\n", name, stat->live, stat->max, stat->blocks);
+}
+
 void list_guimem(void)
 {
+    int index, pos;
+    rt_uint16_t order[GUIENGINE_MEMTRACE_SITES];
+    rt_uint16_t count = 0;
+
     rt_kprintf("Current Used: %d, Maximal Used: %d\n", mem_info.allocated_size, mem_info.max_allocated);
+    if (trace_lost)
+        rt_kprintf("%d blocks not traced, enlarge GUIENGINE_MEMTRACE_MAX\n", trace_lost);
+
+    rt_kprintf("  %-16s %8s %8s %6s\n", "subsystem", "live", "max", "blocks");
+    for (index = 0; index < RTGUI_MEM_TAG_MAX; index ++)
+        _memtrace_dump_stat(trace_tag_name[index], &trace_tags[index]);
+
+    rt_kprintf("  %-16s %8s %8s %6s\n", "app", "live", "max", "blocks");
+    for (index = 0; index < GUIENGINE_MEMTRACE_APPS; index ++)
+    {
+        if (index == 0 || trace_apps[index].app != RT_NULL)
+            _memtrace_dump_stat(index == 0 ? "-" : trace_apps[index].name, &trace_apps[index].stat);
+    }
+
+    /* the callers in use, sorted by the live bytes */
+    rtgui_enter_critical();
+    for (index = 0; index < GUIENGINE_MEMTRACE_SITES; index ++)
+    {
+        if (trace_sites[index].stat.blocks == 0) continue;
+
+        for (pos = count; pos > 0 && trace_sites[order[pos - 1]].stat.live < trace_sites[index].stat.live; pos --)
+            order[pos] = order[pos - 1];
+        order[pos] = index;
+        count ++;
+    }
+    rtgui_exit_critical();
+
+    rt_kprintf("  %-10s %-7s %8s %8s %6s\n", "caller", "tag", "live", "max", "blocks");
+    for (index = 0; index < count; index ++)
+    {
+        struct rti_memtrace_site *site = &trace_sites[order[index]];
+
+        if (order[index] == 0)
+            rt_kprintf("  %-10s %-7s", "others", "-");
+        else
+            rt_kprintf("  %-10p %-7s", site->caller, trace_tag_name[site->tag]);
+        rt_kprintf(" %8d %8d %6d\n", site->stat.live, site->stat.max, site->stat.blocks);
+    }
+
+    rtgui_region_pool_dump();
 }
 FINSH_FUNCTION_EXPORT(list_guimem, display memory information);
+#ifdef FINSH_USING_MSH
+MSH_CMD_EXPORT(list_guimem, display memory information);
+#endif
 #endif
 
 /************************************************************************/
@@ -431,6 +909,7 @@ const char *rtgui_event_string[] =
     "UPDATE_END",           /* end of update rect   */
     "MONITOR_ADD",          /* add a monitor rect   */
     "MONITOR_REMOVE",       /* remove a monitor rect*/
+    "VSYNC",                /* panel refresh        */
     "SHOW",                 /* the widget is going to be shown */
     "HIDE",                 /* the widget is going to be hidden */
     "PAINT",                /* paint on screen      */
@@ -455,6 +934,7 @@ const char *rtgui_event_string[] =
     "SELECTED",             /* widget selected      */
     "UNSELECTED",           /* widget unselected    */
     "MV_MODEL",             /* modal chaned in MV   */
+    "IMAGE_LOADED",         /* image decoded        */
     "BUS_NOTIFY_EVENT",
 };
 
@@ -638,6 +1118,238 @@ static void rtgui_event_dump(struct rtgui_app* app, rtgui_event_t *event)
 /************************************************************************/
 /* RTGUI IPC APIs                                                       */
 /************************************************************************/
+static rt_uint16_t _motion_seq = 0;
+
+/*
+ * The mouse motion is coalesced into the motion of same window at the tail of
+ * mq: the latest one is kept in app->motion and replaces the queued one when
+ * it is received. Any other event sent after the motion ends the coalescing,
+ * so the order of events is kept.
+ */
+static rt_bool_t _rtgui_send_coalesce(struct rtgui_app *app, rtgui_event_t *event,
+                                      rt_size_t event_size)
+{
+    rt_base_t level;
+    struct rtgui_event_mouse *mouse;
+
+    level = rt_hw_interrupt_disable();
+    if (event->type != RTGUI_EVENT_MOUSE_MOTION ||
+        event_size != sizeof(struct rtgui_event_mouse))
+    {
+        app->motion_seq = 0;
+        rt_hw_interrupt_enable(level);
+        return RT_FALSE;
+    }
+
+    mouse = (struct rtgui_event_mouse *)event;
+    if (app->motion_seq != 0 &&
+        app->motion.wid == mouse->wid &&
+        app->motion.button == mouse->button)
+    {
+        event->user = app->motion_seq;
+        app->motion = *mouse;
+        rt_hw_interrupt_enable(level);
+        return RT_TRUE;
+    }
+
+    if (++_motion_seq == 0) _motion_seq = 1;
+    event->user = _motion_seq;
+    app->motion = *mouse;
+    app->motion_seq = _motion_seq;
+    rt_hw_interrupt_enable(level);
+
+    return RT_FALSE;
+}
+
+/* replace the queued motion with the latest one coalesced into it */
+static void _rtgui_recv_coalesced(struct rtgui_app *app, rtgui_event_t *event,
+                                  rt_size_t event_size)
+{
+    rt_base_t level;
+
+    if (event->type != RTGUI_EVENT_MOUSE_MOTION ||
+        event_size < sizeof(struct rtgui_event_mouse))
+        return;
+
+    level = rt_hw_interrupt_disable();
+    if (app->motion_seq != 0 && event->user == app->motion_seq)
+    {
+        *(struct rtgui_event_mouse *)event = app->motion;
+        app->motion_seq = 0;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/*
+ * Send the event to mq and record the most events in it. The mq over 3/4 is
+ * warned once each peak, before the events are dropped on full.
+ */
+static rt_err_t _rtgui_mq_put(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size,
+                              rt_bool_t urgent)
+{
+    rt_err_t result;
+    rt_uint16_t entry, peak = 0;
+    rt_base_t level;
+
+    if (urgent) result = rt_mq_urgent(app->mq, event, event_size);
+    else result = rt_mq_send(app->mq, event, event_size);
+    if (result != RT_EOK)
+        return result;
+
+    level = rt_hw_interrupt_disable();
+    entry = app->mq->entry;
+    if (entry > app->mq_peak)
+    {
+        app->mq_peak = entry;
+        peak = entry;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (peak * 4 >= app->mq_depth * 3 && (peak - 1) * 4 < app->mq_depth * 3)
+        rt_kprintf("the mq of %s is %d/%d full\n", app->name, peak, app->mq_depth);
+
+    return RT_EOK;
+}
+
+#ifdef GUIENGINE_USING_EVENT_RING
+/*
+ * The ring of variable length records: a rt_uint32_t length followed by the
+ * event, aligned to 4 bytes. A record does not wrap around, the rest of ring
+ * is skipped by a record of _RING_WRAP. The ring is empty if head == tail, so
+ * the head never catches up the tail.
+ */
+#define _RING_WRAP      0xFFFFFFFF
+#define _RING_RECORD(size)  RT_ALIGN(sizeof(rt_uint32_t) + (size), 4)
+
+#if defined(__GNUC__)
+#define _ring_barrier()     __sync_synchronize()
+#else
+#define _ring_barrier()     rt_hw_interrupt_enable(rt_hw_interrupt_disable())
+#endif
+
+/* the server thread is the only producer of ring */
+rt_inline rt_bool_t _rtgui_ring_producer(void)
+{
+    struct rtgui_app *srv_app = rtgui_get_server();
+
+    return rt_interrupt_get_nest() == 0 && srv_app != RT_NULL &&
+           rt_thread_self() == srv_app->tid;
+}
+
+static rt_err_t _rtgui_ring_put(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size)
+{
+    rt_uint32_t head, tail, record;
+    rt_bool_t empty;
+
+    head = app->ring_head;
+    tail = app->ring_tail;
+    empty = (head == tail);
+    record = _RING_RECORD(event_size);
+
+    if (head >= tail)
+    {
+        /* keep a gap at the end if the tail is at the beginning */
+        if (record + (tail == 0 ? 4 : 0) > GUIENGINE_EVENT_RING_SIZE - head)
+        {
+            if (record >= tail) return -RT_EFULL;
+
+            *(rt_uint32_t *)(app->ring + head) = _RING_WRAP;
+            head = 0;
+        }
+    }
+    else if (record >= tail - head)
+    {
+        return -RT_EFULL;
+    }
+
+    *(rt_uint32_t *)(app->ring + head) = event_size;
+    rt_memcpy(app->ring + head + sizeof(rt_uint32_t), event, event_size);
+    head += record;
+    if (head == GUIENGINE_EVENT_RING_SIZE) head = 0;
+
+    /* publish the record after it is written */
+    _ring_barrier();
+    app->ring_head = head;
+
+    /* the app checks the ring before waiting the semaphore, so it is only
+     * released when the ring turns to non-empty */
+    if (empty) rt_sem_release(&app->ring_sem);
+
+    return RT_EOK;
+}
+
+static rt_err_t _rtgui_ring_get(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size)
+{
+    rt_uint32_t head, tail, size;
+
+    head = app->ring_head;
+    tail = app->ring_tail;
+    if (head == tail) return -RT_EEMPTY;
+
+    /* read the record after the head is read */
+    _ring_barrier();
+    size = *(rt_uint32_t *)(app->ring + tail);
+    if (size == _RING_WRAP)
+    {
+        tail = 0;
+        size = *(rt_uint32_t *)(app->ring);
+    }
+
+    rt_memcpy(event, app->ring + tail + sizeof(rt_uint32_t), size < event_size ? size : event_size);
+    tail += _RING_RECORD(size);
+    if (tail == GUIENGINE_EVENT_RING_SIZE) tail = 0;
+
+    _ring_barrier();
+    app->ring_tail = tail;
+
+    return RT_EOK;
+}
+
+/* the event in mq is counted by the semaphore of ring too */
+static rt_err_t _rtgui_mq_send(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size,
+                               rt_bool_t urgent)
+{
+    rt_err_t result;
+
+    result = _rtgui_mq_put(app, event, event_size, urgent);
+    if (result == RT_EOK)
+        rt_sem_release(&app->ring_sem);
+
+    return result;
+}
+
+static rt_err_t _rtgui_ring_recv(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size,
+                                 rt_int32_t timeout)
+{
+    rt_tick_t tick = rt_tick_get();
+    rt_err_t result;
+
+    while (1)
+    {
+        /* the events from server are earlier than the ones sent to mq by the
+         * server, the wakeups for them may be taken already */
+        if (_rtgui_ring_get(app, event, event_size) == RT_EOK)
+            return RT_EOK;
+        if (rt_mq_recv(app->mq, event, event_size, 0) == RT_EOK)
+            return RT_EOK;
+
+        if (timeout > 0)
+        {
+            rt_int32_t elapsed = rt_tick_get() - tick;
+
+            if (elapsed >= timeout) return -RT_ETIMEOUT;
+            timeout -= elapsed;
+            tick += elapsed;
+        }
+
+        result = rt_sem_take(&app->ring_sem, timeout);
+        if (result != RT_EOK) return result;
+    }
+}
+#else
+#define _rtgui_mq_send(app, event, event_size, urgent) _rtgui_mq_put(app, event, event_size, urgent)
+#endif
+
 rt_err_t rtgui_send(struct rtgui_app* app, rtgui_event_t *event, rt_size_t event_size)
 {
     rt_err_t result;
@@ -648,11 +1360,29 @@ rt_err_t rtgui_send(struct rtgui_app* app, rtgui_event_t *event, rt_size_t event
 
     rtgui_event_dump(app, event);
 
-    result = rt_mq_send(app->mq, event, event_size);
+    if (_rtgui_send_coalesce(app, event, event_size) == RT_TRUE)
+        return RT_EOK;
+
+#ifdef GUIENGINE_USING_EVENT_RING
+    if (_rtgui_ring_producer())
+        result = _rtgui_ring_put(app, event, event_size);
+    else
+#endif
+    result = _rtgui_mq_send(app, event, event_size, RT_FALSE);
     if (result != RT_EOK)
     {
+        rt_base_t level;
+
+        /* the motion is not queued, nothing to be coalesced into */
+        level = rt_hw_interrupt_disable();
+        if (event->type == RTGUI_EVENT_MOUSE_MOTION && app->motion_seq == event->user)
+            app->motion_seq = 0;
+        app->mq_drops ++;
+        rt_hw_interrupt_enable(level);
+
         if (event->type != RTGUI_EVENT_TIMER)
             rt_kprintf("send event to %s failed\n", app->name);
+        rtgui_event_payload_unref(rtgui_event_get_payload(event));
     }
 
     return result;
@@ -669,9 +1399,13 @@ rt_err_t rtgui_send_urgent(struct rtgui_app* app, rtgui_event_t *event, rt_size_
 
     rtgui_event_dump(app, event);
 
-    result = rt_mq_urgent(app->mq, event, event_size);
+    result = _rtgui_mq_send(app, event, event_size, RT_TRUE);
     if (result != RT_EOK)
+    {
+        app->mq_drops ++;
         rt_kprintf("send ergent event to %s failed\n", app->name);
+        rtgui_event_payload_unref(rtgui_event_get_payload(event));
+    }
 
     return result;
 }
@@ -681,7 +1415,8 @@ rt_err_t rtgui_send_sync(struct rtgui_app* app, rtgui_event_t *event, rt_size_t
 {
     rt_err_t r;
     rt_int32_t ack_buffer, ack_status;
-    struct rt_mailbox ack_mb;
+    struct rt_mailbox ack_mb, *mb;
+    struct rtgui_app *self;
 
     RT_ASSERT(app != RT_NULL);
     RT_ASSERT(event != RT_NULL);
@@ -689,20 +1424,33 @@ rt_err_t rtgui_send_sync(struct rtgui_app* app, rtgui_event_t *event, rt_size_t
 
     rtgui_event_dump(app, event);
 
-    /* init ack mailbox */
-    r = rt_mb_init(&ack_mb, "ack", &ack_buffer, 1, 0);
-    if (r != RT_EOK)
-        goto __return;
+    /* the app waits the ack in its own mailbox, only the thread without app
+     * (or the app being created) inits one on stack */
+    self = (struct rtgui_app *)(rt_thread_self()->user_data);
+    if (self != RT_NULL)
+    {
+        mb = &self->ack_mb;
+    }
+    else
+    {
+        r = rt_mb_init(&ack_mb, "ack", &ack_buffer, 1, 0);
+        if (r != RT_EOK)
+            return r;
+        mb = &ack_mb;
+    }
 
-    event->ack = &ack_mb;
-    r = rt_mq_send(app->mq, event, event_size);
+    event->ack = mb;
+    _rtgui_send_coalesce(app, event, event_size);
+    r = _rtgui_mq_send(app, event, event_size, RT_FALSE);
     if (r != RT_EOK)
     {
+        app->mq_drops ++;
         rt_kprintf("send sync event failed\n");
+        rtgui_event_payload_unref(rtgui_event_get_payload(event));
         goto __return;
     }
 
-    r = rt_mb_recv(&ack_mb, (rt_uint32_t *)&ack_status, RT_WAITING_FOREVER);
+    r = rt_mb_recv(mb, (rt_uint32_t *)&ack_status, RT_WAITING_FOREVER);
     if (r != RT_EOK)
         goto __return;
 
@@ -713,7 +1461,8 @@ rt_err_t rtgui_send_sync(struct rtgui_app* app, rtgui_event_t *event, rt_size_t
 
 __return:
     /* fini ack mailbox */
-    rt_mb_detach(&ack_mb);
+    if (mb == &ack_mb)
+        rt_mb_detach(&ack_mb);
     return r;
 }
 RTM_EXPORT(rtgui_send_sync);
@@ -729,6 +1478,78 @@ rt_err_t rtgui_ack(rtgui_event_t *event, rt_int32_t status)
 }
 RTM_EXPORT(rtgui_ack);
 
+/*
+ * The paint and timer events are deferred in the lanes of app while there are
+ * other events queued, so the input is not blocked behind them. The input and
+ * window events are kept in order, since the input depends on the window state
+ * (win_acti_cnt, clip). The events with ack are never deferred.
+ */
+static rt_bool_t _rtgui_lane_put(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size)
+{
+    int index;
+
+    if (event->ack != RT_NULL) return RT_FALSE;
+
+    if (event->type == RTGUI_EVENT_PAINT && event_size >= sizeof(struct rtgui_event_paint))
+    {
+        struct rtgui_event_paint *paint = (struct rtgui_event_paint *)event;
+
+        for (index = 0; index < app->paint_cnt; index ++)
+        {
+            if (app->paint_lane[index].wid == paint->wid)
+            {
+                rtgui_rect_t *rect = &app->paint_lane[index].rect;
+
+                /* the empty rect is the whole window */
+                if (paint->rect.x1 >= paint->rect.x2 || paint->rect.y1 >= paint->rect.y2)
+                    *rect = paint->rect;
+                else if (rect->x1 < rect->x2 && rect->y1 < rect->y2)
+                    rtgui_rect_union(&paint->rect, rect);
+                return RT_TRUE;
+            }
+        }
+
+        if (app->paint_cnt == GUIENGINE_EVENT_PAINT_LANE) return RT_FALSE;
+
+        app->paint_lane[app->paint_cnt ++] = *paint;
+        return RT_TRUE;
+    }
+
+    if (event->type == RTGUI_EVENT_TIMER && event_size >= sizeof(struct rtgui_event_timer))
+    {
+        if (app->timer_cnt == GUIENGINE_EVENT_TIMER_LANE) return RT_FALSE;
+
+        index = (app->timer_first + app->timer_cnt) % GUIENGINE_EVENT_TIMER_LANE;
+        app->timer_lane[index] = *(struct rtgui_event_timer *)event;
+        app->timer_cnt ++;
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+static rt_bool_t _rtgui_lane_get(struct rtgui_app *app, rtgui_event_t *event, rt_size_t event_size)
+{
+    if (app->paint_cnt)
+    {
+        rt_memcpy(event, &app->paint_lane[0], sizeof(struct rtgui_event_paint));
+        app->paint_cnt --;
+        rt_memmove(&app->paint_lane[0], &app->paint_lane[1],
+                   app->paint_cnt * sizeof(struct rtgui_event_paint));
+        return RT_TRUE;
+    }
+
+    if (app->timer_cnt)
+    {
+        rt_memcpy(event, &app->timer_lane[app->timer_first], sizeof(struct rtgui_event_timer));
+        app->timer_first = (app->timer_first + 1) % GUIENGINE_EVENT_TIMER_LANE;
+        app->timer_cnt --;
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
 rt_err_t rtgui_recv(rtgui_event_t *event, rt_size_t event_size, rt_int32_t timeout)
 {
     struct rtgui_app *app;
@@ -740,7 +1561,25 @@ rt_err_t rtgui_recv(rtgui_event_t *event, rt_size_t event_size, rt_int32_t timeo
     app = (struct rtgui_app *)(rt_thread_self()->user_data);
     if (app == RT_NULL) return -RT_ERROR;
 
-    r = rt_mq_recv(app->mq, event, event_size, timeout);
+    while (1)
+    {
+        /* the deferred events are handled once nothing else is queued */
+        if (app->paint_cnt || app->timer_cnt) timeout = 0;
+
+#ifdef GUIENGINE_USING_EVENT_RING
+        r = _rtgui_ring_recv(app, event, event_size, timeout);
+#else
+        r = rt_mq_recv(app->mq, event, event_size, timeout);
+#endif
+        if (r != RT_EOK) break;
+
+        _rtgui_recv_coalesced(app, event, event_size);
+        if (_rtgui_lane_put(app, event, event_size) == RT_FALSE)
+            return RT_EOK;
+    }
+
+    if (_rtgui_lane_get(app, event, event_size) == RT_TRUE)
+        return RT_EOK;
 
     return r;
 }
@@ -759,7 +1598,7 @@ rt_err_t rtgui_recv_filter(rt_uint32_t type, rtgui_event_t *event, rt_size_t eve
         return -RT_ERROR;
 
     e = (rtgui_event_t*)&app->event_buffer[0];
-    while (rt_mq_recv(app->mq, e, sizeof(union rtgui_event_generic), RT_WAITING_FOREVER) == RT_EOK)
+    while (rtgui_recv(e, app->event_size, RT_WAITING_FOREVER) == RT_EOK)
     {
         if (e->type == type)
         {
@@ -768,10 +1607,14 @@ rt_err_t rtgui_recv_filter(rt_uint32_t type, rtgui_event_t *event, rt_size_t eve
         }
         else
         {
+            void *payload = rtgui_event_get_payload(e);
+
             if (RTGUI_OBJECT(app)->event_handler != RT_NULL)
             {
                 RTGUI_OBJECT(app)->event_handler(RTGUI_OBJECT(app), e);
             }
+            /* the payload is released as the one dispatched in app */
+            rtgui_event_payload_unref(payload);
         }
     }
 
@@ -797,9 +1640,118 @@ void rtgui_get_screen_rect(struct rtgui_rect *rect)
 }
 RTM_EXPORT(rtgui_get_screen_rect);
 
+#ifdef GUIENGINE_USING_RECT_LOCK
+/*
+ * The drawings lock the rect of window on screen only, so the windows not
+ * overlapped are drawn at the same time (the clip of windows never overlaps).
+ * The table of locked rects is guarded by the screen lock, which is taken by
+ * rtgui_screen_lock as the lock of whole screen after the rects of the other
+ * threads are unlocked. A frozen rect is not counted until it's thawed.
+ */
+struct rtgui_screen_locker
+{
+    rt_thread_t owner;
+    rtgui_rect_t rect;
+    rt_uint16_t hold;
+    rt_uint16_t frozen;
+};
+static struct rtgui_screen_locker _screen_lockers[GUIENGINE_SCREEN_LOCKERS];
+static rt_uint16_t _screen_waiters = 0;
+
+/* whether the rect (or the screen if RT_NULL) is locked by the other threads */
+static rt_bool_t _screen_rect_busy(const rtgui_rect_t *rect, rt_bool_t *slot)
+{
+    int index;
+    rt_bool_t busy = RT_FALSE;
+    rt_thread_t self = rt_thread_self();
+
+    if (slot) *slot = RT_FALSE;
+    for (index = 0; index < GUIENGINE_SCREEN_LOCKERS; index ++)
+    {
+        struct rtgui_screen_locker *locker = &_screen_lockers[index];
+
+        if (locker->owner == RT_NULL)
+        {
+            if (slot) *slot = RT_TRUE;
+            continue;
+        }
+        if (locker->owner == self)
+        {
+            if (slot) *slot = RT_TRUE;
+            continue;
+        }
+        if (locker->frozen) continue;
+
+        if (rect == RT_NULL || rtgui_rect_is_intersect(rect, &locker->rect) == RT_EOK)
+            busy = RT_TRUE;
+    }
+
+    return busy;
+}
+
+static struct rtgui_screen_locker *_screen_locker_self(void)
+{
+    int index;
+
+    for (index = 0; index < GUIENGINE_SCREEN_LOCKERS; index ++)
+    {
+        if (_screen_lockers[index].owner == rt_thread_self())
+            return &_screen_lockers[index];
+    }
+
+    return RT_NULL;
+}
+
+static struct rtgui_screen_locker *_screen_locker_empty(void)
+{
+    int index;
+
+    for (index = 0; index < GUIENGINE_SCREEN_LOCKERS; index ++)
+    {
+        if (_screen_lockers[index].owner == RT_NULL)
+            return &_screen_lockers[index];
+    }
+
+    return RT_NULL;
+}
+
+/* wait a rect unlocked with the screen lock held, which is released in the
+ * waiting */
+static void _screen_lock_wait(void)
+{
+    int hold, index;
+
+    _screen_waiters ++;
+    index = hold = _screen_lock.hold;
+    while (index --) rt_mutex_release(&_screen_lock);
+
+    rt_sem_take(&_screen_wait, RT_WAITING_FOREVER);
+
+    while (hold --) rt_mutex_take(&_screen_lock, RT_WAITING_FOREVER);
+}
+
+static void _screen_lock_wakeup(void)
+{
+    while (_screen_waiters)
+    {
+        _screen_waiters --;
+        rt_sem_release(&_screen_wait);
+    }
+}
+#endif
+
 void rtgui_screen_lock(rt_int32_t timeout)
 {
+#ifdef GUIENGINE_USING_RECT_LOCK
+    if (rt_mutex_take(&_screen_lock, timeout) != RT_EOK)
+        return;
+
+    /* the whole screen, wait the drawings of the other threads */
+    while (_screen_rect_busy(RT_NULL, RT_NULL) == RT_TRUE)
+        _screen_lock_wait();
+#else
     rt_mutex_take(&_screen_lock, timeout);
+#endif
 }
 RTM_EXPORT(rtgui_screen_lock);
 
@@ -809,10 +1761,91 @@ void rtgui_screen_unlock(void)
 }
 RTM_EXPORT(rtgui_screen_unlock);
 
+#ifdef GUIENGINE_USING_RECT_LOCK
+void rtgui_screen_lock_rect(const rtgui_rect_t *rect)
+{
+    rt_bool_t slot;
+    rtgui_rect_t lock_rect;
+    struct rtgui_screen_locker *locker;
+    struct rtgui_graphic_driver *driver;
+
+    /* the panel without framebuffer is driven by one bus */
+    driver = rtgui_graphic_driver_get_default();
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL)
+    {
+        rtgui_screen_lock(RT_WAITING_FOREVER);
+        return;
+    }
+
+    rt_mutex_take(&_screen_lock, RT_WAITING_FOREVER);
+
+    /* the nested rects of a thread are merged */
+    lock_rect = *rect;
+    locker = _screen_locker_self();
+    if (locker != RT_NULL)
+        rtgui_rect_union(&locker->rect, &lock_rect);
+
+    while (_screen_rect_busy(&lock_rect, &slot) == RT_TRUE || slot == RT_FALSE)
+        _screen_lock_wait();
+
+    locker = _screen_locker_self();
+    if (locker == RT_NULL)
+    {
+        locker = _screen_locker_empty();
+        locker->owner = rt_thread_self();
+        locker->hold = 0;
+        locker->frozen = 0;
+    }
+    locker->rect = lock_rect;
+    locker->hold ++;
+
+    rt_mutex_release(&_screen_lock);
+}
+RTM_EXPORT(rtgui_screen_lock_rect);
+
+void rtgui_screen_unlock_rect(void)
+{
+    struct rtgui_screen_locker *locker;
+    struct rtgui_graphic_driver *driver;
+
+    driver = rtgui_graphic_driver_get_default();
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL)
+    {
+        rtgui_screen_unlock();
+        return;
+    }
+
+    rt_mutex_take(&_screen_lock, RT_WAITING_FOREVER);
+    locker = _screen_locker_self();
+    RT_ASSERT(locker != RT_NULL);
+    if (-- locker->hold == 0)
+    {
+        locker->owner = RT_NULL;
+        _screen_lock_wakeup();
+    }
+    rt_mutex_release(&_screen_lock);
+}
+RTM_EXPORT(rtgui_screen_unlock_rect);
+#endif
+
 int rtgui_screen_lock_freeze(void)
 {
     int hold = 0;
 
+#ifdef GUIENGINE_USING_RECT_LOCK
+    struct rtgui_screen_locker *locker;
+
+    /* the rect is not counted until it is thawed */
+    rt_mutex_take(&_screen_lock, RT_WAITING_FOREVER);
+    locker = _screen_locker_self();
+    if (locker != RT_NULL)
+    {
+        locker->frozen = 1;
+        _screen_lock_wakeup();
+    }
+    rt_mutex_release(&_screen_lock);
+#endif
+
     if (_screen_lock.owner == rt_thread_self())
     {
         int index;
@@ -827,6 +1860,20 @@ RTM_EXPORT(rtgui_screen_lock_freeze);
 
 void rtgui_screen_lock_thaw(int value)
 {
+#ifdef GUIENGINE_USING_RECT_LOCK
+    struct rtgui_screen_locker *locker;
+
+    rt_mutex_take(&_screen_lock, RT_WAITING_FOREVER);
+    locker = _screen_locker_self();
+    if (locker != RT_NULL)
+    {
+        while (_screen_rect_busy(&locker->rect, RT_NULL) == RT_TRUE)
+            _screen_lock_wait();
+        locker->frozen = 0;
+    }
+    rt_mutex_release(&_screen_lock);
+#endif
+
     while (value--) rt_mutex_take(&_screen_lock, RT_WAITING_FOREVER);
 }
 RTM_EXPORT(rtgui_screen_lock_thaw);
@@ -28,6 +28,9 @@
 #include <rtgui/rtgui_object.h>
 #include <rtgui/rtgui_app.h>
 #include <rtgui/driver.h>
+#include <rtgui/profile.h>
+#include <rtgui/trace.h>
+#include <rtgui/snapshot.h>
 //#include <rtgui/touch.h>
 
 #include <rtgui/widgets/window.h>
@@ -51,15 +54,514 @@ void rtgui_server_install_act_win_hook(void (*hk)(void))
     _act_win_hook = hk;
 }
 
-void rtgui_server_handle_update(struct rtgui_event_update_end *event)
+/* the damaged area not yet flushed to the panel */
+/* the damage of each display */
+static rtgui_region_t _damage_region[RTGUI_DISPLAY_NUM];
+#if GUIENGINE_DAMAGE_FLUSH_MS > 0
+static rtgui_timer_t *_damage_timer = RT_NULL;
+#endif
+
+/* the apps waiting the next frame, and the timer of frames if the panel does
+ * not report vsync */
+static struct rtgui_app *_frame_apps[GUIENGINE_FRAME_APP_MAX];
+static int _frame_app_cnt = 0;
+static rtgui_timer_t *_frame_timer = RT_NULL;
+
+/* vsync scheduler: the flush is presented on the panel refresh */
+static rt_thread_t _vsync_tid = RT_NULL;
+static struct rt_semaphore _vsync_request;
+static volatile rt_bool_t _vsync_pending = RT_FALSE;
+
+#ifdef RTGUI_USING_WINMOVE
+/* the outline of window dragged is moved once a frame */
+static volatile rt_bool_t _winrect_pending = RT_FALSE;
+static rtgui_timer_t *_winrect_timer = RT_NULL;
+#endif
+
+#ifdef GUIENGINE_USING_LATENCY
+/* the stamp of the oldest input in damage region */
+static rt_uint32_t _damage_stamp = 0;
+#endif
+
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+/*
+ * The frame governor: the damage is flushed and the frames are delivered not
+ * faster than the interval, the updates in between are merged in the damage.
+ * The interval is the cap of policy, or the idle one without input for a
+ * while, shifted by the load. The average cost of flush (in the clock of
+ * profile) over 3/4 of the interval in some frames doubles the interval, and
+ * under 1/4 in more frames halves it back, so an app flooding the updates
+ * gets fewer frames and the input in between is not queued behind them.
+ */
+#define _GOVERNOR_OVER_FRAMES       4
+#define _GOVERNOR_UNDER_FRAMES      16
+static struct
+{
+    rt_tick_t last;
+    rt_tick_t input;
+    /* the average cost of flush in 1/8 */
+    rt_uint32_t cost;
+    rt_uint8_t shift;
+    rt_uint8_t over;
+    rt_uint8_t under;
+    rtgui_timer_t *timer;
+} _governor;
+static rt_bool_t _governor_due(void);
+
+static rt_tick_t _governor_interval(void)
+{
+    int ms;
+    enum rtgui_frame_policy policy;
+
+    policy = rtgui_app_get_frame_policy();
+    if (policy == RTGUI_FRAME_POLICY_IDLE || (GUIENGINE_GOVERNOR_IDLE_AFTER_MS > 0 &&
+            rt_tick_get() - _governor.input >= rt_tick_from_millisecond(GUIENGINE_GOVERNOR_IDLE_AFTER_MS)))
+        ms = GUIENGINE_GOVERNOR_IDLE_MS;
+    else if (policy == RTGUI_FRAME_POLICY_BATTERY)
+        ms = GUIENGINE_GOVERNOR_BATTERY_MS;
+    else
+        ms = GUIENGINE_FRAME_MS;
+
+    return rt_tick_from_millisecond(ms << _governor.shift);
+}
+
+static void _governor_account(rt_uint32_t cost)
+{
+    rt_uint32_t budget, average;
+
+    budget = _governor_interval() * (1000000 / RT_TICK_PER_SECOND);
+    _governor.cost += cost - (_governor.cost >> 3);
+    average = _governor.cost >> 3;
+
+    if (average > budget / 4 * 3)
+    {
+        _governor.under = 0;
+        if (++ _governor.over >= _GOVERNOR_OVER_FRAMES && _governor.shift < GUIENGINE_GOVERNOR_SHIFT_MAX)
+        {
+            _governor.shift ++;
+            _governor.over = 0;
+        }
+    }
+    else if (average < budget / 4)
+    {
+        _governor.over = 0;
+        if (++ _governor.under >= _GOVERNOR_UNDER_FRAMES && _governor.shift > 0)
+        {
+            _governor.shift --;
+            _governor.under = 0;
+        }
+    }
+    else
+    {
+        _governor.over = _governor.under = 0;
+    }
+}
+#endif
+
+static void rtgui_server_flush_display(struct rtgui_graphic_driver *driver, rtgui_region_t *damage)
+{
+    int index, num;
+    rtgui_rect_t *rects;
+
+#ifdef GUIENGINE_USING_COMPOSITOR
+    if (driver != RT_NULL)
+    {
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        rtgui_mouse_hide_cursor();
+#endif
+        num = rtgui_region_num_rects(damage);
+        rects = rtgui_region_rects(damage);
+        for (index = 0; index < num; index++)
+            rtgui_topwin_composite(driver, &rects[index]);
+#ifdef RTGUI_USING_MOUSE_CURSOR
+        rtgui_mouse_show_cursor();
+#endif
+    }
+#endif
+    if (driver != RT_NULL && driver->page_num > 1)
+    {
+        /* show the whole back page at once */
+        rtgui_graphic_driver_page_flip(driver, damage);
+    }
+    else if (driver != RT_NULL)
+    {
+        num = rtgui_region_num_rects(damage);
+        RTGUI_TRACE_COUNTER("damage rects", num);
+        if (num > GUIENGINE_DAMAGE_RECT_MAX)
+        {
+            /* too many transfers, send the bounding box at once */
+            rtgui_graphic_driver_screen_update(driver, &(damage->extents));
+        }
+        else
+        {
+            rects = rtgui_region_rects(damage);
+            for (index = 0; index < num; index++)
+                rtgui_graphic_driver_screen_update(driver, &rects[index]);
+        }
+    }
+
+    rtgui_region_empty(damage);
+}
+
+static void rtgui_server_flush_damage(void)
+{
+    int display;
+    rt_bool_t damaged = RT_FALSE;
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    rt_uint32_t start;
+#endif
+
+    for (display = 0; display < RTGUI_DISPLAY_NUM; display ++)
+    {
+        if (rtgui_region_not_empty(&_damage_region[display]))
+            damaged = RT_TRUE;
+    }
+    if (damaged == RT_FALSE)
+        return;
+
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    start = GUIENGINE_PROFILE_CLOCK();
+#endif
+#ifdef GUIENGINE_USING_COMPOSITOR
+    /* no window is drawing to its layer */
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+#endif
+    for (display = 0; display < RTGUI_DISPLAY_NUM; display ++)
+    {
+        if (rtgui_region_not_empty(&_damage_region[display]))
+            rtgui_server_flush_display(rtgui_graphic_driver_get_display(display),
+                                       &_damage_region[display]);
+    }
+#ifdef GUIENGINE_USING_COMPOSITOR
+    rtgui_screen_unlock();
+#endif
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    _governor_account(GUIENGINE_PROFILE_CLOCK() - start);
+#endif
+#ifdef GUIENGINE_USING_LATENCY
+    if (_damage_stamp != 0)
+    {
+        rtgui_latency_add(_damage_stamp);
+        _damage_stamp = 0;
+    }
+#endif
+}
+
+#if GUIENGINE_DAMAGE_FLUSH_MS > 0
+static void rtgui_server_damage_timeout(struct rtgui_timer *timer, void *parameter)
+{
+    /* one shot timer, restarted by the next update */
+    rtgui_timer_stop(timer);
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    if (_governor_due() == RT_FALSE)
+        return;
+#endif
+    rtgui_server_flush_damage();
+}
+#endif
+
+static void rtgui_server_vsync_entry(void *parameter)
+{
+    struct rtgui_graphic_driver *driver;
+    struct rtgui_event_vsync event;
+
+    while (1)
+    {
+        /* sleep until the server has damage to present */
+        rt_sem_take(&_vsync_request, RT_WAITING_FOREVER);
+
+        driver = rtgui_graphic_driver_get_default();
+        if (driver->vsync != RT_NULL)
+        {
+            /* drop the stale refreshes and wait for the next one */
+            rt_sem_control(driver->vsync, RT_IPC_CMD_RESET, RT_NULL);
+            rt_sem_take(driver->vsync, RT_WAITING_FOREVER);
+        }
+
+        /*
+         * Note: RTGUI_EVENT_VSYNC_INIT can not be used here, for this thread
+         * is not a GUI application
+         */
+        event.type = RTGUI_EVENT_VSYNC;
+        event.user = 0;
+        event.sender = RT_NULL;
+        event.ack = RT_NULL;
+        RTGUI_EVENT_STAMP_INIT(&event);
+        rtgui_server_post_event(&event, sizeof(event));
+    }
+}
+
+static rt_bool_t rtgui_server_request_vsync(void)
 {
     struct rtgui_graphic_driver *driver;
 
     driver = rtgui_graphic_driver_get_default();
-    if (driver != RT_NULL)
+    if (driver == RT_NULL || driver->vsync == RT_NULL)
+        return RT_FALSE;
+
+    if (_vsync_tid == RT_NULL)
+    {
+        rt_sem_init(&_vsync_request, "rtgui_vs", 0, RT_IPC_FLAG_FIFO);
+        _vsync_tid = rt_thread_create("rtgui_vs",
+                                      rtgui_server_vsync_entry, RT_NULL,
+                                      GUIENGINE_VSYNC_THREAD_STACK_SIZE,
+                                      GUIENGINE_SVR_THREAD_PRIORITY,
+                                      GUIENGINE_SVR_THREAD_TIMESLICE);
+        if (_vsync_tid == RT_NULL)
+        {
+            rt_sem_detach(&_vsync_request);
+            return RT_FALSE;
+        }
+        rt_thread_startup(_vsync_tid);
+    }
+
+    /* one request per frame, the later damages are merged into it */
+    if (_vsync_pending == RT_FALSE)
     {
-        rtgui_graphic_driver_screen_update(driver, &(event->rect));
+        _vsync_pending = RT_TRUE;
+        rt_sem_release(&_vsync_request);
     }
+
+    return RT_TRUE;
+}
+
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+static void rtgui_server_present_frame(void);
+
+static void _governor_timeout(struct rtgui_timer *timer, void *parameter)
+{
+    rtgui_timer_stop(timer);
+
+    /* on the panel refresh if the panel reports it */
+    if (rtgui_server_request_vsync() == RT_TRUE)
+        return;
+    rtgui_server_present_frame();
+}
+
+/* RT_TRUE if the frame is presented now, or it's deferred to the end of interval */
+static rt_bool_t _governor_due(void)
+{
+    rt_tick_t elapsed, interval;
+
+    elapsed = rt_tick_get() - _governor.last;
+    interval = _governor_interval();
+    if (elapsed >= interval)
+    {
+        _governor.last = rt_tick_get();
+        return RT_TRUE;
+    }
+
+    if (_governor.timer == RT_NULL)
+    {
+        _governor.timer = rtgui_timer_create(interval - elapsed, RT_TIMER_FLAG_ONE_SHOT,
+                                             _governor_timeout, RT_NULL);
+        /* no pacing without timer */
+        if (_governor.timer == RT_NULL)
+            return RT_TRUE;
+    }
+    else if (_governor.timer->state == RTGUI_TIMER_ST_RUNNING)
+    {
+        return RT_FALSE;
+    }
+    else
+    {
+        rtgui_timer_set_timeout(_governor.timer, interval - elapsed);
+    }
+    rtgui_timer_start(_governor.timer);
+
+    return RT_FALSE;
+}
+
+/* the input wakes up the idle frames */
+rt_inline void _governor_input(rt_uint16_t type)
+{
+    if (type == RTGUI_EVENT_MOUSE_MOTION || type == RTGUI_EVENT_MOUSE_BUTTON ||
+            type == RTGUI_EVENT_TOUCH || type == RTGUI_EVENT_KBD)
+        _governor.input = rt_tick_get();
+}
+#endif
+
+/* tell the apps waiting a frame that the frame is presented */
+static void rtgui_server_deliver_frame(void)
+{
+    int index;
+    struct rtgui_event_frame event;
+
+    RTGUI_EVENT_FRAME_INIT(&event);
+    event.tick = rt_tick_get();
+
+    for (index = 0; index < _frame_app_cnt; index ++)
+        rtgui_send(_frame_apps[index], &event.parent, sizeof(event));
+    _frame_app_cnt = 0;
+}
+
+static void rtgui_server_cancel_frame(struct rtgui_app *app)
+{
+    int index;
+
+    for (index = 0; index < _frame_app_cnt; index ++)
+    {
+        if (_frame_apps[index] == app)
+        {
+            _frame_apps[index] = _frame_apps[-- _frame_app_cnt];
+            return;
+        }
+    }
+}
+
+static void rtgui_server_frame_timeout(struct rtgui_timer *timer, void *parameter)
+{
+    rtgui_timer_stop(timer);
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    if (_governor_due() == RT_FALSE)
+        return;
+#endif
+    rtgui_server_flush_damage();
+    rtgui_server_deliver_frame();
+}
+
+static void rtgui_server_handle_frame_request(struct rtgui_event_frame *event)
+{
+    int index;
+    struct rtgui_app *app = event->parent.sender;
+
+    if (app == RT_NULL) return;
+
+    for (index = 0; index < _frame_app_cnt; index ++)
+    {
+        if (_frame_apps[index] == app) return;
+    }
+
+    if (_frame_app_cnt == GUIENGINE_FRAME_APP_MAX)
+    {
+        /* no slot, let it run in the frame at once */
+        rtgui_server_deliver_frame();
+    }
+    _frame_apps[_frame_app_cnt ++] = app;
+
+    /* the frames are ticked with the panel refresh if possible */
+    if (rtgui_server_request_vsync() == RT_TRUE)
+        return;
+
+    if (_frame_timer == RT_NULL)
+    {
+        _frame_timer = rtgui_timer_create(rt_tick_from_millisecond(GUIENGINE_FRAME_MS),
+                                          RT_TIMER_FLAG_ONE_SHOT,
+                                          rtgui_server_frame_timeout, RT_NULL);
+        if (_frame_timer == RT_NULL)
+        {
+            rtgui_server_deliver_frame();
+            return;
+        }
+    }
+    if (_frame_timer->state != RTGUI_TIMER_ST_RUNNING)
+        rtgui_timer_start(_frame_timer);
+}
+
+#ifdef RTGUI_USING_WINMOVE
+static void rtgui_server_flush_winrect(void)
+{
+    if (_winrect_pending == RT_FALSE)
+        return;
+
+    _winrect_pending = RT_FALSE;
+    rtgui_winrect_update();
+}
+
+static void rtgui_server_winrect_timeout(struct rtgui_timer *timer, void *parameter)
+{
+    rtgui_timer_stop(timer);
+    rtgui_server_flush_winrect();
+}
+
+/* the motions in a frame are merged into one move of the outline */
+void rtgui_server_request_winrect(void)
+{
+    if (_winrect_pending == RT_TRUE)
+        return;
+    _winrect_pending = RT_TRUE;
+
+    if (rtgui_server_request_vsync() == RT_TRUE)
+        return;
+
+    if (_winrect_timer == RT_NULL)
+    {
+        _winrect_timer = rtgui_timer_create(rt_tick_from_millisecond(GUIENGINE_FRAME_MS),
+                                            RT_TIMER_FLAG_ONE_SHOT,
+                                            rtgui_server_winrect_timeout, RT_NULL);
+        if (_winrect_timer == RT_NULL)
+        {
+            rtgui_server_flush_winrect();
+            return;
+        }
+    }
+    rtgui_timer_start(_winrect_timer);
+}
+#endif
+
+static void rtgui_server_present_frame(void)
+{
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    if (_governor_due() == RT_FALSE)
+        return;
+#endif
+#ifdef RTGUI_USING_WINMOVE
+    rtgui_server_flush_winrect();
+#endif
+    rtgui_server_flush_damage();
+    rtgui_server_deliver_frame();
+}
+
+static void rtgui_server_handle_vsync(struct rtgui_event_vsync *event)
+{
+    _vsync_pending = RT_FALSE;
+    rtgui_server_present_frame();
+}
+
+void rtgui_server_add_damage(rtgui_rect_t *rect)
+{
+    rtgui_server_add_display_damage(0, rect);
+}
+
+void rtgui_server_add_display_damage(int display, rtgui_rect_t *rect)
+{
+    rtgui_region_union_rect(&_damage_region[display], &_damage_region[display], rect);
+
+    /* present on the next panel refresh if the panel reports it */
+    if (rtgui_server_request_vsync() == RT_TRUE)
+        return;
+
+#if GUIENGINE_DAMAGE_FLUSH_MS > 0
+    if (_damage_timer != RT_NULL)
+    {
+        if (_damage_timer->state != RTGUI_TIMER_ST_RUNNING)
+            rtgui_timer_start(_damage_timer);
+        return;
+    }
+#endif
+
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    if (_governor_due() == RT_FALSE)
+        return;
+#endif
+    rtgui_server_flush_damage();
+}
+
+void rtgui_server_handle_update(struct rtgui_event_update_end *event)
+{
+#ifdef GUIENGINE_USING_BACKING_STORE
+    rtgui_topwin_backing_damage(event->wid, &(event->rect));
+#endif
+#ifdef GUIENGINE_USING_LATENCY
+    if (_damage_stamp == 0)
+        _damage_stamp = event->parent.stamp;
+#endif
+
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    rtgui_server_add_display_damage(event->display, &(event->rect));
+#else
+    rtgui_server_add_damage(&(event->rect));
+#endif
 }
 
 void rtgui_server_handle_monitor_add(struct rtgui_event_monitor *event)
@@ -77,9 +579,15 @@ void rtgui_server_handle_monitor_remove(struct rtgui_event_monitor *event)
 void rtgui_server_handle_mouse_btn(struct rtgui_event_mouse *event)
 {
     struct rtgui_topwin *wnd;
+#ifdef GUIENGINE_USING_LATENCY
+    rt_uint32_t stamp = event->parent.stamp;
+#endif
 
     /* re-init to server thread */
     RTGUI_EVENT_MOUSE_BUTTON_INIT(event);
+#ifdef GUIENGINE_USING_LATENCY
+    event->parent.stamp = stamp;
+#endif
 
     /* set cursor position */
     rtgui_mouse_set_position(event->x, event->y);
@@ -166,9 +674,15 @@ void rtgui_server_handle_mouse_motion(struct rtgui_event_mouse *event)
 void rtgui_server_handle_kbd(struct rtgui_event_kbd *event)
 {
     struct rtgui_topwin *wnd;
+#ifdef GUIENGINE_USING_LATENCY
+    rt_uint32_t stamp = event->parent.stamp;
+#endif
 
     /* re-init to server thread */
     RTGUI_EVENT_KBD_INIT(event);
+#ifdef GUIENGINE_USING_LATENCY
+    event->parent.stamp = stamp;
+#endif
 
     /* todo: handle input method and global shortcut */
 
@@ -190,6 +704,9 @@ void rtgui_server_handle_kbd(struct rtgui_event_kbd *event)
 
 void rtgui_server_handle_touch(struct rtgui_event_touch *event)
 {
+#ifdef GUIENGINE_USING_GESTURE
+    rtgui_gesture_handle_touch(event);
+#endif
 //  if (rtgui_touch_do_calibration(event) == RT_TRUE)
 //  {
 //      struct rtgui_event_mouse emouse;
@@ -230,11 +747,15 @@ static rt_bool_t rtgui_server_event_handler(struct rtgui_object *object,
     RT_ASSERT(object != RT_NULL);
     RT_ASSERT(event != RT_NULL);
 
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    _governor_input(event->type);
+#endif
     /* dispatch event */
     switch (event->type)
     {
     case RTGUI_EVENT_APP_CREATE:
     case RTGUI_EVENT_APP_DESTROY:
+        rtgui_server_cancel_frame(((struct rtgui_event_application *)event)->app);
         if (rtgui_wm_application != RT_NULL)
         {
             /* forward event to wm application */
@@ -270,7 +791,13 @@ static rt_bool_t rtgui_server_event_handler(struct rtgui_object *object,
 
     /* window event */
     case RTGUI_EVENT_WIN_CREATE:
-        if (rtgui_topwin_add((struct rtgui_event_win_create *)event) == RT_EOK)
+        if (event->ack == RT_NULL)
+        {
+            /* GUIENGINE_USING_ASYNC_WIN_CREATE, the show of it fails later */
+            if (rtgui_topwin_add((struct rtgui_event_win_create *)event) != RT_EOK)
+                rt_kprintf("create win: %s failed\n", ((struct rtgui_event_win_create *)event)->wid->title);
+        }
+        else if (rtgui_topwin_add((struct rtgui_event_win_create *)event) == RT_EOK)
             rtgui_ack(event, RTGUI_STATUS_OK);
         else
             rtgui_ack(event, RTGUI_STATUS_ERROR);
@@ -279,7 +806,13 @@ static rt_bool_t rtgui_server_event_handler(struct rtgui_object *object,
     case RTGUI_EVENT_WIN_SHOW:
         if (_show_win_hook) _show_win_hook();
         if (rtgui_topwin_show((struct rtgui_event_win *)event) == RT_EOK)
+        {
+#ifdef GUIENGINE_USING_BOOT_SNAPSHOT
+            /* the paint of window replaces the snapshot of boot */
+            rtgui_snapshot_swap();
+#endif
             rtgui_ack(event, RTGUI_STATUS_OK);
+        }
         else
             rtgui_ack(event, RTGUI_STATUS_ERROR);
         break;
@@ -314,6 +847,9 @@ static rt_bool_t rtgui_server_event_handler(struct rtgui_object *object,
         break;
 
     case RTGUI_EVENT_WIN_DESTROY:
+#ifdef GUIENGINE_USING_GESTURE
+        rtgui_gesture_cancel(((struct rtgui_event_win *)event)->wid);
+#endif
         if (rtgui_topwin_remove(((struct rtgui_event_win *)event)->wid) == RT_EOK)
             rtgui_ack(event, RTGUI_STATUS_OK);
         else
@@ -344,20 +880,26 @@ static rt_bool_t rtgui_server_event_handler(struct rtgui_object *object,
     case RTGUI_EVENT_COMMAND:
         break;
 
+    case RTGUI_EVENT_TIMER:
+        /* the damage flush timer */
+        return rtgui_app_event_handler(object, event);
+
+    case RTGUI_EVENT_VSYNC:
+        /* the panel is refreshing, present the damage */
+        rtgui_server_handle_vsync((struct rtgui_event_vsync *)event);
+        break;
+
+    case RTGUI_EVENT_FRAME_REQUEST:
+        rtgui_server_handle_frame_request((struct rtgui_event_frame *)event);
+        break;
+
     case RTGUI_EVENT_UPDATE_BEGIN:
-#ifdef RTGUI_USING_MOUSE_CURSOR
-        /* hide cursor */
-        rtgui_mouse_hide_cursor();
-#endif
+        /* the cursor over the window is hidden by the drawing app */
         break;
 
     case RTGUI_EVENT_UPDATE_END:
         /* handle screen update */
         rtgui_server_handle_update((struct rtgui_event_update_end *)event);
-#ifdef RTGUI_USING_MOUSE_CURSOR
-        /* show cursor */
-        rtgui_mouse_show_cursor();
-#endif
         break;
 
     case RTGUI_EVENT_MONITOR_ADD:
@@ -378,6 +920,7 @@ static rt_bool_t rtgui_server_event_handler(struct rtgui_object *object,
  */
 static void rtgui_server_entry(void *parameter)
 {
+    int index;
 #ifdef _WIN32_NATIVE
     /* set the server thread to highest */
     HANDLE hCurrentThread = GetCurrentThread();
@@ -394,6 +937,16 @@ static void rtgui_server_entry(void *parameter)
 
     rtgui_object_set_event_handler(RTGUI_OBJECT(rtgui_server_app),
                                    rtgui_server_event_handler);
+    for (index = 0; index < RTGUI_DISPLAY_NUM; index ++)
+        rtgui_region_init(&_damage_region[index]);
+#if GUIENGINE_DAMAGE_FLUSH_MS > 0
+    _damage_timer = rtgui_timer_create(rt_tick_from_millisecond(GUIENGINE_DAMAGE_FLUSH_MS),
+                                       RT_TIMER_FLAG_ONE_SHOT,
+                                       rtgui_server_damage_timeout, RT_NULL);
+#endif
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    _governor.input = rt_tick_get();
+#endif
     /* init mouse and show */
     rtgui_mouse_init();
 #ifdef RTGUI_USING_MOUSE_CURSOR
@@ -402,6 +955,35 @@ static void rtgui_server_entry(void *parameter)
 
     rtgui_app_run(rtgui_server_app);
 
+    if (_frame_timer != RT_NULL)
+    {
+        rtgui_timer_destory(_frame_timer);
+        _frame_timer = RT_NULL;
+    }
+#ifdef GUIENGINE_USING_FRAME_GOVERNOR
+    if (_governor.timer != RT_NULL)
+    {
+        rtgui_timer_destory(_governor.timer);
+        _governor.timer = RT_NULL;
+    }
+#endif
+#if GUIENGINE_DAMAGE_FLUSH_MS > 0
+    if (_damage_timer != RT_NULL)
+    {
+        rtgui_timer_destory(_damage_timer);
+        _damage_timer = RT_NULL;
+    }
+#endif
+#ifdef RTGUI_USING_WINMOVE
+    if (_winrect_timer != RT_NULL)
+    {
+        rtgui_timer_destory(_winrect_timer);
+        _winrect_timer = RT_NULL;
+    }
+#endif
+    for (index = 0; index < RTGUI_DISPLAY_NUM; index ++)
+        rtgui_region_fini(&_damage_region[index]);
+
     rtgui_app_destroy(rtgui_server_app);
     rtgui_server_app = RT_NULL;
 }
@@ -410,6 +992,15 @@ rt_err_t rtgui_server_post_event(struct rtgui_event *event, rt_size_t size)
 {
     rt_err_t result;
 
+#ifdef GUIENGINE_USING_LATENCY
+    /* stamp the input not stamped by driver on acquisition */
+    if (event->stamp == 0 &&
+            (event->type == RTGUI_EVENT_MOUSE_BUTTON ||
+             event->type == RTGUI_EVENT_KBD ||
+             event->type == RTGUI_EVENT_TOUCH))
+        rtgui_latency_stamp(event);
+#endif
+
     if (rtgui_server_app != RT_NULL)
     {
         result = rtgui_send(rtgui_server_app, event, size);
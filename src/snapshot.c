@@ -0,0 +1,268 @@
+/*
+ * File      : snapshot.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/driver.h>
+#include <rtgui/filerw.h>
+#include <rtgui/snapshot.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGINE_USING_BOOT_SNAPSHOT
+
+#ifndef PKG_USING_FASTLZ
+#error "the boot snapshot needs the fastlz package"
+#endif
+#ifndef GUIENGINE_USING_DFS_FILERW
+#error "the boot snapshot is saved in the file system"
+#endif
+extern int fastlz_compress(const void *input, int length, void *output);
+extern int fastlz_decompress(const void *input, int length, void *output, int maxout);
+
+#define SNAPSHOT_MAGIC      0x53535452  /* "RTSS" */
+/* the tag of block not compressed, or the length of compressed one */
+#define SNAPSHOT_RAW        0x80000000UL
+
+struct snapshot_header
+{
+    rt_uint32_t magic;
+    rt_uint8_t pixel_format;
+    rt_uint8_t reserved;
+    rt_uint16_t pitch;
+    rt_uint16_t width;
+    rt_uint16_t height;
+    /* the rows of each block */
+    rt_uint32_t rows;
+};
+
+enum
+{
+    SNAPSHOT_NONE,
+    /* the snapshot is on panel, the updates are held */
+    SNAPSHOT_HOLD,
+    /* the next update pushes the updates held */
+    SNAPSHOT_SWAP,
+};
+static volatile rt_uint8_t _snapshot_state = SNAPSHOT_NONE;
+static rtgui_rect_t _snapshot_held;
+
+static int _snapshot_rows(const struct rtgui_graphic_driver *driver)
+{
+    int rows = GUIENGINE_BOOT_SNAPSHOT_BLOCK / driver->pitch;
+
+    return rows > 0 ? rows : 1;
+}
+
+rt_err_t rtgui_snapshot_save(const char *filename)
+{
+    int y, rows, length, zlen;
+    rt_uint32_t tag;
+    rt_uint8_t *fb, *block, *data;
+    struct snapshot_header header;
+    struct rtgui_filerw *file;
+    struct rtgui_graphic_driver *driver;
+    rt_err_t result = -RT_EIO;
+
+    driver = rtgui_graphic_driver_get_default();
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL)
+        return -RT_ENOSYS;
+
+    rows = _snapshot_rows(driver);
+    length = rows * driver->pitch;
+    /* fastlz writes 5% more than the input in the worst case */
+    block = (rt_uint8_t *)rtgui_malloc(length + length / 16 + 66);
+    if (block == RT_NULL)
+        return -RT_ENOMEM;
+    file = rtgui_filerw_create_file(filename, "wb");
+    if (file == RT_NULL)
+    {
+        rtgui_free(block);
+        return -RT_EIO;
+    }
+
+    /* the magic is written after all the blocks */
+    rt_memset(&header, 0, sizeof(header));
+    header.pixel_format = driver->pixel_format;
+    header.pitch = driver->pitch;
+    header.width = driver->width;
+    header.height = driver->height;
+    header.rows = rows;
+    if (rtgui_filerw_write(file, &header, sizeof(header), 1) != 1)
+        goto __exit;
+
+    /* the pixels are not changed until they are written */
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    fb = driver->framebuffer;
+    for (y = 0; y < driver->height; y += rows)
+    {
+        length = _UI_MIN(rows, driver->height - y) * driver->pitch;
+        data = fb + y * driver->pitch;
+
+        zlen = fastlz_compress(data, length, block);
+        if (zlen > 0 && zlen < length)
+        {
+            tag = zlen;
+            data = block;
+        }
+        else
+        {
+            tag = length | SNAPSHOT_RAW;
+            zlen = length;
+        }
+
+        if (rtgui_filerw_write(file, &tag, sizeof(tag), 1) != 1 ||
+                rtgui_filerw_write(file, data, 1, zlen) != zlen)
+            break;
+    }
+    rtgui_screen_unlock();
+
+    if (y >= driver->height)
+    {
+        header.magic = SNAPSHOT_MAGIC;
+        if (rtgui_filerw_seek(file, 0, RTGUI_FILE_SEEK_SET) == 0 &&
+                rtgui_filerw_write(file, &header, sizeof(header), 1) == 1)
+            result = RT_EOK;
+    }
+
+__exit:
+    rtgui_filerw_close(file);
+    rtgui_free(block);
+    return result;
+}
+RTM_EXPORT(rtgui_snapshot_save);
+
+/*
+ * The blocks are decompressed to the framebuffer in place, and copied to the
+ * other pages of flipping. The driver without framebuffer writes the rows of
+ * each block by pixel_ops.
+ */
+rt_err_t rtgui_snapshot_show(const char *filename)
+{
+    int index, y, rows, length;
+    rt_uint32_t tag;
+    rt_uint8_t *fb, *block, *dst;
+    struct snapshot_header header;
+    struct rtgui_filerw *file;
+    struct rtgui_graphic_driver *driver;
+    rtgui_rect_t rect;
+    rt_err_t result = -RT_ERROR;
+
+    driver = rtgui_graphic_driver_get_default();
+    if (driver == RT_NULL || (driver->framebuffer == RT_NULL && driver->pixel_ops == RT_NULL))
+        return -RT_ENOSYS;
+
+    file = rtgui_filerw_create_file(filename, "rb");
+    if (file == RT_NULL)
+        return -RT_EIO;
+    if (rtgui_filerw_read(file, &header, sizeof(header), 1) != 1 ||
+            header.magic != SNAPSHOT_MAGIC || header.rows == 0 ||
+            header.pixel_format != driver->pixel_format || header.pitch != driver->pitch ||
+            header.width != driver->width || header.height != driver->height)
+    {
+        rtgui_filerw_close(file);
+        return -RT_ERROR;
+    }
+
+    /* the compressed block is smaller than the rows of it */
+    fb = driver->framebuffer;
+    length = header.rows * header.pitch;
+    block = (rt_uint8_t *)rtgui_malloc(fb != RT_NULL ? length : 2 * length);
+    if (block == RT_NULL)
+    {
+        rtgui_filerw_close(file);
+        return -RT_ENOMEM;
+    }
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    for (y = 0; y < header.height; y += rows)
+    {
+        rows = _UI_MIN((int)header.rows, header.height - y);
+        length = rows * header.pitch;
+        dst = fb != RT_NULL ? fb + y * header.pitch : block + header.rows * header.pitch;
+
+        if (rtgui_filerw_read(file, &tag, sizeof(tag), 1) != 1)
+            break;
+        if (tag & SNAPSHOT_RAW)
+        {
+            if ((int)(tag & ~SNAPSHOT_RAW) != length ||
+                    rtgui_filerw_read(file, dst, 1, length) != length)
+                break;
+        }
+        else if ((int)tag >= length || rtgui_filerw_read(file, block, 1, tag) != (int)tag ||
+                 fastlz_decompress(block, tag, dst, length) != length)
+        {
+            break;
+        }
+
+        if (fb == RT_NULL)
+            driver->pixel_ops->blit_rect(dst, header.pitch, 0, y, header.width, rows);
+    }
+
+    if (y >= header.height)
+    {
+        for (index = 0; index < driver->page_num; index ++)
+        {
+            if (driver->pages[index] != fb)
+                rt_memcpy(driver->pages[index], fb, header.height * header.pitch);
+        }
+
+        rtgui_graphic_driver_get_rect(driver, &rect);
+        rtgui_graphic_driver_screen_update(driver, &rect);
+        /* the snapshot stays on panel until the first window is shown */
+        rtgui_rect_init(&_snapshot_held, 0, 0, 0, 0);
+        _snapshot_state = SNAPSHOT_HOLD;
+        result = RT_EOK;
+    }
+    rtgui_screen_unlock();
+
+    rtgui_filerw_close(file);
+    rtgui_free(block);
+    return result;
+}
+RTM_EXPORT(rtgui_snapshot_show);
+
+rt_bool_t rtgui_snapshot_hold(const rtgui_rect_t *rect, rtgui_rect_t *update)
+{
+    *update = *rect;
+    if (_snapshot_state == SNAPSHOT_NONE)
+        return RT_FALSE;
+
+    rtgui_rect_union(update, &_snapshot_held);
+    if (_snapshot_state == SNAPSHOT_HOLD)
+        return RT_TRUE;
+
+    /* the live UI replaces the snapshot in one update */
+    *update = _snapshot_held;
+    _snapshot_state = SNAPSHOT_NONE;
+    return RT_FALSE;
+}
+
+void rtgui_snapshot_swap(void)
+{
+    if (_snapshot_state == SNAPSHOT_HOLD)
+        _snapshot_state = SNAPSHOT_SWAP;
+}
+
+#endif
@@ -0,0 +1,322 @@
+/*
+ * File      : text_edit.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_FONT
+
+#include <rtthread.h>
+#include <rtgui/rtgui.h>
+#include <rtgui/dc.h>
+#include <rtgui/text_edit.h>
+#include <rtgui/rtgui_system.h>
+
+struct rtgui_text_edit *rtgui_text_edit_create(struct rtgui_font *font, rt_ubase_t capacity)
+{
+    struct rtgui_text_edit *edit;
+
+    RT_ASSERT(font != RT_NULL);
+
+    /* the text and the positions in one block */
+    edit = (struct rtgui_text_edit *)rtgui_malloc(sizeof(struct rtgui_text_edit) +
+            (capacity + 1) * sizeof(rt_uint16_t) + capacity + 1);
+    if (edit == RT_NULL)
+        return RT_NULL;
+
+    edit->font = font;
+    edit->len = 0;
+    edit->capacity = capacity;
+    edit->positions = (rt_uint16_t *)(edit + 1);
+    edit->text = (char *)(edit->positions + capacity + 1);
+    edit->text[0] = '\0';
+    edit->positions[0] = 0;
+    edit->caret = 0;
+    edit->caret_on = RT_FALSE;
+
+    /* keep the font until the edit is destroyed */
+    font->refer_count ++;
+
+    return edit;
+}
+RTM_EXPORT(rtgui_text_edit_create);
+
+void rtgui_text_edit_destroy(struct rtgui_text_edit *edit)
+{
+    if (edit == RT_NULL)
+        return;
+
+    rtgui_font_derefer(edit->font);
+    rtgui_free(edit);
+}
+RTM_EXPORT(rtgui_text_edit_destroy);
+
+/* measure the positions after the boundary of character from */
+static void _edit_layout(struct rtgui_text_edit *edit, rt_ubase_t from)
+{
+    rt_uint16_t base;
+    rt_ubase_t index;
+
+    /* the width of text in the engines of prepared text is not the sum of characters */
+    if (from == 0 || edit->font->engine == RT_NULL ||
+            edit->font->engine->font_prepare_text != RT_NULL)
+    {
+        rtgui_font_get_text_positions(edit->font, edit->text, edit->len, edit->positions);
+        return;
+    }
+
+    base = edit->positions[from];
+    rtgui_font_get_text_positions(edit->font, edit->text + from, edit->len - from, edit->positions + from);
+    for (index = from; index <= edit->len; index ++)
+        edit->positions[index] += base;
+}
+
+/* the boundary of the next character */
+static rt_ubase_t _edit_next(struct rtgui_text_edit *edit, rt_ubase_t pos)
+{
+    pos += rtgui_font_char_len(edit->text + pos);
+
+    return pos > edit->len ? edit->len : pos;
+}
+
+/* the end of the whole characters from the boundary in the width */
+static rt_ubase_t _edit_visible_end(struct rtgui_text_edit *edit, rt_ubase_t from, int width)
+{
+    rt_ubase_t pos, next;
+
+    if (edit->positions[edit->len] <= width)
+        return edit->len;
+
+    for (pos = from; pos < edit->len; pos = next)
+    {
+        next = _edit_next(edit, pos);
+        if (edit->positions[next] > width) break;
+    }
+
+    return pos;
+}
+
+static void _edit_caret_rect(struct rtgui_text_edit *edit, rtgui_rect_t *rect, rtgui_rect_t *caret)
+{
+    int x, height;
+
+    x = rect->x1 + edit->positions[edit->caret];
+    if (x >= rect->x2) x = rect->x2 - 1;
+
+    height = edit->font->height;
+    if (height > rtgui_rect_height(*rect)) height = rtgui_rect_height(*rect);
+
+    caret->x1 = x;
+    caret->x2 = x + 1;
+    caret->y1 = rect->y1 + (rtgui_rect_height(*rect) - height) / 2;
+    caret->y2 = caret->y1 + height;
+}
+
+/* repaint the characters from the boundary to end and the background until x2 */
+static void _edit_repaint(struct rtgui_text_edit *edit, struct rtgui_dc *dc, rtgui_rect_t *rect,
+                          rt_ubase_t from, rt_ubase_t end, int x2)
+{
+    rt_uint16_t align;
+    rtgui_rect_t r, caret;
+
+    r = *rect;
+    r.x1 = rect->x1 + edit->positions[from];
+    if (x2 < r.x2) r.x2 = x2;
+    if (r.x1 >= r.x2) return;
+
+    /* the glyphs are drawn on the background, not blended twice */
+    rtgui_dc_fill_rect(dc, &r);
+    if (end > from)
+    {
+        align = RTGUI_DC_TEXTALIGN(dc);
+        RTGUI_DC_TEXTALIGN(dc) = RTGUI_ALIGN_CENTER_VERTICAL;
+        r.x2 = rect->x2;
+        rtgui_font_draw(edit->font, dc, edit->text + from, end - from, &r);
+        RTGUI_DC_TEXTALIGN(dc) = align;
+    }
+
+    if (edit->caret_on)
+    {
+        _edit_caret_rect(edit, rect, &caret);
+        if (caret.x1 >= rect->x1 + edit->positions[from] && caret.x1 < x2)
+            rtgui_dc_fill_rect_forecolor(dc, &caret);
+    }
+}
+
+/* repaint from the edit point to the end of visible line */
+static void _edit_repaint_tail(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                               rtgui_rect_t *rect, rt_ubase_t from)
+{
+    if (dc == RT_NULL) return;
+
+    _edit_repaint(edit, dc, rect, from,
+                  _edit_visible_end(edit, from, rtgui_rect_width(*rect)), rect->x2);
+}
+
+/* repaint the caret and the character under it */
+static void _edit_repaint_caret(struct rtgui_text_edit *edit, struct rtgui_dc *dc, rtgui_rect_t *rect)
+{
+    int x2;
+    rt_ubase_t next;
+    rtgui_rect_t caret;
+
+    if (dc == RT_NULL) return;
+
+    _edit_caret_rect(edit, rect, &caret);
+    next = _edit_next(edit, edit->caret);
+    if (rect->x1 + edit->positions[next] > rect->x2)
+        next = edit->caret;
+
+    x2 = rect->x1 + edit->positions[next];
+    if (x2 < caret.x2) x2 = caret.x2;
+    _edit_repaint(edit, dc, rect, edit->caret, next, x2);
+}
+
+rt_err_t rtgui_text_edit_set_text(struct rtgui_text_edit *edit, const char *text)
+{
+    rt_ubase_t len;
+
+    RT_ASSERT(edit != RT_NULL && text != RT_NULL);
+
+    len = rt_strlen(text);
+    if (len > edit->capacity)
+        return -RT_EFULL;
+
+    rt_memcpy(edit->text, text, len + 1);
+    edit->len = len;
+    edit->caret = len;
+    _edit_layout(edit, 0);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_text_edit_set_text);
+
+void rtgui_text_edit_draw(struct rtgui_text_edit *edit, struct rtgui_dc *dc, rtgui_rect_t *rect)
+{
+    RT_ASSERT(edit != RT_NULL && rect != RT_NULL);
+
+    _edit_repaint_tail(edit, dc, rect, 0);
+}
+RTM_EXPORT(rtgui_text_edit_draw);
+
+rt_err_t rtgui_text_edit_insert(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                                rtgui_rect_t *rect, const char *text)
+{
+    rt_ubase_t len, from;
+
+    RT_ASSERT(edit != RT_NULL && text != RT_NULL);
+
+    len = rt_strlen(text);
+    if (len == 0)
+        return RT_EOK;
+    if (len > edit->capacity - edit->len)
+        return -RT_EFULL;
+
+    from = edit->caret;
+    rt_memmove(edit->text + from + len, edit->text + from, edit->len - from + 1);
+    rt_memcpy(edit->text + from, text, len);
+    edit->len += len;
+    edit->caret += len;
+
+    _edit_layout(edit, from);
+    _edit_repaint_tail(edit, dc, rect, from);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_text_edit_insert);
+
+rt_err_t rtgui_text_edit_delete(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                                rtgui_rect_t *rect, rt_bool_t forward)
+{
+    rt_ubase_t from, to, next;
+
+    RT_ASSERT(edit != RT_NULL);
+
+    if (forward)
+    {
+        if (edit->caret == edit->len)
+            return -RT_EEMPTY;
+
+        from = edit->caret;
+        to = _edit_next(edit, from);
+    }
+    else
+    {
+        if (edit->caret == 0)
+            return -RT_EEMPTY;
+
+        /* the characters can only be stepped from the beginning */
+        to = edit->caret;
+        for (from = 0; (next = _edit_next(edit, from)) < to; from = next);
+    }
+
+    rt_memmove(edit->text + from, edit->text + to, edit->len - to + 1);
+    edit->len -= to - from;
+    edit->caret = from;
+
+    _edit_layout(edit, from);
+    _edit_repaint_tail(edit, dc, rect, from);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_text_edit_delete);
+
+void rtgui_text_edit_set_caret(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                               rtgui_rect_t *rect, rt_ubase_t offset)
+{
+    rt_bool_t caret_on;
+
+    RT_ASSERT(edit != RT_NULL);
+
+    if (offset > edit->len) offset = edit->len;
+    if (offset == edit->caret)
+        return;
+
+    /* erase the caret at the old offset */
+    caret_on = edit->caret_on;
+    edit->caret_on = RT_FALSE;
+    if (caret_on)
+        _edit_repaint_caret(edit, dc, rect);
+
+    edit->caret = offset;
+    edit->caret_on = caret_on;
+    if (caret_on)
+        _edit_repaint_caret(edit, dc, rect);
+}
+RTM_EXPORT(rtgui_text_edit_set_caret);
+
+void rtgui_text_edit_hit(struct rtgui_text_edit *edit, struct rtgui_dc *dc,
+                         rtgui_rect_t *rect, int x)
+{
+    RT_ASSERT(edit != RT_NULL && rect != RT_NULL);
+
+    rtgui_text_edit_set_caret(edit, dc, rect,
+                              rtgui_font_hit_test(edit->positions, edit->len, x - rect->x1));
+}
+RTM_EXPORT(rtgui_text_edit_hit);
+
+void rtgui_text_edit_blink(struct rtgui_text_edit *edit, struct rtgui_dc *dc, rtgui_rect_t *rect)
+{
+    RT_ASSERT(edit != RT_NULL);
+
+    edit->caret_on = !edit->caret_on;
+    _edit_repaint_caret(edit, dc, rect);
+}
+RTM_EXPORT(rtgui_text_edit_blink);
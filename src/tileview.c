@@ -0,0 +1,415 @@
+/*
+ * File      : tileview.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#define RTGUI_MEM_TAG   RTGUI_MEM_IMAGE
+
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_system.h>
+#include <rtgui/widgets/tileview.h>
+
+#if defined(GUIENGINE_USING_DFS_FILERW)
+
+/* the filename of a tile formatted from the pattern */
+#define TILEVIEW_NAME_MAX   128
+
+static void _rtgui_tileview_constructor(rtgui_tileview_t *view)
+{
+    rtgui_object_set_event_handler(RTGUI_OBJECT(view), rtgui_tileview_event_handler);
+
+    view->pattern = RT_NULL;
+    view->tile_w = view->tile_h = 1;
+    view->cols = view->rows = 0;
+    view->scroll_x = view->scroll_y = 0;
+    rt_list_init(&view->tiles);
+    view->tile_count = 0;
+}
+
+static void _tileview_tile_reset(struct rtgui_tileview_tile *tile)
+{
+    /* the callback is not invoked after the cancel */
+    if (tile->request != RT_NULL)
+    {
+        rtgui_image_request_cancel(tile->request);
+        tile->request = RT_NULL;
+    }
+    if (tile->image != RT_NULL)
+    {
+        rtgui_image_destroy(tile->image);
+        tile->image = RT_NULL;
+    }
+    tile->col = tile->row = -1;
+}
+
+static void _rtgui_tileview_destructor(rtgui_tileview_t *view)
+{
+    struct rtgui_tileview_tile *tile;
+
+    while (!rt_list_isempty(&view->tiles))
+    {
+        tile = rt_list_entry(view->tiles.next, struct rtgui_tileview_tile, list);
+        rt_list_remove(&tile->list);
+        _tileview_tile_reset(tile);
+        rtgui_free(tile);
+    }
+    if (view->pattern != RT_NULL)
+        rt_free(view->pattern);
+}
+
+DEFINE_CLASS_TYPE(tileview, "tileview",
+                  RTGUI_PARENT_TYPE(widget),
+                  _rtgui_tileview_constructor,
+                  _rtgui_tileview_destructor,
+                  sizeof(struct rtgui_tileview));
+RTM_EXPORT(_rtgui_tileview);
+
+rtgui_tileview_t *rtgui_tileview_create(const char *pattern, int tile_w, int tile_h, int cols, int rows)
+{
+    rtgui_tileview_t *view;
+
+    RT_ASSERT(pattern != RT_NULL && tile_w > 0 && tile_h > 0);
+
+    view = (rtgui_tileview_t *)rtgui_widget_create(RTGUI_TILEVIEW_TYPE);
+    if (view != RT_NULL)
+    {
+        view->pattern = rt_strdup(pattern);
+        if (view->pattern == RT_NULL)
+        {
+            rtgui_widget_destroy(RTGUI_WIDGET(view));
+            return RT_NULL;
+        }
+        view->tile_w = tile_w;
+        view->tile_h = tile_h;
+        view->cols = cols;
+        view->rows = rows;
+    }
+
+    return view;
+}
+RTM_EXPORT(rtgui_tileview_create);
+
+void rtgui_tileview_destroy(rtgui_tileview_t *view)
+{
+    rtgui_widget_destroy(RTGUI_WIDGET(view));
+}
+RTM_EXPORT(rtgui_tileview_destroy);
+
+static int _tileview_max_x(rtgui_tileview_t *view)
+{
+    int max;
+
+    max = view->cols * view->tile_w - rtgui_rect_width(RTGUI_WIDGET(view)->extent);
+    return max > 0 ? max : 0;
+}
+
+static int _tileview_max_y(rtgui_tileview_t *view)
+{
+    int max;
+
+    max = view->rows * view->tile_h - rtgui_rect_height(RTGUI_WIDGET(view)->extent);
+    return max > 0 ? max : 0;
+}
+
+/* the tiles cover the view in the rect of tiles, x2 and y2 are not included */
+static void _tileview_range(rtgui_tileview_t *view, rtgui_rect_t *range)
+{
+    int w, h;
+
+    w = rtgui_rect_width(RTGUI_WIDGET(view)->extent);
+    h = rtgui_rect_height(RTGUI_WIDGET(view)->extent);
+    range->x1 = view->scroll_x / view->tile_w;
+    range->y1 = view->scroll_y / view->tile_h;
+    range->x2 = _UI_MIN((view->scroll_x + w + view->tile_w - 1) / view->tile_w, view->cols);
+    range->y2 = _UI_MIN((view->scroll_y + h + view->tile_h - 1) / view->tile_h, view->rows);
+}
+
+/* the tiles to cover the view in any scroll */
+static int _tileview_capacity(rtgui_tileview_t *view)
+{
+    int need;
+
+    need = (rtgui_rect_width(RTGUI_WIDGET(view)->extent) / view->tile_w + 2) *
+           (rtgui_rect_height(RTGUI_WIDGET(view)->extent) / view->tile_h + 2);
+    return need > GUIENGINE_TILEVIEW_TILES ? need : GUIENGINE_TILEVIEW_TILES;
+}
+
+/* the rect of tile in the logical coordinate of view */
+static void _tileview_tile_rect(rtgui_tileview_t *view, int col, int row, rtgui_rect_t *rect)
+{
+    rect->x1 = col * view->tile_w - view->scroll_x;
+    rect->y1 = row * view->tile_h - view->scroll_y;
+    rect->x2 = rect->x1 + view->tile_w;
+    rect->y2 = rect->y1 + view->tile_h;
+}
+
+static rt_bool_t _tileview_in_range(const rtgui_rect_t *range, int col, int row)
+{
+    return col >= range->x1 && col < range->x2 && row >= range->y1 && row < range->y2;
+}
+
+/* the tile decoded in the loader, it's painted if it's still in view */
+static void _tileview_tile_done(struct rtgui_image_request *request, struct rtgui_image *image,
+                                void *user_data)
+{
+    rtgui_rect_t range, rect;
+    rtgui_widget_t *widget;
+    struct rtgui_tileview_tile *tile = (struct rtgui_tileview_tile *)user_data;
+
+    tile->request = RT_NULL;
+    tile->image = image;
+    if (image == RT_NULL)
+        return;
+
+    widget = RTGUI_WIDGET(tile->view);
+    _tileview_range(tile->view, &range);
+    if (_tileview_in_range(&range, tile->col, tile->row) &&
+            widget->toplevel != RT_NULL && !RTGUI_WIDGET_IS_HIDE(widget))
+    {
+        _tileview_tile_rect(tile->view, tile->col, tile->row, &rect);
+        rtgui_widget_invalidate(widget, &rect);
+    }
+}
+
+/* the cached tile is moved to the head as the most recently used */
+static struct rtgui_tileview_tile *_tileview_find(rtgui_tileview_t *view, int col, int row)
+{
+    rt_list_t *node;
+    struct rtgui_tileview_tile *tile;
+
+    rt_list_for_each(node, &view->tiles)
+    {
+        tile = rt_list_entry(node, struct rtgui_tileview_tile, list);
+        if (tile->col == col && tile->row == row)
+        {
+            rt_list_remove(&tile->list);
+            rt_list_insert_after(&view->tiles, &tile->list);
+            return tile;
+        }
+    }
+
+    return RT_NULL;
+}
+
+/*
+ * Get the tile, the one not cached is requested in the least recently used
+ * tile. The prefetch in background does not take a tile in view.
+ */
+static struct rtgui_tileview_tile *_tileview_get(rtgui_tileview_t *view, int col, int row,
+                                                 rt_bool_t background)
+{
+    char filename[TILEVIEW_NAME_MAX];
+    rtgui_rect_t range;
+    struct rtgui_tileview_tile *tile;
+
+    tile = _tileview_find(view, col, row);
+    if (tile != RT_NULL)
+        return tile;
+
+    if (view->tile_count < _tileview_capacity(view))
+    {
+        tile = (struct rtgui_tileview_tile *)rtgui_malloc(sizeof(struct rtgui_tileview_tile));
+        if (tile == RT_NULL)
+            return RT_NULL;
+        tile->view = view;
+        tile->image = RT_NULL;
+        tile->request = RT_NULL;
+        view->tile_count ++;
+    }
+    else
+    {
+        tile = rt_list_entry(view->tiles.prev, struct rtgui_tileview_tile, list);
+        _tileview_range(view, &range);
+        if (background && _tileview_in_range(&range, tile->col, tile->row))
+            return RT_NULL;
+        rt_list_remove(&tile->list);
+        _tileview_tile_reset(tile);
+    }
+    rt_list_insert_after(&view->tiles, &tile->list);
+
+    tile->col = col;
+    tile->row = row;
+    rt_snprintf(filename, sizeof(filename), view->pattern, col, row);
+    if (background)
+        tile->request = rtgui_image_load_background(filename, _tileview_tile_done, tile);
+    else
+        tile->request = rtgui_image_load_async(filename, _tileview_tile_done, tile);
+    if (tile->request == RT_NULL)
+        tile->col = tile->row = -1;
+
+    return tile;
+}
+
+static void _tileview_prefetch(rtgui_tileview_t *view, const rtgui_rect_t *range)
+{
+    int col, row;
+
+    for (row = range->y1 - 1; row <= range->y2; row ++)
+    {
+        for (col = range->x1 - 1; col <= range->x2; col ++)
+        {
+            if (col < 0 || col >= view->cols || row < 0 || row >= view->rows ||
+                    _tileview_in_range(range, col, row))
+                continue;
+            _tileview_get(view, col, row, RT_TRUE);
+        }
+    }
+}
+
+static void _tileview_paint(rtgui_tileview_t *view)
+{
+    int col, row;
+    struct rtgui_dc *dc;
+    rtgui_rect_t range, rect, area;
+    struct rtgui_tileview_tile *tile;
+    rtgui_widget_t *widget = RTGUI_WIDGET(view);
+
+    dc = rtgui_dc_begin_drawing(widget);
+    if (dc == RT_NULL)
+        return;
+
+    _tileview_range(view, &range);
+    /* keep the tiles in view first, then load the missing ones */
+    for (row = range.y1; row < range.y2; row ++)
+        for (col = range.x1; col < range.x2; col ++)
+            _tileview_find(view, col, row);
+
+    for (row = range.y1; row < range.y2; row ++)
+    {
+        for (col = range.x1; col < range.x2; col ++)
+        {
+            tile = _tileview_get(view, col, row, RT_FALSE);
+            _tileview_tile_rect(view, col, row, &rect);
+            if (tile != RT_NULL && tile->image != RT_NULL)
+                rtgui_image_blit(tile->image, dc, &rect);
+            else
+                rtgui_dc_fill_rect(dc, &rect);
+        }
+    }
+
+    /* the view larger than the image */
+    rtgui_widget_get_rect(widget, &rect);
+    area = rect;
+    area.x1 = view->cols * view->tile_w - view->scroll_x;
+    if (area.x1 < area.x2)
+        rtgui_dc_fill_rect(dc, &area);
+    area = rect;
+    area.y1 = view->rows * view->tile_h - view->scroll_y;
+    if (area.y1 < area.y2)
+        rtgui_dc_fill_rect(dc, &area);
+
+    rtgui_dc_end_drawing(dc, 1);
+
+    _tileview_prefetch(view, &range);
+}
+
+rt_bool_t rtgui_tileview_event_handler(struct rtgui_object *object, struct rtgui_event *event)
+{
+    rtgui_tileview_t *view;
+
+    RT_ASSERT(object != RT_NULL);
+    RT_ASSERT(event != RT_NULL);
+
+    view = RTGUI_TILEVIEW(object);
+    switch (event->type)
+    {
+    case RTGUI_EVENT_PAINT:
+        _tileview_paint(view);
+        return RT_FALSE;
+
+    case RTGUI_EVENT_RESIZE:
+        if (view->scroll_x > _tileview_max_x(view))
+            view->scroll_x = _tileview_max_x(view);
+        if (view->scroll_y > _tileview_max_y(view))
+            view->scroll_y = _tileview_max_y(view);
+        return RT_FALSE;
+
+    default:
+        break;
+    }
+
+    return rtgui_widget_event_handler(object, event);
+}
+RTM_EXPORT(rtgui_tileview_event_handler);
+
+/*
+ * Scroll the view by copying the pixels in view, only the tiles exposed are
+ * painted. The tiles around the view are prefetched in the paint, so a smooth
+ * pan hits the decoded ones.
+ */
+void rtgui_tileview_scroll_to(rtgui_tileview_t *view, int x, int y)
+{
+    int dx, dy, index;
+    struct rtgui_dc *dc;
+    rtgui_rect_t rect, *rects;
+    rtgui_region_t exposed;
+    rtgui_widget_t *widget;
+
+    RT_ASSERT(view != RT_NULL);
+
+    widget = RTGUI_WIDGET(view);
+    x = _UI_MIN(x, _tileview_max_x(view));
+    y = _UI_MIN(y, _tileview_max_y(view));
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    dx = view->scroll_x - x;
+    dy = view->scroll_y - y;
+    if (dx == 0 && dy == 0)
+        return;
+    view->scroll_x = x;
+    view->scroll_y = y;
+
+    if (widget->toplevel == RT_NULL || RTGUI_WIDGET_IS_HIDE(widget))
+        return;
+
+    rtgui_region_init(&exposed);
+    dc = rtgui_dc_begin_drawing(widget);
+    if (dc == RT_NULL)
+        return;
+    rtgui_widget_get_rect(widget, &rect);
+    rtgui_dc_scroll(dc, &rect, dx, dy, &exposed);
+    rtgui_dc_end_drawing(dc, 1);
+
+    /* the exposed strips of a diagonal pan are painted separately */
+    rects = rtgui_region_rects(&exposed);
+    for (index = 0; index < rtgui_region_num_rects(&exposed); index ++)
+        rtgui_widget_update_rect(widget, &rects[index]);
+    rtgui_region_fini(&exposed);
+}
+RTM_EXPORT(rtgui_tileview_scroll_to);
+
+void rtgui_tileview_flush(rtgui_tileview_t *view)
+{
+    rt_list_t *node;
+    rtgui_widget_t *widget;
+
+    RT_ASSERT(view != RT_NULL);
+
+    rt_list_for_each(node, &view->tiles)
+        _tileview_tile_reset(rt_list_entry(node, struct rtgui_tileview_tile, list));
+
+    widget = RTGUI_WIDGET(view);
+    if (widget->toplevel != RT_NULL && !RTGUI_WIDGET_IS_HIDE(widget))
+        rtgui_widget_update_rect(widget, RT_NULL);
+}
+RTM_EXPORT(rtgui_tileview_flush);
+
+#endif
@@ -21,6 +21,7 @@
  * Date           Author       Notes
  * 2009-10-16     Bernard      first version
  */
+#include <rtgui/dc.h>
 #include <rtgui/rtgui_system.h>
 //#include <rtgui/rtgui_theme.h>
 
@@ -34,6 +35,9 @@ static void _rtgui_wintitle_constructor(rtgui_wintitle_t *wintitle)
 {
     RTGUI_WIDGET(wintitle)->flag = RTGUI_WIDGET_FLAG_DEFAULT;
     RTGUI_WIDGET_TEXTALIGN(wintitle) = RTGUI_ALIGN_CENTER_VERTICAL;
+#ifdef GUIENGINE_USING_TITLE_CACHE
+    wintitle->cache = RT_NULL;
+#endif
 
     rtgui_object_set_event_handler(RTGUI_OBJECT(wintitle),
                                    rtgui_wintile_event_handler);
@@ -41,6 +45,13 @@ static void _rtgui_wintitle_constructor(rtgui_wintitle_t *wintitle)
 
 static void _rtgui_wintitle_deconstructor(rtgui_wintitle_t *wintitle)
 {
+#ifdef GUIENGINE_USING_TITLE_CACHE
+    if (wintitle->cache != RT_NULL)
+    {
+        rtgui_dc_destory(wintitle->cache);
+        wintitle->cache = RT_NULL;
+    }
+#endif
 }
 
 DEFINE_CLASS_TYPE(wintitle, "wintitle",
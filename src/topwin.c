@@ -33,6 +33,27 @@
 #include <rtgui/rtgui_app.h>
 #include <rtgui/widgets/window.h>
 #include <rtgui/widgets/container.h>
+#include <rtgui/trace.h>
+#ifdef GUIENGINE_USING_BACKING_STORE
+#include <rtgui/dc.h>
+#endif
+
+#ifdef GUIENGINE_USING_BACKING_ZIP
+#ifndef GUIENGINE_USING_BACKING_STORE
+#error "the backing zip compresses the backing stores"
+#endif
+#ifndef PKG_USING_FASTLZ
+#error "the backing zip needs the fastlz package"
+#endif
+extern int fastlz_compress(const void *input, int length, void *output);
+extern int fastlz_decompress(const void *input, int length, void *output, int maxout);
+#endif
+
+#if defined(GUIENGINE_USING_MOVE_COPY) && !defined(GUIENGINE_USING_COMPOSITOR) && \
+    !defined(GUIENGINE_USING_BACKING_STORE)
+#define TOPWIN_MOVE_COPY
+#include <rtgui/blit.h>
+#endif
 
 /*
  * windows tree in the server side.
@@ -65,7 +86,24 @@
 static rt_list_t _rtgui_topwin_list = RT_LIST_OBJECT_INIT(_rtgui_topwin_list);
 static struct rt_semaphore _rtgui_topwin_lock;
 
-static void rtgui_topwin_update_clip(void);
+#ifndef GUIENGINE_USING_COMPOSITOR
+/*
+ * The last window hit, with and without the modaled windows. The clips of the
+ * shown windows partition the screen and the clip of a window is where it is
+ * hit, so the motions in the rect of clip hit last time are not looked up in
+ * the tree again. It's cleared when the clips, the tree or the modal change.
+ */
+static struct rtgui_topwin *_rtgui_topwin_hit[2];
+static rtgui_rect_t _rtgui_topwin_hit_box[2];
+#define _rtgui_topwin_hit_clear()   \
+    do { _rtgui_topwin_hit[0] = _rtgui_topwin_hit[1] = RT_NULL; } while (0)
+#else
+/* the layers are not clipped by the others */
+#define _rtgui_topwin_hit_clear()
+#endif
+
+static void rtgui_topwin_update_clip(struct rtgui_rect *rect);
+static void _rtgui_topwin_update_clip_tree(struct rtgui_topwin *topwin);
 static void rtgui_topwin_redraw(struct rtgui_rect *rect);
 static void _rtgui_topwin_activate_next(enum rtgui_topwin_flag);
 
@@ -145,11 +183,25 @@ rt_err_t rtgui_topwin_add(struct rtgui_event_win_create *event)
         topwin->flag |= WINTITLE_ONTOP;
     if (event->parent.user & RTGUI_WIN_STYLE_ONBTM)
         topwin->flag |= WINTITLE_ONBTM;
+#ifdef GUIENGINE_USING_BACKING_STORE
+    if (event->parent.user & RTGUI_WIN_STYLE_BACKING_STORE)
+        topwin->flag |= WINTITLE_BACKING;
+    topwin->backing = RT_NULL;
+    topwin->backing_valid = RT_FALSE;
+#ifdef GUIENGINE_USING_BACKING_ZIP
+    topwin->backing_zip = RT_NULL;
+#endif
+#endif
 
     topwin->title = RT_NULL;
 
     rtgui_list_init(&topwin->monitor_list);
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+    /* the window draws to the screen directly without layer */
+    event->wid->layer = rtgui_layer_create(&topwin->extent);
+#endif
+
     return RT_EOK;
 }
 
@@ -308,6 +360,7 @@ static struct rt_list_node *_rtgui_topwin_free_tree(struct rtgui_topwin *topwin)
     struct rt_list_node *node, *next_node;
 
     RT_ASSERT(topwin != RT_NULL);
+    _rtgui_topwin_hit_clear();
 
     node = topwin->child_list.next;
     while (node != &topwin->child_list)
@@ -326,14 +379,467 @@ static struct rt_list_node *_rtgui_topwin_free_tree(struct rtgui_topwin *topwin)
         rtgui_free(monitor);
     }
 
+#ifdef GUIENGINE_USING_BACKING_STORE
+    if (topwin->backing != RT_NULL)
+        rtgui_dc_destory(topwin->backing);
+#ifdef GUIENGINE_USING_BACKING_ZIP
+    rtgui_free(topwin->backing_zip);
+#endif
+#endif
+#ifdef GUIENGINE_USING_COMPOSITOR
+    if (topwin->wid->layer != RT_NULL)
+    {
+        struct rtgui_layer *layer = topwin->wid->layer;
+
+        /* not in drawing */
+        rtgui_screen_lock(RT_WAITING_FOREVER);
+        topwin->wid->layer = RT_NULL;
+        rtgui_screen_unlock();
+        rtgui_layer_destroy(layer);
+    }
+#endif
     rtgui_free(topwin);
     return next_node;
 }
 
+#ifdef GUIENGINE_USING_BACKING_STORE
+/*
+ * The backing store of window is the screen under it (a save-under): it's
+ * saved when the window is shown, and the exposed area is restored from it
+ * by the server when the window is hidden, moved or removed, without the
+ * repaint of the windows under it. It's stale once a window out of the tree
+ * of window updates the area under it, then the windows are repainted as
+ * usual. Only the driver with framebuffer is supported.
+ */
+static rt_bool_t _rtgui_topwin_in_tree(struct rtgui_topwin *topwin, struct rtgui_topwin *root)
+{
+    for (; topwin != RT_NULL; topwin = topwin->parent)
+    {
+        if (topwin == root)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+static void _rtgui_topwin_backing_rows(rt_uint8_t *dst, int dst_pitch,
+                                       const rt_uint8_t *src, int src_pitch,
+                                       int bytes, int rows)
+{
+    while (rows --)
+    {
+        rt_memcpy(dst, src, bytes);
+        dst += dst_pitch;
+        src += src_pitch;
+    }
+}
+
+/* the pixels of the rect on screen in the backing store of @extent */
+rt_inline rt_uint8_t *_rtgui_topwin_backing_pixel(const rtgui_rect_t *extent,
+                                                  struct rtgui_dc *backing,
+                                                  const rtgui_rect_t *rect, int bpp)
+{
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)backing;
+
+    return rtgui_dc_buffer_get_pixel(backing) + (rect->y1 - extent->y1) * buffer->pitch + (rect->x1 - extent->x1) * bpp;
+}
+
+/* copy the rect on screen, which is in the @extent of backing store */
+static void _rtgui_topwin_backing_copy(const rtgui_rect_t *extent, struct rtgui_dc *backing,
+                                       const rtgui_rect_t *rect, rt_bool_t save)
+{
+    int bpp;
+    rt_uint8_t *fb, *store;
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+    fb = (rt_uint8_t *)driver->framebuffer + rect->y1 * driver->pitch + rect->x1 * bpp;
+    store = _rtgui_topwin_backing_pixel(extent, backing, rect, bpp);
+
+    if (save)
+        _rtgui_topwin_backing_rows(store, ((struct rtgui_dc_buffer *)backing)->pitch, fb,
+                                   driver->pitch, (rect->x2 - rect->x1) * bpp, rect->y2 - rect->y1);
+    else
+        _rtgui_topwin_backing_rows(fb, driver->pitch, store, ((struct rtgui_dc_buffer *)backing)->pitch,
+                                   (rect->x2 - rect->x1) * bpp, rect->y2 - rect->y1);
+}
+
+/* the @extent on screen */
+static rt_bool_t _rtgui_topwin_backing_rect(const rtgui_rect_t *extent, rtgui_rect_t *rect)
+{
+    rtgui_rect_t screen;
+
+    rtgui_graphic_driver_get_rect(rtgui_graphic_driver_get_default(), &screen);
+    *rect = *extent;
+    rtgui_rect_intersect(&screen, rect);
+
+    return (rect->x1 < rect->x2 && rect->y1 < rect->y2) ? RT_TRUE : RT_FALSE;
+}
+
+static struct rtgui_dc *_rtgui_topwin_backing_create(struct rtgui_topwin *topwin)
+{
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+    /* the backing store is in the framebuffer of main display */
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL || RTGUI_WIN_DISPLAY(topwin->wid) != 0)
+        return RT_NULL;
+
+    return rtgui_dc_buffer_create_pixformat(driver->pixel_format,
+                                            rtgui_rect_width(topwin->extent),
+                                            rtgui_rect_height(topwin->extent));
+}
+
+/* save the screen under the window which is going to be shown */
+static void _rtgui_topwin_backing_save(struct rtgui_topwin *topwin)
+{
+    rtgui_rect_t rect;
+    struct rtgui_dc_buffer *buffer;
+
+    if (!(topwin->flag & WINTITLE_BACKING))
+        return;
+
+    topwin->backing_valid = RT_FALSE;
+#ifdef GUIENGINE_USING_BACKING_ZIP
+    rtgui_free(topwin->backing_zip);
+    topwin->backing_zip = RT_NULL;
+#endif
+    buffer = (struct rtgui_dc_buffer *)topwin->backing;
+    if (buffer != RT_NULL && (buffer->width != rtgui_rect_width(topwin->extent) ||
+                              buffer->height != rtgui_rect_height(topwin->extent)))
+    {
+        rtgui_dc_destory(topwin->backing);
+        topwin->backing = RT_NULL;
+    }
+    if (topwin->backing == RT_NULL)
+        topwin->backing = _rtgui_topwin_backing_create(topwin);
+    if (topwin->backing == RT_NULL || !_rtgui_topwin_backing_rect(&topwin->extent, &rect))
+        return;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    rtgui_graphic_driver_accel_sync();
+    _rtgui_topwin_backing_copy(&topwin->extent, topwin->backing, &rect, RT_TRUE);
+    rtgui_screen_unlock();
+
+    topwin->backing_valid = RT_TRUE;
+}
+
+/* the area of window not covered by the shown windows above it */
+static void _rtgui_topwin_backing_exposed(struct rtgui_topwin *topwin, struct rtgui_region *region)
+{
+    struct rtgui_topwin *top;
+
+    rtgui_region_init_with_extents(region, &topwin->extent);
+
+    top = rtgui_topwin_get_topmost_window_shown_all();
+    while (top != RT_NULL && top != topwin)
+    {
+        if (!_rtgui_topwin_in_tree(top, topwin))
+            rtgui_region_subtract_rect(region, region, &top->extent);
+        top = _rtgui_topwin_get_next_shown(top);
+    }
+}
+
+#ifdef GUIENGINE_USING_BACKING_ZIP
+/*
+ * The backing store is compressed in the blocks of BACKING_ZIP_BLOCK bytes,
+ * each one is in a header of 2 bytes: the length of data, and the bit 15 is
+ * set if the block is stored without compression.
+ */
+#define BACKING_ZIP_BLOCK       4096
+#define BACKING_ZIP_RAW         0x8000
+
+static rt_bool_t _rtgui_topwin_backing_deflate(struct rtgui_topwin *topwin)
+{
+    int size, pos, capacity, offset, length, zlen;
+    rt_uint8_t *pixel, *zip, *block;
+    struct rtgui_dc_buffer *buffer = (struct rtgui_dc_buffer *)topwin->backing;
+
+    pixel = rtgui_dc_buffer_read_pixel(topwin->backing);
+    if (pixel == RT_NULL)
+        return RT_FALSE;
+
+    /* it's not worth to keep the pixels compressed over 3/4 */
+    size = buffer->pitch * buffer->height;
+    capacity = size / 4 * 3;
+    zip = (rt_uint8_t *)rtgui_malloc(capacity);
+    /* fastlz writes 5% more than the input in the worst case */
+    block = (rt_uint8_t *)rtgui_malloc(BACKING_ZIP_BLOCK + BACKING_ZIP_BLOCK / 16 + 66);
+    if (zip == RT_NULL || block == RT_NULL)
+        goto __fail;
+
+    for (offset = 0, pos = 0; offset < size; offset += length)
+    {
+        length = _UI_MIN(size - offset, BACKING_ZIP_BLOCK);
+
+        zlen = fastlz_compress(pixel + offset, length, block);
+        if (zlen <= 0 || zlen >= length)
+        {
+            if (pos + 2 + length > capacity)
+                goto __fail;
+            zip[pos] = length & 0xff;
+            zip[pos + 1] = (length | BACKING_ZIP_RAW) >> 8;
+            rt_memcpy(zip + pos + 2, pixel + offset, length);
+            pos += 2 + length;
+        }
+        else
+        {
+            if (pos + 2 + zlen > capacity)
+                goto __fail;
+            zip[pos] = zlen & 0xff;
+            zip[pos + 1] = zlen >> 8;
+            rt_memcpy(zip + pos + 2, block, zlen);
+            pos += 2 + zlen;
+        }
+    }
+    rtgui_free(block);
+
+    /* the shrink of a block is not failed */
+    topwin->backing_zip = (rt_uint8_t *)rtgui_realloc(zip, pos);
+    if (topwin->backing_zip == RT_NULL)
+        topwin->backing_zip = zip;
+    rtgui_dc_destory(topwin->backing);
+    topwin->backing = RT_NULL;
+
+    return RT_TRUE;
+
+__fail:
+    rtgui_free(block);
+    rtgui_free(zip);
+    return RT_FALSE;
+}
+
+static rt_bool_t _rtgui_topwin_backing_inflate(struct rtgui_topwin *topwin)
+{
+    int size, pos, offset, length, zlen;
+    rt_uint8_t *pixel;
+    struct rtgui_dc *backing;
+
+    backing = _rtgui_topwin_backing_create(topwin);
+    if (backing == RT_NULL)
+        return RT_FALSE;
+    pixel = rtgui_dc_buffer_get_pixel(backing);
+    size = ((struct rtgui_dc_buffer *)backing)->pitch * ((struct rtgui_dc_buffer *)backing)->height;
+
+    for (offset = 0, pos = 0; offset < size; offset += length, pos += 2 + zlen)
+    {
+        length = _UI_MIN(size - offset, BACKING_ZIP_BLOCK);
+        zlen = topwin->backing_zip[pos] | (topwin->backing_zip[pos + 1] << 8);
+
+        if (zlen & BACKING_ZIP_RAW)
+        {
+            zlen &= ~BACKING_ZIP_RAW;
+            rt_memcpy(pixel + offset, topwin->backing_zip + pos + 2, zlen);
+        }
+        else if (fastlz_decompress(topwin->backing_zip + pos + 2, zlen, pixel + offset, length) != length)
+        {
+            rtgui_dc_destory(backing);
+            return RT_FALSE;
+        }
+    }
+
+    rtgui_free(topwin->backing_zip);
+    topwin->backing_zip = RT_NULL;
+    topwin->backing = backing;
+
+    return RT_TRUE;
+}
+
+/*
+ * Compress the backing stores of the inactive windows, the bottom ones first,
+ * until the uncompressed ones are in the budget. The stale ones are freed.
+ */
+static void _rtgui_topwin_backing_zip_tree(struct rt_list_node *list, int *bytes)
+{
+    struct rt_list_node *node;
+    struct rtgui_topwin *topwin;
+    struct rtgui_dc_buffer *buffer;
+
+    for (node = list->prev; node != list; node = node->prev)
+    {
+        topwin = get_topwin_from_list(node);
+        _rtgui_topwin_backing_zip_tree(&topwin->child_list, bytes);
+
+        if (!topwin->backing_valid)
+        {
+            if (topwin->backing != RT_NULL)
+                rtgui_dc_destory(topwin->backing);
+            topwin->backing = RT_NULL;
+            rtgui_free(topwin->backing_zip);
+            topwin->backing_zip = RT_NULL;
+            continue;
+        }
+        if (topwin->backing == RT_NULL || *bytes <= GUIENGINE_BACKING_ZIP_BUDGET ||
+                (topwin->flag & WINTITLE_ACTIVATE))
+            continue;
+
+        buffer = (struct rtgui_dc_buffer *)topwin->backing;
+        if (_rtgui_topwin_backing_deflate(topwin))
+            *bytes -= buffer->pitch * buffer->height;
+    }
+}
+
+static int _rtgui_topwin_backing_bytes(struct rt_list_node *list)
+{
+    int bytes = 0;
+    struct rt_list_node *node;
+    struct rtgui_topwin *topwin;
+    struct rtgui_dc_buffer *buffer;
+
+    rt_list_foreach(node, list, next)
+    {
+        topwin = get_topwin_from_list(node);
+        buffer = (struct rtgui_dc_buffer *)topwin->backing;
+        if (topwin->backing_valid && buffer != RT_NULL)
+            bytes += buffer->pitch * buffer->height;
+        bytes += _rtgui_topwin_backing_bytes(&topwin->child_list);
+    }
+
+    return bytes;
+}
+
+static void _rtgui_topwin_backing_zip(void)
+{
+    int bytes;
+
+    bytes = _rtgui_topwin_backing_bytes(&_rtgui_topwin_list);
+    _rtgui_topwin_backing_zip_tree(&_rtgui_topwin_list, &bytes);
+}
+#endif
+
+/* the backing store of window, decompressed if it's compressed */
+static struct rtgui_dc *_rtgui_topwin_backing_get(struct rtgui_topwin *topwin)
+{
+#ifdef GUIENGINE_USING_BACKING_ZIP
+    if (topwin->backing_zip != RT_NULL && !_rtgui_topwin_backing_inflate(topwin))
+        return RT_NULL;
+#endif
+
+    return topwin->backing;
+}
+
+/* restore the region from the backing store of @extent */
+static rt_bool_t _rtgui_topwin_backing_restore(const rtgui_rect_t *extent,
+                                               struct rtgui_dc *backing,
+                                               struct rtgui_region *region)
+{
+    int index, num;
+    rtgui_rect_t rect, *rects;
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+    if (backing == RT_NULL || !_rtgui_topwin_backing_rect(extent, &rect))
+        return RT_FALSE;
+
+    rtgui_region_intersect_rect(region, region, &rect);
+    num = rtgui_region_num_rects(region);
+    rects = rtgui_region_rects(region);
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    rtgui_graphic_driver_accel_sync();
+    for (index = 0; index < num; index ++)
+    {
+        if (rects[index].x1 >= rects[index].x2 || rects[index].y1 >= rects[index].y2)
+            continue;
+        _rtgui_topwin_backing_copy(extent, backing, &rects[index], RT_FALSE);
+    }
+    rtgui_screen_unlock();
+
+    if (rtgui_region_not_empty(region))
+        rtgui_graphic_driver_screen_update(driver, rtgui_region_extents(region));
+
+    return RT_TRUE;
+}
+
+/*
+ * The window is moved from @old_extent, the exposed area is restored and the
+ * backing store is moved with it. The backing store of new extent is the
+ * screen out of the old extent, and the old store in it.
+ */
+static rt_bool_t _rtgui_topwin_backing_move(struct rtgui_topwin *topwin,
+                                            const rtgui_rect_t *old_extent,
+                                            struct rtgui_region *exposed)
+{
+    int bpp;
+    rtgui_rect_t rect, overlap;
+    struct rtgui_dc *backing;
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+    if (_rtgui_topwin_backing_get(topwin) == RT_NULL)
+        return RT_FALSE;
+    backing = _rtgui_topwin_backing_create(topwin);
+    if (backing == RT_NULL)
+        return RT_FALSE;
+
+    bpp = _UI_BITBYTES(driver->bits_per_pixel);
+    if (_rtgui_topwin_backing_rect(&topwin->extent, &rect))
+    {
+        rtgui_screen_lock(RT_WAITING_FOREVER);
+        rtgui_graphic_driver_accel_sync();
+        _rtgui_topwin_backing_copy(&topwin->extent, backing, &rect, RT_TRUE);
+        rtgui_screen_unlock();
+
+        overlap = rect;
+        rtgui_rect_intersect((rtgui_rect_t *)old_extent, &overlap);
+        if (overlap.x1 < overlap.x2 && overlap.y1 < overlap.y2)
+        {
+            _rtgui_topwin_backing_rows(_rtgui_topwin_backing_pixel(&topwin->extent, backing, &overlap, bpp),
+                                       ((struct rtgui_dc_buffer *)backing)->pitch,
+                                       _rtgui_topwin_backing_pixel(old_extent, topwin->backing, &overlap, bpp),
+                                       ((struct rtgui_dc_buffer *)topwin->backing)->pitch,
+                                       (overlap.x2 - overlap.x1) * bpp, overlap.y2 - overlap.y1);
+        }
+    }
+
+    /* the new extent is painted by the window */
+    rtgui_region_subtract_rect(exposed, exposed, &topwin->extent);
+    _rtgui_topwin_backing_restore(old_extent, topwin->backing, exposed);
+
+    rtgui_dc_destory(topwin->backing);
+    topwin->backing = backing;
+
+    return RT_TRUE;
+}
+
+/* the backing stores covering the rect are stale, except the ones of the
+ * windows which @tree is in (it's above them) */
+static void _rtgui_topwin_backing_stale(struct rt_list_node *list, rtgui_rect_t *rect,
+                                        struct rtgui_topwin *tree)
+{
+    struct rt_list_node *node;
+    struct rtgui_topwin *topwin;
+
+    rt_list_foreach(node, list, next)
+    {
+        topwin = get_topwin_from_list(node);
+        if (!(topwin->flag & WINTITLE_SHOWN))
+            break;
+
+        if (topwin->backing_valid && !_rtgui_topwin_in_tree(tree, topwin) &&
+                rtgui_rect_is_intersect(rect, &topwin->extent) == RT_EOK)
+            topwin->backing_valid = RT_FALSE;
+
+        _rtgui_topwin_backing_stale(&topwin->child_list, rect, tree);
+    }
+}
+
+void rtgui_topwin_backing_damage(struct rtgui_win *wid, rtgui_rect_t *rect)
+{
+    struct rtgui_topwin *topwin = RT_NULL;
+
+    if (wid != RT_NULL)
+        topwin = rtgui_topwin_search_in_list(wid, &_rtgui_topwin_list);
+
+    /* the window updates in itself, the screen under it is not changed */
+    _rtgui_topwin_backing_stale(&_rtgui_topwin_list, rect, topwin);
+}
+#endif
+
 rt_err_t rtgui_topwin_remove(struct rtgui_win *wid)
 {
     struct rtgui_topwin *topwin, *old_focus;
     struct rtgui_region region;
+#ifdef GUIENGINE_USING_BACKING_STORE
+    struct rtgui_region exposed;
+#endif
 
     /* find the topwin node */
     topwin = rtgui_topwin_search_in_list(wid, &_rtgui_topwin_list);
@@ -341,6 +847,12 @@ rt_err_t rtgui_topwin_remove(struct rtgui_win *wid)
     if (topwin == RT_NULL) return -RT_ERROR;
 
     rtgui_region_init(&region);
+#ifdef GUIENGINE_USING_BACKING_STORE
+    if (topwin->flag & WINTITLE_SHOWN && topwin->backing_valid)
+        _rtgui_topwin_backing_exposed(topwin, &exposed);
+    else
+        rtgui_region_init(&exposed);
+#endif
 
     old_focus = rtgui_topwin_get_focus();
 
@@ -355,13 +867,21 @@ rt_err_t rtgui_topwin_remove(struct rtgui_win *wid)
 
     if (topwin->flag & WINTITLE_SHOWN)
     {
-        rtgui_topwin_update_clip();
-        /* redraw the old rect */
         _rtgui_topwin_union_region_tree(topwin, &region);
+        rtgui_topwin_update_clip(rtgui_region_extents(&region));
+#ifdef GUIENGINE_USING_BACKING_STORE
+        _rtgui_topwin_backing_stale(&_rtgui_topwin_list, rtgui_region_extents(&region), topwin);
+        if (!topwin->backing_valid ||
+                !_rtgui_topwin_backing_restore(&topwin->extent, _rtgui_topwin_backing_get(topwin), &exposed))
+#endif
+        /* redraw the old rect */
         rtgui_topwin_redraw(rtgui_region_extents(&region));
     }
 
     rtgui_region_fini(&region);
+#ifdef GUIENGINE_USING_BACKING_STORE
+    rtgui_region_fini(&exposed);
+#endif
     _rtgui_topwin_free_tree(topwin);
 
     return RT_EOK;
@@ -386,6 +906,11 @@ static void _rtgui_topwin_only_activate(struct rtgui_topwin *topwin)
 
     event.wid = topwin->wid;
     rtgui_send(topwin->app, &(event.parent), sizeof(struct rtgui_event_win));
+
+#ifdef GUIENGINE_USING_BACKING_ZIP
+    /* the windows under the activated one are inactive */
+    _rtgui_topwin_backing_zip();
+#endif
 }
 
 /* activate next window in the same layer as flag. The flag has many other
@@ -560,7 +1085,7 @@ rt_err_t rtgui_topwin_activate_topwin(struct rtgui_topwin *topwin)
          * "raised" but not "activated".
          */
         tpmoved = _rtgui_topwin_raise_tree_from_root(topwin);
-        rtgui_topwin_update_clip();
+        _rtgui_topwin_update_clip_tree(tpmoved ? _rtgui_topwin_get_root_win(topwin) : topwin);
         if (tpmoved)
             _rtgui_topwin_draw_tree(_rtgui_topwin_get_root_win(topwin),
                                     &epaint);
@@ -580,7 +1105,7 @@ rt_err_t rtgui_topwin_activate_topwin(struct rtgui_topwin *topwin)
 
     tpmoved = _rtgui_topwin_raise_tree_from_root(topwin);
     /* clip before active the window, so we could get right boarder region. */
-    rtgui_topwin_update_clip();
+    _rtgui_topwin_update_clip_tree(tpmoved ? _rtgui_topwin_get_root_win(topwin) : topwin);
 
     if (old_focus_topwin != RT_NULL)
     {
@@ -653,6 +1178,11 @@ rt_err_t rtgui_topwin_show(struct rtgui_event_win *event)
         return -RT_ERROR;
     }
 
+#ifdef GUIENGINE_USING_BACKING_STORE
+    /* the window is not painted yet */
+    if (!(topwin->flag & WINTITLE_SHOWN))
+        _rtgui_topwin_backing_save(topwin);
+#endif
     _rtgui_topwin_preorder_map(topwin, _rtgui_topwin_mark_shown);
     rtgui_topwin_activate_topwin(topwin);
 
@@ -666,6 +1196,7 @@ static void _rtgui_topwin_clear_modal_tree(struct rtgui_topwin *topwin)
     RT_ASSERT(topwin != RT_NULL);
     RT_ASSERT(topwin->parent != RT_NULL);
 
+    _rtgui_topwin_hit_clear();
     while (!IS_ROOT_WIN(topwin))
     {
         rt_list_foreach(node, &topwin->parent->child_list, next)
@@ -692,6 +1223,10 @@ rt_err_t rtgui_topwin_hide(struct rtgui_event_win *event)
     struct rtgui_topwin *old_focus_topwin;
     struct rtgui_win    *wid;
     struct rt_list_node *containing_list;
+#ifdef GUIENGINE_USING_BACKING_STORE
+    struct rtgui_region exposed;
+    rt_bool_t restored = RT_FALSE;
+#endif
 
     if (!event)
         return -RT_ERROR;
@@ -710,6 +1245,12 @@ rt_err_t rtgui_topwin_hide(struct rtgui_event_win *event)
 
     old_focus_topwin = rtgui_topwin_get_focus();
 
+#ifdef GUIENGINE_USING_BACKING_STORE
+    if (topwin->backing_valid)
+        _rtgui_topwin_backing_exposed(topwin, &exposed);
+    else
+        rtgui_region_init(&exposed);
+#endif
     _rtgui_topwin_preorder_map(topwin, _rtgui_topwin_mark_hidden);
 
     if (topwin->parent == RT_NULL)
@@ -721,7 +1262,7 @@ rt_err_t rtgui_topwin_hide(struct rtgui_event_win *event)
     rt_list_insert_before(containing_list, &topwin->list);
 
     /* update clip info */
-    rtgui_topwin_update_clip();
+    _rtgui_topwin_update_clip_tree(topwin);
 
     if (topwin->flag & WINTITLE_MODALING)
     {
@@ -736,12 +1277,82 @@ rt_err_t rtgui_topwin_hide(struct rtgui_event_win *event)
 
     topwin->flag &= ~WINTITLE_ACTIVATE;
 
+#ifdef GUIENGINE_USING_BACKING_STORE
+    /* the windows above it saved this window */
+    _rtgui_topwin_backing_stale(&_rtgui_topwin_list, &(topwin->extent), topwin);
+    if (topwin->backing_valid)
+        restored = _rtgui_topwin_backing_restore(&topwin->extent, _rtgui_topwin_backing_get(topwin), &exposed);
+    topwin->backing_valid = RT_FALSE;
+    rtgui_region_fini(&exposed);
+    if (!restored)
+#endif
     /* redraw the old rect */
     rtgui_topwin_redraw(&(topwin->extent));
 
     return RT_EOK;
 }
 
+#ifdef TOPWIN_MOVE_COPY
+/*
+ * The visible part of window is moved in the framebuffer, the window is
+ * painted only if it has the area not visible before. The clip of window is
+ * updated after the old one is copied in @old_clip.
+ */
+static rt_bool_t _rtgui_topwin_move_copy(struct rtgui_topwin *topwin,
+                                         struct rtgui_region *old_clip, int dx, int dy)
+{
+    int index, num;
+    rtgui_rect_t *rects;
+    struct rtgui_region exposed;
+    struct rtgui_graphic_driver *driver;
+
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    driver = rtgui_graphic_driver_get_default();
+    if (driver == RT_NULL || driver->framebuffer == RT_NULL || driver->page_num > 1 ||
+            rtgui_graphic_driver_is_vmode() || RTGUI_WIN_DISPLAY(topwin->wid) != 0)
+    {
+        rtgui_screen_unlock();
+        return RT_FALSE;
+    }
+
+    /* the visible part in both places */
+    rtgui_region_translate(old_clip, dx, dy);
+    rtgui_region_intersect(old_clip, old_clip, &topwin->wid->outer_clip);
+
+    RTGUI_TRACE_BEGIN("move copy", rtgui_region_num_rects(old_clip));
+#ifdef RTGUI_USING_MOUSE_CURSOR
+    rtgui_mouse_hide_cursor();
+#endif
+    rtgui_blit_copy_region(driver->framebuffer, driver->pitch, driver->pixel_format,
+                           old_clip, dx, dy);
+#ifdef RTGUI_USING_MOUSE_CURSOR
+    rtgui_mouse_show_cursor();
+#endif
+    RTGUI_TRACE_END("move copy");
+    rtgui_screen_unlock();
+
+    num = rtgui_region_num_rects(old_clip);
+    rects = rtgui_region_rects(old_clip);
+    for (index = 0; index < num; index ++)
+        rtgui_server_add_damage(&rects[index]);
+
+    rtgui_region_init(&exposed);
+    rtgui_region_subtract(&exposed, &topwin->wid->outer_clip, old_clip);
+    if (rtgui_region_not_empty(&exposed))
+    {
+        struct rtgui_event_paint epaint;
+
+        RTGUI_EVENT_PAINT_INIT(&epaint);
+        epaint.wid = topwin->wid;
+        epaint.rect = *rtgui_region_extents(&exposed);
+        rtgui_send(topwin->app, &(epaint.parent), sizeof(epaint));
+    }
+    rtgui_region_fini(&exposed);
+
+    return RT_TRUE;
+}
+#endif
+
 /* move top window */
 rt_err_t rtgui_topwin_move(struct rtgui_event_win_move *event)
 {
@@ -749,6 +1360,14 @@ rt_err_t rtgui_topwin_move(struct rtgui_event_win_move *event)
     int dx, dy;
     rtgui_rect_t old_rect; /* the old topwin coverage area */
     struct rtgui_list_node *node;
+#ifdef GUIENGINE_USING_BACKING_STORE
+    struct rtgui_region exposed;
+    rt_bool_t restored = RT_FALSE;
+#endif
+#ifdef TOPWIN_MOVE_COPY
+    struct rtgui_region old_clip;
+    rt_bool_t copied;
+#endif
 
     /* find in show list */
     topwin = rtgui_topwin_search_in_list(event->wid, &_rtgui_topwin_list);
@@ -763,8 +1382,20 @@ rt_err_t rtgui_topwin_move(struct rtgui_event_win_move *event)
     dy = event->y - topwin->extent.y1;
 
     old_rect = topwin->extent;
+#ifdef GUIENGINE_USING_BACKING_STORE
+    if (topwin->backing_valid)
+        _rtgui_topwin_backing_exposed(topwin, &exposed);
+    else
+        rtgui_region_init(&exposed);
+#endif
     /* move window rect */
     rtgui_rect_move(&(topwin->extent), dx, dy);
+#ifdef GUIENGINE_USING_COMPOSITOR
+    if (topwin->wid->layer != RT_NULL)
+        rtgui_layer_move(topwin->wid->layer, dx, dy);
+    /* the layer is shown in new place without painting */
+    rtgui_server_add_damage(&(topwin->extent));
+#endif
 
     /* move the monitor rect list */
     rtgui_list_foreach(node, &(topwin->monitor_list))
@@ -775,12 +1406,40 @@ rt_err_t rtgui_topwin_move(struct rtgui_event_win_move *event)
         rtgui_rect_move(&(monitor->rect), dx, dy);
     }
 
-    /* update windows clip info */
-    rtgui_topwin_update_clip();
+#ifdef TOPWIN_MOVE_COPY
+    /* the clip of window is still in the old place */
+    rtgui_region_init(&old_clip);
+    rtgui_region_copy(&old_clip, &topwin->wid->outer_clip);
+#endif
 
+    /* update windows clip info in the old and new coverage area */
+    {
+        rtgui_rect_t changed = old_rect;
+
+        rtgui_rect_union(&(topwin->extent), &changed);
+        rtgui_topwin_update_clip(&changed);
+    }
+
+#ifdef TOPWIN_MOVE_COPY
+    copied = _rtgui_topwin_move_copy(topwin, &old_clip, dx, dy);
+    rtgui_region_fini(&old_clip);
+#endif
+
+#ifdef GUIENGINE_USING_BACKING_STORE
+    _rtgui_topwin_backing_stale(&_rtgui_topwin_list, &old_rect, topwin);
+    if (topwin->backing_valid)
+        restored = _rtgui_topwin_backing_move(topwin, &old_rect, &exposed);
+    topwin->backing_valid = restored;
+    rtgui_region_fini(&exposed);
+    if (!restored)
+#endif
     /* update old window coverage area */
     rtgui_topwin_redraw(&old_rect);
 
+#ifdef TOPWIN_MOVE_COPY
+    if (copied)
+        return RT_EOK;
+#endif
     if (rtgui_rect_is_intersect(&old_rect, &(topwin->extent)) != RT_EOK)
     {
         /*
@@ -818,9 +1477,25 @@ void rtgui_topwin_resize(struct rtgui_win *wid, rtgui_rect_t *rect)
     rtgui_region_union_rect(&region, &region, rect);
 
     topwin->extent = *rect;
+#ifdef GUIENGINE_USING_BACKING_STORE
+    topwin->backing_valid = RT_FALSE;
+#endif
+#ifdef GUIENGINE_USING_COMPOSITOR
+    {
+        struct rtgui_layer *layer = rtgui_layer_create(rect);
+
+        /* the window is painted on the new layer after resized */
+        rtgui_screen_lock(RT_WAITING_FOREVER);
+        if (layer != RT_NULL && topwin->wid->layer != RT_NULL)
+            layer->opacity = topwin->wid->layer->opacity;
+        rtgui_layer_destroy(topwin->wid->layer);
+        topwin->wid->layer = layer;
+        rtgui_screen_unlock();
+    }
+#endif
 
     /* update windows clip info */
-    rtgui_topwin_update_clip();
+    rtgui_topwin_update_clip(rtgui_region_extents(&region));
 
     /* update old window coverage area */
     rtgui_topwin_redraw(rtgui_region_extents(&region));
@@ -880,6 +1555,9 @@ static struct rtgui_topwin *_rtgui_topwin_get_wnd_from_tree(struct rt_list_node
         topwin = get_topwin_from_list(node);
         if (!(topwin->flag & WINTITLE_SHOWN))
             break;
+        /* the pointer is on the main display */
+        if (RTGUI_WIN_DISPLAY(topwin->wid) != 0)
+            continue;
 
         /* if higher window have this point, return it */
         target = _rtgui_topwin_get_wnd_from_tree(&topwin->child_list, x, y, exclude_modaled);
@@ -898,70 +1576,166 @@ static struct rtgui_topwin *_rtgui_topwin_get_wnd_from_tree(struct rt_list_node
     return RT_NULL;
 }
 
+#ifndef GUIENGINE_USING_COMPOSITOR
+static struct rtgui_topwin *_rtgui_topwin_get_wnd_hit(int x, int y, rt_bool_t exclude_modaled)
+{
+    int index = exclude_modaled ? 1 : 0;
+    struct rtgui_topwin *topwin = _rtgui_topwin_hit[index];
+
+    if (topwin != RT_NULL && (topwin->flag & WINTITLE_SHOWN))
+    {
+        if (rtgui_rect_contains_point(&_rtgui_topwin_hit_box[index], x, y) == RT_EOK)
+            return topwin;
+        if (rtgui_region_contains_point(&topwin->wid->outer_clip, x, y,
+                                        &_rtgui_topwin_hit_box[index]) == RT_EOK)
+            return topwin;
+    }
+
+    topwin = _rtgui_topwin_get_wnd_from_tree(&_rtgui_topwin_list, x, y, exclude_modaled);
+    /* the clip may be out of date until it's updated, it's not cached then */
+    if (topwin != RT_NULL &&
+            rtgui_region_contains_point(&topwin->wid->outer_clip, x, y,
+                                        &_rtgui_topwin_hit_box[index]) == RT_EOK)
+        _rtgui_topwin_hit[index] = topwin;
+    else
+        _rtgui_topwin_hit[index] = RT_NULL;
+
+    return topwin;
+}
+#endif
+
 struct rtgui_topwin *rtgui_topwin_get_wnd(int x, int y)
 {
+#ifndef GUIENGINE_USING_COMPOSITOR
+    return _rtgui_topwin_get_wnd_hit(x, y, RT_FALSE);
+#else
     return _rtgui_topwin_get_wnd_from_tree(&_rtgui_topwin_list, x, y, RT_FALSE);
+#endif
 }
 
 struct rtgui_topwin *rtgui_topwin_get_wnd_no_modaled(int x, int y)
 {
+#ifndef GUIENGINE_USING_COMPOSITOR
+    return _rtgui_topwin_get_wnd_hit(x, y, RT_TRUE);
+#else
     return _rtgui_topwin_get_wnd_from_tree(&_rtgui_topwin_list, x, y, RT_TRUE);
+#endif
 }
 
-/* clip region from topwin, and the windows beneath it. */
-rt_inline void _rtgui_topwin_clip_to_region(struct rtgui_topwin *topwin,
-        struct rtgui_region *region)
-{
-    RT_ASSERT(region != RT_NULL);
-    RT_ASSERT(topwin != RT_NULL);
-
-    rtgui_region_reset(&topwin->wid->outer_clip, &topwin->wid->outer_extent);
-    rtgui_region_intersect(&topwin->wid->outer_clip, &topwin->wid->outer_clip, region);
-}
 
-static void rtgui_topwin_update_clip(void)
+/* clip the shown windows on the display, the @extents are the room of them */
+static void _rtgui_topwin_update_display_clip(int display, struct rtgui_rect *rect,
+                                              struct rtgui_rect *extents, struct rtgui_region *old_clip)
 {
+    int above;
     struct rtgui_topwin *top;
     struct rtgui_event_clip_info eclip;
-    /* Note that the region is a "female die", that means it's the region you
-     * can paint to, not the region covered by others.
-     */
-    struct rtgui_region region_available;
+    struct rtgui_rect screen, clip_rect;
 
-    if (rt_list_isempty(&_rtgui_topwin_list) ||
-            !(get_topwin_from_list(_rtgui_topwin_list.next)->flag & WINTITLE_SHOWN))
+    if (rtgui_graphic_driver_get_display(display) == RT_NULL)
         return;
 
     RTGUI_EVENT_CLIP_INFO_INIT(&eclip);
-
-    rtgui_region_init_rect(&region_available, 0, 0,
-                           rtgui_graphic_driver_get_default()->width,
-                           rtgui_graphic_driver_get_default()->height);
+    rtgui_graphic_driver_get_rect(rtgui_graphic_driver_get_display(display), &screen);
 
     /* from top to bottom. */
-    top = rtgui_topwin_get_topmost_window_shown(WINTITLE_ONTOP);
-    /* 0 is normal layer */
-    if (top == RT_NULL)
-        top = rtgui_topwin_get_topmost_window_shown(WINTITLE_INIT);
-    if (top == RT_NULL)
-        top = rtgui_topwin_get_topmost_window_shown(WINTITLE_ONBTM);
+    top = rtgui_topwin_get_topmost_window_shown_all();
 
-    while (top != RT_NULL)
+    above = 0;
+    for (; top != RT_NULL; top = _rtgui_topwin_get_next_shown(top))
     {
-        /* clip the topwin */
-        _rtgui_topwin_clip_to_region(top, &region_available);
+        /* the windows are clipped by the ones on the same display */
+        if (RTGUI_WIN_DISPLAY(top->wid) != display)
+            continue;
 
-        /* update available region */
-        rtgui_region_subtract_rect(&region_available, &region_available, &top->extent);
+        if (rect == RT_NULL ||
+                rtgui_rect_is_intersect(rect, &top->wid->outer_extent) == RT_EOK)
+        {
+            rtgui_region_copy(old_clip, &top->wid->outer_clip);
+
+            /* clip the topwin */
+            clip_rect = top->wid->outer_extent;
+            rtgui_rect_intersect(&screen, &clip_rect);
+#ifdef GUIENGINE_USING_COMPOSITOR
+            /* not beyond the layer */
+            rtgui_rect_intersect(&top->extent, &clip_rect);
+#endif
+            rtgui_region_clip_rect_minus_rects(&top->wid->outer_clip, &clip_rect, extents, above);
 
-        /* send clip event to destination window */
-        eclip.wid = top->wid;
-        rtgui_send(top->app, &(eclip.parent), sizeof(struct rtgui_event_clip_info));
+            /* send clip event to destination window */
+            if (rect == RT_NULL ||
+                    rtgui_region_is_equal(old_clip, &top->wid->outer_clip) != RT_EOK)
+            {
+                eclip.wid = top->wid;
+                rtgui_send(top->app, &(eclip.parent), sizeof(struct rtgui_event_clip_info));
+            }
+        }
 
-        top = _rtgui_topwin_get_next_shown(top);
+#ifndef GUIENGINE_USING_COMPOSITOR
+        /* the windows beneath are clipped by it, the windows are not clipped
+         * by the others in compositing */
+        extents[above ++] = top->extent;
+#endif
+    }
+}
+
+/*
+ * Update the clip of the shown windows. The windows beyond the changed @rect
+ * keep their clip, so only the windows intersecting with @rect are clipped
+ * again and only the ones whose clip really changed get the clip event. If
+ * @rect is RT_NULL, all the shown windows are clipped again.
+ */
+static void rtgui_topwin_update_clip(struct rtgui_rect *rect)
+{
+    int display;
+#ifndef GUIENGINE_USING_COMPOSITOR
+    int count;
+    struct rtgui_topwin *top;
+#endif
+    /* the extents of the windows above, the clip of a window is its outer
+     * extent on screen minus them, in one pass */
+    struct rtgui_rect *extents;
+    struct rtgui_region old_clip;
+
+    _rtgui_topwin_hit_clear();
+    if (rt_list_isempty(&_rtgui_topwin_list) ||
+            !(get_topwin_from_list(_rtgui_topwin_list.next)->flag & WINTITLE_SHOWN))
+        return;
+
+    RTGUI_TRACE_BEGIN("update clip", rect ? rtgui_rect_width(*rect) * rtgui_rect_height(*rect) : -1);
+
+    extents = RT_NULL;
+#ifndef GUIENGINE_USING_COMPOSITOR
+    count = 0;
+    for (top = rtgui_topwin_get_topmost_window_shown_all(); top != RT_NULL; top = _rtgui_topwin_get_next_shown(top))
+        count ++;
+    extents = (struct rtgui_rect *)rtgui_malloc(count * sizeof(struct rtgui_rect));
+    if (extents == RT_NULL)
+    {
+        RTGUI_TRACE_END("update clip");
+        return;
     }
+#endif
+
+    rtgui_region_init(&old_clip);
+    for (display = 0; display < RTGUI_DISPLAY_NUM; display ++)
+        _rtgui_topwin_update_display_clip(display, rect, extents, &old_clip);
+    rtgui_region_fini(&old_clip);
+
+    if (extents != RT_NULL)
+        rtgui_free(extents);
+    RTGUI_TRACE_END("update clip");
+}
+
+/* update the clip in the coverage area of the topwin tree */
+static void _rtgui_topwin_update_clip_tree(struct rtgui_topwin *topwin)
+{
+    struct rtgui_region region;
 
-    rtgui_region_fini(&region_available);
+    rtgui_region_init(&region);
+    _rtgui_topwin_union_region_tree(topwin, &region);
+    rtgui_topwin_update_clip(rtgui_region_extents(&region));
+    rtgui_region_fini(&region);
 }
 
 static void _rtgui_topwin_redraw_tree(struct rt_list_node *list,
@@ -1002,12 +1776,76 @@ static void _rtgui_topwin_redraw_tree(struct rt_list_node *list,
 static void rtgui_topwin_redraw(struct rtgui_rect *rect)
 {
     struct rtgui_event_paint epaint;
+
+#ifdef GUIENGINE_USING_COMPOSITOR
+    /* the layers are composited again, no window is painted */
+    rtgui_server_add_damage(rect);
+    return;
+#endif
+
     RTGUI_EVENT_PAINT_INIT(&epaint);
     epaint.wid = RT_NULL;
 
     _rtgui_topwin_redraw_tree(&_rtgui_topwin_list, rect, &epaint);
 }
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+/* the layer covers the whole rect */
+rt_inline rt_bool_t _rtgui_topwin_layer_cover(struct rtgui_layer *layer, rtgui_rect_t *rect)
+{
+    return layer->opacity == 255 &&
+           layer->extent.x1 <= rect->x1 && layer->extent.x2 >= rect->x2 &&
+           layer->extent.y1 <= rect->y1 && layer->extent.y2 >= rect->y2;
+}
+
+/*
+ * Composite the rect from the bottom window to the top one. The windows under
+ * an opaque window covering the whole rect are not composited, and the
+ * background is filled if there is not such a window.
+ */
+void rtgui_topwin_composite(struct rtgui_graphic_driver *driver, rtgui_rect_t *rect)
+{
+    int num = 0;
+    rtgui_rect_t r, screen;
+    struct rtgui_topwin *top;
+    struct rtgui_layer *layers[GUIENGINE_COMPOSITOR_LAYERS];
+
+    if (driver->framebuffer == RT_NULL)
+        return;
+
+    r = *rect;
+    rtgui_graphic_driver_get_rect(driver, &screen);
+    rtgui_rect_intersect(&screen, &r);
+    if (r.x1 >= r.x2 || r.y1 >= r.y2)
+        return;
+
+    RTGUI_TRACE_BEGIN("composite", rtgui_rect_width(r) * rtgui_rect_height(r));
+    /* from top to bottom, in the layers of ONTOP, normal and ONBTM */
+    for (top = rtgui_topwin_get_topmost_window_shown_all();
+            top != RT_NULL && num < GUIENGINE_COMPOSITOR_LAYERS;
+            top = _rtgui_topwin_get_next_shown(top))
+    {
+        struct rtgui_layer *layer = top->wid->layer;
+
+        if (layer == RT_NULL || layer->opacity == 0 ||
+                layer->extent.x1 >= r.x2 || layer->extent.x2 <= r.x1 ||
+                layer->extent.y1 >= r.y2 || layer->extent.y2 <= r.y1)
+            continue;
+
+        layers[num ++] = layer;
+        if (_rtgui_topwin_layer_cover(layer, &r))
+            break;
+    }
+
+    if (num == 0 || !_rtgui_topwin_layer_cover(layers[num - 1], &r))
+        rtgui_graphic_driver_fill_rect(driver, GUIENGINE_COMPOSITOR_BACKGROUND, &r);
+
+    while (num > 0)
+        rtgui_layer_composite(driver, layers[-- num], &r);
+    RTGUI_TRACE_END("composite");
+}
+#endif
+
 /* a window enter modal mode will modal all the sibling window and parent
  * window all along to the root window. If a root window modals, there is
  * nothing to do here.*/
@@ -1029,6 +1867,7 @@ rt_err_t rtgui_topwin_modal_enter(struct rtgui_event_win_modal_enter *event)
     /* modal window should be on top already */
     RT_ASSERT(get_topwin_from_list(parent_top->child_list.next) == topwin);
 
+    _rtgui_topwin_hit_clear();
     do
     {
         rt_list_foreach(node, &parent_top->child_list, next)
@@ -1123,6 +1962,13 @@ struct rtgui_object* rtgui_get_object(struct rtgui_app *app, rt_uint32_t id)
     if (object->id == id)
         return object;
 
+#ifdef GUIENGINE_USING_ID_HASH
+    object = rtgui_object_id_lookup(app, id);
+    if (object != RT_NULL)
+        return object;
+#endif
+
+    /* the ones set id out of the app */
     rt_list_foreach(node, &_rtgui_topwin_list, next)
     {
         struct rtgui_topwin *topwin;
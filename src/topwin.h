@@ -29,6 +29,7 @@
 #include <rtgui/event.h>
 #include <rtgui/widgets/title.h>
 #include <rtgui/rtgui_server.h>
+#include <rtgui/driver.h>
 
 /* add or remove a top win */
 rt_err_t rtgui_topwin_add(struct rtgui_event_win_create *event);
@@ -69,5 +70,27 @@ struct rtgui_app *rtgui_topwin_app_get_focus(void);
 
 struct rtgui_topwin *rtgui_topwin_get_topmost_window_shown_all(void);
 
+#ifdef GUIENGINE_USING_BACKING_STORE
+/* the window updated the rect, the backing stores under it are stale */
+void rtgui_topwin_backing_damage(struct rtgui_win *wid, rtgui_rect_t *rect);
+#endif
+
+#ifdef GUIENGINE_USING_COMPOSITOR
+/* composite the layers of the shown windows in the rect to the driver */
+void rtgui_topwin_composite(struct rtgui_graphic_driver *driver, rtgui_rect_t *rect);
+#endif
+
+/* the rect of screen should be flushed to the panel */
+void rtgui_server_add_damage(rtgui_rect_t *rect);
+/* the rect of display, which is flushed to its driver */
+void rtgui_server_add_display_damage(int display, rtgui_rect_t *rect);
+
+#ifdef GUIENGINE_USING_GESTURE
+/* recognize the gestures in touch samples, it's in the server thread */
+void rtgui_gesture_handle_touch(struct rtgui_event_touch *event);
+/* the window is destroyed, the gesture on it is dropped */
+void rtgui_gesture_cancel(struct rtgui_win *wid);
+#endif
+
 #endif
 
@@ -0,0 +1,209 @@
+/*
+ * File      : trace.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtgui/trace.h>
+
+#ifdef GUIENGINE_USING_TRACE
+
+#if (GUIENGINE_TRACE_SIZE & (GUIENGINE_TRACE_SIZE - 1)) != 0
+#error "GUIENGINE_TRACE_SIZE should be a power of 2"
+#endif
+
+struct rtgui_trace_record
+{
+    rt_uint32_t time;
+    const char *name;
+    rt_thread_t thread;
+    rt_int32_t value;
+    char phase;
+};
+
+volatile rt_uint8_t rtgui_trace_on = 0;
+static struct rtgui_trace_record _trace_ring[GUIENGINE_TRACE_SIZE];
+/* the count of records reserved, the oldest ones are overwritten */
+static volatile rt_uint32_t _trace_head = 0;
+
+void rtgui_trace_record(const char *name, char phase, rt_int32_t value)
+{
+    rt_base_t level;
+    rt_uint32_t index;
+    struct rtgui_trace_record *record;
+
+    /* reserve a record, no writer waits for the others */
+    level = rt_hw_interrupt_disable();
+    index = _trace_head ++;
+    rt_hw_interrupt_enable(level);
+
+    record = &_trace_ring[index & (GUIENGINE_TRACE_SIZE - 1)];
+    record->time = GUIENGINE_PROFILE_CLOCK();
+    record->name = name;
+    record->thread = rt_thread_self();
+    record->value = value;
+    record->phase = phase;
+}
+RTM_EXPORT(rtgui_trace_record);
+
+void rtgui_trace_start(void)
+{
+    rtgui_trace_on = 0;
+    _trace_head = 0;
+    rt_memset(_trace_ring, 0, sizeof(_trace_ring));
+    rtgui_trace_on = 1;
+}
+RTM_EXPORT(rtgui_trace_start);
+
+void rtgui_trace_stop(void)
+{
+    rtgui_trace_on = 0;
+}
+RTM_EXPORT(rtgui_trace_stop);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+static void _trace_puts(int fd, const char *line)
+{
+#ifdef RT_USING_DFS
+    if (fd >= 0)
+    {
+        write(fd, line, rt_strlen(line));
+        return;
+    }
+#endif
+    rt_kprintf("%s", line);
+}
+
+/* the thread is the tid, named if it still exists */
+static void _trace_dump_thread(int fd, rt_thread_t thread, char *line, rt_size_t size)
+{
+    if (thread == RT_NULL ||
+            (thread->type & ~RT_Object_Class_Static) != RT_Object_Class_Thread)
+        return;
+
+    rt_snprintf(line, size, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"%.*s\"}},\n", (rt_uint32_t)(rt_ubase_t)thread, RT_NAME_MAX, thread->name);
+    _trace_puts(fd, line);
+}
+
+static void _trace_dump(int fd)
+{
+    char line[128];
+    rt_uint32_t index, start, end, count;
+    rt_thread_t threads[GUIENGINE_TRACE_THREADS];
+    int thread_num = 0, pos;
+    struct rtgui_trace_record *record;
+
+    end = _trace_head;
+    start = end > GUIENGINE_TRACE_SIZE ? end - GUIENGINE_TRACE_SIZE : 0;
+
+    _trace_puts(fd, "{\"traceEvents\":[\n");
+    for (index = start, count = 0; index != end; index ++)
+    {
+        record = &_trace_ring[index & (GUIENGINE_TRACE_SIZE - 1)];
+        if (record->name == RT_NULL) continue;
+
+        /* name the threads once */
+        for (pos = 0; pos < thread_num && threads[pos] != record->thread; pos ++);
+        if (pos == thread_num && thread_num < GUIENGINE_TRACE_THREADS)
+        {
+            threads[thread_num ++] = record->thread;
+            _trace_dump_thread(fd, record->thread, line, sizeof(line));
+        }
+
+        if (record->phase == 'C')
+            rt_snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%u,\"pid\":1,"
+                        "\"tid\":%u,\"args\":{\"value\":%d}},\n", record->name, record->time,
+                        (rt_uint32_t)(rt_ubase_t)record->thread, record->value);
+        else if (record->phase == 'B')
+            rt_snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%u,\"pid\":1,"
+                        "\"tid\":%u,\"args\":{\"arg\":%d}},\n", record->name, record->time,
+                        (rt_uint32_t)(rt_ubase_t)record->thread, record->value);
+        else
+            rt_snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u,\"pid\":1,"
+                        "\"tid\":%u},\n", record->name, record->phase, record->time,
+                        (rt_uint32_t)(rt_ubase_t)record->thread);
+        _trace_puts(fd, line);
+        count ++;
+    }
+    /* the last one is not followed by a comma */
+    _trace_puts(fd, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"gui\"}}\n]}\n");
+
+    if (fd >= 0)
+        rt_kprintf("%d records, %d overwritten\n", count,
+                   end > GUIENGINE_TRACE_SIZE ? end - GUIENGINE_TRACE_SIZE : 0);
+}
+
+#ifdef FINSH_USING_MSH
+static int gui_trace(int argc, char **argv)
+{
+    if (argc >= 2 && rt_strcmp(argv[1], "start") == 0)
+    {
+        rtgui_trace_start();
+        return 0;
+    }
+    else if (argc >= 2 && rt_strcmp(argv[1], "stop") == 0)
+    {
+        rtgui_trace_stop();
+        return 0;
+    }
+    else if (argc >= 2 && rt_strcmp(argv[1], "dump") == 0)
+    {
+        int fd = -1;
+        rt_uint8_t on = rtgui_trace_on;
+
+        /* the ring is not written in dumping */
+        rtgui_trace_on = 0;
+#ifdef RT_USING_DFS
+        if (argc == 3)
+        {
+            fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0);
+            if (fd < 0)
+            {
+                rt_kprintf("open %s failed\n", argv[2]);
+                rtgui_trace_on = on;
+                return -1;
+            }
+        }
+#endif
+        _trace_dump(fd);
+#ifdef RT_USING_DFS
+        if (fd >= 0) close(fd);
+#endif
+        rtgui_trace_on = on;
+        return 0;
+    }
+
+    rt_kprintf("usage: gui_trace start|stop|dump [file]\n");
+    return -1;
+}
+MSH_CMD_EXPORT(gui_trace, trace the engine in the JSON of Chrome trace);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * File      : transition.c
+ * This file is part of RT-Thread GUI Engine
+ * COPYRIGHT (C) 2006 - 2017, RT-Thread Development Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-14     agent        first version
+ */
+#include <rtgui/transition.h>
+#include <rtgui/frame.h>
+#include <rtgui/dc.h>
+#include <rtgui/rtgui_app.h>
+#include <rtgui/rtgui_system.h>
+
+#ifdef GUIENGIN_USING_VFRAMEBUFFER
+
+/* the progress of transition in 1/256 */
+#define TRANSITION_ONE      256
+
+struct rtgui_transition
+{
+    struct rtgui_frame frame;
+
+    enum rtgui_transition_type type;
+    struct rtgui_win *from, *to;
+    /* the snapshots of windows */
+    struct rtgui_dc *from_dc, *to_dc;
+
+    rt_uint32_t duration, elapsed;
+};
+
+/* blit the snapshot at (x, y) of the window, in the clip rect */
+static void _transition_blit(struct rtgui_dc *snapshot, struct rtgui_dc *dc, int x, int y,
+                             rtgui_rect_t *clip)
+{
+    rtgui_rect_t rect;
+    rtgui_point_t point;
+
+    rtgui_dc_get_rect(snapshot, &rect);
+    rtgui_rect_move(&rect, x, y);
+    rtgui_rect_intersect(clip, &rect);
+    if (rtgui_rect_is_empty(&rect))
+        return;
+
+    point.x = rect.x1 - x;
+    point.y = rect.y1 - y;
+    rtgui_dc_blit(snapshot, &point, dc, &rect);
+}
+
+static void _transition_compose(struct rtgui_transition *trans, struct rtgui_dc *dc, int progress)
+{
+    int w, h, fx, fy, tx, ty;
+    double scale;
+    rtgui_rect_t rect, clip;
+    struct rtgui_dc *zoom;
+
+    rtgui_rect_init(&rect, 0, 0, rtgui_rect_width(RTGUI_WIDGET(trans->to)->extent),
+                    rtgui_rect_height(RTGUI_WIDGET(trans->to)->extent));
+    w = rect.x2;
+    h = rect.y2;
+    fx = fy = tx = ty = 0;
+
+    switch (trans->type)
+    {
+    case RTGUI_TRANSITION_FADE:
+        _transition_blit(trans->from_dc, dc, 0, 0, &rect);
+        rtgui_dc_buffer_set_alpha(trans->to_dc, progress * 255 / TRANSITION_ONE);
+        _transition_blit(trans->to_dc, dc, 0, 0, &rect);
+        rtgui_dc_buffer_set_alpha(trans->to_dc, 255);
+        return;
+
+    case RTGUI_TRANSITION_ZOOM:
+        _transition_blit(trans->from_dc, dc, 0, 0, &rect);
+        scale = (double)(progress > 16 ? progress : 16) / TRANSITION_ONE;
+        zoom = rtgui_dc_zoom(trans->to_dc, scale, scale, 0);
+        if (zoom != RT_NULL)
+        {
+            rtgui_dc_get_rect(zoom, &clip);
+            _transition_blit(zoom, dc, (w - clip.x2) / 2, (h - clip.y2) / 2, &rect);
+            rtgui_dc_destory(zoom);
+        }
+        return;
+
+    case RTGUI_TRANSITION_SLIDE_LEFT:
+        tx = w - w * progress / TRANSITION_ONE;
+        break;
+    case RTGUI_TRANSITION_SLIDE_RIGHT:
+        tx = w * progress / TRANSITION_ONE - w;
+        break;
+    case RTGUI_TRANSITION_SLIDE_UP:
+        ty = h - h * progress / TRANSITION_ONE;
+        break;
+    case RTGUI_TRANSITION_SLIDE_DOWN:
+        ty = h * progress / TRANSITION_ONE - h;
+        break;
+    case RTGUI_TRANSITION_PUSH_LEFT:
+        tx = w - w * progress / TRANSITION_ONE;
+        fx = tx - w;
+        break;
+    case RTGUI_TRANSITION_PUSH_RIGHT:
+        tx = w * progress / TRANSITION_ONE - w;
+        fx = tx + w;
+        break;
+    }
+
+    /* the from window is only blitted in the part not covered by the to window */
+    clip = rect;
+    if (tx > 0) clip.x2 = tx;
+    else if (tx < 0) clip.x1 = w + tx;
+    if (ty > 0) clip.y2 = ty;
+    else if (ty < 0) clip.y1 = h + ty;
+    if (tx != 0 || ty != 0)
+        _transition_blit(trans->from_dc, dc, fx, fy, &clip);
+    _transition_blit(trans->to_dc, dc, tx, ty, &rect);
+}
+
+static void _transition_frame(struct rtgui_frame *frame, struct rtgui_dc *dc, rt_uint32_t delta_ms)
+{
+    int t, progress;
+    struct rtgui_transition *trans;
+
+    trans = (struct rtgui_transition *)frame->user_data;
+    if (frame->widget == RT_NULL)
+    {
+        /* out of the drawing, the server is not waited in the screen lock */
+        rtgui_frame_stop(frame);
+        rtgui_dc_destory(trans->from_dc);
+        rtgui_dc_destory(trans->to_dc);
+        if (trans->from != trans->to)
+            rtgui_win_hide(trans->from);
+        rtgui_widget_update(RTGUI_WIDGET(trans->to));
+        rtgui_free(trans);
+        return;
+    }
+
+    trans->elapsed += delta_ms;
+    if (trans->elapsed > trans->duration)
+        trans->elapsed = trans->duration;
+
+    /* ease out in quad */
+    t = trans->duration ? TRANSITION_ONE - trans->elapsed * TRANSITION_ONE / trans->duration : 0;
+    progress = TRANSITION_ONE - t * t / TRANSITION_ONE;
+    if (dc != RT_NULL)
+        _transition_compose(trans, dc, progress);
+
+    if (trans->elapsed == trans->duration)
+    {
+        /* finish in the next frame without widget */
+        rtgui_frame_stop(frame);
+        frame->widget = RT_NULL;
+        rtgui_frame_start(frame);
+    }
+}
+
+rt_err_t rtgui_transition_start(struct rtgui_win *from, struct rtgui_win *to,
+                                enum rtgui_transition_type type, rt_uint32_t duration_ms)
+{
+    struct rtgui_transition *trans;
+
+    RT_ASSERT(from != RT_NULL && to != RT_NULL);
+
+    trans = (struct rtgui_transition *)rtgui_malloc(sizeof(struct rtgui_transition));
+    if (trans == RT_NULL)
+        goto __show;
+
+    trans->from_dc = rtgui_win_get_drawing(from);
+    if (trans->from_dc == RT_NULL)
+    {
+        rtgui_free(trans);
+        goto __show;
+    }
+
+    /* the paint of show is in the events after, which are skipped in the transition */
+    rtgui_win_show(to, RT_FALSE);
+    trans->to_dc = rtgui_win_get_drawing(to);
+    if (trans->to_dc == RT_NULL)
+    {
+        rtgui_dc_destory(trans->from_dc);
+        rtgui_free(trans);
+        return -RT_ENOMEM;
+    }
+
+    trans->type = type;
+    trans->from = from;
+    trans->to = to;
+    trans->duration = duration_ms;
+    trans->elapsed = 0;
+    rtgui_frame_init(&trans->frame, RTGUI_WIDGET(to), _transition_frame, trans);
+    rtgui_frame_start(&trans->frame);
+
+    return RT_EOK;
+
+__show:
+    rtgui_win_show(to, RT_FALSE);
+    return -RT_ENOMEM;
+}
+RTM_EXPORT(rtgui_transition_start);
+
+#endif
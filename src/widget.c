@@ -30,13 +30,45 @@
 #include <rtgui/widgets/widget.h>
 #include <rtgui/widgets/window.h>
 #include <rtgui/widgets/container.h>
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+#include <rthw.h>
+#include <rtgui/driver.h>
+
+#ifndef GUIENGIN_USING_VFRAMEBUFFER
+#error "the widget cache needs GUIENGIN_USING_VFRAMEBUFFER"
+#endif
+
+/* the bytes and number of the caches of all apps */
+static rt_uint32_t _cache_bytes = 0;
+static rt_uint32_t _cache_count = 0;
+
+#define _cache_size(dc)     ((rt_uint32_t)((struct rtgui_dc_buffer *)(dc))->pitch * \
+                             ((struct rtgui_dc_buffer *)(dc))->height)
+
+static void _widget_cache_drop(rtgui_widget_t *widget)
+{
+    rt_base_t level;
+
+    if (widget->cache == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+    _cache_bytes -= _cache_size(widget->cache);
+    _cache_count --;
+    rt_hw_interrupt_enable(level);
+
+    rt_list_remove(&widget->cache_list);
+    rtgui_dc_destory(widget->cache);
+    widget->cache = RT_NULL;
+}
+#endif
 
 static void _rtgui_widget_constructor(rtgui_widget_t *widget)
 {
     if (!widget) return;
 
-    /* set widget as shown */
-    widget->flag = RTGUI_WIDGET_FLAG_SHOWN;
+    /* set widget as shown, the clip is not calculated yet */
+    widget->flag = RTGUI_WIDGET_FLAG_SHOWN | RTGUI_WIDGET_FLAG_CLIP_DIRTY;
 
     /* init list */
     rtgui_list_init(&(widget->sibling));
@@ -44,6 +76,7 @@ static void _rtgui_widget_constructor(rtgui_widget_t *widget)
     /* init gc */
     widget->gc.foreground = default_foreground;
     widget->gc.background = default_background;
+    widget->gc.pixel_format = RTGUI_GC_PIXEL_NONE;
     widget->gc.font = rtgui_font_default();
     widget->gc.textstyle = RTGUI_TEXTSTYLE_NORMAL;
     widget->gc.textalign = RTGUI_ALIGN_LEFT | RTGUI_ALIGN_TOP;
@@ -54,6 +87,7 @@ static void _rtgui_widget_constructor(rtgui_widget_t *widget)
     memset(&(widget->extent_visiable), 0x0, sizeof(widget->extent_visiable));
     widget->min_width = widget->min_height = 0;
     rtgui_region_init_with_extents(&widget->clip, &widget->extent);
+    widget->clip_gen = widget->clip_parent_gen = 0;
 
     /* set parent and toplevel root */
     widget->parent        = RT_NULL;
@@ -69,6 +103,17 @@ static void _rtgui_widget_constructor(rtgui_widget_t *widget)
     /* init user data private to 0 */
     widget->user_data = 0;
 
+#ifdef GUIENGINE_USING_WIDGET_PROFILE
+    widget->paint_us = 0;
+    widget->paint_count = 0;
+    widget->paint_pixels = 0;
+#endif
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    widget->cache = RT_NULL;
+    rt_list_init(&widget->cache_list);
+    widget->cache_gen = widget->cache_top_gen = 0;
+#endif
+
     /* init hardware dc */
     rtgui_dc_client_init(widget);
 }
@@ -86,15 +131,20 @@ static void _rtgui_widget_destructor(rtgui_widget_t *widget)
         widget->parent = RT_NULL;
     }
 
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    _widget_cache_drop(widget);
+#endif
+
     /* fini clip region */
     rtgui_region_fini(&(widget->clip));
 }
 
-DEFINE_CLASS_TYPE(widget, "widget",
-                  RTGUI_PARENT_TYPE(object),
-                  _rtgui_widget_constructor,
-                  _rtgui_widget_destructor,
-                  sizeof(struct rtgui_widget));
+DEFINE_CLASS_TYPE_POOL(widget, "widget",
+                       RTGUI_PARENT_TYPE(object),
+                       _rtgui_widget_constructor,
+                       _rtgui_widget_destructor,
+                       sizeof(struct rtgui_widget),
+                       GUIENGINE_OBJECT_POOL_SIZE);
 RTM_EXPORT(_rtgui_widget);
 
 rtgui_widget_t *rtgui_widget_create(const rtgui_type_t *widget_type)
@@ -123,6 +173,7 @@ void rtgui_widget_set_rect(rtgui_widget_t *widget, const rtgui_rect_t *rect)
     widget->extent = *rect;
     /* set the visiable extern as extern */
     widget->extent_visiable = *rect;
+    rtgui_widget_clip_dirty(widget);
     if (RTGUI_IS_CONTAINER(widget))
     {
         /* re-do layout */
@@ -182,6 +233,7 @@ void rtgui_widget_set_parent(rtgui_widget_t *widget, rtgui_widget_t *parent)
 {
     /* set parent and toplevel widget */
     widget->parent = parent;
+    widget->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
 }
 RTM_EXPORT(rtgui_widget_set_parent);
 
@@ -194,9 +246,17 @@ void rtgui_widget_get_extent(rtgui_widget_t *widget, rtgui_rect_t *rect)
 }
 RTM_EXPORT(rtgui_widget_get_extent);
 
+/* the layout of parent is done again for the changed min size */
+#define _widget_layout_dirty(widget) \
+    do { if ((widget)->parent != RT_NULL) \
+            (widget)->parent->flag |= RTGUI_WIDGET_FLAG_LAYOUT_DIRTY; } while (0)
+
 void rtgui_widget_set_minsize(rtgui_widget_t *widget, int width, int height)
 {
     RT_ASSERT(widget != RT_NULL);
+
+    if (widget->min_width != width || widget->min_height != height)
+        _widget_layout_dirty(widget);
     widget->min_width = width;
     widget->min_height = height;
 }
@@ -206,6 +266,8 @@ void rtgui_widget_set_minwidth(rtgui_widget_t *widget, int width)
 {
     RT_ASSERT(widget != RT_NULL);
 
+    if (widget->min_width != width)
+        _widget_layout_dirty(widget);
     widget->min_width = width;
 }
 RTM_EXPORT(rtgui_widget_set_minwidth);
@@ -214,6 +276,8 @@ void rtgui_widget_set_minheight(rtgui_widget_t *widget, int height)
 {
     RT_ASSERT(widget != RT_NULL);
 
+    if (widget->min_height != height)
+        _widget_layout_dirty(widget);
     widget->min_height = height;
 }
 RTM_EXPORT(rtgui_widget_set_minheight);
@@ -224,6 +288,7 @@ static void _widget_move(struct rtgui_widget* widget, int dx, int dy)
     rtgui_widget_t *child, *parent;
 
 	rtgui_rect_move(&(widget->extent), dx, dy);
+    widget->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
 
     /* handle visiable extent */
     widget->extent_visiable = widget->extent;
@@ -281,6 +346,7 @@ void rtgui_widget_move_to_logic(rtgui_widget_t *widget, int dx, int dy)
 
     /* move this widget (and its children if it's a container) to destination point */
     _widget_move(widget, dx, dy);
+    rtgui_widget_clip_dirty(widget);
     /* update this widget */
     rtgui_widget_update_clip(widget);
 }
@@ -531,26 +597,55 @@ RTM_EXPORT(rtgui_widget_event_handler);
 /*
  * This function updates the clip info of widget
  */
-void rtgui_widget_update_clip(rtgui_widget_t *widget)
+/*
+ * mark the clip of widget as dirty. The parents are marked too, so the
+ * rtgui_widget_update_clip on them will walk down to this widget.
+ */
+void rtgui_widget_clip_dirty(rtgui_widget_t *widget)
+{
+    while (widget != RT_NULL)
+    {
+        widget->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+        widget = widget->parent;
+    }
+}
+RTM_EXPORT(rtgui_widget_clip_dirty);
+
+static void _widget_update_clip(rtgui_widget_t *widget)
 {
     rtgui_rect_t rect;
     struct rtgui_list_node *node;
     rtgui_widget_t *parent;
+    rt_bool_t updated = RT_FALSE;
 
     /* no widget or widget is hide, no update clip */
     if (widget == RT_NULL || RTGUI_WIDGET_IS_HIDE(widget) || widget->parent == RT_NULL)
         return;
 
     parent = widget->parent;
-    /* reset visiable extent */
-    widget->extent_visiable = widget->extent;
-    rtgui_rect_intersect(&(parent->extent_visiable), &(widget->extent_visiable));
+    /* the clip only depends on the extent and the visiable extent of parent */
+    if ((widget->flag & RTGUI_WIDGET_FLAG_CLIP_DIRTY) ||
+            widget->clip_parent_gen != parent->clip_gen)
+    {
+        rect = widget->extent_visiable;
 
-    rect = parent->extent_visiable;
-    /* reset clip to extent */
-    rtgui_region_reset(&(widget->clip), &(widget->extent));
-    /* limit widget extent in parent extent */
-    rtgui_region_intersect_rect(&(widget->clip), &(widget->clip), &rect);
+        /* reset visiable extent */
+        widget->extent_visiable = widget->extent;
+        rtgui_rect_intersect(&(parent->extent_visiable), &(widget->extent_visiable));
+        if ((widget->flag & RTGUI_WIDGET_FLAG_CLIP_DIRTY) ||
+                rtgui_rect_is_equal(&rect, &(widget->extent_visiable)) != RT_EOK)
+            widget->clip_gen ++;
+
+        rect = parent->extent_visiable;
+        /* reset clip to extent */
+        rtgui_region_reset(&(widget->clip), &(widget->extent));
+        /* limit widget extent in parent extent */
+        rtgui_region_intersect_rect(&(widget->clip), &(widget->clip), &rect);
+
+        widget->clip_parent_gen = parent->clip_gen;
+        widget->flag &= ~RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+        updated = RT_TRUE;
+    }
 
     /* get the no transparent parent */
     while (parent != RT_NULL && parent->flag & RTGUI_WIDGET_FLAG_TRANSPARENT)
@@ -573,18 +668,53 @@ void rtgui_widget_update_clip(rtgui_widget_t *widget)
      * note: since the layout widget introduction, the sibling widget should not intersect.
      */
 
-    /* if it's a container object, update the clip info of children */
-    if (RTGUI_IS_CONTAINER(widget))
+    /* if it's a container object, update the clip info of children. The
+     * children of an unchanged container keep their clip, except the ones
+     * of a transparent container which clip the parent beyond it. */
+    if (RTGUI_IS_CONTAINER(widget) &&
+            (updated || (widget->flag & RTGUI_WIDGET_FLAG_TRANSPARENT)))
     {
         rtgui_widget_t *child;
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+        rtgui_region_t base;
+
+        rtgui_region_init(&base);
+        rtgui_region_copy(&base, &(widget->clip));
+#endif
         rtgui_list_foreach(node, &(RTGUI_CONTAINER(widget)->children))
         {
             child = rtgui_list_entry(node, rtgui_widget_t, sibling);
 
-            rtgui_widget_update_clip(child);
+            _widget_update_clip(child);
         }
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+        /* the children of a transparent container are in the parent clip */
+        if (!(widget->flag & RTGUI_WIDGET_FLAG_TRANSPARENT))
+            rtgui_widget_clip_simplify(widget, &base);
+        rtgui_region_fini(&base);
+#endif
     }
 }
+
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+void rtgui_widget_clip_simplify(rtgui_widget_t *widget, rtgui_region_t *base)
+{
+    /* only the areas taken by the children are filled */
+    rtgui_region_subtract(base, base, &(widget->clip));
+    rtgui_region_simplify(&(widget->clip), base, GUIENGINE_CLIP_SIMPLIFY_WASTE);
+}
+RTM_EXPORT(rtgui_widget_clip_simplify);
+#endif
+
+void rtgui_widget_update_clip(rtgui_widget_t *widget)
+{
+    if (widget == RT_NULL)
+        return;
+
+    /* always re-calculate the widget itself, only the children are cached */
+    widget->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+    _widget_update_clip(widget);
+}
 RTM_EXPORT(rtgui_widget_update_clip);
 
 void rtgui_widget_show(struct rtgui_widget *widget)
@@ -596,6 +726,8 @@ void rtgui_widget_show(struct rtgui_widget *widget)
         return;
 
     RTGUI_WIDGET_UNHIDE(widget);
+    /* the clip is not updated when the widget is hidden */
+    rtgui_widget_clip_dirty(widget);
 
     if (widget->toplevel != RT_NULL)
     {
@@ -732,15 +864,379 @@ void rtgui_widget_update(rtgui_widget_t *widget)
 
     RT_ASSERT(widget != RT_NULL);
 
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    rtgui_widget_cache_dirty(widget);
+#endif
     if (RTGUI_OBJECT(widget)->event_handler != RT_NULL &&
             !(RTGUI_WIDGET_FLAG(widget) & RTGUI_WIDGET_FLAG_IN_ANIM))
     {
-        RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget),
-                                            &paint.parent);
+#ifdef GUIENGINE_USING_BAND
+        if (widget->toplevel != RT_NULL && rtgui_win_is_band_mode())
+        {
+            rtgui_win_paint_bands(widget->toplevel, widget, &paint.parent);
+            return;
+        }
+#endif
+        rtgui_widget_paint_event(widget, &paint.parent);
     }
 }
 RTM_EXPORT(rtgui_widget_update);
 
+static rt_bool_t _widget_paint(rtgui_widget_t *widget, struct rtgui_event *event)
+{
+#ifdef GUIENGINE_USING_WIDGET_PROFILE
+    rt_bool_t result;
+    rt_uint32_t start;
+    rtgui_rect_t *rects;
+    int index, num;
+
+    if (!(event->type & RTGUI_EVENT_PAINT))
+        return RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget), event);
+
+    /* the area visible in painting */
+    num = rtgui_region_num_rects(&widget->clip);
+    rects = rtgui_region_rects(&widget->clip);
+    for (index = 0; index < num; index ++)
+    {
+        widget->paint_pixels += (rects[index].x2 - rects[index].x1) *
+                                (rects[index].y2 - rects[index].y1);
+    }
+
+    start = GUIENGINE_PROFILE_CLOCK();
+    result = RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget), event);
+    widget->paint_us += GUIENGINE_PROFILE_CLOCK() - start;
+    widget->paint_count ++;
+
+    return result;
+#else
+    return RTGUI_OBJECT(widget)->event_handler(RTGUI_OBJECT(widget), event);
+#endif
+}
+
+/* the empty damage of paint event is the whole widget */
+#define _damage_is_whole(r)     ((r)->x1 >= (r)->x2 || (r)->y1 >= (r)->y2)
+
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+static void _widget_cache_blit(rtgui_widget_t *widget)
+{
+    struct rtgui_dc *dc;
+    rtgui_rect_t rect;
+
+    dc = rtgui_dc_begin_drawing(widget);
+    if (dc == RT_NULL)
+        return;
+
+    rtgui_widget_get_rect(widget, &rect);
+    rtgui_dc_blit(widget->cache, RT_NULL, dc, &rect);
+    rtgui_dc_end_drawing(dc, 1);
+}
+
+/*
+ * Paint the cached widget by the blit of its cache. The cache is rendered by a
+ * paint of the whole widget in the virtual mode of buffer, so only the visible
+ * pixels are in it, and it's kept until the clip of widget or toplevel is
+ * changed. RT_FALSE if the widget should be painted as usual.
+ */
+static rt_bool_t _widget_cache_paint(rtgui_widget_t *widget, struct rtgui_event *event)
+{
+    int w, h;
+    rt_uint32_t size;
+    rt_base_t level;
+    rtgui_rect_t *damage;
+    rtgui_widget_t *top;
+    struct rtgui_app *app;
+    struct rtgui_dc_buffer *buffer;
+    struct rtgui_event_paint paint;
+
+    app = rtgui_app_self();
+    if (app == RT_NULL)
+        return RT_FALSE;
+
+    top = widget->toplevel != RT_NULL ? RTGUI_WIDGET(widget->toplevel) : widget;
+    w = rtgui_rect_width(widget->extent);
+    h = rtgui_rect_height(widget->extent);
+    buffer = (struct rtgui_dc_buffer *)widget->cache;
+    if (buffer != RT_NULL)
+    {
+        if (buffer->width == w && buffer->height == h &&
+                widget->cache_gen == widget->clip_gen && widget->cache_top_gen == top->clip_gen)
+        {
+            /* move to the head, as the most recently painted */
+            rt_list_remove(&widget->cache_list);
+            rt_list_insert_after(&app->cache_list, &widget->cache_list);
+            _widget_cache_blit(widget);
+            return RT_TRUE;
+        }
+        _widget_cache_drop(widget);
+    }
+
+    /* the clip narrowed to a damage is not the whole widget, and the virtual
+     * mode is not nested */
+    damage = &(((struct rtgui_event_paint *)event)->rect);
+    if (!_damage_is_whole(damage) &&
+            (damage->x1 > widget->extent.x1 || damage->x2 < widget->extent.x2 ||
+             damage->y1 > widget->extent.y1 || damage->y2 < widget->extent.y2))
+        return RT_FALSE;
+    if (w <= 0 || h <= 0 || rtgui_graphic_driver_is_vmode() ||
+            !rtgui_region_not_empty(&(widget->clip)))
+        return RT_FALSE;
+
+    /* make room from the least recently painted caches of this app, the caches
+     * of the other apps are dropped in their threads */
+    size = (rt_uint32_t)w * h * rtgui_color_get_bpp(RTGUI_VFB_PIXEL_FMT);
+    if (size > GUIENGINE_WIDGET_CACHE_BUDGET)
+        return RT_FALSE;
+    while (_cache_bytes + size > GUIENGINE_WIDGET_CACHE_BUDGET && !rt_list_isempty(&app->cache_list))
+        _widget_cache_drop(rt_list_entry(app->cache_list.prev, struct rtgui_widget, cache_list));
+    if (_cache_bytes + size > GUIENGINE_WIDGET_CACHE_BUDGET)
+        return RT_FALSE;
+
+    widget->cache = rtgui_dc_buffer_create_pixformat(RTGUI_VFB_PIXEL_FMT, w, h);
+    if (widget->cache == RT_NULL)
+        return RT_FALSE;
+    if (rtgui_graphic_driver_vmode_enter_buffer(widget->cache, &(widget->extent)) != RT_EOK)
+    {
+        rtgui_dc_destory(widget->cache);
+        widget->cache = RT_NULL;
+        return RT_FALSE;
+    }
+
+    RTGUI_EVENT_PAINT_INIT(&paint);
+    paint.wid = RT_NULL;
+    widget->flag |= RTGUI_WIDGET_FLAG_CACHE_PAINT;
+    _widget_paint(widget, &paint.parent);
+    widget->flag &= ~RTGUI_WIDGET_FLAG_CACHE_PAINT;
+    rtgui_graphic_driver_vmode_exit();
+
+    level = rt_hw_interrupt_disable();
+    _cache_bytes += _cache_size(widget->cache);
+    _cache_count ++;
+    rt_hw_interrupt_enable(level);
+    rt_list_insert_after(&app->cache_list, &widget->cache_list);
+    widget->cache_gen = widget->clip_gen;
+    widget->cache_top_gen = top->clip_gen;
+
+    _widget_cache_blit(widget);
+    return RT_TRUE;
+}
+
+void rtgui_widget_cache_dirty(rtgui_widget_t *widget)
+{
+    if (_cache_count == 0)
+        return;
+
+    /* the parents rendering their caches are not changed by the paint */
+    for (; widget != RT_NULL; widget = widget->parent)
+    {
+        if (widget->flag & RTGUI_WIDGET_FLAG_CACHE_PAINT)
+            break;
+        _widget_cache_drop(widget);
+    }
+}
+RTM_EXPORT(rtgui_widget_cache_dirty);
+
+void rtgui_widget_set_cached(rtgui_widget_t *widget, rt_bool_t cached)
+{
+    RT_ASSERT(widget != RT_NULL);
+
+    if (cached == RT_TRUE)
+    {
+        widget->flag |= RTGUI_WIDGET_FLAG_CACHED;
+    }
+    else
+    {
+        widget->flag &= ~RTGUI_WIDGET_FLAG_CACHED;
+        _widget_cache_drop(widget);
+    }
+}
+RTM_EXPORT(rtgui_widget_set_cached);
+#endif
+
+/*
+ * Pass the event to the handler of widget, the paint is recorded in the
+ * profile of widget. The cached widget is painted by its cache, and the paint
+ * of a widget out of the cache drops the caches of its parents. The event
+ * handler should not be RT_NULL.
+ */
+rt_bool_t rtgui_widget_paint_event(rtgui_widget_t *widget, struct rtgui_event *event)
+{
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    if (event->type == RTGUI_EVENT_PAINT)
+    {
+        rtgui_widget_cache_dirty(widget->parent);
+        if ((widget->flag & (RTGUI_WIDGET_FLAG_CACHED | RTGUI_WIDGET_FLAG_TRANSPARENT |
+                             RTGUI_WIDGET_FLAG_CACHE_PAINT)) == RTGUI_WIDGET_FLAG_CACHED &&
+                _widget_cache_paint(widget, event) == RT_TRUE)
+            return RT_FALSE;
+    }
+#endif
+
+    return _widget_paint(widget, event);
+}
+RTM_EXPORT(rtgui_widget_paint_event);
+
+rt_bool_t rtgui_widget_clip_damage(rtgui_widget_t *widget, const rtgui_rect_t *damage,
+                                   rtgui_region_t *saved)
+{
+    rtgui_rect_t rect;
+
+    /* the rects may live inline in the clip, so copy them to the saved */
+    rtgui_region_init(saved);
+    rtgui_region_copy(saved, &(widget->clip));
+    rect = *damage;
+    rtgui_region_intersect_rect(&(widget->clip), saved, &rect);
+
+    return rtgui_region_not_empty(&(widget->clip)) ? RT_TRUE : RT_FALSE;
+}
+RTM_EXPORT(rtgui_widget_clip_damage);
+
+void rtgui_widget_clip_restore(rtgui_widget_t *widget, rtgui_region_t *saved)
+{
+    rtgui_region_copy(&(widget->clip), saved);
+    rtgui_region_fini(saved);
+}
+RTM_EXPORT(rtgui_widget_clip_restore);
+
+/*
+ * Paint the widget in the damage of paint event. The widget out of the damage
+ * is skipped, and the widget across it is painted with the clip narrowed to
+ * the damage, so the drawing out of the damage is clipped off.
+ */
+rt_bool_t rtgui_widget_paint_damage(rtgui_widget_t *widget, struct rtgui_event *event)
+{
+    rt_bool_t result;
+    rtgui_rect_t *damage;
+    rtgui_region_t saved;
+
+    if (event->type != RTGUI_EVENT_PAINT)
+        return rtgui_widget_paint_event(widget, event);
+
+    damage = &(((struct rtgui_event_paint *)event)->rect);
+    if (_damage_is_whole(damage) ||
+            (damage->x1 <= widget->extent.x1 && damage->x2 >= widget->extent.x2 &&
+             damage->y1 <= widget->extent.y1 && damage->y2 >= widget->extent.y2))
+        return rtgui_widget_paint_event(widget, event);
+
+    if (damage->x1 >= widget->extent.x2 || damage->x2 <= widget->extent.x1 ||
+            damage->y1 >= widget->extent.y2 || damage->y2 <= widget->extent.y1)
+        return RT_FALSE;
+
+    result = RT_FALSE;
+    if (rtgui_widget_clip_damage(widget, damage, &saved) == RT_TRUE)
+        result = rtgui_widget_paint_event(widget, event);
+    rtgui_widget_clip_restore(widget, &saved);
+
+    return result;
+}
+RTM_EXPORT(rtgui_widget_paint_damage);
+
+void rtgui_widget_update_rect(rtgui_widget_t *widget, const rtgui_rect_t *rect)
+{
+    rtgui_widget_t *top;
+    struct rtgui_event_paint paint;
+
+    RT_ASSERT(widget != RT_NULL);
+
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    rtgui_widget_cache_dirty(widget);
+#endif
+    RTGUI_EVENT_PAINT_INIT(&paint);
+    paint.wid = RT_NULL;
+    if (rect != RT_NULL)
+    {
+        paint.rect = *rect;
+        rtgui_widget_rect_to_device(widget, &paint.rect);
+        rtgui_rect_intersect(&(widget->extent), &paint.rect);
+    }
+    else
+    {
+        paint.rect = widget->extent;
+    }
+    if (_damage_is_whole(&paint.rect))
+        return;
+
+    /* the widgets under and over the rect are painted in the toplevel */
+    top = widget->toplevel != RT_NULL ? RTGUI_WIDGET(widget->toplevel) : widget;
+    if (RTGUI_OBJECT(top)->event_handler != RT_NULL &&
+            !(RTGUI_WIDGET_FLAG(top) & RTGUI_WIDGET_FLAG_IN_ANIM))
+    {
+#ifdef GUIENGINE_USING_BAND
+        if (widget->toplevel != RT_NULL && rtgui_win_is_band_mode())
+        {
+            rtgui_win_paint_bands(widget->toplevel, top, &paint.parent);
+            return;
+        }
+#endif
+        rtgui_widget_paint_damage(top, &paint.parent);
+    }
+}
+RTM_EXPORT(rtgui_widget_update_rect);
+
+/*
+ * Invalidate the rect of widget, RT_NULL for the whole widget. The rects are
+ * merged in the damage of toplevel, and painted once by a paint event to the
+ * app, which is handled after the other events queued. So the updates in the
+ * handlers of a tick are painted in one drawing.
+ */
+void rtgui_widget_invalidate(rtgui_widget_t *widget, const rtgui_rect_t *rect)
+{
+    struct rtgui_win *win;
+    rtgui_rect_t damage;
+    struct rtgui_event_paint paint;
+
+    RT_ASSERT(widget != RT_NULL);
+
+    win = widget->toplevel;
+    if (win == RT_NULL || RTGUI_WIDGET_IS_HIDE(widget))
+        return;
+
+    if (rect != RT_NULL)
+    {
+        damage = *rect;
+        rtgui_widget_rect_to_device(widget, &damage);
+        rtgui_rect_intersect(&(widget->extent), &damage);
+    }
+    else
+    {
+        damage = widget->extent;
+    }
+    if (_damage_is_whole(&damage))
+        return;
+
+#ifdef GUIENGINE_USING_WIDGET_CACHE
+    rtgui_widget_cache_dirty(widget);
+#endif
+    if (win->flag & RTGUI_WIN_FLAG_DAMAGED)
+    {
+        rtgui_rect_union(&damage, &(win->damage));
+        return;
+    }
+
+    RTGUI_EVENT_PAINT_INIT(&paint);
+    paint.wid = win;
+    paint.rect = damage;
+    if (rtgui_send(win->app, &(paint.parent), sizeof(paint)) != RT_EOK)
+    {
+        /* the queue is full, paint it now */
+        rtgui_widget_update_rect(widget, rect);
+        return;
+    }
+
+    win->damage = damage;
+    win->flag |= RTGUI_WIN_FLAG_DAMAGED;
+}
+RTM_EXPORT(rtgui_widget_invalidate);
+
+#ifdef GUIENGINE_USING_WIDGET_PROFILE
+void rtgui_widget_paint_reset(rtgui_widget_t *widget)
+{
+    widget->paint_us = 0;
+    widget->paint_count = 0;
+    widget->paint_pixels = 0;
+}
+RTM_EXPORT(rtgui_widget_paint_reset);
+#endif
+
 rtgui_widget_t *rtgui_widget_get_next_sibling(rtgui_widget_t *widget)
 {
     rtgui_widget_t *sibling = RT_NULL;
@@ -793,9 +1289,7 @@ rt_bool_t rtgui_widget_is_in_animation(rtgui_widget_t *widget)
 }
 RTM_EXPORT(rtgui_widget_is_in_animation);
 
-#ifdef RTGUI_WIDGET_DEBUG
-#include <rtgui/widgets/label.h>
-#include <rtgui/widgets/button.h>
+#if defined(RTGUI_WIDGET_DEBUG) || defined(GUIENGINE_USING_WIDGET_PROFILE)
 void rtgui_widget_dump(rtgui_widget_t *widget)
 {
     struct rtgui_object *obj;
@@ -805,11 +1299,18 @@ void rtgui_widget_dump(rtgui_widget_t *widget)
 
     if (RTGUI_IS_WIN(widget) == RT_TRUE)
         rt_kprintf(":%s ", RTGUI_WIN(widget)->title);
-    else if ((RTGUI_IS_LABEL(widget) == RT_TRUE) || (RTGUI_IS_BUTTON(widget) == RT_TRUE))
-        rt_kprintf(":%s ", RTGUI_LABEL(widget)->text);
 
     rt_kprintf("extent(%d, %d) - (%d, %d)\n", widget->extent.x1,
                widget->extent.y1, widget->extent.x2, widget->extent.y2);
+#ifdef GUIENGINE_USING_WIDGET_PROFILE
+    if (widget->paint_count != 0)
+    {
+        rt_kprintf("    paint: %d times, %d us, %d us/paint, %d pixels/paint\n",
+                   widget->paint_count, widget->paint_us,
+                   widget->paint_us / widget->paint_count,
+                   (rt_uint32_t)(widget->paint_pixels / widget->paint_count));
+    }
+#endif
     // rtgui_region_dump(&(widget->clip));
 }
 #endif
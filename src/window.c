@@ -27,6 +27,7 @@
 #include <rtgui/rtgui_system.h>
 #include <rtgui/rtgui_server.h>
 #include <rtgui/rtgui_app.h>
+#include <rtgui/profile.h>
 
 #include <rtgui/widgets/window.h>
 #include <rtgui/widgets/title.h>
@@ -43,6 +44,7 @@ static void _rtgui_win_constructor(rtgui_win_t *win)
     /* init win property */
     win->update = 0;
     win->drawing = 0;
+    win->damage = rtgui_empty_rect;
 
     RTGUI_WIDGET(win)->flag |= RTGUI_WIDGET_FLAG_FOCUSABLE;
     win->parent_window = RT_NULL;
@@ -74,6 +76,12 @@ static void _rtgui_win_constructor(rtgui_win_t *win)
     win->user_data = 0;
 
     win->_do_show = rtgui_win_do_show;
+#ifdef GUIENGINE_USING_COMPOSITOR
+    win->layer = RT_NULL;
+#endif
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    win->display = 0;
+#endif
 }
 
 static void _rtgui_win_destructor(rtgui_win_t *win)
@@ -121,6 +129,16 @@ static rt_bool_t _rtgui_win_create_in_server(struct rtgui_win *win)
         ecreate.wid           = win;
         ecreate.parent.user   = win->style;
 
+#ifdef GUIENGINE_USING_ASYNC_WIN_CREATE
+        /* the server adds it before the events sent later, such as the show
+         * waiting for the ack, so the app goes on building the window */
+        if (rtgui_server_post_event(RTGUI_EVENT(&ecreate),
+                                    sizeof(struct rtgui_event_win_create)) == RT_EOK)
+        {
+            win->flag |= RTGUI_WIN_FLAG_CONNECTED;
+            return RT_TRUE;
+        }
+#endif
         if (rtgui_server_post_event_sync(RTGUI_EVENT(&ecreate),
                                          sizeof(struct rtgui_event_win_create)
                                         ) != RT_EOK)
@@ -150,6 +168,11 @@ int rtgui_win_init(struct rtgui_win *win, struct rtgui_win *parent_window,
 
     /* set parent window */
     win->parent_window = parent_window;
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+    /* the child is on the display of parent */
+    if (parent_window != RT_NULL)
+        win->display = parent_window->display;
+#endif
 
     /* set title, rect and style */
     if (title != RT_NULL)
@@ -438,6 +461,7 @@ RTM_EXPORT(rtgui_win_do_show);
 
 rt_base_t rtgui_win_show(struct rtgui_win *win, rt_bool_t is_modal)
 {
+    RTGUI_BOOT_MARK(RTGUI_BOOT_FIRST_SHOW);
     RTGUI_WIDGET_UNHIDE(win);
 
     win->magic = RTGUI_WIN_MAGIC;
@@ -569,16 +593,42 @@ void rtgui_win_move(struct rtgui_win *win, int x, int y)
 }
 RTM_EXPORT(rtgui_win_move);
 
-static rt_bool_t rtgui_win_ondraw(struct rtgui_win *win)
+/* the invalidated damage is painted in this paint, the empty rect is the whole window */
+static void _rtgui_win_take_damage(struct rtgui_win *win, rtgui_rect_t *rect)
+{
+    if (!(win->flag & RTGUI_WIN_FLAG_DAMAGED))
+        return;
+
+    win->flag &= ~RTGUI_WIN_FLAG_DAMAGED;
+    if (rect->x1 < rect->x2 && rect->y1 < rect->y2)
+        rtgui_rect_union(&win->damage, rect);
+    win->damage = rtgui_empty_rect;
+}
+
+/* paint the window in the damage on screen, the empty damage is the whole window */
+static rt_bool_t rtgui_win_ondraw(struct rtgui_win *win, const rtgui_rect_t *damage)
 {
     struct rtgui_dc *dc;
     struct rtgui_rect rect;
     struct rtgui_event_paint event;
+    rtgui_region_t saved;
+    rt_bool_t narrowed;
+
+    narrowed = damage->x1 < damage->x2 && damage->y1 < damage->y2;
+    if (narrowed && rtgui_widget_clip_damage(RTGUI_WIDGET(win), damage, &saved) == RT_FALSE)
+    {
+        rtgui_widget_clip_restore(RTGUI_WIDGET(win), &saved);
+        return RT_FALSE;
+    }
 
     /* begin drawing */
     dc = rtgui_dc_begin_drawing(RTGUI_WIDGET(win));
     if (dc == RT_NULL)
+    {
+        if (narrowed)
+            rtgui_widget_clip_restore(RTGUI_WIDGET(win), &saved);
         return RT_FALSE;
+    }
 
     /* get window rect */
     rtgui_widget_get_rect(RTGUI_WIDGET(win), &rect);
@@ -590,11 +640,14 @@ static rt_bool_t rtgui_win_ondraw(struct rtgui_win *win)
     /* paint each widget */
     RTGUI_EVENT_PAINT_INIT(&event);
     event.wid = RT_NULL;
+    event.rect = *damage;
 
     rtgui_container_dispatch_event(RTGUI_CONTAINER(win),
                                    (rtgui_event_t *)&event);
 
     rtgui_dc_end_drawing(dc, 1);
+    if (narrowed)
+        rtgui_widget_clip_restore(RTGUI_WIDGET(win), &saved);
 
     return RT_FALSE;
 }
@@ -603,6 +656,9 @@ void rtgui_win_update_clip(struct rtgui_win *win)
 {
     struct rtgui_container *cnt;
     struct rtgui_list_node *node;
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+    rtgui_region_t base;
+#endif
 
     if (win == RT_NULL)
         return;
@@ -629,6 +685,19 @@ void rtgui_win_update_clip(struct rtgui_win *win)
         rtgui_region_copy(&RTGUI_WIDGET(win)->clip, &win->outer_clip);
     }
 
+    /* the children only re-calculate the clip when the window is changed */
+    if (RTGUI_WIDGET(win)->flag & RTGUI_WIDGET_FLAG_CLIP_DIRTY)
+    {
+        RTGUI_WIDGET(win)->clip_gen ++;
+        RTGUI_WIDGET(win)->flag &= ~RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+    }
+
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+    /* the base is in the outer clip, the areas of other windows are not filled */
+    rtgui_region_init(&base);
+    rtgui_region_copy(&base, &RTGUI_WIDGET(win)->clip);
+#endif
+
     /* update the clip info of each child */
     cnt = RTGUI_CONTAINER(win);
     rtgui_list_foreach(node, &(cnt->children))
@@ -637,6 +706,11 @@ void rtgui_win_update_clip(struct rtgui_win *win)
 
         rtgui_widget_update_clip(child);
     }
+
+#ifdef GUIENGINE_USING_CLIP_SIMPLIFY
+    rtgui_widget_clip_simplify(RTGUI_WIDGET(win), &base);
+    rtgui_region_fini(&base);
+#endif
 }
 RTM_EXPORT(rtgui_win_update_clip);
 
@@ -751,9 +825,20 @@ rt_bool_t rtgui_win_event_handler(struct rtgui_object *object, struct rtgui_even
         break;
 
     case RTGUI_EVENT_PAINT:
-        if (win->_title_wgt)
-            rtgui_widget_update(RTGUI_WIDGET(win->_title_wgt));
-        rtgui_win_ondraw(win);
+        _rtgui_win_take_damage(win, &(((struct rtgui_event_paint *)event)->rect));
+        /* the window animated in whole is presented by its frames */
+        if (RTGUI_WIDGET_FLAG(win) & RTGUI_WIDGET_FLAG_IN_ANIM)
+            break;
+#ifdef GUIENGINE_USING_BAND
+        if (rtgui_win_is_band_mode())
+        {
+            rtgui_win_paint_bands(win, RTGUI_WIDGET(win), event);
+            break;
+        }
+#endif
+        if (win->_title_wgt && RTGUI_OBJECT(win->_title_wgt)->event_handler)
+            rtgui_widget_paint_damage(RTGUI_WIDGET(win->_title_wgt), event);
+        rtgui_win_ondraw(win, &(((struct rtgui_event_paint *)event)->rect));
         break;
 
 #ifdef GUIENGIN_USING_VFRAMEBUFFER
@@ -846,6 +931,7 @@ void rtgui_win_set_rect(rtgui_win_t *win, rtgui_rect_t *rect)
     if (win == RT_NULL || rect == RT_NULL) return;
 
     RTGUI_WIDGET(win)->extent = *rect;
+    RTGUI_WIDGET(win)->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
 
     if (win->flag & RTGUI_WIN_FLAG_CONNECTED)
     {
@@ -924,8 +1010,101 @@ char *rtgui_win_get_title(rtgui_win_t *win)
 }
 RTM_EXPORT(rtgui_win_get_title);
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+#include <rtgui/driver.h>
+void rtgui_win_set_opacity(rtgui_win_t *win, rt_uint8_t opacity)
+{
+    struct rtgui_event_update_end eupdate;
+
+    RT_ASSERT(win != RT_NULL);
+
+    if (win->layer == RT_NULL || win->layer->opacity == opacity)
+        return;
+    win->layer->opacity = opacity;
+
+    /* composite the window again */
+    if (!RTGUI_WIDGET_IS_HIDE(win))
+    {
+        RTGUI_EVENT_UPDATE_END_INIT(&(eupdate));
+        eupdate.wid = win;
+        eupdate.rect = win->layer->extent;
+        rtgui_server_post_event((struct rtgui_event *)&eupdate, sizeof(eupdate));
+    }
+}
+RTM_EXPORT(rtgui_win_set_opacity);
+#endif
+
+#ifdef GUIENGINE_USING_MULTI_DISPLAY
+#include <rtgui/driver.h>
+rt_err_t rtgui_win_set_display(rtgui_win_t *win, int display)
+{
+    RT_ASSERT(win != RT_NULL);
+
+    /* the server clips it on the display when it's shown */
+    if (!RTGUI_WIDGET_IS_HIDE(win))
+        return -RT_EBUSY;
+    if (rtgui_graphic_driver_get_display(display) == RT_NULL)
+        return -RT_EINVAL;
+
+    win->display = display;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rtgui_win_set_display);
+#endif
+
 #ifdef GUIENGIN_USING_VFRAMEBUFFER
 #include <rtgui/driver.h>
+/*
+ * Paint the window only in the rect, the children are clipped in it by the
+ * visiable extent of window. The outer clip is set to the region, or the rect
+ * if it's RT_NULL. The clip should be saved and restored by the caller.
+ */
+static void _rtgui_win_limit_clip(struct rtgui_win *win, rtgui_rect_t *rect, rtgui_region_t *region)
+{
+    rtgui_rect_t visiable = RTGUI_WIDGET(win)->extent;
+
+    rtgui_rect_intersect(rect, &visiable);
+    RTGUI_WIDGET(win)->extent_visiable = visiable;
+    RTGUI_WIDGET(win)->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+
+    if (region != RT_NULL)
+        rtgui_region_copy(&win->outer_clip, region);
+    else
+        rtgui_region_reset(&win->outer_clip, rect);
+    rtgui_win_update_clip(win);
+}
+
+static void _rtgui_win_restore_clip(struct rtgui_win *win, rtgui_rect_t *visiable, rtgui_region_t *clip)
+{
+    RTGUI_WIDGET(win)->extent_visiable = *visiable;
+    RTGUI_WIDGET(win)->flag |= RTGUI_WIDGET_FLAG_CLIP_DIRTY;
+
+    rtgui_region_copy(&win->outer_clip, clip);
+    rtgui_win_update_clip(win);
+}
+
+#ifdef GUIENGINE_USING_COMPOSITOR
+/* the layer of window has all of the pixels, which are copied without painting */
+static struct rtgui_dc *_rtgui_win_get_layer_drawing(rtgui_win_t *win)
+{
+    struct rtgui_dc *dc = RT_NULL;
+    struct rtgui_rect rect;
+
+    /* the layer is not destroyed or moved in the lock */
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    if (win->layer != RT_NULL)
+    {
+        rect = RTGUI_WIDGET(win)->extent;
+        rtgui_rect_intersect(&win->layer->extent, &rect);
+        dc = rtgui_graphic_driver_get_rect_buffer(&win->layer->driver, &rect);
+    }
+    rtgui_screen_unlock();
+
+    return dc;
+}
+#endif
+
 struct rtgui_dc *rtgui_win_get_drawing(rtgui_win_t * win)
 {
     struct rtgui_dc *dc;
@@ -936,51 +1115,49 @@ struct rtgui_dc *rtgui_win_get_drawing(rtgui_win_t * win)
     if (win == RT_NULL || !(win->flag & RTGUI_WIN_FLAG_CONNECTED))
         return RT_NULL;
 
+#ifdef GUIENGINE_USING_COMPOSITOR
+    dc = _rtgui_win_get_layer_drawing(win);
+    if (dc != RT_NULL)
+        return dc;
+#endif
+
     if (win->app == rtgui_app_self())
     {
         /* under the same application context */
-        rtgui_region_t region;
         rtgui_region_t clip_region;
+        struct rtgui_rect screen, visiable;
+
+        /* the window is painted in a buffer of its extent */
+        rect = RTGUI_WIDGET(win)->extent;
+        rtgui_graphic_driver_get_rect(RT_NULL, &screen);
+        rtgui_rect_intersect(&screen, &rect);
+        if (rtgui_rect_is_empty(&rect) == RT_TRUE)
+            return RT_NULL;
 
+        dc = rtgui_dc_buffer_create_pixformat(RTGUI_VFB_PIXEL_FMT,
+                                              rtgui_rect_width(rect), rtgui_rect_height(rect));
+        if (dc == RT_NULL)
+            return RT_NULL;
+
+        if (rtgui_graphic_driver_vmode_enter_buffer(dc, &rect) != RT_EOK)
+        {
+            rtgui_dc_destory(dc);
+            return RT_NULL;
+        }
+
+        /* the part covered by the others is painted too */
         rtgui_region_init(&clip_region);
         rtgui_region_copy(&clip_region, &win->outer_clip);
+        visiable = RTGUI_WIDGET(win)->extent_visiable;
+        _rtgui_win_limit_clip(win, &rect, RT_NULL);
 
-        rtgui_graphic_driver_vmode_enter();
-
-        rtgui_graphic_driver_get_rect(RT_NULL, &rect);
-        region.data = RT_NULL;
-        region.extents.x1 = rect.x1;
-        region.extents.y1 = rect.y1;
-        region.extents.x2 = rect.x2;
-        region.extents.y2 = rect.y2;
-
-        /* remove clip */
-        rtgui_region_reset(&win->outer_clip,
-                           &RTGUI_WIDGET(win)->extent);
-        rtgui_region_intersect(&win->outer_clip,
-                               &win->outer_clip,
-                               &region);
-        rtgui_win_update_clip(win);
-        /* use virtual framebuffer */
         rtgui_widget_update(RTGUI_WIDGET(win));
 
-        /* get the extent of widget */
-        rtgui_widget_get_extent(RTGUI_WIDGET(win), &rect);
-
-        dc = rtgui_graphic_driver_get_rect_buffer(RT_NULL, &rect);
-
         rtgui_graphic_driver_vmode_exit();
 
         /* restore the clip information of window */
-        rtgui_region_reset(&RTGUI_WIDGET(win)->clip,
-                           &RTGUI_WIDGET(win)->extent);
-        rtgui_region_intersect(&(RTGUI_WIDGET(win)->clip),
-                               &(RTGUI_WIDGET(win)->clip),
-                               &clip_region);
-        rtgui_region_fini(&region);
+        _rtgui_win_restore_clip(win, &visiable, &clip_region);
         rtgui_region_fini(&clip_region);
-
-        rtgui_win_update_clip(win);
     }
     else
     {
@@ -1007,12 +1184,351 @@ struct rtgui_dc *rtgui_win_get_drawing(rtgui_win_t * win)
 RTM_EXPORT(rtgui_win_get_drawing);
 #endif
 
+#ifdef GUIENGINE_USING_BAND
+#ifndef GUIENGIN_USING_VFRAMEBUFFER
+#error "the band is drawn in the virtual mode of GUIENGIN_USING_VFRAMEBUFFER"
+#endif
+
+extern void rtgui_mouse_show_cursor(void);
+extern void rtgui_mouse_hide_cursor(void);
+
+/* one band is painted while the other is transferred in the async flush */
+#ifdef GUIENGINE_USING_ASYNC_FLUSH
+#define WIN_BAND_NUM    2
+#else
+#define WIN_BAND_NUM    1
+#endif
+
+/* the bands shared by the windows, they are used in the screen lock */
+static struct rtgui_dc *_win_band[WIN_BAND_NUM];
+
+static struct rtgui_dc_buffer *_rtgui_win_get_band(struct rtgui_graphic_driver *driver, int index)
+{
+    int rows;
+    struct rtgui_dc_buffer *band = (struct rtgui_dc_buffer *)_win_band[index];
+
+    if (band != RT_NULL && band->width == driver->width &&
+            band->pixel_format == driver->pixel_format)
+        return band;
+
+    if (_win_band[index] != RT_NULL)
+    {
+        rtgui_dc_destory(_win_band[index]);
+        _win_band[index] = RT_NULL;
+    }
+
+    rows = GUIENGINE_BAND_SIZE / WIN_BAND_NUM / (driver->width * rtgui_color_get_bpp(driver->pixel_format));
+    if (rows < 1) rows = 1;
+    if (rows > driver->height) rows = driver->height;
+
+    /* the band is read by the DMA of panel */
+    _win_band[index] = rtgui_dc_buffer_create_tag(driver->pixel_format, driver->width, rows, RTGUI_MEM_DMA);
+    return (struct rtgui_dc_buffer *)_win_band[index];
+}
+
+rt_bool_t rtgui_win_is_band_mode(void)
+{
+    struct rtgui_graphic_driver *driver = rtgui_graphic_driver_get_default();
+
+    if (driver == RT_NULL || driver->framebuffer != RT_NULL || driver->device == RT_NULL)
+        return RT_FALSE;
+
+    return rtgui_graphic_driver_is_vmode() == RT_TRUE ? RT_FALSE : RT_TRUE;
+}
+RTM_EXPORT(rtgui_win_is_band_mode);
+
+/* write the lines of band in the region to the device */
+static void _rtgui_win_write_band(struct rtgui_graphic_driver *driver, struct rtgui_dc_buffer *band,
+                                  rtgui_rect_t *band_rect, rtgui_region_t *region)
+{
+    int index, num, y, bpp;
+    rtgui_rect_t *rects;
+    rt_uint8_t *pixels;
+
+    bpp = rtgui_color_get_bpp(band->pixel_format);
+    num = rtgui_region_num_rects(region);
+    rects = rtgui_region_rects(region);
+
+#ifdef GUIENGINE_USING_ASYNC_FLUSH
+    /* each rect is a transfer as the update of device, the last one is in
+     * flight on return */
+    for (index = 0; index < num; index ++)
+    {
+        pixels = band->pixel + (rects[index].y1 - band_rect->y1) * band->pitch
+                 + (rects[index].x1 - band_rect->x1) * bpp;
+        if (rtgui_graphic_driver_flush_async(driver, pixels, band->pitch, &rects[index]) != RT_EOK)
+            break;
+    }
+    if (index == num)
+        return;
+    /* the device can not transfer it, the rest are written in lines */
+    rects += index;
+    num -= index;
+#endif
+
+    for (index = 0; index < num; index ++)
+    {
+        pixels = band->pixel + (rects[index].y1 - band_rect->y1) * band->pitch
+                 + (rects[index].x1 - band_rect->x1) * bpp;
+        for (y = rects[index].y1; y < rects[index].y2; y ++)
+        {
+            driver->ops->draw_raw_hline(pixels, rects[index].x1, rects[index].x2, y);
+            pixels += band->pitch;
+        }
+    }
+    rtgui_graphic_driver_screen_update(driver, band_rect);
+}
+
+/*
+ * The clip of window is set to each band in turn, and the widget is painted in
+ * the virtual mode of band. Then the lines of band are written to the device.
+ * The widget is painted directly if the band is not created. In the async
+ * flush, the bands are painted in turn while the other one is transferred.
+ */
+void rtgui_win_paint_bands(struct rtgui_win *win, rtgui_widget_t *widget, struct rtgui_event *event)
+{
+    int y, count;
+    rtgui_rect_t extent, screen, band_rect, visiable;
+    rtgui_region_t clip, band_clip;
+    struct rtgui_dc_buffer *band, *bands[WIN_BAND_NUM];
+    struct rtgui_graphic_driver *driver;
+
+    /* the bands are the lines of main display */
+    if (RTGUI_WIN_DISPLAY(win) != 0)
+    {
+        rtgui_widget_paint_event(widget, event);
+        return;
+    }
+
+    /* the band is used in the lock */
+    rtgui_screen_lock(RT_WAITING_FOREVER);
+    driver = rtgui_graphic_driver_get_default();
+    for (count = 0; count < WIN_BAND_NUM; count ++)
+    {
+        bands[count] = _rtgui_win_get_band(driver, count);
+        /* paint in the one band if there is no memory for the other */
+        if (bands[count] == RT_NULL && count > 0)
+            bands[count] = bands[0];
+    }
+    band = bands[0];
+    if (band == RT_NULL)
+    {
+        rtgui_screen_unlock();
+        rtgui_widget_paint_event(widget, event);
+        return;
+    }
+
+    /* the title is painted with the window */
+    if (widget == RTGUI_WIDGET(win))
+        extent = win->outer_extent;
+    else
+        extent = widget->extent;
+    rtgui_graphic_driver_get_rect(driver, &screen);
+    rtgui_rect_intersect(&screen, &extent);
+
+    rtgui_region_init(&clip);
+    rtgui_region_init(&band_clip);
+    rtgui_region_copy(&clip, &win->outer_clip);
+    visiable = RTGUI_WIDGET(win)->extent_visiable;
+
+    /* the cursor is not drawn on the device while a band is transferred */
+#ifdef RTGUI_USING_MOUSE_CURSOR
+    rtgui_mouse_hide_cursor();
+#endif
+    for (y = extent.y1, count = 0; y < extent.y2; y += band->height)
+    {
+        band_rect = extent;
+        band_rect.y1 = y;
+        if (band_rect.y2 > y + band->height)
+            band_rect.y2 = y + band->height;
+
+        rtgui_region_intersect_rect(&band_clip, &clip, &band_rect);
+        if (!rtgui_region_not_empty(&band_clip))
+            continue;
+
+        band = bands[count % WIN_BAND_NUM];
+#ifdef GUIENGINE_USING_ASYNC_FLUSH
+        /* the transfer in flight is from the other band, except there is one */
+        if (bands[0] == bands[1])
+            rtgui_graphic_driver_flush_wait(driver);
+#endif
+        if (rtgui_graphic_driver_vmode_enter_buffer(RTGUI_DC(band), &band_rect) != RT_EOK)
+            break;
+        _rtgui_win_limit_clip(win, &band_rect, &band_clip);
+        rtgui_widget_paint_event(widget, event);
+        rtgui_graphic_driver_vmode_exit();
+
+        _rtgui_win_write_band(driver, band, &band_rect, &band_clip);
+        count ++;
+    }
+#ifdef GUIENGINE_USING_ASYNC_FLUSH
+    rtgui_graphic_driver_flush_wait(driver);
+#endif
+#ifdef RTGUI_USING_MOUSE_CURSOR
+    rtgui_mouse_show_cursor();
+#endif
+
+    /* restore the clip information of window */
+    _rtgui_win_restore_clip(win, &visiable, &clip);
+    rtgui_region_fini(&clip);
+    rtgui_region_fini(&band_clip);
+
+    rtgui_screen_unlock();
+}
+RTM_EXPORT(rtgui_win_paint_bands);
+#endif
+
 static const rt_uint8_t close_byte[14] =
 {
     0x06, 0x18, 0x03, 0x30, 0x01, 0xE0, 0x00,
     0xC0, 0x01, 0xE0, 0x03, 0x30, 0x06, 0x18
 };
 
+/* draw the title bar in the rect, the foreground of dc is changed */
+static void _rtgui_theme_draw_title(struct rtgui_dc *dc, struct rtgui_win *win,
+                                    rtgui_rect_t *rect)
+{
+    rt_uint16_t index;
+    rt_uint16_t r, g, b, delta;
+
+#define RGB_FACTOR  4
+    if (win->flag & RTGUI_WIN_FLAG_ACTIVATE)
+    {
+        r = 10 << RGB_FACTOR;
+        g = 36 << RGB_FACTOR;
+        b = 106 << RGB_FACTOR;
+        delta = (150 << RGB_FACTOR) / (rect->x2 - rect->x1);
+    }
+    else
+    {
+        r = 128 << RGB_FACTOR;
+        g = 128 << RGB_FACTOR;
+        b = 128 << RGB_FACTOR;
+        delta = (64 << RGB_FACTOR) / (rect->x2 - rect->x1);
+    }
+
+    for (index = rect->x1; index < rect->x2 + 1; index ++)
+    {
+        RTGUI_DC_FC(dc) = RTGUI_RGB((r>>RGB_FACTOR),
+                                    (g>>RGB_FACTOR),
+                                    (b>>RGB_FACTOR));
+        rtgui_dc_draw_vline(dc, index, rect->y1, rect->y2);
+        r += delta;
+        g += delta;
+        b += delta;
+    }
+#undef RGB_FACTOR
+
+    if (win->flag & RTGUI_WIN_FLAG_ACTIVATE)
+    {
+        RTGUI_DC_FC(dc) = white;
+    }
+    else
+    {
+        RTGUI_DC_FC(dc) = RTGUI_RGB(212, 208, 200);
+    }
+
+    rect->x1 += 4;
+    rect->y1 += 2;
+    rect->y2 = rect->y1 + WINTITLE_CB_HEIGHT;
+    rtgui_dc_draw_text_cached(dc, win->title, rect);
+
+    if (win->style & RTGUI_WIN_STYLE_CLOSEBOX)
+    {
+        /* get close button rect */
+        rtgui_rect_t box_rect = {0, 0, WINTITLE_CB_WIDTH, WINTITLE_CB_HEIGHT};
+        rtgui_rect_move_to_align(rect, &box_rect, RTGUI_ALIGN_CENTER_VERTICAL | RTGUI_ALIGN_RIGHT);
+        box_rect.x1 -= 3;
+        box_rect.x2 -= 3;
+        rtgui_dc_fill_rect(dc, &box_rect);
+
+        /* draw close box */
+        if (win->flag & RTGUI_WIN_FLAG_CB_PRESSED)
+        {
+            rtgui_dc_draw_border(dc, &box_rect, RTGUI_BORDER_SUNKEN);
+            RTGUI_DC_FC(dc) = red;
+            rtgui_dc_draw_word(dc, box_rect.x1, box_rect.y1 + 6, 7, close_byte);
+        }
+        else
+        {
+            rtgui_dc_draw_border(dc, &box_rect, RTGUI_BORDER_RAISE);
+            RTGUI_DC_FC(dc) = black;
+            rtgui_dc_draw_word(dc, box_rect.x1 - 1, box_rect.y1 + 5, 7, close_byte);
+        }
+    }
+}
+
+#ifdef GUIENGINE_USING_TITLE_CACHE
+static rt_uint32_t _rtgui_title_hash(const char *title)
+{
+    rt_uint32_t hash = 5381;
+
+    if (title == RT_NULL)
+        return 0;
+    while (*title)
+        hash = hash * 33 + (rt_uint8_t)(*title ++);
+
+    return hash;
+}
+
+/*
+ * Copy the title bar to the window from the cache, which is drawn again only
+ * if the width, title, font or state of window is changed. The rect is the
+ * title bar inside border, RT_FALSE is returned if the cache is not created.
+ */
+static rt_bool_t _rtgui_theme_draw_title_cache(struct rtgui_wintitle *wint, struct rtgui_dc *dc,
+        struct rtgui_win *win, rtgui_rect_t *rect)
+{
+    int w, h;
+    rt_uint32_t state, title;
+    rtgui_rect_t bar, bar_rect;
+    struct rtgui_dc_buffer *buffer;
+
+    /* the part above the client is shown */
+    bar = *rect;
+    bar.x2 += 1;
+    h = RTGUI_WIDGET(win)->extent.y1 - RTGUI_WIDGET(wint)->extent.y1;
+    if (bar.y2 > h) bar.y2 = h;
+    w = rtgui_rect_width(bar);
+    h = rtgui_rect_height(bar);
+    if (w <= 0 || h <= 0)
+        return RT_FALSE;
+
+    state = (win->flag & (RTGUI_WIN_FLAG_ACTIVATE | RTGUI_WIN_FLAG_CB_PRESSED)) |
+            ((win->style & RTGUI_WIN_STYLE_CLOSEBOX) << 16);
+    title = _rtgui_title_hash(win->title);
+
+    buffer = (struct rtgui_dc_buffer *)wint->cache;
+    if (buffer == RT_NULL || buffer->width != w || buffer->height != h ||
+            wint->cache_state != state || wint->cache_title != title ||
+            wint->cache_font != RTGUI_WIDGET_FONT(wint))
+    {
+        /* the width is changed, or the buffer is not created yet */
+        if (buffer == RT_NULL || buffer->width != w || buffer->height != h)
+        {
+            if (wint->cache != RT_NULL)
+                rtgui_dc_destory(wint->cache);
+            wint->cache = rtgui_dc_buffer_create(w, h);
+            if (wint->cache == RT_NULL)
+                return RT_FALSE;
+        }
+
+        *rtgui_dc_get_gc(wint->cache) = RTGUI_WIDGET(wint)->gc;
+        bar_rect = *rect;
+        rtgui_rect_move(&bar_rect, -bar.x1, -bar.y1);
+        _rtgui_theme_draw_title(wint->cache, win, &bar_rect);
+
+        wint->cache_state = state;
+        wint->cache_title = title;
+        wint->cache_font = RTGUI_WIDGET_FONT(wint);
+    }
+
+    rtgui_dc_blit(wint->cache, RT_NULL, dc, &bar);
+
+    return RT_TRUE;
+}
+#endif
+
 /* window drawing */
 void rtgui_theme_draw_win(struct rtgui_wintitle *wint)
 {
@@ -1065,74 +1581,10 @@ void rtgui_theme_draw_win(struct rtgui_wintitle *wint)
     /* draw title */
     if (!(win->style & RTGUI_WIN_STYLE_NO_TITLE))
     {
-        rt_uint16_t index;
-        rt_uint16_t r, g, b, delta;
-
-#define RGB_FACTOR  4
-        if (win->flag & RTGUI_WIN_FLAG_ACTIVATE)
-        {
-            r = 10 << RGB_FACTOR;
-            g = 36 << RGB_FACTOR;
-            b = 106 << RGB_FACTOR;
-            delta = (150 << RGB_FACTOR) / (rect.x2 - rect.x1);
-        }
-        else
-        {
-            r = 128 << RGB_FACTOR;
-            g = 128 << RGB_FACTOR;
-            b = 128 << RGB_FACTOR;
-            delta = (64 << RGB_FACTOR) / (rect.x2 - rect.x1);
-        }
-
-        for (index = rect.x1; index < rect.x2 + 1; index ++)
-        {
-            RTGUI_WIDGET_FOREGROUND(win->_title_wgt) = RTGUI_RGB((r>>RGB_FACTOR),
-                    (g>>RGB_FACTOR),
-                    (b>>RGB_FACTOR));
-            rtgui_dc_draw_vline(dc, index, rect.y1, rect.y2);
-            r += delta;
-            g += delta;
-            b += delta;
-        }
-#undef RGB_FACTOR
-
-        if (win->flag & RTGUI_WIN_FLAG_ACTIVATE)
-        {
-            RTGUI_WIDGET_FOREGROUND(win->_title_wgt) = white;
-        }
-        else
-        {
-            RTGUI_WIDGET_FOREGROUND(win->_title_wgt) = RTGUI_RGB(212, 208, 200);
-        }
-
-        rect.x1 += 4;
-        rect.y1 += 2;
-        rect.y2 = rect.y1 + WINTITLE_CB_HEIGHT;
-        rtgui_dc_draw_text(dc, win->title, &rect);
-
-        if (win->style & RTGUI_WIN_STYLE_CLOSEBOX)
-        {
-            /* get close button rect */
-            rtgui_rect_t box_rect = {0, 0, WINTITLE_CB_WIDTH, WINTITLE_CB_HEIGHT};
-            rtgui_rect_move_to_align(&rect, &box_rect, RTGUI_ALIGN_CENTER_VERTICAL | RTGUI_ALIGN_RIGHT);
-            box_rect.x1 -= 3;
-            box_rect.x2 -= 3;
-            rtgui_dc_fill_rect(dc, &box_rect);
-
-            /* draw close box */
-            if (win->flag & RTGUI_WIN_FLAG_CB_PRESSED)
-            {
-                rtgui_dc_draw_border(dc, &box_rect, RTGUI_BORDER_SUNKEN);
-                RTGUI_WIDGET_FOREGROUND(win->_title_wgt) = red;
-                rtgui_dc_draw_word(dc, box_rect.x1, box_rect.y1 + 6, 7, close_byte);
-            }
-            else
-            {
-                rtgui_dc_draw_border(dc, &box_rect, RTGUI_BORDER_RAISE);
-                RTGUI_WIDGET_FOREGROUND(win->_title_wgt) = black;
-                rtgui_dc_draw_word(dc, box_rect.x1 - 1, box_rect.y1 + 5, 7, close_byte);
-            }
-        }
+#ifdef GUIENGINE_USING_TITLE_CACHE
+        if (_rtgui_theme_draw_title_cache(wint, dc, win, &rect) == RT_FALSE)
+#endif
+            _rtgui_theme_draw_title(dc, win, &rect);
     }
 
     rtgui_dc_end_drawing(dc, 1);